@@ -0,0 +1,52 @@
+# Copyright (c) 2020, ArrayFire
+# All rights reserved.
+#
+# This file is distributed under 3-clause BSD license.
+# The complete license agreement can be obtained at:
+# http://arrayfire.com/licenses/BSD-3-Clause
+
+# Compiles the OpenCL kernels exported by the OpenCL backend with
+# AF_OPENCL_SPIRV_EXPORT_DIR to SPIR-V modules. The source of each kernel is
+# in KERNEL_DIR/<name>.cl and its compiler options in KERNEL_DIR/<name>.opts.
+# The module is written to OUTPUT_DIR/<name>.spv. The kernels which fail to
+# compile are skipped, so the backend builds them from their source.
+#
+# Usage:
+# cmake -DKERNEL_DIR=<dir> -DOUTPUT_DIR=<dir> -DCLANG=<clang>
+#       -DLLVM_SPIRV=<llvm-spirv> -P CompileSPIRV.cmake
+
+file(MAKE_DIRECTORY ${OUTPUT_DIR})
+file(GLOB kernels "${KERNEL_DIR}/*.cl")
+
+foreach(kernel ${kernels})
+  get_filename_component(name ${kernel} NAME_WE)
+  set(module ${OUTPUT_DIR}/${name}.spv)
+  if(EXISTS ${module} AND NOT ${kernel} IS_NEWER_THAN ${module})
+    continue()
+  endif()
+
+  set(options "")
+  if(EXISTS ${KERNEL_DIR}/${name}.opts)
+    file(READ ${KERNEL_DIR}/${name}.opts options)
+    separate_arguments(options UNIX_COMMAND "${options}")
+  endif()
+
+  set(bitcode ${OUTPUT_DIR}/${name}.bc)
+  execute_process(
+    COMMAND ${CLANG} -c -x cl -cl-std=CL1.2 -target spir64 -emit-llvm -O2
+            -Xclang -finclude-default-header ${options}
+            -o ${bitcode} ${kernel}
+    RESULT_VARIABLE result
+    ERROR_VARIABLE error)
+  if(result EQUAL 0)
+    execute_process(
+      COMMAND ${LLVM_SPIRV} ${bitcode} -o ${module}
+      RESULT_VARIABLE result
+      ERROR_VARIABLE error)
+  endif()
+  file(REMOVE ${bitcode})
+
+  if(NOT result EQUAL 0)
+    message(WARNING "Skipping ${name}: ${error}")
+  endif()
+endforeach()
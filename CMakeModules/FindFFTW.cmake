@@ -7,6 +7,7 @@
 #   FFTW_FOUND               ... true if fftw is found on the system
 #   FFTW_LIBRARIES           ... full path to fftw library
 #   FFTW_INCLUDES            ... fftw include directory
+#   FFTW_THREADS_FOUND       ... true if the fftw threads libraries are found
 #
 # The following variables will be checked by the function
 #   FFTW_USE_STATIC_LIBS    ... if true, only static libraries are found
@@ -49,7 +50,25 @@ find_library( FFTWF_LIBRARY
   PATH_SUFFIXES "lib" "lib64"
 )
 
-mark_as_advanced(FFTW_INCLUDE_DIR FFTW_LIBRARY FFTWF_LIBRARY)
+find_library( FFTW_THREADS_LIBRARY
+  NAMES "fftw3_threads" "libfftw3_threads-3" "fftw3_threads-3"
+  PATHS ${FFTW_ROOT}
+        ${CMAKE_SYSTEM_PREFIX_PATH}
+        ${PKG_FFTW_LIBRARY_DIRS}
+  PATH_SUFFIXES "lib" "lib64"
+)
+
+find_library( FFTWF_THREADS_LIBRARY
+  NAMES "fftw3f_threads" "libfftw3f_threads-3" "fftw3f_threads-3"
+  PATHS ${FFTW_ROOT}
+        ${CMAKE_SYSTEM_PREFIX_PATH}
+        ${CMAKE_SYSTEM_LIBRARY_PATH}
+        ${PKG_FFTW_LIBRARY_DIRS}
+  PATH_SUFFIXES "lib" "lib64"
+)
+
+mark_as_advanced(FFTW_INCLUDE_DIR FFTW_LIBRARY FFTWF_LIBRARY
+  FFTW_THREADS_LIBRARY FFTWF_THREADS_LIBRARY)
 
 include(FindPackageHandleStandardArgs)
 find_package_handle_standard_args(FFTW DEFAULT_MSG
@@ -67,5 +86,23 @@ if (FFTW_FOUND)
     IMPORTED_LINK_INTERFACE_LANGUAGE "C"
     IMPORTED_LOCATION "${FFTWF_LIBRARY}"
     INTERFACE_INCLUDE_DIRECTORIES "${FFTW_INCLUDE_DIR}")
+
+  # The threads libraries are optional. Without them the CPU FFTs run on a
+  # single thread.
+  if (FFTW_THREADS_LIBRARY AND FFTWF_THREADS_LIBRARY)
+    set(FFTW_THREADS_FOUND ON)
+
+    add_library(FFTW::FFTW_THREADS UNKNOWN IMPORTED)
+    set_target_properties(FFTW::FFTW_THREADS PROPERTIES
+      IMPORTED_LINK_INTERFACE_LANGUAGE "C"
+      IMPORTED_LOCATION "${FFTW_THREADS_LIBRARY}"
+      INTERFACE_LINK_LIBRARIES FFTW::FFTW)
+
+    add_library(FFTW::FFTWF_THREADS UNKNOWN IMPORTED)
+    set_target_properties(FFTW::FFTWF_THREADS PROPERTIES
+      IMPORTED_LINK_INTERFACE_LANGUAGE "C"
+      IMPORTED_LOCATION "${FFTWF_THREADS_LIBRARY}"
+      INTERFACE_LINK_LIBRARIES FFTW::FFTWF)
+  endif ()
 endif (FFTW_FOUND)
 
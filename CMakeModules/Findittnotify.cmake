@@ -0,0 +1,47 @@
+# Copyright (c) 2020, ArrayFire
+# All rights reserved.
+#
+# This file is distributed under 3-clause BSD license.
+# The complete license agreement can be obtained at:
+# http://arrayfire.com/licenses/BSD-3-Clause
+#
+# Finds the Instrumentation and Tracing Technology (ITT) API of Intel VTune.
+# The static library loads the collector of the profiler at runtime, so the
+# annotated programs run without VTune installed.
+#
+# Sets the following variables:
+#          ittnotify_FOUND
+#          ittnotify_INCLUDE_DIR
+#          ittnotify_LIBRARY
+#
+# Usage:
+# find_package(ittnotify)
+# if (ittnotify_FOUND)
+#    target_include_directories(mylib PRIVATE ${ittnotify_INCLUDE_DIR})
+#    target_link_libraries(mylib PRIVATE ${ittnotify_LIBRARY})
+# endif (ittnotify_FOUND)
+
+set(ittnotify_SEARCH_PATHS
+  ${ittnotify_ROOT}
+  $ENV{VTUNE_PROFILER_DIR}
+  $ENV{VTUNE_PROFILER_2020_DIR}
+  /opt/intel/oneapi/vtune/latest
+  /opt/intel/vtune_profiler)
+
+find_path(ittnotify_INCLUDE_DIR
+  NAMES ittnotify.h
+  PATHS ${ittnotify_SEARCH_PATHS}
+  PATH_SUFFIXES include
+  DOC "The directory where ittnotify.h resides")
+
+find_library(ittnotify_LIBRARY
+  NAMES ittnotify libittnotify
+  PATHS ${ittnotify_SEARCH_PATHS}
+  PATH_SUFFIXES lib64 lib lib/x64
+  DOC "The ITT API static library")
+
+mark_as_advanced(ittnotify_INCLUDE_DIR ittnotify_LIBRARY)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(ittnotify
+  REQUIRED_VARS ittnotify_INCLUDE_DIR ittnotify_LIBRARY)
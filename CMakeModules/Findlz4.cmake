@@ -0,0 +1,35 @@
+# Copyright (c) 2020, ArrayFire
+# All rights reserved.
+#
+# This file is distributed under 3-clause BSD license.
+# The complete license agreement can be obtained at:
+# http://arrayfire.com/licenses/BSD-3-Clause
+#
+# Finds the header of the LZ4 compression library. ArrayFire loads the
+# library at runtime, so the library itself is not needed to build it.
+#
+# Sets the following variables:
+#          lz4_FOUND
+#          lz4_INCLUDE_DIR
+#
+# Usage:
+# find_package(lz4)
+# if (lz4_FOUND)
+#    target_include_directories(mylib PRIVATE ${lz4_INCLUDE_DIR})
+# endif (lz4_FOUND)
+
+find_path(lz4_INCLUDE_DIR
+  NAMES lz4.h
+  PATHS
+    /usr/include
+    /usr/local/include
+    /sw/include
+    /opt/local/include
+    ${lz4_ROOT}
+  DOC "The directory where lz4.h resides")
+
+mark_as_advanced(lz4_INCLUDE_DIR)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(lz4
+  REQUIRED_VARS lz4_INCLUDE_DIR)
@@ -0,0 +1,35 @@
+# Copyright (c) 2020, ArrayFire
+# All rights reserved.
+#
+# This file is distributed under 3-clause BSD license.
+# The complete license agreement can be obtained at:
+# http://arrayfire.com/licenses/BSD-3-Clause
+#
+# Finds the header of the zstd compression library. ArrayFire loads the
+# library at runtime, so the library itself is not needed to build it.
+#
+# Sets the following variables:
+#          zstd_FOUND
+#          zstd_INCLUDE_DIR
+#
+# Usage:
+# find_package(zstd)
+# if (zstd_FOUND)
+#    target_include_directories(mylib PRIVATE ${zstd_INCLUDE_DIR})
+# endif (zstd_FOUND)
+
+find_path(zstd_INCLUDE_DIR
+  NAMES zstd.h
+  PATHS
+    /usr/include
+    /usr/local/include
+    /sw/include
+    /opt/local/include
+    ${zstd_ROOT}
+  DOC "The directory where zstd.h resides")
+
+mark_as_advanced(zstd_INCLUDE_DIR)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(zstd
+  REQUIRED_VARS zstd_INCLUDE_DIR)
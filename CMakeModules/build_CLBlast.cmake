@@ -45,7 +45,7 @@ ExternalProject_Add(
       -DCMAKE_INSTALL_LIBDIR:PATH=lib
       -DBUILD_SHARED_LIBS:BOOL=OFF
       -DSAMPLES:BOOL=OFF
-      -DTUNERS:BOOL=OFF
+      -DTUNERS:BOOL=${AF_BUILD_CLBLAST_TUNERS}
       -DCLIENTS:BOOL=OFF
       -DTESTS:BOOL=OFF
       -DNETLIB:BOOL=OFF
@@ -53,6 +53,7 @@ ExternalProject_Add(
 
 ExternalProject_Get_Property(CLBlast-ext install_dir)
 set(CLBLAST_INCLUDE_DIRS ${install_dir}/include)
+set(CLBLAST_TUNERS_DIR ${install_dir}/bin)
 set(CLBLAST_LIBRARIES CLBlast)
 set(CLBLAST_FOUND ON)
 
@@ -0,0 +1,115 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <arrayfire.h>
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace bench {
+
+/// Returns the ArrayFire type of \p T
+template<typename T>
+af::dtype dtype() {
+    return static_cast<af::dtype>(af::dtype_traits<T>::af_type);
+}
+
+/// Skips the benchmark if the active device does not support \p T. Returns
+/// true if the benchmark can run.
+template<typename T>
+bool isSupported(benchmark::State &state) {
+    const int device     = af::getDevice();
+    const af::dtype type = dtype<T>();
+    if ((type == f64 || type == c64) && !af::isDoubleAvailable(device)) {
+        state.SkipWithError("The device does not support doubles");
+        return false;
+    }
+    if (type == f16 && !af::isHalfAvailable(device)) {
+        state.SkipWithError("The device does not support half");
+        return false;
+    }
+    return true;
+}
+
+/// Returns a random array of type \p T
+template<typename T>
+af::array random(const af::dim4 &dims) {
+    const af::dtype type = dtype<T>();
+    if (type == s32 || type == u32 || type == s64 || type == u64 ||
+        type == s16 || type == u16 || type == u8) {
+        return (af::randu(dims) * 100).as(type);
+    }
+    return af::randu(dims, type);
+}
+
+/// Evaluates the array computed by a benchmarked operation
+inline void evalResult(af::array &out) { out.eval(); }
+
+/// The results copied to the host are ready when they are returned
+template<typename T>
+void evalResult(const T &) {}
+
+/// Times \p fn, which returns the result of the benchmarked operation. The
+/// result is evaluated and the device is synchronized in every iteration, so
+/// the time includes the kernels. The first call, which compiles the
+/// kernels, is not timed. The benchmark is skipped if it throws, which
+/// happens when the backend does not support the type.
+template<typename Fn>
+void run(benchmark::State &state, Fn fn) {
+    try {
+        auto out = fn();
+        evalResult(out);
+        af::sync();
+    } catch (const af::exception &ex) {
+        state.SkipWithError(ex.what());
+        return;
+    }
+    for (auto _ : state) {
+        auto out = fn();
+        evalResult(out);
+        af::sync();
+    }
+}
+
+/// Reports the bytes read and written by each iteration
+inline void setBytes(benchmark::State &state, int64_t bytes) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * bytes);
+}
+
+/// Reports the elements processed by each iteration
+inline void setItems(benchmark::State &state, int64_t items) {
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * items);
+}
+
+/// Runs a benchmark on 4K to 16M elements
+inline void elements(benchmark::internal::Benchmark *b) {
+    b->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+}
+
+/// Runs a benchmark on square matrices of 256 to 4096 rows
+inline void matrices(benchmark::internal::Benchmark *b) {
+    b->RangeMultiplier(2)->Range(256, 4096);
+}
+
+}  // namespace bench
+
+/// Registers the benchmark template \p fn for each floating point type. The
+/// arguments of the benchmarks are set by \p apply.
+#define BENCH_FLOATING(fn, apply)                                             \
+    BENCHMARK_TEMPLATE(fn, float)->Apply(apply);                              \
+    BENCHMARK_TEMPLATE(fn, double)->Apply(apply);                             \
+    BENCHMARK_TEMPLATE(fn, af::half)->Apply(apply)
+
+/// Registers the benchmark template \p fn for float, double and int
+#define BENCH_NUMERIC(fn, apply)                                              \
+    BENCHMARK_TEMPLATE(fn, float)->Apply(apply);                              \
+    BENCHMARK_TEMPLATE(fn, double)->Apply(apply);                             \
+    BENCHMARK_TEMPLATE(fn, int)->Apply(apply)
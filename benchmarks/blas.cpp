@@ -0,0 +1,44 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include "bench.hpp"
+
+using af::array;
+
+// The argument is the number of rows of the square matrices
+
+template<typename T>
+static void gemm(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n = state.range(0);
+    array a       = bench::random<T>(af::dim4(n, n));
+    array b       = bench::random<T>(af::dim4(n, n));
+    a.eval();
+    b.eval();
+
+    bench::run(state, [&]() { return af::matmul(a, b); });
+    state.counters["FLOPS"] = benchmark::Counter(
+        2.0 * n * n * n, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template<typename T>
+static void gemv(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n = state.range(0);
+    array a       = bench::random<T>(af::dim4(n, n));
+    array x       = bench::random<T>(af::dim4(n));
+    a.eval();
+    x.eval();
+
+    bench::run(state, [&]() { return af::matmul(a, x); });
+    bench::setBytes(state, n * n * static_cast<int64_t>(sizeof(T)));
+}
+
+BENCH_FLOATING(gemm, bench::matrices);
+BENCH_FLOATING(gemv, bench::matrices);
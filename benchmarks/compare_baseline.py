@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2020, ArrayFire
+# All rights reserved.
+#
+# This file is distributed under 3-clause BSD license.
+# The complete license agreement can be obtained at:
+# http://arrayfire.com/licenses/BSD-3-Clause
+
+"""Compares the benchmarks of a backend with a stored baseline.
+
+The benchmarks are run several times. The median and the median absolute
+deviation (MAD) of the times of each benchmark are compared with the
+baseline of the device, which is stored in the baseline directory as
+<backend>_<device>.json. A benchmark regresses when its median is slower
+than the baseline by more than the threshold and the slowdown is larger
+than the noise of both measurements.
+
+Exit codes:
+    0   no benchmark regressed, or the baseline was updated
+    1   at least one benchmark regressed
+    77  there is no baseline for the device
+"""
+
+import argparse
+import json
+import os
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+
+SKIP_RETURN_CODE = 77
+
+# Scales the MAD to the standard deviation of a normal distribution
+MAD_TO_SIGMA = 1.4826
+
+TIME_UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def run_benchmarks(executable, benchmark_filter, repetitions, extra_args):
+    """Runs the benchmarks and returns the parsed JSON output"""
+    with tempfile.TemporaryDirectory() as directory:
+        output = os.path.join(directory, "results.json")
+        command = [
+            executable,
+            "--benchmark_filter=" + benchmark_filter,
+            "--benchmark_repetitions=%d" % repetitions,
+            "--benchmark_out=" + output,
+            "--benchmark_out_format=json",
+        ] + extra_args
+        subprocess.run(command, check=True, stdout=sys.stderr)
+        with open(output) as results:
+            return json.load(results)
+
+
+def summarize(results):
+    """Returns the median, the MAD and the number of repetitions of the time
+    of each benchmark, in nanoseconds"""
+    times = {}
+    for run in results["benchmarks"]:
+        if run.get("run_type", "iteration") != "iteration":
+            continue
+        if run.get("error_occurred"):
+            continue
+        scale = TIME_UNITS[run.get("time_unit", "ns")]
+        times.setdefault(run["run_name"], []).append(run["real_time"] * scale)
+
+    summary = {}
+    for name, values in times.items():
+        median = statistics.median(values)
+        mad = statistics.median([abs(value - median) for value in values])
+        summary[name] = {
+            "median": median,
+            "mad": mad,
+            "repetitions": len(values),
+        }
+    return summary
+
+
+def baseline_path(directory, backend, device):
+    name = re.sub(r"[^A-Za-z0-9]+", "_", device).strip("_")
+    return os.path.join(directory, "%s_%s.json" % (backend, name))
+
+
+def compare(baseline, current, threshold):
+    """Prints the comparison and returns the names of the regressions"""
+    regressions = []
+    header = "%-40s %22s %22s %8s" % ("Benchmark", "Baseline (ns)",
+                                      "Current (ns)", "Change")
+    print(header)
+    print("-" * len(header))
+    for name in sorted(current):
+        now = current[name]
+        if name not in baseline:
+            print("%-40s %22s %15.0f +- %4.0f %8s" %
+                  (name, "-", now["median"], now["mad"], "new"))
+            continue
+        before = baseline[name]
+        change = (now["median"] - before["median"]) / before["median"]
+        noise = MAD_TO_SIGMA * (now["mad"] + before["mad"])
+        regressed = (change > threshold and
+                     now["median"] - before["median"] > noise)
+        print("%-40s %15.0f +- %4.0f %15.0f +- %4.0f %+7.1f%%%s" %
+              (name, before["median"], before["mad"], now["median"],
+               now["mad"], 100 * change, "  REGRESSION" if regressed else ""))
+        if regressed:
+            regressions.append(name)
+    print("\n%d benchmarks, %d repetitions each, threshold %.1f%%" %
+          (len(current),
+           min(run["repetitions"] for run in current.values()),
+           100 * threshold))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--benchmark", required=True,
+                        help="the benchmark executable of the backend")
+    parser.add_argument("--backend", required=True)
+    parser.add_argument("--baseline-dir", required=True)
+    parser.add_argument("--filter", default=".",
+                        help="a regex selecting the benchmarks")
+    parser.add_argument("--repetitions", type=int, default=10)
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        help="the slowdown allowed, in percent")
+    parser.add_argument("--update", action="store_true",
+                        help="store the results as the new baseline")
+    parser.add_argument("args", nargs="*",
+                        help="arguments passed to the benchmarks")
+    options = parser.parse_args()
+
+    results = run_benchmarks(options.benchmark, options.filter,
+                             options.repetitions, options.args)
+    device = results["context"].get("arrayfire_device", "unknown")
+    path = baseline_path(options.baseline_dir, options.backend, device)
+    current = summarize(results)
+
+    if options.update:
+        os.makedirs(options.baseline_dir, exist_ok=True)
+        with open(path, "w") as baseline:
+            json.dump({
+                "backend": options.backend,
+                "device": device,
+                "arrayfire_version":
+                    results["context"].get("arrayfire_version", ""),
+                "benchmarks": current,
+            }, baseline, indent=2, sort_keys=True)
+        print("Stored the baseline of %s in %s" % (device, path))
+        return 0
+
+    if not os.path.exists(path):
+        print("There is no baseline for %s. Create %s with --update." %
+              (device, path))
+        return SKIP_RETURN_CODE
+
+    with open(path) as baseline:
+        stored = json.load(baseline)
+    print("Comparing %s with the baseline of ArrayFire %s\n" %
+          (device, stored.get("arrayfire_version", "")))
+    regressions = compare(stored["benchmarks"], current,
+                          options.threshold / 100)
+    if regressions:
+        print("\nRegressions: " + ", ".join(regressions))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,67 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include "bench.hpp"
+
+using af::array;
+using af::seq;
+using af::span;
+
+// Indexing of a 1024 column matrix. The argument is the number of elements.
+
+// Copies every other row
+template<typename T>
+static void indexStrided(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n    = state.range(0);
+    const dim_t rows = n / 1024;
+    array a          = bench::random<T>(af::dim4(rows, 1024));
+    a.eval();
+
+    bench::run(state,
+               [&]() { return af::array(a(seq(0, rows - 1, 2), span)); });
+    bench::setBytes(state, n * static_cast<int64_t>(sizeof(T)));
+}
+
+// Gathers random rows
+template<typename T>
+static void indexArray(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n    = state.range(0);
+    const dim_t rows = n / 1024;
+    array a          = bench::random<T>(af::dim4(rows, 1024));
+    array idx        = (af::randu(rows) * (rows - 1)).as(u32);
+    a.eval();
+    idx.eval();
+
+    bench::run(state, [&]() { return af::lookup(a, idx, 0); });
+    bench::setBytes(state, 2 * n * static_cast<int64_t>(sizeof(T)));
+}
+
+// Assigns to every other row
+template<typename T>
+static void assignStrided(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n    = state.range(0);
+    const dim_t rows = n / 1024;
+    array a          = bench::random<T>(af::dim4(rows, 1024));
+    array b          = bench::random<T>(af::dim4((rows + 1) / 2, 1024));
+    a.eval();
+    b.eval();
+
+    bench::run(state, [&]() {
+        a(seq(0, rows - 1, 2), span) = b;
+        return a;
+    });
+    bench::setBytes(state, n * static_cast<int64_t>(sizeof(T)));
+}
+
+BENCH_NUMERIC(indexStrided, bench::elements);
+BENCH_NUMERIC(indexArray, bench::elements);
+BENCH_NUMERIC(assignStrided, bench::elements);
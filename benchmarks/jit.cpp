@@ -0,0 +1,59 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include "bench.hpp"
+
+using af::array;
+
+// Chains of elementwise operations which are fused into one JIT kernel. The
+// first argument is the number of elements and the second is the length of
+// the chain.
+template<typename T>
+static void jitChain(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n   = state.range(0);
+    const int chain = static_cast<int>(state.range(1));
+    array a         = bench::random<T>(n);
+    array b         = bench::random<T>(n);
+    a.eval();
+    b.eval();
+
+    bench::run(state, [&]() {
+        array out = a;
+        for (int i = 0; i < chain; ++i) { out = (i % 2 ? out * b : out + b); }
+        return out;
+    });
+    bench::setBytes(state, 3 * n * static_cast<int64_t>(sizeof(T)));
+    bench::setItems(state, n * chain);
+}
+
+// Transcendental functions, which are limited by arithmetic rather than
+// memory bandwidth
+template<typename T>
+static void jitTranscendental(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n = state.range(0);
+    array a       = bench::random<T>(n);
+    a.eval();
+
+    bench::run(state, [&]() { return af::exp(af::sin(a)) + af::sqrt(a); });
+    bench::setBytes(state, 2 * n * static_cast<int64_t>(sizeof(T)));
+    bench::setItems(state, n);
+}
+
+static void chains(benchmark::internal::Benchmark *b) {
+    for (int chain : {1, 4, 16}) {
+        for (int64_t n = 1 << 12; n <= 1 << 24; n <<= 4) {
+            b->Args({n, chain});
+        }
+    }
+}
+
+BENCH_FLOATING(jitChain, chains);
+BENCH_FLOATING(jitTranscendental, bench::elements);
@@ -0,0 +1,53 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include "bench.hpp"
+
+using af::array;
+
+// The host time of dispatching a kernel, which is measured on arrays small
+// enough that the kernels take no time on the device. The argument is the
+// number of kernels launched before the device is synchronized, so the
+// latency of the synchronization is spread over them.
+static void launchKernel(benchmark::State &state) {
+    const int launches = static_cast<int>(state.range(0));
+    array a            = af::randu(2, 2);
+    a.eval();
+    af::sync();
+
+    for (auto _ : state) {
+        for (int i = 0; i < launches; ++i) {
+            array out = af::transpose(a);
+            out.eval();
+        }
+        af::sync();
+    }
+    bench::setItems(state, launches);
+}
+
+// The same for the JIT kernels, whose lookup is keyed by the name of the
+// generated kernel
+static void launchJIT(benchmark::State &state) {
+    const int launches = static_cast<int>(state.range(0));
+    array a            = af::randu(4);
+    a.eval();
+    af::sync();
+
+    for (auto _ : state) {
+        for (int i = 0; i < launches; ++i) {
+            array out = a + 1.0f;
+            out.eval();
+        }
+        af::sync();
+    }
+    bench::setItems(state, launches);
+}
+
+BENCHMARK(launchKernel)->Arg(1)->Arg(64);
+BENCHMARK(launchJIT)->Arg(1)->Arg(64);
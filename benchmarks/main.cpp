@@ -0,0 +1,38 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+int main(int argc, char **argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) { return 1; }
+
+    // The version and the device are written to the context of the JSON
+    // output, so results from different releases and machines can be told
+    // apart
+    int major = 0, minor = 0, patch = 0;
+    af_get_version(&major, &minor, &patch);
+    benchmark::AddCustomContext(
+        "arrayfire_version", std::to_string(major) + "." +
+                                 std::to_string(minor) + "." +
+                                 std::to_string(patch) + " (" +
+                                 af_get_revision() + ")");
+
+    char name[256], platform[256], toolkit[256], compute[256];
+    af::deviceInfo(name, platform, toolkit, compute);
+    benchmark::AddCustomContext("arrayfire_device", name);
+    benchmark::AddCustomContext("arrayfire_platform", platform);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,67 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include "bench.hpp"
+
+#include <vector>
+
+using af::array;
+
+// The argument is the number of bytes of each allocation
+
+// Allocates and frees one buffer, which is reused from the cache of the
+// memory manager after the first iteration
+static void allocFree(benchmark::State &state) {
+    const size_t bytes = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        void *ptr = af::allocV2(bytes);
+        benchmark::DoNotOptimize(ptr);
+        af::freeV2(ptr);
+    }
+    bench::setItems(state, 1);
+}
+
+// Allocates 64 buffers before freeing them, so every allocation of an
+// iteration needs a different buffer
+static void allocFreeBatch(benchmark::State &state) {
+    const size_t bytes = static_cast<size_t>(state.range(0));
+    std::vector<void *> ptrs(64);
+    for (auto _ : state) {
+        for (void *&ptr : ptrs) { ptr = af::allocV2(bytes); }
+        for (void *ptr : ptrs) { af::freeV2(ptr); }
+    }
+    bench::setItems(state, static_cast<int64_t>(ptrs.size()));
+}
+
+// Creates and destroys the temporary arrays of an expression which is
+// evaluated in steps, as in a loop of an iterative solver
+static void arrayTemporaries(benchmark::State &state) {
+    const dim_t n = state.range(0) / 4;
+    array a       = af::randu(n);
+    array b       = af::randu(n);
+    a.eval();
+    b.eval();
+
+    bench::run(state, [&]() {
+        array c = a + b;
+        c.eval();
+        array d = c * a;
+        d.eval();
+        return d - b;
+    });
+    bench::setItems(state, 3);
+}
+
+static void sizes(benchmark::internal::Benchmark *b) {
+    b->RangeMultiplier(16)->Range(1 << 10, 1 << 26);
+}
+
+BENCHMARK(allocFree)->Apply(sizes);
+BENCHMARK(allocFreeBatch)->Apply(sizes);
+BENCHMARK(arrayTemporaries)->Apply(sizes);
@@ -0,0 +1,91 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include "bench.hpp"
+
+using af::array;
+
+// Reductions and scans of a 1024 column matrix. The argument is the number
+// of elements.
+
+template<typename T>
+static void sumColumns(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n = state.range(0);
+    array a       = bench::random<T>(af::dim4(n / 1024, 1024));
+    a.eval();
+
+    bench::run(state, [&]() { return af::sum(a, 0); });
+    bench::setBytes(state, n * static_cast<int64_t>(sizeof(T)));
+}
+
+template<typename T>
+static void sumRows(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n = state.range(0);
+    array a       = bench::random<T>(af::dim4(n / 1024, 1024));
+    a.eval();
+
+    bench::run(state, [&]() { return af::sum(a, 1); });
+    bench::setBytes(state, n * static_cast<int64_t>(sizeof(T)));
+}
+
+template<typename T>
+static void sumAll(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n = state.range(0);
+    array a       = bench::random<T>(n);
+    a.eval();
+
+    bench::run(state, [&]() { return af::sum<double>(a); });
+    bench::setBytes(state, n * static_cast<int64_t>(sizeof(T)));
+}
+
+template<typename T>
+static void maxColumns(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n = state.range(0);
+    array a       = bench::random<T>(af::dim4(n / 1024, 1024));
+    a.eval();
+
+    bench::run(state, [&]() { return af::max(a, 0); });
+    bench::setBytes(state, n * static_cast<int64_t>(sizeof(T)));
+}
+
+template<typename T>
+static void scanColumns(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n = state.range(0);
+    array a       = bench::random<T>(af::dim4(n / 1024, 1024));
+    a.eval();
+
+    bench::run(state, [&]() { return af::accum(a, 0); });
+    bench::setBytes(state, 2 * n * static_cast<int64_t>(sizeof(T)));
+}
+
+template<typename T>
+static void scanByKey(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n = state.range(0);
+    array a       = bench::random<T>(n);
+    // Segments of 64 elements
+    array keys = af::range(af::dim4(n), 0, s32) / 64;
+    a.eval();
+    keys.eval();
+
+    bench::run(state, [&]() { return af::scanByKey(keys, a); });
+    bench::setBytes(state, n * static_cast<int64_t>(2 * sizeof(T) + 4));
+}
+
+BENCH_NUMERIC(sumColumns, bench::elements);
+BENCH_NUMERIC(sumRows, bench::elements);
+BENCH_NUMERIC(sumAll, bench::elements);
+BENCH_NUMERIC(maxColumns, bench::elements);
+BENCH_NUMERIC(scanColumns, bench::elements);
+BENCH_NUMERIC(scanByKey, bench::elements);
@@ -0,0 +1,94 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include "bench.hpp"
+
+#include <cmath>
+
+using af::array;
+
+// The argument of fft is the number of elements
+template<typename T>
+static void fft(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n = state.range(0);
+    array a       = bench::random<T>(n);
+    a.eval();
+
+    bench::run(state, [&]() { return af::fft(a); });
+    state.counters["FLOPS"] = benchmark::Counter(
+        5.0 * n * std::log2(static_cast<double>(n)),
+        benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// The argument of fft2 is the number of rows of the square image
+template<typename T>
+static void fft2(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n = state.range(0);
+    array a       = bench::random<T>(af::dim4(n, n));
+    a.eval();
+
+    bench::run(state, [&]() { return af::fft2(a); });
+    state.counters["FLOPS"] = benchmark::Counter(
+        5.0 * n * n * std::log2(static_cast<double>(n * n)),
+        benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// The arguments of the convolutions are the number of rows of the square
+// image and the number of rows of the square filter
+template<typename T>
+static void convolve2(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n = state.range(0);
+    const dim_t k = state.range(1);
+    array image   = bench::random<T>(af::dim4(n, n));
+    array filter  = bench::random<T>(af::dim4(k, k));
+    image.eval();
+    filter.eval();
+
+    bench::run(state, [&]() { return af::convolve2(image, filter); });
+    bench::setItems(state, n * n);
+}
+
+// Separable filters are convolved as a column and a row
+template<typename T>
+static void convolve2Separable(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n = state.range(0);
+    const dim_t k = state.range(1);
+    array image   = bench::random<T>(af::dim4(n, n));
+    array column  = bench::random<T>(af::dim4(k));
+    array row     = bench::random<T>(af::dim4(k));
+    image.eval();
+    column.eval();
+    row.eval();
+
+    bench::run(state, [&]() { return af::convolve(column, row, image); });
+    bench::setItems(state, n * n);
+}
+
+static void images(benchmark::internal::Benchmark *b) {
+    for (int64_t k : {3, 5, 11}) {
+        for (int64_t n = 512; n <= 4096; n <<= 1) { b->Args({n, k}); }
+    }
+}
+
+static void signals(benchmark::internal::Benchmark *b) {
+    b->RangeMultiplier(4)->Range(1 << 10, 1 << 22);
+}
+
+BENCHMARK_TEMPLATE(fft, float)->Apply(signals);
+BENCHMARK_TEMPLATE(fft, double)->Apply(signals);
+BENCHMARK_TEMPLATE(fft2, float)->Apply(bench::matrices);
+BENCHMARK_TEMPLATE(fft2, double)->Apply(bench::matrices);
+BENCHMARK_TEMPLATE(convolve2, float)->Apply(images);
+BENCHMARK_TEMPLATE(convolve2, double)->Apply(images);
+BENCHMARK_TEMPLATE(convolve2Separable, float)->Apply(images);
+BENCHMARK_TEMPLATE(convolve2Separable, double)->Apply(images);
@@ -0,0 +1,60 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include "bench.hpp"
+
+using af::array;
+
+// The argument is the number of elements
+
+template<typename T>
+static void sort(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n = state.range(0);
+    array a       = bench::random<T>(n);
+    a.eval();
+
+    bench::run(state, [&]() { return af::sort(a); });
+    bench::setBytes(state, 2 * n * static_cast<int64_t>(sizeof(T)));
+    bench::setItems(state, n);
+}
+
+template<typename T>
+static void sortByKey(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n = state.range(0);
+    array keys    = bench::random<T>(n);
+    array values  = af::range(af::dim4(n), 0, s32);
+    keys.eval();
+    values.eval();
+
+    bench::run(state, [&]() {
+        array out_keys, out_values;
+        af::sort(out_keys, out_values, keys, values);
+        return out_values;
+    });
+    bench::setBytes(state, 2 * n * static_cast<int64_t>(sizeof(T) + 4));
+    bench::setItems(state, n);
+}
+
+template<typename T>
+static void sortColumns(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n = state.range(0);
+    array a       = bench::random<T>(af::dim4(1024, n / 1024));
+    a.eval();
+
+    bench::run(state, [&]() { return af::sort(a, 0); });
+    bench::setBytes(state, 2 * n * static_cast<int64_t>(sizeof(T)));
+    bench::setItems(state, n);
+}
+
+BENCH_NUMERIC(sort, bench::elements);
+BENCH_NUMERIC(sortByKey, bench::elements);
+BENCH_NUMERIC(sortColumns, bench::elements);
@@ -0,0 +1,47 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include "bench.hpp"
+
+using af::array;
+
+// Multiplies a CSR matrix by a dense vector. The first argument is the
+// number of rows of the square matrix and the second is the number of
+// nonzeros of each row.
+template<typename T>
+static void spmv(benchmark::State &state) {
+    if (!bench::isSupported<T>(state)) { return; }
+    const dim_t n   = state.range(0);
+    const dim_t nnz = state.range(1);
+
+    // Each row has nnz nonzeros in random columns
+    array rows    = af::range(af::dim4(nnz, n), 1, s32);
+    array columns = (af::randu(nnz, n) * (n - 1)).as(s32);
+    array values  = bench::random<T>(af::dim4(nnz * n));
+    array coo     = af::sparse(n, n, values, af::flat(rows),
+                               af::flat(columns), AF_STORAGE_COO);
+    array csr     = af::sparseConvertTo(coo, AF_STORAGE_CSR);
+    array x       = bench::random<T>(af::dim4(n));
+    csr.eval();
+    x.eval();
+
+    bench::run(state, [&]() { return af::matmul(csr, x); });
+    bench::setBytes(state, n * nnz * static_cast<int64_t>(sizeof(T) + 4));
+    state.counters["FLOPS"] = benchmark::Counter(
+        2.0 * n * nnz, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+static void matrices(benchmark::internal::Benchmark *b) {
+    for (int64_t nnz : {8, 64}) {
+        for (int64_t n = 1 << 12; n <= 1 << 20; n <<= 2) { b->Args({n, nnz}); }
+    }
+}
+
+BENCHMARK_TEMPLATE(spmv, float)->Apply(matrices);
+BENCHMARK_TEMPLATE(spmv, double)->Apply(matrices);
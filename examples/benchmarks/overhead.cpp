@@ -0,0 +1,79 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+/*
+   per call overhead of the API
+
+   Calls which do (almost) no work on tiny arrays, so the time is spent in
+   the handle checks, type dispatch and backend selection of each call.
+*/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <cstdlib>
+using namespace af;
+
+static const int calls = 100000;
+static array a, b;
+
+// Only reads the metadata of the handle
+static void get_dims() {
+    dim_t d[4];
+    for (int i = 0; i < calls; ++i) {
+        af_get_dims(d, d + 1, d + 2, d + 3, a.get());
+    }
+}
+
+// Creates and releases a handle
+static void retain_release() {
+    for (int i = 0; i < calls; ++i) {
+        af_array h = 0;
+        af_retain_array(&h, a.get());
+        af_release_array(h);
+    }
+}
+
+// Creates a JIT node which is never evaluated
+static void add_lazy() {
+    for (int i = 0; i < calls; ++i) {
+        af_array h = 0;
+        af_add(&h, a.get(), b.get(), false);
+        af_release_array(h);
+    }
+}
+
+static void print_rate(const char* name, double seconds) {
+    printf("%16s: %8.3f us per call\n", name, seconds * 1e6 / calls);
+}
+
+int main(int argc, char** argv) {
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        a = randu(4);
+        b = randu(4);
+        a.eval();
+        b.eval();
+
+        print_rate("af_get_dims", timeit(get_dims));
+        print_rate("retain/release", timeit(retain_release));
+        print_rate("af_add (lazy)", timeit(add_lazy));
+
+        // Released before the library is unloaded
+        a = array();
+        b = array();
+    } catch (exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    return 0;
+}
@@ -445,6 +445,190 @@ namespace af
     */
     template<typename T> T count(const array &in);
 
+#if AF_API_VERSION >= 38
+    /**
+       C++ Interface for computing several statistics of all the values of an
+       array in one pass
+
+       \param[out] min   will contain the smallest value of \p in. Can be NULL
+       \param[out] max   will contain the largest value of \p in. Can be NULL
+       \param[out] sum   will contain the sum of the values of \p in. Can be
+                         NULL
+       \param[out] sumsq will contain the sum of the squares of the values of
+                         \p in. Can be NULL
+       \param[out] count will contain the number of non-zero values in \p in.
+                         Can be NULL
+       \param[in]  in    is the input array
+
+       \ingroup reduce_func_summary
+
+       \note NaN values are ignored by \p min and \p max
+    */
+    AFAPI void summary(double *min, double *max, double *sum, double *sumsq,
+                       double *count, const array &in);
+#endif
+
+#if AF_API_VERSION >= 38
+    /**
+       C++ Interface for the sum of the segments of an array
+
+       \param[in] in is the input array
+       \param[in] offsets is the s32 or u32 vector of the offsets of the
+                  segments along the first dimension of \p in
+       \return the sum of each segment of \p in, 0 for empty segments
+
+       \ingroup reduce_func_segmented
+    */
+    AFAPI array sumSegmented(const array &in, const array &offsets);
+
+    /**
+       C++ Interface for the minimum of the segments of an array
+
+       \param[in] in is the input array
+       \param[in] offsets is the s32 or u32 vector of the offsets of the
+                  segments along the first dimension of \p in
+       \return the minimum of each segment of \p in, the largest value of
+               the type for empty segments
+
+       \ingroup reduce_func_segmented
+    */
+    AFAPI array minSegmented(const array &in, const array &offsets);
+
+    /**
+       C++ Interface for the maximum of the segments of an array
+
+       \param[in] in is the input array
+       \param[in] offsets is the s32 or u32 vector of the offsets of the
+                  segments along the first dimension of \p in
+       \return the maximum of each segment of \p in, the lowest value of
+               the type for empty segments
+
+       \ingroup reduce_func_segmented
+    */
+    AFAPI array maxSegmented(const array &in, const array &offsets);
+
+    /**
+       C++ Interface for the reduction by key of unsorted keys
+
+       \param[out] keys_out will contain the distinct keys of \p keys, sorted
+                   in ascending order
+       \param[out] vals_out will contain the reduced values of each key
+       \param[in] keys is the s32 or u32 vector of the keys of the values
+       \param[in] vals is the vector of values, with the length of \p keys
+       \param[in] op is the reduction: \ref AF_BINARY_ADD, \ref
+                  AF_BINARY_MIN or \ref AF_BINARY_MAX
+
+       \ingroup reduce_func_by_key_unsorted
+    */
+    AFAPI void reduceByKeyUnsorted(array &keys_out, array &vals_out,
+                                   const array &keys, const array &vals,
+                                   const binaryOp op = AF_BINARY_ADD);
+#endif
+
+#if AF_API_VERSION >= 38
+    /**
+       C++ Interface for summing an array along several dimensions
+
+       \param[in] in is the input array
+       \param[in] ndims is the number of dimensions in \p dims
+       \param[in] dims are the distinct dimensions to reduce
+       \return the sum of the values of \p in along \p dims, whose lengths
+               become 1
+
+       \ingroup reduce_func_dims
+    */
+    AFAPI array sumDims(const array &in, const unsigned ndims,
+                        const int *dims);
+
+    /**
+       C++ Interface for multiplying the values of an array along several
+       dimensions
+
+       \param[in] in is the input array
+       \param[in] ndims is the number of dimensions in \p dims
+       \param[in] dims are the distinct dimensions to reduce
+       \return the product of the values of \p in along \p dims, whose lengths
+               become 1
+
+       \ingroup reduce_func_dims
+    */
+    AFAPI array productDims(const array &in, const unsigned ndims,
+                            const int *dims);
+
+    /**
+       C++ Interface for the minimum values of an array along several dimensions
+
+       \param[in] in is the input array
+       \param[in] ndims is the number of dimensions in \p dims
+       \param[in] dims are the distinct dimensions to reduce
+       \return the minimum of the values of \p in along \p dims, whose lengths
+               become 1
+
+       \ingroup reduce_func_dims
+    */
+    AFAPI array minDims(const array &in, const unsigned ndims,
+                        const int *dims);
+
+    /**
+       C++ Interface for the maximum values of an array along several dimensions
+
+       \param[in] in is the input array
+       \param[in] ndims is the number of dimensions in \p dims
+       \param[in] dims are the distinct dimensions to reduce
+       \return the maximum of the values of \p in along \p dims, whose lengths
+               become 1
+
+       \ingroup reduce_func_dims
+    */
+    AFAPI array maxDims(const array &in, const unsigned ndims,
+                        const int *dims);
+
+    /**
+       C++ Interface for counting the non-zero values of an array along several
+       dimensions
+
+       \param[in] in is the input array
+       \param[in] ndims is the number of dimensions in \p dims
+       \param[in] dims are the distinct dimensions to reduce
+       \return the number of non-zero values of the values of \p in along \p
+               dims, whose lengths become 1
+
+       \ingroup reduce_func_dims
+    */
+    AFAPI array countDims(const array &in, const unsigned ndims,
+                          const int *dims);
+
+    /**
+       C++ Interface for checking if all the values of an array along several
+       dimensions are true
+
+       \param[in] in is the input array
+       \param[in] ndims is the number of dimensions in \p dims
+       \param[in] dims are the distinct dimensions to reduce
+       \return whether all the values are true of the values of \p in along \p
+               dims, whose lengths become 1
+
+       \ingroup reduce_func_dims
+    */
+    AFAPI array allTrueDims(const array &in, const unsigned ndims,
+                            const int *dims);
+
+    /**
+       C++ Interface for checking if any of the values of an array along several
+       dimensions is true
+
+       \param[in] in is the input array
+       \param[in] ndims is the number of dimensions in \p dims
+       \param[in] dims are the distinct dimensions to reduce
+       \return whether any of the values is true of the values of \p in along \p
+               dims, whose lengths become 1
+
+       \ingroup reduce_func_dims
+    */
+    AFAPI array anyTrueDims(const array &in, const unsigned ndims,
+                            const int *dims);
+#endif
+
     /**
        C++ Interface for getting minimum values and their locations in an array
 
@@ -545,6 +729,24 @@ namespace af
                           binaryOp op = AF_BINARY_ADD, bool inclusive_scan = true);
 #endif
 
+#if AF_API_VERSION >= 38
+    /**
+       C++ Interface for scanning the segments of an array
+
+       \param[in] in is the input array
+       \param[in] offsets is the s32 or u32 vector of the offsets of the
+                  segments along the first dimension of \p in
+       \param[in] op is the type of binary operation used
+       \param[in] inclusive_scan is flag specifying whether scan is inclusive
+       \return the scan of each segment of \p in
+
+       \ingroup scan_func_scan_segmented
+    */
+    AFAPI array scanSegmented(const array &in, const array &offsets,
+                              binaryOp op         = AF_BINARY_ADD,
+                              bool inclusive_scan = true);
+#endif
+
     /**
        C++ Interface for finding the locations of non-zero values in an array
 
@@ -555,6 +757,21 @@ namespace af
     */
     AFAPI array where(const array &in);
 
+#if AF_API_VERSION >= 38
+    /**
+       C++ Interface for copying the values of an array where a mask is true
+
+       \param[in] in is the input array
+       \param[in] mask is the b8 array of the values to keep, with the
+                  dimensions of \p in
+       \return the vector of the values of \p in where \p mask is true, in
+               the order of their linear indices
+
+       \ingroup scan_func_compact
+    */
+    AFAPI array compact(const array &in, const array &mask);
+#endif
+
     /**
        C++ Interface for calculating first order differences in an array
 
@@ -619,6 +836,41 @@ namespace af
                      const array &values, const unsigned dim = 0,
                      const bool isAscending = true);
 
+#if AF_API_VERSION >= 38
+    /**
+       C++ Interface for sorting the segments of an array
+
+       \param[in] in is the input array
+       \param[in] offsets is the s32 or u32 vector of the offsets of the
+                  segments along the first dimension of \p in
+       \param[in] isAscending specifies the sorting order
+       \return the values of \p in sorted within each segment
+
+       \ingroup sort_func_sort_segmented
+    */
+    AFAPI array sortSegmented(const array &in, const array &offsets,
+                              const bool isAscending = true);
+
+    /**
+       C++ Interface for sorting the segments of an array based on keys
+
+       \param[out] out_keys will contain the keys sorted within each segment
+       \param[out] out_values will contain the values in the order of the
+                   keys
+       \param[in] keys is the input array
+       \param[in] values is the array of the values of \p keys
+       \param[in] offsets is the s32 or u32 vector of the offsets of the
+                  segments along the first dimension of \p keys
+       \param[in] isAscending specifies the sorting order
+
+       \ingroup sort_func_sort_segmented
+    */
+    AFAPI void sortByKeySegmented(array &out_keys, array &out_values,
+                                  const array &keys, const array &values,
+                                  const array &offsets,
+                                  const bool isAscending = true);
+#endif
+
     /**
        C++ Interface for getting unique values
 
@@ -1108,6 +1360,209 @@ extern "C" {
     */
     AFAPI af_err af_count_all(double *real, double *imag, const af_array in);
 
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for computing several statistics of all the values of an
+       array in one pass
+
+       \param[out] min   will contain the smallest value of \p in. Can be NULL
+       \param[out] max   will contain the largest value of \p in. Can be NULL
+       \param[out] sum   will contain the sum of the values of \p in. Can be
+                         NULL
+       \param[out] sumsq will contain the sum of the squares of the values of
+                         \p in. Can be NULL
+       \param[out] count will contain the number of non-zero values in \p in.
+                         Can be NULL
+       \param[in]  in    is the input array
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_summary
+
+       \note NaN values are ignored by \p min and \p max
+    */
+    AFAPI af_err af_summary_all(double *min, double *max, double *sum,
+                                double *sumsq, double *count,
+                                const af_array in);
+#endif
+
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for the sum of the segments of an array
+
+       \param[out] out will contain the sum of each segment of \p in, 0 for
+                   empty segments
+       \param[in] in is the input array
+       \param[in] offsets is the s32 or u32 vector of the offsets of the
+                  segments along the first dimension of \p in
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_segmented
+    */
+    AFAPI af_err af_sum_segmented(af_array *out, const af_array in,
+                                  const af_array offsets);
+
+    /**
+       C Interface for the minimum of the segments of an array
+
+       \param[out] out will contain the minimum of each segment of \p in, the
+                   largest value of the type for empty segments
+       \param[in] in is the input array
+       \param[in] offsets is the s32 or u32 vector of the offsets of the
+                  segments along the first dimension of \p in
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_segmented
+    */
+    AFAPI af_err af_min_segmented(af_array *out, const af_array in,
+                                  const af_array offsets);
+
+    /**
+       C Interface for the maximum of the segments of an array
+
+       \param[out] out will contain the maximum of each segment of \p in, the
+                   lowest value of the type for empty segments
+       \param[in] in is the input array
+       \param[in] offsets is the s32 or u32 vector of the offsets of the
+                  segments along the first dimension of \p in
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_segmented
+    */
+    AFAPI af_err af_max_segmented(af_array *out, const af_array in,
+                                  const af_array offsets);
+
+    /**
+       C Interface for the reduction by key of unsorted keys
+
+       \param[out] keys_out will contain the distinct keys of \p keys, sorted
+                   in ascending order
+       \param[out] vals_out will contain the reduced values of each key
+       \param[in] keys is the s32 or u32 vector of the keys of the values
+       \param[in] vals is the vector of values, with the length of \p keys
+       \param[in] op is the reduction: \ref AF_BINARY_ADD, \ref
+                  AF_BINARY_MIN or \ref AF_BINARY_MAX
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_by_key_unsorted
+    */
+    AFAPI af_err af_reduce_by_key_unsorted(af_array *keys_out,
+                                           af_array *vals_out,
+                                           const af_array keys,
+                                           const af_array vals,
+                                           const af_binary_op op);
+#endif
+
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for summing an array along several dimensions
+
+       \param[out] out will contain the sum of the values of \p in along \p
+                   dims, whose lengths become 1
+       \param[in] in is the input array
+       \param[in] ndims is the number of dimensions in \p dims
+       \param[in] dims are the distinct dimensions to reduce
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_dims
+    */
+    AFAPI af_err af_sum_dims(af_array *out, const af_array in,
+                             const unsigned ndims, const int *dims);
+
+    /**
+       C Interface for multiplying the values of an array along several
+       dimensions
+
+       \param[out] out will contain the product of the values of \p in along \p
+                   dims, whose lengths become 1
+       \param[in] in is the input array
+       \param[in] ndims is the number of dimensions in \p dims
+       \param[in] dims are the distinct dimensions to reduce
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_dims
+    */
+    AFAPI af_err af_product_dims(af_array *out, const af_array in,
+                                 const unsigned ndims, const int *dims);
+
+    /**
+       C Interface for the minimum values of an array along several dimensions
+
+       \param[out] out will contain the minimum of the values of \p in along \p
+                   dims, whose lengths become 1
+       \param[in] in is the input array
+       \param[in] ndims is the number of dimensions in \p dims
+       \param[in] dims are the distinct dimensions to reduce
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_dims
+    */
+    AFAPI af_err af_min_dims(af_array *out, const af_array in,
+                             const unsigned ndims, const int *dims);
+
+    /**
+       C Interface for the maximum values of an array along several dimensions
+
+       \param[out] out will contain the maximum of the values of \p in along \p
+                   dims, whose lengths become 1
+       \param[in] in is the input array
+       \param[in] ndims is the number of dimensions in \p dims
+       \param[in] dims are the distinct dimensions to reduce
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_dims
+    */
+    AFAPI af_err af_max_dims(af_array *out, const af_array in,
+                             const unsigned ndims, const int *dims);
+
+    /**
+       C Interface for counting the non-zero values of an array along several
+       dimensions
+
+       \param[out] out will contain the number of non-zero values of the values
+                   of \p in along \p dims, whose lengths become 1
+       \param[in] in is the input array
+       \param[in] ndims is the number of dimensions in \p dims
+       \param[in] dims are the distinct dimensions to reduce
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_dims
+    */
+    AFAPI af_err af_count_dims(af_array *out, const af_array in,
+                               const unsigned ndims, const int *dims);
+
+    /**
+       C Interface for checking if all the values of an array along several
+       dimensions are true
+
+       \param[out] out will contain whether all the values are true of the
+                   values of \p in along \p dims, whose lengths become 1
+       \param[in] in is the input array
+       \param[in] ndims is the number of dimensions in \p dims
+       \param[in] dims are the distinct dimensions to reduce
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_dims
+    */
+    AFAPI af_err af_all_true_dims(af_array *out, const af_array in,
+                                  const unsigned ndims, const int *dims);
+
+    /**
+       C Interface for checking if any of the values of an array along several
+       dimensions is true
+
+       \param[out] out will contain whether any of the values is true of the
+                   values of \p in along \p dims, whose lengths become 1
+       \param[in] in is the input array
+       \param[in] ndims is the number of dimensions in \p dims
+       \param[in] dims are the distinct dimensions to reduce
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_dims
+    */
+    AFAPI af_err af_any_true_dims(af_array *out, const af_array in,
+                                  const unsigned ndims, const int *dims);
+#endif
+
     /**
        C Interface for getting minimum values and their locations in an array
 
@@ -1167,6 +1622,155 @@ extern "C" {
     */
     AFAPI af_err af_imax_all(double *real, double *imag, unsigned *idx, const af_array in);
 
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for the sum of all elements in an array, on the device
+
+       Unlike \ref af_sum_all, the result stays on the device as a one
+       element array, so the function does not wait for the device. The
+       result can be used by further functions and JIT expressions, and read
+       without blocking with \ref af_get_data_ptr_async.
+
+       \param[out] out will contain a one element array with the sum of all
+                   elements in input \p in. It is empty if \p in is empty.
+       \param[in] in is the input array
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_sum
+    */
+    AFAPI af_err af_sum_all_array(af_array *out, const af_array in);
+
+    /**
+       C Interface for the sum of all elements in an array while replacing
+       nans, on the device (see \ref af_sum_all_array)
+
+       \param[out] out will contain a one element array with the sum
+       \param[in] in is the input array
+       \param[in] nanval is the value which replaces nan
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_sum
+    */
+    AFAPI af_err af_sum_nan_all_array(af_array *out, const af_array in,
+                                      const double nanval);
+
+    /**
+       C Interface for the product of all elements in an array, on the
+       device (see \ref af_sum_all_array)
+
+       \param[out] out will contain a one element array with the product
+       \param[in] in is the input array
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_product
+    */
+    AFAPI af_err af_product_all_array(af_array *out, const af_array in);
+
+    /**
+       C Interface for the product of all elements in an array while
+       replacing nans, on the device (see \ref af_sum_all_array)
+
+       \param[out] out will contain a one element array with the product
+       \param[in] in is the input array
+       \param[in] nanval is the value which replaces nan
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_product
+    */
+    AFAPI af_err af_product_nan_all_array(af_array *out, const af_array in,
+                                          const double nanval);
+
+    /**
+       C Interface for the minimum of all elements in an array, on the
+       device (see \ref af_sum_all_array)
+
+       \param[out] out will contain a one element array with the minimum
+       \param[in] in is the input array
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_min
+    */
+    AFAPI af_err af_min_all_array(af_array *out, const af_array in);
+
+    /**
+       C Interface for the maximum of all elements in an array, on the
+       device (see \ref af_sum_all_array)
+
+       \param[out] out will contain a one element array with the maximum
+       \param[in] in is the input array
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_max
+    */
+    AFAPI af_err af_max_all_array(af_array *out, const af_array in);
+
+    /**
+       C Interface for checking if all elements in an array are true, on
+       the device (see \ref af_sum_all_array)
+
+       \param[out] out will contain a one element b8 array
+       \param[in] in is the input array
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_all_true
+    */
+    AFAPI af_err af_all_true_all_array(af_array *out, const af_array in);
+
+    /**
+       C Interface for checking if any element in an array is true, on the
+       device (see \ref af_sum_all_array)
+
+       \param[out] out will contain a one element b8 array
+       \param[in] in is the input array
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_any_true
+    */
+    AFAPI af_err af_any_true_all_array(af_array *out, const af_array in);
+
+    /**
+       C Interface for counting the non-zero elements in an array, on the
+       device (see \ref af_sum_all_array)
+
+       \param[out] out will contain a one element u32 array with the count
+       \param[in] in is the input array
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_count
+    */
+    AFAPI af_err af_count_all_array(af_array *out, const af_array in);
+
+    /**
+       C Interface for the minimum value of an array and its location, on
+       the device (see \ref af_sum_all_array)
+
+       \param[out] val will contain a one element array with the minimum
+       \param[out] idx will contain a one element u32 array with the linear
+                   index of the minimum
+       \param[in] in is the input array
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_min
+    */
+    AFAPI af_err af_imin_all_array(af_array *val, af_array *idx,
+                                   const af_array in);
+
+    /**
+       C Interface for the maximum value of an array and its location, on
+       the device (see \ref af_sum_all_array)
+
+       \param[out] val will contain a one element array with the maximum
+       \param[out] idx will contain a one element u32 array with the linear
+                   index of the maximum
+       \param[in] in is the input array
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup reduce_func_max
+    */
+    AFAPI af_err af_imax_all_array(af_array *val, af_array *idx,
+                                   const af_array in);
+#endif
+
     /**
        C Interface for computing the cumulative sum (inclusive) of an array
 
@@ -1214,6 +1818,26 @@ extern "C" {
 
 #endif
 
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for scanning the segments of an array
+
+       \param[out] out will contain the scan of each segment of \p in
+       \param[in] in is the input array
+       \param[in] offsets is the s32 or u32 vector of the offsets of the
+                  segments along the first dimension of \p in
+       \param[in] op is the type of binary operation used
+       \param[in] inclusive_scan is flag specifying whether scan is inclusive
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup scan_func_scan_segmented
+    */
+    AFAPI af_err af_scan_segmented(af_array *out, const af_array in,
+                                   const af_array offsets,
+                                   const af_binary_op op,
+                                   const bool inclusive_scan);
+#endif
+
     /**
        C Interface for finding the locations of non-zero values in an array
 
@@ -1225,6 +1849,23 @@ extern "C" {
     */
     AFAPI af_err af_where(af_array *idx, const af_array in);
 
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for copying the values of an array where a mask is true
+
+       \param[out] out will contain the vector of the values of \p in where
+                   \p mask is true, in the order of their linear indices
+       \param[in] in is the input array
+       \param[in] mask is the b8 array of the values to keep, with the
+                  dimensions of \p in
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup scan_func_compact
+    */
+    AFAPI af_err af_compact(af_array *out, const af_array in,
+                            const af_array mask);
+#endif
+
     /**
        C Interface for calculating first order differences in an array
 
@@ -1294,6 +1935,47 @@ extern "C" {
                                 const af_array keys, const af_array values,
                                 const unsigned dim, const bool isAscending);
 
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for sorting the segments of an array
+
+       \param[out] out will contain the values of \p in sorted within each
+                   segment
+       \param[in] in is the input array
+       \param[in] offsets is the s32 or u32 vector of the offsets of the
+                  segments along the first dimension of \p in
+       \param[in] isAscending specifies the sorting order
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup sort_func_sort_segmented
+    */
+    AFAPI af_err af_sort_segmented(af_array *out, const af_array in,
+                                   const af_array offsets,
+                                   const bool isAscending);
+
+    /**
+       C Interface for sorting the segments of an array based on keys
+
+       \param[out] out_keys will contain the keys sorted within each segment
+       \param[out] out_values will contain the values in the order of the
+                   keys
+       \param[in] keys is the input array
+       \param[in] values is the array of the values of \p keys
+       \param[in] offsets is the s32 or u32 vector of the offsets of the
+                  segments along the first dimension of \p keys
+       \param[in] isAscending specifies the sorting order
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup sort_func_sort_segmented
+    */
+    AFAPI af_err af_sort_by_key_segmented(af_array *out_keys,
+                                          af_array *out_values,
+                                          const af_array keys,
+                                          const af_array values,
+                                          const af_array offsets,
+                                          const bool isAscending);
+#endif
+
     /**
        C Interface for getting unique values
 
@@ -567,6 +567,36 @@ namespace af
     ///
     /// \ingroup arith_func_isnan
     AFAPI array isNaN  (const array &in);
+
+#if AF_API_VERSION >= 38
+    /// C++ Interface for quantizing an array to 8 bits
+    ///
+    /// \param[in] in is the real floating point input
+    /// \param[in] scale is one scale for \p in, or one per index of
+    ///            dimension \p dim
+    /// \param[in] zero is the zero point, with as many values as \p scale.
+    ///            An empty array is a zero point of 0.
+    /// \param[in] dim is the dimension of the channels of \p in
+    /// \return the u8 array round(in / scale) + zero, clamped to [0, 255]
+    ///
+    /// \ingroup arith_func_cast
+    AFAPI array quantize(const array &in, const array &scale,
+                         const array &zero, const int dim = 0);
+
+    /// C++ Interface for dequantizing an integer array
+    ///
+    /// \param[in] in is the integer input
+    /// \param[in] scale is one scale for \p in, or one per index of
+    ///            dimension \p dim
+    /// \param[in] zero is the zero point, with as many values as \p scale.
+    ///            An empty array is a zero point of 0.
+    /// \param[in] dim is the dimension of the channels of \p in
+    /// \return the f32 array (in - zero) * scale
+    ///
+    /// \ingroup arith_func_cast
+    AFAPI array dequantize(const array &in, const array &scale,
+                           const array &zero, const int dim = 0);
+#endif
 }
 #endif
 
@@ -831,6 +861,52 @@ extern "C" {
     */
     AFAPI af_err af_cast    (af_array *out, const af_array in, const af_dtype type);
 
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for quantizing an array to 8 bits
+
+       Computes round(in / scale) + zero, clamped to [0, 255], with one JIT
+       kernel.
+
+       \param[out] out will contain the u8 values
+       \param[in] in is the real floating point input
+       \param[in] scale is one scale for \p in, or one per index of
+                  dimension \p dim
+       \param[in] zero is the zero point, with as many values as \p scale,
+                  or 0 for a zero point of 0
+       \param[in] dim is the dimension of the channels of \p in
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup arith_func_cast
+    */
+    AFAPI af_err af_quantize(af_array *out, const af_array in,
+                             const af_array scale, const af_array zero,
+                             const int dim);
+
+    /**
+       C Interface for dequantizing an integer array
+
+       Computes (in - zero) * scale in f32. The operations are JIT nodes, so
+       they are fused into the kernel of the expression which uses the
+       result. The s32 product of \ref af_matmul_quantized is dequantized
+       with the products of the scales of its inputs and no zero point.
+
+       \param[out] out will contain the f32 values
+       \param[in] in is the integer input
+       \param[in] scale is one scale for \p in, or one per index of
+                  dimension \p dim
+       \param[in] zero is the zero point, with as many values as \p scale,
+                  or 0 for a zero point of 0
+       \param[in] dim is the dimension of the channels of \p in
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup arith_func_cast
+    */
+    AFAPI af_err af_dequantize(af_array *out, const af_array in,
+                               const af_array scale, const af_array zero,
+                               const int dim);
+#endif
+
     /**
        C Interface for min of two arrays
 
@@ -12,6 +12,7 @@
 #include <af/defines.h>
 #include <af/device.h>
 #include <af/dim4.hpp>
+#include <af/event.h>
 #include <af/exception.h>
 #include <af/index.h>
 #include <af/seq.h>
@@ -647,6 +648,48 @@ namespace af
         */
         template<typename T> void write(const T *ptr, const size_t bytes, af::source src = afHost);
 
+#if AF_API_VERSION >= 38
+        /**
+           Copy array data to an existing host pointer without waiting for
+           the transfer
+
+           \param[out] ptr The host pointer. It holds the data of the array
+                           once the returned event is complete.
+
+           \returns an event which is complete once the data has arrived
+
+           \note See \ref af_get_data_ptr_async
+        */
+        event hostAsync(void *ptr) const;
+
+        /**
+           Copy data from a host/device pointer to the array without waiting
+           for the transfer
+
+           \param[in] ptr   The pointer to the data
+           \param[in] bytes The number of bytes to copy
+           \param[in] src   The location of \p ptr
+
+           \returns an event which is complete once the array holds the data
+
+           \note See \ref af_write_array_async
+        */
+        event writeAsync(const void *ptr, const size_t bytes,
+                         af::source src = afHost);
+
+        /**
+           Copy the array to another device without waiting for the transfer
+
+           \param[out] out    The copy of the array on \p device
+           \param[in]  device The device of \p out
+
+           \returns an event which is complete once \p out holds the data
+
+           \note See \ref af_copy_to_device
+        */
+        event copyToDevice(array &out, const int device) const;
+#endif
+
         /**
            Get array data type
         */
@@ -1549,6 +1592,60 @@ namespace af
     AFAPI bool getManualEvalFlag();
 #endif
 
+#if AF_API_VERSION >= 38
+    /**
+       Split an array along a dimension across devices
+
+       \param[out] outs        The \p num_devices parts of \p in. Part i is
+                               on \p devices[i].
+       \param[in]  in          The array to split
+       \param[in]  dim         The dimension along which \p in is split
+       \param[in]  num_devices The number of devices
+       \param[in]  devices     The devices of the parts
+       \param[out] events      The \p num_devices events marked after each
+                               part on the queue of its device. Can be NULL.
+
+       \note See \ref af_scatter
+    */
+    AFAPI void scatter(array *outs, const array &in, const int dim,
+                       const unsigned num_devices, const int *devices,
+                       event *events = 0);
+
+    /**
+       Join arrays from several devices along a dimension on one device
+
+       \param[in]  num_arrays The number of arrays
+       \param[in]  ins        The arrays to join. They can be on any device.
+       \param[in]  dim        The dimension along which the arrays are joined
+       \param[in]  device     The device of the result
+       \param[out] done       The event marked after the join on the queue of
+                              \p device. Can be NULL.
+
+       \returns the arrays joined on \p device
+
+       \note See \ref af_gather
+    */
+    AFAPI array gather(const unsigned num_arrays, const array *ins,
+                       const int dim, const int device, event *done = 0);
+
+    /**
+       Reduce arrays of the same size element-wise across devices
+
+       \param[out] outs       The \p num_arrays copies of the reduction. Copy i
+                              is on the device of \p ins[i].
+       \param[in]  num_arrays The number of arrays
+       \param[in]  ins        The arrays to reduce, one on each device
+       \param[in]  op         The reduction
+       \param[out] events     The \p num_arrays events marked after each copy
+                              on the queue of its device. Can be NULL.
+
+       \note See \ref af_all_reduce
+    */
+    AFAPI void allReduce(array *outs, const unsigned num_arrays,
+                         const array *ins, const binaryOp op = AF_BINARY_ADD,
+                         event *events = 0);
+#endif
+
     /**
        @}
     */
@@ -1612,6 +1709,205 @@ extern "C" {
     */
     AFAPI af_err af_get_data_ptr(void *data, const af_array arr);
 
+#if AF_API_VERSION >= 38
+    /**
+       Copy data from a C pointer (host/device) to an existing array without
+       waiting for the transfer
+
+       Memory allocated by \ref af_alloc_pinned or registered by
+       \ref af_register_host_memory is transferred directly and must not be
+       modified or freed until \p event is complete. Pageable
+       host memory is copied through pinned staging buffers. The copy of
+       each buffer overlaps with the transfer of the previous one and \p
+       data can be reused as soon as this function returns.
+
+       \param[out] event An event which is complete once \p arr holds the
+                         data. Release it with \ref af_delete_event.
+       \param[in]  arr   The array to write to
+       \param[in]  data  The pointer to the data
+       \param[in]  bytes The number of bytes to copy
+       \param[in]  src   The location of \p data
+
+       \returns \ref AF_SUCCESS if the transfer was queued
+    */
+    AFAPI af_err af_write_array_async(af_event *event, af_array arr,
+                                      const void *data, const size_t bytes,
+                                      af_source src);
+
+    /**
+       Create an array from host memory without waiting for the transfer
+
+       The array is created as by \ref af_create_array and \p data is
+       written to it as by \ref af_write_array_async. Memory allocated by
+       \ref af_alloc_pinned or registered by \ref af_register_host_memory is
+       transferred directly and must not be modified or freed until \p event
+       is complete.
+
+       \param[out] event An event which is complete once \p arr holds the
+                         data. Release it with \ref af_delete_event.
+       \param[out] arr   The new array
+       \param[in]  data  The data of the array in host memory
+       \param[in]  ndims The number of dimensions read from \p dims
+       \param[in]  dims  The size of each dimension
+       \param[in]  type  The type of the array
+
+       \returns \ref AF_SUCCESS if the transfer was queued
+    */
+    AFAPI af_err af_create_array_async(af_event *event, af_array *arr,
+                                       const void *data, const unsigned ndims,
+                                       const dim_t *const dims,
+                                       const af_dtype type);
+
+    /// The function which releases the host memory adopted by
+    /// \ref af_adopt_host_array. It is called with the memory and the user
+    /// data given to \ref af_adopt_host_array.
+    typedef void (*af_host_deleter)(void *data, void *user_data);
+
+    /**
+       Create an array which takes the ownership of host memory
+
+       In the CPU backend the array uses \p data as its buffer without a
+       copy, and \p deleter is called once the array and all the arrays
+       which share its buffer are released. The other backends copy \p data
+       to the device and call \p deleter before this function returns.
+
+       \param[out] arr       The new array
+       \param[in]  data      The data of the array in host memory. It must
+                             be aligned to the size of \p type in the CPU
+                             backend.
+       \param[in]  ndims     The number of dimensions read from \p dims
+       \param[in]  dims      The size of each dimension
+       \param[in]  type      The type of the array
+       \param[in]  deleter   The function which releases \p data. It can be
+                             NULL if \p data does not need to be released.
+       \param[in]  user_data The data passed to \p deleter
+
+       \returns \ref AF_SUCCESS if the array was created. The caller keeps
+                the ownership of \p data if the arguments are invalid.
+    */
+    AFAPI af_err af_adopt_host_array(af_array *arr, void *data,
+                                     const unsigned ndims,
+                                     const dim_t *const dims,
+                                     const af_dtype type,
+                                     af_host_deleter deleter,
+                                     void *user_data);
+
+    /**
+       Copy data from an af_array to a C pointer without waiting for the
+       transfer
+
+       A destination allocated by \ref af_alloc_pinned or registered by
+       \ref af_register_host_memory receives the data directly and holds it
+       once \p event is complete. Pageable host
+       memory receives the data through pinned staging buffers and holds it
+       when this function returns.
+
+       \param[out] event An event which is complete once \p data holds the
+                         array. Release it with \ref af_delete_event.
+       \param[out] data  The destination. It must have room for all the
+                         elements of \p arr.
+       \param[in]  arr   The array to copy
+
+       \returns \ref AF_SUCCESS if the transfer was queued
+    */
+    AFAPI af_err af_get_data_ptr_async(af_event *event, void *data,
+                                       const af_array arr);
+
+    /**
+       Copy an array to another device without waiting for the transfer
+
+       The transfer is queued after the work on the device of \p in. In the
+       CUDA backend, the data is copied directly between the devices, and
+       peer access is enabled the first time two devices which support it
+       are used together. In the OpenCL backend, the data is copied through
+       host memory. The active device is not changed.
+
+       \param[out] event  An event marked after the transfer on the queue of
+                          \p device. Release it with \ref af_delete_event.
+       \param[out] out    The copy of \p in on \p device
+       \param[in]  in     The array to copy. It can be on any device.
+       \param[in]  device The device of \p out
+
+       \returns \ref AF_SUCCESS if the transfer was queued
+    */
+    AFAPI af_err af_copy_to_device(af_event *event, af_array *out,
+                                   const af_array in, const int device);
+
+    /**
+       Split an array along a dimension across devices
+
+       The parts are as equal in size as possible, the first ones being one
+       element larger when \p num_devices does not divide the dimension. They
+       are copied to their devices as in \ref af_copy_to_device.
+
+       \param[out] events      The \p num_devices events marked after each
+                               part on the queue of its device. Release them
+                               with \ref af_delete_event. Can be NULL.
+       \param[out] outs        The \p num_devices parts of \p in. Part i is
+                               on \p devices[i].
+       \param[in]  in          The array to split
+       \param[in]  dim         The dimension along which \p in is split
+       \param[in]  num_devices The number of devices. It cannot be larger
+                               than the dimension \p dim of \p in.
+       \param[in]  devices     The devices of the parts. A device can be
+                               repeated.
+
+       \returns \ref AF_SUCCESS if the transfers were queued
+    */
+    AFAPI af_err af_scatter(af_event *events, af_array *outs,
+                            const af_array in, const int dim,
+                            const unsigned num_devices, const int *devices);
+
+    /**
+       Join arrays from several devices along a dimension on one device
+
+       The arrays which are not on \p device are copied to it as in
+       \ref af_copy_to_device, and the arrays are joined as in
+       \ref af_join_many.
+
+       \param[out] event      The event marked after the join on the queue of
+                              \p device. Release it with \ref af_delete_event.
+                              Can be NULL.
+       \param[out] out        The arrays joined on \p device
+       \param[in]  num_arrays The number of arrays
+       \param[in]  ins        The arrays to join. They can be on any device.
+       \param[in]  dim        The dimension along which the arrays are joined
+       \param[in]  device     The device of \p out
+
+       \returns \ref AF_SUCCESS if the transfers were queued
+    */
+    AFAPI af_err af_gather(af_event *event, af_array *out,
+                           const unsigned num_arrays, const af_array *ins,
+                           const int dim, const int device);
+
+    /**
+       Reduce arrays of the same size element-wise across devices
+
+       Every device receives the reduction of all the arrays. The arrays are
+       reduced in a ring: each array is split into one chunk per array, and
+       at each step every device sends one chunk to the next device, which
+       reduces it with its own. Every device transfers the same amount of
+       data, about twice the size of an array in total, and the transfers of
+       a step run concurrently. This is the reduction used to average
+       gradients across devices.
+
+       \param[out] events     The \p num_arrays events marked after each
+                              result on the queue of its device. Release
+                              them with \ref af_delete_event. Can be NULL.
+       \param[out] outs       The \p num_arrays results. Result i is on the
+                              device of \p ins[i].
+       \param[in]  num_arrays The number of arrays
+       \param[in]  ins        The arrays to reduce, usually one on each
+                              device. They have the same type and size.
+       \param[in]  op         The reduction
+
+       \returns \ref AF_SUCCESS if the transfers were queued
+    */
+    AFAPI af_err af_all_reduce(af_event *events, af_array *outs,
+                               const unsigned num_arrays, const af_array *ins,
+                               const af_binary_op op);
+#endif
+
     /**
        \brief Reduce the reference count of the \ref af_array
 
@@ -1639,6 +1935,11 @@ extern "C" {
 #if AF_API_VERSION >= 34
     /**
        Evaluate multiple arrays together
+
+       Arrays of the same dimensions are evaluated by a single kernel, even
+       if their types differ. Small arrays of the same type and different
+       dimensions are evaluated in batches by a single kernel. The other
+       arrays are evaluated individually.
     */
     AFAPI af_err af_eval_multiple(const int num, af_array *arrays);
 #endif
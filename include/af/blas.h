@@ -40,12 +40,24 @@ namespace af
         \note <b> The following applies for Sparse-Dense matrix multiplication.</b>
         \note This function can be used with one sparse input. The sparse input
               must always be the \p lhs and the dense matrix must be \p rhs.
-        \note The sparse array can only be of \ref AF_STORAGE_CSR format.
+        \note The sparse array can be of \ref AF_STORAGE_CSR,
+              \ref AF_STORAGE_CSC, \ref AF_STORAGE_COO, \ref AF_STORAGE_BSR
+              or \ref AF_STORAGE_SELL format. It is multiplied in its own
+              format, without a conversion.
         \note The returned array is always dense.
         \note \p optLhs an only be one of \ref AF_MAT_NONE, \ref AF_MAT_TRANS,
-              \ref AF_MAT_CTRANS.
+              \ref AF_MAT_CTRANS, and only \ref AF_MAT_NONE for
+              \ref AF_STORAGE_BSR and \ref AF_STORAGE_SELL.
         \note \p optRhs can only be \ref AF_MAT_NONE.
 
+        \note <b> The following applies for Sparse-Sparse matrix multiplication.</b>
+        \note Both inputs must be of \ref AF_STORAGE_CSR format and the
+              returned array is a sparse array of \ref AF_STORAGE_CSR format.
+        \note \p optLhs and \p optRhs can only be \ref AF_MAT_NONE.
+        \note The sparsity pattern of the product is kept with \p lhs, so
+              repeated products with right hand sides of the same pattern only
+              compute the values.
+
         \ingroup blas_func_matmul
 
      */
@@ -134,6 +146,80 @@ namespace af
     */
     AFAPI array matmul(const array &a, const array &b, const array &c, const array &d);
 
+#if AF_API_VERSION >= 38
+    /**
+       \brief Matrix multiply followed by a bias and an activation
+
+       Computes \f$act(op(lhs) op(rhs) + bias)\f$ with one call, which the
+       CUDA backend fuses into the matrix multiply with cuBLASLt. See
+       \ref af_gemm_fused.
+
+       \param[in] lhs    The array object on the left hand side
+       \param[in] rhs    The array object on the right hand side
+       \param[in] bias   The column vector added to every column of the
+                         product. An empty array adds no bias.
+       \param[in] epilogue The activation applied to the result
+       \param[in] optLhs Transpose left hand side before the function is
+                         performed
+       \param[in] optRhs Transpose right hand side before the function is
+                         performed
+       \return    The activation of the biased product
+
+       \ingroup blas_func_matmul
+    */
+    AFAPI array matmul(const array &lhs, const array &rhs, const array &bias,
+                       const gemmEpilogue epilogue,
+                       const matProp optLhs = AF_MAT_NONE,
+                       const matProp optRhs = AF_MAT_NONE);
+
+    /**
+       \brief Matrix multiply with the accumulation of a compute type
+
+       Lets f16 inputs accumulate in f32, which the CUDA backend computes on
+       the tensor cores, and lets f32 inputs use TF32 on CUDA devices which
+       support it. See \ref af_gemm_v2.
+
+       \param[in] lhs     The array object on the left hand side
+       \param[in] rhs     The array object on the right hand side
+       \param[in] compute The accumulation of the multiply
+       \param[in] optLhs  Transpose left hand side before the function is
+                          performed
+       \param[in] optRhs  Transpose right hand side before the function is
+                          performed
+       \return    The product. It is f32 when f16 inputs accumulate in f32.
+
+       \ingroup blas_func_matmul
+    */
+    AFAPI array matmul(const array &lhs, const array &rhs,
+                       const gemmComputeType compute,
+                       const matProp optLhs = AF_MAT_NONE,
+                       const matProp optRhs = AF_MAT_NONE);
+
+    /**
+       \brief Matrix multiply of 8-bit quantized matrices
+
+       Multiplies the u8 matrices, whose real values are
+       \f$scale (q - zero)\f$, in 32-bit integers. The scales are applied to
+       the s32 product with \ref dequantize. See \ref af_matmul_quantized.
+
+       \param[in] lhs     The u8 array object on the left hand side
+       \param[in] rhs     The u8 array object on the right hand side
+       \param[in] lhsZero The zero point of \p lhs, from 0 to 255
+       \param[in] rhsZero The zero point of \p rhs, from 0 to 255
+       \param[in] optLhs  Transpose left hand side before the function is
+                          performed
+       \param[in] optRhs  Transpose right hand side before the function is
+                          performed
+       \return    The s32 product \f$(op(lhs) - lhsZero)(op(rhs) - rhsZero)\f$
+
+       \ingroup blas_func_matmul
+    */
+    AFAPI array matmulQuantized(const array &lhs, const array &rhs,
+                                const int lhsZero, const int rhsZero,
+                                const matProp optLhs = AF_MAT_NONE,
+                                const matProp optRhs = AF_MAT_NONE);
+#endif
+
 #if AF_API_VERSION >= 35
     /**
         \brief Dot Product
@@ -280,6 +366,95 @@ extern "C" {
                          const void *beta);
 #endif
 
+#if AF_API_VERSION >= 38
+    /**
+        \brief GEMM followed by a bias and an activation
+
+        \details
+        Computes
+
+        \f[
+        C = act(\alpha * opA(A)opB(B) + \beta * C + bias)
+        \f]
+
+        where \f$bias\f$ is a column vector added to every column of every
+        matrix of the batch and \f$act\f$ is the activation chosen by
+        \p epilogue. The arguments shared with \ref af_gemm behave as they do
+        there.
+
+        On the CUDA backend, the bias and the activation of unbatched
+        f32 and f16 products are applied by the cuBLASLt matrix multiply
+        itself. Otherwise they are applied by one kernel after the multiply,
+        instead of the separate kernels of the equivalent array expression.
+
+        \param[in,out] C        Pointer to the output \ref af_array
+        \param[in]     opA      Operation to perform on A before the
+                                multiplication
+        \param[in]     opB      Operation to perform on B before the
+                                multiplication
+        \param[in]     alpha    The alpha value; must be the same type as
+                                \p A and \p B
+        \param[in]     A        Left-hand side operand
+        \param[in]     B        Right-hand side operand
+        \param[in]     beta     The beta value; must be the same type as
+                                \p A and \p B
+        \param[in]     bias     The column vector with one element per row of
+                                \f$C\f$, or 0 for no bias
+        \param[in]     epilogue The activation applied to the result. Only
+                                \ref AF_GEMM_EPILOGUE_NONE is supported for
+                                complex types.
+
+        \return AF_SUCCESS if the operation is successful.
+
+        \ingroup blas_func_matmul
+    */
+    AFAPI af_err af_gemm_fused(af_array *C, const af_mat_prop opA,
+                               const af_mat_prop opB, const void *alpha,
+                               const af_array A, const af_array B,
+                               const void *beta, const af_array bias,
+                               const af_gemm_epilogue epilogue);
+
+    /**
+        \brief GEMM with the accumulation of a compute type
+
+        \details
+        Computes the same product as \ref af_gemm, accumulated as \p compute
+        asks:
+
+        - \ref AF_GEMM_COMPUTE_DEFAULT accumulates in the type of the inputs,
+          like \ref af_gemm.
+        - \ref AF_GEMM_COMPUTE_F32 accumulates the products of f16 and bf16
+          inputs in f32. The CUDA backend uses the tensor cores of Volta and
+          newer devices, and of Ampere and newer ones for bf16. \p C can
+          then be of the type of the inputs or f32, and a new \p C is f32.
+        - \ref AF_GEMM_COMPUTE_TF32 also lets the CUDA backend round f32 and
+          c32 inputs to TF32 on Ampere and newer devices, which trades
+          precision for speed. Other backends and types ignore it.
+
+        \param[in,out] C       Pointer to the output \ref af_array
+        \param[in]     opA     Operation to perform on A before the
+                               multiplication
+        \param[in]     opB     Operation to perform on B before the
+                               multiplication
+        \param[in]     alpha   The alpha value; must be the same type as
+                               \p C
+        \param[in]     A       Left-hand side operand
+        \param[in]     B       Right-hand side operand
+        \param[in]     beta    The beta value; must be the same type as
+                               \p C
+        \param[in]     compute The accumulation of the products
+
+        \return AF_SUCCESS if the operation is successful.
+
+        \ingroup blas_func_matmul
+    */
+    AFAPI af_err af_gemm_v2(af_array *C, const af_mat_prop opA,
+                            const af_mat_prop opB, const void *alpha,
+                            const af_array A, const af_array B,
+                            const void *beta,
+                            const af_gemm_compute_type compute);
+#endif
+
     /**
         \brief Matrix multiply of two \ref af_array
 
@@ -296,18 +471,70 @@ extern "C" {
         \note <b> The following applies for Sparse-Dense matrix multiplication.</b>
         \note This function can be used with one sparse input. The sparse input
               must always be the \p lhs and the dense matrix must be \p rhs.
-        \note The sparse array can only be of \ref AF_STORAGE_CSR format.
+        \note The sparse array can be of \ref AF_STORAGE_CSR,
+              \ref AF_STORAGE_CSC, \ref AF_STORAGE_COO, \ref AF_STORAGE_BSR
+              or \ref AF_STORAGE_SELL format. It is multiplied in its own
+              format, without a conversion.
         \note The returned array is always dense.
         \note \p optLhs an only be one of \ref AF_MAT_NONE, \ref AF_MAT_TRANS,
-              \ref AF_MAT_CTRANS.
+              \ref AF_MAT_CTRANS, and only \ref AF_MAT_NONE for
+              \ref AF_STORAGE_BSR and \ref AF_STORAGE_SELL.
         \note \p optRhs can only be \ref AF_MAT_NONE.
 
+        \note <b> The following applies for Sparse-Sparse matrix multiplication.</b>
+        \note Both inputs must be of \ref AF_STORAGE_CSR format and the
+              returned array is a sparse array of \ref AF_STORAGE_CSR format.
+        \note \p optLhs and \p optRhs can only be \ref AF_MAT_NONE.
+        \note The sparsity pattern of the product is kept with \p lhs, so
+              repeated products with right hand sides of the same pattern only
+              compute the values.
+
         \ingroup blas_func_matmul
      */
     AFAPI af_err af_matmul( af_array *out ,
                             const af_array lhs, const af_array rhs,
                             const af_mat_prop optLhs, const af_mat_prop optRhs);
 
+#if AF_API_VERSION >= 38
+    /**
+        \brief Matrix multiply of 8-bit quantized matrices
+
+        \details
+        Computes
+
+        \f[
+        out = (opA(A) - zeroA)(opB(B) - zeroB)
+        \f]
+
+        for the u8 matrices \p A and \p B, whose real values are
+        \f$scale (q - zero)\f$. The products are accumulated in 32-bit
+        integers, which is exact for inner dimensions up to 33025. The
+        per-tensor or per-channel scales are applied to the s32 result with
+        \ref af_dequantize, whose operations are fused into the JIT.
+
+        The batches follow the rules of \ref af_matmul.
+
+        \param[out] out   Pointer to the s32 output \ref af_array
+        \param[in]  lhs   The u8 left-hand side operand
+        \param[in]  rhs   The u8 right-hand side operand
+        \param[in]  lhsZero The zero point of \p lhs, from 0 to 255
+        \param[in]  rhsZero The zero point of \p rhs, from 0 to 255
+        \param[in]  optLhs Transpose left hand side before the function is
+                           performed
+        \param[in]  optRhs Transpose right hand side before the function is
+                           performed
+
+        \return AF_SUCCESS if the process is successful.
+
+        \ingroup blas_func_matmul
+     */
+    AFAPI af_err af_matmul_quantized(af_array *out, const af_array lhs,
+                                     const af_array rhs, const int lhsZero,
+                                     const int rhsZero,
+                                     const af_mat_prop optLhs,
+                                     const af_mat_prop optRhs);
+#endif
+
 
     /**
         Scalar dot product between two vectors.  Also referred to as the inner
@@ -0,0 +1,84 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <af/defines.h>
+#include <af/exception.h>
+
+/// This file contain functions that apply only to the CPU backend.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if AF_API_VERSION >= 38
+/**
+   Sets the limits of the work queued by the CPU backend before the calling
+   thread waits for it
+
+   The CPU backend runs the functions asynchronously on a worker thread. The
+   calling thread waits for the queued functions when they use more than
+   \p bytes of arrays or when their estimated work is more than \p elements
+   array elements. A limit of zero is disabled. The queue is also flushed
+   when the memory pressure is above its threshold.
+
+   The defaults are set by AF_CPU_QUEUE_FLUSH_BYTES and
+   AF_CPU_QUEUE_FLUSH_ELEMENTS.
+
+   \param[in] bytes the bytes of arrays the queued functions can use
+   \param[in] elements the estimated work of the queued functions
+   \returns \ref af_err error code
+
+   \ingroup cpu_mat
+*/
+AFAPI af_err afcpu_set_queue_flush_limits(unsigned long long bytes,
+                                          unsigned long long elements);
+
+/**
+   Gets the limits of the work queued by the CPU backend
+
+   \param[out] bytes the bytes of arrays the queued functions can use
+   \param[out] elements the estimated work of the queued functions
+   \returns \ref af_err error code
+
+   \ingroup cpu_mat
+*/
+AFAPI af_err afcpu_get_queue_flush_limits(unsigned long long *bytes,
+                                          unsigned long long *elements);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+namespace afcpu
+{
+
+#if AF_API_VERSION >= 38
+/**
+   Sets the limits of the work queued by the CPU backend
+
+   \param[in] bytes the bytes of arrays the queued functions can use
+   \param[in] elements the estimated work of the queued functions
+
+   \ingroup cpu_mat
+ */
+static inline void setQueueFlushLimits(unsigned long long bytes,
+                                       unsigned long long elements)
+{
+    af_err err = afcpu_set_queue_flush_limits(bytes, elements);
+    if (err!=AF_SUCCESS)
+        throw af::exception("Failed to set the CPU queue flush limits");
+}
+#endif
+
+}
+#endif
@@ -41,6 +41,9 @@ extern "C" {
 /**
    Get the stream for the CUDA device with \p id in ArrayFire context
 
+   This is the stream bound to the calling thread if one has been set using
+   \ref afcu_set_stream.
+
    \param[out] stream CUDA Stream of device with \p id in ArrayFire context
    \param[in] id ArrayFire device id
    \returns \ref af_err error code
@@ -89,6 +92,74 @@ AFAPI af_err afcu_set_native_id(int nativeid);
 AFAPI af_err afcu_cublasSetMathMode(cublasMath_t mode);
 #endif
 
+#if AF_API_VERSION >= 38
+/**
+   Sets the release threshold of the memory pool used by the stream ordered
+   memory manager on the device with \p id
+
+   The pool keeps up to \p bytes of freed memory cached when the device is
+   synchronized instead of returning it to the system. The stream ordered
+   memory manager is enabled by setting AF_CUDA_MEMORY_MANAGER to async and
+   requires CUDA 11.2 or newer.
+
+   \param[in] id ArrayFire device id
+   \param[in] bytes the number of bytes the pool can retain
+   \returns \ref af_err error code
+
+   \ingroup cuda_mat
+*/
+AFAPI af_err afcu_set_mem_pool_release_threshold(int id,
+                                                 unsigned long long bytes);
+
+/**
+   Gets the release threshold of the memory pool of the device with \p id
+
+   \param[out] bytes the number of bytes the pool can retain
+   \param[in] id ArrayFire device id
+   \returns \ref af_err error code
+
+   \ingroup cuda_mat
+*/
+AFAPI af_err afcu_get_mem_pool_release_threshold(unsigned long long *bytes,
+                                                 int id);
+
+/**
+   Binds \p stream to the calling thread for the device with \p id
+
+   The kernels, library calls and memory operations issued by the calling
+   thread on the device are enqueued on \p stream instead of the stream
+   shared by all the threads. Threads with different streams can execute
+   their work concurrently on the same device. Arrays shared between threads
+   with different streams must be synchronized using \ref af_sync by the
+   thread that created them before they are used on another stream.
+
+   Passing a null stream restores the stream shared by all the threads.
+   The stream is owned by the caller and must outlive its use by ArrayFire.
+
+   \param[in] id ArrayFire device id
+   \param[in] stream the CUDA stream to bind to the calling thread
+   \returns \ref af_err error code
+
+   \ingroup cuda_mat
+*/
+AFAPI af_err afcu_set_stream(int id, cudaStream_t stream);
+
+/**
+   Creates a stream and binds it to the calling thread for the device with
+   \p id
+
+   The stream is owned by ArrayFire. It is destroyed when the thread exits or
+   when another stream is bound using \ref afcu_set_stream.
+
+   \param[out] stream the stream bound to the calling thread
+   \param[in] id ArrayFire device id
+   \returns \ref af_err error code
+
+   \ingroup cuda_mat
+*/
+AFAPI af_err afcu_create_stream(cudaStream_t *stream, int id);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -152,5 +223,41 @@ static inline void setNativeId(int nativeId)
 }
 #endif
 
+#if AF_API_VERSION >= 38
+/**
+   Binds \p stream to the calling thread for the device with \p id
+
+   \param[in] id ArrayFire device id
+   \param[in] stream the CUDA stream to bind. A null stream restores the
+              stream shared by all the threads
+
+   \ingroup cuda_mat
+ */
+static inline void setStream(int id, cudaStream_t stream)
+{
+    af_err err = afcu_set_stream(id, stream);
+    if (err!=AF_SUCCESS)
+        throw af::exception("Failed to bind the CUDA stream to the thread");
+}
+
+/**
+   Creates a stream owned by ArrayFire and binds it to the calling thread for
+   the device with \p id
+
+   \param[in] id ArrayFire device id
+   \returns the stream bound to the calling thread
+
+   \ingroup cuda_mat
+ */
+static inline cudaStream_t createStream(int id)
+{
+    cudaStream_t retVal;
+    af_err err = afcu_create_stream(&retVal, id);
+    if (err!=AF_SUCCESS)
+        throw af::exception("Failed to create a CUDA stream for the thread");
+    return retVal;
+}
+#endif
+
 }
 #endif
@@ -227,6 +227,9 @@ typedef enum {
 #if AF_API_VERSION >= 37
     , f16    ///< 16-bit floating point value
 #endif
+#if AF_API_VERSION >= 38
+    , bf16   ///< 16-bit brain floating point value
+#endif
 } af_dtype;
 
 typedef enum {
@@ -491,6 +494,10 @@ typedef enum {
     AF_STORAGE_CSR       = 1,   ///< Storage type is CSR
     AF_STORAGE_CSC       = 2,   ///< Storage type is CSC
     AF_STORAGE_COO       = 3    ///< Storage type is COO
+#if AF_API_VERSION >= 38
+    , AF_STORAGE_BSR     = 4    ///< Storage type is CSR of square blocks
+    , AF_STORAGE_SELL    = 5    ///< Storage type is SELL-C-sigma
+#endif
 } af_storage;
 #endif
 
@@ -543,6 +550,51 @@ typedef enum {
 } af_conv_gradient_type;
 #endif
 
+#if AF_API_VERSION >= 38
+typedef enum {
+    AF_JIT_PASS          = 0, ///< Keep adding nodes to the JIT tree
+    AF_JIT_EVAL_TALLEST  = 1, ///< Evaluate the tallest subtree of the new node
+    AF_JIT_EVAL_CHILDREN = 2  ///< Evaluate all the subtrees of the new node
+} af_jit_decision;
+
+typedef enum {
+    AF_COMPRESSION_NONE = 0, ///< The chunks are stored uncompressed
+    AF_COMPRESSION_LZ4  = 1, ///< The chunks are compressed with LZ4
+    AF_COMPRESSION_ZSTD = 2  ///< The chunks are compressed with zstd
+} af_compression_type;
+
+typedef enum {
+    AF_GEMM_EPILOGUE_NONE = 0, ///< No activation is applied
+    AF_GEMM_EPILOGUE_RELU = 1, ///< max(x, 0)
+    AF_GEMM_EPILOGUE_GELU = 2  ///< The tanh approximation of the GELU
+} af_gemm_epilogue;
+
+typedef enum {
+    AF_GEMM_COMPUTE_DEFAULT = 0, ///< Accumulate in the type of the inputs
+    AF_GEMM_COMPUTE_F32     = 1, ///< Accumulate f16 and bf16 products in f32
+    AF_GEMM_COMPUTE_TF32    = 2  ///< Also allow TF32 products of f32 inputs
+} af_gemm_compute_type;
+
+typedef enum {
+    AF_PRECOND_NONE   = 0, ///< No preconditioner
+    AF_PRECOND_JACOBI = 1, ///< Element-wise product with the inverse diagonal
+    AF_PRECOND_ILU0   = 2, ///< The two triangular solves of an ILU(0) factor
+    AF_PRECOND_IC0    = 3, ///< The two triangular solves of an IC(0) factor
+    AF_PRECOND_MATRIX = 4  ///< Product with an approximate inverse
+} af_precond_type;
+
+typedef enum {
+    AF_PRECISION_DEFAULT = 0, ///< The default options of the kernel compilers
+    AF_PRECISION_STRICT  = 1, ///< No fused multiply-adds and correctly rounded
+                              ///< division and square root
+    AF_PRECISION_RELAXED = 2, ///< Fused multiply-adds and approximate
+                              ///< division and square root
+    AF_PRECISION_FAST    = 3  ///< The fast math options of the compilers,
+                              ///< which also approximate the transcendental
+                              ///< functions and ignore NaN and infinities
+} af_precision_mode;
+#endif
+
 #ifdef __cplusplus
 namespace af
 {
@@ -598,6 +650,14 @@ namespace af
     typedef af_inverse_deconv_algo inverseDeconvAlgo;
     typedef af_conv_gradient_type convGradientType;
 #endif
+#if AF_API_VERSION >= 38
+    typedef af_jit_decision jitDecision;
+    typedef af_compression_type compressionType;
+    typedef af_gemm_epilogue gemmEpilogue;
+    typedef af_gemm_compute_type gemmComputeType;
+    typedef af_precond_type precondType;
+    typedef af_precision_mode precisionMode;
+#endif
 }
 
 #endif
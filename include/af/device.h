@@ -10,6 +10,92 @@
 #pragma once
 #include <af/defines.h>
 
+#if AF_API_VERSION >= 38
+/**
+   The cost estimates of a JIT tree passed to an \ref af_jit_heuristic_fn
+
+   \ingroup device_func_jit
+*/
+typedef struct af_jit_tree_info {
+    int height;              ///< The height of the tree
+    int max_height;          ///< The maximum height set with AF_*_MAX_JIT_LEN
+    unsigned num_nodes;      ///< The number of distinct nodes in the tree
+    unsigned num_buffers;    ///< The number of buffers read by the tree
+    unsigned num_registers;  ///< An estimate of the 32-bit registers needed
+                             ///< to hold the intermediate values of the tree
+    size_t buffer_bytes;     ///< The bytes of the buffers read by the tree
+    size_t param_bytes;      ///< The size of the kernel parameters
+    size_t max_param_bytes;  ///< The maximum size of the kernel parameters
+                             ///< of the device. Zero if there is no limit.
+    int exceeds_memory_pressure; ///< Non-zero if the memory manager reports
+                                 ///< that the buffers of the tree exceed the
+                                 ///< memory pressure
+} af_jit_tree_info;
+
+/**
+   Called when a node is added to a JIT tree to decide if the tree needs to
+   be evaluated
+
+   \param[out] decision  What to do with the tree
+   \param[in]  info      The cost estimates of the tree with the new node
+   \param[in]  user_data The pointer passed to \ref af_set_jit_heuristic
+
+   \ingroup device_func_jit
+*/
+typedef af_err (*af_jit_heuristic_fn)(af_jit_decision *decision,
+                                      const af_jit_tree_info *info,
+                                      void *user_data);
+
+/**
+   A handle to the kernels being loaded by \ref af_prewarm_kernels_async
+
+   \ingroup device_func_mem
+*/
+typedef void *af_kernel_batch;
+
+/**
+   The memory statistics of a device recorded by the default memory manager
+
+   \ingroup device_func_mem
+*/
+typedef struct af_mem_stats {
+    size_t peak_bytes;    ///< The most bytes locked at once
+    size_t peak_buffers;  ///< The most buffers locked at once
+    size_t num_allocs;    ///< The number of allocations
+    size_t cache_hits;    ///< The allocations which reused a free buffer
+    size_t cache_misses;  ///< The allocations which allocated a new buffer
+    size_t size_histogram[48];  ///< The number of allocations of 2^i to
+                                ///< 2^(i+1) - 1 bytes in bucket i
+} af_mem_stats;
+
+/**
+   The statistics of the JIT trees evaluated on a device
+
+   \ingroup device_func_jit
+*/
+typedef struct af_jit_stats {
+    size_t num_evals;       ///< The number of evaluated trees
+    size_t evals_explicit;  ///< The trees evaluated because they were used
+    size_t evals_tree_height;  ///< The trees evaluated because they reached
+                               ///< AF_*_MAX_JIT_LEN
+    size_t evals_param_size;   ///< The trees evaluated because their kernel
+                               ///< parameters exceeded the device limit
+    size_t evals_memory_pressure;  ///< The trees evaluated because of
+                                   ///< memory pressure
+    size_t cache_hits;       ///< The kernels found in the in-memory cache
+    size_t cache_misses;     ///< The kernels loaded from disk or compiled
+    size_t num_compiles;     ///< The number of compiled kernel modules
+    double compile_seconds;  ///< The time spent compiling them
+    size_t node_histogram[16];  ///< The number of kernels which fuse 2^i to
+                                ///< 2^(i+1) - 1 nodes in bucket i
+    size_t num_modules;    ///< The kernel modules loaded on the device
+    size_t module_bytes;   ///< The size of their binaries
+    size_t num_evictions;  ///< The modules unloaded to keep the cache within
+                           ///< AF_JIT_MODULE_CACHE_COUNT and
+                           ///< AF_JIT_MODULE_CACHE_SIZE
+} af_jit_stats;
+#endif
+
 #ifdef __cplusplus
 namespace af
 {
@@ -203,6 +289,25 @@ namespace af
     /// \param[in] ptr the memory to free
     AFAPI void freePinned(const void *ptr);
 
+#if AF_API_VERSION >= 38
+    /// \ingroup device_func_pinned
+    ///
+    /// Registers existing host memory so it is transferred to and from the
+    /// device asynchronously, like the memory of \ref pinned. See
+    /// \ref af_register_host_memory.
+    ///
+    /// \param[in] ptr   the first byte of the memory
+    /// \param[in] bytes the size of the memory
+    AFAPI void registerHostMemory(void *ptr, const size_t bytes);
+
+    /// \ingroup device_func_pinned
+    ///
+    /// Unregisters memory registered by \ref registerHostMemory
+    ///
+    /// \param[in] ptr the pointer which was registered
+    AFAPI void unregisterHostMemory(void *ptr);
+#endif
+
 #if AF_API_VERSION >= 33
     /// \brief Allocate memory on host
     ///
@@ -289,6 +394,123 @@ namespace af
     ///
     /// \ingroup device_func_mem
     AFAPI size_t getMemStepSize();
+
+#if AF_API_VERSION >= 38
+    /// \copydoc af_set_jit_heuristic
+    ///
+    /// \ingroup device_func_jit
+    AFAPI void setJitHeuristic(af_jit_heuristic_fn fn, void *user_data = 0);
+
+    /// \copydoc af_get_jit_stats
+    ///
+    /// \returns the statistics of \p device
+    ///
+    /// \ingroup device_func_jit
+    AFAPI af_jit_stats getJitStats(const int device = -1);
+
+    /// \copydoc af_reset_jit_stats
+    ///
+    /// \ingroup device_func_jit
+    AFAPI void resetJitStats(const int device = -1);
+
+    /// \copydoc af_prewarm_kernels
+    ///
+    /// \returns the number of kernel modules loaded
+    ///
+    /// \ingroup device_func_mem
+    AFAPI unsigned prewarmKernels();
+
+    /// \copydoc af_prewarm_kernels_async
+    ///
+    /// Loads all the cached kernels of \p device. The batch has to be passed
+    /// to \ref af::waitKernels.
+    ///
+    /// \ingroup device_func_mem
+    AFAPI af_kernel_batch prewarmKernelsAsync(const int device = -1);
+
+    /// Waits for the kernels of a batch returned by
+    /// \ref af::prewarmKernelsAsync to be loaded and releases the batch
+    ///
+    /// \returns the number of kernel modules loaded
+    ///
+    /// \ingroup device_func_mem
+    AFAPI unsigned waitKernels(af_kernel_batch batch);
+
+    /// \copydoc af_set_mem_stats_enabled
+    ///
+    /// \ingroup device_func_mem
+    AFAPI void setMemStatsEnabled(const bool enabled);
+
+    /// \copydoc af_get_mem_stats
+    ///
+    /// \returns the statistics of \p device
+    ///
+    /// \ingroup device_func_mem
+    AFAPI af_mem_stats getMemStats(const int device = -1);
+
+    /// Takes the temporary buffers allocated on the calling thread from one
+    /// slab of device memory until the object is destroyed
+    ///
+    /// \code
+    /// {
+    ///     af::memoryScope scope(64 << 20);
+    ///     result = step(result); // The temporaries share a 64 MB slab
+    /// }
+    /// \endcode
+    ///
+    /// \see af_begin_memory_scope
+    ///
+    /// \ingroup device_func_mem
+    class AFAPI memoryScope {
+       public:
+        /// \copydoc af_begin_memory_scope
+        explicit memoryScope(const size_t bytes);
+
+        /// \copydoc af_end_memory_scope
+        ~memoryScope();
+
+        memoryScope(const memoryScope &)            = delete;
+        memoryScope &operator=(const memoryScope &) = delete;
+    };
+
+    /// \copydoc af_set_precision_mode
+    ///
+    /// \ingroup device_func_jit
+    AFAPI void setPrecisionMode(const precisionMode mode);
+
+    /// \returns the precision mode of the calling thread
+    ///
+    /// \see af_get_precision_mode
+    ///
+    /// \ingroup device_func_jit
+    AFAPI precisionMode getPrecisionMode();
+
+    /// Compiles the kernels launched by the calling thread with a precision
+    /// mode until the object is destroyed
+    ///
+    /// \code
+    /// {
+    ///     af::precisionScope scope(AF_PRECISION_FAST);
+    ///     af::array y = af::exp(af::sin(x)) * 2;
+    ///     y.eval(); // Compiled with the fast math options
+    /// }
+    /// \endcode
+    ///
+    /// \see af_begin_precision_scope
+    ///
+    /// \ingroup device_func_jit
+    class AFAPI precisionScope {
+       public:
+        /// \copydoc af_begin_precision_scope
+        explicit precisionScope(const precisionMode mode);
+
+        /// \copydoc af_end_precision_scope
+        ~precisionScope();
+
+        precisionScope(const precisionScope &)            = delete;
+        precisionScope &operator=(const precisionScope &) = delete;
+    };
+#endif
 }
 #endif
 
@@ -306,6 +528,24 @@ extern "C" {
     */
     AFAPI af_err af_init();
 
+#if AF_API_VERSION >= 38
+    /**
+       \brief Initializes the backend and its devices in a background thread
+
+       The devices, their contexts and their queues are created by the first
+       function which needs them, which can take a long time. This function
+       returns immediately and starts the initialization in a background
+       thread, so it overlaps with the start of the application. The functions
+       called before the initialization is done wait for it.
+
+       Errors of the initialization are ignored by the background thread. They
+       are reported by the first function which needs the devices.
+
+       \ingroup device_func_info
+    */
+    AFAPI af_err af_init_async();
+#endif
+
     /**
        \brief Gets the output of af_info() as a string
 
@@ -432,6 +672,35 @@ extern "C" {
     */
     AFAPI af_err af_free_pinned(void *ptr);
 
+#if AF_API_VERSION >= 38
+    /**
+       Registers existing host memory so it is transferred to and from the
+       device asynchronously, like the memory of \ref af_alloc_pinned
+
+       In the CUDA backend the memory is page locked with cudaHostRegister.
+       In the CPU and OpenCL backends it is only recorded, so
+       \ref af_write_array_async and \ref af_get_data_ptr_async use it
+       directly instead of the staging buffers. The memory must stay valid
+       until it is unregistered.
+
+       \param[in] ptr   The first byte of the memory
+       \param[in] bytes The size of the memory. It can not overlap memory
+                        which is already registered.
+
+       \ingroup device_func_pinned
+    */
+    AFAPI af_err af_register_host_memory(void *ptr, const size_t bytes);
+
+    /**
+       Unregisters memory registered by \ref af_register_host_memory
+
+       \param[in] ptr The pointer which was registered
+
+       \ingroup device_func_pinned
+    */
+    AFAPI af_err af_unregister_host_memory(void *ptr);
+#endif
+
 #if AF_API_VERSION >= 33
     /**
        \ingroup device_func_alloc_host
@@ -617,6 +886,304 @@ extern "C" {
     */
     AFAPI af_err af_get_kernel_cache_directory(size_t *length, char *path);
 
+    /**
+       Loads the cached kernels of the active device
+
+       Loads every kernel binary stored in the kernel cache directory for the
+       active device, so the first calls to functions which use them do not
+       compile or load kernels. This is useful at the start of a service to
+       move the cost of loading the kernels out of the first requests. Does
+       nothing in the CPU backend.
+
+       The size of the cached binaries is limited by the
+       AF_JIT_KERNEL_CACHE_SIZE environment variable. The least recently used
+       binaries are removed from the cache directory when it is exceeded.
+
+       \param[out] num_modules The number of kernel modules loaded. Can be
+                               NULL.
+
+       \returns AF_SUCCESS if the kernels were loaded
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_prewarm_kernels(unsigned *num_modules);
+
+    /**
+       Starts loading cached kernels in the background
+
+       The kernels are loaded from the kernel cache directory by a pool of
+       threads shared by all the devices. The calling thread does not wait
+       for them. A function which needs one of these kernels before it is
+       loaded waits only for that kernel. A list of module keys recorded
+       from the kernel_cache.index file of an earlier run can be replayed to
+       load only the kernels an application uses.
+
+       \param[out] batch    The handle of the kernels being loaded. It has to
+                            be released with \ref af_release_kernel_batch.
+       \param[in]  keys     The module keys of the kernels to load. Keys which
+                            are not in the kernel cache index are ignored.
+                            All the cached kernels of the device are loaded
+                            if it is NULL.
+       \param[in]  num_keys The number of keys
+       \param[in]  device   The device to load the kernels for. The active
+                            device is used if it is negative.
+
+       \returns AF_SUCCESS if the kernels were queued
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_prewarm_kernels_async(af_kernel_batch *batch,
+                                          const char *const *keys,
+                                          const unsigned num_keys,
+                                          const int device);
+
+    /**
+       Waits for the kernels of a batch to be loaded
+
+       \param[out] num_modules The number of kernel modules loaded. Can be
+                               NULL.
+       \param[in]  batch       The batch returned by
+                               \ref af_prewarm_kernels_async
+
+       \returns AF_SUCCESS once all the kernels of the batch were loaded or
+                failed to load
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_wait_kernel_batch(unsigned *num_modules,
+                                      const af_kernel_batch batch);
+
+    /**
+       Releases a batch returned by \ref af_prewarm_kernels_async
+
+       The kernels of the batch keep loading in the background.
+
+       \param[in] batch The batch to release
+
+       \returns AF_SUCCESS if the batch was released
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_release_kernel_batch(af_kernel_batch batch);
+
+    /**
+       Sets a function which decides when a JIT tree is evaluated
+
+       By default the tree is evaluated when its height reaches
+       AF_*_MAX_JIT_LEN, when its kernel parameters exceed the limit of the
+       device or when the memory manager reports memory pressure. The
+       function \p fn replaces these rules for the active backend. It
+       receives the cost estimates of the tree every time a node is added to
+       it.
+
+       Trees whose kernel parameters exceed the limit of the device are
+       always evaluated, even if \p fn decides otherwise.
+
+       \param[in] fn        The heuristic. NULL restores the default rules.
+       \param[in] user_data A pointer passed to every call of \p fn
+
+       \note Computing the cost estimates visits all the nodes of the tree,
+             which the default rules avoid for short trees
+
+       \ingroup device_func_jit
+    */
+    AFAPI af_err af_set_jit_heuristic(af_jit_heuristic_fn fn, void *user_data);
+
+    /**
+       Gets the JIT statistics of a device
+
+       The trees are counted when they are evaluated, by the reason of the
+       evaluation. A tree evaluated because it is used, or with \ref af_eval,
+       is explicit. The kernel cache and compile counters include all the
+       kernels of the device, not only the kernels of JIT trees.
+
+       \param[out] stats  The statistics recorded since the last reset
+       \param[in]  device The device. The active device is used if it is
+                          negative.
+
+       \returns AF_SUCCESS if the statistics were read
+
+       \ingroup device_func_jit
+    */
+    AFAPI af_err af_get_jit_stats(af_jit_stats *stats, const int device);
+
+    /**
+       Clears the JIT statistics of a device
+
+       \param[in] device The device. The active device is used if it is
+                         negative.
+
+       \returns AF_SUCCESS if the statistics were cleared
+
+       \ingroup device_func_jit
+    */
+    AFAPI af_err af_reset_jit_stats(const int device);
+
+    /**
+       Starts or stops recording memory statistics
+
+       The default memory manager records the peak usage, the reuse of its
+       free buffers and a histogram of the allocation sizes of each device.
+       Recording can also be started with the AF_MEM_STATS environment
+       variable. The statistics are kept when recording stops.
+
+       \param[in] enabled Non-zero to record the statistics
+
+       \returns AF_SUCCESS if the recording was changed. AF_ERR_NOT_SUPPORTED
+                if a custom memory manager is set.
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_set_mem_stats_enabled(const int enabled);
+
+    /**
+       Gets the memory statistics of a device
+
+       \param[out] stats  The statistics recorded since the last reset
+       \param[in]  device The device. The active device is used if it is
+                          negative.
+
+       \returns AF_SUCCESS if the statistics were read. AF_ERR_NOT_SUPPORTED
+                if a custom memory manager is set.
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_get_mem_stats(af_mem_stats *stats, const int device);
+
+    /**
+       Clears the memory statistics of a device
+
+       The peak usage restarts from the current usage.
+
+       \param[in] device The device. The active device is used if it is
+                         negative.
+
+       \returns AF_SUCCESS if the statistics were cleared
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_reset_mem_stats(const int device);
+
+    /**
+       Labels the allocations of the calling thread
+
+       The allocations recorded while a label is set are also counted per
+       label, so the stages of a pipeline can be told apart in
+       \ref af_get_mem_stats_json.
+
+       \param[in] name The label. NULL or an empty string removes it.
+
+       \returns AF_SUCCESS if the label was set
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_set_mem_stats_site(const char *name);
+
+    /**
+       Gets the memory statistics of a device as a JSON object
+
+       The object has the fields of \ref af_mem_stats, the current usage, the
+       non-empty buckets of the size histogram and the allocations of each
+       label set with \ref af_set_mem_stats_site.
+
+       \param[inout] length The size of \p json. If \p json is NULL, the size
+                            needed to store the object, including the
+                            terminating null character, is assigned to it.
+       \param[out]   json   The null-terminated object. Can be NULL.
+       \param[in]    device The device. The active device is used if it is
+                            negative.
+
+       \returns AF_SUCCESS if the object was written. AF_ERR_SIZE if
+                \p length is not sufficient to store the object.
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_get_mem_stats_json(size_t *length, char *json,
+                                       const int device);
+
+    /**
+       Starts a memory scope on the calling thread
+
+       The buffers allocated on the calling thread for the active device,
+       such as the temporaries of a step of an iteration, are taken in turn
+       from one slab of \p bytes allocated once. They are not looked up in
+       the memory cache and are not returned to it. A buffer which does not
+       fit in the rest of the slab is allocated as usual. The slab is reused
+       from its start whenever all of its buffers are released.
+
+       Scopes can be nested, in which case the innermost scope is used. The
+       arrays created within a scope stay valid after it ends, and the slab is
+       returned to the memory cache once they are released.
+
+       The scopes have no effect in the memory debug mode and with custom
+       memory managers.
+
+       \param[in] bytes The size of the slab
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_begin_memory_scope(const size_t bytes);
+
+    /**
+       Ends the innermost memory scope of the calling thread
+
+       \returns AF_ERR_ARG if no memory scope was started on the thread
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_end_memory_scope();
+
+    /**
+       Sets the floating point precision mode of the CUDA and OpenCL kernels
+
+       The mode selects the options of the runtime compilers of the kernels
+       and of the JIT trees, such as fused multiply-adds and the fast math
+       options. It is part of the key of the compiled kernels, so the kernels
+       of each mode are compiled and cached separately. The mode applies to
+       the kernels compiled after the call, and to the threads outside of a
+       precision scope. The kernels of the CPU backend are not affected.
+
+       The initial mode is read from the AF_PRECISION_MODE environment
+       variable.
+
+       \param[in] mode The precision mode
+
+       \ingroup device_func_jit
+    */
+    AFAPI af_err af_set_precision_mode(const af_precision_mode mode);
+
+    /**
+       Gets the precision mode of the calling thread
+
+       \param[out] mode The mode of the innermost precision scope of the
+                        thread, or the mode set by \ref af_set_precision_mode
+
+       \ingroup device_func_jit
+    */
+    AFAPI af_err af_get_precision_mode(af_precision_mode *mode);
+
+    /**
+       Starts a scope of the calling thread which uses a precision mode
+
+       The kernels launched by the thread until the scope ends are compiled
+       with \p mode instead of the global precision mode. Scopes can be
+       nested, in which case the innermost scope is used.
+
+       \param[in] mode The precision mode
+
+       \ingroup device_func_jit
+    */
+    AFAPI af_err af_begin_precision_scope(const af_precision_mode mode);
+
+    /**
+       Ends the innermost precision scope of the calling thread
+
+       \returns AF_ERR_ARG if no precision scope was started on the thread
+
+       \ingroup device_func_jit
+    */
+    AFAPI af_err af_end_precision_scope();
+
 #endif
 
 #ifdef __cplusplus
@@ -60,6 +60,14 @@ class AFAPI event {
     /// \brief block the calling thread until this event has occurred
     void block() const;
 
+#if AF_API_VERSION >= 38
+    /// \brief Returns the milliseconds between the completion of \p start
+    ///        and of this event
+    ///
+    /// \copydetails af_event_elapsed_time
+    float elapsed(const event& start) const;
+#endif
+
    private:
     event& operator=(const event& other);
     event(const event& other);
@@ -123,6 +131,31 @@ AFAPI af_err af_enqueue_wait_event(const af_event eventHandle);
 */
 AFAPI af_err af_block_event(const af_event eventHandle);
 
+#if AF_API_VERSION >= 38
+/**
+   Measures the time between the completion of two events on the device
+
+   The time is measured by the device, so it does not include the time the
+   host spends launching the operations, and no other operations need to
+   complete. The events have to be marked. The calling thread is blocked
+   until \p end completes.
+
+   On OpenCL the events have to be marked on queues which record timestamps.
+   The queues created by ArrayFire only record them when AF_PROFILE is set.
+
+   \param[out] ms    The elapsed time in milliseconds
+   \param[in]  start The event marked first
+   \param[in]  end   The event marked last
+
+   \returns AF_SUCCESS if the time was measured. AF_ERR_NOT_SUPPORTED if the
+            OpenCL queue does not record timestamps.
+
+   \ingroup event_api
+*/
+AFAPI af_err af_event_elapsed_time(float* ms, const af_event start,
+                                   const af_event end);
+#endif
+
 #ifdef __cplusplus
 }
 #endif  // __cplusplus
@@ -28,5 +28,45 @@ AFAPI void gforSet(bool val);
 typedef array (*batchFunc_t)(const array &lhs, const array &rhs);
 AFAPI array batchFunc(const array &lhs, const array &rhs, batchFunc_t func);
 
+#if AF_API_VERSION >= 38
+typedef array (*vmapFunc_t)(const array &in);
+typedef array (*vmapFunc2_t)(const array &lhs, const array &rhs);
+
+/**
+   Applies a function to every slice of an array with one call
+
+   \p func is written for one slice of \p in, which has the dimensions of
+   \p in without \p dim, and is called once with all the slices stacked
+   along the fourth dimension. The functions which treat the fourth
+   dimension as a batch, like the element wise functions, \ref matmul,
+   \ref solve, the FFTs, the convolutions, \ref sort, \ref scan and the
+   reductions along the other dimensions, process all the slices with one
+   launch. The functions which would mix the slices, like the reductions of
+   all the elements or along the fourth dimension, \ref join, \ref tile
+   and \ref reorder across it, throw \ref AF_ERR_NOT_SUPPORTED, and
+   \ref flat and \ref moddims reshape each slice.
+
+   \param[in] func the function of one slice. It must return one result per
+                   slice along the fourth dimension
+   \param[in] in   the input array
+   \param[in] dim  the dimension of the slices. The last dimension of \p in
+                   is used when it is negative
+   \returns        the results of \p func stacked along \p dim
+*/
+AFAPI array vmap(vmapFunc_t func, const array &in, const int dim = -1);
+
+/**
+   Applies a function to every pair of slices of two arrays with one call
+
+   \p lhs and \p rhs must have the same number of slices along \p dim. See
+   \ref vmap(vmapFunc_t, const array &, const int) for more.
+*/
+AFAPI array vmap(vmapFunc2_t func, const array &lhs, const array &rhs,
+                 const int dim = -1);
+
+/// Returns true while the function of \ref vmap is running
+AFAPI bool vmapGet();
+#endif
+
 }
 #endif
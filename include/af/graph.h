@@ -0,0 +1,163 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <af/defines.h>
+
+#if AF_API_VERSION >= 38
+
+/**
+    Handle to the work captured from the queue of a device
+
+    \ingroup graph_api
+*/
+typedef void* af_graph;
+
+#ifdef __cplusplus
+namespace af {
+
+/**
+    C++ RAII interface for captured graphs
+
+    \code
+    af::array x = af::randu(256, 256);
+    af::array w = af::randu(256, 256);
+
+    af::beginCapture();
+    af::array y = af::tanh(af::matmul(w, x));
+    y.eval();
+    af::graph step = af::endCapture();
+
+    for (int i = 0; i < iterations; ++i) {
+        x.write(input(i), x.bytes());   // Rebinds the input in place
+        step.replay();                  // Recomputes y
+    }
+    \endcode
+
+    \ingroup arrayfire_class
+    \ingroup graph_api
+*/
+class AFAPI graph {
+    af_graph g_;
+
+   public:
+    /// Create a new graph object from the C af_graph handle
+    graph(af_graph g);
+#if AF_COMPILER_CXX_RVALUE_REFERENCES
+    /// Move constructor
+    graph(graph&& other);
+
+    /// Move assignment operator
+    graph& operator=(graph&& other);
+#endif
+
+    /// graph Destructor
+    ~graph();
+
+    /// Return the underlying C af_graph handle
+    af_graph get() const;
+
+    /// \brief Enqueues the captured work on the queue of its device
+    void replay() const;
+
+   private:
+    graph& operator=(const graph& other);
+    graph(const graph& other);
+};
+
+/**
+   \copydoc af_begin_capture
+
+   \ingroup graph_api
+*/
+AFAPI void beginCapture();
+
+/**
+   \copydoc af_end_capture
+
+   \ingroup graph_api
+*/
+AFAPI graph endCapture();
+
+}  // namespace af
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+   Starts capturing the work queued on the active device
+
+   The kernels and copies of the ArrayFire calls made on the active device
+   until \ref af_end_capture are recorded instead of being executed. The
+   arrays computed by these calls hold their values once the graph is
+   replayed. The buffers freed during the capture are kept out of the memory
+   manager until the graph is released, because the replays still use them.
+
+   The calls which read the values of an array on the host, such as
+   \ref af_get_data_ptr or the reductions to a scalar, can not be captured.
+
+   The CUDA backend records the work in a CUDA graph on the stream of the
+   device and the CPU backend records the tasks of its queue. Capturing is
+   not supported by the OpenCL backend.
+
+   \ingroup graph_api
+*/
+AFAPI af_err af_begin_capture();
+
+/**
+   Stops capturing the work queued on the active device
+
+   \param[out] graph the captured work. Release it with
+                     \ref af_release_graph.
+
+   \ingroup graph_api
+*/
+AFAPI af_err af_end_capture(af_graph* graph);
+
+/**
+   Enqueues the captured work on the queue of its device
+
+   The graph has to be replayed with its device active. It reads and writes
+   the buffers of the arrays used during the capture, so new inputs are
+   bound by writing them into these arrays, for example with
+   \ref af_write_array. The arrays used by the graph have to be kept alive
+   until it is released.
+
+   \param[in] graph the captured work
+
+   \ingroup graph_api
+*/
+AFAPI af_err af_replay_graph(const af_graph graph);
+
+/**
+   Releases a captured graph and the buffers it kept
+
+   \param[in] graph the captured work
+
+   \ingroup graph_api
+*/
+AFAPI af_err af_release_graph(af_graph graph);
+
+/**
+   Returns true if the work queued on the active device is being captured
+
+   \param[out] out true if a capture is in progress
+
+   \ingroup graph_api
+*/
+AFAPI af_err af_is_capturing(bool* out);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // AF_API_VERSION >= 38
@@ -20,10 +20,17 @@ typedef struct {
     };
 } af_half;
 
+/// A 16-bit brain floating point value. It holds the upper 16 bits of the
+/// float with the same value: a sign bit, 8 exponent bits and 7 mantissa bits.
+typedef struct {
+    unsigned short data_;
+} af_bfloat16;
+
 #ifdef __cplusplus
 namespace af {
 #endif
 typedef af_half half;
+typedef af_bfloat16 bfloat16;
 #ifdef __cplusplus
 }
 #endif
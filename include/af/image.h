@@ -38,6 +38,26 @@ AFAPI void grad(array& dx, array& dy, const array& in);
 */
 AFAPI array loadImage(const char* filename, const bool is_color=false);
 
+#if AF_API_VERSION >= 38
+/**
+    C++ Interface for loading a batch of images of the same size
+
+    The images are decoded in parallel. Only images with 8 bits per channel
+    are supported.
+
+    \param[in] filenames are the names of the files to be loaded
+    \param[in] count is the number of files
+    \param[in] is_color boolean denoting if the images should be loaded as 1
+               channel or 3 channel
+    \param[in] type is the type of the output, \ref u8 or \ref f32
+    \return the images stacked along the fourth dimension
+
+    \ingroup imageio_func_load
+*/
+AFAPI array loadImages(const char** filenames, const unsigned count,
+                       const bool is_color=false, const dtype type=f32);
+#endif
+
 /**
     C++ Interface for saving an image
 
@@ -195,6 +215,27 @@ AFAPI array resize(const float scale0, const float scale1, const array& in, cons
 */
 AFAPI array resize(const float scale, const array& in, const interpType method=AF_INTERP_NEAREST);
 
+#if AF_API_VERSION >= 38
+/**
+    C++ Interface for building an image pyramid
+
+    \param[out] levels points to \p num_levels arrays which will contain the
+                levels of the pyramid, from the input image to the smallest
+                level
+    \param[in]  in is input image
+    \param[in]  num_levels is the number of levels of the pyramid
+    \param[in]  scale_factor is the factor by which each level is smaller
+                than the previous one
+    \param[in]  sigma is the standard deviation of the Gaussian blur applied
+                to a level before it is downsampled. No blur is applied when
+                it is zero
+
+    \ingroup transform_func_pyramid
+*/
+AFAPI void pyramid(array* levels, const array& in, const unsigned num_levels,
+                   const float scale_factor=2.f, const float sigma=0.f);
+#endif
+
 /**
     C++ Interface for rotating an image
 
@@ -297,6 +338,27 @@ AFAPI array skew(const array& in, const float skew0, const float skew1, const di
 */
 AFAPI array bilateral(const array &in, const float spatial_sigma, const float chromatic_sigma, const bool is_color=false);
 
+#if AF_API_VERSION >= 38
+/**
+    C++ Interface for the approximate bilateral filter of a bilateral grid
+
+    \param[in]  in array is the input image
+    \param[in]  spatial_sigma is the standard deviation of the spatial
+                Gaussian, in pixels
+    \param[in]  chromatic_sigma is the standard deviation of the chromatic
+                Gaussian, in the units of the values of \p in
+    \param[in]  sampling is the size of the cells of the grid relative to
+                the sigmas, in (0, 1]. Smaller cells are more accurate and
+                take more memory.
+    \return     the processed image
+
+    \ingroup image_func_bilateral
+*/
+AFAPI array bilateralGrid(const array &in, const float spatial_sigma,
+                          const float chromatic_sigma,
+                          const float sampling = 1.0f);
+#endif
+
 /**
    C++ Interface for histogram
 
@@ -325,6 +387,57 @@ AFAPI array histogram(const array &in, const unsigned nbins, const double minval
  */
 AFAPI array histogram(const array &in, const unsigned nbins);
 
+#if AF_API_VERSION >= 38
+/**
+   C++ Interface for weighted histogram
+
+   Each value of \p in adds its weight to its bin instead of one.
+
+   \param[in]  in is the input array
+   \param[in]  weights are the weights of the values of \p in, of type \ref
+               f32 and of the same dimensions as \p in
+   \param[in]  nbins  Number of bins to populate between min and max
+   \param[in]  minval minimum bin value (accumulates -inf to min)
+   \param[in]  maxval maximum bin value (accumulates max to +inf)
+   \return     histogram array of type f32
+
+   \ingroup image_func_histogram
+ */
+AFAPI array histogram(const array &in, const array &weights,
+                      const unsigned nbins, const double minval,
+                      const double maxval);
+
+/**
+   C++ Interface for joint histogram
+
+   The pairs of values of \p x and \p y at the same positions are counted in
+   an \p xbins x \p ybins histogram, whose bin (i, j) holds the pairs whose
+   value of \p x is in the i-th bin of [\p xmin, \p xmax] and whose value of
+   \p y is in the j-th bin of [\p ymin, \p ymax]. The third and fourth
+   dimensions of the inputs are batched like \ref histogram.
+
+   \param[in]  x is the first input array
+   \param[in]  y is the second input array, of the type and the dimensions
+               of \p x
+   \param[in]  xbins is the number of bins of the values of \p x
+   \param[in]  ybins is the number of bins of the values of \p y
+   \param[in]  xmin minimum bin value of \p x (accumulates -inf to min)
+   \param[in]  xmax maximum bin value of \p x (accumulates max to +inf)
+   \param[in]  ymin minimum bin value of \p y (accumulates -inf to min)
+   \param[in]  ymax maximum bin value of \p y (accumulates max to +inf)
+   \param[in]  weights are the weights of the pairs, of type \ref f32 and of
+               the dimensions of \p x. The pairs are counted when it is empty.
+   \return     histogram array of type u32, or f32 when \p weights is not
+               empty
+
+   \ingroup image_func_histogram
+ */
+AFAPI array histogram2(const array &x, const array &y, const unsigned xbins,
+                       const unsigned ybins, const double xmin,
+                       const double xmax, const double ymin,
+                       const double ymax, const array &weights = array());
+#endif
+
 /**
     C++ Interface for mean shift
 
@@ -367,6 +480,48 @@ AFAPI array minfilt(const array& in, const dim_t wind_length = 3, const dim_t wi
 */
 AFAPI array maxfilt(const array& in, const dim_t wind_length = 3, const dim_t wind_width = 3, const borderType edge_pad = AF_PAD_ZERO);
 
+#if AF_API_VERSION >= 38
+/**
+    C++ Interface for box filter
+
+    The mean of the window around each value is computed from running sums,
+    so the cost does not depend on the size of the window. The image is
+    padded with zeros, and the windows are centered like those of \ref
+    convolve2.
+
+    \param[in]  in array is the input image
+    \param[in]  wind_length is the kernel height
+    \param[in]  wind_width is the kernel width
+    \return     the filtered image, of type \ref f64, \ref c32 or \ref c64 for
+                those inputs and \ref f32 otherwise
+
+    \ingroup image_func_box_filter
+*/
+AFAPI array boxFilter(const array& in, const dim_t wind_length = 3,
+                      const dim_t wind_width = 3);
+
+/**
+    C++ Interface for recursive Gaussian filter
+
+    The columns and the rows of the image are filtered with the recursive
+    approximation of a Gaussian of Young and van Vliet, whose cost does not
+    depend on the standard deviations. The values past the borders are
+    zeros.
+
+    \param[in]  in array is the input image
+    \param[in]  sigma_r is the standard deviation for the rows, along the
+                first dimension as in \ref gaussianKernel, at least 0.5
+    \param[in]  sigma_c is the standard deviation for the columns, along the
+                second dimension, at least 0.5
+    \return     the filtered image, of type \ref f64, \ref c32 or \ref c64 for
+                those inputs and \ref f32 otherwise
+
+    \ingroup image_func_gaussian_filter
+*/
+AFAPI array gaussianFilter(const array& in, const double sigma_r,
+                           const double sigma_c);
+#endif
+
 /**
     C++ Interface for image dilation (max filter)
 
@@ -444,6 +599,55 @@ AFAPI array erode3(const array& in, const array& mask);
 */
 AFAPI array regions(const array& in, const af::connectivity connectivity=AF_CONNECTIVITY_4, const dtype type=f32);
 
+#if AF_API_VERSION >= 38
+/**
+    C++ Interface for getting regions in an image and the area and bounding
+    box of each region
+
+    \param[out] stats is a \ref u32 array of size 5 x N, where N is the
+                number of regions. Column i - 1 describes the region labelled
+                i with its area, its first row and column, and its last row
+                and column.
+    \param[in]  in array should be binary image of type \ref b8
+    \param[in]  connectivity can take one of the following [\ref AF_CONNECTIVITY_4 | \ref AF_CONNECTIVITY_8]
+    \param[in]  type is type of output array
+    \return     returns array with labels indicating different regions. Throws exceptions if any issue occur.
+
+    \note The CPU backend computes the statistics while it labels the
+          regions. The other backends compute them on the host from the
+          labels.
+
+    \ingroup image_func_regions
+*/
+AFAPI array regions(array& stats, const array& in,
+                    const af::connectivity connectivity=AF_CONNECTIVITY_4,
+                    const dtype type=f32);
+#endif
+
+#if AF_API_VERSION >= 38
+/**
+    C++ Interface for computing the properties of every label of a label
+    image, such as the output of \ref regions
+
+    \param[in]  labels is the label image. Label 0 is the background.
+    \param[in]  nlabels is the number of labels. The largest label is used if
+                it is zero. Labels larger than \p nlabels are ignored.
+    \return     a \ref f32 array of size 13 x \p nlabels
+
+    Column i - 1 of the result describes label i with its area, the row and
+    the column of its centroid, the first row and column and the last row and
+    column of its bounding box, the raw moments M01, M10 and M11 and the
+    central moments mu20, mu02 and mu11. The first index of a moment counts
+    the rows, so M01 is the sum of the rows of the pixels of the label.
+
+    \note The properties of all the labels are computed in one pass over the
+          image, so the cost does not depend on the number of labels.
+
+    \ingroup image_func_regions
+*/
+AFAPI array regionProps(const array& labels, const unsigned nlabels = 0);
+#endif
+
 /**
    C++ Interface for extracting sobel gradients
 
@@ -517,6 +721,37 @@ AFAPI array gray2rgb(const array& in, const float rFactor=1.0, const float gFact
  */
 AFAPI array histEqual(const array& in, const array& hist);
 
+#if AF_API_VERSION >= 38
+/**
+   C++ Interface for contrast limited adaptive histogram equalization
+
+   The image is divided into \p gridRows x \p gridCols tiles. The histogram
+   of every tile is clipped at \p clipLimit times the mean count of a bin,
+   and the clipped counts are redistributed over all the bins. Every pixel
+   is mapped by the cumulative histograms of the four nearest tiles,
+   interpolated bilinearly.
+
+   \param[in]  in is the input image
+   \param[in]  gridRows is the number of tiles along the first dimension
+   \param[in]  gridCols is the number of tiles along the second dimension
+   \param[in]  clipLimit is the limit of a bin relative to the mean count
+               of a bin. The histograms are not clipped if it is not positive.
+   \param[in]  nbins is the number of bins of the histograms
+   \param[in]  minval is the smallest value of the histograms
+   \param[in]  maxval is the largest value of the histograms
+   \return     the equalized image in the range [\p minval, \p maxval]
+
+   \note Batches of images along the third and fourth dimensions are
+         equalized independently.
+
+   \ingroup image_func_histequal
+ */
+AFAPI array clahe(const array& in, const unsigned gridRows = 8,
+                  const unsigned gridCols = 8, const float clipLimit = 2.0f,
+                  const unsigned nbins = 256, const double minval = 0.0,
+                  const double maxval = 255.0);
+#endif
+
 /**
    C++ Interface for generating gausian kernels
 
@@ -600,6 +835,37 @@ AFAPI array unwrap(const array& in, const dim_t wx, const dim_t wy,
                    const bool is_column = true);
 #endif
 
+#if AF_API_VERSION >= 38
+/**
+   C++ Interface for reducing the windowed sections of an input
+
+   The result equals the reduction of the columns of \ref unwrap() with the
+   same windows, arranged as the grid of the windows, but the windows are
+   reduced where they are read, so the unwrapped array is never created.
+
+   \param[in]  in is the input array
+   \param[in]  wx is the window size along dimension 0
+   \param[in]  wy is the window size along dimension 1
+   \param[in]  sx is the stride along dimension 0
+   \param[in]  sy is the stride along dimension 1
+   \param[in]  px is the padding along dimension 0
+   \param[in]  py is the padding along dimension 1
+   \param[in]  op is the reduction of the windows
+   \returns    an array with the reduction of each window, of dimensions
+               nx x ny x in.dims(2) x in.dims(3), where nx and ny are the
+               numbers of windows along dimensions 0 and 1
+
+   \note The padding is reduced as zeros
+   \note f64 inputs are reduced in f64, the other real types in f32
+
+   \ingroup image_func_unwrap
+*/
+AFAPI array unwrapReduce(const array& in, const dim_t wx, const dim_t wy,
+                         const dim_t sx, const dim_t sy, const dim_t px = 0,
+                         const dim_t py = 0,
+                         const binaryOp op = AF_BINARY_ADD);
+#endif
+
 #if AF_API_VERSION >= 31
 /**
    C++ Interface for performing the opposite of \ref unwrap()
@@ -780,7 +1046,45 @@ AFAPI array anisotropicDiffusion(const af::array& in, const float timestep,
 AFAPI array iterativeDeconv(const array& in, const array& ker,
                             const unsigned iterations, const float relaxFactor,
                             const iterativeDeconvAlgo algo);
+#endif
 
+#if AF_API_VERSION >= 38
+/**
+  C++ Interface for Iterative deconvolution algorithm, which stops when the
+  estimate converges
+
+  \param[in] in is the blurred input image
+  \param[in] ker is the kernel(point spread function) known to have caused
+             the blur in the system
+  \param[in] maxIterations is the maximum number of iterations
+  \param[in] relaxFactor is the relaxation factor multiplied with distance
+             of estimate from observed image.
+  \param[in] algo takes value of type enum \ref af_iterative_deconv_algo
+             indicating the iterative deconvolution algorithm to be used
+  \param[in] tol is the tolerance on the norm of the change of the estimate
+             in an iteration, relative to the norm of the estimate. The
+             iterations run until \p maxIterations when it is 0.
+  \param[in] checkInterval is the number of iterations between the checks
+             of the change, which are the only values read back to the host
+  \param[out] iterations will contain the number of iterations, when it is
+              not NULL
+  \return sharp image estimate generated from the blurred input
+
+  \note The \ref AF_ITERATIVE_DECONV_LANDWEBER iterations are computed
+  together in frequency space, so they always run \p maxIterations
+  iterations.
+
+  \ingroup image_func_iterative_deconv
+ */
+AFAPI array iterativeDeconv(const array& in, const array& ker,
+                            const unsigned maxIterations,
+                            const float relaxFactor,
+                            const iterativeDeconvAlgo algo, const double tol,
+                            const unsigned checkInterval = 10,
+                            unsigned* iterations = NULL);
+#endif
+
+#if AF_API_VERSION >= 37
 /**
    C++ Interface for Tikhonov deconvolution algorithm
 
@@ -903,6 +1207,31 @@ extern "C" {
     */
     AFAPI af_err af_load_image(af_array *out, const char* filename, const bool isColor);
 
+#if AF_API_VERSION >= 38
+    /**
+        C Interface for loading a batch of images of the same size
+
+        The images are decoded in parallel into one host buffer, which is
+        copied to the device once. Only images with 8 bits per channel are
+        supported, and the alpha channel is dropped.
+
+        \param[out] out will contain the images stacked along the fourth
+                    dimension
+        \param[in] filenames are the names of the files to be loaded
+        \param[in] count is the number of files
+        \param[in] isColor boolean denoting if the images should be loaded as
+                   1 channel or 3 channel
+        \param[in] type is the type of the output, \ref u8 or \ref f32
+        \return     \ref AF_SUCCESS if the images are loaded successfully,
+        otherwise an appropriate error code is returned.
+
+        \ingroup imageio_func_load
+    */
+    AFAPI af_err af_load_images(af_array *out, const char **filenames,
+                                const unsigned count, const bool isColor,
+                                const af_dtype type);
+#endif
+
     /**
         C Interface for saving an image
 
@@ -1042,6 +1371,31 @@ extern "C" {
     */
     AFAPI af_err af_resize(af_array *out, const af_array in, const dim_t odim0, const dim_t odim1, const af_interp_type method);
 
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for building an image pyramid
+
+       \param[out] levels points to \p num_levels handles which will contain
+                   the levels of the pyramid, from the input image to the
+                   smallest level
+       \param[in]  in is input image
+       \param[in]  num_levels is the number of levels of the pyramid
+       \param[in]  scale_factor is the factor by which each level is smaller
+                   than the previous one
+       \param[in]  sigma is the standard deviation of the Gaussian blur
+                   applied to a level before it is downsampled. No blur is
+                   applied when it is zero
+
+       \return \ref AF_SUCCESS if the pyramid is built successfully,
+       otherwise an appropriate error code is returned.
+
+       \ingroup transform_func_pyramid
+    */
+    AFAPI af_err af_pyramid(af_array *levels, const af_array in,
+                            const unsigned num_levels,
+                            const float scale_factor, const float sigma);
+#endif
+
     /**
        C Interface for transforming an image
 
@@ -1190,6 +1544,58 @@ extern "C" {
      */
     AFAPI af_err af_histogram(af_array *out, const af_array in, const unsigned nbins, const double minval, const double maxval);
 
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for weighted histogram
+
+       \param[out] out (type f32) is the sum of the weights of the values of
+                   \p in in each bin
+       \param[in]  in is the input array
+       \param[in]  weights are the weights of the values of \p in, of type
+                   \ref f32 and of the same dimensions as \p in
+       \param[in]  nbins  Number of bins to populate between min and max
+       \param[in]  minval minimum bin value (accumulates -inf to min)
+       \param[in]  maxval maximum bin value (accumulates max to +inf)
+       \return     \ref AF_SUCCESS if the histogram is successfully created,
+       otherwise an appropriate error code is returned.
+
+       \ingroup image_func_histogram
+     */
+    AFAPI af_err af_histogram_weighted(af_array *out, const af_array in,
+                                       const af_array weights,
+                                       const unsigned nbins,
+                                       const double minval,
+                                       const double maxval);
+
+    /**
+       C Interface for joint histogram
+
+       \param[out] out is the \p xbins x \p ybins histogram of the pairs of
+                   values of \p x and \p y, of type u32, or f32 when \p
+                   weights is not 0
+       \param[in]  x is the first input array
+       \param[in]  y is the second input array, of the type and the
+                   dimensions of \p x
+       \param[in]  weights are the weights of the pairs, of type \ref f32 and
+                   of the dimensions of \p x, or 0 to count the pairs
+       \param[in]  xbins is the number of bins of the values of \p x
+       \param[in]  ybins is the number of bins of the values of \p y
+       \param[in]  xmin minimum bin value of \p x (accumulates -inf to min)
+       \param[in]  xmax maximum bin value of \p x (accumulates max to +inf)
+       \param[in]  ymin minimum bin value of \p y (accumulates -inf to min)
+       \param[in]  ymax maximum bin value of \p y (accumulates max to +inf)
+       \return     \ref AF_SUCCESS if the histogram is successfully created,
+       otherwise an appropriate error code is returned.
+
+       \ingroup image_func_histogram
+     */
+    AFAPI af_err af_histogram2(af_array *out, const af_array x,
+                               const af_array y, const af_array weights,
+                               const unsigned xbins, const unsigned ybins,
+                               const double xmin, const double xmax,
+                               const double ymin, const double ymax);
+#endif
+
     /**
         C Interface for image dilation (max filter)
 
@@ -1261,6 +1667,30 @@ extern "C" {
     */
     AFAPI af_err af_bilateral(af_array *out, const af_array in, const float spatial_sigma, const float chromatic_sigma, const bool isColor);
 
+#if AF_API_VERSION >= 38
+    /**
+        C Interface for the approximate bilateral filter of a bilateral grid
+
+        \param[out] out array is the processed image
+        \param[in]  in array is the input image
+        \param[in]  spatial_sigma is the standard deviation of the spatial
+                    Gaussian, in pixels
+        \param[in]  chromatic_sigma is the standard deviation of the
+                    chromatic Gaussian, in the units of the values of \p in
+        \param[in]  sampling is the size of the cells of the grid relative to
+                    the sigmas, in (0, 1]. Smaller cells are more accurate and
+                    take more memory.
+        \return     \ref AF_SUCCESS if the filter is applied successfully,
+        otherwise an appropriate error code is returned.
+
+        \ingroup image_func_bilateral
+    */
+    AFAPI af_err af_bilateral_grid(af_array *out, const af_array in,
+                                   const float spatial_sigma,
+                                   const float chromatic_sigma,
+                                   const float sampling);
+#endif
+
     /**
         C Interface for mean shift
 
@@ -1309,6 +1739,42 @@ extern "C" {
     */
     AFAPI af_err af_maxfilt(af_array *out, const af_array in, const dim_t wind_length, const dim_t wind_width, const af_border_type edge_pad);
 
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for box filter
+
+       \param[out] out array is the filtered image
+       \param[in]  in array is the input image
+       \param[in]  wind_length is the kernel height
+       \param[in]  wind_width is the kernel width
+       \return     \ref AF_SUCCESS if the box filter is applied successfully,
+       otherwise an appropriate error code is returned.
+
+       \ingroup image_func_box_filter
+    */
+    AFAPI af_err af_box_filter(af_array *out, const af_array in,
+                               const dim_t wind_length,
+                               const dim_t wind_width);
+
+    /**
+       C Interface for recursive Gaussian filter
+
+       \param[out] out array is the filtered image
+       \param[in]  in array is the input image
+       \param[in]  sigma_r is the standard deviation for the rows, along the
+                   first dimension, at least 0.5
+       \param[in]  sigma_c is the standard deviation for the columns, along
+                   the second dimension, at least 0.5
+       \return     \ref AF_SUCCESS if the Gaussian filter is applied
+       successfully, otherwise an appropriate error code is returned.
+
+       \ingroup image_func_gaussian_filter
+    */
+    AFAPI af_err af_gaussian_filter(af_array *out, const af_array in,
+                                    const double sigma_r,
+                                    const double sigma_c);
+#endif
+
     /**
         C Interface for regions in an image
 
@@ -1323,6 +1789,54 @@ extern "C" {
     */
     AFAPI af_err af_regions(af_array *out, const af_array in, const af_connectivity connectivity, const af_dtype ty);
 
+#if AF_API_VERSION >= 38
+    /**
+        C Interface for regions in an image and the area and bounding box of
+        each region
+
+        \param[out] out array will have labels indicating different regions
+        \param[out] stats is a \ref u32 array of size 5 x N, where N is the
+                    number of regions. Column i - 1 describes the region
+                    labelled i with its area, its first row and column, and
+                    its last row and column.
+        \param[in]  in array should be binary image of type \ref b8
+        \param[in]  connectivity can take one of the following [\ref AF_CONNECTIVITY_4 | \ref AF_CONNECTIVITY_8]
+        \param[in]  ty is type of output array
+        \return     \ref AF_SUCCESS if the regions are identified successfully,
+        otherwise an appropriate error code is returned.
+
+        \ingroup image_func_regions
+    */
+    AFAPI af_err af_regions_stats(af_array *out, af_array *stats,
+                                  const af_array in,
+                                  const af_connectivity connectivity,
+                                  const af_dtype ty);
+#endif
+
+#if AF_API_VERSION >= 38
+    /**
+        C Interface for computing the properties of every label of a label
+        image, such as the output of \ref af_regions
+
+        \param[out] out is a \ref f32 array of size 13 x \p nlabels. Column
+                    i - 1 describes label i with its area, the row and the
+                    column of its centroid, the first row and column and the
+                    last row and column of its bounding box, the raw moments
+                    M01, M10 and M11 and the central moments mu20, mu02 and
+                    mu11. The first index of a moment counts the rows.
+        \param[in]  labels is the label image. Label 0 is the background.
+        \param[in]  nlabels is the number of labels. The largest label is
+                    used if it is zero. Larger labels are ignored.
+        \return     \ref AF_SUCCESS if the properties are computed
+                    successfully, otherwise an appropriate error code is
+                    returned.
+
+        \ingroup image_func_regions
+    */
+    AFAPI af_err af_region_props(af_array *out, const af_array labels,
+                                 const unsigned nlabels);
+#endif
+
     /**
        C Interface for getting sobel gradients
 
@@ -1388,6 +1902,32 @@ extern "C" {
     */
     AFAPI af_err af_hist_equal(af_array *out, const af_array in, const af_array hist);
 
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for contrast limited adaptive histogram equalization
+
+       \param[out] out is the equalized image
+       \param[in]  in is the input image
+       \param[in]  grid_rows is the number of tiles along the first dimension
+       \param[in]  grid_cols is the number of tiles along the second
+                   dimension
+       \param[in]  clip_limit is the limit of a bin relative to the mean
+                   count of a bin. The histograms are not clipped if it is
+                   not positive.
+       \param[in]  nbins is the number of bins of the histograms
+       \param[in]  minval is the smallest value of the histograms
+       \param[in]  maxval is the largest value of the histograms
+       \return     \ref AF_SUCCESS if the equalization is successful,
+                   otherwise an appropriate error code is returned.
+
+       \ingroup image_func_histequal
+    */
+    AFAPI af_err af_clahe(af_array *out, const af_array in,
+                          const unsigned grid_rows, const unsigned grid_cols,
+                          const float clip_limit, const unsigned nbins,
+                          const double minval, const double maxval);
+#endif
+
     /**
        C Interface generating gaussian kernels
 
@@ -1485,6 +2025,35 @@ extern "C" {
                            const bool is_column);
 #endif
 
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for reducing the windowed sections of an input
+
+       \param[out] out is an array with the reduction of each window, of
+                   dimensions nx x ny x in.dims(2) x in.dims(3)
+       \param[in]  in is the input array
+       \param[in]  wx is the window size along dimension 0
+       \param[in]  wy is the window size along dimension 1
+       \param[in]  sx is the stride along dimension 0
+       \param[in]  sy is the stride along dimension 1
+       \param[in]  px is the padding along dimension 0
+       \param[in]  py is the padding along dimension 1
+       \param[in]  op is the reduction of the windows
+       \return     \ref AF_SUCCESS if the reduction is successful,
+                   otherwise an appropriate error code is returned.
+
+       \note The windows are reduced where they are read, without creating
+             the output of \ref af_unwrap. The padding is reduced as zeros.
+
+       \ingroup image_func_unwrap
+    */
+    AFAPI af_err af_unwrap_reduce(af_array *out, const af_array in,
+                                  const dim_t wx, const dim_t wy,
+                                  const dim_t sx, const dim_t sy,
+                                  const dim_t px, const dim_t py,
+                                  const af_binary_op op);
+#endif
+
 #if AF_API_VERSION >= 31
     /**
        C Interface for performing the opposite of \ref unwrap()
@@ -1740,7 +2309,50 @@ extern "C" {
                                      const unsigned iterations,
                                      const float relax_factor,
                                      const af_iterative_deconv_algo algo);
+#endif
+
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for Iterative deconvolution algorithm, which stops when
+       the estimate converges
 
+       \param[out] out is the sharp estimate generated from the blurred input
+       \param[out] iterations will contain the number of iterations, when it
+                   is not NULL
+       \param[in] in is the blurred input image
+       \param[in] ker is the kernel(point spread function) known to have caused
+                  the blur in the system
+       \param[in] max_iterations is the maximum number of iterations
+       \param[in] relax_factor is the relaxation factor multiplied with
+                  distance of estimate from observed image.
+       \param[in] algo takes value of type enum \ref af_iterative_deconv_algo
+                  indicating the iterative deconvolution algorithm to be used
+       \param[in] tol is the tolerance on the norm of the change of the
+                  estimate in an iteration, relative to the norm of the
+                  estimate. The iterations run until \p max_iterations when
+                  it is 0.
+       \param[in] check_interval is the number of iterations between the
+                  checks of the change, which are the only values read back
+                  to the host
+       \return \ref AF_SUCCESS if the deconvolution is successful,
+       otherwise an appropriate error code is returned.
+
+       \note The \ref AF_ITERATIVE_DECONV_LANDWEBER iterations are computed
+       together in frequency space, so they always run \p max_iterations
+       iterations.
+
+       \ingroup image_func_iterative_deconv
+     */
+    AFAPI af_err af_iterative_deconv_v2(af_array* out, unsigned* iterations,
+                                        const af_array in, const af_array ker,
+                                        const unsigned max_iterations,
+                                        const float relax_factor,
+                                        const af_iterative_deconv_algo algo,
+                                        const double tol,
+                                        const unsigned check_interval);
+#endif
+
+#if AF_API_VERSION >= 37
     /**
        C Interface for Tikhonov deconvolution algorithm
 
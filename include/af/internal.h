@@ -88,6 +88,28 @@ namespace af
     */
     AFAPI bool isOwner(const array &in);
 #endif
+
+#if AF_API_VERSION >= 38
+    /**
+       \param[in] tensor is a DLManagedTensor. The array takes ownership of it.
+       \param[in] stream is the native stream or queue on which the producer
+                  wrote the tensor, or NULL if it is ready
+       \returns an af::array which uses the memory of \p tensor
+
+       \ingroup internal_func_dlpack
+    */
+    AFAPI array fromDLPack(void *tensor, void *stream = NULL);
+
+    /**
+       \param[in] in is the array to export
+       \param[in] stream is the native stream or queue on which the consumer
+                  will read the tensor, or NULL to wait for \p in
+       \returns a DLManagedTensor which uses the memory of \p in
+
+       \ingroup internal_func_dlpack
+    */
+    AFAPI void *toDLPack(const array &in, void *stream = NULL);
+#endif
 }
 #endif
 
@@ -187,6 +209,53 @@ extern "C"
     AFAPI af_err af_get_allocated_bytes(size_t *bytes, const af_array arr);
 #endif
 
+#if AF_API_VERSION >= 38
+    /**
+       Creates an array which uses the memory of a DLPack tensor
+
+       The last dimension of the tensor is the first dimension of the array,
+       so a row major tensor becomes its transpose without a copy. The
+       tensor must have at most four dimensions and be contiguous along its
+       last one.
+
+       \param[out] arr is the array which uses the memory of \p tensor
+       \param[in] tensor is a DLManagedTensor on the active device. The
+                  array takes ownership of it on success, and calls its
+                  deleter once the array and its copies are released.
+       \param[in] stream is the native stream or queue on which the
+                  producer wrote the tensor: a cudaStream_t for CUDA or a
+                  cl_command_queue for OpenCL. The kernels of ArrayFire wait
+                  for its work. NULL if the tensor is ready.
+
+       \note ArrayFire does not write the results of other arrays to the
+             memory of \p tensor.
+
+       \ingroup internal_func_dlpack
+    */
+    AFAPI af_err af_from_dlpack(af_array *arr, void *tensor, void *stream);
+
+    /**
+       Exports an array as a DLPack tensor without copying it
+
+       The first dimension of the array is the last dimension of the
+       tensor, with the strides and the offset of the array. The buffer is
+       locked, as with \ref af_lock_array, until the consumer calls the
+       deleter of the tensor.
+
+       \param[out] tensor is a DLManagedTensor which uses the memory of
+                   \p arr
+       \param[in] arr is the array to export
+       \param[in] stream is the native stream or queue on which the
+                  consumer will read the tensor: a cudaStream_t for CUDA or
+                  a cl_command_queue for OpenCL. It waits for the kernels
+                  which wrote \p arr. If it is NULL, this function waits for
+                  them.
+
+       \ingroup internal_func_dlpack
+    */
+    AFAPI af_err af_to_dlpack(void **tensor, const af_array arr, void *stream);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,10 @@ namespace af
        \param[out] vt is the output array containing V^H
        \param[in] in is the input matrix
 
+       \note The matrices of a batch along the third and fourth dimensions of
+             \p in are decomposed together. \p s then has a column of singular
+             values for each matrix, along the same dimensions.
+
        \ingroup lapack_factor_func_svd
     */
     AFAPI void svd(array &u, array &s, array &vt, const array &in);
@@ -48,6 +52,32 @@ namespace af
     AFAPI void svdInPlace(array &u, array &s, array &vt, array &in);
 #endif
 
+#if AF_API_VERSION >= 38
+    /**
+       C++ Interface for the randomized SVD of the largest singular values
+
+       \param[out] u is the output array containing the \p rank columns of U
+       \param[out] s is the output array containing the \p rank largest
+                   singular values
+       \param[out] vt is the output array containing the \p rank rows of V^H
+       \param[in] in is the input matrix
+       \param[in] rank is the number of singular values
+       \param[in] oversampling is the number of additional random samples of
+                  the range of \p in, which improve the accuracy
+       \param[in] iterations is the number of subspace iterations, which
+                  improve the accuracy when the singular values decay slowly
+
+       \note The decomposition is approximated from random samples of the
+             range of \p in, which are drawn from the default random engine
+
+       \ingroup lapack_factor_func_svd
+    */
+    AFAPI void svdRandomized(array &u, array &s, array &vt, const array &in,
+                             const unsigned rank,
+                             const unsigned oversampling = 10,
+                             const unsigned iterations   = 2);
+#endif
+
     /**
        C++ Interface for LU decomposition in packed format
 
@@ -168,6 +198,7 @@ namespace af
        \returns \p x, the matrix of unknown variables
 
        \note \p options needs to be one of \ref AF_MAT_NONE, \ref AF_MAT_LOWER or \ref AF_MAT_UPPER
+       \note When \p a is a CSR array, \p options needs to be \ref AF_MAT_LOWER or \ref AF_MAT_UPPER, optionally with \ref AF_MAT_DIAG_UNIT
        \note This function is not supported in GFOR
 
        \ingroup lapack_solve_func_gen
@@ -192,6 +223,111 @@ namespace af
     AFAPI array solveLU(const array &a, const array &piv,
                         const array &b, const matProp options = AF_MAT_NONE);
 
+#if AF_API_VERSION >= 38
+    /**
+       C++ Interface for solving a Hermitian positive definite system with
+       the conjugate gradient method
+
+       \param[in] A is the dense or sparse coefficient matrix
+       \param[in] b is the right hand side vector
+       \param[in] tol is the tolerance on the norm of the residual, relative
+                  to the norm of \p b
+       \param[in] maxIterations is the maximum number of iterations
+       \param[in] ptype is the type of the preconditioner
+       \param[in] precond is the preconditioner: the inverse of the diagonal
+                  of \p A for \ref AF_PRECOND_JACOBI, the factor of
+                  \ref af::sparseILU0 or \ref af::sparseIC0, or a dense or
+                  sparse approximate inverse of \p A for
+                  \ref AF_PRECOND_MATRIX
+       \param[in] x0 is the initial guess. The default is zero.
+       \param[in] checkInterval is the number of iterations between the
+                  checks of the residual, which are the only values read
+                  back to the host
+       \param[out] iterations will contain the number of iterations, when
+                   it is not NULL
+       \returns \p x, the solution of A x = b
+
+       \ingroup lapack_solve_func_iterative
+    */
+    AFAPI array cg(const array &A, const array &b, const double tol = 1e-6,
+                   const unsigned maxIterations = 1000,
+                   const precondType ptype = AF_PRECOND_NONE,
+                   const array &precond = array(), const array &x0 = array(),
+                   const unsigned checkInterval = 10,
+                   unsigned *iterations = NULL);
+
+    /**
+       C++ Interface for solving a system with the stabilized biconjugate
+       gradient method
+
+       \param[in] A is the dense or sparse coefficient matrix
+       \param[in] b is the right hand side vector
+       \param[in] tol is the tolerance on the norm of the residual, relative
+                  to the norm of \p b
+       \param[in] maxIterations is the maximum number of iterations
+       \param[in] ptype is the type of the preconditioner
+       \param[in] precond is the preconditioner: the inverse of the diagonal
+                  of \p A for \ref AF_PRECOND_JACOBI, the factor of
+                  \ref af::sparseILU0 or \ref af::sparseIC0, or a dense or
+                  sparse approximate inverse of \p A for
+                  \ref AF_PRECOND_MATRIX
+       \param[in] x0 is the initial guess. The default is zero.
+       \param[in] checkInterval is the number of iterations between the
+                  checks of the residual, which are the only values read
+                  back to the host
+       \param[out] iterations will contain the number of iterations, when
+                   it is not NULL
+       \returns \p x, the solution of A x = b
+
+       \ingroup lapack_solve_func_iterative
+    */
+    AFAPI array bicgstab(const array &A, const array &b,
+                         const double tol = 1e-6,
+                         const unsigned maxIterations = 1000,
+                         const precondType ptype = AF_PRECOND_NONE,
+                         const array &precond = array(),
+                         const array &x0 = array(),
+                         const unsigned checkInterval = 10,
+                         unsigned *iterations = NULL);
+
+    /**
+       C++ Interface for solving a system with the restarted generalized
+       minimal residual method
+
+       \param[in] A is the dense or sparse coefficient matrix
+       \param[in] b is the right hand side vector
+       \param[in] tol is the tolerance on the norm of the residual, relative
+                  to the norm of \p b
+       \param[in] maxIterations is the maximum number of iterations
+       \param[in] restart is the number of iterations between the restarts
+       \param[in] ptype is the type of the preconditioner
+       \param[in] precond is the preconditioner: the inverse of the diagonal
+                  of \p A for \ref AF_PRECOND_JACOBI, the factor of
+                  \ref af::sparseILU0 or \ref af::sparseIC0, or a dense or
+                  sparse approximate inverse of \p A for
+                  \ref AF_PRECOND_MATRIX
+       \param[in] x0 is the initial guess. The default is zero.
+       \param[in] checkInterval is the number of iterations between the
+                  checks of the residual, which are the only values read
+                  back to the host
+       \param[out] iterations will contain the number of iterations, when
+                   it is not NULL
+       \returns \p x, the solution of A x = b
+
+       \note The preconditioner is applied on the right
+
+       \ingroup lapack_solve_func_iterative
+    */
+    AFAPI array gmres(const array &A, const array &b, const double tol = 1e-6,
+                      const unsigned maxIterations = 1000,
+                      const unsigned restart       = 30,
+                      const precondType ptype      = AF_PRECOND_NONE,
+                      const array &precond         = array(),
+                      const array &x0              = array(),
+                      const unsigned checkInterval = 10,
+                      unsigned *iterations         = NULL);
+#endif
+
     /**
        C++ Interface for inverting a matrix
 
@@ -266,6 +402,58 @@ namespace af
     AFAPI double norm(const array &in, const normType type=AF_NORM_EUCLID,
                       const double p=1, const double q=1);
 
+#if AF_API_VERSION >= 38
+    /**
+       C++ Interface for the determinants of a batch of matrices
+
+       \param[in] in is the input array of square matrices, which are batched
+                  along its third and fourth dimensions
+
+       \returns a 1 x 1 x P x Q array with the determinants of the matrices
+
+       \ingroup lapack_ops_func_det
+    */
+    AFAPI array detBatched(const array &in);
+
+    /**
+       C++ Interface for the logarithms of the determinants of a batch of
+       matrices
+
+       \param[out] logAbs will contain the natural logarithms of the absolute
+                   values of the determinants
+       \param[out] sign will contain the signs of the determinants, or their
+                   phases for complex matrices, which are 0 for the singular
+                   matrices
+       \param[in] in is the input array of square matrices, which are batched
+                  along its third and fourth dimensions
+
+       \note The determinant is sign * exp(logAbs), which may overflow when it
+             is computed directly
+
+       \ingroup lapack_ops_func_det
+    */
+    AFAPI void logDet(array &logAbs, array &sign, const array &in);
+
+    /**
+       C++ Interface for the norms of a batch of matrices
+
+       \param[in] in is the input array of matrices, which are batched along
+                  its third and fourth dimensions
+       \param[in] type specifies the \ref af::normType
+       \param[in] p specifies the value of P when \p type is one of
+                  \ref AF_NORM_VECTOR_P, AF_NORM_MATRIX_L_PQ is used
+       \param[in] q specifies the value of Q when \p type is
+                  AF_NORM_MATRIX_L_PQ
+
+       \returns a 1 x 1 x P x Q array with the norms of the matrices
+
+       \ingroup lapack_ops_func_norm
+    */
+    AFAPI array normBatched(const array &in,
+                            const normType type = AF_NORM_EUCLID,
+                            const double p = 1, const double q = 1);
+#endif
+
 #if AF_API_VERSION >= 33
     /**
        Returns true is ArrayFire is compiled with LAPACK support
@@ -293,6 +481,10 @@ extern "C" {
        \param[out] vt is the output array containing V^H
        \param[in] in is the input matrix
 
+       \note The matrices of a batch along the third and fourth dimensions of
+             \p in are decomposed together. \p s then has a column of singular
+             values for each matrix, along the same dimensions.
+
        \ingroup lapack_factor_func_svd
     */
     AFAPI af_err af_svd(af_array *u, af_array *s, af_array *vt, const af_array in);
@@ -318,6 +510,32 @@ extern "C" {
     AFAPI af_err af_svd_inplace(af_array *u, af_array *s, af_array *vt, af_array in);
 #endif
 
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for the randomized SVD of the largest singular values
+
+       \param[out] u is the output array containing the \p rank columns of U
+       \param[out] s is the output array containing the \p rank largest
+                   singular values
+       \param[out] vt is the output array containing the \p rank rows of V^H
+       \param[in] in is the input matrix
+       \param[in] rank is the number of singular values
+       \param[in] oversampling is the number of additional random samples of
+                  the range of \p in, which improve the accuracy
+       \param[in] iterations is the number of subspace iterations, which
+                  improve the accuracy when the singular values decay slowly
+
+       \note The decomposition is approximated from random samples of the
+             range of \p in, which are drawn from the default random engine
+
+       \ingroup lapack_factor_func_svd
+    */
+    AFAPI af_err af_svd_randomized(af_array *u, af_array *s, af_array *vt,
+                                   const af_array in, const unsigned rank,
+                                   const unsigned oversampling,
+                                   const unsigned iterations);
+#endif
+
     /**
        C Interface for LU decomposition
 
@@ -401,6 +619,7 @@ extern "C" {
        \ingroup lapack_solve_func_gen
 
        \note \p options needs to be one of \ref AF_MAT_NONE, \ref AF_MAT_LOWER or \ref AF_MAT_UPPER
+       \note When \p a is a CSR array, \p options needs to be \ref AF_MAT_LOWER or \ref AF_MAT_UPPER, optionally with \ref AF_MAT_DIAG_UNIT
     */
     AFAPI af_err af_solve(af_array *x, const af_array a, const af_array b,
                           const af_mat_prop options);
@@ -422,6 +641,108 @@ extern "C" {
     AFAPI af_err af_solve_lu(af_array *x, const af_array a, const af_array piv,
                              const af_array b, const af_mat_prop options);
 
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for solving a Hermitian positive definite system with the
+       conjugate gradient method
+
+       \param[out] x will contain the solution of A x = b
+       \param[out] iterations will contain the number of iterations, when
+                   it is not NULL
+       \param[in] A is the dense or sparse coefficient matrix
+       \param[in] b is the right hand side vector
+       \param[in] tol is the tolerance on the norm of the residual, relative
+                  to the norm of \p b
+       \param[in] max_iterations is the maximum number of iterations
+       \param[in] precond_type is the type of the preconditioner
+       \param[in] precond is the preconditioner: the inverse of the diagonal
+                  of \p A for \ref AF_PRECOND_JACOBI, the factor of
+                  \ref af::sparseILU0 or \ref af::sparseIC0, or a dense or
+                  sparse approximate inverse of \p A for
+                  \ref AF_PRECOND_MATRIX
+       \param[in] x0 is the initial guess. The default is zero.
+       \param[in] check_interval is the number of iterations between the
+                  checks of the residual, which are the only values read
+                  back to the host
+
+       \ingroup lapack_solve_func_iterative
+    */
+    AFAPI af_err af_cg(af_array *x, unsigned *iterations, const af_array A,
+                       const af_array b, const double tol,
+                       const unsigned max_iterations,
+                       const af_precond_type precond_type,
+                       const af_array precond, const af_array x0,
+                       const unsigned check_interval);
+
+    /**
+       C Interface for solving a system with the stabilized biconjugate
+       gradient method
+
+       \param[out] x will contain the solution of A x = b
+       \param[out] iterations will contain the number of iterations, when
+                   it is not NULL
+       \param[in] A is the dense or sparse coefficient matrix
+       \param[in] b is the right hand side vector
+       \param[in] tol is the tolerance on the norm of the residual, relative
+                  to the norm of \p b
+       \param[in] max_iterations is the maximum number of iterations
+       \param[in] precond_type is the type of the preconditioner
+       \param[in] precond is the preconditioner: the inverse of the diagonal
+                  of \p A for \ref AF_PRECOND_JACOBI, the factor of
+                  \ref af::sparseILU0 or \ref af::sparseIC0, or a dense or
+                  sparse approximate inverse of \p A for
+                  \ref AF_PRECOND_MATRIX
+       \param[in] x0 is the initial guess. The default is zero.
+       \param[in] check_interval is the number of iterations between the
+                  checks of the residual, which are the only values read
+                  back to the host
+
+       \ingroup lapack_solve_func_iterative
+    */
+    AFAPI af_err af_bicgstab(af_array *x, unsigned *iterations,
+                             const af_array A, const af_array b,
+                             const double tol, const unsigned max_iterations,
+                             const af_precond_type precond_type,
+                             const af_array precond, const af_array x0,
+                             const unsigned check_interval);
+
+    /**
+       C Interface for solving a system with the restarted generalized
+       minimal residual method
+
+       \param[out] x will contain the solution of A x = b
+       \param[out] iterations will contain the number of iterations, when
+                   it is not NULL
+       \param[in] A is the dense or sparse coefficient matrix
+       \param[in] b is the right hand side vector
+       \param[in] tol is the tolerance on the norm of the residual, relative
+                  to the norm of \p b
+       \param[in] max_iterations is the maximum number of iterations
+       \param[in] restart is the number of iterations between the restarts
+       \param[in] precond_type is the type of the preconditioner
+       \param[in] precond is the preconditioner: the inverse of the diagonal
+                  of \p A for \ref AF_PRECOND_JACOBI, the factor of
+                  \ref af::sparseILU0 or \ref af::sparseIC0, or a dense or
+                  sparse approximate inverse of \p A for
+                  \ref AF_PRECOND_MATRIX
+       \param[in] x0 is the initial guess. The default is zero.
+       \param[in] check_interval is the number of iterations between the
+                  checks of the residual, which are the only values read
+                  back to the host
+
+       \note The preconditioner is applied on the right
+
+       \ingroup lapack_solve_func_iterative
+    */
+    AFAPI af_err af_gmres(af_array *x, unsigned *iterations, const af_array A,
+                          const af_array b, const double tol,
+                          const unsigned max_iterations,
+                          const unsigned restart,
+                          const af_precond_type precond_type,
+                          const af_array precond, const af_array x0,
+                          const unsigned check_interval);
+#endif
+
     /**
        C Interface for inverting a matrix
 
@@ -495,6 +816,59 @@ extern "C" {
     */
     AFAPI af_err af_norm(double *out, const af_array in, const af_norm_type type, const double p, const double q);
 
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for the determinants of a batch of matrices
+
+       \param[out] out will contain a 1 x 1 x P x Q array with the
+                   determinants of the matrices
+       \param[in] in is the input array of square matrices, which are batched
+                  along its third and fourth dimensions
+
+       \ingroup lapack_ops_func_det
+    */
+    AFAPI af_err af_det_batched(af_array *out, const af_array in);
+
+    /**
+       C Interface for the logarithms of the determinants of a batch of
+       matrices
+
+       \param[out] log_abs will contain the natural logarithms of the absolute
+                   values of the determinants
+       \param[out] sign will contain the signs of the determinants, or their
+                   phases for complex matrices, which are 0 for the singular
+                   matrices
+       \param[in] in is the input array of square matrices, which are batched
+                  along its third and fourth dimensions
+
+       \note The determinant is sign * exp(log_abs), which may overflow when
+             it is computed directly
+
+       \ingroup lapack_ops_func_det
+    */
+    AFAPI af_err af_log_det(af_array *log_abs, af_array *sign,
+                            const af_array in);
+
+    /**
+       C Interface for the norms of a batch of matrices
+
+       \param[out] out will contain a 1 x 1 x P x Q array with the norms of
+                   the matrices
+       \param[in] in is the input array of matrices, which are batched along
+                  its third and fourth dimensions
+       \param[in] type specifies the \ref af::normType
+       \param[in] p specifies the value of P when \p type is one of
+                  \ref AF_NORM_VECTOR_P, AF_NORM_MATRIX_L_PQ is used
+       \param[in] q specifies the value of Q when \p type is
+                  AF_NORM_MATRIX_L_PQ
+
+       \ingroup lapack_ops_func_norm
+    */
+    AFAPI af_err af_norm_batched(af_array *out, const af_array in,
+                                 const af_norm_type type, const double p,
+                                 const double q);
+#endif
+
 #if AF_API_VERSION >= 33
     /**
        Returns true is ArrayFire is compiled with LAPACK support
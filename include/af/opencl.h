@@ -144,6 +144,39 @@ AFAPI af_err afcl_get_device_type(afcl_device_type *res);
 AFAPI af_err afcl_get_platform(afcl_platform *res);
 #endif
 
+#if AF_API_VERSION >= 38
+/**
+   Bind a command queue to the calling thread for the active device
+
+   The kernels and memory copies issued by the calling thread on the active
+   device are enqueued on \p queue instead of the queue shared by all the
+   threads. Threads using different queues can execute their work, including
+   host to device transfers, concurrently on the same device. Use
+   \ref af_mark_event and \ref af_enqueue_wait_event to order the work of
+   different queues when arrays are shared between them.
+
+   \param[in] queue an in-order queue created on the active device and
+                    context. If NULL, the queue shared by all the threads is
+                    restored.
+   \returns \ref af_err error code
+
+   \note ArrayFire retains \p queue while it is bound. Out of order queues are
+         not supported.
+*/
+AFAPI af_err afcl_set_queue(cl_command_queue queue);
+
+/**
+   Create an additional command queue for the active device
+
+   \param[out] queue a new in-order queue on the active device and context
+   \returns \ref af_err error code
+
+   \note The user owns the queue and must release it with
+         clReleaseCommandQueue
+*/
+AFAPI af_err afcl_create_queue(cl_command_queue *queue);
+#endif
+
 /**
   @}
 */
@@ -282,6 +315,33 @@ static inline void deleteDevice(cl_device_id dev, cl_context ctx)
 #endif
 
 
+#if AF_API_VERSION >= 38
+/**
+   Bind a command queue to the calling thread for the active device
+
+   \param[in] queue an in-order queue on the active device and context. If
+                    NULL, the queue shared by all the threads is restored.
+*/
+static inline void setQueue(cl_command_queue queue)
+{
+    af_err err = afcl_set_queue(queue);
+    if (err!=AF_SUCCESS) throw af::exception("Failed to bind the OpenCL command queue to the thread");
+}
+
+/**
+   Create an additional command queue for the active device
+
+   \returns a new in-order queue owned by the caller
+*/
+static inline cl_command_queue createQueue()
+{
+    cl_command_queue queue;
+    af_err err = afcl_create_queue(&queue);
+    if (err!=AF_SUCCESS) throw af::exception("Failed to create an OpenCL command queue");
+    return queue;
+}
+#endif
+
 #if AF_API_VERSION >= 33
  typedef afcl_device_type deviceType;
  typedef afcl_platform platform;
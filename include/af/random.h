@@ -107,6 +107,42 @@ namespace af
       */
       unsigned long long getSeed(void) const;
 
+#if AF_API_VERSION >= 38
+      /**
+          \brief Returns the substream \p index of \p count independent
+                 substreams of the random engine
+
+          \param[in] index The index of the substream, less than \p count
+          \param[in] count The number of substreams
+
+          \returns a new random engine generating the substream
+
+          \see af_random_engine_substream
+      */
+      randomEngine substream(const unsigned index,
+                             const unsigned count) const;
+
+      /**
+          \brief Returns the \p count independent substreams of the random
+                 engine
+
+          \param[out] out The substreams, an array of \p count engines
+          \param[in] count The number of substreams
+
+          \see af_random_engine_substreams
+      */
+      void substreams(randomEngine *out, const unsigned count) const;
+
+      /**
+          \brief Skips \p n values of the random engine
+
+          \param[in] n The number of values skipped
+
+          \see af_random_engine_skip
+      */
+      void skip(const unsigned long long n);
+#endif
+
       /**
           \brief Returns the af_random_engine handle of this object
 
@@ -143,6 +179,61 @@ namespace af
     AFAPI array randn(const dim4 &dims, const dtype ty, randomEngine &r);
 #endif
 
+#if AF_API_VERSION >= 38
+    /**
+        \param[in] rate The rates of the elements, f32 or f64
+        \param[in] r The random engine object
+
+        \return array of the dimensions and the type of \p rate, with values
+                of the exponential distribution of the rate of each element
+
+        \ingroup random_func_distributions
+    */
+    AFAPI array randomExponential(const array &rate, randomEngine &r);
+
+    /**
+        \param[in] shape The shapes of the elements, f32 or f64
+        \param[in] scale The scales of the elements, of the dimensions and
+                         the type of \p shape
+        \param[in] r The random engine object
+
+        \return array of the dimensions and the type of \p shape, with values
+                of the gamma distribution of the shape and the scale of each
+                element
+
+        \ingroup random_func_distributions
+    */
+    AFAPI array randomGamma(const array &shape, const array &scale,
+                            randomEngine &r);
+
+    /**
+        \param[in] lambda The means of the elements, f32 or f64
+        \param[in] r The random engine object
+
+        \return array of the dimensions and the type of \p lambda, with
+                integer values of the Poisson distribution of the mean of
+                each element
+
+        \ingroup random_func_distributions
+    */
+    AFAPI array randomPoisson(const array &lambda, randomEngine &r);
+
+    /**
+        \param[in] lower The lower bounds of the elements, f32 or f64
+        \param[in] upper The upper bounds of the elements, of the dimensions
+                         and the type of \p lower
+        \param[in] r The random engine object
+
+        \return array of the dimensions and the type of \p lower, with values
+                of the standard normal distribution truncated to the bounds
+                of each element
+
+        \ingroup random_func_distributions
+    */
+    AFAPI array randomTruncatedNormal(const array &lower, const array &upper,
+                                      randomEngine &r);
+#endif
+
     /**
         \param[in] dims The dimensions of the array to be generated
         \param[in] ty The type of the array
@@ -475,6 +566,147 @@ extern "C" {
     AFAPI af_err af_release_random_engine(af_random_engine engine);
 #endif
 
+#if AF_API_VERSION >= 38
+    /**
+       C Interface for creating an independent substream of a random engine
+
+       The substreams \p index of \p count substreams of an engine are
+       reproducible: they only depend on the type, the seed and the state of
+       \p engine. They are meant to give each thread or device of a parallel
+       computation its own engine.
+
+       The Philox and Threefry engines partition their counter, so the
+       substreams do not overlap until one of them generates more than
+       2^64 / \p count values. The Mersenne engine has no partition of its
+       sequence: its substreams are seeded with a hash of the seed of
+       \p engine and \p index.
+
+       \param[out] substream The pointer to the returned random engine object
+       \param[in]  engine The random engine object the substream is taken from
+       \param[in]  index The index of the substream, less than \p count
+       \param[in]  count The number of substreams \p engine is split into
+       \returns \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup random_func_random_engine
+    */
+    AFAPI af_err af_random_engine_substream(af_random_engine *substream,
+                                            const af_random_engine engine,
+                                            const unsigned index,
+                                            const unsigned count);
+
+    /**
+       C Interface for creating all the substreams of a random engine
+
+       Returns the same engines as \ref af_random_engine_substream called
+       with the indices 0 to \p count - 1. The states of the Mersenne
+       substreams are initialized together, which is faster than creating
+       them one by one.
+
+       \param[out] substreams The array of \p count returned random engine
+                   objects, which are released by the caller
+       \param[in]  engine The random engine object the substreams are taken
+                   from
+       \param[in]  count The number of substreams \p engine is split into
+       \returns \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup random_func_random_engine
+    */
+    AFAPI af_err af_random_engine_substreams(af_random_engine *substreams,
+                                             const af_random_engine engine,
+                                             const unsigned count);
+
+    /**
+       C Interface for skipping values of a random engine
+
+       Advances the counter of \p engine by \p n, so the next values are
+       the ones generated after \p n values, without generating them. It is
+       not supported by the Mersenne engine, whose state cannot be advanced
+       without generating the values.
+
+       \param[inout] engine The random engine object
+       \param[in]    n The number of values skipped
+       \returns \ref AF_SUCCESS if the execution completes properly,
+                \ref AF_ERR_NOT_SUPPORTED for the Mersenne engine
+
+       \ingroup random_func_random_engine
+    */
+    AFAPI af_err af_random_engine_skip(af_random_engine *engine,
+                                       const unsigned long long n);
+
+    /**
+       C Interface for sampling the exponential distribution with a rate per
+       element
+
+       \param[out] out The generated array, of the dimensions and the type
+                   of \p rate
+       \param[in]  rate The rates of the elements, f32 or f64. The values of
+                   the rates which are not positive are NaN.
+       \param[in]  engine The random engine object
+       \returns \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup random_func_distributions
+    */
+    AFAPI af_err af_random_exponential(af_array *out, const af_array rate,
+                                       af_random_engine engine);
+
+    /**
+       C Interface for sampling the gamma distribution with a shape and a
+       scale per element
+
+       \param[out] out The generated array, of the dimensions and the type
+                   of \p shape
+       \param[in]  shape The shapes of the elements, f32 or f64
+       \param[in]  scale The scales of the elements, of the dimensions and
+                   the type of \p shape. The values of the elements whose
+                   shape or scale is not positive are NaN.
+       \param[in]  engine The random engine object
+       \returns \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup random_func_distributions
+    */
+    AFAPI af_err af_random_gamma(af_array *out, const af_array shape,
+                                 const af_array scale,
+                                 af_random_engine engine);
+
+    /**
+       C Interface for sampling the Poisson distribution with a mean per
+       element
+
+       \param[out] out The generated array, of the dimensions and the type
+                   of \p lambda, with integer values
+       \param[in]  lambda The means of the elements, f32 or f64. The values
+                   of the negative means are NaN.
+       \param[in]  engine The random engine object
+       \returns \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup random_func_distributions
+    */
+    AFAPI af_err af_random_poisson(af_array *out, const af_array lambda,
+                                   af_random_engine engine);
+
+    /**
+       C Interface for sampling the standard normal distribution truncated to
+       bounds per element
+
+       \param[out] out The generated array, of the dimensions and the type
+                   of \p lower
+       \param[in]  lower The lower bounds of the elements, f32 or f64. They
+                   may be -infinity.
+       \param[in]  upper The upper bounds of the elements, of the dimensions
+                   and the type of \p lower. They may be infinity. The
+                   values of the elements whose lower bound is not below
+                   their upper bound are NaN.
+       \param[in]  engine The random engine object
+       \returns \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup random_func_distributions
+    */
+    AFAPI af_err af_random_truncated_normal(af_array *out,
+                                            const af_array lower,
+                                            const af_array upper,
+                                            af_random_engine engine);
+#endif
+
     /**
         \param[out] out The generated array
         \param[in] ndims Size of dimension array \p dims
@@ -0,0 +1,251 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <af/array.h>
+#include <af/defines.h>
+
+#if AF_API_VERSION >= 38
+
+/**
+   A handle to an array sharded across devices
+
+   \ingroup sharded_mat
+*/
+typedef void *af_sharded_array;
+
+/**
+   A function which computes one shard of the result of \ref af_sharded_map
+
+   It is called with the device of the shards as the active device.
+
+   \param[out] out        The shard of the result on the active device
+   \param[in]  shards     The shards of the inputs on the active device
+   \param[in]  num_inputs The number of inputs
+   \param[in]  user_data  The pointer passed to \ref af_sharded_map
+
+   \returns AF_SUCCESS or the error of the computation
+
+   \ingroup sharded_mat
+*/
+typedef af_err (*af_shard_fn)(af_array *out, const af_array *shards,
+                              const unsigned num_inputs, void *user_data);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /**
+       Creates an array sharded across devices
+
+       \p in is split along its last non-singleton dimension as in
+       \ref af_scatter, with shard i on \p devices[i].
+
+       \param[out] out         The sharded array. Release it with
+                               \ref af_release_sharded_array.
+       \param[in]  in          The array to shard
+       \param[in]  num_devices The number of shards
+       \param[in]  devices     The devices of the shards
+
+       \ingroup sharded_mat
+    */
+    AFAPI af_err af_create_sharded_array(af_sharded_array *out,
+                                         const af_array in,
+                                         const unsigned num_devices,
+                                         const int *devices);
+
+    /**
+       Releases a sharded array and its shards
+
+       \ingroup sharded_mat
+    */
+    AFAPI af_err af_release_sharded_array(af_sharded_array arr);
+
+    /**
+       Gets the layout of a sharded array
+
+       \param[out] num_shards The number of shards. Can be NULL.
+       \param[out] dim        The dimension along which the array is sharded.
+                              Can be NULL.
+       \param[out] dims       The 4 dimensions of the whole array. Can be
+                              NULL.
+       \param[in]  arr        The sharded array
+
+       \ingroup sharded_mat
+    */
+    AFAPI af_err af_get_sharded_info(unsigned *num_shards, int *dim,
+                                     dim_t *dims, const af_sharded_array arr);
+
+    /**
+       Gets a shard of a sharded array
+
+       \param[out] shard A new handle to the shard, which is on its own
+                         device. Release it with \ref af_release_array.
+       \param[in]  arr   The sharded array
+       \param[in]  index The index of the shard
+
+       \ingroup sharded_mat
+    */
+    AFAPI af_err af_get_shard(af_array *shard, const af_sharded_array arr,
+                              const unsigned index);
+
+    /**
+       Evaluates a function on each shard of sharded arrays
+
+       \p fn is called once per shard, with the device of the shard as the
+       active device and the matching shards of \p ins. Its result is
+       evaluated before the next shard, so the JIT kernels of each device
+       are launched one after the other without waiting for each other and
+       run concurrently. The results are the shards of \p out, which is
+       sharded along the same dimension on the same devices.
+
+       \param[out] out        The sharded result. Release it with
+                              \ref af_release_sharded_array.
+       \param[in]  num_inputs The number of inputs
+       \param[in]  ins        The inputs, which are sharded the same way
+       \param[in]  fn         The function computing a shard of \p out
+       \param[in]  user_data  A pointer passed to \p fn
+
+       \ingroup sharded_mat
+    */
+    AFAPI af_err af_sharded_map(af_sharded_array *out,
+                                const unsigned num_inputs,
+                                const af_sharded_array *ins, af_shard_fn fn,
+                                void *user_data);
+
+    /**
+       Reduces all the elements of a sharded array
+
+       Each shard is reduced on its own device, and the partial results are
+       copied to \p device and reduced there. The type of the result is the
+       one of the reductions of \ref af_sum, \ref af_product, \ref af_min and
+       \ref af_max.
+
+       \param[out] out    A one element array on \p device
+       \param[in]  in     The sharded array
+       \param[in]  op     The reduction
+       \param[in]  device The device of \p out. The active device is used if
+                          it is negative.
+
+       \ingroup sharded_mat
+    */
+    AFAPI af_err af_sharded_reduce(af_array *out, const af_sharded_array in,
+                                   const af_binary_op op, const int device);
+
+    /**
+       Joins the shards of a sharded array on one device
+
+       \param[out] out    The whole array on \p device
+       \param[in]  in     The sharded array
+       \param[in]  device The device of \p out. The active device is used if
+                          it is negative.
+
+       \ingroup sharded_mat
+    */
+    AFAPI af_err af_sharded_gather(af_array *out, const af_sharded_array in,
+                                   const int device);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+namespace af
+{
+    /**
+       An array sharded across devices
+
+       The array is split along its last non-singleton dimension, one shard
+       on each device of a set. The element-wise expressions of
+       \ref af::shardedArray::map are evaluated on each shard on its own
+       device, and the reductions combine the partial results of the shards,
+       so the array can exceed the memory of one device.
+
+       \code
+       array scale(const array &x) { return 2 * x + 1; }
+
+       int devices[] = {0, 1, 2, 3};
+       af::shardedArray a(af::randu(1 << 16, 4096), 4, devices);
+       af::shardedArray b = a.map(scale);  // Launched on the 4 devices
+       float total = b.reduce(AF_BINARY_ADD).scalar<float>();
+       \endcode
+
+       \ingroup sharded_mat
+    */
+    class AFAPI shardedArray {
+        af_sharded_array arr;
+
+        shardedArray(const shardedArray &);
+        shardedArray &operator=(const shardedArray &);
+
+       public:
+        /// A function computing a shard of the result of
+        /// \ref af::shardedArray::map from a shard
+        typedef array (*unaryFunc)(const array &shard);
+
+        /// A function computing a shard of the result of
+        /// \ref af::shardedArray::map from the shards of two arrays
+        typedef array (*binaryFunc)(const array &lhs, const array &rhs);
+
+        /// Takes the ownership of \p handle
+        explicit shardedArray(const af_sharded_array handle);
+
+        /// \copydoc af_create_sharded_array
+        shardedArray(const array &in, const unsigned num_devices,
+                     const int *devices);
+
+#if AF_COMPILER_CXX_RVALUE_REFERENCES
+        /// Move constructor
+        shardedArray(shardedArray &&other);
+
+        /// Move assignment operator
+        shardedArray &operator=(shardedArray &&other);
+#endif
+
+        ~shardedArray();
+
+        /// Returns the handle of the array
+        af_sharded_array get() const;
+
+        /// Returns the number of shards
+        unsigned numShards() const;
+
+        /// Returns the dimension along which the array is sharded
+        int shardDim() const;
+
+        /// Returns the dimensions of the whole array
+        dim4 dims() const;
+
+        /// Returns the shard \p index, which is on its own device
+        array shard(const unsigned index) const;
+
+        /// \copydoc af_sharded_gather
+        array gather(const int device = -1) const;
+
+        /// \copydoc af_sharded_reduce
+        array reduce(const binaryOp op = AF_BINARY_ADD,
+                     const int device = -1) const;
+
+        /// Evaluates \p func on each shard on its own device
+        ///
+        /// \note See \ref af_sharded_map
+        shardedArray map(unaryFunc func) const;
+
+        /// Evaluates \p func on the shards of \p lhs and \p rhs on their
+        /// device. \p lhs and \p rhs have to be sharded the same way.
+        ///
+        /// \note See \ref af_sharded_map
+        static shardedArray map(const shardedArray &lhs,
+                                const shardedArray &rhs, binaryFunc func);
+    };
+}
+#endif
+
+#endif
@@ -10,6 +10,22 @@
 #pragma once
 #include <af/defines.h>
 
+#if AF_API_VERSION >= 38
+/**
+    Handle to the state of a streaming convolution
+
+    \ingroup signal_func_convolve1
+*/
+typedef void *af_convolve_stream;
+
+/**
+    Handle to an interpolation plan
+
+    \ingroup signal_func_approx1
+*/
+typedef void *af_interp_plan;
+#endif
+
 #ifdef __cplusplus
 
 namespace af
@@ -125,6 +141,69 @@ AFAPI array approx2(const array &in,
                     const interpType method = AF_INTERP_LINEAR, const float off_grid = 0.0f);
 #endif
 
+#if AF_API_VERSION >= 38
+/**
+   C++ RAII interface for interpolating many inputs at the same positions
+
+   A plan computes the input elements each position reads and their weights
+   once, so resampling many inputs on the same grid does not compute them
+   again. Its results are those of \ref approx1 and \ref approx2 along the
+   first dimensions of the inputs. The positions are sorted by the elements
+   they read, so the inputs are read in order even for unsorted positions.
+
+   \ingroup signal_func_approx1
+ */
+class AFAPI interpPlan {
+    af_interp_plan plan_;
+
+   public:
+    /// Creates a plan for interpolating the columns of inputs of
+    /// \p inLength rows
+    ///
+    /// \param[in] pos is the column vector of positions along the first
+    ///            dimension
+    /// \param[in] inLength is the number of rows of the inputs
+    /// \param[in] method is the interpolation method: nearest neighbor,
+    ///            lower, linear, linear cosine, cubic or cubic spline
+    /// \param[in] offGrid is the value of the positions outside the inputs
+    interpPlan(const array &pos, const dim_t inLength,
+               const interpType method = AF_INTERP_LINEAR,
+               const float offGrid = 0.0f);
+
+    /// Creates a plan for interpolating the images of inputs of
+    /// \p inRows x \p inCols elements
+    ///
+    /// \param[in] pos0 is the positions along the first dimension
+    /// \param[in] pos1 is the positions along the second dimension. It has
+    ///            the dimensions of \p pos0.
+    /// \param[in] inRows is the number of rows of the inputs
+    /// \param[in] inCols is the number of columns of the inputs
+    /// \param[in] method is the interpolation method
+    /// \param[in] offGrid is the value of the positions outside the inputs
+    interpPlan(const array &pos0, const array &pos1, const dim_t inRows,
+               const dim_t inCols, const interpType method = AF_INTERP_LINEAR,
+               const float offGrid = 0.0f);
+
+    /// interpPlan Destructor
+    ~interpPlan();
+
+    /// Return the underlying C af_interp_plan handle
+    af_interp_plan get() const;
+
+    /// Interpolates \p in at the positions of the plan
+    ///
+    /// \param[in] in is the input. Its first dimensions are the sizes the
+    ///            plan was created for and its other dimensions are
+    ///            batched.
+    /// \returns   the interpolated array
+    array apply(const array &in) const;
+
+   private:
+    interpPlan &operator=(const interpPlan &other);
+    interpPlan(const interpPlan &other);
+};
+#endif
+
 /**
    C++ Interface for fast fourier transform on one dimensional signals
 
@@ -531,7 +610,7 @@ array fftC2R(const array &in, bool is_odd = false,
    \param[in]  domain specifies if the convolution should be performed in frequency os spatial domain
    \return     the convolved array
 
-   \note The default parameter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain.
+   \note The default parameter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain. When the environment variable AF_CONVOLVE_AUTOTUNE is set to 1, it benchmarks the methods instead the first time a shape is convolved.
 
    \ingroup signal_func_convolve
  */
@@ -548,7 +627,7 @@ AFAPI array convolve(const array& signal, const array& filter, const convMode mo
    \param[in]  mode indicates if the convolution should be expanded or not(where output size equals input)
    \return     the convolved array
 
-   \note The default parameter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain.
+   \note The default parameter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain. When the environment variable AF_CONVOLVE_AUTOTUNE is set to 1, it benchmarks the methods instead the first time a shape is convolved.
 
    \note Separable convolution only supports two(ONE-to-ONE and MANY-to-ONE) batch modes from the ones described in the detailed description section.
 
@@ -567,7 +646,7 @@ AFAPI array convolve(const array& col_filter, const array& row_filter, const arr
    \param[in]  domain specifies if the convolution should be performed in frequency os spatial domain
    \return     the convolved array
 
-   \note The default parameter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain.
+   \note The default parameter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain. When the environment variable AF_CONVOLVE_AUTOTUNE is set to 1, it benchmarks the methods instead the first time a shape is convolved.
 
    \ingroup signal_func_convolve1
  */
@@ -584,7 +663,7 @@ AFAPI array convolve1(const array& signal, const array& filter, const convMode m
    \param[in]  domain specifies if the convolution should be performed in frequency os spatial domain
    \return     the convolved array
 
-   \note The default parameter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain.
+   \note The default parameter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain. When the environment variable AF_CONVOLVE_AUTOTUNE is set to 1, it benchmarks the methods instead the first time a shape is convolved.
 
    \ingroup signal_func_convolve2
  */
@@ -631,12 +710,41 @@ AFAPI array convolve2NN(const array& signal, const array& filter,
    \param[in]  domain specifies if the convolution should be performed in frequency os spatial domain
    \return     the convolved array
 
-   \note The default parameter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain.
+   \note The default parameter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain. When the environment variable AF_CONVOLVE_AUTOTUNE is set to 1, it benchmarks the methods instead the first time a shape is convolved.
 
    \ingroup signal_func_convolve3
  */
 AFAPI array convolve3(const array& signal, const array& filter, const convMode mode=AF_CONV_DEFAULT, const convDomain domain=AF_CONV_AUTO);
 
+#if AF_API_VERSION >= 38
+/**
+   C++ Interface for saving the convolution tuning table
+
+   The table holds the methods \ref AF_CONV_AUTO chose for the convolutions
+   benchmarked when the environment variable AF_CONVOLVE_AUTOTUNE is set to 1.
+   Its keys contain the backend and the name of the device, so the file can be
+   imported on other machines.
+
+   \param[in]  path is the file the table is written to
+
+   \ingroup signal_func_convolve
+ */
+AFAPI void exportConvolveTuning(const char *path);
+
+/**
+   C++ Interface for loading a convolution tuning table
+
+   The methods in the file replace the methods of the same convolutions in the
+   tuning table. They are used by \ref AF_CONV_AUTO even if
+   AF_CONVOLVE_AUTOTUNE is not set.
+
+   \param[in]  path is a file written by \ref af::exportConvolveTuning
+
+   \ingroup signal_func_convolve
+ */
+AFAPI void importConvolveTuning(const char *path);
+#endif
+
 /**
    C++ Interface for FFT-based convolution any(one through three) dimensional signals
 
@@ -661,6 +769,79 @@ AFAPI array fftConvolve(const array& signal, const array& filter, const convMode
  */
 AFAPI array fftConvolve1(const array& signal, const array& filter, const convMode mode=AF_CONV_DEFAULT);
 
+#if AF_API_VERSION >= 38
+/**
+   C++ Interface for convolution on long 1D signals using FFTs of blocks
+
+   The signal is cut into overlapping blocks of \p blockSize elements which
+   are transformed with the filter (the overlap-save method). The size of the
+   transforms does not depend on the length of the signal, so long signals
+   need much less memory than with \ref fftConvolve1.
+
+   \param[in]  signal is the input signal. Its columns are convolved
+               separately.
+   \param[in]  filter is the one dimensional filter
+   \param[in]  blockSize is the number of elements of each transform. It
+               must be at least the length of the filter. Zero chooses a
+               size several times the length of the filter.
+   \param[in]  mode indicates if the convolution should be expanded or
+               not(where output size equals input)
+   \return     the convolved array
+
+   \ingroup signal_func_convolve1
+ */
+AFAPI array fftConvolve1Block(const array& signal, const array& filter,
+                              const dim_t blockSize = 0,
+                              const convMode mode = AF_CONV_DEFAULT);
+
+/**
+   C++ RAII interface for filtering a signal which arrives in chunks
+
+   Each chunk pushed to the stream returns as many filtered elements, which
+   are the elements \ref fir returns for the concatenated chunks. The
+   transform of the filter is computed once and the chunks are convolved
+   with the overlap-save method, so chunks of the same size reuse the cached
+   FFT plans.
+
+   \ingroup signal_func_convolve1
+ */
+class AFAPI convolveStream {
+    af_convolve_stream stream_;
+
+   public:
+    /// Creates a stream which filters its chunks with \p filter
+    ///
+    /// \param[in] filter is the one dimensional filter. The chunks are
+    ///            converted to its type, or to f32 for integer filters.
+    /// \param[in] blockSize is the number of elements of each transform.
+    ///            Zero chooses a size several times the length of the
+    ///            filter.
+    convolveStream(const array& filter, const dim_t blockSize = 0);
+
+    /// convolveStream Destructor
+    ~convolveStream();
+
+    /// Return the underlying C af_convolve_stream handle
+    af_convolve_stream get() const;
+
+    /// Filters the next chunk of the signal
+    ///
+    /// \param[in] chunk is the next chunk of the signal. Its columns are
+    ///            separate signals, so every chunk must have the same
+    ///            number of columns.
+    /// \returns   the filtered chunk
+    array push(const array& chunk);
+
+    /// Forgets the chunks pushed so far, so the next chunk starts a new
+    /// signal
+    void reset();
+
+   private:
+    convolveStream& operator=(const convolveStream& other);
+    convolveStream(const convolveStream& other);
+};
+#endif
+
 /**
    C++ Interface for convolution on 2D signals using FFT
 
@@ -773,6 +954,35 @@ AFAPI array medfilt2(const array& in, const dim_t wind_length = 3, const dim_t w
 AFAPI void setFFTPlanCacheSize(size_t cacheSize);
 #endif
 
+#if AF_API_VERSION >= 38
+/**
+   C++ Interface for limiting the workspace memory of the plan cache
+
+   This function doesn't do anything if called when CPU backend is active. The
+   least recently used plans are removed from the cache until the workspace
+   memory of the cached plans is below the limit.
+
+   \param[in] cacheBytes is the maximum number of bytes of workspace held by
+              the cached plans. Zero removes the limit.
+*/
+AFAPI void setFFTPlanCacheBytes(size_t cacheBytes);
+
+/**
+   C++ Interface for creating the FFT plans of a shape ahead of time
+
+   Creates the plans used by the forward and inverse transforms of an array of
+   size \p dims and type \p type and stores them in the plan cache. For real
+   types the plans of the real to complex and complex to real transforms are
+   created. The plan cache is local to the calling thread and device.
+
+   \param[in] dims is the size of the arrays that will be transformed
+   \param[in] rank is the number of dimensions of the transform (1, 2 or 3)
+   \param[in] type is the type of the arrays that will be transformed
+*/
+AFAPI void prepareFFTPlan(const dim4 &dims, const int rank,
+                          const dtype type = f32);
+#endif
+
 }
 #endif
 
@@ -1079,6 +1289,84 @@ AFAPI af_err af_approx2_uniform_v2(af_array *out, const af_array in,
                                    const float off_grid);
 #endif
 
+#if AF_API_VERSION >= 38
+/**
+   C Interface for creating a plan for interpolating columns
+
+   A plan computes the input elements each position reads and their weights
+   once, so resampling many inputs on the same grid does not compute them
+   again. Its results are those of \ref af_approx1. The positions are sorted
+   by the elements they read, so the inputs are read in order even for
+   unsorted positions.
+
+   \param[out] plan is the new plan
+   \param[in]  pos is the column vector of positions along the first
+               dimension
+   \param[in]  in_length is the number of rows of the inputs
+   \param[in]  method is the interpolation method: nearest neighbor, lower,
+               linear, linear cosine, cubic or cubic spline
+   \param[in]  off_grid is the value of the positions outside the inputs
+   \return     \ref AF_SUCCESS if the plan is created,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_approx1
+ */
+AFAPI af_err af_create_approx1_plan(af_interp_plan *plan, const af_array pos,
+                                    const dim_t in_length,
+                                    const af_interp_type method,
+                                    const float off_grid);
+
+/**
+   C Interface for creating a plan for interpolating images
+
+   Its results are those of \ref af_approx2. See \ref af_create_approx1_plan.
+
+   \param[out] plan is the new plan
+   \param[in]  pos0 is the positions along the first dimension
+   \param[in]  pos1 is the positions along the second dimension. It has the
+               dimensions of \p pos0.
+   \param[in]  in_rows is the number of rows of the inputs
+   \param[in]  in_cols is the number of columns of the inputs
+   \param[in]  method is the interpolation method
+   \param[in]  off_grid is the value of the positions outside the inputs
+   \return     \ref AF_SUCCESS if the plan is created,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_approx2
+ */
+AFAPI af_err af_create_approx2_plan(af_interp_plan *plan, const af_array pos0,
+                                    const af_array pos1, const dim_t in_rows,
+                                    const dim_t in_cols,
+                                    const af_interp_type method,
+                                    const float off_grid);
+
+/**
+   C Interface for interpolating an input with a plan
+
+   \param[out] out is the interpolated array
+   \param[in]  plan is the plan
+   \param[in]  in is the input. Its first dimensions are the sizes the plan
+               was created for and its other dimensions are batched.
+   \return     \ref AF_SUCCESS if the interpolation is successful,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_approx1
+ */
+AFAPI af_err af_apply_interp_plan(af_array *out, const af_interp_plan plan,
+                                  const af_array in);
+
+/**
+   C Interface for releasing an interpolation plan
+
+   \param[in]  plan is the plan
+   \return     \ref AF_SUCCESS if the plan is released,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_approx1
+ */
+AFAPI af_err af_release_interp_plan(af_interp_plan plan);
+#endif
+
 /**
    C Interface for fast fourier transform on one dimensional signals
 
@@ -1388,7 +1676,7 @@ AFAPI af_err af_fft3_c2r(af_array *out, const af_array in, const double norm_fac
    \return     \ref AF_SUCCESS if the convolution is successful,
                otherwise an appropriate error code is returned.
 
-   \note The default parameter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain.
+   \note The default parameter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain. When the environment variable AF_CONVOLVE_AUTOTUNE is set to 1, it benchmarks the methods instead the first time a shape is convolved.
 
    \ingroup signal_func_convolve1
  */
@@ -1405,7 +1693,7 @@ AFAPI af_err af_convolve1(af_array *out, const af_array signal, const af_array f
    \return     \ref AF_SUCCESS if the convolution is successful,
                otherwise an appropriate error code is returned.
 
-   \note The default parameter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain.
+   \note The default parameter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain. When the environment variable AF_CONVOLVE_AUTOTUNE is set to 1, it benchmarks the methods instead the first time a shape is convolved.
 
    \ingroup signal_func_convolve2
  */
@@ -1457,12 +1745,45 @@ AFAPI af_err af_convolve2_nn(af_array *out, const af_array signal, const af_arra
    \return     \ref AF_SUCCESS if the convolution is successful,
                otherwise an appropriate error code is returned.
 
-   \note The default parameter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain.
+   \note The default parameter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain. When the environment variable AF_CONVOLVE_AUTOTUNE is set to 1, it benchmarks the methods instead the first time a shape is convolved.
 
    \ingroup signal_func_convolve3
  */
 AFAPI af_err af_convolve3(af_array *out, const af_array signal, const af_array filter, const af_conv_mode mode, af_conv_domain domain);
 
+#if AF_API_VERSION >= 38
+/**
+   C Interface for saving the convolution tuning table
+
+   The table holds the methods \ref AF_CONV_AUTO chose for the convolutions
+   benchmarked when the environment variable AF_CONVOLVE_AUTOTUNE is set to 1.
+   Its keys contain the backend and the name of the device, so the file can be
+   imported on other machines.
+
+   \param[in]  path is the file the table is written to
+   \return     \ref AF_SUCCESS if the table is written,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_convolve
+ */
+AFAPI af_err af_export_convolve_tuning(const char *path);
+
+/**
+   C Interface for loading a convolution tuning table
+
+   The methods in the file replace the methods of the same convolutions in the
+   tuning table. They are used by \ref AF_CONV_AUTO even if
+   AF_CONVOLVE_AUTOTUNE is not set.
+
+   \param[in]  path is a file written by \ref af_export_convolve_tuning
+   \return     \ref AF_SUCCESS if the table is read,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_convolve
+ */
+AFAPI af_err af_import_convolve_tuning(const char *path);
+#endif
+
 /**
    C Interface for separable convolution on two dimensional signals
 
@@ -1495,6 +1816,99 @@ AFAPI af_err af_convolve2_sep(af_array *out, const af_array col_filter, const af
  */
 AFAPI af_err af_fft_convolve1(af_array *out, const af_array signal, const af_array filter, const af_conv_mode mode);
 
+#if AF_API_VERSION >= 38
+/**
+   C Interface for convolution on long 1D signals using FFTs of blocks
+
+   The signal is cut into overlapping blocks of \p block_size elements which
+   are transformed with the filter (the overlap-save method). The size of the
+   transforms does not depend on the length of the signal, so long signals
+   need much less memory than with \ref af_fft_convolve1.
+
+   \param[out] out is convolved array
+   \param[in]  signal is the input signal. Its columns are convolved
+               separately.
+   \param[in]  filter is the one dimensional filter
+   \param[in]  block_size is the number of elements of each transform. It
+               must be at least the length of the filter. Zero chooses a
+               size several times the length of the filter.
+   \param[in]  mode indicates if the convolution should be expanded or
+               not(where output size equals input)
+   \return     \ref AF_SUCCESS if the convolution is successful,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_convolve1
+ */
+AFAPI af_err af_fft_convolve1_block(af_array *out, const af_array signal,
+                                    const af_array filter,
+                                    const dim_t block_size,
+                                    const af_conv_mode mode);
+
+/**
+   C Interface for creating a streaming convolution
+
+   Each chunk pushed to the stream with \ref af_convolve_stream_push returns
+   as many filtered elements, which are the elements \ref af_fir returns for
+   the concatenated chunks. The transform of the filter is computed once and
+   the chunks are convolved with the overlap-save method, so chunks of the
+   same size reuse the cached FFT plans.
+
+   \param[out] stream is the new stream
+   \param[in]  filter is the one dimensional filter. The chunks are
+               converted to its type, or to f32 for integer filters.
+   \param[in]  block_size is the number of elements of each transform. It
+               must be at least the length of the filter. Zero chooses a
+               size several times the length of the filter.
+   \return     \ref AF_SUCCESS if the stream is created,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_convolve1
+ */
+AFAPI af_err af_create_convolve_stream(af_convolve_stream *stream,
+                                       const af_array filter,
+                                       const dim_t block_size);
+
+/**
+   C Interface for filtering the next chunk of a streaming convolution
+
+   \param[out] out is the filtered chunk
+   \param[in]  stream is the stream
+   \param[in]  chunk is the next chunk of the signal. Its columns are
+               separate signals, so every chunk must have the same number of
+               columns.
+   \return     \ref AF_SUCCESS if the chunk is filtered,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_convolve1
+ */
+AFAPI af_err af_convolve_stream_push(af_array *out, af_convolve_stream stream,
+                                     const af_array chunk);
+
+/**
+   C Interface for restarting a streaming convolution
+
+   Forgets the chunks pushed so far, so the next chunk starts a new signal.
+
+   \param[in]  stream is the stream
+   \return     \ref AF_SUCCESS if the stream is reset,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_convolve1
+ */
+AFAPI af_err af_convolve_stream_reset(af_convolve_stream stream);
+
+/**
+   C Interface for releasing a streaming convolution
+
+   \param[in]  stream is the stream
+   \return     \ref AF_SUCCESS if the stream is released,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_convolve1
+ */
+AFAPI af_err af_release_convolve_stream(af_convolve_stream stream);
+#endif
+
 /**
    C Interface for convolution on 2D signals using FFT
 
@@ -1614,6 +2028,40 @@ AFAPI af_err af_iir(af_array *y, const af_array b, const af_array a, const af_ar
 AFAPI af_err af_set_fft_plan_cache_size(size_t cache_size);
 #endif
 
+#if AF_API_VERSION >= 38
+/**
+   C Interface for limiting the workspace memory of the plan cache
+
+   This function doesn't do anything if called when CPU backend is active. The
+   least recently used plans are removed from the cache until the workspace
+   memory of the cached plans is below the limit.
+
+   \param[in] cache_bytes is the maximum number of bytes of workspace held by
+              the cached plans. Zero removes the limit.
+
+   \ingroup signal_func_fft
+*/
+AFAPI af_err af_set_fft_plan_cache_bytes(size_t cache_bytes);
+
+/**
+   C Interface for creating the FFT plans of a shape ahead of time
+
+   Creates the plans used by the forward and inverse transforms of an array of
+   size \p dims and type \p type and stores them in the plan cache. For real
+   types the plans of the real to complex and complex to real transforms are
+   created. The plan cache is local to the calling thread and device.
+
+   \param[in] ndims is the number of dimensions in \p dims
+   \param[in] dims is the size of the arrays that will be transformed
+   \param[in] rank is the number of dimensions of the transform (1, 2 or 3)
+   \param[in] type is the type of the arrays that will be transformed
+
+   \ingroup signal_func_fft
+*/
+AFAPI af_err af_prepare_fft_plan(const unsigned ndims, const dim_t *const dims,
+                                 const int rank, const af_dtype type);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -99,6 +99,39 @@ namespace af
     AFAPI array sparseConvertTo(const array in, const af::storage destStrorage);
 #endif
 
+#if AF_API_VERSION >= 38
+    /**
+       Converts a sparse or dense matrix to one of the blocked storage types.
+
+       \ref AF_STORAGE_BSR stores the CSR structure of the \p blockSize x
+       \p blockSize blocks which have a nonzero value. The values of each
+       block are stored in column major order and the row indices are the
+       offsets of the block rows.
+
+       \ref AF_STORAGE_SELL (SELL-C-sigma) stores slices of \p blockSize rows
+       padded to the length of their longest row, in column major order. The
+       rows are sorted by length in windows of \p sortWindow rows first. The
+       padding has the column index -1 and the value 0. The row indices are
+       the offsets of the slices followed by the original row of each sorted
+       row.
+
+       The products of the blocked storage types with dense matrices do not
+       support transposes.
+
+       \param[in] in is the source sparse or dense matrix
+       \param[in] destStorage is \ref AF_STORAGE_BSR or \ref AF_STORAGE_SELL
+       \param[in] blockSize is the size of the blocks or the number of rows
+                  of the slices
+       \param[in] sortWindow is the number of rows sorted by length for
+                  \ref AF_STORAGE_SELL. 1 keeps the order of the rows.
+       \return \ref af::array for the sparse array with the given storage type
+
+       \ingroup sparse_func_convert_to
+     */
+    AFAPI array sparseConvertTo(const array in, const af::storage destStorage,
+                                const int blockSize, const int sortWindow = 1);
+#endif
+
 #if AF_API_VERSION >= 34
     /**
        \param[in] sparse is the source sparse matrix
@@ -174,6 +207,70 @@ namespace af
      */
     AFAPI af::storage sparseGetStorage(const array in);
 #endif
+
+#if AF_API_VERSION >= 38
+    /**
+       Replaces the values of a sparse array and keeps its indices
+
+       \param[inout] in is the sparse array
+       \param[in] values is the array of the new values. It has the type and
+                  the number of elements of the values of \p in.
+
+       \ingroup sparse_func_update
+     */
+    AFAPI void sparseSetValues(array &in, const array &values);
+
+    /**
+       Inserts entries into a CSR array. The entries which are already in the
+       array are overwritten, and the last of repeated entries is kept.
+
+       \param[inout] in is the CSR array
+       \param[in] values is the array of the values of the entries
+       \param[in] rowIdx is the array of the rows of the entries
+       \param[in] colIdx is the array of the columns of the entries
+
+       \ingroup sparse_func_update
+     */
+    AFAPI void sparseInsert(array &in, const array &values,
+                            const array &rowIdx, const array &colIdx);
+
+    /**
+       Removes entries from a CSR array. The entries which are not in the
+       array are ignored.
+
+       \param[inout] in is the CSR array
+       \param[in] rowIdx is the array of the rows of the entries
+       \param[in] colIdx is the array of the columns of the entries
+
+       \ingroup sparse_func_update
+     */
+    AFAPI void sparseRemove(array &in, const array &rowIdx,
+                            const array &colIdx);
+
+    /**
+       Returns the ILU(0) factorization of a square CSR array
+
+       \param[in] in is the square CSR array. Each row has its diagonal entry.
+       \return the CSR array with the pattern of \p in whose strictly lower
+               triangle is L, with a unit diagonal, and whose upper triangle
+               is U
+
+       \ingroup sparse_func_ilu0
+     */
+    AFAPI array sparseILU0(const array &in);
+
+    /**
+       Returns the IC(0) factorization of a Hermitian positive definite CSR
+       array
+
+       \param[in] in is the CSR array. Only its lower triangle is read.
+       \return the CSR array whose lower triangle is L and whose upper
+               triangle is the conjugate transpose of L
+
+       \ingroup sparse_func_ilu0
+     */
+    AFAPI array sparseIC0(const array &in);
+#endif
 }
 #endif
 
@@ -274,6 +371,30 @@ extern "C" {
                                       const af_storage destStorage);
 #endif
 
+#if AF_API_VERSION >= 38
+    /**
+       Converts a sparse or dense matrix to \ref AF_STORAGE_BSR or
+       \ref AF_STORAGE_SELL. See \ref af::sparseConvertTo for the layouts.
+
+       \param[out] out \ref af_array for the sparse array with the given
+                   storage type
+       \param[in] in is the source sparse or dense matrix
+       \param[in] destStorage is \ref AF_STORAGE_BSR or \ref AF_STORAGE_SELL
+       \param[in] blockSize is the size of the blocks or the number of rows
+                  of the slices
+       \param[in] sortWindow is the number of rows sorted by length for
+                  \ref AF_STORAGE_SELL. 1 keeps the order of the rows.
+
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup sparse_func_convert_to
+     */
+    AFAPI af_err af_sparse_convert_to_blocked(af_array *out, const af_array in,
+                                              const af_storage destStorage,
+                                              const int blockSize,
+                                              const int sortWindow);
+#endif
+
 #if AF_API_VERSION >= 34
     /**
        \param[out] out dense \ref af_array from sparse
@@ -362,6 +483,83 @@ extern "C" {
     AFAPI af_err af_sparse_get_storage(af_storage *out, const af_array in);
 #endif
 
+#if AF_API_VERSION >= 38
+    /**
+       Replaces the values of a sparse array in place and keeps its indices
+
+       \param[inout] arr is the sparse array
+       \param[in] values is the array of the new values. It has the type and
+                  the number of elements of the values of \p arr.
+
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup sparse_func_update
+     */
+    AFAPI af_err af_sparse_set_values(af_array arr, const af_array values);
+
+    /**
+       Inserts entries into a CSR array in place. The entries which are
+       already in the array are overwritten, and the last of repeated entries
+       is kept.
+
+       \param[inout] arr is the CSR array
+       \param[in] values is the array of the values of the entries
+       \param[in] rowIdx is the \ref s32 array of the rows of the entries
+       \param[in] colIdx is the \ref s32 array of the columns of the entries
+
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup sparse_func_update
+     */
+    AFAPI af_err af_sparse_insert(af_array arr, const af_array values,
+                                  const af_array rowIdx,
+                                  const af_array colIdx);
+
+    /**
+       Removes entries from a CSR array in place. The entries which are not
+       in the array are ignored.
+
+       \param[inout] arr is the CSR array
+       \param[in] rowIdx is the \ref s32 array of the rows of the entries
+       \param[in] colIdx is the \ref s32 array of the columns of the entries
+
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup sparse_func_update
+     */
+    AFAPI af_err af_sparse_remove(af_array arr, const af_array rowIdx,
+                                  const af_array colIdx);
+
+    /**
+       Computes the ILU(0) factorization of a square CSR array
+
+       \param[out] out is the CSR array with the pattern of \p in whose
+                   strictly lower triangle is L, with a unit diagonal, and
+                   whose upper triangle is U
+       \param[in] in is the square CSR array. Each row has its diagonal
+                  entry.
+
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup sparse_func_ilu0
+     */
+    AFAPI af_err af_sparse_ilu0(af_array *out, const af_array in);
+
+    /**
+       Computes the IC(0) factorization of a Hermitian positive definite CSR
+       array
+
+       \param[out] out is the CSR array whose lower triangle is L and whose
+                   upper triangle is the conjugate transpose of L
+       \param[in] in is the CSR array. Only its lower triangle is read.
+
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup sparse_func_ilu0
+     */
+    AFAPI af_err af_sparse_ic0(af_array *out, const af_array in);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
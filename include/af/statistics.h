@@ -186,6 +186,22 @@ AFAPI array cov(const array &X, const array &Y, const af_var_bias bias);
 */
 AFAPI array median(const array& in, const dim_t dim=-1);
 
+#if AF_API_VERSION >= 38
+/**
+   C++ Interface for quantile
+
+   \param[in] in is the input array
+   \param[in] q the quantile, between 0 and 1
+   \param[in] dim the dimension along which the quantile is extracted
+   \return    the quantile \p q of the input array along dimension \p dim
+
+   \ingroup stat_func_quantile
+
+   \note \p dim is -1 by default. -1 denotes the first non-singleton dimension.
+*/
+AFAPI array quantile(const array &in, const double q, const dim_t dim = -1);
+#endif
+
 /**
    C++ Interface for mean of all elements
 
@@ -290,6 +306,20 @@ template <typename T> AFAPI T stdev(const array &in, const af_var_bias bias);
 template<typename T>
 AFAPI T median(const array& in);
 
+#if AF_API_VERSION >= 38
+/**
+   C++ Interface for quantile of all elements
+
+   \param[in] in is the input array
+   \param[in] q the quantile, between 0 and 1
+   \return    the quantile \p q of the entire input array
+
+   \ingroup stat_func_quantile
+*/
+template<typename T>
+AFAPI T quantile(const array &in, const double q);
+#endif
+
 /**
    C++ Interface for correlation coefficient
 
@@ -513,6 +543,24 @@ AFAPI af_err af_cov_v2(af_array *out, const af_array X, const af_array Y,
 */
 AFAPI af_err af_median(af_array* out, const af_array in, const dim_t dim);
 
+#if AF_API_VERSION >= 38
+/**
+   C Interface for quantile
+
+   \param[out] out will contain the quantile \p q of the input array along
+               dimension \p dim
+   \param[in] in is the input array
+   \param[in] q the quantile, between 0 and 1
+   \param[in] dim the dimension along which the quantile is extracted
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_quantile
+*/
+AFAPI af_err af_quantile(af_array *out, const af_array in, const double q,
+                         const dim_t dim);
+#endif
+
 /**
    C Interface for mean of all elements
 
@@ -641,6 +689,25 @@ AFAPI af_err af_stdev_all_v2(double *real, double *imag, const af_array in,
 */
 AFAPI af_err af_median_all(double *realVal, double *imagVal, const af_array in);
 
+#if AF_API_VERSION >= 38
+/**
+   C Interface for quantile of all elements
+
+   \param[out] realVal will contain the real part of the quantile \p q of the
+               entire input array
+   \param[out] imagVal will contain the imaginary part of the quantile \p q of
+               the entire input array
+   \param[in] in is the input array
+   \param[in] q the quantile, between 0 and 1
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_quantile
+*/
+AFAPI af_err af_quantile_all(double *realVal, double *imagVal,
+                             const af_array in, const double q);
+#endif
+
 /**
    C Interface for correlation coefficient
 
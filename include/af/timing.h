@@ -9,6 +9,7 @@
 
 #pragma once
 #include <af/defines.h>
+#include <af/event.h>
 
 #ifdef __cplusplus
 
@@ -43,6 +44,75 @@ namespace af {
 } timer;
 
 AFAPI double timeit(void(*fn)());
+
+#if AF_API_VERSION >= 38
+/// Measures the time the device spends between two points of the queue
+///
+/// The points are marked with events, so the time does not include the
+/// launch overhead of the host and elapsed only waits for the end point
+/// instead of synchronizing the device.
+///
+/// \code
+/// af::deviceTimer timer;
+/// timer.start();
+/// af::array c = af::matmul(a, b);
+/// c.eval();
+/// timer.stop();
+/// double seconds = timer.elapsed();
+/// \endcode
+///
+/// On OpenCL the queue has to record timestamps, see
+/// \ref af_event_elapsed_time.
+class AFAPI deviceTimer {
+    event start_;
+    event end_;
+
+  public:
+    /// Marks the start on the active queue
+    void start();
+
+    /// Marks the end on the active queue
+    void stop();
+
+    /// Returns the seconds between the start and the end. Blocks until the
+    /// operations enqueued before the end complete.
+    double elapsed() const;
+};
+
+/// The statistics of the times of the runs of a function, in seconds
+typedef struct timeit_stats {
+    double min;     ///< The fastest run
+    double median;  ///< The median run
+    double mean;    ///< The mean of the runs
+    double p90;     ///< The 90th percentile
+    double p99;     ///< The 99th percentile
+    double max;     ///< The slowest run
+    double mad;     ///< The median absolute deviation from the median
+    int samples;    ///< The number of runs
+    bool device;    ///< True if the runs were timed by the device
+} timeit_stats;
+
+/// The options of \ref timeitStats
+typedef struct timeit_options {
+    int warmup;       ///< The untimed runs before the timed runs
+    int samples;      ///< The timed runs
+    bool flushCache;  ///< Overwrite a buffer larger than the caches of the
+                      ///< device before each run
+    bool deviceTime;  ///< Time the runs with events on the device instead of
+                      ///< the host clock
+
+    timeit_options()
+        : warmup(2), samples(20), flushCache(true), deviceTime(true) {}
+} timeit_options;
+
+/// Runs \p fn several times and returns the statistics of the times
+///
+/// Unlike \ref timeit, each run is timed separately, so the spread of the
+/// times can be judged. The results of \p fn have to be evaluated by it.
+/// If the device cannot time the runs, they are timed by the host clock.
+AFAPI timeit_stats timeitStats(
+    void (*fn)(), const timeit_options &options = timeit_options());
+#endif
 }
 
 #endif
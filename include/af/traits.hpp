@@ -175,6 +175,18 @@ struct dtype_traits<half> {
     static const char* getName() { return "half"; }
 };
 #endif
+
+#if AF_API_VERSION >= 38
+template<>
+struct dtype_traits<bfloat16> {
+    enum {
+        af_type = bf16 ,
+        ctype = bf16
+    };
+    typedef bfloat16 base_type;
+    static const char* getName() { return "bfloat16"; }
+};
+#endif
 }
 
 #endif
@@ -9,6 +9,16 @@
 
 #pragma once
 #include <af/defines.h>
+#include <af/seq.h>
+
+#if AF_API_VERSION >= 38
+/**
+   A handle to an array being saved by \ref af_save_array_async
+
+   \ingroup stream_func_save
+*/
+typedef void *af_save_handle;
+#endif
 
 #ifdef __cplusplus
 namespace af
@@ -92,6 +102,148 @@ namespace af
     AFAPI int readArrayCheck(const char *filename, const char *key);
 #endif
 
+#if AF_API_VERSION >= 38
+    /**
+        Saves an array to a file in chunks which may be compressed
+
+        The array is split along its last dimension with more than one
+        element, so each chunk holds whole slices of that dimension. The
+        arrays of the file can be read with \ref readArray, and a range of
+        an array can be read with \ref readArrayRange without reading the
+        chunks outside of the range.
+
+        \param[in] key is an expression used as tag/key for the array during \ref readArray
+        \param[in] arr is the array to be written
+        \param[in] filename is the path to the location on disk
+        \param[in] append is used to append to an existing file when true and create or
+        overwrite an existing file when false. Only files written by this function can
+        be appended to.
+        \param[in] compression is the compression of the chunks. Chunks which do not get
+        smaller are stored uncompressed.
+        \param[in] chunkBytes is the size of the chunks before compression. 0 uses chunks
+        of 4 MB.
+
+        \returns index of the saved array in the file
+
+        \ingroup stream_func_save
+    */
+    AFAPI int saveArrayChunked(const char *key, const array &arr,
+                               const char *filename, const bool append = false,
+                               const compressionType compression = AF_COMPRESSION_NONE,
+                               const dim_t chunkBytes = 0);
+#endif
+
+#if AF_API_VERSION >= 38
+    /**
+        Saves an array to a file in the background
+
+        The array is written in the format of \ref saveArray by a background
+        thread, so the caller can keep working while the file is written.
+        Later changes to \p arr do not change the saved array.
+
+        \param[in] key is an expression used as tag/key for the array during \ref readArray
+        \param[in] arr is the array to be written
+        \param[in] filename is the path to the location on disk
+        \param[in] append is used to append to an existing file when true and create or
+        overwrite an existing file when false
+
+        \returns the handle of the save. It has to be passed to \ref af::waitSave.
+
+        \ingroup stream_func_save
+    */
+    AFAPI af_save_handle saveArrayAsync(const char *key, const array &arr,
+                                        const char *filename,
+                                        const bool append = false);
+
+    /**
+        Waits for a save started by \ref af::saveArrayAsync to be written and
+        releases its handle
+
+        \returns index of the saved array in the file
+
+        \ingroup stream_func_save
+    */
+    AFAPI int waitSave(af_save_handle handle);
+#endif
+
+#if AF_API_VERSION >= 38
+    /**
+        Reads the elements of an array selected by a sequence, the same way
+        as indexing the array with a single sequence
+
+        Only the chunks of the file which hold the selected elements are read.
+
+        \param[in] filename is the path to the location on disk
+        \param[in] index is the 0-based sequential location of the array to be read
+        \param[in] s0 is the sequence of the elements
+
+        \returns the selected elements of the array
+
+        \ingroup stream_func_read
+    */
+    AFAPI array readArrayRange(const char *filename, const unsigned index,
+                               const seq &s0);
+
+    /**
+        Reads the part of an array selected by a sequence along each
+        dimension
+
+        Only the parts of the file which hold the selected range of the last
+        dimension of the array with more than one element are read. The
+        arrays saved by \ref saveArrayChunked are split along that
+        dimension.
+
+        \param[in] filename is the path to the location on disk
+        \param[in] index is the 0-based sequential location of the array to be read
+        \param[in] s0 is the sequence along the first dimension
+        \param[in] s1 is the sequence along the second dimension
+        \param[in] s2 is the sequence along the third dimension
+        \param[in] s3 is the sequence along the fourth dimension
+
+        \returns the selected part of the array
+
+        \ingroup stream_func_read
+    */
+    AFAPI array readArrayRange(const char *filename, const unsigned index,
+                               const seq &s0, const seq &s1,
+                               const seq &s2 = span, const seq &s3 = span);
+#endif
+
+#if AF_API_VERSION >= 38
+    /**
+        Reads a matrix from a Matrix Market file
+
+        Coordinate files are read to a sparse array in CSR format, and array
+        files to a dense array. See \ref af_read_mtx for how the file is read.
+
+        \param[in] filename is the path to the location on disk
+        \param[in] type is the type of the matrix, which is \ref f32,
+        \ref f64, \ref c32 or \ref c64
+
+        \returns the matrix
+
+        \ingroup stream_func_read
+    */
+    AFAPI array readMtx(const char *filename, const dtype type = f32);
+
+    /**
+        Reads a matrix of numbers from a CSV file, with one row of the matrix
+        on each line of the file
+
+        \param[in] filename is the path to the location on disk
+        \param[in] type is the type of the matrix
+        \param[in] delimiter is the character between the fields of a line
+        \param[in] skipRows is the number of lines at the beginning of the
+        file which are skipped
+
+        \returns the matrix
+
+        \ingroup stream_func_read
+    */
+    AFAPI array readCsv(const char *filename, const dtype type = f32,
+                        const char delimiter = ',', const unsigned skipRows = 0);
+#endif
+
 #if AF_API_VERSION >= 31
     /**
         \param[out] output is the pointer to the c-string that will hold the data. The memory for
@@ -203,6 +355,12 @@ extern "C" {
 
         \note This function will throw an exception if the key is not found.
 
+        \note The file is memory mapped and the positions of its arrays are
+        kept until the file changes, so reading arrays by key or index does
+        not scan the file. In the CPU backend the array uses the mapped data
+        directly when it is aligned, so the file must not be truncated by
+        other processes while the array is in use.
+
         \ingroup stream_func_read
     */
     AFAPI af_err af_read_array_index(af_array *out, const char *filename, const unsigned index);
@@ -216,6 +374,8 @@ extern "C" {
 
         \note This function will throw an exception if the key is not found.
 
+        \note See \ref af_read_array_index for how the file is read.
+
         \ingroup stream_func_read
     */
     AFAPI af_err af_read_array_key(af_array *out, const char *filename, const char* key);
@@ -235,6 +395,160 @@ extern "C" {
     AFAPI af_err af_read_array_key_check(int *index, const char *filename, const char* key);
 #endif
 
+#if AF_API_VERSION >= 38
+    /**
+        Saves an array to a file in chunks which may be compressed
+
+        \param[out] index is the index location of the array in the file
+        \param[in] key is an expression used as tag/key for the array during \ref readArray()
+        \param[in] arr is the array to be written
+        \param[in] filename is the path to the location on disk
+        \param[in] append is used to append to an existing file when true and create or
+        overwrite an existing file when false. Only files written by this function can
+        be appended to.
+        \param[in] compression is the compression of the chunks. Chunks which do not get
+        smaller are stored uncompressed.
+        \param[in] chunk_bytes is the size of the chunks before compression. 0 uses chunks
+        of 4 MB.
+
+        \note The array is split along its last dimension with more than one element.
+        \ref af_read_array_range only reads the chunks which hold the range it selects
+        along that dimension.
+
+        \note LZ4 and zstd are loaded when they are first used. An error is returned if
+        ArrayFire was built without them or if they fail to load.
+
+        \ingroup stream_func_save
+    */
+    AFAPI af_err af_save_array_chunked(int *index, const char* key, const af_array arr,
+                                       const char *filename, const bool append,
+                                       const af_compression_type compression,
+                                       const dim_t chunk_bytes);
+#endif
+
+#if AF_API_VERSION >= 38
+    /**
+        Saves an array to a file in the background
+
+        A snapshot of the array is taken when this function is called. It
+        shares the memory of \p arr, which is copied by the next write to
+        \p arr, so the saved values do not change. A background thread copies
+        the array to pinned host buffers in chunks and writes each chunk while
+        the device copies the next one. The saves are written one at a time
+        in the order they were made, so consecutive saves can append to the
+        same file.
+
+        \param[out] handle is the handle of the save. It has to be released
+        with \ref af_release_save.
+        \param[in] key is an expression used as tag/key for the array during \ref readArray()
+        \param[in] arr is the array to be written
+        \param[in] filename is the path to the location on disk
+        \param[in] append is used to append to an existing file when true and create or
+        overwrite an existing file when false
+
+        \note The file has the format of \ref af_save_array.
+
+        \ingroup stream_func_save
+    */
+    AFAPI af_err af_save_array_async(af_save_handle *handle, const char *key,
+                                     const af_array arr, const char *filename,
+                                     const bool append);
+
+    /**
+        Waits for a save started by \ref af_save_array_async to be written
+
+        \param[out] index is the index location of the array in the file. Can
+        be NULL.
+        \param[in] handle is the handle returned by \ref af_save_array_async
+
+        \returns the error of the save if it failed. A save can only be
+        waited for once.
+
+        \ingroup stream_func_save
+    */
+    AFAPI af_err af_wait_save(int *index, const af_save_handle handle);
+
+    /**
+        Releases a handle returned by \ref af_save_array_async
+
+        Waits for the save to be written if it was not waited for.
+
+        \param[in] handle is the handle to release
+
+        \ingroup stream_func_save
+    */
+    AFAPI af_err af_release_save(af_save_handle handle);
+#endif
+
+#if AF_API_VERSION >= 38
+    /**
+        Reads the part of an array selected by sequences, the same way as
+        \ref af_index
+
+        \param[out] out is the part of the array which is selected
+        \param[in] filename is the path to the location on disk
+        \param[in] index is the 0-based sequential location of the array to be read
+        \param[in] ndims is the number of sequences in \p indices. A single sequence
+        selects the elements of the array in order.
+        \param[in] indices is the sequence along each dimension
+
+        \note Only the range selected along the last dimension of the array with more
+        than one element, or the range of the elements for a single sequence, is read
+        from the file. The other dimensions are indexed after the range is read.
+
+        \ingroup stream_func_read
+    */
+    AFAPI af_err af_read_array_range(af_array *out, const char *filename,
+                                     const unsigned index, const unsigned ndims,
+                                     const af_seq *const indices);
+#endif
+
+#if AF_API_VERSION >= 38
+    /**
+        Reads a matrix from a Matrix Market file
+
+        \param[out] out is the matrix. Coordinate files are read to a sparse array in
+        CSR format, and array files to a dense array.
+        \param[in] filename is the path to the location on disk
+        \param[in] type is the type of the matrix. It can be \ref f32, \ref f64,
+        \ref c32 or \ref c64. Complex files can only be read to complex types.
+
+        \note The file is memory mapped and parsed by several threads, which
+        write the values and the indices directly to pinned host buffers. The
+        entries of symmetric, skew-symmetric and hermitian files are mirrored,
+        the values of pattern files are one, and the columns of each row are
+        sorted.
+
+        \ingroup stream_func_read
+    */
+    AFAPI af_err af_read_mtx(af_array *out, const char *filename,
+                             const af_dtype type);
+
+    /**
+        Reads a matrix of numbers from a CSV file
+
+        Each line of the file is a row of the matrix, and all the rows must
+        have the same number of fields. Blank lines are skipped.
+
+        \param[out] out is the matrix
+        \param[in] filename is the path to the location on disk
+        \param[in] type is the type of the matrix. It can be a real floating
+        point type or an integer type other than \ref b8.
+        \param[in] delimiter is the character between the fields of a line
+        \param[in] skip_rows is the number of lines at the beginning of the file,
+        like a header, which are skipped
+
+        \note Empty fields are NaN for floating point types and zero for
+        integer types. The file is parsed by several threads as in
+        \ref af_read_mtx.
+
+        \ingroup stream_func_read
+    */
+    AFAPI af_err af_read_csv(af_array *out, const char *filename,
+                             const af_dtype type, const char delimiter,
+                             const unsigned skip_rows);
+#endif
+
 #if AF_API_VERSION >= 31
     /**
         \param[out] output is the pointer to the c-string that will hold the data. The memory for
@@ -102,6 +102,36 @@ AFAPI void orb(features& feat, array& desc, const array& image,
                const float scl_fctr=1.5f, const unsigned levels=4,
                const bool blur_img=false);
 
+#if AF_API_VERSION >= 38
+/**
+    C++ Interface for ORB feature descriptor of a stack of images
+
+    \param[out] feat features object composed of max_feat x K arrays for x
+                and y coordinates, score, orientation and size of the
+                features of each of the K images
+    \param[out] desc 8 x max_feat x K array of the descriptors of the
+                features of each image
+    \param[out] counts \ref u32 array of the number of features found in
+                each image. The features past it are zero.
+    \param[in]  images W x H x K array of grayscale images
+    \param[in]  fast_thr FAST threshold
+    \param[in]  max_feat maximum number of features to hold for each image
+    \param[in]  scl_fctr factor to downsample the images at each level
+    \param[in]  levels number of levels to be computed for the image pyramid
+    \param[in]  blur_img blur images with a Gaussian filter with sigma=2
+                before computing descriptors if true
+
+    \note The descriptors of all the images can be matched at once with
+          \ref hammingMatcher by reshaping \p desc to 8 x (max_feat * K)
+
+    \ingroup cv_func_orb
+ */
+AFAPI void orbBatch(features& feat, array& desc, array& counts,
+                    const array& images, const float fast_thr=20.f,
+                    const unsigned max_feat=400, const float scl_fctr=1.5f,
+                    const unsigned levels=4, const bool blur_img=false);
+#endif
+
 #if AF_API_VERSION >= 31
 /**
     C++ Interface for SIFT feature detector and descriptor
@@ -337,6 +367,36 @@ AFAPI void homography(array& H, int& inliers, const array& x_src, const array& y
                       const float inlier_thr=3.f, const unsigned iterations=1000, const dtype otype=f32);
 #endif
 
+#if AF_API_VERSION >= 38
+/**
+   C++ Interface for Homography estimation of a batch of correspondence sets
+
+   \param[out] H is a 3x3xK array containing the homography of each set
+   \param[out] inliers is a \ref s32 array of the number of inliers of each
+               homography
+   \param[in]  x_src x coordinates of the source points, one set per column
+   \param[in]  y_src y coordinates of the source points, one set per column
+   \param[in]  x_dst x coordinates of the destination points, one set per
+               column
+   \param[in]  y_dst y coordinates of the destination points, one set per
+               column
+   \param[in]  htype the method to evaluate the homography quality
+   \param[in]  inlier_thr the maximum L2-distance for a point to be
+               considered an inlier when htype is AF_HOMOGRAPHY_RANSAC
+   \param[in]  iterations the maximum number of iterations for each set
+   \param[in]  otype the array type for the homography output.
+
+   \ingroup cv_func_homography
+*/
+AFAPI void homographyBatch(array& H, array& inliers, const array& x_src,
+                           const array& y_src, const array& x_dst,
+                           const array& y_dst,
+                           const af_homography_type htype=AF_HOMOGRAPHY_RANSAC,
+                           const float inlier_thr=3.f,
+                           const unsigned iterations=1000,
+                           const dtype otype=f32);
+#endif
+
 }
 #endif
 
@@ -430,6 +490,39 @@ extern "C" {
                         const float fast_thr, const unsigned max_feat, const float scl_fctr,
                         const unsigned levels, const bool blur_img);
 
+#if AF_API_VERSION >= 38
+    /**
+        C Interface for ORB feature descriptor of a stack of images
+
+        The features of each image are kept in a fixed number of slots, so
+        that the outputs of all the images are in the same arrays and can be
+        passed on to the matchers without reading the counts back.
+
+        \param[out] feat af_features struct composed of max_feat x K arrays
+                    for x and y coordinates, score, orientation and size of
+                    the features of each of the K images
+        \param[out] desc 8 x max_feat x K array of the descriptors of the
+                    features of each image
+        \param[out] counts \ref u32 array of the number of features found in
+                    each image. The features past it are zero.
+        \param[in]  in W x H x K array of grayscale images
+        \param[in]  fast_thr FAST threshold
+        \param[in]  max_feat maximum number of features to hold for each image
+        \param[in]  scl_fctr factor to downsample the images at each level
+        \param[in]  levels number of levels to be computed for the image
+                    pyramid
+        \param[in]  blur_img blur images with a Gaussian filter with sigma=2
+                    before computing descriptors if true
+
+        \ingroup cv_func_orb
+    */
+    AFAPI af_err af_orb_batch(af_features *feat, af_array *desc,
+                              af_array *counts, const af_array in,
+                              const float fast_thr, const unsigned max_feat,
+                              const float scl_fctr, const unsigned levels,
+                              const bool blur_img);
+#endif
+
 #if AF_API_VERSION >= 31
     /**
         C++ Interface for SIFT feature detector and descriptor
@@ -669,6 +762,45 @@ AFAPI af_err af_nearest_neighbour(af_array* idx, af_array* dist,
                                const unsigned iterations, const af_dtype otype);
 #endif
 
+#if AF_API_VERSION >= 38
+    /**
+       C Interface wrapper for Homography estimation of a batch of
+       correspondence sets
+
+       Each column of the coordinates is a set of correspondences, whose
+       homography is estimated as by \ref af_homography. The random samples
+       are drawn once for the whole batch.
+
+       \param[out] H is a 3x3xK array containing the homography of each set
+       \param[out] inliers is a \ref s32 array of the number of inliers of
+                   each homography
+       \param[in]  x_src x coordinates of the source points, one set per
+                   column
+       \param[in]  y_src y coordinates of the source points, one set per
+                   column
+       \param[in]  x_dst x coordinates of the destination points, one set
+                   per column
+       \param[in]  y_dst y coordinates of the destination points, one set
+                   per column
+       \param[in]  htype the method to evaluate the homography quality
+       \param[in]  inlier_thr the maximum L2-distance for a point to be
+                   considered an inlier when htype is AF_HOMOGRAPHY_RANSAC
+       \param[in]  iterations the maximum number of iterations for each set
+       \param[in]  otype the array type for the homography output.
+
+       \ingroup cv_func_homography
+    */
+    AFAPI af_err af_homography_batch(af_array *H, af_array *inliers,
+                                     const af_array x_src,
+                                     const af_array y_src,
+                                     const af_array x_dst,
+                                     const af_array y_dst,
+                                     const af_homography_type htype,
+                                     const float inlier_thr,
+                                     const unsigned iterations,
+                                     const af_dtype otype);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -40,6 +40,9 @@
       @defgroup c_api_mat C API to manage arrays
       Create, release, copy, fetch-properties of \ref af_array
 
+      @defgroup sharded_mat Arrays sharded across devices
+      shardedArray, scatter, gather, allReduce
+
       @defgroup index_mat Assignment & Indexing operation on arrays
       Access sub regions of an array object
 
@@ -163,6 +166,9 @@
 
       \defgroup event_api Event API
       \brief af_create_event, af_mark_event, etc.
+
+      \defgroup graph_api Graph API
+      \brief af_begin_capture, af_end_capture, af_replay_graph, etc.
    @}
 
    @defgroup linalg_mat Linear Algebra
@@ -357,6 +363,10 @@
         kernels and do custom memory operations using native CUDA commands. The functions
         contained in the \p afcu namespace provide methods to get the stream and native
         device id that ArrayFire is using.
+
+     @defgroup cpu_mat CPU specific functions
+
+        \brief Configuring the queue of ArrayFire's CPU backend.
    @}
 
    @defgroup ml Machine Learning
@@ -386,6 +396,7 @@
 #include "af/exception.h"
 #include "af/features.h"
 #include "af/gfor.h"
+#include "af/graph.h"
 #include "af/graphics.h"
 #include "af/half.h"
 #include "af/image.h"
@@ -395,6 +406,7 @@
 #include "af/ml.h"
 #include "af/random.h"
 #include "af/seq.h"
+#include "af/sharded.h"
 #include "af/signal.h"
 #include "af/sparse.h"
 #include "af/statistics.h"
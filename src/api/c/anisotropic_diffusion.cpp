@@ -9,49 +9,29 @@
 
 #include <anisotropic_diffusion.hpp>
 
-#include <arith.hpp>
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <cast.hpp>
 #include <common/err_common.hpp>
 #include <copy.hpp>
-#include <gradient.hpp>
 #include <handle.hpp>
-#include <reduce.hpp>
 
 #include <af/dim4.hpp>
 #include <af/image.h>
 
 #include <type_traits>
 
-using af::dim4;
-using detail::arithOp;
 using detail::Array;
 using detail::cast;
-using detail::createEmptyArray;
-using detail::gradient;
-using detail::reduce_all;
 
 template<typename T>
 af_array diffusion(const Array<float>& in, const float dt, const float K,
                    const unsigned iterations, const af_flux_function fftype,
                    const af::diffusionEq eq) {
-    auto out  = copyArray(in);
-    auto dims = out.dims();
-    auto g0   = createEmptyArray<float>(dims);
-    auto g1   = createEmptyArray<float>(dims);
-    float cnst =
-        -2.0f * K * K / dims.elements();  // NOLINT(readability-magic-numbers)
-
-    for (unsigned i = 0; i < iterations; ++i) {
-        gradient<float>(g0, g1, out);
-
-        auto g0Sqr = arithOp<float, af_mul_t>(g0, g0, dims);
-        auto g1Sqr = arithOp<float, af_mul_t>(g1, g1, dims);
-        auto sumd  = arithOp<float, af_add_t>(g0Sqr, g1Sqr, dims);
-        float avg  = reduce_all<af_add_t, float, float>(sumd, true, 0);
-
-        anisotropicDiffusion(out, dt, 1.0f / (cnst * avg), fftype, eq);
-    }
+    // The backends run all the timesteps, each of them scaled by the
+    // gradient energy of its input, without reading the energy back
+    auto out = copyArray(in);
+    anisotropicDiffusion(out, dt, K, iterations, fftype, eq);
 
     return getHandle(cast<T, float>(out));
 }
@@ -61,6 +41,7 @@ af_err af_anisotropic_diffusion(af_array* out, const af_array in,
                                 const unsigned iterations,
                                 const af_flux_function fftype,
                                 const af_diffusion_eq eq) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& info = getInfo(in);
 
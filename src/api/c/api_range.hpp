@@ -0,0 +1,117 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+/// Ranges which mark the API calls in the timelines of external profilers.
+/// The CUDA backend pushes NVTX ranges, shown by Nsight Systems, and the CPU
+/// and OpenCL backends begin ITT tasks, shown by VTune. The ranges are only
+/// compiled in when ArrayFire is built with AF_WITH_API_RANGES, otherwise
+/// the macros below expand to nothing.
+#pragma once
+
+#if defined(AF_WITH_NVTX) || defined(AF_WITH_ITT)
+
+#include <common/ArrayInfo.hpp>
+#include <handle.hpp>
+#include <type_util.hpp>
+#include <af/defines.h>
+
+#if defined(AF_WITH_NVTX)
+#include <nvtx3/nvToolsExt.h>
+#else
+#include <ittnotify.h>
+#endif
+
+#include <string>
+
+/// Marks the lifetime of the object as a range named after an API function.
+/// The range of a function with an input array is annotated with the
+/// dimensions and type of the array.
+class ApiRange {
+   public:
+    explicit ApiRange(const char *function) { begin(function, nullptr); }
+
+    ApiRange(const char *function, const af_array in) {
+        if (in == 0) {
+            begin(function, nullptr);
+            return;
+        }
+        // Does not check the handle, so the range never throws
+        const ArrayInfo &info = getInfo(in, false, false);
+        const af::dim4 &dims  = info.dims();
+        std::string array     = "[";
+        for (int i = 0; i < 4; ++i) {
+            array += std::to_string(dims[i]);
+            array += (i < 3 ? " " : "] ");
+        }
+        array += getName(info.getType());
+        begin(function, &array);
+    }
+
+    ~ApiRange() {
+#if defined(AF_WITH_NVTX)
+        nvtxDomainRangePop(getDomain());
+#else
+        __itt_task_end(getDomain());
+#endif
+    }
+
+    ApiRange(const ApiRange &)            = delete;
+    ApiRange &operator=(const ApiRange &) = delete;
+
+   private:
+#if defined(AF_WITH_NVTX)
+    static nvtxDomainHandle_t getDomain() {
+        static nvtxDomainHandle_t domain = nvtxDomainCreateA("ArrayFire");
+        return domain;
+    }
+
+    static void begin(const char *function, const std::string *array) {
+        // NVTX ranges only carry a message, so the array is appended to it
+        std::string message(function);
+        if (array) { message += " " + *array; }
+
+        nvtxEventAttributes_t attributes = {};
+        attributes.version               = NVTX_VERSION;
+        attributes.size                  = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
+        attributes.messageType           = NVTX_MESSAGE_TYPE_ASCII;
+        attributes.message.ascii         = message.c_str();
+        nvtxDomainRangePushEx(getDomain(), &attributes);
+    }
+#else
+    static __itt_domain *getDomain() {
+        static __itt_domain *domain = __itt_domain_create("ArrayFire");
+        return domain;
+    }
+
+    static void begin(const char *function, const std::string *array) {
+        __itt_task_begin(getDomain(), __itt_null, __itt_null,
+                         __itt_string_handle_create(function));
+        if (array) {
+            static __itt_string_handle *key =
+                __itt_string_handle_create("array");
+            __itt_metadata_str_add(getDomain(), __itt_null, key,
+                                   array->c_str(), array->size());
+        }
+    }
+#endif
+};
+
+/// Marks the rest of the enclosing API function as a range
+#define AF_API_RANGE() ApiRange apiRange_(__func__)
+
+/// Marks the rest of the enclosing API function as a range annotated with
+/// the dimensions and type of the array \p in
+#define AF_API_RANGE_ARRAY(in) ApiRange apiRange_(__func__, in)
+
+#else
+
+#define AF_API_RANGE()
+#define AF_API_RANGE_ARRAY(in)
+
+#endif
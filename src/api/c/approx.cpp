@@ -9,6 +9,7 @@
 
 #include <approx.hpp>
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -117,6 +118,7 @@ af_err af_approx1_uniform(af_array *yo, const af_array yi, const af_array xo,
                           const int xdim, const double xi_beg,
                           const double xi_step, const af_interp_type method,
                           const float offGrid) {
+    AF_API_RANGE_ARRAY(yi);
     try {
         af_approx1_common(yo, yi, xo, xdim, xi_beg, xi_step, method, offGrid,
                           true);
@@ -130,6 +132,7 @@ af_err af_approx1_uniform_v2(af_array *yo, const af_array yi, const af_array xo,
                              const int xdim, const double xi_beg,
                              const double xi_step, const af_interp_type method,
                              const float offGrid) {
+    AF_API_RANGE_ARRAY(yi);
     try {
         ARG_ASSERT(0, yo != 0);  // need to dereference yo in next call
         af_approx1_common(yo, yi, xo, xdim, xi_beg, xi_step, method, offGrid,
@@ -142,6 +145,7 @@ af_err af_approx1_uniform_v2(af_array *yo, const af_array yi, const af_array xo,
 
 af_err af_approx1(af_array *yo, const af_array yi, const af_array xo,
                   const af_interp_type method, const float offGrid) {
+    AF_API_RANGE_ARRAY(yi);
     try {
         af_approx1_common(yo, yi, xo, 0, 0.0, 1.0, method, offGrid, true);
     }
@@ -152,6 +156,7 @@ af_err af_approx1(af_array *yo, const af_array yi, const af_array xo,
 
 af_err af_approx1_v2(af_array *yo, const af_array yi, const af_array xo,
                      const af_interp_type method, const float offGrid) {
+    AF_API_RANGE_ARRAY(yi);
     try {
         ARG_ASSERT(0, yo != 0);  // need to dereference yo in next call
         af_approx1_common(yo, yi, xo, 0, 0.0, 1.0, method, offGrid, *yo == 0);
@@ -245,6 +250,7 @@ af_err af_approx2_uniform(af_array *zo, const af_array zi, const af_array xo,
                           const int ydim, const double yi_beg,
                           const double yi_step, const af_interp_type method,
                           const float offGrid) {
+    AF_API_RANGE_ARRAY(zi);
     try {
         af_approx2_common(zo, zi, xo, xdim, xi_beg, xi_step, yo, ydim, yi_beg,
                           yi_step, method, offGrid, true);
@@ -260,6 +266,7 @@ af_err af_approx2_uniform_v2(af_array *zo, const af_array zi, const af_array xo,
                              const int ydim, const double yi_beg,
                              const double yi_step, const af_interp_type method,
                              const float offGrid) {
+    AF_API_RANGE_ARRAY(zi);
     try {
         ARG_ASSERT(0, zo != 0);  // need to dereference zo in next call
         af_approx2_common(zo, zi, xo, xdim, xi_beg, xi_step, yo, ydim, yi_beg,
@@ -273,6 +280,7 @@ af_err af_approx2_uniform_v2(af_array *zo, const af_array zi, const af_array xo,
 af_err af_approx2(af_array *zo, const af_array zi, const af_array xo,
                   const af_array yo, const af_interp_type method,
                   const float offGrid) {
+    AF_API_RANGE_ARRAY(zi);
     try {
         af_approx2_common(zo, zi, xo, 0, 0.0, 1.0, yo, 1, 0.0, 1.0, method,
                           offGrid, true);
@@ -285,6 +293,7 @@ af_err af_approx2(af_array *zo, const af_array zi, const af_array xo,
 af_err af_approx2_v2(af_array *zo, const af_array zi, const af_array xo,
                      const af_array yo, const af_interp_type method,
                      const float offGrid) {
+    AF_API_RANGE_ARRAY(zi);
     try {
         ARG_ASSERT(0, zo != 0);  // need to dereference zo in next call
         af_approx2_common(zo, zi, xo, 0, 0.0, 1.0, yo, 1, 0.0, 1.0, method,
@@ -6,8 +6,10 @@
  * The complete license agreement can be obtained at:
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/bfloat16.hpp>
 #include <common/half.hpp>
 #include <copy.hpp>
 #include <handle.hpp>
@@ -16,7 +18,12 @@
 #include <sparse_handle.hpp>
 #include <af/sparse.h>
 
+#include <cstdint>
+#include <memory>
+#include <utility>
+
 using af::dim4;
+using common::bfloat16;
 using common::half;
 using common::SparseArrayBase;
 using detail::cdouble;
@@ -43,6 +50,7 @@ af_array createHandle(const dim4 &d, af_dtype dtype) {
         case s16: return createHandle<short  >(d);
         case u16: return createHandle<ushort >(d);
         case f16: return createHandle<half   >(d);
+        case bf16: return createHandle<bfloat16>(d);
         default: TYPE_ERROR(3, dtype);
     }
     // clang-format on
@@ -64,12 +72,14 @@ af_array createHandleFromValue(const dim4 &d, double val, af_dtype dtype) {
         case s16: return createHandleFromValue<short  >(d, val);
         case u16: return createHandleFromValue<ushort >(d, val);
         case f16: return createHandleFromValue<half   >(d, val);
+        case bf16: return createHandleFromValue<bfloat16>(d, val);
         default: TYPE_ERROR(3, dtype);
     }
     // clang-format on
 }
 
 af_err af_get_data_ptr(void *data, const af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         af_dtype type = getInfo(arr).getType();
         // clang-format off
@@ -87,6 +97,7 @@ af_err af_get_data_ptr(void *data, const af_array arr) {
             case s16: copyData(static_cast<short*   >(data), arr); break;
             case u16: copyData(static_cast<ushort*  >(data), arr); break;
             case f16: copyData(static_cast<half*    >(data), arr); break;
+            case bf16: copyData(static_cast<bfloat16*>(data), arr); break;
             default: TYPE_ERROR(1, type);
         }
         // clang-format on
@@ -99,6 +110,7 @@ af_err af_get_data_ptr(void *data, const af_array arr) {
 af_err af_create_array(af_array *result, const void *const data,
                        const unsigned ndims, const dim_t *const dims,
                        const af_dtype type) {
+    AF_API_RANGE();
     try {
         af_array out;
         AF_CHECK(af_init());
@@ -149,6 +161,10 @@ af_err af_create_array(af_array *result, const void *const data,
             case f16:
                 out = createHandleFromData(d, static_cast<const half *>(data));
                 break;
+            case bf16:
+                out = createHandleFromData(d,
+                                           static_cast<const bfloat16 *>(data));
+                break;
             default: TYPE_ERROR(4, type);
         }
         std::swap(*result, out);
@@ -157,9 +173,69 @@ af_err af_create_array(af_array *result, const void *const data,
     return AF_SUCCESS;
 }
 
+namespace {
+
+/// Creates an array which takes the ownership of the host memory \p data
+template<typename T>
+af_array adoptHostData(const dim4 &d, void *data, af_host_deleter deleter,
+                       void *user_data) {
+    auto release = [deleter, user_data](T *ptr) {
+        if (deleter) { deleter(ptr, user_data); }
+    };
+#if defined(AF_CPU)
+    // The array uses the memory as its buffer
+    ARG_ASSERT(1, reinterpret_cast<uintptr_t>(data) % alignof(T) == 0);
+    std::shared_ptr<T> buffer(static_cast<T *>(data), release);
+    return getHandle(detail::createSharedDataArray<T>(d, std::move(buffer)));
+#else
+    // The memory is released once it is copied to the device
+    std::unique_ptr<T, decltype(release)> owner(static_cast<T *>(data),
+                                                release);
+    return getHandle(detail::createHostDataArray<T>(d, owner.get()));
+#endif
+}
+
+}  // namespace
+
+af_err af_adopt_host_array(af_array *arr, void *data, const unsigned ndims,
+                           const dim_t *const dims, const af_dtype type,
+                           af_host_deleter deleter, void *user_data) {
+    AF_API_RANGE();
+    try {
+        AF_CHECK(af_init());
+        const dim4 d = verifyDims(ndims, dims);
+        if (d.elements() > 0) { ARG_ASSERT(1, data != nullptr); }
+
+        af_array out;
+        // clang-format off
+        switch (type) {
+            case f32: out = adoptHostData<float   >(d, data, deleter, user_data); break;
+            case c32: out = adoptHostData<cfloat  >(d, data, deleter, user_data); break;
+            case f64: out = adoptHostData<double  >(d, data, deleter, user_data); break;
+            case c64: out = adoptHostData<cdouble >(d, data, deleter, user_data); break;
+            case b8:  out = adoptHostData<char    >(d, data, deleter, user_data); break;
+            case s32: out = adoptHostData<int     >(d, data, deleter, user_data); break;
+            case u32: out = adoptHostData<uint    >(d, data, deleter, user_data); break;
+            case u8:  out = adoptHostData<uchar   >(d, data, deleter, user_data); break;
+            case s64: out = adoptHostData<intl    >(d, data, deleter, user_data); break;
+            case u64: out = adoptHostData<uintl   >(d, data, deleter, user_data); break;
+            case s16: out = adoptHostData<short   >(d, data, deleter, user_data); break;
+            case u16: out = adoptHostData<ushort  >(d, data, deleter, user_data); break;
+            case f16: out = adoptHostData<half    >(d, data, deleter, user_data); break;
+            case bf16: out = adoptHostData<bfloat16>(d, data, deleter, user_data); break;
+            default: TYPE_ERROR(4, type);
+        }
+        // clang-format on
+        std::swap(*arr, out);
+    }
+    CATCHALL
+    return AF_SUCCESS;
+}
+
 // Strong Exception Guarantee
 af_err af_create_handle(af_array *result, const unsigned ndims,
                         const dim_t *const dims, const af_dtype type) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
 
@@ -177,6 +253,7 @@ af_err af_create_handle(af_array *result, const unsigned ndims,
 
 // Strong Exception Guarantee
 af_err af_copy_array(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in, false);
         const af_dtype type   = info.getType();
@@ -215,6 +292,7 @@ af_err af_copy_array(af_array *out, const af_array in) {
                 case s16: res = copyArray<short>(in); break;
                 case u16: res = copyArray<ushort>(in); break;
                 case f16: res = copyArray<half>(in); break;
+                case bf16: res = copyArray<bfloat16>(in); break;
                 default: TYPE_ERROR(1, type);
             }
         }
@@ -226,6 +304,7 @@ af_err af_copy_array(af_array *out, const af_array in) {
 
 // Strong Exception Guarantee
 af_err af_get_data_ref_count(int *use_count, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in, false, false);
         const af_dtype type   = info.getType();
@@ -245,6 +324,7 @@ af_err af_get_data_ref_count(int *use_count, const af_array in) {
             case s16: res = getArray<short>(in).useCount(); break;
             case u16: res = getArray<ushort>(in).useCount(); break;
             case f16: res = getArray<half>(in).useCount(); break;
+            case bf16: res = getArray<bfloat16>(in).useCount(); break;
             default: TYPE_ERROR(1, type);
         }
         std::swap(*use_count, res);
@@ -254,6 +334,7 @@ af_err af_get_data_ref_count(int *use_count, const af_array in) {
 }
 
 af_err af_release_array(af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         if (arr == 0) { return AF_SUCCESS; }
         const ArrayInfo &info = getInfo(arr, false, false);
@@ -282,6 +363,7 @@ af_err af_release_array(af_array arr) {
                 case s16: releaseHandle<short>(arr); break;
                 case u16: releaseHandle<ushort>(arr); break;
                 case f16: releaseHandle<half>(arr); break;
+                case bf16: releaseHandle<bfloat16>(arr); break;
                 default: TYPE_ERROR(0, type);
             }
         }
@@ -318,12 +400,14 @@ af_array retain(const af_array in) {
             case s16: return retainHandle<short>(in);
             case u16: return retainHandle<ushort>(in);
             case f16: return retainHandle<half>(in);
+            case bf16: return retainHandle<bfloat16>(in);
             default: TYPE_ERROR(1, ty);
         }
     }
 }
 
 af_err af_retain_array(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         *out = retain(in);
     }
@@ -343,6 +427,7 @@ void write_array(af_array arr, const T *const data, const size_t bytes,
 
 af_err af_write_array(af_array arr, const void *data, const size_t bytes,
                       af_source src) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         af_dtype type = getInfo(arr).getType();
         // DIM_ASSERT(2, bytes <= getInfo(arr).bytes());
@@ -388,6 +473,10 @@ af_err af_write_array(af_array arr, const void *data, const size_t bytes,
             case f16:
                 write_array(arr, static_cast<const half *>(data), bytes, src);
                 break;
+            case bf16:
+                write_array(arr, static_cast<const bfloat16 *>(data), bytes,
+                            src);
+                break;
             default: TYPE_ERROR(4, type);
         }
     }
@@ -396,6 +485,7 @@ af_err af_write_array(af_array arr, const void *data, const size_t bytes,
 }
 
 af_err af_get_elements(dim_t *elems, const af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         // Do not check for device mismatch
         *elems = getInfo(arr, false, false).elements();
@@ -405,6 +495,7 @@ af_err af_get_elements(dim_t *elems, const af_array arr) {
 }
 
 af_err af_get_type(af_dtype *type, const af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         // Do not check for device mismatch
         *type = getInfo(arr, false, false).getType();
@@ -415,6 +506,7 @@ af_err af_get_type(af_dtype *type, const af_array arr) {
 
 af_err af_get_dims(dim_t *d0, dim_t *d1, dim_t *d2, dim_t *d3,
                    const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         // Do not check for device mismatch
         const ArrayInfo &info = getInfo(in, false, false);
@@ -428,6 +520,7 @@ af_err af_get_dims(dim_t *d0, dim_t *d1, dim_t *d2, dim_t *d3,
 }
 
 af_err af_get_numdims(unsigned *nd, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         // Do not check for device mismatch
         const ArrayInfo &info = getInfo(in, false, false);
@@ -440,6 +533,7 @@ af_err af_get_numdims(unsigned *nd, const af_array in) {
 #undef INSTANTIATE
 #define INSTANTIATE(fn1, fn2)                                  \
     af_err fn1(bool *result, const af_array in) {              \
+        AF_API_RANGE_ARRAY(in);                                \
         try {                                                  \
             const ArrayInfo &info = getInfo(in, false, false); \
             *result               = info.fn2();                \
@@ -472,6 +566,7 @@ inline void getScalar(T *out, const af_array &arr) {
 }
 
 af_err af_get_scalar(void *output_value, const af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         ARG_ASSERT(0, (output_value != NULL));
 
@@ -522,6 +617,9 @@ af_err af_get_scalar(void *output_value, const af_array arr) {
             case f16:
                 getScalar<half>(static_cast<half *>(output_value), arr);
                 break;
+            case bf16:
+                getScalar<bfloat16>(static_cast<bfloat16 *>(output_value), arr);
+                break;
             default: TYPE_ERROR(4, type);
         }
     }
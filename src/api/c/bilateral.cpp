@@ -7,23 +7,54 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
+#include <arith.hpp>
 #include <backend.hpp>
 #include <bilateral.hpp>
+#include <cast.hpp>
+#include <common/SparseArray.hpp>
 #include <common/err_common.hpp>
+#include <copy.hpp>
+#include <fftconvolve.hpp>
 #include <handle.hpp>
+#include <join.hpp>
+#include <range.hpp>
+#include <reduce.hpp>
+#include <sparse_blas.hpp>
+#include <unary.hpp>
 #include <af/defines.h>
 #include <af/dim4.hpp>
 #include <af/image.h>
 
+#include <climits>
+#include <cmath>
 #include <type_traits>
+#include <vector>
 
 using af::dim4;
+using common::createArrayDataSparseArray;
+using common::SparseArray;
+using detail::arithOp;
+using detail::Array;
 using detail::bilateral;
+using detail::cast;
+using detail::copyArray;
+using detail::createHostDataArray;
+using detail::createSubArray;
+using detail::createValueArray;
+using detail::fftconvolve;
+using detail::join;
+using detail::matmul;
+using detail::range;
+using detail::reduce_all;
+using detail::scalar;
 using detail::uchar;
 using detail::uint;
+using detail::unaryOp;
 using detail::ushort;
 using std::conditional;
 using std::is_same;
+using std::vector;
 
 template<typename T>
 inline af_array bilateral(const af_array &in, const float &sp_sig,
@@ -33,8 +64,162 @@ inline af_array bilateral(const af_array &in, const float &sp_sig,
     return getHandle(bilateral<T, OutType>(getArray<T>(in), sp_sig, chr_sig));
 }
 
+template<af_op_t op, typename T>
+static Array<T> arithScalar(const Array<T> &lhs, const T rhs) {
+    return arithOp<T, op>(lhs, createValueArray(lhs.dims(), rhs), lhs.dims());
+}
+
+/// Filters each image of \p in with a bilateral grid whose cells span
+/// \p sampling times the sigmas.
+///
+/// The pixels are splatted into the grid with trilinear weights, the grid
+/// of the sums of the values and of the weights is blurred with a Gaussian
+/// of one sigma along each of its dimensions, and the pixels are sliced back
+/// out of it with the same weights. The splatting and slicing are products
+/// with a sparse matrix of the weights, and the blur uses the FFT, so that
+/// the cost does not grow with the sigmas.
+template<typename T>
+static Array<T> bilateralGrid(const Array<T> &in, const float sSigma,
+                              const float cSigma, const float sampling) {
+    const dim4 &dims      = in.dims();
+    const dim_t numPixels = dims.elements();
+    const T sStep         = static_cast<T>(sSigma * sampling);
+    const T cStep         = static_cast<T>(cSigma * sampling);
+    const T minVal        = reduce_all<af_min_t, T, T>(in);
+    const T maxVal        = reduce_all<af_max_t, T, T>(in);
+
+    // One cell past the last coordinate holds the upper trilinear weights
+    const dim4 gDims(static_cast<dim_t>((dims[0] - 1) / sStep) + 2,
+                     static_cast<dim_t>((dims[1] - 1) / sStep) + 2,
+                     static_cast<dim_t>((maxVal - minVal) / cStep) + 2,
+                     dims[2] * dims[3]);
+    const dim_t numCells = gDims.elements();
+    if (numCells > INT_MAX || 8 * numPixels > INT_MAX) {
+        AF_ERROR("The bilateral grid of the image is too large", AF_ERR_SIZE);
+    }
+
+    // The coordinates of the pixels in the grid, and the cell below them
+    const Array<T> coords[3] = {
+        arithScalar<af_div_t>(range<T>(dims, 0), sStep),
+        arithScalar<af_div_t>(range<T>(dims, 1), sStep),
+        arithScalar<af_div_t>(arithScalar<af_sub_t>(in, minVal), cStep)};
+    vector<Array<T>> fracs;
+    vector<Array<int>> lower;
+    for (const Array<T> &coord : coords) {
+        const Array<T> floored = unaryOp<T, af_floor_t>(coord);
+        fracs.push_back(arithOp<T, af_sub_t>(coord, floored, dims));
+        lower.push_back(cast<int>(floored));
+    }
+    const Array<int> image = arithOp<int, af_add_t>(
+        range<int>(dims, 2),
+        arithScalar<af_mul_t>(range<int>(dims, 3), static_cast<int>(dims[2])),
+        dims);
+    Array<int> base = arithOp<int, af_add_t>(
+        lower[2], arithScalar<af_mul_t>(image, static_cast<int>(gDims[2])),
+        dims);
+    base = arithOp<int, af_add_t>(
+        lower[1], arithScalar<af_mul_t>(base, static_cast<int>(gDims[1])),
+        dims);
+    base = arithOp<int, af_add_t>(
+        lower[0], arithScalar<af_mul_t>(base, static_cast<int>(gDims[0])),
+        dims);
+
+    // The eight corners of the cell of each pixel are the consecutive
+    // entries of its row
+    vector<Array<int>> cornerIdx;
+    vector<Array<T>> cornerWts;
+    const Array<T> ONES = createValueArray(dims, scalar<T>(1));
+    for (int corner = 0; corner < 8; ++corner) {
+        dim_t offset    = 0;
+        dim_t stride    = 1;
+        Array<T> weight = ONES;
+        for (int d = 0; d < 3; ++d) {
+            const bool upper = (corner >> d) & 1;
+            offset += upper ? stride : 0;
+            stride *= gDims[d];
+            weight = arithOp<T, af_mul_t>(
+                weight,
+                upper ? fracs[d] : arithOp<T, af_sub_t>(ONES, fracs[d], dims),
+                dims);
+        }
+        Array<int> idx = arithScalar<af_add_t>(base, static_cast<int>(offset));
+        idx.eval();
+        weight.eval();
+        idx.modDims(dim4(1, numPixels));
+        weight.modDims(dim4(1, numPixels));
+        cornerIdx.push_back(idx);
+        cornerWts.push_back(weight);
+    }
+    Array<int> colIdx = join(0, cornerIdx);
+    Array<T> values   = join(0, cornerWts);
+    colIdx.modDims(dim4(8 * numPixels));
+    values.modDims(dim4(8 * numPixels));
+    const Array<int> rowIdx =
+        arithScalar<af_mul_t>(range<int>(dim4(numPixels + 1)), 8);
+    const SparseArray<T> weights = createArrayDataSparseArray<T>(
+        dim4(numPixels, numCells), values, rowIdx, colIdx, AF_STORAGE_CSR,
+        false);
+
+    // The values and the weights of the pixels are splatted together
+    Array<T> pixels = in.isLinear() ? in : copyArray(in);
+    pixels.eval();
+    pixels.modDims(dim4(numPixels));
+    Array<T> grid =
+        matmul(weights,
+               join(1, pixels,
+                    createValueArray(dim4(numPixels), scalar<T>(1))),
+               AF_MAT_TRANS, AF_MAT_NONE);
+    grid.modDims(dim4(gDims[0], gDims[1], gDims[2], 2 * gDims[3]));
+
+    // A Gaussian of one sigma, which is 1 / sampling cells
+    const int radius = static_cast<int>(std::ceil(3.f / sampling));
+    const int width  = 2 * radius + 1;
+    vector<T> gauss(width);
+    for (int i = 0; i < width; ++i) {
+        const T dist = static_cast<T>((i - radius) * sampling);
+        gauss[i]     = std::exp(-dist * dist / 2);
+    }
+    vector<T> kernel(width * width * width);
+    for (int k = 0; k < width; ++k) {
+        for (int j = 0; j < width; ++j) {
+            for (int i = 0; i < width; ++i) {
+                kernel[(k * width + j) * width + i] =
+                    gauss[i] * gauss[j] * gauss[k];
+            }
+        }
+    }
+    grid = fftconvolve(
+        grid,
+        createHostDataArray<T>(dim4(width, width, width), kernel.data()),
+        false, AF_BATCH_LHS, 3);
+    grid.eval();
+
+    // The sliced sums of the values are normalized by the sliced weights
+    grid.modDims(dim4(numCells, 2));
+    const Array<T> sliced = matmul(weights, grid, AF_MAT_NONE, AF_MAT_NONE);
+    vector<af_seq> index(AF_MAX_DIMS, af_span);
+    index[1]             = {0., 0., 1.};
+    const Array<T> sums  = createSubArray(sliced, index);
+    index[1]             = {1., 1., 1.};
+    const Array<T> norms = createSubArray(sliced, index);
+    Array<T> out         = arithOp<T, af_div_t>(sums, norms, sums.dims());
+    out.eval();
+    out.modDims(dims);
+    return out;
+}
+
+template<typename T>
+inline af_array bilateralGrid(const af_array &in, const float sSigma,
+                              const float cSigma, const float sampling) {
+    using OutType =
+        typename conditional<is_same<T, double>::value, double, float>::type;
+    return getHandle(bilateralGrid<OutType>(castArray<OutType>(in), sSigma,
+                                            cSigma, sampling));
+}
+
 af_err af_bilateral(af_array *out, const af_array in, const float ssigma,
                     const float csigma, const bool iscolor) {
+    AF_API_RANGE_ARRAY(in);
     UNUSED(iscolor);
     try {
         const ArrayInfo &info = getInfo(in);
@@ -61,3 +246,60 @@ af_err af_bilateral(af_array *out, const af_array in, const float ssigma,
 
     return AF_SUCCESS;
 }
+
+af_err af_bilateral_grid(af_array *out, const af_array in,
+                         const float spatial_sigma,
+                         const float chromatic_sigma, const float sampling) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const ArrayInfo &info = getInfo(in);
+        af_dtype type         = info.getType();
+        af::dim4 dims         = info.dims();
+
+        DIM_ASSERT(1, (dims.ndims() >= 2));
+        ARG_ASSERT(2, (spatial_sigma > 0));
+        ARG_ASSERT(3, (chromatic_sigma > 0));
+        ARG_ASSERT(4, (sampling > 0 && sampling <= 1));
+
+        af_array output = nullptr;
+        switch (type) {
+            case f64:
+                output = bilateralGrid<double>(in, spatial_sigma,
+                                               chromatic_sigma, sampling);
+                break;
+            case f32:
+                output = bilateralGrid<float>(in, spatial_sigma,
+                                              chromatic_sigma, sampling);
+                break;
+            case b8:
+                output = bilateralGrid<char>(in, spatial_sigma,
+                                             chromatic_sigma, sampling);
+                break;
+            case s32:
+                output = bilateralGrid<int>(in, spatial_sigma,
+                                            chromatic_sigma, sampling);
+                break;
+            case u32:
+                output = bilateralGrid<uint>(in, spatial_sigma,
+                                             chromatic_sigma, sampling);
+                break;
+            case u8:
+                output = bilateralGrid<uchar>(in, spatial_sigma,
+                                              chromatic_sigma, sampling);
+                break;
+            case s16:
+                output = bilateralGrid<short>(in, spatial_sigma,
+                                              chromatic_sigma, sampling);
+                break;
+            case u16:
+                output = bilateralGrid<ushort>(in, spatial_sigma,
+                                               chromatic_sigma, sampling);
+                break;
+            default: TYPE_ERROR(1, type);
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
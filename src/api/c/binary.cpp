@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -24,10 +25,13 @@
 #include <logic.hpp>
 #include <sparse_arith.hpp>
 
+#include <common/bfloat16.hpp>
 #include <common/half.hpp>
 
 using af::dim4;
+using common::bfloat16;
 using common::half;
+using detail::Array;
 using detail::arithOp;
 using detail::arithOpD;
 using detail::cdouble;
@@ -46,6 +50,17 @@ static inline af_array arithOp(const af_array lhs, const af_array rhs,
     return res;
 }
 
+/// The bfloat16 operations are done on the float values of the operands.
+/// The casts are part of the JIT tree, so the result is rounded to bfloat16
+/// once, in the kernel which computes it.
+template<af_op_t op>
+static inline af_array arithOpBf16(const af_array lhs, const af_array rhs,
+                                   const dim4 &odims) {
+    Array<float> res =
+        arithOp<float, op>(castArray<float>(lhs), castArray<float>(rhs), odims);
+    return getHandle(detail::cast<bfloat16, float>(res));
+}
+
 template<typename T, af_op_t op>
 static inline af_array sparseArithOp(const af_array lhs, const af_array rhs) {
     auto res = arithOp<T, op>(getSparseArray<T>(lhs), getSparseArray<T>(rhs));
@@ -91,6 +106,7 @@ static af_err af_arith(af_array *out, const af_array lhs, const af_array rhs,
             case s16: res = arithOp<short, op>(lhs, rhs, odims); break;
             case u16: res = arithOp<ushort, op>(lhs, rhs, odims); break;
             case f16: res = arithOp<half, op>(lhs, rhs, odims); break;
+            case bf16: res = arithOpBf16<op>(lhs, rhs, odims); break;
             default: TYPE_ERROR(0, otype);
         }
 
@@ -123,6 +139,7 @@ static af_err af_arith_real(af_array *out, const af_array lhs,
             case s16: res = arithOp<short, op>(lhs, rhs, odims); break;
             case u16: res = arithOp<ushort, op>(lhs, rhs, odims); break;
             case f16: res = arithOp<half, op>(lhs, rhs, odims); break;
+            case bf16: res = arithOpBf16<op>(lhs, rhs, odims); break;
             default: TYPE_ERROR(0, otype);
         }
         std::swap(*out, res);
@@ -166,6 +183,9 @@ static af_err af_arith_sparse_dense(af_array *out, const af_array lhs,
         const common::SparseArrayBase linfo = getSparseArrayBase(lhs);
         const ArrayInfo &rinfo              = getInfo(rhs);
 
+        ARG_ASSERT(1, linfo.getStorage() == AF_STORAGE_CSR ||
+                          linfo.getStorage() == AF_STORAGE_COO);
+
         const af_dtype otype = implicit(linfo.getType(), rinfo.getType());
         af_array res;
         switch (otype) {
@@ -192,6 +212,7 @@ static af_err af_arith_sparse_dense(af_array *out, const af_array lhs,
 
 af_err af_add(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     // Check if inputs are sparse
     const ArrayInfo &linfo = getInfo(lhs, false, true);
     const ArrayInfo &rinfo = getInfo(rhs, false, true);
@@ -211,6 +232,7 @@ af_err af_add(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_mul(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     // Check if inputs are sparse
     const ArrayInfo &linfo = getInfo(lhs, false, true);
     const ArrayInfo &rinfo = getInfo(rhs, false, true);
@@ -233,6 +255,7 @@ af_err af_mul(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_sub(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     // Check if inputs are sparse
     const ArrayInfo &linfo = getInfo(lhs, false, true);
     const ArrayInfo &rinfo = getInfo(rhs, false, true);
@@ -252,6 +275,7 @@ af_err af_sub(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_div(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     // Check if inputs are sparse
     const ArrayInfo &linfo = getInfo(lhs, false, true);
     const ArrayInfo &rinfo = getInfo(rhs, false, true);
@@ -277,26 +301,31 @@ af_err af_div(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_maxof(af_array *out, const af_array lhs, const af_array rhs,
                 const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_arith<af_max_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_minof(af_array *out, const af_array lhs, const af_array rhs,
                 const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_arith<af_min_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_rem(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_arith_real<af_rem_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_mod(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_arith_real<af_mod_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_pow(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     try {
         const ArrayInfo &linfo = getInfo(lhs);
         const ArrayInfo &rinfo = getInfo(rhs);
@@ -342,6 +371,7 @@ af_err af_pow(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_root(af_array *out, const af_array lhs, const af_array rhs,
                const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     try {
         const ArrayInfo &linfo = getInfo(lhs);
         const ArrayInfo &rinfo = getInfo(rhs);
@@ -374,6 +404,7 @@ af_err af_root(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_atan2(af_array *out, const af_array lhs, const af_array rhs,
                 const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     try {
         const af_dtype type = implicit(lhs, rhs);
 
@@ -402,6 +433,7 @@ af_err af_atan2(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_hypot(af_array *out, const af_array lhs, const af_array rhs,
                 const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     try {
         const af_dtype type = implicit(lhs, rhs);
 
@@ -462,6 +494,7 @@ static af_err af_logic(af_array *out, const af_array lhs, const af_array rhs,
             case s16: res = logicOp<short, op>(lhs, rhs, odims); break;
             case u16: res = logicOp<ushort, op>(lhs, rhs, odims); break;
             case f16: res = logicOp<half, op>(lhs, rhs, odims); break;
+            case bf16: res = logicOp<float, op>(lhs, rhs, odims); break;
             default: TYPE_ERROR(0, type);
         }
 
@@ -473,41 +506,49 @@ static af_err af_logic(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_eq(af_array *out, const af_array lhs, const af_array rhs,
              const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_logic<af_eq_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_neq(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_logic<af_neq_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_gt(af_array *out, const af_array lhs, const af_array rhs,
              const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_logic<af_gt_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_ge(af_array *out, const af_array lhs, const af_array rhs,
              const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_logic<af_ge_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_lt(af_array *out, const af_array lhs, const af_array rhs,
              const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_logic<af_lt_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_le(af_array *out, const af_array lhs, const af_array rhs,
              const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_logic<af_le_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_and(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_logic<af_and_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_or(af_array *out, const af_array lhs, const af_array rhs,
              const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_logic<af_or_t>(out, lhs, rhs, batchMode);
 }
 
@@ -555,25 +596,30 @@ static af_err af_bitwise(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_bitand(af_array *out, const af_array lhs, const af_array rhs,
                  const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_bitwise<af_bitand_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_bitor(af_array *out, const af_array lhs, const af_array rhs,
                 const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_bitwise<af_bitor_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_bitxor(af_array *out, const af_array lhs, const af_array rhs,
                  const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_bitwise<af_bitxor_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_bitshiftl(af_array *out, const af_array lhs, const af_array rhs,
                     const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_bitwise<af_bitshiftl_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_bitshiftr(af_array *out, const af_array lhs, const af_array rhs,
                     const bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     return af_bitwise<af_bitshiftr_t>(out, lhs, rhs, batchMode);
 }
@@ -10,9 +10,11 @@
 #include <af/blas.h>
 
 #include <Array.hpp>
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <blas.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/bfloat16.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <handle.hpp>
@@ -25,12 +27,18 @@
 #include <af/defines.h>
 #include <af/dim4.hpp>
 
+using common::bfloat16;
 using common::half;
 using common::SparseArrayBase;
 using detail::cdouble;
 using detail::cfloat;
+using detail::createEmptyArray;
 using detail::gemm;
+using detail::gemmEpilogue;
+using detail::gemmMixed;
+using detail::gemmQuantized;
 using detail::matmul;
+using detail::uchar;
 
 template<typename T>
 static inline af_array sparseMatmul(const af_array lhs, const af_array rhs,
@@ -39,6 +47,12 @@ static inline af_array sparseMatmul(const af_array lhs, const af_array rhs,
         matmul<T>(getSparseArray<T>(lhs), getArray<T>(rhs), optLhs, optRhs));
 }
 
+template<typename T>
+static inline af_array sparseSparseMatmul(const af_array lhs,
+                                          const af_array rhs) {
+    return getHandle(matmul<T>(getSparseArray<T>(lhs), getSparseArray<T>(rhs)));
+}
+
 template<typename T>
 static inline void gemm(af_array *out, af_mat_prop optLhs, af_mat_prop optRhs,
                         const T *alpha, const af_array lhs, const af_array rhs,
@@ -47,6 +61,28 @@ static inline void gemm(af_array *out, af_mat_prop optLhs, af_mat_prop optRhs,
             getArray<T>(rhs), betas);
 }
 
+template<typename T>
+static inline void gemmFused(af_array *out, af_mat_prop optLhs,
+                             af_mat_prop optRhs, const T *alpha,
+                             const af_array lhs, const af_array rhs,
+                             const T *beta, const af_array bias,
+                             af_gemm_epilogue epilogue) {
+    gemmEpilogue<T>(getArray<T>(*out), optLhs, optRhs, alpha, getArray<T>(lhs),
+                    getArray<T>(rhs), beta,
+                    bias ? getArray<T>(bias)
+                         : createEmptyArray<T>(af::dim4(0)),
+                    epilogue);
+}
+
+template<typename Ti, typename To>
+static inline void gemmMixed(af_array *out, af_mat_prop optLhs,
+                             af_mat_prop optRhs, const To *alpha,
+                             const af_array lhs, const af_array rhs,
+                             const To *beta, af_gemm_compute_type compute) {
+    gemmMixed<Ti, To>(getArray<To>(*out), optLhs, optRhs, alpha,
+                      getArray<Ti>(lhs), getArray<Ti>(rhs), beta, compute);
+}
+
 template<typename T>
 static inline af_array dot(const af_array lhs, const af_array rhs,
                            af_mat_prop optLhs, af_mat_prop optRhs) {
@@ -56,17 +92,50 @@ static inline af_array dot(const af_array lhs, const af_array rhs,
 
 af_err af_sparse_matmul(af_array *out, const af_array lhs, const af_array rhs,
                         const af_mat_prop optLhs, const af_mat_prop optRhs) {
+    AF_API_RANGE_ARRAY(lhs);
     try {
         const SparseArrayBase lhsBase = getSparseArrayBase(lhs);
-        const ArrayInfo &rhsInfo      = getInfo(rhs);
+        const ArrayInfo &rhsInfo      = getInfo(rhs, false, true);
 
-        ARG_ASSERT(2,
-                   lhsBase.isSparse() == true && rhsInfo.isSparse() == false);
+        ARG_ASSERT(1, lhsBase.isSparse() == true);
 
         af_dtype lhs_type = lhsBase.getType();
         af_dtype rhs_type = rhsInfo.getType();
 
-        ARG_ASSERT(1, lhsBase.getStorage() == AF_STORAGE_CSR);
+        const af_storage lhsStorage = lhsBase.getStorage();
+        ARG_ASSERT(1, lhsStorage == AF_STORAGE_CSR ||
+                          lhsStorage == AF_STORAGE_CSC ||
+                          lhsStorage == AF_STORAGE_COO ||
+                          lhsStorage == AF_STORAGE_BSR ||
+                          lhsStorage == AF_STORAGE_SELL);
+
+        if (rhsInfo.isSparse()) {
+            const SparseArrayBase rhsBase = getSparseArrayBase(rhs);
+            ARG_ASSERT(1, lhsStorage == AF_STORAGE_CSR);
+            ARG_ASSERT(2, rhsBase.getStorage() == AF_STORAGE_CSR);
+
+            if (optLhs != AF_MAT_NONE || optRhs != AF_MAT_NONE) {
+                AF_ERROR(
+                    "Transposes are not supported in sparse-sparse matmul",
+                    AF_ERR_NOT_SUPPORTED);
+            }
+
+            TYPE_ASSERT(lhs_type == rhs_type);
+            DIM_ASSERT(1, lhsBase.dims()[1] == rhsBase.dims()[0]);
+
+            af_array output = 0;
+            switch (lhs_type) {
+                case f32: output = sparseSparseMatmul<float>(lhs, rhs); break;
+                case c32: output = sparseSparseMatmul<cfloat>(lhs, rhs); break;
+                case f64: output = sparseSparseMatmul<double>(lhs, rhs); break;
+                case c64:
+                    output = sparseSparseMatmul<cdouble>(lhs, rhs);
+                    break;
+                default: TYPE_ERROR(1, lhs_type);
+            }
+            std::swap(*out, output);
+            return AF_SUCCESS;
+        }
 
         if (!(optLhs == AF_MAT_NONE || optLhs == AF_MAT_TRANS ||
               optLhs == AF_MAT_CTRANS)) {  // Note the ! operator.
@@ -75,6 +144,12 @@ af_err af_sparse_matmul(af_array *out, const af_array lhs, const af_array rhs,
                 AF_ERR_NOT_SUPPORTED);
         }
 
+        if ((lhsStorage == AF_STORAGE_BSR || lhsStorage == AF_STORAGE_SELL) &&
+            optLhs != AF_MAT_NONE) {
+            AF_ERROR("Transposes of blocked sparse arrays are not supported",
+                     AF_ERR_NOT_SUPPORTED);
+        }
+
         // No transpose options for RHS
         if (optRhs != AF_MAT_NONE) {
             AF_ERROR("Using this property is not yet supported in matmul",
@@ -117,64 +192,75 @@ af_err af_sparse_matmul(af_array *out, const af_array lhs, const af_array rhs,
     return AF_SUCCESS;
 }
 
-af_err af_gemm(af_array *out, const af_mat_prop optLhs,
-               const af_mat_prop optRhs, const void *alpha, const af_array lhs,
-               const af_array rhs, const void *beta) {
-    try {
-        const ArrayInfo &lhsInfo = getInfo(lhs, false, true);
-        const ArrayInfo &rhsInfo = getInfo(rhs, true, true);
+// Checks the operands of a GEMM and returns the output array, which is
+// allocated with outType if *out is null
+static af_array gemmOutput(const af_array *out, const af_mat_prop optLhs,
+                           const af_mat_prop optRhs, const af_array lhs,
+                           const af_array rhs, const af_dtype outType) {
+    const ArrayInfo &lhsInfo = getInfo(lhs, false, true);
+    const ArrayInfo &rhsInfo = getInfo(rhs, true, true);
+
+    af_dtype lhs_type = lhsInfo.getType();
+    af_dtype rhs_type = rhsInfo.getType();
+
+    if (!(optLhs == AF_MAT_NONE || optLhs == AF_MAT_TRANS ||
+          optLhs == AF_MAT_CTRANS)) {
+        AF_ERROR("Using this property is not yet supported in matmul",
+                 AF_ERR_NOT_SUPPORTED);
+    }
 
-        af_dtype lhs_type = lhsInfo.getType();
-        af_dtype rhs_type = rhsInfo.getType();
+    if (!(optRhs == AF_MAT_NONE || optRhs == AF_MAT_TRANS ||
+          optRhs == AF_MAT_CTRANS)) {
+        AF_ERROR("Using this property is not yet supported in matmul",
+                 AF_ERR_NOT_SUPPORTED);
+    }
 
-        if (!(optLhs == AF_MAT_NONE || optLhs == AF_MAT_TRANS ||
-              optLhs == AF_MAT_CTRANS)) {
-            AF_ERROR("Using this property is not yet supported in matmul",
-                     AF_ERR_NOT_SUPPORTED);
-        }
+    af::dim4 lDims = lhsInfo.dims();
+    af::dim4 rDims = rhsInfo.dims();
 
-        if (!(optRhs == AF_MAT_NONE || optRhs == AF_MAT_TRANS ||
-              optRhs == AF_MAT_CTRANS)) {
-            AF_ERROR("Using this property is not yet supported in matmul",
-                     AF_ERR_NOT_SUPPORTED);
+    if (lDims.ndims() > 2 && rDims.ndims() > 2) {
+        DIM_ASSERT(3, lDims.ndims() == rDims.ndims());
+        if (lDims[2] != rDims[2] && lDims[2] != 1 && rDims[2] != 1) {
+            AF_ERROR("Batch size mismatch along dimension 2", AF_ERR_BATCH);
         }
-
-        af::dim4 lDims = lhsInfo.dims();
-        af::dim4 rDims = rhsInfo.dims();
-
-        if (lDims.ndims() > 2 && rDims.ndims() > 2) {
-            DIM_ASSERT(3, lDims.ndims() == rDims.ndims());
-            if (lDims[2] != rDims[2] && lDims[2] != 1 && rDims[2] != 1) {
-                AF_ERROR("Batch size mismatch along dimension 2", AF_ERR_BATCH);
-            }
-            if (lDims[3] != rDims[3] && lDims[3] != 1 && rDims[3] != 1) {
-                AF_ERROR("Batch size mismatch along dimension 3", AF_ERR_BATCH);
-            }
+        if (lDims[3] != rDims[3] && lDims[3] != 1 && rDims[3] != 1) {
+            AF_ERROR("Batch size mismatch along dimension 3", AF_ERR_BATCH);
         }
+    }
 
-        TYPE_ASSERT(lhs_type == rhs_type);
+    TYPE_ASSERT(lhs_type == rhs_type);
 
-        int aColDim = (optLhs == AF_MAT_NONE) ? 1 : 0;
-        int bRowDim = (optRhs == AF_MAT_NONE) ? 0 : 1;
+    int aColDim = (optLhs == AF_MAT_NONE) ? 1 : 0;
+    int bRowDim = (optRhs == AF_MAT_NONE) ? 0 : 1;
 
-        DIM_ASSERT(1, lhsInfo.dims()[aColDim] == rhsInfo.dims()[bRowDim]);
+    DIM_ASSERT(1, lhsInfo.dims()[aColDim] == rhsInfo.dims()[bRowDim]);
 
-        // Assume that *out is either initialized to null or an actual af_array
-        // Otherwise, this function has undefined behavior
-        af_array output = 0;
-        if (*out) {
-            output = *out;
-        } else {
-            const int aRowDim    = (optLhs == AF_MAT_NONE) ? 0 : 1;
-            const int bColDim    = (optRhs == AF_MAT_NONE) ? 1 : 0;
-            const int M          = lDims[aRowDim];
-            const int N          = rDims[bColDim];
-            const dim_t d2       = std::max(lDims[2], rDims[2]);
-            const dim_t d3       = std::max(lDims[3], rDims[3]);
-            const af::dim4 oDims = af::dim4(M, N, d2, d3);
-            AF_CHECK(af_create_handle(&output, lhsInfo.ndims(), oDims.get(),
-                                      lhs_type));
-        }
+    // Assume that *out is either initialized to null or an actual af_array
+    // Otherwise, this function has undefined behavior
+    af_array output = 0;
+    if (*out) {
+        output = *out;
+    } else {
+        const int aRowDim    = (optLhs == AF_MAT_NONE) ? 0 : 1;
+        const int bColDim    = (optRhs == AF_MAT_NONE) ? 1 : 0;
+        const int M          = lDims[aRowDim];
+        const int N          = rDims[bColDim];
+        const dim_t d2       = std::max(lDims[2], rDims[2]);
+        const dim_t d3       = std::max(lDims[3], rDims[3]);
+        const af::dim4 oDims = af::dim4(M, N, d2, d3);
+        AF_CHECK(af_create_handle(&output, lhsInfo.ndims(), oDims.get(),
+                                  outType));
+    }
+    return output;
+}
+
+af_err af_gemm(af_array *out, const af_mat_prop optLhs,
+               const af_mat_prop optRhs, const void *alpha, const af_array lhs,
+               const af_array rhs, const void *beta) {
+    AF_API_RANGE_ARRAY(lhs);
+    try {
+        af_dtype lhs_type = getInfo(lhs, false, true).getType();
+        af_array output = gemmOutput(out, optLhs, optRhs, lhs, rhs, lhs_type);
 
         switch (lhs_type) {
             case f32:
@@ -202,6 +288,11 @@ af_err af_gemm(af_array *out, const af_mat_prop optLhs,
                            static_cast<const half *>(alpha), lhs, rhs,
                            static_cast<const half *>(beta));
                 break;
+            case bf16:
+                gemm<bfloat16>(&output, optLhs, optRhs,
+                               static_cast<const bfloat16 *>(alpha), lhs, rhs,
+                               static_cast<const bfloat16 *>(beta));
+                break;
             default: TYPE_ERROR(3, lhs_type);
         }
 
@@ -211,16 +302,174 @@ af_err af_gemm(af_array *out, const af_mat_prop optLhs,
     return AF_SUCCESS;
 }
 
+af_err af_gemm_fused(af_array *out, const af_mat_prop optLhs,
+                     const af_mat_prop optRhs, const void *alpha,
+                     const af_array lhs, const af_array rhs, const void *beta,
+                     const af_array bias, const af_gemm_epilogue epilogue) {
+    AF_API_RANGE_ARRAY(lhs);
+    try {
+        const ArrayInfo &lhsInfo = getInfo(lhs, false, true);
+        af_dtype lhs_type        = lhsInfo.getType();
+
+        ARG_ASSERT(8, epilogue == AF_GEMM_EPILOGUE_NONE ||
+                          epilogue == AF_GEMM_EPILOGUE_RELU ||
+                          epilogue == AF_GEMM_EPILOGUE_GELU);
+        if (epilogue != AF_GEMM_EPILOGUE_NONE &&
+            (lhs_type == c32 || lhs_type == c64)) {
+            AF_ERROR("Activations are not supported for complex matrices",
+                     AF_ERR_NOT_SUPPORTED);
+        }
+
+        const bool hasBias = bias != 0 && getInfo(bias).elements() > 0;
+        if (hasBias) {
+            const ArrayInfo &biasInfo = getInfo(bias);
+            const int aRowDim         = (optLhs == AF_MAT_NONE) ? 0 : 1;
+            TYPE_ASSERT(biasInfo.getType() == lhs_type);
+            DIM_ASSERT(7, biasInfo.isColumn() &&
+                              biasInfo.elements() == lhsInfo.dims()[aRowDim]);
+        }
+
+        af_array output = gemmOutput(out, optLhs, optRhs, lhs, rhs, lhs_type);
+        const af_array biasArray = hasBias ? bias : 0;
+
+        switch (lhs_type) {
+            case f32:
+                gemmFused<float>(&output, optLhs, optRhs,
+                                 static_cast<const float *>(alpha), lhs, rhs,
+                                 static_cast<const float *>(beta), biasArray,
+                                 epilogue);
+                break;
+            case c32:
+                gemmFused<cfloat>(&output, optLhs, optRhs,
+                                  static_cast<const cfloat *>(alpha), lhs, rhs,
+                                  static_cast<const cfloat *>(beta), biasArray,
+                                  epilogue);
+                break;
+            case f64:
+                gemmFused<double>(&output, optLhs, optRhs,
+                                  static_cast<const double *>(alpha), lhs, rhs,
+                                  static_cast<const double *>(beta), biasArray,
+                                  epilogue);
+                break;
+            case c64:
+                gemmFused<cdouble>(&output, optLhs, optRhs,
+                                   static_cast<const cdouble *>(alpha), lhs,
+                                   rhs, static_cast<const cdouble *>(beta),
+                                   biasArray, epilogue);
+                break;
+            case f16:
+                gemmFused<half>(&output, optLhs, optRhs,
+                                static_cast<const half *>(alpha), lhs, rhs,
+                                static_cast<const half *>(beta), biasArray,
+                                epilogue);
+                break;
+            default: TYPE_ERROR(4, lhs_type);
+        }
+
+        std::swap(*out, output);
+    }
+    CATCHALL
+    return AF_SUCCESS;
+}
+
+af_err af_gemm_v2(af_array *out, const af_mat_prop optLhs,
+                  const af_mat_prop optRhs, const void *alpha,
+                  const af_array lhs, const af_array rhs, const void *beta,
+                  const af_gemm_compute_type compute) {
+    AF_API_RANGE_ARRAY(lhs);
+    try {
+        ARG_ASSERT(7, compute == AF_GEMM_COMPUTE_DEFAULT ||
+                          compute == AF_GEMM_COMPUTE_F32 ||
+                          compute == AF_GEMM_COMPUTE_TF32);
+
+        af_dtype lhs_type = getInfo(lhs, false, true).getType();
+        af_dtype out_type = lhs_type;
+        if ((lhs_type == f16 || lhs_type == bf16) &&
+            compute != AF_GEMM_COMPUTE_DEFAULT) {
+            // f16 and bf16 products accumulated in f32 are kept in f32
+            // unless the caller provides an output of the input type
+            out_type = *out ? getInfo(*out).getType() : f32;
+            TYPE_ASSERT(out_type == lhs_type || out_type == f32);
+        }
+        af_array output = gemmOutput(out, optLhs, optRhs, lhs, rhs, out_type);
+
+        switch (lhs_type) {
+            case f32:
+                gemmMixed<float, float>(&output, optLhs, optRhs,
+                                        static_cast<const float *>(alpha),
+                                        lhs, rhs,
+                                        static_cast<const float *>(beta),
+                                        compute);
+                break;
+            case c32:
+                gemmMixed<cfloat, cfloat>(&output, optLhs, optRhs,
+                                          static_cast<const cfloat *>(alpha),
+                                          lhs, rhs,
+                                          static_cast<const cfloat *>(beta),
+                                          compute);
+                break;
+            case f64:
+                gemmMixed<double, double>(&output, optLhs, optRhs,
+                                          static_cast<const double *>(alpha),
+                                          lhs, rhs,
+                                          static_cast<const double *>(beta),
+                                          compute);
+                break;
+            case c64:
+                gemmMixed<cdouble, cdouble>(
+                    &output, optLhs, optRhs,
+                    static_cast<const cdouble *>(alpha), lhs, rhs,
+                    static_cast<const cdouble *>(beta), compute);
+                break;
+            case f16:
+                if (out_type == f32) {
+                    gemmMixed<half, float>(&output, optLhs, optRhs,
+                                           static_cast<const float *>(alpha),
+                                           lhs, rhs,
+                                           static_cast<const float *>(beta),
+                                           compute);
+                } else {
+                    gemmMixed<half, half>(&output, optLhs, optRhs,
+                                          static_cast<const half *>(alpha),
+                                          lhs, rhs,
+                                          static_cast<const half *>(beta),
+                                          compute);
+                }
+                break;
+            case bf16:
+                if (out_type == f32) {
+                    gemmMixed<bfloat16, float>(
+                        &output, optLhs, optRhs,
+                        static_cast<const float *>(alpha), lhs, rhs,
+                        static_cast<const float *>(beta), compute);
+                } else {
+                    gemmMixed<bfloat16, bfloat16>(
+                        &output, optLhs, optRhs,
+                        static_cast<const bfloat16 *>(alpha), lhs, rhs,
+                        static_cast<const bfloat16 *>(beta), compute);
+                }
+                break;
+            default: TYPE_ERROR(4, lhs_type);
+        }
+
+        std::swap(*out, output);
+    }
+    CATCHALL
+    return AF_SUCCESS;
+}
+
 af_err af_matmul(af_array *out, const af_array lhs, const af_array rhs,
                  const af_mat_prop optLhs, const af_mat_prop optRhs) {
+    AF_API_RANGE_ARRAY(lhs);
     try {
         const ArrayInfo &lhsInfo = getInfo(lhs, false, true);
-        const ArrayInfo &rhsInfo = getInfo(rhs, true, true);
 
         if (lhsInfo.isSparse()) {
             return af_sparse_matmul(out, lhs, rhs, optLhs, optRhs);
         }
 
+        const ArrayInfo &rhsInfo = getInfo(rhs, true, true);
+
         const int aRowDim = (optLhs == AF_MAT_NONE) ? 0 : 1;
         const int bColDim = (optRhs == AF_MAT_NONE) ? 1 : 0;
 
@@ -246,6 +495,13 @@ af_err af_matmul(af_array *out, const af_array lhs, const af_array rhs,
                                  &beta));
                 break;
             }
+            case bf16: {
+                static const bfloat16 alpha(1.0f);
+                static const bfloat16 beta(0.0f);
+                AF_CHECK(af_gemm(&gemm_out, optLhs, optRhs, &alpha, lhs, rhs,
+                                 &beta));
+                break;
+            }
             case f32: {
                 float alpha = 1.f;
                 float beta  = 0.f;
@@ -284,8 +540,31 @@ af_err af_matmul(af_array *out, const af_array lhs, const af_array rhs,
     return AF_SUCCESS;
 }
 
+af_err af_matmul_quantized(af_array *out, const af_array lhs,
+                           const af_array rhs, const int lhsZero,
+                           const int rhsZero, const af_mat_prop optLhs,
+                           const af_mat_prop optRhs) {
+    AF_API_RANGE_ARRAY(lhs);
+    try {
+        const af_dtype lhs_type = getInfo(lhs, false, true).getType();
+        if (lhs_type != u8) { TYPE_ERROR(1, lhs_type); }
+        ARG_ASSERT(3, lhsZero >= 0 && lhsZero <= 255);
+        ARG_ASSERT(4, rhsZero >= 0 && rhsZero <= 255);
+
+        af_array output = 0;
+        output = gemmOutput(&output, optLhs, optRhs, lhs, rhs, s32);
+        gemmQuantized(getArray<int>(output), optLhs, optRhs,
+                      getArray<uchar>(lhs), lhsZero, getArray<uchar>(rhs),
+                      rhsZero);
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
 af_err af_dot(af_array *out, const af_array lhs, const af_array rhs,
               const af_mat_prop optLhs, const af_mat_prop optRhs) {
+    AF_API_RANGE_ARRAY(lhs);
     try {
         const ArrayInfo &lhsInfo = getInfo(lhs);
         const ArrayInfo &rhsInfo = getInfo(rhs);
@@ -338,6 +617,7 @@ static inline T dotAll(af_array out) {
 af_err af_dot_all(double *rval, double *ival, const af_array lhs,
                   const af_array rhs, const af_mat_prop optLhs,
                   const af_mat_prop optRhs) {
+    AF_API_RANGE_ARRAY(lhs);
     using namespace detail;  // NOLINT needed for imag and real functions
                              // name resolution
 
@@ -7,9 +7,11 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <cast.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/bfloat16.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <handle.hpp>
@@ -22,6 +24,7 @@
 #include <af/dim4.hpp>
 
 using af::dim4;
+using common::bfloat16;
 using common::half;
 using detail::cdouble;
 using detail::cfloat;
@@ -59,21 +62,23 @@ static af_array cast(const af_array in, const af_dtype type) {
             case s16: return getHandle(castArray<short>(in));
             case u16: return getHandle(castArray<ushort>(in));
             case f16: return getHandle(castArray<half>(in));
+            case bf16: return getHandle(castArray<bfloat16>(in));
             default: TYPE_ERROR(2, type);
         }
     }
 }
 
 af_err af_cast(af_array* out, const af_array in, const af_dtype type) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& info = getInfo(in, false, true);
 
         af_dtype inType = info.getType();
         if ((inType == c32 || inType == c64) &&
-            (type == f32 || type == f64 || type == f16)) {
+            (type == f32 || type == f64 || type == f16 || type == bf16)) {
             AF_ERROR(
                 "Casting is not allowed from complex (c32/c64) to real "
-                "(f16/f32/f64) types.\n"
+                "(bf16/f16/f32/f64) types.\n"
                 "Use abs, real, imag etc to convert complex to floating type.",
                 AF_ERR_TYPE);
         }
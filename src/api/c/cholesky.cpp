@@ -9,6 +9,7 @@
 
 #include <cholesky.hpp>
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -33,13 +34,10 @@ static inline int cholesky_inplace(af_array in, const bool is_upper) {
 
 af_err af_cholesky(af_array *out, int *info, const af_array in,
                    const bool is_upper) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &i_info = getInfo(in);
 
-        if (i_info.ndims() > 2) {
-            AF_ERROR("cholesky can not be used in batch mode", AF_ERR_BATCH);
-        }
-
         af_dtype type = i_info.getType();
 
         if (i_info.ndims() == 0) {
@@ -65,13 +63,10 @@ af_err af_cholesky(af_array *out, int *info, const af_array in,
 }
 
 af_err af_cholesky_inplace(int *info, af_array in, const bool is_upper) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &i_info = getInfo(in);
 
-        if (i_info.ndims() > 2) {
-            AF_ERROR("cholesky can not be used in batch mode", AF_ERR_BATCH);
-        }
-
         af_dtype type = i_info.getType();
         if (i_info.ndims() == 0) { return AF_SUCCESS; }
         ARG_ASSERT(1, i_info.isFloating());  // Only floating and complex types
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
@@ -45,6 +46,7 @@ static inline af_array clampOp(const af_array in, const af_array lo,
 
 af_err af_clamp(af_array* out, const af_array in, const af_array lo,
                 const af_array hi, const bool batch) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& linfo = getInfo(lo);
         const ArrayInfo& hinfo = getInfo(hi);
@@ -0,0 +1,394 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <Event.hpp>
+#include <api_range.hpp>
+#include <arith.hpp>
+#include <backend.hpp>
+#include <common/ArrayInfo.hpp>
+#include <common/err_common.hpp>
+#include <common/half.hpp>
+#include <copy.hpp>
+#include <handle.hpp>
+#include <join.hpp>
+#include <optypes.hpp>
+#include <platform.hpp>
+#include <with_device.hpp>
+#include <af/array.h>
+#include <af/defines.h>
+#include <af/event.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using af::dim4;
+using common::half;
+using detail::arithOp;
+using detail::Array;
+using detail::cdouble;
+using detail::cfloat;
+using detail::copyArray;
+using detail::copyToDevice;
+using detail::createAndMarkEvent;
+using detail::createSubArray;
+using detail::getDeviceCount;
+using detail::intl;
+using detail::join;
+using detail::uchar;
+using detail::uint;
+using detail::uintl;
+using detail::ushort;
+using std::vector;
+
+namespace {
+
+/// Returns an event marked on the queue of \p device
+af_event markOnDevice(const int device) {
+    af_event event;
+    withDevice(device, [&]() { event = createAndMarkEvent(); });
+    return event;
+}
+
+/// Returns \p in on \p device, copied only if it is on another device
+template<typename T>
+Array<T> onDevice(const Array<T> &in, const int device) {
+    if (static_cast<int>(in.getDevId()) == device) { return in; }
+    return copyToDevice(in, device);
+}
+
+template<typename T>
+void scatter(af_array *outs, af_event *events, const af_array in,
+             const int dim, const unsigned num_devices, const int *devices) {
+    const Array<T> &input = getArray<T>(in);
+    const dim_t base      = input.dims()[dim] / num_devices;
+    const dim_t rest      = input.dims()[dim] % num_devices;
+
+    vector<af_seq> index(4, af_span);
+    dim_t begin = 0;
+    for (unsigned i = 0; i < num_devices; ++i) {
+        const dim_t size = base + (static_cast<dim_t>(i) < rest ? 1 : 0);
+        index[dim]       = {static_cast<double>(begin),
+                      static_cast<double>(begin + size - 1), 1.};
+
+        const Array<T> piece = createSubArray(input, index, false);
+        outs[i]              = getHandle(copyToDevice(piece, devices[i]));
+        if (events) { events[i] = markOnDevice(devices[i]); }
+        begin += size;
+    }
+}
+
+template<typename T>
+af_array gather(af_event *event, const unsigned num_arrays,
+                const af_array *ins, const int dim, const int device) {
+    vector<Array<T>> pieces;
+    pieces.reserve(num_arrays);
+    for (unsigned i = 0; i < num_arrays; ++i) {
+        pieces.push_back(onDevice(getArray<T>(ins[i]), device));
+    }
+
+    af_array out;
+    withDevice(device, [&]() {
+        out = getHandle(num_arrays == 1 ? copyArray(pieces[0])
+                                        : join<T>(dim, pieces));
+        pieces.clear();
+        if (event) { *event = createAndMarkEvent(); }
+    });
+    return out;
+}
+
+/// Reduces the arrays of the devices in a ring. Each array is split into one
+/// chunk per device. The reduction of each chunk is passed around the ring
+/// and completed on one device, after which the reduced chunks are passed
+/// around the ring again. Every device sends and receives one chunk at each
+/// step, so the devices transfer the same amount of data.
+template<typename T, af_op_t op>
+void allReduce(af_array *outs, af_event *events, const unsigned num_arrays,
+               const af_array *ins) {
+    const unsigned n     = num_arrays;
+    const dim4 dims      = getArray<T>(ins[0]).dims();
+    const dim_t elements = dims.elements();
+
+    vector<int> devices(n);
+    vector<dim_t> offsets(n + 1);
+    for (unsigned k = 0; k <= n; ++k) { offsets[k] = elements * k / n; }
+
+    // chunks[i][k] is the chunk k held by device i
+    vector<vector<Array<T>>> chunks(n);
+    for (unsigned i = 0; i < n; ++i) {
+        const Array<T> &input = getArray<T>(ins[i]);
+        devices[i]            = input.getDevId();
+
+        withDevice(devices[i], [&]() {
+            const Array<T> data = flat(input);
+            vector<af_seq> index(1);
+            for (unsigned k = 0; k < n; ++k) {
+                index[0] = {static_cast<double>(offsets[k]),
+                            static_cast<double>(offsets[k + 1] - 1), 1.};
+                chunks[i].push_back(createSubArray(data, index, false));
+            }
+        });
+    }
+
+    // Device i sends chunk i - s at step s and holds the reduction of chunk
+    // i + 1 after the last step
+    for (unsigned s = 0; s + 1 < n; ++s) {
+        for (unsigned i = 0; i < n; ++i) {
+            const unsigned k   = (i + n - s) % n;
+            const unsigned dst = (i + 1) % n;
+            if (offsets[k] == offsets[k + 1]) { continue; }
+
+            withDevice(devices[dst], [&]() {
+                Array<T> recv  = copyToDevice(chunks[i][k], devices[dst]);
+                chunks[dst][k] = arithOp<T, op>(chunks[dst][k], recv,
+                                                chunks[dst][k].dims());
+                chunks[dst][k].eval();
+            });
+        }
+    }
+
+    // Device i sends chunk i + 1 - s at step s
+    for (unsigned s = 0; s + 1 < n; ++s) {
+        for (unsigned i = 0; i < n; ++i) {
+            const unsigned k   = (i + 1 + n - s) % n;
+            const unsigned dst = (i + 1) % n;
+            if (offsets[k] == offsets[k + 1]) { continue; }
+
+            withDevice(devices[dst], [&]() {
+                chunks[dst][k] = copyToDevice(chunks[i][k], devices[dst]);
+            });
+        }
+    }
+
+    for (unsigned i = 0; i < n; ++i) {
+        withDevice(devices[i], [&]() {
+            vector<Array<T>> parts;
+            for (unsigned k = 0; k < n; ++k) {
+                if (offsets[k] != offsets[k + 1]) {
+                    parts.push_back(chunks[i][k]);
+                }
+            }
+            chunks[i].clear();
+
+            const Array<T> out =
+                parts.size() == 1 ? copyArray(parts[0]) : join(0, parts);
+            outs[i] = getHandle(modDims(out, dims));
+            if (events) { events[i] = createAndMarkEvent(); }
+        });
+    }
+}
+
+template<af_op_t op>
+void allReduce(af_array *outs, af_event *events, const unsigned num_arrays,
+               const af_array *ins, const af_dtype type) {
+    switch (type) {
+        case f32: allReduce<float, op>(outs, events, num_arrays, ins); break;
+        case f64: allReduce<double, op>(outs, events, num_arrays, ins); break;
+        case c32: allReduce<cfloat, op>(outs, events, num_arrays, ins); break;
+        case c64: allReduce<cdouble, op>(outs, events, num_arrays, ins); break;
+        case s32: allReduce<int, op>(outs, events, num_arrays, ins); break;
+        case u32: allReduce<uint, op>(outs, events, num_arrays, ins); break;
+        case u8: allReduce<uchar, op>(outs, events, num_arrays, ins); break;
+        case b8: allReduce<char, op>(outs, events, num_arrays, ins); break;
+        case s64: allReduce<intl, op>(outs, events, num_arrays, ins); break;
+        case u64: allReduce<uintl, op>(outs, events, num_arrays, ins); break;
+        case s16: allReduce<short, op>(outs, events, num_arrays, ins); break;
+        case u16: allReduce<ushort, op>(outs, events, num_arrays, ins); break;
+        case f16: allReduce<half, op>(outs, events, num_arrays, ins); break;
+        default: TYPE_ERROR(3, type);
+    }
+}
+
+}  // namespace
+
+af_err af_scatter(af_event *events, af_array *outs, const af_array in,
+                  const int dim, const unsigned num_devices,
+                  const int *devices) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const ArrayInfo &info = getInfo(in, true, false);
+        ARG_ASSERT(1, outs != nullptr);
+        ARG_ASSERT(3, dim >= 0 && dim < 4);
+        ARG_ASSERT(4, num_devices > 0 && num_devices <= info.dims()[dim]);
+        ARG_ASSERT(5, devices != nullptr);
+        for (unsigned i = 0; i < num_devices; ++i) {
+            ARG_ASSERT(5, devices[i] >= 0 && devices[i] < getDeviceCount());
+        }
+
+        vector<af_array> res(num_devices);
+        af_dtype type = info.getType();
+        switch (type) {
+            case f32:
+                scatter<float>(res.data(), events, in, dim, num_devices,
+                               devices);
+                break;
+            case f64:
+                scatter<double>(res.data(), events, in, dim, num_devices,
+                                devices);
+                break;
+            case c32:
+                scatter<cfloat>(res.data(), events, in, dim, num_devices,
+                                devices);
+                break;
+            case c64:
+                scatter<cdouble>(res.data(), events, in, dim, num_devices,
+                                 devices);
+                break;
+            case s32:
+                scatter<int>(res.data(), events, in, dim, num_devices,
+                             devices);
+                break;
+            case u32:
+                scatter<uint>(res.data(), events, in, dim, num_devices,
+                              devices);
+                break;
+            case u8:
+                scatter<uchar>(res.data(), events, in, dim, num_devices,
+                               devices);
+                break;
+            case b8:
+                scatter<char>(res.data(), events, in, dim, num_devices,
+                              devices);
+                break;
+            case s64:
+                scatter<intl>(res.data(), events, in, dim, num_devices,
+                              devices);
+                break;
+            case u64:
+                scatter<uintl>(res.data(), events, in, dim, num_devices,
+                               devices);
+                break;
+            case s16:
+                scatter<short>(res.data(), events, in, dim, num_devices,
+                               devices);
+                break;
+            case u16:
+                scatter<ushort>(res.data(), events, in, dim, num_devices,
+                                devices);
+                break;
+            case f16:
+                scatter<half>(res.data(), events, in, dim, num_devices,
+                              devices);
+                break;
+            default: TYPE_ERROR(2, type);
+        }
+        std::copy(res.begin(), res.end(), outs);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_gather(af_event *event, af_array *out, const unsigned num_arrays,
+                 const af_array *ins, const int dim, const int device) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(2, num_arrays > 0);
+        ARG_ASSERT(3, ins != nullptr);
+        ARG_ASSERT(4, dim >= 0 && dim < 4);
+        ARG_ASSERT(5, device >= 0 && device < getDeviceCount());
+
+        const ArrayInfo &first = getInfo(ins[0], true, false);
+        for (unsigned i = 1; i < num_arrays; ++i) {
+            const ArrayInfo &info = getInfo(ins[i], true, false);
+            ARG_ASSERT(3, info.getType() == first.getType());
+            for (int d = 0; d < 4; ++d) {
+                if (d == dim) { continue; }
+                DIM_ASSERT(3, info.dims()[d] == first.dims()[d]);
+            }
+        }
+
+        af_array res;
+        af_dtype type = first.getType();
+        switch (type) {
+            case f32:
+                res = gather<float>(event, num_arrays, ins, dim, device);
+                break;
+            case f64:
+                res = gather<double>(event, num_arrays, ins, dim, device);
+                break;
+            case c32:
+                res = gather<cfloat>(event, num_arrays, ins, dim, device);
+                break;
+            case c64:
+                res = gather<cdouble>(event, num_arrays, ins, dim, device);
+                break;
+            case s32:
+                res = gather<int>(event, num_arrays, ins, dim, device);
+                break;
+            case u32:
+                res = gather<uint>(event, num_arrays, ins, dim, device);
+                break;
+            case u8:
+                res = gather<uchar>(event, num_arrays, ins, dim, device);
+                break;
+            case b8:
+                res = gather<char>(event, num_arrays, ins, dim, device);
+                break;
+            case s64:
+                res = gather<intl>(event, num_arrays, ins, dim, device);
+                break;
+            case u64:
+                res = gather<uintl>(event, num_arrays, ins, dim, device);
+                break;
+            case s16:
+                res = gather<short>(event, num_arrays, ins, dim, device);
+                break;
+            case u16:
+                res = gather<ushort>(event, num_arrays, ins, dim, device);
+                break;
+            case f16:
+                res = gather<half>(event, num_arrays, ins, dim, device);
+                break;
+            default: TYPE_ERROR(3, type);
+        }
+        std::swap(*out, res);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_all_reduce(af_event *events, af_array *outs,
+                     const unsigned num_arrays, const af_array *ins,
+                     const af_binary_op op) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(1, outs != nullptr);
+        ARG_ASSERT(2, num_arrays > 0);
+        ARG_ASSERT(3, ins != nullptr);
+
+        const ArrayInfo &first = getInfo(ins[0], true, false);
+        for (unsigned i = 1; i < num_arrays; ++i) {
+            const ArrayInfo &info = getInfo(ins[i], true, false);
+            ARG_ASSERT(3, info.getType() == first.getType());
+            DIM_ASSERT(3, info.dims() == first.dims());
+        }
+
+        vector<af_array> res(num_arrays);
+        const af_dtype type = first.getType();
+        switch (op) {
+            case AF_BINARY_ADD:
+                allReduce<af_add_t>(res.data(), events, num_arrays, ins, type);
+                break;
+            case AF_BINARY_MUL:
+                allReduce<af_mul_t>(res.data(), events, num_arrays, ins, type);
+                break;
+            case AF_BINARY_MIN:
+                allReduce<af_min_t>(res.data(), events, num_arrays, ins, type);
+                break;
+            case AF_BINARY_MAX:
+                allReduce<af_max_t>(res.data(), events, num_arrays, ins, type);
+                break;
+            default: AF_ERROR("Unsupported reduction", AF_ERR_ARG);
+        }
+        std::copy(res.begin(), res.end(), outs);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
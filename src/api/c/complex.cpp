@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -39,6 +40,7 @@ static inline af_array cplx(const af_array lhs, const af_array rhs,
 
 af_err af_cplx2(af_array *out, const af_array lhs, const af_array rhs,
                 bool batchMode) {
+    AF_API_RANGE_ARRAY(lhs);
     try {
         af_dtype type = implicit(lhs, rhs);
 
@@ -65,6 +67,7 @@ af_err af_cplx2(af_array *out, const af_array lhs, const af_array rhs,
 }
 
 af_err af_cplx(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in);
         af_dtype type         = info.getType();
@@ -93,6 +96,7 @@ af_err af_cplx(af_array *out, const af_array in) {
 }
 
 af_err af_real(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in);
         af_dtype type         = info.getType();
@@ -118,6 +122,7 @@ af_err af_real(af_array *out, const af_array in) {
 }
 
 af_err af_imag(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in);
         af_dtype type         = info.getType();
@@ -145,6 +150,7 @@ af_err af_imag(af_array *out, const af_array in) {
 }
 
 af_err af_conjg(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in);
         af_dtype type         = info.getType();
@@ -170,6 +176,7 @@ af_err af_conjg(af_array *out, const af_array in) {
 }
 
 af_err af_abs(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &in_info = getInfo(in);
         af_dtype in_type         = in_info.getType();
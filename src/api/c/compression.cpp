@@ -0,0 +1,230 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <compression.hpp>
+
+#include <common/DependencyModule.hpp>
+#include <common/err_common.hpp>
+
+#ifdef WITH_LZ4
+#include <lz4.h>
+#endif
+#ifdef WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <string>
+#include <tuple>
+
+using std::string;
+
+namespace {
+
+#ifdef WITH_LZ4
+constexpr std::array<common::Version, 1> lz4Versions = {
+    std::make_tuple(1, 0, 0)};
+
+class LZ4_Module {
+    common::DependencyModule module;
+
+   public:
+    MODULE_MEMBER(LZ4_compressBound);
+    MODULE_MEMBER(LZ4_compress_default);
+    MODULE_MEMBER(LZ4_decompress_safe);
+
+    LZ4_Module()
+        : module({"lz4", "liblz4"}, {""}, {""}, lz4Versions.size(),
+                 lz4Versions.data()) {
+        if (!module.isLoaded()) {
+            string error_message =
+                "Error loading LZ4: " +
+                common::DependencyModule::getErrorMessage() +
+                "\nLZ4 failed to load. Try installing LZ4 or check if LZ4 is "
+                "in the search path.";
+            AF_ERROR(error_message.c_str(), AF_ERR_LOAD_LIB);
+        }
+        MODULE_FUNCTION_INIT(LZ4_compressBound);
+        MODULE_FUNCTION_INIT(LZ4_compress_default);
+        MODULE_FUNCTION_INIT(LZ4_decompress_safe);
+
+        if (!module.symbolsLoaded()) {
+            string error_message =
+                "Error loading LZ4 symbols. ArrayFire was unable to load some "
+                "symbols from the LZ4 library. Please create an issue on the "
+                "ArrayFire repository with information about the installed "
+                "LZ4 and ArrayFire on your system.";
+            AF_ERROR(error_message.c_str(), AF_ERR_LOAD_LIB);
+        }
+    }
+};
+
+LZ4_Module &getLZ4Plugin() {
+    static auto *plugin = new LZ4_Module();
+    return *plugin;
+}
+
+/// LZ4 compresses at most LZ4_MAX_INPUT_SIZE bytes at once
+void checkLZ4Size(const size_t bytes) {
+    if (bytes > LZ4_MAX_INPUT_SIZE) {
+        AF_ERROR("Chunks compressed with LZ4 must be smaller than 2 GB",
+                 AF_ERR_ARG);
+    }
+}
+#endif
+
+#ifdef WITH_ZSTD
+constexpr std::array<common::Version, 1> zstdVersions = {
+    std::make_tuple(1, 0, 0)};
+
+class Zstd_Module {
+    common::DependencyModule module;
+
+   public:
+    MODULE_MEMBER(ZSTD_compress);
+    MODULE_MEMBER(ZSTD_compressBound);
+    MODULE_MEMBER(ZSTD_decompress);
+    MODULE_MEMBER(ZSTD_getErrorName);
+    MODULE_MEMBER(ZSTD_isError);
+
+    Zstd_Module()
+        : module({"zstd", "libzstd"}, {""}, {""}, zstdVersions.size(),
+                 zstdVersions.data()) {
+        if (!module.isLoaded()) {
+            string error_message =
+                "Error loading zstd: " +
+                common::DependencyModule::getErrorMessage() +
+                "\nzstd failed to load. Try installing zstd or check if zstd "
+                "is in the search path.";
+            AF_ERROR(error_message.c_str(), AF_ERR_LOAD_LIB);
+        }
+        MODULE_FUNCTION_INIT(ZSTD_compress);
+        MODULE_FUNCTION_INIT(ZSTD_compressBound);
+        MODULE_FUNCTION_INIT(ZSTD_decompress);
+        MODULE_FUNCTION_INIT(ZSTD_getErrorName);
+        MODULE_FUNCTION_INIT(ZSTD_isError);
+
+        if (!module.symbolsLoaded()) {
+            string error_message =
+                "Error loading zstd symbols. ArrayFire was unable to load "
+                "some symbols from the zstd library. Please create an issue "
+                "on the ArrayFire repository with information about the "
+                "installed zstd and ArrayFire on your system.";
+            AF_ERROR(error_message.c_str(), AF_ERR_LOAD_LIB);
+        }
+    }
+};
+
+Zstd_Module &getZstdPlugin() {
+    static auto *plugin = new Zstd_Module();
+    return *plugin;
+}
+
+/// The default level of the zstd command line tool
+constexpr int ZSTD_LEVEL = 3;
+#endif
+
+[[noreturn]] void notConfigured(const af_compression_type type) {
+    switch (type) {
+        case AF_COMPRESSION_LZ4:
+            AF_ERROR("ArrayFire was built without LZ4 compression",
+                     AF_ERR_NOT_CONFIGURED);
+        case AF_COMPRESSION_ZSTD:
+            AF_ERROR("ArrayFire was built without zstd compression",
+                     AF_ERR_NOT_CONFIGURED);
+        default: AF_ERROR("Unknown compression", AF_ERR_ARG);
+    }
+}
+
+}  // namespace
+
+size_t compressChunkBound(const af_compression_type type, const size_t bytes) {
+    switch (type) {
+        case AF_COMPRESSION_NONE: return bytes;
+#ifdef WITH_LZ4
+        case AF_COMPRESSION_LZ4: {
+            checkLZ4Size(bytes);
+            return getLZ4Plugin().LZ4_compressBound(static_cast<int>(bytes));
+        }
+#endif
+#ifdef WITH_ZSTD
+        case AF_COMPRESSION_ZSTD:
+            return getZstdPlugin().ZSTD_compressBound(bytes);
+#endif
+        default: notConfigured(type);
+    }
+}
+
+size_t compressChunk(const af_compression_type type, char *dst,
+                     const size_t capacity, const char *src,
+                     const size_t bytes) {
+    switch (type) {
+#ifdef WITH_LZ4
+        case AF_COMPRESSION_LZ4: {
+            checkLZ4Size(bytes);
+            const int size = getLZ4Plugin().LZ4_compress_default(
+                src, dst, static_cast<int>(bytes),
+                static_cast<int>(std::min<size_t>(capacity, INT_MAX)));
+            if (size <= 0) {
+                AF_ERROR("LZ4 failed to compress a chunk", AF_ERR_INTERNAL);
+            }
+            return static_cast<size_t>(size);
+        }
+#endif
+#ifdef WITH_ZSTD
+        case AF_COMPRESSION_ZSTD: {
+            Zstd_Module &zstd = getZstdPlugin();
+            const size_t size =
+                zstd.ZSTD_compress(dst, capacity, src, bytes, ZSTD_LEVEL);
+            if (zstd.ZSTD_isError(size)) {
+                string error_message = string("zstd failed to compress a "
+                                              "chunk: ") +
+                                       zstd.ZSTD_getErrorName(size);
+                AF_ERROR(error_message.c_str(), AF_ERR_INTERNAL);
+            }
+            return size;
+        }
+#endif
+        default: notConfigured(type);
+    }
+}
+
+void decompressChunk(const af_compression_type type, char *dst,
+                     const size_t bytes, const char *src,
+                     const size_t src_bytes) {
+    switch (type) {
+#ifdef WITH_LZ4
+        case AF_COMPRESSION_LZ4: {
+            checkLZ4Size(bytes);
+            checkLZ4Size(src_bytes);
+            const int size = getLZ4Plugin().LZ4_decompress_safe(
+                src, dst, static_cast<int>(src_bytes),
+                static_cast<int>(bytes));
+            if (size < 0 || static_cast<size_t>(size) != bytes) {
+                AF_ERROR("Compressed chunk is corrupt", AF_ERR_ARG);
+            }
+            return;
+        }
+#endif
+#ifdef WITH_ZSTD
+        case AF_COMPRESSION_ZSTD: {
+            Zstd_Module &zstd = getZstdPlugin();
+            const size_t size =
+                zstd.ZSTD_decompress(dst, bytes, src, src_bytes);
+            if (zstd.ZSTD_isError(size) || size != bytes) {
+                AF_ERROR("Compressed chunk is corrupt", AF_ERR_ARG);
+            }
+            return;
+        }
+#endif
+        default: notConfigured(type);
+    }
+}
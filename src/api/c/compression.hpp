@@ -0,0 +1,51 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+/// Compression of the chunks of the arrays saved by af_save_array_chunked.
+///
+/// The compression libraries are loaded when they are first used, so
+/// ArrayFire does not depend on them unless compressed chunks are written or
+/// read. The functions throw AF_ERR_NOT_CONFIGURED if ArrayFire was built
+/// without the headers of a library and AF_ERR_LOAD_LIB if the library can
+/// not be loaded.
+#pragma once
+
+#include <af/defines.h>
+
+#include <cstddef>
+
+/// Returns the largest size of \p bytes compressed with \p type
+size_t compressChunkBound(const af_compression_type type, const size_t bytes);
+
+/// Compresses \p bytes of \p src to \p dst
+///
+/// \param[in] type     The compression
+/// \param[out] dst     The compressed data
+/// \param[in] capacity The size of \p dst. It should be at least the size
+///                     returned by compressChunkBound.
+/// \param[in] src      The data to compress
+/// \param[in] bytes    The size of \p src
+///
+/// \returns the size of the compressed data
+size_t compressChunk(const af_compression_type type, char *dst,
+                     const size_t capacity, const char *src,
+                     const size_t bytes);
+
+/// Decompresses a chunk which was compressed by compressChunk
+///
+/// \param[in] type      The compression
+/// \param[out] dst      The decompressed data
+/// \param[in] bytes     The size of the decompressed data
+/// \param[in] src       The compressed data
+/// \param[in] src_bytes The size of \p src
+///
+/// Throws AF_ERR_ARG if the data does not decompress to \p bytes
+void decompressChunk(const af_compression_type type, char *dst,
+                     const size_t bytes, const char *src,
+                     const size_t src_bytes);
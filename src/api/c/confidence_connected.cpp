@@ -9,6 +9,7 @@
 
 #include <af/image.h>
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <cast.hpp>
 #include <common/err_common.hpp>
@@ -188,6 +189,7 @@ af_err af_confidence_cc(af_array* out, const af_array in, const af_array seedx,
                         const af_array seedy, const unsigned radius,
                         const unsigned multiplier, const int iter,
                         const double segmented_value) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& inInfo         = getInfo(in);
         const ArrayInfo& seedxInfo      = getInfo(seedx);
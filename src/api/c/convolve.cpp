@@ -8,21 +8,33 @@
  ********************************************************/
 #include <convolve.hpp>
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <cast.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
+#include <convolve_tuning.hpp>
 #include <fftconvolve.hpp>
 #include <handle.hpp>
+#include <platform.hpp>
 #include <tile.hpp>
+#include <af/array.h>
 #include <af/data.h>
 #include <af/defines.h>
 #include <af/dim4.hpp>
 #include <af/ml.h>
 #include <af/signal.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstdio>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 using af::dim4;
 using common::half;
@@ -37,6 +49,10 @@ using detail::uchar;
 using detail::uint;
 using detail::uintl;
 using detail::ushort;
+using std::ostringstream;
+using std::string;
+using std::unordered_map;
+using std::vector;
 
 template<typename T, typename accT>
 inline af_array convolve(const af_array &s, const af_array &f,
@@ -93,37 +109,58 @@ AF_BATCH_KIND identifyBatchKind(const int rank, const dim4 &sDims,
     return AF_BATCH_UNSUPPORTED;
 }
 
-bool isFreqDomain(const int rank, const af_array &signal, const af_array filter,
-                  af_conv_domain domain) {
-    if (domain == AF_CONV_FREQ) { return true; }
-    if (domain != AF_CONV_AUTO) { return false; }
-
-    const ArrayInfo &sInfo = getInfo(signal);
-    const ArrayInfo &fInfo = getInfo(filter);
-
-    const dim4 &sdims = sInfo.dims();
-    dim4 fdims        = fInfo.dims();
-
-    if (identifyBatchKind(rank, sdims, fdims) == AF_BATCH_DIFF) { return true; }
-
-    int kbatch = 1;
-    for (int i = 3; i >= rank; i--) { kbatch *= fdims[i]; }
-
-    if (kbatch >= 10) { return true; }
+/// Returns true if the spatial kernels support the filter of the convolution
+bool isSpatialSupported(const int rank, const dim4 &sdims, const dim4 &fdims) {
+    if (identifyBatchKind(rank, sdims, fdims) == AF_BATCH_DIFF) {
+        return false;
+    }
     if (rank == 1) {
-        if (fdims[0] > 128) { return true; }
+        if (fdims[0] > 128) { return false; }
     }
     if (rank == 2) {
         // maximum supported size in 2D domain
-        if (fdims[0] > 17 || fdims[1] > 17) { return true; }
+        if (fdims[0] > 17 || fdims[1] > 17) { return false; }
 
         // Maximum supported non square size
-        if (fdims[0] != fdims[1] && fdims[0] > 5) { return true; }
+        if (fdims[0] != fdims[1] && fdims[0] > 5) { return false; }
     }
     if (rank == 3) {
-        if (fdims[0] > 5 || fdims[1] > 5 || fdims[2] > 5) { return true; }
+        if (fdims[0] > 5 || fdims[1] > 5 || fdims[2] > 5) { return false; }
+    }
+    return true;
+}
+
+/// Returns true if af_convolve2_nn computes the convolution. It pads the
+/// signal symmetrically, so only odd filters are centered like the other
+/// methods.
+bool isGemmSupported(const int rank, const af_array &signal,
+                     const af_array &filter, const af_conv_mode mode) {
+    const ArrayInfo &sInfo = getInfo(signal);
+    const ArrayInfo &fInfo = getInfo(filter);
+    const dim4 &fdims      = fInfo.dims();
+
+    const af_dtype stype = sInfo.getType();
+    if (rank != 2 || (stype != f32 && stype != f64) ||
+        fInfo.getType() != stype) {
+        return false;
+    }
+    if (sInfo.dims().ndims() > 2 || fdims.ndims() > 2) { return false; }
+    return mode == AF_CONV_EXPAND || (fdims[0] % 2 == 1 && fdims[1] % 2 == 1);
+}
+
+/// The method of the convolutions with the AF_CONV_AUTO domain which are not
+/// in the tuning table
+ConvolveMethod defaultMethod(const int rank, const dim4 &sdims,
+                             const dim4 &fdims) {
+    if (!isSpatialSupported(rank, sdims, fdims)) {
+        return ConvolveMethod::Frequency;
     }
-    return false;
+
+    int kbatch = 1;
+    for (int i = 3; i >= rank; i--) { kbatch *= fdims[i]; }
+
+    if (kbatch >= 10) { return ConvolveMethod::Frequency; }
+    return ConvolveMethod::Spatial;
 }
 
 af_err convolve(af_array *out, const af_array signal, const af_array filter,
@@ -207,50 +244,317 @@ af_err convolve(af_array *out, const af_array signal, const af_array filter,
     return AF_SUCCESS;
 }
 
+af_err convolve2Gemm(af_array *out, const af_array signal,
+                     const af_array filter, const af_conv_mode mode) {
+    const dim4 &fdims = getInfo(filter).dims();
+    const bool expand = mode == AF_CONV_EXPAND;
+
+    const dim_t strides[]   = {1, 1};
+    const dim_t dilations[] = {1, 1};
+    const dim_t paddings[]  = {expand ? fdims[0] - 1 : fdims[0] / 2,
+                              expand ? fdims[1] - 1 : fdims[1] / 2};
+    return af_convolve2_nn(out, signal, filter, 2, strides, 2, paddings, 2,
+                           dilations);
+}
+
+af_err convolveWithMethod(af_array *out, const af_array signal,
+                          const af_array filter, const af_conv_mode mode,
+                          const int rank, const ConvolveMethod method) {
+    switch (method) {
+        case ConvolveMethod::Frequency:
+            if (rank == 1) {
+                return af_fft_convolve1(out, signal, filter, mode);
+            }
+            if (rank == 2) {
+                return af_fft_convolve2(out, signal, filter, mode);
+            }
+            return af_fft_convolve3(out, signal, filter, mode);
+        case ConvolveMethod::Gemm:
+            return convolve2Gemm(out, signal, filter, mode);
+        default: return convolve(out, signal, filter, mode, rank);
+    }
+}
+
+/// Returns the name of the active device, which is part of the keys of the
+/// tuning table so that the table can be shared by several machines
+const string &activeDeviceName() {
+    thread_local unordered_map<unsigned, string> names;
+    const unsigned device = detail::getActiveDeviceId();
+
+    auto iter = names.find(device);
+    if (iter == names.end()) {
+        char name[256]     = {};
+        char platform[256] = {};
+        char toolkit[256]  = {};
+        char compute[256]  = {};
+        detail::devprop(name, platform, toolkit, compute);
+        iter = names.emplace(device, string(name) + " " + compute).first;
+    }
+    return iter->second;
+}
+
+string convolveKey(const int rank, const af_array signal, const af_array filter,
+                   const af_conv_mode mode) {
+    const ArrayInfo &sInfo = getInfo(signal);
+    const ArrayInfo &fInfo = getInfo(filter);
+
+    ostringstream key;
+    key << detail::getBackend() << ":" << activeDeviceName() << ":" << rank
+        << ":" << sInfo.getType() << ":" << fInfo.getType() << ":" << mode;
+    for (int i = 0; i < AF_MAX_DIMS; ++i) { key << ":" << sInfo.dims()[i]; }
+    for (int i = 0; i < AF_MAX_DIMS; ++i) { key << ":" << fInfo.dims()[i]; }
+    return key.str();
+}
+
+/// Returns the time of one convolution with \p method, or infinity if the
+/// method fails
+double timeConvolve(const af_array signal, const af_array filter,
+                    const af_conv_mode mode, const int rank,
+                    const ConvolveMethod method) {
+    using clock = std::chrono::steady_clock;
+    const int device = static_cast<int>(detail::getActiveDeviceId());
+
+    // The first run creates the kernels and the plans of the method
+    af_array result = 0;
+    if (convolveWithMethod(&result, signal, filter, mode, rank, method) !=
+        AF_SUCCESS) {
+        return std::numeric_limits<double>::infinity();
+    }
+    af_release_array(result);
+    detail::sync(device);
+
+    const auto start = clock::now();
+    if (convolveWithMethod(&result, signal, filter, mode, rank, method) !=
+        AF_SUCCESS) {
+        return std::numeric_limits<double>::infinity();
+    }
+    af_eval(result);
+    detail::sync(device);
+    const std::chrono::duration<double> elapsed = clock::now() - start;
+    af_release_array(result);
+    return elapsed.count();
+}
+
+/// Benchmarks the methods which support the convolution
+ConvolveMethod tuneConvolve(const af_array signal, const af_array filter,
+                            const af_conv_mode mode, const int rank) {
+    const dim4 &sdims = getInfo(signal).dims();
+    const dim4 &fdims = getInfo(filter).dims();
+
+    vector<ConvolveMethod> methods = {ConvolveMethod::Frequency};
+    if (isSpatialSupported(rank, sdims, fdims)) {
+        methods.push_back(ConvolveMethod::Spatial);
+    }
+    if (isGemmSupported(rank, signal, filter, mode)) {
+        methods.push_back(ConvolveMethod::Gemm);
+    }
+
+    ConvolveMethod fastest = defaultMethod(rank, sdims, fdims);
+    double fastestTime     = std::numeric_limits<double>::infinity();
+    for (const ConvolveMethod method : methods) {
+        const double time = timeConvolve(signal, filter, mode, rank, method);
+        if (time < fastestTime) {
+            fastest     = method;
+            fastestTime = time;
+        }
+    }
+    return fastest;
+}
+
+/// The longest filters of the separable kernels of the GPU backends
+constexpr dim_t SEPARABLE_MAX_FILTER_LEN = 31;
+
+/// The smallest 2D filters which are checked for separability. The check
+/// copies the filter to the host, which costs more than the convolution with
+/// smaller filters.
+constexpr dim_t SEPARABLE_MIN_FILTER_ELEMENTS = 25;
+
+/// Sets \p colFilter and \p rowFilter to vectors whose outer product is
+/// \p filter if it has rank one, such as the filters of gaussianKernel. The
+/// columns of the filter are multiples of the column of its largest value.
+template<typename T>
+bool separableFactors(af_array *colFilter, af_array *rowFilter,
+                      const af_array filter) {
+    const dim4 &fdims = getInfo(filter).dims();
+    const dim_t rows  = fdims[0];
+    const dim_t cols  = fdims[1];
+
+    vector<T> values(rows * cols);
+    AF_CHECK(af_get_data_ptr(values.data(), filter));
+
+    const dim_t pivot =
+        std::max_element(values.begin(), values.end(),
+                         [](T a, T b) { return std::abs(a) < std::abs(b); }) -
+        values.begin();
+    const T maxValue = values[pivot];
+    if (maxValue == T(0)) { return false; }
+
+    const dim_t pi = pivot % rows;
+    const dim_t pj = pivot / rows;
+    vector<T> col(values.begin() + pj * rows, values.begin() + (pj + 1) * rows);
+    vector<T> row(cols);
+    for (dim_t j = 0; j < cols; ++j) {
+        row[j] = values[pi + j * rows] / maxValue;
+    }
+
+    const T tolerance =
+        16 * std::numeric_limits<T>::epsilon() * std::abs(maxValue);
+    for (dim_t j = 0; j < cols; ++j) {
+        for (dim_t i = 0; i < rows; ++i) {
+            if (std::abs(values[i + j * rows] - col[i] * row[j]) > tolerance) {
+                return false;
+            }
+        }
+    }
+
+    const af_dtype type = getInfo(filter).getType();
+    AF_CHECK(af_create_array(colFilter, col.data(), 1, &rows, type));
+    AF_CHECK(af_create_array(rowFilter, row.data(), 1, &cols, type));
+    return true;
+}
+
+/// Returns true if \p filter is large enough for its factors to be worth
+/// finding. It only reads the metadata of the filter, so the filters which
+/// fail it are not copied to the host.
+bool isSeparableCandidate(const af_array filter) {
+    const ArrayInfo &fInfo = getInfo(filter);
+    const dim4 &fdims      = fInfo.dims();
+    const af_dtype ftype   = fInfo.getType();
+    return (ftype == f32 || ftype == f64) && fdims.ndims() == 2 &&
+           fdims.elements() >= SEPARABLE_MIN_FILTER_ELEMENTS &&
+           fdims[0] <= SEPARABLE_MAX_FILTER_LEN &&
+           fdims[1] <= SEPARABLE_MAX_FILTER_LEN;
+}
+
+/// Convolves with the factors of \p filter when it is a single separable 2D
+/// filter, which costs fdims[0] + fdims[1] operations per value instead of
+/// fdims[0] * fdims[1]. Returns false if the filter is not separable. The
+/// filter must pass isSeparableCandidate.
+bool convolveSeparable(af_array *out, const af_array signal,
+                       const af_array filter, const af_conv_mode mode) {
+    const af_dtype ftype = getInfo(filter).getType();
+
+    af_array colFilter = 0;
+    af_array rowFilter = 0;
+    const bool separable =
+        ftype == f32 ? separableFactors<float>(&colFilter, &rowFilter, filter)
+                     : separableFactors<double>(&colFilter, &rowFilter, filter);
+    if (!separable) { return false; }
+
+    const af_err err =
+        af_convolve2_sep(out, colFilter, rowFilter, signal, mode);
+    AF_CHECK(af_release_array(colFilter));
+    AF_CHECK(af_release_array(rowFilter));
+    AF_CHECK(err);
+    return true;
+}
+
+/// Convolves with the method of \p domain. The method of AF_CONV_AUTO is
+/// found in the tuning table, benchmarked if AF_CONVOLVE_AUTOTUNE is set or
+/// chosen by the size of the filter.
+af_err convolveInDomain(af_array *out, const af_array signal,
+                        const af_array filter, const af_conv_mode mode,
+                        const af_conv_domain domain, const int rank) {
+    if (domain == AF_CONV_FREQ) {
+        return convolveWithMethod(out, signal, filter, mode, rank,
+                                  ConvolveMethod::Frequency);
+    }
+
+    // The empty arrays are handled by convolve before any other method
+    const dim4 &sdims = getInfo(signal).dims();
+    const dim4 &fdims = getInfo(filter).dims();
+    if (sdims.ndims() == 0 || fdims.ndims() == 0) {
+        return convolve(out, signal, filter, mode, rank);
+    }
+
+    if (rank == 2 && isSeparableCandidate(filter) &&
+        convolveSeparable(out, signal, filter, mode)) {
+        return AF_SUCCESS;
+    }
+    if (domain != AF_CONV_AUTO) {
+        return convolve(out, signal, filter, mode, rank);
+    }
+
+    const string key      = convolveKey(rank, signal, filter, mode);
+    ConvolveMethod method = ConvolveMethod::Spatial;
+    if (!findConvolveMethod(key, method)) {
+        if (isConvolveAutotuneEnabled()) {
+            method = tuneConvolve(signal, filter, mode, rank);
+            cacheConvolveMethod(key, method);
+        } else {
+            method = defaultMethod(rank, sdims, fdims);
+        }
+    }
+
+    // The imported tables may come from other versions
+    if ((method == ConvolveMethod::Spatial &&
+         !isSpatialSupported(rank, sdims, fdims)) ||
+        (method == ConvolveMethod::Gemm &&
+         !isGemmSupported(rank, signal, filter, mode))) {
+        method = defaultMethod(rank, sdims, fdims);
+    }
+    return convolveWithMethod(out, signal, filter, mode, rank, method);
+}
+
 af_err af_convolve1(af_array *out, const af_array signal, const af_array filter,
                     const af_conv_mode mode, af_conv_domain domain) {
+    AF_API_RANGE_ARRAY(signal);
     try {
-        if (isFreqDomain(1, signal, filter, domain)) {
-            return af_fft_convolve1(out, signal, filter, mode);
-        }
-        return convolve(out, signal, filter, mode, 1);
+        return convolveInDomain(out, signal, filter, mode, domain, 1);
     }
     CATCHALL;
 }
 
 af_err af_convolve2(af_array *out, const af_array signal, const af_array filter,
                     const af_conv_mode mode, af_conv_domain domain) {
+    AF_API_RANGE_ARRAY(signal);
     try {
         if (getInfo(signal).dims().ndims() < 2 ||
             getInfo(filter).dims().ndims() < 2) {
             return af_convolve1(out, signal, filter, mode, domain);
         }
-        if (isFreqDomain(2, signal, filter, domain)) {
-            return af_fft_convolve2(out, signal, filter, mode);
-        }
-        return convolve(out, signal, filter, mode, 2);
+        return convolveInDomain(out, signal, filter, mode, domain, 2);
     }
     CATCHALL;
 }
 
 af_err af_convolve3(af_array *out, const af_array signal, const af_array filter,
                     const af_conv_mode mode, af_conv_domain domain) {
+    AF_API_RANGE_ARRAY(signal);
     try {
         if (getInfo(signal).dims().ndims() < 3 ||
             getInfo(filter).dims().ndims() < 3) {
             return af_convolve2(out, signal, filter, mode, domain);
         }
-        if (isFreqDomain(3, signal, filter, domain)) {
-            return af_fft_convolve3(out, signal, filter, mode);
-        }
-        return convolve(out, signal, filter, mode, 3);
+        return convolveInDomain(out, signal, filter, mode, domain, 3);
     }
     CATCHALL;
 }
 
+af_err af_export_convolve_tuning(const char *path) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(0, path != nullptr);
+        exportConvolveTuning(path);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_import_convolve_tuning(const char *path) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(0, path != nullptr);
+        importConvolveTuning(path);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
 af_err af_convolve2_sep(af_array *out, const af_array col_filter,
                         const af_array row_filter, const af_array signal,
                         const af_conv_mode mode) {
+    AF_API_RANGE_ARRAY(col_filter);
     try {
         const ArrayInfo &sInfo = getInfo(signal);
 
@@ -335,6 +639,7 @@ af_err af_convolve2_nn(af_array *out, const af_array signal,
                        const dim_t *strides, const unsigned padding_dims,
                        const dim_t *paddings, const unsigned dilation_dims,
                        const dim_t *dilations) {
+    AF_API_RANGE_ARRAY(signal);
     try {
         const ArrayInfo &sInfo = getInfo(signal);
         const ArrayInfo &fInfo = getInfo(filter);
@@ -404,6 +709,7 @@ af_err af_convolve2_gradient_nn(
     const dim_t *strides, const unsigned padding_dims, const dim_t *paddings,
     const unsigned dilation_dims, const dim_t *dilations,
     af_conv_gradient_type grad_type) {
+    AF_API_RANGE_ARRAY(incoming_gradient);
     try {
         const ArrayInfo &iinfo = getInfo(incoming_gradient);
         const af::dim4 &iDims  = iinfo.dims();
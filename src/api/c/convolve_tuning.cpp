@@ -0,0 +1,171 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <convolve_tuning.hpp>
+
+#include <common/defines.hpp>
+#include <common/err_common.hpp>
+#include <common/util.hpp>
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+using std::ifstream;
+using std::lock_guard;
+using std::mutex;
+using std::ofstream;
+using std::ostringstream;
+using std::string;
+using std::unordered_map;
+
+namespace {
+
+using MethodMap = unordered_map<string, ConvolveMethod>;
+
+struct TuningTable {
+    mutex lock;
+    MethodMap methods;
+};
+
+const char *methodName(const ConvolveMethod method) {
+    switch (method) {
+        case ConvolveMethod::Spatial: return "spatial";
+        case ConvolveMethod::Frequency: return "frequency";
+        default: return "gemm";
+    }
+}
+
+bool parseMethod(const string &name, ConvolveMethod &method) {
+    if (name == "spatial") {
+        method = ConvolveMethod::Spatial;
+    } else if (name == "frequency") {
+        method = ConvolveMethod::Frequency;
+    } else if (name == "gemm") {
+        method = ConvolveMethod::Gemm;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/// Reads the lines of a tuning file, which are a key and a method separated
+/// by a tab. The keys contain device names, which may contain spaces. The
+/// later lines of a key replace the earlier ones.
+bool readMethods(const string &path, MethodMap &methods) {
+    ifstream file(path);
+    if (!file) { return false; }
+
+    string line;
+    while (std::getline(file, line)) {
+        const size_t tab = line.rfind('\t');
+        ConvolveMethod method;
+        if (tab == string::npos || !parseMethod(line.substr(tab + 1), method)) {
+            continue;
+        }
+        methods[line.substr(0, tab)] = method;
+    }
+    return true;
+}
+
+string formatMethod(const string &key, const ConvolveMethod method) {
+    return key + "\t" + methodName(method) + "\n";
+}
+
+string tuningFilePath() {
+    const string &directory = getCacheDirectory();
+    if (directory.empty()) { return string(); }
+    return directory + AF_PATH_SEPARATOR + "convolve_tuning.txt";
+}
+
+/// The table starts with the methods saved by earlier runs
+TuningTable &tuningTable() {
+    static auto *table = [] {
+        auto *retVal = new TuningTable();
+        if (isConvolveAutotuneEnabled()) {
+            const string path = tuningFilePath();
+            if (!path.empty()) { readMethods(path, retVal->methods); }
+        }
+        return retVal;
+    }();
+    return *table;
+}
+
+}  // namespace
+
+bool isConvolveAutotuneEnabled() {
+    static const bool enabled = getEnvVar("AF_CONVOLVE_AUTOTUNE") == "1";
+    return enabled;
+}
+
+bool findConvolveMethod(const string &key, ConvolveMethod &method) {
+    TuningTable &table = tuningTable();
+    lock_guard<mutex> lock(table.lock);
+    auto iter = table.methods.find(key);
+    if (iter == table.methods.end()) { return false; }
+    method = iter->second;
+    return true;
+}
+
+void cacheConvolveMethod(const string &key, const ConvolveMethod method) {
+    TuningTable &table = tuningTable();
+    lock_guard<mutex> lock(table.lock);
+    table.methods[key] = method;
+
+    if (!isConvolveAutotuneEnabled()) { return; }
+    const string path = tuningFilePath();
+    if (path.empty()) { return; }
+    // Each line is appended at once so that the lines of other processes
+    // do not interleave
+    ofstream file(path, std::ios::app);
+    file << formatMethod(key, method) << std::flush;
+}
+
+void exportConvolveTuning(const string &path) {
+    ostringstream contents;
+    {
+        TuningTable &table = tuningTable();
+        lock_guard<mutex> lock(table.lock);
+        for (const auto &entry : table.methods) {
+            contents << formatMethod(entry.first, entry.second);
+        }
+    }
+
+    // The file is replaced at once so that it is never read half written
+    const string tempPath = path + "." + makeTempFilename();
+    {
+        ofstream file(tempPath, std::ios::trunc);
+        file << contents.str();
+        if (!file.flush()) {
+            removeFile(tempPath);
+            AF_ERROR("Failed to write the convolution tuning table",
+                     AF_ERR_RUNTIME);
+        }
+    }
+    if (!renameFile(tempPath, path)) {
+        removeFile(tempPath);
+        AF_ERROR("Failed to write the convolution tuning table",
+                 AF_ERR_RUNTIME);
+    }
+}
+
+void importConvolveTuning(const string &path) {
+    MethodMap methods;
+    if (!readMethods(path, methods)) {
+        AF_ERROR("Failed to read the convolution tuning table", AF_ERR_ARG);
+    }
+
+    TuningTable &table = tuningTable();
+    lock_guard<mutex> lock(table.lock);
+    for (const auto &entry : methods) {
+        table.methods[entry.first] = entry.second;
+    }
+}
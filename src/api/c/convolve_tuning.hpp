@@ -0,0 +1,47 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+/// The tuning table of the convolutions with the AF_CONV_AUTO domain.
+///
+/// The table maps the shapes, type and device of a convolution to the
+/// fastest of its methods. It is shared by every thread and device and is
+/// saved in the cache directory when AF_CONVOLVE_AUTOTUNE is set, so that
+/// each convolution is only benchmarked once.
+#pragma once
+
+#include <string>
+
+/// The methods af_convolve1, af_convolve2 and af_convolve3 choose from
+enum class ConvolveMethod {
+    /// The spatial convolution kernels
+    Spatial,
+    /// The FFT based convolution
+    Frequency,
+    /// The unwrap and GEMM or cuDNN convolution of af_convolve2_nn
+    Gemm
+};
+
+/// Returns true if the convolutions which are not in the tuning table are
+/// benchmarked (see AF_CONVOLVE_AUTOTUNE)
+bool isConvolveAutotuneEnabled();
+
+/// Finds the method of the convolution of \p key in the tuning table
+///
+/// \returns true if the method was found
+bool findConvolveMethod(const std::string &key, ConvolveMethod &method);
+
+/// Adds the method of the convolution of \p key to the tuning table
+void cacheConvolveMethod(const std::string &key, const ConvolveMethod method);
+
+/// Writes the tuning table to \p path
+void exportConvolveTuning(const std::string &path);
+
+/// Adds the methods in the file \p path to the tuning table. The imported
+/// methods replace the methods of the same convolutions.
+void importConvolveTuning(const std::string &path);
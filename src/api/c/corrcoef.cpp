@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <cast.hpp>
@@ -62,6 +63,7 @@ static To corrcoef(const af_array& X, const af_array& Y) {
 // NOLINTNEXTLINE
 af_err af_corrcoef(double* realVal, double* imagVal, const af_array X,
                    const af_array Y) {
+    AF_API_RANGE_ARRAY(X);
     UNUSED(imagVal);  // TODO(umar): implement for complex types
     try {
         const ArrayInfo& xInfo = getInfo(X);
@@ -7,7 +7,9 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
+#include <common/bfloat16.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <copy.hpp>
@@ -26,6 +28,7 @@
 #include <af/util.h>
 
 using af::dim4;
+using common::bfloat16;
 using common::half;
 using detail::cdouble;
 using detail::cfloat;
@@ -56,6 +59,7 @@ dim4 verifyDims(const unsigned ndims, const dim_t *const dims) {
 // Strong Exception Guarantee
 af_err af_constant(af_array *result, const double value, const unsigned ndims,
                    const dim_t *const dims, const af_dtype type) {
+    AF_API_RANGE();
     try {
         af_array out;
         AF_CHECK(af_init());
@@ -77,6 +81,9 @@ af_err af_constant(af_array *result, const double value, const unsigned ndims,
             case s16: out = createHandleFromValue<short>(d, value); break;
             case u16: out = createHandleFromValue<ushort>(d, value); break;
             case f16: out = createHandleFromValue<half>(d, value); break;
+            case bf16:
+                out = createHandleFromValue<bfloat16>(d, value);
+                break;
             default: TYPE_ERROR(4, type);
         }
         std::swap(*result, out);
@@ -95,6 +102,7 @@ static inline af_array createCplx(dim4 dims, const Ti real, const Ti imag) {
 af_err af_constant_complex(af_array *result, const double real,
                            const double imag, const unsigned ndims,
                            const dim_t *const dims, af_dtype type) {
+    AF_API_RANGE();
     try {
         af_array out;
         AF_CHECK(af_init());
@@ -116,6 +124,7 @@ af_err af_constant_complex(af_array *result, const double real,
 
 af_err af_constant_long(af_array *result, const intl val, const unsigned ndims,
                         const dim_t *const dims) {
+    AF_API_RANGE();
     try {
         af_array out;
         AF_CHECK(af_init());
@@ -134,6 +143,7 @@ af_err af_constant_long(af_array *result, const intl val, const unsigned ndims,
 
 af_err af_constant_ulong(af_array *result, const uintl val,
                          const unsigned ndims, const dim_t *const dims) {
+    AF_API_RANGE();
     try {
         af_array out;
         AF_CHECK(af_init());
@@ -157,6 +167,7 @@ static inline af_array identity_(const af::dim4 &dims) {
 
 af_err af_identity(af_array *out, const unsigned ndims, const dim_t *const dims,
                    const af_dtype type) {
+    AF_API_RANGE();
     try {
         af_array result;
         AF_CHECK(af_init());
@@ -199,6 +210,7 @@ static inline af_array range_(const dim4 &d, const int seq_dim) {
 // Strong Exception Guarantee
 af_err af_range(af_array *result, const unsigned ndims, const dim_t *const dims,
                 const int seq_dim, const af_dtype type) {
+    AF_API_RANGE();
     try {
         af_array out;
         AF_CHECK(af_init());
@@ -234,6 +246,7 @@ static inline af_array iota_(const dim4 &dims, const dim4 &tile_dims) {
 af_err af_iota(af_array *result, const unsigned ndims, const dim_t *const dims,
                const unsigned t_ndims, const dim_t *const tdims,
                const af_dtype type) {
+    AF_API_RANGE();
     try {
         af_array out;
         AF_CHECK(af_init());
@@ -276,6 +289,7 @@ static inline af_array diagExtract(const af_array in, const int num) {
 }
 
 af_err af_diag_create(af_array *out, const af_array in, const int num) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &in_info = getInfo(in);
         DIM_ASSERT(1, in_info.ndims() <= 2);
@@ -315,6 +329,7 @@ af_err af_diag_create(af_array *out, const af_array in, const int num) {
 }
 
 af_err af_diag_extract(af_array *out, const af_array in, const int num) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &in_info = getInfo(in);
         af_dtype type            = in_info.getType();
@@ -361,6 +376,7 @@ inline af_array triangle(const af_array in, const bool is_upper,
 }
 
 af_err af_lower(af_array *out, const af_array in, bool is_unit_diag) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in);
         af_dtype type         = info.getType();
@@ -390,6 +406,7 @@ af_err af_lower(af_array *out, const af_array in, bool is_unit_diag) {
 }
 
 af_err af_upper(af_array *out, const af_array in, bool is_unit_diag) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in);
         af_dtype type         = info.getType();
@@ -427,6 +444,7 @@ inline af_array pad(const af_array in, const dim4 &lPad, const dim4 &uPad,
 af_err af_pad(af_array *out, const af_array in, const unsigned begin_ndims,
               const dim_t *const begin_dims, const unsigned end_ndims,
               const dim_t *const end_dims, const af_border_type pad_type) {
+    AF_API_RANGE_ARRAY(in);
     try {
         DIM_ASSERT(2, begin_ndims > 0 && begin_ndims <= 4);
         DIM_ASSERT(4, end_ndims > 0 && end_ndims <= 4);
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <cast.hpp>
@@ -106,25 +107,57 @@ std::vector<af_seq> calcPadInfo(dim4& inLPad, dim4& psfLPad, dim4& inUPad,
     return index;
 }
 
+/// Returns the squared norm of \p v, which is read back to the host
+template<typename T>
+double squaredNorm(const Array<T>& v) {
+    auto sq = arithOp<T, af_mul_t>(v, v, v.dims());
+    return detail::reduce_all<af_add_t, T, T>(sq);
+}
+
+/// Runs at most \p iters Richardson-Lucy iterations and returns the number
+/// of iterations which were run. \p P and \p Pc are the transforms of the
+/// PSF and of its transpose, scaled by the normalization of the inverse
+/// transforms, so every product, division and update below is one JIT node
+/// which is evaluated by the transform which reads it.
 template<typename T, typename CT>
-void richardsonLucy(Array<T>& currentEstimate, const Array<T>& in,
-                    const Array<CT>& P, const Array<CT>& Pc,
-                    const unsigned iters, const float normFactor,
-                    const dim4 odims) {
+unsigned richardsonLucy(Array<T>& currentEstimate, const Array<T>& in,
+                        const Array<CT>& P, const Array<CT>& Pc,
+                        const unsigned iters, const double tol,
+                        const unsigned checkInterval, const dim4 odims) {
+    const double bound = tol * tol;
     for (unsigned i = 0; i < iters; ++i) {
         auto fft1  = fft_r2c<CT, T>(currentEstimate, BASE_DIM);
         auto cmul1 = arithOp<CT, af_mul_t>(fft1, P, P.dims());
-        auto ifft1 = fft_c2r<CT, T>(cmul1, normFactor, odims, BASE_DIM);
+        auto ifft1 = fft_c2r<CT, T>(cmul1, 1.0, odims, BASE_DIM);
         auto div1  = arithOp<T, af_div_t>(in, ifft1, in.dims());
         auto fft2  = fft_r2c<CT, T>(div1, BASE_DIM);
         auto cmul2 = arithOp<CT, af_mul_t>(fft2, Pc, Pc.dims());
-        auto ifft2 = fft_c2r<CT, T>(cmul2, normFactor, odims, BASE_DIM);
+        auto ifft2 = fft_c2r<CT, T>(cmul2, 1.0, odims, BASE_DIM);
 
-        currentEstimate =
+        auto update =
             arithOp<T, af_mul_t>(currentEstimate, ifft2, ifft2.dims());
+
+        // The relative change of the estimate, x (c - 1), is only read back
+        // every checkInterval iterations
+        if (bound > 0 && (i + 1) % checkInterval == 0) {
+            update.eval();
+            auto change = arithOp<T, af_sub_t>(update, currentEstimate,
+                                               update.dims());
+            const double prev = squaredNorm(currentEstimate);
+            currentEstimate   = update;
+            if (squaredNorm(change) <= bound * prev) { return i + 1; }
+            continue;
+        }
+        currentEstimate = update;
     }
+    return iters;
 }
 
+/// Computes \p iters Landweber iterations in frequency space. An iteration
+/// is the affine map X -> q X + r, with the real factor q = 1 - a |P|^2 and
+/// r = a Pc I. The map of \p iters iterations, X -> A X + B, is composed
+/// from the maps of the powers of 2 of the iteration, so only
+/// log2(iters) steps are built into the JIT tree of the result.
 template<typename T, typename CT>
 void landweber(Array<T>& currentEstimate, const Array<T>& in,
                const Array<CT>& P, const Array<CT>& Pc, const unsigned iters,
@@ -132,28 +165,43 @@ void landweber(Array<T>& currentEstimate, const Array<T>& in,
                const dim4 odims) {
     const dim4& dims = P.dims();
 
-    auto I        = fft_r2c<CT, T>(in, BASE_DIM);
-    auto Pn       = complexNorm<T, CT>(P);
-    auto ONE      = createValueArray(dims, scalar<T>(1.0));
-    auto alpha    = createValueArray(dims, scalar<T>(relaxFactor));
-    auto alphaC   = cast<CT>(alpha);
-    auto prod     = arithOp<T, af_mul_t>(alpha, Pn, dims);
-    auto lhsFac   = arithOp<T, af_sub_t>(ONE, prod, dims);
-    auto lhs      = cast<CT>(lhsFac);
-    auto rhsFac   = arithOp<CT, af_mul_t>(Pc, I, dims);
-    auto rhs      = arithOp<CT, af_mul_t>(rhsFac, alphaC, dims);
-    auto iterTemp = I;
-
-    for (unsigned i = 0; i < iters; ++i) {
-        auto mul = arithOp<CT, af_mul_t>(iterTemp, lhs, dims);
-        iterTemp = arithOp<CT, af_add_t>(mul, rhs, dims);
+    auto I      = fft_r2c<CT, T>(in, BASE_DIM);
+    auto Pn     = complexNorm<T, CT>(P);
+    auto ONE    = createValueArray(dims, scalar<T>(1.0));
+    auto alpha  = createValueArray(dims, scalar<T>(relaxFactor));
+    auto alphaC = cast<CT>(alpha);
+    auto prod   = arithOp<T, af_mul_t>(alpha, Pn, dims);
+    auto q      = arithOp<T, af_sub_t>(ONE, prod, dims);
+    auto rhsFac = arithOp<CT, af_mul_t>(Pc, I, dims);
+    auto r      = arithOp<CT, af_mul_t>(rhsFac, alphaC, dims);
+
+    // The maps are powers of the same map, so they commute
+    Array<T> A  = ONE;
+    Array<CT> B = createValueArray(dims, scalar<CT>(0));
+    for (unsigned n = iters; n > 0; n >>= 1) {
+        if (n & 1) {
+            A = arithOp<T, af_mul_t>(A, q, dims);
+            B = arithOp<CT, af_add_t>(
+                arithOp<CT, af_mul_t>(cast<CT>(q), B, dims), r, dims);
+        }
+        if (n > 1) {
+            r = arithOp<CT, af_add_t>(
+                arithOp<CT, af_mul_t>(cast<CT>(q), r, dims), r, dims);
+            q = arithOp<T, af_mul_t>(q, q, dims);
+            r.eval();
+            q.eval();
+        }
     }
-    currentEstimate = fft_c2r<CT, T>(iterTemp, normFactor, odims, BASE_DIM);
+    auto mul        = arithOp<CT, af_mul_t>(cast<CT>(A), I, dims);
+    auto estimate   = arithOp<CT, af_add_t>(mul, B, dims);
+    currentEstimate = fft_c2r<CT, T>(estimate, normFactor, odims, BASE_DIM);
 }
 
 template<typename InputType, typename RealType = float>
-af_array iterDeconv(const af_array in, const af_array ker, const uint iters,
-                    const float rfactor, const af_iterative_deconv_algo algo) {
+af_array iterDeconv(unsigned* iterations, const af_array in,
+                    const af_array ker, const uint iters, const float rfactor,
+                    const af_iterative_deconv_algo algo, const double tol,
+                    const unsigned checkInterval) {
     using T    = RealType;
     using CT   = typename std::conditional<std::is_same<T, double>::value,
                                          cdouble, cfloat>::type;
@@ -181,22 +229,85 @@ af_array iterDeconv(const af_array in, const af_array ker, const uint iters,
     Array<T> currentEstimate = paddedIn;
     const double normFactor  = 1 / static_cast<double>(nElems);
 
+    unsigned count = iters;
     switch (algo) {
-        case AF_ITERATIVE_DECONV_RICHARDSONLUCY:
-            richardsonLucy(currentEstimate, paddedIn, P, Pc, iters, normFactor,
-                           odims);
-            break;
+        case AF_ITERATIVE_DECONV_RICHARDSONLUCY: {
+            // The normalization of the inverse transforms is applied to the
+            // spectra once, instead of to the results of every iteration
+            auto NORM = createValueArray(P.dims(), scalar<CT>(normFactor));
+            auto Pn   = arithOp<CT, af_mul_t>(P, NORM, P.dims());
+            auto Pcn  = arithOp<CT, af_mul_t>(Pc, NORM, Pc.dims());
+            Pn.eval();
+            Pcn.eval();
+            count = richardsonLucy(currentEstimate, paddedIn, Pn, Pcn, iters,
+                                   tol, checkInterval, odims);
+        } break;
         case AF_ITERATIVE_DECONV_LANDWEBER:
         default:
             landweber(currentEstimate, paddedIn, P, Pc, iters, rfactor,
                       normFactor, odims);
     }
+    if (iterations) { *iterations = count; }
     return getHandle(createSubArray<T>(currentEstimate, index));
 }
 
+af_err af_iterative_deconv_v2(af_array* out, unsigned* iterations,
+                              const af_array in, const af_array ker,
+                              const unsigned max_iterations,
+                              const float relax_factor,
+                              const af_iterative_deconv_algo algo,
+                              const double tol, const unsigned check_interval) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const ArrayInfo& inputInfo  = getInfo(in);
+        const dim4& inputDims       = inputInfo.dims();
+        const ArrayInfo& kernelInfo = getInfo(ker);
+        const dim4& kernelDims      = kernelInfo.dims();
+
+        DIM_ASSERT(2, (inputDims.ndims() == 2));
+        DIM_ASSERT(3, (kernelDims.ndims() == 2));
+        ARG_ASSERT(4, (max_iterations > 0));
+        ARG_ASSERT(5, std::isfinite(relax_factor));
+        ARG_ASSERT(5, (relax_factor > 0));
+        ARG_ASSERT(6, (algo == AF_ITERATIVE_DECONV_DEFAULT ||
+                       algo == AF_ITERATIVE_DECONV_LANDWEBER ||
+                       algo == AF_ITERATIVE_DECONV_RICHARDSONLUCY));
+        ARG_ASSERT(7, std::isfinite(tol) && tol >= 0);
+        ARG_ASSERT(8, (check_interval > 0));
+        af_array res   = 0;
+        unsigned iters = max_iterations;
+        float rfac     = relax_factor;
+
+        af_dtype inputType = inputInfo.getType();
+        switch (inputType) {
+            case f32:
+                res = iterDeconv<float>(iterations, in, ker, iters, rfac, algo,
+                                        tol, check_interval);
+                break;
+            case s16:
+                res = iterDeconv<short>(iterations, in, ker, iters, rfac, algo,
+                                        tol, check_interval);
+                break;
+            case u16:
+                res = iterDeconv<ushort>(iterations, in, ker, iters, rfac,
+                                         algo, tol, check_interval);
+                break;
+            case u8:
+                res = iterDeconv<uchar>(iterations, in, ker, iters, rfac, algo,
+                                        tol, check_interval);
+                break;
+            default: TYPE_ERROR(2, inputType);
+        }
+        std::swap(res, *out);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
 af_err af_iterative_deconv(af_array* out, const af_array in, const af_array ker,
                            const unsigned iterations, const float relax_factor,
                            const af_iterative_deconv_algo algo) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& inputInfo  = getInfo(in);
         const dim4& inputDims       = inputInfo.dims();
@@ -218,15 +329,21 @@ af_err af_iterative_deconv(af_array* out, const af_array in, const af_array ker,
         af_dtype inputType = inputInfo.getType();
         switch (inputType) {
             case f32:
-                res = iterDeconv<float>(in, ker, iters, rfac, algo);
+                res = iterDeconv<float>(nullptr, in, ker, iters, rfac, algo, 0,
+                                        1);
                 break;
             case s16:
-                res = iterDeconv<short>(in, ker, iters, rfac, algo);
+                res = iterDeconv<short>(nullptr, in, ker, iters, rfac, algo, 0,
+                                        1);
                 break;
             case u16:
-                res = iterDeconv<ushort>(in, ker, iters, rfac, algo);
+                res = iterDeconv<ushort>(nullptr, in, ker, iters, rfac, algo,
+                                         0, 1);
+                break;
+            case u8:
+                res = iterDeconv<uchar>(nullptr, in, ker, iters, rfac, algo, 0,
+                                        1);
                 break;
-            case u8: res = iterDeconv<uchar>(in, ker, iters, rfac, algo); break;
             default: TYPE_ERROR(1, inputType);
         }
         std::swap(res, *out);
@@ -304,6 +421,7 @@ af_array invDeconv(const af_array in, const af_array ker, const float gamma,
 
 af_err af_inverse_deconv(af_array* out, const af_array in, const af_array psf,
                          const float gamma, const af_inverse_deconv_algo algo) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& inputInfo = getInfo(in);
         const dim4& inputDims      = inputInfo.dims();
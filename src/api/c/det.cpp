@@ -7,74 +7,126 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
+#include <arith.hpp>
 #include <backend.hpp>
+#include <cast.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
+#include <complex.hpp>
 #include <copy.hpp>
 #include <diagonal.hpp>
 #include <handle.hpp>
+#include <logic.hpp>
 #include <lu.hpp>
 #include <math.hpp>
+#include <range.hpp>
+#include <reduce.hpp>
+#include <select.hpp>
+#include <unary.hpp>
 #include <af/array.h>
 #include <af/defines.h>
 #include <af/lapack.h>
+#include <af/traits.hpp>
 
 using af::dim4;
+using detail::arithOp;
 using detail::Array;
 using detail::cdouble;
 using detail::cfloat;
-using detail::createEmptyArray;
+using detail::createSelectNode;
+using detail::createValueArray;
 using detail::imag;
+using detail::logicOp;
 using detail::real;
+using detail::reduce;
+using detail::reduce_all;
 using detail::scalar;
+using detail::unaryOp;
+
+// Returns the diagonal of the LU factorization of each matrix of A, as a
+// N x 1 x P x Q array, with the sign of its row swaps folded into it. The
+// determinants are the products of its columns, which are reduced on the
+// device.
+template<typename T>
+static Array<T> signedLUDiagonal(const Array<T> &A) {
+    Array<T> LU            = detail::copyArray<T>(A);
+    const Array<int> pivot = detail::lu_inplace(LU, false);
+    const Array<T> D       = detail::diagExtract(LU, 0);
+
+    // The LAPACK pivots are 1 based. Each row i whose pivot is not i + 1 was
+    // swapped, which flips the sign of the determinant.
+    const dim4 &dims = D.dims();
+    Array<int> rows  = arithOp<int, af_add_t>(
+        detail::range<int>(dims, 0), createValueArray<int>(dims, 1), dims);
+    Array<char> swapped = logicOp<int, af_neq_t>(pivot, rows, dims);
+    Array<T> sign       = createSelectNode<T>(
+        swapped, createValueArray<T>(dims, scalar<T>(-1)),
+        createValueArray<T>(dims, scalar<T>(1)), dims);
+    return arithOp<T, af_mul_t>(D, sign, dims);
+}
 
 template<typename T>
 T det(const af_array a) {
-    using namespace detail;
     const Array<T> A = getArray<T>(a);
 
-    const int num = A.dims()[0];
+    if (A.dims()[0] == 0) { return scalar<T>(1.0); }
 
-    if (num == 0) {
-        T res = scalar<T>(1.0);
-        return res;
-    }
+    return reduce_all<af_mul_t, T, T>(signedLUDiagonal(A));
+}
 
-    std::vector<T> hD(num);
-    std::vector<int> hP(num);
+template<typename T>
+static af_array detBatched(const af_array a) {
+    const Array<T> A = getArray<T>(a);
+    const dim4 &dims = A.dims();
 
-    Array<T> D       = createEmptyArray<T>(dim4());
-    Array<int> pivot = createEmptyArray<int>(dim4());
+    if (dims[0] == 0) {
+        return getHandle(
+            createValueArray<T>(dim4(1, 1, dims[2], dims[3]), scalar<T>(1)));
+    }
 
-    // Free memory as soon as possible
-    {
-        Array<T> A_copy = copyArray<T>(A);
+    return getHandle(reduce<af_mul_t, T, T>(signedLUDiagonal(A), 0));
+}
 
-        Array<int> pivot = lu_inplace(A_copy, false);
-        copyData(&hP[0], pivot);
+template<typename T>
+static void logDet(af_array *logAbs, af_array *sign, const af_array a) {
+    using BT = typename af::dtype_traits<T>::base_type;
 
-        Array<T> D = diagExtract(A_copy, 0);
-        copyData(&hD[0], D);
-    }
+    const Array<T> A = getArray<T>(a);
 
-    bool is_neg = false;
-    T res       = scalar<T>(is_neg ? -1 : 1);
-    for (int i = 0; i < num; i++) {
-        res = res * hD[i];
-        is_neg ^= (hP[i] != (i + 1));
+    if (A.dims()[0] == 0) {
+        const dim4 oDims(1, 1, A.dims()[2], A.dims()[3]);
+        *logAbs = getHandle(createValueArray<BT>(oDims, scalar<BT>(0)));
+        *sign   = getHandle(createValueArray<T>(oDims, scalar<T>(1)));
+        return;
     }
 
-    if (is_neg) { res = res * scalar<T>(-1); }
-
-    return res;
+    const Array<T> D     = signedLUDiagonal(A);
+    const dim4 &dims     = D.dims();
+    const Array<BT> absD = detail::abs<BT, T>(D);
+
+    // The signs of the diagonal are d / |d|, and 0 for the zeros of the
+    // singular matrices, whose logarithm is -Inf
+    Array<char> zero = logicOp<BT, af_eq_t>(
+        absD, createValueArray<BT>(dims, scalar<BT>(0)), dims);
+    Array<T> divisor = createSelectNode<T>(
+        zero, createValueArray<T>(dims, scalar<T>(1)),
+        detail::cast<T, BT>(absD), dims);
+    Array<T> signs = arithOp<T, af_div_t>(D, divisor, dims);
+
+    *logAbs =
+        getHandle(reduce<af_add_t, BT, BT>(unaryOp<BT, af_log_t>(absD), 0));
+    *sign = getHandle(reduce<af_mul_t, T, T>(signs, 0));
 }
 
 af_err af_det(double *real_val, double *imag_val, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &i_info = getInfo(in);
 
         if (i_info.ndims() > 2) {
-            AF_ERROR("solve can not be used in batch mode", AF_ERR_BATCH);
+            AF_ERROR("det can not be used in batch mode, use af_det_batched",
+                     AF_ERR_BATCH);
         }
 
         af_dtype type = i_info.getType();
@@ -111,3 +163,55 @@ af_err af_det(double *real_val, double *imag_val, const af_array in) {
 
     return AF_SUCCESS;
 }
+
+af_err af_det_batched(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const ArrayInfo &i_info = getInfo(in);
+        af_dtype type           = i_info.getType();
+
+        DIM_ASSERT(1, i_info.dims()[0] == i_info.dims()[1]);
+        ARG_ASSERT(1, i_info.isFloating());  // Only floating and complex types
+        ARG_ASSERT(0, out != nullptr);
+
+        af_array output = 0;
+        switch (type) {
+            case f32: output = detBatched<float>(in); break;
+            case f64: output = detBatched<double>(in); break;
+            case c32: output = detBatched<cfloat>(in); break;
+            case c64: output = detBatched<cdouble>(in); break;
+            default: TYPE_ERROR(1, type);
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_log_det(af_array *log_abs, af_array *sign, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const ArrayInfo &i_info = getInfo(in);
+        af_dtype type           = i_info.getType();
+
+        DIM_ASSERT(2, i_info.dims()[0] == i_info.dims()[1]);
+        ARG_ASSERT(2, i_info.isFloating());  // Only floating and complex types
+        ARG_ASSERT(0, log_abs != nullptr);
+        ARG_ASSERT(1, sign != nullptr);
+
+        af_array l = 0, s = 0;
+        switch (type) {
+            case f32: logDet<float>(&l, &s, in); break;
+            case f64: logDet<double>(&l, &s, in); break;
+            case c32: logDet<cfloat>(&l, &s, in); break;
+            case c64: logDet<cdouble>(&l, &s, in); break;
+            default: TYPE_ERROR(2, type);
+        }
+        std::swap(*log_abs, l);
+        std::swap(*sign, s);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
@@ -8,9 +8,15 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <api_range.hpp>
 #include <backend.hpp>
+#include <common/PrecisionMode.hpp>
+#include <common/bfloat16.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
+#include <common/jit/JitHeuristics.hpp>
+#include <common/jit/JitStats.hpp>
+#include <common/kernel_cache.hpp>
 #include <common/util.hpp>
 #include <handle.hpp>
 #include <platform.hpp>
@@ -21,9 +27,14 @@
 #include <af/version.h>
 
 #include <cstring>
+#include <memory>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using af::dim4;
+using common::bfloat16;
 using common::half;
 using detail::Array;
 using detail::cdouble;
@@ -45,6 +56,7 @@ using detail::uintl;
 using detail::ushort;
 
 af_err af_set_backend(const af_backend bknd) {
+    AF_API_RANGE();
     try {
         if (bknd != getBackend() && bknd != AF_BACKEND_DEFAULT) {
             return AF_ERR_ARG;
@@ -56,11 +68,13 @@ af_err af_set_backend(const af_backend bknd) {
 }
 
 af_err af_get_backend_count(unsigned* num_backends) {
+    AF_API_RANGE();
     *num_backends = 1;
     return AF_SUCCESS;
 }
 
 af_err af_get_available_backends(int* result) {
+    AF_API_RANGE();
     try {
         *result = getBackend();
     }
@@ -69,6 +83,7 @@ af_err af_get_available_backends(int* result) {
 }
 
 af_err af_get_backend_id(af_backend* result, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         if (in) {
             const ArrayInfo& info = getInfo(in, false, false);
@@ -82,6 +97,7 @@ af_err af_get_backend_id(af_backend* result, const af_array in) {
 }
 
 af_err af_get_device_id(int* device, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         if (in) {
             const ArrayInfo& info = getInfo(in, false, false);
@@ -95,11 +111,13 @@ af_err af_get_device_id(int* device, const af_array in) {
 }
 
 af_err af_get_active_backend(af_backend* result) {
+    AF_API_RANGE();
     *result = static_cast<af_backend>(getBackend());
     return AF_SUCCESS;
 }
 
 af_err af_init() {
+    AF_API_RANGE();
     try {
         thread_local std::once_flag flag;
         std::call_once(flag, []() { getDeviceInfo(); });
@@ -108,7 +126,32 @@ af_err af_init() {
     return AF_SUCCESS;
 }
 
+af_err af_init_async() {
+    AF_API_RANGE();
+    try {
+        // The device manager is created by the first call of getDeviceCount,
+        // and each device is set up by the first call of setDevice on it.
+        // Both are thread-safe, so the threads which need the devices while
+        // this thread sets them up wait for it.
+        std::thread([]() {
+            try {
+                const int ndevices = getDeviceCount();
+                for (int device = 0; device < ndevices; ++device) {
+                    setDevice(device);
+                    detail::sync(device);
+                }
+            } catch (...) {
+                // The errors are reported by the next call which needs the
+                // devices
+            }
+        }).detach();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
 af_err af_info() {
+    AF_API_RANGE();
     try {
         printf("%s", getDeviceInfo().c_str());  // NOLINT
     }
@@ -117,6 +160,7 @@ af_err af_info() {
 }
 
 af_err af_info_string(char** str, const bool verbose) {
+    AF_API_RANGE();
     UNUSED(verbose);  // TODO(umar): Add something useful
     try {
         std::string infoStr = getDeviceInfo();
@@ -135,6 +179,7 @@ af_err af_info_string(char** str, const bool verbose) {
 
 af_err af_device_info(char* d_name, char* d_platform, char* d_toolkit,
                       char* d_compute) {
+    AF_API_RANGE();
     try {
         devprop(d_name, d_platform, d_toolkit, d_compute);
     }
@@ -143,6 +188,7 @@ af_err af_device_info(char* d_name, char* d_platform, char* d_toolkit,
 }
 
 af_err af_get_dbl_support(bool* available, const int device) {
+    AF_API_RANGE();
     try {
         *available = isDoubleSupported(device);
     }
@@ -151,6 +197,7 @@ af_err af_get_dbl_support(bool* available, const int device) {
 }
 
 af_err af_get_half_support(bool* available, const int device) {
+    AF_API_RANGE();
     try {
         *available = isHalfSupported(device);
     }
@@ -159,6 +206,7 @@ af_err af_get_half_support(bool* available, const int device) {
 }
 
 af_err af_get_device_count(int* nDevices) {
+    AF_API_RANGE();
     try {
         *nDevices = getDeviceCount();
     }
@@ -168,6 +216,7 @@ af_err af_get_device_count(int* nDevices) {
 }
 
 af_err af_get_device(int* device) {
+    AF_API_RANGE();
     try {
         *device = static_cast<int>(getActiveDeviceId());
     }
@@ -176,6 +225,7 @@ af_err af_get_device(int* device) {
 }
 
 af_err af_set_device(const int device) {
+    AF_API_RANGE();
     try {
         ARG_ASSERT(0, device >= 0);
         if (setDevice(device) < 0) {
@@ -202,6 +252,7 @@ af_err af_set_device(const int device) {
 }
 
 af_err af_sync(const int device) {
+    AF_API_RANGE();
     try {
         int dev = device == -1 ? static_cast<int>(getActiveDeviceId()) : device;
         detail::sync(dev);
@@ -221,6 +272,7 @@ static inline void sparseEval(af_array arr) {
 }
 
 af_err af_eval(af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         const ArrayInfo& info = getInfo(arr, false);
         af_dtype type         = info.getType();
@@ -248,6 +300,7 @@ af_err af_eval(af_array arr) {
                 case s16: eval<short>(arr); break;
                 case u16: eval<ushort>(arr); break;
                 case f16: eval<half>(arr); break;
+                case bf16: eval<bfloat16>(arr); break;
                 default: TYPE_ERROR(0, type);
             }
         }
@@ -270,22 +323,37 @@ static inline void evalMultiple(int num, af_array* arrayPtrs) {
 }
 
 af_err af_eval_multiple(int num, af_array* arrays) {
+    AF_API_RANGE();
     try {
         const ArrayInfo& info = getInfo(arrays[0]);
         af_dtype type         = info.getType();
         const dim4& dims      = info.dims();
+        bool mixed            = false;
+        bool sameDims         = true;
 
         for (int i = 1; i < num; i++) {
             const ArrayInfo& currInfo = getInfo(arrays[i]);
 
-            // FIXME: This needs to be removed when new functionality is added
-            if (type != currInfo.getType()) {
-                AF_ERROR("All arrays must be of same type", AF_ERR_TYPE);
-            }
+            mixed |= type != currInfo.getType();
+            sameDims &= dims == currInfo.dims();
+        }
 
-            if (dims != currInfo.dims()) {
-                AF_ERROR("All arrays must be of same size", AF_ERR_SIZE);
+        // Arrays of different types and sizes are evaluated individually.
+        // The backends batch the arrays of the same type and different sizes.
+        if (mixed && !sameDims) {
+            for (int i = 0; i < num; i++) { AF_CHECK(af_eval(arrays[i])); }
+            return AF_SUCCESS;
+        }
+
+        // Arrays of different types are written by the same kernel
+        if (mixed) {
+            std::vector<std::pair<af_dtype, void*>> typed;
+            typed.reserve(num);
+            for (int i = 0; i < num; i++) {
+                typed.emplace_back(getInfo(arrays[i]).getType(), arrays[i]);
             }
+            detail::evalMultiple(typed);
+            return AF_SUCCESS;
         }
 
         switch (type) {
@@ -302,6 +370,7 @@ af_err af_eval_multiple(int num, af_array* arrays) {
             case s16: evalMultiple<short>(num, arrays); break;
             case u16: evalMultiple<ushort>(num, arrays); break;
             case f16: evalMultiple<half>(num, arrays); break;
+            case bf16: evalMultiple<bfloat16>(num, arrays); break;
             default: TYPE_ERROR(0, type);
         }
     }
@@ -311,6 +380,7 @@ af_err af_eval_multiple(int num, af_array* arrays) {
 }
 
 af_err af_set_manual_eval_flag(bool flag) {
+    AF_API_RANGE();
     try {
         bool& backendFlag = evalFlag();
         backendFlag       = !flag;
@@ -320,6 +390,7 @@ af_err af_set_manual_eval_flag(bool flag) {
 }
 
 af_err af_get_manual_eval_flag(bool* flag) {
+    AF_API_RANGE();
     try {
         bool backendFlag = evalFlag();
         *flag            = !backendFlag;
@@ -329,6 +400,7 @@ af_err af_get_manual_eval_flag(bool* flag) {
 }
 
 af_err af_get_kernel_cache_directory(size_t* length, char* path) {
+    AF_API_RANGE();
     try {
         std::string& cache_path = getCacheDirectory();
         if (path == nullptr) {
@@ -350,7 +422,154 @@ af_err af_get_kernel_cache_directory(size_t* length, char* path) {
     return AF_SUCCESS;
 }
 
+af_err af_prewarm_kernels(unsigned* num_modules) {
+    AF_API_RANGE();
+    try {
+        unsigned count = 0;
+#if !defined(AF_CPU)
+        count = common::prewarmModules(getActiveDeviceId());
+#endif
+        if (num_modules) { *num_modules = count; }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+namespace {
+/// The kernels loaded by a call to af_prewarm_kernels_async
+struct KernelBatch {
+#if !defined(AF_CPU)
+    common::ModuleBatch modules;
+#endif
+};
+}  // namespace
+
+af_err af_prewarm_kernels_async(af_kernel_batch* batch,
+                                const char* const* keys,
+                                const unsigned num_keys, const int device) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(0, batch != nullptr);
+        ARG_ASSERT(1, keys != nullptr || num_keys == 0);
+        ARG_ASSERT(3, device < getDeviceCount());
+
+        std::unique_ptr<KernelBatch> out(new KernelBatch());
+#if !defined(AF_CPU)
+        const int dev = device < 0 ? static_cast<int>(getActiveDeviceId())
+                                   : device;
+        std::vector<std::string> moduleKeys;
+        if (keys) { moduleKeys.assign(keys, keys + num_keys); }
+        if (keys == nullptr || !moduleKeys.empty()) {
+            out->modules = common::enqueueModules(dev, moduleKeys);
+        }
+#endif
+        *batch = out.release();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_wait_kernel_batch(unsigned* num_modules,
+                            const af_kernel_batch batch) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(1, batch != nullptr);
+        unsigned count = 0;
+#if !defined(AF_CPU)
+        count = common::waitModules(static_cast<KernelBatch*>(batch)->modules);
+#endif
+        if (num_modules) { *num_modules = count; }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_release_kernel_batch(af_kernel_batch batch) {
+    AF_API_RANGE();
+    try {
+        delete static_cast<KernelBatch*>(batch);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_set_jit_heuristic(af_jit_heuristic_fn fn, void* user_data) {
+    AF_API_RANGE();
+    try {
+        common::setJitHeuristic(fn, user_data);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+static int getJitStatsDevice(const int device) {
+    if (device < 0) { return static_cast<int>(getActiveDeviceId()); }
+    ARG_ASSERT(1, device < getDeviceCount());
+    return device;
+}
+
+af_err af_get_jit_stats(af_jit_stats* stats, const int device) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(0, stats != nullptr);
+        common::getJitStats(stats, getJitStatsDevice(device));
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_reset_jit_stats(const int device) {
+    AF_API_RANGE();
+    try {
+        common::resetJitStats(getJitStatsDevice(device));
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_set_precision_mode(const af_precision_mode mode) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(0,
+                   mode >= AF_PRECISION_DEFAULT && mode <= AF_PRECISION_FAST);
+        common::setPrecisionMode(mode);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_precision_mode(af_precision_mode* mode) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(0, mode != nullptr);
+        *mode = common::getPrecisionMode();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_begin_precision_scope(const af_precision_mode mode) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(0,
+                   mode >= AF_PRECISION_DEFAULT && mode <= AF_PRECISION_FAST);
+        common::beginPrecisionScope(mode);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_end_precision_scope() {
+    AF_API_RANGE();
+    try {
+        common::endPrecisionScope();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
 af_err af_set_kernel_cache_directory(const char* path, int override_env) {
+    AF_API_RANGE();
     try {
         ARG_ASSERT(path != nullptr, 1);
         if (override_env) {
@@ -0,0 +1,329 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <dlpack.hpp>
+
+#include <Array.hpp>
+#include <Event.hpp>
+#include <api_range.hpp>
+#include <backend.hpp>
+#include <common/ExternalRelease.hpp>
+#include <common/bfloat16.hpp>
+#include <common/err_common.hpp>
+#include <common/half.hpp>
+#include <handle.hpp>
+#include <memory.hpp>
+#include <platform.hpp>
+#include <af/array.h>
+#include <af/backend.h>
+#include <af/device.h>
+#include <af/dim4.hpp>
+#include <af/internal.h>
+
+#include <memory>
+#include <utility>
+
+using af::dim4;
+using common::ExternalRelease;
+using common::bfloat16;
+using common::half;
+using detail::Array;
+using detail::cdouble;
+using detail::cfloat;
+using detail::createSharedDataArray;
+using detail::getActiveDeviceId;
+using detail::getRawPtr;
+using detail::intl;
+using detail::memLock;
+using detail::signalNativeQueue;
+using detail::uchar;
+using detail::uint;
+using detail::uintl;
+using detail::ushort;
+using detail::waitForNativeQueue;
+using dlpack::DLDataType;
+using dlpack::DLDevice;
+using dlpack::DLManagedTensor;
+using dlpack::DLTensor;
+using std::move;
+using std::unique_ptr;
+
+namespace {
+
+DLDataType toDLType(const af_dtype type) {
+    using namespace dlpack;  // NOLINT(google-build-using-namespace)
+    switch (type) {
+        case f32: return {kDLFloat, 32, 1};
+        case f64: return {kDLFloat, 64, 1};
+        case c32: return {kDLComplex, 64, 1};
+        case c64: return {kDLComplex, 128, 1};
+        case s32: return {kDLInt, 32, 1};
+        case u32: return {kDLUInt, 32, 1};
+        case s64: return {kDLInt, 64, 1};
+        case u64: return {kDLUInt, 64, 1};
+        case s16: return {kDLInt, 16, 1};
+        case u16: return {kDLUInt, 16, 1};
+        case u8: return {kDLUInt, 8, 1};
+        case b8: return {kDLBool, 8, 1};
+        case f16: return {kDLFloat, 16, 1};
+        case bf16: return {kDLBfloat, 16, 1};
+        default: TYPE_ERROR(1, type);
+    }
+}
+
+af_dtype toAfType(const DLDataType &type) {
+    using namespace dlpack;  // NOLINT(google-build-using-namespace)
+    if (type.lanes == 1) {
+        switch (type.code) {
+            case kDLFloat:
+                if (type.bits == 16) { return f16; }
+                if (type.bits == 32) { return f32; }
+                if (type.bits == 64) { return f64; }
+                break;
+            case kDLComplex:
+                if (type.bits == 64) { return c32; }
+                if (type.bits == 128) { return c64; }
+                break;
+            case kDLInt:
+                if (type.bits == 16) { return s16; }
+                if (type.bits == 32) { return s32; }
+                if (type.bits == 64) { return s64; }
+                break;
+            case kDLUInt:
+                if (type.bits == 8) { return u8; }
+                if (type.bits == 16) { return u16; }
+                if (type.bits == 32) { return u32; }
+                if (type.bits == 64) { return u64; }
+                break;
+            case kDLBool:
+                if (type.bits == 8) { return b8; }
+                break;
+            case kDLBfloat:
+                if (type.bits == 16) { return bf16; }
+                break;
+            default: break;
+        }
+    }
+    AF_ERROR("The type of the tensor is not supported", AF_ERR_TYPE);
+}
+
+/// Returns the DLPack device of the ArrayFire device \p device
+DLDevice toDLDevice(const int device) {
+#if defined(AF_CUDA)
+    return {dlpack::kDLCUDA, detail::getDeviceNativeId(device)};
+#elif defined(AF_OPENCL)
+    return {dlpack::kDLOpenCL, device};
+#else
+    UNUSED(device);
+    return {dlpack::kDLCPU, 0};
+#endif
+}
+
+/// Returns true when the kernels of the active device can read and write
+/// the memory of \p device
+bool isAccessible(const DLDevice &device) {
+    using namespace dlpack;  // NOLINT(google-build-using-namespace)
+    const int type = device.device_type;
+#if defined(AF_CUDA)
+    const int active = detail::getDeviceNativeId(getActiveDeviceId());
+    return type == kDLCUDAHost || type == kDLCUDAManaged ||
+           (type == kDLCUDA && device.device_id == active);
+#elif defined(AF_OPENCL)
+    return type == kDLOpenCL && device.device_id == getActiveDeviceId();
+#else
+    return type == kDLCPU || type == kDLCUDAHost;
+#endif
+}
+
+/// An exported array. The handle keeps the buffer alive and its user lock
+/// keeps the memory manager from reusing it until the consumer calls the
+/// deleter of the tensor.
+struct ExportedArray {
+    DLManagedTensor tensor;
+    af_array array;
+    int64_t shape[AF_MAX_DIMS];
+    int64_t strides[AF_MAX_DIMS];
+};
+
+void releaseExported(DLManagedTensor *self) {
+    auto *exported = static_cast<ExportedArray *>(self->manager_ctx);
+
+    // The consumer can release the tensor while another device is active.
+    // The errors cannot be reported from here.
+    int active = 0, device = 0;
+    af_get_device(&active);
+    af_get_device_id(&device, exported->array);
+    if (device != active) { af_set_device(device); }
+    af_unlock_array(exported->array);
+    af_release_array(exported->array);
+    if (device != active) { af_set_device(active); }
+
+    delete exported;
+}
+
+template<typename T>
+DLManagedTensor *exportArray(const af_array arr, void *stream) {
+    const Array<T> &in = getArray<T>(arr);
+    in.eval();
+
+    unique_ptr<ExportedArray> exported(new ExportedArray());
+    AF_CHECK(af_retain_array(&exported->array, arr));
+    memLock(in.getData().get());
+    exported->tensor.manager_ctx = exported.get();
+    exported->tensor.deleter     = releaseExported;
+    unique_ptr<DLManagedTensor, void (*)(DLManagedTensor *)> out(
+        &exported.release()->tensor, releaseExported);
+
+    // The first dimension of the array is the last one of the tensor
+    auto *ctx           = static_cast<ExportedArray *>(out->manager_ctx);
+    const dim4 &dims    = in.dims();
+    const dim4 &strides = in.strides();
+    const int ndims     = std::max<int>(in.ndims(), 1);
+    for (int i = 0; i < ndims; ++i) {
+        ctx->shape[ndims - 1 - i]   = dims[i];
+        ctx->strides[ndims - 1 - i] = strides[i];
+    }
+
+    DLTensor &tensor   = out->dl_tensor;
+    tensor.data        = getRawPtr(in);
+    tensor.device      = toDLDevice(in.getDevId());
+    tensor.ndim        = ndims;
+    tensor.dtype       = toDLType(in.getType());
+    tensor.shape       = ctx->shape;
+    tensor.strides     = ctx->strides;
+    tensor.byte_offset = in.getOffset() * sizeof(T);
+
+    // The consumer reads the buffer after the kernels which wrote it
+    if (stream) {
+        signalNativeQueue(stream);
+    } else {
+        detail::sync(getActiveDeviceId());
+    }
+    return out.release();
+}
+
+/// Returns the array which uses the buffer of \p managed. The deleter of
+/// \p managed is called once the array and its copies are released.
+template<typename T>
+af_array importTensor(DLManagedTensor *managed) {
+    const DLTensor &tensor = managed->dl_tensor;
+    const int ndims        = tensor.ndim;
+
+    // The last dimension of the tensor is the first one of the array. The
+    // strides of the dimensions of size 1 are not used, and are made compact.
+    dim4 dims(1, 1, 1, 1);
+    dim4 strides(1, 1, 1, 1);
+    for (int i = 0; i < AF_MAX_DIMS; ++i) {
+        if (i < ndims) { dims[i] = tensor.shape[ndims - 1 - i]; }
+        const dim_t compact = i == 0 ? 1 : strides[i - 1] * dims[i - 1];
+        strides[i]          = (i < ndims && tensor.strides && dims[i] != 1)
+                                  ? tensor.strides[ndims - 1 - i]
+                                  : compact;
+        ARG_ASSERT(1, dims[i] >= 0 && strides[i] > 0);
+    }
+    if (strides[0] != 1) {
+        AF_ERROR("The last dimension of the tensor is not contiguous",
+                 AF_ERR_ARG);
+    }
+    ARG_ASSERT(1, tensor.byte_offset % sizeof(T) == 0);
+    const dim_t offset = tensor.byte_offset / sizeof(T);
+
+    auto release = [managed]() {
+        if (managed->deleter) { managed->deleter(managed); }
+    };
+#if defined(AF_OPENCL)
+    detail::Buffer_ptr data(
+        new cl::Buffer(static_cast<cl_mem>(tensor.data), true),
+        ExternalRelease<cl::Buffer>{[release](cl::Buffer *buffer) {
+            delete buffer;
+            release();
+        }});
+#else
+    std::shared_ptr<T> data(
+        static_cast<T *>(tensor.data),
+        ExternalRelease<T>{[release](T * /*unused*/) { release(); }});
+#endif
+    return getHandle(
+        createSharedDataArray<T>(dims, strides, offset, move(data)));
+}
+
+}  // namespace
+
+af_err af_from_dlpack(af_array *arr, void *tensor, void *stream) {
+    AF_API_RANGE();
+    try {
+        AF_CHECK(af_init());
+        ARG_ASSERT(0, arr != nullptr);
+        ARG_ASSERT(1, tensor != nullptr);
+
+        auto *managed = static_cast<DLManagedTensor *>(tensor);
+        const DLTensor &in = managed->dl_tensor;
+        DIM_ASSERT(1, in.ndim >= 0 && in.ndim <= AF_MAX_DIMS);
+        if (!isAccessible(in.device)) {
+            AF_ERROR("The tensor is not on the active device", AF_ERR_DEVICE);
+        }
+        const af_dtype type = toAfType(in.dtype);
+
+        // The kernels of ArrayFire run after the work of the producer
+        if (stream) { waitForNativeQueue(stream); }
+
+        af_array res = 0;
+        switch (type) {
+            case f32: res = importTensor<float>(managed); break;
+            case f64: res = importTensor<double>(managed); break;
+            case c32: res = importTensor<cfloat>(managed); break;
+            case c64: res = importTensor<cdouble>(managed); break;
+            case s32: res = importTensor<int>(managed); break;
+            case u32: res = importTensor<uint>(managed); break;
+            case s64: res = importTensor<intl>(managed); break;
+            case u64: res = importTensor<uintl>(managed); break;
+            case s16: res = importTensor<short>(managed); break;
+            case u16: res = importTensor<ushort>(managed); break;
+            case u8: res = importTensor<uchar>(managed); break;
+            case b8: res = importTensor<char>(managed); break;
+            case f16: res = importTensor<half>(managed); break;
+            case bf16: res = importTensor<bfloat16>(managed); break;
+            default: TYPE_ERROR(1, type);
+        }
+        std::swap(*arr, res);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_to_dlpack(void **tensor, const af_array arr, void *stream) {
+    AF_API_RANGE_ARRAY(arr);
+    try {
+        ARG_ASSERT(0, tensor != nullptr);
+        const ArrayInfo &info = getInfo(arr, false);
+        ARG_ASSERT(1, !info.isSparse());
+
+        DLManagedTensor *res = nullptr;
+        switch (info.getType()) {
+            case f32: res = exportArray<float>(arr, stream); break;
+            case f64: res = exportArray<double>(arr, stream); break;
+            case c32: res = exportArray<cfloat>(arr, stream); break;
+            case c64: res = exportArray<cdouble>(arr, stream); break;
+            case s32: res = exportArray<int>(arr, stream); break;
+            case u32: res = exportArray<uint>(arr, stream); break;
+            case s64: res = exportArray<intl>(arr, stream); break;
+            case u64: res = exportArray<uintl>(arr, stream); break;
+            case s16: res = exportArray<short>(arr, stream); break;
+            case u16: res = exportArray<ushort>(arr, stream); break;
+            case u8: res = exportArray<uchar>(arr, stream); break;
+            case b8: res = exportArray<char>(arr, stream); break;
+            case f16: res = exportArray<half>(arr, stream); break;
+            case bf16: res = exportArray<bfloat16>(arr, stream); break;
+            default: TYPE_ERROR(1, info.getType());
+        }
+        *tensor = res;
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
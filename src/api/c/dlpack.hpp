@@ -0,0 +1,68 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+/// The structures of the DLPack tensors exchanged with the other libraries.
+/// Their layout is the one of DLManagedTensor in dlpack.h, whose version 0.8
+/// is used by the current frameworks.
+namespace dlpack {
+
+/// The values of DLDeviceType
+enum DeviceType : int32_t {
+    kDLCPU         = 1,
+    kDLCUDA        = 2,
+    kDLCUDAHost    = 3,
+    kDLOpenCL      = 4,
+    kDLCUDAManaged = 13,
+};
+
+/// The values of DLDataTypeCode
+enum DataTypeCode : uint8_t {
+    kDLInt     = 0,
+    kDLUInt    = 1,
+    kDLFloat   = 2,
+    kDLBfloat  = 4,
+    kDLComplex = 5,
+    kDLBool    = 6,
+};
+
+struct DLDevice {
+    int32_t device_type;
+    int32_t device_id;
+};
+
+struct DLDataType {
+    uint8_t code;
+    uint8_t bits;
+    uint16_t lanes;
+};
+
+/// A row major tensor. The last dimension of a tensor is the first
+/// dimension of an array. \p strides is null for compact tensors, and is
+/// counted in elements.
+struct DLTensor {
+    void *data;
+    DLDevice device;
+    int32_t ndim;
+    DLDataType dtype;
+    int64_t *shape;
+    int64_t *strides;
+    uint64_t byte_offset;
+};
+
+struct DLManagedTensor {
+    DLTensor dl_tensor;
+    void *manager_ctx;
+    void (*deleter)(DLManagedTensor *self);
+};
+
+}  // namespace dlpack
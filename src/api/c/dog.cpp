@@ -8,20 +8,25 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
 #include <convolve.hpp>
+#include <copy.hpp>
 #include <handle.hpp>
 #include <af/defines.h>
 #include <af/dim4.hpp>
 #include <af/image.h>
 #include <af/vision.h>
 
+#include <algorithm>
+
 using af::dim4;
 using detail::arithOp;
 using detail::Array;
 using detail::convolve;
+using detail::padArrayBorders;
 using detail::uchar;
 using detail::uint;
 using detail::ushort;
@@ -40,11 +45,21 @@ static af_array dog(const af_array& in, const int radius1, const int radius2) {
 
     AF_BATCH_KIND bkind = iDims[2] > 1 ? AF_BATCH_LHS : AF_BATCH_NONE;
 
-    Array<accT> smth1 =
-        convolve<accT, accT>(input, castArray<accT>(g1), bkind, 2, false);
-    Array<accT> smth2 =
-        convolve<accT, accT>(input, castArray<accT>(g2), bkind, 2, false);
-    Array<accT> retVal = arithOp<accT, af_sub_t>(smth1, smth2, iDims);
+    // The difference of the convolutions is the convolution with the
+    // difference of the kernels, so the image is filtered by one pass
+    // without the two smoothed temporaries. The smaller kernel is zero
+    // padded to the size of the larger one around the same center.
+    const int radius = std::max(radius1, radius2);
+    const dim4 kDims(2 * radius + 1, 2 * radius + 1);
+    const dim4 pad1(radius - radius1, radius - radius1, 0, 0);
+    const dim4 pad2(radius - radius2, radius - radius2, 0, 0);
+    Array<accT> k1 = padArrayBorders<accT>(castArray<accT>(g1), pad1, pad1,
+                                           AF_PAD_ZERO);
+    Array<accT> k2 = padArrayBorders<accT>(castArray<accT>(g2), pad2, pad2,
+                                           AF_PAD_ZERO);
+    Array<accT> kernel = arithOp<accT, af_sub_t>(k1, k2, kDims);
+
+    Array<accT> retVal = convolve<accT, accT>(input, kernel, bkind, 2, false);
 
     AF_CHECK(af_release_array(g1));
     AF_CHECK(af_release_array(g2));
@@ -54,6 +69,7 @@ static af_array dog(const af_array& in, const int radius1, const int radius2) {
 
 af_err af_dog(af_array* out, const af_array in, const int radius1,
               const int radius2) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& info = getInfo(in);
         dim4 inDims           = info.dims();
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <common/err_common.hpp>
 #include <af/device.h>
 #include <af/exception.h>
@@ -36,6 +37,7 @@ void af_get_last_error(char **str, dim_t *len) {
 }
 
 af_err af_set_enable_stacktrace(int is_enabled) {
+    AF_API_RANGE();
     common::is_stacktrace_enabled() = is_enabled;
 
     return AF_SUCCESS;
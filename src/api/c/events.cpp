@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <events.hpp>
 
 #include <Event.hpp>
@@ -15,7 +16,8 @@
 #include <af/event.h>
 
 using detail::block;
-using detail::createEvent;
+using detail::createTimingEvent;
+using detail::elapsedTime;
 using detail::enqueueWaitOnActiveQueue;
 using detail::Event;
 using detail::markEventOnActiveQueue;
@@ -33,9 +35,11 @@ const Event &getEvent(const af_event &handle) {
 af_event getHandle(Event &event) { return static_cast<af_event>(&event); }
 
 af_err af_create_event(af_event *handle) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
-        *handle = createEvent();
+        // The events created for the user can always be timed
+        *handle = createTimingEvent();
     }
     CATCHALL;
 
@@ -43,6 +47,7 @@ af_err af_create_event(af_event *handle) {
 }
 
 af_err af_delete_event(af_event handle) {
+    AF_API_RANGE();
     try {
         delete &getEvent(handle);
     }
@@ -52,6 +57,7 @@ af_err af_delete_event(af_event handle) {
 }
 
 af_err af_mark_event(const af_event handle) {
+    AF_API_RANGE();
     try {
         markEventOnActiveQueue(handle);
     }
@@ -61,6 +67,7 @@ af_err af_mark_event(const af_event handle) {
 }
 
 af_err af_enqueue_wait_event(const af_event handle) {
+    AF_API_RANGE();
     try {
         enqueueWaitOnActiveQueue(handle);
     }
@@ -70,6 +77,7 @@ af_err af_enqueue_wait_event(const af_event handle) {
 }
 
 af_err af_block_event(const af_event handle) {
+    AF_API_RANGE();
     try {
         block(handle);
     }
@@ -77,3 +85,17 @@ af_err af_block_event(const af_event handle) {
 
     return AF_SUCCESS;
 }
+
+af_err af_event_elapsed_time(float *ms, const af_event start,
+                             const af_event end) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(0, ms != nullptr);
+        ARG_ASSERT(1, start != nullptr);
+        ARG_ASSERT(2, end != nullptr);
+        *ms = elapsedTime(start, end);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
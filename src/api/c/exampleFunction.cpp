@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <af/dim4.hpp>  // Needed if you use dim4 class
 
 #include <af/util.h>  // Include header where function is delcared
@@ -51,6 +52,7 @@ af_array example(const af_array& a, const af_array& b,
 
 af_err af_example_function(af_array* out, const af_array a,
                            const af_someenum_t param) {
+    AF_API_RANGE_ARRAY(a);
     try {
         af_array output = 0;
         const ArrayInfo& info =
@@ -7,12 +7,14 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <features.hpp>
 #include <handle.hpp>
 #include <af/array.h>
 #include <af/features.h>
 
 af_err af_release_features(af_features featHandle) {
+    AF_API_RANGE();
     try {
         af_features_t feat = *static_cast<af_features_t *>(featHandle);
         if (feat.n > 0) {
@@ -38,6 +40,7 @@ af_features getFeaturesHandle(const af_features_t feat) {
 }
 
 af_err af_create_features(af_features *featHandle, dim_t num) {
+    AF_API_RANGE();
     try {
         af_features_t feat;
         feat.n = num;
@@ -64,6 +67,7 @@ af_features_t getFeatures(const af_features featHandle) {
 
 af_err af_retain_features(af_features *outHandle,
                           const af_features featHandle) {
+    AF_API_RANGE();
     try {
         af_features_t feat = getFeatures(featHandle);
         af_features_t out;
@@ -82,6 +86,7 @@ af_err af_retain_features(af_features *outHandle,
 }
 
 af_err af_get_features_num(dim_t *num, const af_features featHandle) {
+    AF_API_RANGE();
     try {
         af_features_t feat = getFeatures(featHandle);
         *num               = feat.n;
@@ -91,6 +96,7 @@ af_err af_get_features_num(dim_t *num, const af_features featHandle) {
 }
 
 af_err af_get_features_xpos(af_array *out, const af_features featHandle) {
+    AF_API_RANGE();
     try {
         af_features_t feat = getFeatures(featHandle);
         *out               = feat.x;
@@ -100,6 +106,7 @@ af_err af_get_features_xpos(af_array *out, const af_features featHandle) {
 }
 
 af_err af_get_features_ypos(af_array *out, const af_features featHandle) {
+    AF_API_RANGE();
     try {
         af_features_t feat = getFeatures(featHandle);
         *out               = feat.y;
@@ -109,6 +116,7 @@ af_err af_get_features_ypos(af_array *out, const af_features featHandle) {
 }
 
 af_err af_get_features_score(af_array *out, const af_features featHandle) {
+    AF_API_RANGE();
     try {
         af_features_t feat = getFeatures(featHandle);
         *out               = feat.score;
@@ -119,6 +127,7 @@ af_err af_get_features_score(af_array *out, const af_features featHandle) {
 
 af_err af_get_features_orientation(af_array *out,
                                    const af_features featHandle) {
+    AF_API_RANGE();
     try {
         af_features_t feat = getFeatures(featHandle);
         *out               = feat.orientation;
@@ -128,6 +137,7 @@ af_err af_get_features_orientation(af_array *out,
 }
 
 af_err af_get_features_size(af_array *out, const af_features featHandle) {
+    AF_API_RANGE();
     try {
         af_features_t feat = getFeatures(featHandle);
         *out               = feat.size;
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
 #include <fft_common.hpp>
@@ -20,7 +21,9 @@ using af::dim4;
 using detail::Array;
 using detail::cdouble;
 using detail::cfloat;
+using detail::createValueArray;
 using detail::multiply_inplace;
+using detail::scalar;
 using std::conditional;
 using std::is_same;
 
@@ -82,12 +85,14 @@ af_err fft(af_array *out, const af_array in, const double norm_factor,
 
 af_err af_fft(af_array *out, const af_array in, const double norm_factor,
               const dim_t pad0) {
+    AF_API_RANGE_ARRAY(in);
     const dim_t pad[1] = {pad0};
     return fft(out, in, norm_factor, (pad0 > 0 ? 1 : 0), pad, 1, true);
 }
 
 af_err af_fft2(af_array *out, const af_array in, const double norm_factor,
                const dim_t pad0, const dim_t pad1) {
+    AF_API_RANGE_ARRAY(in);
     const dim_t pad[2] = {pad0, pad1};
     return fft(out, in, norm_factor, (pad0 > 0 && pad1 > 0 ? 2 : 0), pad, 2,
                true);
@@ -95,6 +100,7 @@ af_err af_fft2(af_array *out, const af_array in, const double norm_factor,
 
 af_err af_fft3(af_array *out, const af_array in, const double norm_factor,
                const dim_t pad0, const dim_t pad1, const dim_t pad2) {
+    AF_API_RANGE_ARRAY(in);
     const dim_t pad[3] = {pad0, pad1, pad2};
     return fft(out, in, norm_factor, (pad0 > 0 && pad1 > 0 && pad2 > 0 ? 3 : 0),
                pad, 3, true);
@@ -102,12 +108,14 @@ af_err af_fft3(af_array *out, const af_array in, const double norm_factor,
 
 af_err af_ifft(af_array *out, const af_array in, const double norm_factor,
                const dim_t pad0) {
+    AF_API_RANGE_ARRAY(in);
     const dim_t pad[1] = {pad0};
     return fft(out, in, norm_factor, (pad0 > 0 ? 1 : 0), pad, 1, false);
 }
 
 af_err af_ifft2(af_array *out, const af_array in, const double norm_factor,
                 const dim_t pad0, const dim_t pad1) {
+    AF_API_RANGE_ARRAY(in);
     const dim_t pad[2] = {pad0, pad1};
     return fft(out, in, norm_factor, (pad0 > 0 && pad1 > 0 ? 2 : 0), pad, 2,
                false);
@@ -115,6 +123,7 @@ af_err af_ifft2(af_array *out, const af_array in, const double norm_factor,
 
 af_err af_ifft3(af_array *out, const af_array in, const double norm_factor,
                 const dim_t pad0, const dim_t pad1, const dim_t pad2) {
+    AF_API_RANGE_ARRAY(in);
     const dim_t pad[3] = {pad0, pad1, pad2};
     return fft(out, in, norm_factor, (pad0 > 0 && pad1 > 0 && pad2 > 0 ? 3 : 0),
                pad, 3, false);
@@ -154,26 +163,32 @@ af_err fft_inplace(af_array in, const double norm_factor, int rank,
 }
 
 af_err af_fft_inplace(af_array in, const double norm_factor) {
+    AF_API_RANGE_ARRAY(in);
     return fft_inplace(in, norm_factor, 1, true);
 }
 
 af_err af_fft2_inplace(af_array in, const double norm_factor) {
+    AF_API_RANGE_ARRAY(in);
     return fft_inplace(in, norm_factor, 2, true);
 }
 
 af_err af_fft3_inplace(af_array in, const double norm_factor) {
+    AF_API_RANGE_ARRAY(in);
     return fft_inplace(in, norm_factor, 3, true);
 }
 
 af_err af_ifft_inplace(af_array in, const double norm_factor) {
+    AF_API_RANGE_ARRAY(in);
     return fft_inplace(in, norm_factor, 1, false);
 }
 
 af_err af_ifft2_inplace(af_array in, const double norm_factor) {
+    AF_API_RANGE_ARRAY(in);
     return fft_inplace(in, norm_factor, 2, false);
 }
 
 af_err af_ifft3_inplace(af_array in, const double norm_factor) {
+    AF_API_RANGE_ARRAY(in);
     return fft_inplace(in, norm_factor, 3, false);
 }
 
@@ -217,12 +232,14 @@ af_err fft_r2c(af_array *out, const af_array in, const double norm_factor,
 
 af_err af_fft_r2c(af_array *out, const af_array in, const double norm_factor,
                   const dim_t pad0) {
+    AF_API_RANGE_ARRAY(in);
     const dim_t pad[1] = {pad0};
     return fft_r2c(out, in, norm_factor, (pad0 > 0 ? 1 : 0), pad, 1);
 }
 
 af_err af_fft2_r2c(af_array *out, const af_array in, const double norm_factor,
                    const dim_t pad0, const dim_t pad1) {
+    AF_API_RANGE_ARRAY(in);
     const dim_t pad[2] = {pad0, pad1};
     return fft_r2c(out, in, norm_factor, (pad0 > 0 && pad1 > 0 ? 2 : 0), pad,
                    2);
@@ -230,6 +247,7 @@ af_err af_fft2_r2c(af_array *out, const af_array in, const double norm_factor,
 
 af_err af_fft3_r2c(af_array *out, const af_array in, const double norm_factor,
                    const dim_t pad0, const dim_t pad1, const dim_t pad2) {
+    AF_API_RANGE_ARRAY(in);
     const dim_t pad[3] = {pad0, pad1, pad2};
     return fft_r2c(out, in, norm_factor,
                    (pad0 > 0 && pad1 > 0 && pad2 > 0 ? 3 : 0), pad, 3);
@@ -276,23 +294,73 @@ af_err fft_c2r(af_array *out, const af_array in, const double norm_factor,
 
 af_err af_fft_c2r(af_array *out, const af_array in, const double norm_factor,
                   const bool is_odd) {
+    AF_API_RANGE_ARRAY(in);
     return fft_c2r(out, in, norm_factor, is_odd, 1);
 }
 
 af_err af_fft2_c2r(af_array *out, const af_array in, const double norm_factor,
                    const bool is_odd) {
+    AF_API_RANGE_ARRAY(in);
     return fft_c2r(out, in, norm_factor, is_odd, 2);
 }
 
 af_err af_fft3_c2r(af_array *out, const af_array in, const double norm_factor,
                    const bool is_odd) {
+    AF_API_RANGE_ARRAY(in);
     return fft_c2r(out, in, norm_factor, is_odd, 3);
 }
 
 af_err af_set_fft_plan_cache_size(size_t cache_size) {
+    AF_API_RANGE();
     try {
         detail::setFFTPlanCacheSize(cache_size);
     }
     CATCHALL;
     return AF_SUCCESS;
 }
+
+af_err af_set_fft_plan_cache_bytes(size_t cache_bytes) {
+    AF_API_RANGE();
+    try {
+        detail::setFFTPlanCacheBytes(cache_bytes);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+template<typename T>
+void prepareFFTPlan(const dim4 &dims, const int rank) {
+    Array<T> in = createValueArray<T>(dims, scalar<T>(0));
+    // Forward and inverse transforms share the plan
+    detail::fft_inplace<T>(in, rank, true);
+}
+
+template<typename Tr, typename Tc>
+void prepareRealFFTPlans(const dim4 &dims, const int rank) {
+    Array<Tr> in  = createValueArray<Tr>(dims, scalar<Tr>(0));
+    Array<Tc> tmp = detail::fft_r2c<Tc, Tr>(in, rank);
+    detail::fft_c2r<Tr, Tc>(tmp, dims, rank);
+}
+
+af_err af_prepare_fft_plan(const unsigned ndims, const dim_t *const dims,
+                           const int rank, const af_dtype type) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(1, dims != nullptr);
+        ARG_ASSERT(2, rank >= 1 && rank <= 3);
+
+        dim4 d = verifyDims(ndims, dims);
+        if (d.elements() == 0) { return AF_SUCCESS; }
+        DIM_ASSERT(1, (d.ndims() >= static_cast<dim_t>(rank)));
+
+        switch (type) {
+            case c32: prepareFFTPlan<cfloat>(d, rank); break;
+            case c64: prepareFFTPlan<cdouble>(d, rank); break;
+            case f32: prepareRealFFTPlans<float, cfloat>(d, rank); break;
+            case f64: prepareRealFFTPlans<double, cdouble>(d, rank); break;
+            default: TYPE_ERROR(3, type);
+        }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
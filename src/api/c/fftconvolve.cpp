@@ -7,14 +7,20 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <common/dispatch.hpp>
 #include <common/err_common.hpp>
 #include <complex.hpp>
+#include <copy.hpp>
 #include <fft_common.hpp>
 #include <fftconvolve.hpp>
 #include <handle.hpp>
+#include <join.hpp>
+#include <tile.hpp>
+#include <unwrap.hpp>
+#include <af/array.h>
 #include <af/defines.h>
 #include <af/dim4.hpp>
 #include <af/signal.h>
@@ -29,18 +35,27 @@ using detail::Array;
 using detail::cast;
 using detail::cdouble;
 using detail::cfloat;
+using detail::copyArray;
 using detail::createSubArray;
+using detail::createValueArray;
 using detail::fftconvolve;
 using detail::intl;
+using detail::join;
+using detail::padArrayBorders;
 using detail::real;
+using detail::reshape;
+using detail::scalar;
+using detail::tile;
 using detail::uchar;
 using detail::uint;
 using detail::uintl;
+using detail::unwrap;
 using detail::ushort;
 using std::conditional;
 using std::is_integral;
 using std::is_same;
 using std::max;
+using std::min;
 using std::swap;
 using std::vector;
 
@@ -231,11 +246,13 @@ af_err fft_convolve(af_array *out, const af_array signal, const af_array filter,
 
 af_err af_fft_convolve1(af_array *out, const af_array signal,
                         const af_array filter, const af_conv_mode mode) {
+    AF_API_RANGE_ARRAY(signal);
     return fft_convolve(out, signal, filter, mode == AF_CONV_EXPAND, 1);
 }
 
 af_err af_fft_convolve2(af_array *out, const af_array signal,
                         const af_array filter, const af_conv_mode mode) {
+    AF_API_RANGE_ARRAY(signal);
     if (getInfo(signal).dims().ndims() < 2 &&
         getInfo(filter).dims().ndims() < 2) {
         return fft_convolve(out, signal, filter, mode == AF_CONV_EXPAND, 1);
@@ -245,9 +262,365 @@ af_err af_fft_convolve2(af_array *out, const af_array signal,
 
 af_err af_fft_convolve3(af_array *out, const af_array signal,
                         const af_array filter, const af_conv_mode mode) {
+    AF_API_RANGE_ARRAY(signal);
     if (getInfo(signal).dims().ndims() < 3 &&
         getInfo(filter).dims().ndims() < 3) {
         return fft_convolve(out, signal, filter, mode == AF_CONV_EXPAND, 2);
     }
     return fft_convolve(out, signal, filter, mode == AF_CONV_EXPAND, 3);
 }
+
+namespace {
+
+/// The transforms of the blocks of an overlap-save convolution. The real
+/// types use the real to complex transforms, which are half the size.
+template<typename T, bool IsComplex = is_same<T, cfloat>::value ||
+                                      is_same<T, cdouble>::value>
+struct BlockFFT {
+    using cT = typename conditional<is_same<T, float>::value, cfloat,
+                                    cdouble>::type;
+
+    static Array<cT> forward(const Array<T> &blocks, const dim_t blockSize) {
+        return fft_r2c<T, cT>(blocks, 1.0, 1, &blockSize, 1);
+    }
+
+    static Array<T> inverse(const Array<cT> &spectrum, const dim4 &odims) {
+        return fft_c2r<cT, T>(spectrum, 1.0 / static_cast<double>(odims[0]),
+                              odims, 1);
+    }
+};
+
+template<typename T>
+struct BlockFFT<T, true> {
+    using cT = T;
+
+    static Array<cT> forward(const Array<T> &blocks, const dim_t blockSize) {
+        return fft<T, T>(blocks, 1.0, 1, &blockSize, 1, true);
+    }
+
+    static Array<T> inverse(const Array<cT> &spectrum, const dim4 &odims) {
+        const dim_t blockSize = odims[0];
+        return fft<T, T>(spectrum, 1.0 / static_cast<double>(blockSize), 1,
+                         &blockSize, 1, false);
+    }
+};
+
+/// The block size used when none is given. The blocks are several times
+/// longer than the filter so that most of each transform is output.
+dim_t defaultBlockSize(const dim_t filterLen) {
+    return nextpow2(static_cast<unsigned>(max<dim_t>(8 * filterLen, 1024)));
+}
+
+/// Convolves the columns of \p input with a filter of \p filterLen elements
+/// whose transform of \p blockSize elements is \p spectrum.
+///
+/// Element i of a column of the output is the filter applied to the
+/// elements of the input column which end at element i + filterLen - 1. The
+/// elements after the end of the input are zero.
+///
+/// This is the overlap-save method. The input is cut into blocks of
+/// blockSize elements which overlap by filterLen - 1 elements and are
+/// transformed as one batch, so the size of the transforms does not depend
+/// on the length of the signal.
+template<typename T>
+Array<T> overlapSave(const Array<T> &input,
+                     const Array<typename BlockFFT<T>::cT> &spectrum,
+                     const dim_t blockSize, const dim_t filterLen,
+                     const dim_t outLen) {
+    using cT = typename BlockFFT<T>::cT;
+
+    const dim_t step    = blockSize - filterLen + 1;
+    const dim_t nBlocks = divup(outLen, step);
+    const dim_t batch   = input.elements() / input.dims()[0];
+
+    // unwrap slides its window along the first two dimensions, so the
+    // columns of the input are moved to the third one
+    Array<T> padded = modDims(input, dim4(input.dims()[0], 1, batch));
+    padded = reshape<T, T>(
+        padded, dim4(nBlocks * step + filterLen - 1, 1, batch), scalar<T>(0));
+
+    Array<T> blocks = unwrap(padded, blockSize, 1, step, 1, 0, 0, 1, 1, true);
+    Array<cT> blockSpectrum = BlockFFT<T>::forward(blocks, blockSize);
+    blockSpectrum           = arithOp<cT, af_mul_t>(
+        blockSpectrum, tile(spectrum, dim4(1, nBlocks, batch)),
+        blockSpectrum.dims());
+    blocks = BlockFFT<T>::inverse(blockSpectrum, blocks.dims());
+
+    // The first filterLen - 1 elements of each block have wrapped around
+    vector<af_seq> index(AF_MAX_DIMS, af_span);
+    index[0] = {static_cast<double>(filterLen - 1),
+                static_cast<double>(blockSize - 1), 1.};
+    Array<T> out = modDims(createSubArray(blocks, index),
+                           dim4(nBlocks * step, batch));
+
+    index[0] = {0., static_cast<double>(outLen - 1), 1.};
+    return createSubArray(out, index);
+}
+
+template<typename T>
+Array<typename BlockFFT<T>::cT> filterSpectrum(const af_array filter,
+                                               const dim_t blockSize) {
+    const Array<T> F = castArray<T>(filter);
+    return BlockFFT<T>::forward(modDims(F, dim4(F.elements())), blockSize);
+}
+
+template<typename T, typename convT>
+af_array fftconvolveBlock(const af_array signal, const af_array filter,
+                          const dim_t blockSize, const bool expand) {
+    const Array<convT> S  = castArray<convT>(signal);
+    const dim4 &sdims     = S.dims();
+    const dim_t filterLen = getInfo(filter).elements();
+    const dim_t outLen    = expand ? sdims[0] + filterLen - 1 : sdims[0];
+
+    // The output starts where the last element of the filter overlaps the
+    // signal in the expanded mode and at its centre otherwise
+    const dim_t lead = expand ? filterLen - 1 : filterLen - 1 - filterLen / 2;
+    const Array<convT> input =
+        padArrayBorders(S, dim4(lead, 0, 0, 0), dim4(0, 0, 0, 0), AF_PAD_ZERO);
+
+    Array<convT> out = overlapSave(input,
+                                   filterSpectrum<convT>(filter, blockSize),
+                                   blockSize, filterLen, outLen);
+    return getHandle(
+        cast<T>(modDims(out, dim4(outLen, sdims[1], sdims[2], sdims[3]))));
+}
+
+/// The state of a streaming convolution. The transform of the filter is
+/// computed once and the last filterLen - 1 elements of the signal are kept
+/// for the next chunk.
+struct ConvolveStream {
+    af_dtype type;
+    dim_t blockSize;
+    dim_t filterLen;
+    af_array spectrum;
+    af_array history;  // Null until the first chunk is pushed
+};
+
+ConvolveStream &getConvolveStream(const af_convolve_stream handle) {
+    if (!handle) {
+        AF_ERROR("Invalid af_convolve_stream handle", AF_ERR_ARG);
+    }
+    return *static_cast<ConvolveStream *>(handle);
+}
+
+template<typename T>
+af_array pushChunk(ConvolveStream &stream, const af_array chunk) {
+    using cT = typename BlockFFT<T>::cT;
+
+    const Array<T> C       = castArray<T>(chunk);
+    const dim4 &cdims      = C.dims();
+    const dim_t historyLen = stream.filterLen - 1;
+    const dim4 historyDims(historyLen, cdims[1], cdims[2], cdims[3]);
+
+    Array<T> input = C;
+    if (historyLen > 0) {
+        if (stream.history) {
+            const Array<T> &history = getArray<T>(stream.history);
+            ARG_ASSERT(2, history.dims() == historyDims);
+            input = join(0, history, C);
+        } else {
+            input =
+                join(0, createValueArray<T>(historyDims, scalar<T>(0)), C);
+        }
+    }
+
+    Array<T> out = overlapSave(input, getArray<cT>(stream.spectrum),
+                               stream.blockSize, stream.filterLen, cdims[0]);
+    out          = modDims(out, cdims);
+
+    if (historyLen > 0) {
+        vector<af_seq> index(AF_MAX_DIMS, af_span);
+        index[0] = {static_cast<double>(cdims[0]),
+                    static_cast<double>(cdims[0] + historyLen - 1), 1.};
+        af_array history = getHandle(copyArray(createSubArray(input, index)));
+        if (stream.history) { AF_CHECK(af_release_array(stream.history)); }
+        stream.history = history;
+    }
+    return getHandle(out);
+}
+
+}  // namespace
+
+af_err af_fft_convolve1_block(af_array *out, const af_array signal,
+                              const af_array filter, const dim_t block_size,
+                              const af_conv_mode mode) {
+    AF_API_RANGE_ARRAY(signal);
+    try {
+        const ArrayInfo &sInfo = getInfo(signal);
+        const ArrayInfo &fInfo = getInfo(filter);
+        const dim_t filterLen  = fInfo.elements();
+
+        ARG_ASSERT(1, sInfo.ndims() > 0);
+        ARG_ASSERT(2, fInfo.ndims() == 1);
+        ARG_ASSERT(3, block_size == 0 || block_size >= filterLen);
+
+        const bool expand     = mode == AF_CONV_EXPAND;
+        const dim_t outLen    = sInfo.dims()[0] + (expand ? filterLen - 1 : 0);
+        const dim_t blockSize = block_size > 0
+                                    ? block_size
+                                    : min(defaultBlockSize(filterLen),
+                                          static_cast<dim_t>(nextpow2(
+                                              outLen + filterLen - 1)));
+
+        af_array output;
+        switch (sInfo.getType()) {
+            case f64:
+                output = fftconvolveBlock<double, double>(signal, filter,
+                                                          blockSize, expand);
+                break;
+            case f32:
+                output = fftconvolveBlock<float, float>(signal, filter,
+                                                        blockSize, expand);
+                break;
+            case u32:
+                output = fftconvolveBlock<uint, float>(signal, filter,
+                                                       blockSize, expand);
+                break;
+            case s32:
+                output = fftconvolveBlock<int, float>(signal, filter,
+                                                      blockSize, expand);
+                break;
+            case u64:
+                output = fftconvolveBlock<uintl, float>(signal, filter,
+                                                        blockSize, expand);
+                break;
+            case s64:
+                output = fftconvolveBlock<intl, float>(signal, filter,
+                                                       blockSize, expand);
+                break;
+            case u16:
+                output = fftconvolveBlock<ushort, float>(signal, filter,
+                                                         blockSize, expand);
+                break;
+            case s16:
+                output = fftconvolveBlock<short, float>(signal, filter,
+                                                        blockSize, expand);
+                break;
+            case u8:
+                output = fftconvolveBlock<uchar, float>(signal, filter,
+                                                        blockSize, expand);
+                break;
+            case b8:
+                output = fftconvolveBlock<char, float>(signal, filter,
+                                                       blockSize, expand);
+                break;
+            case c32:
+                output = fftconvolveBlock<cfloat, cfloat>(signal, filter,
+                                                          blockSize, expand);
+                break;
+            case c64:
+                output = fftconvolveBlock<cdouble, cdouble>(
+                    signal, filter, blockSize, expand);
+                break;
+            default: TYPE_ERROR(1, sInfo.getType());
+        }
+        swap(*out, output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_create_convolve_stream(af_convolve_stream *stream,
+                                 const af_array filter,
+                                 const dim_t block_size) {
+    AF_API_RANGE_ARRAY(filter);
+    try {
+        const ArrayInfo &fInfo = getInfo(filter);
+        const dim_t filterLen  = fInfo.elements();
+
+        ARG_ASSERT(1, fInfo.ndims() == 1);
+        ARG_ASSERT(2, block_size == 0 || block_size >= filterLen);
+
+        const dim_t blockSize =
+            block_size > 0 ? block_size : defaultBlockSize(filterLen);
+
+        af_dtype type;
+        af_array spectrum;
+        switch (fInfo.getType()) {
+            case f64:
+                type     = f64;
+                spectrum =
+                    getHandle(filterSpectrum<double>(filter, blockSize));
+                break;
+            case c32:
+                type     = c32;
+                spectrum =
+                    getHandle(filterSpectrum<cfloat>(filter, blockSize));
+                break;
+            case c64:
+                type     = c64;
+                spectrum =
+                    getHandle(filterSpectrum<cdouble>(filter, blockSize));
+                break;
+            case f32:
+            case u32:
+            case s32:
+            case u64:
+            case s64:
+            case u16:
+            case s16:
+            case u8:
+            case b8:
+                type     = f32;
+                spectrum =
+                    getHandle(filterSpectrum<float>(filter, blockSize));
+                break;
+            default: TYPE_ERROR(1, fInfo.getType());
+        }
+        *stream = static_cast<af_convolve_stream>(
+            new ConvolveStream{type, blockSize, filterLen, spectrum, 0});
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_convolve_stream_push(af_array *out, af_convolve_stream stream,
+                               const af_array chunk) {
+    AF_API_RANGE_ARRAY(chunk);
+    try {
+        ConvolveStream &state = getConvolveStream(stream);
+        ARG_ASSERT(2, getInfo(chunk).ndims() > 0);
+
+        af_array output;
+        switch (state.type) {
+            case f32: output = pushChunk<float>(state, chunk); break;
+            case f64: output = pushChunk<double>(state, chunk); break;
+            case c32: output = pushChunk<cfloat>(state, chunk); break;
+            case c64: output = pushChunk<cdouble>(state, chunk); break;
+            default: TYPE_ERROR(1, state.type);
+        }
+        swap(*out, output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_convolve_stream_reset(af_convolve_stream stream) {
+    AF_API_RANGE();
+    try {
+        ConvolveStream &state = getConvolveStream(stream);
+        if (state.history) {
+            AF_CHECK(af_release_array(state.history));
+            state.history = 0;
+        }
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_release_convolve_stream(af_convolve_stream stream) {
+    AF_API_RANGE();
+    try {
+        ConvolveStream &state = getConvolveStream(stream);
+        AF_CHECK(af_release_array(state.spectrum));
+        if (state.history) { AF_CHECK(af_release_array(state.history)); }
+        delete &state;
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
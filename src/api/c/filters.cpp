@@ -7,16 +7,24 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <medfilt.hpp>
+#include <af/algorithm.h>
+#include <af/arith.h>
+#include <af/array.h>
 #include <af/data.h>
 #include <af/defines.h>
 #include <af/dim4.hpp>
 #include <af/image.h>
+#include <af/index.h>
 #include <af/signal.h>
 
+#include <cmath>
+#include <utility>
+
 using af::dim4;
 using detail::uchar;
 using detail::uint;
@@ -24,6 +32,7 @@ using detail::ushort;
 
 af_err af_medfilt(af_array *out, const af_array in, const dim_t wind_length,
                   const dim_t wind_width, const af_border_type edge_pad) {
+    AF_API_RANGE_ARRAY(in);
     return af_medfilt2(out, in, wind_length, wind_width, edge_pad);
 }
 
@@ -36,6 +45,7 @@ static af_array medfilt1(af_array const &in, dim_t w_wid,
 
 af_err af_medfilt1(af_array *out, const af_array in, const dim_t wind_width,
                    const af_border_type edge_pad) {
+    AF_API_RANGE_ARRAY(in);
     try {
         ARG_ASSERT(2, (wind_width > 0));
         ARG_ASSERT(4, (edge_pad >= AF_PAD_ZERO && edge_pad <= AF_PAD_SYM));
@@ -83,6 +93,7 @@ inline af_array medfilt2(af_array const &in, dim_t w_len, dim_t w_wid,
 
 af_err af_medfilt2(af_array *out, const af_array in, const dim_t wind_length,
                    const dim_t wind_width, const af_border_type edge_pad) {
+    AF_API_RANGE_ARRAY(in);
     try {
         ARG_ASSERT(2, (wind_length == wind_width));
         ARG_ASSERT(2, (wind_length > 0));
@@ -143,6 +154,7 @@ af_err af_medfilt2(af_array *out, const af_array in, const dim_t wind_length,
 
 af_err af_minfilt(af_array *out, const af_array in, const dim_t wind_length,
                   const dim_t wind_width, const af_border_type edge_pad) {
+    AF_API_RANGE_ARRAY(in);
     try {
         ARG_ASSERT(2, (wind_length == wind_width));
         ARG_ASSERT(2, (wind_length > 0));
@@ -170,6 +182,7 @@ af_err af_minfilt(af_array *out, const af_array in, const dim_t wind_length,
 
 af_err af_maxfilt(af_array *out, const af_array in, const dim_t wind_length,
                   const dim_t wind_width, const af_border_type edge_pad) {
+    AF_API_RANGE_ARRAY(in);
     try {
         ARG_ASSERT(2, (wind_length == wind_width));
         ARG_ASSERT(2, (wind_length > 0));
@@ -194,3 +207,172 @@ af_err af_maxfilt(af_array *out, const af_array in, const dim_t wind_length,
 
     return AF_SUCCESS;
 }
+
+namespace {
+
+/// Returns \p in as a floating point array, the type of the results of the
+/// box and the Gaussian filters
+af_array floatingArray(const af_array in) {
+    const af_dtype type = getInfo(in).getType();
+    if (type == f32 || type == f64 || type == c32 || type == c64) {
+        return retain(in);
+    }
+    af_array out = 0;
+    AF_CHECK(af_cast(&out, in, f32));
+    return out;
+}
+
+/// Returns the sums of the windows of \p window values along \p dim, centered
+/// like the convolutions and padded with zeros. The sums are differences of
+/// a scan, so they cost the same for all the windows.
+af_array runningSums(const af_array in, const unsigned dim,
+                     const dim_t window) {
+    const dim4 &dims = getInfo(in).dims();
+
+    // The scan starts with a zero, so the sum of the window ending at k is
+    // scan(k + 1) - scan(k + 1 - window)
+    dim_t before[AF_MAX_DIMS] = {0, 0, 0, 0};
+    dim_t after[AF_MAX_DIMS]  = {0, 0, 0, 0};
+    before[dim]               = window - window / 2;
+    after[dim]                = window / 2;
+
+    af_array padded  = 0;
+    af_array scanned = 0;
+    AF_CHECK(af_pad(&padded, in, AF_MAX_DIMS, before, AF_MAX_DIMS, after,
+                    AF_PAD_ZERO));
+    AF_CHECK(af_accum(&scanned, padded, static_cast<int>(dim)));
+    AF_CHECK(af_release_array(padded));
+
+    af_seq last[AF_MAX_DIMS]  = {af_span, af_span, af_span, af_span};
+    af_seq first[AF_MAX_DIMS] = {af_span, af_span, af_span, af_span};
+    last[dim]  = {static_cast<double>(window),
+                 static_cast<double>(window + dims[dim] - 1), 1.};
+    first[dim] = {0., static_cast<double>(dims[dim] - 1), 1.};
+
+    af_array ends   = 0;
+    af_array starts = 0;
+    af_array sums   = 0;
+    AF_CHECK(af_index(&ends, scanned, AF_MAX_DIMS, last));
+    AF_CHECK(af_index(&starts, scanned, AF_MAX_DIMS, first));
+    AF_CHECK(af_release_array(scanned));
+    AF_CHECK(af_sub(&sums, ends, starts, false));
+    AF_CHECK(af_release_array(ends));
+    AF_CHECK(af_release_array(starts));
+    return sums;
+}
+
+/// Filters the columns of \p in with the recursive approximation of a
+/// Gaussian of Young and van Vliet, a causal and an anticausal filter of
+/// order 3 whose cost does not depend on \p sigma.
+af_array recursiveGaussianColumns(const af_array in, const double sigma) {
+    const double q = sigma >= 2.5
+                         ? 0.98711 * sigma - 0.96330
+                         : 3.97156 - 4.14554 * std::sqrt(1 - 0.26891 * sigma);
+    const double q2 = q * q;
+    const double q3 = q2 * q;
+    const double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    const double b1 = 2.44413 * q + 2.85619 * q2 + 1.26661 * q3;
+    const double b2 = -(1.4281 * q2 + 1.26661 * q3);
+    const double b3 = 0.422205 * q3;
+    const double B  = 1 - (b1 + b2 + b3) / b0;
+
+    const af_dtype type        = getInfo(in).getType();
+    const double feedforward[] = {B};
+    const double feedback[]    = {1, -b1 / b0, -b2 / b0, -b3 / b0};
+    const dim_t nb             = 1;
+    const dim_t na             = 4;
+
+    af_array bd = 0;
+    af_array ad = 0;
+    af_array b  = 0;
+    af_array a  = 0;
+    AF_CHECK(af_create_array(&bd, feedforward, 1, &nb, f64));
+    AF_CHECK(af_create_array(&ad, feedback, 1, &na, f64));
+    AF_CHECK(af_cast(&b, bd, type));
+    AF_CHECK(af_cast(&a, ad, type));
+    AF_CHECK(af_release_array(bd));
+    AF_CHECK(af_release_array(ad));
+
+    // The anticausal filter is the causal filter of the reversed columns
+    af_array causal   = 0;
+    af_array reversed = 0;
+    af_array filtered = 0;
+    af_array out      = 0;
+    AF_CHECK(af_iir(&causal, b, a, in));
+    AF_CHECK(af_flip(&reversed, causal, 0));
+    AF_CHECK(af_release_array(causal));
+    AF_CHECK(af_iir(&filtered, b, a, reversed));
+    AF_CHECK(af_release_array(reversed));
+    AF_CHECK(af_flip(&out, filtered, 0));
+    AF_CHECK(af_release_array(filtered));
+    AF_CHECK(af_release_array(b));
+    AF_CHECK(af_release_array(a));
+    return out;
+}
+
+}  // namespace
+
+af_err af_box_filter(af_array *out, const af_array in, const dim_t wind_length,
+                     const dim_t wind_width) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        ARG_ASSERT(2, (wind_length > 0));
+        ARG_ASSERT(3, (wind_width > 0));
+
+        const ArrayInfo &info = getInfo(in);
+        ARG_ASSERT(1, info.getType() != f16);
+        DIM_ASSERT(1, (info.ndims() >= 2));
+
+        af_array input = floatingArray(in);
+        af_array cols  = runningSums(input, 0, wind_length);
+        AF_CHECK(af_release_array(input));
+        af_array sums = runningSums(cols, 1, wind_width);
+        AF_CHECK(af_release_array(cols));
+
+        const ArrayInfo &sInfo = getInfo(sums);
+        const double count     = static_cast<double>(wind_length * wind_width);
+        af_array area          = 0;
+        af_array output        = 0;
+        AF_CHECK(af_constant(&area, count, AF_MAX_DIMS, sInfo.dims().get(),
+                             sInfo.getType()));
+        AF_CHECK(af_div(&output, sums, area, false));
+        AF_CHECK(af_release_array(area));
+        AF_CHECK(af_release_array(sums));
+        std::swap(*out, output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_gaussian_filter(af_array *out, const af_array in,
+                          const double sigma_r, const double sigma_c) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        ARG_ASSERT(2, (sigma_r >= 0.5));
+        ARG_ASSERT(3, (sigma_c >= 0.5));
+
+        const ArrayInfo &info = getInfo(in);
+        ARG_ASSERT(1, info.getType() != f16);
+        DIM_ASSERT(1, (info.ndims() >= 2));
+
+        af_array input = floatingArray(in);
+        af_array cols  = recursiveGaussianColumns(input, sigma_r);
+        AF_CHECK(af_release_array(input));
+
+        // The rows are filtered as the columns of the transposed image
+        af_array colsT = 0;
+        AF_CHECK(af_reorder(&colsT, cols, 1, 0, 2, 3));
+        AF_CHECK(af_release_array(cols));
+        af_array rowsT = recursiveGaussianColumns(colsT, sigma_c);
+        AF_CHECK(af_release_array(colsT));
+
+        af_array output = 0;
+        AF_CHECK(af_reorder(&output, rowsT, 1, 0, 2, 3));
+        AF_CHECK(af_release_array(rowsT));
+        std::swap(*out, output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
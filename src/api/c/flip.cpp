@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/half.hpp>
 #include <common/indexing_helpers.hpp>
@@ -36,6 +37,7 @@ static inline af_array flip(const af_array in, const unsigned dim) {
 }
 
 af_err af_flip(af_array *result, const af_array in, const unsigned dim) {
+    AF_API_RANGE_ARRAY(in);
     af_array out;
     try {
         const ArrayInfo &in_info = getInfo(in);
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
@@ -87,6 +88,7 @@ Array<T> gaussianKernel(const int rows, const int cols, const double sigma_r,
 
 af_err af_gaussian_kernel(af_array *out, const int rows, const int cols,
                           const double sigma_r, const double sigma_c) {
+    AF_API_RANGE();
     try {
         af_array res;
         res = getHandle<float>(
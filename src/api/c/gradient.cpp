@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -26,6 +27,7 @@ static inline void gradient(af_array *grad0, af_array *grad1,
 }
 
 af_err af_gradient(af_array *grows, af_array *gcols, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in);
         af_dtype type         = info.getType();
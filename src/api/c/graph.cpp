@@ -0,0 +1,70 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Graph.hpp>
+#include <api_range.hpp>
+#include <backend.hpp>
+#include <common/err_common.hpp>
+#include <af/device.h>
+#include <af/graph.h>
+
+using detail::beginCapture;
+using detail::endCapture;
+using detail::isCapturing;
+using detail::releaseGraph;
+using detail::replayGraph;
+
+af_err af_begin_capture() {
+    AF_API_RANGE();
+    try {
+        AF_CHECK(af_init());
+        beginCapture();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_end_capture(af_graph *graph) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(0, graph != nullptr);
+        *graph = endCapture();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_replay_graph(const af_graph graph) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(0, graph != nullptr);
+        replayGraph(graph);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_release_graph(af_graph graph) {
+    AF_API_RANGE();
+    try {
+        if (graph) { releaseGraph(graph); }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_is_capturing(bool *out) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(0, out != nullptr);
+        *out = isCapturing();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
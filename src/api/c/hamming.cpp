@@ -7,12 +7,14 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <af/defines.h>
 #include <af/vision.h>
 
 af_err af_hamming_matcher(af_array* idx, af_array* dist, const af_array query,
                           const af_array train, const dim_t dist_dim,
                           const unsigned n_dist) {
+    AF_API_RANGE_ARRAY(query);
     return af_nearest_neighbour(idx, dist, query, train, dist_dim, n_dist,
                                 AF_SHD);
 }
@@ -12,6 +12,7 @@
 #include <backend.hpp>
 #include <cast.hpp>
 #include <common/err_common.hpp>
+#include <common/bfloat16.hpp>
 #include <common/half.hpp>
 #include <common/traits.hpp>
 #include <copy.hpp>
@@ -79,6 +80,12 @@ detail::Array<To> castArray(const af_array &in) {
     using detail::ushort;
 
     const ArrayInfo &info = getInfo(in);
+
+    // Most calls pass arrays of the requested type, skip the dispatch for them
+    if (info.getType() == (af_dtype)af::dtype_traits<To>::af_type) {
+        return *static_cast<const detail::Array<To> *>(in);
+    }
+
     switch (info.getType()) {
         case f32: return detail::cast<To, float>(getArray<float>(in));
         case f64: return detail::cast<To, double>(getArray<double>(in));
@@ -94,6 +101,9 @@ detail::Array<To> castArray(const af_array &in) {
         case u16: return detail::cast<To, ushort>(getArray<ushort>(in));
         case f16:
             return detail::cast<To, common::half>(getArray<common::half>(in));
+        case bf16:
+            return detail::cast<To, common::bfloat16>(
+                getArray<common::bfloat16>(in));
         default: TYPE_ERROR(1, info.getType());
     }
 }
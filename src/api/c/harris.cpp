@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
 #include <features.hpp>
@@ -53,6 +54,7 @@ af_err af_harris(af_features *out, const af_array in,
                  const unsigned max_corners, const float min_response,
                  const float sigma, const unsigned block_size,
                  const float k_thr) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in);
         dim4 dims             = info.dims();
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <cast.hpp>
 #include <common/ArrayInfo.hpp>
@@ -91,6 +92,7 @@ fg_chart setup_histogram(fg_window const window, const af_array in,
 af_err af_draw_hist(const af_window window, const af_array X,
                     const double minval, const double maxval,
                     const af_cell* const props) {
+    AF_API_RANGE_ARRAY(X);
     try {
         if (window == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
 
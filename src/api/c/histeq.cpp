@@ -7,9 +7,11 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <cast.hpp>
+#include <clahe.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <lookup.hpp>
@@ -24,10 +26,11 @@ using af::dim4;
 using detail::arithOp;
 using detail::Array;
 using detail::cast;
+using detail::clahe;
 using detail::createValueArray;
 using detail::intl;
 using detail::lookup;
-using detail::reduce_all;
+using detail::reduce;
 using detail::scan;
 using detail::uchar;
 using detail::uint;
@@ -48,18 +51,17 @@ static af_array hist_equal(const af_array& in, const af_array& hist) {
 
     Array<float> cdf = scan<af_add_t, float, float>(fHist, 0);
 
-    float minCdf = reduce_all<af_min_t, float, float>(cdf);
-    float maxCdf = reduce_all<af_max_t, float, float>(cdf);
-    float factor = static_cast<float>(grayLevels - 1) / (maxCdf - minCdf);
-
-    // constant array of min value from cdf
-    Array<float> minCnst = createValueArray<float>(hDims, minCdf);
-    // constant array of factor variable
-    Array<float> facCnst = createValueArray<float>(hDims, factor);
-    // cdf(i) - min for all elements
-    Array<float> diff = arithOp<float, af_sub_t>(cdf, minCnst, hDims);
-    // multiply factor with difference
-    Array<float> normCdf = arithOp<float, af_mul_t>(diff, facCnst, hDims);
+    // The normalization of the cdf is computed on the device from the
+    // reduced extrema, so nothing is read back before the lookup
+    const dim4 one(1);
+    Array<float> minCdf = reduce<af_min_t, float, float>(cdf, 0);
+    Array<float> maxCdf = reduce<af_max_t, float, float>(cdf, 0);
+    Array<float> factor = arithOp<float, af_div_t>(
+        createValueArray<float>(one, static_cast<float>(grayLevels - 1)),
+        arithOp<float, af_sub_t>(maxCdf, minCdf, one), one);
+    // (cdf(i) - min) * factor for all elements
+    Array<float> normCdf = arithOp<float, af_mul_t>(
+        arithOp<float, af_sub_t>(cdf, minCdf, hDims), factor, hDims);
     // index input array with normalized cdf array
     Array<float> idxArr = lookup<float, T>(normCdf, getArray<T>(vInput), 0);
 
@@ -72,6 +74,7 @@ static af_array hist_equal(const af_array& in, const af_array& hist) {
 }
 
 af_err af_hist_equal(af_array* out, const af_array in, const af_array hist) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& dataInfo = getInfo(in);
         const ArrayInfo& histInfo = getInfo(hist);
@@ -100,3 +103,68 @@ af_err af_hist_equal(af_array* out, const af_array in, const af_array hist) {
 
     return AF_SUCCESS;
 }
+
+template<typename T>
+static inline af_array clahe(const af_array in, const unsigned gridRows,
+                             const unsigned gridCols, const float clipLimit,
+                             const unsigned nbins, const double minval,
+                             const double maxval) {
+    return getHandle(clahe<T>(getArray<T>(in), gridRows, gridCols, clipLimit,
+                              nbins, static_cast<float>(minval),
+                              static_cast<float>(maxval)));
+}
+
+af_err af_clahe(af_array* out, const af_array in, const unsigned grid_rows,
+                const unsigned grid_cols, const float clip_limit,
+                const unsigned nbins, const double minval,
+                const double maxval) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const ArrayInfo& info = getInfo(in);
+        af_dtype type         = info.getType();
+        const dim4& dims      = info.dims();
+
+        ARG_ASSERT(2, grid_rows >= 1 && grid_rows <= dims[0]);
+        ARG_ASSERT(3, grid_cols >= 1 && grid_cols <= dims[1]);
+        // The histogram of a tile is kept in shared memory
+        ARG_ASSERT(5, nbins >= 1 && nbins <= 4096);
+        ARG_ASSERT(7, minval < maxval);
+
+        af_array output = 0;
+        switch (type) {
+            case f32:
+                output = clahe<float>(in, grid_rows, grid_cols, clip_limit,
+                                      nbins, minval, maxval);
+                break;
+            case f64:
+                output = clahe<double>(in, grid_rows, grid_cols, clip_limit,
+                                       nbins, minval, maxval);
+                break;
+            case s32:
+                output = clahe<int>(in, grid_rows, grid_cols, clip_limit,
+                                    nbins, minval, maxval);
+                break;
+            case u32:
+                output = clahe<uint>(in, grid_rows, grid_cols, clip_limit,
+                                     nbins, minval, maxval);
+                break;
+            case s16:
+                output = clahe<short>(in, grid_rows, grid_cols, clip_limit,
+                                      nbins, minval, maxval);
+                break;
+            case u16:
+                output = clahe<ushort>(in, grid_rows, grid_cols, clip_limit,
+                                       nbins, minval, maxval);
+                break;
+            case u8:
+                output = clahe<uchar>(in, grid_rows, grid_cols, clip_limit,
+                                      nbins, minval, maxval);
+                break;
+            default: TYPE_ERROR(1, type);
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
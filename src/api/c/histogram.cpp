@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
@@ -14,6 +15,9 @@
 #include <af/dim4.hpp>
 #include <af/image.h>
 
+using af::dim4;
+using detail::Array;
+using detail::createEmptyArray;
 using detail::intl;
 using detail::uchar;
 using detail::uint;
@@ -30,6 +34,7 @@ inline af_array histogram(const af_array in, const unsigned &nbins,
 
 af_err af_histogram(af_array *out, const af_array in, const unsigned nbins,
                     const double minval, const double maxval) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in);
         af_dtype type         = info.getType();
@@ -90,3 +95,103 @@ af_err af_histogram(af_array *out, const af_array in, const unsigned nbins,
 
     return AF_SUCCESS;
 }
+
+template<typename T, typename To>
+inline af_array histogram2(const af_array x, const af_array y,
+                           const Array<float> &weights, const unsigned xbins,
+                           const unsigned ybins, const double xmin,
+                           const double xmax, const double ymin,
+                           const double ymax) {
+    return getHandle(histogram2<T, To>(getArray<T>(x), getArray<T>(y), weights,
+                                       xbins, ybins, xmin, xmax, ymin, ymax));
+}
+
+template<typename To>
+af_array histogram2(const af_dtype type, const af_array x, const af_array y,
+                    const Array<float> &weights, const unsigned xbins,
+                    const unsigned ybins, const double xmin, const double xmax,
+                    const double ymin, const double ymax) {
+    switch (type) {
+        case f32:
+            return histogram2<float, To>(x, y, weights, xbins, ybins, xmin,
+                                         xmax, ymin, ymax);
+        case f64:
+            return histogram2<double, To>(x, y, weights, xbins, ybins, xmin,
+                                          xmax, ymin, ymax);
+        case s32:
+            return histogram2<int, To>(x, y, weights, xbins, ybins, xmin, xmax,
+                                       ymin, ymax);
+        case u32:
+            return histogram2<uint, To>(x, y, weights, xbins, ybins, xmin,
+                                        xmax, ymin, ymax);
+        case s16:
+            return histogram2<short, To>(x, y, weights, xbins, ybins, xmin,
+                                         xmax, ymin, ymax);
+        case u16:
+            return histogram2<ushort, To>(x, y, weights, xbins, ybins, xmin,
+                                          xmax, ymin, ymax);
+        case u8:
+            return histogram2<uchar, To>(x, y, weights, xbins, ybins, xmin,
+                                         xmax, ymin, ymax);
+        default: TYPE_ERROR(1, type);
+    }
+}
+
+/// The joint histogram of \p x and \p y, which counts the pairs when \p
+/// weights is 0 and sums their weights otherwise
+af_array jointHistogram(const af_array x, const af_array y,
+                        const af_array weights, const unsigned xbins,
+                        const unsigned ybins, const double xmin,
+                        const double xmax, const double ymin,
+                        const double ymax) {
+    const ArrayInfo &xInfo = getInfo(x);
+    const ArrayInfo &yInfo = getInfo(y);
+    const af_dtype type    = xInfo.getType();
+
+    TYPE_ASSERT(yInfo.getType() == type);
+    DIM_ASSERT(2, yInfo.dims() == xInfo.dims());
+    ARG_ASSERT(4, xbins > 0);
+    ARG_ASSERT(5, ybins > 0);
+
+    if (weights == 0) {
+        return histogram2<uint>(type, x, y, createEmptyArray<float>(dim4()),
+                                xbins, ybins, xmin, xmax, ymin, ymax);
+    }
+    const ArrayInfo &wInfo = getInfo(weights);
+    TYPE_ASSERT(wInfo.getType() == f32);
+    DIM_ASSERT(3, wInfo.dims() == xInfo.dims());
+    return histogram2<float>(type, x, y, getArray<float>(weights), xbins,
+                             ybins, xmin, xmax, ymin, ymax);
+}
+
+af_err af_histogram2(af_array *out, const af_array x, const af_array y,
+                     const af_array weights, const unsigned xbins,
+                     const unsigned ybins, const double xmin,
+                     const double xmax, const double ymin, const double ymax) {
+    AF_API_RANGE_ARRAY(x);
+    try {
+        af_array output = jointHistogram(x, y, weights, xbins, ybins, xmin,
+                                         xmax, ymin, ymax);
+        std::swap(*out, output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_histogram_weighted(af_array *out, const af_array in,
+                             const af_array weights, const unsigned nbins,
+                             const double minval, const double maxval) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        ARG_ASSERT(2, weights != 0);
+        // The weighted histogram is the joint histogram of the input with
+        // itself with a single bin along the second dimension
+        af_array output = jointHistogram(in, in, weights, nbins, 1, minval,
+                                         maxval, minval, maxval);
+        std::swap(*out, output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
@@ -7,22 +7,28 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <homography.hpp>
+#include <join.hpp>
 #include <af/array.h>
 #include <af/defines.h>
 #include <af/random.h>
 #include <af/vision.h>
 
 #include <utility>
+#include <vector>
 
 using af::dim4;
 using detail::Array;
 using detail::createEmptyArray;
+using detail::createHostDataArray;
+using detail::createSubArray;
 using std::swap;
+using std::vector;
 
 template<typename T>
 static inline void homography(af_array& H, int& inliers, const af_array x_src,
@@ -50,6 +56,7 @@ af_err af_homography(af_array* H, int* inliers, const af_array x_src,
                      const af_array y_dst, const af_homography_type htype,
                      const float inlier_thr, const unsigned iterations,
                      const af_dtype otype) {
+    AF_API_RANGE_ARRAY(x_src);
     try {
         const ArrayInfo& xsinfo = getInfo(x_src);
         const ArrayInfo& ysinfo = getInfo(y_src);
@@ -102,3 +109,103 @@ af_err af_homography(af_array* H, int* inliers, const af_array x_src,
 
     return AF_SUCCESS;
 }
+
+template<typename T>
+static inline void homographyBatch(af_array& H, af_array& inliers,
+                                   const af_array x_src, const af_array y_src,
+                                   const af_array x_dst, const af_array y_dst,
+                                   const af_homography_type htype,
+                                   const float inlier_thr,
+                                   const unsigned iterations) {
+    const Array<float> xs = getArray<float>(x_src);
+    const Array<float> ys = getArray<float>(y_src);
+    const Array<float> xd = getArray<float>(x_dst);
+    const Array<float> yd = getArray<float>(y_dst);
+
+    // The samples are shared by the sets, which only differ in their points
+    af_array initial;
+    unsigned d    = (iterations + 256 - 1) / 256;
+    dim_t rdims[] = {4, d * 256};
+    AF_CHECK(af_randu(&initial, 2, rdims, f32));
+    const Array<float> samples = getArray<float>(initial);
+
+    const dim_t nsets = xs.dims()[1];
+    vector<Array<T>> outH;
+    vector<int> outInl(nsets);
+    outH.reserve(nsets);
+    for (dim_t k = 0; k < nsets; ++k) {
+        const vector<af_seq> idx = {af_span, {double(k), double(k), 1.}};
+
+        Array<T> bestH = createEmptyArray<T>(dim4(3, 3));
+        outInl[k]      = homography<T>(
+            bestH, createSubArray(xs, idx), createSubArray(ys, idx),
+            createSubArray(xd, idx), createSubArray(yd, idx), samples,
+            htype, inlier_thr, iterations);
+        outH.push_back(bestH);
+    }
+    AF_CHECK(af_release_array(initial));
+
+    H       = getHandle<T>(detail::join(2, outH));
+    inliers = getHandle(createHostDataArray<int>(dim4(nsets), outInl.data()));
+}
+
+af_err af_homography_batch(af_array* H, af_array* inliers,
+                           const af_array x_src, const af_array y_src,
+                           const af_array x_dst, const af_array y_dst,
+                           const af_homography_type htype,
+                           const float inlier_thr, const unsigned iterations,
+                           const af_dtype otype) {
+    AF_API_RANGE_ARRAY(x_src);
+    try {
+        const ArrayInfo& xsinfo = getInfo(x_src);
+        const ArrayInfo& ysinfo = getInfo(y_src);
+        const ArrayInfo& xdinfo = getInfo(x_dst);
+        const ArrayInfo& ydinfo = getInfo(y_dst);
+
+        af::dim4 xsdims = xsinfo.dims();
+        af::dim4 ysdims = ysinfo.dims();
+        af::dim4 xddims = xdinfo.dims();
+        af::dim4 yddims = ydinfo.dims();
+
+        af_dtype xstype = xsinfo.getType();
+        af_dtype ystype = ysinfo.getType();
+        af_dtype xdtype = xdinfo.getType();
+        af_dtype ydtype = ydinfo.getType();
+
+        if (xstype != f32) { TYPE_ERROR(2, xstype); }
+        if (ystype != f32) { TYPE_ERROR(3, ystype); }
+        if (xdtype != f32) { TYPE_ERROR(4, xdtype); }
+        if (ydtype != f32) { TYPE_ERROR(5, ydtype); }
+
+        ARG_ASSERT(2, (xsdims[0] > 0 && xsdims.ndims() <= 2));
+        ARG_ASSERT(3, (ysdims == xsdims));
+        ARG_ASSERT(4, (xddims[0] > 0 && xddims[1] == xsdims[1] &&
+                       xddims.ndims() <= 2));
+        ARG_ASSERT(5, (yddims == xddims));
+
+        ARG_ASSERT(7, (inlier_thr >= 0.1f));
+        ARG_ASSERT(8, (iterations > 0));
+        ARG_ASSERT(
+            6, (htype == AF_HOMOGRAPHY_RANSAC || htype == AF_HOMOGRAPHY_LMEDS));
+
+        af_array outH;
+        af_array outInl;
+
+        switch (otype) {
+            case f32:
+                homographyBatch<float>(outH, outInl, x_src, y_src, x_dst,
+                                       y_dst, htype, inlier_thr, iterations);
+                break;
+            case f64:
+                homographyBatch<double>(outH, outInl, x_src, y_src, x_dst,
+                                        y_dst, htype, inlier_thr, iterations);
+                break;
+            default: TYPE_ERROR(9, otype);
+        }
+        swap(*H, outH);
+        swap(*inliers, outInl);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
@@ -56,9 +57,11 @@ af_err convert(af_array* out, const af_array& in) {
 }
 
 af_err af_hsv2rgb(af_array* out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     return convert<true>(out, in);
 }
 
 af_err af_rgb2hsv(af_array* out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     return convert<false>(out, in);
 }
@@ -6,9 +6,14 @@
  * The complete license agreement can be obtained at:
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
+#include <api_range.hpp>
+#include <arith.hpp>
 #include <backend.hpp>
+#include <blas.hpp>
+#include <common/dispatch.hpp>
 #include <common/err_common.hpp>
 #include <convolve.hpp>
+#include <copy.hpp>
 #include <handle.hpp>
 #include <iir.hpp>
 #include <af/arith.h>
@@ -16,13 +21,28 @@
 #include <af/dim4.hpp>
 #include <af/signal.h>
 
+#include <algorithm>
+#include <complex>
 #include <cstdio>
+#include <vector>
 
 using af::dim4;
+using detail::arithOp;
+using detail::Array;
 using detail::cdouble;
 using detail::cfloat;
+using detail::copyData;
+using detail::createHostDataArray;
+using detail::createSubArray;
+using detail::createValueArray;
+using detail::matmul;
+using detail::reshape;
+using detail::scalar;
+using std::max;
+using std::vector;
 
 af_err af_fir(af_array* y, const af_array b, const af_array x) {
+    AF_API_RANGE_ARRAY(b);
     try {
         af_array out;
         AF_CHECK(af_convolve1(&out, x, b, AF_CONV_EXPAND, AF_CONV_AUTO));
@@ -41,14 +61,154 @@ af_err af_fir(af_array* y, const af_array b, const af_array x) {
     return AF_SUCCESS;
 }
 
+namespace {
+
+/// The smallest number of elements in a block of the blocked recurrence
+constexpr dim_t IIR_MIN_BLOCK_ELEMENTS = 256;
+
+/// The largest number of blocks in a signal. The blocks are filtered as the
+/// columns of an array, whose number is limited by the GPU grids.
+constexpr dim_t IIR_MAX_BLOCKS = 16384;
+
+/// The host type of the elements of an array. The complex types of the
+/// backends have the layout of std::complex.
 template<typename T>
-inline static af_array iir(const af_array b, const af_array a,
-                           const af_array x) {
-    return getHandle(iir<T>(getArray<T>(b), getArray<T>(a), getArray<T>(x)));
+struct HostType {
+    using type = T;
+};
+
+template<>
+struct HostType<cfloat> {
+    using type = std::complex<float>;
+};
+
+template<>
+struct HostType<cdouble> {
+    using type = std::complex<double>;
+};
+
+/// Returns the length of the blocks af_iir splits the signals into, or 0 if
+/// the signals are filtered from start to end.
+///
+/// The recurrence is only parallel across the signals, so a few long
+/// signals are split into blocks when there are fewer signals than blocks.
+dim_t iirBlockLength(const dim4 &xdims, const dim_t order) {
+    const dim_t len      = xdims[0];
+    const dim_t batch    = xdims.elements() / len;
+    const dim_t blockLen = max<dim_t>(
+        {IIR_MIN_BLOCK_ELEMENTS, nextpow2(static_cast<unsigned>(16 * order)),
+         nextpow2(static_cast<unsigned>(divup(len, IIR_MAX_BLOCKS)))});
+    const dim_t nBlocks = len / blockLen;
+    return (nBlocks >= 4 && batch < nBlocks) ? blockLen : 0;
 }
 
+/// Filters the signals in blocks of \p blockLen elements which are solved in
+/// parallel, for a feedback filter \p a shared by all the signals.
+///
+/// Each block is first filtered as if the outputs before it were zero. The
+/// recurrence is linear, so the rest of the output of a block is the
+/// response of the filter to the last `order` outputs of the previous block.
+/// Those outputs are carried from block to block on the host, which only
+/// touches `order` elements of each block, and the responses are added to
+/// all the blocks with one matrix multiplication.
+template<typename T>
+af_array iirBlocked(const af_array b, const af_array a, const af_array x,
+                    const dim_t blockLen) {
+    using HostT = typename HostType<T>::type;
+
+    const Array<T> &A   = getArray<T>(a);
+    const dim4 &xdims   = getInfo(x).dims();
+    const dim_t len     = xdims[0];
+    const dim_t batch   = xdims.elements() / len;
+    const dim_t order   = A.elements() - 1;
+    const dim_t nBlocks = divup(len, blockLen);
+    const dim_t nLines  = nBlocks * batch;
+
+    // The feedforward part does not depend on the earlier outputs
+    af_array c;
+    AF_CHECK(af_fir(&c, b, x));
+    Array<T> blocks = modDims(getArray<T>(c), dim4(len, batch));
+    AF_CHECK(af_release_array(c));
+    blocks = reshape<T, T>(blocks, dim4(nBlocks * blockLen, batch),
+                           scalar<T>(0));
+    blocks = modDims(blocks, dim4(blockLen, nBlocks, batch));
+
+    const Array<T> one = createValueArray<T>(dim4(1), scalar<T>(1));
+    Array<T> y         = detail::iir<T>(one, A, blocks);
+
+    vector<HostT> coefs(order + 1);
+    copyData(reinterpret_cast<T *>(coefs.data()), A);
+
+    vector<HostT> response(blockLen, HostT(0));
+    response[0] = HostT(1);
+    copyData(reinterpret_cast<T *>(response.data()),
+             detail::iir<T>(one, A,
+                            createHostDataArray<T>(
+                                dim4(blockLen),
+                                reinterpret_cast<T *>(response.data()))));
+
+    vector<af_seq> index(AF_MAX_DIMS, af_span);
+    index[0] = {static_cast<double>(blockLen - order),
+                static_cast<double>(blockLen - 1), 1.};
+    vector<HostT> tails(order * nLines);
+    copyData(reinterpret_cast<T *>(tails.data()), createSubArray(y, index));
+
+    // The inputs which start the first `order` outputs of a block from the
+    // outputs of the previous block. The tail of each block is corrected
+    // before it is carried to the next one.
+    vector<HostT> inputs(order * nLines, HostT(0));
+    for (dim_t line = 0; line < nLines; ++line) {
+        if (line % nBlocks == 0) { continue; }
+        const HostT *prev = &tails[(line - 1) * order];
+        HostT *input      = &inputs[line * order];
+        HostT *tail       = &tails[line * order];
+        for (dim_t i = 0; i < order; ++i) {
+            for (dim_t k = i + 1; k <= order; ++k) {
+                input[i] -= coefs[k] * prev[order + i - k];
+            }
+        }
+        for (dim_t j = 0; j < order; ++j) {
+            const dim_t n = blockLen - order + j;
+            for (dim_t i = 0; i < order; ++i) {
+                tail[j] += response[n - i] * input[i];
+            }
+        }
+    }
+
+    vector<HostT> toeplitz(blockLen * order, HostT(0));
+    for (dim_t i = 0; i < order; ++i) {
+        for (dim_t n = i; n < blockLen; ++n) {
+            toeplitz[i * blockLen + n] = response[n - i];
+        }
+    }
+    const Array<T> corrections = matmul(
+        createHostDataArray<T>(dim4(blockLen, order),
+                               reinterpret_cast<T *>(toeplitz.data())),
+        createHostDataArray<T>(dim4(order, nLines),
+                               reinterpret_cast<T *>(inputs.data())),
+        AF_MAT_NONE, AF_MAT_NONE);
+
+    y = modDims(y, dim4(blockLen, nLines));
+    y = arithOp<T, af_add_t>(y, corrections, y.dims());
+    y = modDims(y, dim4(nBlocks * blockLen, batch));
+
+    index[0] = {0., static_cast<double>(len - 1), 1.};
+    return getHandle(modDims(createSubArray(y, index), xdims));
+}
+
+template<typename T>
+af_array iir(const af_array b, const af_array a, const af_array x,
+             const dim_t blockLen) {
+    if (blockLen > 0) { return iirBlocked<T>(b, a, x, blockLen); }
+    return getHandle(
+        detail::iir<T>(getArray<T>(b), getArray<T>(a), getArray<T>(x)));
+}
+
+}  // namespace
+
 af_err af_iir(af_array* y, const af_array b, const af_array a,
               const af_array x) {
+    AF_API_RANGE_ARRAY(b);
     try {
         const ArrayInfo& ainfo = getInfo(a);
         const ArrayInfo& binfo = getInfo(b);
@@ -83,12 +243,15 @@ af_err af_iir(af_array* y, const af_array b, const af_array a,
             return AF_SUCCESS;
         }
 
+        const dim_t blockLen =
+            ainfo.ndims() == 1 ? iirBlockLength(xdims, adims[0] - 1) : 0;
+
         af_array res;
         switch (xtype) {
-            case f32: res = iir<float>(b, a, x); break;
-            case f64: res = iir<double>(b, a, x); break;
-            case c32: res = iir<cfloat>(b, a, x); break;
-            case c64: res = iir<cdouble>(b, a, x); break;
+            case f32: res = iir<float>(b, a, x, blockLen); break;
+            case f64: res = iir<double>(b, a, x, blockLen); break;
+            case c32: res = iir<cfloat>(b, a, x, blockLen); break;
+            case c64: res = iir<cdouble>(b, a, x, blockLen); break;
             default: TYPE_ERROR(1, xtype);
         }
 
@@ -12,6 +12,7 @@
 #include <af/image.h>
 #include <af/index.h>
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <cast.hpp>
@@ -77,6 +78,7 @@ static fg_image convert_and_copy_image(const af_array in) {
 
 af_err af_draw_image(const af_window window, const af_array in,
                      const af_cell* const props) {
+    AF_API_RANGE_ARRAY(in);
     try {
         if (window == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
 
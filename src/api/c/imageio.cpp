@@ -11,6 +11,7 @@
 
 #include "imageio_helper.h"
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -28,11 +29,17 @@
 
 #include <common/DependencyModule.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <exception>
 #include <memory>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 using af::dim4;
 using detail::pinnedAlloc;
@@ -218,6 +225,7 @@ static af_err readImage(af_array* rImage, const uchar* pSrcLine,
 ////////////////////////////////////////////////////////////////////////////////
 // Load image from disk.
 af_err af_load_image(af_array* out, const char* filename, const bool isColor) {
+    AF_API_RANGE();
     try {
         ARG_ASSERT(1, filename != NULL);
 
@@ -514,8 +522,194 @@ af_err af_load_image(af_array* out, const char* filename, const bool isColor) {
     return AF_SUCCESS;
 }
 
+// Loads an image with 8 bits per channel for af_load_images
+static bitmap_ptr loadBitmap8(const char* filename, const bool isColor,
+                              uint& fi_color) {
+    FreeImage_Module& _ = getFreeImagePlugin();
+
+    FREE_IMAGE_FORMAT fif = _.FreeImage_GetFileType(filename, 0);
+    if (fif == FIF_UNKNOWN) { fif = _.FreeImage_GetFIFFromFilename(filename); }
+
+    if (fif == FIF_UNKNOWN) {
+        AF_ERROR("FreeImage Error: Unknown File or Filetype",
+                 AF_ERR_NOT_SUPPORTED);
+    }
+
+    unsigned flags = 0;
+    if (fif == FIF_JPEG) {
+        flags = flags | static_cast<unsigned>(JPEG_ACCURATE);
+    }
+#ifdef JPEG_GREYSCALE
+    if (fif == FIF_JPEG && !isColor) {
+        flags = flags | static_cast<unsigned>(JPEG_GREYSCALE);
+    }
+#endif
+
+    bitmap_ptr pBitmap = make_bitmap_ptr(NULL);
+    if (_.FreeImage_FIFSupportsReading(fif)) {
+        pBitmap.reset(_.FreeImage_Load(fif, filename, static_cast<int>(flags)));
+    }
+
+    if (pBitmap == NULL) {
+        AF_ERROR("FreeImage Error: Error reading image or file does not exist",
+                 AF_ERR_RUNTIME);
+    }
+
+    switch (_.FreeImage_GetColorType(pBitmap.get())) {
+        case 0:  // FIC_MINISBLACK
+        case 1:  // FIC_MINISWHITE
+            fi_color = 1;
+            break;
+        case 3:  // FIC_RGB
+            fi_color = 3;
+            break;
+        case 4:  // FIC_RGBALPHA
+            fi_color = 4;
+            break;
+        default:
+            AF_ERROR("FreeImage Error: Color type not supported in batches",
+                     AF_ERR_NOT_SUPPORTED);
+    }
+
+    if (_.FreeImage_GetImageType(pBitmap.get()) != FIT_BITMAP ||
+        _.FreeImage_GetBPP(pBitmap.get()) != 8 * fi_color) {
+        AF_ERROR("FreeImage Error: Only 8 bits per channel are supported",
+                 AF_ERR_NOT_SUPPORTED);
+    }
+    return pBitmap;
+}
+
+template<typename T>
+static T grayPixel(const uchar r, const uchar g, const uchar b) {
+    const float gray = r * 0.2989f + g * 0.5870f + b * 0.1140f;
+    return std::is_integral<T>::value ? static_cast<T>(std::round(gray))
+                                      : static_cast<T>(gray);
+}
+
+// Writes the channels of an 8 bit \p bitmap to consecutive planes of \p pDst
+template<typename T>
+static void copyBitmap8(T* pDst, FIBITMAP* bitmap, const uint fi_color,
+                        const uint channels) {
+    FreeImage_Module& _ = getFreeImagePlugin();
+
+    const uint fi_w       = _.FreeImage_GetWidth(bitmap);
+    const uint fi_h       = _.FreeImage_GetHeight(bitmap);
+    const uint nSrcPitch  = _.FreeImage_GetPitch(bitmap);
+    const uchar* pSrcLine =
+        _.FreeImage_GetBits(bitmap) + nSrcPitch * (fi_h - 1);
+    const size_t plane = static_cast<size_t>(fi_w) * fi_h;
+
+    size_t indx = 0;
+    for (uint x = 0; x < fi_w; ++x) {
+        for (uint y = 0; y < fi_h; ++y, ++indx) {
+            const uchar* src = pSrcLine - y * nSrcPitch + x * fi_color;
+            if (fi_color == 1) {
+                for (uint c = 0; c < channels; ++c) {
+                    pDst[c * plane + indx] = static_cast<T>(src[0]);
+                }
+            } else if (channels == 3) {
+                pDst[indx]             = static_cast<T>(src[FI_RGBA_RED]);
+                pDst[plane + indx]     = static_cast<T>(src[FI_RGBA_GREEN]);
+                pDst[2 * plane + indx] = static_cast<T>(src[FI_RGBA_BLUE]);
+            } else {
+                pDst[indx] = grayPixel<T>(src[FI_RGBA_RED], src[FI_RGBA_GREEN],
+                                          src[FI_RGBA_BLUE]);
+            }
+        }
+    }
+}
+
+template<typename T>
+static af_array loadImages(const char** filenames, const unsigned count,
+                           const bool isColor) {
+    FreeImage_Module& _ = getFreeImagePlugin();
+    _.FreeImage_SetOutputMessage(FreeImageErrorHandler);
+
+    // The first image gives the dimensions of the batch
+    uint fi_color       = 0;
+    bitmap_ptr pBitmap  = loadBitmap8(filenames[0], isColor, fi_color);
+    const uint fi_w     = _.FreeImage_GetWidth(pBitmap.get());
+    const uint fi_h     = _.FreeImage_GetHeight(pBitmap.get());
+    const uint channels = isColor ? 3 : 1;
+    const size_t slot   = static_cast<size_t>(fi_w) * fi_h * channels;
+
+    AF_CHECK(af_init());
+    T* pDst = pinnedAlloc<T>(slot * count);
+    copyBitmap8(pDst, pBitmap.get(), fi_color, channels);
+    pBitmap.reset();
+
+    // The other images are decoded by a pool of threads into their slots
+    std::vector<std::exception_ptr> errors(count);
+    auto decode = [&](unsigned first, unsigned step) {
+        for (unsigned i = first; i < count; i += step) {
+            try {
+                uint img_color = 0;
+                bitmap_ptr img = loadBitmap8(filenames[i], isColor, img_color);
+                if (_.FreeImage_GetWidth(img.get()) != fi_w ||
+                    _.FreeImage_GetHeight(img.get()) != fi_h) {
+                    AF_ERROR("The images of a batch must have the same size",
+                             AF_ERR_SIZE);
+                }
+                copyBitmap8(pDst + i * slot, img.get(), img_color, channels);
+            } catch (...) { errors[i] = std::current_exception(); }
+        }
+    };
+    const unsigned nthreads =
+        std::min(count - 1, std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < nthreads; ++t) {
+        workers.emplace_back(decode, t + 1, nthreads);
+    }
+    for (auto& worker : workers) { worker.join(); }
+
+    for (auto& error : errors) {
+        if (error) {
+            pinnedFree(pDst);
+            std::rethrow_exception(error);
+        }
+    }
+
+    af_array out;
+    dim4 dims(fi_h, fi_w, channels, count);
+    af_err err = af_create_array(&out, pDst, dims.ndims(), dims.get(),
+                                 (af_dtype)af::dtype_traits<T>::af_type);
+    pinnedFree(pDst);
+    AF_CHECK(err);
+    return out;
+}
+
+// Load a batch of images of the same size from disk.
+af_err af_load_images(af_array* out, const char** filenames,
+                      const unsigned count, const bool isColor,
+                      const af_dtype type) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(1, filenames != NULL);
+        ARG_ASSERT(2, count > 0);
+        for (unsigned i = 0; i < count; ++i) {
+            ARG_ASSERT(1, filenames[i] != NULL);
+        }
+
+        af_array rImage;
+        switch (type) {
+            case f32:
+                rImage = loadImages<float>(filenames, count, isColor);
+                break;
+            case u8:
+                rImage = loadImages<uchar>(filenames, count, isColor);
+                break;
+            default: TYPE_ERROR(4, type);
+        }
+        swap(*out, rImage);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
 // Save an image to disk.
 af_err af_save_image(const char* filename, const af_array in_) {
+    AF_API_RANGE_ARRAY(in_);
     try {
         ARG_ASSERT(0, filename != NULL);
 
@@ -707,6 +901,7 @@ af_err af_save_image(const char* filename, const af_array in_) {
 ////////////////////////////////////////////////////////////////////////////////
 /// Load image from memory.
 af_err af_load_image_memory(af_array* out, const void* ptr) {
+    AF_API_RANGE();
     try {
         ARG_ASSERT(1, ptr != NULL);
 
@@ -843,6 +1038,7 @@ af_err af_load_image_memory(af_array* out, const void* ptr) {
 // Save an image to memory.
 af_err af_save_image_memory(void** ptr, const af_array in_,
                             const af_image_format format) {
+    AF_API_RANGE_ARRAY(in_);
     try {
         FreeImage_Module& _ = getFreeImagePlugin();
 
@@ -1021,6 +1217,7 @@ af_err af_save_image_memory(void** ptr, const af_array in_,
 }
 
 af_err af_delete_image_memory(void* ptr) {
+    AF_API_RANGE();
     try {
         ARG_ASSERT(0, ptr != NULL);
 
@@ -1051,27 +1248,40 @@ af_err af_delete_image_memory(void* ptr) {
 #include <stdio.h>
 #include <af/image.h>
 af_err af_load_image(af_array *out, const char *filename, const bool isColor) {
+    AF_API_RANGE();
+    AF_RETURN_ERROR("ArrayFire compiled without Image IO (FreeImage) support",
+                    AF_ERR_NOT_CONFIGURED);
+}
+
+af_err af_load_images(af_array *out, const char **filenames,
+                      const unsigned count, const bool isColor,
+                      const af_dtype type) {
+    AF_API_RANGE();
     AF_RETURN_ERROR("ArrayFire compiled without Image IO (FreeImage) support",
                     AF_ERR_NOT_CONFIGURED);
 }
 
 af_err af_save_image(const char *filename, const af_array in_) {
+    AF_API_RANGE_ARRAY(in_);
     AF_RETURN_ERROR("ArrayFire compiled without Image IO (FreeImage) support",
                     AF_ERR_NOT_CONFIGURED);
 }
 
 af_err af_load_image_memory(af_array *out, const void *ptr) {
+    AF_API_RANGE();
     AF_RETURN_ERROR("ArrayFire compiled without Image IO (FreeImage) support",
                     AF_ERR_NOT_CONFIGURED);
 }
 
 af_err af_save_image_memory(void **ptr, const af_array in_,
                             const af_image_format format) {
+    AF_API_RANGE_ARRAY(in_);
     AF_RETURN_ERROR("ArrayFire compiled without Image IO (FreeImage) support",
                     AF_ERR_NOT_CONFIGURED);
 }
 
 af_err af_delete_image_memory(void *ptr) {
+    AF_API_RANGE();
     AF_RETURN_ERROR("ArrayFire compiled without Image IO (FreeImage) support",
                     AF_ERR_NOT_CONFIGURED);
 }
@@ -11,6 +11,7 @@
 
 #include "imageio_helper.h"
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -29,6 +30,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <string>
 
 using af::dim4;
@@ -44,43 +46,9 @@ static af_err readImage_t(af_array* rImage, const uchar* pSrcLine,
                           const uint fi_h) {
     // create an array to receive the loaded image data.
     AF_CHECK(af_init());
-    T* pDst  = pinnedAlloc<T>(fi_w * fi_h * 4);  // 4 channels is max
-    T* pDst0 = pDst;
-    T* pDst1 = pDst + (fi_w * fi_h * 1);
-    T* pDst2 = pDst + (fi_w * fi_h * 2);
-    T* pDst3 = pDst + (fi_w * fi_h * 3);
-
-    uint indx = 0;
-    uint step = fi_color;
-
-    for (uint x = 0; x < fi_w; ++x) {
-        for (uint y = 0; y < fi_h; ++y) {
-            const T* src = reinterpret_cast<T*>(const_cast<uchar*>(pSrcLine) -
-                                                y * nSrcPitch);
-            if (fi_color == 1) {
-                pDst0[indx] = *(src + (x * step));
-            } else if (fi_color >= 3) {
-                if (static_cast<af_dtype>(af::dtype_traits<T>::af_type) == u8) {
-                    pDst0[indx] = *(src + (x * step + FI_RGBA_RED));
-                    pDst1[indx] = *(src + (x * step + FI_RGBA_GREEN));
-                    pDst2[indx] = *(src + (x * step + FI_RGBA_BLUE));
-                    if (fi_color == 4) {
-                        pDst3[indx] = *(src + (x * step + FI_RGBA_ALPHA));
-                    }
-                } else {
-                    // Non 8-bit types do not use ordering
-                    // See Pixel Access Functions Chapter in FreeImage Doc
-                    pDst0[indx] = *(src + (x * step + 0));
-                    pDst1[indx] = *(src + (x * step + 1));
-                    pDst2[indx] = *(src + (x * step + 2));
-                    if (fi_color == 4) {
-                        pDst3[indx] = *(src + (x * step + 3));
-                    }
-                }
-            }
-            indx++;
-        }
-    }
+    T* pDst = pinnedAlloc<T>(fi_w * fi_h * fi_color);
+
+    deinterleave<T, fi_color>(pDst, pSrcLine, nSrcPitch, fi_w, fi_h);
 
     af::dim4 dims(fi_h, fi_w, fi_color, 1);
     af_err err =
@@ -121,6 +89,7 @@ FREE_IMAGE_TYPE getFIT(FI_CHANNELS channels, af_dtype type) {
 ////////////////////////////////////////////////////////////////////////////////
 // Load image from disk.
 af_err af_load_image_native(af_array* out, const char* filename) {
+    AF_API_RANGE();
     try {
         ARG_ASSERT(1, filename != NULL);
 
@@ -316,85 +285,23 @@ af_err af_load_image_native(af_array* out, const char* filename) {
 template<typename T, FI_CHANNELS channels>
 static void save_t(T* pDstLine, const af_array in, const dim4& dims,
                    uint nDstPitch) {
-    af_array rr = 0, gg = 0, bb = 0, aa = 0;
-    AF_CHECK(channel_split(in, dims, &rr, &gg, &bb,
-                           &aa));  // convert array to 3 channels if needed
-
-    af_array rrT = 0, ggT = 0, bbT = 0, aaT = 0;
-    T *pSrc0 = 0, *pSrc1 = 0, *pSrc2 = 0, *pSrc3 = 0;
-
-    uint step = channels;  // force 3 channels saving
-    uint indx = 0;
-
-    AF_CHECK(af_transpose(&rrT, rr, false));
-    if (channels >= 3) { AF_CHECK(af_transpose(&ggT, gg, false)); }
-    if (channels >= 3) { AF_CHECK(af_transpose(&bbT, bb, false)); }
-    if (channels >= 4) { AF_CHECK(af_transpose(&aaT, aa, false)); }
-
-    const ArrayInfo& cinfo = getInfo(rrT);
-    pSrc0                  = pinnedAlloc<T>(cinfo.elements());
-    if (channels >= 3) { pSrc1 = pinnedAlloc<T>(cinfo.elements()); }
-    if (channels >= 3) { pSrc2 = pinnedAlloc<T>(cinfo.elements()); }
-    if (channels >= 4) { pSrc3 = pinnedAlloc<T>(cinfo.elements()); }
-
-    AF_CHECK(af_get_data_ptr((void*)pSrc0, rrT));
-    if (channels >= 3) { AF_CHECK(af_get_data_ptr((void*)pSrc1, ggT)); }
-    if (channels >= 3) { AF_CHECK(af_get_data_ptr((void*)pSrc2, bbT)); }
-    if (channels >= 4) { AF_CHECK(af_get_data_ptr((void*)pSrc3, aaT)); }
+    // The planes of all the channels are read back at once
+    std::unique_ptr<T, void (*)(T*)> pSrc(
+        pinnedAlloc<T>(getInfo(in).elements()),
+        [](T* ptr) { pinnedFree(ptr); });
+    AF_CHECK(af_get_data_ptr(pSrc.get(), in));
 
     const uint fi_w = dims[1];
     const uint fi_h = dims[0];
 
     // Copy the array into FreeImage buffer
-    for (uint y = 0; y < fi_h; ++y) {
-        for (uint x = 0; x < fi_w; ++x) {
-            if (channels == 1) {
-                *(pDstLine + x * step) = pSrc0[indx];  // r -> 0
-            } else if (channels >= 3) {
-                if (static_cast<af_dtype>(af::dtype_traits<T>::af_type) == u8) {
-                    *(pDstLine + x * step + FI_RGBA_RED) =
-                        pSrc0[indx];  // r -> 0
-                    *(pDstLine + x * step + FI_RGBA_GREEN) =
-                        pSrc1[indx];  // g -> 1
-                    *(pDstLine + x * step + FI_RGBA_BLUE) =
-                        pSrc2[indx];  // b -> 2
-                    if (channels >= 4) {
-                        *(pDstLine + x * step + FI_RGBA_ALPHA) =
-                            pSrc3[indx];  // a
-                    }
-                } else {
-                    // Non 8-bit types do not use ordering
-                    // See Pixel Access Functions Chapter in FreeImage Doc
-                    *(pDstLine + x * step + 0) = pSrc0[indx];  // r -> 0
-                    *(pDstLine + x * step + 1) = pSrc1[indx];  // g -> 1
-                    *(pDstLine + x * step + 2) = pSrc2[indx];  // b -> 2
-                    if (channels >= 4) {
-                        *(pDstLine + x * step + 3) = pSrc3[indx];  // a
-                    }
-                }
-            }
-            ++indx;
-        }
-        pDstLine = reinterpret_cast<T*>(reinterpret_cast<uchar*>(pDstLine) -
-                                        nDstPitch);
-    }
-    pinnedFree(pSrc0);
-    if (channels >= 3) { pinnedFree(pSrc1); }
-    if (channels >= 3) { pinnedFree(pSrc2); }
-    if (channels >= 4) { pinnedFree(pSrc3); }
-
-    if (rr != 0) { AF_CHECK(af_release_array(rr)); }
-    if (gg != 0) { AF_CHECK(af_release_array(gg)); }
-    if (bb != 0) { AF_CHECK(af_release_array(bb)); }
-    if (aa != 0) { AF_CHECK(af_release_array(aa)); }
-    if (rrT != 0) { AF_CHECK(af_release_array(rrT)); }
-    if (ggT != 0) { AF_CHECK(af_release_array(ggT)); }
-    if (bbT != 0) { AF_CHECK(af_release_array(bbT)); }
-    if (aaT != 0) { AF_CHECK(af_release_array(aaT)); }
+    interleave<T, channels>(reinterpret_cast<uchar*>(pDstLine), nDstPitch,
+                            pSrc.get(), fi_w, fi_h);
 }
 
 // Save an image to disk.
 af_err af_save_image_native(const char* filename, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         ARG_ASSERT(0, filename != NULL);
 
@@ -527,6 +434,7 @@ af_err af_save_image_native(const char* filename, const af_array in) {
 }
 
 af_err af_is_image_io_available(bool* out) {
+    AF_API_RANGE();
     *out = true;
     return AF_SUCCESS;
 }
@@ -536,16 +444,19 @@ af_err af_is_image_io_available(bool* out) {
 #include <stdio.h>
 #include <af/image.h>
 af_err af_load_image_native(af_array* out, const char* filename) {
+    AF_API_RANGE();
     AF_RETURN_ERROR("ArrayFire compiled without Image IO (FreeImage) support",
                     AF_ERR_NOT_CONFIGURED);
 }
 
 af_err af_save_image_native(const char* filename, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     AF_RETURN_ERROR("ArrayFire compiled without Image IO (FreeImage) support",
                     AF_ERR_NOT_CONFIGURED);
 }
 
 af_err af_is_image_io_available(bool* out) {
+    AF_API_RANGE();
     *out = false;
     return AF_SUCCESS;
 }
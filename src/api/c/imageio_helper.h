@@ -18,8 +18,11 @@
 
 #include <FreeImage.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <type_traits>
 
 class FreeImage_Module {
     common::DependencyModule module;
@@ -73,6 +76,89 @@ static void FreeImageErrorHandler(FREE_IMAGE_FORMAT oFif,
     printf("FreeImage Error Handler: %s\n", zMessage);
 }
 
+// The images are transposed between the row major FreeImage bitmaps and the
+// column major arrays in square tiles of this size, so that the rows of the
+// bitmap and the columns of the array read by a tile stay in cache.
+constexpr unsigned IMAGE_TILE = 32;
+
+// Position of channel \p c in an interleaved pixel of a FreeImage bitmap.
+// 8 bit images use the byte order of FreeImage, the other types are stored
+// in RGBA order. See Pixel Access Functions Chapter in FreeImage Doc
+template<typename T, unsigned channels>
+static unsigned channelOffset(const unsigned c) {
+    static const unsigned byteOrder[] = {FI_RGBA_RED, FI_RGBA_GREEN,
+                                         FI_RGBA_BLUE, FI_RGBA_ALPHA};
+    if (channels == 1) { return 0; }
+    return std::is_same<T, unsigned char>::value ? byteOrder[c] : c;
+}
+
+// Copies the interleaved pixels of a \p fi_w by \p fi_h bitmap, whose top
+// row is at \p pSrcLine and whose rows go down by \p nSrcPitch bytes, to
+// the consecutive column major channel planes of \p pDst.
+template<typename T, unsigned channels>
+static void deinterleave(T *pDst, const unsigned char *pSrcLine,
+                         const int nSrcPitch, const unsigned fi_w,
+                         const unsigned fi_h) {
+    const size_t plane = static_cast<size_t>(fi_w) * fi_h;
+    unsigned offset[channels];
+    for (unsigned c = 0; c < channels; ++c) {
+        offset[c] = channelOffset<T, channels>(c);
+    }
+
+    for (unsigned y0 = 0; y0 < fi_h; y0 += IMAGE_TILE) {
+        const unsigned y1 = std::min(y0 + IMAGE_TILE, fi_h);
+        for (unsigned x0 = 0; x0 < fi_w; x0 += IMAGE_TILE) {
+            const unsigned x1 = std::min(x0 + IMAGE_TILE, fi_w);
+            for (unsigned x = x0; x < x1; ++x) {
+                T *dst = pDst + static_cast<size_t>(x) * fi_h;
+                for (unsigned y = y0; y < y1; ++y) {
+                    const T *src = reinterpret_cast<const T *>(
+                                       pSrcLine -
+                                       static_cast<std::ptrdiff_t>(y) *
+                                           nSrcPitch) +
+                                   static_cast<size_t>(x) * channels;
+                    for (unsigned c = 0; c < channels; ++c) {
+                        dst[c * plane + y] = src[offset[c]];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Copies the consecutive column major channel planes of \p pSrc to the
+// interleaved pixels of a \p fi_w by \p fi_h bitmap, whose top row is at
+// \p pDstLine and whose rows go down by \p nDstPitch bytes.
+template<typename T, unsigned channels>
+static void interleave(unsigned char *pDstLine, const int nDstPitch,
+                       const T *pSrc, const unsigned fi_w,
+                       const unsigned fi_h) {
+    const size_t plane = static_cast<size_t>(fi_w) * fi_h;
+    unsigned offset[channels];
+    for (unsigned c = 0; c < channels; ++c) {
+        offset[c] = channelOffset<T, channels>(c);
+    }
+
+    for (unsigned y0 = 0; y0 < fi_h; y0 += IMAGE_TILE) {
+        const unsigned y1 = std::min(y0 + IMAGE_TILE, fi_h);
+        for (unsigned x0 = 0; x0 < fi_w; x0 += IMAGE_TILE) {
+            const unsigned x1 = std::min(x0 + IMAGE_TILE, fi_w);
+            for (unsigned x = x0; x < x1; ++x) {
+                const T *src = pSrc + static_cast<size_t>(x) * fi_h;
+                for (unsigned y = y0; y < y1; ++y) {
+                    T *dst = reinterpret_cast<T *>(
+                                 pDstLine -
+                                 static_cast<std::ptrdiff_t>(y) * nDstPitch) +
+                             static_cast<size_t>(x) * channels;
+                    for (unsigned c = 0; c < channels; ++c) {
+                        dst[offset[c]] = src[c * plane + y];
+                    }
+                }
+            }
+        }
+    }
+}
+
 //  Split a MxNx3 image into 3 separate channel matrices.
 //  Produce 3 channels if needed
 static af_err channel_split(const af_array rgb, const af::dim4 &dims,
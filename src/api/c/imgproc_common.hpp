@@ -14,7 +14,7 @@
 #include <cast.hpp>
 #include <logic.hpp>
 #include <reduce.hpp>
-#include <scan.hpp>
+#include <sat.hpp>
 
 #include <cmath>
 
@@ -22,9 +22,7 @@ namespace common {
 
 template<typename To, typename Ti = To>
 detail::Array<To> integralImage(const detail::Array<Ti>& in) {
-    auto input                       = detail::cast<To, Ti>(in);
-    detail::Array<To> horizontalScan = detail::scan<af_add_t, To, To>(input, 0);
-    return detail::scan<af_add_t, To, To>(horizontalScan, 1);
+    return detail::sat<Ti, To>(in);
 }
 
 template<typename T>
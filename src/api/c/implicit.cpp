@@ -29,7 +29,11 @@ af_dtype implicit(const af_dtype lty, const af_dtype rty) {
 
     if (lty == f64 || rty == f64) { return f64; }
     if (lty == f32 || rty == f32) { return f32; }
+    if ((lty == f16 && rty == bf16) || (lty == bf16 && rty == f16)) {
+        return f32;
+    }
     if ((lty == f16) || (rty == f16)) { return f16; }
+    if ((lty == bf16) || (rty == bf16)) { return bf16; }
 
     if ((lty == u64) || (rty == u64)) { return u64; }
     if ((lty == s64) || (rty == s64)) { return s64; }
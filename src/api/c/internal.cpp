@@ -8,7 +8,9 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <api_range.hpp>
 #include <backend.hpp>
+#include <common/bfloat16.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <handle.hpp>
@@ -20,6 +22,7 @@
 #include <cstring>
 
 using af::dim4;
+using common::bfloat16;
 using common::half;
 using detail::cdouble;
 using detail::cfloat;
@@ -35,6 +38,7 @@ af_err af_create_strided_array(af_array *arr, const void *data,
                                const dim_t *const dims_,
                                const dim_t *const strides_, const af_dtype ty,
                                const af_source location) {
+    AF_API_RANGE();
     try {
         ARG_ASSERT(2, offset >= 0);
         ARG_ASSERT(3, ndims >= 1 && ndims <= 4);
@@ -125,6 +129,11 @@ af_err af_create_strided_array(af_array *arr, const void *data,
                     dims, strides, offset, static_cast<half *>(in_data),
                     isdev));
                 break;
+            case bf16:
+                res = getHandle(createStridedArray<bfloat16>(
+                    dims, strides, offset, static_cast<bfloat16 *>(in_data),
+                    isdev));
+                break;
             default: TYPE_ERROR(6, ty);
         }
 
@@ -136,6 +145,7 @@ af_err af_create_strided_array(af_array *arr, const void *data,
 
 af_err af_get_strides(dim_t *s0, dim_t *s1, dim_t *s2, dim_t *s3,
                       const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in);
         *s0                   = info.strides()[0];
@@ -148,6 +158,7 @@ af_err af_get_strides(dim_t *s0, dim_t *s1, dim_t *s2, dim_t *s3,
 }
 
 af_err af_get_offset(dim_t *offset, const af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         dim_t res = getInfo(arr).getOffset();
         std::swap(*offset, res);
@@ -157,6 +168,7 @@ af_err af_get_offset(dim_t *offset, const af_array arr) {
 }
 
 af_err af_get_raw_ptr(void **ptr, const af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         void *res = NULL;
 
@@ -176,6 +188,7 @@ af_err af_get_raw_ptr(void **ptr, const af_array arr) {
             case b8: res = getRawPtr(getArray<char>(arr)); break;
             case u8: res = getRawPtr(getArray<uchar>(arr)); break;
             case f16: res = getRawPtr(getArray<half>(arr)); break;
+            case bf16: res = getRawPtr(getArray<bfloat16>(arr)); break;
             default: TYPE_ERROR(6, ty);
         }
 
@@ -186,6 +199,7 @@ af_err af_get_raw_ptr(void **ptr, const af_array arr) {
 }
 
 af_err af_is_linear(bool *result, const af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         *result = getInfo(arr).isLinear();
     }
@@ -194,6 +208,7 @@ af_err af_is_linear(bool *result, const af_array arr) {
 }
 
 af_err af_is_owner(bool *result, const af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         bool res = false;
 
@@ -213,6 +228,7 @@ af_err af_is_owner(bool *result, const af_array arr) {
             case b8: res = getArray<char>(arr).isOwner(); break;
             case u8: res = getArray<uchar>(arr).isOwner(); break;
             case f16: res = getArray<half>(arr).isOwner(); break;
+            case bf16: res = getArray<bfloat16>(arr).isOwner(); break;
             default: TYPE_ERROR(6, ty);
         }
 
@@ -223,6 +239,7 @@ af_err af_is_owner(bool *result, const af_array arr) {
 }
 
 af_err af_get_allocated_bytes(size_t *bytes, const af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         af_dtype ty = getInfo(arr).getType();
 
@@ -242,6 +259,9 @@ af_err af_get_allocated_bytes(size_t *bytes, const af_array arr) {
             case b8: res = getArray<char>(arr).getAllocatedBytes(); break;
             case u8: res = getArray<uchar>(arr).getAllocatedBytes(); break;
             case f16: res = getArray<half>(arr).getAllocatedBytes(); break;
+            case bf16:
+                res = getArray<bfloat16>(arr).getAllocatedBytes();
+                break;
             default: TYPE_ERROR(6, ty);
         }
 
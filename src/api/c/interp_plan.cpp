@@ -0,0 +1,466 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <api_range.hpp>
+#include <arith.hpp>
+#include <backend.hpp>
+#include <cast.hpp>
+#include <common/ArrayInfo.hpp>
+#include <common/err_common.hpp>
+#include <copy.hpp>
+#include <handle.hpp>
+#include <lookup.hpp>
+#include <af/array.h>
+#include <af/constants.h>
+#include <af/defines.h>
+#include <af/dim4.hpp>
+#include <af/signal.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+using af::dim4;
+using detail::arithOp;
+using detail::Array;
+using detail::cast;
+using detail::cdouble;
+using detail::cfloat;
+using detail::copyData;
+using detail::createHostDataArray;
+using detail::lookup;
+using detail::uint;
+using std::vector;
+
+namespace {
+
+/// The input elements read by the queries of a plan and their weights. The
+/// taps of query q are at q * taps + i.
+struct Taps {
+    dim_t taps;
+    vector<uint> indices;
+    vector<double> weights;
+    vector<bool> offGrid;
+};
+
+/// An interpolation plan of af_create_approx1_plan or
+/// af_create_approx2_plan. The arrays are held as handles because their
+/// types are only known at run time.
+struct InterpPlan {
+    int rank;
+    dim4 inDims;     // The sizes of the interpolated dimensions
+    dim4 queryDims;  // The dimensions of the positions
+    af_dtype type;   // The type of the positions and weights
+    vector<af_array> indices;  // One index array per tap
+    vector<af_array> weights;  // One weight array per tap
+    af_array offGrid;          // The values of the off grid queries or null
+    af_array order;  // The ranks of the queries in the sorted order, or null
+                     // if the queries are sorted
+};
+
+int interpOrder(const af_interp_type method) {
+    switch (method) {
+        case AF_INTERP_NEAREST:
+        case AF_INTERP_LOWER: return 1;
+        case AF_INTERP_LINEAR:
+        case AF_INTERP_BILINEAR:
+        case AF_INTERP_LINEAR_COSINE:
+        case AF_INTERP_BILINEAR_COSINE: return 2;
+        default: return 3;
+    }
+}
+
+/// The weights of the two elements around a position, where \p ratio is
+/// the distance from the first one
+void linearWeights(const af_interp_type method, double ratio, double w[2]) {
+    if (method == AF_INTERP_LINEAR_COSINE ||
+        method == AF_INTERP_BILINEAR_COSINE) {
+        // Smooth the factional part with cosine
+        ratio = (1 - std::cos(ratio * af::Pi)) / 2;
+    }
+    w[0] = 1 - ratio;
+    w[1] = ratio;
+}
+
+/// The weights of the four elements around a position. They are the results
+/// of the cubic interpolation of the approx kernels for each unit input.
+void cubicWeights(const af_interp_type method, const double ratio,
+                  double w[4]) {
+    const bool spline = (method == AF_INTERP_CUBIC_SPLINE ||
+                         method == AF_INTERP_BICUBIC_SPLINE);
+    const double ratio2 = ratio * ratio;
+    const double ratio3 = ratio2 * ratio;
+    for (int i = 0; i < 4; ++i) {
+        double val[4] = {0, 0, 0, 0};
+        val[i]        = 1;
+
+        double a0, a1, a2, a3;
+        if (spline) {
+            a0 = -0.5 * val[0] + 1.5 * val[1] - 1.5 * val[2] + 0.5 * val[3];
+            a1 = val[0] - 2.5 * val[1] + 2.0 * val[2] - 0.5 * val[3];
+            a2 = -0.5 * val[0] + 0.5 * val[2];
+            a3 = val[1];
+        } else {
+            a0 = val[3] - val[2] - val[0] + val[1];
+            a1 = val[0] - val[1] - a0;
+            a2 = val[2] - val[0];
+            a3 = val[1];
+        }
+        w[i] = a0 * ratio3 + a1 * ratio2 + a2 * ratio + a3;
+    }
+}
+
+/// The elements and weights along one dimension of length \p len of a
+/// position \p x inside the input. The elements past the ends are replaced
+/// as the approx kernels do.
+int axisTaps(const af_interp_type method, const int order, const double x,
+             const dim_t len, int idx[4], double w[4]) {
+    const int grid = static_cast<int>(std::floor(x));
+    switch (order) {
+        case 1:
+            idx[0] = static_cast<int>(
+                method == AF_INTERP_LOWER ? std::floor(x) : std::round(x));
+            w[0]   = 1;
+            return 1;
+        case 2: {
+            const bool next = x + 1 < len;
+            idx[0]          = grid;
+            idx[1]          = grid + (next ? 1 : 0);
+            linearWeights(method, x - grid, w);
+            // The approx kernels read zero past the end
+            if (!next) { w[1] = 0; }
+            return 2;
+        }
+        default: {
+            const bool cond[4] = {grid - 1 >= 0, true, grid + 1 < len,
+                                  grid + 2 < len};
+            const int off[4]   = {cond[0] ? -1 : 0, 0, cond[2] ? 1 : 0,
+                                cond[3] ? 2 : (cond[2] ? 1 : 0)};
+            for (int i = 0; i < 4; ++i) { idx[i] = grid + off[i]; }
+            cubicWeights(method, x - grid, w);
+            return 4;
+        }
+    }
+}
+
+Taps approx1Taps(const vector<double> &pos, const dim_t len,
+                 const af_interp_type method) {
+    const int order = interpOrder(method);
+    Taps taps;
+    taps.taps = order == 3 ? 4 : order;
+    taps.indices.assign(pos.size() * taps.taps, 0);
+    taps.weights.assign(pos.size() * taps.taps, 0);
+    taps.offGrid.assign(pos.size(), false);
+
+    for (size_t q = 0; q < pos.size(); ++q) {
+        const double x = pos[q];
+        if (!(x >= 0 && x + 1 <= len)) {
+            taps.offGrid[q] = true;
+            continue;
+        }
+        int idx[4];
+        double w[4];
+        axisTaps(method, order, x, len, idx, w);
+        for (dim_t i = 0; i < taps.taps; ++i) {
+            taps.indices[q * taps.taps + i] = idx[i];
+            taps.weights[q * taps.taps + i] = w[i];
+        }
+    }
+    return taps;
+}
+
+Taps approx2Taps(const vector<double> &pos0, const vector<double> &pos1,
+                 const dim_t rows, const dim_t cols,
+                 const af_interp_type method) {
+    const int order = interpOrder(method);
+    const int axis  = order == 3 ? 4 : order;
+    Taps taps;
+    taps.taps = axis * axis;
+    taps.indices.assign(pos0.size() * taps.taps, 0);
+    taps.weights.assign(pos0.size() * taps.taps, 0);
+    taps.offGrid.assign(pos0.size(), false);
+
+    for (size_t q = 0; q < pos0.size(); ++q) {
+        const double x = pos0[q];
+        const double y = pos1[q];
+        if (!(x >= 0 && x + 1 <= rows && y >= 0 && y + 1 <= cols)) {
+            taps.offGrid[q] = true;
+            continue;
+        }
+        int idx[4], idy[4];
+        double wx[4], wy[4];
+        axisTaps(method, order, x, rows, idx, wx);
+        axisTaps(method, order, y, cols, idy, wy);
+        for (int j = 0; j < axis; ++j) {
+            for (int i = 0; i < axis; ++i) {
+                const dim_t t = q * taps.taps + j * axis + i;
+                taps.indices[t] = idx[i] + idy[j] * rows;
+                taps.weights[t] = wx[i] * wy[j];
+            }
+        }
+    }
+    return taps;
+}
+
+/// Returns true if the first taps of the queries never increase or never
+/// decrease, so each tap reads the input in order
+bool isSorted(const Taps &taps) {
+    const dim_t nQueries = taps.offGrid.size();
+    bool ascending = true, descending = true;
+    for (dim_t q = 1; q < nQueries; ++q) {
+        const uint prev = taps.indices[(q - 1) * taps.taps];
+        const uint curr = taps.indices[q * taps.taps];
+        ascending &= prev <= curr;
+        descending &= prev >= curr;
+    }
+    return ascending || descending;
+}
+
+template<typename T>
+af_array hostHandle(const vector<T> &data) {
+    return getHandle(createHostDataArray<T>(
+        dim4(static_cast<dim_t>(data.size())), data.data()));
+}
+
+/// Creates the arrays of a plan from its taps. Unsorted queries are sorted
+/// by their first tap, so the taps read the input in order, and the ranks
+/// restore the order of the results.
+template<typename LocT>
+void createPlanArrays(InterpPlan &plan, const Taps &taps, const float offGrid) {
+    const dim_t nQueries = taps.offGrid.size();
+
+    vector<dim_t> sorted(nQueries);
+    std::iota(sorted.begin(), sorted.end(), 0);
+    if (!isSorted(taps)) {
+        std::stable_sort(sorted.begin(), sorted.end(),
+                         [&taps](const dim_t lhs, const dim_t rhs) {
+                             return taps.indices[lhs * taps.taps] <
+                                    taps.indices[rhs * taps.taps];
+                         });
+        vector<uint> ranks(nQueries);
+        for (dim_t s = 0; s < nQueries; ++s) {
+            ranks[sorted[s]] = static_cast<uint>(s);
+        }
+        plan.order = hostHandle(ranks);
+    }
+
+    vector<uint> indices(nQueries);
+    vector<LocT> weights(nQueries);
+    for (dim_t i = 0; i < taps.taps; ++i) {
+        for (dim_t s = 0; s < nQueries; ++s) {
+            const dim_t t = sorted[s] * taps.taps + i;
+            indices[s]    = taps.indices[t];
+            weights[s]    = static_cast<LocT>(taps.weights[t]);
+        }
+        plan.indices.push_back(hostHandle(indices));
+        plan.weights.push_back(hostHandle(weights));
+    }
+
+    vector<LocT> offValues(nQueries, LocT(0));
+    bool anyOffGrid = false;
+    for (dim_t s = 0; s < nQueries; ++s) {
+        if (taps.offGrid[sorted[s]]) {
+            offValues[s] = static_cast<LocT>(offGrid);
+            anyOffGrid   = true;
+        }
+    }
+    if (anyOffGrid) { plan.offGrid = hostHandle(offValues); }
+}
+
+template<typename LocT>
+vector<double> hostPositions(const af_array pos) {
+    const Array<LocT> &positions = getArray<LocT>(pos);
+    vector<LocT> data(positions.elements());
+    copyData(data.data(), positions);
+    return vector<double>(data.begin(), data.end());
+}
+
+vector<double> hostPositions(const af_array pos) {
+    const ArrayInfo &info = getInfo(pos);
+    switch (info.getType()) {
+        case f32: return hostPositions<float>(pos);
+        case f64: return hostPositions<double>(pos);
+        default: TYPE_ERROR(1, info.getType());
+    }
+}
+
+void releasePlan(InterpPlan *plan) {
+    for (af_array arr : plan->indices) { af_release_array(arr); }
+    for (af_array arr : plan->weights) { af_release_array(arr); }
+    if (plan->offGrid) { af_release_array(plan->offGrid); }
+    if (plan->order) { af_release_array(plan->order); }
+    delete plan;
+}
+
+af_interp_plan createPlan(const int rank, const dim4 &inDims,
+                          const dim4 &queryDims, const af_dtype type,
+                          const Taps &taps, const float offGrid) {
+    auto *plan = new InterpPlan{rank, inDims, queryDims, type, {}, {}, 0, 0};
+    try {
+        if (type == f32) {
+            createPlanArrays<float>(*plan, taps, offGrid);
+        } else {
+            createPlanArrays<double>(*plan, taps, offGrid);
+        }
+    } catch (...) {
+        releasePlan(plan);
+        throw;
+    }
+    return static_cast<af_interp_plan>(plan);
+}
+
+InterpPlan &getInterpPlan(const af_interp_plan handle) {
+    if (!handle) { AF_ERROR("Invalid af_interp_plan handle", AF_ERR_ARG); }
+    return *static_cast<InterpPlan *>(handle);
+}
+
+bool isPlanMethod(const af_interp_type method) {
+    return method == AF_INTERP_NEAREST || method == AF_INTERP_LOWER ||
+           method == AF_INTERP_LINEAR || method == AF_INTERP_LINEAR_COSINE ||
+           method == AF_INTERP_CUBIC || method == AF_INTERP_CUBIC_SPLINE;
+}
+
+bool is2DPlanMethod(const af_interp_type method) {
+    return isPlanMethod(method) || method == AF_INTERP_BILINEAR ||
+           method == AF_INTERP_BILINEAR_COSINE ||
+           method == AF_INTERP_BICUBIC || method == AF_INTERP_BICUBIC_SPLINE;
+}
+
+/// Interpolates \p in with a plan. Each tap gathers one element of every
+/// query from the flattened interpolated dimensions and the weighted taps
+/// are summed by the JIT.
+template<typename T, typename LocT>
+af_array applyPlan(const InterpPlan &plan, const af_array in) {
+    const Array<T> &input = getArray<T>(in);
+    const dim4 &idims     = input.dims();
+    const dim_t inLen     = plan.inDims[0] * plan.inDims[1];
+    const dim_t nQueries  = plan.queryDims.elements();
+    const dim4 flatDims(inLen, idims.elements() / inLen);
+
+    const Array<T> flatIn = modDims(input, flatDims);
+    const dim4 odims(nQueries, flatDims[1]);
+
+    auto tap = [&](const size_t i) {
+        const Array<T> taps =
+            lookup<T, uint>(flatIn, getArray<uint>(plan.indices[i]), 0);
+        const Array<T> weights = cast<T, LocT>(getArray<LocT>(plan.weights[i]));
+        return arithOp<T, af_mul_t>(taps, weights, odims);
+    };
+
+    Array<T> out = tap(0);
+    for (size_t i = 1; i < plan.indices.size(); ++i) {
+        out = arithOp<T, af_add_t>(out, tap(i), odims);
+    }
+    if (plan.offGrid) {
+        out = arithOp<T, af_add_t>(
+            out, cast<T, LocT>(getArray<LocT>(plan.offGrid)), odims);
+    }
+    if (plan.order) {
+        out = lookup<T, uint>(out, getArray<uint>(plan.order), 0);
+    }
+
+    dim4 outDims = idims;
+    for (int i = 0; i < plan.rank; ++i) { outDims[i] = plan.queryDims[i]; }
+    return getHandle(modDims(out, outDims));
+}
+
+}  // namespace
+
+af_err af_create_approx1_plan(af_interp_plan *plan, const af_array pos,
+                              const dim_t in_length,
+                              const af_interp_type method,
+                              const float off_grid) {
+    AF_API_RANGE_ARRAY(pos);
+    try {
+        ARG_ASSERT(0, plan != 0);
+        const ArrayInfo &pInfo = getInfo(pos);
+        ARG_ASSERT(1, pInfo.isRealFloating());
+        ARG_ASSERT(1, pInfo.ndims() == 1);
+        ARG_ASSERT(2, in_length > 0 &&
+                          in_length <= std::numeric_limits<uint>::max());
+        ARG_ASSERT(3, isPlanMethod(method));
+
+        const Taps taps = approx1Taps(hostPositions(pos), in_length, method);
+        *plan = createPlan(1, dim4(in_length), pInfo.dims(), pInfo.getType(),
+                           taps, off_grid);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_create_approx2_plan(af_interp_plan *plan, const af_array pos0,
+                              const af_array pos1, const dim_t in_rows,
+                              const dim_t in_cols,
+                              const af_interp_type method,
+                              const float off_grid) {
+    AF_API_RANGE_ARRAY(pos0);
+    try {
+        ARG_ASSERT(0, plan != 0);
+        const ArrayInfo &xInfo = getInfo(pos0);
+        const ArrayInfo &yInfo = getInfo(pos1);
+        ARG_ASSERT(1, xInfo.isRealFloating());
+        ARG_ASSERT(1, xInfo.ndims() > 0 && xInfo.ndims() <= 2);
+        ARG_ASSERT(2, xInfo.getType() == yInfo.getType());
+        DIM_ASSERT(2, xInfo.dims() == yInfo.dims());
+        ARG_ASSERT(3, in_rows > 0);
+        ARG_ASSERT(4, in_cols > 0 && in_rows * in_cols <=
+                                         std::numeric_limits<uint>::max());
+        ARG_ASSERT(5, is2DPlanMethod(method));
+
+        const Taps taps = approx2Taps(hostPositions(pos0), hostPositions(pos1),
+                                      in_rows, in_cols, method);
+        *plan = createPlan(2, dim4(in_rows, in_cols), xInfo.dims(),
+                           xInfo.getType(), taps, off_grid);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_apply_interp_plan(af_array *out, const af_interp_plan plan,
+                            const af_array in) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const InterpPlan &p    = getInterpPlan(plan);
+        const ArrayInfo &iInfo = getInfo(in);
+        const dim4 &idims      = iInfo.dims();
+
+        ARG_ASSERT(2, iInfo.isFloating());
+        ARG_ASSERT(2, iInfo.isDouble() == (p.type == f64));
+        for (int i = 0; i < p.rank; ++i) {
+            DIM_ASSERT(2, idims[i] == p.inDims[i]);
+        }
+
+        af_array output;
+        switch (iInfo.getType()) {
+            case f32: output = applyPlan<float, float>(p, in); break;
+            case f64: output = applyPlan<double, double>(p, in); break;
+            case c32: output = applyPlan<cfloat, float>(p, in); break;
+            case c64: output = applyPlan<cdouble, double>(p, in); break;
+            default: TYPE_ERROR(2, iInfo.getType());
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_release_interp_plan(af_interp_plan plan) {
+    AF_API_RANGE();
+    try {
+        releasePlan(&getInterpPlan(plan));
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -25,13 +26,10 @@ static inline af_array inverse(const af_array in) {
 }
 
 af_err af_inverse(af_array* out, const af_array in, const af_mat_prop options) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& i_info = getInfo(in);
 
-        if (i_info.ndims() > 2) {
-            AF_ERROR("solve can not be used in batch mode", AF_ERR_BATCH);
-        }
-
         af_dtype type = i_info.getType();
 
         if (options != AF_MAT_NONE) {
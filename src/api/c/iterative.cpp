@@ -0,0 +1,516 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <api_range.hpp>
+#include <arith.hpp>
+#include <backend.hpp>
+#include <blas.hpp>
+#include <cast.hpp>
+#include <common/ArrayInfo.hpp>
+#include <common/SparseArray.hpp>
+#include <common/err_common.hpp>
+#include <complex.hpp>
+#include <copy.hpp>
+#include <handle.hpp>
+#include <join.hpp>
+#include <solve.hpp>
+#include <sparse_blas.hpp>
+#include <sparse_handle.hpp>
+#include <tile.hpp>
+#include <unary.hpp>
+#include <af/array.h>
+#include <af/defines.h>
+#include <af/lapack.h>
+#include <af/seq.h>
+#include <af/traits.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using af::dim4;
+using common::SparseArray;
+using common::SparseArrayBase;
+using detail::arithOp;
+using detail::Array;
+using detail::cdouble;
+using detail::cfloat;
+using detail::createEmptyArray;
+using detail::createSubArray;
+using detail::createValueArray;
+using detail::evalMultiple;
+using detail::scalar;
+using std::vector;
+
+// The iterative solvers keep their scalars in 1 x 1 arrays on the device.
+// They are broadcast to the vectors with lazy tiles, so that the updates of
+// the vectors are fused by the JIT, and only the norm of the residual is read
+// back, once every check_interval iterations.
+
+/// Returns A * x for a dense or a sparse matrix A
+template<typename T>
+static Array<T> applyMatrix(const af_array A, const Array<T> &x) {
+    if (getInfo(A, false, true).isSparse()) {
+        return detail::matmul(getSparseArray<T>(A), x, AF_MAT_NONE,
+                              AF_MAT_NONE);
+    }
+    return detail::matmul(getArray<T>(A), x, AF_MAT_NONE, AF_MAT_NONE);
+}
+
+/// Returns the preconditioner \p M of \p type applied to \p x
+template<typename T>
+static Array<T> applyPrecond(const af_precond_type type, const af_array M,
+                             const Array<T> &x) {
+    switch (type) {
+        case AF_PRECOND_JACOBI:
+            return arithOp<T, af_mul_t>(getArray<T>(M), x, x.dims());
+        case AF_PRECOND_ILU0:
+        case AF_PRECOND_IC0: {
+            const af_mat_prop lower =
+                type == AF_PRECOND_ILU0
+                    ? static_cast<af_mat_prop>(AF_MAT_LOWER | AF_MAT_DIAG_UNIT)
+                    : AF_MAT_LOWER;
+            const SparseArray<T> &factor = getSparseArray<T>(M);
+            return detail::solve(factor, detail::solve(factor, x, lower),
+                                 AF_MAT_UPPER);
+        }
+        case AF_PRECOND_MATRIX: return applyMatrix<T>(M, x);
+        default: return x;
+    }
+}
+
+/// Returns the product of the scalar \p s with the vector \p v
+template<typename T>
+static Array<T> scaled(const Array<T> &s, const Array<T> &v) {
+    return arithOp<T, af_mul_t>(detail::tile(s, dim4(v.dims()[0])), v,
+                                v.dims());
+}
+
+/// Returns the inner product of \p a and \p b, conjugating \p a
+template<typename T>
+static Array<T> inner(const Array<T> &a, const Array<T> &b) {
+    return detail::dot<T>(a, b, AF_MAT_CONJ, AF_MAT_NONE);
+}
+
+template<typename T>
+static Array<T> divide(const Array<T> &a, const Array<T> &b) {
+    return arithOp<T, af_div_t>(a, b, a.dims());
+}
+
+/// Returns the norm of \p v as a scalar on the device
+template<typename T>
+static Array<T> norm2(const Array<T> &v) {
+    using BT = typename af::dtype_traits<T>::base_type;
+    return detail::cast<T, BT>(
+        detail::unaryOp<BT, af_sqrt_t>(detail::abs<BT, T>(inner(v, v))));
+}
+
+/// Returns the squared norm of \p v, which is read back to the host
+template<typename T>
+static double squaredNorm(const Array<T> &v) {
+    using BT = typename af::dtype_traits<T>::base_type;
+    return detail::getScalar<BT>(detail::abs<BT, T>(inner(v, v)));
+}
+
+/// Returns true when the squared norm of the residual \p r is below
+/// \p bound. A breakdown of the iterations also stops them.
+template<typename T>
+static bool converged(const Array<T> &r, const double bound) {
+    const double res = squaredNorm(r);
+    return res <= bound || std::isnan(res);
+}
+
+template<typename T>
+static Array<T> initialGuess(const af_array x0, const dim4 &dims) {
+    if (x0) { return getArray<T>(x0); }
+    return createValueArray<T>(dims, scalar<T>(0));
+}
+
+template<typename T>
+static Array<T> columns(const Array<T> &in, const dim_t first,
+                        const dim_t last) {
+    const vector<af_seq> index = {
+        af_span,
+        {static_cast<double>(first), static_cast<double>(last), 1.}};
+    return createSubArray(in, index, false);
+}
+
+template<typename T>
+static af_array cg(unsigned *iterations, const af_array A, const af_array b,
+                   const double tol, const unsigned maxIterations,
+                   const af_precond_type ptype, const af_array precond,
+                   const af_array x0, const unsigned check) {
+    const Array<T> B   = getArray<T>(b);
+    const dim4 &dims   = B.dims();
+    const double bound = tol * tol * squaredNorm(B);
+
+    Array<T> x = initialGuess<T>(x0, dims);
+    Array<T> r = arithOp<T, af_sub_t>(B, applyMatrix<T>(A, x), dims);
+    r.eval();
+
+    Array<T> p  = applyPrecond<T>(ptype, precond, r);
+    Array<T> rz = inner(r, p);
+
+    unsigned it = 0;
+    if (!converged(r, bound)) {
+        while (it < maxIterations) {
+            ++it;
+            const Array<T> q     = applyMatrix<T>(A, p);
+            const Array<T> alpha = divide(rz, inner(p, q));
+
+            x = arithOp<T, af_add_t>(x, scaled(alpha, p), dims);
+            r = arithOp<T, af_sub_t>(r, scaled(alpha, q), dims);
+            evalMultiple<T>({&x, &r});
+            if (it % check == 0 && converged(r, bound)) { break; }
+
+            const Array<T> z     = applyPrecond<T>(ptype, precond, r);
+            const Array<T> rzNew = inner(r, z);
+            p = arithOp<T, af_add_t>(z, scaled(divide(rzNew, rz), p), dims);
+            p.eval();
+            rz = rzNew;
+        }
+    }
+
+    if (iterations) { *iterations = it; }
+    return getHandle(x);
+}
+
+template<typename T>
+static af_array bicgstab(unsigned *iterations, const af_array A,
+                         const af_array b, const double tol,
+                         const unsigned maxIterations,
+                         const af_precond_type ptype, const af_array precond,
+                         const af_array x0, const unsigned check) {
+    const Array<T> B   = getArray<T>(b);
+    const dim4 &dims   = B.dims();
+    const double bound = tol * tol * squaredNorm(B);
+
+    Array<T> x = initialGuess<T>(x0, dims);
+    Array<T> r = arithOp<T, af_sub_t>(B, applyMatrix<T>(A, x), dims);
+    r.eval();
+    const Array<T> rHat = r;
+
+    // With these values, the first direction is the residual
+    const Array<T> one = createValueArray<T>(dim4(1), scalar<T>(1));
+    Array<T> rho       = one;
+    Array<T> alpha     = one;
+    Array<T> omega     = one;
+    Array<T> p         = createValueArray<T>(dims, scalar<T>(0));
+    Array<T> v         = p;
+
+    unsigned it = 0;
+    if (!converged(r, bound)) {
+        while (it < maxIterations) {
+            ++it;
+            const Array<T> rhoNew = inner(rHat, r);
+            const Array<T> beta   = arithOp<T, af_mul_t>(
+                divide(rhoNew, rho), divide(alpha, omega), rho.dims());
+            p = arithOp<T, af_add_t>(
+                r,
+                scaled(beta, arithOp<T, af_sub_t>(p, scaled(omega, v), dims)),
+                dims);
+            p.eval();
+
+            const Array<T> pHat = applyPrecond<T>(ptype, precond, p);
+            v                   = applyMatrix<T>(A, pHat);
+            alpha               = divide(rhoNew, inner(rHat, v));
+
+            Array<T> s = arithOp<T, af_sub_t>(r, scaled(alpha, v), dims);
+            s.eval();
+            const Array<T> sHat = applyPrecond<T>(ptype, precond, s);
+            const Array<T> t    = applyMatrix<T>(A, sHat);
+            omega               = divide(inner(t, s), inner(t, t));
+
+            x = arithOp<T, af_add_t>(
+                x,
+                arithOp<T, af_add_t>(scaled(alpha, pHat), scaled(omega, sHat),
+                                     dims),
+                dims);
+            r = arithOp<T, af_sub_t>(s, scaled(omega, t), dims);
+            evalMultiple<T>({&x, &r});
+            rho = rhoNew;
+
+            if (it % check == 0 && converged(r, bound)) { break; }
+        }
+    }
+
+    if (iterations) { *iterations = it; }
+    return getHandle(x);
+}
+
+/// Returns the solution y of the least squares problem min |g - H y| of the
+/// Arnoldi relation, where g is beta times the first unit vector, and sets
+/// \p residual to the squared norm of g - H y, which is the squared norm of
+/// the residual of the system
+template<typename T>
+static Array<T> arnoldiLeastSquares(double &residual, const Array<T> &H,
+                                    const Array<T> &beta) {
+    const dim_t rows = H.dims()[0];
+    const Array<T> g = detail::join<T>(
+        0, beta, createValueArray<T>(dim4(rows - 1), scalar<T>(0)));
+    const Array<T> y = detail::solve<T>(H, g, AF_MAT_NONE);
+
+    residual = squaredNorm(arithOp<T, af_sub_t>(
+        g, detail::matmul(H, y, AF_MAT_NONE, AF_MAT_NONE), g.dims()));
+    return y;
+}
+
+template<typename T>
+static af_array gmres(unsigned *iterations, const af_array A,
+                      const af_array b, const double tol,
+                      const unsigned maxIterations, const unsigned restart,
+                      const af_precond_type ptype, const af_array precond,
+                      const af_array x0, const unsigned check) {
+    const Array<T> B   = getArray<T>(b);
+    const dim4 &dims   = B.dims();
+    const dim_t m      = std::min<dim_t>(restart, dims[0]);
+    const double bound = tol * tol * squaredNorm(B);
+
+    Array<T> x = initialGuess<T>(x0, dims);
+    Array<T> V = createEmptyArray<T>(dim4(dims[0], m + 1));
+
+    unsigned it = 0;
+    while (true) {
+        Array<T> r = arithOp<T, af_sub_t>(B, applyMatrix<T>(A, x), dims);
+        r.eval();
+        if (it == maxIterations || converged(r, bound)) { break; }
+
+        // The entries of H below the subdiagonal stay 0
+        Array<T> H = createValueArray<T>(dim4(m + 1, m), scalar<T>(0));
+        H.eval();
+
+        const Array<T> beta = norm2(r);
+        Array<T> v0         = columns(V, 0, 0);
+        detail::copyArray(v0, divide(r, detail::tile(beta, dims)));
+
+        // The Arnoldi iterations with right preconditioning, orthogonalized
+        // with two passes of classical Gram-Schmidt, which are products of
+        // matrices
+        Array<T> y = createEmptyArray<T>(dim4());
+        dim_t cols = 0;
+        double res = 0;
+        for (dim_t j = 0; j < m && it < maxIterations; ++j) {
+            ++it;
+            Array<T> w = applyMatrix<T>(
+                A, applyPrecond<T>(ptype, precond, columns(V, j, j)));
+
+            const Array<T> Vj = columns(V, 0, j);
+            Array<T> h  = detail::matmul(Vj, w, AF_MAT_CTRANS, AF_MAT_NONE);
+            w           = arithOp<T, af_sub_t>(
+                w, detail::matmul(Vj, h, AF_MAT_NONE, AF_MAT_NONE), dims);
+            Array<T> h2 = detail::matmul(Vj, w, AF_MAT_CTRANS, AF_MAT_NONE);
+            w           = arithOp<T, af_sub_t>(
+                w, detail::matmul(Vj, h2, AF_MAT_NONE, AF_MAT_NONE), dims);
+            w.eval();
+            h = arithOp<T, af_add_t>(h, h2, h.dims());
+
+            const Array<T> hNext = norm2(w);
+            const vector<af_seq> hIndex = {
+                {0., static_cast<double>(j + 1), 1.},
+                {static_cast<double>(j), static_cast<double>(j), 1.}};
+            Array<T> hColumn = createSubArray(H, hIndex, false);
+            detail::copyArray(hColumn, detail::join<T>(0, h, hNext));
+
+            Array<T> vNext = columns(V, j + 1, j + 1);
+            detail::copyArray(vNext, divide(w, detail::tile(hNext, dims)));
+
+            cols = j + 1;
+            if (it % check == 0 || cols == m || it == maxIterations) {
+                const vector<af_seq> index = {
+                    {0., static_cast<double>(cols), 1.},
+                    {0., static_cast<double>(cols - 1), 1.}};
+                y = arnoldiLeastSquares(res, createSubArray(H, index, true),
+                                        beta);
+                if (res <= bound || std::isnan(res)) { break; }
+            }
+        }
+
+        const Array<T> update = applyPrecond<T>(
+            ptype, precond,
+            detail::matmul(columns(V, 0, cols - 1), y, AF_MAT_NONE,
+                           AF_MAT_NONE));
+        x = arithOp<T, af_add_t>(x, update, dims);
+        x.eval();
+        if (res <= bound || std::isnan(res)) { break; }
+    }
+
+    if (iterations) { *iterations = it; }
+    return getHandle(x);
+}
+
+/// Checks the operands shared by the iterative solvers. \p A and \p b are
+/// the arguments 2 and 3 of the C functions, and \p ptype, \p precond and
+/// \p x0 the arguments \p argPrecond to \p argPrecond + 2.
+static af_dtype checkIterative(const af_array A, const af_array b,
+                               const af_precond_type ptype,
+                               const af_array precond, const af_array x0,
+                               const int argPrecond) {
+    const ArrayInfo &aInfo = getInfo(A, false, true);
+    const ArrayInfo &bInfo = getInfo(b);
+    const af_dtype type    = aInfo.getType();
+    const dim_t N          = aInfo.dims()[0];
+
+    ARG_ASSERT(2, aInfo.isFloating());  // Only floating and complex types
+    DIM_ASSERT(2, aInfo.ndims() <= 2 && aInfo.dims()[1] == N);
+    TYPE_ASSERT(bInfo.getType() == type);
+    DIM_ASSERT(3, bInfo.dims() == dim4(N));
+
+    switch (ptype) {
+        case AF_PRECOND_NONE: break;
+        case AF_PRECOND_JACOBI: {
+            ARG_ASSERT(argPrecond + 1, precond != 0);
+            const ArrayInfo &pInfo = getInfo(precond);
+            TYPE_ASSERT(pInfo.getType() == type);
+            DIM_ASSERT(argPrecond + 1, pInfo.dims() == dim4(N));
+        } break;
+        case AF_PRECOND_ILU0:
+        case AF_PRECOND_IC0: {
+            ARG_ASSERT(argPrecond + 1, precond != 0);
+            const SparseArrayBase pBase = getSparseArrayBase(precond);
+            ARG_ASSERT(argPrecond + 1, pBase.getStorage() == AF_STORAGE_CSR);
+            TYPE_ASSERT(pBase.getType() == type);
+            DIM_ASSERT(argPrecond + 1, pBase.dims() == dim4(N, N));
+        } break;
+        case AF_PRECOND_MATRIX: {
+            ARG_ASSERT(argPrecond + 1, precond != 0);
+            const ArrayInfo &pInfo = getInfo(precond, false, true);
+            TYPE_ASSERT(pInfo.getType() == type);
+            DIM_ASSERT(argPrecond + 1, pInfo.dims() == dim4(N, N));
+        } break;
+        default: ARG_ASSERT(argPrecond, false);
+    }
+
+    if (x0) {
+        const ArrayInfo &xInfo = getInfo(x0);
+        TYPE_ASSERT(xInfo.getType() == type);
+        DIM_ASSERT(argPrecond + 2, xInfo.dims() == dim4(N));
+    }
+    return type;
+}
+
+af_err af_cg(af_array *x, unsigned *iterations, const af_array A,
+             const af_array b, const double tol, const unsigned max_iterations,
+             const af_precond_type precond_type, const af_array precond,
+             const af_array x0, const unsigned check_interval) {
+    AF_API_RANGE_ARRAY(A);
+    try {
+        ARG_ASSERT(0, x != nullptr);
+        ARG_ASSERT(4, tol >= 0);
+        const af_dtype type =
+            checkIterative(A, b, precond_type, precond, x0, 6);
+        const unsigned check = std::max(check_interval, 1u);
+
+        af_array out = 0;
+        switch (type) {
+            case f32:
+                out = cg<float>(iterations, A, b, tol, max_iterations,
+                                precond_type, precond, x0, check);
+                break;
+            case f64:
+                out = cg<double>(iterations, A, b, tol, max_iterations,
+                                 precond_type, precond, x0, check);
+                break;
+            case c32:
+                out = cg<cfloat>(iterations, A, b, tol, max_iterations,
+                                 precond_type, precond, x0, check);
+                break;
+            case c64:
+                out = cg<cdouble>(iterations, A, b, tol, max_iterations,
+                                  precond_type, precond, x0, check);
+                break;
+            default: TYPE_ERROR(2, type);
+        }
+        std::swap(*x, out);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_bicgstab(af_array *x, unsigned *iterations, const af_array A,
+                   const af_array b, const double tol,
+                   const unsigned max_iterations,
+                   const af_precond_type precond_type, const af_array precond,
+                   const af_array x0, const unsigned check_interval) {
+    AF_API_RANGE_ARRAY(A);
+    try {
+        ARG_ASSERT(0, x != nullptr);
+        ARG_ASSERT(4, tol >= 0);
+        const af_dtype type =
+            checkIterative(A, b, precond_type, precond, x0, 6);
+        const unsigned check = std::max(check_interval, 1u);
+
+        af_array out = 0;
+        switch (type) {
+            case f32:
+                out = bicgstab<float>(iterations, A, b, tol, max_iterations,
+                                      precond_type, precond, x0, check);
+                break;
+            case f64:
+                out = bicgstab<double>(iterations, A, b, tol, max_iterations,
+                                       precond_type, precond, x0, check);
+                break;
+            case c32:
+                out = bicgstab<cfloat>(iterations, A, b, tol, max_iterations,
+                                       precond_type, precond, x0, check);
+                break;
+            case c64:
+                out = bicgstab<cdouble>(iterations, A, b, tol, max_iterations,
+                                        precond_type, precond, x0, check);
+                break;
+            default: TYPE_ERROR(2, type);
+        }
+        std::swap(*x, out);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_gmres(af_array *x, unsigned *iterations, const af_array A,
+                const af_array b, const double tol,
+                const unsigned max_iterations, const unsigned restart,
+                const af_precond_type precond_type, const af_array precond,
+                const af_array x0, const unsigned check_interval) {
+    AF_API_RANGE_ARRAY(A);
+    try {
+        ARG_ASSERT(0, x != nullptr);
+        ARG_ASSERT(4, tol >= 0);
+        ARG_ASSERT(6, restart > 0);
+        const af_dtype type =
+            checkIterative(A, b, precond_type, precond, x0, 7);
+        const unsigned check = std::max(check_interval, 1u);
+
+        af_array out = 0;
+        switch (type) {
+            case f32:
+                out = gmres<float>(iterations, A, b, tol, max_iterations,
+                                   restart, precond_type, precond, x0, check);
+                break;
+            case f64:
+                out = gmres<double>(iterations, A, b, tol, max_iterations,
+                                    restart, precond_type, precond, x0, check);
+                break;
+            case c32:
+                out = gmres<cfloat>(iterations, A, b, tol, max_iterations,
+                                    restart, precond_type, precond, x0, check);
+                break;
+            case c64:
+                out =
+                    gmres<cdouble>(iterations, A, b, tol, max_iterations,
+                                   restart, precond_type, precond, x0, check);
+                break;
+            default: TYPE_ERROR(2, type);
+        }
+        std::swap(*x, out);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
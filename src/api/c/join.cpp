@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -49,6 +50,7 @@ static inline af_array join_many(const int dim, const unsigned n_arrays,
 
 af_err af_join(af_array *out, const int dim, const af_array first,
                const af_array second) {
+    AF_API_RANGE_ARRAY(first);
     try {
         const ArrayInfo &finfo = getInfo(first);
         const ArrayInfo &sinfo = getInfo(second);
@@ -97,6 +99,7 @@ af_err af_join(af_array *out, const int dim, const af_array first,
 
 af_err af_join_many(af_array *out, const int dim, const unsigned n_arrays,
                     const af_array *inputs) {
+    AF_API_RANGE();
     try {
         ARG_ASSERT(3, inputs != nullptr);
 
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -44,11 +45,13 @@ static inline af_array lu_inplace(af_array in, bool is_lapack_piv) {
 
 af_err af_lu(af_array *lower, af_array *upper, af_array *pivot,
              const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &i_info = getInfo(in);
 
-        if (i_info.ndims() > 2) {
-            AF_ERROR("lu can not be used in batch mode", AF_ERR_BATCH);
+        if (i_info.ndims() > 2 && i_info.dims()[0] != i_info.dims()[1]) {
+            AF_ERROR("lu can only be batched for square matrices",
+                     AF_ERR_BATCH);
         }
 
         af_dtype type = i_info.getType();
@@ -79,12 +82,14 @@ af_err af_lu(af_array *lower, af_array *upper, af_array *pivot,
 }
 
 af_err af_lu_inplace(af_array *pivot, af_array in, const bool is_lapack_piv) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &i_info = getInfo(in);
         af_dtype type           = i_info.getType();
 
-        if (i_info.ndims() > 2) {
-            AF_ERROR("lu can not be used in batch mode", AF_ERR_BATCH);
+        if (i_info.ndims() > 2 && i_info.dims()[0] != i_info.dims()[1]) {
+            AF_ERROR("lu can only be batched for square matrices",
+                     AF_ERR_BATCH);
         }
 
         ARG_ASSERT(1, i_info.isFloating());  // Only floating and complex types
@@ -110,6 +115,7 @@ af_err af_lu_inplace(af_array *pivot, af_array in, const bool is_lapack_piv) {
 }
 
 af_err af_is_lapack_available(bool *out) {
+    AF_API_RANGE();
     try {
         *out = isLAPACKAvailable();
     }
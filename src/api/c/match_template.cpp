@@ -7,30 +7,176 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
+#include <arith.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
+#include <common/indexing_helpers.hpp>
+#include <copy.hpp>
+#include <fftconvolve.hpp>
 #include <handle.hpp>
+#include <imgproc_common.hpp>
 #include <match_template.hpp>
+#include <reduce.hpp>
 #include <types.hpp>
 #include <af/defines.h>
 #include <af/vision.h>
 
 #include <type_traits>
+#include <vector>
 
 using af::dim4;
+using common::flip;
+using common::integralImage;
+using detail::arithOp;
+using detail::Array;
+using detail::createSubArray;
+using detail::createValueArray;
+using detail::fftconvolve;
 using detail::intl;
+using detail::padArrayBorders;
+using detail::reduce_all;
+using detail::scalar;
 using detail::uchar;
 using detail::uint;
 using detail::uintl;
 using detail::ushort;
 using std::conditional;
 using std::is_same;
+using std::vector;
+
+/// Returns the sums of \p in over the windows of \p wDims which start at
+/// each of its elements. The windows are padded with zeros past the end.
+template<typename T>
+static Array<T> windowSums(const Array<T>& in, const dim4& wDims) {
+    const dim4& iDims = in.dims();
+
+    // sat(i, j) is the sum of the elements before (i, j)
+    const Array<T> sat = integralImage<T, T>(
+        padArrayBorders(in, dim4(1, 1, 0, 0),
+                        dim4(wDims[0] - 1, wDims[1] - 1, 0, 0), AF_PAD_ZERO));
+
+    auto corner = [&](dim_t i, dim_t j) {
+        vector<af_seq> index(AF_MAX_DIMS, af_span);
+        index[0] = {static_cast<double>(i),
+                    static_cast<double>(i + iDims[0] - 1), 1.};
+        index[1] = {static_cast<double>(j),
+                    static_cast<double>(j + iDims[1] - 1), 1.};
+        return createSubArray(sat, index);
+    };
+
+    const Array<T> outer = arithOp<T, af_sub_t>(
+        corner(wDims[0], wDims[1]), corner(0, wDims[1]), iDims);
+    const Array<T> inner =
+        arithOp<T, af_sub_t>(corner(wDims[0], 0), corner(0, 0), iDims);
+    return arithOp<T, af_sub_t>(outer, inner, iDims);
+}
+
+/// Returns the sums of \p in times \p kernel over the windows which start
+/// at each of its elements
+template<typename T>
+static Array<T> correlate(const Array<T>& in, const Array<T>& kernel) {
+    const dim4& iDims = in.dims();
+    const dim4& kDims = kernel.dims();
+
+    // The full convolution with the flipped kernel ends each window at the
+    // element which is past the start by the size of the kernel
+    const Array<T> full =
+        fftconvolve(in, flip(kernel, {true, true, false, false}), true,
+                    iDims.ndims() > 2 ? AF_BATCH_LHS : AF_BATCH_NONE, 2);
+
+    vector<af_seq> index(AF_MAX_DIMS, af_span);
+    index[0] = {static_cast<double>(kDims[0] - 1),
+                static_cast<double>(kDims[0] + iDims[0] - 2), 1.};
+    index[1] = {static_cast<double>(kDims[1] - 1),
+                static_cast<double>(kDims[1] + iDims[1] - 2), 1.};
+    return createSubArray(full, index);
+}
+
+/// Computes the SSD measures from the sums of squares of the windows and
+/// their cross-correlation with the template, which are found with the
+/// summed area tables and the FFT. Their cost does not grow with the size
+/// of the template, but they are rounded differently than the direct sums.
+template<typename T>
+static Array<T> fftMatchTemplate(const Array<T>& sImg, const Array<T>& tImg,
+                                 const af_match_type mType) {
+    const dim4& sDims = sImg.dims();
+    const dim4& tDims = tImg.dims();
+    const T count     = static_cast<T>(tDims.elements());
+
+    auto constant = [&](T val) { return createValueArray(sDims, val); };
+    auto square   = [](const Array<T>& in) {
+        return arithOp<T, af_mul_t>(in, in, in.dims());
+    };
+
+    const Array<T> sSquares = windowSums(square(sImg), tDims);
+    const T tMean = reduce_all<af_add_t, T, T>(tImg) / count;
+
+    Array<T> out = sSquares;
+    if (mType == AF_ZSSD) {
+        // sum((s - sMean) - (t - tMean))^2 = sum(s^2) - sum(s)^2 / count
+        //     - 2 * sum(s * (t - tMean)) + sum((t - tMean)^2)
+        const Array<T> tZero = arithOp<T, af_sub_t>(
+            tImg, createValueArray(tDims, tMean), tDims);
+        const T tSquares = reduce_all<af_add_t, T, T>(square(tZero));
+        const Array<T> sSums = windowSums(sImg, tDims);
+
+        out = arithOp<T, af_sub_t>(
+            out,
+            arithOp<T, af_div_t>(square(sSums), constant(count), sDims),
+            sDims);
+        out = arithOp<T, af_sub_t>(
+            out,
+            arithOp<T, af_mul_t>(correlate(sImg, tZero), constant(scalar<T>(2)),
+                                 sDims),
+            sDims);
+        out = arithOp<T, af_add_t>(out, constant(tSquares), sDims);
+    } else {
+        // sum(s - r * t)^2 = sum(s^2) - 2 * r * sum(s * t) + r^2 * sum(t^2),
+        // where r is one for SSD and the ratio of the means for LSSD
+        const T tSquares = reduce_all<af_add_t, T, T>(square(tImg));
+        Array<T> ratio   = constant(scalar<T>(1));
+        if (mType == AF_LSSD) {
+            ratio = arithOp<T, af_div_t>(windowSums(sImg, tDims),
+                                         constant(count * tMean), sDims);
+        }
+
+        const Array<T> cross = arithOp<T, af_mul_t>(
+            correlate(sImg, tImg), ratio, sDims);
+        out = arithOp<T, af_sub_t>(
+            out, arithOp<T, af_add_t>(cross, cross, sDims), sDims);
+        out = arithOp<T, af_add_t>(
+            out,
+            arithOp<T, af_mul_t>(square(ratio), constant(tSquares), sDims),
+            sDims);
+    }
+    return out;
+}
 
 template<typename InType>
 static af_array match_template(const af_array& sImg, const af_array tImg,
                                af_match_type mType) {
     using OutType = typename conditional<is_same<InType, double>::value, double,
                                          float>::type;
+
+    // The side of the templates above which the SSD measures are computed
+    // with the FFT instead of sliding over each element of the template
+#if defined(AF_CPU)
+    constexpr dim_t fftMethodThreshold = 16;
+#elif defined(AF_CUDA)
+    constexpr dim_t fftMethodThreshold = 24;
+#elif defined(AF_OPENCL)
+    constexpr dim_t fftMethodThreshold = 24;
+#endif  // defined(AF_CPU)
+
+    const dim4& tDims = getInfo(tImg).dims();
+    const bool isSSD  = mType == AF_SSD || mType == AF_ZSSD || mType == AF_LSSD;
+    if (isSSD &&
+        tDims[0] * tDims[1] > fftMethodThreshold * fftMethodThreshold) {
+        return getHandle(fftMatchTemplate<OutType>(
+            castArray<OutType>(sImg), castArray<OutType>(tImg), mType));
+    }
+
     return getHandle(match_template<InType, OutType>(
         getArray<InType>(sImg), getArray<InType>(tImg), mType));
 }
@@ -38,6 +184,7 @@ static af_array match_template(const af_array& sImg, const af_array tImg,
 af_err af_match_template(af_array* out, const af_array search_img,
                          const af_array template_img,
                          const af_match_type m_type) {
+    AF_API_RANGE_ARRAY(search_img);
     try {
         ARG_ASSERT(3, (m_type >= AF_SAD && m_type <= AF_LSSD));
 
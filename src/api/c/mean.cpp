@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <cast.hpp>
@@ -62,6 +63,7 @@ static af_array mean(const af_array &in, const af_array &weights,
 }
 
 af_err af_mean(af_array *out, const af_array in, const dim_t dim) {
+    AF_API_RANGE_ARRAY(in);
     try {
         ARG_ASSERT(2, (dim >= 0 && dim <= 3));
 
@@ -92,6 +94,7 @@ af_err af_mean(af_array *out, const af_array in, const dim_t dim) {
 
 af_err af_mean_weighted(af_array *out, const af_array in,
                         const af_array weights, const dim_t dim) {
+    AF_API_RANGE_ARRAY(in);
     try {
         ARG_ASSERT(3, (dim >= 0 && dim <= 3));
 
@@ -146,6 +149,7 @@ af_err af_mean_weighted(af_array *out, const af_array in,
 }
 
 af_err af_mean_all(double *realVal, double *imagVal, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in);
         af_dtype type         = info.getType();
@@ -180,6 +184,7 @@ af_err af_mean_all(double *realVal, double *imagVal, const af_array in) {
 
 af_err af_mean_all_weighted(double *realVal, double *imagVal, const af_array in,
                             const af_array weights) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &iInfo = getInfo(in);
         const ArrayInfo &wInfo = getInfo(weights);
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
@@ -34,6 +35,7 @@ static inline af_array mean_shift(const af_array &in, const float &s_sigma,
 af_err af_mean_shift(af_array *out, const af_array in,
                      const float spatial_sigma, const float chromatic_sigma,
                      const unsigned num_iterations, const bool is_color) {
+    AF_API_RANGE_ARRAY(in);
     try {
         ARG_ASSERT(2, (spatial_sigma >= 0));
         ARG_ASSERT(3, (chromatic_sigma >= 0));
@@ -7,76 +7,138 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
+#include <arith.hpp>
 #include <backend.hpp>
 #include <cast.hpp>
 #include <common/err_common.hpp>
+#include <copy.hpp>
 #include <handle.hpp>
 #include <math.hpp>
+#include <nth_element.hpp>
 #include <sort.hpp>
-#include <af/arith.h>
 #include <af/data.h>
 #include <af/defines.h>
 #include <af/dim4.hpp>
-#include <af/index.h>
 #include <af/statistics.h>
 
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
 using af::dim4;
+using detail::arithOp;
 using detail::Array;
-using detail::division;
+using detail::cast;
+using detail::createSubArray;
+using detail::createValueArray;
+using detail::getScalar;
+using detail::nth_element;
+using detail::sort;
 using detail::uchar;
 using detail::uint;
 using detail::ushort;
-using std::sort;
+using std::conditional;
+using std::is_same;
+using std::vector;
 
-template<typename T>
-static double median(const af_array& in) {
-    dim_t nElems = getInfo(in).elements();
-    dim4 dims(nElems, 1, 1, 1);
-    ARG_ASSERT(0, nElems > 0);
+/// Lines of at least this length are selected with nth_element, which takes
+/// linear time. Shorter lines are sorted, which is as fast for them and does
+/// not need the histogram of each line of the radix select of the GPUs.
+constexpr dim_t kSelectMinLength = 256;
 
-    af_array temp = 0;
-    AF_CHECK(af_moddims(&temp, in, 1, dims.get()));
-    const Array<T> input = getArray<T>(temp);
+/// The ranks of the values interpolated by a quantile
+struct QuantileRanks {
+    dim_t rank;     ///< The rank of the lower value
+    double weight;  ///< The weight of the upper value, of rank rank + 1
+};
 
-    // Shortcut cases for 1 or 2 elements
-    if (nElems == 1) {
-        T result;
-        AF_CHECK(af_get_data_ptr((void*)&result, in));
-        return result;
-    }
-    if (nElems == 2) {
-        T result[2];
-        AF_CHECK(af_get_data_ptr((void*)&result, in));
-        return division(
-            (static_cast<double>(result[0]) + static_cast<double>(result[1])),
-            2.0);
+/// Returns the ranks of the quantile \p q of \p n values. The quantile is
+/// interpolated linearly between the closest ranks, like the default method
+/// of numpy.quantile and R (type 7).
+static QuantileRanks quantileRanks(const dim_t n, const double q) {
+    const double h   = static_cast<double>(n - 1) * q;
+    const dim_t rank = static_cast<dim_t>(std::floor(h));
+    return {rank, h - static_cast<double>(rank)};
+}
+
+/// Returns an array with the values of rank \p rank along \p dim at the index
+/// returned in \p first, followed by the values of rank \p rank + 1 when they
+/// exist.
+template<typename T>
+static Array<T> selectRanks(dim_t& first, const Array<T>& in, const int dim,
+                            const dim_t rank) {
+    if (in.dims()[dim] >= kSelectMinLength) {
+        first = 0;
+        return nth_element<T>(in, dim, rank);
     }
+    first = rank;
+    return sort<T>(in, dim, true);
+}
 
-    double mid       = static_cast<double>(nElems + 1) / 2.0;
-    af_seq mdSpan[1] = {af_make_seq(mid - 1, mid, 1)};
+template<typename T>
+static Array<T> slice(const Array<T>& in, const int dim, const dim_t index) {
+    vector<af_seq> seqs(4, af_span);
+    seqs[dim] = af_make_seq(static_cast<double>(index),
+                            static_cast<double>(index), 1.0);
+    return createSubArray<T>(in, seqs);
+}
+
+/// Integers are interpolated in single precision, like the other statistics
+template<typename T>
+using quantile_t =
+    typename conditional<is_same<T, double>::value, double, float>::type;
+
+template<typename T>
+static af_array quantile(const af_array& in, const double q, const dim_t dim) {
+    using To = quantile_t<T>;
 
-    Array<T> sortedArr = sort<T>(input, 0, true);
+    const Array<T> input = getArray<T>(in);
+    const int d          = static_cast<int>(dim);
+    const dim_t n        = input.dims()[d];
 
-    af_array sarrHandle = getHandle<T>(sortedArr);
+    const QuantileRanks ranks = quantileRanks(n, q);
 
-    double result;
-    T resPtr[2];
-    af_array res = 0;
-    AF_CHECK(af_index(&res, sarrHandle, 1, mdSpan));
-    AF_CHECK(af_get_data_ptr((void*)&resPtr, res));
+    dim_t first             = 0;
+    const Array<T> selected = selectRanks<T>(first, input, d, ranks.rank);
+    const Array<To> lower   = cast<To, T>(slice<T>(selected, d, first));
+    if (ranks.weight == 0.0) { return getHandle<To>(lower); }
 
-    AF_CHECK(af_release_array(res));
-    AF_CHECK(af_release_array(sarrHandle));
-    AF_CHECK(af_release_array(temp));
+    const Array<To> upper = cast<To, T>(slice<T>(selected, d, first + 1));
+    const dim4 odims      = lower.dims();
 
-    if (nElems % 2 == 1) {
-        result = resPtr[0];
-    } else {
-        result = division(
-            static_cast<double>(resPtr[0]) + static_cast<double>(resPtr[1]),
-            2.0);
-    }
+    const Array<To> lowerWeight =
+        createValueArray<To>(odims, static_cast<To>(1.0 - ranks.weight));
+    const Array<To> upperWeight =
+        createValueArray<To>(odims, static_cast<To>(ranks.weight));
 
+    const Array<To> result = arithOp<To, af_add_t>(
+        arithOp<To, af_mul_t>(lower, lowerWeight, odims),
+        arithOp<To, af_mul_t>(upper, upperWeight, odims), odims);
+    return getHandle<To>(result);
+}
+
+template<typename T>
+static double quantile(const af_array& in, const double q) {
+    const dim_t nElems = getInfo(in).elements();
+    ARG_ASSERT(0, nElems > 0);
+
+    const dim4 dims(nElems);
+    af_array flat = 0;
+    AF_CHECK(af_moddims(&flat, in, 1, dims.get()));
+    const Array<T> input = getArray<T>(flat);
+
+    const QuantileRanks ranks = quantileRanks(nElems, q);
+
+    dim_t first             = 0;
+    const Array<T> selected = selectRanks<T>(first, input, 0, ranks.rank);
+    AF_CHECK(af_release_array(flat));
+
+    double result = getScalar<T>(slice<T>(selected, 0, first));
+    if (ranks.weight != 0.0) {
+        const double upper = getScalar<T>(slice<T>(selected, 0, first + 1));
+        result = (1.0 - ranks.weight) * result + ranks.weight * upper;
+    }
     return result;
 }
 
@@ -89,73 +151,12 @@ static af_array median(const af_array& in, const dim_t dim) {
         Array<T> result = copyArray<T>(input);
         return getHandle<T>(result);
     }
-
-    Array<T> sortedIn = sort<T>(input, dim, true);
-
-    size_t dimLength = input.dims()[dim];
-    double mid       = static_cast<double>(dimLength + 1) / 2.0;
-    af_array left    = 0;
-
-    af_seq slices[4] = {af_span, af_span, af_span, af_span};
-    slices[dim]      = af_make_seq(mid - 1.0, mid - 1.0, 1.0);
-
-    af_array sortedIn_handle = getHandle<T>(sortedIn);
-    AF_CHECK(af_index(&left, sortedIn_handle, input.ndims(), slices));
-
-    af_array out = nullptr;
-    if (dimLength % 2 == 1) {
-        // mid-1 is our guy
-        if (input.isFloating()) {
-            AF_CHECK(af_release_array(sortedIn_handle));
-            return left;
-        }
-
-        // Return as floats for consistency
-        af_array out;
-        AF_CHECK(af_cast(&out, left, f32));
-        AF_CHECK(af_release_array(left));
-        AF_CHECK(af_release_array(sortedIn_handle));
-        return out;
-    } else {
-        // ((mid-1)+mid)/2 is our guy
-        dim4 dims      = input.dims();
-        af_array right = 0;
-        slices[dim]    = af_make_seq(mid, mid, 1.0);
-
-        AF_CHECK(af_index(&right, sortedIn_handle, dims.ndims(), slices));
-
-        af_array sumarr = 0;
-        af_array carr   = 0;
-
-        dim4 cdims = dims;
-        cdims[dim] = 1;
-        AF_CHECK(af_constant(&carr, 0.5, cdims.ndims(), cdims.get(),
-                             input.isDouble() ? f64 : f32));
-
-        if (!input.isFloating()) {
-            af_array lleft, rright;
-            AF_CHECK(af_cast(&lleft, left, f32));
-            AF_CHECK(af_cast(&rright, right, f32));
-            AF_CHECK(af_release_array(left));
-            AF_CHECK(af_release_array(right));
-            left  = lleft;
-            right = rright;
-        }
-
-        AF_CHECK(af_add(&sumarr, left, right, false));
-        AF_CHECK(af_mul(&out, sumarr, carr, false));
-
-        AF_CHECK(af_release_array(left));
-        AF_CHECK(af_release_array(right));
-        AF_CHECK(af_release_array(sumarr));
-        AF_CHECK(af_release_array(carr));
-        AF_CHECK(af_release_array(sortedIn_handle));
-    }
-    return out;
+    return quantile<T>(in, 0.5, dim);
 }
 
 af_err af_median_all(double* realVal, double* imagVal,  // NOLINT
                      const af_array in) {
+    AF_API_RANGE();
     UNUSED(imagVal);
     try {
         const ArrayInfo& info = getInfo(in);
@@ -163,13 +164,13 @@ af_err af_median_all(double* realVal, double* imagVal,  // NOLINT
 
         ARG_ASSERT(2, info.ndims() > 0);
         switch (type) {
-            case f64: *realVal = median<double>(in); break;
-            case f32: *realVal = median<float>(in); break;
-            case s32: *realVal = median<int>(in); break;
-            case u32: *realVal = median<uint>(in); break;
-            case s16: *realVal = median<short>(in); break;
-            case u16: *realVal = median<ushort>(in); break;
-            case u8: *realVal = median<uchar>(in); break;
+            case f64: *realVal = quantile<double>(in, 0.5); break;
+            case f32: *realVal = quantile<float>(in, 0.5); break;
+            case s32: *realVal = quantile<int>(in, 0.5); break;
+            case u32: *realVal = quantile<uint>(in, 0.5); break;
+            case s16: *realVal = quantile<short>(in, 0.5); break;
+            case u16: *realVal = quantile<ushort>(in, 0.5); break;
+            case u8: *realVal = quantile<uchar>(in, 0.5); break;
             default: TYPE_ERROR(1, type);
         }
     }
@@ -178,6 +179,7 @@ af_err af_median_all(double* realVal, double* imagVal,  // NOLINT
 }
 
 af_err af_median(af_array* out, const af_array in, const dim_t dim) {
+    AF_API_RANGE_ARRAY(in);
     try {
         ARG_ASSERT(2, (dim >= 0 && dim <= 4));
 
@@ -201,3 +203,56 @@ af_err af_median(af_array* out, const af_array in, const dim_t dim) {
     CATCHALL;
     return AF_SUCCESS;
 }
+
+af_err af_quantile_all(double* realVal, double* imagVal, const af_array in,
+                       const double q) {
+    AF_API_RANGE();
+    UNUSED(imagVal);
+    try {
+        const ArrayInfo& info = getInfo(in);
+        af_dtype type         = info.getType();
+
+        ARG_ASSERT(2, info.ndims() > 0);
+        ARG_ASSERT(3, q >= 0.0 && q <= 1.0);
+        switch (type) {
+            case f64: *realVal = quantile<double>(in, q); break;
+            case f32: *realVal = quantile<float>(in, q); break;
+            case s32: *realVal = quantile<int>(in, q); break;
+            case u32: *realVal = quantile<uint>(in, q); break;
+            case s16: *realVal = quantile<short>(in, q); break;
+            case u16: *realVal = quantile<ushort>(in, q); break;
+            case u8: *realVal = quantile<uchar>(in, q); break;
+            default: TYPE_ERROR(2, type);
+        }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_quantile(af_array* out, const af_array in, const double q,
+                   const dim_t dim) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        ARG_ASSERT(2, q >= 0.0 && q <= 1.0);
+        ARG_ASSERT(3, (dim >= 0 && dim < 4));
+
+        af_array output       = 0;
+        const ArrayInfo& info = getInfo(in);
+
+        ARG_ASSERT(1, info.ndims() > 0);
+        af_dtype type = info.getType();
+        switch (type) {
+            case f64: output = quantile<double>(in, q, dim); break;
+            case f32: output = quantile<float>(in, q, dim); break;
+            case s32: output = quantile<int>(in, q, dim); break;
+            case u32: output = quantile<uint>(in, q, dim); break;
+            case s16: output = quantile<short>(in, q, dim); break;
+            case u16: output = quantile<ushort>(in, q, dim); break;
+            case u8: output = quantile<uchar>(in, q, dim); break;
+            default: TYPE_ERROR(1, type);
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
@@ -10,7 +10,10 @@
 #include <memoryapi.hpp>
 
 #include <Array.hpp>
+#include <api_range.hpp>
 #include <backend.hpp>
+#include <common/MemoryStats.hpp>
+#include <common/bfloat16.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <events.hpp>
@@ -23,9 +26,12 @@
 #include <af/memory.h>
 #include <af/version.h>
 
+#include <cstring>
+#include <string>
 #include <utility>
 
 using af::dim4;
+using common::bfloat16;
 using common::half;
 using detail::cdouble;
 using detail::cfloat;
@@ -38,20 +44,24 @@ using detail::isLocked;
 using detail::memAllocUser;
 using detail::memFreeUser;
 using detail::memLock;
+using detail::memoryManager;
 using detail::memUnlock;
 using detail::pinnedAlloc;
 using detail::pinnedFree;
 using detail::printMemInfo;
+using detail::registerHostMemory;
 using detail::signalMemoryCleanup;
 using detail::uchar;
 using detail::uint;
 using detail::uintl;
+using detail::unregisterHostMemory;
 using detail::ushort;
 using std::move;
 using std::swap;
 
 af_err af_device_array(af_array *arr, void *data, const unsigned ndims,
                        const dim_t *const dims, const af_dtype type) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
 
@@ -104,6 +114,9 @@ af_err af_device_array(af_array *arr, void *data, const unsigned ndims,
             case f16:
                 res = getHandle(createDeviceDataArray<half>(d, data));
                 break;
+            case bf16:
+                res = getHandle(createDeviceDataArray<bfloat16>(d, data));
+                break;
             default: TYPE_ERROR(4, type);
         }
 
@@ -115,6 +128,7 @@ af_err af_device_array(af_array *arr, void *data, const unsigned ndims,
 }
 
 af_err af_get_device_ptr(void **data, const af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         af_dtype type = getInfo(arr).getType();
 
@@ -133,6 +147,9 @@ af_err af_get_device_ptr(void **data, const af_array arr) {
             case u8: *data = getDevicePtr(getArray<uchar>(arr)); break;
             case b8: *data = getDevicePtr(getArray<char>(arr)); break;
             case f16: *data = getDevicePtr(getArray<half>(arr)); break;
+            case bf16:
+                *data = getDevicePtr(getArray<bfloat16>(arr));
+                break;
 
             default: TYPE_ERROR(4, type);
         }
@@ -153,6 +170,7 @@ inline void lockArray(const af_array arr) {
 af_err af_lock_device_ptr(const af_array arr) { return af_lock_array(arr); }
 
 af_err af_lock_array(const af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         af_dtype type = getInfo(arr).getType();
 
@@ -170,6 +188,7 @@ af_err af_lock_array(const af_array arr) {
             case u8: lockArray<uchar>(arr); break;
             case b8: lockArray<char>(arr); break;
             case f16: lockArray<half>(arr); break;
+            case bf16: lockArray<bfloat16>(arr); break;
             default: TYPE_ERROR(4, type);
         }
     }
@@ -187,6 +206,7 @@ inline bool checkUserLock(const af_array arr) {
 }
 
 af_err af_is_locked_array(bool *res, const af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         af_dtype type = getInfo(arr).getType();
 
@@ -204,6 +224,7 @@ af_err af_is_locked_array(bool *res, const af_array arr) {
             case u8: *res = checkUserLock<uchar>(arr); break;
             case b8: *res = checkUserLock<char>(arr); break;
             case f16: *res = checkUserLock<half>(arr); break;
+            case bf16: *res = checkUserLock<bfloat16>(arr); break;
             default: TYPE_ERROR(4, type);
         }
     }
@@ -223,6 +244,7 @@ inline void unlockArray(const af_array arr) {
 af_err af_unlock_device_ptr(const af_array arr) { return af_unlock_array(arr); }
 
 af_err af_unlock_array(const af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         af_dtype type = getInfo(arr).getType();
 
@@ -240,6 +262,7 @@ af_err af_unlock_array(const af_array arr) {
             case u8: unlockArray<uchar>(arr); break;
             case b8: unlockArray<char>(arr); break;
             case f16: unlockArray<half>(arr); break;
+            case bf16: unlockArray<bfloat16>(arr); break;
             default: TYPE_ERROR(4, type);
         }
     }
@@ -249,6 +272,7 @@ af_err af_unlock_array(const af_array arr) {
 }
 
 af_err af_alloc_device(void **ptr, const dim_t bytes) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         *ptr = memAllocUser(bytes);
@@ -258,6 +282,7 @@ af_err af_alloc_device(void **ptr, const dim_t bytes) {
 }
 
 af_err af_alloc_device_v2(void **ptr, const dim_t bytes) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
 #ifdef AF_OPENCL
@@ -277,6 +302,7 @@ af_err af_alloc_device_v2(void **ptr, const dim_t bytes) {
 }
 
 af_err af_alloc_pinned(void **ptr, const dim_t bytes) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         *ptr = static_cast<void *>(pinnedAlloc<char>(bytes));
@@ -286,6 +312,7 @@ af_err af_alloc_pinned(void **ptr, const dim_t bytes) {
 }
 
 af_err af_free_device(void *ptr) {
+    AF_API_RANGE();
     try {
         memFreeUser(ptr);
     }
@@ -294,6 +321,7 @@ af_err af_free_device(void *ptr) {
 }
 
 af_err af_free_device_v2(void *ptr) {
+    AF_API_RANGE();
     try {
 #ifdef AF_OPENCL
         auto mem = static_cast<cl_mem>(ptr);
@@ -307,6 +335,7 @@ af_err af_free_device_v2(void *ptr) {
 }
 
 af_err af_free_pinned(void *ptr) {
+    AF_API_RANGE();
     try {
         pinnedFree<char>(static_cast<char *>(ptr));
     }
@@ -314,7 +343,30 @@ af_err af_free_pinned(void *ptr) {
     return AF_SUCCESS;
 }
 
+af_err af_register_host_memory(void *ptr, const size_t bytes) {
+    AF_API_RANGE();
+    try {
+        AF_CHECK(af_init());
+        ARG_ASSERT(0, ptr != nullptr);
+        ARG_ASSERT(1, bytes > 0);
+        registerHostMemory(ptr, bytes);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_unregister_host_memory(void *ptr) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(0, ptr != nullptr);
+        unregisterHostMemory(ptr);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
 af_err af_alloc_host(void **ptr, const dim_t bytes) {
+    AF_API_RANGE();
     if ((*ptr = malloc(bytes))) {  // NOLINT(hicpp-no-malloc)
         return AF_SUCCESS;
     }
@@ -322,11 +374,13 @@ af_err af_alloc_host(void **ptr, const dim_t bytes) {
 }
 
 af_err af_free_host(void *ptr) {
+    AF_API_RANGE();
     free(ptr);  // NOLINT(hicpp-no-malloc)
     return AF_SUCCESS;
 }
 
 af_err af_print_mem_info(const char *msg, const int device_id) {
+    AF_API_RANGE();
     try {
         int device = device_id;
         if (device == -1) { device = static_cast<int>(getActiveDeviceId()); }
@@ -343,6 +397,7 @@ af_err af_print_mem_info(const char *msg, const int device_id) {
 }
 
 af_err af_device_gc() {
+    AF_API_RANGE();
     try {
         signalMemoryCleanup();
     }
@@ -352,6 +407,7 @@ af_err af_device_gc() {
 
 af_err af_device_mem_info(size_t *alloc_bytes, size_t *alloc_buffers,
                           size_t *lock_bytes, size_t *lock_buffers) {
+    AF_API_RANGE();
     try {
         deviceMemoryInfo(alloc_bytes, alloc_buffers, lock_bytes, lock_buffers);
     }
@@ -360,6 +416,7 @@ af_err af_device_mem_info(size_t *alloc_bytes, size_t *alloc_buffers,
 }
 
 af_err af_set_mem_step_size(const size_t step_bytes) {
+    AF_API_RANGE();
     try {
         detail::setMemStepSize(step_bytes);
     }
@@ -368,6 +425,7 @@ af_err af_set_mem_step_size(const size_t step_bytes) {
 }
 
 af_err af_get_mem_step_size(size_t *step_bytes) {
+    AF_API_RANGE();
     try {
         *step_bytes = detail::getMemStepSize();
     }
@@ -375,6 +433,87 @@ af_err af_get_mem_step_size(size_t *step_bytes) {
     return AF_SUCCESS;
 }
 
+static int getMemStatsDevice(const int device) {
+    if (device < 0) { return static_cast<int>(getActiveDeviceId()); }
+    ARG_ASSERT(1, device < getDeviceCount());
+    return device;
+}
+
+af_err af_set_mem_stats_enabled(const int enabled) {
+    AF_API_RANGE();
+    try {
+        memoryManager().setStatsEnabled(enabled != 0);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_mem_stats(af_mem_stats *stats, const int device) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(0, stats != nullptr);
+        memoryManager().getStats(stats, getMemStatsDevice(device));
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_reset_mem_stats(const int device) {
+    AF_API_RANGE();
+    try {
+        memoryManager().resetStats(getMemStatsDevice(device));
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_set_mem_stats_site(const char *name) {
+    AF_API_RANGE();
+    try {
+        common::setAllocationSite(name ? name : "");
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_mem_stats_json(size_t *length, char *json, const int device) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(0, length != nullptr);
+        const std::string out =
+            memoryManager().getStatsJson(getMemStatsDevice(device));
+        if (json == nullptr) {
+            *length = out.size() + 1;
+        } else {
+            if (*length < out.size() + 1) {
+                AF_ERROR("Length not sufficient to store the statistics",
+                         AF_ERR_SIZE);
+            }
+            memcpy(json, out.c_str(), out.size() + 1);
+        }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_begin_memory_scope(const size_t bytes) {
+    AF_API_RANGE();
+    try {
+        memoryManager().beginScope(bytes);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_end_memory_scope() {
+    AF_API_RANGE();
+    try {
+        memoryManager().endScope();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Memory Manager API
 ////////////////////////////////////////////////////////////////////////////////
@@ -390,6 +529,7 @@ af_memory_manager getHandle(MemoryManager &manager) {
 }
 
 af_err af_create_memory_manager(af_memory_manager *manager) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         std::unique_ptr<MemoryManager> m(new MemoryManager());
@@ -401,6 +541,7 @@ af_err af_create_memory_manager(af_memory_manager *manager) {
 }
 
 af_err af_release_memory_manager(af_memory_manager handle) {
+    AF_API_RANGE();
     try {
         // NB: does NOT reset the internal memory manager to be the default:
         // af_unset_memory_manager_pinned must be used to fully-reset with a new
@@ -413,6 +554,7 @@ af_err af_release_memory_manager(af_memory_manager handle) {
 }
 
 af_err af_set_memory_manager(af_memory_manager mgr) {
+    AF_API_RANGE();
     try {
         std::unique_ptr<MemoryManagerFunctionWrapper> newManager(
             new MemoryManagerFunctionWrapper(mgr));
@@ -426,6 +568,7 @@ af_err af_set_memory_manager(af_memory_manager mgr) {
 }
 
 af_err af_unset_memory_manager() {
+    AF_API_RANGE();
     try {
         detail::resetMemoryManager();
     }
@@ -435,6 +578,7 @@ af_err af_unset_memory_manager() {
 }
 
 af_err af_set_memory_manager_pinned(af_memory_manager mgr) {
+    AF_API_RANGE();
     try {
         // NB: does NOT free if a non-default implementation is set as the
         // current memory manager - the user is responsible for freeing any
@@ -451,6 +595,7 @@ af_err af_set_memory_manager_pinned(af_memory_manager mgr) {
 }
 
 af_err af_unset_memory_manager_pinned() {
+    AF_API_RANGE();
     try {
         detail::resetMemoryManagerPinned();
     }
@@ -460,6 +605,7 @@ af_err af_unset_memory_manager_pinned() {
 }
 
 af_err af_memory_manager_get_payload(af_memory_manager handle, void **payload) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         *payload               = manager.payload;
@@ -470,6 +616,7 @@ af_err af_memory_manager_get_payload(af_memory_manager handle, void **payload) {
 }
 
 af_err af_memory_manager_set_payload(af_memory_manager handle, void *payload) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.payload        = payload;
@@ -484,6 +631,7 @@ af_err af_memory_manager_set_payload(af_memory_manager handle, void *payload) {
 
 af_err af_memory_manager_get_active_device_id(af_memory_manager handle,
                                               int *id) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         *id                    = manager.wrapper->getActiveDeviceId();
@@ -496,6 +644,7 @@ af_err af_memory_manager_get_active_device_id(af_memory_manager handle,
 
 af_err af_memory_manager_native_alloc(af_memory_manager handle, void **ptr,
                                       size_t size) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         *ptr                   = manager.wrapper->nativeAlloc(size);
@@ -506,6 +655,7 @@ af_err af_memory_manager_native_alloc(af_memory_manager handle, void **ptr,
 }
 
 af_err af_memory_manager_native_free(af_memory_manager handle, void *ptr) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.wrapper->nativeFree(ptr);
@@ -517,6 +667,7 @@ af_err af_memory_manager_native_free(af_memory_manager handle, void *ptr) {
 
 af_err af_memory_manager_get_max_memory_size(af_memory_manager handle,
                                              size_t *size, int id) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         *size                  = manager.wrapper->getMaxMemorySize(id);
@@ -528,6 +679,7 @@ af_err af_memory_manager_get_max_memory_size(af_memory_manager handle,
 
 af_err af_memory_manager_get_memory_pressure_threshold(af_memory_manager handle,
                                                        float *value) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         *value                 = manager.wrapper->getMemoryPressureThreshold();
@@ -539,6 +691,7 @@ af_err af_memory_manager_get_memory_pressure_threshold(af_memory_manager handle,
 
 af_err af_memory_manager_set_memory_pressure_threshold(af_memory_manager handle,
                                                        float value) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.wrapper->setMemoryPressureThreshold(value);
@@ -553,6 +706,7 @@ af_err af_memory_manager_set_memory_pressure_threshold(af_memory_manager handle,
 
 af_err af_memory_manager_set_initialize_fn(af_memory_manager handle,
                                            af_memory_manager_initialize_fn fn) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.initialize_fn  = fn;
@@ -564,6 +718,7 @@ af_err af_memory_manager_set_initialize_fn(af_memory_manager handle,
 
 af_err af_memory_manager_set_shutdown_fn(af_memory_manager handle,
                                          af_memory_manager_shutdown_fn fn) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.shutdown_fn    = fn;
@@ -575,6 +730,7 @@ af_err af_memory_manager_set_shutdown_fn(af_memory_manager handle,
 
 af_err af_memory_manager_set_alloc_fn(af_memory_manager handle,
                                       af_memory_manager_alloc_fn fn) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.alloc_fn       = fn;
@@ -586,6 +742,7 @@ af_err af_memory_manager_set_alloc_fn(af_memory_manager handle,
 
 af_err af_memory_manager_set_allocated_fn(af_memory_manager handle,
                                           af_memory_manager_allocated_fn fn) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.allocated_fn   = fn;
@@ -597,6 +754,7 @@ af_err af_memory_manager_set_allocated_fn(af_memory_manager handle,
 
 af_err af_memory_manager_set_unlock_fn(af_memory_manager handle,
                                        af_memory_manager_unlock_fn fn) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.unlock_fn      = fn;
@@ -608,6 +766,7 @@ af_err af_memory_manager_set_unlock_fn(af_memory_manager handle,
 
 af_err af_memory_manager_set_signal_memory_cleanup_fn(
     af_memory_manager handle, af_memory_manager_signal_memory_cleanup_fn fn) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager           = getMemoryManager(handle);
         manager.signal_memory_cleanup_fn = fn;
@@ -619,6 +778,7 @@ af_err af_memory_manager_set_signal_memory_cleanup_fn(
 
 af_err af_memory_manager_set_print_info_fn(af_memory_manager handle,
                                            af_memory_manager_print_info_fn fn) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.print_info_fn  = fn;
@@ -630,6 +790,7 @@ af_err af_memory_manager_set_print_info_fn(af_memory_manager handle,
 
 af_err af_memory_manager_set_user_lock_fn(af_memory_manager handle,
                                           af_memory_manager_user_lock_fn fn) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.user_lock_fn   = fn;
@@ -641,6 +802,7 @@ af_err af_memory_manager_set_user_lock_fn(af_memory_manager handle,
 
 af_err af_memory_manager_set_user_unlock_fn(
     af_memory_manager handle, af_memory_manager_user_unlock_fn fn) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.user_unlock_fn = fn;
@@ -652,6 +814,7 @@ af_err af_memory_manager_set_user_unlock_fn(
 
 af_err af_memory_manager_set_is_user_locked_fn(
     af_memory_manager handle, af_memory_manager_is_user_locked_fn fn) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager    = getMemoryManager(handle);
         manager.is_user_locked_fn = fn;
@@ -663,6 +826,7 @@ af_err af_memory_manager_set_is_user_locked_fn(
 
 af_err af_memory_manager_set_get_memory_pressure_fn(
     af_memory_manager handle, af_memory_manager_get_memory_pressure_fn fn) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager         = getMemoryManager(handle);
         manager.get_memory_pressure_fn = fn;
@@ -675,6 +839,7 @@ af_err af_memory_manager_set_get_memory_pressure_fn(
 af_err af_memory_manager_set_jit_tree_exceeds_memory_pressure_fn(
     af_memory_manager handle,
     af_memory_manager_jit_tree_exceeds_memory_pressure_fn fn) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager                      = getMemoryManager(handle);
         manager.jit_tree_exceeds_memory_pressure_fn = fn;
@@ -686,6 +851,7 @@ af_err af_memory_manager_set_jit_tree_exceeds_memory_pressure_fn(
 
 af_err af_memory_manager_set_add_memory_management_fn(
     af_memory_manager handle, af_memory_manager_add_memory_management_fn fn) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager           = getMemoryManager(handle);
         manager.add_memory_management_fn = fn;
@@ -698,6 +864,7 @@ af_err af_memory_manager_set_add_memory_management_fn(
 af_err af_memory_manager_set_remove_memory_management_fn(
     af_memory_manager handle,
     af_memory_manager_remove_memory_management_fn fn) {
+    AF_API_RANGE();
     try {
         MemoryManager &manager              = getMemoryManager(handle);
         manager.remove_memory_management_fn = fn;
@@ -823,6 +990,38 @@ void MemoryManagerFunctionWrapper::setMemStepSize(size_t new_step_size) {
              AF_ERR_NOT_SUPPORTED);
 }
 
+// The memory statistics are not part of the public memory manager API
+void MemoryManagerFunctionWrapper::setStatsEnabled(bool enabled) {
+    UNUSED(enabled);
+    AF_ERROR("Memory statistics are not recorded by custom memory managers",
+             AF_ERR_NOT_SUPPORTED);
+}
+
+void MemoryManagerFunctionWrapper::resetStats(int device) {
+    UNUSED(device);
+    AF_ERROR("Memory statistics are not recorded by custom memory managers",
+             AF_ERR_NOT_SUPPORTED);
+}
+
+void MemoryManagerFunctionWrapper::getStats(af_mem_stats *stats, int device) {
+    UNUSED(stats);
+    UNUSED(device);
+    AF_ERROR("Memory statistics are not recorded by custom memory managers",
+             AF_ERR_NOT_SUPPORTED);
+}
+
+std::string MemoryManagerFunctionWrapper::getStatsJson(int device) {
+    UNUSED(device);
+    AF_ERROR("Memory statistics are not recorded by custom memory managers",
+             AF_ERR_NOT_SUPPORTED);
+}
+
+// The allocations of a memory scope are made by the custom memory manager as
+// usual
+void MemoryManagerFunctionWrapper::beginScope(size_t bytes) { UNUSED(bytes); }
+
+void MemoryManagerFunctionWrapper::endScope() {}
+
 void MemoryManagerFunctionWrapper::addMemoryManagement(int device) {
     getMemoryManager(handle_).add_memory_management_fn(handle_, device);
 }
@@ -45,6 +45,12 @@ class MemoryManagerFunctionWrapper final
     void setMemStepSize(size_t new_step_size) override;
     float getMemoryPressure() override;
     bool jitTreeExceedsMemoryPressure(size_t bytes) override;
+    void setStatsEnabled(bool enabled) override;
+    void resetStats(int device) override;
+    void getStats(af_mem_stats *stats, int device) override;
+    std::string getStatsJson(int device) override;
+    void beginScope(size_t bytes) override;
+    void endScope() override;
 
     void addMemoryManagement(int device) override;
     void removeMemoryManagement(int device) override;
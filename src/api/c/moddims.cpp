@@ -7,7 +7,9 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
+#include <common/bfloat16.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <copy.hpp>
@@ -17,6 +19,7 @@
 #include <af/dim4.hpp>
 
 using af::dim4;
+using common::bfloat16;
 using common::half;
 using detail::cdouble;
 using detail::cfloat;
@@ -39,6 +42,7 @@ af_array flat(const af_array in) {
 
 af_err af_moddims(af_array* out, const af_array in, const unsigned ndims,
                   const dim_t* const dims) {
+    AF_API_RANGE_ARRAY(in);
     try {
         if (ndims == 0) {
             *out = retain(in);
@@ -71,6 +75,7 @@ af_err af_moddims(af_array* out, const af_array in, const unsigned ndims,
             case s16: output = modDims<short>(in, newDims); break;
             case u16: output = modDims<ushort>(in, newDims); break;
             case f16: output = modDims<half>(in, newDims); break;
+            case bf16: output = modDims<bfloat16>(in, newDims); break;
             default: TYPE_ERROR(1, type);
         }
         std::swap(*out, output);
@@ -81,6 +86,7 @@ af_err af_moddims(af_array* out, const af_array in, const unsigned ndims,
 }
 
 af_err af_flat(af_array* out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& info = getInfo(in);
 
@@ -104,6 +110,7 @@ af_err af_flat(af_array* out, const af_array in) {
                 case s16: output = flat<short>(in); break;
                 case u16: output = flat<ushort>(in); break;
                 case f16: output = flat<half>(in); break;
+                case bf16: output = flat<bfloat16>(in); break;
                 default: TYPE_ERROR(1, type);
             }
             std::swap(*out, output);
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <cast.hpp>
@@ -179,17 +180,21 @@ af_err morph3d(af_array *out, const af_array &in, const af_array &mask,
 }
 
 af_err af_dilate(af_array *out, const af_array in, const af_array mask) {
+    AF_API_RANGE_ARRAY(in);
     return morph(out, in, mask, true);
 }
 
 af_err af_erode(af_array *out, const af_array in, const af_array mask) {
+    AF_API_RANGE_ARRAY(in);
     return morph(out, in, mask, false);
 }
 
 af_err af_dilate3(af_array *out, const af_array in, const af_array mask) {
+    AF_API_RANGE_ARRAY(in);
     return morph3d(out, in, mask, true);
 }
 
 af_err af_erode3(af_array *out, const af_array in, const af_array mask) {
+    AF_API_RANGE_ARRAY(in);
     return morph3d(out, in, mask, false);
 }
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
@@ -16,6 +17,7 @@
 #include <lu.hpp>
 #include <math.hpp>
 #include <reduce.hpp>
+#include <unary.hpp>
 #include <af/array.h>
 #include <af/constants.h>
 #include <af/defines.h>
@@ -33,66 +35,63 @@ using detail::reduce;
 using detail::reduce_all;
 using detail::scalar;
 
+// The terms of a norm, which is the root-th root of their sum or of their
+// maximum. The terms are computed from the lazy absolute values of the input,
+// so that they are evaluated in the reductions.
 template<typename T>
-double matrixNorm(const Array<T> &A, double p) {
-    if (p == 1) {
-        Array<T> colSum = reduce<af_add_t, T, T>(A, 0);
-        return reduce_all<af_max_t, T, T>(colSum);
-    }
-    if (p == af::Inf) {
-        Array<T> rowSum = reduce<af_add_t, T, T>(A, 1);
-        return reduce_all<af_max_t, T, T>(rowSum);
-    }
+struct NormTerms {
+    Array<T> values;
+    bool max;
+    double root;
+};
+
+template<typename T>
+NormTerms<T> matrixNorm(const Array<T> &A, double p) {
+    if (p == 1) { return {reduce<af_add_t, T, T>(A, 0), true, 1}; }
+    if (p == af::Inf) { return {reduce<af_add_t, T, T>(A, 1), true, 1}; }
 
     AF_ERROR("This type of norm is not supported in ArrayFire\n",
              AF_ERR_NOT_SUPPORTED);
 }
 
 template<typename T>
-double vectorNorm(const Array<T> &A, double p) {
-    if (p == 1) { return reduce_all<af_add_t, T, T>(A); }
+NormTerms<T> vectorNorm(const Array<T> &A, double p) {
+    if (p == 1) { return {A, false, 1}; }
     if (p == af::Inf) {
-        return reduce_all<af_max_t, T, T>(A);
+        return {A, true, 1};
     } else if (p == 2) {
-        Array<T> A_sq = arithOp<T, af_mul_t>(A, A, A.dims());
-        return std::sqrt(reduce_all<af_add_t, T, T>(A_sq));
+        return {arithOp<T, af_mul_t>(A, A, A.dims()), false, 2};
     }
 
-    Array<T> P   = createValueArray<T>(A.dims(), scalar<T>(p));
-    Array<T> A_p = arithOp<T, af_pow_t>(A, P, A.dims());
-    return std::pow(reduce_all<af_add_t, T, T>(A_p), T(1.0 / p));
+    Array<T> P = createValueArray<T>(A.dims(), scalar<T>(p));
+    return {arithOp<T, af_pow_t>(A, P, A.dims()), false, p};
 }
 
 template<typename T>
-double LPQNorm(const Array<T> &A, double p, double q) {
+NormTerms<T> LPQNorm(const Array<T> &A, double p, double q) {
     Array<T> A_p_norm = createEmptyArray<T>(dim4());
 
     if (p == 1) {
         A_p_norm = reduce<af_add_t, T, T>(A, 0);
     } else {
-        Array<T> P    = createValueArray<T>(A.dims(), scalar<T>(p));
-        Array<T> invP = createValueArray<T>(A.dims(), scalar<T>(1.0 / p));
+        Array<T> P = createValueArray<T>(A.dims(), scalar<T>(p));
 
         Array<T> A_p     = arithOp<T, af_pow_t>(A, P, A.dims());
         Array<T> A_p_sum = reduce<af_add_t, T, T>(A_p, 0);
-        A_p_norm         = arithOp<T, af_pow_t>(A_p_sum, invP, invP.dims());
+        Array<T> invP =
+            createValueArray<T>(A_p_sum.dims(), scalar<T>(1.0 / p));
+        A_p_norm = arithOp<T, af_pow_t>(A_p_sum, invP, invP.dims());
     }
 
-    if (q == 1) { return reduce_all<af_add_t, T, T>(A_p_norm); }
+    if (q == 1) { return {A_p_norm, false, 1}; }
 
-    Array<T> Q          = createValueArray<T>(A_p_norm.dims(), scalar<T>(q));
-    Array<T> A_p_norm_q = arithOp<T, af_pow_t>(A_p_norm, Q, Q.dims());
-
-    return std::pow(reduce_all<af_add_t, T, T>(A_p_norm_q), T(1.0 / q));
+    Array<T> Q = createValueArray<T>(A_p_norm.dims(), scalar<T>(q));
+    return {arithOp<T, af_pow_t>(A_p_norm, Q, Q.dims()), false, q};
 }
 
 template<typename T>
-double norm(const af_array a, const af_norm_type type, const double p,
-            const double q) {
-    using BT = typename af::dtype_traits<T>::base_type;
-
-    const Array<BT> A = detail::abs<BT, T>(getArray<T>(a));
-
+NormTerms<T> normTerms(const Array<T> &A, const af_norm_type type,
+                       const double p, const double q) {
     switch (type) {
         case AF_NORM_EUCLID: return vectorNorm(A, 2);
 
@@ -116,13 +115,58 @@ double norm(const af_array a, const af_norm_type type, const double p,
     }
 }
 
+template<typename T>
+double norm(const af_array a, const af_norm_type type, const double p,
+            const double q) {
+    using BT = typename af::dtype_traits<T>::base_type;
+
+    const Array<BT> A = detail::abs<BT, T>(getArray<T>(a));
+
+    // The terms are reduced on the device, and only the norm is read back
+    const NormTerms<BT> terms = normTerms(A, type, p, q);
+    const double value =
+        terms.max ? reduce_all<af_max_t, BT, BT>(terms.values)
+                  : reduce_all<af_add_t, BT, BT>(terms.values);
+
+    if (terms.root == 1) { return value; }
+    if (terms.root == 2) { return std::sqrt(value); }
+    return std::pow(value, 1.0 / terms.root);
+}
+
+// Returns the norms of the matrices of a, a batch along its third and fourth
+// dimensions, as a 1 x 1 x P x Q array
+template<typename T>
+af_array normBatched(const af_array a, const af_norm_type type,
+                     const double p, const double q) {
+    using BT = typename af::dtype_traits<T>::base_type;
+
+    const Array<BT> A = detail::abs<BT, T>(getArray<T>(a));
+
+    const NormTerms<BT> terms = normTerms(A, type, p, q);
+    Array<BT> value =
+        terms.max ? reduce<af_max_t, BT, BT>(
+                        reduce<af_max_t, BT, BT>(terms.values, 0), 1)
+                  : reduce<af_add_t, BT, BT>(
+                        reduce<af_add_t, BT, BT>(terms.values, 0), 1);
+
+    if (terms.root == 1) { return getHandle(value); }
+    if (terms.root == 2) {
+        return getHandle(detail::unaryOp<BT, af_sqrt_t>(value));
+    }
+    Array<BT> invRoot =
+        createValueArray<BT>(value.dims(), scalar<BT>(1.0 / terms.root));
+    return getHandle(arithOp<BT, af_pow_t>(value, invRoot, value.dims()));
+}
+
 af_err af_norm(double *out, const af_array in, const af_norm_type type,
                const double p, const double q) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &i_info = getInfo(in);
 
         if (i_info.ndims() > 2) {
-            AF_ERROR("solve can not be used in batch mode", AF_ERR_BATCH);
+            AF_ERROR("norm can not be used in batch mode, use af_norm_batched",
+                     AF_ERR_BATCH);
         }
 
         af_dtype i_type = i_info.getType();
@@ -145,3 +189,44 @@ af_err af_norm(double *out, const af_array in, const af_norm_type type,
 
     return AF_SUCCESS;
 }
+
+af_err af_norm_batched(af_array *out, const af_array in,
+                       const af_norm_type type, const double p,
+                       const double q) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const ArrayInfo &i_info = getInfo(in);
+        af_dtype i_type         = i_info.getType();
+
+        ARG_ASSERT(1, i_info.isFloating());  // Only floating and complex types
+        ARG_ASSERT(0, out != nullptr);
+
+        af_array output = 0;
+        if (i_info.elements() == 0) {
+            const dim4 oDims(1, 1, i_info.dims()[2], i_info.dims()[3]);
+            switch (i_type) {
+                case f32:
+                case c32:
+                    output = createHandleFromValue<float>(oDims, 0);
+                    break;
+                case f64:
+                case c64:
+                    output = createHandleFromValue<double>(oDims, 0);
+                    break;
+                default: TYPE_ERROR(1, i_type);
+            }
+        } else {
+            switch (i_type) {
+                case f32: output = normBatched<float>(in, type, p, q); break;
+                case f64: output = normBatched<double>(in, type, p, q); break;
+                case c32: output = normBatched<cfloat>(in, type, p, q); break;
+                case c64: output = normBatched<cdouble>(in, type, p, q); break;
+                default: TYPE_ERROR(1, i_type);
+            }
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
@@ -7,21 +7,32 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
+#include <copy.hpp>
 #include <features.hpp>
 #include <handle.hpp>
+#include <join.hpp>
 #include <orb.hpp>
 #include <af/defines.h>
 #include <af/dim4.hpp>
 #include <af/features.h>
 #include <af/vision.h>
 
+#include <vector>
+
 using af::dim4;
 
 using detail::Array;
 using detail::createEmptyArray;
+using detail::createHostDataArray;
+using detail::createSubArray;
+using detail::createValueArray;
+using detail::join;
+using detail::padArrayBorders;
 using detail::uint;
+using std::vector;
 
 template<typename T, typename convAccT>
 static void orb(af_features& feat_, af_array& descriptor, const af_array& in,
@@ -50,10 +61,72 @@ static void orb(af_features& feat_, af_array& descriptor, const af_array& in,
     descriptor = getHandle<unsigned>(desc);
 }
 
+/// Pads \p in with zeros to \p len along \p dim, the dimension of the
+/// features
+template<typename T>
+static Array<T> padFeatures(const Array<T>& in, const dim4& dims,
+                            const int dim, const dim_t len) {
+    if (in.elements() == 0) { return createValueArray<T>(dims, T(0)); }
+    dim4 upper(0, 0, 0, 0);
+    upper[dim] = len - in.dims()[dim];
+    return padArrayBorders(in, dim4(0, 0, 0, 0), upper, AF_PAD_ZERO);
+}
+
+template<typename T, typename convAccT>
+static void orbBatch(af_features& feat_, af_array& descriptor,
+                     af_array& counts, const af_array& in,
+                     const float fast_thr, const unsigned max_feat,
+                     const float scl_fctr, const unsigned levels,
+                     const bool blur_img) {
+    const Array<T> images = getArray<T>(in);
+    const dim_t num       = images.dims()[2];
+
+    // The features of each image, padded to max_feat
+    vector<Array<float>> x, y, score, ori, size;
+    vector<Array<uint>> desc;
+    vector<uint> h_counts(num);
+    vector<af_seq> index(AF_MAX_DIMS, af_span);
+    for (dim_t i = 0; i < num; ++i) {
+        index[2] = {static_cast<double>(i), static_cast<double>(i), 1.};
+        Array<float> xi     = createEmptyArray<float>(dim4());
+        Array<float> yi     = createEmptyArray<float>(dim4());
+        Array<float> scorei = createEmptyArray<float>(dim4());
+        Array<float> orii   = createEmptyArray<float>(dim4());
+        Array<float> sizei  = createEmptyArray<float>(dim4());
+        Array<uint> desci   = createEmptyArray<uint>(dim4());
+
+        h_counts[i] = orb<T, convAccT>(
+            xi, yi, scorei, orii, sizei, desci, createSubArray(images, index),
+            fast_thr, max_feat, scl_fctr, levels, blur_img);
+
+        const dim4 featDims(max_feat);
+        x.push_back(padFeatures(xi, featDims, 0, max_feat));
+        y.push_back(padFeatures(yi, featDims, 0, max_feat));
+        score.push_back(padFeatures(scorei, featDims, 0, max_feat));
+        ori.push_back(padFeatures(orii, featDims, 0, max_feat));
+        size.push_back(padFeatures(sizei, featDims, 0, max_feat));
+        desc.push_back(padFeatures(desci, dim4(8, max_feat), 1, max_feat));
+    }
+
+    af_features_t feat;
+    feat.n           = max_feat * num;
+    feat.x           = getHandle(join(1, x));
+    feat.y           = getHandle(join(1, y));
+    feat.score       = getHandle(join(1, score));
+    feat.orientation = getHandle(join(1, ori));
+    feat.size        = getHandle(join(1, size));
+
+    feat_      = getFeaturesHandle(feat);
+    descriptor = getHandle(join(2, desc));
+    counts =
+        getHandle(createHostDataArray<uint>(dim4(num), h_counts.data()));
+}
+
 af_err af_orb(af_features* feat, af_array* desc, const af_array in,
               const float fast_thr, const unsigned max_feat,
               const float scl_fctr, const unsigned levels,
               const bool blur_img) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& info = getInfo(in);
         af::dim4 dims         = info.dims();
@@ -87,3 +160,44 @@ af_err af_orb(af_features* feat, af_array* desc, const af_array in,
 
     return AF_SUCCESS;
 }
+
+af_err af_orb_batch(af_features* feat, af_array* desc, af_array* counts,
+                    const af_array in, const float fast_thr,
+                    const unsigned max_feat, const float scl_fctr,
+                    const unsigned levels, const bool blur_img) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const ArrayInfo& info = getInfo(in);
+        af::dim4 dims         = info.dims();
+
+        ARG_ASSERT(3, (dims[0] >= 7 && dims[1] >= 7 && dims[3] == 1));
+        ARG_ASSERT(4, fast_thr > 0.0f);
+        ARG_ASSERT(5, max_feat > 0);
+        ARG_ASSERT(6, scl_fctr > 1.0f);
+        ARG_ASSERT(7, levels > 0);
+
+        af_features tmp_feat;
+        af_array tmp_desc;
+        af_array tmp_counts;
+        af_dtype type = info.getType();
+        switch (type) {
+            case f32:
+                orbBatch<float, float>(tmp_feat, tmp_desc, tmp_counts, in,
+                                       fast_thr, max_feat, scl_fctr, levels,
+                                       blur_img);
+                break;
+            case f64:
+                orbBatch<double, double>(tmp_feat, tmp_desc, tmp_counts, in,
+                                         fast_thr, max_feat, scl_fctr, levels,
+                                         blur_img);
+                break;
+            default: TYPE_ERROR(3, type);
+        }
+        std::swap(*feat, tmp_feat);
+        std::swap(*desc, tmp_desc);
+        std::swap(*counts, tmp_counts);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <api_range.hpp>
 #include <backend.hpp>
 
 #include <arith.hpp>
@@ -47,7 +48,7 @@ using detail::max;
 using detail::min;
 using detail::reduce;
 using detail::scalar;
-using detail::svd;
+using detail::svdBatched;
 using detail::tile;
 using detail::uint;
 using std::swap;
@@ -83,19 +84,7 @@ Array<T> pinverseSvd(const Array<T> &in, const double tol) {
     Array<T> vT = createValueArray<T>(dim4(N, N, P, Q), scalar<T>(0));
     Array<Tr> sVec =
         createValueArray<Tr>(dim4(min(M, N), 1, P, Q), scalar<Tr>(0));
-    for (dim_t j = 0; j < Q; ++j) {
-        for (dim_t i = 0; i < P; ++i) {
-            Array<T> inSlice =
-                getSubArray(in, false, 0, M - 1, 0, N - 1, i, i, j, j);
-            Array<Tr> sVecSlice = getSubArray(
-                sVec, false, 0, sVec.dims()[0] - 1, 0, 0, i, i, j, j);
-            Array<T> uSlice  = getSubArray(u, false, 0, u.dims()[0] - 1, 0,
-                                          u.dims()[1] - 1, i, i, j, j);
-            Array<T> vTSlice = getSubArray(vT, false, 0, vT.dims()[0] - 1, 0,
-                                           vT.dims()[1] - 1, i, i, j, j);
-            svd<T, Tr>(sVecSlice, uSlice, vTSlice, inSlice);
-        }
-    }
+    svdBatched<T, Tr>(sVec, u, vT, in);
 
     // Cast s back to original data type for matmul later
     // (since svd() makes s' type the base type of T)
@@ -167,6 +156,7 @@ static inline af_array pinverse(const af_array in, const double tol) {
 
 af_err af_pinverse(af_array *out, const af_array in, const double tol,
                    const af_mat_prop options) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &i_info = getInfo(in);
 
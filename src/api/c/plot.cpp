@@ -11,45 +11,63 @@
 #include <af/graphics.h>
 #include <af/image.h>
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
 #include <common/graphics_common.hpp>
 #include <handle.hpp>
-#include <join.hpp>
 #include <plot.hpp>
 #include <reduce.hpp>
-#include <reorder.hpp>
-#include <transpose.hpp>
+
+#include <vector>
 
 using af::dim4;
 using detail::Array;
 using detail::copy_plot;
+using detail::createSubArray;
 using detail::forgeManager;
-using detail::reduce;
+using detail::reduce_all;
 using detail::uchar;
 using detail::uint;
 using detail::ushort;
+using std::vector;
 using namespace graphics;
 
-// Requires in_ to be in either [order, n] or [n, order] format
+// Requires in_ to be a single array in either [order, n] or [n, order]
+// format, or order vectors
 template<typename T, int order>
-fg_chart setup_plot(fg_window window, const af_array in_,
+fg_chart setup_plot(fg_window window, const vector<af_array>& in_,
                     const af_cell* const props, fg_plot_type ptype,
                     fg_marker_type mtype) {
     ForgeModule& _ = graphics::forgePlugin();
 
-    Array<T> in = getArray<T>(in_);
-
-    af::dim4 dims = in.dims();
-
-    DIM_ASSERT(1, dims.ndims() == 2);
-    DIM_ASSERT(1, (dims[0] == order || dims[1] == order));
-
-    // The data expected by backend is 2D [order, n]
-    if (dims[1] == order) { in = transpose(in, false); }
-
-    af::dim4 tdims = in.dims();  // transposed dimensions
+    // The components are the rows or the columns of a single array or one
+    // vector each. The backends write them straight into the buffer of the
+    // plot, so they are not joined and transposed first.
+    vector<Array<T>> components;
+    if (in_.size() == 1) {
+        const Array<T> in = getArray<T>(in_[0]);
+
+        af::dim4 dims = in.dims();
+
+        DIM_ASSERT(1, dims.ndims() == 2);
+        DIM_ASSERT(1, (dims[0] == order || dims[1] == order));
+
+        // The components are the columns of [n, order] and the rows of
+        // [order, n]
+        const int dim = dims[1] == order ? 1 : 0;
+        for (int c = 0; c < order; ++c) {
+            const double idx    = static_cast<double>(c);
+            vector<af_seq> seqs = {af_span, af_span};
+            seqs[dim]           = {idx, idx, 1};
+            components.push_back(createSubArray(in, seqs, false));
+        }
+    } else {
+        for (const af_array& component : in_) {
+            components.push_back(getArray<T>(component));
+        }
+    }
 
     ForgeManager& fgMngr = forgeManager();
 
@@ -64,7 +82,8 @@ fg_chart setup_plot(fg_window window, const af_array in_,
     }
 
     fg_plot plot =
-        fgMngr.getPlot(chart, tdims[1], getGLType<T>(), ptype, mtype);
+        fgMngr.getPlot(chart, components[0].elements(), getGLType<T>(), ptype,
+                       mtype);
 
     // ArrayFire LOGO Orange shade
     FG_CHECK(_.fg_set_plot_color(plot, 0.929f, 0.529f, 0.212f, 1.0));
@@ -76,8 +95,10 @@ fg_chart setup_plot(fg_window window, const af_array in_,
         T dmin[3], dmax[3];
         FG_CHECK(_.fg_get_chart_axes_limits(
             &cmin[0], &cmax[0], &cmin[1], &cmax[1], &cmin[2], &cmax[2], chart));
-        copyData(dmin, reduce<af_min_t, T, T>(in, 1));
-        copyData(dmax, reduce<af_max_t, T, T>(in, 1));
+        for (int c = 0; c < order; ++c) {
+            dmin[c] = reduce_all<af_min_t, T, T>(components[c]);
+            dmax[c] = reduce_all<af_max_t, T, T>(components[c]);
+        }
 
         if (cmin[0] == 0 && cmax[0] == 0 && cmin[1] == 0 && cmax[1] == 0 &&
             cmin[2] == 0 && cmax[2] == 0) {
@@ -101,15 +122,15 @@ fg_chart setup_plot(fg_window window, const af_array in_,
         FG_CHECK(_.fg_set_chart_axes_limits(chart, cmin[0], cmax[0], cmin[1],
                                             cmax[1], cmin[2], cmax[2]));
     }
-    copy_plot<T>(in, plot);
+    copy_plot<T>(components, plot);
 
     return chart;
 }
 
 template<typename T>
-fg_chart setup_plot(fg_window window, const af_array in_, const int order,
-                    const af_cell* const props, fg_plot_type ptype,
-                    fg_marker_type mtype) {
+fg_chart setup_plot(fg_window window, const vector<af_array>& in_,
+                    const int order, const af_cell* const props,
+                    fg_plot_type ptype, fg_marker_type mtype) {
     if (order == 2) {
         return setup_plot<T, 2>(window, in_, props, ptype, mtype);
     }
@@ -120,20 +141,22 @@ fg_chart setup_plot(fg_window window, const af_array in_, const int order,
     return NULL;
 }
 
-af_err plotWrapper(const af_window window, const af_array in,
+af_err plotWrapper(const af_window window, const af_array points,
                    const int order_dim, const af_cell* const props,
                    fg_plot_type ptype    = FG_PLOT_LINE,
                    fg_marker_type marker = FG_MARKER_NONE) {
     try {
         if (window == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
 
-        const ArrayInfo& info = getInfo(in);
+        const ArrayInfo& info = getInfo(points);
         af::dim4 dims         = info.dims();
         af_dtype type         = info.getType();
 
         DIM_ASSERT(0, dims.ndims() == 2);
         DIM_ASSERT(0, dims[order_dim] == 2 || dims[order_dim] == 3);
 
+        vector<af_array> in = {points};
+
         makeContextCurrent(window);
 
         fg_chart chart = NULL;
@@ -208,10 +231,7 @@ af_err plotWrapper(const af_window window, const af_array X, const af_array Y,
         TYPE_ASSERT(xType == yType);
         TYPE_ASSERT(xType == zType);
 
-        // Join for set up vector
-        af_array in    = 0;
-        af_array pIn[] = {X, Y, Z};
-        AF_CHECK(af_join_many(&in, 1, 3, pIn));
+        vector<af_array> in = {X, Y, Z};
 
         makeContextCurrent(window);
 
@@ -249,8 +269,6 @@ af_err plotWrapper(const af_window window, const af_array X, const af_array Y,
         } else {
             FG_CHECK(_.fg_draw_chart(window, chart));
         }
-
-        AF_CHECK(af_release_array(in));
     }
     CATCHALL;
     return AF_SUCCESS;
@@ -276,9 +294,7 @@ af_err plotWrapper(const af_window window, const af_array X, const af_array Y,
 
         TYPE_ASSERT(xType == yType);
 
-        // Join for set up vector
-        af_array in = 0;
-        AF_CHECK(af_join(&in, 1, X, Y));
+        vector<af_array> in = {X, Y};
 
         makeContextCurrent(window);
 
@@ -316,8 +332,6 @@ af_err plotWrapper(const af_window window, const af_array X, const af_array Y,
         } else {
             FG_CHECK(_.fg_draw_chart(window, chart));
         }
-
-        AF_CHECK(af_release_array(in));
     }
     CATCHALL;
     return AF_SUCCESS;
@@ -326,27 +340,32 @@ af_err plotWrapper(const af_window window, const af_array X, const af_array Y,
 // Plot API
 af_err af_draw_plot_nd(const af_window wind, const af_array in,
                        const af_cell* const props) {
+    AF_API_RANGE_ARRAY(in);
     return plotWrapper(wind, in, 1, props);
 }
 
 af_err af_draw_plot_2d(const af_window wind, const af_array X, const af_array Y,
                        const af_cell* const props) {
+    AF_API_RANGE_ARRAY(X);
     return plotWrapper(wind, X, Y, props);
 }
 
 af_err af_draw_plot_3d(const af_window wind, const af_array X, const af_array Y,
                        const af_array Z, const af_cell* const props) {
+    AF_API_RANGE_ARRAY(X);
     return plotWrapper(wind, X, Y, Z, props);
 }
 
 // Deprecated Plot API
 af_err af_draw_plot(const af_window wind, const af_array X, const af_array Y,
                     const af_cell* const props) {
+    AF_API_RANGE_ARRAY(X);
     return plotWrapper(wind, X, Y, props);
 }
 
 af_err af_draw_plot3(const af_window wind, const af_array P,
                      const af_cell* const props) {
+    AF_API_RANGE_ARRAY(P);
     try {
         const ArrayInfo& info = getInfo(P);
         af::dim4 dims         = info.dims();
@@ -378,6 +397,7 @@ af_err af_draw_plot3(const af_window wind, const af_array P,
 af_err af_draw_scatter_nd(const af_window wind, const af_array in,
                           const af_marker_type af_marker,
                           const af_cell* const props) {
+    AF_API_RANGE_ARRAY(in);
     fg_marker_type fg_marker = getFGMarker(af_marker);
     return plotWrapper(wind, in, 1, props, FG_PLOT_SCATTER, fg_marker);
 }
@@ -385,6 +405,7 @@ af_err af_draw_scatter_nd(const af_window wind, const af_array in,
 af_err af_draw_scatter_2d(const af_window wind, const af_array X,
                           const af_array Y, const af_marker_type af_marker,
                           const af_cell* const props) {
+    AF_API_RANGE_ARRAY(X);
     fg_marker_type fg_marker = getFGMarker(af_marker);
     return plotWrapper(wind, X, Y, props, FG_PLOT_SCATTER, fg_marker);
 }
@@ -393,6 +414,7 @@ af_err af_draw_scatter_3d(const af_window wind, const af_array X,
                           const af_array Y, const af_array Z,
                           const af_marker_type af_marker,
                           const af_cell* const props) {
+    AF_API_RANGE_ARRAY(X);
     fg_marker_type fg_marker = getFGMarker(af_marker);
     return plotWrapper(wind, X, Y, Z, props, FG_PLOT_SCATTER, fg_marker);
 }
@@ -401,6 +423,7 @@ af_err af_draw_scatter_3d(const af_window wind, const af_array X,
 af_err af_draw_scatter(const af_window wind, const af_array X, const af_array Y,
                        const af_marker_type af_marker,
                        const af_cell* const props) {
+    AF_API_RANGE_ARRAY(X);
     fg_marker_type fg_marker = getFGMarker(af_marker);
     return plotWrapper(wind, X, Y, props, FG_PLOT_SCATTER, fg_marker);
 }
@@ -408,6 +431,7 @@ af_err af_draw_scatter(const af_window wind, const af_array X, const af_array Y,
 af_err af_draw_scatter3(const af_window wind, const af_array P,
                         const af_marker_type af_marker,
                         const af_cell* const props) {
+    AF_API_RANGE_ARRAY(P);
     fg_marker_type fg_marker = getFGMarker(af_marker);
     try {
         const ArrayInfo& info = getInfo(P);
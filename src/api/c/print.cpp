@@ -9,8 +9,10 @@
 
 #include <print.hpp>
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/bfloat16.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <copy.hpp>
@@ -19,6 +21,7 @@
 #include <type_util.hpp>
 
 #include <af/array.h>
+#include <af/arith.h>
 #include <af/data.h>
 #include <af/internal.h>
 
@@ -30,6 +33,7 @@
 
 #include <af/index.h>
 
+using common::bfloat16;
 using common::half;
 using detail::cdouble;
 using detail::cfloat;
@@ -112,6 +116,17 @@ static void print(const char *exp, af_array arr, const int precision,
     os.flags(backup);
 }
 
+/// Prints the float values of the bfloat16 arrays. The transposition of the
+/// printed arrays is done by reorder, which does not support bfloat16.
+template<>
+void print<bfloat16>(const char *exp, af_array arr, const int precision,
+                     std::ostream &os, bool transpose) {
+    af_array arrF = 0;
+    AF_CHECK(af_cast(&arrF, arr, f32));
+    print<float>(exp, arrF, precision, os, transpose);
+    AF_CHECK(af_release_array(arrF));
+}
+
 template<typename T>
 static void printSparse(const char *exp, af_array arr, const int precision,
                         std::ostream &os = std::cout, bool transpose = true) {
@@ -126,6 +141,8 @@ static void printSparse(const char *exp, af_array arr, const int precision,
         case AF_STORAGE_CSR: os << "AF_STORAGE_CSR\n"; break;
         case AF_STORAGE_CSC: os << "AF_STORAGE_CSC\n"; break;
         case AF_STORAGE_COO: os << "AF_STORAGE_COO\n"; break;
+        case AF_STORAGE_BSR: os << "AF_STORAGE_BSR\n"; break;
+        case AF_STORAGE_SELL: os << "AF_STORAGE_SELL\n"; break;
     }
     os << "[" << sparse.dims() << "]\n";
 
@@ -138,6 +155,7 @@ static void printSparse(const char *exp, af_array arr, const int precision,
 }
 
 af_err af_print_array(af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         const ArrayInfo &info =
             getInfo(arr, false);  // Don't assert sparse/dense
@@ -166,6 +184,7 @@ af_err af_print_array(af_array arr) {
                 case s16: print<short>(NULL, arr, 4); break;
                 case u16: print<ushort>(NULL, arr, 4); break;
                 case f16: print<half>(NULL, arr, 4); break;
+                case bf16: print<bfloat16>(NULL, arr, 4); break;
                 default: TYPE_ERROR(1, type);
             }
         }
@@ -176,6 +195,7 @@ af_err af_print_array(af_array arr) {
 
 af_err af_print_array_gen(const char *exp, const af_array arr,
                           const int precision) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         ARG_ASSERT(0, exp != NULL);
         const ArrayInfo &info =
@@ -205,6 +225,7 @@ af_err af_print_array_gen(const char *exp, const af_array arr,
                 case s16: print<short>(exp, arr, precision); break;
                 case u16: print<ushort>(exp, arr, precision); break;
                 case f16: print<half>(exp, arr, precision); break;
+                case bf16: print<bfloat16>(exp, arr, precision); break;
                 default: TYPE_ERROR(1, type);
             }
         }
@@ -215,6 +236,7 @@ af_err af_print_array_gen(const char *exp, const af_array arr,
 
 af_err af_array_to_string(char **output, const char *exp, const af_array arr,
                           const int precision, bool transpose) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         ARG_ASSERT(0, exp != NULL);
         const ArrayInfo &info =
@@ -275,6 +297,9 @@ af_err af_array_to_string(char **output, const char *exp, const af_array arr,
                 case f16:
                     print<half>(exp, arr, precision, ss, transpose);
                     break;
+                case bf16:
+                    print<bfloat16>(exp, arr, precision, ss, transpose);
+                    break;
                 default: TYPE_ERROR(1, type);
             }
         }
@@ -0,0 +1,131 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <api_range.hpp>
+#include <backend.hpp>
+#include <common/ArrayInfo.hpp>
+#include <common/err_common.hpp>
+#include <convolve.hpp>
+#include <copy.hpp>
+#include <handle.hpp>
+#include <resize.hpp>
+#include <af/defines.h>
+#include <af/dim4.hpp>
+#include <af/image.h>
+
+#include <cmath>
+#include <vector>
+
+using af::dim4;
+using detail::Array;
+using detail::convolve2;
+using detail::copyArray;
+using detail::createEmptyArray;
+using detail::createHostDataArray;
+using detail::createSubArray;
+using detail::resize;
+using std::vector;
+
+/// Returns the dimensions of the \p level of a pyramid of \p idims
+static dim4 levelDims(const dim4 &idims, const float scale_factor,
+                      const unsigned level) {
+    const float lvl_scl = std::pow(scale_factor, static_cast<float>(level));
+    return dim4(static_cast<dim_t>(std::round(idims[0] / lvl_scl)),
+                static_cast<dim_t>(std::round(idims[1] / lvl_scl)), idims[2],
+                idims[3]);
+}
+
+template<typename T>
+static void pyramid(af_array *levels, const af_array in,
+                    const unsigned num_levels, const float scale_factor,
+                    const float sigma) {
+    const Array<T> input = getArray<T>(in);
+    const dim4 idims     = input.dims();
+
+    vector<dim4> ldims(num_levels);
+    dim_t total = 0;
+    for (unsigned i = 0; i < num_levels; ++i) {
+        ldims[i] = levelDims(idims, scale_factor, i);
+        total += ldims[i].elements();
+    }
+
+    // Separable Gaussian applied before each downsampling
+    Array<T> gauss = createEmptyArray<T>(dim4());
+    if (sigma > 0.f) {
+        const int radius = static_cast<int>(std::ceil(3.f * sigma));
+        vector<T> h_gauss(2 * radius + 1);
+        T sum = T(0);
+        for (int i = -radius; i <= radius; ++i) {
+            h_gauss[i + radius] =
+                static_cast<T>(std::exp(-(i * i) / (2.f * sigma * sigma)));
+            sum += h_gauss[i + radius];
+        }
+        for (auto &val : h_gauss) { val /= sum; }
+        gauss = createHostDataArray<T>(dim4(h_gauss.size()), h_gauss.data());
+    }
+
+    // The levels are views of one allocation, each made from the previous one
+    Array<T> slab = createEmptyArray<T>(dim4(total));
+    Array<T> prev = input;
+    dim_t offset  = 0;
+    for (unsigned i = 0; i < num_levels; ++i) {
+        const dim_t n             = ldims[i].elements();
+        const vector<af_seq> span = {
+            {static_cast<double>(offset), static_cast<double>(offset + n - 1),
+             1.}};
+        Array<T> level = createSubArray(slab, span, false);
+        level.modDims(ldims[i]);
+
+        if (i == 0) {
+            copyArray<T, T>(level, input);
+        } else {
+            Array<T> src =
+                sigma > 0.f ? convolve2<T, T>(prev, gauss, gauss, false) : prev;
+            copyArray<T, T>(level, resize<T>(src, ldims[i][0], ldims[i][1],
+                                             AF_INTERP_BILINEAR));
+        }
+
+        levels[i] = getHandle(level);
+        prev      = level;
+        offset += n;
+    }
+}
+
+af_err af_pyramid(af_array *levels, const af_array in,
+                  const unsigned num_levels, const float scale_factor,
+                  const float sigma) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const ArrayInfo &info = getInfo(in);
+        af_dtype type         = info.getType();
+        dim4 idims            = info.dims();
+
+        ARG_ASSERT(0, levels != nullptr);
+        DIM_ASSERT(1, idims.ndims() >= 2);
+        ARG_ASSERT(2, num_levels > 0);
+        ARG_ASSERT(3, scale_factor > 1.f);
+        ARG_ASSERT(4, sigma >= 0.f);
+
+        const dim4 last = levelDims(idims, scale_factor, num_levels - 1);
+        ARG_ASSERT(2, last[0] > 0 && last[1] > 0);
+
+        switch (type) {
+            case f32:
+                pyramid<float>(levels, in, num_levels, scale_factor, sigma);
+                break;
+            case f64:
+                pyramid<double>(levels, in, num_levels, scale_factor, sigma);
+                break;
+            default: TYPE_ERROR(1, type);
+        }
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -43,6 +44,7 @@ static inline af_array qr_inplace(af_array in) {
 }
 
 af_err af_qr(af_array *q, af_array *r, af_array *tau, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &i_info = getInfo(in);
 
@@ -78,6 +80,7 @@ af_err af_qr(af_array *q, af_array *r, af_array *tau, const af_array in) {
 }
 
 af_err af_qr_inplace(af_array *tau, af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &i_info = getInfo(in);
 
@@ -0,0 +1,107 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <api_range.hpp>
+#include <arith.hpp>
+#include <backend.hpp>
+#include <cast.hpp>
+#include <common/ArrayInfo.hpp>
+#include <common/err_common.hpp>
+#include <handle.hpp>
+#include <optypes.hpp>
+#include <unary.hpp>
+#include <af/arith.h>
+#include <af/defines.h>
+#include <af/dim4.hpp>
+
+#include <utility>
+
+using af::dim4;
+using detail::arithOp;
+using detail::Array;
+using detail::cast;
+using detail::createValueArray;
+using detail::uchar;
+using detail::unaryOp;
+
+namespace {
+
+/// Returns the scales or zero points \p param as floats with the dimensions
+/// which broadcast them over an array of \p dims. \p param has one value for
+/// the whole array, or one value per index of dimension \p dim.
+Array<float> channelParam(const af_array param, const dim4 &dims,
+                          const int dim, const int argId) {
+    const ArrayInfo &info = getInfo(param);
+    ARG_ASSERT(argId, info.isReal() && !info.isBool());
+
+    const dim_t count = info.elements();
+    ARG_ASSERT(argId, count == 1 || count == dims[dim]);
+
+    dim4 pdims(1, 1, 1, 1);
+    pdims[dim] = count;
+    return modDims(castArray<float>(param), pdims);
+}
+
+}  // namespace
+
+af_err af_quantize(af_array *out, const af_array in, const af_array scale,
+                   const af_array zero, const int dim) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const ArrayInfo &info = getInfo(in);
+        ARG_ASSERT(4, dim >= 0 && dim < AF_MAX_DIMS);
+        if (!info.isRealFloating()) { TYPE_ERROR(1, info.getType()); }
+
+        // The expression is one JIT tree, so the rounded and clamped values
+        // are computed by one kernel without intermediate arrays
+        const dim4 &dims = info.dims();
+        Array<float> res = arithOp<float, af_div_t>(
+            castArray<float>(in), channelParam(scale, dims, dim, 2), dims);
+        res = unaryOp<float, af_round_t>(res);
+        if (zero) {
+            res = arithOp<float, af_add_t>(
+                res, channelParam(zero, dims, dim, 3), dims);
+        }
+        res = arithOp<float, af_max_t>(
+            res, createValueArray<float>(dims, 0.f), dims);
+        res = arithOp<float, af_min_t>(
+            res, createValueArray<float>(dims, 255.f), dims);
+
+        af_array output = getHandle(cast<uchar, float>(res));
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_dequantize(af_array *out, const af_array in, const af_array scale,
+                     const af_array zero, const int dim) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const ArrayInfo &info = getInfo(in);
+        ARG_ASSERT(4, dim >= 0 && dim < AF_MAX_DIMS);
+        if (!info.isInteger()) { TYPE_ERROR(1, info.getType()); }
+
+        // The nodes are fused into the kernel of the expression which uses
+        // the result
+        const dim4 &dims = info.dims();
+        Array<float> res = castArray<float>(in);
+        if (zero) {
+            res = arithOp<float, af_sub_t>(
+                res, channelParam(zero, dims, dim, 3), dims);
+        }
+        res = arithOp<float, af_mul_t>(res, channelParam(scale, dims, dim, 2),
+                                       dims);
+
+        af_array output = getHandle(res);
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
@@ -9,18 +9,27 @@
 
 #include <af/random.h>
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/MersenneTwister.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
+#include <common/internal_enums.hpp>
+#include <copy.hpp>
 #include <handle.hpp>
+#include <platform.hpp>
 #include <random_engine.hpp>
 #include <types.hpp>
 #include <af/array.h>
 #include <af/data.h>
 #include <af/defines.h>
 #include <af/dim4.hpp>
+
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 using af::dim4;
 using common::half;
@@ -36,15 +45,19 @@ using common::temper_tbl;
 using detail::Array;
 using detail::cdouble;
 using detail::cfloat;
+using detail::copyArray;
 using detail::createEmptyArray;
 using detail::createHostDataArray;
+using detail::getActiveDeviceId;
 using detail::intl;
 using detail::normalDistribution;
+using detail::randomDistribution;
 using detail::uchar;
 using detail::uint;
 using detail::uintl;
 using detail::uniformDistribution;
 using detail::ushort;
+using std::vector;
 
 Array<uint> emptyArray() { return createEmptyArray<uint>(dim4(0)); }
 
@@ -73,6 +86,52 @@ struct RandomEngine {
         , state(emptyArray()) {}
 };
 
+/// The parameter tables of the Mersenne engine, which are shared by the
+/// engines of a device because the kernels do not modify them
+struct MersenneTables {
+    Array<uint> pos;
+    Array<uint> sh1;
+    Array<uint> sh2;
+    Array<uint> recursion_table;
+    Array<uint> temper_table;
+};
+
+/// Returns the tables of the active device, which are copied to it when
+/// the first Mersenne engine of the device is created
+const MersenneTables &getMersenneTables() {
+    static std::mutex tablesMutex;
+    // The tables are not released at exit, when the devices may already be
+    // gone
+    static auto *tables = new std::unordered_map<int, MersenneTables>();
+
+    const int device = static_cast<int>(getActiveDeviceId());
+    std::lock_guard<std::mutex> lock(tablesMutex);
+    auto iter = tables->find(device);
+    if (iter == tables->end()) {
+        MersenneTables created{
+            createHostDataArray<uint>(dim4(MaxBlocks), pos),
+            createHostDataArray<uint>(dim4(MaxBlocks), sh1),
+            createHostDataArray<uint>(dim4(MaxBlocks), sh2),
+            createHostDataArray<uint>(dim4(TableLength), recursion_tbl),
+            createHostDataArray<uint>(dim4(TableLength), temper_tbl)};
+        iter = tables->emplace(device, std::move(created)).first;
+    }
+    return iter->second;
+}
+
+/// Sets the tables of the Mersenne engine \p e and allocates its state,
+/// which is not initialized
+void setMersenneTables(RandomEngine &e) {
+    const MersenneTables &tables = getMersenneTables();
+    e.pos             = tables.pos;
+    e.sh1             = tables.sh1;
+    e.sh2             = tables.sh2;
+    e.mask            = mask;
+    e.recursion_table = tables.recursion_table;
+    e.temper_table    = tables.temper_table;
+    e.state           = createEmptyArray<uint>(dim4(MtStateLength));
+}
+
 af_random_engine getRandomEngineHandle(const RandomEngine &engine) {
     auto *engineHandle = new RandomEngine;
     *engineHandle      = engine;
@@ -111,6 +170,79 @@ inline af_array normalDistribution_(const dim4 &dims, RandomEngine *e) {
     }
 }
 
+template<typename T>
+inline af_array randomDistribution_(const AF_RANDOM_DIST dist,
+                                    const af_array param0,
+                                    const af_array param1, RandomEngine *e) {
+    const Array<T> &p0 = getArray<T>(param0);
+    const Array<T> &p1 = getArray<T>(param1);
+    return getHandle(randomDistribution<T>(
+        dist, p0.isLinear() ? p0 : copyArray(p0),
+        p1.isLinear() ? p1 : copyArray(p1), *(e->seed), *(e->counter)));
+}
+
+/// Samples \p dist with the parameters of each element of \p param0 and
+/// \p param1. The distributions with one parameter pass it twice.
+///
+/// The values are generated with Philox keyed by the seed of the engine, and
+/// the counter of the engine is advanced by the number of elements, for all
+/// the engine types.
+af_err sampleDistribution(af_array *out, const AF_RANDOM_DIST dist,
+                          const af_array param0, const af_array param1,
+                          af_random_engine engine) {
+    try {
+        AF_CHECK(af_init());
+        const ArrayInfo &info0 = getInfo(param0);
+        const ArrayInfo &info1 = getInfo(param1);
+        const af_dtype type    = info0.getType();
+        if (info1.getType() != type) { TYPE_ERROR(2, info1.getType()); }
+        DIM_ASSERT(2, info1.dims() == info0.dims());
+        RandomEngine *e = getRandomEngine(engine);
+
+        af_array result;
+        switch (type) {
+            case f32:
+                result = randomDistribution_<float>(dist, param0, param1, e);
+                break;
+            case f64:
+                result = randomDistribution_<double>(dist, param0, param1, e);
+                break;
+            default: TYPE_ERROR(1, type);
+        }
+        std::swap(*out, result);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+/// Returns the seed of the Mersenne substream \p index of an engine seeded
+/// with \p seed (the SplitMix64 output function)
+uintl substreamSeed(const uintl seed, const unsigned index) {
+    uintl z = seed + (static_cast<uintl>(index) + 1) * 0x9E3779B97F4A7C15ULL;
+    z       = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z       = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/// Returns the substream \p index of \p count substreams of \p e. The
+/// state of a Mersenne substream is allocated but not initialized.
+RandomEngine makeSubstream(const RandomEngine &e, const unsigned index,
+                           const unsigned count) {
+    // The substream does not share the seed and the counter of the engine
+    RandomEngine sub = e;
+    sub.seed         = std::make_shared<uintl>(*(e.seed));
+    sub.counter      = std::make_shared<uintl>(*(e.counter));
+
+    if (e.type == AF_RANDOM_ENGINE_MERSENNE_GP11213) {
+        *sub.seed = substreamSeed(*(e.seed), index);
+        sub.state = createEmptyArray<uint>(dim4(MtStateLength));
+    } else {
+        const uintl stride = std::numeric_limits<uintl>::max() / count;
+        *sub.counter += stride * index;
+    }
+    return sub;
+}
+
 void validateRandomType(const af_random_engine_type type) {
     if ((type != AF_RANDOM_ENGINE_PHILOX_4X32_10) &&
         (type != AF_RANDOM_ENGINE_THREEFRY_2X32_16) &&
@@ -125,6 +257,7 @@ void validateRandomType(const af_random_engine_type type) {
 }  // namespace
 
 af_err af_get_default_random_engine(af_random_engine *r) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
 
@@ -137,6 +270,7 @@ af_err af_get_default_random_engine(af_random_engine *r) {
 
 af_err af_create_random_engine(af_random_engine *engineHandle,
                                af_random_engine_type rtype, uintl seed) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         validateRandomType(rtype);
@@ -147,17 +281,7 @@ af_err af_create_random_engine(af_random_engine *engineHandle,
         *e.counter = 0;
 
         if (rtype == AF_RANDOM_ENGINE_MERSENNE_GP11213) {
-            e.pos  = createHostDataArray<uint>(dim4(MaxBlocks), pos);
-            e.sh1  = createHostDataArray<uint>(dim4(MaxBlocks), sh1);
-            e.sh2  = createHostDataArray<uint>(dim4(MaxBlocks), sh2);
-            e.mask = mask;
-
-            e.recursion_table =
-                createHostDataArray<uint>(dim4(TableLength), recursion_tbl);
-            e.temper_table =
-                createHostDataArray<uint>(dim4(TableLength), temper_tbl);
-            e.state = createEmptyArray<uint>(dim4(MtStateLength));
-
+            setMersenneTables(e);
             initMersenneState(e.state, seed, e.recursion_table);
         }
 
@@ -170,6 +294,7 @@ af_err af_create_random_engine(af_random_engine *engineHandle,
 
 af_err af_retain_random_engine(af_random_engine *outHandle,
                                const af_random_engine engineHandle) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         *outHandle = getRandomEngineHandle(*(getRandomEngine(engineHandle)));
@@ -180,23 +305,14 @@ af_err af_retain_random_engine(af_random_engine *outHandle,
 
 af_err af_random_engine_set_type(af_random_engine *engine,
                                  const af_random_engine_type rtype) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         validateRandomType(rtype);
         RandomEngine *e = getRandomEngine(*engine);
         if (rtype != e->type) {
             if (rtype == AF_RANDOM_ENGINE_MERSENNE_GP11213) {
-                e->pos  = createHostDataArray<uint>(dim4(MaxBlocks), pos);
-                e->sh1  = createHostDataArray<uint>(dim4(MaxBlocks), sh1);
-                e->sh2  = createHostDataArray<uint>(dim4(MaxBlocks), sh2);
-                e->mask = mask;
-
-                e->recursion_table =
-                    createHostDataArray<uint>(dim4(TableLength), recursion_tbl);
-                e->temper_table =
-                    createHostDataArray<uint>(dim4(TableLength), temper_tbl);
-                e->state = createEmptyArray<uint>(dim4(MtStateLength));
-
+                setMersenneTables(*e);
                 initMersenneState(e->state, *(e->seed), e->recursion_table);
             } else if (e->type == AF_RANDOM_ENGINE_MERSENNE_GP11213) {
                 e->pos             = emptyArray();
@@ -216,6 +332,7 @@ af_err af_random_engine_set_type(af_random_engine *engine,
 
 af_err af_random_engine_get_type(af_random_engine_type *rtype,
                                  const af_random_engine engine) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         RandomEngine *e = getRandomEngine(engine);
@@ -226,6 +343,7 @@ af_err af_random_engine_get_type(af_random_engine_type *rtype,
 }
 
 af_err af_set_default_random_engine_type(const af_random_engine_type rtype) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         af_random_engine e;
@@ -237,14 +355,16 @@ af_err af_set_default_random_engine_type(const af_random_engine_type rtype) {
 }
 
 af_err af_random_engine_set_seed(af_random_engine *engine, const uintl seed) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         RandomEngine *e = getRandomEngine(*engine);
         *(e->seed)      = seed;
+        // The counter of the Mersenne engine is only used by the
+        // distributions with per element parameters
+        *(e->counter) = 0;
         if (e->type == AF_RANDOM_ENGINE_MERSENNE_GP11213) {
             initMersenneState(e->state, seed, e->recursion_table);
-        } else {
-            *(e->counter) = 0;
         }
     }
     CATCHALL;
@@ -252,6 +372,7 @@ af_err af_random_engine_set_seed(af_random_engine *engine, const uintl seed) {
 }
 
 af_err af_random_engine_get_seed(uintl *const seed, af_random_engine engine) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         RandomEngine *e = getRandomEngine(engine);
@@ -261,9 +382,83 @@ af_err af_random_engine_get_seed(uintl *const seed, af_random_engine engine) {
     return AF_SUCCESS;
 }
 
+af_err af_random_engine_substream(af_random_engine *substream,
+                                  const af_random_engine engine,
+                                  const unsigned index, const unsigned count) {
+    AF_API_RANGE();
+    try {
+        AF_CHECK(af_init());
+        ARG_ASSERT(3, count > 0);
+        ARG_ASSERT(2, index < count);
+        const RandomEngine *e = getRandomEngine(engine);
+
+        RandomEngine sub = makeSubstream(*e, index, count);
+        if (e->type == AF_RANDOM_ENGINE_MERSENNE_GP11213) {
+            initMersenneState(sub.state, *sub.seed, sub.recursion_table);
+        }
+
+        *substream = getRandomEngineHandle(sub);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_random_engine_substreams(af_random_engine *substreams,
+                                   const af_random_engine engine,
+                                   const unsigned count) {
+    AF_API_RANGE();
+    try {
+        AF_CHECK(af_init());
+        ARG_ASSERT(0, substreams != nullptr);
+        ARG_ASSERT(2, count > 0);
+        const RandomEngine *e = getRandomEngine(engine);
+
+        vector<RandomEngine> subs;
+        subs.reserve(count);
+        for (unsigned i = 0; i < count; ++i) {
+            subs.push_back(makeSubstream(*e, i, count));
+        }
+
+        // The states of the Mersenne substreams are initialized together
+        if (e->type == AF_RANDOM_ENGINE_MERSENNE_GP11213) {
+            vector<Array<uint>> states;
+            vector<uintl> seeds;
+            states.reserve(count);
+            seeds.reserve(count);
+            for (const RandomEngine &sub : subs) {
+                states.push_back(sub.state);
+                seeds.push_back(*sub.seed);
+            }
+            initMersenneStates(states, seeds, e->recursion_table);
+        }
+
+        for (unsigned i = 0; i < count; ++i) {
+            substreams[i] = getRandomEngineHandle(subs[i]);
+        }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_random_engine_skip(af_random_engine *engine, const uintl n) {
+    AF_API_RANGE();
+    try {
+        AF_CHECK(af_init());
+        RandomEngine *e = getRandomEngine(*engine);
+        if (e->type == AF_RANDOM_ENGINE_MERSENNE_GP11213) {
+            AF_ERROR("The Mersenne random engine cannot skip values",
+                     AF_ERR_NOT_SUPPORTED);
+        }
+        *(e->counter) += n;
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
 af_err af_random_uniform(af_array *out, const unsigned ndims,
                          const dim_t *const dims, const af_dtype type,
                          af_random_engine engine) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         af_array result;
@@ -296,6 +491,7 @@ af_err af_random_uniform(af_array *out, const unsigned ndims,
 af_err af_random_normal(af_array *out, const unsigned ndims,
                         const dim_t *const dims, const af_dtype type,
                         af_random_engine engine) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         af_array result;
@@ -317,7 +513,34 @@ af_err af_random_normal(af_array *out, const unsigned ndims,
     return AF_SUCCESS;
 }
 
+af_err af_random_exponential(af_array *out, const af_array rate,
+                             af_random_engine engine) {
+    AF_API_RANGE_ARRAY(rate);
+    return sampleDistribution(out, AF_RANDOM_EXPONENTIAL, rate, rate, engine);
+}
+
+af_err af_random_gamma(af_array *out, const af_array shape,
+                       const af_array scale, af_random_engine engine) {
+    AF_API_RANGE_ARRAY(shape);
+    return sampleDistribution(out, AF_RANDOM_GAMMA, shape, scale, engine);
+}
+
+af_err af_random_poisson(af_array *out, const af_array lambda,
+                         af_random_engine engine) {
+    AF_API_RANGE_ARRAY(lambda);
+    return sampleDistribution(out, AF_RANDOM_POISSON, lambda, lambda, engine);
+}
+
+af_err af_random_truncated_normal(af_array *out, const af_array lower,
+                                  const af_array upper,
+                                  af_random_engine engine) {
+    AF_API_RANGE_ARRAY(lower);
+    return sampleDistribution(out, AF_RANDOM_TRUNCATED_NORMAL, lower, upper,
+                              engine);
+}
+
 af_err af_release_random_engine(af_random_engine engineHandle) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         delete getRandomEngine(engineHandle);
@@ -328,6 +551,7 @@ af_err af_release_random_engine(af_random_engine engineHandle) {
 
 af_err af_randu(af_array *out, const unsigned ndims, const dim_t *const dims,
                 const af_dtype type) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         af_array result;
@@ -361,6 +585,7 @@ af_err af_randu(af_array *out, const unsigned ndims, const dim_t *const dims,
 
 af_err af_randn(af_array *out, const unsigned ndims, const dim_t *const dims,
                 const af_dtype type) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         af_array result;
@@ -385,6 +610,7 @@ af_err af_randn(af_array *out, const unsigned ndims, const dim_t *const dims,
 }
 
 af_err af_set_seed(const uintl seed) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         af_random_engine engine;
@@ -396,6 +622,7 @@ af_err af_set_seed(const uintl seed) {
 }
 
 af_err af_get_seed(uintl *seed) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         af_random_engine e;
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -56,6 +57,7 @@ static inline uint rank(const af_array in, double tol) {
 }
 
 af_err af_rank(uint* out, const af_array in, const double tol) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& i_info = getInfo(in);
 
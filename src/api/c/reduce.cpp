@@ -7,7 +7,9 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
+#include <common/bfloat16.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <handle.hpp>
@@ -16,10 +18,14 @@
 #include <optypes.hpp>
 #include <reduce.hpp>
 #include <af/algorithm.h>
+#include <af/data.h>
 #include <af/defines.h>
 #include <af/dim4.hpp>
 
+#include <utility>
+
 using af::dim4;
+using common::bfloat16;
 using common::half;
 using detail::Array;
 using detail::cdouble;
@@ -352,6 +358,9 @@ static af_err reduce_promote(af_array *out, const af_array in, const int dim,
             case f16:
                 res = reduce<op, half, float>(in, dim, change_nan, nanval);
                 break;
+            case bf16:
+                res = reduce<op, bfloat16, float>(in, dim, change_nan, nanval);
+                break;
             default: TYPE_ERROR(1, type);
         }
         std::swap(*out, res);
@@ -439,68 +448,82 @@ static af_err reduce_promote_by_key(af_array *keys_out, af_array *vals_out,
 }
 
 af_err af_min(af_array *out, const af_array in, const int dim) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_common<af_min_t>(out, in, dim);
 }
 
 af_err af_max(af_array *out, const af_array in, const int dim) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_common<af_max_t>(out, in, dim);
 }
 
 af_err af_sum(af_array *out, const af_array in, const int dim) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_promote<af_add_t>(out, in, dim);
 }
 
 af_err af_product(af_array *out, const af_array in, const int dim) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_promote<af_mul_t>(out, in, dim);
 }
 
 af_err af_sum_nan(af_array *out, const af_array in, const int dim,
                   const double nanval) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_promote<af_add_t>(out, in, dim, true, nanval);
 }
 
 af_err af_product_nan(af_array *out, const af_array in, const int dim,
                       const double nanval) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_promote<af_mul_t>(out, in, dim, true, nanval);
 }
 
 af_err af_count(af_array *out, const af_array in, const int dim) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_type<af_notzero_t, uint>(out, in, dim);
 }
 
 af_err af_all_true(af_array *out, const af_array in, const int dim) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_type<af_and_t, char>(out, in, dim);
 }
 
 af_err af_any_true(af_array *out, const af_array in, const int dim) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_type<af_or_t, char>(out, in, dim);
 }
 
 // by key versions
 af_err af_min_by_key(af_array *keys_out, af_array *vals_out,
                      const af_array keys, const af_array vals, const int dim) {
+    AF_API_RANGE_ARRAY(keys);
     return reduce_by_key_common<af_min_t>(keys_out, vals_out, keys, vals, dim);
 }
 
 af_err af_max_by_key(af_array *keys_out, af_array *vals_out,
                      const af_array keys, const af_array vals, const int dim) {
+    AF_API_RANGE_ARRAY(keys);
     return reduce_by_key_common<af_max_t>(keys_out, vals_out, keys, vals, dim);
 }
 
 af_err af_sum_by_key(af_array *keys_out, af_array *vals_out,
                      const af_array keys, const af_array vals, const int dim) {
+    AF_API_RANGE_ARRAY(keys);
     return reduce_promote_by_key<af_add_t>(keys_out, vals_out, keys, vals, dim);
 }
 
 af_err af_product_by_key(af_array *keys_out, af_array *vals_out,
                          const af_array keys, const af_array vals,
                          const int dim) {
+    AF_API_RANGE_ARRAY(keys);
     return reduce_promote_by_key<af_mul_t>(keys_out, vals_out, keys, vals, dim);
 }
 
 af_err af_sum_by_key_nan(af_array *keys_out, af_array *vals_out,
                          const af_array keys, const af_array vals,
                          const int dim, const double nanval) {
+    AF_API_RANGE_ARRAY(keys);
     return reduce_promote_by_key<af_add_t>(keys_out, vals_out, keys, vals, dim,
                                            true, nanval);
 }
@@ -508,6 +531,7 @@ af_err af_sum_by_key_nan(af_array *keys_out, af_array *vals_out,
 af_err af_product_by_key_nan(af_array *keys_out, af_array *vals_out,
                              const af_array keys, const af_array vals,
                              const int dim, const double nanval) {
+    AF_API_RANGE_ARRAY(keys);
     return reduce_promote_by_key<af_mul_t>(keys_out, vals_out, keys, vals, dim,
                                            true, nanval);
 }
@@ -515,6 +539,7 @@ af_err af_product_by_key_nan(af_array *keys_out, af_array *vals_out,
 af_err af_count_by_key(af_array *keys_out, af_array *vals_out,
                        const af_array keys, const af_array vals,
                        const int dim) {
+    AF_API_RANGE_ARRAY(keys);
     return reduce_by_key_type<af_notzero_t, uint>(keys_out, vals_out, keys,
                                                   vals, dim);
 }
@@ -522,6 +547,7 @@ af_err af_count_by_key(af_array *keys_out, af_array *vals_out,
 af_err af_all_true_by_key(af_array *keys_out, af_array *vals_out,
                           const af_array keys, const af_array vals,
                           const int dim) {
+    AF_API_RANGE_ARRAY(keys);
     return reduce_by_key_type<af_and_t, char>(keys_out, vals_out, keys, vals,
                                               dim);
 }
@@ -529,10 +555,126 @@ af_err af_all_true_by_key(af_array *keys_out, af_array *vals_out,
 af_err af_any_true_by_key(af_array *keys_out, af_array *vals_out,
                           const af_array keys, const af_array vals,
                           const int dim) {
+    AF_API_RANGE_ARRAY(keys);
     return reduce_by_key_type<af_or_t, char>(keys_out, vals_out, keys, vals,
                                              dim);
 }
 
+/// Reduces the values of each distinct key with a hash table. Returns false
+/// when the keys have too many distinct values for it.
+template<af_op_t op, typename Tk, typename T>
+static bool reduce_by_key_hash(af_array *keys_out, af_array *vals_out,
+                               const af_array keys, const af_array vals) {
+    Array<Tk> oKeyArray = createEmptyArray<Tk>(dim4());
+    Array<T> oValArray  = createEmptyArray<T>(dim4());
+
+    if (!reduce_by_key_hash<op, T, Tk, T>(oKeyArray, oValArray,
+                                          getArray<Tk>(keys),
+                                          getArray<T>(vals))) {
+        return false;
+    }
+
+    *keys_out = getHandle(oKeyArray);
+    *vals_out = getHandle(oValArray);
+    return true;
+}
+
+template<af_op_t op, typename Tk>
+static bool reduce_hash_type(af_array *keys_out, af_array *vals_out,
+                             const af_array keys, const af_array vals) {
+    switch (getInfo(vals).getType()) {
+        case f32:
+            return reduce_by_key_hash<op, Tk, float>(keys_out, vals_out, keys,
+                                                     vals);
+        case s32:
+            return reduce_by_key_hash<op, Tk, int>(keys_out, vals_out, keys,
+                                                   vals);
+        case u32:
+            return reduce_by_key_hash<op, Tk, uint>(keys_out, vals_out, keys,
+                                                    vals);
+        default: return false;
+    }
+}
+
+template<af_op_t op>
+static bool reduce_hash_key(af_array *keys_out, af_array *vals_out,
+                            const af_array keys, const af_array vals) {
+    switch (getInfo(keys).getType()) {
+        case s32:
+            return reduce_hash_type<op, int>(keys_out, vals_out, keys, vals);
+        case u32:
+            return reduce_hash_type<op, uint>(keys_out, vals_out, keys, vals);
+        default: return false;
+    }
+}
+
+af_err af_reduce_by_key_unsorted(af_array *keys_out, af_array *vals_out,
+                                 const af_array keys, const af_array vals,
+                                 const af_binary_op op) {
+    AF_API_RANGE_ARRAY(keys);
+    try {
+        const ArrayInfo &kinfo = getInfo(keys);
+        const ArrayInfo &vinfo = getInfo(vals);
+        ARG_ASSERT(2, kinfo.isVector() || kinfo.elements() == 0);
+        ARG_ASSERT(3, vinfo.isVector() || vinfo.elements() == 0);
+        ARG_ASSERT(3, vinfo.elements() == kinfo.elements());
+        ARG_ASSERT(4, op == AF_BINARY_ADD || op == AF_BINARY_MIN ||
+                          op == AF_BINARY_MAX);
+
+        af_array okeys = 0;
+        af_array ovals = 0;
+        bool hashed    = false;
+        if (kinfo.elements() != 0) {
+            switch (op) {
+                case AF_BINARY_ADD:
+                    hashed = reduce_hash_key<af_add_t>(&okeys, &ovals, keys,
+                                                       vals);
+                    break;
+                case AF_BINARY_MIN:
+                    hashed = reduce_hash_key<af_min_t>(&okeys, &ovals, keys,
+                                                       vals);
+                    break;
+                default:
+                    hashed = reduce_hash_key<af_max_t>(&okeys, &ovals, keys,
+                                                       vals);
+                    break;
+            }
+        }
+
+        if (!hashed) {
+            // The keys are sorted, which groups the values of each key
+            af_array flatKeys = 0;
+            af_array flatVals = 0;
+            af_array skeys    = 0;
+            af_array svals    = 0;
+            AF_CHECK(af_flat(&flatKeys, keys));
+            AF_CHECK(af_flat(&flatVals, vals));
+            AF_CHECK(af_sort_by_key(&skeys, &svals, flatKeys, flatVals, 0,
+                                    true));
+            AF_CHECK(af_release_array(flatKeys));
+            AF_CHECK(af_release_array(flatVals));
+            switch (op) {
+                case AF_BINARY_ADD:
+                    AF_CHECK(af_sum_by_key(&okeys, &ovals, skeys, svals, 0));
+                    break;
+                case AF_BINARY_MIN:
+                    AF_CHECK(af_min_by_key(&okeys, &ovals, skeys, svals, 0));
+                    break;
+                default:
+                    AF_CHECK(af_max_by_key(&okeys, &ovals, skeys, svals, 0));
+                    break;
+            }
+            AF_CHECK(af_release_array(skeys));
+            AF_CHECK(af_release_array(svals));
+        }
+
+        std::swap(*keys_out, okeys);
+        std::swap(*vals_out, ovals);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
 template<af_op_t op, typename Ti, typename Tacc, typename Tret = double>
 static inline Tret reduce_all(const af_array in, bool change_nan = false,
                               double nanval = 0) {
@@ -677,6 +819,10 @@ static af_err reduce_all_promote(double *real_val, double *imag_val,
             case f16:
                 *real_val = reduce_all<op, half, float>(in, change_nan, nanval);
                 break;
+            case bf16:
+                *real_val =
+                    reduce_all<op, bfloat16, float>(in, change_nan, nanval);
+                break;
 
             default: TYPE_ERROR(1, type);
         }
@@ -687,30 +833,37 @@ static af_err reduce_all_promote(double *real_val, double *imag_val,
 }
 
 af_err af_min_all(double *real, double *imag, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_all_common<af_min_t>(real, imag, in);
 }
 
 af_err af_max_all(double *real, double *imag, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_all_common<af_max_t>(real, imag, in);
 }
 
 af_err af_sum_all(double *real, double *imag, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_all_promote<af_add_t>(real, imag, in);
 }
 
 af_err af_product_all(double *real, double *imag, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_all_promote<af_mul_t>(real, imag, in);
 }
 
 af_err af_count_all(double *real, double *imag, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_all_type<af_notzero_t, uint>(real, imag, in);
 }
 
 af_err af_all_true_all(double *real, double *imag, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_all_type<af_and_t, char>(real, imag, in);
 }
 
 af_err af_any_true_all(double *real, double *imag, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_all_type<af_or_t, char>(real, imag, in);
 }
 
@@ -790,10 +943,12 @@ static af_err ireduce_common(af_array *val, af_array *idx, const af_array in,
 }
 
 af_err af_imin(af_array *val, af_array *idx, const af_array in, const int dim) {
+    AF_API_RANGE_ARRAY(in);
     return ireduce_common<af_min_t>(val, idx, in, dim);
 }
 
 af_err af_imax(af_array *val, af_array *idx, const af_array in, const int dim) {
+    AF_API_RANGE_ARRAY(in);
     return ireduce_common<af_max_t>(val, idx, in, dim);
 }
 
@@ -866,6 +1021,7 @@ static af_err rreduce_common(af_array *val, af_array *idx, const af_array in,
 
 af_err af_max_ragged(af_array *val, af_array *idx, const af_array in,
                      const af_array ragged_len, const int dim) {
+    AF_API_RANGE_ARRAY(in);
     return rreduce_common<af_max_t>(val, idx, in, ragged_len, dim);
 }
 
@@ -935,20 +1091,286 @@ static af_err ireduce_all_common(double *real_val, double *imag_val,
 
 af_err af_imin_all(double *real, double *imag, unsigned *idx,
                    const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     return ireduce_all_common<af_min_t>(real, imag, idx, in);
 }
 
 af_err af_imax_all(double *real, double *imag, unsigned *idx,
                    const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     return ireduce_all_common<af_max_t>(real, imag, idx, in);
 }
 
 af_err af_sum_nan_all(double *real, double *imag, const af_array in,
                       const double nanval) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_all_promote<af_add_t>(real, imag, in, true, nanval);
 }
 
 af_err af_product_nan_all(double *real, double *imag, const af_array in,
                           const double nanval) {
+    AF_API_RANGE_ARRAY(in);
     return reduce_all_promote<af_mul_t>(real, imag, in, true, nanval);
 }
+
+/// Reduces all the elements of \p in to a one element array on the device.
+/// \p reduce is called with the flat array to reduce it along dimension 0.
+template<typename F>
+static af_err reduce_all_array(af_array *out, const af_array in, F reduce) {
+    try {
+        ARG_ASSERT(0, out != nullptr);
+
+        af_array flat = 0;
+        AF_CHECK(af_flat(&flat, in));
+        af_array res     = 0;
+        const af_err err = reduce(&res, flat);
+        AF_CHECK(af_release_array(flat));
+        AF_CHECK(err);
+
+        std::swap(*out, res);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+template<af_op_t op>
+static af_err ireduce_all_array(af_array *val, af_array *idx,
+                                const af_array in) {
+    try {
+        ARG_ASSERT(0, val != nullptr);
+        ARG_ASSERT(1, idx != nullptr);
+
+        af_array flat = 0;
+        AF_CHECK(af_flat(&flat, in));
+        af_array res     = 0;
+        af_array loc     = 0;
+        const af_err err = ireduce_common<op>(&res, &loc, flat, 0);
+        AF_CHECK(af_release_array(flat));
+        AF_CHECK(err);
+
+        std::swap(*val, res);
+        std::swap(*idx, loc);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_sum_all_array(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
+    return reduce_all_array(out, in, [](af_array *res, const af_array flat) {
+        return af_sum(res, flat, 0);
+    });
+}
+
+af_err af_sum_nan_all_array(af_array *out, const af_array in,
+                            const double nanval) {
+    AF_API_RANGE_ARRAY(in);
+    return reduce_all_array(
+        out, in, [nanval](af_array *res, const af_array flat) {
+            return af_sum_nan(res, flat, 0, nanval);
+        });
+}
+
+af_err af_product_all_array(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
+    return reduce_all_array(out, in, [](af_array *res, const af_array flat) {
+        return af_product(res, flat, 0);
+    });
+}
+
+af_err af_product_nan_all_array(af_array *out, const af_array in,
+                                const double nanval) {
+    AF_API_RANGE_ARRAY(in);
+    return reduce_all_array(
+        out, in, [nanval](af_array *res, const af_array flat) {
+            return af_product_nan(res, flat, 0, nanval);
+        });
+}
+
+af_err af_min_all_array(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
+    return reduce_all_array(out, in, [](af_array *res, const af_array flat) {
+        return af_min(res, flat, 0);
+    });
+}
+
+af_err af_max_all_array(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
+    return reduce_all_array(out, in, [](af_array *res, const af_array flat) {
+        return af_max(res, flat, 0);
+    });
+}
+
+af_err af_all_true_all_array(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
+    return reduce_all_array(out, in, [](af_array *res, const af_array flat) {
+        return af_all_true(res, flat, 0);
+    });
+}
+
+af_err af_any_true_all_array(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
+    return reduce_all_array(out, in, [](af_array *res, const af_array flat) {
+        return af_any_true(res, flat, 0);
+    });
+}
+
+af_err af_count_all_array(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
+    return reduce_all_array(out, in, [](af_array *res, const af_array flat) {
+        return af_count(res, flat, 0);
+    });
+}
+
+af_err af_imin_all_array(af_array *val, af_array *idx, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
+    return ireduce_all_array<af_min_t>(val, idx, in);
+}
+
+af_err af_imax_all_array(af_array *val, af_array *idx, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
+    return ireduce_all_array<af_max_t>(val, idx, in);
+}
+
+/// Reduces \p in along the \p ndims dimensions \p dims, which keep a length
+/// of 1. Each run of consecutive dimensions is merged into its first one with
+/// af_moddims, which does not copy linear arrays, and reduced by one call of
+/// \p reduce along that dimension.
+template<typename F>
+static af_err reduce_dims(af_array *out, const af_array in,
+                          const unsigned ndims, const int *dims, F reduce) {
+    try {
+        ARG_ASSERT(0, out != nullptr);
+        ARG_ASSERT(2, ndims <= 4);
+        ARG_ASSERT(3, ndims == 0 || dims != nullptr);
+
+        bool reduced[4] = {false, false, false, false};
+        for (unsigned i = 0; i < ndims; ++i) {
+            ARG_ASSERT(3, dims[i] >= 0 && dims[i] < 4);
+            ARG_ASSERT(3, !reduced[dims[i]]);
+            reduced[dims[i]] = true;
+        }
+
+        af_array res = 0;
+        AF_CHECK(af_retain_array(&res, in));
+        for (int begin = 0; begin < 4; ++begin) {
+            if (!reduced[begin]) { continue; }
+            int end = begin + 1;
+            while (end < 4 && reduced[end]) { ++end; }
+
+            if (end - begin == 1) {
+                af_array part    = 0;
+                const af_err err = reduce(&part, res, begin);
+                AF_CHECK(af_release_array(res));
+                res = part;
+                AF_CHECK(err);
+                continue;
+            }
+
+            const dim4 idims = getInfo(res).dims();
+            dim_t mdims[4]   = {1, 1, 1, 1};
+            dim_t odims[4]   = {idims[0], idims[1], idims[2], idims[3]};
+            for (int k = 0; k < begin; ++k) { mdims[k] = idims[k]; }
+            for (int k = begin; k < end; ++k) {
+                mdims[begin] *= idims[k];
+                odims[k] = 1;
+            }
+            for (int k = end; k < 4; ++k) {
+                mdims[begin + 1 + k - end] = idims[k];
+            }
+
+            af_array merged = 0;
+            af_array part   = 0;
+            af_err err      = af_moddims(&merged, res, 4, mdims);
+            if (err == AF_SUCCESS) {
+                err = reduce(&part, merged, begin);
+                AF_CHECK(af_release_array(merged));
+            }
+            AF_CHECK(af_release_array(res));
+            res = 0;
+            AF_CHECK(err);
+
+            err = af_moddims(&res, part, 4, odims);
+            AF_CHECK(af_release_array(part));
+            AF_CHECK(err);
+            begin = end;
+        }
+
+        std::swap(*out, res);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_sum_dims(af_array *out, const af_array in, const unsigned ndims,
+                   const int *dims) {
+    AF_API_RANGE_ARRAY(in);
+    return reduce_dims(
+        out, in, ndims, dims,
+        [](af_array *res, const af_array arr, const int dim) {
+            return af_sum(res, arr, dim);
+        });
+}
+
+af_err af_product_dims(af_array *out, const af_array in, const unsigned ndims,
+                       const int *dims) {
+    AF_API_RANGE_ARRAY(in);
+    return reduce_dims(
+        out, in, ndims, dims,
+        [](af_array *res, const af_array arr, const int dim) {
+            return af_product(res, arr, dim);
+        });
+}
+
+af_err af_min_dims(af_array *out, const af_array in, const unsigned ndims,
+                   const int *dims) {
+    AF_API_RANGE_ARRAY(in);
+    return reduce_dims(
+        out, in, ndims, dims,
+        [](af_array *res, const af_array arr, const int dim) {
+            return af_min(res, arr, dim);
+        });
+}
+
+af_err af_max_dims(af_array *out, const af_array in, const unsigned ndims,
+                   const int *dims) {
+    AF_API_RANGE_ARRAY(in);
+    return reduce_dims(
+        out, in, ndims, dims,
+        [](af_array *res, const af_array arr, const int dim) {
+            return af_max(res, arr, dim);
+        });
+}
+
+af_err af_count_dims(af_array *out, const af_array in, const unsigned ndims,
+                     const int *dims) {
+    AF_API_RANGE_ARRAY(in);
+    return reduce_dims(
+        out, in, ndims, dims,
+        [](af_array *res, const af_array arr, const int dim) {
+            return af_count(res, arr, dim);
+        });
+}
+
+af_err af_all_true_dims(af_array *out, const af_array in, const unsigned ndims,
+                        const int *dims) {
+    AF_API_RANGE_ARRAY(in);
+    return reduce_dims(
+        out, in, ndims, dims,
+        [](af_array *res, const af_array arr, const int dim) {
+            return af_all_true(res, arr, dim);
+        });
+}
+
+af_err af_any_true_dims(af_array *out, const af_array in, const unsigned ndims,
+                        const int *dims) {
+    AF_API_RANGE_ARRAY(in);
+    return reduce_dims(
+        out, in, ndims, dims,
+        [](af_array *res, const af_array arr, const int dim) {
+            return af_any_true(res, arr, dim);
+        });
+}
@@ -7,9 +7,12 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
+#include <reduce.hpp>
+#include <region_props.hpp>
 #include <regions.hpp>
 #include <types.hpp>
 #include <af/defines.h>
@@ -17,6 +20,10 @@
 #include <af/image.h>
 
 using af::dim4;
+using detail::Array;
+using detail::createEmptyArray;
+using detail::reduce_all;
+using detail::regionProps;
 using detail::uint;
 using detail::ushort;
 
@@ -25,8 +32,19 @@ static af_array regions(af_array const &in, af_connectivity connectivity) {
     return getHandle<T>(regions<T>(getArray<char>(in), connectivity));
 }
 
+template<typename T>
+static af_array regions(af_array *stats, af_array const &in,
+                        af_connectivity connectivity) {
+    Array<uint> regionStats = createEmptyArray<uint>(dim4());
+    af_array out =
+        getHandle<T>(regions<T>(getArray<char>(in), connectivity, regionStats));
+    *stats = getHandle(regionStats);
+    return out;
+}
+
 af_err af_regions(af_array *out, const af_array in,
                   const af_connectivity connectivity, const af_dtype type) {
+    AF_API_RANGE_ARRAY(in);
     try {
         ARG_ASSERT(2, (connectivity == AF_CONNECTIVITY_4 ||
                        connectivity == AF_CONNECTIVITY_8));
@@ -56,3 +74,87 @@ af_err af_regions(af_array *out, const af_array in,
 
     return AF_SUCCESS;
 }
+
+af_err af_regions_stats(af_array *out, af_array *stats, const af_array in,
+                        const af_connectivity connectivity,
+                        const af_dtype type) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        ARG_ASSERT(3, (connectivity == AF_CONNECTIVITY_4 ||
+                       connectivity == AF_CONNECTIVITY_8));
+
+        const ArrayInfo &info = getInfo(in);
+        af::dim4 dims         = info.dims();
+
+        dim_t in_ndims = dims.ndims();
+        DIM_ASSERT(2, (in_ndims == 2));
+
+        af_dtype in_type = info.getType();
+        if (in_type != b8) { TYPE_ERROR(2, in_type); }
+
+        af_array output;
+        af_array regionStats = 0;
+        switch (type) {
+            case f32:
+                output = regions<float>(&regionStats, in, connectivity);
+                break;
+            case f64:
+                output = regions<double>(&regionStats, in, connectivity);
+                break;
+            case s32:
+                output = regions<int>(&regionStats, in, connectivity);
+                break;
+            case u32:
+                output = regions<uint>(&regionStats, in, connectivity);
+                break;
+            case s16:
+                output = regions<short>(&regionStats, in, connectivity);
+                break;
+            case u16:
+                output = regions<ushort>(&regionStats, in, connectivity);
+                break;
+            default: TYPE_ERROR(4, type);
+        }
+        std::swap(*out, output);
+        std::swap(*stats, regionStats);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+template<typename T>
+static af_array regionProps(const af_array labels, unsigned nlabels) {
+    const Array<T> &in = getArray<T>(labels);
+    // The labels of regions are sequential, so the largest is their number
+    if (nlabels == 0) {
+        const T maxLabel = reduce_all<af_max_t, T, T>(in);
+        nlabels = maxLabel > T(0) ? static_cast<unsigned>(maxLabel) : 0;
+    }
+    return getHandle(regionProps<T>(in, nlabels));
+}
+
+af_err af_region_props(af_array *out, const af_array labels,
+                       const unsigned nlabels) {
+    AF_API_RANGE_ARRAY(labels);
+    try {
+        const ArrayInfo &info = getInfo(labels);
+        DIM_ASSERT(1, info.ndims() <= 2);
+
+        af_dtype type = info.getType();
+        af_array output;
+        switch (type) {
+            case f32: output = regionProps<float>(labels, nlabels); break;
+            case f64: output = regionProps<double>(labels, nlabels); break;
+            case s32: output = regionProps<int>(labels, nlabels); break;
+            case u32: output = regionProps<uint>(labels, nlabels); break;
+            case s16: output = regionProps<short>(labels, nlabels); break;
+            case u16: output = regionProps<ushort>(labels, nlabels); break;
+            default: TYPE_ERROR(1, type);
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
@@ -6,6 +6,7 @@
  * The complete license agreement can be obtained at:
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -23,22 +24,28 @@
 
 using af::dim4;
 using common::half;
+using detail::Array;
 using detail::cdouble;
 using detail::cfloat;
+using detail::createSelectNode;
 using detail::intl;
-using detail::select_scalar;
 using detail::uchar;
 using detail::uint;
 using detail::uintl;
 using detail::ushort;
 
+// The replacement is a select node of the JIT tree of a, so it is fused with
+// the expressions which produce and use a instead of writing a in place.
+// Other arrays sharing the buffer of a keep their values.
 template<typename T>
 void replace(af_array a, const af_array cond, const af_array b) {
-    select(getCopyOnWriteArray<T>(a), getArray<char>(cond), getArray<T>(a),
-           getArray<T>(b));
+    Array<T> &in = getArray<T>(a);
+    in = createSelectNode<T>(getArray<char>(cond), in, getArray<T>(b),
+                             in.dims());
 }
 
 af_err af_replace(af_array a, const af_array cond, const af_array b) {
+    AF_API_RANGE_ARRAY(a);
     try {
         const ArrayInfo& ainfo = getInfo(a);
         const ArrayInfo& binfo = getInfo(b);
@@ -84,11 +91,12 @@ af_err af_replace(af_array a, const af_array cond, const af_array b) {
 
 template<typename T>
 void replace_scalar(af_array a, const af_array cond, const double b) {
-    select_scalar<T, false>(getCopyOnWriteArray<T>(a), getArray<char>(cond),
-                            getArray<T>(a), b);
+    Array<T> &in = getArray<T>(a);
+    in = createSelectNode<T, false>(getArray<char>(cond), in, b, in.dims());
 }
 
 af_err af_replace_scalar(af_array a, const af_array cond, const double b) {
+    AF_API_RANGE_ARRAY(a);
     try {
         const ArrayInfo& ainfo = getInfo(a);
         const ArrayInfo& cinfo = getInfo(cond);
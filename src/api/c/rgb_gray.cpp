@@ -13,12 +13,12 @@
 #include <af/image.h>
 #include <af/index.h>
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <cast.hpp>
 #include <common/ArrayInfo.hpp>
 #include <handle.hpp>
-#include <join.hpp>
 #include <math.hpp>
 #include <tile.hpp>
 
@@ -26,8 +26,8 @@ using af::dim4;
 using detail::arithOp;
 using detail::Array;
 using detail::cast;
+using detail::createHostDataArray;
 using detail::createValueArray;
-using detail::join;
 using detail::scalar;
 using detail::uchar;
 using detail::uint;
@@ -77,27 +77,16 @@ static af_array gray2rgb(const af_array& in, const float r, const float g,
         return getHandle(tile(getArray<T>(in), tileDims));
     }
 
-    af_array mod_input = 0;
-    dim4 inputDims     = getInfo(in).dims();
-
-    dim4 matDims(inputDims[0], inputDims[1], 1, inputDims[2] * inputDims[3]);
-
-    AF_CHECK(af_moddims(&mod_input, in, matDims.ndims(), matDims.get()));
-    Array<cType> mod_in = cast<cType>(getArray<cType>(mod_input));
-
-    Array<cType> rCnst = createValueArray<cType>(matDims, scalar<cType>(r));
-    Array<cType> gCnst = createValueArray<cType>(matDims, scalar<cType>(g));
-    Array<cType> bCnst = createValueArray<cType>(matDims, scalar<cType>(b));
-
-    Array<cType> expr1 = arithOp<cType, af_mul_t>(mod_in, rCnst, matDims);
-    Array<cType> expr2 = arithOp<cType, af_mul_t>(mod_in, gCnst, matDims);
-    Array<cType> expr3 = arithOp<cType, af_mul_t>(mod_in, bCnst, matDims);
-
-    AF_CHECK(af_release_array(mod_input));
-
-    // join channels
-    Array<cType> expr4 = join<cType>(2, expr1, expr2);
-    return getHandle(join<cType>(2, expr3, expr4));
+    Array<cType> input = cast<cType>(getArray<T>(in));
+    dim4 odims         = input.dims();
+    odims[2]           = 3;
+
+    // The factors are broadcast with the gray channel, so the three
+    // channels are written by one JIT kernel
+    const cType factors[3] = {scalar<cType>(r), scalar<cType>(g),
+                              scalar<cType>(b)};
+    Array<cType> fac = createHostDataArray<cType>(dim4(1, 1, 3, 1), factors);
+    return getHandle(arithOp<cType, af_mul_t>(input, fac, odims));
 }
 
 template<typename T, typename cType, bool isRGB2GRAY>
@@ -164,10 +153,12 @@ af_err convert(af_array* out, const af_array in, const float r, const float g,
 
 af_err af_rgb2gray(af_array* out, const af_array in, const float rPercent,
                    const float gPercent, const float bPercent) {
+    AF_API_RANGE_ARRAY(in);
     return convert<true>(out, in, rPercent, gPercent, bPercent);
 }
 
 af_err af_gray2rgb(af_array* out, const af_array in, const float rFactor,
                    const float gFactor, const float bFactor) {
+    AF_API_RANGE_ARRAY(in);
     return convert<false>(out, in, rFactor, gFactor, bFactor);
 }
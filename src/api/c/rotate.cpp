@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -36,6 +37,7 @@ static inline af_array rotate(const af_array in, const float theta,
 
 af_err af_rotate(af_array *out, const af_array in, const float theta,
                  const bool crop, const af_interp_type method) {
+    AF_API_RANGE_ARRAY(in);
     try {
         dim_t odims0 = 0, odims1 = 0;
 
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <imgproc_common.hpp>
@@ -28,6 +29,7 @@ inline af_array sat(const af_array& in) {
 }
 
 af_err af_sat(af_array* out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& info = getInfo(in);
         const dim4& dims      = info.dims();
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
@@ -115,6 +116,7 @@ static inline af_array scan_op(const af_array in, const int dim,
 }
 
 af_err af_accum(af_array* out, const af_array in, const int dim) {
+    AF_API_RANGE_ARRAY(in);
     try {
         ARG_ASSERT(2, dim >= 0);
         ARG_ASSERT(2, dim < 4);
@@ -156,6 +158,7 @@ af_err af_accum(af_array* out, const af_array in, const int dim) {
 
 af_err af_scan(af_array* out, const af_array in, const int dim, af_binary_op op,
                bool inclusive_scan) {
+    AF_API_RANGE_ARRAY(in);
     try {
         ARG_ASSERT(2, dim >= 0);
         ARG_ASSERT(2, dim < 4);
@@ -219,6 +222,7 @@ af_err af_scan(af_array* out, const af_array in, const int dim, af_binary_op op,
 
 af_err af_scan_by_key(af_array* out, const af_array key, const af_array in,
                       const int dim, af_binary_op op, bool inclusive_scan) {
+    AF_API_RANGE_ARRAY(key);
     try {
         ARG_ASSERT(2, dim >= 0);
         ARG_ASSERT(2, dim < 4);
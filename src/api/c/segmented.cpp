@@ -0,0 +1,303 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// Segmented operations on values along the first dimension, split by an array
+// of offsets. The segment of each value is turned into a key, and the
+// operations are computed with the by key functions, which reduce and scan
+// the runs of equal keys.
+
+#include <api_range.hpp>
+#include <backend.hpp>
+#include <common/err_common.hpp>
+#include <handle.hpp>
+#include <af/algorithm.h>
+#include <af/arith.h>
+#include <af/data.h>
+#include <af/defines.h>
+#include <af/dim4.hpp>
+#include <af/index.h>
+
+#include <limits>
+
+using af::dim4;
+using detail::intl;
+using detail::uchar;
+using detail::uint;
+using detail::uintl;
+using detail::ushort;
+using std::numeric_limits;
+
+using reduce_by_key_func = af_err (*)(af_array *, af_array *, const af_array,
+                                      const af_array, const int);
+
+/// Checks the offsets of the segments of \p in, and returns their number. The
+/// offsets are the nondecreasing indices of the first value of each segment,
+/// followed by the number of values.
+static dim_t numSegments(const af_array in, const af_array offsets) {
+    const ArrayInfo &oinfo = getInfo(offsets);
+    const af_dtype otype   = oinfo.getType();
+    if (otype != s32 && otype != u32) { TYPE_ERROR(2, otype); }
+    ARG_ASSERT(2, oinfo.isVector() && oinfo.elements() > 1);
+    ARG_ASSERT(1, getInfo(in).ndims() > 0);
+    return oinfo.elements() - 1;
+}
+
+/// Returns the segment of each of the \p n values, which is the number of
+/// segments which end at or before the value, tiled to \p dims
+static af_array segmentKeys(const af_array offsets, const dim4 &dims) {
+    const dim_t n     = dims[0];
+    const dim_t nsegs = getInfo(offsets).elements() - 1;
+
+    af_array uoffsets = 0;
+    af_array ends     = 0;
+    AF_CHECK(af_cast(&uoffsets, offsets, u32));
+    const af_seq endSeq = {1, static_cast<double>(nsegs), 1};
+    AF_CHECK(af_index(&ends, uoffsets, 1, &endSeq));
+    AF_CHECK(af_release_array(uoffsets));
+
+    // Adds the number of segments ending at each index, which are consecutive
+    af_array ones   = 0;
+    af_array endIdx = 0;
+    af_array counts = 0;
+    AF_CHECK(af_constant(&ones, 1, 1, &nsegs, u32));
+    AF_CHECK(af_sum_by_key(&endIdx, &counts, ends, ones, 0));
+    AF_CHECK(af_release_array(ones));
+    AF_CHECK(af_release_array(ends));
+
+    af_array steps       = 0;
+    const dim_t nsteps   = n + 1;
+    af_index_t stepIndex = {{endIdx}, false, false};
+    AF_CHECK(af_constant(&steps, 0, 1, &nsteps, u32));
+    AF_CHECK(af_assign_gen(&steps, steps, 1, &stepIndex, counts));
+    AF_CHECK(af_release_array(endIdx));
+    AF_CHECK(af_release_array(counts));
+
+    af_array scanned    = 0;
+    af_array keys       = 0;
+    const af_seq keySeq = {0, static_cast<double>(n - 1), 1};
+    AF_CHECK(af_accum(&scanned, steps, 0));
+    AF_CHECK(af_index(&keys, scanned, 1, &keySeq));
+    AF_CHECK(af_release_array(steps));
+    AF_CHECK(af_release_array(scanned));
+
+    if (dims.elements() == n) { return keys; }
+
+    af_array tiled = 0;
+    AF_CHECK(af_tile(&tiled, keys, 1, dims[1], dims[2], dims[3]));
+    AF_CHECK(af_release_array(keys));
+    return tiled;
+}
+
+template<typename T>
+static void constantOf(af_array *out, const dim4 &dims, const af_dtype type,
+                       const T value) {
+    AF_CHECK(af_constant(out, static_cast<double>(value), dims.ndims(),
+                         dims.get(), type));
+}
+
+/// Returns an array of \p dims filled with the identity of \p op, which is
+/// the result of an empty segment
+template<af_op_t op>
+static af_array identityArray(const dim4 &dims, const af_dtype type) {
+    static_assert(op == af_add_t || op == af_min_t || op == af_max_t,
+                  "unsupported segmented reduction");
+    const bool isMin = op == af_min_t;
+    af_array out     = 0;
+    if (op == af_add_t) {
+        constantOf(&out, dims, type, 0);
+        return out;
+    }
+    switch (type) {
+        case f16:
+        case f32:
+        case f64:
+            constantOf(&out, dims, type,
+                       isMin ? numeric_limits<double>::infinity()
+                             : -numeric_limits<double>::infinity());
+            break;
+        case s32:
+            constantOf(&out, dims, type,
+                       isMin ? numeric_limits<int>::max()
+                             : numeric_limits<int>::lowest());
+            break;
+        case u32:
+            constantOf(&out, dims, type,
+                       isMin ? numeric_limits<uint>::max() : 0U);
+            break;
+        case s16:
+            constantOf(&out, dims, type,
+                       isMin ? numeric_limits<short>::max()
+                             : numeric_limits<short>::lowest());
+            break;
+        case u16:
+            constantOf(&out, dims, type,
+                       isMin ? numeric_limits<ushort>::max() : 0);
+            break;
+        case u8:
+            constantOf(&out, dims, type,
+                       isMin ? numeric_limits<uchar>::max() : 0);
+            break;
+        case b8: constantOf(&out, dims, type, isMin ? 1 : 0); break;
+        case s64:
+            AF_CHECK(af_constant_long(&out,
+                                      isMin ? numeric_limits<intl>::max()
+                                            : numeric_limits<intl>::lowest(),
+                                      dims.ndims(), dims.get()));
+            break;
+        case u64:
+            AF_CHECK(af_constant_ulong(
+                &out, isMin ? numeric_limits<uintl>::max() : 0, dims.ndims(),
+                dims.get()));
+            break;
+        default: TYPE_ERROR(1, type);
+    }
+    return out;
+}
+
+/// Reduces the values of each segment of \p in with \p reduceByKey. Empty
+/// segments are set to the identity of \p op.
+template<af_op_t op>
+static af_err reduceSegmented(af_array *out, const af_array in,
+                              const af_array offsets,
+                              reduce_by_key_func reduceByKey) {
+    try {
+        const dim_t nsegs     = numSegments(in, offsets);
+        const ArrayInfo &info = getInfo(in);
+        const af_dtype type   = info.getType();
+        if (op != af_add_t && (type == c32 || type == c64)) {
+            TYPE_ERROR(1, type);
+        }
+
+        dim4 odims = info.dims();
+        odims[0]   = nsegs;
+
+        af_array keys   = segmentKeys(offsets, dim4(info.dims()[0]));
+        af_array keyOut = 0;
+        af_array valOut = 0;
+        AF_CHECK(reduceByKey(&keyOut, &valOut, keys, in, 0));
+        AF_CHECK(af_release_array(keys));
+
+        // The segment keys of the results are unique, so the results of the
+        // nonempty segments are assigned without conflicts
+        if (getInfo(keyOut).elements() != nsegs) {
+            const af_dtype otype = getInfo(valOut).getType();
+            af_array res         = identityArray<op>(odims, otype);
+            af_index_t index     = {{keyOut}, false, false};
+            AF_CHECK(af_assign_gen(&res, res, 1, &index, valOut));
+            AF_CHECK(af_release_array(valOut));
+            valOut = res;
+        }
+        AF_CHECK(af_release_array(keyOut));
+        std::swap(*out, valOut);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_sort_segmented(af_array *out, const af_array in,
+                         const af_array offsets, const bool isAscending) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        numSegments(in, offsets);
+        const dim4 &dims = getInfo(in).dims();
+
+        // Sorts the values, then sorts their segments stably, which keeps the
+        // values sorted within each segment
+        af_array keys       = segmentKeys(offsets, dims);
+        af_array values     = 0;
+        af_array valueKeys  = 0;
+        af_array sortedKeys = 0;
+        af_array res        = 0;
+        AF_CHECK(af_sort_by_key(&values, &valueKeys, in, keys, 0, isAscending));
+        AF_CHECK(af_release_array(keys));
+        AF_CHECK(af_sort_by_key(&sortedKeys, &res, valueKeys, values, 0, true));
+        AF_CHECK(af_release_array(values));
+        AF_CHECK(af_release_array(valueKeys));
+        AF_CHECK(af_release_array(sortedKeys));
+        std::swap(*out, res);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_sort_by_key_segmented(af_array *out_keys, af_array *out_values,
+                                const af_array keys, const af_array values,
+                                const af_array offsets,
+                                const bool isAscending) {
+    AF_API_RANGE_ARRAY(keys);
+    try {
+        numSegments(keys, offsets);
+        const dim4 &dims = getInfo(keys).dims();
+        ARG_ASSERT(2, getInfo(values).dims() == dims);
+
+        // Both sorts of the first pass have the same keys, so they move the
+        // values and the segments in the same order
+        af_array segments = segmentKeys(offsets, dims);
+        af_array sk       = 0;
+        af_array sv       = 0;
+        af_array sk2      = 0;
+        af_array ss       = 0;
+        AF_CHECK(af_sort_by_key(&sk, &sv, keys, values, 0, isAscending));
+        AF_CHECK(af_sort_by_key(&sk2, &ss, keys, segments, 0, isAscending));
+        AF_CHECK(af_release_array(segments));
+        AF_CHECK(af_release_array(sk2));
+
+        af_array ss2  = 0;
+        af_array ss3  = 0;
+        af_array resK = 0;
+        af_array resV = 0;
+        AF_CHECK(af_sort_by_key(&ss2, &resK, ss, sk, 0, true));
+        AF_CHECK(af_sort_by_key(&ss3, &resV, ss, sv, 0, true));
+        AF_CHECK(af_release_array(sk));
+        AF_CHECK(af_release_array(sv));
+        AF_CHECK(af_release_array(ss));
+        AF_CHECK(af_release_array(ss2));
+        AF_CHECK(af_release_array(ss3));
+
+        std::swap(*out_keys, resK);
+        std::swap(*out_values, resV);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_sum_segmented(af_array *out, const af_array in,
+                        const af_array offsets) {
+    AF_API_RANGE_ARRAY(in);
+    return reduceSegmented<af_add_t>(out, in, offsets, af_sum_by_key);
+}
+
+af_err af_min_segmented(af_array *out, const af_array in,
+                        const af_array offsets) {
+    AF_API_RANGE_ARRAY(in);
+    return reduceSegmented<af_min_t>(out, in, offsets, af_min_by_key);
+}
+
+af_err af_max_segmented(af_array *out, const af_array in,
+                        const af_array offsets) {
+    AF_API_RANGE_ARRAY(in);
+    return reduceSegmented<af_max_t>(out, in, offsets, af_max_by_key);
+}
+
+af_err af_scan_segmented(af_array *out, const af_array in,
+                         const af_array offsets, const af_binary_op op,
+                         const bool inclusive_scan) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        numSegments(in, offsets);
+
+        af_array keys = segmentKeys(offsets, getInfo(in).dims());
+        af_array res  = 0;
+        AF_CHECK(af_scan_by_key(&res, keys, in, 0, op, inclusive_scan));
+        AF_CHECK(af_release_array(keys));
+        std::swap(*out, res);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
@@ -6,6 +6,7 @@
  * The complete license agreement can be obtained at:
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -41,6 +42,7 @@ af_array select(const af_array cond, const af_array a, const af_array b,
 
 af_err af_select(af_array* out, const af_array cond, const af_array a,
                  const af_array b) {
+    AF_API_RANGE_ARRAY(cond);
     try {
         const ArrayInfo& ainfo     = getInfo(a);
         const ArrayInfo& binfo     = getInfo(b);
@@ -98,6 +100,7 @@ af_array select_scalar(const af_array cond, const af_array a, const double b,
 
 af_err af_select_scalar_r(af_array* out, const af_array cond, const af_array a,
                           const double b) {
+    AF_API_RANGE_ARRAY(cond);
     try {
         const ArrayInfo& ainfo = getInfo(a);
         const ArrayInfo& cinfo = getInfo(cond);
@@ -163,6 +166,7 @@ af_err af_select_scalar_r(af_array* out, const af_array cond, const af_array a,
 
 af_err af_select_scalar_l(af_array* out, const af_array cond, const double a,
                           const af_array b) {
+    AF_API_RANGE_ARRAY(cond);
     try {
         const ArrayInfo& binfo = getInfo(b);
         const ArrayInfo& cinfo = getInfo(cond);
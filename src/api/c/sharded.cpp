@@ -0,0 +1,263 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <api_range.hpp>
+#include <backend.hpp>
+#include <common/ArrayInfo.hpp>
+#include <common/err_common.hpp>
+#include <handle.hpp>
+#include <platform.hpp>
+#include <with_device.hpp>
+#include <af/algorithm.h>
+#include <af/array.h>
+#include <af/data.h>
+#include <af/device.h>
+#include <af/event.h>
+#include <af/sharded.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+using af::dim4;
+using detail::getActiveDeviceId;
+using detail::getDeviceCount;
+using std::unique_ptr;
+using std::vector;
+
+namespace {
+
+/// Array handles which are released with the object
+struct Handles {
+    vector<af_array> arrays;
+
+    Handles()                           = default;
+    Handles(const Handles &)            = delete;
+    Handles &operator=(const Handles &) = delete;
+    ~Handles() {
+        for (af_array arr : arrays) { af_release_array(arr); }
+    }
+};
+
+/// The shards of an array split along one dimension, each on its own device
+struct ShardedArray {
+    Handles shards;
+    vector<int> devices;
+    int dim;
+    dim4 dims;
+};
+
+const ShardedArray &getSharded(const af_sharded_array arr) {
+    if (arr == nullptr) { AF_ERROR("Invalid sharded array", AF_ERR_ARG); }
+    return *static_cast<const ShardedArray *>(arr);
+}
+
+/// Returns the last dimension of \p dims larger than one
+int lastDimension(const dim4 &dims) {
+    for (int d = 3; d > 0; --d) {
+        if (dims[d] > 1) { return d; }
+    }
+    return 0;
+}
+
+/// Returns the dimensions of \p shards joined along \p dim
+dim4 joinedDims(const vector<af_array> &shards, const int dim) {
+    dim4 dims = getInfo(shards[0], false, false).dims();
+    for (size_t i = 1; i < shards.size(); ++i) {
+        const dim4 &shardDims = getInfo(shards[i], false, false).dims();
+        for (int d = 0; d < 4; ++d) {
+            if (d == dim) { continue; }
+            DIM_ASSERT(0, shardDims[d] == dims[d]);
+        }
+        dims[dim] += shardDims[dim];
+    }
+    return dims;
+}
+
+af_err reduceAll(af_array *out, const af_array in, const af_binary_op op) {
+    switch (op) {
+        case AF_BINARY_ADD: return af_sum(out, in, 0);
+        case AF_BINARY_MUL: return af_product(out, in, 0);
+        case AF_BINARY_MIN: return af_min(out, in, 0);
+        case AF_BINARY_MAX: return af_max(out, in, 0);
+        default: return AF_ERR_ARG;
+    }
+}
+
+}  // namespace
+
+af_err af_create_sharded_array(af_sharded_array *out, const af_array in,
+                               const unsigned num_devices,
+                               const int *devices) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        ARG_ASSERT(0, out != nullptr);
+        ARG_ASSERT(2, num_devices > 0);
+        ARG_ASSERT(3, devices != nullptr);
+        const ArrayInfo &info = getInfo(in, true, false);
+
+        unique_ptr<ShardedArray> res(new ShardedArray());
+        res->dim  = lastDimension(info.dims());
+        res->dims = info.dims();
+        res->devices.assign(devices, devices + num_devices);
+        res->shards.arrays.resize(num_devices, nullptr);
+        AF_CHECK(af_scatter(nullptr, res->shards.arrays.data(), in, res->dim,
+                            num_devices, devices));
+        *out = res.release();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_release_sharded_array(af_sharded_array arr) {
+    AF_API_RANGE();
+    try {
+        delete static_cast<ShardedArray *>(arr);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_sharded_info(unsigned *num_shards, int *dim, dim_t *dims,
+                           const af_sharded_array arr) {
+    AF_API_RANGE();
+    try {
+        const ShardedArray &in = getSharded(arr);
+        if (num_shards) { *num_shards = in.devices.size(); }
+        if (dim) { *dim = in.dim; }
+        if (dims) {
+            for (int d = 0; d < 4; ++d) { dims[d] = in.dims[d]; }
+        }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_shard(af_array *shard, const af_sharded_array arr,
+                    const unsigned index) {
+    AF_API_RANGE();
+    try {
+        const ShardedArray &in = getSharded(arr);
+        ARG_ASSERT(2, index < in.devices.size());
+        AF_CHECK(af_retain_array(shard, in.shards.arrays[index]));
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_sharded_map(af_sharded_array *out, const unsigned num_inputs,
+                      const af_sharded_array *ins, af_shard_fn fn,
+                      void *user_data) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(0, out != nullptr);
+        ARG_ASSERT(1, num_inputs > 0);
+        ARG_ASSERT(2, ins != nullptr);
+        ARG_ASSERT(3, fn != nullptr);
+
+        const ShardedArray &first = getSharded(ins[0]);
+        const size_t num_shards   = first.devices.size();
+        for (unsigned j = 1; j < num_inputs; ++j) {
+            const ShardedArray &in = getSharded(ins[j]);
+            ARG_ASSERT(2, in.devices == first.devices && in.dim == first.dim);
+            for (size_t i = 0; i < num_shards; ++i) {
+                const af_array lhs = first.shards.arrays[i];
+                const af_array rhs = in.shards.arrays[i];
+                DIM_ASSERT(2, getInfo(lhs, false, false).dims() ==
+                                  getInfo(rhs, false, false).dims());
+            }
+        }
+
+        unique_ptr<ShardedArray> res(new ShardedArray());
+        res->dim     = first.dim;
+        res->devices = first.devices;
+
+        // The result of each shard is evaluated before the next one, so the
+        // devices compute their shards concurrently
+        vector<af_array> shards(num_inputs);
+        for (size_t i = 0; i < num_shards; ++i) {
+            for (unsigned j = 0; j < num_inputs; ++j) {
+                shards[j] = getSharded(ins[j]).shards.arrays[i];
+            }
+            withDevice(first.devices[i], [&]() {
+                af_array shard = nullptr;
+                AF_CHECK(fn(&shard, shards.data(), num_inputs, user_data));
+                if (shard == nullptr) {
+                    AF_ERROR("The shard function returned no array",
+                             AF_ERR_ARG);
+                }
+                res->shards.arrays.push_back(shard);
+                AF_CHECK(af_eval(shard));
+            });
+        }
+        res->dims = joinedDims(res->shards.arrays, res->dim);
+        *out      = res.release();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_sharded_reduce(af_array *out, const af_sharded_array in,
+                         const af_binary_op op, const int device) {
+    AF_API_RANGE();
+    try {
+        const ShardedArray &arr = getSharded(in);
+        ARG_ASSERT(2, op == AF_BINARY_ADD || op == AF_BINARY_MUL ||
+                          op == AF_BINARY_MIN || op == AF_BINARY_MAX);
+        ARG_ASSERT(3, device < getDeviceCount());
+        const int dst =
+            device < 0 ? static_cast<int>(getActiveDeviceId()) : device;
+
+        // The partial results of the shards are computed on their devices
+        Handles partials;
+        for (size_t i = 0; i < arr.devices.size(); ++i) {
+            withDevice(arr.devices[i], [&]() {
+                Handles temps;
+                temps.arrays.resize(2, nullptr);
+                AF_CHECK(af_flat(&temps.arrays[0], arr.shards.arrays[i]));
+                AF_CHECK(reduceAll(&temps.arrays[1], temps.arrays[0], op));
+
+                af_event event   = nullptr;
+                af_array partial = nullptr;
+                AF_CHECK(
+                    af_copy_to_device(&event, &partial, temps.arrays[1], dst));
+                partials.arrays.push_back(partial);
+                AF_CHECK(af_delete_event(event));
+            });
+        }
+
+        af_array res = nullptr;
+        withDevice(dst, [&]() {
+            Handles joined;
+            joined.arrays.resize(1, nullptr);
+            AF_CHECK(af_join_many(&joined.arrays[0], 0,
+                                  partials.arrays.size(),
+                                  partials.arrays.data()));
+            AF_CHECK(reduceAll(&res, joined.arrays[0], op));
+        });
+        std::swap(*out, res);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_sharded_gather(af_array *out, const af_sharded_array in,
+                         const int device) {
+    AF_API_RANGE();
+    try {
+        const ShardedArray &arr = getSharded(in);
+        ARG_ASSERT(2, device < getDeviceCount());
+        const int dst =
+            device < 0 ? static_cast<int>(getActiveDeviceId()) : device;
+        AF_CHECK(af_gather(nullptr, out, arr.devices.size(),
+                           arr.shards.arrays.data(), arr.dim, dst));
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -28,6 +29,7 @@ static inline af_array shift(const af_array in, const int sdims[4]) {
 }
 
 af_err af_shift(af_array *out, const af_array in, const int sdims[4]) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in);
         af_dtype type         = info.getType();
@@ -61,6 +63,7 @@ af_err af_shift(af_array *out, const af_array in, const int sdims[4]) {
 
 af_err af_shift(af_array *out, const af_array in, const int x, const int y,
                 const int z, const int w) {
+    AF_API_RANGE_ARRAY(in);
     const int sdims[] = {x, y, z, w};
     return af_shift(out, in, sdims);
 }
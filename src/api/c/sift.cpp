@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
 #include <features.hpp>
@@ -56,6 +57,7 @@ af_err af_sift(af_features* feat, af_array* desc, const af_array in,
                const float edge_thr, const float init_sigma,
                const bool double_input, const float img_scale,
                const float feature_ratio) {
+    AF_API_RANGE_ARRAY(in);
     try {
 #ifdef AF_WITH_NONFREE_SIFT
         const ArrayInfo& info = getInfo(in);
@@ -115,6 +117,7 @@ af_err af_gloh(af_features* feat, af_array* desc, const af_array in,
                const float edge_thr, const float init_sigma,
                const bool double_input, const float img_scale,
                const float feature_ratio) {
+    AF_API_RANGE_ARRAY(in);
     try {
 #ifdef AF_WITH_NONFREE_SIFT
         const ArrayInfo& info = getInfo(in);
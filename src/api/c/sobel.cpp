@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
@@ -36,6 +37,7 @@ ArrayPair sobelDerivatives(const af_array &in, const unsigned &ker_size) {
 
 af_err af_sobel_operator(af_array *dx, af_array *dy, const af_array img,
                          const unsigned ker_size) {
+    AF_API_RANGE_ARRAY(img);
     try {
         // FIXME: ADD SUPPORT FOR OTHER KERNEL SIZES
         // ARG_ASSERT(4, (ker_size==3 || ker_size==5 || ker_size==7));
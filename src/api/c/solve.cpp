@@ -7,16 +7,20 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <solve.hpp>
+#include <sparse_blas.hpp>
+#include <sparse_handle.hpp>
 #include <af/array.h>
 #include <af/defines.h>
 #include <af/lapack.h>
 
 using af::dim4;
+using common::SparseArrayBase;
 using detail::Array;
 using detail::cdouble;
 using detail::cfloat;
@@ -28,14 +32,75 @@ static inline af_array solve(const af_array a, const af_array b,
     return getHandle(solve<T>(getArray<T>(a), getArray<T>(b), options));
 }
 
+template<typename T>
+static inline af_array sparseSolve(const af_array a, const af_array b,
+                                   const af_mat_prop options) {
+    return getHandle(
+        solve<T>(getSparseArray<T>(a), getArray<T>(b), options));
+}
+
+static af_err solveSparse(af_array* out, const af_array a, const af_array b,
+                          const af_mat_prop options) {
+    try {
+        const SparseArrayBase a_base = getSparseArrayBase(a);
+        const ArrayInfo& b_info      = getInfo(b);
+
+        af_dtype a_type = a_base.getType();
+        af_dtype b_type = b_info.getType();
+
+        dim4 adims = a_base.dims();
+        dim4 bdims = b_info.dims();
+
+        ARG_ASSERT(1, a_base.getStorage() == AF_STORAGE_CSR);
+        ARG_ASSERT(2, b_info.isFloating());  // Only floating and complex types
+        TYPE_ASSERT(a_type == b_type);
+
+        DIM_ASSERT(1, adims[0] == adims[1]);
+        DIM_ASSERT(1, bdims[0] == adims[0]);
+        DIM_ASSERT(2, bdims[2] == 1 && bdims[3] == 1);
+
+        const af_mat_prop triangle = static_cast<af_mat_prop>(
+            options & ~static_cast<int>(AF_MAT_DIAG_UNIT));
+        if (triangle != AF_MAT_LOWER && triangle != AF_MAT_UPPER) {
+            AF_ERROR("Sparse solve needs AF_MAT_LOWER or AF_MAT_UPPER",
+                     AF_ERR_NOT_SUPPORTED);
+        }
+
+        if (b_info.ndims() == 0) {
+            return af_create_handle(out, 0, nullptr, a_type);
+        }
+
+        af_array output;
+
+        switch (a_type) {
+            case f32: output = sparseSolve<float>(a, b, options); break;
+            case f64: output = sparseSolve<double>(a, b, options); break;
+            case c32: output = sparseSolve<cfloat>(a, b, options); break;
+            case c64: output = sparseSolve<cdouble>(a, b, options); break;
+            default: TYPE_ERROR(1, a_type);
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
 af_err af_solve(af_array* out, const af_array a, const af_array b,
                 const af_mat_prop options) {
+    AF_API_RANGE_ARRAY(a);
     try {
+        if (getInfo(a, false, true).isSparse()) {
+            return solveSparse(out, a, b, options);
+        }
+
         const ArrayInfo& a_info = getInfo(a);
         const ArrayInfo& b_info = getInfo(b);
 
-        if (a_info.ndims() > 2 || b_info.ndims() > 2) {
-            AF_ERROR("solve can not be used in batch mode", AF_ERR_BATCH);
+        if ((a_info.ndims() > 2 || b_info.ndims() > 2) &&
+            a_info.dims()[0] != a_info.dims()[1]) {
+            AF_ERROR("solve can only be batched for square matrices",
+                     AF_ERR_BATCH);
         }
 
         af_dtype a_type = a_info.getType();
@@ -98,13 +163,12 @@ static inline af_array solve_lu(const af_array a, const af_array pivot,
 
 af_err af_solve_lu(af_array* out, const af_array a, const af_array piv,
                    const af_array b, const af_mat_prop options) {
+    AF_API_RANGE_ARRAY(a);
     try {
         const ArrayInfo& a_info = getInfo(a);
         const ArrayInfo& b_info = getInfo(b);
 
-        if (a_info.ndims() > 2 || b_info.ndims() > 2) {
-            AF_ERROR("solveLU can not be used in batch mode", AF_ERR_BATCH);
-        }
+        const ArrayInfo& p_info = getInfo(piv);
 
         af_dtype a_type = a_info.getType();
         af_dtype b_type = b_info.getType();
@@ -124,6 +188,8 @@ af_err af_solve_lu(af_array* out, const af_array a, const af_array piv,
         DIM_ASSERT(1, bdims[0] == adims[0]);
         DIM_ASSERT(1, bdims[2] == adims[2]);
         DIM_ASSERT(1, bdims[3] == adims[3]);
+        DIM_ASSERT(2, p_info.dims()[2] == adims[2]);
+        DIM_ASSERT(2, p_info.dims()[3] == adims[3]);
 
         if (options != AF_MAT_NONE) {
             AF_ERROR("Using this property is not yet supported in solveLU",
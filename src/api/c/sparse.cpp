@@ -7,9 +7,13 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
+#include <common/sparse_blocked.hpp>
+#include <common/sparse_triangular.hpp>
+#include <common/sparse_update.hpp>
 #include <handle.hpp>
 #include <lookup.hpp>
 #include <platform.hpp>
@@ -20,7 +24,14 @@
 #include <af/sparse.h>
 
 using af::dim4;
+using common::blockedToCsr;
 using common::createEmptySparseArray;
+using common::csrInsert;
+using common::csrRemove;
+using common::csrToBsr;
+using common::csrToSell;
+using common::ic0;
+using common::ilu0;
 using common::SparseArray;
 using common::SparseArrayBase;
 using detail::Array;
@@ -64,6 +75,7 @@ af_err af_create_sparse_array(af_array *out, const dim_t nRows,
                               const dim_t nCols, const af_array values,
                               const af_array rowIdx, const af_array colIdx,
                               const af_storage stype) {
+    AF_API_RANGE_ARRAY(values);
     try {
         // Checks:
         // rowIdx and colIdx arrays are of s32 type
@@ -161,6 +173,7 @@ af_err af_create_sparse_array_from_ptr(
     af_array *out, const dim_t nRows, const dim_t nCols, const dim_t nNZ,
     const void *const values, const int *const rowIdx, const int *const colIdx,
     const af_dtype type, const af_storage stype, const af_source source) {
+    AF_API_RANGE();
     try {
         // Checks:
         // rowIdx and colIdx arrays are of s32 type
@@ -233,6 +246,7 @@ af_array createSparseArrayFromDense(const af_array _in,
 
 af_err af_create_sparse_array_from_dense(af_array *out, const af_array in,
                                          const af_storage stype) {
+    AF_API_RANGE_ARRAY(in);
     try {
         // Checks:
         // stype is within acceptable range
@@ -279,6 +293,26 @@ af_array sparseConvertStorage(const af_array in_,
                               const af_storage destStorage) {
     const SparseArray<T> in = getSparseArray<T>(in_);
 
+    // The blocked storage formats are converted through CSR
+    if (in.getStorage() == AF_STORAGE_BSR ||
+        in.getStorage() == AF_STORAGE_SELL) {
+        const SparseArray<T> csr = blockedToCsr(in);
+        switch (destStorage) {
+            case AF_STORAGE_DENSE:
+                return getHandle(
+                    detail::sparseConvertStorageToDense<T, AF_STORAGE_CSR>(
+                        csr));
+            case AF_STORAGE_CSR: return getHandle(csr);
+            case AF_STORAGE_COO:
+                return getHandle(
+                    detail::sparseConvertStorageToStorage<T, AF_STORAGE_COO,
+                                                          AF_STORAGE_CSR>(
+                        csr));
+            default:
+                AF_ERROR("Invalid storage type of output array", AF_ERR_ARG);
+        }
+    }
+
     if (destStorage == AF_STORAGE_DENSE) {
         // Returns a regular af_array, not sparse
         switch (in.getStorage()) {
@@ -321,6 +355,7 @@ af_array sparseConvertStorage(const af_array in_,
 
 af_err af_sparse_convert_to(af_array *out, const af_array in,
                             const af_storage destStorage) {
+    AF_API_RANGE_ARRAY(in);
     try {
         // Handle dense case
         const ArrayInfo &info = getInfo(in, false, true);
@@ -337,8 +372,11 @@ af_err af_sparse_convert_to(af_array *out, const af_array in,
         ARG_ASSERT(1, base.getStorage() != AF_STORAGE_DENSE &&
                           base.getStorage() != AF_STORAGE_CSC);
 
-        // Conversion to and from CSC is not supported
-        ARG_ASSERT(2, destStorage != AF_STORAGE_CSC);
+        // Conversion to and from CSC is not supported. The conversions to the
+        // blocked storage formats need the block size.
+        ARG_ASSERT(2, destStorage != AF_STORAGE_CSC &&
+                          destStorage != AF_STORAGE_BSR &&
+                          destStorage != AF_STORAGE_SELL);
 
         if (base.getStorage() == destStorage) {
             // Return a reference
@@ -367,7 +405,66 @@ af_err af_sparse_convert_to(af_array *out, const af_array in,
     return AF_SUCCESS;
 }
 
+template<typename T>
+af_array sparseConvertBlocked(const af_array in, const af_storage destStorage,
+                              const int blockSize, const int sortWindow) {
+    const SparseArray<T> csr = getSparseArray<T>(in);
+    if (destStorage == AF_STORAGE_BSR) {
+        return getHandle(csrToBsr(csr, blockSize));
+    }
+    return getHandle(csrToSell(csr, blockSize, sortWindow));
+}
+
+af_err af_sparse_convert_to_blocked(af_array *out, const af_array in,
+                                    const af_storage destStorage,
+                                    const int blockSize, const int sortWindow) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        ARG_ASSERT(2, destStorage == AF_STORAGE_BSR ||
+                          destStorage == AF_STORAGE_SELL);
+        ARG_ASSERT(3, blockSize > 0);
+        ARG_ASSERT(4, sortWindow > 0);
+
+        // The blocked storage formats are built from CSR
+        af_array csr = nullptr;
+        AF_CHECK(af_sparse_convert_to(&csr, in, AF_STORAGE_CSR));
+        const SparseArrayBase &base = getSparseArrayBase(csr);
+
+        af_array output = nullptr;
+        try {
+            switch (base.getType()) {
+                case f32:
+                    output = sparseConvertBlocked<float>(csr, destStorage,
+                                                         blockSize, sortWindow);
+                    break;
+                case f64:
+                    output = sparseConvertBlocked<double>(
+                        csr, destStorage, blockSize, sortWindow);
+                    break;
+                case c32:
+                    output = sparseConvertBlocked<cfloat>(
+                        csr, destStorage, blockSize, sortWindow);
+                    break;
+                case c64:
+                    output = sparseConvertBlocked<cdouble>(
+                        csr, destStorage, blockSize, sortWindow);
+                    break;
+                default:
+                    AF_ERROR("Output storage type is not valid", AF_ERR_ARG);
+            }
+        } catch (...) {
+            AF_CHECK(af_release_array(csr));
+            throw;
+        }
+        AF_CHECK(af_release_array(csr));
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
 af_err af_sparse_to_dense(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         af_array output = nullptr;
 
@@ -408,6 +505,7 @@ af_array getSparseValues(const af_array in) {
 
 af_err af_sparse_get_info(af_array *values, af_array *rows, af_array *cols,
                           af_storage *stype, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         if (values != NULL) { AF_CHECK(af_sparse_get_values(values, in)); }
         if (rows != NULL) { AF_CHECK(af_sparse_get_row_idx(rows, in)); }
@@ -420,6 +518,7 @@ af_err af_sparse_get_info(af_array *values, af_array *rows, af_array *cols,
 }
 
 af_err af_sparse_get_values(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const SparseArrayBase base = getSparseArrayBase(in);
 
@@ -439,6 +538,7 @@ af_err af_sparse_get_values(af_array *out, const af_array in) {
 }
 
 af_err af_sparse_get_row_idx(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const SparseArrayBase base = getSparseArrayBase(in);
         *out                       = getHandle(base.getRowIdx());
@@ -448,6 +548,7 @@ af_err af_sparse_get_row_idx(af_array *out, const af_array in) {
 }
 
 af_err af_sparse_get_col_idx(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const SparseArrayBase base = getSparseArrayBase(in);
         *out                       = getHandle(base.getColIdx());
@@ -457,6 +558,7 @@ af_err af_sparse_get_col_idx(af_array *out, const af_array in) {
 }
 
 af_err af_sparse_get_nnz(dim_t *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const SparseArrayBase base = getSparseArrayBase(in);
         *out                       = base.getNNZ();
@@ -466,6 +568,7 @@ af_err af_sparse_get_nnz(dim_t *out, const af_array in) {
 }
 
 af_err af_sparse_get_storage(af_storage *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const SparseArrayBase base = getSparseArrayBase(in);
         *out                       = base.getStorage();
@@ -473,3 +576,158 @@ af_err af_sparse_get_storage(af_storage *out, const af_array in) {
     CATCHALL;
     return AF_SUCCESS;
 }
+
+template<typename T>
+void sparseSetValues(af_array arr, const af_array values) {
+    getSparseArray<T>(arr).setValues(getArray<T>(values));
+}
+
+af_err af_sparse_set_values(af_array arr, const af_array values) {
+    AF_API_RANGE_ARRAY(arr);
+    try {
+        const SparseArrayBase &base = getSparseArrayBase(arr);
+        const ArrayInfo &vInfo      = getInfo(values);
+
+        TYPE_ASSERT(vInfo.getType() == base.getType());
+        DIM_ASSERT(1, vInfo.isLinear());
+        DIM_ASSERT(1, static_cast<dim_t>(vInfo.elements()) ==
+                          static_cast<dim_t>(base.getNNZ()));
+
+        switch (base.getType()) {
+            case f32: sparseSetValues<float>(arr, values); break;
+            case f64: sparseSetValues<double>(arr, values); break;
+            case c32: sparseSetValues<cfloat>(arr, values); break;
+            case c64: sparseSetValues<cdouble>(arr, values); break;
+            default: TYPE_ERROR(1, base.getType());
+        }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+template<typename T>
+void sparseInsert(af_array arr, const af_array values, const af_array rowIdx,
+                  const af_array colIdx) {
+    SparseArray<T> &sparse = getSparseArray<T>(arr);
+    sparse = csrInsert(sparse, getArray<T>(values), getArray<int>(rowIdx),
+                       getArray<int>(colIdx));
+}
+
+af_err af_sparse_insert(af_array arr, const af_array values,
+                        const af_array rowIdx, const af_array colIdx) {
+    AF_API_RANGE_ARRAY(arr);
+    try {
+        const SparseArrayBase &base = getSparseArrayBase(arr);
+        const ArrayInfo &vInfo      = getInfo(values);
+        const ArrayInfo &rInfo      = getInfo(rowIdx);
+        const ArrayInfo &cInfo      = getInfo(colIdx);
+
+        ARG_ASSERT(0, base.getStorage() == AF_STORAGE_CSR);
+        TYPE_ASSERT(vInfo.getType() == base.getType());
+        ARG_ASSERT(2, rInfo.getType() == s32);
+        ARG_ASSERT(3, cInfo.getType() == s32);
+        DIM_ASSERT(2, rInfo.elements() == vInfo.elements());
+        DIM_ASSERT(3, cInfo.elements() == vInfo.elements());
+
+        if (vInfo.elements() == 0) { return AF_SUCCESS; }
+
+        switch (base.getType()) {
+            case f32: sparseInsert<float>(arr, values, rowIdx, colIdx); break;
+            case f64: sparseInsert<double>(arr, values, rowIdx, colIdx); break;
+            case c32: sparseInsert<cfloat>(arr, values, rowIdx, colIdx); break;
+            case c64:
+                sparseInsert<cdouble>(arr, values, rowIdx, colIdx);
+                break;
+            default: TYPE_ERROR(1, base.getType());
+        }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+template<typename T>
+void sparseRemove(af_array arr, const af_array rowIdx, const af_array colIdx) {
+    SparseArray<T> &sparse = getSparseArray<T>(arr);
+    sparse = csrRemove(sparse, getArray<int>(rowIdx), getArray<int>(colIdx));
+}
+
+af_err af_sparse_remove(af_array arr, const af_array rowIdx,
+                        const af_array colIdx) {
+    AF_API_RANGE_ARRAY(arr);
+    try {
+        const SparseArrayBase &base = getSparseArrayBase(arr);
+        const ArrayInfo &rInfo      = getInfo(rowIdx);
+        const ArrayInfo &cInfo      = getInfo(colIdx);
+
+        ARG_ASSERT(0, base.getStorage() == AF_STORAGE_CSR);
+        ARG_ASSERT(1, rInfo.getType() == s32);
+        ARG_ASSERT(2, cInfo.getType() == s32);
+        DIM_ASSERT(2, cInfo.elements() == rInfo.elements());
+
+        if (rInfo.elements() == 0) { return AF_SUCCESS; }
+
+        switch (base.getType()) {
+            case f32: sparseRemove<float>(arr, rowIdx, colIdx); break;
+            case f64: sparseRemove<double>(arr, rowIdx, colIdx); break;
+            case c32: sparseRemove<cfloat>(arr, rowIdx, colIdx); break;
+            case c64: sparseRemove<cdouble>(arr, rowIdx, colIdx); break;
+            default: TYPE_ERROR(1, base.getType());
+        }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+template<typename T>
+af_array sparseILU0(const af_array in) {
+    return getHandle(ilu0(getSparseArray<T>(in)));
+}
+
+template<typename T>
+af_array sparseIC0(const af_array in) {
+    return getHandle(ic0(getSparseArray<T>(in)));
+}
+
+af_err af_sparse_ilu0(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const SparseArrayBase &base = getSparseArrayBase(in);
+
+        ARG_ASSERT(1, base.getStorage() == AF_STORAGE_CSR);
+        DIM_ASSERT(1, base.dims()[0] == base.dims()[1]);
+
+        af_array output = nullptr;
+        switch (base.getType()) {
+            case f32: output = sparseILU0<float>(in); break;
+            case f64: output = sparseILU0<double>(in); break;
+            case c32: output = sparseILU0<cfloat>(in); break;
+            case c64: output = sparseILU0<cdouble>(in); break;
+            default: TYPE_ERROR(1, base.getType());
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_sparse_ic0(af_array *out, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const SparseArrayBase &base = getSparseArrayBase(in);
+
+        ARG_ASSERT(1, base.getStorage() == AF_STORAGE_CSR);
+        DIM_ASSERT(1, base.dims()[0] == base.dims()[1]);
+
+        af_array output = nullptr;
+        switch (base.getType()) {
+            case f32: output = sparseIC0<float>(in); break;
+            case f64: output = sparseIC0<double>(in); break;
+            case c32: output = sparseIC0<cfloat>(in); break;
+            case c64: output = sparseIC0<cdouble>(in); break;
+            default: TYPE_ERROR(1, base.getType());
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
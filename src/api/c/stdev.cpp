@@ -7,95 +7,54 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
-#include <arith.hpp>
+#include <api_range.hpp>
 #include <backend.hpp>
-#include <cast.hpp>
+#include <common/err_common.hpp>
 #include <handle.hpp>
 #include <math.hpp>
-#include <mean.hpp>
-#include <reduce.hpp>
-#include <tile.hpp>
 #include <unary.hpp>
 #include <af/defines.h>
-#include <af/dim4.hpp>
 #include <af/statistics.h>
 #include <cmath>
 #include <complex>
 
-#include "stats.h"
-
-using af::dim4;
 using detail::Array;
-using detail::cast;
-using detail::cdouble;
-using detail::cfloat;
-using detail::createValueArray;
-using detail::division;
 using detail::intl;
-using detail::mean;
-using detail::reduce;
-using detail::reduce_all;
-using detail::scalar;
 using detail::uchar;
 using detail::uint;
 using detail::uintl;
 using detail::ushort;
 
+/// The standard deviation is the square root of the variance, which is
+/// computed in one pass
 template<typename inType, typename outType>
 static outType stdev(const af_array& in, const af_var_bias bias) {
-    using weightType        = typename baseOutType<outType>::type;
-    const Array<inType> _in = getArray<inType>(in);
-    Array<outType> input    = cast<outType>(_in);
-    Array<outType> meanCnst = createValueArray<outType>(
-        input.dims(), mean<inType, weightType, outType>(_in));
-    Array<outType> diff =
-        detail::arithOp<outType, af_sub_t>(input, meanCnst, input.dims());
-    Array<outType> diffSq =
-        detail::arithOp<outType, af_mul_t>(diff, diff, diff.dims());
-    outType result =
-        division(reduce_all<af_add_t, outType, outType>(diffSq),
-                 (input.elements() - (bias == AF_VARIANCE_SAMPLE)));
-    return sqrt(result);
+    double variance = 0;
+    double imag     = 0;
+    AF_CHECK(af_var_all_v2(&variance, &imag, in, bias));
+    return sqrt(static_cast<outType>(variance));
 }
 
 template<typename inType, typename outType>
 static af_array stdev(const af_array& in, int dim, const af_var_bias bias) {
-    using weightType        = typename baseOutType<outType>::type;
-    const Array<inType> _in = getArray<inType>(in);
-    Array<outType> input    = cast<outType>(_in);
-    dim4 iDims              = input.dims();
-
-    Array<outType> meanArr = mean<inType, weightType, outType>(_in, dim);
-
-    /* now tile meanArr along dim and use it for variance computation */
-    dim4 tileDims(1);
-    tileDims[dim]           = iDims[dim];
-    Array<outType> tMeanArr = detail::tile<outType>(meanArr, tileDims);
-    /* now mean array is ready */
+    af_array variance = 0;
+    AF_CHECK(af_var_v2(&variance, in, bias, dim));
+    const Array<outType> varArr = getArray<outType>(variance);
+    AF_CHECK(af_release_array(variance));
 
-    Array<outType> diff =
-        detail::arithOp<outType, af_sub_t>(input, tMeanArr, tMeanArr.dims());
-    Array<outType> diffSq =
-        detail::arithOp<outType, af_mul_t>(diff, diff, diff.dims());
-    Array<outType> redDiff = reduce<af_add_t, outType, outType>(diffSq, dim);
-    const dim4& oDims      = redDiff.dims();
-
-    Array<outType> divArr = createValueArray<outType>(
-        oDims, scalar<outType>((iDims[dim] - (bias == AF_VARIANCE_SAMPLE))));
-    Array<outType> varArr =
-        detail::arithOp<outType, af_div_t>(redDiff, divArr, redDiff.dims());
     Array<outType> result = detail::unaryOp<outType, af_sqrt_t>(varArr);
-
     return getHandle<outType>(result);
 }
 
 // NOLINTNEXTLINE(readability-non-const-parameter)
 af_err af_stdev_all(double* realVal, double* imagVal, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     return af_stdev_all_v2(realVal, imagVal, in, AF_VARIANCE_POPULATION);
 }
 
 af_err af_stdev_all_v2(double* realVal, double* imagVal, const af_array in,
                        const af_var_bias bias) {
+    AF_API_RANGE_ARRAY(in);
     UNUSED(imagVal);  // TODO implement for complex values
     try {
         const ArrayInfo& info = getInfo(in);
@@ -130,11 +89,13 @@ af_err af_stdev_all_v2(double* realVal, double* imagVal, const af_array in,
 }
 
 af_err af_stdev(af_array* out, const af_array in, const dim_t dim) {
+    AF_API_RANGE_ARRAY(in);
     return af_stdev_v2(out, in, AF_VARIANCE_POPULATION, dim);
 }
 
 af_err af_stdev_v2(af_array* out, const af_array in, const af_var_bias bias,
                    const dim_t dim) {
+    AF_API_RANGE_ARRAY(in);
     try {
         ARG_ASSERT(2, (dim >= 0 && dim <= 3));
 
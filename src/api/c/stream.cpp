@@ -7,38 +7,459 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <Event.hpp>
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/MappedFile.hpp>
+#include <common/dispatch.hpp>
 #include <common/err_common.hpp>
+#include <common/util.hpp>
+#include <compression.hpp>
+#include <copy.hpp>
 #include <handle.hpp>
+#include <indexing_common.hpp>
+#include <memory.hpp>
+#include <platform.hpp>
 #include <type_util.hpp>
 
 #include <af/array.h>
+#include <af/dim4.hpp>
+#include <af/event.h>
 #include <af/index.h>
-
+#include <af/util.h>
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iomanip>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+using common::convert2Canonical;
+using common::MappedFile;
+using std::lock_guard;
+using std::move;
+using std::mutex;
+using std::shared_ptr;
 using std::string;
+using std::unique_ptr;
+using std::unordered_map;
 using std::vector;
+using std::weak_ptr;
 
 using af::dim4;
+using detail::Array;
+using detail::block;
 using detail::cdouble;
 using detail::cfloat;
-using detail::createHostDataArray;
+using detail::copyArray;
+using detail::copyFromArrayAsync;
+using detail::createEmptyArray;
+using detail::createEvent;
+using detail::getActiveDeviceId;
 using detail::intl;
+using detail::markEventOnActiveQueue;
+using detail::pinnedAlloc;
+using detail::pinnedFree;
+using detail::setDevice;
 using detail::uchar;
 using detail::uint;
 using detail::uintl;
 using detail::ushort;
+using detail::writeHostDataArray;
 
 #define STREAM_FORMAT_VERSION 0x1
 static const char sfv_char = STREAM_FORMAT_VERSION;
 
-template<typename T>
-static int save(const char *key, const af_array arr, const char *filename,
-                const bool append = false) {
+#define CHUNKED_STREAM_FORMAT_VERSION 0x2
+static const char cfv_char = CHUNKED_STREAM_FORMAT_VERSION;
+
+namespace {
+
+/// A part of an array stored in a file
+struct StoredChunk {
+    af_compression_type compression;
+    size_t offset;  ///< The position of the chunk in the file
+    size_t bytes;   ///< The size of the chunk in the file
+};
+
+/// An array stored in a file written by af_save_array or
+/// af_save_array_chunked. The arrays written by af_save_array have a single
+/// uncompressed chunk.
+struct StoredArray {
+    string key;
+    af_dtype type;
+    dim4 dims;
+    size_t chunk_elements;  ///< The number of elements of each chunk
+    vector<StoredChunk> chunks;
+};
+
+/// A mapped file of arrays with the positions of the arrays and their keys
+struct ArrayFile {
+    shared_ptr<MappedFile> file;
+    char version  = 0;
+    int n_arrays  = 0;  ///< The number of arrays in the header of the file
+    size_t footer = 0;  ///< The position of the footer of a chunked file
+    vector<StoredArray> arrays;
+    unordered_map<string, unsigned> keys;  ///< The first array of each key
+};
+
+// The files written by af_save_array_chunked have the layout
+//
+// (char     )   Version (Once)
+// (char     )   Reserved (x 7, Once)
+// (char     )   Chunks of the arrays
+// (int      )   No. of Arrays (Footer)
+//     (int    )   Length of the key
+//     (cstring)   Key
+//     (char   )   Type
+//     (intl   )   dim4 (x 4)
+//     (intl   )   Elements of each chunk
+//     (int    )   No. of chunks
+//         (char   )   Compression
+//         (intl   )   Position of the chunk
+//         (intl   )   Bytes of the chunk
+// (char     )   Padding
+// (intl     )   Position of the footer (Trailer)
+// (intl     )   Bytes of the footer
+// (uintl    )   Hash of the footer
+// (char     )   CHUNKED_MAGIC
+//
+// The chunks split the array along its last dimension with more than one
+// element, so each chunk holds a range of whole slices of that dimension.
+// Appending to a file writes the new chunks over the old footer and writes
+// a new footer.
+
+constexpr size_t CHUNKED_HEADER_BYTES = 8;
+constexpr char CHUNKED_MAGIC[8] = {'A', 'F', 'C', 'H', 'U', 'N', 'K', 'S'};
+constexpr size_t CHUNKED_TRAILER_BYTES =
+    2 * sizeof(intl) + sizeof(uintl) + sizeof(CHUNKED_MAGIC);
+
+/// The size of the chunks before compression if none is given
+constexpr size_t DEFAULT_CHUNK_BYTES = 4 << 20;
+
+/// The number of mapped files kept open by openArrayFile
+constexpr size_t MAX_OPEN_ARRAY_FILES = 16;
+
+/// The size of the pinned buffer used to copy arrays to the device
+constexpr size_t STAGING_BYTES = 64 << 20;
+
+/// The mapped files of this process
+struct ArrayFiles {
+    mutex files_mutex;
+    /// The indexes of the most recently used files first
+    std::list<shared_ptr<const ArrayFile>> recent;
+    /// The mappings which may still be used by arrays
+    vector<weak_ptr<MappedFile>> mapped;
+};
+
+ArrayFiles &getArrayFiles() {
+    static auto *files = new ArrayFiles();
+    return *files;
+}
+
+/// Builds the index of a file written by af_save_array. Arrays are only
+/// indexed up to the first array which does not fit in the file.
+void indexArrayFileV1(ArrayFile &out) {
+    const char *data  = out.file->data();
+    const size_t size = out.file->size();
+
+    size_t pos = sizeof(char);
+    auto read  = [&](void *dst, size_t bytes) {
+        if (bytes > size - pos) { return false; }
+        memcpy(dst, data + pos, bytes);
+        pos += bytes;
+        return true;
+    };
+    if (!read(&out.n_arrays, sizeof(int))) { return; }
+
+    for (int i = 0; i < out.n_arrays; i++) {
+        // (int    )   Length of the key
+        // (cstring)   Key
+        // (intl   )   Offset bytes to next array (type + dims + data)
+        // (char   )   Type
+        // (intl   )   dim4 (x 4)
+        // (T      )   data (x elements)
+        int klen = -1;
+        if (!read(&klen, sizeof(int)) || klen < 0 ||
+            static_cast<size_t>(klen) > size - pos) {
+            break;
+        }
+        StoredArray stored;
+        stored.key = string(data + pos, klen);
+        pos += klen;
+
+        intl offset = -1;
+        char type   = -1;
+        intl dims[4];
+        if (!read(&offset, sizeof(intl))) { break; }
+        const size_t next = pos + offset;
+        if (offset < 0 || static_cast<size_t>(offset) > size - pos ||
+            !read(&type, sizeof(char)) || !read(&dims, sizeof(dims))) {
+            break;
+        }
+
+        stored.type           = static_cast<af_dtype>(type);
+        stored.dims           = dim4(dims[0], dims[1], dims[2], dims[3]);
+        stored.chunk_elements = stored.dims.elements();
+        stored.chunks.push_back(
+            {AF_COMPRESSION_NONE, pos,
+             stored.dims.elements() * size_of(stored.type)});
+        out.keys.emplace(stored.key, out.arrays.size());
+        out.arrays.push_back(move(stored));
+        pos = next;
+    }
+}
+
+/// Builds the index of a file written by af_save_array_chunked from its
+/// footer
+void indexArrayFileV2(ArrayFile &out) {
+    const char *data  = out.file->data();
+    const size_t size = out.file->size();
+    const string invalid =
+        out.file->path() + " does not have a valid index of its arrays";
+    if (size < CHUNKED_HEADER_BYTES + CHUNKED_TRAILER_BYTES) {
+        AF_ERROR(invalid.c_str(), AF_ERR_ARG);
+    }
+
+    intl footer = 0, footer_bytes = 0;
+    uintl hash  = 0;
+    const char *trailer = data + size - CHUNKED_TRAILER_BYTES;
+    memcpy(&footer, trailer, sizeof(intl));
+    memcpy(&footer_bytes, trailer + sizeof(intl), sizeof(intl));
+    memcpy(&hash, trailer + 2 * sizeof(intl), sizeof(uintl));
+    const size_t end = size - CHUNKED_TRAILER_BYTES;
+    if (memcmp(trailer + 2 * sizeof(intl) + sizeof(uintl), CHUNKED_MAGIC,
+               sizeof(CHUNKED_MAGIC)) != 0 ||
+        footer < static_cast<intl>(CHUNKED_HEADER_BYTES) ||
+        static_cast<size_t>(footer) > end || footer_bytes < 0 ||
+        static_cast<size_t>(footer_bytes) > end - footer ||
+        hash != deterministicHash(data + footer, footer_bytes)) {
+        AF_ERROR(invalid.c_str(), AF_ERR_ARG);
+    }
+
+    size_t pos        = footer;
+    const size_t last = footer + footer_bytes;
+    auto read         = [&](void *dst, size_t bytes) {
+        if (bytes > last - pos) { AF_ERROR(invalid.c_str(), AF_ERR_ARG); }
+        memcpy(dst, data + pos, bytes);
+        pos += bytes;
+    };
+
+    int n_arrays = 0;
+    read(&n_arrays, sizeof(int));
+    for (int i = 0; i < n_arrays; i++) {
+        int klen = -1;
+        read(&klen, sizeof(int));
+        if (klen < 0 || static_cast<size_t>(klen) > last - pos) {
+            AF_ERROR(invalid.c_str(), AF_ERR_ARG);
+        }
+        StoredArray stored;
+        stored.key = string(data + pos, klen);
+        pos += klen;
+
+        char type = -1;
+        intl dims[4], chunk_elements = 0;
+        int n_chunks = 0;
+        read(&type, sizeof(char));
+        read(&dims, sizeof(dims));
+        read(&chunk_elements, sizeof(intl));
+        read(&n_chunks, sizeof(int));
+        stored.type = static_cast<af_dtype>(type);
+        stored.dims = dim4(dims[0], dims[1], dims[2], dims[3]);
+        if (*std::min_element(dims, dims + 4) < 0) {
+            AF_ERROR(invalid.c_str(), AF_ERR_ARG);
+        }
+
+        const size_t elements = stored.dims.elements();
+        const size_t tsize    = size_of(stored.type);
+        if (tsize == 0 || chunk_elements <= 0 || n_chunks < 0 ||
+            static_cast<size_t>(n_chunks) !=
+                divup(elements, static_cast<size_t>(chunk_elements))) {
+            AF_ERROR(invalid.c_str(), AF_ERR_ARG);
+        }
+        stored.chunk_elements = chunk_elements;
+
+        for (int c = 0; c < n_chunks; c++) {
+            char compression = -1;
+            intl offset = -1, bytes = -1;
+            read(&compression, sizeof(char));
+            read(&offset, sizeof(intl));
+            read(&bytes, sizeof(intl));
+
+            const size_t raw =
+                std::min(stored.chunk_elements,
+                         elements - c * stored.chunk_elements) *
+                tsize;
+            if (compression < AF_COMPRESSION_NONE ||
+                compression > AF_COMPRESSION_ZSTD ||
+                offset < static_cast<intl>(CHUNKED_HEADER_BYTES) ||
+                offset > footer || bytes < 0 || bytes > footer - offset ||
+                (compression == AF_COMPRESSION_NONE &&
+                 static_cast<size_t>(bytes) != raw)) {
+                AF_ERROR(invalid.c_str(), AF_ERR_ARG);
+            }
+            stored.chunks.push_back(
+                {static_cast<af_compression_type>(compression),
+                 static_cast<size_t>(offset), static_cast<size_t>(bytes)});
+        }
+        out.keys.emplace(stored.key, out.arrays.size());
+        out.arrays.push_back(move(stored));
+    }
+    out.n_arrays = n_arrays;
+    out.footer   = footer;
+}
+
+/// Maps a file written by af_save_array or af_save_array_chunked and builds
+/// the index of its keys
+shared_ptr<const ArrayFile> indexArrayFile(const string &filename) {
+    auto out  = std::make_shared<ArrayFile>();
+    out->file = std::make_shared<MappedFile>(filename);
+
+    if (out->file->size() == 0) {
+        string errStr = filename + " is empty";
+        AF_ERROR(errStr.c_str(), AF_ERR_ARG);
+    }
+    out->version = out->file->data()[0];
+    switch (out->version) {
+        case STREAM_FORMAT_VERSION: indexArrayFileV1(*out); break;
+        case CHUNKED_STREAM_FORMAT_VERSION: indexArrayFileV2(*out); break;
+        default: AF_ERROR("Invalid version", AF_ERR_ARG);
+    }
+    return out;
+}
+
+/// Returns the index of \p filename. The indexes of the most recently used
+/// files are kept until the files change.
+shared_ptr<const ArrayFile> openArrayFile(const string &filename) {
+    ArrayFiles &files = getArrayFiles();
+    lock_guard<mutex> lock(files.files_mutex);
+    auto &recent = files.recent;
+    for (auto iter = recent.begin(); iter != recent.end(); ++iter) {
+        if ((*iter)->file->path() != filename) { continue; }
+        if ((*iter)->file->isCurrent()) {
+            recent.splice(recent.begin(), recent, iter);
+            return recent.front();
+        }
+        recent.erase(iter);
+        break;
+    }
+    recent.push_front(indexArrayFile(filename));
+    if (recent.size() > MAX_OPEN_ARRAY_FILES) { recent.pop_back(); }
+    auto &mapped = files.mapped;
+    mapped.erase(std::remove_if(mapped.begin(), mapped.end(),
+                                [](const weak_ptr<MappedFile> &file) {
+                                    return file.expired();
+                                }),
+                 mapped.end());
+    mapped.push_back(recent.front()->file);
+    return recent.front();
+}
+
+/// Drops the index of \p filename before it is written to
+///
+/// \returns true if arrays still use a mapping of the file. The file must
+///          not be truncated in that case.
+bool closeArrayFile(const string &filename) {
+    ArrayFiles &files = getArrayFiles();
+    lock_guard<mutex> lock(files.files_mutex);
+    files.recent.remove_if([&](const shared_ptr<const ArrayFile> &file) {
+        return file->file->path() == filename;
+    });
+
+    bool mapped = false;
+    auto &live  = files.mapped;
+    live.erase(std::remove_if(live.begin(), live.end(),
+                              [&](const weak_ptr<MappedFile> &file) {
+                                  auto ptr = file.lock();
+                                  if (ptr && ptr->path() == filename) {
+                                      mapped = true;
+                                  }
+                                  return !ptr;
+                              }),
+               live.end());
+    return mapped;
+}
+
+/// The alignment of the data of the arrays appended to a file, so that
+/// reads can use the mapped data directly
+constexpr size_t ARRAY_DATA_ALIGNMENT = 64;
+
+/// Returns the padding after the last array of \p filename which aligns the
+/// data of a new array with a key of \p klen bytes appended to the file. The
+/// padding is part of the last array, so its offset to the next array has to
+/// be increased by the padding. Readers skip the padding with that offset.
+///
+/// \param[out] field  The position of the offset of the last array
+/// \param[out] offset The value of the offset of the last array
+///
+/// \returns zero if the file has no arrays or is not well formed
+size_t getAppendPadding(const string &filename, const int klen, size_t &field,
+                        intl &offset) {
+    auto file = indexArrayFile(filename);
+    if (file->version != sfv_char || file->arrays.empty() ||
+        file->arrays.size() != static_cast<size_t>(file->n_arrays)) {
+        return 0;
+    }
+
+    // The offset is followed by the type and the dims of the array
+    field = file->arrays.back().chunks[0].offset - 4 * sizeof(intl) -
+            sizeof(char) - sizeof(intl);
+    memcpy(&offset, file->file->data() + field, sizeof(intl));
+    const size_t end = file->file->size();
+    if (field + sizeof(intl) + offset != end) { return 0; }
+
+    const size_t data = end + sizeof(int) + klen + sizeof(intl) +
+                        sizeof(char) + 4 * sizeof(intl);
+    return (ARRAY_DATA_ALIGNMENT - data % ARRAY_DATA_ALIGNMENT) %
+           ARRAY_DATA_ALIGNMENT;
+}
+
+/// Returns the path to write a file which is overwritten to. Arrays which
+/// use the mapped pages of the file would lose their data if it was
+/// truncated, so a \p mapped file is replaced by a temporary file instead.
+/// This keeps the old file alive until the arrays are released.
+string getWritePath(const string &filename, const bool mapped) {
+    if (!mapped) { return filename; }
+    const size_t sep = filename.find_last_of("/\\");
+    const string dir =
+        sep == string::npos ? string() : filename.substr(0, sep + 1);
+    return dir + makeTempFilename();
+}
+
+/// Moves the file written to \p writePath to \p filename
+void replaceFile(const string &writePath, const string &filename) {
+    if (writePath != filename && !renameFile(writePath, filename)) {
+        // The destination has to be removed first on some platforms
+        removeFile(filename);
+        if (!renameFile(writePath, filename)) {
+            removeFile(writePath);
+            AF_ERROR("File failed to open", AF_ERR_ARG);
+        }
+    }
+}
+
+/// Writes an array of \p type and \p dims to \p filename in the format of
+/// af_save_array. The \p bytes of its data are written by \p writeData to
+/// the stream, which is at the end of the header of the array.
+///
+/// \returns the index of the array in the file
+int writeArrayToFile(const string &key, const char type, const dim4 &dims,
+                     const size_t bytes, const char *filename,
+                     const bool append,
+                     const std::function<void(std::fstream &)> &writeData) {
     // (char     )   Version (Once)
     // (int      )   No. of Arrays (Once)
     // (int    )   Length of the key
@@ -49,22 +470,18 @@ static int save(const char *key, const af_array arr, const char *filename,
     // (T      )   data (x elements)
     // Setup all the data structures that need to be written to file
     ///////////////////////////////////////////////////////////////////////////
-    std::string k(key);
-    int klen = k.size();
-
-    const ArrayInfo &info = getInfo(arr);
-    std::vector<T> data(info.elements());
-
-    AF_CHECK(af_get_data_ptr(&data.front(), arr));
-
-    char type = info.getType();
+    int klen = key.size();
 
     intl odims[4];
-    for (int i = 0; i < 4; i++) { odims[i] = info.dims()[i]; }
+    for (int i = 0; i < 4; i++) { odims[i] = dims[i]; }
 
-    intl offset = sizeof(char) + 4 * sizeof(intl) + info.elements() * sizeof(T);
+    intl offset = sizeof(char) + 4 * sizeof(intl) + bytes;
     ///////////////////////////////////////////////////////////////////////////
 
+    // The index of the file is rebuilt by the next read
+    const bool mapped = closeArrayFile(filename);
+    string writePath(filename);
+
     std::fstream fs;
     int n_arrays = 0;
 
@@ -95,9 +512,24 @@ static int save(const char *key, const af_array arr, const char *filename,
                 "ArrayFire data format has changed. Can't append to file");
 
             fs.read(reinterpret_cast<char *>(&n_arrays), sizeof(int));
+
+            size_t field = 0;
+            intl offset  = 0;
+            const size_t padding =
+                n_arrays > 0 ? getAppendPadding(filename, klen, field, offset)
+                             : 0;
+            if (padding) {
+                offset += padding;
+                fs.seekp(field);
+                fs.write(reinterpret_cast<char *>(&offset), sizeof(intl));
+                const vector<char> zeros(padding, 0);
+                fs.seekp(0, std::ios_base::end);
+                fs.write(zeros.data(), padding);
+            }
         }
     } else {
-        fs.open(filename,
+        writePath = getWritePath(filename, mapped);
+        fs.open(writePath,
                 std::fstream::out | std::fstream::binary | std::fstream::trunc);
 
         // Throw exception if file is not open
@@ -114,18 +546,38 @@ static int save(const char *key, const af_array arr, const char *filename,
     // Write array to end of file. Irrespective of new or append
     fs.seekp(0, std::ios_base::end);
     fs.write(reinterpret_cast<char *>(&klen), sizeof(int));
-    fs.write(k.c_str(), klen);
+    fs.write(key.c_str(), klen);
     fs.write(reinterpret_cast<char *>(&offset), sizeof(intl));
     fs.write(&type, sizeof(char));
     fs.write(reinterpret_cast<char *>(&odims), sizeof(intl) * 4);
-    fs.write(reinterpret_cast<char *>(&data.front()), sizeof(T) * data.size());
+    writeData(fs);
     fs.close();
+    replaceFile(writePath, filename);
 
     return n_arrays - 1;
 }
 
+}  // namespace
+
+template<typename T>
+static int save(const char *key, const af_array arr, const char *filename,
+                const bool append = false) {
+    const ArrayInfo &info = getInfo(arr);
+    std::vector<T> data(info.elements());
+
+    AF_CHECK(af_get_data_ptr(&data.front(), arr));
+
+    return writeArrayToFile(
+        key, info.getType(), info.dims(), data.size() * sizeof(T), filename,
+        append, [&](std::fstream &fs) {
+            fs.write(reinterpret_cast<char *>(&data.front()),
+                     sizeof(T) * data.size());
+        });
+}
+
 af_err af_save_array(int *index, const char *key, const af_array arr,
                      const char *filename, const bool append) {
+    AF_API_RANGE_ARRAY(arr);
     try {
         ARG_ASSERT(0, key != NULL);
         ARG_ASSERT(2, filename != NULL);
@@ -154,180 +606,594 @@ af_err af_save_array(int *index, const char *key, const af_array arr,
     return AF_SUCCESS;
 }
 
-template<typename T>
-static af_array readDataToArray(std::fstream &fs) {
-    intl dims[4];
-    fs.read(reinterpret_cast<char *>(&dims), 4 * sizeof(intl));
+namespace {
+
+/// The size of the pinned buffers which stage the arrays saved by
+/// af_save_array_async
+constexpr size_t SAVE_CHUNK_BYTES = 16 << 20;
+
+/// The thread which writes the arrays saved by af_save_array_async. The
+/// arrays are written one at a time in the order they were saved, so the
+/// arrays appended to a file by consecutive saves keep their order.
+class SaveQueue {
+    mutex m_mutex;
+    std::condition_variable m_ready;
+    std::deque<std::function<void()>> m_tasks;
+    unique_ptr<std::thread> m_worker;
+
+    void work() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<mutex> lock(m_mutex);
+                m_ready.wait(lock, [this] { return !m_tasks.empty(); });
+                task = move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
 
-    dim4 d;
-    for (int i = 0; i < 4; i++) { d[i] = dims[i]; }
+   public:
+    void push(std::function<void()> task) {
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_tasks.push_back(move(task));
+            if (!m_worker) {
+                m_worker.reset(new std::thread(&SaveQueue::work, this));
+                m_worker->detach();
+            }
+        }
+        m_ready.notify_one();
+    }
+};
 
-    intl size = d.elements();
+SaveQueue &getSaveQueue() {
+    // The worker waits for saves until the process exits, so the queue is
+    // never destroyed
+    static auto *queue = new SaveQueue();
+    return *queue;
+}
 
-    std::vector<T> data(size);
-    fs.read(reinterpret_cast<char *>(&data.front()), size * sizeof(T));
+/// An array being saved by af_save_array_async
+struct SaveTask {
+    std::future<int> index;
+};
+
+/// A pinned buffer which stages a chunk of an array saved by
+/// af_save_array_async
+struct SaveBuffer {
+    unique_ptr<char, void (*)(char *)> data;
+    unique_ptr<void, af_err (*)(af_event)> event;
+
+    explicit SaveBuffer(const size_t bytes)
+        : data(pinnedAlloc<char>(bytes), pinnedFree<char>)
+        , event(createEvent(), af_delete_event) {}
+};
+
+/// Writes the data of \p in to \p fs. The device copies the next chunk of
+/// the array to one pinned buffer while the previous chunk is written from
+/// the other one.
+template<typename T>
+void writeStaged(std::fstream &fs, const Array<T> &in) {
+    const size_t bytes = in.elements() * sizeof(T);
+    if (bytes == 0) { return; }
+
+    const size_t chunk_bytes =
+        std::min(bytes, SAVE_CHUNK_BYTES / sizeof(T) * sizeof(T));
+    SaveBuffer buffers[2] = {SaveBuffer(chunk_bytes), SaveBuffer(chunk_bytes)};
+
+    SaveBuffer *pending   = nullptr;
+    size_t pending_length = 0;
+    int next              = 0;
+    for (size_t offset = 0; offset < bytes; offset += chunk_bytes) {
+        SaveBuffer &buffer  = buffers[next];
+        const size_t length = std::min(chunk_bytes, bytes - offset);
+
+        copyFromArrayAsync(reinterpret_cast<T *>(buffer.data.get()), in,
+                           length, offset);
+        markEventOnActiveQueue(buffer.event.get());
+        if (pending) {
+            block(pending->event.get());
+            fs.write(pending->data.get(), pending_length);
+        }
+        pending        = &buffer;
+        pending_length = length;
+        next           = 1 - next;
+    }
+    block(pending->event.get());
+    fs.write(pending->data.get(), pending_length);
+}
 
-    return getHandle(createHostDataArray<T>(d, &data.front()));
+/// Takes a snapshot of \p arr and queues it to be written to \p filename.
+/// The snapshot shares the memory of the array, which is copied if the
+/// array is written to before the save is done.
+template<typename T>
+std::future<int> saveAsync(const char *key, const af_array arr,
+                           const char *filename, const bool append) {
+    // The array is evaluated before the snapshot shares its memory, so it
+    // is not evaluated again by its next use
+    getArray<T>(arr).eval();
+    Array<T> in = getArray<T>(arr);
+    if (!in.isLinear()) { in = copyArray(in); }
+
+    const int device = getActiveDeviceId();
+    auto task        = std::make_shared<std::packaged_task<int()>>(
+        [in, device, key = string(key), filename = string(filename),
+         append]() {
+            setDevice(device);
+            return writeArrayToFile(
+                key, in.getType(), in.dims(), in.elements() * sizeof(T),
+                filename.c_str(), append,
+                [&](std::fstream &fs) { writeStaged(fs, in); });
+        });
+    std::future<int> out = task->get_future();
+    getSaveQueue().push([task] { (*task)(); });
+    return out;
 }
 
-static af_array readArrayV1(const char *filename, const unsigned index) {
-    char version = 0;
-    int n_arrays = 0;
+}  // namespace
 
-    std::fstream fs(filename, std::fstream::in | std::fstream::binary);
+#define SAVE_ASYNC(T) saveAsync<T>(key, arr, filename, append)
 
-    // Throw exception if file is not open
-    if (!fs.is_open()) { AF_ERROR("File failed to open", AF_ERR_ARG); }
+af_err af_save_array_async(af_save_handle *handle, const char *key,
+                           const af_array arr, const char *filename,
+                           const bool append) {
+    AF_API_RANGE_ARRAY(arr);
+    try {
+        ARG_ASSERT(0, handle != NULL);
+        ARG_ASSERT(1, key != NULL);
+        ARG_ASSERT(3, filename != NULL);
 
-    if (fs.peek() == std::fstream::traits_type::eof()) {
-        AF_ERROR("File is empty", AF_ERR_ARG);
+        unique_ptr<SaveTask> out(new SaveTask());
+        const af_dtype type = getInfo(arr).getType();
+        switch (type) {
+            case f32: out->index = SAVE_ASYNC(float); break;
+            case c32: out->index = SAVE_ASYNC(cfloat); break;
+            case f64: out->index = SAVE_ASYNC(double); break;
+            case c64: out->index = SAVE_ASYNC(cdouble); break;
+            case b8: out->index = SAVE_ASYNC(char); break;
+            case s32: out->index = SAVE_ASYNC(int); break;
+            case u32: out->index = SAVE_ASYNC(unsigned); break;
+            case u8: out->index = SAVE_ASYNC(uchar); break;
+            case s64: out->index = SAVE_ASYNC(intl); break;
+            case u64: out->index = SAVE_ASYNC(uintl); break;
+            case s16: out->index = SAVE_ASYNC(short); break;
+            case u16: out->index = SAVE_ASYNC(ushort); break;
+            default: TYPE_ERROR(2, type);
+        }
+        *handle = out.release();
     }
+    CATCHALL;
+    return AF_SUCCESS;
+}
 
-    fs.read(&version, sizeof(char));
-    fs.read(reinterpret_cast<char *>(&n_arrays), sizeof(int));
+#undef SAVE_ASYNC
 
-    AF_ASSERT((int)index < n_arrays, "Index out of bounds");
+af_err af_wait_save(int *index, const af_save_handle handle) {
+    AF_API_RANGE();
+    try {
+        ARG_ASSERT(1, handle != NULL);
+        std::future<int> &result = static_cast<SaveTask *>(handle)->index;
+        ARG_ASSERT(1, result.valid());
 
-    for (unsigned i = 0; i < index; i++) {
-        // (int    )   Length of the key
-        // (cstring)   Key
-        // (intl   )   Offset bytes to next array (type + dims + data)
-        // (char   )   Type
-        // (intl   )   dim4 (x 4)
-        // (T      )   data (x elements)
-        int klen = -1;
-        fs.read(reinterpret_cast<char *>(&klen), sizeof(int));
+        // The error of a failed save is thrown by get
+        const int id = result.get();
+        if (index) { *index = id; }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
 
-        // char* key = new char[klen];
-        // fs.read((char*)&key, klen * sizeof(char));
+af_err af_release_save(af_save_handle handle) {
+    AF_API_RANGE();
+    try {
+        auto *task = static_cast<SaveTask *>(handle);
+        // The file is complete once the handle is released
+        if (task && task->index.valid()) { task->index.wait(); }
+        delete task;
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
 
-        // Skip the array name tag
-        fs.seekg(klen, std::ios_base::cur);
+namespace {
 
-        // Read data offset
-        intl offset = -1;
-        fs.read(reinterpret_cast<char *>(&offset), sizeof(intl));
+/// Appends the bytes of \p value to \p out
+template<typename T>
+void appendBytes(string &out, const T &value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
 
-        // Skip data
-        fs.seekg(offset, std::ios_base::cur);
+/// Returns the footer of a chunked file which holds \p arrays
+string makeFooter(const vector<StoredArray> &arrays) {
+    string out;
+    appendBytes(out, static_cast<int>(arrays.size()));
+    for (const StoredArray &stored : arrays) {
+        appendBytes(out, static_cast<int>(stored.key.size()));
+        out.append(stored.key);
+        appendBytes(out, static_cast<char>(stored.type));
+        for (int i = 0; i < 4; i++) {
+            appendBytes(out, static_cast<intl>(stored.dims[i]));
+        }
+        appendBytes(out, static_cast<intl>(stored.chunk_elements));
+        appendBytes(out, static_cast<int>(stored.chunks.size()));
+        for (const StoredChunk &chunk : stored.chunks) {
+            appendBytes(out, static_cast<char>(chunk.compression));
+            appendBytes(out, static_cast<intl>(chunk.offset));
+            appendBytes(out, static_cast<intl>(chunk.bytes));
+        }
     }
+    return out;
+}
 
-    int klen = -1;
-    fs.read(reinterpret_cast<char *>(&klen), sizeof(int));
+/// Returns the number of elements of each chunk of an array of \p dims. The
+/// chunks hold whole slices of the last dimension with more than one
+/// element, unless a single slice is larger than \p chunk_bytes.
+size_t getChunkElements(const dim4 &dims, const size_t type_bytes,
+                        const size_t chunk_bytes) {
+    size_t slice = 1;
+    for (int i = dims.ndims() - 2; i >= 0; i--) { slice *= dims[i]; }
+    if (slice == 0) { return 1; }
+    const size_t slices =
+        std::max<size_t>(chunk_bytes / (slice * type_bytes), 1);
+    return std::max<size_t>(std::min<size_t>(slices * slice, dims.elements()),
+                            1);
+}
 
-    // char* key = new char[klen];
-    // fs.read((char*)&key, klen * sizeof(char));
+}  // namespace
 
-    // Skip the array name tag
-    fs.seekg(klen, std::ios_base::cur);
+template<typename T>
+static int saveChunked(const char *key, const af_array arr,
+                       const char *filename, const bool append,
+                       const af_compression_type compression,
+                       const size_t chunk_bytes) {
+    const ArrayInfo &info = getInfo(arr);
+    std::vector<T> data(info.elements());
+    if (!data.empty()) { AF_CHECK(af_get_data_ptr(&data.front(), arr)); }
+
+    StoredArray stored;
+    stored.key  = key;
+    stored.type = info.getType();
+    stored.dims = info.dims();
+    stored.chunk_elements =
+        getChunkElements(stored.dims, sizeof(T), chunk_bytes);
+
+    // The compression library is loaded before the file is changed
+    const size_t elements = data.size();
+    vector<char> buffer;
+    if (compression != AF_COMPRESSION_NONE && elements) {
+        buffer.resize(compressChunkBound(
+            compression, stored.chunk_elements * sizeof(T)));
+    }
 
-    // Read data offset
-    intl offset = -1;
-    fs.read(reinterpret_cast<char *>(&offset), sizeof(intl));
+    // The index of the file is rebuilt by the next read
+    const bool mapped = closeArrayFile(filename);
+    string writePath(filename);
 
-    // Read type and dims
-    char type_ = -1;
-    fs.read(&type_, sizeof(char));
+    vector<StoredArray> arrays;
+    size_t pos      = CHUNKED_HEADER_BYTES;
+    size_t old_size = 0;
 
-    auto type = static_cast<af_dtype>(type_);
+    if (append) {
+        std::ifstream checkIfExists(filename, std::ios::binary);
+        const bool exists = checkIfExists.good() &&
+                            checkIfExists.peek() !=
+                                std::ifstream::traits_type::eof();
+        checkIfExists.close();
+        if (exists) {
+            auto file = indexArrayFile(filename);
+            AF_ASSERT(file->version == cfv_char,
+                      "Chunked arrays can only be appended to files written "
+                      "by af_save_array_chunked");
+            arrays   = file->arrays;
+            pos      = file->footer;
+            old_size = file->file->size();
+        }
+    }
+
+    std::fstream fs;
+    if (old_size) {
+        fs.open(filename,
+                std::fstream::in | std::fstream::out | std::fstream::binary);
+    } else {
+        writePath = getWritePath(filename, mapped);
+        fs.open(writePath,
+                std::fstream::out | std::fstream::binary | std::fstream::trunc);
+    }
+    if (!fs.is_open()) { AF_ERROR("File failed to open", AF_ERR_ARG); }
+
+    if (!old_size) {
+        char header[CHUNKED_HEADER_BYTES] = {cfv_char};
+        fs.write(header, sizeof(header));
+    }
 
-    af_array out;
-    switch (type) {
-        case f32: out = readDataToArray<float>(fs); break;
-        case c32: out = readDataToArray<cfloat>(fs); break;
-        case f64: out = readDataToArray<double>(fs); break;
-        case c64: out = readDataToArray<cdouble>(fs); break;
-        case b8: out = readDataToArray<char>(fs); break;
-        case s32: out = readDataToArray<int>(fs); break;
-        case u32: out = readDataToArray<uint>(fs); break;
-        case u8: out = readDataToArray<uchar>(fs); break;
-        case s64: out = readDataToArray<intl>(fs); break;
-        case u64: out = readDataToArray<uintl>(fs); break;
-        case s16: out = readDataToArray<short>(fs); break;
-        case u16: out = readDataToArray<ushort>(fs); break;
-        default: TYPE_ERROR(1, type);
+    // The chunks of each array are aligned so that the uncompressed chunks
+    // can be used directly from the mapped file
+    fs.seekp(pos);
+    const size_t padding =
+        (ARRAY_DATA_ALIGNMENT - pos % ARRAY_DATA_ALIGNMENT) %
+        ARRAY_DATA_ALIGNMENT;
+    const vector<char> zeros(ARRAY_DATA_ALIGNMENT, 0);
+    fs.write(zeros.data(), padding);
+    pos += padding;
+
+    for (size_t begin = 0; begin < elements; begin += stored.chunk_elements) {
+        const char *src   = reinterpret_cast<const char *>(&data[begin]);
+        const size_t size =
+            std::min(stored.chunk_elements, elements - begin) * sizeof(T);
+
+        StoredChunk chunk{AF_COMPRESSION_NONE, pos, size};
+        if (compression != AF_COMPRESSION_NONE) {
+            const size_t bytes = compressChunk(
+                compression, buffer.data(), buffer.size(), src, size);
+            // Chunks which do not get smaller are stored uncompressed
+            if (bytes < size) {
+                chunk.compression = compression;
+                chunk.bytes       = bytes;
+                src               = buffer.data();
+            }
+        }
+        fs.write(src, chunk.bytes);
+        pos += chunk.bytes;
+        stored.chunks.push_back(chunk);
     }
+    arrays.push_back(move(stored));
+
+    const string footer = makeFooter(arrays);
+    fs.write(footer.data(), footer.size());
+
+    // The trailer has to be at the end of the file, which can not be
+    // truncated, so a file which was appended to does not get smaller
+    const size_t end = pos + footer.size();
+    for (size_t i = end + CHUNKED_TRAILER_BYTES; i < old_size;
+         i += zeros.size()) {
+        fs.write(zeros.data(), std::min(zeros.size(), old_size - i));
+    }
+
+    const intl footer_pos   = pos;
+    const intl footer_bytes = footer.size();
+    const uintl hash        = deterministicHash(footer.data(), footer.size());
+    fs.write(reinterpret_cast<const char *>(&footer_pos), sizeof(intl));
+    fs.write(reinterpret_cast<const char *>(&footer_bytes), sizeof(intl));
+    fs.write(reinterpret_cast<const char *>(&hash), sizeof(uintl));
+    fs.write(CHUNKED_MAGIC, sizeof(CHUNKED_MAGIC));
     fs.close();
+    if (fs.fail()) { AF_ERROR("Failed to write the file", AF_ERR_ARG); }
+    replaceFile(writePath, filename);
 
-    return out;
+    return static_cast<int>(arrays.size()) - 1;
 }
 
-static af_array checkVersionAndRead(const char *filename,
-                                    const unsigned index) {
-    char version = 0;
+#define SAVE_CHUNKED(T) \
+    saveChunked<T>(key, arr, filename, append, compression, bytes)
 
-    std::string filenameStr = std::string(filename);
-    std::fstream fs(filenameStr, std::fstream::in | std::fstream::binary);
-    // Throw exception if file is not open
-    if (!fs.is_open()) {
-        std::string errStr = "Failed to open: " + filenameStr;
-        AF_ERROR(errStr.c_str(), AF_ERR_ARG);
+af_err af_save_array_chunked(int *index, const char *key, const af_array arr,
+                             const char *filename, const bool append,
+                             const af_compression_type compression,
+                             const dim_t chunk_bytes) {
+    AF_API_RANGE_ARRAY(arr);
+    try {
+        ARG_ASSERT(1, key != NULL);
+        ARG_ASSERT(3, filename != NULL);
+        ARG_ASSERT(5, compression == AF_COMPRESSION_NONE ||
+                          compression == AF_COMPRESSION_LZ4 ||
+                          compression == AF_COMPRESSION_ZSTD);
+        ARG_ASSERT(6, chunk_bytes >= 0);
+
+        const size_t bytes = chunk_bytes ? chunk_bytes : DEFAULT_CHUNK_BYTES;
+        const ArrayInfo &info = getInfo(arr);
+        af_dtype type         = info.getType();
+        int id                = -1;
+        switch (type) {
+            case f32: id = SAVE_CHUNKED(float); break;
+            case c32: id = SAVE_CHUNKED(cfloat); break;
+            case f64: id = SAVE_CHUNKED(double); break;
+            case c64: id = SAVE_CHUNKED(cdouble); break;
+            case b8: id = SAVE_CHUNKED(char); break;
+            case s32: id = SAVE_CHUNKED(int); break;
+            case u32: id = SAVE_CHUNKED(unsigned); break;
+            case u8: id = SAVE_CHUNKED(uchar); break;
+            case s64: id = SAVE_CHUNKED(intl); break;
+            case u64: id = SAVE_CHUNKED(uintl); break;
+            case s16: id = SAVE_CHUNKED(short); break;
+            case u16: id = SAVE_CHUNKED(ushort); break;
+            default: TYPE_ERROR(2, type);
+        }
+        std::swap(*index, id);
     }
+    CATCHALL;
+    return AF_SUCCESS;
+}
 
-    if (fs.peek() == std::fstream::traits_type::eof()) {
-        std::string errStr = filenameStr + " is empty";
-        AF_ERROR(errStr.c_str(), AF_ERR_ARG);
-    } else {
-        fs.read(&version, sizeof(char));
+#undef SAVE_CHUNKED
+
+namespace {
+
+/// Reads \p dims.elements() elements of \p stored starting at the element
+/// \p begin to an array of \p dims. Only the chunks which hold the elements
+/// are read.
+template<typename T>
+af_array readDataToArray(const shared_ptr<const ArrayFile> &file,
+                         const StoredArray &stored, const dim4 &dims,
+                         const size_t begin) {
+    const char *data      = file->file->data();
+    const size_t elements = dims.elements();
+    if (elements == 0) { return getHandle(createEmptyArray<T>(dims)); }
+
+    const size_t per_chunk = stored.chunk_elements;
+    const size_t first     = begin / per_chunk;
+    const size_t last      = (begin + elements - 1) / per_chunk;
+    bool compressed        = false;
+    bool contiguous        = true;
+    for (size_t c = first; c <= last; c++) {
+        const StoredChunk &chunk = stored.chunks[c];
+        if (chunk.bytes > file->file->size() - chunk.offset) {
+            AF_ERROR("Array data is truncated", AF_ERR_ARG);
+        }
+        compressed |= chunk.compression != AF_COMPRESSION_NONE;
+        if (c > first) {
+            const StoredChunk &prev = stored.chunks[c - 1];
+            contiguous &= chunk.offset == prev.offset + prev.bytes;
+        }
     }
-    fs.close();
 
-    switch (version) {  // NOLINT(hicpp-multiway-paths-covered)
-        case 1: return readArrayV1(filename, index);
-        default: AF_ERROR("Invalid version", AF_ERR_ARG);
+#if defined(AF_CPU)
+    using detail::createSharedDataArray;
+    // The array uses the mapped pages directly if the data is uncompressed
+    // and aligned. The pages are copy on write so the array can be modified.
+    const char *src = data + stored.chunks[first].offset +
+                      (begin - first * per_chunk) * sizeof(T);
+    if (!compressed && contiguous &&
+        reinterpret_cast<uintptr_t>(src) % alignof(T) == 0) {
+        shared_ptr<T> ptr(file->file,
+                          reinterpret_cast<T *>(const_cast<char *>(src)));
+        return getHandle(createSharedDataArray<T>(dims, move(ptr)));
+    }
+    const size_t staging_elements = compressed ? per_chunk : 0;
+#else
+    // The data is copied to the device through a pinned buffer so the
+    // transfers do not need another copy by the driver
+    const size_t staging_elements =
+        std::max(compressed ? per_chunk : 0,
+                 std::min(elements, STAGING_BYTES / sizeof(T)));
+#endif
+    // Compressed chunks are decompressed to the staging buffer as a whole
+    unique_ptr<T, void (*)(T *)> staging(
+        staging_elements ? pinnedAlloc<T>(staging_elements) : nullptr,
+        pinnedFree<T>);
+
+    Array<T> out   = createEmptyArray<T>(dims);
+    size_t written = 0;
+    for (size_t c = first; c <= last; c++) {
+        const StoredChunk &chunk = stored.chunks[c];
+        const size_t chunk_begin = c * per_chunk;
+        const size_t chunk_size =
+            std::min(per_chunk, static_cast<size_t>(stored.dims.elements()) -
+                                    chunk_begin);
+        const size_t lo = std::max(begin, chunk_begin) - chunk_begin;
+        const size_t hi =
+            std::min(begin + elements, chunk_begin + chunk_size) - chunk_begin;
+        const size_t bytes = (hi - lo) * sizeof(T);
+
+        if (chunk.compression != AF_COMPRESSION_NONE) {
+            decompressChunk(chunk.compression,
+                            reinterpret_cast<char *>(staging.get()),
+                            chunk_size * sizeof(T), data + chunk.offset,
+                            chunk.bytes);
+            writeHostDataArray<T>(out, staging.get() + lo, bytes, written);
+            written += bytes;
+            continue;
+        }
+
+        const char *src = data + chunk.offset + lo * sizeof(T);
+#if defined(AF_CPU)
+        writeHostDataArray<T>(out, reinterpret_cast<const T *>(src), bytes,
+                              written);
+        written += bytes;
+#else
+        const size_t piece = staging_elements * sizeof(T);
+        for (size_t offset = 0; offset < bytes; offset += piece) {
+            const size_t len = std::min(piece, bytes - offset);
+            memcpy(staging.get(), src + offset, len);
+            writeHostDataArray<T>(out, staging.get(), len, written);
+            written += len;
+        }
+#endif
     }
+    return getHandle(out);
 }
 
-int checkVersionAndFindIndex(const char *filename, const char *k) {
-    char version = 0;
-    std::string key(k);
-    std::string filenameStr(filename);
-    std::ifstream fs(filenameStr, std::ifstream::in | std::ifstream::binary);
-
-    // Throw exception if file is not open
-    if (!fs.is_open()) {
-        std::string errStr = "Failed to open: " + filenameStr;
-        AF_ERROR(errStr.c_str(), AF_ERR_ARG);
+af_array readStoredArray(const shared_ptr<const ArrayFile> &file,
+                         const StoredArray &stored, const dim4 &dims,
+                         const size_t begin) {
+    switch (stored.type) {
+        case f32: return readDataToArray<float>(file, stored, dims, begin);
+        case c32: return readDataToArray<cfloat>(file, stored, dims, begin);
+        case f64: return readDataToArray<double>(file, stored, dims, begin);
+        case c64: return readDataToArray<cdouble>(file, stored, dims, begin);
+        case b8: return readDataToArray<char>(file, stored, dims, begin);
+        case s32: return readDataToArray<int>(file, stored, dims, begin);
+        case u32: return readDataToArray<uint>(file, stored, dims, begin);
+        case u8: return readDataToArray<uchar>(file, stored, dims, begin);
+        case s64: return readDataToArray<intl>(file, stored, dims, begin);
+        case u64: return readDataToArray<uintl>(file, stored, dims, begin);
+        case s16: return readDataToArray<short>(file, stored, dims, begin);
+        case u16: return readDataToArray<ushort>(file, stored, dims, begin);
+        default: TYPE_ERROR(1, stored.type);
     }
+}
 
-    if (fs.peek() == std::ifstream::traits_type::eof()) {
-        std::string errStr = filenameStr + " is empty";
-        AF_ERROR(errStr.c_str(), AF_ERR_ARG);
-    } else {
-        fs.read(&version, sizeof(char));
-    }
-
-    int index = -1;
-    if (version == 1) {
-        int n_arrays = -1;
-        fs.read(reinterpret_cast<char *>(&n_arrays), sizeof(int));
-        for (int i = 0; i < n_arrays; i++) {
-            int klen = -1;
-            fs.read(reinterpret_cast<char *>(&klen), sizeof(int));
-            string readKey;
-            readKey.resize(klen);
-            fs.read(&readKey.front(), klen);
-
-            if (key == readKey) {
-                // Ket matches, break
-                index = i;
-                break;
-            }
-            // Key doesn't match. Skip the data
-            intl offset = -1;
-            fs.read(reinterpret_cast<char *>(&offset), sizeof(intl));
-            fs.seekg(offset, std::ios_base::cur);
+const StoredArray &getStoredArray(const shared_ptr<const ArrayFile> &file,
+                                  const unsigned index) {
+    AF_ASSERT((int)index < file->n_arrays, "Index out of bounds");
+    if (index >= file->arrays.size()) {
+        AF_ERROR("Array is truncated", AF_ERR_ARG);
+    }
+    return file->arrays[index];
+}
+
+af_array readArray(const shared_ptr<const ArrayFile> &file,
+                   const unsigned index) {
+    const StoredArray &stored = getStoredArray(file, index);
+    return readStoredArray(file, stored, stored.dims, 0);
+}
+
+/// Reads the part of an array selected by \p indices. The range of the
+/// elements which are selected is read first, which only reads the chunks
+/// of the range, and is then indexed.
+af_array readArrayRange(const shared_ptr<const ArrayFile> &file,
+                        const unsigned index, const unsigned ndims,
+                        const af_seq *const indices) {
+    const StoredArray &stored = getStoredArray(file, index);
+
+    // A single sequence indexes the elements of the array in order.
+    // Otherwise the range is read along the last dimension with more than
+    // one element, which is the dimension the array is chunked along.
+    dim4 dims       = ndims == 1 ? dim4(stored.dims.elements()) : stored.dims;
+    const int dim   = std::max<int>(dims.ndims(), 1) - 1;
+    const dim_t len = dims[dim];
+    size_t slice    = 1;
+    for (int i = 0; i < dim; i++) { slice *= dims[i]; }
+
+    vector<af_seq> seqs(indices, indices + ndims);
+    size_t begin = 0;
+    if (static_cast<unsigned>(dim) < ndims && !af::isSpan(seqs[dim])) {
+        const af_seq seq = convert2Canonical(seqs[dim], len);
+        const double lo  = std::floor(std::min(seq.begin, seq.end));
+        const double hi  = std::floor(std::max(seq.begin, seq.end));
+        if (lo < 0 || hi >= len) {
+            AF_ERROR("Range is out of bounds", AF_ERR_ARG);
         }
-    } else {
-        AF_ERROR("Invalid version", AF_ERR_ARG);
+        seqs[dim] = af_seq{seq.begin - lo, seq.end - lo, seq.step};
+        dims[dim] = static_cast<dim_t>(hi - lo) + 1;
+        begin     = static_cast<size_t>(lo) * slice;
     }
-    fs.close();
 
-    return index;
+    af_array range = readStoredArray(file, stored, dims, begin);
+    af_array out   = 0;
+    af_err err     = af_index(&out, range, ndims, seqs.data());
+    AF_CHECK(af_release_array(range));
+    AF_CHECK(err);
+    return out;
+}
+
+}  // namespace
+
+static af_array checkVersionAndRead(const char *filename,
+                                    const unsigned index) {
+    return readArray(openArrayFile(filename), index);
+}
+
+int checkVersionAndFindIndex(const char *filename, const char *k) {
+    auto file = openArrayFile(filename);
+    auto iter = file->keys.find(k);
+    return iter == file->keys.end() ? -1 : static_cast<int>(iter->second);
 }
 
 af_err af_read_array_index(af_array *out, const char *filename,
                            const unsigned index) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
 
@@ -341,6 +1207,7 @@ af_err af_read_array_index(af_array *out, const char *filename,
 }
 
 af_err af_read_array_key(af_array *out, const char *filename, const char *key) {
+    AF_API_RANGE();
     try {
         AF_CHECK(af_init());
         ARG_ASSERT(1, filename != NULL);
@@ -360,6 +1227,7 @@ af_err af_read_array_key(af_array *out, const char *filename, const char *key) {
 
 af_err af_read_array_key_check(int *index, const char *filename,
                                const char *key) {
+    AF_API_RANGE();
     try {
         ARG_ASSERT(1, filename != NULL);
         ARG_ASSERT(2, key != NULL);
@@ -373,3 +1241,21 @@ af_err af_read_array_key_check(int *index, const char *filename,
     CATCHALL;
     return AF_SUCCESS;
 }
+
+af_err af_read_array_range(af_array *out, const char *filename,
+                           const unsigned index, const unsigned ndims,
+                           const af_seq *const indices) {
+    AF_API_RANGE();
+    try {
+        AF_CHECK(af_init());
+        ARG_ASSERT(1, filename != NULL);
+        ARG_ASSERT(3, ndims > 0 && ndims <= AF_MAX_DIMS);
+        ARG_ASSERT(4, indices != NULL);
+
+        af_array output =
+            readArrayRange(openArrayFile(filename), index, ndims, indices);
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
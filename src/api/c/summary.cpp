@@ -0,0 +1,62 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <api_range.hpp>
+#include <backend.hpp>
+#include <common/err_common.hpp>
+#include <common/summary.hpp>
+#include <handle.hpp>
+#include <summary.hpp>
+#include <af/algorithm.h>
+#include <af/defines.h>
+
+using common::Summary;
+using detail::intl;
+using detail::summary_all;
+using detail::uchar;
+using detail::uint;
+using detail::uintl;
+using detail::ushort;
+
+template<typename T>
+static Summary summary(const af_array in) {
+    return summary_all<T>(getArray<T>(in));
+}
+
+af_err af_summary_all(double *min, double *max, double *sum, double *sumsq,
+                      double *count, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const ArrayInfo &info = getInfo(in);
+        af_dtype type         = info.getType();
+
+        Summary out{};
+        switch (type) {
+            case f32: out = summary<float>(in); break;
+            case f64: out = summary<double>(in); break;
+            case s32: out = summary<int>(in); break;
+            case u32: out = summary<uint>(in); break;
+            case s64: out = summary<intl>(in); break;
+            case u64: out = summary<uintl>(in); break;
+            case s16: out = summary<short>(in); break;
+            case u16: out = summary<ushort>(in); break;
+            case b8: out = summary<char>(in); break;
+            case u8: out = summary<uchar>(in); break;
+            default: TYPE_ERROR(5, type);
+        }
+
+        if (min) { *min = out.min; }
+        if (max) { *max = out.max; }
+        if (sum) { *sum = out.sum; }
+        if (sumsq) { *sumsq = out.sumsq; }
+        if (count) { *count = out.count; }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
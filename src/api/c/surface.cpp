@@ -10,16 +10,14 @@
 #include <af/graphics.h>
 #include <af/image.h>
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
 #include <common/graphics_common.hpp>
 #include <handle.hpp>
-#include <join.hpp>
 #include <reduce.hpp>
-#include <reorder.hpp>
 #include <surface.hpp>
-#include <tile.hpp>
 
 using af::dim4;
 using detail::Array;
@@ -36,41 +34,11 @@ fg_chart setup_surface(fg_window window, const af_array xVals,
                        const af_array yVals, const af_array zVals,
                        const af_cell* const props) {
     ForgeModule& _ = graphics::forgePlugin();
-    Array<T> xIn   = getArray<T>(xVals);
-    Array<T> yIn   = getArray<T>(yVals);
-    Array<T> zIn   = getArray<T>(zVals);
-
-    const ArrayInfo& Xinfo = getInfo(xVals);
-    const ArrayInfo& Yinfo = getInfo(yVals);
-    const ArrayInfo& Zinfo = getInfo(zVals);
-
-    dim4 X_dims = Xinfo.dims();
-    dim4 Y_dims = Yinfo.dims();
-    dim4 Z_dims = Zinfo.dims();
-
-    if (Xinfo.isVector()) {
-        // Convert xIn is a column vector
-        xIn = modDims(xIn, xIn.elements());
-        // Now tile along second dimension
-        dim4 x_tdims(1, Y_dims[0], 1, 1);
-        xIn = tile(xIn, x_tdims);
-
-        // Convert yIn to a row vector
-        yIn = modDims(yIn, dim4(1, yIn.elements()));
-        // Now tile along first dimension
-        dim4 y_tdims(X_dims[0], 1, 1, 1);
-        yIn = tile(yIn, y_tdims);
-    }
-
-    // Flatten xIn, yIn and zIn into row vectors
-    dim4 rowDims = dim4(1, zIn.elements());
-    xIn          = modDims(xIn, rowDims);
-    yIn          = modDims(yIn, rowDims);
-    zIn          = modDims(zIn, rowDims);
+    const Array<T> xIn = getArray<T>(xVals);
+    const Array<T> yIn = getArray<T>(yVals);
+    const Array<T> zIn = getArray<T>(zVals);
 
-    // Now join along first dimension, skip reorder
-    std::vector<Array<T>> inputs{xIn, yIn, zIn};
-    Array<T> Z = join(0, inputs);
+    const dim4 Z_dims = zIn.dims();
 
     ForgeManager& fgMngr = forgeManager();
 
@@ -122,7 +90,9 @@ fg_chart setup_surface(fg_window window, const af_array xVals,
         FG_CHECK(_.fg_set_chart_axes_limits(chart, cmin[0], cmax[0], cmin[1],
                                             cmax[1], cmin[2], cmax[2]));
     }
-    copy_surface<T>(Z, surface);
+    // The backends repeat vectors of x and y coordinates along the grid
+    // while they write the vertices into the buffer of the surface
+    copy_surface<T>(xIn, yIn, zIn, surface);
 
     return chart;
 }
@@ -130,6 +100,7 @@ fg_chart setup_surface(fg_window window, const af_array xVals,
 af_err af_draw_surface(const af_window window, const af_array xVals,
                        const af_array yVals, const af_array S,
                        const af_cell* const props) {
+    AF_API_RANGE_ARRAY(xVals);
     try {
         if (window == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
 
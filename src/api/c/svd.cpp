@@ -12,11 +12,20 @@
 #include <af/lapack.h>
 
 #include <Array.hpp>
+#include <api_range.hpp>
 #include <backend.hpp>
+#include <blas.hpp>
 #include <common/err_common.hpp>
+#include <copy.hpp>
 #include <handle.hpp>
+#include <math.hpp>
 #include <svd.hpp>
 #include <af/defines.h>
+#include <af/random.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
 
 using af::dim4;
 using af::dtype_traits;
@@ -24,7 +33,13 @@ using detail::Array;
 using detail::cdouble;
 using detail::cfloat;
 using detail::createEmptyArray;
+using detail::createHostDataArray;
+using detail::createSubArray;
+using detail::scalar;
+using detail::svdBatched;
 using std::min;
+using std::numeric_limits;
+using std::vector;
 
 template<typename T>
 static inline void svd(af_array *s, af_array *u, af_array *vt,
@@ -36,12 +51,16 @@ static inline void svd(af_array *s, af_array *u, af_array *vt,
 
     using Tr = typename dtype_traits<T>::base_type;
 
-    // Allocate output arrays
-    Array<Tr> sA = createEmptyArray<Tr>(dim4(min(M, N)));
-    Array<T> uA  = createEmptyArray<T>(dim4(M, M));
-    Array<T> vtA = createEmptyArray<T>(dim4(N, N));
+    // Allocate output arrays, with a matrix for each matrix of a batch
+    Array<Tr> sA = createEmptyArray<Tr>(dim4(min(M, N), 1, dims[2], dims[3]));
+    Array<T> uA  = createEmptyArray<T>(dim4(M, M, dims[2], dims[3]));
+    Array<T> vtA = createEmptyArray<T>(dim4(N, N, dims[2], dims[3]));
 
-    svd<T, Tr>(sA, uA, vtA, getArray<T>(in));
+    if (dims[2] * dims[3] == 1) {
+        svd<T, Tr>(sA, uA, vtA, getArray<T>(in));
+    } else {
+        svdBatched<T, Tr>(sA, uA, vtA, getArray<T>(in));
+    }
 
     *s  = getHandle(sA);
     *u  = getHandle(uA);
@@ -70,12 +89,101 @@ static inline void svdInPlace(af_array *s, af_array *u, af_array *vt,
     *vt = getHandle(vtA);
 }
 
+/// Returns an orthonormal basis of the columns of \p y. It is computed from
+/// the eigenvectors of the small Gram matrix y^H y, twice, to restore the
+/// orthogonality lost to the squared condition number of the Gram matrix.
+/// The directions in which \p y is rank deficient are zero columns.
+template<typename T>
+static Array<T> orthonormalBasis(Array<T> y) {
+    using Tr      = typename dtype_traits<T>::base_type;
+    const dim_t L = y.dims()[1];
+
+    for (int pass = 0; pass < 2; ++pass) {
+        Array<T> gram = matmul(y, y, AF_MAT_CTRANS, AF_MAT_NONE);
+        Array<Tr> s   = createEmptyArray<Tr>(dim4(L));
+        Array<T> v    = createEmptyArray<T>(dim4(L, L));
+        Array<T> vt   = createEmptyArray<T>(dim4(L, L));
+        svd<T, Tr>(s, v, vt, gram);
+
+        // The eigenvectors are scaled by the inverse square roots of the
+        // eigenvalues, on the host as there are only L of them
+        vector<Tr> eig(L);
+        copyData(eig.data(), s);
+        const Tr tol = eig[0] * L * numeric_limits<Tr>::epsilon();
+
+        vector<T> scale(L * L, scalar<T>(0));
+        for (dim_t i = 0; i < L; ++i) {
+            if (eig[i] > tol) {
+                scale[i * L + i] = scalar<T>(1.0 / std::sqrt(eig[i]));
+            }
+        }
+        Array<T> w = matmul(v, createHostDataArray<T>(dim4(L, L), scale.data()),
+                            AF_MAT_NONE, AF_MAT_NONE);
+        y          = matmul(y, w, AF_MAT_NONE, AF_MAT_NONE);
+    }
+    return y;
+}
+
+template<typename T>
+static inline void svdRandomized(af_array *s, af_array *u, af_array *vt,
+                                 const af_array in, const unsigned rank,
+                                 const unsigned oversampling,
+                                 const unsigned iterations) {
+    using Tr = typename dtype_traits<T>::base_type;
+
+    const Array<T> A = getArray<T>(in);
+    const dim_t M    = A.dims()[0];
+    const dim_t N    = A.dims()[1];
+    const dim_t K    = min<dim_t>(rank, min(M, N));
+    const dim_t L    = min<dim_t>(K + oversampling, min(M, N));
+
+    // The range of A is sampled with a Gaussian random matrix
+    af_array gaussian   = 0;
+    const dim_t gDims[] = {N, L};
+    AF_CHECK(af_randn(&gaussian, 2, gDims, getInfo(in).getType()));
+    const Array<T> omega = getArray<T>(gaussian);
+    AF_CHECK(af_release_array(gaussian));
+
+    // The subspace iterations sharpen the basis q of the sampled range
+    // towards the dominant singular vectors
+    Array<T> q =
+        orthonormalBasis(matmul(A, omega, AF_MAT_NONE, AF_MAT_NONE));
+    for (unsigned i = 0; i < iterations; ++i) {
+        Array<T> z = orthonormalBasis(matmul(A, q, AF_MAT_CTRANS, AF_MAT_NONE));
+        q          = orthonormalBasis(matmul(A, z, AF_MAT_NONE, AF_MAT_NONE));
+    }
+
+    // A is approximated by q q^H A, whose rows are spanned by the basis p of
+    // the columns of A^H q. The SVD of the small L x L matrix q^H A p gives
+    // its SVD, without the N x N V^H of the SVD of q^H A.
+    Array<T> p = orthonormalBasis(matmul(A, q, AF_MAT_CTRANS, AF_MAT_NONE));
+    Array<T> c = matmul(q, matmul(A, p, AF_MAT_NONE, AF_MAT_NONE),
+                        AF_MAT_CTRANS, AF_MAT_NONE);
+
+    Array<Tr> sC = createEmptyArray<Tr>(dim4(L));
+    Array<T> uC  = createEmptyArray<T>(dim4(L, L));
+    Array<T> vtC = createEmptyArray<T>(dim4(L, L));
+    svd<T, Tr>(sC, uC, vtC, c);
+
+    const af_seq first = {0., static_cast<double>(K - 1), 1.};
+    Array<Tr> sA = createSubArray(sC, {first});
+    Array<T> uA  = matmul(q, createSubArray(uC, {af_span, first}),
+                          AF_MAT_NONE, AF_MAT_NONE);
+    Array<T> vtA = matmul(createSubArray(vtC, {first, af_span}), p,
+                          AF_MAT_NONE, AF_MAT_CTRANS);
+
+    *s  = getHandle(sA);
+    *u  = getHandle(uA);
+    *vt = getHandle(vtA);
+}
+
 af_err af_svd(af_array *u, af_array *s, af_array *vt, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in);
         dim4 dims             = info.dims();
 
-        ARG_ASSERT(3, (dims.ndims() >= 0 && dims.ndims() <= 2));
+        // The matrices of a batch are along the third and fourth dimensions
         af_dtype type = info.getType();
 
         if (dims.ndims() == 0) {
@@ -98,6 +206,7 @@ af_err af_svd(af_array *u, af_array *s, af_array *vt, const af_array in) {
 }
 
 af_err af_svd_inplace(af_array *u, af_array *s, af_array *vt, af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in);
         dim4 dims             = info.dims();
@@ -125,3 +234,47 @@ af_err af_svd_inplace(af_array *u, af_array *s, af_array *vt, af_array in) {
     CATCHALL;
     return AF_SUCCESS;
 }
+
+af_err af_svd_randomized(af_array *u, af_array *s, af_array *vt,
+                         const af_array in, const unsigned rank,
+                         const unsigned oversampling,
+                         const unsigned iterations) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const ArrayInfo &info = getInfo(in);
+        dim4 dims             = info.dims();
+
+        ARG_ASSERT(3, (dims.ndims() >= 0 && dims.ndims() <= 2));
+        ARG_ASSERT(4, rank > 0);
+        af_dtype type = info.getType();
+
+        if (dims.ndims() == 0) {
+            AF_CHECK(af_create_handle(u, 0, nullptr, type));
+            AF_CHECK(af_create_handle(s, 0, nullptr, type));
+            AF_CHECK(af_create_handle(vt, 0, nullptr, type));
+            return AF_SUCCESS;
+        }
+
+        switch (type) {
+            case f64:
+                svdRandomized<double>(s, u, vt, in, rank, oversampling,
+                                      iterations);
+                break;
+            case f32:
+                svdRandomized<float>(s, u, vt, in, rank, oversampling,
+                                     iterations);
+                break;
+            case c64:
+                svdRandomized<cdouble>(s, u, vt, in, rank, oversampling,
+                                       iterations);
+                break;
+            case c32:
+                svdRandomized<cfloat>(s, u, vt, in, rank, oversampling,
+                                      iterations);
+                break;
+            default: TYPE_ERROR(1, type);
+        }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
@@ -0,0 +1,679 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <api_range.hpp>
+#include <backend.hpp>
+#include <common/MappedFile.hpp>
+#include <common/err_common.hpp>
+#include <memory.hpp>
+
+#include <af/array.h>
+#include <af/device.h>
+#include <af/sparse.h>
+#include <af/util.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <climits>
+#include <complex>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using common::MappedFile;
+using detail::intl;
+using detail::pinnedAlloc;
+using detail::pinnedFree;
+using detail::uchar;
+using detail::uint;
+using detail::uintl;
+using detail::ushort;
+using std::atomic;
+using std::complex;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace {
+
+/// The smallest part of a file which is parsed by its own thread
+constexpr size_t MIN_PARSE_BYTES = 1 << 20;
+
+/// A pinned host buffer, which the arrays are created from so the copy to
+/// the device does not need another copy by the driver
+using pinned_ptr = unique_ptr<char, void (*)(char *)>;
+
+pinned_ptr allocPinned(const size_t bytes) {
+    return pinned_ptr(pinnedAlloc<char>(std::max<size_t>(bytes, 1)),
+                      pinnedFree<char>);
+}
+
+/// Returns the number of threads which parse \p bytes of text
+unsigned getParseThreads(const size_t bytes) {
+    const size_t parts = std::max<size_t>(1, bytes / MIN_PARSE_BYTES);
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    return static_cast<unsigned>(std::min(parts, cores));
+}
+
+/// Calls \p func with the ids [0, \p n) on \p n threads. The calling thread
+/// runs the first id. The first error of the threads is rethrown.
+template<typename Func>
+void runThreads(const unsigned n, Func &&func) {
+    vector<std::exception_ptr> errors(n);
+    auto run = [&](const unsigned t) {
+        try {
+            func(t);
+        } catch (...) { errors[t] = std::current_exception(); }
+    };
+    vector<std::thread> workers;
+    for (unsigned t = 1; t < n; ++t) { workers.emplace_back(run, t); }
+    run(0);
+    for (auto &worker : workers) { worker.join(); }
+    for (auto &error : errors) {
+        if (error) { std::rethrow_exception(error); }
+    }
+}
+
+bool isBlank(const char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+const char *skipBlanks(const char *p, const char *end) {
+    while (p < end && isBlank(*p)) { ++p; }
+    return p;
+}
+
+/// Returns the end of the line which starts at \p p, without the newline
+const char *getLineEnd(const char *p, const char *end) {
+    const void *nl = memchr(p, '\n', end - p);
+    return nl ? static_cast<const char *>(nl) : end;
+}
+
+/// Returns the start of the line after the line which starts at \p p
+const char *getNextLine(const char *p, const char *end) {
+    const char *stop = getLineEnd(p, end);
+    return stop < end ? stop + 1 : end;
+}
+
+/// Splits [\p begin, \p end) into \p n parts which start at the beginning
+/// of a line. Part t is [bounds[t], bounds[t + 1]).
+vector<const char *> splitLines(const char *begin, const char *end,
+                                const unsigned n) {
+    vector<const char *> bounds(n + 1, end);
+    bounds[0]          = begin;
+    const size_t bytes = end - begin;
+    for (unsigned t = 1; t < n; ++t) {
+        const char *p = std::max(begin + bytes * t / n, bounds[t - 1]);
+        bounds[t]     = p == begin ? begin : getNextLine(p - 1, end);
+    }
+    return bounds;
+}
+
+/// A field of a line
+struct Field {
+    const char *begin;
+    const char *end;
+
+    bool empty() const { return begin == end; }
+    string str() const { return string(begin, end); }
+};
+
+/// Returns the next field of the line [\p p, \p end) separated by blanks
+/// and moves \p p past it. The field is empty at the end of the line.
+Field nextField(const char *&p, const char *end) {
+    p           = skipBlanks(p, end);
+    Field field = {p, p};
+    while (p < end && !isBlank(*p)) { ++p; }
+    field.end = p;
+    return field;
+}
+
+[[noreturn]] void throwInvalidNumber(const Field &field) {
+    const string msg = "Invalid number \"" + field.str() + "\" in the file";
+    AF_ERROR(msg.c_str(), AF_ERR_ARG);
+}
+
+/// Copies \p field to \p token as a C string
+void copyField(const Field &field, char (&token)[64]) {
+    const size_t len = field.end - field.begin;
+    if (len == 0 || len >= sizeof(token)) { throwInvalidNumber(field); }
+    memcpy(token, field.begin, len);
+    token[len] = '\0';
+}
+
+void checkParsed(const Field &field, const char *token, const char *stop) {
+    if (stop != token + (field.end - field.begin)) {
+        throwInvalidNumber(field);
+    }
+}
+
+/// Parses the number in \p field. The fields of integer types are parsed as
+/// integers so the large values of 64-bit types are exact.
+template<typename T>
+typename std::enable_if<std::is_floating_point<T>::value, T>::type
+parseNumber(const Field &field) {
+    char token[64];
+    copyField(field, token);
+    char *stop    = nullptr;
+    const T value = static_cast<T>(strtod(token, &stop));
+    checkParsed(field, token, stop);
+    return value;
+}
+
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value, T>::type parseNumber(
+    const Field &field) {
+    char token[64];
+    copyField(field, token);
+    char *stop = nullptr;
+    T value;
+    if (std::is_signed<T>::value) {
+        value = static_cast<T>(strtoll(token, &stop, 10));
+    } else {
+        value = static_cast<T>(strtoull(token, &stop, 10));
+    }
+    checkParsed(field, token, stop);
+    return value;
+}
+
+/// Parses the 1-based index in \p field to a 0-based index smaller than
+/// \p size
+int parseIndex(const Field &field, const dim_t size) {
+    const intl index = parseNumber<intl>(field);
+    if (index < 1 || index > size) {
+        const string msg =
+            "Index " + field.str() + " of the Matrix Market file is invalid";
+        AF_ERROR(msg.c_str(), AF_ERR_ARG);
+    }
+    return static_cast<int>(index - 1);
+}
+
+/// The value of an empty field of a CSV file
+template<typename T>
+T getMissingValue() {
+    return std::numeric_limits<T>::has_quiet_NaN
+               ? std::numeric_limits<T>::quiet_NaN()
+               : T(0);
+}
+
+/// Parses the fields of the CSV line [\p p, \p end) to \p out, which holds
+/// the fields with a stride of \p stride. Only counts the fields if \p out
+/// is null.
+///
+/// \returns the number of fields of the line
+template<typename T>
+dim_t readCsvLine(const char *p, const char *end, const char delimiter,
+                  T *out, const dim_t stride, const dim_t ncols) {
+    dim_t col = 0;
+    while (true) {
+        const void *found = memchr(p, delimiter, end - p);
+        const char *stop  = found ? static_cast<const char *>(found) : end;
+        if (out) {
+            if (col >= ncols) {
+                AF_ERROR(
+                    "The rows of a CSV file must have the same number of "
+                    "fields",
+                    AF_ERR_SIZE);
+            }
+            Field field = {skipBlanks(p, stop), stop};
+            while (!field.empty() && isBlank(field.end[-1])) { --field.end; }
+            out[col * stride] =
+                field.empty() ? getMissingValue<T>() : parseNumber<T>(field);
+        }
+        ++col;
+        if (!found) { break; }
+        p = stop + 1;
+    }
+    if (out && col != ncols) {
+        AF_ERROR("The rows of a CSV file must have the same number of fields",
+                 AF_ERR_SIZE);
+    }
+    return col;
+}
+
+/// Returns true if the line [\p p, \p end) only has blanks
+bool isBlankLine(const char *p, const char *end) {
+    return skipBlanks(p, end) == end;
+}
+
+/// Counts the lines of each part of \p bounds which are not blank or
+/// comments starting with \p comment, and returns the number of lines
+/// before each part
+vector<dim_t> countLines(const vector<const char *> &bounds,
+                         const char comment) {
+    const unsigned n = static_cast<unsigned>(bounds.size() - 1);
+    vector<dim_t> first(n + 1, 0);
+    runThreads(n, [&](const unsigned t) {
+        dim_t count = 0;
+        for (const char *p = bounds[t]; p < bounds[t + 1];) {
+            const char *stop  = getLineEnd(p, bounds[t + 1]);
+            const char *start = skipBlanks(p, stop);
+            if (start < stop && *start != comment) { ++count; }
+            p = stop + 1;
+        }
+        first[t + 1] = count;
+    });
+    for (unsigned t = 0; t < n; ++t) { first[t + 1] += first[t]; }
+    return first;
+}
+
+template<typename T>
+af_array readCsv(const MappedFile &file, const af_dtype type,
+                 const char delimiter, const unsigned skip_rows) {
+    const char *p   = file.data();
+    const char *end = p + file.size();
+    if (end - p >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0) { p += 3; }
+    for (unsigned i = 0; i < skip_rows; ++i) { p = getNextLine(p, end); }
+    while (p < end && isBlankLine(p, getLineEnd(p, end))) {
+        p = getNextLine(p, end);
+    }
+
+    const dim_t ncols =
+        p < end ? readCsvLine<T>(p, getLineEnd(p, end), delimiter, nullptr, 0,
+                                 0)
+                : 0;
+
+    const vector<const char *> bounds =
+        splitLines(p, end, getParseThreads(end - p));
+    const vector<dim_t> first = countLines(bounds, '\0');
+    const dim_t nrows         = first.back();
+
+    pinned_ptr buffer = allocPinned(nrows * ncols * sizeof(T));
+    T *values         = reinterpret_cast<T *>(buffer.get());
+    runThreads(static_cast<unsigned>(first.size() - 1), [&](const unsigned t) {
+        dim_t row = first[t];
+        for (const char *line = bounds[t]; line < bounds[t + 1];) {
+            const char *stop = getLineEnd(line, bounds[t + 1]);
+            if (!isBlankLine(line, stop)) {
+                readCsvLine<T>(line, stop, delimiter, values + row, nrows,
+                               ncols);
+                ++row;
+            }
+            line = stop + 1;
+        }
+    });
+
+    af_array out;
+    const dim_t dims[2] = {nrows, ncols};
+    if (nrows * ncols == 0) {
+        AF_CHECK(af_create_handle(&out, 2, dims, type));
+    } else {
+        AF_CHECK(af_create_array(&out, values, 2, dims, type));
+    }
+    return out;
+}
+
+/// The header of a Matrix Market file
+struct MtxHeader {
+    bool coordinate;
+    int values;  ///< The number of numbers of each value
+    string symmetry;
+    dim_t rows;
+    dim_t cols;
+    dim_t entries;
+};
+
+string toLower(string str) {
+    std::transform(str.begin(), str.end(), str.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return str;
+}
+
+/// Reads the header of a Matrix Market file, and moves \p p to the first
+/// line of the entries
+MtxHeader readMtxHeader(const char *&p, const char *end) {
+    const char *stop = getLineEnd(p, end);
+    const string banner(nextField(p, stop).str());
+    const string object(toLower(nextField(p, stop).str()));
+    const string format(toLower(nextField(p, stop).str()));
+    const string field(toLower(nextField(p, stop).str()));
+
+    MtxHeader header;
+    header.symmetry = toLower(nextField(p, stop).str());
+    if (toLower(banner) != "%%matrixmarket" || object != "matrix") {
+        AF_ERROR("The file is not a Matrix Market matrix", AF_ERR_ARG);
+    }
+    if (format != "coordinate" && format != "array") {
+        AF_ERROR("Unknown Matrix Market format", AF_ERR_ARG);
+    }
+    header.coordinate = format == "coordinate";
+    if (field == "real" || field == "double" || field == "integer") {
+        header.values = 1;
+    } else if (field == "complex") {
+        header.values = 2;
+    } else if (field == "pattern" && header.coordinate) {
+        header.values = 0;
+    } else {
+        AF_ERROR("Unknown Matrix Market field", AF_ERR_ARG);
+    }
+    if (header.symmetry != "general" && header.symmetry != "symmetric" &&
+        header.symmetry != "skew-symmetric" && header.symmetry != "hermitian") {
+        AF_ERROR("Unknown Matrix Market symmetry", AF_ERR_ARG);
+    }
+
+    // The comments are followed by the size line
+    p = getNextLine(stop, end);
+    while (p < end) {
+        stop              = getLineEnd(p, end);
+        const char *start = skipBlanks(p, stop);
+        if (start < stop && *start != '%') { break; }
+        p = getNextLine(stop, end);
+    }
+    if (p == end) {
+        AF_ERROR("The Matrix Market file has no size line", AF_ERR_ARG);
+    }
+    header.rows    = parseNumber<intl>(nextField(p, stop));
+    header.cols    = parseNumber<intl>(nextField(p, stop));
+    header.entries = header.coordinate ? parseNumber<intl>(nextField(p, stop))
+                                       : header.rows * header.cols;
+    if (header.rows < 0 || header.cols < 0 || header.entries < 0 ||
+        header.rows > INT_MAX || header.cols > INT_MAX) {
+        AF_ERROR("Invalid size of the Matrix Market matrix", AF_ERR_SIZE);
+    }
+    if (header.symmetry != "general" && header.rows != header.cols) {
+        AF_ERROR("A symmetric Matrix Market matrix must be square",
+                 AF_ERR_SIZE);
+    }
+    p = getNextLine(stop, end);
+    return header;
+}
+
+template<typename T>
+struct is_complex : std::false_type {};
+template<typename T>
+struct is_complex<complex<T>> : std::true_type {};
+
+template<typename T>
+T makeValue(const double re, const double im, std::false_type) {
+    UNUSED(im);
+    return static_cast<T>(re);
+}
+
+template<typename T>
+T makeValue(const double re, const double im, std::true_type) {
+    return T(re, im);
+}
+
+/// Parses the value of an entry, which has \p count numbers. The values of
+/// pattern files are one.
+template<typename T>
+T parseValue(const char *&p, const char *end, const int count) {
+    const double re = count > 0 ? parseNumber<double>(nextField(p, end)) : 1;
+    const double im = count > 1 ? parseNumber<double>(nextField(p, end)) : 0;
+    return makeValue<T>(re, im, is_complex<T>());
+}
+
+/// The entries of a coordinate file parsed by a thread
+template<typename T>
+struct MtxEntries {
+    vector<int> rows;
+    vector<int> cols;
+    vector<T> values;
+};
+
+template<typename T>
+T conjugate(const T &value) {
+    return value;
+}
+
+template<typename T>
+complex<T> conjugate(const complex<T> &value) {
+    return std::conj(value);
+}
+
+/// Returns the value of the entry mirrored by the symmetry of the matrix
+template<typename T>
+T mirrorValue(const T &value, const string &symmetry) {
+    if (symmetry == "skew-symmetric") { return -value; }
+    if (symmetry == "hermitian") { return conjugate(value); }
+    return value;
+}
+
+/// Builds a CSR array from the entries of a coordinate file. The rows are
+/// counted and filled by all the threads, and the columns of each row are
+/// sorted.
+template<typename T>
+af_array readMtxCoordinate(const MtxHeader &header, const char *p,
+                           const char *end, const af_dtype type) {
+    const vector<const char *> bounds =
+        splitLines(p, end, getParseThreads(end - p));
+    const unsigned n = static_cast<unsigned>(bounds.size() - 1);
+    vector<MtxEntries<T>> parts(n);
+    runThreads(n, [&](const unsigned t) {
+        MtxEntries<T> &part = parts[t];
+        for (const char *line = bounds[t]; line < bounds[t + 1];) {
+            const char *stop  = getLineEnd(line, bounds[t + 1]);
+            const char *start = skipBlanks(line, stop);
+            line              = stop + 1;
+            if (start == stop || *start == '%') { continue; }
+            const Field row = nextField(start, stop);
+            const Field col = nextField(start, stop);
+            part.rows.push_back(parseIndex(row, header.rows));
+            part.cols.push_back(parseIndex(col, header.cols));
+            part.values.push_back(parseValue<T>(start, stop, header.values));
+        }
+    });
+
+    const bool general = header.symmetry == "general";
+    size_t entries = 0, nnz = 0;
+    for (const auto &part : parts) {
+        entries += part.rows.size();
+        nnz += part.rows.size();
+        if (general) { continue; }
+        for (size_t i = 0; i < part.rows.size(); ++i) {
+            nnz += part.rows[i] != part.cols[i];
+        }
+    }
+    if (entries != static_cast<size_t>(header.entries)) {
+        AF_ERROR(
+            "The number of entries of the Matrix Market file does not match "
+            "its size line",
+            AF_ERR_ARG);
+    }
+    if (nnz > INT_MAX) {
+        AF_ERROR("The matrix has too many values for 32-bit indices",
+                 AF_ERR_SIZE);
+    }
+
+    const int nrows = static_cast<int>(header.rows);
+    unique_ptr<atomic<int>[]> next(new atomic<int>[nrows + 1]);
+    for (int r = 0; r <= nrows; ++r) { next[r].store(0); }
+    runThreads(n, [&](const unsigned t) {
+        const MtxEntries<T> &part = parts[t];
+        for (size_t i = 0; i < part.rows.size(); ++i) {
+            next[part.rows[i]].fetch_add(1, std::memory_order_relaxed);
+            if (!general && part.rows[i] != part.cols[i]) {
+                next[part.cols[i]].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    });
+
+    pinned_ptr rowBuffer = allocPinned((nrows + 1) * sizeof(int));
+    pinned_ptr colBuffer = allocPinned(nnz * sizeof(int));
+    pinned_ptr valBuffer = allocPinned(nnz * sizeof(T));
+    int *rowIdx          = reinterpret_cast<int *>(rowBuffer.get());
+    int *colIdx          = reinterpret_cast<int *>(colBuffer.get());
+    T *values            = reinterpret_cast<T *>(valBuffer.get());
+    rowIdx[0]            = 0;
+    for (int r = 0; r < nrows; ++r) {
+        rowIdx[r + 1] = rowIdx[r] + next[r].load();
+        next[r].store(rowIdx[r]);
+    }
+
+    runThreads(n, [&](const unsigned t) {
+        const MtxEntries<T> &part = parts[t];
+        for (size_t i = 0; i < part.rows.size(); ++i) {
+            const int row = part.rows[i], col = part.cols[i];
+            int pos = next[row].fetch_add(1, std::memory_order_relaxed);
+            colIdx[pos] = col;
+            values[pos] = part.values[i];
+            if (!general && row != col) {
+                pos = next[col].fetch_add(1, std::memory_order_relaxed);
+                colIdx[pos] = row;
+                values[pos] = mirrorValue(part.values[i], header.symmetry);
+            }
+        }
+    });
+    parts.clear();
+
+    // The threads fill the rows in any order
+    runThreads(n, [&](const unsigned t) {
+        vector<std::pair<int, T>> row;
+        const intl lo_row = static_cast<intl>(nrows) * t / n;
+        const intl hi_row = static_cast<intl>(nrows) * (t + 1) / n;
+        for (int r = static_cast<int>(lo_row); r < hi_row; ++r) {
+            const int lo = rowIdx[r], hi = rowIdx[r + 1];
+            if (std::is_sorted(colIdx + lo, colIdx + hi)) { continue; }
+            row.clear();
+            for (int i = lo; i < hi; ++i) {
+                row.emplace_back(colIdx[i], values[i]);
+            }
+            std::stable_sort(row.begin(), row.end(),
+                             [](const std::pair<int, T> &a,
+                                const std::pair<int, T> &b) {
+                                 return a.first < b.first;
+                             });
+            for (int i = lo; i < hi; ++i) {
+                colIdx[i] = row[i - lo].first;
+                values[i] = row[i - lo].second;
+            }
+        }
+    });
+
+    af_array out;
+    AF_CHECK(af_create_sparse_array_from_ptr(
+        &out, header.rows, header.cols, static_cast<dim_t>(nnz), values,
+        rowIdx, colIdx, type, AF_STORAGE_CSR, afHost));
+    return out;
+}
+
+/// Reads the values of an array file, which are stored in column major
+/// order, to a dense array
+template<typename T>
+af_array readMtxArray(const MtxHeader &header, const char *p,
+                      const char *end, const af_dtype type) {
+    if (header.symmetry != "general") {
+        AF_ERROR("Only general Matrix Market arrays are supported",
+                 AF_ERR_NOT_SUPPORTED);
+    }
+    const vector<const char *> bounds =
+        splitLines(p, end, getParseThreads(end - p));
+    const vector<dim_t> first = countLines(bounds, '%');
+    if (first.back() != header.entries) {
+        AF_ERROR(
+            "The number of values of the Matrix Market file does not match "
+            "its size line",
+            AF_ERR_ARG);
+    }
+
+    pinned_ptr buffer = allocPinned(header.entries * sizeof(T));
+    T *values         = reinterpret_cast<T *>(buffer.get());
+    runThreads(static_cast<unsigned>(first.size() - 1), [&](const unsigned t) {
+        T *dst = values + first[t];
+        for (const char *line = bounds[t]; line < bounds[t + 1];) {
+            const char *stop  = getLineEnd(line, bounds[t + 1]);
+            const char *start = skipBlanks(line, stop);
+            line              = stop + 1;
+            if (start == stop || *start == '%') { continue; }
+            *dst++ = parseValue<T>(start, stop, header.values);
+        }
+    });
+
+    af_array out;
+    const dim_t dims[2] = {header.rows, header.cols};
+    AF_CHECK(af_create_array(&out, values, 2, dims, type));
+    return out;
+}
+
+template<typename T>
+af_array readMtx(const MappedFile &file, const af_dtype type) {
+    const char *p          = file.data();
+    const char *end        = p + file.size();
+    const MtxHeader header = readMtxHeader(p, end);
+    if (header.values == 2 && !is_complex<T>::value) {
+        AF_ERROR("The Matrix Market file is complex", AF_ERR_TYPE);
+    }
+    return header.coordinate ? readMtxCoordinate<T>(header, p, end, type)
+                             : readMtxArray<T>(header, p, end, type);
+}
+
+}  // namespace
+
+af_err af_read_mtx(af_array *out, const char *filename, const af_dtype type) {
+    AF_API_RANGE();
+    try {
+        AF_CHECK(af_init());
+        ARG_ASSERT(1, filename != NULL);
+
+        const MappedFile file(filename);
+        af_array output;
+        switch (type) {
+            case f32: output = readMtx<float>(file, type); break;
+            case f64: output = readMtx<double>(file, type); break;
+            case c32: output = readMtx<complex<float>>(file, type); break;
+            case c64: output = readMtx<complex<double>>(file, type); break;
+            default: TYPE_ERROR(2, type);
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_read_csv(af_array *out, const char *filename, const af_dtype type,
+                   const char delimiter, const unsigned skip_rows) {
+    AF_API_RANGE();
+    try {
+        AF_CHECK(af_init());
+        ARG_ASSERT(1, filename != NULL);
+        ARG_ASSERT(3, delimiter != '\n' && delimiter != '\0');
+
+        const MappedFile file(filename);
+        af_array output;
+        switch (type) {
+            case f32:
+                output = readCsv<float>(file, type, delimiter, skip_rows);
+                break;
+            case f64:
+                output = readCsv<double>(file, type, delimiter, skip_rows);
+                break;
+            case s32:
+                output = readCsv<int>(file, type, delimiter, skip_rows);
+                break;
+            case u32:
+                output = readCsv<uint>(file, type, delimiter, skip_rows);
+                break;
+            case s64:
+                output = readCsv<intl>(file, type, delimiter, skip_rows);
+                break;
+            case u64:
+                output = readCsv<uintl>(file, type, delimiter, skip_rows);
+                break;
+            case s16:
+                output = readCsv<short>(file, type, delimiter, skip_rows);
+                break;
+            case u16:
+                output = readCsv<ushort>(file, type, delimiter, skip_rows);
+                break;
+            case u8:
+                output = readCsv<uchar>(file, type, delimiter, skip_rows);
+                break;
+            default: TYPE_ERROR(2, type);
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
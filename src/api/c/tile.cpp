@@ -9,6 +9,7 @@
 
 #include <tile.hpp>
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
@@ -60,6 +61,7 @@ static inline af_array tile(const af_array in, const af::dim4 &tileDims) {
 }
 
 af_err af_tile(af_array *out, const af_array in, const af::dim4 &tileDims) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo &info = getInfo(in);
         af_dtype type         = info.getType();
@@ -95,6 +97,7 @@ af_err af_tile(af_array *out, const af_array in, const af::dim4 &tileDims) {
 
 af_err af_tile(af_array *out, const af_array in, const unsigned x,
                const unsigned y, const unsigned z, const unsigned w) {
+    AF_API_RANGE_ARRAY(in);
     af::dim4 tileDims(x, y, z, w);
     return af_tile(out, in, tileDims);
 }
@@ -10,6 +10,7 @@
 #include <af/data.h>
 #include <af/statistics.h>
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -39,6 +40,7 @@ af_err topk(af_array *v, af_array *i, const af_array in, const int k,
 
 af_err af_topk(af_array *values, af_array *indices, const af_array in,
                const int k, const int dim, const af_topk_function order) {
+    AF_API_RANGE_ARRAY(in);
     try {
         af::topkFunction ord = (order == AF_TOPK_DEFAULT ? AF_TOPK_MAX : order);
 
@@ -66,7 +68,6 @@ af_err af_topk(af_array *values, af_array *indices, const af_array in,
         }
 
         ARG_ASSERT(2, (inInfo.dims()[rdim] >= k));
-        ARG_ASSERT(4, (k <= 256));  // TODO(umar): Remove this limitation
 
         if (rdim != 0) {
             AF_ERROR("topk is supported along dimenion 0 only.",
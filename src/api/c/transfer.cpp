@@ -0,0 +1,348 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <Event.hpp>
+#include <api_range.hpp>
+#include <backend.hpp>
+#include <common/ArrayInfo.hpp>
+#include <common/err_common.hpp>
+#include <common/half.hpp>
+#include <copy.hpp>
+#include <handle.hpp>
+#include <memory.hpp>
+#include <platform.hpp>
+#include <type_util.hpp>
+#include <af/array.h>
+#include <af/event.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+using common::half;
+using detail::Array;
+using detail::block;
+using detail::cdouble;
+using detail::cfloat;
+using detail::copyArray;
+using detail::copyFromArrayAsync;
+using detail::copyToArrayAsync;
+using detail::createAndMarkEvent;
+using detail::createEvent;
+using detail::getActiveDeviceId;
+using detail::getDeviceCount;
+using detail::intl;
+using detail::markEventOnActiveQueue;
+using detail::pinnedAlloc;
+using detail::pinnedAllocated;
+using detail::setDevice;
+using detail::uchar;
+using detail::uint;
+using detail::uintl;
+using detail::ushort;
+using std::lock_guard;
+using std::mutex;
+
+namespace {
+
+/// The size of each staging buffer
+constexpr size_t STAGING_BUFFER_BYTES = 16 << 20;
+
+/// The number of staging buffers of each device. The host copies the data
+/// of one buffer while the device transfers the data of the other.
+constexpr size_t STAGING_BUFFER_COUNT = 2;
+
+/// A pinned buffer which stages the transfers of pageable host memory
+struct StagingBuffer {
+    char *data;
+    /// Marked on the queue after the last transfer which uses the buffer
+    af_event event;
+};
+
+using StagingBuffers = std::array<StagingBuffer, STAGING_BUFFER_COUNT>;
+
+/// The staging buffers of each device. The buffers of a device are created
+/// by its first staged transfer and are kept until the process exits.
+class StagingPool {
+    mutex m_mutex;
+    std::unordered_map<unsigned, StagingBuffers> m_buffers;
+
+   public:
+    /// Calls \p func with the staging buffers of the active device. The
+    /// buffers can not be used by other threads until \p func returns.
+    template<typename F>
+    void run(F func) {
+        lock_guard<mutex> lock(m_mutex);
+        const unsigned device = getActiveDeviceId();
+        auto iter             = m_buffers.find(device);
+        if (iter == m_buffers.end()) {
+            StagingBuffers buffers{};
+            for (StagingBuffer &buffer : buffers) {
+                buffer.data  = pinnedAlloc<char>(STAGING_BUFFER_BYTES);
+                buffer.event = createEvent();
+                // The event of an unused buffer is complete
+                markEventOnActiveQueue(buffer.event);
+            }
+            iter = m_buffers.emplace(device, buffers).first;
+        }
+        func(iter->second);
+    }
+};
+
+StagingPool &getStagingPool() {
+    // The buffers are not freed because the memory managers may be
+    // destroyed before the static objects of this file
+    static auto *pool = new StagingPool();
+    return *pool;
+}
+
+template<typename T>
+af_event writeAsync(af_array arr, const T *data, const size_t bytes,
+                         const af_source src) {
+    Array<T> &out = getArray<T>(arr);
+    if (src == afDevice) {
+        writeDeviceDataArray(out, data, bytes);
+    } else if (bytes != 0 && pinnedAllocated(data) >= bytes) {
+        copyToArrayAsync(out, data, bytes, 0);
+    } else if (bytes != 0) {
+        // Pageable memory can not be read by the device asynchronously, so
+        // it is copied to the staging buffers in turn
+        const char *host = reinterpret_cast<const char *>(data);
+        getStagingPool().run([&](StagingBuffers &buffers) {
+            size_t next = 0;
+            for (size_t offset = 0; offset < bytes;
+                 offset += STAGING_BUFFER_BYTES) {
+                StagingBuffer &buffer = buffers[next];
+                const size_t length =
+                    std::min(STAGING_BUFFER_BYTES, bytes - offset);
+
+                block(buffer.event);
+                std::memcpy(buffer.data, host + offset, length);
+                copyToArrayAsync(out, reinterpret_cast<T *>(buffer.data),
+                                 length, offset);
+                markEventOnActiveQueue(buffer.event);
+                next = (next + 1) % STAGING_BUFFER_COUNT;
+            }
+        });
+    }
+    return createAndMarkEvent();
+}
+
+template<typename T>
+af_event readAsync(T *data, const af_array arr) {
+    Array<T> in = getArray<T>(arr);
+    in.eval();
+    if (!in.isLinear() && in.ndims() != 1) { in = copyArray(in); }
+
+    const size_t bytes = in.elements() * sizeof(T);
+    if (bytes != 0 && pinnedAllocated(data) >= bytes) {
+        copyFromArrayAsync(data, in, bytes, 0);
+    } else if (bytes != 0) {
+        // The device transfers the next chunk to one buffer while the host
+        // copies the previous chunk out of the other
+        char *host = reinterpret_cast<char *>(data);
+        getStagingPool().run([&](StagingBuffers &buffers) {
+            size_t next = 0;
+            StagingBuffer *pending = nullptr;
+            size_t pendingOffset = 0, pendingLength = 0;
+            for (size_t offset = 0; offset < bytes;
+                 offset += STAGING_BUFFER_BYTES) {
+                StagingBuffer &buffer = buffers[next];
+                const size_t length =
+                    std::min(STAGING_BUFFER_BYTES, bytes - offset);
+
+                copyFromArrayAsync(reinterpret_cast<T *>(buffer.data), in,
+                                   length, offset);
+                markEventOnActiveQueue(buffer.event);
+                if (pending) {
+                    block(pending->event);
+                    std::memcpy(host + pendingOffset, pending->data,
+                                pendingLength);
+                }
+                pending       = &buffer;
+                pendingOffset = offset;
+                pendingLength = length;
+                next          = (next + 1) % STAGING_BUFFER_COUNT;
+            }
+            block(pending->event);
+            std::memcpy(host + pendingOffset, pending->data, pendingLength);
+        });
+    }
+    return createAndMarkEvent();
+}
+
+template<typename T>
+af_array copyToDevice(af_event *event, const af_array in, const int device) {
+    Array<T> out = detail::copyToDevice(getArray<T>(in), device);
+
+    // The event is marked on the queue of the destination device
+    const int oldDevice = setDevice(device);
+    *event              = createAndMarkEvent();
+    setDevice(oldDevice);
+    return getHandle(out);
+}
+
+}  // namespace
+
+af_err af_write_array_async(af_event *event, af_array arr, const void *data,
+                            const size_t bytes, af_source src) {
+    AF_API_RANGE_ARRAY(arr);
+    try {
+        const ArrayInfo &info = getInfo(arr);
+        ARG_ASSERT(3, bytes <= info.elements() * size_of(info.getType()));
+
+        af_event out;
+        switch (info.getType()) {
+            case f32:
+                out = writeAsync(arr, static_cast<const float *>(data), bytes,
+                                 src);
+                break;
+            case c32:
+                out = writeAsync(arr, static_cast<const cfloat *>(data), bytes,
+                                 src);
+                break;
+            case f64:
+                out = writeAsync(arr, static_cast<const double *>(data), bytes,
+                                 src);
+                break;
+            case c64:
+                out = writeAsync(arr, static_cast<const cdouble *>(data), bytes,
+                                 src);
+                break;
+            case b8:
+                out = writeAsync(arr, static_cast<const char *>(data), bytes,
+                                 src);
+                break;
+            case s32:
+                out = writeAsync(arr, static_cast<const int *>(data), bytes,
+                                 src);
+                break;
+            case u32:
+                out = writeAsync(arr, static_cast<const uint *>(data), bytes,
+                                 src);
+                break;
+            case u8:
+                out = writeAsync(arr, static_cast<const uchar *>(data), bytes,
+                                 src);
+                break;
+            case s64:
+                out = writeAsync(arr, static_cast<const intl *>(data), bytes,
+                                 src);
+                break;
+            case u64:
+                out = writeAsync(arr, static_cast<const uintl *>(data), bytes,
+                                 src);
+                break;
+            case s16:
+                out = writeAsync(arr, static_cast<const short *>(data), bytes,
+                                 src);
+                break;
+            case u16:
+                out = writeAsync(arr, static_cast<const ushort *>(data), bytes,
+                                 src);
+                break;
+            case f16:
+                out = writeAsync(arr, static_cast<const half *>(data), bytes,
+                                 src);
+                break;
+            default: TYPE_ERROR(1, info.getType());
+        }
+        *event = out;
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_create_array_async(af_event *event, af_array *arr, const void *data,
+                             const unsigned ndims, const dim_t *const dims,
+                             const af_dtype type) {
+    AF_API_RANGE();
+    try {
+        AF_CHECK(af_init());
+        const af::dim4 d = verifyDims(ndims, dims);
+
+        af_array out = createHandle(d, type);
+        af_event written;
+        const af_err err = af_write_array_async(
+            &written, out, data, d.elements() * size_of(type), afHost);
+        if (err != AF_SUCCESS) {
+            af_release_array(out);
+            return err;
+        }
+        *event = written;
+        std::swap(*arr, out);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_data_ptr_async(af_event *event, void *data, const af_array arr) {
+    AF_API_RANGE_ARRAY(arr);
+    try {
+        const af_dtype type = getInfo(arr).getType();
+        af_event out;
+        // clang-format off
+        switch (type) {
+            case f32: out = readAsync(static_cast<float*   >(data), arr); break;
+            case c32: out = readAsync(static_cast<cfloat*  >(data), arr); break;
+            case f64: out = readAsync(static_cast<double*  >(data), arr); break;
+            case c64: out = readAsync(static_cast<cdouble* >(data), arr); break;
+            case b8:  out = readAsync(static_cast<char*    >(data), arr); break;
+            case s32: out = readAsync(static_cast<int*     >(data), arr); break;
+            case u32: out = readAsync(static_cast<unsigned*>(data), arr); break;
+            case u8:  out = readAsync(static_cast<uchar*   >(data), arr); break;
+            case s64: out = readAsync(static_cast<intl*    >(data), arr); break;
+            case u64: out = readAsync(static_cast<uintl*   >(data), arr); break;
+            case s16: out = readAsync(static_cast<short*   >(data), arr); break;
+            case u16: out = readAsync(static_cast<ushort*  >(data), arr); break;
+            case f16: out = readAsync(static_cast<half*    >(data), arr); break;
+            default: TYPE_ERROR(2, type);
+        }
+        // clang-format on
+        *event = out;
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_copy_to_device(af_event *event, af_array *out, const af_array in,
+                         const int device) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const af_dtype type = getInfo(in, true, false).getType();
+        ARG_ASSERT(3, device >= 0 && device < getDeviceCount());
+
+        af_array res;
+        // clang-format off
+        switch (type) {
+            case f32: res = copyToDevice<float   >(event, in, device); break;
+            case c32: res = copyToDevice<cfloat  >(event, in, device); break;
+            case f64: res = copyToDevice<double  >(event, in, device); break;
+            case c64: res = copyToDevice<cdouble >(event, in, device); break;
+            case b8:  res = copyToDevice<char    >(event, in, device); break;
+            case s32: res = copyToDevice<int     >(event, in, device); break;
+            case u32: res = copyToDevice<unsigned>(event, in, device); break;
+            case u8:  res = copyToDevice<uchar   >(event, in, device); break;
+            case s64: res = copyToDevice<intl    >(event, in, device); break;
+            case u64: res = copyToDevice<uintl   >(event, in, device); break;
+            case s16: res = copyToDevice<short   >(event, in, device); break;
+            case u16: res = copyToDevice<ushort  >(event, in, device); break;
+            case f16: res = copyToDevice<half    >(event, in, device); break;
+            default: TYPE_ERROR(2, type);
+        }
+        // clang-format on
+        std::swap(*out, res);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <blas.hpp>
@@ -83,6 +84,7 @@ static af_array transform_coordinates(const af_array &tf_, const float d0_,
 
 af_err af_transform_coordinates(af_array *out, const af_array tf,
                                 const float d0_, const float d1_) {
+    AF_API_RANGE_ARRAY(tf);
     try {
         const ArrayInfo &tfInfo = getInfo(tf);
         dim4 tfDims             = tfInfo.dims();
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
@@ -35,6 +36,7 @@ static inline af_array trs(const af_array in, const bool conjugate) {
 }
 
 af_err af_transpose(af_array* out, af_array in, const bool conjugate) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type         = info.getType();
@@ -88,6 +90,7 @@ static inline void transpose_inplace(af_array in, const bool conjugate) {
 }
 
 af_err af_transpose_inplace(af_array in, const bool conjugate) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type         = info.getType();
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <type_util.hpp>
 
 #include <common/err_common.hpp>
@@ -29,6 +30,7 @@ size_t size_of(af_dtype type) {
             case s64: return sizeof(long long);
             case u64: return sizeof(unsigned long long);
             case f16: return sizeof(af_half);
+            case bf16: return sizeof(af_bfloat16);
             default: TYPE_ERROR(1, type);
         }
     }
@@ -38,6 +40,7 @@ size_t size_of(af_dtype type) {
 }
 
 af_err af_get_size_of(size_t *size, af_dtype type) {
+    AF_API_RANGE();
     *size = size_of(type);
     return AF_SUCCESS;
 }
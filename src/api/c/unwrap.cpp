@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
@@ -23,6 +24,7 @@ using detail::intl;
 using detail::uchar;
 using detail::uint;
 using detail::uintl;
+using detail::unwrapReduce;
 using detail::ushort;
 
 template<typename T>
@@ -36,6 +38,7 @@ static inline af_array unwrap(const af_array in, const dim_t wx, const dim_t wy,
 af_err af_unwrap(af_array* out, const af_array in, const dim_t wx,
                  const dim_t wy, const dim_t sx, const dim_t sy, const dim_t px,
                  const dim_t py, const bool is_column) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type         = info.getType();
@@ -95,3 +98,63 @@ af_err af_unwrap(af_array* out, const af_array in, const dim_t wx,
 
     return AF_SUCCESS;
 }
+
+template<af_op_t op>
+static inline af_array unwrap_reduce(const af_array in, const dim_t wx,
+                                     const dim_t wy, const dim_t sx,
+                                     const dim_t sy, const dim_t px,
+                                     const dim_t py) {
+    // The windows of double arrays are reduced in double, the windows of the
+    // other real arrays in float
+    if (getInfo(in).getType() == f64) {
+        return getHandle(unwrapReduce<op, double>(getArray<double>(in), wx,
+                                                  wy, sx, sy, px, py));
+    }
+    return getHandle(unwrapReduce<op, float>(castArray<float>(in), wx, wy, sx,
+                                             sy, px, py));
+}
+
+af_err af_unwrap_reduce(af_array* out, const af_array in, const dim_t wx,
+                        const dim_t wy, const dim_t sx, const dim_t sy,
+                        const dim_t px, const dim_t py,
+                        const af_binary_op op) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const ArrayInfo& info = getInfo(in);
+        af::dim4 idims        = info.dims();
+
+        if (!info.isReal() || info.isBool()) {
+            TYPE_ERROR(1, info.getType());
+        }
+        ARG_ASSERT(2, wx > 0 && wx <= idims[0] + 2 * px);
+        ARG_ASSERT(3, wy > 0 && wy <= idims[1] + 2 * py);
+        ARG_ASSERT(4, sx > 0);
+        ARG_ASSERT(5, sy > 0);
+        ARG_ASSERT(6, px >= 0 && px < wx);
+        ARG_ASSERT(7, py >= 0 && py < wy);
+
+        af_array output;
+        switch (op) {
+            case AF_BINARY_ADD:
+                output = unwrap_reduce<af_add_t>(in, wx, wy, sx, sy, px, py);
+                break;
+            case AF_BINARY_MUL:
+                output = unwrap_reduce<af_mul_t>(in, wx, wy, sx, sy, px, py);
+                break;
+            case AF_BINARY_MIN:
+                output = unwrap_reduce<af_min_t>(in, wx, wy, sx, sy, px, py);
+                break;
+            case AF_BINARY_MAX:
+                output = unwrap_reduce<af_max_t>(in, wx, wy, sx, sy, px, py);
+                break;
+            default:
+                AF_ERROR(
+                    "Incorrect binary operation enum for argument number 8",
+                    AF_ERR_ARG);
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
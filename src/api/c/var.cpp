@@ -7,15 +7,19 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <cast.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
+#include <copy.hpp>
 #include <handle.hpp>
 #include <math.hpp>
 #include <mean.hpp>
+#include <meanvar.hpp>
 #include <reduce.hpp>
+#include <af/data.h>
 #include <af/defines.h>
 #include <af/dim4.hpp>
 #include <af/statistics.h>
@@ -23,6 +27,7 @@
 #include "stats.h"
 
 #include <tuple>
+#include <type_traits>
 
 using af::dim4;
 using common::half;
@@ -34,6 +39,7 @@ using detail::cfloat;
 using detail::createEmptyArray;
 using detail::createValueArray;
 using detail::division;
+using detail::getScalar;
 using detail::imag;
 using detail::intl;
 using detail::mean;
@@ -45,14 +51,68 @@ using detail::uchar;
 using detail::uint;
 using detail::uintl;
 using detail::ushort;
+using std::false_type;
 using std::ignore;
+using std::integral_constant;
+using std::is_same;
 using std::make_tuple;
 using std::tie;
+using std::true_type;
 using std::tuple;
 
+/// The backends compute the mean and the variance of real values in one pass.
+/// Complex values and half precision inputs are reduced in two passes.
+template<typename inType, typename outType>
+using isOnePass =
+    integral_constant<bool, (is_same<outType, float>::value ||
+                             is_same<outType, double>::value) &&
+                                !is_same<inType, half>::value>;
+
+/// Computes the mean and the variance of \p in along \p dim in one pass with
+/// Welford's algorithm. Returns false, leaving the outputs unchanged, when the
+/// types are not supported by the backends or \p in is empty.
+template<typename inType, typename outType>
+static bool meanvarOnePass(
+    Array<outType>& mean, Array<outType>& var, const Array<inType>& in,
+    const Array<typename baseOutType<outType>::type>& weights,
+    const af_var_bias bias, const int dim, true_type) {
+    if (in.elements() == 0) { return false; }
+    detail::meanvar<inType, outType>(mean, var, in, weights, bias, dim);
+    return true;
+}
+
+template<typename inType, typename outType>
+static bool meanvarOnePass(
+    Array<outType>&, Array<outType>&, const Array<inType>&,
+    const Array<typename baseOutType<outType>::type>&, const af_var_bias,
+    const int, false_type) {
+    return false;
+}
+
+/// Returns the values of \p in as a vector
+template<typename T>
+static Array<T> flat(const af_array& in) {
+    const dim4 dims(getInfo(in).elements());
+    af_array vec = 0;
+    AF_CHECK(af_moddims(&vec, in, 1, dims.get()));
+    const Array<T> out = getArray<T>(vec);
+    AF_CHECK(af_release_array(vec));
+    return out;
+}
+
 template<typename inType, typename outType>
 static outType varAll(const af_array& in, const af_var_bias bias) {
-    using weightType          = typename baseOutType<outType>::type;
+    using weightType = typename baseOutType<outType>::type;
+
+    Array<outType> meanVec = createEmptyArray<outType>({0});
+    Array<outType> varVec  = createEmptyArray<outType>({0});
+    if (meanvarOnePass<inType, outType>(
+            meanVec, varVec, flat<inType>(in),
+            createEmptyArray<weightType>({0}), bias, 0,
+            isOnePass<inType, outType>())) {
+        return getScalar<outType>(varVec);
+    }
+
     const Array<inType> inArr = getArray<inType>(in);
     Array<outType> input      = cast<outType>(inArr);
 
@@ -75,6 +135,14 @@ template<typename inType, typename outType>
 static outType varAll(const af_array& in, const af_array weights) {
     using bType = typename baseOutType<outType>::type;
 
+    Array<outType> meanVec = createEmptyArray<outType>({0});
+    Array<outType> varVec  = createEmptyArray<outType>({0});
+    if (meanvarOnePass<inType, outType>(
+            meanVec, varVec, flat<inType>(in), flat<bType>(weights),
+            AF_VARIANCE_POPULATION, 0, isOnePass<inType, outType>())) {
+        return getScalar<outType>(varVec);
+    }
+
     Array<outType> input = cast<outType>(getArray<inType>(in));
     Array<outType> wts   = cast<outType>(getArray<bType>(weights));
 
@@ -100,11 +168,18 @@ static tuple<Array<outType>, Array<outType>> meanvar(
     const Array<inType>& in,
     const Array<typename baseOutType<outType>::type>& weights,
     const af_var_bias bias, const dim_t dim) {
-    using weightType     = typename baseOutType<outType>::type;
-    Array<outType> input = cast<outType>(in);
-    dim4 iDims           = input.dims();
+    using weightType = typename baseOutType<outType>::type;
 
     Array<outType> meanArr = createEmptyArray<outType>({0});
+    Array<outType> varArr  = createEmptyArray<outType>({0});
+    if (meanvarOnePass<inType, outType>(meanArr, varArr, in, weights, bias,
+                                        static_cast<int>(dim),
+                                        isOnePass<inType, outType>())) {
+        return make_tuple(meanArr, varArr);
+    }
+
+    Array<outType> input   = cast<outType>(in);
+    dim4 iDims             = input.dims();
     Array<outType> normArr = createEmptyArray<outType>({0});
     if (weights.isEmpty()) {
         meanArr  = mean<outType, weightType, outType>(input, dim);
@@ -181,6 +256,7 @@ static af_array var_(const af_array& in, const af_array& weights,
 
 af_err af_var(af_array* out, const af_array in, const bool isbiased,
               const dim_t dim) {
+    AF_API_RANGE_ARRAY(in);
     const af_var_bias bias =
         (isbiased ? AF_VARIANCE_SAMPLE : AF_VARIANCE_POPULATION);
     return af_var_v2(out, in, bias, dim);
@@ -188,6 +264,7 @@ af_err af_var(af_array* out, const af_array in, const bool isbiased,
 
 af_err af_var_v2(af_array* out, const af_array in, const af_var_bias bias,
                  const dim_t dim) {
+    AF_API_RANGE_ARRAY(in);
     try {
         ARG_ASSERT(3, (dim >= 0 && dim <= 3));
 
@@ -246,6 +323,7 @@ af_err af_var_v2(af_array* out, const af_array in, const af_var_bias bias,
 
 af_err af_var_weighted(af_array* out, const af_array in, const af_array weights,
                        const dim_t dim) {
+    AF_API_RANGE_ARRAY(in);
     try {
         ARG_ASSERT(3, (dim >= 0 && dim <= 3));
 
@@ -324,6 +402,7 @@ af_err af_var_weighted(af_array* out, const af_array in, const af_array weights,
 
 af_err af_var_all(double* realVal, double* imagVal, const af_array in,
                   const bool isbiased) {
+    AF_API_RANGE_ARRAY(in);
     const af_var_bias bias =
         (isbiased ? AF_VARIANCE_SAMPLE : AF_VARIANCE_POPULATION);
     return af_var_all_v2(realVal, imagVal, in, bias);
@@ -331,6 +410,7 @@ af_err af_var_all(double* realVal, double* imagVal, const af_array in,
 
 af_err af_var_all_v2(double* realVal, double* imagVal, const af_array in,
                      const af_var_bias bias) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type         = info.getType();
@@ -365,6 +445,7 @@ af_err af_var_all_v2(double* realVal, double* imagVal, const af_array in,
 
 af_err af_var_all_weighted(double* realVal, double* imagVal, const af_array in,
                            const af_array weights) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& iInfo = getInfo(in);
         const ArrayInfo& wInfo = getInfo(weights);
@@ -409,6 +490,7 @@ af_err af_var_all_weighted(double* realVal, double* imagVal, const af_array in,
 af_err af_meanvar(af_array* mean, af_array* var, const af_array in,
                   const af_array weights, const af_var_bias bias,
                   const dim_t dim) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& iInfo = getInfo(in);
         if (weights != 0) {
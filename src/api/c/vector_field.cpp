@@ -10,14 +10,13 @@
 #include <af/data.h>
 #include <af/graphics.h>
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
 #include <common/graphics_common.hpp>
 #include <handle.hpp>
-#include <join.hpp>
 #include <reduce.hpp>
-#include <transpose.hpp>
 #include <vector_field.hpp>
 
 #include <vector>
@@ -25,9 +24,9 @@
 using af::dim4;
 using detail::Array;
 using detail::copy_vector_field;
+using detail::createSubArray;
 using detail::forgeManager;
-using detail::reduce;
-using detail::transpose;
+using detail::reduce_all;
 using detail::uchar;
 using detail::uint;
 using detail::ushort;
@@ -38,33 +37,37 @@ using namespace graphics;
 template<typename T>
 fg_chart setup_vector_field(fg_window window, const vector<af_array>& points,
                             const vector<af_array>& directions,
-                            const af_cell* const props,
-                            const bool transpose_ = true) {
+                            const af_cell* const props) {
     ForgeModule& _ = graphics::forgePlugin();
     vector<Array<T>> pnts;
     vector<Array<T>> dirs;
 
-    for (unsigned i = 0; i < points.size(); ++i) {
-        pnts.push_back(getArray<T>(points[i]));
-        dirs.push_back(getArray<T>(directions[i]));
-    }
-
-    // Join for set up vector
-    Array<T> pIn = detail::join(1, pnts);
-    Array<T> dIn = detail::join(1, dirs);
-
-    // do transpose if required
-    if (transpose_) {
-        pIn = transpose<T>(pIn, false);
-        dIn = transpose<T>(dIn, false);
+    // The components are the columns of a single array of points or one
+    // vector each. The backends write them straight into the buffers of the
+    // vector field, so they are not joined and transposed first.
+    if (points.size() == 1) {
+        const Array<T> pIn = getArray<T>(points[0]);
+        const Array<T> dIn = getArray<T>(directions[0]);
+        for (dim_t c = 0; c < pIn.dims()[1]; ++c) {
+            const double col      = static_cast<double>(c);
+            vector<af_seq> column = {af_span, {col, col, 1}};
+            pnts.push_back(createSubArray(pIn, column, false));
+            dirs.push_back(createSubArray(dIn, column, false));
+        }
+    } else {
+        for (unsigned i = 0; i < points.size(); ++i) {
+            pnts.push_back(getArray<T>(points[i]));
+            dirs.push_back(getArray<T>(directions[i]));
+        }
     }
+    const size_t order = pnts.size();
 
     ForgeManager& fgMngr = forgeManager();
 
     // Get the chart for the current grid position (if any)
     fg_chart chart = NULL;
 
-    if (pIn.dims()[0] == 2) {
+    if (order == 2) {
         if (props->col > -1 && props->row > -1) {
             chart =
                 fgMngr.getChart(window, props->row, props->col, FG_CHART_2D);
@@ -81,7 +84,7 @@ fg_chart setup_vector_field(fg_window window, const vector<af_array>& points,
     }
 
     fg_vector_field vfield =
-        fgMngr.getVectorField(chart, pIn.dims()[1], getGLType<T>());
+        fgMngr.getVectorField(chart, pnts[0].elements(), getGLType<T>());
 
     // ArrayFire LOGO dark blue shade
     FG_CHECK(_.fg_set_vector_field_color(vfield, 0.130f, 0.173f, 0.263f, 1.0));
@@ -93,8 +96,10 @@ fg_chart setup_vector_field(fg_window window, const vector<af_array>& points,
         T dmin[3], dmax[3];
         FG_CHECK(_.fg_get_chart_axes_limits(
             &cmin[0], &cmax[0], &cmin[1], &cmax[1], &cmin[2], &cmax[2], chart));
-        copyData(dmin, reduce<af_min_t, T, T>(pIn, 1));
-        copyData(dmax, reduce<af_max_t, T, T>(pIn, 1));
+        for (size_t c = 0; c < order; ++c) {
+            dmin[c] = reduce_all<af_min_t, T, T>(pnts[c]);
+            dmax[c] = reduce_all<af_max_t, T, T>(pnts[c]);
+        }
 
         if (cmin[0] == 0 && cmax[0] == 0 && cmin[1] == 0 && cmax[1] == 0 &&
             cmin[2] == 0 && cmax[2] == 0) {
@@ -103,14 +108,14 @@ fg_chart setup_vector_field(fg_window window, const vector<af_array>& points,
             cmax[0] = step_round(dmax[0], true);
             cmin[1] = step_round(dmin[1], false);
             cmax[1] = step_round(dmax[1], true);
-            if (pIn.dims()[0] == 3) { cmin[2] = step_round(dmin[2], false); }
-            if (pIn.dims()[0] == 3) { cmax[2] = step_round(dmax[2], true); }
+            if (order == 3) { cmin[2] = step_round(dmin[2], false); }
+            if (order == 3) { cmax[2] = step_round(dmax[2], true); }
         } else {
             if (cmin[0] > dmin[0]) { cmin[0] = step_round(dmin[0], false); }
             if (cmax[0] < dmax[0]) { cmax[0] = step_round(dmax[0], true); }
             if (cmin[1] > dmin[1]) { cmin[1] = step_round(dmin[1], false); }
             if (cmax[1] < dmax[1]) { cmax[1] = step_round(dmax[1], true); }
-            if (pIn.dims()[0] == 3) {
+            if (order == 3) {
                 if (cmin[2] > dmin[2]) { cmin[2] = step_round(dmin[2], false); }
                 if (cmax[2] < dmax[2]) { cmax[2] = step_round(dmax[2], true); }
             }
@@ -118,7 +123,7 @@ fg_chart setup_vector_field(fg_window window, const vector<af_array>& points,
         FG_CHECK(_.fg_set_chart_axes_limits(chart, cmin[0], cmax[0], cmin[1],
                                             cmax[1], cmin[2], cmax[2]));
     }
-    copy_vector_field<T>(pIn, dIn, vfield);
+    copy_vector_field<T>(pnts, dirs, vfield);
 
     return chart;
 }
@@ -397,6 +402,7 @@ af_err vectorFieldWrapper(const af_window window, const af_array xPoints,
 af_err af_draw_vector_field_nd(const af_window wind, const af_array points,
                                const af_array directions,
                                const af_cell* const props) {
+    AF_API_RANGE_ARRAY(points);
     return vectorFieldWrapper(wind, points, directions, props);
 }
 
@@ -405,6 +411,7 @@ af_err af_draw_vector_field_3d(const af_window wind, const af_array xPoints,
                                const af_array xDirs, const af_array yDirs,
                                const af_array zDirs,
                                const af_cell* const props) {
+    AF_API_RANGE_ARRAY(xPoints);
     return vectorFieldWrapper(wind, xPoints, yPoints, zPoints, xDirs, yDirs,
                               zDirs, props);
 }
@@ -413,5 +420,6 @@ af_err af_draw_vector_field_2d(const af_window wind, const af_array xPoints,
                                const af_array yPoints, const af_array xDirs,
                                const af_array yDirs,
                                const af_cell* const props) {
+    AF_API_RANGE_ARRAY(xPoints);
     return vectorFieldWrapper(wind, xPoints, yPoints, xDirs, yDirs, props);
 }
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
@@ -31,6 +32,7 @@ static inline af_array where(const af_array in) {
 }
 
 af_err af_where(af_array* idx, const af_array in) {
+    AF_API_RANGE_ARRAY(in);
     try {
         const ArrayInfo& i_info = getInfo(in);
         af_dtype type           = i_info.getType();
@@ -61,3 +63,45 @@ af_err af_where(af_array* idx, const af_array in) {
 
     return AF_SUCCESS;
 }
+
+template<typename T>
+static inline af_array compact(const af_array in, const af_array mask) {
+    return getHandle(compact<T>(getArray<T>(in), getArray<char>(mask)));
+}
+
+af_err af_compact(af_array* out, const af_array in, const af_array mask) {
+    AF_API_RANGE_ARRAY(in);
+    try {
+        const ArrayInfo& i_info = getInfo(in);
+        const ArrayInfo& m_info = getInfo(mask);
+        af_dtype type           = i_info.getType();
+
+        ARG_ASSERT(2, m_info.getType() == b8);
+        DIM_ASSERT(2, m_info.dims() == i_info.dims());
+
+        if (i_info.ndims() == 0) {
+            return af_create_handle(out, 0, nullptr, type);
+        }
+
+        af_array res;
+        switch (type) {
+            case f32: res = compact<float>(in, mask); break;
+            case f64: res = compact<double>(in, mask); break;
+            case c32: res = compact<cfloat>(in, mask); break;
+            case c64: res = compact<cdouble>(in, mask); break;
+            case s32: res = compact<int>(in, mask); break;
+            case u32: res = compact<uint>(in, mask); break;
+            case s64: res = compact<intl>(in, mask); break;
+            case u64: res = compact<uintl>(in, mask); break;
+            case s16: res = compact<short>(in, mask); break;
+            case u16: res = compact<ushort>(in, mask); break;
+            case u8: res = compact<uchar>(in, mask); break;
+            case b8: res = compact<char>(in, mask); break;
+            default: TYPE_ERROR(1, type);
+        }
+        swap(*out, res);
+    }
+    CATCHALL
+
+    return AF_SUCCESS;
+}
@@ -10,6 +10,7 @@
 #include <af/algorithm.h>
 #include <af/graphics.h>
 
+#include <api_range.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
 #include <common/graphics_common.hpp>
@@ -20,6 +21,7 @@ using namespace graphics;
 
 af_err af_create_window(af_window* out, const int width, const int height,
                         const char* const title) {
+    AF_API_RANGE();
     try {
         fg_window temp = forgeManager().getWindow(width, height, title, false);
         std::swap(*out, temp);
@@ -30,6 +32,7 @@ af_err af_create_window(af_window* out, const int width, const int height,
 
 af_err af_set_position(const af_window wind, const unsigned x,
                        const unsigned y) {
+    AF_API_RANGE();
     try {
         if (wind == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
         FG_CHECK(forgePlugin().fg_set_window_position(wind, x, y));
@@ -39,6 +42,7 @@ af_err af_set_position(const af_window wind, const unsigned x,
 }
 
 af_err af_set_title(const af_window wind, const char* const title) {
+    AF_API_RANGE();
     try {
         if (wind == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
         FG_CHECK(forgePlugin().fg_set_window_title(wind, title));
@@ -48,6 +52,7 @@ af_err af_set_title(const af_window wind, const char* const title) {
 }
 
 af_err af_set_size(const af_window wind, const unsigned w, const unsigned h) {
+    AF_API_RANGE();
     try {
         if (wind == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
         FG_CHECK(forgePlugin().fg_set_window_size(wind, w, h));
@@ -57,6 +62,7 @@ af_err af_set_size(const af_window wind, const unsigned w, const unsigned h) {
 }
 
 af_err af_grid(const af_window wind, const int rows, const int cols) {
+    AF_API_RANGE();
     try {
         if (wind == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
         forgeManager().setWindowChartGrid(wind, rows, cols);
@@ -69,6 +75,7 @@ af_err af_set_axes_limits_compute(const af_window window, const af_array x,
                                   const af_array y, const af_array z,
                                   const bool exact,
                                   const af_cell* const props) {
+    AF_API_RANGE_ARRAY(x);
     try {
         if (window == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
 
@@ -118,6 +125,7 @@ af_err af_set_axes_limits_2d(const af_window window, const float xmin,
                              const float xmax, const float ymin,
                              const float ymax, const bool exact,
                              const af_cell* const props) {
+    AF_API_RANGE();
     try {
         if (window == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
 
@@ -159,6 +167,7 @@ af_err af_set_axes_limits_3d(const af_window window, const float xmin,
                              const float ymax, const float zmin,
                              const float zmax, const bool exact,
                              const af_cell* const props) {
+    AF_API_RANGE();
     try {
         if (window == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
 
@@ -202,6 +211,7 @@ af_err af_set_axes_limits_3d(const af_window window, const float xmin,
 af_err af_set_axes_titles(const af_window window, const char* const xtitle,
                           const char* const ytitle, const char* const ztitle,
                           const af_cell* const props) {
+    AF_API_RANGE();
     try {
         if (window == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
 
@@ -229,6 +239,7 @@ af_err af_set_axes_label_format(const af_window window,
                                 const char* const yformat,
                                 const char* const zformat,
                                 const af_cell* const props) {
+    AF_API_RANGE();
     try {
         if (window == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
 
@@ -261,6 +272,7 @@ af_err af_set_axes_label_format(const af_window window,
 }
 
 af_err af_show(const af_window wind) {
+    AF_API_RANGE();
     try {
         if (wind == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
         FG_CHECK(forgePlugin().fg_swap_window_buffers(wind));
@@ -270,6 +282,7 @@ af_err af_show(const af_window wind) {
 }
 
 af_err af_is_window_closed(bool* out, const af_window wind) {
+    AF_API_RANGE();
     try {
         if (wind == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
         FG_CHECK(forgePlugin().fg_close_window(out, wind));
@@ -279,6 +292,7 @@ af_err af_is_window_closed(bool* out, const af_window wind) {
 }
 
 af_err af_set_visibility(const af_window wind, const bool is_visible) {
+    AF_API_RANGE();
     try {
         if (wind == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
         if (is_visible) {
@@ -292,6 +306,7 @@ af_err af_set_visibility(const af_window wind, const bool is_visible) {
 }
 
 af_err af_destroy_window(const af_window wind) {
+    AF_API_RANGE();
     try {
         if (wind == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
         forgeManager().setWindowChartGrid(wind, 0, 0);
@@ -0,0 +1,22 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <backend.hpp>
+#include <platform.hpp>
+
+/// Calls \p func with \p device as the active device, so that the arrays
+/// created and released by \p func are on \p device
+template<typename Func>
+void withDevice(const int device, Func &&func) {
+    const int oldDevice = detail::setDevice(device);
+    func();
+    detail::setDevice(oldDevice);
+}
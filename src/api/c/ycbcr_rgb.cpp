@@ -7,11 +7,11 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <api_range.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
-#include <join.hpp>
 #include <math.hpp>
 #include <af/defines.h>
 #include <af/dim4.hpp>
@@ -20,108 +20,78 @@
 using af::dim4;
 using detail::arithOp;
 using detail::Array;
-using detail::createValueArray;
-using detail::join;
+using detail::createHostDataArray;
 using detail::scalar;
 
+/// Returns the output channels k = 0, 1, 2 of
+/// m[k][0] in_0 + m[k][1] in_1 + m[k][2] in_2 + offset[k], where in_c is the
+/// channel c of \p input. The coefficients of the output channels are
+/// arrays of 1 x 1 x 3 which are broadcast with the input channels, so all
+/// the output channels are written by one JIT kernel.
 template<typename T>
-static Array<T> mix(const Array<T>& X, const Array<T>& Y, double xf,
-                    double yf) {
-    const dim4& dims = X.dims();
-    Array<T> xf_cnst = createValueArray<T>(dims, xf);
-    Array<T> yf_cnst = createValueArray<T>(dims, yf);
+static Array<T> mixChannels(const Array<T>& input, const double m[3][3],
+                            const double offset[3]) {
+    dim4 dims = input.dims();
+    dims[2]   = 3;
+    const dim4 cdims(1, 1, 3, 1);
 
-    Array<T> fX = arithOp<T, af_mul_t>(xf_cnst, X, dims);
-    Array<T> fY = arithOp<T, af_mul_t>(yf_cnst, Y, dims);
+    T values[3];
+    for (int k = 0; k < 3; ++k) { values[k] = scalar<T>(offset[k]); }
+    Array<T> res = createHostDataArray<T>(cdims, values);
 
-    return arithOp<T, af_add_t>(fX, fY, dims);
-}
-
-template<typename T>
-static Array<T> mix(const Array<T>& X, const Array<T>& Y, const Array<T>& Z,
-                    double xf, double yf, double zf) {
-    const dim4& dims = X.dims();
-    Array<T> xf_cnst = createValueArray<T>(dims, xf);
-    Array<T> yf_cnst = createValueArray<T>(dims, yf);
-    Array<T> zf_cnst = createValueArray<T>(dims, zf);
-
-    Array<T> fX = arithOp<T, af_mul_t>(xf_cnst, X, dims);
-    Array<T> fY = arithOp<T, af_mul_t>(yf_cnst, Y, dims);
-    Array<T> fZ = arithOp<T, af_mul_t>(zf_cnst, Z, dims);
-
-    Array<T> fx_fy = arithOp<T, af_add_t>(fX, fY, dims);
-    return arithOp<T, af_add_t>(fx_fy, fZ, dims);
-}
-
-template<typename T>
-static Array<T> digitize(const Array<T> ch, const double scale,
-                         const double offset) {
-    const dim4& dims = ch.dims();
-    Array<T> base    = createValueArray<T>(dims, scalar<T>(offset));
-    Array<T> cnst    = createValueArray<T>(dims, scalar<T>(scale));
-    Array<T> scl     = arithOp<T, af_mul_t>(ch, cnst, dims);
-    return arithOp<T, af_add_t>(scl, base, dims);
+    std::vector<af_seq> indices(4, af_span);
+    for (int c = 0; c < 3; ++c) {
+        for (int k = 0; k < 3; ++k) { values[k] = scalar<T>(m[k][c]); }
+        indices[2]       = {double(c), double(c), 1};
+        Array<T> channel = createSubArray(input, indices, false);
+        Array<T> coeffs  = createHostDataArray<T>(cdims, values);
+        Array<T> term    = arithOp<T, af_mul_t>(channel, coeffs, dims);
+        res              = arithOp<T, af_add_t>(res, term, dims);
+    }
+    return res;
 }
 
 template<typename T, bool isYCbCr2RGB>
 static af_array convert(const af_array& in, const af_ycc_std standard) {
-    static const float INV_219 = 0.004566210;
-    static const float INV_112 = 0.008928571;
-    const static float k[6]    = {0.1140f, 0.2990f, 0.0722f,
-                               0.2126f, 0.0593f, 0.2627f};
-    unsigned stdIdx            = 0;  // Default standard is AF_YCC_601
+    static const double INV_219 = 0.004566210;
+    static const double INV_112 = 0.008928571;
+    const static double k[6]    = {0.1140, 0.2990, 0.0722,
+                                0.2126, 0.0593, 0.2627};
+    unsigned stdIdx             = 0;  // Default standard is AF_YCC_601
     switch (standard) {
         case AF_YCC_709: stdIdx = 2; break;
         case AF_YCC_2020: stdIdx = 4; break;
         default: stdIdx = 0; break;
     }
-    float kb    = k[stdIdx];
-    float kr    = k[stdIdx + 1];
-    float kl    = 1.0f - kb - kr;
-    float invKl = 1 / kl;
+    double kb    = k[stdIdx];
+    double kr    = k[stdIdx + 1];
+    double kl    = 1.0 - kb - kr;
+    double invKl = 1 / kl;
 
-    // extract three channels as three slices
-    // prepare sequence objects
-    // get Array objects for corresponding channel views
     const Array<T> input = getArray<T>(in);
-    std::vector<af_seq> indices(4, af_span);
-
-    indices[2] = {0, 0, 1};
-    Array<T> X = createSubArray(input, indices, false);
-
-    indices[2] = {1, 1, 1};
-    Array<T> Y = createSubArray(input, indices, false);
-
-    indices[2] = {2, 2, 1};
-    Array<T> Z = createSubArray(input, indices, false);
 
     if (isYCbCr2RGB) {
-        const dim4& dims = X.dims();
-        Array<T> yc      = createValueArray<T>(dims, 16);
-        Array<T> cc      = createValueArray<T>(dims, 128);
-        Array<T> Y_      = arithOp<T, af_sub_t>(X, yc, dims);
-        Array<T> Cb_     = arithOp<T, af_sub_t>(Y, cc, dims);
-        Array<T> Cr_     = arithOp<T, af_sub_t>(Z, cc, dims);
-        Array<T> R       = mix<T>(Y_, Cr_, INV_219, INV_112 * (1 - kr));
-        Array<T> G =
-            mix<T>(Y_, Cr_, Cb_, INV_219, INV_112 * (kr - 1) * kr * invKl,
-                   INV_112 * (kb - 1) * kb * invKl);
-        Array<T> B = mix<T>(Y_, Cb_, INV_219, INV_112 * (1 - kb));
-        // join channels
-        Array<T> RG = join<T>(2, R, G);
-        return getHandle(join<T>(2, RG, B));
+        // The input channels are Y, Cb and Cr, which are offset by 16, 128
+        // and 128
+        const double m[3][3] = {
+            {INV_219, 0, INV_112 * (1 - kr)},
+            {INV_219, INV_112 * (kb - 1) * kb * invKl,
+             INV_112 * (kr - 1) * kr * invKl},
+            {INV_219, INV_112 * (1 - kb), 0}};
+        double offset[3];
+        for (int i = 0; i < 3; ++i) {
+            offset[i] = -(16 * m[i][0] + 128 * m[i][1] + 128 * m[i][2]);
+        }
+        return getHandle(mixChannels<T>(input, m, offset));
     }
-    Array<T> Ey = mix<T>(X, Y, Z, kr, kl, kb);
-    Array<T> Ecr =
-        mix<T>(X, Y, Z, 0.5, 0.5 * kl / (kr - 1), 0.5 * kb / (kr - 1));
-    Array<T> Ecb =
-        mix<T>(X, Y, Z, 0.5 * kr / (kb - 1), 0.5 * kl / (kb - 1), 0.5);
-    Array<T> Y_ = digitize<T>(Ey, 219.0, 16.0);
-    Array<T> Cr = digitize<T>(Ecr, 224.0, 128.0);
-    Array<T> Cb = digitize<T>(Ecb, 224.0, 128.0);
-    // join channels
-    Array<T> YCb = join<T>(2, Y_, Cb);
-    return getHandle(join<T>(2, YCb, Cr));
+    // The output channels are Y, Cb and Cr, which are digitized with the
+    // scales 219, 224 and 224 and the offsets 16, 128 and 128
+    const double m[3][3] = {
+        {219 * kr, 219 * kl, 219 * kb},
+        {224 * 0.5 * kr / (kb - 1), 224 * 0.5 * kl / (kb - 1), 224 * 0.5},
+        {224 * 0.5, 224 * 0.5 * kl / (kr - 1), 224 * 0.5 * kb / (kr - 1)}};
+    const double offset[3] = {16, 128, 128};
+    return getHandle(mixChannels<T>(input, m, offset));
 }
 
 template<bool isYCbCr2RGB>
@@ -149,10 +119,12 @@ af_err convert(af_array* out, const af_array& in, const af_ycc_std standard) {
 
 af_err af_ycbcr2rgb(af_array* out, const af_array in,
                     const af_ycc_std standard) {
+    AF_API_RANGE_ARRAY(in);
     return convert<true>(out, in, standard);
 }
 
 af_err af_rgb2ycbcr(af_array* out, const af_array in,
                     const af_ycc_std standard) {
+    AF_API_RANGE_ARRAY(in);
     return convert<false>(out, in, standard);
 }
@@ -45,4 +45,31 @@ array approx2(const array &zi, const array &xo, const int xdim,
                                 offGrid));
     return array(zo);
 }
+interpPlan::interpPlan(const array &pos, const dim_t inLength,
+                       const interpType method, const float offGrid)
+    : plan_{} {
+    AF_THROW(
+        af_create_approx1_plan(&plan_, pos.get(), inLength, method, offGrid));
+}
+
+interpPlan::interpPlan(const array &pos0, const array &pos1,
+                       const dim_t inRows, const dim_t inCols,
+                       const interpType method, const float offGrid)
+    : plan_{} {
+    AF_THROW(af_create_approx2_plan(&plan_, pos0.get(), pos1.get(), inRows,
+                                    inCols, method, offGrid));
+}
+
+interpPlan::~interpPlan() {
+    // No dtor throw
+    if (plan_) { af_release_interp_plan(plan_); }
+}
+
+af_interp_plan interpPlan::get() const { return plan_; }
+
+array interpPlan::apply(const array &in) const {
+    af_array out = 0;
+    AF_THROW(af_apply_interp_plan(&out, plan_, in.get()));
+    return array(out);
+}
 }  // namespace af
@@ -14,6 +14,7 @@
 #include <af/blas.h>
 #include <af/data.h>
 #include <af/device.h>
+#include <af/event.h>
 #include <af/gfor.h>
 #include <af/half.h>
 #include <af/index.h>
@@ -242,6 +243,7 @@ INSTANTIATE(unsigned long long)
 INSTANTIATE(short)
 INSTANTIATE(unsigned short)
 INSTANTIATE(af_half)
+INSTANTIATE(af_bfloat16)
 INSTANTIATE(half_float::half)
 #ifdef AF_CUDA
 INSTANTIATE(__half);
@@ -313,6 +315,26 @@ dim_t array::elements() const {
 
 void array::host(void *ptr) const { AF_THROW(af_get_data_ptr(ptr, get())); }
 
+event array::hostAsync(void *ptr) const {
+    af_event e = nullptr;
+    AF_THROW(af_get_data_ptr_async(&e, ptr, get()));
+    return event(e);
+}
+
+event array::writeAsync(const void *ptr, const size_t bytes, af::source src) {
+    af_event e = nullptr;
+    AF_THROW(af_write_array_async(&e, get(), ptr, bytes, src));
+    return event(e);
+}
+
+event array::copyToDevice(array &out, const int device) const {
+    af_event e   = nullptr;
+    af_array res = nullptr;
+    AF_THROW(af_copy_to_device(&e, &res, get(), device));
+    out = array(res);
+    return event(e);
+}
+
 af_array array::get() { return arr; }
 
 af_array array::get() const { return const_cast<array *>(this)->get(); }
@@ -889,9 +911,10 @@ af::dtype implicit_dtype(af::dtype scalar_type, af::dtype array_type) {
         return array_type;
     }
 
-    // If the array is f16 then avoid upcasting to float or double
-    if ((scalar_type == f64 || scalar_type == f32) && (array_type == f16)) {
-        return f16;
+    // If the array is f16 or bf16 then avoid upcasting to float or double
+    if ((scalar_type == f64 || scalar_type == f32) &&
+        (array_type == f16 || array_type == bf16)) {
+        return array_type;
     }
 
     // Default to single precision by default when multiplying with scalar
@@ -1044,6 +1067,7 @@ INSTANTIATE(unsigned long long)
 INSTANTIATE(short)
 INSTANTIATE(unsigned short)
 INSTANTIATE(af_half)
+INSTANTIATE(af_bfloat16)
 INSTANTIATE(half_float::half)
 
 template<>
@@ -1086,6 +1110,7 @@ INSTANTIATE(unsigned long long)
 INSTANTIATE(short)
 INSTANTIATE(unsigned short)
 INSTANTIATE(af_half)
+INSTANTIATE(af_bfloat16)
 INSTANTIATE(half_float::half)
 
 #undef INSTANTIATE
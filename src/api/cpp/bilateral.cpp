@@ -21,4 +21,12 @@ array bilateral(const array &in, const float spatial_sigma,
     return array(out);
 }
 
+array bilateralGrid(const array &in, const float spatial_sigma,
+                    const float chromatic_sigma, const float sampling) {
+    af_array out = 0;
+    AF_THROW(af_bilateral_grid(&out, in.get(), spatial_sigma, chromatic_sigma,
+                               sampling));
+    return array(out);
+}
+
 }  // namespace af
@@ -9,6 +9,7 @@
 
 #include <af/array.h>
 #include <af/blas.h>
+#include <af/half.h>
 #include "error.hpp"
 
 namespace af {
@@ -37,6 +38,101 @@ array matmulTT(const array &lhs, const array &rhs) {
     return array(out);
 }
 
+array matmul(const array &lhs, const array &rhs, const array &bias,
+             const gemmEpilogue epilogue, const matProp optLhs,
+             const matProp optRhs) {
+    af_array out        = 0;
+    const af_array bptr = bias.isempty() ? 0 : bias.get();
+    switch (lhs.type()) {
+        case f16: {
+            half alpha, beta;
+            alpha.data_ = 0x3C00;  // 1.0 in IEEE 754 half precision
+            beta.data_  = 0;
+            AF_THROW(af_gemm_fused(&out, optLhs, optRhs, &alpha, lhs.get(),
+                                   rhs.get(), &beta, bptr, epilogue));
+            break;
+        }
+        case c32: {
+            cfloat alpha(1.f), beta(0.f);
+            AF_THROW(af_gemm_fused(&out, optLhs, optRhs, &alpha, lhs.get(),
+                                   rhs.get(), &beta, bptr, epilogue));
+            break;
+        }
+        case f64: {
+            double alpha = 1.0, beta = 0.0;
+            AF_THROW(af_gemm_fused(&out, optLhs, optRhs, &alpha, lhs.get(),
+                                   rhs.get(), &beta, bptr, epilogue));
+            break;
+        }
+        case c64: {
+            cdouble alpha(1.0), beta(0.0);
+            AF_THROW(af_gemm_fused(&out, optLhs, optRhs, &alpha, lhs.get(),
+                                   rhs.get(), &beta, bptr, epilogue));
+            break;
+        }
+        default: {
+            float alpha = 1.f, beta = 0.f;
+            AF_THROW(af_gemm_fused(&out, optLhs, optRhs, &alpha, lhs.get(),
+                                   rhs.get(), &beta, bptr, epilogue));
+        }
+    }
+    return array(out);
+}
+
+array matmul(const array &lhs, const array &rhs, const gemmComputeType compute,
+             const matProp optLhs, const matProp optRhs) {
+    af_array out = 0;
+    switch (lhs.type()) {
+        case f16:
+            if (compute == AF_GEMM_COMPUTE_DEFAULT) {
+                half alpha, beta;
+                alpha.data_ = 0x3C00;  // 1.0 in IEEE 754 half precision
+                beta.data_  = 0;
+                AF_THROW(af_gemm_v2(&out, optLhs, optRhs, &alpha, lhs.get(),
+                                    rhs.get(), &beta, compute));
+            } else {
+                // The f16 products accumulated in f32 give an f32 product
+                float alpha = 1.f, beta = 0.f;
+                AF_THROW(af_gemm_v2(&out, optLhs, optRhs, &alpha, lhs.get(),
+                                    rhs.get(), &beta, compute));
+            }
+            break;
+        case c32: {
+            cfloat alpha(1.f), beta(0.f);
+            AF_THROW(af_gemm_v2(&out, optLhs, optRhs, &alpha, lhs.get(),
+                                rhs.get(), &beta, compute));
+            break;
+        }
+        case f64: {
+            double alpha = 1.0, beta = 0.0;
+            AF_THROW(af_gemm_v2(&out, optLhs, optRhs, &alpha, lhs.get(),
+                                rhs.get(), &beta, compute));
+            break;
+        }
+        case c64: {
+            cdouble alpha(1.0), beta(0.0);
+            AF_THROW(af_gemm_v2(&out, optLhs, optRhs, &alpha, lhs.get(),
+                                rhs.get(), &beta, compute));
+            break;
+        }
+        default: {
+            float alpha = 1.f, beta = 0.f;
+            AF_THROW(af_gemm_v2(&out, optLhs, optRhs, &alpha, lhs.get(),
+                                rhs.get(), &beta, compute));
+        }
+    }
+    return array(out);
+}
+
+array matmulQuantized(const array &lhs, const array &rhs, const int lhsZero,
+                      const int rhsZero, const matProp optLhs,
+                      const matProp optRhs) {
+    af_array out = 0;
+    AF_THROW(af_matmul_quantized(&out, lhs.get(), rhs.get(), lhsZero, rhsZero,
+                                 optLhs, optRhs));
+    return array(out);
+}
+
 array matmul(const array &a, const array &b, const array &c) {
     dim_t tmp1 = a.dims(0) * b.dims(1);
     dim_t tmp2 = b.dims(0) * c.dims(1);
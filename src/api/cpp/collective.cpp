@@ -0,0 +1,60 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/array.h>
+#include <af/event.h>
+#include "error.hpp"
+
+#include <vector>
+
+using std::vector;
+
+namespace af {
+
+void scatter(array *outs, const array &in, const int dim,
+             const unsigned num_devices, const int *devices, event *events) {
+    vector<af_array> res(num_devices, 0);
+    vector<af_event> e(num_devices, 0);
+    AF_THROW(af_scatter(events ? e.data() : NULL, res.data(), in.get(), dim,
+                        num_devices, devices));
+    for (unsigned i = 0; i < num_devices; ++i) {
+        outs[i] = array(res[i]);
+        if (events) { events[i] = event(e[i]); }
+    }
+}
+
+array gather(const unsigned num_arrays, const array *ins, const int dim,
+             const int device, event *done) {
+    vector<af_array> inputs(num_arrays);
+    for (unsigned i = 0; i < num_arrays; ++i) { inputs[i] = ins[i].get(); }
+
+    af_array out = 0;
+    af_event e   = 0;
+    AF_THROW(af_gather(done ? &e : NULL, &out, num_arrays, inputs.data(), dim,
+                       device));
+    if (done) { *done = event(e); }
+    return array(out);
+}
+
+void allReduce(array *outs, const unsigned num_arrays, const array *ins,
+               const binaryOp op, event *events) {
+    vector<af_array> inputs(num_arrays);
+    for (unsigned i = 0; i < num_arrays; ++i) { inputs[i] = ins[i].get(); }
+
+    vector<af_array> res(num_arrays, 0);
+    vector<af_event> e(num_arrays, 0);
+    AF_THROW(af_all_reduce(events ? e.data() : NULL, res.data(), num_arrays,
+                           inputs.data(), op));
+    for (unsigned i = 0; i < num_arrays; ++i) {
+        outs[i] = array(res[i]);
+        if (events) { events[i] = event(e[i]); }
+    }
+}
+
+}  // namespace af
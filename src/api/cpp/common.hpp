@@ -7,7 +7,10 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <common/defines.hpp>
 #include <af/dim4.hpp>
+#include <af/exception.h>
+#include <af/gfor.h>
 #include <af/half.h>
 
 #pragma GCC diagnostic push
@@ -24,11 +27,18 @@
 namespace af {
 
 /// Get the first non-zero dimension
+///
+/// The fourth dimension holds the batch inside vmap, so it is not used
 static inline dim_t getFNSD(const int dim, af::dim4 dims) {
+    const bool batched = vmapGet();
+    if (batched && dim == 3) {
+        throw af::exception("The batch dimension can not be used inside vmap",
+                            __AF_FILENAME__, __LINE__, AF_ERR_NOT_SUPPORTED);
+    }
     if (dim >= 0) return dim;
 
     dim_t fNSD = 0;
-    for (dim_t i = 0; i < 4; ++i) {
+    for (dim_t i = 0; i < (batched ? 3 : 4); ++i) {
         if (dims[i] > 1) {
             fNSD = i;
             break;
@@ -85,6 +85,14 @@ array convolve3(const array &signal, const array &filter, const convMode mode,
     return array(out);
 }
 
+void exportConvolveTuning(const char *path) {
+    AF_THROW(af_export_convolve_tuning(path));
+}
+
+void importConvolveTuning(const char *path) {
+    AF_THROW(af_import_convolve_tuning(path));
+}
+
 array filter(const array &image, const array &kernel) {
     return convolve(image, kernel, AF_CONV_DEFAULT, AF_CONV_AUTO);
 }
@@ -22,6 +22,7 @@
 #include <af/traits.hpp>
 #include "error.hpp"
 
+#include <algorithm>
 #include <type_traits>
 
 using af::array;
@@ -200,7 +201,19 @@ array diag(const array &in, const int num, const bool extract) {
 
 array moddims(const array &in, const unsigned ndims, const dim_t *const dims) {
     af_array out = 0;
-    AF_THROW(af_moddims(&out, in.get(), ndims, dims));
+    if (vmapGet()) {
+        // Each slice of the batch is reshaped
+        const dim_t batch = in.dims(3);
+        if (ndims > 3 && dims[3] != 1 && dims[3] != batch) {
+            AF_THROW_ERR("The batch dimension can not be used inside vmap",
+                         AF_ERR_NOT_SUPPORTED);
+        }
+        dim_t sliceDims[4] = {1, 1, 1, batch};
+        std::copy(dims, dims + std::min(ndims, 3U), sliceDims);
+        AF_THROW(af_moddims(&out, in.get(), 4, sliceDims));
+    } else {
+        AF_THROW(af_moddims(&out, in.get(), ndims, dims));
+    }
     return array(out);
 }
 
@@ -215,12 +228,15 @@ array moddims(const array &in, const dim_t d0, const dim_t d1, const dim_t d2,
 }
 
 array flat(const array &in) {
+    // Each slice of the batch is flattened inside vmap
+    if (vmapGet()) { return moddims(in, in.elements() / in.dims(3)); }
     af_array out = 0;
     AF_THROW(af_flat(&out, in.get()));
     return array(out);
 }
 
 array join(const int dim, const array &first, const array &second) {
+    VMAP_CHECK_DIM(dim);
     af_array out = 0;
     AF_THROW(af_join(&out, dim, first.get(), second.get()));
     return array(out);
@@ -228,6 +244,7 @@ array join(const int dim, const array &first, const array &second) {
 
 array join(const int dim, const array &first, const array &second,
            const array &third) {
+    VMAP_CHECK_DIM(dim);
     af_array out       = 0;
     af_array inputs[3] = {first.get(), second.get(), third.get()};
     AF_THROW(af_join_many(&out, dim, 3, inputs));
@@ -236,6 +253,7 @@ array join(const int dim, const array &first, const array &second,
 
 array join(const int dim, const array &first, const array &second,
            const array &third, const array &fourth) {
+    VMAP_CHECK_DIM(dim);
     af_array out       = 0;
     af_array inputs[4] = {first.get(), second.get(), third.get(), fourth.get()};
     AF_THROW(af_join_many(&out, dim, 4, inputs));
@@ -244,12 +262,14 @@ array join(const int dim, const array &first, const array &second,
 
 array tile(const array &in, const unsigned x, const unsigned y,
            const unsigned z, const unsigned w) {
+    if (w != 1) { VMAP_UNSUPPORTED(); }
     af_array out = 0;
     AF_THROW(af_tile(&out, in.get(), x, y, z, w));
     return array(out);
 }
 
 array tile(const array &in, const af::dim4 &dims) {
+    if (dims[3] != 1) { VMAP_UNSUPPORTED(); }
     af_array out = 0;
     AF_THROW(af_tile(&out, in.get(), dims[0], dims[1], dims[2], dims[3]));
     return array(out);
@@ -257,6 +277,7 @@ array tile(const array &in, const af::dim4 &dims) {
 
 array reorder(const array &in, const unsigned x, const unsigned y,
               const unsigned z, const unsigned w) {
+    if (w != 3) { VMAP_UNSUPPORTED(); }
     af_array out = 0;
     AF_THROW(af_reorder(&out, in.get(), x, y, z, w));
     return array(out);
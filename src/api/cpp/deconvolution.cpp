@@ -21,6 +21,17 @@ array iterativeDeconv(const array& in, const array& ker,
     return array(temp);
 }
 
+array iterativeDeconv(const array& in, const array& ker,
+                      const unsigned maxIterations, const float relaxFactor,
+                      const iterativeDeconvAlgo algo, const double tol,
+                      const unsigned checkInterval, unsigned* iterations) {
+    af_array temp = 0;
+    AF_THROW(af_iterative_deconv_v2(&temp, iterations, in.get(), ker.get(),
+                                    maxIterations, relaxFactor, algo, tol,
+                                    checkInterval));
+    return array(temp);
+}
+
 array inverseDeconv(const array& in, const array& psf, const float gamma,
                     const inverseDeconvAlgo algo) {
     af_array temp = 0;
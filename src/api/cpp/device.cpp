@@ -141,6 +141,14 @@ void freePinned(const void *ptr) {
     AF_THROW(af_free_pinned((void *)ptr));
 }
 
+void registerHostMemory(void *ptr, const size_t bytes) {
+    AF_THROW(af_register_host_memory(ptr, bytes));
+}
+
+void unregisterHostMemory(void *ptr) {
+    AF_THROW(af_unregister_host_memory(ptr));
+}
+
 void *allocHost(const size_t elements, const af::dtype type) {
     void *ptr;
     AF_THROW(af_alloc_host(&ptr, elements * size_of(type)));
@@ -171,6 +179,72 @@ size_t getMemStepSize() {
     return size_bytes;
 }
 
+void setJitHeuristic(af_jit_heuristic_fn fn, void *user_data) {
+    AF_THROW(af_set_jit_heuristic(fn, user_data));
+}
+
+af_jit_stats getJitStats(const int device) {
+    af_jit_stats stats;
+    AF_THROW(af_get_jit_stats(&stats, device));
+    return stats;
+}
+
+void resetJitStats(const int device) { AF_THROW(af_reset_jit_stats(device)); }
+
+unsigned prewarmKernels() {
+    unsigned num_modules = 0;
+    AF_THROW(af_prewarm_kernels(&num_modules));
+    return num_modules;
+}
+
+af_kernel_batch prewarmKernelsAsync(const int device) {
+    af_kernel_batch batch = nullptr;
+    AF_THROW(af_prewarm_kernels_async(&batch, nullptr, 0, device));
+    return batch;
+}
+
+unsigned waitKernels(af_kernel_batch batch) {
+    unsigned num_modules = 0;
+    af_err err           = af_wait_kernel_batch(&num_modules, batch);
+    af_release_kernel_batch(batch);
+    AF_THROW(err);
+    return num_modules;
+}
+
+void setMemStatsEnabled(const bool enabled) {
+    AF_THROW(af_set_mem_stats_enabled(enabled));
+}
+
+af_mem_stats getMemStats(const int device) {
+    af_mem_stats stats;
+    AF_THROW(af_get_mem_stats(&stats, device));
+    return stats;
+}
+
+memoryScope::memoryScope(const size_t bytes) {
+    AF_THROW(af_begin_memory_scope(bytes));
+}
+
+// Destructors cannot throw
+memoryScope::~memoryScope() { af_end_memory_scope(); }
+
+void setPrecisionMode(const precisionMode mode) {
+    AF_THROW(af_set_precision_mode(mode));
+}
+
+precisionMode getPrecisionMode() {
+    af_precision_mode mode = AF_PRECISION_DEFAULT;
+    AF_THROW(af_get_precision_mode(&mode));
+    return mode;
+}
+
+precisionScope::precisionScope(const precisionMode mode) {
+    AF_THROW(af_begin_precision_scope(mode));
+}
+
+// Destructors cannot throw
+precisionScope::~precisionScope() { af_end_precision_scope(); }
+
 AF_DEPRECATED_WARNINGS_OFF
 #define INSTANTIATE(T)                                                        \
     template<>                                                                \
@@ -10,6 +10,7 @@
 #include <common/defines.hpp>
 #include <af/device.h>
 #include <af/exception.h>
+#include <af/gfor.h>
 
 #define AF_THROW(fn)                                                          \
     do {                                                                      \
@@ -27,3 +28,23 @@
         throw af::exception(__msg, __AF_FUNC__, __AF_FILENAME__, __LINE__, \
                             __err);                                        \
     } while (0)
+
+/// Throws when the function called by af::vmap uses the dimension \p dim
+/// which holds its batch
+#define VMAP_CHECK_DIM(dim)                                                 \
+    do {                                                                    \
+        if (af::vmapGet() && (dim) == 3) {                                  \
+            AF_THROW_ERR("The batch dimension can not be used inside vmap", \
+                         AF_ERR_NOT_SUPPORTED);                             \
+        }                                                                   \
+    } while (0)
+
+/// Throws when a function which mixes the slices of the batch is called by
+/// af::vmap
+#define VMAP_UNSUPPORTED()                                             \
+    do {                                                               \
+        if (af::vmapGet()) {                                           \
+            AF_THROW_ERR("This function is not supported inside vmap", \
+                         AF_ERR_NOT_SUPPORTED);                        \
+        }                                                              \
+    } while (0)
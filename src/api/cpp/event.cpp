@@ -40,4 +40,10 @@ void event::enqueue() { AF_THROW(af_enqueue_wait_event(e_)); }
 
 void event::block() const { AF_THROW(af_block_event(e_)); }
 
+float event::elapsed(const event& start) const {
+    float ms = 0.f;
+    AF_THROW(af_event_elapsed_time(&ms, start.e_, e_));
+    return ms;
+}
+
 }  // namespace af
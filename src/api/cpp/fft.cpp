@@ -264,4 +264,12 @@ FFT_REAL(3)
 void setFFTPlanCacheSize(size_t cacheSize) {
     AF_THROW(af_set_fft_plan_cache_size(cacheSize));
 }
+
+void setFFTPlanCacheBytes(size_t cacheBytes) {
+    AF_THROW(af_set_fft_plan_cache_bytes(cacheBytes));
+}
+
+void prepareFFTPlan(const dim4 &dims, const int rank, const dtype type) {
+    AF_THROW(af_prepare_fft_plan(dims.ndims(), dims.get(), rank, type));
+}
 }  // namespace af
@@ -34,6 +34,34 @@ array fftConvolve1(const array& signal, const array& filter,
     return array(out);
 }
 
+array fftConvolve1Block(const array& signal, const array& filter,
+                        const dim_t blockSize, const convMode mode) {
+    af_array out = 0;
+    AF_THROW(af_fft_convolve1_block(&out, signal.get(), filter.get(),
+                                    blockSize, mode));
+    return array(out);
+}
+
+convolveStream::convolveStream(const array& filter, const dim_t blockSize)
+    : stream_{} {
+    AF_THROW(af_create_convolve_stream(&stream_, filter.get(), blockSize));
+}
+
+convolveStream::~convolveStream() {
+    // No dtor throw
+    if (stream_) { af_release_convolve_stream(stream_); }
+}
+
+af_convolve_stream convolveStream::get() const { return stream_; }
+
+array convolveStream::push(const array& chunk) {
+    af_array out = 0;
+    AF_THROW(af_convolve_stream_push(&out, stream_, chunk.get()));
+    return array(out);
+}
+
+void convolveStream::reset() { AF_THROW(af_convolve_stream_reset(stream_)); }
+
 array fftConvolve2(const array& signal, const array& filter,
                    const convMode mode) {
     af_array out = 0;
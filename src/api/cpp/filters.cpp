@@ -49,4 +49,18 @@ array maxfilt(const array& in, const dim_t wind_length, const dim_t wind_width,
     return array(out);
 }
 
+array boxFilter(const array& in, const dim_t wind_length,
+                const dim_t wind_width) {
+    af_array out = 0;
+    AF_THROW(af_box_filter(&out, in.get(), wind_length, wind_width));
+    return array(out);
+}
+
+array gaussianFilter(const array& in, const double sigma_r,
+                     const double sigma_c) {
+    af_array out = 0;
+    AF_THROW(af_gaussian_filter(&out, in.get(), sigma_r, sigma_c));
+    return array(out);
+}
+
 }  // namespace af
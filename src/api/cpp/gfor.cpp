@@ -8,12 +8,15 @@
  ********************************************************/
 
 #include <af/array.h>
+#include <af/data.h>
 #include <af/defines.h>
 #include <af/dim4.hpp>
 #include <af/gfor.h>
 #include <af/seq.h>
 #include "error.hpp"
 
+#include <algorithm>
+
 namespace af {
 
 thread_local bool gforStatus;
@@ -38,4 +41,82 @@ array batchFunc(const array &lhs, const array &rhs, batchFunc_t func) {
     return res;
 }
 
+thread_local bool vmapStatus;
+
+bool vmapGet() { return vmapStatus; }
+
+namespace {
+
+int vmapDim(const array &in, const int dim) {
+    if (dim > 3) { AF_THROW_ERR("Invalid dimension for vmap", AF_ERR_ARG); }
+    return dim < 0 ? std::max(static_cast<int>(in.numdims()) - 1, 0) : dim;
+}
+
+/// Moves the dimension \p dim of \p in to the fourth dimension
+array toBatch(const array &in, const int dim) {
+    if (dim == 3) { return in; }
+    unsigned order[4];
+    for (unsigned i = 0, j = 0; i < 4; ++i) {
+        if (i != static_cast<unsigned>(dim)) { order[j++] = i; }
+    }
+    order[3] = dim;
+    return reorder(in, order[0], order[1], order[2], order[3]);
+}
+
+/// Moves the fourth dimension of \p in to the dimension \p dim
+array fromBatch(const array &in, const int dim) {
+    if (dim == 3) { return in; }
+    unsigned order[4];
+    for (unsigned i = 0, j = 0; i < 4; ++i) {
+        order[i] = i == static_cast<unsigned>(dim) ? 3 : j++;
+    }
+    return reorder(in, order[0], order[1], order[2], order[3]);
+}
+
+template<typename Func>
+array runBatched(Func func, const dim_t batch) {
+    if (gforGet() || vmapGet()) {
+        AF_THROW_ERR("vmap can not be used inside GFOR or vmap", AF_ERR_ARG);
+    }
+    vmapStatus = true;
+    array res;
+    try {
+        res = func();
+    } catch (...) {
+        vmapStatus = false;
+        throw;
+    }
+    vmapStatus = false;
+
+    if (res.dims(3) != batch) {
+        AF_THROW_ERR("The function of vmap must return one result per slice",
+                     AF_ERR_SIZE);
+    }
+    return res;
+}
+
+}  // namespace
+
+array vmap(vmapFunc_t func, const array &in, const int dim) {
+    const int bdim = vmapDim(in, dim);
+    array batched  = toBatch(in, bdim);
+
+    array res = runBatched([&] { return func(batched); }, batched.dims(3));
+    return fromBatch(res, bdim);
+}
+
+array vmap(vmapFunc2_t func, const array &lhs, const array &rhs,
+           const int dim) {
+    const int bdim = vmapDim(lhs, dim);
+    if (lhs.dims(bdim) != rhs.dims(bdim)) {
+        AF_THROW_ERR("The inputs of vmap must have the same number of slices",
+                     AF_ERR_SIZE);
+    }
+    array lbatched = toBatch(lhs, bdim);
+    array rbatched = toBatch(rhs, bdim);
+    array res      = runBatched([&] { return func(lbatched, rbatched); },
+                                lbatched.dims(3));
+    return fromBatch(res, bdim);
+}
+
 }  // namespace af
@@ -0,0 +1,45 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/graph.h>
+#include "error.hpp"
+
+namespace af {
+
+graph::graph(af_graph g) : g_(g) {}
+
+graph::~graph() {
+    // No dtor throw
+    if (g_) { af_release_graph(g_); }
+}
+
+// NOLINTNEXTLINE(performance-noexcept-move-constructor) we can't change the API
+graph::graph(graph&& other) : g_(other.g_) { other.g_ = 0; }
+
+// NOLINTNEXTLINE(performance-noexcept-move-constructor) we can't change the API
+graph& graph::operator=(graph&& other) {
+    af_release_graph(this->g_);
+    this->g_ = other.g_;
+    other.g_ = 0;
+    return *this;
+}
+
+af_graph graph::get() const { return g_; }
+
+void graph::replay() const { AF_THROW(af_replay_graph(g_)); }
+
+void beginCapture() { AF_THROW(af_begin_capture()); }
+
+graph endCapture() {
+    af_graph g = 0;
+    AF_THROW(af_end_capture(&g));
+    return graph(g);
+}
+
+}  // namespace af
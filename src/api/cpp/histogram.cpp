@@ -30,6 +30,24 @@ array histogram(const array& in, const unsigned nbins) {
     return array(out);
 }
 
+array histogram(const array& in, const array& weights, const unsigned nbins,
+                const double minval, const double maxval) {
+    af_array out = 0;
+    AF_THROW(af_histogram_weighted(&out, in.get(), weights.get(), nbins,
+                                   minval, maxval));
+    return array(out);
+}
+
+array histogram2(const array& x, const array& y, const unsigned xbins,
+                 const unsigned ybins, const double xmin, const double xmax,
+                 const double ymin, const double ymax, const array& weights) {
+    const af_array wptr = weights.isempty() ? 0 : weights.get();
+    af_array out        = 0;
+    AF_THROW(af_histogram2(&out, x.get(), y.get(), wptr, xbins, ybins, xmin,
+                           xmax, ymin, ymax));
+    return array(out);
+}
+
 array histequal(const array& in, const array& hist) {
     return histEqual(in, hist);
 }
@@ -39,4 +57,13 @@ array histEqual(const array& in, const array& hist) {
     return array(temp);
 }
 
+array clahe(const array& in, const unsigned gridRows, const unsigned gridCols,
+            const float clipLimit, const unsigned nbins, const double minval,
+            const double maxval) {
+    af_array temp = 0;
+    AF_THROW(af_clahe(&temp, in.get(), gridRows, gridCols, clipLimit, nbins,
+                      minval, maxval));
+    return array(temp);
+}
+
 }  // namespace af
@@ -25,4 +25,19 @@ void homography(array &H, int &inliers, const array &x_src, const array &y_src,
     H = array(outH);
 }
 
+void homographyBatch(array &H, array &inliers, const array &x_src,
+                     const array &y_src, const array &x_dst,
+                     const array &y_dst, const af_homography_type htype,
+                     const float inlier_thr, const unsigned iterations,
+                     const af::dtype otype) {
+    af_array outH       = 0;
+    af_array outInliers = 0;
+    AF_THROW(af_homography_batch(&outH, &outInliers, x_src.get(), y_src.get(),
+                                 x_dst.get(), y_dst.get(), htype, inlier_thr,
+                                 iterations, otype));
+
+    H       = array(outH);
+    inliers = array(outInliers);
+}
+
 }  // namespace af
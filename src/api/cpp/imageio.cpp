@@ -20,6 +20,13 @@ array loadImage(const char* filename, const bool is_color) {
     return array(out);
 }
 
+array loadImages(const char** filenames, const unsigned count,
+                 const bool is_color, const dtype type) {
+    af_array out = 0;
+    AF_THROW(af_load_images(&out, filenames, count, is_color, type));
+    return array(out);
+}
+
 array loadImageMem(const void* ptr) {
     af_array out = 0;
     AF_THROW(af_load_image_memory(&out, ptr));
@@ -53,4 +53,16 @@ bool isOwner(const array &in) {
     return is_owner;
 }
 
+array fromDLPack(void *tensor, void *stream) {
+    af_array res;
+    AF_THROW(af_from_dlpack(&res, tensor, stream));
+    return array(res);
+}
+
+void *toDLPack(const array &in, void *stream) {
+    void *tensor = NULL;
+    AF_THROW(af_to_dlpack(&tensor, in.get(), stream));
+    return tensor;
+}
+
 }  // namespace af
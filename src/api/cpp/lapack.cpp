@@ -28,6 +28,17 @@ void svdInPlace(array &u, array &s, array &vt, array &in) {
     vt = array(vtl);
 }
 
+void svdRandomized(array &u, array &s, array &vt, const array &in,
+                   const unsigned rank, const unsigned oversampling,
+                   const unsigned iterations) {
+    af_array sl = 0, ul = 0, vtl = 0;
+    AF_THROW(af_svd_randomized(&ul, &sl, &vtl, in.get(), rank, oversampling,
+                               iterations));
+    s  = array(sl);
+    u  = array(ul);
+    vt = array(vtl);
+}
+
 void lu(array &out, array &pivot, const array &in, const bool is_lapack_piv) {
     out        = in.copy();
     af_array p = 0;
@@ -97,6 +108,37 @@ array solveLU(const array &a, const array &piv, const array &b,
     return array(out);
 }
 
+array cg(const array &A, const array &b, const double tol,
+         const unsigned maxIterations, const precondType ptype,
+         const array &precond, const array &x0, const unsigned checkInterval,
+         unsigned *iterations) {
+    af_array out;
+    AF_THROW(af_cg(&out, iterations, A.get(), b.get(), tol, maxIterations,
+                   ptype, precond.get(), x0.get(), checkInterval));
+    return array(out);
+}
+
+array bicgstab(const array &A, const array &b, const double tol,
+               const unsigned maxIterations, const precondType ptype,
+               const array &precond, const array &x0,
+               const unsigned checkInterval, unsigned *iterations) {
+    af_array out;
+    AF_THROW(af_bicgstab(&out, iterations, A.get(), b.get(), tol,
+                         maxIterations, ptype, precond.get(), x0.get(),
+                         checkInterval));
+    return array(out);
+}
+
+array gmres(const array &A, const array &b, const double tol,
+            const unsigned maxIterations, const unsigned restart,
+            const precondType ptype, const array &precond, const array &x0,
+            const unsigned checkInterval, unsigned *iterations) {
+    af_array out;
+    AF_THROW(af_gmres(&out, iterations, A.get(), b.get(), tol, maxIterations,
+                      restart, ptype, precond.get(), x0.get(), checkInterval));
+    return array(out);
+}
+
 array inverse(const array &in, const matProp options) {
     af_array out;
     AF_THROW(af_inverse(&out, in.get(), options));
@@ -142,6 +184,26 @@ double norm(const array &in, const normType type, const double p,
     return out;
 }
 
+array detBatched(const array &in) {
+    af_array out = 0;
+    AF_THROW(af_det_batched(&out, in.get()));
+    return array(out);
+}
+
+void logDet(array &logAbs, array &sign, const array &in) {
+    af_array l = 0, s = 0;
+    AF_THROW(af_log_det(&l, &s, in.get()));
+    logAbs = array(l);
+    sign   = array(s);
+}
+
+array normBatched(const array &in, const normType type, const double p,
+                  const double q) {
+    af_array out = 0;
+    AF_THROW(af_norm_batched(&out, in.get(), type, p, q));
+    return array(out);
+}
+
 bool isLAPACKAvailable() {
     bool out = false;
     AF_THROW(af_is_lapack_available(&out));
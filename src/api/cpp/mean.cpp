@@ -37,12 +37,14 @@ array mean(const array& in, const array& weights, const dim_t dim) {
 #define INSTANTIATE_MEAN(T)                                                  \
     template<>                                                               \
     AFAPI T mean(const array& in) {                                          \
+        VMAP_UNSUPPORTED();                                                  \
         double ret_val;                                                      \
         AF_THROW(af_mean_all(&ret_val, NULL, in.get()));                     \
         return cast<T>(ret_val);                                             \
     }                                                                        \
     template<>                                                               \
     AFAPI T mean(const array& in, const array& wts) {                        \
+        VMAP_UNSUPPORTED();                                                  \
         double ret_val;                                                      \
         AF_THROW(af_mean_all_weighted(&ret_val, NULL, in.get(), wts.get())); \
         return cast<T>(ret_val);                                             \
@@ -50,6 +52,7 @@ array mean(const array& in, const array& weights, const dim_t dim) {
 
 template<>
 AFAPI af_cfloat mean(const array& in) {
+    VMAP_UNSUPPORTED();
     double real, imag;
     AF_THROW(af_mean_all(&real, &imag, in.get()));
     return {static_cast<float>(real), static_cast<float>(imag)};
@@ -57,6 +60,7 @@ AFAPI af_cfloat mean(const array& in) {
 
 template<>
 AFAPI af_cdouble mean(const array& in) {
+    VMAP_UNSUPPORTED();
     double real, imag;
     AF_THROW(af_mean_all(&real, &imag, in.get()));
     return {real, imag};
@@ -35,10 +35,37 @@ INSTANTIATE_MEDIAN(unsigned short);
 
 #undef INSTANTIATE_MEDIAN
 
+#define INSTANTIATE_QUANTILE(T)                                 \
+    template<>                                                  \
+    AFAPI T quantile(const array& in, const double q) {         \
+        double ret_val;                                         \
+        AF_THROW(af_quantile_all(&ret_val, NULL, in.get(), q)); \
+        return (T)ret_val;                                      \
+    }
+
+INSTANTIATE_QUANTILE(float);
+INSTANTIATE_QUANTILE(double);
+INSTANTIATE_QUANTILE(int);
+INSTANTIATE_QUANTILE(unsigned int);
+INSTANTIATE_QUANTILE(char);
+INSTANTIATE_QUANTILE(unsigned char);
+INSTANTIATE_QUANTILE(long long);
+INSTANTIATE_QUANTILE(unsigned long long);
+INSTANTIATE_QUANTILE(short);
+INSTANTIATE_QUANTILE(unsigned short);
+
+#undef INSTANTIATE_QUANTILE
+
 array median(const array& in, const dim_t dim) {
     af_array temp = 0;
     AF_THROW(af_median(&temp, in.get(), getFNSD(dim, in.dims())));
     return array(temp);
 }
 
+array quantile(const array& in, const double q, const dim_t dim) {
+    af_array temp = 0;
+    AF_THROW(af_quantile(&temp, in.get(), q, getFNSD(dim, in.dims())));
+    return array(temp);
+}
+
 }  // namespace af
@@ -27,4 +27,19 @@ void orb(features& feat, array& desc, const array& in, const float fast_thr,
     desc = array(temp_desc);
 }
 
+void orbBatch(features& feat, array& desc, array& counts, const array& images,
+              const float fast_thr, const unsigned max_feat,
+              const float scl_fctr, const unsigned levels,
+              const bool blur_img) {
+    af_features temp_feat;
+    af_array temp_desc   = 0;
+    af_array temp_counts = 0;
+    AF_THROW(af_orb_batch(&temp_feat, &temp_desc, &temp_counts, images.get(),
+                          fast_thr, max_feat, scl_fctr, levels, blur_img));
+
+    feat   = features(temp_feat);
+    desc   = array(temp_desc);
+    counts = array(temp_counts);
+}
+
 }  // namespace af
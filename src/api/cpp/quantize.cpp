@@ -0,0 +1,28 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/arith.h>
+#include <af/array.h>
+#include "error.hpp"
+
+namespace af {
+array quantize(const array &in, const array &scale, const array &zero,
+               const int dim) {
+    af_array out = 0;
+    AF_THROW(af_quantize(&out, in.get(), scale.get(), zero.get(), dim));
+    return array(out);
+}
+
+array dequantize(const array &in, const array &scale, const array &zero,
+                 const int dim) {
+    af_array out = 0;
+    AF_THROW(af_dequantize(&out, in.get(), scale.get(), zero.get(), dim));
+    return array(out);
+}
+}  // namespace af
@@ -13,6 +13,8 @@
 #include <af/random.h>
 #include "error.hpp"
 
+#include <vector>
+
 namespace af {
 randomEngine::randomEngine(randomEngineType type, unsigned long long seed)
     : engine(0) {
@@ -59,6 +61,23 @@ unsigned long long randomEngine::getSeed() const {
     return seed;
 }
 
+randomEngine randomEngine::substream(const unsigned index,
+                                     const unsigned count) const {
+    af_random_engine out = 0;
+    AF_THROW(af_random_engine_substream(&out, engine, index, count));
+    return randomEngine(out);
+}
+
+void randomEngine::substreams(randomEngine *out, const unsigned count) const {
+    std::vector<af_random_engine> handles(count, 0);
+    AF_THROW(af_random_engine_substreams(handles.data(), engine, count));
+    for (unsigned i = 0; i < count; ++i) { out[i] = randomEngine(handles[i]); }
+}
+
+void randomEngine::skip(const unsigned long long n) {
+    AF_THROW(af_random_engine_skip(&engine, n));
+}
+
 af_random_engine randomEngine::get() const { return engine; }
 
 array randu(const dim4 &dims, const dtype ty, randomEngine &r) {
@@ -73,6 +92,32 @@ array randn(const dim4 &dims, const dtype ty, randomEngine &r) {
     return array(out);
 }
 
+array randomExponential(const array &rate, randomEngine &r) {
+    af_array out;
+    AF_THROW(af_random_exponential(&out, rate.get(), r.get()));
+    return array(out);
+}
+
+array randomGamma(const array &shape, const array &scale, randomEngine &r) {
+    af_array out;
+    AF_THROW(af_random_gamma(&out, shape.get(), scale.get(), r.get()));
+    return array(out);
+}
+
+array randomPoisson(const array &lambda, randomEngine &r) {
+    af_array out;
+    AF_THROW(af_random_poisson(&out, lambda.get(), r.get()));
+    return array(out);
+}
+
+array randomTruncatedNormal(const array &lower, const array &upper,
+                            randomEngine &r) {
+    af_array out;
+    AF_THROW(
+        af_random_truncated_normal(&out, lower.get(), upper.get(), r.get()));
+    return array(out);
+}
+
 array randu(const dim4 &dims, const af::dtype type) {
     af_array res;
     AF_THROW(af_randu(&res, dims.ndims(), dims.get(), type));
@@ -163,6 +163,81 @@ void countByKey(array &keys_out, array &vals_out, const array &keys,
     vals_out = array(ovals);
 }
 
+void summary(double *min, double *max, double *sum, double *sumsq,
+             double *count, const array &in) {
+    AF_THROW(af_summary_all(min, max, sum, sumsq, count, in.get()));
+}
+
+array sumSegmented(const array &in, const array &offsets) {
+    af_array out = 0;
+    AF_THROW(af_sum_segmented(&out, in.get(), offsets.get()));
+    return array(out);
+}
+
+array minSegmented(const array &in, const array &offsets) {
+    af_array out = 0;
+    AF_THROW(af_min_segmented(&out, in.get(), offsets.get()));
+    return array(out);
+}
+
+array maxSegmented(const array &in, const array &offsets) {
+    af_array out = 0;
+    AF_THROW(af_max_segmented(&out, in.get(), offsets.get()));
+    return array(out);
+}
+
+array sumDims(const array &in, const unsigned ndims, const int *dims) {
+    af_array out = 0;
+    AF_THROW(af_sum_dims(&out, in.get(), ndims, dims));
+    return array(out);
+}
+
+array productDims(const array &in, const unsigned ndims, const int *dims) {
+    af_array out = 0;
+    AF_THROW(af_product_dims(&out, in.get(), ndims, dims));
+    return array(out);
+}
+
+array minDims(const array &in, const unsigned ndims, const int *dims) {
+    af_array out = 0;
+    AF_THROW(af_min_dims(&out, in.get(), ndims, dims));
+    return array(out);
+}
+
+array maxDims(const array &in, const unsigned ndims, const int *dims) {
+    af_array out = 0;
+    AF_THROW(af_max_dims(&out, in.get(), ndims, dims));
+    return array(out);
+}
+
+array countDims(const array &in, const unsigned ndims, const int *dims) {
+    af_array out = 0;
+    AF_THROW(af_count_dims(&out, in.get(), ndims, dims));
+    return array(out);
+}
+
+array allTrueDims(const array &in, const unsigned ndims, const int *dims) {
+    af_array out = 0;
+    AF_THROW(af_all_true_dims(&out, in.get(), ndims, dims));
+    return array(out);
+}
+
+array anyTrueDims(const array &in, const unsigned ndims, const int *dims) {
+    af_array out = 0;
+    AF_THROW(af_any_true_dims(&out, in.get(), ndims, dims));
+    return array(out);
+}
+
+void reduceByKeyUnsorted(array &keys_out, array &vals_out, const array &keys,
+                         const array &vals, const binaryOp op) {
+    af_array okeys = 0;
+    af_array ovals = 0;
+    AF_THROW(af_reduce_by_key_unsorted(&okeys, &ovals, keys.get(), vals.get(),
+                                       op));
+    keys_out = array(okeys);
+    vals_out = array(ovals);
+}
+
 void min(array &val, array &idx, const array &in, const int dim) {
     af_array out = 0;
     af_array loc = 0;
@@ -198,6 +273,7 @@ void max(array &val, array &idx, const array &in, const int dim) {
 #define INSTANTIATE_REAL(fnC, fnCPP, T)                   \
     template<>                                            \
     AFAPI T fnCPP(const array &in) {                      \
+        VMAP_UNSUPPORTED();                               \
         double rval, ival;                                \
         AF_THROW(af_##fnC##_all(&rval, &ival, in.get())); \
         return (T)(rval);                                 \
@@ -206,6 +282,7 @@ void max(array &val, array &idx, const array &in, const int dim) {
 #define INSTANTIATE_CPLX(fnC, fnCPP, T, Tr)               \
     template<>                                            \
     AFAPI T fnCPP(const array &in) {                      \
+        VMAP_UNSUPPORTED();                               \
         double rval, ival;                                \
         AF_THROW(af_##fnC##_all(&rval, &ival, in.get())); \
         T out((Tr)rval, (Tr)ival);                        \
@@ -229,6 +306,7 @@ INSTANTIATE_REAL(any_true, anyTrue, bool);
 #define INSTANTIATE_REAL(fnC, fnCPP, T)                           \
     template<>                                                    \
     AFAPI T fnCPP(const array &in, const double nanval) {         \
+        VMAP_UNSUPPORTED();                                       \
         double rval, ival;                                        \
         AF_THROW(af_##fnC##_all(&rval, &ival, in.get(), nanval)); \
         return (T)(rval);                                         \
@@ -237,6 +315,7 @@ INSTANTIATE_REAL(any_true, anyTrue, bool);
 #define INSTANTIATE_CPLX(fnC, fnCPP, T, Tr)                       \
     template<>                                                    \
     AFAPI T fnCPP(const array &in, const double nanval) {         \
+        VMAP_UNSUPPORTED();                                       \
         double rval, ival;                                        \
         AF_THROW(af_##fnC##_all(&rval, &ival, in.get(), nanval)); \
         T out((Tr)rval, (Tr)ival);                                \
@@ -20,4 +20,19 @@ array regions(const array& in, const af::connectivity connectivity,
     return array(temp);
 }
 
+array regions(array& stats, const array& in,
+              const af::connectivity connectivity, const af::dtype type) {
+    af_array temp  = 0;
+    af_array stemp = 0;
+    AF_THROW(af_regions_stats(&temp, &stemp, in.get(), connectivity, type));
+    stats = array(stemp);
+    return array(temp);
+}
+
+array regionProps(const array& labels, const unsigned nlabels) {
+    af_array temp = 0;
+    AF_THROW(af_region_props(&temp, labels.get(), nlabels));
+    return array(temp);
+}
+
 }  // namespace af
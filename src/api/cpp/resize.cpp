@@ -11,6 +11,8 @@
 #include <af/image.h>
 #include "error.hpp"
 
+#include <vector>
+
 namespace af {
 
 array resize(const array &in, const dim_t odim0, const dim_t odim1,
@@ -35,4 +37,12 @@ array resize(const float scale, const array &in, const interpType method) {
     return array(out);
 }
 
+void pyramid(array *levels, const array &in, const unsigned num_levels,
+             const float scale_factor, const float sigma) {
+    std::vector<af_array> out(num_levels, 0);
+    AF_THROW(
+        af_pyramid(out.data(), in.get(), num_levels, scale_factor, sigma));
+    for (unsigned i = 0; i < num_levels; ++i) { levels[i] = array(out[i]); }
+}
+
 }  // namespace af
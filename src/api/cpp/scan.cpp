@@ -13,12 +13,14 @@
 
 namespace af {
 array accum(const array& in, const int dim) {
+    VMAP_CHECK_DIM(dim);
     af_array out = 0;
     AF_THROW(af_accum(&out, in.get(), dim));
     return array(out);
 }
 
 array scan(const array& in, const int dim, binaryOp op, bool inclusive_scan) {
+    VMAP_CHECK_DIM(dim);
     af_array out = 0;
     AF_THROW(af_scan(&out, in.get(), dim, op, inclusive_scan));
     return array(out);
@@ -26,9 +28,18 @@ array scan(const array& in, const int dim, binaryOp op, bool inclusive_scan) {
 
 array scanByKey(const array& key, const array& in, const int dim, binaryOp op,
                 bool inclusive_scan) {
+    VMAP_CHECK_DIM(dim);
     af_array out = 0;
     AF_THROW(
         af_scan_by_key(&out, key.get(), in.get(), dim, op, inclusive_scan));
     return array(out);
 }
+
+array scanSegmented(const array& in, const array& offsets, binaryOp op,
+                    bool inclusive_scan) {
+    af_array out = 0;
+    AF_THROW(af_scan_segmented(&out, in.get(), offsets.get(), op,
+                               inclusive_scan));
+    return array(out);
+}
 }  // namespace af
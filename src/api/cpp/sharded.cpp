@@ -0,0 +1,136 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/array.h>
+#include <af/exception.h>
+#include <af/sharded.h>
+#include "error.hpp"
+
+namespace af {
+
+namespace {
+
+/// Returns a new array object for a shard owned by af_sharded_map
+array borrowShard(const af_array shard) {
+    af_array handle = 0;
+    AF_THROW(af_retain_array(&handle, shard));
+    return array(handle);
+}
+
+/// Returns a new handle to \p res, which outlives the array object
+af_err returnShard(af_array *out, const array &res) {
+    return af_retain_array(out, res.get());
+}
+
+af_err callUnary(af_array *out, const af_array *shards,
+                 const unsigned num_inputs, void *user_data) {
+    UNUSED(num_inputs);
+    try {
+        shardedArray::unaryFunc func =
+            *static_cast<shardedArray::unaryFunc *>(user_data);
+        return returnShard(out, func(borrowShard(shards[0])));
+    } catch (af::exception &ex) {
+        return ex.err();
+    } catch (...) { return AF_ERR_UNKNOWN; }
+}
+
+af_err callBinary(af_array *out, const af_array *shards,
+                  const unsigned num_inputs, void *user_data) {
+    UNUSED(num_inputs);
+    try {
+        shardedArray::binaryFunc func =
+            *static_cast<shardedArray::binaryFunc *>(user_data);
+        return returnShard(
+            out, func(borrowShard(shards[0]), borrowShard(shards[1])));
+    } catch (af::exception &ex) {
+        return ex.err();
+    } catch (...) { return AF_ERR_UNKNOWN; }
+}
+
+}  // namespace
+
+shardedArray::shardedArray(const af_sharded_array handle) : arr(handle) {}
+
+shardedArray::shardedArray(const array &in, const unsigned num_devices,
+                           const int *devices)
+    : arr(0) {
+    AF_THROW(af_create_sharded_array(&arr, in.get(), num_devices, devices));
+}
+
+// NOLINTNEXTLINE(performance-noexcept-move-constructor) we can't change the API
+shardedArray::shardedArray(shardedArray &&other) : arr(other.arr) {
+    other.arr = 0;
+}
+
+// NOLINTNEXTLINE(performance-noexcept-move-constructor) we can't change the API
+shardedArray &shardedArray::operator=(shardedArray &&other) {
+    af_release_sharded_array(arr);
+    arr       = other.arr;
+    other.arr = 0;
+    return *this;
+}
+
+shardedArray::~shardedArray() {
+    // No dtor throw
+    if (arr) { af_release_sharded_array(arr); }
+}
+
+af_sharded_array shardedArray::get() const { return arr; }
+
+unsigned shardedArray::numShards() const {
+    unsigned num_shards = 0;
+    AF_THROW(af_get_sharded_info(&num_shards, NULL, NULL, arr));
+    return num_shards;
+}
+
+int shardedArray::shardDim() const {
+    int dim = 0;
+    AF_THROW(af_get_sharded_info(NULL, &dim, NULL, arr));
+    return dim;
+}
+
+dim4 shardedArray::dims() const {
+    dim_t d[4];
+    AF_THROW(af_get_sharded_info(NULL, NULL, d, arr));
+    return dim4(d[0], d[1], d[2], d[3]);
+}
+
+array shardedArray::shard(const unsigned index) const {
+    af_array out = 0;
+    AF_THROW(af_get_shard(&out, arr, index));
+    return array(out);
+}
+
+array shardedArray::gather(const int device) const {
+    af_array out = 0;
+    AF_THROW(af_sharded_gather(&out, arr, device));
+    return array(out);
+}
+
+array shardedArray::reduce(const binaryOp op, const int device) const {
+    af_array out = 0;
+    AF_THROW(af_sharded_reduce(&out, arr, op, device));
+    return array(out);
+}
+
+shardedArray shardedArray::map(unaryFunc func) const {
+    af_sharded_array out = 0;
+    AF_THROW(af_sharded_map(&out, 1, &arr, callUnary, &func));
+    return shardedArray(out);
+}
+
+shardedArray shardedArray::map(const shardedArray &lhs,
+                               const shardedArray &rhs, binaryFunc func) {
+    af_sharded_array out        = 0;
+    const af_sharded_array in[] = {lhs.arr, rhs.arr};
+    AF_THROW(af_sharded_map(&out, 2, in, callBinary, &func));
+    return shardedArray(out);
+}
+
+}  // namespace af
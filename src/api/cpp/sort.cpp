@@ -13,6 +13,7 @@
 
 namespace af {
 array sort(const array &in, const unsigned dim, const bool isAscending) {
+    VMAP_CHECK_DIM(dim);
     af_array out = 0;
     AF_THROW(af_sort(&out, in.get(), dim, isAscending));
     return array(out);
@@ -20,6 +21,7 @@ array sort(const array &in, const unsigned dim, const bool isAscending) {
 
 void sort(array &out, array &indices, const array &in, const unsigned dim,
           const bool isAscending) {
+    VMAP_CHECK_DIM(dim);
     af_array out_, indices_;
     AF_THROW(af_sort_index(&out_, &indices_, in.get(), dim, isAscending));
     out     = array(out_);
@@ -28,10 +30,29 @@ void sort(array &out, array &indices, const array &in, const unsigned dim,
 
 void sort(array &out_keys, array &out_values, const array &keys,
           const array &values, const unsigned dim, const bool isAscending) {
+    VMAP_CHECK_DIM(dim);
     af_array okeys, ovalues;
     AF_THROW(af_sort_by_key(&okeys, &ovalues, keys.get(), values.get(), dim,
                             isAscending));
     out_keys   = array(okeys);
     out_values = array(ovalues);
 }
+
+array sortSegmented(const array &in, const array &offsets,
+                    const bool isAscending) {
+    af_array out = 0;
+    AF_THROW(af_sort_segmented(&out, in.get(), offsets.get(), isAscending));
+    return array(out);
+}
+
+void sortByKeySegmented(array &out_keys, array &out_values, const array &keys,
+                        const array &values, const array &offsets,
+                        const bool isAscending) {
+    af_array okeys, ovalues;
+    AF_THROW(af_sort_by_key_segmented(&okeys, &ovalues, keys.get(),
+                                      values.get(), offsets.get(),
+                                      isAscending));
+    out_keys   = array(okeys);
+    out_values = array(ovalues);
+}
 }  // namespace af
@@ -47,6 +47,15 @@ array sparseConvertTo(const array in, const af::storage stype) {
     return array(out);
 }
 
+// NOLINTNEXTLINE(performance-unnecessary-value-param)
+array sparseConvertTo(const array in, const af::storage destStorage,
+                      const int blockSize, const int sortWindow) {
+    af_array out = 0;
+    AF_THROW(af_sparse_convert_to_blocked(&out, in.get(), destStorage,
+                                          blockSize, sortWindow));
+    return array(out);
+}
+
 // NOLINTNEXTLINE(performance-unnecessary-value-param)
 array dense(const array sparse) {
     af_array out = 0;
@@ -101,4 +110,30 @@ af::storage sparseGetStorage(const array in) {
     AF_THROW(af_sparse_get_storage(&out, in.get()));
     return out;
 }
+
+void sparseSetValues(array &in, const array &values) {
+    AF_THROW(af_sparse_set_values(in.get(), values.get()));
+}
+
+void sparseInsert(array &in, const array &values, const array &rowIdx,
+                  const array &colIdx) {
+    AF_THROW(
+        af_sparse_insert(in.get(), values.get(), rowIdx.get(), colIdx.get()));
+}
+
+void sparseRemove(array &in, const array &rowIdx, const array &colIdx) {
+    AF_THROW(af_sparse_remove(in.get(), rowIdx.get(), colIdx.get()));
+}
+
+array sparseILU0(const array &in) {
+    af_array out = 0;
+    AF_THROW(af_sparse_ilu0(&out, in.get()));
+    return array(out);
+}
+
+array sparseIC0(const array &in) {
+    af_array out = 0;
+    AF_THROW(af_sparse_ic0(&out, in.get()));
+    return array(out);
+}
 }  // namespace af
@@ -7,7 +7,10 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <af/array.h>
+#include <af/data.h>
 #include <af/device.h>
+#include <af/exception.h>
 #include <af/timing.h>
 #include <algorithm>
 #include <cmath>
@@ -110,4 +113,87 @@ double timeit(void (*fn)()) {
     return run_time / batches;
 }
 
+void deviceTimer::start() { start_.mark(); }
+
+void deviceTimer::stop() { end_.mark(); }
+
+double deviceTimer::elapsed() const { return end_.elapsed(start_) * 1e-3; }
+
+// The value at the fraction p of the sorted times
+static double percentile(const std::vector<double> &sorted, double p) {
+    size_t index = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::min(std::max<size_t>(index, 1), sorted.size()) - 1];
+}
+
+static double median(const std::vector<double> &sorted) {
+    size_t n = sorted.size();
+    return n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+}
+
+timeit_stats timeitStats(void (*fn)(), const timeit_options &options) {
+    if (options.samples < 1) {
+        throw exception("timeitStats needs at least one sample", __FILE__,
+                        __LINE__, AF_ERR_ARG);
+    }
+
+    // Larger than the last level caches of the devices, so each run reads
+    // its inputs from memory
+    array flushBuffer;
+    if (options.flushCache) { flushBuffer = constant(0, 16 << 20, u32); }
+
+    for (int i = 0; i < options.warmup; ++i) { fn(); }
+    sync();
+
+    bool device = options.deviceTime;
+    deviceTimer deviceTime;
+    std::vector<double> times;
+    times.reserve(options.samples);
+    for (int i = 0; i < options.samples; ++i) {
+        if (options.flushCache) {
+            flushBuffer += 1;
+            flushBuffer.eval();
+        }
+        if (device) {
+            deviceTime.start();
+            fn();
+            deviceTime.stop();
+            try {
+                times.push_back(deviceTime.elapsed());
+                continue;
+            } catch (exception &ex) {
+                // The queue does not record timestamps. The run was not
+                // timed, so it is repeated with the host clock.
+                if (ex.err() != AF_ERR_NOT_SUPPORTED) { throw; }
+                device = false;
+            }
+        }
+        sync();
+        timer start = timer::start();
+        fn();
+        sync();
+        times.push_back(timer::stop(start));
+    }
+
+    std::sort(times.begin(), times.end());
+    timeit_stats stats;
+    stats.min     = times.front();
+    stats.max     = times.back();
+    stats.median  = median(times);
+    stats.p90     = percentile(times, 0.9);
+    stats.p99     = percentile(times, 0.99);
+    stats.samples = static_cast<int>(times.size());
+    stats.device  = device;
+
+    double total = 0;
+    std::vector<double> deviations;
+    for (double time : times) {
+        total += time;
+        deviations.push_back(std::abs(time - stats.median));
+    }
+    std::sort(deviations.begin(), deviations.end());
+    stats.mean = total / times.size();
+    stats.mad  = median(deviations);
+    return stats;
+}
+
 }  // namespace af
@@ -19,4 +19,12 @@ array unwrap(const array& in, const dim_t wx, const dim_t wy, const dim_t sx,
     AF_THROW(af_unwrap(&out, in.get(), wx, wy, sx, sy, px, py, is_column));
     return array(out);
 }
+
+array unwrapReduce(const array& in, const dim_t wx, const dim_t wy,
+                   const dim_t sx, const dim_t sy, const dim_t px,
+                   const dim_t py, const binaryOp op) {
+    af_array out = 0;
+    AF_THROW(af_unwrap_reduce(&out, in.get(), wx, wy, sx, sy, px, py, op));
+    return array(out);
+}
 }  // namespace af
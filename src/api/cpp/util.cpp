@@ -48,6 +48,60 @@ int readArrayCheck(const char *filename, const char *key) {
     return out;
 }
 
+int saveArrayChunked(const char *key, const array &arr, const char *filename,
+                     const bool append, const compressionType compression,
+                     const dim_t chunkBytes) {
+    int index = -1;
+    AF_THROW(af_save_array_chunked(&index, key, arr.get(), filename, append,
+                                   compression, chunkBytes));
+    return index;
+}
+
+af_save_handle saveArrayAsync(const char *key, const array &arr,
+                              const char *filename, const bool append) {
+    af_save_handle handle = nullptr;
+    AF_THROW(af_save_array_async(&handle, key, arr.get(), filename, append));
+    return handle;
+}
+
+int waitSave(af_save_handle handle) {
+    int index  = -1;
+    af_err err = af_wait_save(&index, handle);
+    af_release_save(handle);
+    AF_THROW(err);
+    return index;
+}
+
+array readArrayRange(const char *filename, const unsigned index,
+                     const seq &s0) {
+    af_array out = 0;
+    af_seq seqs  = s0.s;
+    AF_THROW(af_read_array_range(&out, filename, index, 1, &seqs));
+    return array(out);
+}
+
+array readArrayRange(const char *filename, const unsigned index,
+                     const seq &s0, const seq &s1, const seq &s2,
+                     const seq &s3) {
+    af_array out   = 0;
+    af_seq seqs[4] = {s0.s, s1.s, s2.s, s3.s};
+    AF_THROW(af_read_array_range(&out, filename, index, 4, seqs));
+    return array(out);
+}
+
+array readMtx(const char *filename, const dtype type) {
+    af_array out = 0;
+    AF_THROW(af_read_mtx(&out, filename, type));
+    return array(out);
+}
+
+array readCsv(const char *filename, const dtype type, const char delimiter,
+              const unsigned skipRows) {
+    af_array out = 0;
+    AF_THROW(af_read_csv(&out, filename, type, delimiter, skipRows));
+    return array(out);
+}
+
 void toString(char **output, const char *exp, const array &arr,
               const int precision, const bool transpose) {
     AF_THROW(af_array_to_string(output, exp, arr.get(), precision, transpose));
@@ -22,4 +22,14 @@ array where(const array& in) {
     AF_THROW(af_where(&out, in.get()));
     return array(out);
 }
+
+array compact(const array& in, const array& mask) {
+    if (gforGet()) {
+        AF_THROW_ERR("COMPACT can not be used inside GFOR", AF_ERR_RUNTIME);
+    }
+
+    af_array out = 0;
+    AF_THROW(af_compact(&out, in.get(), mask.get()));
+    return array(out);
+}
 }  // namespace af
@@ -9,12 +9,13 @@
 
 #include <af/algorithm.h>
 #include <af/array.h>
+#include "placement.hpp"
 #include "symbol_manager.hpp"
 
-#define ALGO_HAPI_DEF(af_func)                                        \
-    af_err af_func(af_array *out, const af_array in, const int dim) { \
-        CHECK_ARRAYS(in);                                             \
-        CALL(af_func, out, in, dim);                                  \
+#define ALGO_HAPI_DEF(af_func)                                  \
+    af_err af_func(af_array *out, af_array in, const int dim) { \
+        PLACE_ARRAYS(in);                                       \
+        CALL(af_func, out, in, dim);                            \
     }
 
 ALGO_HAPI_DEF(af_sum)
@@ -124,11 +125,56 @@ ALGO_HAPI_DEF(af_imax_all)
 
 #undef ALGO_HAPI_DEF
 
+#define ALGO_HAPI_DEF(af_func_all_array)                         \
+    af_err af_func_all_array(af_array *out, const af_array in) { \
+        CHECK_ARRAYS(in);                                        \
+        CALL(af_func_all_array, out, in);                        \
+    }
+
+ALGO_HAPI_DEF(af_sum_all_array)
+ALGO_HAPI_DEF(af_product_all_array)
+ALGO_HAPI_DEF(af_min_all_array)
+ALGO_HAPI_DEF(af_max_all_array)
+ALGO_HAPI_DEF(af_all_true_all_array)
+ALGO_HAPI_DEF(af_any_true_all_array)
+ALGO_HAPI_DEF(af_count_all_array)
+
+#undef ALGO_HAPI_DEF
+
+#define ALGO_HAPI_DEF(af_func_nan_all_array)                       \
+    af_err af_func_nan_all_array(af_array *out, const af_array in, \
+                                 const double nanval) {            \
+        CHECK_ARRAYS(in);                                          \
+        CALL(af_func_nan_all_array, out, in, nanval);              \
+    }
+
+ALGO_HAPI_DEF(af_sum_nan_all_array)
+ALGO_HAPI_DEF(af_product_nan_all_array)
+
+#undef ALGO_HAPI_DEF
+
+#define ALGO_HAPI_DEF(af_ifunc_all_array)                   \
+    af_err af_ifunc_all_array(af_array *val, af_array *idx, \
+                              const af_array in) {          \
+        CHECK_ARRAYS(in);                                   \
+        CALL(af_ifunc_all_array, val, idx, in);             \
+    }
+
+ALGO_HAPI_DEF(af_imin_all_array)
+ALGO_HAPI_DEF(af_imax_all_array)
+
+#undef ALGO_HAPI_DEF
+
 af_err af_where(af_array *idx, const af_array in) {
     CHECK_ARRAYS(in);
     CALL(af_where, idx, in);
 }
 
+af_err af_compact(af_array *out, const af_array in, const af_array mask) {
+    CHECK_ARRAYS(in, mask);
+    CALL(af_compact, out, in, mask);
+}
+
 af_err af_scan(af_array *out, const af_array in, const int dim, af_binary_op op,
                bool inclusive_scan) {
     CHECK_ARRAYS(in);
@@ -182,3 +228,73 @@ af_err af_max_ragged(af_array *vals, af_array *idx, const af_array in,
     CHECK_ARRAYS(in, ragged_len);
     CALL(af_max_ragged, vals, idx, in, ragged_len, dim);
 }
+
+af_err af_summary_all(double *min, double *max, double *sum, double *sumsq,
+                      double *count, const af_array in) {
+    CHECK_ARRAYS(in);
+    CALL(af_summary_all, min, max, sum, sumsq, count, in);
+}
+
+af_err af_sum_segmented(af_array *out, const af_array in,
+                        const af_array offsets) {
+    CHECK_ARRAYS(in, offsets);
+    CALL(af_sum_segmented, out, in, offsets);
+}
+
+af_err af_min_segmented(af_array *out, const af_array in,
+                        const af_array offsets) {
+    CHECK_ARRAYS(in, offsets);
+    CALL(af_min_segmented, out, in, offsets);
+}
+
+af_err af_max_segmented(af_array *out, const af_array in,
+                        const af_array offsets) {
+    CHECK_ARRAYS(in, offsets);
+    CALL(af_max_segmented, out, in, offsets);
+}
+
+#define ALGO_HAPI_DEF_DIMS(af_func)                                  \
+    af_err af_func(af_array *out, af_array in, const unsigned ndims, \
+                   const int *dims) {                                \
+        PLACE_ARRAYS(in);                                            \
+        CALL(af_func, out, in, ndims, dims);                         \
+    }
+
+ALGO_HAPI_DEF_DIMS(af_sum_dims)
+ALGO_HAPI_DEF_DIMS(af_product_dims)
+ALGO_HAPI_DEF_DIMS(af_min_dims)
+ALGO_HAPI_DEF_DIMS(af_max_dims)
+ALGO_HAPI_DEF_DIMS(af_count_dims)
+ALGO_HAPI_DEF_DIMS(af_all_true_dims)
+ALGO_HAPI_DEF_DIMS(af_any_true_dims)
+
+#undef ALGO_HAPI_DEF_DIMS
+
+af_err af_reduce_by_key_unsorted(af_array *keys_out, af_array *vals_out,
+                                 const af_array keys, const af_array vals,
+                                 const af_binary_op op) {
+    CHECK_ARRAYS(keys, vals);
+    CALL(af_reduce_by_key_unsorted, keys_out, vals_out, keys, vals, op);
+}
+
+af_err af_scan_segmented(af_array *out, const af_array in,
+                         const af_array offsets, const af_binary_op op,
+                         const bool inclusive_scan) {
+    CHECK_ARRAYS(in, offsets);
+    CALL(af_scan_segmented, out, in, offsets, op, inclusive_scan);
+}
+
+af_err af_sort_segmented(af_array *out, const af_array in,
+                         const af_array offsets, const bool isAscending) {
+    CHECK_ARRAYS(in, offsets);
+    CALL(af_sort_segmented, out, in, offsets, isAscending);
+}
+
+af_err af_sort_by_key_segmented(af_array *out_keys, af_array *out_values,
+                                const af_array keys, const af_array values,
+                                const af_array offsets,
+                                const bool isAscending) {
+    CHECK_ARRAYS(keys, values, offsets);
+    CALL(af_sort_by_key_segmented, out_keys, out_values, keys, values,
+         offsets, isAscending);
+}
@@ -9,13 +9,14 @@
 
 #include <af/arith.h>
 #include <af/array.h>
+#include "placement.hpp"
 #include "symbol_manager.hpp"
 
-#define BINARY_HAPI_DEF(af_func)                                          \
-    af_err af_func(af_array* out, const af_array lhs, const af_array rhs, \
-                   const bool batchMode) {                                \
-        CHECK_ARRAYS(lhs, rhs);                                           \
-        CALL(af_func, out, lhs, rhs, batchMode);                          \
+#define BINARY_HAPI_DEF(af_func)                              \
+    af_err af_func(af_array* out, af_array lhs, af_array rhs, \
+                   const bool batchMode) {                    \
+        PLACE_ARRAYS(lhs, rhs);                               \
+        CALL(af_func, out, lhs, rhs, batchMode);              \
     }
 
 BINARY_HAPI_DEF(af_add)
@@ -45,15 +46,27 @@ BINARY_HAPI_DEF(af_bitshiftl)
 BINARY_HAPI_DEF(af_bitshiftr)
 BINARY_HAPI_DEF(af_hypot)
 
-af_err af_cast(af_array* out, const af_array in, const af_dtype type) {
-    CHECK_ARRAYS(in);
+af_err af_cast(af_array* out, af_array in, const af_dtype type) {
+    PLACE_ARRAYS(in);
     CALL(af_cast, out, in, type);
 }
 
-#define UNARY_HAPI_DEF(af_func)                        \
-    af_err af_func(af_array* out, const af_array in) { \
-        CHECK_ARRAYS(in);                              \
-        CALL(af_func, out, in);                        \
+af_err af_quantize(af_array* out, const af_array in, const af_array scale,
+                   const af_array zero, const int dim) {
+    CHECK_ARRAYS(in, scale, zero);
+    CALL(af_quantize, out, in, scale, zero, dim);
+}
+
+af_err af_dequantize(af_array* out, const af_array in, const af_array scale,
+                     const af_array zero, const int dim) {
+    CHECK_ARRAYS(in, scale, zero);
+    CALL(af_dequantize, out, in, scale, zero, dim);
+}
+
+#define UNARY_HAPI_DEF(af_func)                  \
+    af_err af_func(af_array* out, af_array in) { \
+        PLACE_ARRAYS(in);                        \
+        CALL(af_func, out, in);                  \
     }
 
 UNARY_HAPI_DEF(af_abs)
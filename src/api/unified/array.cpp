@@ -38,8 +38,59 @@ af_err af_get_data_ptr(void *data, const af_array arr) {
     CALL(af_get_data_ptr, data, arr);
 }
 
+af_err af_write_array_async(af_event *event, af_array arr, const void *data,
+                            const size_t bytes, af_source src) {
+    CHECK_ARRAYS(arr);
+    CALL(af_write_array_async, event, arr, data, bytes, src);
+}
+
+af_err af_get_data_ptr_async(af_event *event, void *data, const af_array arr) {
+    CHECK_ARRAYS(arr);
+    CALL(af_get_data_ptr_async, event, data, arr);
+}
+
+af_err af_create_array_async(af_event *event, af_array *arr, const void *data,
+                             const unsigned ndims, const dim_t *const dims,
+                             const af_dtype type) {
+    CALL(af_create_array_async, event, arr, data, ndims, dims, type);
+}
+
+af_err af_adopt_host_array(af_array *arr, void *data, const unsigned ndims,
+                           const dim_t *const dims, const af_dtype type,
+                           af_host_deleter deleter, void *user_data) {
+    CALL(af_adopt_host_array, arr, data, ndims, dims, type, deleter,
+         user_data);
+}
+
+af_err af_copy_to_device(af_event *event, af_array *out, const af_array in,
+                         const int device) {
+    CHECK_ARRAYS(in);
+    CALL(af_copy_to_device, event, out, in, device);
+}
+
+af_err af_scatter(af_event *events, af_array *outs, const af_array in,
+                  const int dim, const unsigned num_devices,
+                  const int *devices) {
+    CHECK_ARRAYS(in);
+    CALL(af_scatter, events, outs, in, dim, num_devices, devices);
+}
+
+af_err af_gather(af_event *event, af_array *out, const unsigned num_arrays,
+                 const af_array *ins, const int dim, const int device) {
+    for (unsigned i = 0; i < num_arrays; i++) { CHECK_ARRAYS(ins[i]); }
+    CALL(af_gather, event, out, num_arrays, ins, dim, device);
+}
+
+af_err af_all_reduce(af_event *events, af_array *outs,
+                     const unsigned num_arrays, const af_array *ins,
+                     const af_binary_op op) {
+    for (unsigned i = 0; i < num_arrays; i++) { CHECK_ARRAYS(ins[i]); }
+    CALL(af_all_reduce, events, outs, num_arrays, ins, op);
+}
+
 af_err af_release_array(af_array arr) {
     if (arr) {
+        CHECK_ARRAYS(arr);
         CALL(af_release_array, arr);
     } else {
         return AF_SUCCESS;
@@ -17,12 +17,37 @@ AFAPI af_err af_gemm(af_array *out, const af_mat_prop optLhs,
     CALL(af_gemm, out, optLhs, optRhs, alpha, lhs, rhs, beta);
 }
 
+af_err af_gemm_fused(af_array *out, const af_mat_prop optLhs,
+                     const af_mat_prop optRhs, const void *alpha,
+                     const af_array lhs, const af_array rhs, const void *beta,
+                     const af_array bias, const af_gemm_epilogue epilogue) {
+    CHECK_ARRAYS(out, lhs, rhs, bias);
+    CALL(af_gemm_fused, out, optLhs, optRhs, alpha, lhs, rhs, beta, bias,
+         epilogue);
+}
+
+af_err af_gemm_v2(af_array *out, const af_mat_prop optLhs,
+                  const af_mat_prop optRhs, const void *alpha,
+                  const af_array lhs, const af_array rhs, const void *beta,
+                  const af_gemm_compute_type compute) {
+    CHECK_ARRAYS(out, lhs, rhs);
+    CALL(af_gemm_v2, out, optLhs, optRhs, alpha, lhs, rhs, beta, compute);
+}
+
 af_err af_matmul(af_array *out, const af_array lhs, const af_array rhs,
                  const af_mat_prop optLhs, const af_mat_prop optRhs) {
     CHECK_ARRAYS(lhs, rhs);
     CALL(af_matmul, out, lhs, rhs, optLhs, optRhs);
 }
 
+af_err af_matmul_quantized(af_array *out, const af_array lhs,
+                           const af_array rhs, const int lhsZero,
+                           const int rhsZero, const af_mat_prop optLhs,
+                           const af_mat_prop optRhs) {
+    CHECK_ARRAYS(lhs, rhs);
+    CALL(af_matmul_quantized, out, lhs, rhs, lhsZero, rhsZero, optLhs, optRhs);
+}
+
 af_err af_dot(af_array *out, const af_array lhs, const af_array rhs,
               const af_mat_prop optLhs, const af_mat_prop optRhs) {
     CHECK_ARRAYS(lhs, rhs);
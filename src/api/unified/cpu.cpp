@@ -0,0 +1,32 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/backend.h>
+#include <af/cpu.h>
+#include "symbol_manager.hpp"
+
+af_err afcpu_set_queue_flush_limits(unsigned long long bytes,
+                                    unsigned long long elements) {
+    af_backend backend;
+    af_get_active_backend(&backend);
+    if (backend == AF_BACKEND_CPU) {
+        CALL(afcpu_set_queue_flush_limits, bytes, elements);
+    }
+    return AF_ERR_NOT_SUPPORTED;
+}
+
+af_err afcpu_get_queue_flush_limits(unsigned long long *bytes,
+                                    unsigned long long *elements) {
+    af_backend backend;
+    af_get_active_backend(&backend);
+    if (backend == AF_BACKEND_CPU) {
+        CALL(afcpu_get_queue_flush_limits, bytes, elements);
+    }
+    return AF_ERR_NOT_SUPPORTED;
+}
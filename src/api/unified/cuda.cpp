@@ -40,3 +40,35 @@ af_err afcu_cublasSetMathMode(cublasMath_t mode) {
     if (backend == AF_BACKEND_CUDA) { CALL(afcu_cublasSetMathMode, mode); }
     return AF_ERR_NOT_SUPPORTED;
 }
+
+af_err afcu_set_mem_pool_release_threshold(int id, unsigned long long bytes) {
+    af_backend backend;
+    af_get_active_backend(&backend);
+    if (backend == AF_BACKEND_CUDA) {
+        CALL(afcu_set_mem_pool_release_threshold, id, bytes);
+    }
+    return AF_ERR_NOT_SUPPORTED;
+}
+
+af_err afcu_get_mem_pool_release_threshold(unsigned long long *bytes, int id) {
+    af_backend backend;
+    af_get_active_backend(&backend);
+    if (backend == AF_BACKEND_CUDA) {
+        CALL(afcu_get_mem_pool_release_threshold, bytes, id);
+    }
+    return AF_ERR_NOT_SUPPORTED;
+}
+
+af_err afcu_set_stream(int id, cudaStream_t stream) {
+    af_backend backend;
+    af_get_active_backend(&backend);
+    if (backend == AF_BACKEND_CUDA) { CALL(afcu_set_stream, id, stream); }
+    return AF_ERR_NOT_SUPPORTED;
+}
+
+af_err afcu_create_stream(cudaStream_t *stream, int id) {
+    af_backend backend;
+    af_get_active_backend(&backend);
+    if (backend == AF_BACKEND_CUDA) { CALL(afcu_create_stream, stream, id); }
+    return AF_ERR_NOT_SUPPORTED;
+}
@@ -47,6 +47,8 @@ af_err af_info() { CALL_NO_PARAMS(af_info); }
 
 af_err af_init() { CALL_NO_PARAMS(af_init); }
 
+af_err af_init_async() { CALL_NO_PARAMS(af_init_async); }
+
 af_err af_info_string(char **str, const bool verbose) {
     CALL(af_info_string, str, verbose);
 }
@@ -98,6 +100,14 @@ af_err af_free_device_v2(void *ptr) { CALL(af_free_device_v2, ptr); }
 
 af_err af_free_pinned(void *ptr) { CALL(af_free_pinned, ptr); }
 
+af_err af_register_host_memory(void *ptr, const size_t bytes) {
+    CALL(af_register_host_memory, ptr, bytes);
+}
+
+af_err af_unregister_host_memory(void *ptr) {
+    CALL(af_unregister_host_memory, ptr);
+}
+
 af_err af_alloc_host(void **ptr, const dim_t bytes) {
     *ptr = malloc(bytes);  // NOLINT(hicpp-no-malloc)
     return (*ptr == NULL) ? AF_ERR_NO_MEM : AF_SUCCESS;
@@ -187,3 +197,74 @@ af_err af_set_kernel_cache_directory(const char *path, int override_eval) {
 af_err af_get_kernel_cache_directory(size_t *length, char *path) {
     CALL(af_get_kernel_cache_directory, length, path);
 }
+
+af_err af_prewarm_kernels(unsigned *num_modules) {
+    CALL(af_prewarm_kernels, num_modules);
+}
+
+af_err af_prewarm_kernels_async(af_kernel_batch *batch,
+                                const char *const *keys,
+                                const unsigned num_keys, const int device) {
+    CALL(af_prewarm_kernels_async, batch, keys, num_keys, device);
+}
+
+af_err af_wait_kernel_batch(unsigned *num_modules,
+                            const af_kernel_batch batch) {
+    CALL(af_wait_kernel_batch, num_modules, batch);
+}
+
+af_err af_release_kernel_batch(af_kernel_batch batch) {
+    CALL(af_release_kernel_batch, batch);
+}
+
+af_err af_set_jit_heuristic(af_jit_heuristic_fn fn, void *user_data) {
+    CALL(af_set_jit_heuristic, fn, user_data);
+}
+
+af_err af_get_jit_stats(af_jit_stats *stats, const int device) {
+    CALL(af_get_jit_stats, stats, device);
+}
+
+af_err af_reset_jit_stats(const int device) {
+    CALL(af_reset_jit_stats, device);
+}
+
+af_err af_set_mem_stats_enabled(const int enabled) {
+    CALL(af_set_mem_stats_enabled, enabled);
+}
+
+af_err af_get_mem_stats(af_mem_stats *stats, const int device) {
+    CALL(af_get_mem_stats, stats, device);
+}
+
+af_err af_reset_mem_stats(const int device) {
+    CALL(af_reset_mem_stats, device);
+}
+
+af_err af_set_mem_stats_site(const char *name) {
+    CALL(af_set_mem_stats_site, name);
+}
+
+af_err af_get_mem_stats_json(size_t *length, char *json, const int device) {
+    CALL(af_get_mem_stats_json, length, json, device);
+}
+
+af_err af_begin_memory_scope(const size_t bytes) {
+    CALL(af_begin_memory_scope, bytes);
+}
+
+af_err af_end_memory_scope() { CALL_NO_PARAMS(af_end_memory_scope); }
+
+af_err af_set_precision_mode(const af_precision_mode mode) {
+    CALL(af_set_precision_mode, mode);
+}
+
+af_err af_get_precision_mode(af_precision_mode *mode) {
+    CALL(af_get_precision_mode, mode);
+}
+
+af_err af_begin_precision_scope(const af_precision_mode mode) {
+    CALL(af_begin_precision_scope, mode);
+}
+
+af_err af_end_precision_scope() { CALL_NO_PARAMS(af_end_precision_scope); }
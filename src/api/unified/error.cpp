@@ -37,9 +37,13 @@ void af_get_last_error(char **str, dim_t *len) {
 
         if (len) { *len = slen; }
     } else {
-        // If false, the error is coming from active backend.
+        // If false, the error is coming from the backend of the last call,
+        // which is the active backend unless the placement policy is enabled
+        LibHandle handle = unified::getLastHandle();
+        if (!handle) { handle = unified::getActiveHandle(); }
         typedef void (*af_func)(char **, dim_t *);
-        auto func = reinterpret_cast<af_func>(LOAD_SYMBOL());
+        auto func = reinterpret_cast<af_func>(
+            common::getFunctionPointer(handle, __FUNCTION__));
         func(str, len);
     }
 }
@@ -29,3 +29,8 @@ af_err af_enqueue_wait_event(const af_event eventHandle) {
 af_err af_block_event(const af_event eventHandle) {
     CALL(af_block_event, eventHandle);
 }
+
+af_err af_event_elapsed_time(float* ms, const af_event start,
+                             const af_event end) {
+    CALL(af_event_elapsed_time, ms, start, end);
+}
@@ -0,0 +1,21 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/graph.h>
+#include "symbol_manager.hpp"
+
+af_err af_begin_capture() { CALL_NO_PARAMS(af_begin_capture); }
+
+af_err af_end_capture(af_graph* graph) { CALL(af_end_capture, graph); }
+
+af_err af_replay_graph(const af_graph graph) { CALL(af_replay_graph, graph); }
+
+af_err af_release_graph(af_graph graph) { CALL(af_release_graph, graph); }
+
+af_err af_is_capturing(bool* out) { CALL(af_is_capturing, out); }
@@ -21,6 +21,12 @@ af_err af_load_image(af_array *out, const char *filename, const bool isColor) {
     CALL(af_load_image, out, filename, isColor);
 }
 
+af_err af_load_images(af_array *out, const char **filenames,
+                      const unsigned count, const bool isColor,
+                      const af_dtype type) {
+    CALL(af_load_images, out, filenames, count, isColor, type);
+}
+
 af_err af_save_image(const char *filename, const af_array in) {
     CHECK_ARRAYS(in);
     CALL(af_save_image, filename, in);
@@ -57,6 +63,13 @@ af_err af_resize(af_array *out, const af_array in, const dim_t odim0,
     CALL(af_resize, out, in, odim0, odim1, method);
 }
 
+af_err af_pyramid(af_array *levels, const af_array in,
+                  const unsigned num_levels, const float scale_factor,
+                  const float sigma) {
+    CHECK_ARRAYS(in);
+    CALL(af_pyramid, levels, in, num_levels, scale_factor, sigma);
+}
+
 af_err af_transform(af_array *out, const af_array in, const af_array transform,
                     const dim_t odim0, const dim_t odim1,
                     const af_interp_type method, const bool inverse) {
@@ -111,6 +124,22 @@ af_err af_histogram(af_array *out, const af_array in, const unsigned nbins,
     CALL(af_histogram, out, in, nbins, minval, maxval);
 }
 
+af_err af_histogram_weighted(af_array *out, const af_array in,
+                             const af_array weights, const unsigned nbins,
+                             const double minval, const double maxval) {
+    CHECK_ARRAYS(in, weights);
+    CALL(af_histogram_weighted, out, in, weights, nbins, minval, maxval);
+}
+
+af_err af_histogram2(af_array *out, const af_array x, const af_array y,
+                     const af_array weights, const unsigned xbins,
+                     const unsigned ybins, const double xmin,
+                     const double xmax, const double ymin, const double ymax) {
+    CHECK_ARRAYS(x, y, weights);
+    CALL(af_histogram2, out, x, y, weights, xbins, ybins, xmin, xmax, ymin,
+         ymax);
+}
+
 af_err af_dilate(af_array *out, const af_array in, const af_array mask) {
     CHECK_ARRAYS(in, mask);
     CALL(af_dilate, out, in, mask);
@@ -137,6 +166,13 @@ af_err af_bilateral(af_array *out, const af_array in, const float spatial_sigma,
     CALL(af_bilateral, out, in, spatial_sigma, chromatic_sigma, isColor);
 }
 
+af_err af_bilateral_grid(af_array *out, const af_array in,
+                         const float spatial_sigma,
+                         const float chromatic_sigma, const float sampling) {
+    CHECK_ARRAYS(in);
+    CALL(af_bilateral_grid, out, in, spatial_sigma, chromatic_sigma, sampling);
+}
+
 af_err af_mean_shift(af_array *out, const af_array in,
                      const float spatial_sigma, const float chromatic_sigma,
                      const unsigned iter, const bool is_color) {
@@ -157,12 +193,36 @@ af_err af_maxfilt(af_array *out, const af_array in, const dim_t wind_length,
     CALL(af_maxfilt, out, in, wind_length, wind_width, edge_pad);
 }
 
+af_err af_box_filter(af_array *out, const af_array in, const dim_t wind_length,
+                     const dim_t wind_width) {
+    CHECK_ARRAYS(in);
+    CALL(af_box_filter, out, in, wind_length, wind_width);
+}
+
+af_err af_gaussian_filter(af_array *out, const af_array in,
+                          const double sigma_r, const double sigma_c) {
+    CHECK_ARRAYS(in);
+    CALL(af_gaussian_filter, out, in, sigma_r, sigma_c);
+}
+
 af_err af_regions(af_array *out, const af_array in,
                   const af_connectivity connectivity, const af_dtype ty) {
     CHECK_ARRAYS(in);
     CALL(af_regions, out, in, connectivity, ty);
 }
 
+af_err af_regions_stats(af_array *out, af_array *stats, const af_array in,
+                        const af_connectivity connectivity, const af_dtype ty) {
+    CHECK_ARRAYS(in);
+    CALL(af_regions_stats, out, stats, in, connectivity, ty);
+}
+
+af_err af_region_props(af_array *out, const af_array labels,
+                       const unsigned nlabels) {
+    CHECK_ARRAYS(labels);
+    CALL(af_region_props, out, labels, nlabels);
+}
+
 af_err af_sobel_operator(af_array *dx, af_array *dy, const af_array img,
                          const unsigned ker_size) {
     CHECK_ARRAYS(img);
@@ -186,6 +246,15 @@ af_err af_hist_equal(af_array *out, const af_array in, const af_array hist) {
     CALL(af_hist_equal, out, in, hist);
 }
 
+af_err af_clahe(af_array *out, const af_array in, const unsigned grid_rows,
+                const unsigned grid_cols, const float clip_limit,
+                const unsigned nbins, const double minval,
+                const double maxval) {
+    CHECK_ARRAYS(in);
+    CALL(af_clahe, out, in, grid_rows, grid_cols, clip_limit, nbins, minval,
+         maxval);
+}
+
 af_err af_gaussian_kernel(af_array *out, const int rows, const int cols,
                           const double sigma_r, const double sigma_c) {
     CALL(af_gaussian_kernel, out, rows, cols, sigma_r, sigma_c);
@@ -214,6 +283,14 @@ af_err af_unwrap(af_array *out, const af_array in, const dim_t wx,
     CALL(af_unwrap, out, in, wx, wy, sx, sy, px, py, is_column);
 }
 
+af_err af_unwrap_reduce(af_array *out, const af_array in, const dim_t wx,
+                        const dim_t wy, const dim_t sx, const dim_t sy,
+                        const dim_t px, const dim_t py,
+                        const af_binary_op op) {
+    CHECK_ARRAYS(in);
+    CALL(af_unwrap_reduce, out, in, wx, wy, sx, sy, px, py, op);
+}
+
 af_err af_wrap(af_array *out, const af_array in, const dim_t ox, const dim_t oy,
                const dim_t wx, const dim_t wy, const dim_t sx, const dim_t sy,
                const dim_t px, const dim_t py, const bool is_column) {
@@ -269,6 +346,17 @@ af_err af_iterative_deconv(af_array *out, const af_array in, const af_array ker,
     CALL(af_iterative_deconv, out, in, ker, iterations, relax_factor, algo);
 }
 
+af_err af_iterative_deconv_v2(af_array *out, unsigned *iterations,
+                              const af_array in, const af_array ker,
+                              const unsigned max_iterations,
+                              const float relax_factor,
+                              const af_iterative_deconv_algo algo,
+                              const double tol, const unsigned check_interval) {
+    CHECK_ARRAYS(in, ker);
+    CALL(af_iterative_deconv_v2, out, iterations, in, ker, max_iterations,
+         relax_factor, algo, tol, check_interval);
+}
+
 af_err af_inverse_deconv(af_array *out, const af_array in, const af_array psf,
                          const float gamma, const af_inverse_deconv_algo algo) {
     CHECK_ARRAYS(in, psf);
@@ -49,3 +49,12 @@ af_err af_get_allocated_bytes(size_t *bytes, const af_array arr) {
     CHECK_ARRAYS(arr);
     CALL(af_get_allocated_bytes, bytes, arr);
 }
+
+af_err af_from_dlpack(af_array *arr, void *tensor, void *stream) {
+    CALL(af_from_dlpack, arr, tensor, stream);
+}
+
+af_err af_to_dlpack(void **tensor, const af_array arr, void *stream) {
+    CHECK_ARRAYS(arr);
+    CALL(af_to_dlpack, tensor, arr, stream);
+}
@@ -21,6 +21,14 @@ af_err af_svd_inplace(af_array *u, af_array *s, af_array *vt, af_array in) {
     CALL(af_svd_inplace, u, s, vt, in);
 }
 
+af_err af_svd_randomized(af_array *u, af_array *s, af_array *vt,
+                         const af_array in, const unsigned rank,
+                         const unsigned oversampling,
+                         const unsigned iterations) {
+    CHECK_ARRAYS(in);
+    CALL(af_svd_randomized, u, s, vt, in, rank, oversampling, iterations);
+}
+
 af_err af_lu(af_array *lower, af_array *upper, af_array *pivot,
              const af_array in) {
     CHECK_ARRAYS(in);
@@ -65,6 +73,41 @@ af_err af_solve_lu(af_array *x, const af_array a, const af_array piv,
     CALL(af_solve_lu, x, a, piv, b, options);
 }
 
+af_err af_cg(af_array *x, unsigned *iterations, const af_array A,
+             const af_array b, const double tol, const unsigned max_iterations,
+             const af_precond_type precond_type, const af_array precond,
+             const af_array x0, const unsigned check_interval) {
+    CHECK_ARRAYS(A, b);
+    if (precond) { CHECK_ARRAYS(precond); }
+    if (x0) { CHECK_ARRAYS(x0); }
+    CALL(af_cg, x, iterations, A, b, tol, max_iterations, precond_type,
+         precond, x0, check_interval);
+}
+
+af_err af_bicgstab(af_array *x, unsigned *iterations, const af_array A,
+                   const af_array b, const double tol,
+                   const unsigned max_iterations,
+                   const af_precond_type precond_type, const af_array precond,
+                   const af_array x0, const unsigned check_interval) {
+    CHECK_ARRAYS(A, b);
+    if (precond) { CHECK_ARRAYS(precond); }
+    if (x0) { CHECK_ARRAYS(x0); }
+    CALL(af_bicgstab, x, iterations, A, b, tol, max_iterations, precond_type,
+         precond, x0, check_interval);
+}
+
+af_err af_gmres(af_array *x, unsigned *iterations, const af_array A,
+                const af_array b, const double tol,
+                const unsigned max_iterations, const unsigned restart,
+                const af_precond_type precond_type, const af_array precond,
+                const af_array x0, const unsigned check_interval) {
+    CHECK_ARRAYS(A, b);
+    if (precond) { CHECK_ARRAYS(precond); }
+    if (x0) { CHECK_ARRAYS(x0); }
+    CALL(af_gmres, x, iterations, A, b, tol, max_iterations, restart,
+         precond_type, precond, x0, check_interval);
+}
+
 af_err af_inverse(af_array *out, const af_array in, const af_mat_prop options) {
     CHECK_ARRAYS(in);
     CALL(af_inverse, out, in, options);
@@ -92,4 +135,21 @@ af_err af_norm(double *out, const af_array in, const af_norm_type type,
     CALL(af_norm, out, in, type, p, q);
 }
 
+af_err af_det_batched(af_array *out, const af_array in) {
+    CHECK_ARRAYS(in);
+    CALL(af_det_batched, out, in);
+}
+
+af_err af_log_det(af_array *log_abs, af_array *sign, const af_array in) {
+    CHECK_ARRAYS(in);
+    CALL(af_log_det, log_abs, sign, in);
+}
+
+af_err af_norm_batched(af_array *out, const af_array in,
+                       const af_norm_type type, const double p,
+                       const double q) {
+    CHECK_ARRAYS(in);
+    CALL(af_norm_batched, out, in, type, p, q);
+}
+
 af_err af_is_lapack_available(bool *out) { CALL(af_is_lapack_available, out); }
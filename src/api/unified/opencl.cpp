@@ -40,6 +40,20 @@ af_err afcl_get_queue(cl_command_queue* queue, const bool retain) {
     return AF_ERR_NOT_SUPPORTED;
 }
 
+af_err afcl_set_queue(cl_command_queue queue) {
+    af_backend backend;
+    af_get_active_backend(&backend);
+    if (backend == AF_BACKEND_OPENCL) { CALL(afcl_set_queue, queue); }
+    return AF_ERR_NOT_SUPPORTED;
+}
+
+af_err afcl_create_queue(cl_command_queue* queue) {
+    af_backend backend;
+    af_get_active_backend(&backend);
+    if (backend == AF_BACKEND_OPENCL) { CALL(afcl_create_queue, queue); }
+    return AF_ERR_NOT_SUPPORTED;
+}
+
 af_err afcl_get_device_id(cl_device_id* id) {
     af_backend backend;
     af_get_active_backend(&backend);
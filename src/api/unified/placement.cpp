@@ -0,0 +1,148 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include "placement.hpp"
+
+#include <common/module_loading.hpp>
+#include <af/array.h>
+#include <af/util.h>
+
+#include <array>
+#include <vector>
+
+using common::getFunctionPointer;
+
+using std::array;
+using std::vector;
+
+namespace unified {
+
+namespace {
+
+/// The functions of a backend library which move the arrays between the
+/// backends
+struct BackendApi {
+    decltype(&af_get_elements) getElements   = nullptr;
+    decltype(&af_is_sparse) isSparse         = nullptr;
+    decltype(&af_get_type) getType           = nullptr;
+    decltype(&af_get_dims) getDims           = nullptr;
+    decltype(&af_get_size_of) getSizeOf      = nullptr;
+    decltype(&af_get_data_ptr) getDataPtr    = nullptr;
+    decltype(&af_create_array) createArray   = nullptr;
+    decltype(&af_release_array) releaseArray = nullptr;
+};
+
+const BackendApi &getBackendApi(const af_backend backend) {
+    static const array<BackendApi, NUM_BACKENDS> apis = [] {
+        array<BackendApi, NUM_BACKENDS> out;
+        auto &instance = AFSymbolManager::getInstance();
+        for (int i = 0; i < NUM_BACKENDS; ++i) {
+            LibHandle handle = instance.getHandle(i);
+            if (!handle) { continue; }
+#define LOAD_API(MEMBER, FUNCTION)                              \
+    out[i].MEMBER = reinterpret_cast<decltype(out[i].MEMBER)>( \
+        getFunctionPointer(handle, #FUNCTION))
+            LOAD_API(getElements, af_get_elements);
+            LOAD_API(isSparse, af_is_sparse);
+            LOAD_API(getType, af_get_type);
+            LOAD_API(getDims, af_get_dims);
+            LOAD_API(getSizeOf, af_get_size_of);
+            LOAD_API(getDataPtr, af_get_data_ptr);
+            LOAD_API(createArray, af_create_array);
+            LOAD_API(releaseArray, af_release_array);
+#undef LOAD_API
+        }
+        return out;
+    }();
+    return apis[backend >> 1U];
+}
+
+/// Copies \p in to \p out on the backend of \p to through host memory
+af_err migrate(af_array *out, const af_array in, const BackendApi &from,
+               const BackendApi &to) {
+    af_dtype type;
+    dim_t dims[4];
+    dim_t elements;
+    size_t size;
+    if (af_err err = from.getType(&type, in)) { return err; }
+    if (af_err err =
+            from.getDims(&dims[0], &dims[1], &dims[2], &dims[3], in)) {
+        return err;
+    }
+    if (af_err err = from.getElements(&elements, in)) { return err; }
+    if (af_err err = from.getSizeOf(&size, type)) { return err; }
+
+    vector<char> host(elements * size);
+    if (af_err err = from.getDataPtr(host.data(), in)) { return err; }
+    return to.createArray(out, host.data(), 4, dims, type);
+}
+
+}  // namespace
+
+Placement::~Placement() {
+    if (m_count == 0) { return; }
+    const BackendApi &api = getBackendApi(m_backend);
+    for (int i = 0; i < m_count; ++i) { api.releaseArray(m_copies[i]); }
+}
+
+af_err Placement::placeArrays(af_array *const *arrays, const int count) {
+    const PlacementPolicy &policy = getPlacementPolicy();
+
+    af_backend largest = getActiveBackend();
+    dim_t elements     = -1;
+    bool sparse        = false;
+    for (int i = 0; i < count; ++i) {
+        if (*arrays[i] == 0) { continue; }
+        const af_backend backend = arrayBackend(*arrays[i]);
+        const BackendApi &api    = getBackendApi(backend);
+
+        bool isSparse = false;
+        dim_t size    = 0;
+        if (af_err err = api.isSparse(&isSparse, *arrays[i])) { return err; }
+        if (af_err err = api.getElements(&size, *arrays[i])) { return err; }
+        sparse |= isSparse;
+        if (size > elements) {
+            elements = size;
+            largest  = backend;
+        }
+    }
+
+    af_backend target = largest;
+    if (sparse) {
+        // The sparse arrays are not moved, so the call runs on their backend
+    } else if (elements >= policy.threshold) {
+        target = policy.gpu;
+    } else if (elements >= 0 && elements < policy.threshold / 4) {
+        target = AF_BACKEND_CPU;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (*arrays[i] == 0) { continue; }
+        const af_backend backend = arrayBackend(*arrays[i]);
+        if (backend == target) { continue; }
+        if (sparse) {
+            AF_RETURN_ERROR("Input array does not belong to current backend",
+                            AF_ERR_ARR_BKND_MISMATCH);
+        }
+
+        af_array copy = 0;
+        if (af_err err = migrate(&copy, *arrays[i], getBackendApi(backend),
+                                 getBackendApi(target))) {
+            return err;
+        }
+        m_backend           = target;
+        m_copies[m_count++] = copy;
+        *arrays[i]          = copy;
+    }
+
+    getCallBackend() = target;
+    return AF_SUCCESS;
+}
+
+}  // namespace unified
@@ -0,0 +1,73 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+#pragma once
+
+#include "symbol_manager.hpp"
+
+#include <af/defines.h>
+
+#include <array>
+
+namespace unified {
+
+/// Chooses the backend of a call from the size of its arrays and the
+/// backend which holds them.
+///
+/// Small arrays pay the launch and transfer latency of the GPU, and large
+/// ones are slow on the CPU. When AF_UNIFIED_PLACEMENT is set to auto, the
+/// calls whose largest array has at least AF_UNIFIED_PLACEMENT_THRESHOLD
+/// elements run on the GPU backend, the calls whose largest array has less
+/// than a quarter of it run on the CPU backend, and the calls in between
+/// run on the backend of their largest array, so the arrays near the
+/// threshold do not move back and forth. The arrays which are not on the
+/// chosen backend are copied to it when the call is made, and the results
+/// stay on that backend.
+class Placement {
+   public:
+    Placement() = default;
+    ~Placement();
+
+    Placement(const Placement &)            = delete;
+    Placement &operator=(const Placement &) = delete;
+
+    /// Sets the backend of the next call and replaces the \p arrays which
+    /// are not on it with their copies on it. The copies are released with
+    /// the Placement.
+    template<typename... Args>
+    af_err place(Args &...arrays) {
+        static_assert(sizeof...(Args) <= kMaxArrays, "Too many arrays");
+        af_array *handles[] = {&arrays...};
+        return placeArrays(handles, sizeof...(Args));
+    }
+
+   private:
+    static constexpr int kMaxArrays = 4;
+
+    af_err placeArrays(af_array *const *arrays, int count);
+
+    af_backend m_backend = AF_BACKEND_DEFAULT;
+    std::array<af_array, kMaxArrays> m_copies{};
+    int m_count = 0;
+};
+
+}  // namespace unified
+
+/// Chooses the backend of the call when the placement policy is enabled and
+/// checks the arrays like CHECK_ARRAYS otherwise. The arrays are the
+/// parameters of the function, which are replaced by their copies on the
+/// chosen backend, so they must not be declared const.
+///
+/// \param[in] Up to four af_arrays
+#define PLACE_ARRAYS(...)                                                  \
+    unified::Placement placement_;                                         \
+    if (unified::getPlacementPolicy().enabled) {                           \
+        if (af_err err_ = placement_.place(__VA_ARGS__)) { return err_; } \
+    } else {                                                               \
+        CHECK_ARRAYS(__VA_ARGS__);                                         \
+    }
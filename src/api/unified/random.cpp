@@ -66,6 +66,48 @@ af_err af_random_engine_get_seed(unsigned long long *const seed,
     CALL(af_random_engine_get_seed, seed, engine);
 }
 
+af_err af_random_engine_substream(af_random_engine *substream,
+                                  const af_random_engine engine,
+                                  const unsigned index, const unsigned count) {
+    CALL(af_random_engine_substream, substream, engine, index, count);
+}
+
+af_err af_random_engine_substreams(af_random_engine *substreams,
+                                   const af_random_engine engine,
+                                   const unsigned count) {
+    CALL(af_random_engine_substreams, substreams, engine, count);
+}
+
+af_err af_random_engine_skip(af_random_engine *engine,
+                             const unsigned long long n) {
+    CALL(af_random_engine_skip, engine, n);
+}
+
+af_err af_random_exponential(af_array *out, const af_array rate,
+                             af_random_engine engine) {
+    CHECK_ARRAYS(rate);
+    CALL(af_random_exponential, out, rate, engine);
+}
+
+af_err af_random_gamma(af_array *out, const af_array shape,
+                       const af_array scale, af_random_engine engine) {
+    CHECK_ARRAYS(shape, scale);
+    CALL(af_random_gamma, out, shape, scale, engine);
+}
+
+af_err af_random_poisson(af_array *out, const af_array lambda,
+                         af_random_engine engine) {
+    CHECK_ARRAYS(lambda);
+    CALL(af_random_poisson, out, lambda, engine);
+}
+
+af_err af_random_truncated_normal(af_array *out, const af_array lower,
+                                  const af_array upper,
+                                  af_random_engine engine) {
+    CHECK_ARRAYS(lower, upper);
+    CALL(af_random_truncated_normal, out, lower, upper, engine);
+}
+
 af_err af_randu(af_array *out, const unsigned ndims, const dim_t *const dims,
                 const af_dtype type) {
     CALL(af_randu, out, ndims, dims, type);
@@ -0,0 +1,49 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/array.h>
+#include <af/sharded.h>
+#include "symbol_manager.hpp"
+
+af_err af_create_sharded_array(af_sharded_array *out, const af_array in,
+                               const unsigned num_devices,
+                               const int *devices) {
+    CHECK_ARRAYS(in);
+    CALL(af_create_sharded_array, out, in, num_devices, devices);
+}
+
+af_err af_release_sharded_array(af_sharded_array arr) {
+    CALL(af_release_sharded_array, arr);
+}
+
+af_err af_get_sharded_info(unsigned *num_shards, int *dim, dim_t *dims,
+                           const af_sharded_array arr) {
+    CALL(af_get_sharded_info, num_shards, dim, dims, arr);
+}
+
+af_err af_get_shard(af_array *shard, const af_sharded_array arr,
+                    const unsigned index) {
+    CALL(af_get_shard, shard, arr, index);
+}
+
+af_err af_sharded_map(af_sharded_array *out, const unsigned num_inputs,
+                      const af_sharded_array *ins, af_shard_fn fn,
+                      void *user_data) {
+    CALL(af_sharded_map, out, num_inputs, ins, fn, user_data);
+}
+
+af_err af_sharded_reduce(af_array *out, const af_sharded_array in,
+                         const af_binary_op op, const int device) {
+    CALL(af_sharded_reduce, out, in, op, device);
+}
+
+af_err af_sharded_gather(af_array *out, const af_sharded_array in,
+                         const int device) {
+    CALL(af_sharded_gather, out, in, device);
+}
@@ -78,10 +78,47 @@ af_err af_approx2_uniform_v2(af_array *zo, const af_array zi, const af_array xo,
          yi_beg, yi_step, method, offGrid);
 }
 
+af_err af_create_approx1_plan(af_interp_plan *plan, const af_array pos,
+                              const dim_t in_length,
+                              const af_interp_type method,
+                              const float off_grid) {
+    CHECK_ARRAYS(pos);
+    CALL(af_create_approx1_plan, plan, pos, in_length, method, off_grid);
+}
+
+af_err af_create_approx2_plan(af_interp_plan *plan, const af_array pos0,
+                              const af_array pos1, const dim_t in_rows,
+                              const dim_t in_cols,
+                              const af_interp_type method,
+                              const float off_grid) {
+    CHECK_ARRAYS(pos0, pos1);
+    CALL(af_create_approx2_plan, plan, pos0, pos1, in_rows, in_cols, method,
+         off_grid);
+}
+
+af_err af_apply_interp_plan(af_array *out, const af_interp_plan plan,
+                            const af_array in) {
+    CHECK_ARRAYS(in);
+    CALL(af_apply_interp_plan, out, plan, in);
+}
+
+af_err af_release_interp_plan(af_interp_plan plan) {
+    CALL(af_release_interp_plan, plan);
+}
+
 af_err af_set_fft_plan_cache_size(size_t cache_size) {
     CALL(af_set_fft_plan_cache_size, cache_size);
 }
 
+af_err af_set_fft_plan_cache_bytes(size_t cache_bytes) {
+    CALL(af_set_fft_plan_cache_bytes, cache_bytes);
+}
+
+af_err af_prepare_fft_plan(const unsigned ndims, const dim_t *const dims,
+                           const int rank, const af_dtype type) {
+    CALL(af_prepare_fft_plan, ndims, dims, rank, type);
+}
+
 #define FFT_HAPI_DEF(af_func)                               \
     af_err af_func(af_array in, const double norm_factor) { \
         CHECK_ARRAYS(in);                                   \
@@ -172,6 +209,14 @@ CONV_HAPI_DEF(af_convolve1)
 CONV_HAPI_DEF(af_convolve2)
 CONV_HAPI_DEF(af_convolve3)
 
+af_err af_export_convolve_tuning(const char *path) {
+    CALL(af_export_convolve_tuning, path);
+}
+
+af_err af_import_convolve_tuning(const char *path) {
+    CALL(af_import_convolve_tuning, path);
+}
+
 af_err af_convolve2_nn(af_array *out, const af_array signal,
                        const af_array filter, const unsigned stride_dims,
                        const dim_t *strides, const unsigned padding_dims,
@@ -207,6 +252,34 @@ FFT_CONV_HAPI_DEF(af_fft_convolve1)
 FFT_CONV_HAPI_DEF(af_fft_convolve2)
 FFT_CONV_HAPI_DEF(af_fft_convolve3)
 
+af_err af_fft_convolve1_block(af_array *out, const af_array signal,
+                              const af_array filter, const dim_t block_size,
+                              const af_conv_mode mode) {
+    CHECK_ARRAYS(signal, filter);
+    CALL(af_fft_convolve1_block, out, signal, filter, block_size, mode);
+}
+
+af_err af_create_convolve_stream(af_convolve_stream *stream,
+                                 const af_array filter,
+                                 const dim_t block_size) {
+    CHECK_ARRAYS(filter);
+    CALL(af_create_convolve_stream, stream, filter, block_size);
+}
+
+af_err af_convolve_stream_push(af_array *out, af_convolve_stream stream,
+                               const af_array chunk) {
+    CHECK_ARRAYS(chunk);
+    CALL(af_convolve_stream_push, out, stream, chunk);
+}
+
+af_err af_convolve_stream_reset(af_convolve_stream stream) {
+    CALL(af_convolve_stream_reset, stream);
+}
+
+af_err af_release_convolve_stream(af_convolve_stream stream) {
+    CALL(af_release_convolve_stream, stream);
+}
+
 af_err af_convolve2_sep(af_array *out, const af_array col_filter,
                         const af_array row_filter, const af_array signal,
                         const af_conv_mode mode) {
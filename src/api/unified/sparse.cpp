@@ -39,6 +39,14 @@ af_err af_sparse_convert_to(af_array *out, const af_array in,
     CALL(af_sparse_convert_to, out, in, destStorage);
 }
 
+af_err af_sparse_convert_to_blocked(af_array *out, const af_array in,
+                                    const af_storage destStorage,
+                                    const int blockSize, const int sortWindow) {
+    CHECK_ARRAYS(in);
+    CALL(af_sparse_convert_to_blocked, out, in, destStorage, blockSize,
+         sortWindow);
+}
+
 af_err af_sparse_to_dense(af_array *out, const af_array in) {
     CHECK_ARRAYS(in);
     CALL(af_sparse_to_dense, out, in);
@@ -74,3 +82,30 @@ af_err af_sparse_get_storage(af_storage *out, const af_array in) {
     CHECK_ARRAYS(in);
     CALL(af_sparse_get_storage, out, in);
 }
+
+af_err af_sparse_set_values(af_array arr, const af_array values) {
+    CHECK_ARRAYS(arr, values);
+    CALL(af_sparse_set_values, arr, values);
+}
+
+af_err af_sparse_insert(af_array arr, const af_array values,
+                        const af_array rowIdx, const af_array colIdx) {
+    CHECK_ARRAYS(arr, values, rowIdx, colIdx);
+    CALL(af_sparse_insert, arr, values, rowIdx, colIdx);
+}
+
+af_err af_sparse_remove(af_array arr, const af_array rowIdx,
+                        const af_array colIdx) {
+    CHECK_ARRAYS(arr, rowIdx, colIdx);
+    CALL(af_sparse_remove, arr, rowIdx, colIdx);
+}
+
+af_err af_sparse_ilu0(af_array *out, const af_array in) {
+    CHECK_ARRAYS(in);
+    CALL(af_sparse_ilu0, out, in);
+}
+
+af_err af_sparse_ic0(af_array *out, const af_array in) {
+    CHECK_ARRAYS(in);
+    CALL(af_sparse_ic0, out, in);
+}
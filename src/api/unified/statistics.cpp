@@ -62,6 +62,12 @@ af_err af_median(af_array *out, const af_array in, const dim_t dim) {
     CALL(af_median, out, in, dim);
 }
 
+af_err af_quantile(af_array *out, const af_array in, const double q,
+                   const dim_t dim) {
+    CHECK_ARRAYS(in);
+    CALL(af_quantile, out, in, q, dim);
+}
+
 af_err af_mean_all(double *real, double *imag, const af_array in) {
     CHECK_ARRAYS(in);
     CALL(af_mean_all, real, imag, in);
@@ -99,6 +105,12 @@ af_err af_median_all(double *realVal, double *imagVal, const af_array in) {
     CALL(af_median_all, realVal, imagVal, in);
 }
 
+af_err af_quantile_all(double *realVal, double *imagVal, const af_array in,
+                       const double q) {
+    CHECK_ARRAYS(in);
+    CALL(af_quantile_all, realVal, imagVal, in, q);
+}
+
 af_err af_corrcoef(double *realVal, double *imagVal, const af_array X,
                    const af_array Y) {
     CHECK_ARRAYS(X, Y);
@@ -15,7 +15,9 @@
 #include <common/module_loading.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <functional>
 #include <string>
 #include <type_traits>
@@ -179,6 +181,47 @@ LibHandle& getActiveHandle() {
     return activeHandle;
 }
 
+af_backend& getCallBackend() {
+    thread_local af_backend callBackend = AF_BACKEND_DEFAULT;
+    return callBackend;
+}
+
+LibHandle& getLastHandle() {
+    thread_local LibHandle lastHandle = nullptr;
+    return lastHandle;
+}
+
+const PlacementPolicy& getPlacementPolicy() {
+    static const PlacementPolicy policy = [] {
+        // The crossover of the launch latency of the GPU and the throughput
+        // of the CPU for the element wise functions
+        constexpr dim_t defaultThreshold = 1 << 15;
+
+        PlacementPolicy out;
+        auto& instance = AFSymbolManager::getInstance();
+        af_backend gpu = instance.getDefaultBackend();
+        if (getEnvVar("AF_UNIFIED_PLACEMENT") != "auto" ||
+            gpu == AF_BACKEND_CPU || gpu == AF_BACKEND_DEFAULT ||
+            !instance.getHandle(AF_BACKEND_CPU >> 1U)) {
+            return out;
+        }
+        string threshold = getEnvVar("AF_UNIFIED_PLACEMENT_THRESHOLD");
+        out.enabled      = true;
+        out.gpu          = gpu;
+        out.threshold    = defaultThreshold;
+        if (!threshold.empty()) {
+            out.threshold = std::max<dim_t>(
+                1, std::strtoll(threshold.c_str(), nullptr, 10));
+        }
+
+        auto getLogger = [&] { return instance.getLogger(); };
+        AF_TRACE("AF_UNIFIED_PLACEMENT: {} from {} elements",
+                 getBackendDirectoryName(gpu), out.threshold);
+        return out;
+    }();
+    return policy;
+}
+
 AFSymbolManager::AFSymbolManager()
     : defaultHandle(nullptr)
     , numBackends(0)
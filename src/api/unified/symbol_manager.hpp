@@ -84,20 +84,60 @@ af::Backend& getActiveBackend();
 
 LibHandle& getActiveHandle();
 
+/// The opt-in policy which runs each call on the CPU or the GPU backend
+/// instead of the active backend. See placement.hpp
+struct PlacementPolicy {
+    bool enabled = false;
+    /// The backend of the calls on large arrays
+    af_backend gpu = AF_BACKEND_DEFAULT;
+    /// The number of elements from which a call runs on \p gpu
+    dim_t threshold = 0;
+};
+
+/// Returns the policy read from AF_UNIFIED_PLACEMENT and
+/// AF_UNIFIED_PLACEMENT_THRESHOLD
+const PlacementPolicy& getPlacementPolicy();
+
+/// The backend of the next call of the calling thread when it is not the
+/// active backend, and AF_BACKEND_DEFAULT otherwise. It is set by
+/// CHECK_ARRAYS and PLACE_ARRAYS when the placement policy is enabled and
+/// is reset by CALL.
+af_backend& getCallBackend();
+
+/// The library of the last call of the calling thread, which holds the
+/// error of the call
+LibHandle& getLastHandle();
+
+/// Returns the library of the current call and sets \p backend to its
+/// backend
+inline LibHandle getCallHandle(af_backend& backend) {
+    af_backend& callBackend = getCallBackend();
+    if (callBackend == AF_BACKEND_DEFAULT) {
+        backend = getActiveBackend();
+        return getActiveHandle();
+    }
+    backend     = callBackend;
+    callBackend = AF_BACKEND_DEFAULT;
+    return AFSymbolManager::getInstance().getHandle(backend >> 1U);
+}
+
 namespace {
-bool checkArray(af_backend activeBackend, const af_array a) {
-    // Convert af_array into int to retrieve the backend info.
-    // See ArrayInfo.hpp for more
-    af_backend backend = (af_backend)0;
+af_backend arrayBackend(const af_array a) {
+    // The backend is encoded in the bits above the device id of the first
+    // member of every handle, so it is read directly instead of dispatching
+    // af_get_backend_id to the backend library. See ArrayInfo.hpp for more
+    unsigned devId = *static_cast<const unsigned*>(a);
+    return static_cast<af_backend>(devId >> 8U);
+}
 
+bool checkArray(af_backend activeBackend, const af_array a) {
     // This condition is required so that the invalid args tests for unified
     // backend return the expected error rather than AF_ERR_ARR_BKND_MISMATCH
     // Since a = 0, does not have a backend specified, it should be a
     // AF_ERR_ARG instead of AF_ERR_ARR_BKND_MISMATCH
     if (a == 0) return true;
 
-    af_get_backend_id(&backend, a);
-    return backend == activeBackend;
+    return arrayBackend(a) == activeBackend;
 }
 
 [[gnu::unused]] bool checkArray(af_backend activeBackend, const af_array* a) {
@@ -121,6 +161,31 @@ bool checkArrays(af_backend activeBackend, T a, Args... arg) {
     return checkArray(activeBackend, a) && checkArrays(activeBackend, arg...);
 }
 
+namespace {
+[[gnu::unused]] af_backend arraysBackend(af_backend activeBackend) {
+    return activeBackend;
+}
+
+[[gnu::unused]] af_backend arraysBackend(af_backend activeBackend,
+                                         const af_array a) {
+    return a ? arrayBackend(a) : activeBackend;
+}
+
+[[gnu::unused]] af_backend arraysBackend(af_backend activeBackend,
+                                         const af_array* a) {
+    return a ? arraysBackend(activeBackend, *a) : activeBackend;
+}
+
+/// Returns the backend of the first array which is not on \p activeBackend,
+/// or \p activeBackend if all the arrays are on it
+template<typename T, typename U, typename... Args>
+af_backend arraysBackend(af_backend activeBackend, T a, U b, Args... arg) {
+    af_backend backend = arraysBackend(activeBackend, a);
+    return backend != activeBackend ? backend
+                                    : arraysBackend(activeBackend, b, arg...);
+}
+}  // namespace
+
 }  // namespace unified
 
 /// Checks if the active backend and the af_arrays are the same.
@@ -129,30 +194,40 @@ bool checkArrays(af_backend activeBackend, T a, Args... arg) {
 /// not match, an error is returned. This macro accepts pointer to af_arrays
 /// and af_arrays. Null pointers to af_arrays are considered acceptable.
 ///
+/// When the placement policy is enabled, the arrays have to be on the same
+/// backend, which runs the call, instead of the active backend.
+///
 /// \param[in] Any number of af_arrays or pointer to af_arrays
 #define CHECK_ARRAYS(...)                                                     \
     do {                                                                      \
         af_backend backendId = unified::getActiveBackend();                   \
-        if (!unified::checkArrays(backendId, __VA_ARGS__))                    \
+        if (unified::getPlacementPolicy().enabled) {                          \
+            backendId = unified::arraysBackend(backendId, __VA_ARGS__);       \
+            unified::getCallBackend() = backendId;                            \
+        }                                                                     \
+        if (!unified::checkArrays(backendId, __VA_ARGS__)) {                  \
+            unified::getCallBackend() = AF_BACKEND_DEFAULT;                   \
             AF_RETURN_ERROR("Input array does not belong to current backend", \
                             AF_ERR_ARR_BKND_MISMATCH);                        \
+        }                                                                     \
     } while (0)
 
-#define CALL(FUNCTION, ...)                                                      \
-    using af_func                  = std::add_pointer<decltype(FUNCTION)>::type; \
-    thread_local af_backend index_ = unified::getActiveBackend();                \
-    if (unified::getActiveHandle()) {                                            \
-        thread_local af_func func = (af_func)common::getFunctionPointer(         \
-            unified::getActiveHandle(), __func__);                               \
-        if (index_ != unified::getActiveBackend()) {                             \
-            index_ = unified::getActiveBackend();                                \
-            func   = (af_func)common::getFunctionPointer(                        \
-                unified::getActiveHandle(), __func__);                         \
-        }                                                                        \
-        return func(__VA_ARGS__);                                                \
-    } else {                                                                     \
-        AF_RETURN_ERROR("ArrayFire couldn't locate any backends.",               \
-                        AF_ERR_LOAD_LIB);                                        \
+// The function pointers are cached for each backend, so the calls which
+// alternate between backends do not look them up again
+#define CALL(FUNCTION, ...)                                                \
+    using af_func       = std::add_pointer<decltype(FUNCTION)>::type;      \
+    af_backend backend_ = AF_BACKEND_DEFAULT;                              \
+    if (LibHandle handle_ = unified::getCallHandle(backend_)) {            \
+        thread_local af_func funcs_[unified::NUM_BACKENDS]{};              \
+        af_func& func = funcs_[unified::backend_index(backend_)];          \
+        if (!func) {                                                       \
+            func = (af_func)common::getFunctionPointer(handle_, __func__); \
+        }                                                                  \
+        unified::getLastHandle() = handle_;                                \
+        return func(__VA_ARGS__);                                          \
+    } else {                                                               \
+        AF_RETURN_ERROR("ArrayFire couldn't locate any backends.",         \
+                        AF_ERR_LOAD_LIB);                                  \
     }
 
 #define CALL_NO_PARAMS(FUNCTION) CALL(FUNCTION)
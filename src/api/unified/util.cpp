@@ -42,6 +42,45 @@ af_err af_read_array_key_check(int *index, const char *filename,
     CALL(af_read_array_key_check, index, filename, key);
 }
 
+af_err af_save_array_chunked(int *index, const char *key, const af_array arr,
+                             const char *filename, const bool append,
+                             const af_compression_type compression,
+                             const dim_t chunk_bytes) {
+    CHECK_ARRAYS(arr);
+    CALL(af_save_array_chunked, index, key, arr, filename, append, compression,
+         chunk_bytes);
+}
+
+af_err af_save_array_async(af_save_handle *handle, const char *key,
+                           const af_array arr, const char *filename,
+                           const bool append) {
+    CHECK_ARRAYS(arr);
+    CALL(af_save_array_async, handle, key, arr, filename, append);
+}
+
+af_err af_wait_save(int *index, const af_save_handle handle) {
+    CALL(af_wait_save, index, handle);
+}
+
+af_err af_release_save(af_save_handle handle) {
+    CALL(af_release_save, handle);
+}
+
+af_err af_read_array_range(af_array *out, const char *filename,
+                           const unsigned index, const unsigned ndims,
+                           const af_seq *const indices) {
+    CALL(af_read_array_range, out, filename, index, ndims, indices);
+}
+
+af_err af_read_mtx(af_array *out, const char *filename, const af_dtype type) {
+    CALL(af_read_mtx, out, filename, type);
+}
+
+af_err af_read_csv(af_array *out, const char *filename, const af_dtype type,
+                   const char delimiter, const unsigned skip_rows) {
+    CALL(af_read_csv, out, filename, type, delimiter, skip_rows);
+}
+
 af_err af_array_to_string(char **output, const char *exp, const af_array arr,
                           const int precision, const bool transpose) {
     CHECK_ARRAYS(arr);
@@ -36,6 +36,15 @@ af_err af_orb(af_features *feat, af_array *desc, const af_array in,
          blur_img);
 }
 
+af_err af_orb_batch(af_features *feat, af_array *desc, af_array *counts,
+                    const af_array in, const float fast_thr,
+                    const unsigned max_feat, const float scl_fctr,
+                    const unsigned levels, const bool blur_img) {
+    CHECK_ARRAYS(in);
+    CALL(af_orb_batch, feat, desc, counts, in, fast_thr, max_feat, scl_fctr,
+         levels, blur_img);
+}
+
 af_err af_sift(af_features *feat, af_array *desc, const af_array in,
                const unsigned n_layers, const float contrast_thr,
                const float edge_thr, const float init_sigma,
@@ -101,3 +110,14 @@ af_err af_homography(af_array *H, int *inliers, const af_array x_src,
     CALL(af_homography, H, inliers, x_src, y_src, x_dst, y_dst, htype,
          inlier_thr, iterations, type);
 }
+
+af_err af_homography_batch(af_array *H, af_array *inliers,
+                           const af_array x_src, const af_array y_src,
+                           const af_array x_dst, const af_array y_dst,
+                           const af_homography_type htype,
+                           const float inlier_thr, const unsigned iterations,
+                           const af_dtype type) {
+    CHECK_ARRAYS(x_src, y_src, x_dst, y_dst);
+    CALL(af_homography_batch, H, inliers, x_src, y_src, x_dst, y_dst, htype,
+         inlier_thr, iterations, type);
+}
@@ -33,6 +33,22 @@ class AllocatorInterface {
     virtual size_t getMaxMemorySize(int id)       = 0;
     virtual void *nativeAlloc(const size_t bytes) = 0;
     virtual void nativeFree(void *ptr)            = 0;
+    // Returns the memory of the device which is not used by any process, or 0
+    // when the device does not report it
+    virtual size_t getFreeMemorySize(int id) {
+        (void)id;
+        return 0;
+    }
+    // Returns a buffer of \p bytes at \p offset bytes of the buffer \p ptr.
+    // The default fits the backends whose buffers are device pointers.
+    virtual void *nativeSubAlloc(void *ptr, size_t offset, size_t bytes) {
+        (void)bytes;
+        return static_cast<char *>(ptr) + offset;
+    }
+    // Releases a buffer returned by nativeSubAlloc
+    virtual void nativeSubFree(void *ptr) { (void)ptr; }
+    // The alignment of the offsets passed to nativeSubAlloc
+    virtual size_t getSubAllocAlignment() { return 256; }
     virtual spdlog::logger *getLogger() final { return this->logger.get(); }
 
    protected:
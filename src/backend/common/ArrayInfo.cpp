@@ -30,12 +30,6 @@ dim4 calcStrides(const dim4 &parentDim) {
     return out;
 }
 
-unsigned ArrayInfo::getDevId() const {
-    // The actual device ID is only stored in the first 8 bits of devId
-    // See ArrayInfo.hpp for more
-    return devId & 0xffU;
-}
-
 void ArrayInfo::setId(int id) const {
     // 1 << (backendId + 8) sets the 9th, 10th or 11th bit of devId to 1
     // for CPU, CUDA and OpenCL respectively
@@ -104,7 +98,7 @@ bool ArrayInfo::isSingle() const { return (type == f32 || type == c32); }
 bool ArrayInfo::isHalf() const { return (type == f16); }
 
 bool ArrayInfo::isRealFloating() const {
-    return (type == f64 || type == f32 || type == f16);
+    return (type == f64 || type == f32 || type == f16 || type == bf16);
 }
 
 bool ArrayInfo::isFloating() const { return (!isInteger() && !isBool()); }
@@ -127,8 +121,6 @@ bool ArrayInfo::isLinear() const {
     return true;
 }
 
-bool ArrayInfo::isSparse() const { return is_sparse; }
-
 dim4 getOutDims(const dim4 &ldims, const dim4 &rdims, bool batchMode) {
     if (!batchMode) {
         DIM_ASSERT(1, ldims == rdims);
@@ -176,13 +168,30 @@ dim4 toOffset(const vector<af_seq> &seqs, const dim4 &parentDims) {
 }
 
 dim4 toStride(const vector<af_seq> &seqs, const af::dim4 &parentDims) {
-    dim4 out(calcStrides(parentDims));
+    return toViewStride(seqs, calcStrides(parentDims));
+}
+
+dim4 toViewStride(const vector<af_seq> &seqs, const af::dim4 &parentStrides) {
+    dim4 out(parentStrides);
     for (unsigned i = 0; i < seqs.size(); i++) {
         if (seqs[i].step != 0) { out[i] *= seqs[i].step; }
     }
     return out;
 }
 
+bool isPitchedView(const dim4 &dims, const dim4 &strides, dim4 &pitch) {
+    pitch = strides;
+    if (pitch[0] != 1) { return false; }
+
+    // The strides of the singleton dimensions are never used
+    if (dims[1] == 1) { pitch[1] = dims[0]; }
+    if (dims[2] == 1) { pitch[2] = pitch[1] * dims[1]; }
+    if (dims[3] == 1) { pitch[3] = pitch[2] * dims[2]; }
+
+    return pitch[1] >= dims[0] && pitch[2] >= pitch[1] * dims[1] &&
+           pitch[3] == pitch[2] * dims[2];
+}
+
 const ArrayInfo &getInfo(const af_array arr, bool sparse_check,
                          bool device_check) {
     const ArrayInfo *info =
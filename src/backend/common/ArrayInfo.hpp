@@ -117,7 +117,9 @@ class ArrayInfo {
     const af::dim4& dims() const { return dim_size; }
     size_t total() const { return offset + dim_strides[3] * dim_size[3]; }
 
-    unsigned getDevId() const;
+    // The actual device ID is only stored in the first 8 bits of devId.
+    // Inlined because every C API call checks it through getInfo
+    unsigned getDevId() const { return devId & 0xffU; }
 
     void setId(int id) const;
 
@@ -167,7 +169,7 @@ class ArrayInfo {
 
     bool isLinear() const;
 
-    bool isSparse() const;
+    bool isSparse() const { return is_sparse; }
 };
 static_assert(std::is_standard_layout<ArrayInfo>::value,
               "ArrayInfo must be a standard layout type");
@@ -177,3 +179,15 @@ af::dim4 toDims(const std::vector<af_seq>& seqs, const af::dim4& parentDims);
 af::dim4 toOffset(const std::vector<af_seq>& seqs, const af::dim4& parentDims);
 
 af::dim4 toStride(const std::vector<af_seq>& seqs, const af::dim4& parentDims);
+
+/// Returns the strides of the view \p seqs of an array with the strides
+/// \p parentStrides, which can be a view itself
+af::dim4 toViewStride(const std::vector<af_seq>& seqs,
+                      const af::dim4& parentStrides);
+
+/// Returns true if a view with \p dims and \p strides can be copied with a
+/// single rectangular (pitched) copy: its columns are contiguous and its
+/// last two dimensions can be merged. \p pitch gets the strides of the copy,
+/// in which the strides of the singleton dimensions are made consistent.
+bool isPitchedView(const af::dim4& dims, const af::dim4& strides,
+                   af::dim4& pitch);
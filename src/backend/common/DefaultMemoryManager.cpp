@@ -16,12 +16,20 @@
 #include <af/event.h>
 #include <af/memory.h>
 
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
 
 using std::max;
+using std::min;
+using std::make_shared;
 using std::move;
+using std::numeric_limits;
+using std::stod;
 using std::stoi;
 using std::string;
 using std::vector;
@@ -33,6 +41,34 @@ DefaultMemoryManager::getCurrentMemoryInfo() {
     return memory[this->getActiveDeviceId()];
 }
 
+void DefaultMemoryManager::updateFreeBytes(memory_info &current, bool force) {
+    {
+        lock_guard_t lock(this->memory_mutex);
+        if (!force && current.free_query_countdown > 0) {
+            current.free_query_countdown--;
+            return;
+        }
+        current.free_query_countdown = FREE_MEMORY_QUERY_INTERVAL;
+    }
+
+    // The device is queried outside of the lock
+    const size_t free_bytes =
+        this->getFreeMemorySize(this->getActiveDeviceId());
+    lock_guard_t lock(this->memory_mutex);
+    current.free_bytes = free_bytes;
+}
+
+size_t DefaultMemoryManager::lockableBytes(const memory_info &current) {
+    const size_t limit = current.max_bytes > current.lock_bytes
+                             ? current.max_bytes - current.lock_bytes
+                             : 0;
+    if (current.free_bytes == 0) { return limit; }
+    const size_t cached = current.total_bytes > current.lock_bytes
+                              ? current.total_bytes - current.lock_bytes
+                              : 0;
+    return min(limit, current.free_bytes + cached);
+}
+
 void DefaultMemoryManager::cleanDeviceMemoryManager(int device) {
     if (this->debug_mode) { return; }
 
@@ -44,6 +80,22 @@ void DefaultMemoryManager::cleanDeviceMemoryManager(int device) {
     DefaultMemoryManager::memory_info &current = memory[device];
     {
         lock_guard_t lock(this->memory_mutex);
+        // The free buffers of the caches of the threads are released too.
+        // The caches of the threads which exited are dropped once all of
+        // their buffers are unlocked.
+        for (const cache_ptr &cache : caches) {
+            if (cache->device == device) { flushCache(current, *cache, 0); }
+        }
+        caches.erase(
+            std::remove_if(caches.begin(), caches.end(),
+                           [device](const cache_ptr &cache) {
+                               lock_guard_t cache_lock(cache->mutex);
+                               return cache->device == device &&
+                                      cache.use_count() == 1 &&
+                                      cache->locked_map.empty();
+                           }),
+            caches.end());
+
         // Return if all buffers are locked
         if (current.total_buffers == current.lock_buffers) { return; }
         free_ptrs.reserve(current.free_map.size());
@@ -60,6 +112,7 @@ void DefaultMemoryManager::cleanDeviceMemoryManager(int device) {
             current.total_buffers -= num_ptrs;
         }
         current.free_map.clear();
+        if (current.free_bytes != 0) { current.free_bytes += bytes_freed; }
     }
 
     AF_TRACE("GC: Clearing {} buffers {}", free_ptrs.size(),
@@ -72,8 +125,14 @@ DefaultMemoryManager::DefaultMemoryManager(int num_devices,
                                            unsigned max_buffers, bool debug)
     : mem_step_size(1024)
     , max_buffers(max_buffers)
+    , max_slack_ratio(0.125)
     , debug_mode(debug)
+    , stats_enabled(false)
+    , thread_cache_bytes(64 << 20)
     , memory(num_devices) {
+    static std::atomic<unsigned> instances(0);
+    this->instance_id = instances++;
+
     // Check for environment variables
 
     // Debug mode
@@ -84,6 +143,21 @@ DefaultMemoryManager::DefaultMemoryManager(int num_devices,
     // Max Buffer count
     env_var = getEnvVar("AF_MAX_BUFFERS");
     if (!env_var.empty()) { this->max_buffers = max(1, stoi(env_var)); }
+
+    // Slack allowed when reusing larger buffers
+    env_var = getEnvVar("AF_MEM_MAX_SLACK_RATIO");
+    if (!env_var.empty()) { this->max_slack_ratio = max(0.0, stod(env_var)); }
+
+    // Memory statistics
+    env_var = getEnvVar("AF_MEM_STATS");
+    if (!env_var.empty()) { this->stats_enabled = env_var[0] != '0'; }
+
+    // Free buffers kept by each thread
+    env_var = getEnvVar("AF_MEM_THREAD_CACHE_MB");
+    if (!env_var.empty()) {
+        this->thread_cache_bytes = static_cast<size_t>(max(0, stoi(env_var)))
+                                   << 20;
+    }
 }
 
 void DefaultMemoryManager::initialize() { this->setMaxMemorySize(); }
@@ -127,18 +201,21 @@ void DefaultMemoryManager::setMaxMemorySize() {
 float DefaultMemoryManager::getMemoryPressure() {
     lock_guard_t lock(this->memory_mutex);
     memory_info &current = this->getCurrentMemoryInfo();
-    if (current.lock_bytes > current.max_bytes ||
-        current.lock_buffers > max_buffers) {
-        return 1.0;
-    } else {
-        return 0.0;
-    }
+    if (current.lock_buffers > max_buffers) { return 1.0; }
+
+    // The fraction of the memory which can be locked that is locked
+    const size_t lockable = lockableBytes(current);
+    if (lockable == 0) { return 1.0; }
+    return static_cast<float>(current.lock_bytes) /
+           static_cast<float>(current.lock_bytes + lockable);
 }
 
 bool DefaultMemoryManager::jitTreeExceedsMemoryPressure(size_t bytes) {
     lock_guard_t lock(this->memory_mutex);
     memory_info &current = this->getCurrentMemoryInfo();
-    return 2 * bytes > current.lock_bytes;
+    // The buffers of the tree hold most of the locked memory, or more memory
+    // than the device has left
+    return 2 * bytes > current.lock_bytes || bytes > lockableBytes(current);
 }
 
 void *DefaultMemoryManager::alloc(bool user_lock, const unsigned ndims,
@@ -151,36 +228,65 @@ void *DefaultMemoryManager::alloc(bool user_lock, const unsigned ndims,
                              ? bytes
                              : (divup(bytes, mem_step_size) * mem_step_size);
 
-    if (bytes > 0) {
+    // The temporaries of a memory scope are taken from its slab
+    if (bytes > 0 && !user_lock) { ptr = arenaAlloc(bytes); }
+
+    if (bytes > 0 && ptr == nullptr) {
         memory_info &current = this->getCurrentMemoryInfo();
         locked_info info     = {!user_lock, user_lock, alloc_bytes};
+        // The buffers of the user are not cached by the thread
+        cache_ptr cache = user_lock ? nullptr : threadCache();
+
+        // Reuse the smallest free buffer which can hold the request without
+        // wasting more than max_slack_ratio of the request
+        const size_t max_reuse_bytes =
+            alloc_bytes +
+            static_cast<size_t>(alloc_bytes * this->max_slack_ratio);
+
+        // The cache of the thread is searched without memory_mutex
+        if (cache) { ptr = cacheAlloc(cache, alloc_bytes, max_reuse_bytes); }
 
         // There is no memory cache in debug mode
-        if (!this->debug_mode) {
-            // FIXME: Add better checks for garbage collection
-            // Perhaps look at total memory available as a metric
+        if (ptr == nullptr && !this->debug_mode) {
+            updateFreeBytes(current, false);
             if (current.lock_bytes >= current.max_bytes ||
                 current.total_buffers >= this->max_buffers) {
                 this->signalMemoryCleanup();
             }
 
             lock_guard_t lock(this->memory_mutex);
-            auto free_buffer_iter = current.free_map.find(alloc_bytes);
+            auto free_buffer_iter = current.free_map.lower_bound(alloc_bytes);
             if (free_buffer_iter != current.free_map.end() &&
-                !free_buffer_iter->second.empty()) {
+                free_buffer_iter->first <= max_reuse_bytes) {
                 // Delete existing buffer info and underlying event
                 // Set to existing in from free map
                 vector<void *> &free_buffer_vector = free_buffer_iter->second;
                 ptr                                = free_buffer_vector.back();
                 free_buffer_vector.pop_back();
-                current.locked_map[ptr] = info;
-                current.lock_bytes += alloc_bytes;
-                current.lock_buffers++;
+                info.bytes = free_buffer_iter->first;
+                if (free_buffer_vector.empty()) {
+                    current.free_map.erase(free_buffer_iter);
+                }
+                lockBuffer(current, cache.get(), ptr, info);
+                if (this->stats_enabled) {
+                    current.stats.record(bytes, true, current.lock_bytes,
+                                         current.lock_buffers);
+                }
             }
         }
 
         // Only comes here if buffer size not found or in debug mode
         if (ptr == nullptr) {
+            // Release the cached buffers first when the device, which may be
+            // shared with other processes, does not have the memory left
+            if (!this->debug_mode && current.free_bytes != 0 &&
+                alloc_bytes > current.free_bytes) {
+                AF_TRACE("GC: {} free on the device for {}",
+                         bytesToString(current.free_bytes),
+                         bytesToString(alloc_bytes));
+                this->signalMemoryCleanup();
+            }
+
             // Perform garbage collection if memory can not be allocated
             try {
                 ptr = this->nativeAlloc(alloc_bytes);
@@ -190,13 +296,16 @@ void *DefaultMemoryManager::alloc(bool user_lock, const unsigned ndims,
                 this->signalMemoryCleanup();
                 ptr = this->nativeAlloc(alloc_bytes);
             }
+            if (!this->debug_mode) { updateFreeBytes(current, true); }
             lock_guard_t lock(this->memory_mutex);
             // Increment these two only when it succeeds to come here.
             current.total_bytes += alloc_bytes;
             current.total_buffers += 1;
-            current.locked_map[ptr] = info;
-            current.lock_bytes += alloc_bytes;
-            current.lock_buffers++;
+            lockBuffer(current, cache.get(), ptr, info);
+            if (this->stats_enabled) {
+                current.stats.record(bytes, false, current.lock_bytes,
+                                     current.lock_buffers);
+            }
         }
     }
 
@@ -207,7 +316,17 @@ size_t DefaultMemoryManager::allocated(void *ptr) {
     if (!ptr) { return 0; }
     memory_info &current = this->getCurrentMemoryInfo();
     auto locked_iter     = current.locked_map.find(ptr);
-    if (locked_iter == current.locked_map.end()) { return 0; }
+    if (locked_iter == current.locked_map.end()) {
+        if (arena_ptr arena = threadArena(ptr)) {
+            lock_guard_t lock(arena->mutex);
+            return arena->locked_map[ptr].bytes;
+        }
+        lock_guard_t lock(this->memory_mutex);
+        cache_ptr cache = registeredCache(ptr);
+        if (!cache) { return 0; }
+        lock_guard_t cache_lock(cache->mutex);
+        return cache->locked_map[ptr].bytes;
+    }
     return (locked_iter->second).bytes;
 }
 
@@ -215,17 +334,60 @@ void DefaultMemoryManager::unlock(void *ptr, bool user_unlock) {
     // Shortcut for empty arrays
     if (!ptr) { return; }
 
+    // The buffers of the memory scopes of this thread skip memory_mutex
+    if (arena_ptr arena = threadArena(ptr)) {
+        arenaUnlock(arena, ptr, user_unlock);
+        return;
+    }
+    // So do the buffers of the caches of this thread
+    if (cache_ptr cache = threadCacheOf(ptr)) {
+        cacheUnlock(cache, ptr, user_unlock);
+        return;
+    }
+
     // Frees the pointer outside the lock.
     uptr_t freed_ptr(nullptr, [this](void *p) { this->nativeFree(p); });
+    // Unlocks a buffer of the memory scope of another thread outside the
+    // lock, because the slab may be unlocked with it
+    arena_ptr arena;
+    uptr_t arena_buffer(nullptr, [this, &arena, user_unlock](void *p) {
+        this->arenaUnlock(arena, p, user_unlock);
+    });
     {
         lock_guard_t lock(this->memory_mutex);
         memory_info &current = this->getCurrentMemoryInfo();
 
         auto locked_buffer_iter = current.locked_map.find(ptr);
         if (locked_buffer_iter == current.locked_map.end()) {
+            // A buffer of the cache of another thread goes back to the free
+            // buffers of its device
+            if (cache_ptr cache = registeredCache(ptr)) {
+                memory_info &owner = memory[cache->device];
+                lock_guard_t cache_lock(cache->mutex);
+                auto cached_iter  = cache->locked_map.find(ptr);
+                locked_info &info = cached_iter->second;
+                if (user_unlock) {
+                    info.user_lock = false;
+                } else {
+                    info.manager_lock = false;
+                }
+                if (!info.user_lock && !info.manager_lock) {
+                    owner.lock_bytes -= info.bytes;
+                    owner.lock_buffers--;
+                    owner.free_map[info.bytes].emplace_back(ptr);
+                    cache->locked_map.erase(cached_iter);
+                }
+                return;
+            }
+
             // Pointer not found in locked map
             // Probably came from user, just free it
-            freed_ptr.reset(ptr);
+            arena = registeredArena(ptr);
+            if (arena) {
+                arena_buffer.reset(ptr);
+            } else {
+                freed_ptr.reset(ptr);
+            }
             return;
         }
         locked_info &locked_buffer_info = locked_buffer_iter->second;
@@ -274,42 +436,60 @@ void DefaultMemoryManager::printInfo(const char *msg, const int device) {
         "|     POINTER      |    SIZE    |  AF LOCK  | USER LOCK |\n"
         "---------------------------------------------------------\n");
 
-    lock_guard_t lock(this->memory_mutex);
-    for (const auto &kv : current.locked_map) {
-        const char *status_mngr = "Yes";
-        const char *status_user = "Unknown";
-        if (kv.second.user_lock) {
-            status_user = "Yes";
-        } else {
-            status_user = " No";
-        }
-
-        const char *unit = "KB";
-        double size      = static_cast<double>(kv.second.bytes) / 1024;
-        if (size >= 1024) {
-            size = size / 1024;
-            unit = "MB";
-        }
-
-        printf("|  %14p  |  %6.f %s | %9s | %9s |\n", kv.first, size, unit,
-               status_mngr, status_user);
-    }
+    auto printLocked = [](const locked_t &locked_map) {
+        for (const auto &kv : locked_map) {
+            const char *status_mngr = "Yes";
+            const char *status_user = "Unknown";
+            if (kv.second.user_lock) {
+                status_user = "Yes";
+            } else {
+                status_user = " No";
+            }
 
-    for (const auto &kv : current.free_map) {
-        const char *status_mngr = "No";
-        const char *status_user = "No";
+            const char *unit = "KB";
+            double size      = static_cast<double>(kv.second.bytes) / 1024;
+            if (size >= 1024) {
+                size = size / 1024;
+                unit = "MB";
+            }
 
-        const char *unit = "KB";
-        double size      = static_cast<double>(kv.first) / 1024;
-        if (size >= 1024) {
-            size = size / 1024;
-            unit = "MB";
+            printf("|  %14p  |  %6.f %s | %9s | %9s |\n", kv.first, size,
+                   unit, status_mngr, status_user);
         }
+    };
+
+    auto printFree = [](const free_t &free_map) {
+        for (const auto &kv : free_map) {
+            const char *status_mngr = "No";
+            const char *status_user = "No";
+
+            const char *unit = "KB";
+            double size      = static_cast<double>(kv.first) / 1024;
+            if (size >= 1024) {
+                size = size / 1024;
+                unit = "MB";
+            }
 
-        for (const auto &ptr : kv.second) {
-            printf("|  %14p  |  %6.f %s | %9s | %9s |\n", ptr, size, unit,
-                   status_mngr, status_user);
+            for (const auto &ptr : kv.second) {
+                printf("|  %14p  |  %6.f %s | %9s | %9s |\n", ptr, size, unit,
+                       status_mngr, status_user);
+            }
         }
+    };
+
+    lock_guard_t lock(this->memory_mutex);
+    const int active = this->getActiveDeviceId();
+    printLocked(current.locked_map);
+    for (const cache_ptr &cache : caches) {
+        if (cache->device != active) { continue; }
+        lock_guard_t cache_lock(cache->mutex);
+        printLocked(cache->locked_map);
+    }
+    printFree(current.free_map);
+    for (const cache_ptr &cache : caches) {
+        if (cache->device != active) { continue; }
+        lock_guard_t cache_lock(cache->mutex);
+        printFree(cache->free_map);
     }
 
     printf("---------------------------------------------------------\n");
@@ -319,6 +499,7 @@ void DefaultMemoryManager::usageInfo(size_t *alloc_bytes, size_t *alloc_buffers,
                                      size_t *lock_bytes, size_t *lock_buffers) {
     const memory_info &current = this->getCurrentMemoryInfo();
     lock_guard_t lock(this->memory_mutex);
+    flushCaches(this->getActiveDeviceId());
     if (alloc_bytes) { *alloc_bytes = current.total_bytes; }
     if (alloc_buffers) { *alloc_buffers = current.total_buffers; }
     if (lock_bytes) { *lock_bytes = current.lock_bytes; }
@@ -333,6 +514,12 @@ void DefaultMemoryManager::userLock(const void *ptr) {
     auto locked_iter = current.locked_map.find(const_cast<void *>(ptr));
     if (locked_iter != current.locked_map.end()) {
         locked_iter->second.user_lock = true;
+    } else if (cache_ptr cache = registeredCache(const_cast<void *>(ptr))) {
+        lock_guard_t cache_lock(cache->mutex);
+        cache->locked_map[const_cast<void *>(ptr)].user_lock = true;
+    } else if (arena_ptr arena = registeredArena(const_cast<void *>(ptr))) {
+        lock_guard_t arena_lock(arena->mutex);
+        arena->locked_map[const_cast<void *>(ptr)].user_lock = true;
     } else {
         locked_info info = {false, true, 100};  // This number is not relevant
 
@@ -348,7 +535,16 @@ bool DefaultMemoryManager::isUserLocked(const void *ptr) {
     memory_info &current = this->getCurrentMemoryInfo();
     lock_guard_t lock(this->memory_mutex);
     auto locked_iter = current.locked_map.find(const_cast<void *>(ptr));
-    if (locked_iter == current.locked_map.end()) { return false; }
+    if (locked_iter == current.locked_map.end()) {
+        if (cache_ptr cache = registeredCache(const_cast<void *>(ptr))) {
+            lock_guard_t cache_lock(cache->mutex);
+            return cache->locked_map[const_cast<void *>(ptr)].user_lock;
+        }
+        arena_ptr arena = registeredArena(const_cast<void *>(ptr));
+        if (!arena) { return false; }
+        lock_guard_t arena_lock(arena->mutex);
+        return arena->locked_map[const_cast<void *>(ptr)].user_lock;
+    }
     return locked_iter->second.user_lock;
 }
 
@@ -362,4 +558,313 @@ void DefaultMemoryManager::setMemStepSize(size_t new_step_size) {
     this->mem_step_size = new_step_size;
 }
 
+void DefaultMemoryManager::setStatsEnabled(bool enabled) {
+    lock_guard_t lock(this->memory_mutex);
+    this->stats_enabled = enabled;
+}
+
+void DefaultMemoryManager::resetStats(int device) {
+    lock_guard_t lock(this->memory_mutex);
+    flushCaches(device);
+    memory_info &current = memory[device];
+    current.stats.reset(current.lock_bytes, current.lock_buffers);
+}
+
+void DefaultMemoryManager::getStats(af_mem_stats *stats, int device) {
+    lock_guard_t lock(this->memory_mutex);
+    *stats = memory[device].stats.getTotals();
+}
+
+vector<DefaultMemoryManager::arena_ptr> &DefaultMemoryManager::threadScopes() {
+    thread_local vector<arena_ptr> scopes;
+    return scopes;
+}
+
+void *DefaultMemoryManager::arenaAlloc(size_t bytes) {
+    vector<arena_ptr> &scopes = threadScopes();
+    if (scopes.empty()) { return nullptr; }
+    arena_info &arena = *scopes.back();
+    if (arena.owner != this || arena.device != this->getActiveDeviceId()) {
+        return nullptr;
+    }
+
+    lock_guard_t lock(arena.mutex);
+    if (arena.offset + bytes > arena.capacity) { return nullptr; }
+    void *ptr = this->nativeSubAlloc(arena.slab, arena.offset, bytes);
+    arena.offset += divup(bytes, arena.alignment) * arena.alignment;
+    arena.locked_map[ptr] = {true, false, bytes};
+    return ptr;
+}
+
+DefaultMemoryManager::arena_ptr DefaultMemoryManager::threadArena(void *ptr) {
+    vector<arena_ptr> &scopes = threadScopes();
+    for (auto it = scopes.rbegin(); it != scopes.rend(); ++it) {
+        if ((*it)->owner != this) { continue; }
+        lock_guard_t lock((*it)->mutex);
+        if ((*it)->locked_map.count(ptr)) { return *it; }
+    }
+    return nullptr;
+}
+
+DefaultMemoryManager::arena_ptr DefaultMemoryManager::registeredArena(
+    void *ptr) {
+    for (const arena_ptr &arena : this->arenas) {
+        lock_guard_t lock(arena->mutex);
+        if (arena->locked_map.count(ptr)) { return arena; }
+    }
+    return nullptr;
+}
+
+void DefaultMemoryManager::arenaUnlock(const arena_ptr &arena, void *ptr,
+                                       bool user_unlock) {
+    bool release = false;
+    {
+        lock_guard_t lock(arena->mutex);
+        auto locked_iter = arena->locked_map.find(ptr);
+        if (locked_iter == arena->locked_map.end()) { return; }
+        if (user_unlock) {
+            locked_iter->second.user_lock = false;
+        } else {
+            locked_iter->second.manager_lock = false;
+        }
+        if (locked_iter->second.user_lock || locked_iter->second.manager_lock) {
+            return;
+        }
+        arena->locked_map.erase(locked_iter);
+
+        // The slab is reused from its start once all of its buffers are
+        // unlocked. The buffers start one alignment in, so that none of them
+        // has the address of the slab.
+        if (arena->locked_map.empty()) {
+            arena->offset = arena->alignment;
+            release       = arena->closed;
+        }
+    }
+    this->nativeSubFree(ptr);
+    if (release) { releaseArena(arena); }
+}
+
+void DefaultMemoryManager::releaseArena(arena_ptr arena) {
+    {
+        lock_guard_t lock(this->memory_mutex);
+        arenas.erase(std::remove(arenas.begin(), arenas.end(), arena),
+                     arenas.end());
+    }
+    this->unlock(arena->slab, false);
+}
+
+void DefaultMemoryManager::beginScope(size_t bytes) {
+    auto arena       = make_shared<arena_info>();
+    arena->owner     = this;
+    arena->device    = this->getActiveDeviceId();
+    arena->alignment = this->getSubAllocAlignment();
+    arena->offset    = arena->alignment;
+    arena->closed    = false;
+    // The allocations are not moved to a slab in debug mode
+    arena->capacity = this->debug_mode || bytes == 0
+                          ? 0
+                          : divup(bytes, arena->alignment) * arena->alignment +
+                                arena->alignment;
+    arena->slab = nullptr;
+    if (arena->capacity > 0) {
+        dim_t dims  = static_cast<dim_t>(arena->capacity);
+        arena->slab = this->alloc(false, 1, &dims, 1);
+    }
+    AF_TRACE("Scope: {} slab {}", bytesToString(arena->capacity),
+             arena->slab);
+
+    {
+        lock_guard_t lock(this->memory_mutex);
+        arenas.push_back(arena);
+    }
+    threadScopes().push_back(arena);
+}
+
+void DefaultMemoryManager::endScope() {
+    vector<arena_ptr> &scopes = threadScopes();
+    auto scope_iter =
+        std::find_if(scopes.rbegin(), scopes.rend(),
+                     [this](const arena_ptr &a) { return a->owner == this; });
+    if (scope_iter == scopes.rend()) {
+        AF_ERROR("No memory scope was started on this thread", AF_ERR_ARG);
+    }
+    arena_ptr arena = *scope_iter;
+    scopes.erase(std::next(scope_iter).base());
+
+    bool release = false;
+    {
+        lock_guard_t lock(arena->mutex);
+        arena->closed = true;
+        release       = arena->locked_map.empty();
+    }
+    AF_TRACE("Scope: end slab {}{}", arena->slab,
+             release ? "" : " with buffers in use");
+    if (release) { releaseArena(arena); }
+}
+
+vector<DefaultMemoryManager::cache_ptr> &
+DefaultMemoryManager::threadCaches() {
+    thread_local vector<cache_ptr> thread_caches;
+    return thread_caches;
+}
+
+DefaultMemoryManager::cache_ptr DefaultMemoryManager::threadCache() {
+    // Each allocation is recorded in order in the statistics
+    if (this->thread_cache_bytes == 0 || this->debug_mode ||
+        this->stats_enabled) {
+        return nullptr;
+    }
+
+    const int device                 = this->getActiveDeviceId();
+    vector<cache_ptr> &thread_caches = threadCaches();
+    for (const cache_ptr &cache : thread_caches) {
+        if (cache->owner == this->instance_id && cache->device == device) {
+            return cache;
+        }
+    }
+
+    auto cache          = make_shared<thread_cache>();
+    cache->owner        = this->instance_id;
+    cache->device       = device;
+    cache->free_bytes   = 0;
+    cache->lock_bytes   = 0;
+    cache->lock_buffers = 0;
+    cache->ops          = 0;
+    {
+        lock_guard_t lock(this->memory_mutex);
+        caches.push_back(cache);
+    }
+    thread_caches.push_back(cache);
+    return cache;
+}
+
+void *DefaultMemoryManager::cacheAlloc(const cache_ptr &cache,
+                                       size_t alloc_bytes, size_t max_bytes) {
+    void *ptr  = nullptr;
+    bool flush = false;
+    {
+        lock_guard_t lock(cache->mutex);
+        auto free_iter = cache->free_map.lower_bound(alloc_bytes);
+        if (free_iter == cache->free_map.end() ||
+            free_iter->first > max_bytes) {
+            return nullptr;
+        }
+        const size_t bytes = free_iter->first;
+        ptr                = free_iter->second.back();
+        free_iter->second.pop_back();
+        if (free_iter->second.empty()) { cache->free_map.erase(free_iter); }
+
+        cache->locked_map[ptr] = {true, false, bytes};
+        cache->free_bytes -= bytes;
+        cache->lock_bytes += static_cast<long long>(bytes);
+        cache->lock_buffers++;
+        flush = ++cache->ops >= THREAD_CACHE_FLUSH_INTERVAL;
+    }
+    if (flush) {
+        lock_guard_t lock(this->memory_mutex);
+        flushCache(memory[cache->device], *cache, this->thread_cache_bytes);
+    }
+    return ptr;
+}
+
+DefaultMemoryManager::cache_ptr DefaultMemoryManager::threadCacheOf(
+    void *ptr) {
+    for (const cache_ptr &cache : threadCaches()) {
+        if (cache->owner != this->instance_id) { continue; }
+        lock_guard_t lock(cache->mutex);
+        if (cache->locked_map.count(ptr)) { return cache; }
+    }
+    return nullptr;
+}
+
+DefaultMemoryManager::cache_ptr DefaultMemoryManager::registeredCache(
+    void *ptr) {
+    for (const cache_ptr &cache : this->caches) {
+        lock_guard_t lock(cache->mutex);
+        if (cache->locked_map.count(ptr)) { return cache; }
+    }
+    return nullptr;
+}
+
+void DefaultMemoryManager::cacheUnlock(const cache_ptr &cache, void *ptr,
+                                       bool user_unlock) {
+    bool flush = false;
+    {
+        lock_guard_t lock(cache->mutex);
+        auto locked_iter = cache->locked_map.find(ptr);
+        if (locked_iter == cache->locked_map.end()) { return; }
+        if (user_unlock) {
+            locked_iter->second.user_lock = false;
+        } else {
+            locked_iter->second.manager_lock = false;
+        }
+        if (locked_iter->second.user_lock || locked_iter->second.manager_lock) {
+            return;
+        }
+
+        const size_t bytes = locked_iter->second.bytes;
+        cache->locked_map.erase(locked_iter);
+        cache->free_map[bytes].emplace_back(ptr);
+        cache->free_bytes += bytes;
+        cache->lock_bytes -= static_cast<long long>(bytes);
+        cache->lock_buffers--;
+        flush = ++cache->ops >= THREAD_CACHE_FLUSH_INTERVAL ||
+                cache->free_bytes > this->thread_cache_bytes;
+    }
+    if (flush) {
+        lock_guard_t lock(this->memory_mutex);
+        flushCache(memory[cache->device], *cache, this->thread_cache_bytes);
+    }
+}
+
+void DefaultMemoryManager::flushCache(memory_info &current,
+                                      thread_cache &cache, size_t keep_bytes) {
+    lock_guard_t lock(cache.mutex);
+    // The changes may be negative. The unsigned sums wrap to the counts.
+    current.lock_bytes += static_cast<size_t>(cache.lock_bytes);
+    current.lock_buffers += static_cast<size_t>(cache.lock_buffers);
+    cache.lock_bytes   = 0;
+    cache.lock_buffers = 0;
+    cache.ops          = 0;
+
+    // The smaller buffers are kept, as they are requested more often
+    while (cache.free_bytes > keep_bytes) {
+        auto largest         = std::prev(cache.free_map.end());
+        vector<void *> &ptrs = largest->second;
+        current.free_map[largest->first].emplace_back(ptrs.back());
+        cache.free_bytes -= largest->first;
+        ptrs.pop_back();
+        if (ptrs.empty()) { cache.free_map.erase(largest); }
+    }
+}
+
+void DefaultMemoryManager::flushCaches(int device) {
+    for (const cache_ptr &cache : caches) {
+        if (cache->device != device) { continue; }
+        flushCache(memory[device], *cache, numeric_limits<size_t>::max());
+    }
+}
+
+void DefaultMemoryManager::lockBuffer(memory_info &current,
+                                      thread_cache *cache, void *ptr,
+                                      const locked_info &info) {
+    current.lock_bytes += info.bytes;
+    current.lock_buffers++;
+    if (cache) {
+        lock_guard_t lock(cache->mutex);
+        cache->locked_map[ptr] = info;
+    } else {
+        current.locked_map[ptr] = info;
+    }
+}
+
+string DefaultMemoryManager::getStatsJson(int device) {
+    lock_guard_t lock(this->memory_mutex);
+    flushCaches(device);
+    const memory_info &current = memory[device];
+    return current.stats.toJson(device, this->stats_enabled,
+                                current.total_bytes, current.total_buffers,
+                                current.lock_bytes, current.lock_buffers);
+}
+
 }  // namespace common
@@ -10,9 +10,13 @@
 #pragma once
 
 #include <common/MemoryManagerBase.hpp>
+#include <common/MemoryStats.hpp>
 #include <common/defines.hpp>
 
 #include <functional>
+#include <map>
+#include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -21,14 +25,38 @@ namespace common {
 constexpr unsigned MAX_BUFFERS = 1000;
 constexpr size_t ONE_GB        = 1 << 30;
 
+/// The number of allocations after which the free memory of the device is
+/// queried again
+constexpr unsigned FREE_MEMORY_QUERY_INTERVAL = 64;
+
+/// The number of allocations and unlocks of a thread cache after which its
+/// counts are added to those of the device and its free buffers are trimmed
+constexpr unsigned THREAD_CACHE_FLUSH_INTERVAL = 64;
+
 using uptr_t = std::unique_ptr<void, std::function<void(void *)>>;
 
 class DefaultMemoryManager final : public common::memory::MemoryManagerBase {
     size_t mem_step_size;
     unsigned max_buffers;
 
+    /// The largest fraction of a request that can be wasted when a larger
+    /// free buffer is reused for it
+    double max_slack_ratio;
+
     bool debug_mode;
 
+    /// Records the memory statistics. Set with AF_MEM_STATS.
+    bool stats_enabled;
+
+    /// The largest number of bytes of free buffers kept in the cache of a
+    /// thread. The caches are disabled when it is 0. Set with
+    /// AF_MEM_THREAD_CACHE_MB.
+    size_t thread_cache_bytes;
+
+    /// Identifies the manager in the caches of the threads, which may
+    /// outlive it
+    unsigned instance_id;
+
     struct locked_info {
         bool manager_lock;
         bool user_lock;
@@ -36,7 +64,8 @@ class DefaultMemoryManager final : public common::memory::MemoryManagerBase {
     };
 
     using locked_t = typename std::unordered_map<void *, locked_info>;
-    using free_t   = std::unordered_map<size_t, std::vector<void *>>;
+    // Ordered by size so that the smallest buffer that fits can be found
+    using free_t = std::map<size_t, std::vector<void *>>;
 
     struct memory_info {
         locked_t locked_map;
@@ -48,6 +77,15 @@ class DefaultMemoryManager final : public common::memory::MemoryManagerBase {
         size_t lock_bytes;
         size_t lock_buffers;
 
+        /// The free memory of the device at the last query, which counts the
+        /// memory of other processes. It is 0 when the device does not
+        /// report it.
+        size_t free_bytes;
+        /// The allocations left until the free memory is queried again
+        unsigned free_query_countdown;
+
+        MemoryStats stats;
+
         memory_info()
             // Calling getMaxMemorySize() here calls the virtual function
             // that returns 0 Call it from outside the constructor.
@@ -55,7 +93,9 @@ class DefaultMemoryManager final : public common::memory::MemoryManagerBase {
             , total_bytes(0)
             , total_buffers(0)
             , lock_bytes(0)
-            , lock_buffers(0) {}
+            , lock_buffers(0)
+            , free_bytes(0)
+            , free_query_countdown(0) {}
 
         memory_info(memory_info &other)  = delete;
         memory_info(memory_info &&other) = default;
@@ -65,6 +105,129 @@ class DefaultMemoryManager final : public common::memory::MemoryManagerBase {
 
     memory_info &getCurrentMemoryInfo();
 
+    /// A slab of device memory which holds the allocations of a memory scope.
+    /// Its buffers are allocated by bumping an offset and are not cached.
+    /// The slab is unlocked once the scope ended and all of its buffers were
+    /// unlocked.
+    struct arena_info {
+        const DefaultMemoryManager *owner;
+        int device;
+        void *slab;
+        size_t capacity;
+        size_t alignment;
+        size_t offset;
+        bool closed;
+        // Only locked by the threads which use the buffers of the slab, so
+        // the allocations of the scope do not wait for memory_mutex
+        common::mutex_t mutex;
+        locked_t locked_map;
+    };
+
+    using arena_ptr = std::shared_ptr<arena_info>;
+
+    /// The memory scopes of the calling thread, innermost last
+    static std::vector<arena_ptr> &threadScopes();
+
+    /// The slabs of the memory scopes of all the threads, including the
+    /// scopes which ended while some of their buffers are locked. Guarded by
+    /// memory_mutex.
+    std::vector<arena_ptr> arenas;
+
+    /// Returns a buffer from the innermost memory scope of the calling
+    /// thread, or nullptr if there is none or its slab is full
+    void *arenaAlloc(size_t bytes);
+
+    /// Returns the memory scope of the calling thread which holds \p ptr, or
+    /// nullptr
+    arena_ptr threadArena(void *ptr);
+
+    /// Returns the memory scope of any thread which holds \p ptr, or
+    /// nullptr. Called with memory_mutex held.
+    arena_ptr registeredArena(void *ptr);
+
+    /// Unlocks the buffer \p ptr of \p arena. Called without memory_mutex.
+    void arenaUnlock(const arena_ptr &arena, void *ptr, bool user_unlock);
+
+    /// Unlocks the slab of \p arena, whose scope ended and whose buffers
+    /// are unlocked
+    void releaseArena(arena_ptr arena);
+
+    /// The buffers of a device which a thread locks and unlocks without
+    /// memory_mutex. The buffers that the thread unlocks are kept in its
+    /// free_map for its next allocations. Buffers which another thread
+    /// unlocks go back to the memory_info of the device. The changes of the
+    /// locked bytes and buffers are added to the memory_info every
+    /// THREAD_CACHE_FLUSH_INTERVAL operations, and when the usage or the
+    /// statistics are read. The memory pressure may lag behind them.
+    struct thread_cache {
+        unsigned owner;
+        int device;
+        // Locked by its thread, and by the other threads with memory_mutex
+        // held
+        common::mutex_t mutex;
+        locked_t locked_map;
+        free_t free_map;
+        size_t free_bytes;
+        // Not yet added to the memory_info of the device
+        long long lock_bytes;
+        long long lock_buffers;
+        unsigned ops;
+    };
+
+    using cache_ptr = std::shared_ptr<thread_cache>;
+
+    /// The caches of the calling thread
+    static std::vector<cache_ptr> &threadCaches();
+
+    /// The caches of all the threads. Guarded by memory_mutex.
+    std::vector<cache_ptr> caches;
+
+    /// Returns the cache of the calling thread for the active device, or
+    /// nullptr when the caches are disabled
+    cache_ptr threadCache();
+
+    /// Locks a free buffer of the cache of the calling thread which holds
+    /// \p alloc_bytes and is at most \p max_bytes, or returns nullptr
+    void *cacheAlloc(const cache_ptr &cache, size_t alloc_bytes,
+                     size_t max_bytes);
+
+    /// Returns the cache of the calling thread which holds the locked buffer
+    /// \p ptr, or nullptr
+    cache_ptr threadCacheOf(void *ptr);
+
+    /// Returns the cache of any thread which holds the locked buffer \p ptr,
+    /// or nullptr. Called with memory_mutex held.
+    cache_ptr registeredCache(void *ptr);
+
+    /// Unlocks the buffer \p ptr of \p cache, which belongs to the calling
+    /// thread. Called without memory_mutex.
+    void cacheUnlock(const cache_ptr &cache, void *ptr, bool user_unlock);
+
+    /// Adds the counts of \p cache to \p current and moves its largest free
+    /// buffers to \p current until it holds at most \p keep_bytes. Called
+    /// with memory_mutex held.
+    static void flushCache(memory_info &current, thread_cache &cache,
+                           size_t keep_bytes);
+
+    /// Flushes the caches of the threads for \p device without trimming
+    /// them, so that the counts of \p device are exact. Called with
+    /// memory_mutex held.
+    void flushCaches(int device);
+
+    /// Records \p ptr as locked in \p cache, or in \p current when \p cache
+    /// is nullptr. Called with memory_mutex held.
+    static void lockBuffer(memory_info &current, thread_cache *cache,
+                           void *ptr, const locked_info &info);
+
+    /// Queries the free memory of the active device every
+    /// FREE_MEMORY_QUERY_INTERVAL allocations, or now when \p force is set
+    void updateFreeBytes(memory_info &current, bool force);
+
+    /// Returns the bytes which can still be locked on the device before
+    /// max_bytes is reached or the device runs out of memory. The cached
+    /// buffers count as free because they are released on a cleanup.
+    static size_t lockableBytes(const memory_info &current);
+
    public:
     DefaultMemoryManager(int num_devices, unsigned max_buffers, bool debug);
 
@@ -90,8 +253,9 @@ class DefaultMemoryManager final : public common::memory::MemoryManagerBase {
     ///
     /// This funciton will return a memory location of at least \p size
     /// bytes. If there is already a free buffer available, it will use
-    /// that buffer. Otherwise, it will allocate a new buffer using the
-    /// nativeAlloc function.
+    /// that buffer. The smallest free buffer that is at most
+    /// max_slack_ratio larger than the request is used. Otherwise, it will
+    /// allocate a new buffer using the nativeAlloc function.
     void *alloc(bool user_lock, const unsigned ndims, dim_t *dims,
                 const unsigned element_size) override;
 
@@ -117,6 +281,12 @@ class DefaultMemoryManager final : public common::memory::MemoryManagerBase {
     void setMemStepSize(size_t new_step_size) override;
     float getMemoryPressure() override;
     bool jitTreeExceedsMemoryPressure(size_t bytes) override;
+    void setStatsEnabled(bool enabled) override;
+    void resetStats(int device) override;
+    void getStats(af_mem_stats *stats, int device) override;
+    std::string getStatsJson(int device) override;
+    void beginScope(size_t bytes) override;
+    void endScope() override;
 
     ~DefaultMemoryManager() = default;
 
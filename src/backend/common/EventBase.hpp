@@ -44,6 +44,24 @@ class EventBase {
         return NativeEventPolicy::createAndMarkEvent(&e_);
     }
 
+    /// \brief Creates an event which records when it is completed, so the
+    ///        time between two events can be measured
+    ErrorType createTiming() noexcept {
+        return NativeEventPolicy::createTimingEvent(&e_);
+    }
+
+    /// \brief Measures the time between the completion of \p start and of
+    ///        this event. Both events have to be created with createTiming
+    ///        and marked. Blocks the calling thread until they complete.
+    ///
+    /// \param[out] ms    The elapsed time in milliseconds
+    /// \param[in]  start The event marked first
+    ///
+    /// \returns the error code of the timing call
+    ErrorType elapsed(float *ms, EventBase &start) noexcept {
+        return NativeEventPolicy::elapsedTime(ms, &start.e_, &e_);
+    }
+
     /// \brief Adds the event on the queue. Once this point on the program
     ///        is executed, the event is marked complete.
     ///
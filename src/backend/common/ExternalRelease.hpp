@@ -0,0 +1,35 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+namespace common {
+
+/// The deleter of the buffers of other libraries which are used by the
+/// arrays without a copy. It hands the buffer back to its library instead of
+/// the memory manager.
+template<typename T>
+struct ExternalRelease {
+    std::function<void(T *)> release;
+
+    void operator()(T *ptr) const { release(ptr); }
+};
+
+/// Returns true when \p data is the buffer of another library. The JIT does
+/// not write the results of the arrays to these buffers, because the other
+/// library can still read them.
+template<typename T>
+bool isExternal(const std::shared_ptr<T> &data) {
+    return std::get_deleter<ExternalRelease<T>>(data) != nullptr;
+}
+
+}  // namespace common
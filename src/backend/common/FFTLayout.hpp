@@ -0,0 +1,127 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <af/defines.h>
+#include <af/dim4.hpp>
+
+#include <array>
+
+namespace common {
+
+/// Computes the embedded dimensions of the advanced data layout of FFTW and
+/// cuFFT for the first \p rank dimensions of data with \p dims and
+/// \p strides. The embedded dimensions are stored from the slowest to the
+/// fastest varying dimension, and the element stride is strides[0].
+///
+/// \returns false if the strides are not multiples of each other, in which
+///          case the layout can not describe the data
+inline bool fftEmbed(std::array<int, AF_MAX_DIMS> &embed, const int rank,
+                     const af::dim4 &dims, const af::dim4 &strides) {
+    embed = {};
+    for (int i = 0; i < rank; i++) {
+        dim_t size = dims[i];
+        if (i < rank - 1) {
+            if (strides[i] == 0 || strides[i + 1] % strides[i] != 0) {
+                return false;
+            }
+            size = strides[i + 1] / strides[i];
+            if (size < dims[i]) { return false; }
+        }
+        embed[(rank - 1) - i] = static_cast<int>(size);
+    }
+    return true;
+}
+
+/// Returns true if the advanced data layout can describe the first \p rank
+/// dimensions of data with \p dims and \p strides (see fftEmbed)
+inline bool fftEmbeddable(const int rank, const af::dim4 &dims,
+                          const af::dim4 &strides) {
+    std::array<int, AF_MAX_DIMS> embed;
+    return fftEmbed(embed, rank, dims, strides);
+}
+
+/// The batch of transforms over the dimensions after the first \p rank
+/// dimensions of strided input and output data.
+///
+/// The batch dimensions whose strides are the strides of a packed batch in
+/// both the input and the output are transformed by one plan execution,
+/// with the distances idist and odist between the transforms. The plan is
+/// executed once for every index of the other batch dimensions, at the
+/// offsets returned by inOffset and outOffset, so no data is copied to pack
+/// the transforms.
+class FFTBatch {
+    int m_batch;
+    dim_t m_idist;
+    dim_t m_odist;
+    af::dim4 m_loopDims;
+    af::dim4 m_loopIStrides;
+    af::dim4 m_loopOStrides;
+
+   public:
+    FFTBatch(const int rank, const af::dim4 &dims, const af::dim4 &istrides,
+             const af::dim4 &ostrides)
+        : m_batch(1)
+        , m_idist(istrides[rank])
+        , m_odist(ostrides[rank])
+        , m_loopDims(1, 1, 1, 1)
+        , m_loopIStrides(0, 0, 0, 0)
+        , m_loopOStrides(0, 0, 0, 0) {
+        bool started = false;
+        int loops    = 0;
+        for (int d = rank; d < AF_MAX_DIMS; d++) {
+            if (dims[d] == 1) { continue; }
+            if (!started) {
+                started = true;
+                m_batch = static_cast<int>(dims[d]);
+                m_idist = istrides[d];
+                m_odist = ostrides[d];
+            } else if (loops == 0 && istrides[d] == m_idist * m_batch &&
+                       ostrides[d] == m_odist * m_batch) {
+                m_batch *= static_cast<int>(dims[d]);
+            } else {
+                m_loopDims[loops]     = dims[d];
+                m_loopIStrides[loops] = istrides[d];
+                m_loopOStrides[loops] = ostrides[d];
+                loops++;
+            }
+        }
+    }
+
+    /// The number of transforms of a plan execution
+    int batch() const { return m_batch; }
+
+    /// The distance between the inputs of the transforms of an execution
+    int idist() const { return static_cast<int>(m_idist); }
+
+    /// The distance between the outputs of the transforms of an execution
+    int odist() const { return static_cast<int>(m_odist); }
+
+    /// The number of plan executions
+    dim_t executions() const { return m_loopDims.elements(); }
+
+    /// The offset of the input of execution \p e
+    dim_t inOffset(dim_t e) const { return offset(e, m_loopIStrides); }
+
+    /// The offset of the output of execution \p e
+    dim_t outOffset(dim_t e) const { return offset(e, m_loopOStrides); }
+
+   private:
+    dim_t offset(dim_t e, const af::dim4 &strides) const {
+        dim_t off = 0;
+        for (int i = 0; i < AF_MAX_DIMS; i++) {
+            off += (e % m_loopDims[i]) * strides[i];
+            e /= m_loopDims[i];
+        }
+        return off;
+    }
+};
+
+}  // namespace common
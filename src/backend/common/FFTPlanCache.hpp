@@ -8,65 +8,107 @@
  ********************************************************/
 
 #pragma once
-#include <deque>
+#include <iterator>
+#include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 
 namespace common {
-// FFTPlanCache caches backend specific fft plans in FIFO order
+// FFTPlanCache caches backend specific fft plans in least recently used order
 //
-// new plan |--> IF number of plans cached is at limit, pop the oldest entry and
-// push new plan.
+// new plan |--> push the plan to the front of the cache.
 //          |
-//          |--> ELSE just push the plan
-// existing plan -> reuse a plan
+//          |--> WHILE the number of plans or the workspace bytes of the plans
+//               is above the limit, pop the least recently used entry.
+// existing plan -> move the plan to the front of the cache and reuse it
+//
+// The plans are indexed by their key so finding a plan does not depend on the
+// number of cached plans.
 template<typename T, typename P>
 class FFTPlanCache {
-    using plan_t       = typename std::shared_ptr<P>;
-    using plan_pair_t  = typename std::pair<std::string, plan_t>;
-    using plan_cache_t = typename std::deque<plan_pair_t>;
+    using plan_t = typename std::shared_ptr<P>;
+
+    struct plan_entry_t {
+        std::string key;
+        plan_t plan;
+        size_t bytes;
+    };
+
+    using plan_list_t  = typename std::list<plan_entry_t>;
+    using plan_index_t = typename std::unordered_map<
+        std::string, typename plan_list_t::iterator>;
 
    public:
-    FFTPlanCache() : mMaxCacheSize(5) {}
+    FFTPlanCache() : mMaxCacheSize(5), mMaxCacheBytes(0), mCacheBytes(0) {}
 
     void setMaxCacheSize(size_t size) {
         mMaxCacheSize = size;
-        while (mCache.size() > mMaxCacheSize) mCache.pop_back();
+        evict();
     }
 
     size_t getMaxCacheSize() const { return mMaxCacheSize; }
 
-    // iterates through plan cache from front to back
-    // of the cache(queue)
+    // Limits the total workspace bytes of the cached plans. Zero means the
+    // cache is only limited by the number of plans.
+    void setMaxCacheBytes(size_t bytes) {
+        mMaxCacheBytes = bytes;
+        evict();
+    }
+
+    size_t getMaxCacheBytes() const { return mMaxCacheBytes; }
+
+    // Returns the total workspace bytes of the cached plans
+    size_t getCacheBytes() const { return mCacheBytes; }
+
     // A valid shared_ptr of the plan in the cache is returned
-    // if found, and empty share_ptr otherwise.
-    plan_t find(const std::string& key) const {
-        std::shared_ptr<P> res;
-
-        for (unsigned i = 0; i < mCache.size(); ++i) {
-            if (key == mCache[i].first) {
-                res = mCache[i].second;
-                break;
-            }
-        }
+    // if found, and empty share_ptr otherwise. The plan found
+    // becomes the most recently used plan.
+    plan_t find(const std::string& key) {
+        auto iter = mIndex.find(key);
+        if (iter == mIndex.end()) { return plan_t(); }
 
-        return res;
+        mCache.splice(mCache.begin(), mCache, iter->second);
+        return iter->second->plan;
     }
 
-    // pushes plan to the front of cache(queue)
-    void push(const std::string key, plan_t plan) {
-        if (mCache.size() >= mMaxCacheSize) mCache.pop_back();
+    // pushes plan to the front of cache. bytes is the size of the workspace
+    // held by the plan.
+    void push(const std::string& key, plan_t plan, size_t bytes = 0) {
+        auto iter = mIndex.find(key);
+        if (iter != mIndex.end()) { erase(iter->second); }
 
-        mCache.push_front(plan_pair_t(key, plan));
+        mCache.push_front(plan_entry_t{key, std::move(plan), bytes});
+        mIndex[key] = mCache.begin();
+        mCacheBytes += bytes;
+        evict();
     }
 
    protected:
     FFTPlanCache(FFTPlanCache const&);
     void operator=(FFTPlanCache const&);
 
+    void erase(typename plan_list_t::iterator iter) {
+        mCacheBytes -= iter->bytes;
+        mIndex.erase(iter->key);
+        mCache.erase(iter);
+    }
+
+    // pops the least recently used plans until the cache is within its limits
+    void evict() {
+        while (!mCache.empty() &&
+               (mCache.size() > mMaxCacheSize ||
+                (mMaxCacheBytes > 0 && mCacheBytes > mMaxCacheBytes))) {
+            erase(std::prev(mCache.end()));
+        }
+    }
+
     size_t mMaxCacheSize;
+    size_t mMaxCacheBytes;
+    size_t mCacheBytes;
 
-    plan_cache_t mCache;
+    plan_list_t mCache;
+    plan_index_t mIndex;
 };
 }  // namespace common
@@ -0,0 +1,79 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/GraphCapture.hpp>
+
+#include <common/err_common.hpp>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <utility>
+
+using std::atomic;
+using std::lock_guard;
+using std::map;
+using std::mutex;
+using std::vector;
+
+namespace common {
+
+namespace {
+
+mutex captureMutex;
+
+/// The buffers kept by the capture of each device
+map<int, vector<void *>> &captures() {
+    static map<int, vector<void *>> *value = new map<int, vector<void *>>();
+    return *value;
+}
+
+/// The number of devices being captured, so the buffers are freed without
+/// locking captureMutex when nothing is captured
+atomic<int> numCaptures{0};
+
+}  // namespace
+
+void beginGraphCapture(int device) {
+    lock_guard<mutex> lock(captureMutex);
+    if (!captures().emplace(device, vector<void *>()).second) {
+        AF_ERROR("A capture is already in progress on this device",
+                 AF_ERR_RUNTIME);
+    }
+    ++numCaptures;
+}
+
+vector<void *> endGraphCapture(int device) {
+    lock_guard<mutex> lock(captureMutex);
+    auto it = captures().find(device);
+    if (it == captures().end()) {
+        AF_ERROR("No capture is in progress on this device", AF_ERR_RUNTIME);
+    }
+    vector<void *> buffers = std::move(it->second);
+    captures().erase(it);
+    --numCaptures;
+    return buffers;
+}
+
+bool isCapturingGraph(int device) {
+    if (numCaptures == 0) { return false; }
+    lock_guard<mutex> lock(captureMutex);
+    return captures().count(device) != 0;
+}
+
+bool keepCapturedBuffer(int device, void *ptr) {
+    if (ptr == nullptr || numCaptures == 0) { return false; }
+    lock_guard<mutex> lock(captureMutex);
+    auto it = captures().find(device);
+    if (it == captures().end()) { return false; }
+    it->second.push_back(ptr);
+    return true;
+}
+
+}  // namespace common
@@ -0,0 +1,32 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <vector>
+
+namespace common {
+
+/// Starts tracking the buffers freed on \p device for a graph capture.
+/// Throws if the device is already being captured.
+void beginGraphCapture(int device);
+
+/// Stops the capture of \p device and returns the buffers freed while it was
+/// captured. Throws if the device is not being captured.
+std::vector<void *> endGraphCapture(int device);
+
+/// Returns true if the work queued on \p device is being captured
+bool isCapturingGraph(int device);
+
+/// Keeps \p ptr out of the memory manager if \p device is being captured,
+/// because the replays of the graph still read and write it. Returns false
+/// if the buffer has to be freed as usual.
+bool keepCapturedBuffer(int device, void *ptr);
+
+}  // namespace common
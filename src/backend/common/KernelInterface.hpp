@@ -95,7 +95,9 @@ class KernelInterface {
     template<typename EnqueueArgsType, typename... Args>
     void operator()(const EnqueueArgsType& qArgs, Args... args) {
         EnqueuerType launch;
-        launch(mKernelHandle, qArgs, std::forward<Args>(args)...);
+        // The module is passed so profiled launches can be attributed to it
+        launch(mModuleHandle, mKernelHandle, qArgs,
+               std::forward<Args>(args)...);
     }
 };
 
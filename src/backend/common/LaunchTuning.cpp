@@ -0,0 +1,180 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#if !defined(AF_CPU)
+
+#include <common/LaunchTuning.hpp>
+
+#include <backend.hpp>
+#include <common/defines.hpp>
+#include <common/util.hpp>
+#include <platform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+using std::ifstream;
+using std::lock_guard;
+using std::mutex;
+using std::ofstream;
+using std::ostringstream;
+using std::string;
+using std::unordered_map;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+namespace common {
+
+namespace {
+
+using ConfigMap = unordered_map<string, int>;
+
+struct TuningTable {
+    mutex lock;
+    ConfigMap configs;
+};
+
+/// Reads the lines of a tuning file, which are a key and the index of a
+/// configuration separated by a tab. The later lines of a key replace the
+/// earlier ones.
+void readConfigs(const string &path, ConfigMap &configs) {
+    ifstream file(path);
+    string line;
+    while (std::getline(file, line)) {
+        const size_t tab = line.rfind('\t');
+        if (tab == string::npos) { continue; }
+        try {
+            configs[line.substr(0, tab)] = std::stoi(line.substr(tab + 1));
+        } catch (...) {
+            // Ignore the lines which were not written completely
+        }
+    }
+}
+
+string tuningFilePath() {
+    const string &directory = getCacheDirectory();
+    if (directory.empty()) { return string(); }
+    return directory + AF_PATH_SEPARATOR + "launch_tuning.txt";
+}
+
+/// The table starts with the configurations saved by earlier runs
+TuningTable &tuningTable() {
+    static auto *table = [] {
+        auto *retVal = new TuningTable();
+        if (isLaunchAutotuneEnabled()) {
+            const string path = tuningFilePath();
+            if (!path.empty()) { readConfigs(path, retVal->configs); }
+        }
+        return retVal;
+    }();
+    return *table;
+}
+
+/// Returns the name of the active device, so the table can be shared by
+/// several machines with different devices
+const string &activeDeviceName() {
+    thread_local unordered_map<int, string> names;
+    const int device = static_cast<int>(detail::getActiveDeviceId());
+
+    auto iter = names.find(device);
+    if (iter == names.end()) {
+        char name[256]     = {};
+        char platform[256] = {};
+        char toolkit[256]  = {};
+        char compute[256]  = {};
+        detail::devprop(name, platform, toolkit, compute);
+        iter = names.emplace(device, string(name) + " " + compute).first;
+    }
+    return iter->second;
+}
+
+/// Returns the fastest of several launches of each configuration
+int benchmarkConfigs(const int numConfigs,
+                     const std::function<void(int)> &launch) {
+    constexpr int repetitions = 3;
+    const int device          = static_cast<int>(detail::getActiveDeviceId());
+
+    int best        = 0;
+    double bestTime = std::numeric_limits<double>::max();
+    for (int config = 0; config < numConfigs; ++config) {
+        // The first launch compiles the kernel
+        launch(config);
+        detail::sync(device);
+
+        double time = std::numeric_limits<double>::max();
+        for (int i = 0; i < repetitions; ++i) {
+            auto start = steady_clock::now();
+            launch(config);
+            detail::sync(device);
+            duration<double> elapsed = steady_clock::now() - start;
+            time = std::min(time, elapsed.count());
+        }
+        if (time < bestTime) {
+            best     = config;
+            bestTime = time;
+        }
+    }
+    return best;
+}
+
+}  // namespace
+
+bool isLaunchAutotuneEnabled() {
+    static const bool enabled = getEnvVar("AF_LAUNCH_AUTOTUNE") == "1";
+    return enabled;
+}
+
+int tuneLaunch(const string &kernel, const dim_t elements,
+               const int numConfigs, const int defaultConfig,
+               const std::function<void(int)> &launch) {
+    int bucket = 0;
+    while (bucket < 62 && (dim_t(1) << (bucket + 1)) <= elements) {
+        bucket++;
+    }
+
+    ostringstream key;
+    key << detail::getBackend() << ":" << activeDeviceName() << ":" << kernel
+        << ":" << bucket;
+
+    TuningTable &table = tuningTable();
+    {
+        lock_guard<mutex> lock(table.lock);
+        auto iter = table.configs.find(key.str());
+        // The saved tables may come from other versions
+        if (iter != table.configs.end() && iter->second >= 0 &&
+            iter->second < numConfigs) {
+            return iter->second;
+        }
+    }
+    if (!isLaunchAutotuneEnabled()) { return defaultConfig; }
+
+    const int config = benchmarkConfigs(numConfigs, launch);
+
+    lock_guard<mutex> lock(table.lock);
+    table.configs[key.str()] = config;
+    const string path        = tuningFilePath();
+    if (!path.empty()) {
+        // Each line is appended at once so that the lines of other
+        // processes do not interleave
+        ofstream file(path, std::ios::app);
+        file << key.str() + "\t" + std::to_string(config) + "\n"
+             << std::flush;
+    }
+    return config;
+}
+
+}  // namespace common
+
+#endif
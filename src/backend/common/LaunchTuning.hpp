@@ -0,0 +1,49 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+/// The tuning table of the launch configurations of the CUDA and OpenCL
+/// kernels.
+///
+/// A kernel which can be launched with several block or tile sizes asks the
+/// table for the configuration of its type and size on the active device.
+/// When AF_LAUNCH_AUTOTUNE is set, the configurations which are not in the
+/// table are benchmarked the first time they are needed and the fastest one
+/// is saved in the cache directory, so each device is only tuned once.
+#pragma once
+
+#include <af/defines.h>
+
+#include <functional>
+#include <string>
+
+namespace common {
+
+/// Returns true if the launch configurations which are not in the tuning
+/// table are benchmarked (see AF_LAUNCH_AUTOTUNE)
+bool isLaunchAutotuneEnabled();
+
+/// Returns the index of the fastest launch configuration of a kernel on the
+/// active device.
+///
+/// \param[in] kernel        The name of the kernel and the template
+///                          arguments which change its configurations
+/// \param[in] elements      The number of elements processed. The
+///                          configurations are tuned for each power of two.
+/// \param[in] numConfigs    The number of configurations
+/// \param[in] defaultConfig The configuration used when the kernel is not
+///                          in the table and autotuning is disabled
+/// \param[in] launch        Launches the kernel with a configuration. It is
+///                          called several times for each configuration
+///                          while tuning, so the kernel must not read its
+///                          output.
+int tuneLaunch(const std::string &kernel, const dim_t elements,
+               const int numConfigs, const int defaultConfig,
+               const std::function<void(int)> &launch);
+
+}  // namespace common
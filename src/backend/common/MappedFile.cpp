@@ -0,0 +1,113 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#if defined(OS_WIN)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <common/MappedFile.hpp>
+#include <common/err_common.hpp>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <string>
+
+using std::string;
+
+namespace common {
+
+namespace {
+
+/// Returns false if \p path cannot be opened
+bool getFileStatus(const string &path, std::size_t &size, long long &modTime) {
+#if defined(OS_WIN)
+    struct _stat64 status;
+    if (_stat64(path.c_str(), &status) != 0) { return false; }
+    modTime = static_cast<long long>(status.st_mtime);
+#else
+    struct stat status;
+    if (stat(path.c_str(), &status) != 0) { return false; }
+#if defined(__APPLE__)
+    modTime = static_cast<long long>(status.st_mtimespec.tv_sec) * 1000000000 +
+              status.st_mtimespec.tv_nsec;
+#else
+    modTime = static_cast<long long>(status.st_mtim.tv_sec) * 1000000000 +
+              status.st_mtim.tv_nsec;
+#endif
+#endif
+    size = static_cast<std::size_t>(status.st_size);
+    return true;
+}
+
+}  // namespace
+
+MappedFile::MappedFile(const string &path) : m_path(path) {
+    const string failed = "Failed to open: " + path;
+    if (!getFileStatus(path, m_size, m_modTime)) {
+        AF_ERROR(failed.c_str(), AF_ERR_ARG);
+    }
+    // Empty files cannot be mapped
+    if (m_size == 0) { return; }
+
+#if defined(OS_WIN)
+    // Other handles can append to and replace the file while it is mapped
+    m_file = CreateFileA(
+        path.c_str(), GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        AF_ERROR(failed.c_str(), AF_ERR_ARG);
+    }
+    m_mapping =
+        CreateFileMappingA(m_file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (m_mapping) {
+        m_data = static_cast<char *>(
+            MapViewOfFile(m_mapping, FILE_MAP_COPY, 0, 0, m_size));
+    }
+    if (!m_data) {
+        if (m_mapping) { CloseHandle(m_mapping); }
+        CloseHandle(m_file);
+        AF_ERROR(failed.c_str(), AF_ERR_ARG);
+    }
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) { AF_ERROR(failed.c_str(), AF_ERR_ARG); }
+    void *data =
+        mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    close(fd);
+    if (data == MAP_FAILED) { AF_ERROR(failed.c_str(), AF_ERR_ARG); }
+    m_data = static_cast<char *>(data);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    if (!m_data) { return; }
+#if defined(OS_WIN)
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    CloseHandle(m_file);
+#else
+    munmap(m_data, m_size);
+#endif
+}
+
+bool MappedFile::isCurrent() const {
+    std::size_t size  = 0;
+    long long modTime = 0;
+    return getFileStatus(m_path, size, modTime) && size == m_size &&
+           modTime == m_modTime;
+}
+
+}  // namespace common
@@ -0,0 +1,48 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace common {
+
+/// A file mapped into the address space of the process
+///
+/// The pages of the file are mapped copy on write. They can be modified
+/// without changing the file, so the mapped data can back an array.
+class MappedFile {
+    std::string m_path;
+    char *m_data        = nullptr;
+    std::size_t m_size  = 0;
+    long long m_modTime = 0;
+#if defined(OS_WIN)
+    void *m_file    = nullptr;
+    void *m_mapping = nullptr;
+#endif
+
+   public:
+    /// Maps \p path. Throws if the file cannot be opened or mapped.
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &)            = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const std::string &path() const { return m_path; }
+    char *data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+    /// True if the file on disk still has the size and modification time
+    /// it had when it was mapped
+    bool isCurrent() const;
+};
+
+}  // namespace common
@@ -11,9 +11,11 @@
 
 #include <Event.hpp>
 #include <common/AllocatorInterface.hpp>
+#include <af/device.h>
 
 #include <cstddef>
 #include <memory>
+#include <string>
 
 namespace spdlog {
 class logger;
@@ -61,8 +63,14 @@ class MemoryManagerBase {
 
     int getActiveDeviceId() { return nmi_->getActiveDeviceId(); }
     size_t getMaxMemorySize(int id) { return nmi_->getMaxMemorySize(id); }
+    size_t getFreeMemorySize(int id) { return nmi_->getFreeMemorySize(id); }
     void *nativeAlloc(const size_t bytes) { return nmi_->nativeAlloc(bytes); }
     void nativeFree(void *ptr) { nmi_->nativeFree(ptr); }
+    void *nativeSubAlloc(void *ptr, size_t offset, size_t bytes) {
+        return nmi_->nativeSubAlloc(ptr, offset, bytes);
+    }
+    void nativeSubFree(void *ptr) { nmi_->nativeSubFree(ptr); }
+    size_t getSubAllocAlignment() { return nmi_->getSubAllocAlignment(); }
     virtual spdlog::logger *getLogger() final { return nmi_->getLogger(); }
     virtual void setAllocator(std::unique_ptr<AllocatorInterface> nmi) {
         nmi_ = std::move(nmi);
@@ -78,6 +86,17 @@ class MemoryManagerBase {
     virtual float getMemoryPressure()                       = 0;
     virtual bool jitTreeExceedsMemoryPressure(size_t bytes) = 0;
 
+    // Memory statistics, which are recorded after setStatsEnabled(true)
+    virtual void setStatsEnabled(bool enabled)                = 0;
+    virtual void resetStats(int device)                       = 0;
+    virtual void getStats(af_mem_stats *stats, int device)    = 0;
+    virtual std::string getStatsJson(int device)              = 0;
+
+    // Memory scopes of the calling thread, whose allocations are taken from
+    // a slab of \p bytes
+    virtual void beginScope(size_t bytes) = 0;
+    virtual void endScope()               = 0;
+
    private:
     // A threshold at or above which JIT evaluations will be triggered due to
     // memory pressure. Settable via a call to setMemoryPressureThreshold
@@ -0,0 +1,133 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/MemoryStats.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+using std::max;
+using std::ostringstream;
+using std::string;
+
+namespace common {
+
+namespace {
+
+constexpr unsigned NUM_BUCKETS =
+    sizeof(af_mem_stats::size_histogram) / sizeof(size_t);
+
+string &allocationSite() {
+    thread_local string site;
+    return site;
+}
+
+/// Writes \p str as a JSON string
+void writeJsonString(ostringstream &out, const string &str) {
+    out << '"';
+    for (const char c : str) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out << escaped;
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+}  // namespace
+
+void setAllocationSite(const string &name) { allocationSite() = name; }
+
+MemoryStats::MemoryStats() : totals() {}
+
+void MemoryStats::record(size_t bytes, bool cache_hit, size_t lock_bytes,
+                         size_t lock_buffers) {
+    totals.num_allocs++;
+    if (cache_hit) {
+        totals.cache_hits++;
+    } else {
+        totals.cache_misses++;
+    }
+    totals.peak_bytes   = max(totals.peak_bytes, lock_bytes);
+    totals.peak_buffers = max(totals.peak_buffers, lock_buffers);
+
+    unsigned bucket = 0;
+    while (bucket + 1 < NUM_BUCKETS && (bytes >> (bucket + 1)) != 0) {
+        bucket++;
+    }
+    totals.size_histogram[bucket]++;
+
+    const string &site = allocationSite();
+    if (!site.empty()) {
+        site_info &info = sites[site];
+        info.num_allocs++;
+        info.bytes += bytes;
+    }
+}
+
+void MemoryStats::reset(size_t lock_bytes, size_t lock_buffers) {
+    totals              = af_mem_stats();
+    totals.peak_bytes   = lock_bytes;
+    totals.peak_buffers = lock_buffers;
+    sites.clear();
+}
+
+string MemoryStats::toJson(int device, bool enabled, size_t alloc_bytes,
+                           size_t alloc_buffers, size_t lock_bytes,
+                           size_t lock_buffers) const {
+    ostringstream out;
+    out << "{\"device\":" << device
+        << ",\"enabled\":" << (enabled ? "true" : "false")
+        << ",\"alloc_bytes\":" << alloc_bytes
+        << ",\"alloc_buffers\":" << alloc_buffers
+        << ",\"lock_bytes\":" << lock_bytes
+        << ",\"lock_buffers\":" << lock_buffers
+        << ",\"peak_bytes\":" << totals.peak_bytes
+        << ",\"peak_buffers\":" << totals.peak_buffers
+        << ",\"num_allocs\":" << totals.num_allocs
+        << ",\"cache_hits\":" << totals.cache_hits
+        << ",\"cache_misses\":" << totals.cache_misses;
+
+    // The non-empty buckets with the smallest size they count
+    out << ",\"size_histogram\":[";
+    bool first = true;
+    for (unsigned i = 0; i < NUM_BUCKETS; ++i) {
+        if (totals.size_histogram[i] == 0) { continue; }
+        if (!first) { out << ','; }
+        first = false;
+        out << "{\"min_bytes\":" << (size_t(1) << i)
+            << ",\"count\":" << totals.size_histogram[i] << '}';
+    }
+
+    out << "],\"sites\":{";
+    first = true;
+    for (const auto &kv : sites) {
+        if (!first) { out << ','; }
+        first = false;
+        writeJsonString(out, kv.first);
+        out << ":{\"num_allocs\":" << kv.second.num_allocs
+            << ",\"bytes\":" << kv.second.bytes << '}';
+    }
+    out << "}}";
+    return out.str();
+}
+
+}  // namespace common
@@ -0,0 +1,55 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <af/device.h>
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+namespace common {
+
+/// Sets the label of the allocations of the calling thread in the memory
+/// statistics. An empty name removes it.
+void setAllocationSite(const std::string &name);
+
+/// The memory statistics of a device. The memory managers record the
+/// allocations while holding their own lock.
+class MemoryStats {
+    struct site_info {
+        size_t num_allocs;
+        size_t bytes;
+    };
+
+    af_mem_stats totals;
+    std::map<std::string, site_info> sites;
+
+   public:
+    MemoryStats();
+
+    /// Records an allocation of \p bytes. \p lock_bytes and \p lock_buffers
+    /// are the usage of the device after the allocation.
+    void record(size_t bytes, bool cache_hit, size_t lock_bytes,
+                size_t lock_buffers);
+
+    /// Clears the statistics. The peak usage restarts from \p lock_bytes and
+    /// \p lock_buffers.
+    void reset(size_t lock_bytes, size_t lock_buffers);
+
+    const af_mem_stats &getTotals() const { return totals; }
+
+    /// Returns the statistics as a JSON object with the usage of the device
+    std::string toJson(int device, bool enabled, size_t alloc_bytes,
+                       size_t alloc_buffers, size_t lock_bytes,
+                       size_t lock_buffers) const;
+};
+
+}  // namespace common
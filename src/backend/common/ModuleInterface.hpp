@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 namespace common {
 
 /// Instances of this object are stored in jit kernel cache
@@ -16,6 +18,7 @@ template<typename ModuleType>
 class ModuleInterface {
    private:
     ModuleType mModuleHandle;
+    std::size_t mBytes = 0;
 
    public:
     /// \brief Creates an uninitialized Module
@@ -36,6 +39,17 @@ class ModuleInterface {
     /// \returns handle to backend specific module
     inline const ModuleType& get() const { return mModuleHandle; }
 
+    /// \brief Set the size of the binary of the module
+    ///
+    /// \param[in] bytes is the size of the binary loaded on the device
+    inline void setBytes(std::size_t bytes) { mBytes = bytes; }
+
+    /// \brief Get the size of the binary of the module
+    ///
+    /// \returns the size of the binary loaded on the device, or zero if it
+    ///          is unknown
+    inline std::size_t bytes() const { return mBytes; }
+
     /// \brief Unload module
     virtual void unload() = 0;
 
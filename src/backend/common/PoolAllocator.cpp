@@ -0,0 +1,130 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/PoolAllocator.hpp>
+
+#include <array>
+#include <vector>
+
+using std::size_t;
+
+namespace common {
+
+namespace {
+
+// The blocks are cached in size classes of kSmallStep bytes up to
+// kSmallBytes, which holds the nodes of the GPU backends, the Array objects
+// and the control blocks, and of kLargeStep bytes up to kMaxBlockBytes,
+// which holds the nodes of the CPU backend with their vector of values.
+constexpr size_t kSmallStep     = 16;
+constexpr size_t kSmallBytes    = 512;
+constexpr size_t kLargeStep     = 512;
+constexpr size_t kMaxBlockBytes = 8192;
+constexpr size_t kSmallClasses  = kSmallBytes / kSmallStep;
+constexpr size_t kNumClasses =
+    kSmallClasses + (kMaxBlockBytes - kSmallBytes) / kLargeStep;
+
+// The number of bytes of the freed blocks cached in each class. Blocks
+// freed beyond this are returned to the global allocator, so a thread which
+// frees many objects at once does not hold on to the memory.
+constexpr size_t kMaxCachedBytes = 1 << 20;
+
+size_t sizeClass(const size_t bytes) {
+    if (bytes <= kSmallBytes) {
+        return (bytes + kSmallStep - 1) / kSmallStep - 1;
+    }
+    const size_t large = bytes - kSmallBytes;
+    return kSmallClasses + (large + kLargeStep - 1) / kLargeStep - 1;
+}
+
+/// Returns the size of the blocks of the class of \p bytes
+size_t blockBytes(const size_t bytes) {
+    const size_t cls = sizeClass(bytes);
+    if (cls < kSmallClasses) { return (cls + 1) * kSmallStep; }
+    return kSmallBytes + (cls - kSmallClasses + 1) * kLargeStep;
+}
+
+class BlockCache {
+    std::array<std::vector<void *>, kNumClasses> m_free;
+
+   public:
+    BlockCache() = default;
+
+    BlockCache(const BlockCache &) = delete;
+    BlockCache &operator=(const BlockCache &) = delete;
+
+    ~BlockCache() {
+        for (auto &blocks : m_free) {
+            for (void *block : blocks) { ::operator delete(block); }
+        }
+    }
+
+    void *allocate(const size_t bytes) {
+        auto &blocks = m_free[sizeClass(bytes)];
+        if (blocks.empty()) {
+            return ::operator new(blockBytes(bytes));
+        }
+        void *block = blocks.back();
+        blocks.pop_back();
+        return block;
+    }
+
+    void deallocate(void *ptr, const size_t bytes) noexcept {
+        auto &blocks = m_free[sizeClass(bytes)];
+        if (blocks.size() * blockBytes(bytes) < kMaxCachedBytes) {
+            try {
+                blocks.push_back(ptr);
+                return;
+            } catch (...) {}
+        }
+        ::operator delete(ptr);
+    }
+};
+
+// The cache of a thread is destroyed when the thread exits. Objects which
+// are destroyed later, like the thread local objects destroyed after the
+// cache, return their blocks to the global allocator. The flag is trivially
+// destructible, so it is valid during the destruction of the thread.
+thread_local bool cacheDestroyed = false;
+
+struct ThreadCache {
+    BlockCache cache;
+    ~ThreadCache() { cacheDestroyed = true; }
+};
+
+BlockCache *threadCache() {
+    if (cacheDestroyed) { return nullptr; }
+    thread_local ThreadCache threadCache;
+    return &threadCache.cache;
+}
+
+}  // namespace
+
+void *poolAllocate(const size_t bytes) {
+    if (bytes == 0 || bytes > kMaxBlockBytes) { return ::operator new(bytes); }
+    BlockCache *cache = threadCache();
+    // The blocks always have the size of their class, because a block
+    // allocated after the destruction of a cache can be cached by another
+    // thread
+    return cache ? cache->allocate(bytes) : ::operator new(blockBytes(bytes));
+}
+
+void poolDeallocate(void *ptr, const size_t bytes) noexcept {
+    if (ptr == nullptr) { return; }
+    BlockCache *cache = bytes == 0 || bytes > kMaxBlockBytes
+                            ? nullptr
+                            : threadCache();
+    if (cache) {
+        cache->deallocate(ptr, bytes);
+    } else {
+        ::operator delete(ptr);
+    }
+}
+
+}  // namespace common
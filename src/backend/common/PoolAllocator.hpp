@@ -0,0 +1,84 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace common {
+
+/// Allocates \p bytes from the block cache of the calling thread.
+///
+/// The small objects which are created and destroyed for every operation,
+/// like the JIT nodes, the Array objects and the control blocks of their
+/// shared pointers, reuse the blocks freed by the thread instead of calling
+/// the global allocator. Larger allocations are forwarded to operator new.
+void *poolAllocate(std::size_t bytes);
+
+/// Returns the block \p ptr of \p bytes allocated by poolAllocate.
+///
+/// The block can be returned by any thread. It is cached by the returning
+/// thread, which is the common case of objects destroyed on the thread
+/// that created them.
+void poolDeallocate(void *ptr, std::size_t bytes) noexcept;
+
+/// The standard allocator interface of the block cache. It is used with
+/// std::allocate_shared to allocate the object and the control block of a
+/// shared pointer in one cached block.
+template<typename T>
+class PoolAllocator {
+   public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U> & /*other*/) noexcept {}
+
+    T *allocate(std::size_t n) {
+        return static_cast<T *>(poolAllocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, std::size_t n) noexcept {
+        poolDeallocate(ptr, n * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U> & /*other*/) const noexcept {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const PoolAllocator<U> & /*other*/) const noexcept {
+        return false;
+    }
+};
+
+/// Creates a shared \p T whose object and control block are allocated from
+/// the block cache
+template<typename T, typename... Args>
+std::shared_ptr<T> makePooled(Args &&...args) {
+    return std::allocate_shared<T>(PoolAllocator<T>(),
+                                   std::forward<Args>(args)...);
+}
+
+/// Declares the class specific operator new and delete of a class whose
+/// objects are allocated from the block cache
+#define AF_POOL_ALLOCATED                                                \
+    static void *operator new(std::size_t bytes) {                       \
+        return common::poolAllocate(bytes);                              \
+    }                                                                    \
+    static void operator delete(void *ptr, std::size_t bytes) noexcept { \
+        common::poolDeallocate(ptr, bytes);                              \
+    }
+
+}  // namespace common
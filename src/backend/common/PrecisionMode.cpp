@@ -0,0 +1,67 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/PrecisionMode.hpp>
+
+#include <common/err_common.hpp>
+#include <common/util.hpp>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+using std::atomic;
+using std::string;
+using std::vector;
+
+namespace common {
+
+namespace {
+
+af_precision_mode readPrecisionMode() {
+    const string env = getEnvVar(PRECISION_MODE_ENV_NAME);
+    if (env == "strict") { return AF_PRECISION_STRICT; }
+    if (env == "relaxed") { return AF_PRECISION_RELAXED; }
+    if (env == "fast") { return AF_PRECISION_FAST; }
+    return AF_PRECISION_DEFAULT;
+}
+
+atomic<af_precision_mode> &globalMode() {
+    static atomic<af_precision_mode> mode(readPrecisionMode());
+    return mode;
+}
+
+/// The modes of the precision scopes of the calling thread
+vector<af_precision_mode> &scopeModes() {
+    thread_local vector<af_precision_mode> modes;
+    return modes;
+}
+
+}  // namespace
+
+void setPrecisionMode(const af_precision_mode mode) { globalMode() = mode; }
+
+af_precision_mode getPrecisionMode() {
+    const vector<af_precision_mode> &modes = scopeModes();
+    return modes.empty() ? globalMode().load() : modes.back();
+}
+
+void beginPrecisionScope(const af_precision_mode mode) {
+    scopeModes().push_back(mode);
+}
+
+void endPrecisionScope() {
+    vector<af_precision_mode> &modes = scopeModes();
+    if (modes.empty()) {
+        AF_ERROR("No precision scope was started on this thread", AF_ERR_ARG);
+    }
+    modes.pop_back();
+}
+
+}  // namespace common
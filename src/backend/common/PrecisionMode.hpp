@@ -0,0 +1,40 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+/// The floating point precision mode of the CUDA and OpenCL kernels.
+///
+/// The mode selects the options of the runtime compilers. It is part of the
+/// key of the compiled modules, so the modules of each mode are cached
+/// separately in memory and on disk. The global mode is read from
+/// AF_PRECISION_MODE and can be replaced by af_set_precision_mode. Precision
+/// scopes override it on their thread.
+#pragma once
+
+#include <af/defines.h>
+
+namespace common {
+
+/// The environment variable which sets the initial global precision mode.
+/// Its values are strict, relaxed and fast.
+constexpr const char *PRECISION_MODE_ENV_NAME = "AF_PRECISION_MODE";
+
+/// Sets the precision mode used outside of the precision scopes
+void setPrecisionMode(af_precision_mode mode);
+
+/// Returns the precision mode of the calling thread, which is the mode of
+/// its innermost precision scope or the global mode
+af_precision_mode getPrecisionMode();
+
+/// Starts a scope of the calling thread which uses \p mode
+void beginPrecisionScope(af_precision_mode mode);
+
+/// Ends the innermost precision scope of the calling thread
+void endPrecisionScope();
+
+}  // namespace common
@@ -0,0 +1,235 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/Profiler.hpp>
+#include <common/util.hpp>
+
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <link.h>
+#endif
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using std::function;
+using std::lock_guard;
+using std::mutex;
+using std::string;
+using std::unordered_map;
+using std::vector;
+using std::chrono::steady_clock;
+
+namespace common {
+
+namespace {
+
+#if defined(AF_CPU)
+constexpr const char* profiledBackend  = "CPU";
+constexpr const char* profiledCategory = "task";
+#elif defined(AF_CUDA)
+constexpr const char* profiledBackend  = "CUDA";
+constexpr const char* profiledCategory = "kernel";
+#else
+constexpr const char* profiledBackend  = "OpenCL";
+constexpr const char* profiledCategory = "kernel";
+#endif
+
+struct Profiler;
+void writeTimeline(Profiler& profiler, const string& path);
+
+struct Profiler {
+    mutex profilerMutex;
+    vector<ProfileEvent> events;
+    unordered_map<const void*, string> names;
+    unordered_map<const void*, string> symbols;
+    function<void()> flush;
+    const string path;
+    const steady_clock::time_point begin;
+
+    Profiler() : path(getEnvVar("AF_PROFILE")), begin(steady_clock::now()) {}
+
+    ~Profiler() {
+        if (path.empty()) { return; }
+        try {
+            writeTimeline(*this, path);
+        } catch (...) {
+            // The devices may already be released when the library is
+            // unloaded, in which case the pending launches are dropped
+        }
+    }
+};
+
+Profiler& getProfiler() {
+    static Profiler profiler;
+    return profiler;
+}
+
+#if defined(__GLIBC__)
+/// Returns the name of the exported function which contains an address, or
+/// an empty string. The size of the symbol is checked because dladdr returns
+/// the closest exported symbol for the addresses of internal functions.
+string getSymbolName(void* address) {
+    Dl_info info;
+    void* extra = nullptr;
+    if (dladdr1(address, &info, &extra, RTLD_DL_SYMENT) == 0 ||
+        info.dli_sname == nullptr || extra == nullptr) {
+        return string();
+    }
+    const auto* symbol = static_cast<const ElfW(Sym)*>(extra);
+    auto offset = static_cast<size_t>(static_cast<const char*>(address) -
+                                      static_cast<const char*>(info.dli_saddr));
+    return offset < symbol->st_size ? string(info.dli_sname) : string();
+}
+#endif
+
+void writeEscaped(std::ostream& out, const string& value) {
+    out << '"';
+    for (char c : value) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char code[8];
+                    snprintf(code, sizeof(code), "\\u%04x",
+                             static_cast<unsigned>(c));
+                    out << code;
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+void writeTimeline(Profiler& profiler, const string& path) {
+    function<void()> flush;
+    {
+        lock_guard<mutex> lock(profiler.profilerMutex);
+        flush = profiler.flush;
+    }
+    // The flush adds events, so it is called without the lock
+    if (flush) { flush(); }
+
+    vector<ProfileEvent> events;
+    {
+        lock_guard<mutex> lock(profiler.profilerMutex);
+        events = profiler.events;
+    }
+
+    std::ofstream out(path);
+    if (!out) { return; }
+    out.precision(3);
+    out << std::fixed << "{\"traceEvents\":[\n";
+
+    // Each device is shown as a thread of the process
+    std::set<int> devices;
+    for (const ProfileEvent& event : events) { devices.insert(event.device); }
+    bool first = true;
+    for (int device : devices) {
+        out << (first ? "" : ",\n");
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":"
+            << device << ",\"args\":{\"name\":\"" << profiledBackend
+            << " device " << device << "\"}}";
+        first = false;
+    }
+    for (const ProfileEvent& event : events) {
+        out << (first ? "" : ",\n") << "{\"name\":";
+        writeEscaped(out, event.name.empty() ? event.function : event.name);
+        out << ",\"cat\":\"" << profiledCategory << "\",\"ph\":\"X\",\"ts\":"
+            << event.start << ",\"dur\":" << event.duration
+            << ",\"pid\":0,\"tid\":" << event.device
+            << ",\"args\":{\"function\":";
+        writeEscaped(out, event.function);
+        out << ",\"module\":";
+        writeEscaped(out, event.module);
+        out << "}}";
+        first = false;
+    }
+    out << "\n]}\n";
+}
+
+}  // namespace
+
+bool isProfiling() {
+    static const bool profiling = !getProfiler().path.empty();
+    return profiling;
+}
+
+double profileClock() {
+    std::chrono::duration<double, std::micro> elapsed =
+        steady_clock::now() - getProfiler().begin;
+    return elapsed.count();
+}
+
+string getProfiledFunction() {
+#if defined(__GLIBC__)
+    constexpr int maxFrames = 64;
+    void* frames[maxFrames];
+    int count = backtrace(frames, maxFrames);
+
+    Profiler& profiler = getProfiler();
+    lock_guard<mutex> lock(profiler.profilerMutex);
+    const string* function = nullptr;
+    for (int i = 0; i < count; ++i) {
+        auto iter = profiler.symbols.find(frames[i]);
+        if (iter == profiler.symbols.end()) {
+            iter = profiler.symbols
+                       .emplace(frames[i], getSymbolName(frames[i]))
+                       .first;
+        }
+        // The frames go from the innermost to the outermost call
+        if (iter->second.compare(0, 3, "af_") == 0) {
+            function = &iter->second;
+        }
+    }
+    return function ? *function : string();
+#else
+    return string();
+#endif
+}
+
+void setProfiledName(const void* handle, const string& name) {
+    Profiler& profiler = getProfiler();
+    lock_guard<mutex> lock(profiler.profilerMutex);
+    profiler.names[handle] = name;
+}
+
+string getProfiledName(const void* handle) {
+    Profiler& profiler = getProfiler();
+    lock_guard<mutex> lock(profiler.profilerMutex);
+    auto iter = profiler.names.find(handle);
+    return iter == profiler.names.end() ? string() : iter->second;
+}
+
+void addProfileEvent(ProfileEvent event) {
+    Profiler& profiler = getProfiler();
+    lock_guard<mutex> lock(profiler.profilerMutex);
+    profiler.events.push_back(std::move(event));
+}
+
+void setProfileFlush(function<void()> flush) {
+    Profiler& profiler = getProfiler();
+    lock_guard<mutex> lock(profiler.profilerMutex);
+    profiler.flush = std::move(flush);
+}
+
+void writeProfile(const string& path) { writeTimeline(getProfiler(), path); }
+
+}  // namespace common
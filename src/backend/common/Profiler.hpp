@@ -0,0 +1,64 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+/// The profiler records the kernels and queue tasks launched by the library
+/// when the environment variable AF_PROFILE names a file. The timeline is
+/// written to this file as Chrome trace JSON when the library is unloaded,
+/// and can be opened in chrome://tracing or Perfetto.
+#pragma once
+
+#include <functional>
+#include <string>
+
+namespace common {
+
+/// A kernel or task recorded by the profiler
+struct ProfileEvent {
+    /// The name of the kernel or task
+    std::string name;
+    /// The af_* function which launched it
+    std::string function;
+    /// The key of the module of the kernel. Empty for CPU tasks
+    std::string module;
+    /// The device which ran it
+    int device;
+    /// The start, in microseconds since the profiler started
+    double start;
+    /// The duration, in microseconds
+    double duration;
+};
+
+/// Returns true if the launches are profiled (see AF_PROFILE)
+bool isProfiling();
+
+/// Returns the microseconds elapsed on the host since the profiler started
+double profileClock();
+
+/// Returns the name of the outermost af_* function on the stack of the
+/// calling thread, or an empty string if it cannot be found
+std::string getProfiledFunction();
+
+/// Associates a name with a kernel or module handle, so its launches are
+/// attributed to it
+void setProfiledName(const void* handle, const std::string& name);
+
+/// Returns the name associated with a handle by setProfiledName
+std::string getProfiledName(const void* handle);
+
+/// Adds a launch to the timeline
+void addProfileEvent(ProfileEvent event);
+
+/// Sets the function which adds the launches whose device timestamps are
+/// still pending. It is called before the timeline is written.
+void setProfileFlush(std::function<void()> flush);
+
+/// Writes the timeline recorded so far to a file as Chrome trace JSON
+void writeProfile(const std::string& path);
+
+}  // namespace common
@@ -0,0 +1,81 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/RegisteredHostMemory.hpp>
+
+#include <common/err_common.hpp>
+
+#include <iterator>
+#include <map>
+#include <mutex>
+
+using std::lock_guard;
+using std::map;
+using std::mutex;
+using std::size_t;
+
+namespace common {
+
+namespace {
+
+/// The registered ranges by their first byte
+struct RegisteredRanges {
+    mutex lock;
+    map<const char *, size_t> ranges;
+};
+
+RegisteredRanges &getRegisteredRanges() {
+    static auto *ranges = new RegisteredRanges();
+    return *ranges;
+}
+
+}  // namespace
+
+void addRegisteredHostMemory(void *ptr, const size_t bytes) {
+    RegisteredRanges &registered = getRegisteredRanges();
+    lock_guard<mutex> lock(registered.lock);
+
+    const char *begin = static_cast<const char *>(ptr);
+    auto next         = registered.ranges.lower_bound(begin);
+    const bool overlapsNext =
+        next != registered.ranges.end() && next->first < begin + bytes;
+    const bool overlapsPrev =
+        next != registered.ranges.begin() &&
+        std::prev(next)->first + std::prev(next)->second > begin;
+    if (overlapsNext || overlapsPrev) {
+        AF_ERROR("The host memory overlaps memory which is already registered",
+                 AF_ERR_ARG);
+    }
+    registered.ranges.emplace(begin, bytes);
+}
+
+size_t removeRegisteredHostMemory(void *ptr) {
+    RegisteredRanges &registered = getRegisteredRanges();
+    lock_guard<mutex> lock(registered.lock);
+
+    auto iter = registered.ranges.find(static_cast<const char *>(ptr));
+    if (iter == registered.ranges.end()) { return 0; }
+    const size_t bytes = iter->second;
+    registered.ranges.erase(iter);
+    return bytes;
+}
+
+size_t registeredHostBytes(const void *ptr) {
+    RegisteredRanges &registered = getRegisteredRanges();
+    lock_guard<mutex> lock(registered.lock);
+
+    const char *pos = static_cast<const char *>(ptr);
+    auto next       = registered.ranges.upper_bound(pos);
+    if (next == registered.ranges.begin()) { return 0; }
+    const auto &range = *std::prev(next);
+    const char *end   = range.first + range.second;
+    return pos < end ? static_cast<size_t>(end - pos) : 0;
+}
+
+}  // namespace common
@@ -0,0 +1,31 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+namespace common {
+
+/// Records the range of \p bytes of host memory at \p ptr registered by
+/// af_register_host_memory. Throws if the range overlaps a registered
+/// range.
+void addRegisteredHostMemory(void *ptr, std::size_t bytes);
+
+/// Removes the range which starts at \p ptr
+///
+/// \returns the size of the range, or zero if \p ptr does not start a
+///          registered range
+std::size_t removeRegisteredHostMemory(void *ptr);
+
+/// Returns the number of registered bytes from \p ptr to the end of the
+/// registered range which holds it, or zero if \p ptr is not registered
+std::size_t registeredHostBytes(const void *ptr);
+
+}  // namespace common
@@ -48,7 +48,8 @@ SparseArrayBase::SparseArrayBase(const af::dim4 &_dims, dim_t _nNZ,
     : info(getActiveDeviceId(), _dims, 0, calcStrides(_dims), _type, true)
     , stype(_storage)
     , rowIdx(createValueArray<int>(dim4(ROW_LENGTH), 0))
-    , colIdx(createValueArray<int>(dim4(COL_LENGTH), 0)) {
+    , colIdx(createValueArray<int>(dim4(COL_LENGTH), 0))
+    , blockSize(1) {
     static_assert(offsetof(SparseArrayBase, info) == 0,
                   "SparseArrayBase::info must be the first member variable of "
                   "SparseArrayBase.");
@@ -73,7 +74,8 @@ SparseArrayBase::SparseArrayBase(const af::dim4 &_dims, dim_t _nNZ,
                  ? (!_copy_device
                         ? createDeviceDataArray<int>(dim4(COL_LENGTH), _colIdx)
                         : createValueArray<int>(dim4(COL_LENGTH), 0))
-                 : createHostDataArray<int>(dim4(COL_LENGTH), _colIdx)) {
+                 : createHostDataArray<int>(dim4(COL_LENGTH), _colIdx))
+    , blockSize(1) {
     static_assert(offsetof(SparseArrayBase, info) == 0,
                   "SparseArrayBase::info must be the first member variable of "
                   "SparseArrayBase.");
@@ -87,11 +89,12 @@ SparseArrayBase::SparseArrayBase(const af::dim4 &_dims,
                                  const Array<int> &_rowIdx,
                                  const Array<int> &_colIdx,
                                  const af::storage _storage, af_dtype _type,
-                                 bool _copy)
+                                 bool _copy, int _blockSize)
     : info(getActiveDeviceId(), _dims, 0, calcStrides(_dims), _type, true)
     , stype(_storage)
     , rowIdx(_copy ? copyArray<int>(_rowIdx) : _rowIdx)
-    , colIdx(_copy ? copyArray<int>(_colIdx) : _colIdx) {
+    , colIdx(_copy ? copyArray<int>(_colIdx) : _colIdx)
+    , blockSize(_blockSize) {
     static_assert(offsetof(SparseArrayBase, info) == 0,
                   "SparseArrayBase::info must be the first member variable of "
                   "SparseArrayBase.");
@@ -101,7 +104,9 @@ SparseArrayBase::SparseArrayBase(const SparseArrayBase &base, bool copy)
     : info(base.info)
     , stype(base.stype)
     , rowIdx(copy ? copyArray<int>(base.rowIdx) : base.rowIdx)
-    , colIdx(copy ? copyArray<int>(base.colIdx) : base.colIdx) {}
+    , colIdx(copy ? copyArray<int>(base.colIdx) : base.colIdx)
+    , blockSize(base.blockSize)
+    , cache(copy ? nullptr : base.cache) {}
 
 SparseArrayBase::~SparseArrayBase() = default;
 
@@ -110,6 +115,11 @@ dim_t SparseArrayBase::getNNZ() const {
         return rowIdx.elements();
     }
     if (stype == AF_STORAGE_CSR) { return colIdx.elements(); }
+    // The values of the blocks and of the padding of the slices
+    if (stype == AF_STORAGE_BSR) {
+        return colIdx.elements() * blockSize * blockSize;
+    }
+    if (stype == AF_STORAGE_SELL) { return colIdx.elements(); }
 
     // This is to ensure future storages are properly configured
     return 0;
@@ -155,6 +165,15 @@ SparseArray<T> createArrayDataSparseArray(
     return SparseArray<T>(_dims, _values, _rowIdx, _colIdx, _storage, _copy);
 }
 
+template<typename T>
+SparseArray<T> createBlockedSparseArray(
+    const af::dim4 &_dims, const Array<T> &_values, const Array<int> &_rowIdx,
+    const Array<int> &_colIdx, const af::storage _storage,
+    const int _blockSize) {
+    return SparseArray<T>(_dims, _values, _rowIdx, _colIdx, _storage, false,
+                          _blockSize);
+}
+
 template<typename T>
 SparseArray<T> copySparseArray(const SparseArray<T> &other) {
     return SparseArray<T>(other, true);
@@ -210,9 +229,10 @@ template<typename T>
 SparseArray<T>::SparseArray(const af::dim4 &_dims, const Array<T> &_values,
                             const Array<int> &_rowIdx,
                             const Array<int> &_colIdx,
-                            const af::storage _storage, bool _copy)
+                            const af::storage _storage, bool _copy,
+                            int _blockSize)
     : base(_dims, _rowIdx, _colIdx, _storage,
-           static_cast<af_dtype>(dtype_traits<T>::af_type), _copy)
+           static_cast<af_dtype>(dtype_traits<T>::af_type), _copy, _blockSize)
     , values(_copy ? copyArray<T>(_values) : _values) {}
 
 template<typename T>
@@ -220,6 +240,17 @@ SparseArray<T>::SparseArray(const SparseArray<T> &other, bool copy)
     : base(other.base, copy)
     , values(copy ? copyArray<T>(other.values) : other.values) {}
 
+template<typename T>
+void SparseArray<T>::setValues(const Array<T> &newValues) {
+    if (values.isLinear() && values.useCount() == 1) {
+        copyArray<T, T>(values, newValues);
+        if (base.getCache()) { base.getCache()->valuesChanged(); }
+    } else {
+        values = copyArray<T>(newValues);
+        base.dropCache();
+    }
+}
+
 #define INSTANTIATE(T)                                                       \
     template SparseArray<T> createEmptySparseArray<T>(                       \
         const af::dim4 &_dims, dim_t _nNZ, const af::storage _storage);      \
@@ -236,6 +267,10 @@ SparseArray<T>::SparseArray(const SparseArray<T> &other, bool copy)
         const af::dim4 &_dims, const Array<T> &_values,                      \
         const Array<int> &_rowIdx, const Array<int> &_colIdx,                \
         const af::storage _storage, const bool _copy);                       \
+    template SparseArray<T> createBlockedSparseArray<T>(                     \
+        const af::dim4 &_dims, const Array<T> &_values,                      \
+        const Array<int> &_rowIdx, const Array<int> &_colIdx,                \
+        const af::storage _storage, const int _blockSize);                   \
     template SparseArray<T> *initSparseArray<T>();                           \
     template SparseArray<T> copySparseArray<T>(const SparseArray<T> &other); \
     template void destroySparseArray<T>(SparseArray<T> * sparse);            \
@@ -249,7 +284,8 @@ SparseArray<T>::SparseArray(const SparseArray<T> &other, bool copy)
     template SparseArray<T>::SparseArray(                                    \
         const af::dim4 &_dims, const Array<T> &_values,                      \
         const Array<int> &_rowIdx, const Array<int> &_colIdx,                \
-        const af::storage _storage, bool _copy)
+        const af::storage _storage, bool _copy, int _blockSize);             \
+    template void SparseArray<T>::setValues(const Array<T> &newValues)
 
 // Instantiate only floating types
 INSTANTIATE(float);
@@ -14,6 +14,7 @@
 #include <common/sparse_helpers.hpp>
 
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 namespace common {
@@ -21,6 +22,20 @@ namespace common {
 template<typename T>
 class SparseArray;
 
+/// The base of the data a backend derives from the indices and values of a
+/// SparseArray, like the descriptors, the analysis and the workspace of its
+/// sparse BLAS library. It is kept with the array so that repeated products
+/// with the same matrix reuse it.
+class SparseArrayCache {
+   public:
+    virtual ~SparseArrayCache() = default;
+
+    /// Called after the values were overwritten in place. The indices and the
+    /// buffers are the same, so only the data which copies the values needs
+    /// to be refreshed.
+    virtual void valuesChanged() {}
+};
+
 /// SparseArray Array Info class
 ///
 /// This class is the base class to all SparseArray objects. The purpose of this
@@ -33,9 +48,15 @@ class SparseArrayBase {
    private:
     ArrayInfo
         info;  ///< NOTE: This must be the first element of SparseArray<T>.
-    af::storage stype;          ///< Storage format: CSR, CSC, COO
+    af::storage stype;          ///< Storage format: CSR, CSC, COO, BSR, SELL
     detail::Array<int> rowIdx;  ///< Linear array containing row indices
     detail::Array<int> colIdx;  ///< Linear array containing col indices
+    int blockSize;  ///< The block size of BSR or the slice height of SELL
+
+    /// The backend data derived from the indices and values. The shallow
+    /// copies of the array share it, and it is dropped when the indices or
+    /// the values can be modified.
+    mutable std::shared_ptr<SparseArrayCache> cache;
 
    public:
     SparseArrayBase(SparseArrayBase &&other) noexcept = default;
@@ -50,7 +71,7 @@ class SparseArrayBase {
     SparseArrayBase(const af::dim4 &_dims, const detail::Array<int> &_rowIdx,
                     const detail::Array<int> &_colIdx,
                     const af::storage _storage, af_dtype _type,
-                    bool _copy = false);
+                    bool _copy = false, int _blockSize = 1);
 
     SparseArrayBase &operator=(SparseArrayBase other) noexcept {
         std::swap(*this, other);
@@ -108,19 +129,40 @@ class SparseArrayBase {
     }
 
     /// Returns the row indices for the corresponding values in the SparseArray
-    detail::Array<int> &getRowIdx() { return rowIdx; }
+    detail::Array<int> &getRowIdx() {
+        dropCache();
+        return rowIdx;
+    }
     const detail::Array<int> &getRowIdx() const { return rowIdx; }
 
     /// Returns the column indices for the corresponding values in the
     /// SparseArray
-    detail::Array<int> &getColIdx() { return colIdx; }
+    detail::Array<int> &getColIdx() {
+        dropCache();
+        return colIdx;
+    }
     const detail::Array<int> &getColIdx() const { return colIdx; }
 
+    /// Returns the backend data cached for the array, or null
+    const std::shared_ptr<SparseArrayCache> &getCache() const { return cache; }
+
+    /// Keeps \p data with the array until its indices or values change
+    void setCache(std::shared_ptr<SparseArrayCache> data) const {
+        cache = std::move(data);
+    }
+
+    /// Drops the cached backend data
+    void dropCache() { cache.reset(); }
+
     /// Returns the number of non-zero elements in the array.
     dim_t getNNZ() const;
 
     /// Returns the storage format of the SparseArray
     af::storage getStorage() const { return stype; }
+
+    /// Returns the block size of BSR or the slice height of SELL, and 1 for
+    /// the other storage formats
+    int getBlockSize() const { return blockSize; }
 };
 static_assert(std::is_standard_layout<SparseArrayBase>::value,
               "SparseArrayBase must be a standard layout type");
@@ -145,7 +187,7 @@ class SparseArray {
     SparseArray(const af::dim4 &_dims, const detail::Array<T> &_values,
                 const detail::Array<int> &_rowIdx,
                 const detail::Array<int> &_colIdx, const af::storage _storage,
-                bool _copy = false);
+                bool _copy = false, int _blockSize = 1);
 
     /// A copy constructor for SparseArray
     ///
@@ -197,6 +239,12 @@ class SparseArray {
     // Function from Base but not in ArrayInfo
     INSTANTIATE_INFO(dim_t, getNNZ)
     INSTANTIATE_INFO(af::storage, getStorage)
+    INSTANTIATE_INFO(int, getBlockSize)
+    INSTANTIATE_INFO(const std::shared_ptr<SparseArrayCache> &, getCache)
+
+    void setCache(std::shared_ptr<SparseArrayCache> data) const {
+        base.setCache(std::move(data));
+    }
 
     detail::Array<int> &getRowIdx() { return base.getRowIdx(); }
     detail::Array<int> &getColIdx() { return base.getColIdx(); }
@@ -211,9 +259,17 @@ class SparseArray {
     }
 
     // Return the values array
-    detail::Array<T> &getValues() { return values; }
+    detail::Array<T> &getValues() {
+        base.dropCache();
+        return values;
+    }
     const detail::Array<T> &getValues() const { return values; }
 
+    /// Replaces the values and keeps the indices. The values are copied into
+    /// the buffer of the array, which keeps the cached data, unless another
+    /// array shares the buffer.
+    void setValues(const detail::Array<T> &newValues);
+
     void eval() const {
         getValues().eval();
         getRowIdx().eval();
@@ -240,6 +296,11 @@ class SparseArray {
         const detail::Array<int> &_rowIdx, const detail::Array<int> &_colIdx,
         const af::storage _storage, const bool _copy);
 
+    friend SparseArray<T> createBlockedSparseArray<T>(
+        const af::dim4 &_dims, const detail::Array<T> &_values,
+        const detail::Array<int> &_rowIdx, const detail::Array<int> &_colIdx,
+        const af::storage _storage, const int _blockSize);
+
     friend SparseArray<T> *initSparseArray<T>();
 
     friend SparseArray<T> copySparseArray<T>(const SparseArray<T> &input);
@@ -0,0 +1,55 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Array.hpp>
+#include <common/SparseArray.hpp>
+#include <af/dim4.hpp>
+
+namespace common {
+
+/// The sparsity pattern of the product of two CSR arrays, which is computed by
+/// the symbolic phase of the product. The products of the same left hand side
+/// with right hand sides of the same pattern only run the numeric phase.
+///
+/// The indices of the right hand side are kept so that their buffers cannot be
+/// reused by another pattern while the pattern is cached.
+struct SpgemmPattern {
+    detail::Array<int> rhsRowIdx;
+    detail::Array<int> rhsColIdx;
+    af::dim4 rhsDims;
+
+    detail::Array<int> rowIdx;  ///< The row offsets of the product
+    detail::Array<int> colIdx;  ///< The sorted column indices of each row
+
+    template<typename T>
+    SpgemmPattern(const SparseArray<T> &rhs, detail::Array<int> rowIdx_,
+                  detail::Array<int> colIdx_)
+        : rhsRowIdx(rhs.getRowIdx())
+        , rhsColIdx(rhs.getColIdx())
+        , rhsDims(rhs.dims())
+        , rowIdx(rowIdx_)
+        , colIdx(colIdx_) {}
+
+    /// Returns true if \p rhs has the indices the pattern was computed for
+    template<typename T>
+    bool matches(const SparseArray<T> &rhs) const {
+        const detail::Array<int> &r = rhs.getRowIdx();
+        const detail::Array<int> &c = rhs.getColIdx();
+        return rhs.dims() == rhsDims && r.get() == rhsRowIdx.get() &&
+               r.getOffset() == rhsRowIdx.getOffset() &&
+               c.get() == rhsColIdx.get() &&
+               c.getOffset() == rhsColIdx.getOffset();
+    }
+
+    dim_t getNNZ() const { return colIdx.elements(); }
+};
+
+}  // namespace common
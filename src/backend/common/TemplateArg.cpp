@@ -284,3 +284,17 @@ string toString(af_homography_type val) {
 #undef CASE_STMT
     return retVal;
 }
+
+template<>
+string toString(af_gemm_epilogue val) {
+    const char* retVal = NULL;
+#define CASE_STMT(v) \
+    case v: retVal = #v; break
+    switch (val) {
+        CASE_STMT(AF_GEMM_EPILOGUE_NONE);
+        CASE_STMT(AF_GEMM_EPILOGUE_RELU);
+        CASE_STMT(AF_GEMM_EPILOGUE_GELU);
+    }
+#undef CASE_STMT
+    return retVal;
+}
@@ -34,5 +34,6 @@ SPECIALIZE(unsigned int, detail::uint);
 SPECIALIZE(unsigned short, detail::ushort);
 SPECIALIZE(long long, long long);
 SPECIALIZE(unsigned long long, unsigned long long);
+SPECIALIZE(common::bfloat16, detail::ushort);
 
 #undef SPECIALIZE
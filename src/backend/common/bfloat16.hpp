@@ -0,0 +1,163 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <backend.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#ifndef __CUDA_ARCH__
+#include <ostream>
+#include <string>
+#endif
+
+namespace common {
+
+/// Returns the bits of the bfloat16 value nearest to \p value. The ties are
+/// rounded to even and the NaNs stay quiet NaNs.
+///
+/// The function has no branches, so the loops converting arrays with it are
+/// vectorized by the compiler.
+__DH__ inline uint16_t float2bfloat16(float value) noexcept {
+#ifdef __CUDA_ARCH__
+    const uint32_t bits = __float_as_uint(value);
+#else
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+#endif
+    const uint32_t rounded = bits + 0x7FFFu + ((bits >> 16) & 1u);
+    const uint32_t nan     = (bits >> 16) | 0x0040u;
+    return static_cast<uint16_t>(
+        (bits & 0x7FFFFFFFu) > 0x7F800000u ? nan : rounded >> 16);
+}
+
+/// Returns the float with the same value as the bfloat16 bits \p value
+__DH__ inline float bfloat162float(uint16_t value) noexcept {
+    const uint32_t bits = static_cast<uint32_t>(value) << 16;
+#ifdef __CUDA_ARCH__
+    return __uint_as_float(bits);
+#else
+    float out;
+    std::memcpy(&out, &bits, sizeof(out));
+    return out;
+#endif
+}
+
+/// A 16-bit brain floating point value. It has the exponent of a float and
+/// the upper 7 bits of its mantissa, so the conversions only move bits and
+/// round. The values are converted to float for the computations.
+class alignas(2) bfloat16 {
+    uint16_t data_ = 0;
+
+   public:
+    bfloat16() = default;
+
+    __DH__ explicit bfloat16(float value) noexcept
+        : data_(float2bfloat16(value)) {}
+
+    template<typename T>
+    __DH__ explicit bfloat16(T value) noexcept
+        : data_(float2bfloat16(static_cast<float>(value))) {}
+
+    /// Returns the value whose binary representation is \p bits
+    __DH__ static bfloat16 fromBits(uint16_t bits) noexcept {
+        bfloat16 out;
+        out.data_ = bits;
+        return out;
+    }
+
+    __DH__ uint16_t bits() const noexcept { return data_; }
+
+    __DH__ explicit operator float() const noexcept {
+        return bfloat162float(data_);
+    }
+
+    template<typename T>
+    __DH__ explicit operator T() const noexcept {
+        return static_cast<T>(bfloat162float(data_));
+    }
+
+    __DH__ bfloat16 operator-() const noexcept {
+        return fromBits(data_ ^ 0x8000u);
+    }
+
+    __DH__ bfloat16 operator+() const noexcept { return *this; }
+};
+
+__DH__ inline bool operator==(bfloat16 lhs, bfloat16 rhs) noexcept {
+    return static_cast<float>(lhs) == static_cast<float>(rhs);
+}
+
+__DH__ inline bool operator!=(bfloat16 lhs, bfloat16 rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+__DH__ inline bool operator<(bfloat16 lhs, bfloat16 rhs) noexcept {
+    return static_cast<float>(lhs) < static_cast<float>(rhs);
+}
+
+__DH__ inline bool operator>(bfloat16 lhs, bfloat16 rhs) noexcept {
+    return rhs < lhs;
+}
+
+__DH__ inline bool isnan(bfloat16 val) noexcept {
+    return (val.bits() & 0x7FFFu) > 0x7F80u;
+}
+
+__DH__ inline bool isinf(bfloat16 val) noexcept {
+    return (val.bits() & 0x7FFFu) == 0x7F80u;
+}
+
+#ifndef __CUDA_ARCH__
+inline std::ostream &operator<<(std::ostream &os, const bfloat16 &val) {
+    return os << static_cast<float>(val);
+}
+
+inline std::string to_string(const bfloat16 &val) {
+    return std::to_string(static_cast<float>(val));
+}
+#endif
+
+}  // namespace common
+
+#if !defined(NVCC) && !defined(__CUDACC_RTC__)
+namespace std {
+/// Numeric limits of the bfloat16 values. They have the range of float and
+/// 8 significant bits.
+template<>
+class numeric_limits<common::bfloat16> : public numeric_limits<float> {
+   public:
+    static constexpr int digits       = 8;
+    static constexpr int digits10     = 2;
+    static constexpr int max_digits10 = 4;
+
+    static common::bfloat16 min() noexcept {
+        return common::bfloat16::fromBits(0x0080);
+    }
+    static common::bfloat16 lowest() noexcept {
+        return common::bfloat16::fromBits(0xFF7F);
+    }
+    static common::bfloat16 max() noexcept {
+        return common::bfloat16::fromBits(0x7F7F);
+    }
+    static common::bfloat16 epsilon() noexcept {
+        return common::bfloat16::fromBits(0x3C00);
+    }
+    static common::bfloat16 infinity() noexcept {
+        return common::bfloat16::fromBits(0x7F80);
+    }
+    static common::bfloat16 quiet_NaN() noexcept {
+        return common::bfloat16::fromBits(0x7FC0);
+    }
+};
+}  // namespace std
+#endif
@@ -17,6 +17,15 @@
 #include <string>
 #include <vector>
 
+/// \brief Returns the name of the file which stores the binary of a module
+///
+/// This function has to be implemented separately in each backend. The name
+/// identifies the device and the version of ArrayFire the binary is for.
+///
+/// \param[in] device is the device index
+/// \param[in] key is hash of code+options+instantiations
+std::string getKernelCacheFilename(const int device, const std::string& key);
+
 namespace common {
 
 /// \brief Backend specific source compilation implementation
@@ -61,6 +70,29 @@ detail::Module loadModuleFromDisk(const int device,
                                   const std::string& moduleKey,
                                   const bool isJIT);
 
+/// \brief Shares the ownership of a module added to the in-memory cache
+///
+/// This function has to be implemented separately in each backend. The
+/// cache drops its reference to \p mod when it evicts the module, and the
+/// kernels taken from the module keep it loaded until they are destroyed
+/// and their launches on \p device are complete.
+///
+/// \param[in] mod is the module which is added to the cache
+/// \param[in] device is the device index
+void shareModule(detail::Module& mod, const int device);
+
+/// \brief Returns the compiler options of a precision mode
+///
+/// This function has to be implemented separately in each backend. The
+/// options are appended to the options of the kernels compiled in \p mode.
+///
+/// \param[in] device is the device index
+/// \param[in] mode is the precision mode
+///
+/// \returns the options, which are empty for the default mode
+std::vector<std::string> getPrecisionOptions(const int device,
+                                             const af_precision_mode mode);
+
 }  // namespace common
 
 #endif
@@ -0,0 +1,59 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// The layout of the vertex buffers of the Forge objects. The vertices are
+// interleaved: the components of a vertex are next to each other. The
+// backends write the components straight from the arrays of the user into
+// the buffers, without joining them into an interleaved array first.
+
+#pragma once
+
+#include <af/defines.h>
+#include <af/dim4.hpp>
+
+namespace common {
+
+/// How a component of the vertices is read from an array. The component of
+/// the vertex i is the element i of an array of \p dims, in column major
+/// order, read with \p strides. The arrays of points, their rows and their
+/// columns are read with their own dims and strides. A stride of 0 repeats
+/// the elements of the array along a dimension.
+struct VertexComponent {
+    af::dim4 dims;
+    af::dim4 strides;
+};
+
+/// Returns the x (\p dim 0) or the y (\p dim 1) coordinates of the
+/// \p vertices of a surface from an array of \p dims and \p strides.
+/// Arrays with a value per vertex are read as they are. Vectors of the
+/// coordinates of the first (x) or of the second (y) dimension of the grid
+/// are repeated along the other dimension.
+inline VertexComponent surfaceComponent(const dim_t vertices,
+                                        const af::dim4 &dims,
+                                        const af::dim4 &strides,
+                                        const int dim) {
+    const dim_t elements = dims.elements();
+    if (elements == vertices) { return {dims, strides}; }
+
+    dim_t stride = 1;
+    for (int i = 0; i < 4; ++i) {
+        if (dims[i] > 1) {
+            stride = strides[i];
+            break;
+        }
+    }
+
+    if (dim == 0) {
+        return {af::dim4(elements, vertices / elements),
+                af::dim4(stride, 0, 0, 0)};
+    }
+    return {af::dim4(vertices / elements, elements), af::dim4(0, stride, 0, 0)};
+}
+
+}  // namespace common
@@ -0,0 +1,88 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Array.hpp>
+#include <backend.hpp>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace common {
+
+/// The largest number of slots of the hash table of reduce_by_key_hash. Keys
+/// with too many distinct values for it are reduced by sorting them.
+constexpr dim_t HASH_REDUCE_MAX_SLOTS = 1 << 12;
+/// The smallest number of slots of the hash table
+constexpr dim_t HASH_REDUCE_MIN_SLOTS = 1 << 6;
+/// The number of slots probed for a key before the table is considered full
+constexpr unsigned HASH_REDUCE_MAX_PROBES = 64;
+
+/// Returns the number of slots of the hash table for \p n keys, a power of two
+/// at least twice as large as \p n up to HASH_REDUCE_MAX_SLOTS
+inline dim_t hashReduceSlots(const dim_t n) {
+    dim_t slots = HASH_REDUCE_MIN_SLOTS;
+    while (slots < 2 * n && slots < HASH_REDUCE_MAX_SLOTS) { slots *= 2; }
+    return slots;
+}
+
+/// The key of the empty slots. The values of this key are reduced in an extra
+/// slot after the others.
+template<typename Tk>
+Tk hashReduceEmptyKey() {
+    return std::numeric_limits<Tk>::max();
+}
+
+/// The hash table of reduce_by_key_hash, copied from the device. It has one
+/// more slot than the table of the other keys, for the empty key.
+template<typename Tk, typename To>
+struct HashReduceTable {
+    std::vector<Tk> keys;
+    std::vector<To> vals;
+    bool full;           ///< A key did not find a slot
+    bool emptyKeyFound;  ///< The empty key is one of the keys
+};
+
+/// Sets \p keys_out and \p vals_out to the keys of the occupied slots of
+/// \p table, sorted like the results of sort_by_key and reduce_by_key, and to
+/// their reduced values. Returns false when the table is full.
+template<typename Tk, typename To>
+bool hashReduceOutputs(detail::Array<Tk> &keys_out, detail::Array<To> &vals_out,
+                       const HashReduceTable<Tk, To> &table) {
+    if (table.full) { return false; }
+
+    const Tk emptyKey = hashReduceEmptyKey<Tk>();
+    const dim_t slots = static_cast<dim_t>(table.keys.size()) - 1;
+
+    std::vector<dim_t> occupied;
+    for (dim_t i = 0; i < slots; ++i) {
+        if (table.keys[i] != emptyKey) { occupied.push_back(i); }
+    }
+    std::sort(occupied.begin(), occupied.end(), [&](dim_t a, dim_t b) {
+        return table.keys[a] < table.keys[b];
+    });
+    if (table.emptyKeyFound) { occupied.push_back(slots); }
+
+    std::vector<Tk> okeys(occupied.size());
+    std::vector<To> ovals(occupied.size());
+    for (size_t i = 0; i < occupied.size(); ++i) {
+        okeys[i] = occupied[i] == slots ? emptyKey : table.keys[occupied[i]];
+        ovals[i] = table.vals[occupied[i]];
+    }
+
+    const af::dim4 odims(static_cast<dim_t>(occupied.size()));
+    keys_out = detail::createHostDataArray<Tk>(odims, okeys.data());
+    vals_out = detail::createHostDataArray<To>(odims, ovals.data());
+    return true;
+}
+
+}  // namespace common
@@ -20,3 +20,20 @@ typedef enum {
     AF_BATCH_SAME,             /* signal and filter have same batch size */
     AF_BATCH_DIFF,             /* signal and filter have different batch size */
 } AF_BATCH_KIND;
+
+/// The distributions sampled with the parameters of each element by
+/// af_random_exponential and the related functions
+typedef enum {
+    AF_RANDOM_EXPONENTIAL,      /* rate */
+    AF_RANDOM_GAMMA,            /* shape and scale */
+    AF_RANDOM_POISSON,          /* mean */
+    AF_RANDOM_TRUNCATED_NORMAL, /* lower and upper bounds */
+} AF_RANDOM_DIST;
+
+/// The passes of the convolution of the neural network functions computed by
+/// the conv2Implicit kernels
+typedef enum {
+    AF_CONV2_FORWARD,         /* output from the signal and the filter */
+    AF_CONV2_DATA_GRADIENT,   /* signal gradient from the output gradient */
+    AF_CONV2_FILTER_GRADIENT, /* filter gradient from the output gradient */
+} AF_CONV2_PASS;
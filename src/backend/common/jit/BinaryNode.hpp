@@ -8,15 +8,48 @@
  ********************************************************/
 
 #include <common/jit/NaryNode.hpp>
+#include <optypes.hpp>
 
 #include <cmath>
 
 namespace common {
+
+/// Returns true if the operation \p op with the result type \p type gives
+/// the same result when its operands are swapped. The minimum and the
+/// maximum are not commutative, because they return the second operand if
+/// the first one is NaN, and the complex product may be contracted into
+/// different fused multiply-adds.
+inline bool isCommutative(const int op, const af::dtype type) {
+    switch (op) {
+        case af_mul_t: return type != c32 && type != c64;
+        case af_add_t:
+        case af_and_t:
+        case af_or_t:
+        case af_eq_t:
+        case af_neq_t:
+        case af_bitor_t:
+        case af_bitand_t:
+        case af_bitxor_t: return true;
+        default: return false;
+    }
+}
+
 class BinaryNode : public NaryNode {
+    /// Orders the operands of commutative operations by their structural
+    /// hash, so expressions which only differ in the order of the operands
+    /// generate the same kernel
+    static std::array<Node_ptr, Node::kMaxChildren> operands(
+        const af::dtype type, const int op, Node_ptr lhs, Node_ptr rhs) {
+        if (isCommutative(op, type) && rhs->getHash() < lhs->getHash()) {
+            std::swap(lhs, rhs);
+        }
+        return {{lhs, rhs}};
+    }
+
    public:
     BinaryNode(const af::dtype type, const char *op_str, common::Node_ptr lhs,
                common::Node_ptr rhs, int op)
-        : NaryNode(type, op_str, 2, {{lhs, rhs}}, op,
+        : NaryNode(type, op_str, 2, operands(type, op, lhs, rhs), op,
                    std::max(lhs->getHeight(), rhs->getHeight()) + 1) {}
 };
 }  // namespace common
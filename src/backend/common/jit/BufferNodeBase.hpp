@@ -12,6 +12,7 @@
 #include <common/jit/Node.hpp>
 #include <jit/kernel_generators.hpp>
 
+#include <cstring>
 #include <iomanip>
 #include <mutex>
 #include <sstream>
@@ -30,10 +31,17 @@ class BufferNodeBase : public common::Node {
    public:
     BufferNodeBase(af::dtype type) : Node(type, 0, {}) {
         // This class is not movable because of std::once_flag
+        updateHash('B');
     }
 
     bool isBuffer() const final { return true; }
 
+    /// Returns the memory read by the node
+    const DataType &getData() const { return m_data; }
+
+    /// Returns the dimensions, strides and offset used to read the memory
+    const ParamType &getParam() const { return m_param; }
+
     void setData(ParamType param, DataType data, const unsigned bytes,
                  bool is_linear) {
         std::call_once(m_set_data_flag,
@@ -92,6 +100,14 @@ class BufferNodeBase : public common::Node {
     }
 
     size_t getBytes() const final { return m_bytes; }
+
+    /// Buffers are equal if they read the same memory in the same way
+    bool isEqual(const Node &other) const final {
+        const auto &node = static_cast<const BufferNodeBase &>(other);
+        return m_data == node.m_data && m_bytes == node.m_bytes &&
+               m_linear_buffer == node.m_linear_buffer &&
+               std::memcmp(&m_param, &node.m_param, sizeof(ParamType)) == 0;
+    }
 };
 
 }  // namespace common
@@ -0,0 +1,122 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <jit/BufferNode.hpp>
+#include <jit/kernel_generators.hpp>
+
+#include <backend.hpp>
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace common {
+
+/// Reads a buffer at the indices computed by its child along one dimension.
+///
+/// The child is evaluated in the same kernel as the node, so lookups are
+/// fused into the expressions which use them instead of being gathered into
+/// an intermediate buffer. The child has to be shaped along the gathered
+/// dimension so it is broadcast along the other dimensions.
+template<typename BufferNode>
+class GatherNodeBase : public Node {
+   private:
+    std::shared_ptr<BufferNode> m_buffer_node;
+    int m_dim;
+
+   public:
+    GatherNodeBase(const af::dtype type,
+                   std::shared_ptr<BufferNode> buffer_node, Node_ptr indices,
+                   const int dim)
+        : Node(type, indices->getHeight() + 1, {{indices}})
+        , m_buffer_node(buffer_node)
+        , m_dim(dim) {
+        static_assert(std::is_nothrow_move_assignable<GatherNodeBase>::value,
+                      "GatherNode is not move assignable");
+        static_assert(
+            std::is_nothrow_move_constructible<GatherNodeBase>::value,
+            "GatherNode is not move constructible");
+        updateHash('G');
+        updateHash(m_dim);
+    }
+
+    /// Default copy constructor
+    GatherNodeBase(const GatherNodeBase &other) = default;
+
+    /// Default move constructor
+    GatherNodeBase(GatherNodeBase &&other) = default;
+
+    /// Default move/copy assignment operator(Rule of 4)
+    GatherNodeBase &operator=(GatherNodeBase node) noexcept {
+        swap(node);
+        return *this;
+    }
+
+    // Swap specilization
+    void swap(GatherNodeBase &other) noexcept {
+        using std::swap;
+        Node::swap(other);
+        swap(m_buffer_node, other.m_buffer_node);
+        swap(m_dim, other.m_dim);
+    }
+
+    bool isLinear(dim_t dims[4]) const final {
+        UNUSED(dims);
+        return false;
+    }
+
+    void genKerName(std::string &kerString,
+                    const common::Node_ids &ids) const final {
+        kerString += '_';
+        kerString += getNameStr();
+        kerString += ',';
+        kerString += std::to_string(m_dim);
+        kerString += ',';
+        kerString += std::to_string(ids.child_ids[0]);
+        kerString += ',';
+        kerString += std::to_string(ids.id);
+    }
+
+    void genParams(std::stringstream &kerStream, int id,
+                   bool is_linear) const final {
+        m_buffer_node->genParams(kerStream, id, is_linear);
+    }
+
+    int setArgs(int start_id, bool is_linear,
+                std::function<void(int id, const void *ptr, size_t arg_size)>
+                    setArg) const {
+        return m_buffer_node->setArgs(start_id, is_linear, setArg);
+    }
+
+    void genFuncs(std::stringstream &kerStream,
+                  const common::Node_ids &ids) const final {
+        // The offset depends on the value of the child, so it is computed
+        // here instead of in genOffsets
+        detail::generateGatherNodeRead(kerStream, ids.id, ids.child_ids[0],
+                                       m_dim, getTypeStr());
+    }
+
+    void getInfo(unsigned &len, unsigned &buf_count,
+                 unsigned &bytes) const final {
+        m_buffer_node->getInfo(len, buf_count, bytes);
+    }
+
+    std::string getNameStr() const final {
+        return std::string("Ga") + getShortName(m_type);
+    }
+
+    bool isEqual(const Node &other) const final {
+        const auto &node = static_cast<const GatherNodeBase &>(other);
+        return m_dim == node.m_dim &&
+               m_buffer_node->isEqual(*node.m_buffer_node);
+    }
+};
+}  // namespace common
@@ -0,0 +1,221 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/jit/Node.hpp>
+#include <af/dim4.hpp>
+#include <af/traits.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+namespace common {
+
+/// The values generated by an index node
+enum class IndexKind : char {
+    Range,     ///< The index of the element along one dimension
+    Iota,      ///< The linear index of the element in a tiled period
+    Identity,  ///< One on the diagonal of the first two dimensions
+};
+
+/// Describes the values of an array which only depend on the indices of its
+/// elements. The description is shared by the nodes of all the backends,
+/// which generate the values in the JIT kernels instead of writing them to a
+/// buffer.
+struct IndexParams {
+    IndexKind kind;
+    /// The dimension of the sequence of a range
+    int dim;
+    /// The dimensions of the array
+    dim_t dims[4];
+    /// The dimensions of the period of an iota
+    dim_t period[4];
+
+    IndexParams(const IndexKind kind_, const af::dim4 &dims_,
+                const int dim_ = 0, const af::dim4 &period_ = af::dim4(1))
+        : kind(kind_)
+        , dim(dim_)
+        , dims{dims_[0], dims_[1], dims_[2], dims_[3]}
+        , period{period_[0], period_[1], period_[2], period_[3]} {}
+
+    /// Returns the value of the element at (\p x, \p y, \p z, \p w)
+    dim_t value(const dim_t x, const dim_t y, const dim_t z,
+                const dim_t w) const {
+        switch (kind) {
+            case IndexKind::Range: {
+                const dim_t id[4] = {x, y, z, w};
+                return id[dim];
+            }
+            case IndexKind::Iota:
+                return (x % period[0]) +
+                       period[0] *
+                           ((y % period[1]) +
+                            period[1] * ((z % period[2]) +
+                                         period[2] * (w % period[3])));
+            case IndexKind::Identity: return x == y;
+        }
+        return 0;
+    }
+
+    /// Returns the value of the element at the linear index \p idx
+    dim_t value(dim_t idx) const {
+        const dim_t x = idx % dims[0];
+        idx /= dims[0];
+        const dim_t y = idx % dims[1];
+        idx /= dims[1];
+        const dim_t z = idx % dims[2];
+        return value(x, y, z, idx / dims[2]);
+    }
+
+    /// Generates the declarations of the coordinates gx, gy, gz and gw of the
+    /// element of the node \p id. The linear kernels compute them from the
+    /// linear index idx and the dimensions gdims<id>_<i> of the node, so they
+    /// do not depend on the output of the kernel.
+    void genCoords(std::stringstream &kerStream, const int id,
+                   const bool is_linear) const {
+        const std::string n = std::to_string(id);
+        if (!is_linear) {
+            kerStream << "dim_t gx" << n << " = id0, gy" << n << " = id1, gz"
+                      << n << " = id2, gw" << n << " = id3;\n";
+            return;
+        }
+        kerStream << "dim_t gw" << n << " = idx;\n"
+                  << "dim_t gx" << n << " = gw" << n << " % gdims" << n
+                  << "_0;\n"
+                  << "gw" << n << " /= gdims" << n << "_0;\n"
+                  << "dim_t gy" << n << " = gw" << n << " % gdims" << n
+                  << "_1;\n"
+                  << "gw" << n << " /= gdims" << n << "_1;\n"
+                  << "dim_t gz" << n << " = gw" << n << " % gdims" << n
+                  << "_2;\n"
+                  << "gw" << n << " /= gdims" << n << "_2;\n";
+    }
+
+    /// Returns the expression of the value of the node \p id, in the
+    /// coordinates declared by genCoords
+    std::string genValue(const int id) const {
+        const std::string n  = std::to_string(id);
+        const char *coord[4] = {"gx", "gy", "gz", "gw"};
+        switch (kind) {
+            case IndexKind::Range: return coord[dim] + n;
+            case IndexKind::Iota: {
+                std::string expr = "(gw" + n + " % gper" + n + "_3)";
+                for (int i = 2; i >= 0; i--) {
+                    const std::string p = "gper" + n + "_" + std::to_string(i);
+                    expr = "(" + std::string(coord[i]) + n + " % " + p +
+                           " + " + p + " * " + expr + ")";
+                }
+                return expr;
+            }
+            case IndexKind::Identity: return "(gx" + n + " == gy" + n + ")";
+        }
+        return "0";
+    }
+
+    /// Returns the name of the node, which distinguishes the generated code
+    std::string getNameStr() const {
+        switch (kind) {
+            case IndexKind::Range: return "Rg" + std::to_string(dim);
+            case IndexKind::Iota: return "Io";
+            case IndexKind::Identity: return "Id";
+        }
+        return "";
+    }
+
+    bool operator==(const IndexParams &other) const {
+        return kind == other.kind && dim == other.dim &&
+               std::equal(dims, dims + 4, other.dims) &&
+               std::equal(period, period + 4, other.period);
+    }
+};
+
+/// Generates the values of a range, an iota or an identity array in the JIT
+/// kernel. The expressions which use the array are fused with its generation
+/// instead of reading a buffer of the values, so the array is never
+/// allocated unless it is evaluated on its own.
+///
+/// The dimensions of the array and of the period are the kernel arguments,
+/// so arrays of the same kind with different sizes share the kernel.
+template<typename T>
+class IndexNode : public Node {
+   private:
+    IndexParams m_params;
+
+   public:
+    IndexNode(const IndexParams &params)
+        : Node(static_cast<af::dtype>(af::dtype_traits<T>::af_type), 0, {})
+        , m_params(params) {
+        updateHash('I');
+        updateHash(m_params.kind);
+        updateHash(m_params.dim);
+    }
+
+    void genKerName(std::string &kerString,
+                    const common::Node_ids &ids) const final {
+        kerString += '_';
+        kerString += getNameStr();
+        kerString += ',';
+        kerString += std::to_string(ids.id);
+    }
+
+    void genParams(std::stringstream &kerStream, int id,
+                   bool is_linear) const final {
+        UNUSED(is_linear);
+        for (int i = 0; i < 4; i++) {
+            kerStream << "dim_t gdims" << id << "_" << i << ", ";
+        }
+        for (int i = 0; i < 4; i++) {
+            kerStream << "dim_t gper" << id << "_" << i << ", ";
+        }
+        kerStream << "\n";
+    }
+
+    int setArgs(int start_id, bool is_linear,
+                std::function<void(int id, const void *ptr, size_t arg_size)>
+                    setArg) const final {
+        UNUSED(is_linear);
+        for (int i = 0; i < 4; i++) {
+            setArg(start_id + i, static_cast<const void *>(&m_params.dims[i]),
+                   sizeof(dim_t));
+            setArg(start_id + 4 + i,
+                   static_cast<const void *>(&m_params.period[i]),
+                   sizeof(dim_t));
+        }
+        return start_id + 8;
+    }
+
+    void genOffsets(std::stringstream &kerStream, int id,
+                    bool is_linear) const final {
+        m_params.genCoords(kerStream, id, is_linear);
+    }
+
+    void genFuncs(std::stringstream &kerStream,
+                  const common::Node_ids &ids) const final {
+        // Half values are converted from float, which all the backends
+        // support
+        const bool isHalf = m_type == f16;
+        kerStream << getTypeStr() << " val" << ids.id << " = ("
+                  << getTypeStr() << ")(" << (isHalf ? "(float)" : "")
+                  << m_params.genValue(ids.id) << ");\n";
+    }
+
+    std::string getNameStr() const final {
+        return m_params.getNameStr() + getShortName(m_type);
+    }
+
+    size_t getParamBytes() const final { return 8 * sizeof(dim_t); }
+
+    bool isEqual(const Node &other) const final {
+        return m_params == static_cast<const IndexNode &>(other).m_params;
+    }
+};
+
+}  // namespace common
@@ -0,0 +1,117 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/defines.hpp>
+#include <common/err_common.hpp>
+#include <common/jit/JitHeuristics.hpp>
+#include <common/jit/NodeIterator.hpp>
+
+#include <atomic>
+
+namespace common {
+
+namespace {
+struct JitHeuristic {
+    af_jit_heuristic_fn fn;
+    void *user_data;
+};
+
+mutex_t &getHeuristicMutex() {
+    static mutex_t mutex;
+    return mutex;
+}
+
+JitHeuristic &getHeuristic() {
+    static JitHeuristic heuristic{nullptr, nullptr};
+    return heuristic;
+}
+
+/// Checked before the mutex is locked so the default heuristics are not
+/// slowed down
+std::atomic<bool> &heuristicIsSet() {
+    static std::atomic<bool> is_set(false);
+    return is_set;
+}
+
+unsigned typeBytes(af::dtype type) {
+    switch (type) {
+        case c64: return 16;
+        case f64:
+        case c32:
+        case s64:
+        case u64: return 8;
+        case f32:
+        case s32:
+        case u32: return 4;
+        case f16:
+        case bf16:
+        case s16:
+        case u16: return 2;
+        case b8:
+        case u8: return 1;
+    }
+    return 4;
+}
+}  // namespace
+
+af_jit_tree_info getJitTreeInfo(Node *root, size_t buffer_param_bytes) {
+    af_jit_tree_info info{};
+    info.height = root->getHeight();
+
+    NodeIterator<> end_node;
+    for (NodeIterator<> it(root); it != end_node; ++it) {
+        info.num_nodes++;
+        if (it->isBuffer()) {
+            info.num_buffers++;
+            info.buffer_bytes += it->getBytes();
+            info.param_bytes += buffer_param_bytes;
+        } else {
+            info.param_bytes += it->getParamBytes();
+        }
+        // Every node holds its value in registers until the kernel writes
+        // the outputs
+        info.num_registers += (typeBytes(it->getType()) + 3) / 4;
+    }
+    return info;
+}
+
+void setJitHeuristic(af_jit_heuristic_fn fn, void *user_data) {
+    lock_guard_t lock(getHeuristicMutex());
+    getHeuristic() = JitHeuristic{fn, user_data};
+    heuristicIsSet() = fn != nullptr;
+}
+
+bool hasJitHeuristic() { return heuristicIsSet(); }
+
+kJITHeuristics callJitHeuristic(const af_jit_tree_info &info) {
+    if (info.max_param_bytes > 0 && info.param_bytes >= info.max_param_bytes) {
+        return kJITHeuristics::KernelParameterSize;
+    }
+
+    JitHeuristic heuristic;
+    {
+        lock_guard_t lock(getHeuristicMutex());
+        heuristic = getHeuristic();
+    }
+    if (!heuristic.fn) { return kJITHeuristics::Pass; }
+
+    af_jit_decision decision = AF_JIT_PASS;
+    if (heuristic.fn(&decision, &info, heuristic.user_data) != AF_SUCCESS) {
+        AF_ERROR("The JIT heuristic failed", AF_ERR_RUNTIME);
+    }
+
+    switch (decision) {
+        case AF_JIT_PASS: return kJITHeuristics::Pass;
+        case AF_JIT_EVAL_TALLEST: return kJITHeuristics::TreeHeight;
+        case AF_JIT_EVAL_CHILDREN: return kJITHeuristics::MemoryPressure;
+    }
+    AF_ERROR("Invalid decision returned by the JIT heuristic", AF_ERR_ARG);
+}
+
+}  // namespace common
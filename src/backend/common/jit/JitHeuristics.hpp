@@ -0,0 +1,41 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <common/jit/Node.hpp>
+#include <af/device.h>
+
+#include <cstddef>
+
+namespace common {
+
+/// Visits the nodes of a tree and estimates the cost of its kernel.
+///
+/// The height, the memory pressure and the limits are not set. They depend
+/// on the backend.
+///
+/// \param[in] root               The root of the tree
+/// \param[in] buffer_param_bytes The size of the kernel parameters of a
+///                               buffer
+af_jit_tree_info getJitTreeInfo(Node *root, size_t buffer_param_bytes);
+
+/// Sets the user defined heuristic. A null \p fn restores the default
+/// heuristics of the backend.
+void setJitHeuristic(af_jit_heuristic_fn fn, void *user_data);
+
+/// Returns true if a user defined heuristic is set
+bool hasJitHeuristic();
+
+/// Calls the user defined heuristic with \p info.
+///
+/// Trees with parameters larger than the limit of the device are always
+/// evaluated.
+kJITHeuristics callJitHeuristic(const af_jit_tree_info &info);
+
+}  // namespace common
@@ -0,0 +1,141 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/jit/JitStats.hpp>
+
+#include <device_manager.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+using std::atomic;
+using std::memory_order_relaxed;
+
+namespace common {
+
+namespace {
+
+#if defined(AF_CPU)
+constexpr int maxStatsDevices = detail::DeviceManager::NUM_DEVICES;
+#else
+constexpr int maxStatsDevices = detail::DeviceManager::MAX_DEVICES;
+#endif
+
+constexpr int histogramBuckets =
+    sizeof(af_jit_stats::node_histogram) / sizeof(size_t);
+
+struct JitCounters {
+    atomic<size_t> evals[4];
+    atomic<size_t> cache_hits;
+    atomic<size_t> cache_misses;
+    atomic<size_t> num_compiles;
+    atomic<uint64_t> compile_nanoseconds;
+    atomic<size_t> node_histogram[histogramBuckets];
+    atomic<size_t> num_modules;
+    atomic<size_t> module_bytes;
+    atomic<size_t> num_evictions;
+};
+
+JitCounters &getCounters(int device) {
+    // Static storage is zero initialized, which clears the counters
+    static JitCounters counters[maxStatsDevices];
+    return counters[device];
+}
+
+kJITHeuristics &evalReason() {
+    thread_local kJITHeuristics reason = kJITHeuristics::Pass;
+    return reason;
+}
+
+int histogramBucket(size_t num_nodes) {
+    int bucket = 0;
+    while (num_nodes > 1 && bucket < histogramBuckets - 1) {
+        num_nodes >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+}  // namespace
+
+JitEvalScope::JitEvalScope(kJITHeuristics reason) : m_previous(evalReason()) {
+    evalReason() = reason;
+}
+
+JitEvalScope::~JitEvalScope() { evalReason() = m_previous; }
+
+void recordJitEval(int device) {
+    const auto reason = static_cast<int>(evalReason());
+    getCounters(device).evals[reason].fetch_add(1, memory_order_relaxed);
+}
+
+void recordJitFusion(int device, size_t num_nodes) {
+    getCounters(device)
+        .node_histogram[histogramBucket(num_nodes)]
+        .fetch_add(1, memory_order_relaxed);
+}
+
+void recordKernelCacheLookup(int device, bool hit) {
+    JitCounters &counters = getCounters(device);
+    auto &counter         = hit ? counters.cache_hits : counters.cache_misses;
+    counter.fetch_add(1, memory_order_relaxed);
+}
+
+void recordKernelCompile(int device, double seconds) {
+    JitCounters &counters = getCounters(device);
+    counters.num_compiles.fetch_add(1, memory_order_relaxed);
+    counters.compile_nanoseconds.fetch_add(static_cast<uint64_t>(seconds * 1e9),
+                                           memory_order_relaxed);
+}
+
+void recordModuleCache(int device, size_t num_modules, size_t bytes) {
+    JitCounters &counters = getCounters(device);
+    counters.num_modules.store(num_modules, memory_order_relaxed);
+    counters.module_bytes.store(bytes, memory_order_relaxed);
+}
+
+void recordModuleEviction(int device) {
+    getCounters(device).num_evictions.fetch_add(1, memory_order_relaxed);
+}
+
+void getJitStats(af_jit_stats *stats, int device) {
+    JitCounters &counters = getCounters(device);
+    auto evals            = [&](kJITHeuristics reason) {
+        return counters.evals[static_cast<int>(reason)].load();
+    };
+    stats->evals_explicit        = evals(kJITHeuristics::Pass);
+    stats->evals_tree_height     = evals(kJITHeuristics::TreeHeight);
+    stats->evals_param_size      = evals(kJITHeuristics::KernelParameterSize);
+    stats->evals_memory_pressure = evals(kJITHeuristics::MemoryPressure);
+    stats->num_evals = stats->evals_explicit + stats->evals_tree_height +
+                       stats->evals_param_size + stats->evals_memory_pressure;
+    stats->cache_hits      = counters.cache_hits.load();
+    stats->cache_misses    = counters.cache_misses.load();
+    stats->num_compiles    = counters.num_compiles.load();
+    stats->compile_seconds = counters.compile_nanoseconds.load() * 1e-9;
+    for (int i = 0; i < histogramBuckets; ++i) {
+        stats->node_histogram[i] = counters.node_histogram[i].load();
+    }
+    stats->num_modules   = counters.num_modules.load();
+    stats->module_bytes  = counters.module_bytes.load();
+    stats->num_evictions = counters.num_evictions.load();
+}
+
+void resetJitStats(int device) {
+    JitCounters &counters = getCounters(device);
+    for (auto &count : counters.evals) { count = 0; }
+    counters.cache_hits          = 0;
+    counters.cache_misses        = 0;
+    counters.num_compiles        = 0;
+    counters.compile_nanoseconds = 0;
+    for (auto &count : counters.node_histogram) { count = 0; }
+    counters.num_evictions = 0;
+}
+
+}  // namespace common
@@ -0,0 +1,61 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+/// Counters which describe how the JIT trees of a device are evaluated. They
+/// are read with af_get_jit_stats.
+#pragma once
+
+#include <common/jit/Node.hpp>
+#include <af/device.h>
+
+#include <cstddef>
+
+namespace common {
+
+/// Attributes the evaluations of the calling thread to a heuristic until the
+/// object is destroyed. The evaluations outside of a scope are explicit.
+class JitEvalScope {
+    kJITHeuristics m_previous;
+
+   public:
+    explicit JitEvalScope(kJITHeuristics reason);
+    ~JitEvalScope();
+
+    JitEvalScope(const JitEvalScope &)            = delete;
+    JitEvalScope &operator=(const JitEvalScope &) = delete;
+};
+
+/// Counts an evaluation of a JIT tree on \p device, attributed to the
+/// reason set by the innermost JitEvalScope of the calling thread
+void recordJitEval(int device);
+
+/// Adds a kernel which fuses \p num_nodes nodes to the histogram of
+/// \p device
+void recordJitFusion(int device, size_t num_nodes);
+
+/// Counts a lookup of a kernel module in the in-memory cache of \p device
+void recordKernelCacheLookup(int device, bool hit);
+
+/// Counts the compilation of a kernel module which took \p seconds
+void recordKernelCompile(int device, double seconds);
+
+/// Records the number of modules in the in-memory cache of \p device and
+/// the size of their binaries
+void recordModuleCache(int device, size_t num_modules, size_t bytes);
+
+/// Counts a module unloaded from the in-memory cache of \p device
+void recordModuleEviction(int device);
+
+/// Reads the counters of \p device
+void getJitStats(af_jit_stats *stats, int device);
+
+/// Clears the counters of \p device. The size of the module cache is kept.
+void resetJitStats(int device);
+
+}  // namespace common
@@ -12,9 +12,11 @@
 #include <Array.hpp>
 #include <backend.hpp>
 #include <common/defines.hpp>
+#include <common/jit/JitStats.hpp>
 #include <common/jit/Node.hpp>
 
 #include <array>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 #include <string>
@@ -44,6 +46,8 @@ class NaryNode : public Node {
                       "NaryNode is not move assignable");
         static_assert(std::is_nothrow_move_constructible<NaryNode>::value,
                       "NaryNode is not move constructible");
+        updateHash('N');
+        updateHash(m_op);
     }
 
     NaryNode(NaryNode &&other) noexcept = default;
@@ -87,6 +91,12 @@ class NaryNode : public Node {
         }
         kerStream << ");\n";
     }
+
+    bool isEqual(const Node &other) const final {
+        const auto &node = static_cast<const NaryNode &>(other);
+        return m_op == node.m_op && m_num_children == node.m_num_children &&
+               std::strcmp(m_op_str, node.m_op_str) == 0;
+    }
 };
 
 template<typename Ti, int N, typename FUNC>
@@ -98,8 +108,10 @@ common::Node_ptr createNaryNode(
 
     common::Node_ptr ptr = createNode(childNodes);
 
-    switch (static_cast<kJITHeuristics>(
-        detail::passesJitHeuristics<Ti>(ptr.get()))) {
+    const kJITHeuristics reason = detail::passesJitHeuristics<Ti>(ptr.get());
+    // The evaluations of the children are counted by the reason
+    JitEvalScope scope(reason);
+    switch (reason) {
         case kJITHeuristics::Pass: {
             return ptr;
         }
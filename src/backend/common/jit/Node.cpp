@@ -7,54 +7,147 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <common/PrecisionMode.hpp>
 #include <common/defines.hpp>
 #include <common/jit/Node.hpp>
+#include <common/jit/NodeIterator.hpp>
 #include <common/util.hpp>
 
+#include <algorithm>
 #include <sstream>
 #include <string>
+#include <typeinfo>
+#include <unordered_map>
 #include <vector>
 
 using std::vector;
 
 namespace common {
 
+namespace {
+/// Returns the id of the node in \p full_nodes which computes the same
+/// values as \p node or -1 if there is no such node. Only the nodes with the
+/// same hash in \p hash_map are compared.
+int findEqualNode(const Node &node, const Node_ids &ids,
+                  const vector<Node *> &full_nodes,
+                  const vector<Node_ids> &full_ids,
+                  const Node_hash_map_t &hash_map) {
+    auto range = hash_map.equal_range(node.getHash());
+    for (auto it = range.first; it != range.second; ++it) {
+        const int i       = it->second;
+        const Node &other = *full_nodes[i];
+        if (other.getType() == node.getType() &&
+            full_ids[i].child_ids == ids.child_ids &&
+            typeid(other) == typeid(node) && node.isEqual(other)) {
+            return i;
+        }
+    }
+    return -1;
+}
+}  // namespace
+
 int Node::getNodesMap(Node_map_t &node_map, vector<Node *> &full_nodes,
-                      vector<Node_ids> &full_ids) {
+                      vector<Node_ids> &full_ids, Node_hash_map_t &hash_map) {
     auto iter = node_map.find(this);
     if (iter == node_map.end()) {
         Node_ids ids{};
 
         for (int i = 0; i < kMaxChildren && m_children[i] != nullptr; i++) {
-            ids.child_ids[i] =
-                m_children[i]->getNodesMap(node_map, full_nodes, full_ids);
+            ids.child_ids[i] = m_children[i]->getNodesMap(node_map, full_nodes,
+                                                          full_ids, hash_map);
+        }
+
+        // The children were mapped first so equal subtrees have equal child
+        // ids by the time their roots are compared
+        ids.id = findEqualNode(*this, ids, full_nodes, full_ids, hash_map);
+        if (ids.id < 0) {
+            ids.id = static_cast<int>(full_nodes.size());
+            full_nodes.push_back(this);
+            full_ids.push_back(ids);
+            hash_map.emplace(getHash(), ids.id);
         }
-        ids.id         = node_map.size();
         node_map[this] = ids.id;
-        full_nodes.push_back(this);
-        full_ids.push_back(ids);
         return ids.id;
     }
     return iter->second;
 }
 
+void Node::relinkChildren(const Node_ids &ids, const vector<Node_ptr> &nodes) {
+    for (int i = 0; i < kMaxChildren && m_children[i] != nullptr; i++) {
+        replaceChild(i, nodes[ids.child_ids[i]]);
+    }
+}
+
+bool Node::hasExclusiveChildren() const {
+    // The number of references to each node from the parents in the tree
+    std::unordered_map<const Node *, long> refs;
+    vector<const Node *> nodes{this};
+    for (size_t n = 0; n < nodes.size(); n++) {
+        const Node *node = nodes[n];
+        for (int i = 0; i < kMaxChildren && node->m_children[i] != nullptr;
+             i++) {
+            const Node *child = node->m_children[i].get();
+            if (refs[child]++ == 0) { nodes.push_back(child); }
+        }
+    }
+
+    for (size_t n = 0; n < nodes.size(); n++) {
+        const Node *node = nodes[n];
+        for (int i = 0; i < kMaxChildren && node->m_children[i] != nullptr;
+             i++) {
+            const Node_ptr &child = node->m_children[i];
+            if (child.use_count() != refs[child.get()]) { return false; }
+        }
+    }
+    return true;
+}
+
 std::string getFuncName(const vector<Node *> &output_nodes,
-                        const vector<Node *> &full_nodes,
                         const vector<Node_ids> &full_ids, bool is_linear) {
-    std::string funcName;
-    funcName.reserve(512);
-    funcName = (is_linear ? 'L' : 'G');
+    std::size_t hash = deterministicHash(&is_linear, sizeof(is_linear));
+    // The kernels of each precision mode are compiled with different options
+    const af_precision_mode mode = getPrecisionMode();
+    if (mode != AF_PRECISION_DEFAULT) {
+        hash = deterministicHash(&mode, sizeof(mode), hash);
+    }
+    for (const auto &node : output_nodes) {
+        const std::size_t node_hash = node->getHash();
+        hash = deterministicHash(&node_hash, sizeof(node_hash), hash);
+    }
+    hash = deterministicHash(full_ids.data(),
+                             full_ids.size() * sizeof(Node_ids), hash);
+
+    return "KER" + std::to_string(hash);
+}
+
+std::string getTreeString(const vector<Node *> &output_nodes,
+                          const vector<Node *> &full_nodes,
+                          const vector<Node_ids> &full_ids, bool is_linear) {
+    std::string treeString;
+    treeString.reserve(512);
+    treeString = (is_linear ? 'L' : 'G');
 
     for (const auto &node : output_nodes) {
-        funcName += '_';
-        funcName += node->getNameStr();
+        treeString += '_';
+        treeString += node->getNameStr();
     }
 
     for (int i = 0; i < static_cast<int>(full_nodes.size()); i++) {
-        full_nodes[i]->genKerName(funcName, full_ids[i]);
+        full_nodes[i]->genKerName(treeString, full_ids[i]);
     }
 
-    return "KER" + std::to_string(deterministicHash(funcName));
+    return treeString;
+}
+
+vector<int> getTreeIds(Node *root, const Node_map_t &node_map) {
+    vector<int> ids;
+    for (NodeIterator<> it(root), end; it != end; ++it) {
+        ids.push_back(node_map.at(&*it));
+    }
+    // Equal nodes share an id
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
 }
 
 }  // namespace common
@@ -9,7 +9,9 @@
 
 #pragma once
 #include <backend.hpp>
+#include <common/PoolAllocator.hpp>
 #include <common/defines.hpp>
+#include <common/util.hpp>
 #include <optypes.hpp>
 #include <platform.hpp>
 #include <types.hpp>
@@ -38,6 +40,9 @@ using Node_ptr      = std::shared_ptr<Node>;
 using Node_map_t    = std::unordered_map<Node *, int>;
 using Node_map_iter = Node_map_t::iterator;
 
+/// The ids of the nodes added by getNodesMap indexed by their hashes
+using Node_hash_map_t = std::unordered_multimap<std::size_t, int>;
+
 static const char *getFullName(af::dtype type) {
     switch (type) {
         case f32: return detail::getFullName<float>();
@@ -53,6 +58,7 @@ static const char *getFullName(af::dtype type) {
         case b8: return detail::getFullName<char>();
         case u8: return detail::getFullName<unsigned char>();
         case f16: return "half";
+        case bf16: return detail::getFullName<common::bfloat16>();
     }
     return "";
 }
@@ -72,6 +78,7 @@ static const char *getShortName(af::dtype type) {
         case b8: return detail::shortname<char>();
         case u8: return detail::shortname<unsigned char>();
         case f16: return "h";
+        case bf16: return detail::shortname<common::bfloat16>();
     }
     return "";
 }
@@ -80,10 +87,16 @@ class Node {
    public:
     static const int kMaxChildren = 3;
 
+    // Nodes are created and destroyed for every operation, so they are
+    // allocated from the block cache of the thread. Shared nodes are created
+    // with makePooled, which also allocates the control block there.
+    AF_POOL_ALLOCATED
+
    protected:
     std::array<Node_ptr, kMaxChildren> m_children;
     af::dtype m_type;
     int m_height;
+    std::size_t m_hash = 0;
 
     template<typename T>
     friend class NodeIterator;
@@ -95,6 +108,14 @@ class Node {
         }
         swap(m_type, other.m_type);
         swap(m_height, other.m_height);
+        swap(m_hash, other.m_hash);
+    }
+
+    /// Adds \p val to the structural hash of the node. Derived nodes add the
+    /// values which change the code generated for the node.
+    template<typename T>
+    void updateHash(const T &val) {
+        m_hash = deterministicHash(&val, sizeof(T), m_hash);
     }
 
    public:
@@ -104,6 +125,10 @@ class Node {
         : m_children(children), m_type(type), m_height(height) {
         static_assert(std::is_nothrow_move_assignable<Node>::value,
                       "Node is not move assignable");
+        updateHash(m_type);
+        for (int i = 0; i < kMaxChildren && m_children[i] != nullptr; i++) {
+            updateHash(m_children[i]->m_hash);
+        }
     }
 
     /// Default move constructor operator
@@ -118,10 +143,60 @@ class Node {
     /// Default move assignment operator
     Node &operator=(Node &&node) noexcept = default;
 
+    /// Assigns an id to this node and to all the nodes below it.
+    ///
+    /// The nodes are added to \p full_nodes in the order they need to be
+    /// evaluated. A node which is structurally equal to a node which was
+    /// already added is not added again. It gets the id of the equal node
+    /// instead, so common subexpressions are only evaluated once.
+    ///
+    /// \note A merged node is not part of \p full_nodes, but its parents
+    ///       still point to it. Evaluating the nodes through their child
+    ///       pointers requires relinking the parents with relinkChildren.
+    ///       This is needed when \p node_map has more entries than
+    ///       \p full_nodes.
+    ///
+    /// \param[inout] hash_map The ids of the nodes of \p full_nodes by hash,
+    ///                        used to find the equal nodes
+    /// \returns the id of this node
     int getNodesMap(Node_map_t &node_map, std::vector<Node *> &full_nodes,
-                    std::vector<Node_ids> &full_ids);
+                    std::vector<Node_ids> &full_ids,
+                    Node_hash_map_t &hash_map);
+
+    /// Creates a copy of this node which can be evaluated independently of
+    /// the original.
+    ///
+    /// The copy shares its children with this node until they are replaced
+    /// by calling replaceChild or relinkChildren. This is used by the CPU
+    /// backend to give each thread its own intermediate buffers.
+    ///
+    /// \returns a new node or nullptr if the node cannot be copied
+    virtual Node_ptr clone() const { return nullptr; }
+
+    /// Replaces the child at \p index with \p child
+    ///
+    /// \note The structural hash is not updated. The child is expected to
+    ///       generate the same code as the node it replaces.
+    virtual void replaceChild(int index, Node_ptr child) {
+        m_children[index] = std::move(child);
+    }
 
-    /// Generates the string that will be used to hash the kernel
+    /// Replaces the children of this node with the nodes in \p nodes that
+    /// are referenced by \p ids
+    ///
+    /// \param[in] ids   The ids of this node and its children
+    /// \param[in] nodes The nodes indexed by the ids generated by getNodesMap
+    void relinkChildren(const Node_ids &ids,
+                        const std::vector<Node_ptr> &nodes);
+
+    /// Returns true if the nodes below this node are only referenced by their
+    /// parents in this tree
+    ///
+    /// No other tree reads the buffers of such a tree, so its evaluation can
+    /// overwrite them if the root is not referenced by another array either.
+    bool hasExclusiveChildren() const;
+
+    /// Generates the description of the node used by getTreeString
     virtual void genKerName(std::string &kerString,
                             const Node_ids &ids) const = 0;
 
@@ -209,18 +284,50 @@ class Node {
     // Returns true if this node is a Buffer
     virtual bool isBuffer() const { return false; }
 
+    /// Returns true if the node has the same value for all the elements
+    virtual bool isScalar() const { return false; }
+
+    /// Returns true if the node has children and all of them are scalars
+    bool hasOnlyScalarChildren() const {
+        for (int i = 0; i < kMaxChildren && m_children[i] != nullptr; i++) {
+            if (!m_children[i]->isScalar()) { return false; }
+        }
+        return m_children[0] != nullptr;
+    }
+
+    /// Returns true if this node computes the same values as \p other when
+    /// both nodes have the same children.
+    ///
+    /// getNodesMap uses this to merge structurally equal subtrees. \p other
+    /// always has the same dynamic type, value type and hash as this node.
+    /// The default implementation only matches the node itself.
+    virtual bool isEqual(const Node &other) const { return this == &other; }
+
+    /// Returns true if the node can be converted to source code by the JIT
+    virtual bool isCompilable() const { return true; }
+
     /// Returns true if the buffer is linear
     virtual bool isLinear(dim_t dims[4]) const {
         UNUSED(dims);
         return true;
     }
 
+    /// Returns the type of the values of the node
+    af::dtype getType() const { return m_type; }
+
     /// Returns the string representation of the type
     std::string getTypeStr() const { return getFullName(m_type); }
 
     /// Returns the height of the JIT tree from this node
     int getHeight() const { return m_height; }
 
+    /// Returns the structural hash of the JIT tree from this node.
+    ///
+    /// The hash is computed when the node is created from the hashes of its
+    /// children, so it is available without walking the tree. Trees with the
+    /// same hash generate the same code unless they share nodes differently.
+    std::size_t getHash() const { return m_hash; }
+
     /// Returns the short name for this type
     /// \note For the shift node this is "Sh" appended by the short name of the
     ///       type
@@ -235,8 +342,31 @@ struct Node_ids {
     int id;
 };
 
+/// Returns the name of the kernel generated for the JIT trees.
+///
+/// The name is built from the structural hashes of the output nodes and
+/// the ids of the nodes, which describe how the nodes are shared. It does
+/// not visit the nodes, so it is used as the key of the kernel cache.
 std::string getFuncName(const std::vector<Node *> &output_nodes,
-                        const std::vector<Node *> &full_nodes,
                         const std::vector<Node_ids> &full_ids, bool is_linear);
 
+/// Returns a readable description of the JIT trees. This is only generated
+/// when a kernel is not found in the cache.
+std::string getTreeString(const std::vector<Node *> &output_nodes,
+                          const std::vector<Node *> &full_nodes,
+                          const std::vector<Node_ids> &full_ids,
+                          bool is_linear);
+
+/// Returns the ids of the nodes in the tree of \p root in increasing order,
+/// which is an order in which their code can be generated.
+///
+/// \param[in] root     The root of the tree
+/// \param[in] node_map The ids of the nodes generated by getNodesMap
+std::vector<int> getTreeIds(Node *root, const Node_map_t &node_map);
+
+/// The largest arrays which evalMultiple evaluates with a single batched
+/// kernel when their dimensions differ. The launch dominates the run time of
+/// the JIT kernels of smaller arrays.
+constexpr dim_t kJitBatchMaxElements = 16384;
+
 }  // namespace common
@@ -0,0 +1,105 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/jit/Node.hpp>
+#include <jit/kernel_generators.hpp>
+#include <af/traits.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace common {
+
+/// Generates the values of a uniform random array of the Philox engine in the
+/// JIT kernel. The value of each element only depends on the seed, on the
+/// counter of the engine and on the index of the element, so the expressions
+/// which use the array are fused with its generation instead of reading a
+/// buffer of random values.
+///
+/// The values are the ones written by the uniform Philox kernel of the
+/// random engine.
+template<typename T>
+class RandomNode : public Node {
+   private:
+    // The low and high words of the seed and of the counter of the engine,
+    // which are the kernel arguments
+    detail::uint m_args[4];
+
+   public:
+    RandomNode(const detail::uintl seed, const detail::uintl counter)
+        : Node(static_cast<af::dtype>(af::dtype_traits<T>::af_type), 0, {})
+        , m_args{static_cast<detail::uint>(seed),
+                 static_cast<detail::uint>(seed >> 32),
+                 static_cast<detail::uint>(counter),
+                 static_cast<detail::uint>(counter >> 32)} {
+        static_assert(std::is_same<T, float>::value ||
+                          std::is_same<T, double>::value,
+                      "RandomNode only generates floating point values");
+        updateHash('R');
+    }
+
+    void genKerName(std::string &kerString,
+                    const common::Node_ids &ids) const final {
+        kerString += '_';
+        kerString += getNameStr();
+        kerString += ',';
+        kerString += std::to_string(ids.id);
+    }
+
+    void genParams(std::stringstream &kerStream, int id,
+                   bool is_linear) const final {
+        UNUSED(is_linear);
+        kerStream << "uint rkey" << id << "_0, uint rkey" << id
+                  << "_1, uint rctr" << id << "_0, uint rctr" << id
+                  << "_1, \n";
+    }
+
+    int setArgs(int start_id, bool is_linear,
+                std::function<void(int id, const void *ptr, size_t arg_size)>
+                    setArg) const final {
+        UNUSED(is_linear);
+        for (int i = 0; i < 4; i++) {
+            setArg(start_id + i, static_cast<const void *>(&m_args[i]),
+                   sizeof(detail::uint));
+        }
+        return start_id + 4;
+    }
+
+    void genOffsets(std::stringstream &kerStream, int id,
+                    bool is_linear) const final {
+        detail::generateRandomNodeOffsets(kerStream, id, is_linear);
+    }
+
+    void genFuncs(std::stringstream &kerStream,
+                  const common::Node_ids &ids) const final {
+        const int id = ids.id;
+        kerStream << getTypeStr() << " val" << id << " = "
+                  << (std::is_same<T, float>::value ? "__philoxUniformFloat"
+                                                    : "__philoxUniformDouble")
+                  << "(rid" << id << ", rkey" << id << "_0, rkey" << id
+                  << "_1, rctr" << id << "_0, rctr" << id << "_1);\n";
+    }
+
+    std::string getNameStr() const final {
+        return std::string("R") + getShortName(m_type);
+    }
+
+    size_t getParamBytes() const final { return 4 * sizeof(detail::uint); }
+
+    bool isEqual(const Node &other) const final {
+        const auto &node = static_cast<const RandomNode &>(other);
+        return std::equal(m_args, m_args + 4, node.m_args);
+    }
+};
+
+}  // namespace common
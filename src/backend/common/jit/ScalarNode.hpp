@@ -14,7 +14,9 @@
 
 #include <math.hpp>
 #include <types.hpp>
+#include <cstring>
 #include <iomanip>
+#include <type_traits>
 
 namespace common {
 
@@ -31,6 +33,7 @@ class ScalarNode : public common::Node {
                       "ScalarNode is not move assignable");
         static_assert(std::is_nothrow_move_constructible<ScalarNode>::value,
                       "ScalarNode is not move constructible");
+        updateHash('C');
     }
 
     /// Default move copy constructor
@@ -84,6 +87,76 @@ class ScalarNode : public common::Node {
 
     // Return the info for the params and the size of the buffers
     virtual size_t getParamBytes() const final { return sizeof(T); }
+
+    bool isScalar() const final { return true; }
+
+    /// Scalars are compared bitwise so NaNs with the same bits are merged
+    bool isEqual(const Node& other) const final {
+        const auto& node = static_cast<const ScalarNode&>(other);
+        return std::memcmp(&m_val, &node.m_val, sizeof(T)) == 0;
+    }
+
+    /// Returns the value of the scalar
+    T getValue() const { return m_val; }
 };
 
+/// Computes a binary operation of two scalars on the host. Only the
+/// operations which give the same result as the generated kernels are
+/// computed. Everything else is left to the kernels.
+template<typename To, typename Ti, af_op_t op, typename Enable = void>
+struct ScalarFold {
+    static bool apply(To &out, const Ti lhs, const Ti rhs) {
+        UNUSED(out);
+        UNUSED(lhs);
+        UNUSED(rhs);
+        return false;
+    }
+};
+
+template<typename T, af_op_t op>
+struct ScalarFold<
+    T, T, op, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    static bool apply(T &out, const T lhs, const T rhs) {
+        switch (op) {
+            case af_add_t: out = lhs + rhs; return true;
+            case af_sub_t: out = lhs - rhs; return true;
+            case af_mul_t: out = lhs * rhs; return true;
+            default: return false;
+        }
+    }
+};
+
+template<typename T, af_op_t op>
+struct ScalarFold<T, T, op,
+                  typename std::enable_if<std::is_integral<T>::value>::type> {
+    static bool apply(T &out, const T lhs, const T rhs) {
+        // Unsigned arithmetic wraps around on overflow like the kernels
+        using U   = unsigned long long;
+        const U l = static_cast<U>(lhs);
+        const U r = static_cast<U>(rhs);
+        switch (op) {
+            case af_add_t: out = static_cast<T>(l + r); return true;
+            case af_sub_t: out = static_cast<T>(l - r); return true;
+            case af_mul_t: out = static_cast<T>(l * r); return true;
+            default: return false;
+        }
+    }
+};
+
+/// Computes op(lhs, rhs) into \p out if both nodes are scalars and the
+/// operation can be folded on the host.
+///
+/// \returns true if \p out holds the result
+template<typename To, typename Ti, af_op_t op>
+bool foldScalarNodes(To &out, const Node &lhs, const Node &rhs) {
+    constexpr auto type = static_cast<af::dtype>(af::dtype_traits<Ti>::af_type);
+    if (!lhs.isScalar() || !rhs.isScalar() || lhs.getType() != type ||
+        rhs.getType() != type) {
+        return false;
+    }
+    return ScalarFold<To, Ti, op>::apply(
+        out, static_cast<const ScalarNode<Ti> &>(lhs).getValue(),
+        static_cast<const ScalarNode<Ti> &>(rhs).getValue());
+}
+
 }  // namespace common
@@ -36,6 +36,7 @@ class ShiftNodeBase : public Node {
                       "ShiftNode is not move assignable");
         static_assert(std::is_nothrow_move_constructible<ShiftNodeBase>::value,
                       "ShiftNode is not move constructible");
+        updateHash('S');
     }
 
     /// Default move copy constructor
@@ -109,5 +110,11 @@ class ShiftNodeBase : public Node {
     std::string getNameStr() const final {
         return std::string("Sh") + getShortName(m_type);
     }
+
+    bool isEqual(const Node &other) const final {
+        const auto &node = static_cast<const ShiftNodeBase &>(other);
+        return m_shifts == node.m_shifts &&
+               m_buffer_node->isEqual(*node.m_buffer_node);
+    }
 };
 }  // namespace common
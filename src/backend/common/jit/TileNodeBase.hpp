@@ -0,0 +1,126 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <jit/BufferNode.hpp>
+#include <jit/kernel_generators.hpp>
+
+#include <backend.hpp>
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace common {
+
+/// Reads a buffer repeated along each dimension. The output of the kernel
+/// is indexed modulo the dimensions of the buffer, so tiled arrays are
+/// fused into the expressions which use them instead of being copied.
+///
+/// A buffer which is only repeated along the dimensions of size one is
+/// broadcast. The buffers of the general kernels already read the first
+/// element of these dimensions, so a broadcast node generates the code of a
+/// buffer and has its hash. Broadcast expressions then share the kernels of
+/// the expressions of buffers with the same structure.
+template<typename BufferNode>
+class TileNodeBase : public Node {
+   private:
+    std::shared_ptr<BufferNode> m_buffer_node;
+    bool m_broadcast;
+
+   public:
+    TileNodeBase(const af::dtype type, std::shared_ptr<BufferNode> buffer_node,
+                 const bool broadcast = false)
+        : Node(type, 0, {})
+        , m_buffer_node(buffer_node)
+        , m_broadcast(broadcast) {
+        static_assert(std::is_nothrow_move_assignable<TileNodeBase>::value,
+                      "TileNode is not move assignable");
+        static_assert(std::is_nothrow_move_constructible<TileNodeBase>::value,
+                      "TileNode is not move constructible");
+        updateHash(m_broadcast ? 'B' : 'T');
+    }
+
+    /// Default copy constructor
+    TileNodeBase(const TileNodeBase &other) = default;
+
+    /// Default move constructor
+    TileNodeBase(TileNodeBase &&other) = default;
+
+    /// Default move/copy assignment operator(Rule of 4)
+    TileNodeBase &operator=(TileNodeBase node) noexcept {
+        swap(node);
+        return *this;
+    }
+
+    // Swap specilization
+    void swap(TileNodeBase &other) noexcept {
+        using std::swap;
+        Node::swap(other);
+        swap(m_buffer_node, other.m_buffer_node);
+        swap(m_broadcast, other.m_broadcast);
+    }
+
+    bool isLinear(dim_t dims[4]) const final {
+        UNUSED(dims);
+        return false;
+    }
+
+    void genKerName(std::string &kerString,
+                    const common::Node_ids &ids) const final {
+        kerString += '_';
+        kerString += getNameStr();
+        kerString += ',';
+        kerString += std::to_string(ids.id);
+    }
+
+    void genParams(std::stringstream &kerStream, int id,
+                   bool is_linear) const final {
+        m_buffer_node->genParams(kerStream, id, is_linear);
+    }
+
+    int setArgs(int start_id, bool is_linear,
+                std::function<void(int id, const void *ptr, size_t arg_size)>
+                    setArg) const {
+        return m_buffer_node->setArgs(start_id, is_linear, setArg);
+    }
+
+    void genOffsets(std::stringstream &kerStream, int id,
+                    bool is_linear) const final {
+        if (m_broadcast) {
+            detail::generateBufferOffsets(kerStream, id, is_linear,
+                                          getTypeStr());
+        } else {
+            detail::generateTileNodeOffsets(kerStream, id, is_linear,
+                                            getTypeStr());
+        }
+    }
+
+    void genFuncs(std::stringstream &kerStream,
+                  const common::Node_ids &ids) const final {
+        detail::generateBufferRead(kerStream, ids.id, getTypeStr());
+    }
+
+    void getInfo(unsigned &len, unsigned &buf_count,
+                 unsigned &bytes) const final {
+        m_buffer_node->getInfo(len, buf_count, bytes);
+    }
+
+    std::string getNameStr() const final {
+        return std::string("Ti") + getShortName(m_type);
+    }
+
+    bool isEqual(const Node &other) const final {
+        const auto &node = static_cast<const TileNodeBase &>(other);
+        return m_broadcast == node.m_broadcast &&
+               m_buffer_node->isEqual(*node.m_buffer_node);
+    }
+};
+}  // namespace common
@@ -11,110 +11,509 @@
 
 #include <common/kernel_cache.hpp>
 
+#include <common/PrecisionMode.hpp>
+#include <common/Profiler.hpp>
 #include <common/compile_module.hpp>
+#include <common/defines.hpp>
+#include <common/jit/JitStats.hpp>
+#include <common/kernel_disk_cache.hpp>
 #include <common/util.hpp>
 #include <device_manager.hpp>
 #include <platform.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 using detail::Kernel;
 using detail::Module;
 
-using std::back_inserter;
+using std::atomic;
+using std::condition_variable;
+using std::deque;
+using std::function;
+using std::lock_guard;
+using std::make_shared;
+using std::memory_order_relaxed;
+using std::mutex;
+using std::promise;
+using std::shared_future;
 using std::shared_timed_mutex;
 using std::string;
-using std::transform;
+using std::thread;
+using std::unique_lock;
 using std::unordered_map;
 using std::vector;
+using std::chrono::duration;
+using std::chrono::steady_clock;
 
 namespace common {
 
-using ModuleMap = unordered_map<string, Module>;
+/// A module in the in-memory cache
+struct CachedModule {
+    Module mod;
+    /// The value of the use clock of the cache when the module was last
+    /// found. It is updated under the read lock of the cache.
+    mutable atomic<uint64_t> lastUse;
+
+    CachedModule(Module mod_, uint64_t use) : mod(mod_), lastUse(use) {}
+};
+
+/// A kernel instance which was already looked up by getKernel
+struct ResolvedKernel {
+    string moduleKey;
+#if defined(AF_CUDA)
+    /// The function of the kernel in the module, which stays valid while
+    /// the module is in the cache. The OpenCL kernels are created for each
+    /// call because their arguments are set on the kernel object.
+    Kernel kernel;
+#endif
+};
+
+/// The in-memory cache of the modules of a device
+struct ModuleCache {
+    unordered_map<string, CachedModule> modules;
+    /// The kernel instances found in the modules, by their lookup key. It
+    /// is cleared when a module is evicted.
+    unordered_map<string, ResolvedKernel> kernels;
+    /// Counts the lookups, which orders the uses of the modules
+    atomic<uint64_t> clock{0};
+    /// The size of the binaries of the modules
+    size_t bytes = 0;
+};
+
+/// The limits of the in-memory cache of each device, zero if unlimited
+struct ModuleCacheLimits {
+    size_t modules;
+    size_t bytes;
+};
+
+size_t readLimit(const char* name) {
+    const string env = getEnvVar(name);
+    size_t limit     = 0;
+    try {
+        if (!env.empty()) { limit = std::stoull(env); }
+    } catch (const std::exception&) {}
+    return limit;
+}
+
+const ModuleCacheLimits& getCacheLimits() {
+    static const ModuleCacheLimits limits{
+        readLimit(JIT_MODULE_CACHE_COUNT_ENV_NAME),
+        readLimit(JIT_MODULE_CACHE_SIZE_ENV_NAME) << 20};
+    return limits;
+}
 
 shared_timed_mutex& getCacheMutex(const int device) {
     static shared_timed_mutex mutexes[detail::DeviceManager::MAX_DEVICES];
     return mutexes[device];
 }
 
-ModuleMap& getCache(const int device) {
-    static ModuleMap* caches =
-        new ModuleMap[detail::DeviceManager::MAX_DEVICES];
+ModuleCache& getCache(const int device) {
+    static ModuleCache* caches =
+        new ModuleCache[detail::DeviceManager::MAX_DEVICES];
     return caches[device];
 }
 
 Module findModule(const int device, const string& key) {
     std::shared_lock<shared_timed_mutex> readLock(getCacheMutex(device));
     auto& cache = getCache(device);
-    auto iter   = cache.find(key);
-    if (iter != cache.end()) { return iter->second; }
+    auto iter   = cache.modules.find(key);
+    if (iter != cache.modules.end()) {
+        iter->second.lastUse.store(
+            cache.clock.fetch_add(1, memory_order_relaxed) + 1,
+            memory_order_relaxed);
+        return iter->second.mod;
+    }
     return Module{};
 }
 
+/// Unloads the least recently used modules of \p cache until it is within
+/// the limits. The module with the key \p keep, which was just added, is
+/// never unloaded. Must be called with the write lock of the cache.
+void evictModules(const int device, ModuleCache& cache, const string& keep) {
+    const ModuleCacheLimits& limits = getCacheLimits();
+    auto overLimit                  = [&]() {
+        return cache.modules.size() > 1 &&
+               ((limits.modules && cache.modules.size() > limits.modules) ||
+                (limits.bytes && cache.bytes > limits.bytes));
+    };
+    if (!overLimit()) { return; }
+
+    // The cache only drops its reference to the evicted modules. They are
+    // unloaded once the kernels taken from them are destroyed and their
+    // launches on every stream or queue of the device are done.
+    while (overLimit()) {
+        auto lru = cache.modules.end();
+        for (auto iter = cache.modules.begin(); iter != cache.modules.end();
+             ++iter) {
+            if (iter->first == keep) { continue; }
+            if (lru == cache.modules.end() ||
+                iter->second.lastUse.load(memory_order_relaxed) <
+                    lru->second.lastUse.load(memory_order_relaxed)) {
+                lru = iter;
+            }
+        }
+        cache.bytes -= lru->second.mod.bytes();
+        lru->second.mod.unload();
+        cache.modules.erase(lru);
+        recordModuleEviction(device);
+    }
+    cache.kernels.clear();
+}
+
+/// Adds \p mod to the cache unless another thread added a module with the
+/// same key first. Returns the module in the cache.
+Module addModule(const int device, const string& key, Module mod) {
+    std::unique_lock<shared_timed_mutex> writeLock(getCacheMutex(device));
+    auto& cache = getCache(device);
+    auto iter   = cache.modules.find(key);
+    if (iter == cache.modules.end()) {
+        const uint64_t use = cache.clock.fetch_add(1, memory_order_relaxed);
+        shareModule(mod, device);
+        cache.modules.emplace(std::piecewise_construct,
+                              std::forward_as_tuple(key),
+                              std::forward_as_tuple(mod, use + 1));
+        cache.bytes += mod.bytes();
+        evictModules(device, cache, key);
+        recordModuleCache(device, cache.modules.size(), cache.bytes);
+        // The launches of the kernels of the module are attributed to its key
+        if (isProfiling()) {
+#if defined(AF_CUDA)
+            setProfiledName(mod.get(), key);
+#elif defined(AF_OPENCL)
+            setProfiledName(mod.get()(), key);
+#endif
+        }
+        return mod;
+    }
+    mod.unload();
+    return iter->second.mod;
+}
+
+/// The modules which are being compiled or loaded by a thread
+using InFlightMap = unordered_map<string, shared_future<Module>>;
+
+mutex& getInFlightMutex(const int device) {
+    static mutex mutexes[detail::DeviceManager::MAX_DEVICES];
+    return mutexes[device];
+}
+
+InFlightMap& getInFlight(const int device) {
+    static InFlightMap* maps =
+        new InFlightMap[detail::DeviceManager::MAX_DEVICES];
+    return maps[device];
+}
+
+/// Returns the module with the key \p key from the cache. If it is not in
+/// the cache, \p create is called to compile or load it unless another
+/// thread is already doing so. In that case only that module is waited for.
+///
+/// \p create can return an empty module if the module is not available. The
+/// empty module is returned without being added to the cache.
+Module getOrCreateModule(const int device, const string& key,
+                         const function<Module()>& create) {
+    while (true) {
+        Module mod = findModule(device, key);
+        if (mod) { return mod; }
+
+        promise<Module> created;
+        shared_future<Module> inFlight;
+        {
+            lock_guard<mutex> lock(getInFlightMutex(device));
+            auto& modules = getInFlight(device);
+            auto iter     = modules.find(key);
+            if (iter != modules.end()) {
+                inFlight = iter->second;
+            } else {
+                // The module may have been added since the first lookup
+                mod = findModule(device, key);
+                if (mod) { return mod; }
+                modules.emplace(key, created.get_future().share());
+            }
+        }
+
+        if (inFlight.valid()) {
+            mod = inFlight.get();
+            // If the other thread could not load the module, try again
+            if (mod) { return mod; }
+            continue;
+        }
+
+        auto finish = [&]() {
+            lock_guard<mutex> lock(getInFlightMutex(device));
+            getInFlight(device).erase(key);
+        };
+        try {
+            mod = create();
+            // The module is added to the cache before it is removed from the
+            // in flight modules so other threads always find one of them
+            if (mod) { mod = addModule(device, key, mod); }
+            created.set_value(mod);
+        } catch (...) {
+            created.set_exception(std::current_exception());
+            finish();
+            throw;
+        }
+        finish();
+        return mod;
+    }
+}
+
+/// The threads which load the modules requested by enqueueModules. The
+/// threads are shared by all the devices. Each task sets the device it
+/// loads the module for.
+class ModuleQueue {
+    mutex m_mutex;
+    condition_variable m_ready;
+    deque<function<void()>> m_tasks;
+    vector<thread> m_workers;
+
+    void work() {
+        while (true) {
+            function<void()> task;
+            {
+                unique_lock<mutex> lock(m_mutex);
+                m_ready.wait(lock, [this] { return !m_tasks.empty(); });
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+   public:
+    void push(function<void()> task) {
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+            if (m_workers.empty()) {
+                const unsigned count =
+                    std::max(1U, thread::hardware_concurrency());
+                for (unsigned i = 0; i < count; ++i) {
+                    m_workers.emplace_back(&ModuleQueue::work, this);
+                }
+            }
+        }
+        m_ready.notify_one();
+    }
+};
+
+ModuleQueue& getModuleQueue() {
+    // The workers wait for tasks until the process exits, so the queue is
+    // never destroyed
+    static ModuleQueue* queue = new ModuleQueue();
+    return *queue;
+}
+
+ModuleBatch enqueueModules(const int device, const vector<string>& keys) {
+    // Only the modules in the index are loaded. The index records if the
+    // binary was generated by the JIT, which determines its format.
+    unordered_map<string, const CachedKernel*> indexed;
+    const vector<CachedKernel> entries = getCachedKernels();
+    for (const CachedKernel& entry : entries) {
+        // The index lists the binaries of all the devices and versions
+        if (entry.filename == getKernelCacheFilename(device, entry.key)) {
+            indexed.emplace(entry.key, &entry);
+        }
+    }
+
+    vector<const CachedKernel*> requested;
+    if (keys.empty()) {
+        for (const auto& item : indexed) { requested.push_back(item.second); }
+    } else {
+        for (const string& key : keys) {
+            auto iter = indexed.find(key);
+            if (iter != indexed.end()) { requested.push_back(iter->second); }
+        }
+    }
+
+    ModuleBatch batch;
+    batch.reserve(requested.size());
+    for (const CachedKernel* entry : requested) {
+        if (findModule(device, entry->key)) { continue; }
+        auto task = make_shared<std::packaged_task<Module()>>(
+            [device, key = entry->key, isJIT = entry->isJIT]() {
+                detail::setDevice(device);
+                return getOrCreateModule(device, key, [&]() {
+                    return loadModuleFromDisk(device, key, isJIT);
+                });
+            });
+        batch.push_back(task->get_future().share());
+        getModuleQueue().push([task]() { (*task)(); });
+    }
+    return batch;
+}
+
+int waitModules(const ModuleBatch& batch) {
+    int count = 0;
+    for (const shared_future<Module>& mod : batch) {
+        try {
+            if (mod.get()) { count++; }
+        } catch (...) {
+            // A module which fails to load is compiled when it is used
+        }
+    }
+    return count;
+}
+
+int prewarmModules(const int device) {
+    return waitModules(enqueueModules(device, {}));
+}
+
+/// Returns the key of a kernel instance in the resolved kernels of the
+/// cache. It is only used by this process, so the sources are hashed with
+/// std::hash, which is much faster than the byte by byte hash of the
+/// module key.
+string getLookupKey(const string& tInstance, const vector<string>& sources,
+                    const vector<string>& options,
+                    const af_precision_mode mode, const bool sourceIsJIT) {
+    string key = tInstance;
+    key += '\0';
+    key += std::to_string(static_cast<int>(mode));
+    for (const string& option : options) {
+        key += '\0';
+        key += option;
+    }
+    // The names of the JIT kernels are the hashes of their sources
+    if (!sourceIsJIT) {
+        for (const string& source : sources) {
+            key += '\0';
+            key += std::to_string(std::hash<string>{}(source));
+        }
+    }
+    return key;
+}
+
+/// Looks up a kernel instance which was already resolved on \p device
+bool findResolvedKernel(Kernel& kernel, const int device, const string& key,
+                        const string& kernelName, const bool sourceIsJIT) {
+    std::shared_lock<shared_timed_mutex> readLock(getCacheMutex(device));
+    auto& cache = getCache(device);
+    auto iter   = cache.kernels.find(key);
+    if (iter == cache.kernels.end()) { return false; }
+    auto mod = cache.modules.find(iter->second.moduleKey);
+    if (mod == cache.modules.end()) { return false; }
+    mod->second.lastUse.store(
+        cache.clock.fetch_add(1, memory_order_relaxed) + 1,
+        memory_order_relaxed);
+#if defined(AF_CUDA)
+    UNUSED(kernelName);
+    UNUSED(sourceIsJIT);
+    kernel = iter->second.kernel;
+#elif defined(AF_OPENCL)
+    kernel = getKernel(mod->second.mod, kernelName, sourceIsJIT);
+#endif
+    return true;
+}
+
+/// Adds a kernel instance of the module \p mod to the resolved kernels,
+/// unless the module was evicted since it was found
+void addResolvedKernel(const int device, const string& key,
+                       const string& moduleKey, const Module& mod,
+                       const Kernel& kernel) {
+    std::unique_lock<shared_timed_mutex> writeLock(getCacheMutex(device));
+    auto& cache = getCache(device);
+    auto iter   = cache.modules.find(moduleKey);
+    if (iter == cache.modules.end()) { return; }
+#if defined(AF_CUDA)
+    if (iter->second.mod.get() != mod.get()) { return; }
+    cache.kernels[key] = ResolvedKernel{moduleKey, kernel};
+#elif defined(AF_OPENCL)
+    UNUSED(mod);
+    UNUSED(kernel);
+    cache.kernels[key] = ResolvedKernel{moduleKey};
+#endif
+}
+
 Kernel getKernel(const string& kernelName, const vector<string>& sources,
                  const vector<TemplateArg>& targs,
                  const vector<string>& options, const bool sourceIsJIT) {
-    vector<string> args;
-    args.reserve(targs.size());
-
-    transform(targs.begin(), targs.end(), back_inserter(args),
-              [](const TemplateArg& arg) -> string { return arg._tparam; });
-
     string tInstance = kernelName;
-    if (args.size() > 0) {
-        tInstance = kernelName + "<" + args[0];
-        for (size_t i = 1; i < args.size(); ++i) {
-            tInstance += ("," + args[i]);
+    if (!targs.empty()) {
+        tInstance += '<';
+        for (size_t i = 0; i < targs.size(); ++i) {
+            if (i > 0) { tInstance += ','; }
+            tInstance += targs[i]._tparam;
         }
-        tInstance += ">";
+        tInstance += '>';
     }
 
-    const bool notJIT = !sourceIsJIT;
+    const bool notJIT            = !sourceIsJIT;
+    const int device             = detail::getActiveDeviceId();
+    const af_precision_mode mode = getPrecisionMode();
+
+    // The kernels which were already launched skip the hash of the module
+    // key and the lookup of the function in the module
+    const string lookupKey =
+        getLookupKey(tInstance, sources, options, mode, sourceIsJIT);
+    Kernel resolved;
+    if (findResolvedKernel(resolved, device, lookupKey, kernelName,
+                           sourceIsJIT)) {
+        recordKernelCacheLookup(device, true);
+        return resolved;
+    }
+
+    // The names of the JIT kernels already include the precision mode
+    vector<string> compileOptions = options;
+    const vector<string> precision = getPrecisionOptions(device, mode);
+    compileOptions.insert(compileOptions.end(), precision.begin(),
+                          precision.end());
 
     vector<string> hashingVals;
-    hashingVals.reserve(1 + (notJIT * (sources.size() + options.size())));
+    hashingVals.reserve(1 +
+                        (notJIT * (sources.size() + compileOptions.size())));
     hashingVals.push_back(tInstance);
     if (notJIT) {
         // This code path is only used for regular kernel compilation
         // since, jit funcName(kernelName) is unique to use it's hash
         // for caching the relevant compiled/linked module
         hashingVals.insert(hashingVals.end(), sources.begin(), sources.end());
-        hashingVals.insert(hashingVals.end(), options.begin(), options.end());
+        hashingVals.insert(hashingVals.end(), compileOptions.begin(),
+                           compileOptions.end());
     }
 
     const string moduleKey = std::to_string(deterministicHash(hashingVals));
-    const int device       = detail::getActiveDeviceId();
     Module currModule      = findModule(device, moduleKey);
+    recordKernelCacheLookup(device, static_cast<bool>(currModule));
 
     if (!currModule) {
-        currModule = loadModuleFromDisk(device, moduleKey, sourceIsJIT);
-        if (!currModule) {
-            currModule = compileModule(moduleKey, sources, options, {tInstance},
-                                       sourceIsJIT);
-        }
-
-        std::unique_lock<shared_timed_mutex> writeLock(getCacheMutex(device));
-        auto& cache = getCache(device);
-        auto iter   = cache.find(moduleKey);
-        if (iter == cache.end()) {
-            // If not found, this thread is the first one to compile this
-            // kernel. Keep the generated module.
-            Module mod = currModule;
-            getCache(device).emplace(moduleKey, mod);
-        } else {
-            currModule.unload();  // dump the current threads extra compilation
-            currModule = iter->second;
-        }
+        // If another thread is compiling or loading this module, only that
+        // module is waited for
+        currModule = getOrCreateModule(device, moduleKey, [&]() {
+            Module mod = loadModuleFromDisk(device, moduleKey, sourceIsJIT);
+            if (!mod) {
+                auto start = steady_clock::now();
+                mod = compileModule(moduleKey, sources, compileOptions,
+                                    {tInstance}, sourceIsJIT);
+                duration<double> elapsed = steady_clock::now() - start;
+                recordKernelCompile(device, elapsed.count());
+            }
+            return mod;
+        });
     }
 #if defined(AF_CUDA)
-    return getKernel(currModule, tInstance, sourceIsJIT);
+    Kernel kernel = getKernel(currModule, tInstance, sourceIsJIT);
 #elif defined(AF_OPENCL)
-    return getKernel(currModule, kernelName, sourceIsJIT);
+    Kernel kernel = getKernel(currModule, kernelName, sourceIsJIT);
 #endif
+    addResolvedKernel(device, lookupKey, moduleKey, currModule, kernel);
+    return kernel;
 }
 
 }  // namespace common
@@ -16,11 +16,26 @@
 #include <backend.hpp>
 #include <common/TemplateTypename.hpp>
 
+#include <future>
 #include <string>
 #include <vector>
 
 namespace common {
 
+/// The environment variable which limits the number of modules in the
+/// in-memory cache of each device. Zero disables the limit.
+constexpr const char* JIT_MODULE_CACHE_COUNT_ENV_NAME =
+    "AF_JIT_MODULE_CACHE_COUNT";
+
+/// The environment variable which limits the size of the binaries of the
+/// modules in the in-memory cache of each device, in megabytes. Zero
+/// disables the limit.
+constexpr const char* JIT_MODULE_CACHE_SIZE_ENV_NAME =
+    "AF_JIT_MODULE_CACHE_SIZE";
+
+/// The modules requested by a call to enqueueModules
+using ModuleBatch = std::vector<std::shared_future<detail::Module>>;
+
 /// \brief Find/Create-Cache a Kernel that fits the given criteria
 ///
 /// This function takes in two vectors of strings apart from the main Kernel
@@ -100,6 +115,37 @@ detail::Module findModule(const int device, const std::string& key);
 detail::Kernel getKernel(const detail::Module& mod, const std::string& name,
                          const bool sourceWasJIT);
 
+/// \brief Loads modules of a device from the disk cache in the background
+///
+/// The modules are loaded by a pool of threads shared by all the devices.
+/// A call to getKernel which needs one of these modules before it is loaded
+/// waits only for that module. Modules which are already loaded and keys
+/// which are not in the kernel cache index for \p device are skipped.
+///
+/// \param[in] device is index of device in given backend
+/// \param[in] keys are the keys of the modules to load. All the modules in
+///            the index are loaded if it is empty.
+///
+/// \returns the modules which are being loaded
+ModuleBatch enqueueModules(const int device,
+                           const std::vector<std::string>& keys);
+
+/// \brief Waits for the modules in \p batch to be loaded
+///
+/// \returns the number of modules which were loaded
+int waitModules(const ModuleBatch& batch);
+
+/// \brief Loads all the modules of a device from the disk cache
+///
+/// The modules listed in the kernel cache index for \p device are loaded
+/// into the in-memory cache, so later calls to getKernel do not compile or
+/// load them. Modules which are already loaded are skipped.
+///
+/// \param[in] device is index of device in given backend
+///
+/// \returns the number of modules loaded
+int prewarmModules(const int device);
+
 }  // namespace common
 
 #endif
@@ -0,0 +1,283 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/kernel_disk_cache.hpp>
+
+#include <common/defines.hpp>
+#include <common/util.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using std::ifstream;
+using std::istringstream;
+using std::lock_guard;
+using std::mutex;
+using std::ofstream;
+using std::ostringstream;
+using std::string;
+using std::unordered_map;
+using std::unordered_set;
+using std::vector;
+
+namespace common {
+
+namespace {
+
+constexpr const char *INDEX_HEADER   = "ArrayFire kernel cache index 1";
+constexpr const char *INDEX_CHECKSUM = "checksum";
+
+/// The entries of the index by the name of the binary
+using EntryMap = unordered_map<string, CachedKernel>;
+
+long long now() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch())
+        .count();
+}
+
+std::size_t getCacheSizeLimit() {
+    const string env      = getEnvVar(JIT_KERNEL_CACHE_SIZE_ENV_NAME);
+    std::size_t megabytes = DEFAULT_JIT_KERNEL_CACHE_SIZE_MB;
+    try {
+        if (!env.empty()) { megabytes = std::stoull(env); }
+    } catch (const std::exception &) {}
+    return megabytes << 20;
+}
+
+string indexPath(const string &directory) {
+    return directory + AF_PATH_SEPARATOR + KERNEL_CACHE_INDEX_FILENAME;
+}
+
+/// Reads the index in \p directory. The index is ignored if it is missing,
+/// incomplete or if its checksum does not match.
+EntryMap readIndex(const string &directory) {
+    EntryMap entries;
+    ifstream in(indexPath(directory), std::ios::binary);
+    if (!in.is_open()) { return entries; }
+
+    ostringstream contents;
+    contents << in.rdbuf();
+    const string text = contents.str();
+
+    // The last line holds the checksum of everything before it
+    const size_t end = text.rfind(string("\n") + INDEX_CHECKSUM + '\t');
+    if (end == string::npos || text.compare(0, strlen(INDEX_HEADER),
+                                            INDEX_HEADER) != 0) {
+        return entries;
+    }
+    const size_t last = end + 1;
+    istringstream tail(text.substr(last + strlen(INDEX_CHECKSUM)));
+    std::size_t checksum = 0;
+    if (!(tail >> checksum) ||
+        checksum != deterministicHash(text.data(), last)) {
+        return entries;
+    }
+
+    istringstream lines(text.substr(0, last));
+    string line;
+    std::getline(lines, line);  // header
+    while (std::getline(lines, line)) {
+        istringstream fields(line);
+        CachedKernel entry{};
+        string bytes, checksum, isJIT, lastUse;
+        if (std::getline(fields, entry.key, '\t') &&
+            std::getline(fields, bytes, '\t') &&
+            std::getline(fields, checksum, '\t') &&
+            std::getline(fields, isJIT, '\t') &&
+            std::getline(fields, lastUse, '\t') &&
+            std::getline(fields, entry.filename) && !entry.filename.empty()) {
+            try {
+                entry.bytes    = std::stoull(bytes);
+                entry.checksum = std::stoull(checksum);
+                entry.isJIT    = isJIT == "1";
+                entry.lastUse  = std::stoll(lastUse);
+            } catch (const std::exception &) { continue; }
+            entries.emplace(entry.filename, entry);
+        }
+    }
+    return entries;
+}
+
+/// Writes the index to a temporary file which replaces the index so other
+/// processes never read a partial index
+void writeIndex(const string &directory, const EntryMap &entries) {
+    ostringstream out;
+    out << INDEX_HEADER << '\n';
+    for (const auto &item : entries) {
+        const CachedKernel &entry = item.second;
+        out << entry.key << '\t' << entry.bytes << '\t' << entry.checksum
+            << '\t' << (entry.isJIT ? 1 : 0) << '\t' << entry.lastUse << '\t'
+            << entry.filename << '\n';
+    }
+    const string text = out.str();
+
+    const string tempFile = directory + AF_PATH_SEPARATOR + makeTempFilename();
+    {
+        ofstream file(tempFile, std::ios::binary);
+        if (!file.is_open()) { return; }
+        file << text << INDEX_CHECKSUM << '\t'
+             << deterministicHash(text.data(), text.size()) << '\n';
+    }
+    if (!renameFile(tempFile, indexPath(directory))) { removeFile(tempFile); }
+}
+
+/// The in memory copy of the index of the cache directory
+class KernelCacheIndex {
+    mutex m_mutex;
+    string m_directory;
+    EntryMap m_entries;
+    /// The binaries removed by this process since the last sync. They are
+    /// not added back from the index of another process.
+    unordered_set<string> m_removed;
+    bool m_loaded = false;
+    bool m_dirty  = false;
+
+    void load(const string &directory) {
+        if (m_loaded && m_directory == directory) { return; }
+        if (m_loaded && m_dirty) { sync(""); }
+        m_directory = directory;
+        m_entries   = readIndex(directory);
+        m_removed.clear();
+        m_loaded = true;
+        m_dirty  = false;
+    }
+
+    /// Removes the least recently used binaries, other than \p keep, until
+    /// the cache is within its size limit
+    void evict(const string &keep) {
+        const std::size_t limit = getCacheSizeLimit();
+        std::size_t total       = 0;
+        for (const auto &item : m_entries) { total += item.second.bytes; }
+        if (limit == 0 || total <= limit) { return; }
+
+        vector<const CachedKernel *> order;
+        order.reserve(m_entries.size());
+        for (const auto &item : m_entries) { order.push_back(&item.second); }
+        std::sort(order.begin(), order.end(),
+                  [](const CachedKernel *a, const CachedKernel *b) {
+                      return a->lastUse < b->lastUse;
+                  });
+
+        vector<string> evicted;
+        for (const CachedKernel *entry : order) {
+            if (total <= limit) { break; }
+            if (entry->filename == keep) { continue; }
+            total -= entry->bytes;
+            evicted.push_back(entry->filename);
+        }
+        for (const string &filename : evicted) {
+            removeFile(m_directory + AF_PATH_SEPARATOR + filename);
+            m_entries.erase(filename);
+        }
+    }
+
+    /// Merges the index on disk, which may have been updated by other
+    /// processes, with this index and writes the result back
+    void sync(const string &keep) {
+        for (auto &item : readIndex(m_directory)) {
+            if (m_removed.count(item.first)) { continue; }
+            auto iter = m_entries.find(item.first);
+            if (iter == m_entries.end()) {
+                m_entries.emplace(item.first, item.second);
+            } else if (iter->second.lastUse < item.second.lastUse) {
+                iter->second = item.second;
+            }
+        }
+        evict(keep);
+        writeIndex(m_directory, m_entries);
+        m_removed.clear();
+        m_dirty = false;
+    }
+
+   public:
+    ~KernelCacheIndex() {
+        // The uses of the binaries are saved when the process exits
+        try {
+            if (m_loaded && m_dirty) { sync(""); }
+        } catch (...) {}
+    }
+
+    void add(CachedKernel entry) {
+        const string &directory = getCacheDirectory();
+        if (directory.empty()) { return; }
+        lock_guard<mutex> lock(m_mutex);
+        load(directory);
+        entry.lastUse = now();
+        m_removed.erase(entry.filename);
+        m_entries[entry.filename] = entry;
+        sync(entry.filename);
+    }
+
+    bool touch(CachedKernel entry) {
+        const string &directory = getCacheDirectory();
+        if (directory.empty()) { return true; }
+        lock_guard<mutex> lock(m_mutex);
+        load(directory);
+        auto iter = m_entries.find(entry.filename);
+        if (iter != m_entries.end() &&
+            iter->second.checksum != entry.checksum) {
+            return false;
+        }
+        entry.lastUse             = now();
+        m_entries[entry.filename] = entry;
+        m_dirty                   = true;
+        return true;
+    }
+
+    void remove(const string &filename) {
+        const string &directory = getCacheDirectory();
+        if (directory.empty()) { return; }
+        lock_guard<mutex> lock(m_mutex);
+        load(directory);
+        removeFile(directory + AF_PATH_SEPARATOR + filename);
+        if (m_entries.erase(filename) == 0) { return; }
+        m_removed.insert(filename);
+        sync("");
+    }
+
+    vector<CachedKernel> entries() {
+        vector<CachedKernel> out;
+        const string &directory = getCacheDirectory();
+        if (directory.empty()) { return out; }
+        lock_guard<mutex> lock(m_mutex);
+        load(directory);
+        out.reserve(m_entries.size());
+        for (const auto &item : m_entries) { out.push_back(item.second); }
+        return out;
+    }
+};
+
+KernelCacheIndex &getIndex() {
+    static KernelCacheIndex index;
+    return index;
+}
+
+}  // namespace
+
+void addCachedKernel(CachedKernel entry) { getIndex().add(std::move(entry)); }
+
+bool touchCachedKernel(CachedKernel entry) {
+    return getIndex().touch(std::move(entry));
+}
+
+void removeCachedKernel(const string &filename) { getIndex().remove(filename); }
+
+vector<CachedKernel> getCachedKernels() { return getIndex().entries(); }
+
+}  // namespace common
@@ -0,0 +1,72 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+/// This file manages the index of the kernel binaries stored in the cache
+/// directory returned by getCacheDirectory.
+///
+/// The index is a single text file in the cache directory with one entry per
+/// binary. It records the module key, the size, the checksum and the last
+/// time each binary was used. The size of the binaries is limited by the
+/// AF_JIT_KERNEL_CACHE_SIZE environment variable. When a new binary pushes
+/// the cache over the limit, the least recently used binaries are removed.
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace common {
+
+/// The environment variable which limits the total size of the cached kernel
+/// binaries in megabytes. Zero disables the limit.
+constexpr const char *JIT_KERNEL_CACHE_SIZE_ENV_NAME =
+    "AF_JIT_KERNEL_CACHE_SIZE";
+
+/// The size limit used if AF_JIT_KERNEL_CACHE_SIZE is not set, in megabytes
+constexpr std::size_t DEFAULT_JIT_KERNEL_CACHE_SIZE_MB = 1024;
+
+/// The name of the index file in the cache directory
+constexpr const char *KERNEL_CACHE_INDEX_FILENAME = "kernel_cache.index";
+
+/// An entry of the kernel cache index
+struct CachedKernel {
+    std::string key;       ///< The module key passed to compileModule
+    std::string filename;  ///< The name of the binary in the cache directory
+    std::size_t bytes;     ///< The size of the binary file in bytes
+    std::size_t checksum;  ///< The hash of the binary stored in the file
+    bool isJIT;            ///< True if the module was generated by the JIT
+    long long lastUse;     ///< The last time the binary was used
+};
+
+/// Adds a binary which was written to the cache directory to the index and
+/// removes the least recently used binaries if the cache is over its limit.
+///
+/// \param[in] entry The binary. The last use is set to the current time.
+void addCachedKernel(CachedKernel entry);
+
+/// Marks a binary loaded from the cache directory as used.
+///
+/// A binary which is not in the index yet is added to it. The checksum of a
+/// binary which is in the index has to match the checksum in the index.
+///
+/// \param[in] entry The binary which was loaded
+///
+/// \returns false if the index has a different checksum for the binary. The
+///          binary should not be used in that case.
+bool touchCachedKernel(CachedKernel entry);
+
+/// Removes a binary from the index and from the cache directory
+///
+/// \param[in] filename The name of the binary in the cache directory
+void removeCachedKernel(const std::string &filename);
+
+/// Returns the binaries in the index of the current cache directory
+std::vector<CachedKernel> getCachedKernels();
+
+}  // namespace common
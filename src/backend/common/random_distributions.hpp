@@ -0,0 +1,210 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// Samplers of the distributions with per element parameters, shared by the
+// CPU and the CUDA kernels. The OpenCL kernels implement the same algorithms
+// in kernel/random_distributions.cl.
+//
+// The samplers draw their values from a generator gen with two functions:
+// gen.uniform() returns values in (0, 1] and gen.normal() returns values of
+// the standard normal distribution.
+
+#pragma once
+
+#include <backend.hpp>
+#include <common/internal_enums.hpp>
+
+#include <math.h>
+
+#ifndef __DH__
+#define __DH__
+#endif
+
+namespace common {
+
+/// The index of the stream of the values of an element, in the last word of
+/// the Philox counter. The uniform and normal kernels leave it at 0, so the
+/// values of the distributions are not the values of those kernels.
+constexpr unsigned RANDOM_DIST_STREAM = 1;
+
+/// The largest number of proposals of a rejection sampler. The samplers
+/// accept about half of the proposals in their worst cases, so they only
+/// return NaN after RANDOM_DIST_MAX_TRIALS rejections when the parameters
+/// make the arithmetic degenerate.
+constexpr int RANDOM_DIST_MAX_TRIALS = 1000;
+
+namespace random {
+
+// The math functions of each precision, available on the host and on the
+// device without overload resolution through std
+__DH__ inline float rLog(float x) { return logf(x); }
+__DH__ inline double rLog(double x) { return log(x); }
+__DH__ inline float rExp(float x) { return expf(x); }
+__DH__ inline double rExp(double x) { return exp(x); }
+__DH__ inline float rSqrt(float x) { return sqrtf(x); }
+__DH__ inline double rSqrt(double x) { return sqrt(x); }
+__DH__ inline float rFloor(float x) { return floorf(x); }
+__DH__ inline double rFloor(double x) { return floor(x); }
+__DH__ inline float rAbs(float x) { return fabsf(x); }
+__DH__ inline double rAbs(double x) { return fabs(x); }
+__DH__ inline float rLgamma(float x) { return lgammaf(x); }
+__DH__ inline double rLgamma(double x) { return lgamma(x); }
+
+template<typename T>
+__DH__ inline T rNaN() {
+    return static_cast<T>(NAN);
+}
+
+}  // namespace random
+
+/// Samples the exponential distribution of rate \p rate
+template<typename T, typename G>
+__DH__ T sampleExponential(G &gen, const T rate) {
+    if (!(rate > T(0))) { return random::rNaN<T>(); }
+    return -random::rLog(gen.uniform()) / rate;
+}
+
+/// Samples the gamma distribution of shape \p shape and scale \p scale with
+/// the method of Marsaglia and Tsang (2000). Shapes below 1 are boosted by 1
+/// and the value is multiplied by u^(1 / shape).
+template<typename T, typename G>
+__DH__ T sampleGamma(G &gen, const T shape, const T scale) {
+    using namespace random;  // NOLINT
+    if (!(shape > T(0)) || !(scale > T(0))) { return rNaN<T>(); }
+
+    const bool boost = shape < T(1);
+    const T d        = (boost ? shape + T(1) : shape) - T(1) / T(3);
+    const T c        = T(1) / rSqrt(T(9) * d);
+    for (int trial = 0; trial < RANDOM_DIST_MAX_TRIALS; ++trial) {
+        const T x = gen.normal();
+        T v       = T(1) + c * x;
+        if (v <= T(0)) { continue; }
+        v *= v * v;
+
+        const T u  = gen.uniform();
+        const T x2 = x * x;
+        if (u < T(1) - T(0.0331) * x2 * x2 ||
+            rLog(u) < T(0.5) * x2 + d * (T(1) - v + rLog(v))) {
+            const T value = d * v * scale;
+            if (!boost) { return value; }
+            return value * rExp(rLog(gen.uniform()) / shape);
+        }
+    }
+    return rNaN<T>();
+}
+
+/// Samples the Poisson distribution of mean \p lambda. Means below 10 use
+/// the multiplication of uniform values of Knuth, larger means use the
+/// transformed rejection (PTRS) of Hörmann (1993).
+template<typename T, typename G>
+__DH__ T samplePoisson(G &gen, const T lambda) {
+    using namespace random;  // NOLINT
+    if (!(lambda >= T(0))) { return rNaN<T>(); }
+    if (lambda == T(0)) { return T(0); }
+
+    if (lambda < T(10)) {
+        const T limit = rExp(-lambda);
+        T product     = gen.uniform();
+        T k           = T(0);
+        while (product > limit && k < T(RANDOM_DIST_MAX_TRIALS)) {
+            product *= gen.uniform();
+            k += T(1);
+        }
+        return k;
+    }
+
+    const T sqrtLambda = rSqrt(lambda);
+    const T logLambda  = rLog(lambda);
+    const T b          = T(0.931) + T(2.53) * sqrtLambda;
+    const T a          = T(-0.059) + T(0.02483) * b;
+    const T invAlpha   = T(1.1239) + T(1.1328) / (b - T(3.4));
+    const T vr         = T(0.9277) - T(3.6224) / (b - T(2));
+    for (int trial = 0; trial < RANDOM_DIST_MAX_TRIALS; ++trial) {
+        const T u  = gen.uniform() - T(0.5);
+        const T v  = gen.uniform();
+        const T us = T(0.5) - rAbs(u);
+        const T k  = rFloor((T(2) * a / us + b) * u + lambda + T(0.43));
+        if (us >= T(0.07) && v <= vr) { return k; }
+        if (k < T(0) || (us < T(0.013) && v > us)) { continue; }
+        if (rLog(v) + rLog(invAlpha) - rLog(a / (us * us) + b) <=
+            -lambda + k * logLambda - rLgamma(k + T(1))) {
+            return k;
+        }
+    }
+    return rNaN<T>();
+}
+
+/// Samples the standard normal distribution truncated to [\p lower,
+/// \p upper] with the proposals of Robert (1995): normal values when the
+/// interval contains 0 and is wide, uniform values when it is narrow, and
+/// shifted exponential values in a tail. Tails below 0 are mirrored.
+template<typename T, typename G>
+__DH__ T sampleTruncatedNormal(G &gen, const T lower, const T upper) {
+    using namespace random;  // NOLINT
+    if (!(lower < upper)) { return rNaN<T>(); }
+
+    const bool mirror = upper <= T(0);
+    const T a         = mirror ? -upper : lower;
+    const T b         = mirror ? -lower : upper;
+    const T sign      = mirror ? T(-1) : T(1);
+    // sqrt(2 pi), the width above which normal proposals are accepted more
+    // often than uniform ones
+    const T wide = T(2.5066282746310002);
+
+    for (int trial = 0; trial < RANDOM_DIST_MAX_TRIALS; ++trial) {
+        if (a <= T(0)) {
+            if (b - a >= wide) {
+                const T z = gen.normal();
+                if (a <= z && z <= b) { return sign * z; }
+            } else {
+                const T z = a + (b - a) * gen.uniform();
+                if (gen.uniform() <= rExp(T(-0.5) * z * z)) {
+                    return sign * z;
+                }
+            }
+            continue;
+        }
+
+        const T root  = rSqrt(a * a + T(4));
+        const T alpha = T(0.5) * (a + root);
+        const T narrow =
+            a + T(2) / (a + root) * rExp(T(0.25) * (a * a - a * root) +
+                                         T(0.5));
+        if (b < narrow) {
+            const T z = a + (b - a) * gen.uniform();
+            if (gen.uniform() <= rExp(T(0.5) * (a * a - z * z))) {
+                return sign * z;
+            }
+        } else {
+            const T z = a - rLog(gen.uniform()) / alpha;
+            const T s = z - alpha;
+            if (z <= b && gen.uniform() <= rExp(T(-0.5) * s * s)) {
+                return sign * z;
+            }
+        }
+    }
+    return rNaN<T>();
+}
+
+/// Samples \p dist with the parameters \p param0 and \p param1 of an element.
+/// The distributions with one parameter ignore \p param1.
+template<typename T, typename G>
+__DH__ T sampleDistribution(G &gen, const AF_RANDOM_DIST dist, const T param0,
+                            const T param1) {
+    switch (dist) {
+        case AF_RANDOM_EXPONENTIAL: return sampleExponential(gen, param0);
+        case AF_RANDOM_GAMMA: return sampleGamma(gen, param0, param1);
+        case AF_RANDOM_POISSON: return samplePoisson(gen, param0);
+        case AF_RANDOM_TRUNCATED_NORMAL:
+            return sampleTruncatedNormal(gen, param0, param1);
+    }
+    return random::rNaN<T>();
+}
+
+}  // namespace common
@@ -0,0 +1,72 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Array.hpp>
+#include <copy.hpp>
+#include <types.hpp>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace common {
+
+/// The number of statistics of each region: the area, the first row and
+/// column and the last row and column of the bounding box
+constexpr dim_t REGION_STAT_COUNT = 5;
+
+/// The number of properties of each label computed by regionProps: the
+/// area, the centroid row and column, the first row and column and the last
+/// row and column of the bounding box, the raw moments M01, M10 and M11 and
+/// the central moments mu20, mu02 and mu11. The first index of a moment
+/// counts the rows.
+constexpr dim_t REGION_PROP_COUNT = 13;
+
+/// Computes the statistics of the regions labelled by regions on the host.
+/// Used by the backends which can not compute them while labelling.
+template<typename T>
+detail::Array<detail::uint> regionStats(const detail::Array<T> &labels) {
+    using detail::uint;
+
+    const af::dim4 dims = labels.dims();
+    std::vector<T> values(labels.elements());
+    detail::copyData(values.data(), labels);
+
+    // The labels are sequential, so the largest is the number of regions
+    const T maxLabel =
+        values.empty() ? T(0) : *std::max_element(values.begin(), values.end());
+    const dim_t count = static_cast<dim_t>(maxLabel);
+
+    std::vector<uint> stats(count * REGION_STAT_COUNT, 0);
+    for (dim_t j = 0; j < dims[1]; ++j) {
+        for (dim_t i = 0; i < dims[0]; ++i) {
+            const dim_t label = static_cast<dim_t>(values[j * dims[0] + i]);
+            if (label == 0) { continue; }
+
+            uint *s         = stats.data() + (label - 1) * REGION_STAT_COUNT;
+            const uint row  = static_cast<uint>(i);
+            const uint col  = static_cast<uint>(j);
+            if (s[0]++ == 0) {
+                s[1] = s[3] = row;
+                s[2] = s[4] = col;
+                continue;
+            }
+            s[1] = std::min(s[1], row);
+            s[2] = std::min(s[2], col);
+            s[3] = std::max(s[3], row);
+            s[4] = std::max(s[4], col);
+        }
+    }
+    return detail::createHostDataArray<uint>(af::dim4(REGION_STAT_COUNT, count),
+                                             stats.data());
+}
+
+}  // namespace common
@@ -0,0 +1,237 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/sparse_blocked.hpp>
+
+#include <backend.hpp>
+#include <common/dispatch.hpp>
+#include <common/sparse_helpers.hpp>
+#include <copy.hpp>
+#include <math.hpp>
+#include <types.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+using af::dim4;
+using detail::Array;
+using detail::cdouble;
+using detail::cfloat;
+using detail::copyData;
+using detail::createHostDataArray;
+using detail::scalar;
+using std::vector;
+
+namespace common {
+
+namespace {
+
+/// The indices and values of a sparse array on the host
+template<typename T>
+struct HostSparse {
+    vector<int> rowIdx;
+    vector<int> colIdx;
+    vector<T> values;
+
+    explicit HostSparse(const SparseArray<T> &in)
+        : rowIdx(in.getRowIdx().elements())
+        , colIdx(in.getColIdx().elements())
+        , values(in.getValues().elements()) {
+        copyData(rowIdx.data(), in.getRowIdx());
+        copyData(colIdx.data(), in.getColIdx());
+        copyData(values.data(), in.getValues());
+    }
+};
+
+template<typename T>
+SparseArray<T> createSparse(const dim4 &dims, const vector<T> &values,
+                            const vector<int> &rowIdx,
+                            const vector<int> &colIdx,
+                            const af::storage stype, const int blockSize) {
+    return createBlockedSparseArray<T>(
+        dims, createHostDataArray<T>(dim4(values.size()), values.data()),
+        createHostDataArray<int>(dim4(rowIdx.size()), rowIdx.data()),
+        createHostDataArray<int>(dim4(colIdx.size()), colIdx.data()), stype,
+        blockSize);
+}
+
+}  // namespace
+
+template<typename T>
+SparseArray<T> csrToBsr(const SparseArray<T> &in, const int blockSize) {
+    const int M  = in.dims()[0];
+    const int N  = in.dims()[1];
+    const int b  = blockSize;
+    const int Mb = divup(M, b);
+    const int Nb = divup(N, b);
+    const HostSparse<T> csr(in);
+
+    vector<int> rowIdx(Mb + 1, 0);
+    vector<int> colIdx;
+    vector<T> values;
+
+    // The block row each block column was last seen in, and its position in
+    // the block row
+    vector<int> marker(Nb, -1);
+    vector<int> position(Nb, 0);
+    vector<int> cols;
+    for (int br = 0; br < Mb; ++br) {
+        const int rowBegin = br * b;
+        const int rowEnd   = std::min(M, rowBegin + b);
+
+        cols.clear();
+        for (int row = rowBegin; row < rowEnd; ++row) {
+            for (int j = csr.rowIdx[row]; j < csr.rowIdx[row + 1]; ++j) {
+                const int bc = csr.colIdx[j] / b;
+                if (marker[bc] != br) {
+                    marker[bc] = br;
+                    cols.push_back(bc);
+                }
+            }
+        }
+        std::sort(cols.begin(), cols.end());
+
+        const int first = colIdx.size();
+        for (size_t i = 0; i < cols.size(); ++i) {
+            position[cols[i]] = first + i;
+            colIdx.push_back(cols[i]);
+        }
+        values.resize(colIdx.size() * b * b, scalar<T>(0));
+
+        // The values of a block are column major
+        for (int row = rowBegin; row < rowEnd; ++row) {
+            for (int j = csr.rowIdx[row]; j < csr.rowIdx[row + 1]; ++j) {
+                const int col = csr.colIdx[j];
+                values[position[col / b] * b * b + (col % b) * b + row % b] =
+                    csr.values[j];
+            }
+        }
+        rowIdx[br + 1] = colIdx.size();
+    }
+
+    return createSparse<T>(in.dims(), values, rowIdx, colIdx, AF_STORAGE_BSR,
+                           b);
+}
+
+template<typename T>
+SparseArray<T> csrToSell(const SparseArray<T> &in, const int sliceSize,
+                         const int sortWindow) {
+    const int M = in.dims()[0];
+    const int C = sliceSize;
+    const int S = divup(M, C);
+    const HostSparse<T> csr(in);
+
+    auto length = [&csr](int row) {
+        return csr.rowIdx[row + 1] - csr.rowIdx[row];
+    };
+
+    // The rows sorted by decreasing length in each window
+    vector<int> perm(M);
+    std::iota(perm.begin(), perm.end(), 0);
+    for (int w = 0; w < M; w += sortWindow) {
+        std::stable_sort(perm.begin() + w,
+                         perm.begin() + std::min(M, w + sortWindow),
+                         [&length](int a, int b) {
+                             return length(a) > length(b);
+                         });
+    }
+
+    // The slice offsets followed by the original row of each sorted row
+    vector<int> rowIdx(S + 1 + M, 0);
+    for (int s = 0; s < S; ++s) {
+        int width = 0;
+        for (int p = s * C; p < std::min(M, (s + 1) * C); ++p) {
+            width = std::max(width, length(perm[p]));
+        }
+        rowIdx[s + 1] = rowIdx[s] + width * C;
+    }
+    std::copy(perm.begin(), perm.end(), rowIdx.begin() + S + 1);
+
+    vector<int> colIdx(rowIdx[S], -1);
+    vector<T> values(rowIdx[S], scalar<T>(0));
+    for (int p = 0; p < M; ++p) {
+        const int s   = p / C;
+        const int r   = p % C;
+        const int row = perm[p];
+        for (int k = 0; k < length(row); ++k) {
+            const int idx = rowIdx[s] + k * C + r;
+            colIdx[idx]   = csr.colIdx[csr.rowIdx[row] + k];
+            values[idx]   = csr.values[csr.rowIdx[row] + k];
+        }
+    }
+
+    return createSparse<T>(in.dims(), values, rowIdx, colIdx, AF_STORAGE_SELL,
+                           C);
+}
+
+template<typename T>
+SparseArray<T> blockedToCsr(const SparseArray<T> &in) {
+    const int M = in.dims()[0];
+    const int N = in.dims()[1];
+    const int b = in.getBlockSize();
+    const HostSparse<T> blk(in);
+
+    vector<int> rowIdx(M + 1, 0);
+    vector<int> colIdx;
+    vector<T> values;
+
+    if (in.getStorage() == AF_STORAGE_BSR) {
+        for (int row = 0; row < M; ++row) {
+            const int br = row / b;
+            for (int i = blk.rowIdx[br]; i < blk.rowIdx[br + 1]; ++i) {
+                for (int jj = 0; jj < b; ++jj) {
+                    const int col = blk.colIdx[i] * b + jj;
+                    if (col >= N) { break; }
+                    colIdx.push_back(col);
+                    values.push_back(blk.values[i * b * b + jj * b + row % b]);
+                }
+            }
+            rowIdx[row + 1] = colIdx.size();
+        }
+    } else {
+        const int S     = divup(M, b);
+        const int *perm = blk.rowIdx.data() + S + 1;
+        vector<int> lanes(M);  // The sorted position of each row
+        for (int p = 0; p < M; ++p) { lanes[perm[p]] = p; }
+
+        for (int row = 0; row < M; ++row) {
+            const int s     = lanes[row] / b;
+            const int r     = lanes[row] % b;
+            const int width = (blk.rowIdx[s + 1] - blk.rowIdx[s]) / b;
+            for (int k = 0; k < width; ++k) {
+                const int idx = blk.rowIdx[s] + k * b + r;
+                if (blk.colIdx[idx] < 0) { break; }
+                colIdx.push_back(blk.colIdx[idx]);
+                values.push_back(blk.values[idx]);
+            }
+            rowIdx[row + 1] = colIdx.size();
+        }
+    }
+
+    return createSparse<T>(in.dims(), values, rowIdx, colIdx, AF_STORAGE_CSR,
+                           1);
+}
+
+#define INSTANTIATE(T)                                                      \
+    template SparseArray<T> csrToBsr<T>(const SparseArray<T> &in,           \
+                                        const int blockSize);               \
+    template SparseArray<T> csrToSell<T>(const SparseArray<T> &in,          \
+                                         const int sliceSize,               \
+                                         const int sortWindow);             \
+    template SparseArray<T> blockedToCsr<T>(const SparseArray<T> &in);
+
+INSTANTIATE(float)
+INSTANTIATE(double)
+INSTANTIATE(cfloat)
+INSTANTIATE(cdouble)
+
+#undef INSTANTIATE
+
+}  // namespace common
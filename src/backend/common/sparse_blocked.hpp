@@ -0,0 +1,35 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/SparseArray.hpp>
+
+namespace common {
+
+// The conversions between CSR and the blocked storage formats run on the
+// host. They prepare a matrix for many products, which run on the device.
+
+/// Converts the CSR array \p in to BSR with \p blockSize x \p blockSize
+/// blocks. The blocks on the last block row and column are padded with zeros.
+template<typename T>
+SparseArray<T> csrToBsr(const SparseArray<T> &in, const int blockSize);
+
+/// Converts the CSR array \p in to SELL-C-sigma with slices of \p sliceSize
+/// rows, after sorting the rows by length in windows of \p sortWindow rows
+template<typename T>
+SparseArray<T> csrToSell(const SparseArray<T> &in, const int sliceSize,
+                         const int sortWindow);
+
+/// Converts the BSR or SELL array \p in to CSR. The CSR array keeps the zeros
+/// of the blocks of a BSR array.
+template<typename T>
+SparseArray<T> blockedToCsr(const SparseArray<T> &in);
+
+}  // namespace common
@@ -46,6 +46,16 @@ SparseArray<T> createArrayDataSparseArray(const af::dim4 &_dims,
                                           const af::storage _storage,
                                           const bool _copy = false);
 
+/// Creates a BSR or SELL array of the blocked data of \p _values,
+/// \p _rowIdx and \p _colIdx
+template<typename T>
+SparseArray<T> createBlockedSparseArray(const af::dim4 &_dims,
+                                        const detail::Array<T> &_values,
+                                        const detail::Array<int> &_rowIdx,
+                                        const detail::Array<int> &_colIdx,
+                                        const af::storage _storage,
+                                        const int _blockSize);
+
 template<typename T>
 SparseArray<T> *initSparseArray();
 
@@ -0,0 +1,311 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/sparse_triangular.hpp>
+
+#include <backend.hpp>
+#include <common/err_common.hpp>
+#include <common/sparse_helpers.hpp>
+#include <copy.hpp>
+#include <types.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+using af::dim4;
+using detail::Array;
+using detail::cdouble;
+using detail::cfloat;
+using detail::copyData;
+using detail::createHostDataArray;
+using std::vector;
+
+namespace common {
+
+namespace {
+
+/// The type of the arithmetic on the host, which has the layout of T
+template<typename T>
+struct host_type {
+    using type = T;
+};
+
+template<>
+struct host_type<cfloat> {
+    using type = std::complex<float>;
+};
+
+template<>
+struct host_type<cdouble> {
+    using type = std::complex<double>;
+};
+
+template<typename T>
+T hostReal(T val) {
+    return val;
+}
+
+template<typename T>
+T hostReal(std::complex<T> val) {
+    return val.real();
+}
+
+template<typename T>
+T hostConj(T val) {
+    return val;
+}
+
+template<typename T>
+std::complex<T> hostConj(std::complex<T> val) {
+    return std::conj(val);
+}
+
+/// The indices and values of a CSR array on the host, with the columns of
+/// each row sorted
+template<typename T>
+struct SortedCsr {
+    using HT = typename host_type<T>::type;
+    static_assert(sizeof(HT) == sizeof(T), "Host type does not match T");
+
+    vector<int> rowIdx;
+    vector<int> colIdx;
+    vector<HT> values;
+
+    explicit SortedCsr(const SparseArray<T> &in)
+        : rowIdx(in.getRowIdx().elements())
+        , colIdx(in.getColIdx().elements())
+        , values(in.getValues().elements()) {
+        copyData(rowIdx.data(), in.getRowIdx());
+        copyData(colIdx.data(), in.getColIdx());
+        copyData(reinterpret_cast<T *>(values.data()), in.getValues());
+
+        vector<int> order;
+        vector<int> cols;
+        vector<HT> vals;
+        for (size_t row = 0; row + 1 < rowIdx.size(); ++row) {
+            const int begin = rowIdx[row];
+            const int end   = rowIdx[row + 1];
+            if (std::is_sorted(colIdx.begin() + begin,
+                               colIdx.begin() + end)) {
+                continue;
+            }
+            order.resize(end - begin);
+            std::iota(order.begin(), order.end(), begin);
+            std::sort(order.begin(), order.end(),
+                      [&](int a, int b) { return colIdx[a] < colIdx[b]; });
+            cols.clear();
+            vals.clear();
+            for (int j : order) {
+                cols.push_back(colIdx[j]);
+                vals.push_back(values[j]);
+            }
+            std::copy(cols.begin(), cols.end(), colIdx.begin() + begin);
+            std::copy(vals.begin(), vals.end(), values.begin() + begin);
+        }
+    }
+
+    /// Returns the position of the diagonal entry of each row
+    vector<int> diagonal() const {
+        const int M = rowIdx.size() - 1;
+        vector<int> diag(M);
+        for (int row = 0; row < M; ++row) {
+            auto first = colIdx.begin() + rowIdx[row];
+            auto last  = colIdx.begin() + rowIdx[row + 1];
+            auto it    = std::lower_bound(first, last, row);
+            if (it == last || *it != row) {
+                AF_ERROR("The incomplete factorizations need the diagonal",
+                         AF_ERR_ARG);
+            }
+            diag[row] = it - colIdx.begin();
+        }
+        return diag;
+    }
+};
+
+template<typename T, typename HT>
+SparseArray<T> createCsr(const dim4 &dims, const vector<HT> &values,
+                         const vector<int> &rowIdx,
+                         const vector<int> &colIdx) {
+    return createArrayDataSparseArray<T>(
+        dims,
+        createHostDataArray<T>(dim4(values.size()),
+                               reinterpret_cast<const T *>(values.data())),
+        createHostDataArray<int>(dim4(rowIdx.size()), rowIdx.data()),
+        createHostDataArray<int>(dim4(colIdx.size()), colIdx.data()),
+        AF_STORAGE_CSR);
+}
+
+}  // namespace
+
+template<typename T>
+std::shared_ptr<TriangularLevels> triangularLevels(const SparseArray<T> &in,
+                                                   const bool upper) {
+    const int M = in.dims()[0];
+    vector<int> rowIdx(in.getRowIdx().elements());
+    vector<int> colIdx(in.getColIdx().elements());
+    copyData(rowIdx.data(), in.getRowIdx());
+    copyData(colIdx.data(), in.getColIdx());
+
+    // The level of a row is one more than the level of the rows it needs
+    vector<int> level(M, 0);
+    int nLevels = 0;
+    for (int n = 0; n < M; ++n) {
+        const int row = upper ? M - 1 - n : n;
+        int lvl       = 0;
+        for (int j = rowIdx[row]; j < rowIdx[row + 1]; ++j) {
+            const int col = colIdx[j];
+            if (upper ? col > row : col < row) {
+                lvl = std::max(lvl, level[col] + 1);
+            }
+        }
+        level[row] = lvl;
+        nLevels    = std::max(nLevels, lvl + 1);
+    }
+
+    vector<int> offsets(nLevels + 1, 0);
+    for (int row = 0; row < M; ++row) { offsets[level[row] + 1]++; }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    vector<int> next(offsets.begin(), offsets.end() - 1);
+    vector<int> rows(M);
+    for (int row = 0; row < M; ++row) { rows[next[level[row]]++] = row; }
+    return std::make_shared<TriangularLevels>(
+        createHostDataArray<int>(dim4(M), rows.data()), std::move(offsets));
+}
+
+template<typename T>
+SparseArray<T> ilu0(const SparseArray<T> &in) {
+    const int M = in.dims()[0];
+    SortedCsr<T> a(in);
+    const vector<int> diag = a.diagonal();
+
+    // The position of each column of the current row, or -1
+    vector<int> pos(in.dims()[1], -1);
+    for (int i = 0; i < M; ++i) {
+        const int begin = a.rowIdx[i];
+        const int end   = a.rowIdx[i + 1];
+        for (int j = begin; j < end; ++j) { pos[a.colIdx[j]] = j; }
+
+        for (int j = begin; j < diag[i]; ++j) {
+            const int k = a.colIdx[j];
+            a.values[j] /= a.values[diag[k]];
+            for (int kk = diag[k] + 1; kk < a.rowIdx[k + 1]; ++kk) {
+                const int p = pos[a.colIdx[kk]];
+                if (p >= 0) { a.values[p] -= a.values[j] * a.values[kk]; }
+            }
+        }
+
+        for (int j = begin; j < end; ++j) { pos[a.colIdx[j]] = -1; }
+    }
+
+    return createCsr<T>(in.dims(), a.values, a.rowIdx, a.colIdx);
+}
+
+template<typename T>
+SparseArray<T> ic0(const SparseArray<T> &in) {
+    using HT    = typename SortedCsr<T>::HT;
+    const int M = in.dims()[0];
+    const SortedCsr<T> a(in);
+    const vector<int> diag = a.diagonal();
+
+    // The lower triangle, whose last entry of each row is the diagonal
+    vector<int> rowIdx(M + 1, 0);
+    vector<int> colIdx;
+    vector<HT> values;
+    for (int i = 0; i < M; ++i) {
+        colIdx.insert(colIdx.end(), a.colIdx.begin() + a.rowIdx[i],
+                      a.colIdx.begin() + diag[i] + 1);
+        values.insert(values.end(), a.values.begin() + a.rowIdx[i],
+                      a.values.begin() + diag[i] + 1);
+        rowIdx[i + 1] = colIdx.size();
+    }
+
+    // l_ik = (a_ik - sum_j<k l_ij * conj(l_kj)) / l_kk
+    vector<int> pos(M, -1);
+    for (int i = 0; i < M; ++i) {
+        const int begin = rowIdx[i];
+        const int last  = rowIdx[i + 1] - 1;
+        for (int j = begin; j <= last; ++j) { pos[colIdx[j]] = j; }
+
+        for (int j = begin; j < last; ++j) {
+            const int k = colIdx[j];
+            HT s        = values[j];
+            for (int kk = rowIdx[k]; kk < rowIdx[k + 1] - 1; ++kk) {
+                const int p = pos[colIdx[kk]];
+                if (p >= 0) { s -= values[p] * hostConj(values[kk]); }
+            }
+            values[j] = s / values[rowIdx[k + 1] - 1];
+        }
+
+        auto d = hostReal(values[last]);
+        for (int j = begin; j < last; ++j) {
+            d -= hostReal(values[j] * hostConj(values[j]));
+        }
+        if (!(d > 0)) {
+            AF_ERROR("The matrix is not positive definite", AF_ERR_ARG);
+        }
+        values[last] = HT(std::sqrt(d));
+
+        for (int j = begin; j <= last; ++j) { pos[colIdx[j]] = -1; }
+    }
+
+    // Each row is followed by its entries of the conjugate transpose, whose
+    // rows are in increasing order
+    vector<int> upperCount(M, 0);
+    for (int i = 0; i < M; ++i) {
+        for (int j = rowIdx[i]; j < rowIdx[i + 1] - 1; ++j) {
+            upperCount[colIdx[j]]++;
+        }
+    }
+    vector<int> outRowIdx(M + 1, 0);
+    for (int i = 0; i < M; ++i) {
+        outRowIdx[i + 1] =
+            outRowIdx[i] + (rowIdx[i + 1] - rowIdx[i]) + upperCount[i];
+    }
+
+    vector<int> outColIdx(outRowIdx[M]);
+    vector<HT> outValues(outRowIdx[M]);
+    vector<int> next(M);
+    for (int i = 0; i < M; ++i) {
+        const int count = rowIdx[i + 1] - rowIdx[i];
+        std::copy(colIdx.begin() + rowIdx[i], colIdx.begin() + rowIdx[i + 1],
+                  outColIdx.begin() + outRowIdx[i]);
+        std::copy(values.begin() + rowIdx[i], values.begin() + rowIdx[i + 1],
+                  outValues.begin() + outRowIdx[i]);
+        next[i] = outRowIdx[i] + count;
+    }
+    for (int i = 0; i < M; ++i) {
+        for (int j = rowIdx[i]; j < rowIdx[i + 1] - 1; ++j) {
+            const int p  = next[colIdx[j]]++;
+            outColIdx[p] = i;
+            outValues[p] = hostConj(values[j]);
+        }
+    }
+
+    return createCsr<T>(in.dims(), outValues, outRowIdx, outColIdx);
+}
+
+#define INSTANTIATE(T)                                                      \
+    template std::shared_ptr<TriangularLevels> triangularLevels<T>(         \
+        const SparseArray<T> &in, const bool upper);                        \
+    template SparseArray<T> ilu0<T>(const SparseArray<T> &in);              \
+    template SparseArray<T> ic0<T>(const SparseArray<T> &in);
+
+INSTANTIATE(float)
+INSTANTIATE(double)
+INSTANTIATE(cfloat)
+INSTANTIATE(cdouble)
+
+#undef INSTANTIATE
+
+}  // namespace common
@@ -0,0 +1,55 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/SparseArray.hpp>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace common {
+
+/// The rows of a triangle of a CSR matrix grouped in levels. The rows of a
+/// level only depend on the rows of the previous levels, so a triangular
+/// solve computes the rows of one level in parallel.
+struct TriangularLevels {
+    detail::Array<int> rows;   ///< The rows ordered by level
+    std::vector<int> offsets;  ///< The offset of each level in rows
+
+    TriangularLevels(detail::Array<int> rows_, std::vector<int> offsets_)
+        : rows(std::move(rows_)), offsets(std::move(offsets_)) {}
+};
+
+/// Returns the levels of the lower or the \p upper triangle of the CSR array
+/// \p in. The analysis runs on the host and is kept in the cache of the
+/// array by the backends which use it.
+template<typename T>
+std::shared_ptr<TriangularLevels> triangularLevels(const SparseArray<T> &in,
+                                                   const bool upper);
+
+// The incomplete factorizations run on the host. Their factors are used for
+// many triangular solves on the device.
+
+/// Returns the ILU(0) factorization of the square CSR array \p in. The
+/// strictly lower triangle of the result is L, whose diagonal is one, and
+/// the upper triangle is U. The result has the pattern of \p in with sorted
+/// columns.
+template<typename T>
+SparseArray<T> ilu0(const SparseArray<T> &in);
+
+/// Returns the IC(0) factorization of the lower triangle of the Hermitian
+/// positive definite CSR array \p in. The lower triangle of the result is L
+/// and the upper triangle is its conjugate transpose, so the preconditioner
+/// is applied with the same two triangular solves as ILU(0).
+template<typename T>
+SparseArray<T> ic0(const SparseArray<T> &in);
+
+}  // namespace common
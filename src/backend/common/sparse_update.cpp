@@ -0,0 +1,225 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/sparse_update.hpp>
+
+#include <backend.hpp>
+#include <common/err_common.hpp>
+#include <common/sparse_helpers.hpp>
+#include <copy.hpp>
+#include <types.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+using af::dim4;
+using detail::Array;
+using detail::cdouble;
+using detail::cfloat;
+using detail::copyData;
+using detail::createEmptyArray;
+using detail::createHostDataArray;
+using detail::createSubArray;
+using std::pair;
+using std::vector;
+
+namespace common {
+
+namespace {
+
+/// The entries of a batch sorted by row and then by column. Repeated entries
+/// keep the order of the batch.
+struct Batch {
+    vector<int> rows;
+    vector<int> cols;
+    vector<int> order;  ///< The position of each sorted entry in the batch
+
+    Batch(const dim4 &dims, const Array<int> &rowIdx,
+          const Array<int> &colIdx) {
+        const size_t n = rowIdx.elements();
+        vector<int> r(n), c(n);
+        copyData(r.data(), rowIdx);
+        copyData(c.data(), colIdx);
+        for (size_t i = 0; i < n; ++i) {
+            if (r[i] < 0 || r[i] >= dims[0] || c[i] < 0 || c[i] >= dims[1]) {
+                AF_ERROR("Sparse entry is outside of the array", AF_ERR_ARG);
+            }
+        }
+
+        order.resize(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return r[a] != r[b] ? r[a] < r[b] : c[a] < c[b];
+        });
+
+        rows.resize(n);
+        cols.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            rows[i] = r[order[i]];
+            cols[i] = c[order[i]];
+        }
+    }
+};
+
+/// The indices and values of a CSR array on the host
+template<typename T>
+struct HostCsr {
+    vector<int> rowIdx;
+    vector<int> colIdx;
+    vector<T> values;
+
+    explicit HostCsr(const SparseArray<T> &in)
+        : rowIdx(in.getRowIdx().elements())
+        , colIdx(in.getColIdx().elements())
+        , values(in.getValues().elements()) {
+        copyData(rowIdx.data(), in.getRowIdx());
+        copyData(colIdx.data(), in.getColIdx());
+        copyData(values.data(), in.getValues());
+    }
+};
+
+/// The number of elements allocated for \p nnz values or column indices
+dim_t updateCapacity(const dim_t nnz) {
+    dim_t capacity = 64;
+    while (capacity < nnz) { capacity += capacity / 2; }
+    return capacity;
+}
+
+/// Returns a view of the elements of \p data in a buffer of updateCapacity
+/// elements
+template<typename T>
+Array<T> createCapacityArray(vector<T> &data) {
+    const dim_t nnz = data.size();
+    if (nnz == 0) { return createEmptyArray<T>(dim4(0)); }
+
+    data.resize(updateCapacity(nnz));
+    const Array<T> buffer =
+        createHostDataArray<T>(dim4(data.size()), data.data());
+    return createSubArray<T>(buffer, {af_seq{0, double(nnz - 1), 1}});
+}
+
+template<typename T>
+SparseArray<T> createCsr(const dim4 &dims, vector<T> &values,
+                         const vector<int> &rowIdx, vector<int> &colIdx) {
+    return createArrayDataSparseArray<T>(
+        dims, createCapacityArray(values),
+        createHostDataArray<int>(dim4(rowIdx.size()), rowIdx.data()),
+        createCapacityArray(colIdx), AF_STORAGE_CSR);
+}
+
+}  // namespace
+
+template<typename T>
+SparseArray<T> csrInsert(const SparseArray<T> &in, const Array<T> &values,
+                         const Array<int> &rowIdx, const Array<int> &colIdx) {
+    const int M = in.dims()[0];
+    const Batch batch(in.dims(), rowIdx, colIdx);
+    const HostCsr<T> csr(in);
+    vector<T> batchValues(values.elements());
+    copyData(batchValues.data(), values);
+
+    vector<int> outRowIdx(M + 1, 0);
+    vector<int> outColIdx;
+    vector<T> outValues;
+    outColIdx.reserve(csr.colIdx.size() + batch.rows.size());
+    outValues.reserve(csr.colIdx.size() + batch.rows.size());
+
+    // The entries of a row which gets new entries, sorted by column with the
+    // new entries after the old ones
+    vector<pair<int, T>> entries;
+    size_t k = 0;
+    for (int row = 0; row < M; ++row) {
+        const int begin = csr.rowIdx[row];
+        const int end   = csr.rowIdx[row + 1];
+        if (k == batch.rows.size() || batch.rows[k] != row) {
+            outColIdx.insert(outColIdx.end(), csr.colIdx.begin() + begin,
+                             csr.colIdx.begin() + end);
+            outValues.insert(outValues.end(), csr.values.begin() + begin,
+                             csr.values.begin() + end);
+            outRowIdx[row + 1] = outColIdx.size();
+            continue;
+        }
+
+        entries.clear();
+        for (int j = begin; j < end; ++j) {
+            entries.emplace_back(csr.colIdx[j], csr.values[j]);
+        }
+        for (; k < batch.rows.size() && batch.rows[k] == row; ++k) {
+            entries.emplace_back(batch.cols[k], batchValues[batch.order[k]]);
+        }
+        std::stable_sort(entries.begin(), entries.end(),
+                         [](const pair<int, T> &a, const pair<int, T> &b) {
+                             return a.first < b.first;
+                         });
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (i + 1 < entries.size() &&
+                entries[i + 1].first == entries[i].first) {
+                continue;
+            }
+            outColIdx.push_back(entries[i].first);
+            outValues.push_back(entries[i].second);
+        }
+        outRowIdx[row + 1] = outColIdx.size();
+    }
+
+    return createCsr<T>(in.dims(), outValues, outRowIdx, outColIdx);
+}
+
+template<typename T>
+SparseArray<T> csrRemove(const SparseArray<T> &in, const Array<int> &rowIdx,
+                         const Array<int> &colIdx) {
+    const int M = in.dims()[0];
+    const Batch batch(in.dims(), rowIdx, colIdx);
+    const HostCsr<T> csr(in);
+
+    vector<int> outRowIdx(M + 1, 0);
+    vector<int> outColIdx;
+    vector<T> outValues;
+    outColIdx.reserve(csr.colIdx.size());
+    outValues.reserve(csr.colIdx.size());
+
+    size_t k = 0;
+    for (int row = 0; row < M; ++row) {
+        // The sorted columns removed from the row
+        const size_t first = k;
+        while (k < batch.rows.size() && batch.rows[k] == row) { ++k; }
+        const auto colsBegin = batch.cols.begin() + first;
+        const auto colsEnd   = batch.cols.begin() + k;
+
+        for (int j = csr.rowIdx[row]; j < csr.rowIdx[row + 1]; ++j) {
+            if (std::binary_search(colsBegin, colsEnd, csr.colIdx[j])) {
+                continue;
+            }
+            outColIdx.push_back(csr.colIdx[j]);
+            outValues.push_back(csr.values[j]);
+        }
+        outRowIdx[row + 1] = outColIdx.size();
+    }
+
+    return createCsr<T>(in.dims(), outValues, outRowIdx, outColIdx);
+}
+
+#define INSTANTIATE(T)                                                        \
+    template SparseArray<T> csrInsert<T>(                                     \
+        const SparseArray<T> &in, const Array<T> &values,                     \
+        const Array<int> &rowIdx, const Array<int> &colIdx);                  \
+    template SparseArray<T> csrRemove<T>(const SparseArray<T> &in,            \
+                                         const Array<int> &rowIdx,            \
+                                         const Array<int> &colIdx);
+
+INSTANTIATE(float)
+INSTANTIATE(double)
+INSTANTIATE(cfloat)
+INSTANTIATE(cdouble)
+
+#undef INSTANTIATE
+
+}  // namespace common
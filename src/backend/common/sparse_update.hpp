@@ -0,0 +1,37 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/SparseArray.hpp>
+
+namespace common {
+
+// The changes of the sparsity pattern of a CSR array run on the host. The
+// values and the column indices of the result are views of buffers with a
+// few spare elements, whose sizes grow geometrically, so the buffers freed by
+// one batch are reused by the memory manager for the next ones.
+
+/// Returns the CSR array \p in with the entries \p values at the rows
+/// \p rowIdx and the columns \p colIdx. The entries which are already in
+/// \p in are overwritten, and the last of repeated entries is kept.
+template<typename T>
+SparseArray<T> csrInsert(const SparseArray<T> &in,
+                         const detail::Array<T> &values,
+                         const detail::Array<int> &rowIdx,
+                         const detail::Array<int> &colIdx);
+
+/// Returns the CSR array \p in without the entries at the rows \p rowIdx and
+/// the columns \p colIdx. The entries which are not in \p in are ignored.
+template<typename T>
+SparseArray<T> csrRemove(const SparseArray<T> &in,
+                         const detail::Array<int> &rowIdx,
+                         const detail::Array<int> &colIdx);
+
+}  // namespace common
@@ -0,0 +1,80 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <backend.hpp>
+#include <types.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+namespace common {
+
+/// The statistics of all the values of an array, computed in one pass by
+/// summary_all
+struct Summary {
+    double min;    ///< The smallest value, ignoring NaN values
+    double max;    ///< The largest value, ignoring NaN values
+    double sum;    ///< The sum of the values
+    double sumsq;  ///< The sum of the squares of the values
+    double count;  ///< The number of nonzero values
+};
+
+/// The type in which the sums of values of type T are accumulated. Like the
+/// variance, only double and 64 bit integers are summed in double precision.
+template<typename T>
+using summary_sum_t =
+    typename std::conditional<std::is_same<T, double>::value ||
+                                  std::is_same<T, detail::intl>::value ||
+                                  std::is_same<T, detail::uintl>::value,
+                              double, float>::type;
+
+/// The initial minimum of values of type T, which is larger than all of them
+template<typename T>
+T summaryMinInit() {
+    return std::numeric_limits<T>::has_infinity
+               ? std::numeric_limits<T>::infinity()
+               : std::numeric_limits<T>::max();
+}
+
+/// The initial maximum of values of type T, which is smaller than all of them
+template<typename T>
+T summaryMaxInit() {
+    return std::numeric_limits<T>::has_infinity
+               ? -std::numeric_limits<T>::infinity()
+               : std::numeric_limits<T>::lowest();
+}
+
+/// Combines the statistics of the \p parts parts of an array, which the
+/// backends reduce in parallel. The parts without values hold the initial
+/// value of each statistic, so the statistics of an empty array are the
+/// initial values.
+template<typename T>
+Summary combineSummaries(const T *mins, const T *maxs,
+                         const summary_sum_t<T> *sums,
+                         const summary_sum_t<T> *sumsqs,
+                         const detail::uint *counts, const dim_t parts) {
+    T min       = summaryMinInit<T>();
+    T max       = summaryMaxInit<T>();
+    Summary out = {0, 0, 0, 0, 0};
+    for (dim_t p = 0; p < parts; ++p) {
+        min = std::min(min, mins[p]);
+        max = std::max(max, maxs[p]);
+        out.sum += static_cast<double>(sums[p]);
+        out.sumsq += static_cast<double>(sumsqs[p]);
+        out.count += static_cast<double>(counts[p]);
+    }
+    out.min = static_cast<double>(min);
+    out.max = static_cast<double>(max);
+    return out;
+}
+
+}  // namespace common
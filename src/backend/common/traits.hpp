@@ -16,6 +16,7 @@ struct dtype_traits;
 }
 
 namespace common {
+class bfloat16;
 class half;
 }
 
@@ -26,4 +27,13 @@ struct dtype_traits<common::half> {
     typedef common::half base_type;
     static const char* getName() { return "half"; }
 };
+
+/// The kernels which only move values read the bfloat16 values as ushort. The
+/// other kernels convert the ushort values to and from float.
+template<>
+struct dtype_traits<common::bfloat16> {
+    enum { af_type = bf16, ctype = bf16 };
+    typedef common::bfloat16 base_type;
+    static const char* getName() { return "ushort"; }
+};
 }  // namespace af
@@ -215,13 +215,13 @@ string makeTempFilename() {
                                               std::to_string(fileCount)));
 }
 
-std::size_t deterministicHash(const void* data, std::size_t byteSize) {
+std::size_t deterministicHash(const void* data, std::size_t byteSize,
+                              std::size_t prevHash) {
     // Fowler-Noll-Vo "1a" 32 bit hash
     // https://en.wikipedia.org/wiki/Fowler-Noll-Vo_hash_function
-    constexpr std::size_t seed  = 0x811C9DC5;
     constexpr std::size_t prime = 0x01000193;
     const auto* byteData        = static_cast<const std::uint8_t*>(data);
-    return std::accumulate(byteData, byteData + byteSize, seed,
+    return std::accumulate(byteData, byteData + byteSize, prevHash,
                            [&](std::size_t hash, std::uint8_t data) {
                                return (hash ^ data) * prime;
                            });
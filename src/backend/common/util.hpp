@@ -51,9 +51,12 @@ std::string makeTempFilename();
 ///
 /// \param[in] data Binary data to hash
 /// \param[in] byteSize Size of the data in bytes
+/// \param[in] prevHash The hash of the preceding data. This continues the
+///                     hash of non-contiguous data.
 ///
 /// \returns An unsigned integer representing the hash of the data
-std::size_t deterministicHash(const void* data, std::size_t byteSize);
+std::size_t deterministicHash(const void* data, std::size_t byteSize,
+                              std::size_t prevHash = 0x811C9DC5);
 
 // This is just a wrapper around the above function.
 std::size_t deterministicHash(const std::string& data);
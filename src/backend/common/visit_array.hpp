@@ -0,0 +1,77 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Array.hpp>
+#include <backend.hpp>
+#include <common/bfloat16.hpp>
+#include <common/err_common.hpp>
+#include <common/half.hpp>
+#include <types.hpp>
+#include <af/defines.h>
+
+#include <type_traits>
+
+namespace common {
+
+/// The element type of a detail::Array, which is used by the functions
+/// called by visitArray
+template<typename ArrayType>
+struct array_value;
+
+template<typename T>
+struct array_value<detail::Array<T>> {
+    using type = T;
+};
+
+template<typename ArrayType>
+using array_value_t = typename array_value<std::decay_t<ArrayType>>::type;
+
+/// Calls \p func with the detail::Array<T> pointed to by \p array, where T
+/// is the element type of \p type. It is used by the backends to handle
+/// arrays of different types together, like the outputs of a kernel.
+template<typename Func>
+void visitArray(const af::dtype type, void *array, Func &&func) {
+    switch (type) {
+        case f32: func(*static_cast<detail::Array<float> *>(array)); break;
+        case f64: func(*static_cast<detail::Array<double> *>(array)); break;
+        case c32:
+            func(*static_cast<detail::Array<detail::cfloat> *>(array));
+            break;
+        case c64:
+            func(*static_cast<detail::Array<detail::cdouble> *>(array));
+            break;
+        case s32: func(*static_cast<detail::Array<int> *>(array)); break;
+        case u32:
+            func(*static_cast<detail::Array<detail::uint> *>(array));
+            break;
+        case u8:
+            func(*static_cast<detail::Array<detail::uchar> *>(array));
+            break;
+        case b8: func(*static_cast<detail::Array<char> *>(array)); break;
+        case s64:
+            func(*static_cast<detail::Array<detail::intl> *>(array));
+            break;
+        case u64:
+            func(*static_cast<detail::Array<detail::uintl> *>(array));
+            break;
+        case s16: func(*static_cast<detail::Array<short> *>(array)); break;
+        case u16:
+            func(*static_cast<detail::Array<detail::ushort> *>(array));
+            break;
+        case f16: func(*static_cast<detail::Array<half> *>(array)); break;
+        case bf16:
+            func(*static_cast<detail::Array<bfloat16> *>(array));
+            break;
+        default: TYPE_ERROR(0, type);
+    }
+}
+
+}  // namespace common
@@ -12,10 +12,15 @@
 
 #include <Param.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/ExternalRelease.hpp>
+#include <common/bfloat16.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
+#include <common/jit/JitHeuristics.hpp>
+#include <common/jit/JitStats.hpp>
 #include <common/jit/NodeIterator.hpp>
 #include <common/traits.hpp>
+#include <common/visit_array.hpp>
 #include <copy.hpp>
 #include <jit/BufferNode.hpp>
 #include <jit/Node.hpp>
@@ -37,23 +42,40 @@
 #include <utility>
 
 using af::dim4;
+using common::array_value_t;
+using common::bfloat16;
+using common::callJitHeuristic;
+using common::getJitTreeInfo;
 using common::half;
+using common::hasJitHeuristic;
+using common::isExternal;
 using common::Node;
 using common::Node_map_t;
 using common::Node_ptr;
 using common::NodeIterator;
+using common::recordJitEval;
+using common::visitArray;
 using cpu::jit::BufferNode;
 using std::adjacent_find;
 using std::copy;
 using std::is_standard_layout;
 using std::move;
+using std::pair;
 using std::vector;
 
 namespace cpu {
 
 template<typename T>
 Node_ptr bufferNodePtr() {
-    return Node_ptr(reinterpret_cast<Node *>(new BufferNode<T>()));
+    return common::makePooled<BufferNode<T>>();
+}
+
+/// Allocates the data of an evaluated array. The control block of the
+/// shared pointer is allocated from the block cache.
+template<typename T>
+shared_ptr<T> allocData(const dim_t elements) {
+    return shared_ptr<T>(memAlloc<T>(elements).release(), memFree<T>,
+                         common::PoolAllocator<T>());
 }
 
 template<typename T>
@@ -104,6 +126,27 @@ Array<T>::Array(const af::dim4 &dims, Node_ptr n)
     , ready(false)
     , owner(true) {}
 
+template<typename T>
+Array<T>::Array(const dim4 &dims, shared_ptr<T> in_data)
+    : info(getActiveDeviceId(), dims, 0, calcStrides(dims),
+           static_cast<af_dtype>(dtype_traits<T>::af_type))
+    , data(move(in_data))
+    , data_dims(dims)
+    , node(bufferNodePtr<T>())
+    , ready(true)
+    , owner(true) {}
+
+template<typename T>
+Array<T>::Array(const dim4 &dims, const dim4 &strides, dim_t offset_,
+                shared_ptr<T> in_data)
+    : info(getActiveDeviceId(), dims, offset_, strides,
+           static_cast<af_dtype>(dtype_traits<T>::af_type))
+    , data(move(in_data))
+    , data_dims(dims)
+    , node(bufferNodePtr<T>())
+    , ready(true)
+    , owner(true) {}
+
 template<typename T>
 Array<T>::Array(const Array<T> &parent, const dim4 &dims, const dim_t &offset_,
                 const dim4 &strides)
@@ -133,6 +176,34 @@ Array<T>::Array(const dim4 &dims, const dim4 &strides, dim_t offset_,
     }
 }
 
+/// Returns the buffer of a node in the tree of \p root which the evaluation
+/// of the tree can overwrite, or nullptr if there is none.
+///
+/// The tree reads each element of a linear buffer with the dimensions of
+/// the output at the index it writes, so the output can be written in place
+/// when no other array or tree reads the buffer.
+template<typename T>
+shared_ptr<T> getReusableBuffer(const Node_ptr &root, const dim4 &dims) {
+    if (root.use_count() > 1 || !root->hasExclusiveChildren()) {
+        return nullptr;
+    }
+
+    dim_t odims[4] = {dims[0], dims[1], dims[2], dims[3]};
+    for (NodeIterator<> it(root.get()), end; it != end; ++it) {
+        if (!it->isBuffer() ||
+            it->getType() != static_cast<af::dtype>(dtype_traits<T>::af_type)) {
+            continue;
+        }
+        const auto &buffer        = static_cast<const BufferNode<T> &>(*it);
+        const shared_ptr<T> &data = buffer.getData();
+        if (data.use_count() == 1 && !isExternal(data) &&
+            buffer.getOffset() == 0 && buffer.isLinear(odims)) {
+            return data;
+        }
+    }
+    return nullptr;
+}
+
 template<typename T>
 void Array<T>::eval() {
     if (isReady()) { return; }
@@ -142,8 +213,12 @@ void Array<T>::eval() {
 
     this->setId(getActiveDeviceId());
 
-    data = shared_ptr<T>(memAlloc<T>(elements()).release(), memFree<T>);
+    data = getReusableBuffer<T>(node, dims());
+    if (!data) { data = allocData<T>(elements()); }
 
+    // The reason is only known on the calling thread, so the evaluation is
+    // counted before it is enqueued
+    recordJitEval(getActiveDeviceId());
     getQueue().enqueue(kernel::evalArray<T>, *this, this->node);
     // Reset shared_ptr
     this->node = bufferNodePtr<T>();
@@ -190,8 +265,7 @@ void evalMultiple(vector<Array<T> *> array_ptrs) {
         if (array->ready) { continue; }
 
         array->setId(getActiveDeviceId());
-        array->data =
-            shared_ptr<T>(memAlloc<T>(array->elements()).release(), memFree<T>);
+        array->data = allocData<T>(array->elements());
 
         outputs.push_back(array);
         params.push_back(*array);
@@ -199,6 +273,7 @@ void evalMultiple(vector<Array<T> *> array_ptrs) {
     }
 
     if (!outputs.empty()) {
+        recordJitEval(getActiveDeviceId());
         getQueue().enqueue(kernel::evalMultiple<T>, params, nodes);
         for (Array<T> *array : outputs) {
             array->ready = true;
@@ -207,6 +282,45 @@ void evalMultiple(vector<Array<T> *> array_ptrs) {
     }
 }
 
+void evalMultiple(const vector<pair<af::dtype, void *>> &arrays) {
+    vector<kernel::JitOutput> outputs;
+    vector<Node_ptr> nodes;
+    vector<pair<af::dtype, void *>> output_arrays;
+    dim4 odims;
+    dim4 ostrs;
+    if (getQueue().is_worker()) {
+        AF_ERROR("Array not evaluated", AF_ERR_INTERNAL);
+    }
+
+    for (const auto &array : arrays) {
+        visitArray(array.first, array.second, [&](auto &arr) {
+            using T = array_value_t<decltype(arr)>;
+            if (arr.ready) { return; }
+
+            arr.setId(getActiveDeviceId());
+            arr.data  = allocData<T>(arr.elements());
+            arr.ready = true;
+
+            Param<T> param = arr;
+            odims          = param.dims();
+            ostrs          = param.strides();
+            outputs.push_back(kernel::jitOutput(param));
+            output_arrays.push_back(array);
+            nodes.push_back(arr.node);
+        });
+    }
+
+    if (!outputs.empty()) {
+        recordJitEval(getActiveDeviceId());
+        getQueue().enqueue(kernel::evalOutputs, outputs, odims, ostrs, nodes);
+        for (const auto &array : output_arrays) {
+            visitArray(array.first, array.second, [](auto &arr) {
+                arr.node = bufferNodePtr<array_value_t<decltype(arr)>>();
+            });
+        }
+    }
+}
+
 template<typename T>
 Node_ptr Array<T>::getNode() {
     if (node->isBuffer()) {
@@ -234,10 +348,21 @@ Array<T> createDeviceDataArray(const dim4 &dims, void *data) {
     return Array<T>(dims, static_cast<T *>(data), true);
 }
 
+template<typename T>
+Array<T> createSharedDataArray(const dim4 &dims, shared_ptr<T> data) {
+    return Array<T>(dims, move(data));
+}
+
+template<typename T>
+Array<T> createSharedDataArray(const dim4 &dims, const dim4 &strides,
+                               dim_t offset, shared_ptr<T> data) {
+    return Array<T>(dims, strides, offset, move(data));
+}
+
 template<typename T>
 Array<T> createValueArray(const dim4 &dims, const T &value) {
-    auto *node = new jit::ScalarNode<T>(value);
-    return createNodeArray<T>(dims, Node_ptr(node));
+    return createNodeArray<T>(dims,
+                              common::makePooled<jit::ScalarNode<T>>(value));
 }
 
 template<typename T>
@@ -248,6 +373,14 @@ Array<T> createEmptyArray(const dim4 &dims) {
 template<typename T>
 kJITHeuristics passesJitHeuristics(Node *root_node) {
     if (!evalFlag()) { return kJITHeuristics::Pass; }
+    if (hasJitHeuristic()) {
+        // The parameters of the CPU kernels are not limited
+        af_jit_tree_info info = getJitTreeInfo(root_node, sizeof(Param<T>));
+        info.max_height       = static_cast<int>(getMaxJitSize());
+        info.exceeds_memory_pressure =
+            jitTreeExceedsMemoryPressure(info.buffer_bytes);
+        return callJitHeuristic(info);
+    }
     if (root_node->getHeight() >= static_cast<int>(getMaxJitSize())) {
         return kJITHeuristics::TreeHeight;
     }
@@ -271,9 +404,23 @@ kJITHeuristics passesJitHeuristics(Node *root_node) {
     return kJITHeuristics::Pass;
 }
 
+/// Replaces a node whose children are all scalars with a scalar node which
+/// holds the value of the node. This folds constant subexpressions once when
+/// they are created instead of computing them for every element.
+template<typename T>
+Node_ptr foldScalarChildren(Node_ptr node) {
+    if (!node->hasOnlyScalarChildren()) { return node; }
+
+    // The values of the scalar children are stored in all the lanes of the
+    // children, so computing a single lane gives the value of the node
+    auto *tnode = reinterpret_cast<TNode<compute_t<T>> *>(node.get());
+    tnode->calc(0, 1);
+    return common::makePooled<jit::ScalarNode<compute_t<T>>>(tnode->m_val[0]);
+}
+
 template<typename T>
 Array<T> createNodeArray(const dim4 &dims, Node_ptr node) {
-    Array<T> out = Array<T>(dims, node);
+    Array<T> out = Array<T>(dims, foldScalarChildren<T>(std::move(node)));
     return out;
 }
 
@@ -282,18 +429,12 @@ Array<T> createSubArray(const Array<T> &parent, const vector<af_seq> &index,
                         bool copy) {
     parent.eval();
 
-    dim4 dDims          = parent.getDataDims();
-    dim4 dStrides       = calcStrides(dDims);
-    dim4 parent_strides = parent.strides();
-
-    if (dStrides != parent_strides) {
-        const Array<T> parentCopy = copyArray(parent);
-        return createSubArray(parentCopy, index, copy);
-    }
-
-    const dim4 &pDims = parent.dims();
-    dim4 dims         = toDims(index, pDims);
-    dim4 strides      = toStride(index, dDims);
+    // The strides of the parent are scaled, so the views of views share the
+    // buffer of the parent instead of a linearized copy of it
+    const dim4 &parent_strides = parent.strides();
+    const dim4 &pDims          = parent.dims();
+    dim4 dims                  = toDims(index, pDims);
+    dim4 strides               = toViewStride(index, parent_strides);
 
     // Find total offsets after indexing
     dim4 offsets = toOffset(index, pDims);
@@ -318,12 +459,12 @@ void destroyArray(Array<T> *A) {
 
 template<typename T>
 void writeHostDataArray(Array<T> &arr, const T *const data,
-                        const size_t bytes) {
+                        const size_t bytes, const size_t offset) {
     if (!arr.isOwner()) { arr = copyArray<T>(arr); }
     arr.eval();
     // Ensure the memory being written to isnt used anywhere else.
     getQueue().sync();
-    memcpy(arr.get(), data, bytes);
+    memcpy(reinterpret_cast<char *>(arr.get()) + offset, data, bytes);
 }
 
 template<typename T>
@@ -344,6 +485,11 @@ void Array<T>::setDataDims(const dim4 &new_dims) {
     template Array<T> createHostDataArray<T>(const dim4 &dims,                \
                                              const T *const data);            \
     template Array<T> createDeviceDataArray<T>(const dim4 &dims, void *data); \
+    template Array<T> createSharedDataArray<T>(const dim4 &dims,              \
+                                               shared_ptr<T> data);           \
+    template Array<T> createSharedDataArray<T>(                               \
+        const dim4 &dims, const dim4 &strides, dim_t offset,                  \
+        shared_ptr<T> data);                                                  \
     template Array<T> createValueArray<T>(const dim4 &dims, const T &value);  \
     template Array<T> createEmptyArray<T>(const dim4 &dims);                  \
     template Array<T> createSubArray<T>(                                      \
@@ -360,7 +506,8 @@ void Array<T>::setDataDims(const dim4 &new_dims) {
     template Node_ptr Array<T>::getNode();                                    \
     template Node_ptr Array<T>::getNode() const;                              \
     template void writeHostDataArray<T>(Array<T> & arr, const T *const data,  \
-                                        const size_t bytes);                  \
+                                        const size_t bytes,                   \
+                                        const size_t offset);                 \
     template void writeDeviceDataArray<T>(                                    \
         Array<T> & arr, const void *const data, const size_t bytes);          \
     template void evalMultiple<T>(vector<Array<T> *> arrays);                 \
@@ -379,5 +526,6 @@ INSTANTIATE(uintl)
 INSTANTIATE(short)
 INSTANTIATE(ushort)
 INSTANTIATE(half)
+INSTANTIATE(bfloat16)
 
 }  // namespace cpu
@@ -13,6 +13,7 @@
 #include <Param.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/MemoryManagerBase.hpp>
+#include <common/PoolAllocator.hpp>
 #include <common/jit/Node.hpp>
 #include <jit/Node.hpp>
 #include <memory.hpp>
@@ -24,6 +25,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace cpu {
@@ -46,6 +48,10 @@ using std::shared_ptr;
 template<typename T>
 void evalMultiple(std::vector<Array<T> *> array_ptrs);
 
+/// Evaluates arrays of different types with the same dimensions. Each
+/// element of \p arrays is the type of an array and a pointer to its Array.
+void evalMultiple(const std::vector<std::pair<af::dtype, void *>> &arrays);
+
 // Creates a new Array object on the heap and returns a reference to it.
 template<typename T>
 Array<T> createNodeArray(const af::dim4 &dims, common::Node_ptr node);
@@ -63,6 +69,20 @@ Array<T> createHostDataArray(const af::dim4 &dims, const T *const data);
 template<typename T>
 Array<T> createDeviceDataArray(const af::dim4 &dims, void *data);
 
+/// Creates an array which uses \p data as its buffer without copying it
+///
+/// The array keeps a reference to \p data. The memory is released by the
+/// deleter of \p data once the array and all the arrays which share its
+/// buffer are destroyed.
+template<typename T>
+Array<T> createSharedDataArray(const af::dim4 &dims, std::shared_ptr<T> data);
+
+/// Creates an array with \p strides and \p offset which uses \p data as its
+/// buffer without copying it, as createSharedDataArray does
+template<typename T>
+Array<T> createSharedDataArray(const af::dim4 &dims, const af::dim4 &strides,
+                               dim_t offset, std::shared_ptr<T> data);
+
 template<typename T>
 Array<T> createStridedArray(af::dim4 dims, af::dim4 strides, dim_t offset,
                             T *const in_data, bool is_device) {
@@ -70,8 +90,11 @@ Array<T> createStridedArray(af::dim4 dims, af::dim4 strides, dim_t offset,
 }
 
 /// Copies data to an existing Array object from a host pointer
+///
+/// \p bytes bytes are written starting \p offset bytes into the array
 template<typename T>
-void writeHostDataArray(Array<T> &arr, const T *const data, const size_t bytes);
+void writeHostDataArray(Array<T> &arr, const T *const data, const size_t bytes,
+                        const size_t offset = 0);
 
 /// Copies data to an existing Array object from a device pointer
 template<typename T>
@@ -84,6 +107,14 @@ void writeDeviceDataArray(Array<T> &arr, const void *const data,
 template<typename T>
 Array<T> createEmptyArray(const af::dim4 &dims);
 
+/// Creates a view of \p parent without copying its data. The views of views
+/// share the buffer of the first parent.
+///
+/// \param[in] parent The array to index
+/// \param[in] index  The sequences of the view along each dimension
+/// \param[in] copy   False if the caller handles any strides. If true, views
+///                   with non contiguous columns or negative strides are
+///                   copied into a linear array.
 template<typename T>
 Array<T> createSubArray(const Array<T> &parent,
                         const std::vector<af_seq> &index, bool copy = true);
@@ -130,10 +161,17 @@ class Array {
     Array(const Array<T> &parent, const dim4 &dims, const dim_t &offset,
           const dim4 &stride);
     explicit Array(const af::dim4 &dims, common::Node_ptr n);
+    Array(const af::dim4 &dims, std::shared_ptr<T> in_data);
+    Array(const af::dim4 &dims, const af::dim4 &strides, dim_t offset,
+          std::shared_ptr<T> in_data);
     Array(const af::dim4 &dims, const af::dim4 &strides, dim_t offset,
           T *const in_data, bool is_device = false);
 
    public:
+    // The handles of the arrays are created and destroyed by every call of
+    // the API, so they are allocated from the block cache of the thread
+    AF_POOL_ALLOCATED
+
     Array<T>(const Array<T> &other) = default;
     Array<T>(Array<T> &&other)      = default;
 
@@ -249,11 +287,19 @@ class Array {
     common::Node_ptr getNode();
 
     friend void evalMultiple<T>(std::vector<Array<T> *> arrays);
+    friend void evalMultiple(
+        const std::vector<std::pair<af::dtype, void *>> &arrays);
 
     friend Array<T> createValueArray<T>(const af::dim4 &dims, const T &value);
     friend Array<T> createHostDataArray<T>(const af::dim4 &dims,
                                            const T *const data);
     friend Array<T> createDeviceDataArray<T>(const af::dim4 &dims, void *data);
+    friend Array<T> createSharedDataArray<T>(const af::dim4 &dims,
+                                             std::shared_ptr<T> data);
+    friend Array<T> createSharedDataArray<T>(const af::dim4 &dims,
+                                             const af::dim4 &strides,
+                                             dim_t offset,
+                                             std::shared_ptr<T> data);
     friend Array<T> createStridedArray<T>(af::dim4 dims, af::dim4 strides,
                                           dim_t offset, T *const in_data,
                                           bool is_device);
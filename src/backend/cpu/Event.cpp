@@ -67,4 +67,28 @@ af_event createAndMarkEvent() {
     return handle;
 }
 
+af_event createTimingEvent() {
+    auto e = make_unique<Event>();
+    getQueue();
+    if (e->createTiming() != 0) {
+        AF_ERROR("Could not create event", AF_ERR_RUNTIME);
+    }
+    Event& ref = *e.release();
+    return getHandle(ref);
+}
+
+float elapsedTime(af_event start, af_event end) {
+    float ms = 0.f;
+    if (getEvent(end).elapsed(&ms, getEvent(start)) != 0) {
+        AF_ERROR("Could not measure the time between the events", AF_ERR_ARG);
+    }
+    return ms;
+}
+
+// The buffers of the other libraries are written by the host, so there is
+// nothing to wait for. Their readers on the host wait for the active queue.
+void waitForNativeQueue(void* /*queue*/) {}
+
+void signalNativeQueue(void* /*queue*/) { getQueue().sync(); }
+
 }  // namespace cpu
@@ -26,6 +26,15 @@ class CPUEventPolicy {
         return e->create();
     }
 
+    static int createTimingEvent(queue_event *e) noexcept {
+        return e->createTiming();
+    }
+
+    static int elapsedTime(float *ms, queue_event *start,
+                           queue_event *end) noexcept {
+        return end->elapsed(ms, *start);
+    }
+
     static int markEvent(queue_event *e, cpu::queue &stream) noexcept {
         return e->mark(stream);
     }
@@ -57,4 +66,19 @@ void block(af_event eventHandle);
 
 af_event createAndMarkEvent();
 
+/// \brief Creates an event which can be timed with elapsedTime
+af_event createTimingEvent();
+
+/// \brief Returns the milliseconds between the completion of two timing
+///        events
+float elapsedTime(af_event start, af_event end);
+
+/// \brief Makes the active queue wait for the work enqueued so far on the
+///        native \p queue of another library
+void waitForNativeQueue(void *queue);
+
+/// \brief Makes the native \p queue of another library wait for the work
+///        enqueued so far on the active queue
+void signalNativeQueue(void *queue);
+
 }  // namespace cpu
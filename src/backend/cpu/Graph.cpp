@@ -0,0 +1,70 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Graph.hpp>
+
+#include <common/GraphCapture.hpp>
+#include <common/MemoryManagerBase.hpp>
+#include <common/err_common.hpp>
+#include <platform.hpp>
+#include <queue.hpp>
+
+#include <memory>
+
+using common::beginGraphCapture;
+using common::endGraphCapture;
+using common::isCapturingGraph;
+using std::unique_ptr;
+
+namespace cpu {
+
+Graph::~Graph() {
+    for (void *ptr : buffers) { memoryManager().unlock(ptr, false); }
+}
+
+void beginCapture() {
+    const int device = static_cast<int>(getActiveDeviceId());
+    beginGraphCapture(device);
+    getQueue(device).beginCapture();
+}
+
+af_graph endCapture() {
+    const int device = static_cast<int>(getActiveDeviceId());
+    unique_ptr<Graph> graph(new Graph());
+    graph->device  = device;
+    graph->buffers = endGraphCapture(device);
+    graph->tasks   = getQueue(device).endCapture();
+    return static_cast<af_graph>(graph.release());
+}
+
+void replayGraph(const af_graph graph) {
+    const Graph &g = *static_cast<const Graph *>(graph);
+    if (g.device != static_cast<int>(getActiveDeviceId())) {
+        AF_ERROR("The graph was not captured on the active device",
+                 AF_ERR_DEVICE);
+    }
+    if (isCapturingGraph(g.device)) {
+        AF_ERROR("A graph can not be replayed during a capture",
+                 AF_ERR_NOT_SUPPORTED);
+    }
+    getQueue(g.device).replay(g.tasks);
+}
+
+void releaseGraph(af_graph graph) {
+    // The replays still running use the buffers of the graph
+    Graph *g = static_cast<Graph *>(graph);
+    getQueue(g->device).sync();
+    delete g;
+}
+
+bool isCapturing() {
+    return isCapturingGraph(static_cast<int>(getActiveDeviceId()));
+}
+
+}  // namespace cpu
@@ -0,0 +1,46 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+#pragma once
+
+#include <af/graph.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace cpu {
+
+/// The tasks recorded from the queue of a device and the buffers they use
+/// which were freed during the capture
+struct Graph {
+    int device;
+    std::shared_ptr<const std::vector<std::function<void()>>> tasks;
+    std::vector<void *> buffers;
+
+    Graph()                         = default;
+    Graph(const Graph &)            = delete;
+    Graph &operator=(const Graph &) = delete;
+    ~Graph();
+};
+
+/// Starts recording the tasks enqueued on the active device
+void beginCapture();
+
+/// Stops recording and returns the recorded tasks
+af_graph endCapture();
+
+/// Enqueues the tasks of \p graph on the queue of the active device
+void replayGraph(const af_graph graph);
+
+void releaseGraph(af_graph graph);
+
+/// Returns true if the work of the active device is being recorded
+bool isCapturing();
+
+}  // namespace cpu
@@ -13,22 +13,24 @@
 
 namespace cpu {
 template<typename T>
-void anisotropicDiffusion(Array<T>& inout, const float dt, const float mct,
+void anisotropicDiffusion(Array<T>& inout, const float dt, const float K,
+                          const unsigned iterations,
                           const af::fluxFunction fftype,
                           const af::diffusionEq eq) {
     if (eq == AF_DIFFUSION_MCDE) {
-        getQueue().enqueue(kernel::anisotropicDiffusion<T, true>, inout, dt,
-                           mct, fftype);
+        getQueue().enqueue(kernel::anisotropicDiffusion<T, true>, inout, dt, K,
+                           iterations, fftype);
     } else {
         getQueue().enqueue(kernel::anisotropicDiffusion<T, false>, inout, dt,
-                           mct, fftype);
+                           K, iterations, fftype);
     }
 }
 
-#define INSTANTIATE(T)                                     \
-    template void anisotropicDiffusion<T>(                 \
-        Array<T> & inout, const float dt, const float mct, \
-        const af::fluxFunction fftype, const af::diffusionEq eq);
+#define INSTANTIATE(T)                                            \
+    template void anisotropicDiffusion<T>(                        \
+        Array<T> & inout, const float dt, const float K,          \
+        const unsigned iterations, const af::fluxFunction fftype, \
+        const af::diffusionEq eq);
 
 INSTANTIATE(double)
 INSTANTIATE(float)
@@ -87,10 +87,9 @@ Array<T> arithOp(const Array<T> &lhs, const Array<T> &rhs,
     common::Node_ptr lhs_node = lhs.getNode();
     common::Node_ptr rhs_node = rhs.getNode();
 
-    jit::BinaryNode<T, T, op> *node =
-        new jit::BinaryNode<T, T, op>(lhs_node, rhs_node);
-
-    return createNodeArray<T>(odims, common::Node_ptr(node));
+    return createNodeArray<T>(
+        odims, common::makePooled<jit::BinaryNode<T, T, op>>(lhs_node,
+                                                             rhs_node));
 }
 
 }  // namespace cpu
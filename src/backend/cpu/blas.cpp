@@ -16,12 +16,16 @@
 #include <Array.hpp>
 #include <Param.hpp>
 #include <cast.hpp>
+#include <common/bfloat16.hpp>
 #include <common/blas_headers.hpp>
 #include <common/complex.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <copy.hpp>
 #include <kernel/dot.hpp>
+#include <kernel/gemm_epilogue.hpp>
+#include <kernel/gemm_quantized.hpp>
+#include <kernel/gemm_small.hpp>
 #include <platform.hpp>
 #include <types.hpp>
 
@@ -34,6 +38,7 @@
 #include <vector>
 
 using af::dtype_traits;
+using common::bfloat16;
 using common::half;
 using common::is_complex;
 using std::conditional;
@@ -242,6 +247,13 @@ void gemm(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs, const T *alpha,
 #ifdef USE_MKL
     auto alpha_batched = scale_type<T, true>(alpha);
     auto beta_batched  = scale_type<T, true>(beta);
+#else
+    // The batches of small products are not sent to BLAS one by one
+    const bool isSmall = M <= kernel::GEMM_SMALL_MAX_DIM &&
+                         N <= kernel::GEMM_SMALL_MAX_DIM &&
+                         K <= kernel::GEMM_SMALL_MAX_DIM;
+    const T alphaValue = *alpha;
+    const T betaValue  = *beta;
 #endif
 
     auto func = [=](Param<T> output, CParam<T> left, CParam<T> right) {
@@ -268,6 +280,13 @@ void gemm(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs, const T *alpha,
                     oStrides[1]);
             }
         } else {
+#ifndef USE_MKL
+            if (isSmall) {
+                kernel::gemmSmall<T>(output, left, right, optLhs, optRhs,
+                                     alphaValue, betaValue);
+                return;
+            }
+#endif
             int batchSize = static_cast<int>(oDims[2] * oDims[3]);
 
             const bool is_l_d2_batched = oDims[2] == lDims[2];
@@ -339,6 +358,70 @@ void gemm<half>(Array<half> &out, af_mat_prop optLhs, af_mat_prop optRhs,
     copyArray(out, outArr);
 }
 
+// The CPU BLAS libraries have no bfloat16 GEMM. The inputs are converted to
+// f32 while the JIT evaluates them, and the products are accumulated in f32.
+template<>
+void gemm<bfloat16>(Array<bfloat16> &out, af_mat_prop optLhs,
+                    af_mat_prop optRhs, const bfloat16 *alpha,
+                    const Array<bfloat16> &lhs, const Array<bfloat16> &rhs,
+                    const bfloat16 *beta) {
+    const auto float_alpha = static_cast<float>(*alpha);
+    const auto float_beta  = static_cast<float>(*beta);
+    Array<float> outArr    = cast<float>(out);
+    outArr.eval();
+    gemm<float>(outArr, optLhs, optRhs, &float_alpha, cast<float>(lhs),
+                cast<float>(rhs), &float_beta);
+    copyArray(out, cast<bfloat16>(outArr));
+}
+
+template<typename T>
+void gemmEpilogue(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+                  const T *alpha, const Array<T> &lhs, const Array<T> &rhs,
+                  const T *beta, const Array<T> &bias,
+                  af_gemm_epilogue epilogue) {
+    gemm<T>(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+    if (bias.elements() > 0 || epilogue != AF_GEMM_EPILOGUE_NONE) {
+        getQueue().enqueue(kernel::gemmEpilogue<T>, out, bias, epilogue);
+    }
+}
+
+// MKL's cblas_gemm_s8u8s32 takes one signed operand and 8-bit offsets, so
+// the zero points of two u8 operands do not fit it
+void gemmQuantized(Array<int> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+                   const Array<uchar> &lhs, const int lhsZero,
+                   const Array<uchar> &rhs, const int rhsZero) {
+    getQueue().enqueue(kernel::gemmQuantized, out, lhs, rhs, optLhs, optRhs,
+                       lhsZero, rhsZero);
+}
+
+// The CPU BLAS libraries have no TF32, and gemm<half> already accumulates in
+// f32
+template<typename Ti, typename To>
+void gemmMixed(Array<To> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+               const To *alpha, const Array<Ti> &lhs, const Array<Ti> &rhs,
+               const To *beta, af_gemm_compute_type /*compute*/) {
+    gemm<To>(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+}
+
+template<>
+void gemmMixed<half, float>(Array<float> &out, af_mat_prop optLhs,
+                            af_mat_prop optRhs, const float *alpha,
+                            const Array<half> &lhs, const Array<half> &rhs,
+                            const float *beta, af_gemm_compute_type) {
+    gemm<float>(out, optLhs, optRhs, alpha, cast<float>(lhs),
+                cast<float>(rhs), beta);
+}
+
+template<>
+void gemmMixed<bfloat16, float>(Array<float> &out, af_mat_prop optLhs,
+                                af_mat_prop optRhs, const float *alpha,
+                                const Array<bfloat16> &lhs,
+                                const Array<bfloat16> &rhs, const float *beta,
+                                af_gemm_compute_type) {
+    gemm<float>(out, optLhs, optRhs, alpha, cast<float>(lhs),
+                cast<float>(rhs), beta);
+}
+
 template<typename T>
 Array<T> dot(const Array<T> &lhs, const Array<T> &rhs, af_mat_prop optLhs,
              af_mat_prop optRhs) {
@@ -380,6 +463,31 @@ INSTANTIATE_GEMM(cfloat);
 INSTANTIATE_GEMM(double);
 INSTANTIATE_GEMM(cdouble);
 
+#define INSTANTIATE_GEMM_EPILOGUE(TYPE)                                   \
+    template void gemmEpilogue<TYPE>(                                     \
+        Array<TYPE> & out, af_mat_prop optLhs, af_mat_prop optRhs,        \
+        const TYPE *alpha, const Array<TYPE> &lhs, const Array<TYPE> &rhs, \
+        const TYPE *beta, const Array<TYPE> &bias, af_gemm_epilogue epilogue)
+
+INSTANTIATE_GEMM_EPILOGUE(float);
+INSTANTIATE_GEMM_EPILOGUE(cfloat);
+INSTANTIATE_GEMM_EPILOGUE(double);
+INSTANTIATE_GEMM_EPILOGUE(cdouble);
+INSTANTIATE_GEMM_EPILOGUE(half);
+
+#define INSTANTIATE_GEMM_MIXED(TI, TO)                               \
+    template void gemmMixed<TI, TO>(                                 \
+        Array<TO> & out, af_mat_prop optLhs, af_mat_prop optRhs,     \
+        const TO *alpha, const Array<TI> &lhs, const Array<TI> &rhs, \
+        const TO *beta, af_gemm_compute_type compute)
+
+INSTANTIATE_GEMM_MIXED(float, float);
+INSTANTIATE_GEMM_MIXED(cfloat, cfloat);
+INSTANTIATE_GEMM_MIXED(double, double);
+INSTANTIATE_GEMM_MIXED(cdouble, cdouble);
+INSTANTIATE_GEMM_MIXED(half, half);
+INSTANTIATE_GEMM_MIXED(bfloat16, bfloat16);
+
 #define INSTANTIATE_DOT(TYPE)                                                  \
     template Array<TYPE> dot<TYPE>(const Array<TYPE> &lhs,                     \
                                    const Array<TYPE> &rhs, af_mat_prop optLhs, \
@@ -16,6 +16,28 @@ template<typename T>
 void gemm(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs, const T *alpha,
           const Array<T> &lhs, const Array<T> &rhs, const T *beta);
 
+/// Computes the GEMM of \p out and then adds the column vector \p bias to
+/// every column of \p out and applies the activation of \p epilogue. An
+/// empty \p bias adds nothing.
+template<typename T>
+void gemmEpilogue(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+                  const T *alpha, const Array<T> &lhs, const Array<T> &rhs,
+                  const T *beta, const Array<T> &bias,
+                  af_gemm_epilogue epilogue);
+
+/// Computes the GEMM of \p out with the accumulation of \p compute. The
+/// inputs are f16 and the output f32 only for the mixed precision GEMM.
+template<typename Ti, typename To>
+void gemmMixed(Array<To> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+               const To *alpha, const Array<Ti> &lhs, const Array<Ti> &rhs,
+               const To *beta, af_gemm_compute_type compute);
+
+/// Computes (op(lhs) - lhsZero) (op(rhs) - rhsZero) for the 8-bit quantized
+/// matrices \p lhs and \p rhs, accumulated in 32-bit integers
+void gemmQuantized(Array<int> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+                   const Array<uchar> &lhs, const int lhsZero,
+                   const Array<uchar> &rhs, const int rhsZero);
+
 template<typename T>
 Array<T> matmul(const Array<T> &lhs, const Array<T> &rhs, af_mat_prop optLhs,
                 af_mat_prop optRhs) {
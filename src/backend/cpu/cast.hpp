@@ -9,6 +9,7 @@
 
 #pragma once
 #include <Array.hpp>
+#include <common/bfloat16.hpp>
 #include <err_cpu.hpp>
 #include <jit/UnaryNode.hpp>
 #include <math.hpp>
@@ -98,6 +99,69 @@ struct UnOp<common::half, std::complex<double>, af_cast_t> {
     }
 };
 
+// The bfloat16 values of the JIT trees are floats, which are rounded to
+// bfloat16 when they are cast to it
+template<typename To>
+struct UnOp<To, common::bfloat16, af_cast_t> {
+    void eval(jit::array<compute_t<To>> &out, const jit::array<float> &in,
+              int lim) {
+        for (int i = 0; i < lim; i++) { out[i] = compute_t<To>(in[i]); }
+    }
+};
+
+template<typename Ti>
+struct UnOp<common::bfloat16, Ti, af_cast_t> {
+    void eval(jit::array<float> &out, const jit::array<compute_t<Ti>> &in,
+              int lim) {
+        for (int i = 0; i < lim; i++) {
+            out[i] = static_cast<float>(common::bfloat16(in[i]));
+        }
+    }
+};
+
+template<>
+struct UnOp<common::half, common::bfloat16, af_cast_t> {
+    void eval(jit::array<float> &out, const jit::array<float> &in, int lim) {
+        for (int i = 0; i < lim; i++) { out[i] = in[i]; }
+    }
+};
+
+template<>
+struct UnOp<common::bfloat16, common::half, af_cast_t> {
+    void eval(jit::array<float> &out, const jit::array<float> &in, int lim) {
+        for (int i = 0; i < lim; i++) {
+            out[i] = static_cast<float>(common::bfloat16(in[i]));
+        }
+    }
+};
+
+template<>
+struct UnOp<char, common::bfloat16, af_cast_t> {
+    void eval(jit::array<char> &out, const jit::array<float> &in, int lim) {
+        for (int i = 0; i < lim; i++) { out[i] = char(in[i] != 0); }
+    }
+};
+
+template<>
+struct UnOp<common::bfloat16, std::complex<float>, af_cast_t> {
+    void eval(jit::array<float> &out,
+              const jit::array<std::complex<float>> &in, int lim) {
+        for (int i = 0; i < lim; i++) {
+            out[i] = static_cast<float>(common::bfloat16(std::abs(in[i])));
+        }
+    }
+};
+
+template<>
+struct UnOp<common::bfloat16, std::complex<double>, af_cast_t> {
+    void eval(jit::array<float> &out,
+              const jit::array<std::complex<double>> &in, int lim) {
+        for (int i = 0; i < lim; i++) {
+            out[i] = static_cast<float>(common::bfloat16(std::abs(in[i])));
+        }
+    }
+};
+
 template<typename To>
 struct UnOp<To, std::complex<float>, af_cast_t> {
     typedef std::complex<float> Ti;
@@ -156,11 +220,9 @@ template<typename To, typename Ti>
 struct CastWrapper {
     Array<To> operator()(const Array<Ti> &in) {
         common::Node_ptr in_node = in.getNode();
-        jit::UnaryNode<To, Ti, af_cast_t> *node =
-            new jit::UnaryNode<To, Ti, af_cast_t>(in_node);
         return createNodeArray<To>(
             in.dims(),
-            common::Node_ptr(reinterpret_cast<common::Node *>(node)));
+            common::makePooled<jit::UnaryNode<To, Ti, af_cast_t>>(in_node));
     }
 };
 
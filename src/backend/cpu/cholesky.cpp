@@ -19,11 +19,14 @@
 #include <types.hpp>
 
 #include <lapack_helper.hpp>
+#include <parallel_for.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <triangle.hpp>
 #include <af/dim4.hpp>
 
+#include <vector>
+
 namespace cpu {
 
 template<typename T>
@@ -63,17 +66,26 @@ int cholesky_inplace(Array<T> &in, const bool is_upper) {
     char uplo = 'L';
     if (is_upper) { uplo = 'U'; }
 
-    int info  = 0;
+    // The matrices of a batch are factorized concurrently
+    std::vector<int> infos(iDims[2] * iDims[3], 0);
     auto func = [&](int *info, Param<T> in) {
-        *info = potrf_func<T>()(AF_LAPACK_COL_MAJOR, uplo, N, in.get(),
-                                in.strides(1));
+        parallelForSlices(in.dims(), N * N * N, [&](dim_t z, dim_t w) {
+            info[w * iDims[2] + z] = potrf_func<T>()(
+                AF_LAPACK_COL_MAJOR, uplo, N,
+                in.get() + z * in.strides(2) + w * in.strides(3),
+                in.strides(1));
+        });
     };
 
-    getQueue().enqueue(func, &info, in);
+    getQueue().enqueue(func, infos.data(), in);
     // Ensure the value of info has been written into info.
     getQueue().sync();
 
-    return info;
+    // A batch reports the failure of its first failing matrix
+    for (int info : infos) {
+        if (info != 0) { return info; }
+    }
+    return 0;
 }
 
 #define INSTANTIATE_CH(T)                                                 \
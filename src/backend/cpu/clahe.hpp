@@ -0,0 +1,18 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Array.hpp>
+
+namespace cpu {
+template<typename T>
+Array<T> clahe(const Array<T> &in, const unsigned gridRows,
+               const unsigned gridCols, const float clipLimit,
+               const unsigned nbins, const float minval, const float maxval);
+}
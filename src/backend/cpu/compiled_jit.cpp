@@ -0,0 +1,430 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <compiled_jit.hpp>
+
+#include <common/Logger.hpp>
+#include <common/defines.hpp>
+#include <common/module_loading.hpp>
+#include <common/util.hpp>
+#include <device_manager.hpp>
+#include <af/version.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using common::Node;
+using common::Node_ids;
+using std::shared_timed_mutex;
+using std::string;
+using std::stringstream;
+using std::to_string;
+using std::unordered_map;
+using std::vector;
+
+namespace cpu {
+namespace jit {
+
+namespace {
+
+spdlog::logger *getLogger() {
+    static std::shared_ptr<spdlog::logger> logger(common::loggerFactory("jit"));
+    return logger.get();
+}
+
+/// The functions used by the generated kernels. The semantics match the
+/// UnOp and BinOp specializations used by the interpreted JIT.
+const char *const kernelPrelude = R"JIT(
+#include <algorithm>
+#include <cmath>
+
+typedef long long dim_t;
+
+#define UNARY_FN(NAME, EXPR)                     \
+    template<typename To, typename Ti>           \
+    static inline To NAME(Ti a) {                \
+        return static_cast<To>(EXPR);            \
+    }
+
+#define BINARY_FN(NAME, EXPR)                    \
+    template<typename To, typename Ti>           \
+    static inline To NAME(Ti a, Ti b) {          \
+        return static_cast<To>(EXPR);            \
+    }
+
+BINARY_FN(af_add, a + b)
+BINARY_FN(af_sub, a - b)
+BINARY_FN(af_mul, a * b)
+BINARY_FN(af_div, a / b)
+BINARY_FN(af_min, std::min(a, b))
+BINARY_FN(af_max, std::max(a, b))
+BINARY_FN(af_pow, std::pow(a, b))
+BINARY_FN(af_atan2, std::atan2(a, b))
+BINARY_FN(af_hypot, std::hypot(a, b))
+BINARY_FN(af_eq, a == b)
+BINARY_FN(af_neq, a != b)
+BINARY_FN(af_lt, a < b)
+BINARY_FN(af_gt, a > b)
+BINARY_FN(af_le, a <= b)
+BINARY_FN(af_ge, a >= b)
+BINARY_FN(af_and, a && b)
+BINARY_FN(af_or, a || b)
+BINARY_FN(af_bitor, a | b)
+BINARY_FN(af_bitand, a & b)
+BINARY_FN(af_bitxor, a ^ b)
+BINARY_FN(af_bitshiftl, a << b)
+BINARY_FN(af_bitshiftr, a >> b)
+
+UNARY_FN(af_sin, std::sin(a))
+UNARY_FN(af_cos, std::cos(a))
+UNARY_FN(af_tan, std::tan(a))
+UNARY_FN(af_asin, std::asin(a))
+UNARY_FN(af_acos, std::acos(a))
+UNARY_FN(af_atan, std::atan(a))
+UNARY_FN(af_sinh, std::sinh(a))
+UNARY_FN(af_cosh, std::cosh(a))
+UNARY_FN(af_tanh, std::tanh(a))
+UNARY_FN(af_asinh, std::asinh(a))
+UNARY_FN(af_acosh, std::acosh(a))
+UNARY_FN(af_atanh, std::atanh(a))
+UNARY_FN(af_round, std::round(a))
+UNARY_FN(af_trunc, std::trunc(a))
+UNARY_FN(af_floor, std::floor(a))
+UNARY_FN(af_ceil, std::ceil(a))
+UNARY_FN(af_exp, std::exp(a))
+UNARY_FN(af_sigmoid, 1.0 / (1 + std::exp(-a)))
+UNARY_FN(af_expm1, std::expm1(a))
+UNARY_FN(af_erf, std::erf(a))
+UNARY_FN(af_erfc, std::erfc(a))
+UNARY_FN(af_log, std::log(a))
+UNARY_FN(af_log10, std::log10(a))
+UNARY_FN(af_log1p, std::log1p(a))
+UNARY_FN(af_log2, std::log2(a))
+UNARY_FN(af_sqrt, std::sqrt(a))
+UNARY_FN(af_rsqrt, std::pow(a, -0.5))
+UNARY_FN(af_cbrt, std::cbrt(a))
+UNARY_FN(af_tgamma, std::tgamma(a))
+UNARY_FN(af_lgamma, std::lgamma(a))
+UNARY_FN(af_noop, a)
+UNARY_FN(af_bitnot, ~a)
+UNARY_FN(af_isinf, std::isinf(a))
+UNARY_FN(af_isnan, std::isnan(a))
+UNARY_FN(af_iszero, a == 0)
+
+template<typename To, typename Ti>
+struct CastOp {
+    static To eval(Ti a) { return static_cast<To>(a); }
+};
+
+#define CAST_B8(T)                                         \
+    template<>                                             \
+    struct CastOp<char, T> {                               \
+        static char eval(T a) { return char(a != 0); }     \
+    };
+
+CAST_B8(float)
+CAST_B8(double)
+CAST_B8(int)
+CAST_B8(unsigned char)
+CAST_B8(char)
+
+template<typename To, typename Ti>
+static inline To af_cast(Ti a) {
+    return CastOp<To, Ti>::eval(a);
+}
+)JIT";
+
+/// The name of the kernel function in the generated modules
+const char *const kernelName = "af_jit_kernel";
+
+string getKernelString(const vector<const char *> &out_types,
+                       const vector<Node *> &full_nodes,
+                       const vector<Node_ids> &full_ids,
+                       const vector<int> &output_ids, const bool is_linear) {
+    stringstream params;
+    stringstream offsets;
+    stringstream funcs;
+    stringstream outputs;
+
+    for (size_t i = 0; i < full_nodes.size(); i++) {
+        const Node *node = full_nodes[i];
+        const int id     = full_ids[i].id;
+        node->genParams(params, id, is_linear);
+        node->genOffsets(offsets, id, is_linear);
+        node->genFuncs(funcs, full_ids[i]);
+    }
+
+    for (size_t i = 0; i < output_ids.size(); i++) {
+        params << out_types[i] << " *out" << i << " = (" << out_types[i]
+               << " *)(*arg++);\n";
+        outputs << "out" << i << (is_linear ? "[idx]" : "[ooff + id0]")
+                << " = v" << output_ids[i] << ";\n";
+    }
+
+    stringstream kerStream;
+    kerStream << kernelPrelude << "\nextern \"C\" void " << kernelName
+              << "(const void *const *args, dim_t begin, dim_t end) {\n"
+              << "const void *const *arg = args;\n"
+              << params.str()
+              << "const dim_t *odims = (const dim_t *)(*arg++);\n"
+              << "const dim_t *ostrides = (const dim_t *)(*arg++);\n"
+              << "(void)odims;\n(void)ostrides;\n";
+    if (is_linear) {
+        kerStream << "for (dim_t idx = begin; idx < end; idx++) {\n"
+                  << offsets.str() << funcs.str() << outputs.str() << "}\n";
+    } else {
+        kerStream << "for (dim_t row = begin; row < end; row++) {\n"
+                  << "const dim_t id1 = row % odims[1];\n"
+                  << "const dim_t id2 = (row / odims[1]) % odims[2];\n"
+                  << "const dim_t id3 = row / (odims[1] * odims[2]);\n"
+                  << "const dim_t ooff = id1 * ostrides[1] + "
+                  << "id2 * ostrides[2] + id3 * ostrides[3];\n"
+                  << "for (dim_t id0 = 0; id0 < odims[0]; id0++) {\n"
+                  << offsets.str() << funcs.str() << outputs.str()
+                  << "}\n}\n";
+    }
+    kerStream << "}\n";
+    return kerStream.str();
+}
+
+string getCompiler() {
+    string compiler = getEnvVar("AF_CPU_JIT_COMPILER");
+    return compiler.empty() ? string("c++") : compiler;
+}
+
+/// -march=native ties the generated code to the instruction set of the host
+const char *const compileFlags = " -O3 -march=native -std=c++11 -shared -fPIC";
+
+/// Identifies the compiler, the flags and the host CPU a module is built
+/// for. The cache directory can be shared between machines, so a module on
+/// disk is only reused when all of them match.
+string getTargetKey() {
+    const CPUInfo cinfo = DeviceManager::getInstance().getCPUInfo();
+    return to_string(deterministicHash(vector<string>{
+        getCompiler(), compileFlags, cinfo.vendor(), cinfo.model()}));
+}
+
+#if defined(OS_WIN)
+const char *const libraryExtension = ".dll";
+#elif defined(OS_MAC)
+const char *const libraryExtension = ".dylib";
+#else
+const char *const libraryExtension = ".so";
+#endif
+
+/// Compiles \p source into a shared library at \p libPath
+bool compileLibrary(const string &source, const string &srcPath,
+                    const string &libPath) {
+    FILE *f = fopen(srcPath.c_str(), "w");
+    if (!f) { return false; }
+    bool written = fputs(source.c_str(), f) != EOF;
+    fclose(f);
+    if (!written) {
+        removeFile(srcPath);
+        return false;
+    }
+
+    const string command = getCompiler() + compileFlags + " -o \"" + libPath +
+                           "\" \"" + srcPath + "\"";
+    const int status = std::system(command.c_str());
+    removeFile(srcPath);
+    if (status != 0) {
+        AF_TRACE("Failed to compile JIT kernel: \"{}\" returned {}", command,
+                 status);
+        removeFile(libPath);
+        return false;
+    }
+    return true;
+}
+
+/// Generates, compiles and loads the module for \p source. Returns nullptr
+/// on failure.
+LibHandle buildModule(const string &moduleKey, const string &source) {
+    const string &cacheDirectory = getCacheDirectory();
+    if (cacheDirectory.empty()) {
+        AF_TRACE("{{{:<20} : no writable cache directory}}", moduleKey);
+        return nullptr;
+    }
+
+    const string libPath = cacheDirectory + AF_PATH_SEPARATOR + moduleKey +
+                           "_CPU_" + getTargetKey() + "_AF_" +
+                           to_string(AF_API_VERSION_CURRENT) +
+                           libraryExtension;
+
+#ifdef AF_CACHE_KERNELS_TO_DISK
+    if (LibHandle handle = common::loadLibrary(libPath.c_str())) {
+        AF_TRACE("{{{:<20} : loaded from {}}}", moduleKey, libPath);
+        return handle;
+    }
+#endif
+
+    const string tempFile =
+        cacheDirectory + AF_PATH_SEPARATOR + makeTempFilename();
+    const string tempLib = tempFile + libraryExtension;
+    if (!compileLibrary(source, tempFile + ".cpp", tempLib)) {
+        return nullptr;
+    }
+
+#ifdef AF_CACHE_KERNELS_TO_DISK
+    // Another thread or process may have created the file in the meantime.
+    // Either way a valid module will be at libPath.
+    if (renameFile(tempLib, libPath)) {
+        if (LibHandle handle = common::loadLibrary(libPath.c_str())) {
+            AF_TRACE("{{{:<20} : saved to {}}}", moduleKey, libPath);
+            return handle;
+        }
+    }
+#endif
+
+    LibHandle handle = common::loadLibrary(tempLib.c_str());
+    if (!handle) {
+        AF_TRACE("{{{:<20} : failed to load {}: {}}}", moduleKey, tempLib,
+                 common::getErrorMessage());
+    }
+    removeFile(tempLib);
+    return handle;
+}
+
+using KernelMap = unordered_map<string, CompiledKernel>;
+
+shared_timed_mutex &getCacheMutex() {
+    static shared_timed_mutex mutex;
+    return mutex;
+}
+
+KernelMap &getCache() {
+    // Leaked on purpose so that the modules outlive the threads using them
+    static KernelMap *cache = new KernelMap;
+    return *cache;
+}
+
+}  // namespace
+
+bool isCompiledJitEnabled() {
+    thread_local int enabled = -1;
+    if (enabled == -1) { enabled = getEnvVar("AF_CPU_JIT_COMPILE") == "1"; }
+    return enabled == 1;
+}
+
+const char *getOpName(af_op_t op) {
+    switch (op) {
+        case af_add_t: return "af_add";
+        case af_sub_t: return "af_sub";
+        case af_mul_t: return "af_mul";
+        case af_div_t: return "af_div";
+        case af_and_t: return "af_and";
+        case af_or_t: return "af_or";
+        case af_eq_t: return "af_eq";
+        case af_neq_t: return "af_neq";
+        case af_lt_t: return "af_lt";
+        case af_le_t: return "af_le";
+        case af_gt_t: return "af_gt";
+        case af_ge_t: return "af_ge";
+        case af_bitnot_t: return "af_bitnot";
+        case af_bitor_t: return "af_bitor";
+        case af_bitand_t: return "af_bitand";
+        case af_bitxor_t: return "af_bitxor";
+        case af_bitshiftl_t: return "af_bitshiftl";
+        case af_bitshiftr_t: return "af_bitshiftr";
+        case af_min_t: return "af_min";
+        case af_max_t: return "af_max";
+        case af_pow_t: return "af_pow";
+        case af_atan2_t: return "af_atan2";
+        case af_hypot_t: return "af_hypot";
+        case af_sin_t: return "af_sin";
+        case af_cos_t: return "af_cos";
+        case af_tan_t: return "af_tan";
+        case af_asin_t: return "af_asin";
+        case af_acos_t: return "af_acos";
+        case af_atan_t: return "af_atan";
+        case af_sinh_t: return "af_sinh";
+        case af_cosh_t: return "af_cosh";
+        case af_tanh_t: return "af_tanh";
+        case af_asinh_t: return "af_asinh";
+        case af_acosh_t: return "af_acosh";
+        case af_atanh_t: return "af_atanh";
+        case af_exp_t: return "af_exp";
+        case af_expm1_t: return "af_expm1";
+        case af_erf_t: return "af_erf";
+        case af_erfc_t: return "af_erfc";
+        case af_log_t: return "af_log";
+        case af_log10_t: return "af_log10";
+        case af_log1p_t: return "af_log1p";
+        case af_log2_t: return "af_log2";
+        case af_sqrt_t: return "af_sqrt";
+        case af_rsqrt_t: return "af_rsqrt";
+        case af_cbrt_t: return "af_cbrt";
+        case af_iszero_t: return "af_iszero";
+        case af_isinf_t: return "af_isinf";
+        case af_isnan_t: return "af_isnan";
+        case af_sigmoid_t: return "af_sigmoid";
+        case af_round_t: return "af_round";
+        case af_trunc_t: return "af_trunc";
+        case af_floor_t: return "af_floor";
+        case af_ceil_t: return "af_ceil";
+        case af_tgamma_t: return "af_tgamma";
+        case af_lgamma_t: return "af_lgamma";
+        case af_noop_t: return "af_noop";
+        case af_cast_t: return "af_cast";
+        default: return nullptr;
+    }
+}
+
+CompiledKernel getCompiledKernel(const vector<const char *> &out_types,
+                                 const vector<Node *> &full_nodes,
+                                 const vector<Node_ids> &full_ids,
+                                 const vector<int> &output_ids,
+                                 bool is_linear) {
+    for (const char *out_type : out_types) {
+        if (out_type == nullptr) { return nullptr; }
+    }
+    for (const Node *node : full_nodes) {
+        if (!node->isCompilable()) { return nullptr; }
+    }
+
+    // The generated source describes the whole tree, including the order of
+    // the outputs, so its hash is used as the key of the module
+    const string source = getKernelString(out_types, full_nodes, full_ids,
+                                          output_ids, is_linear);
+    const string moduleKey = "KER" + to_string(deterministicHash(source));
+
+    {
+        std::shared_lock<shared_timed_mutex> readLock(getCacheMutex());
+        auto iter = getCache().find(moduleKey);
+        if (iter != getCache().end()) { return iter->second; }
+    }
+
+    saveKernel(moduleKey, source, ".cpp");
+
+    // Failures are cached as well so that the tree is not compiled again
+    CompiledKernel kernel = nullptr;
+    LibHandle handle      = buildModule(moduleKey, source);
+    if (handle) {
+        kernel = reinterpret_cast<CompiledKernel>(
+            common::getFunctionPointer(handle, kernelName));
+    }
+
+    std::unique_lock<shared_timed_mutex> writeLock(getCacheMutex());
+    auto result = getCache().emplace(moduleKey, kernel);
+    if (!result.second) {
+        // Another thread compiled the same tree while this one was working
+        if (handle) { common::unloadLibrary(handle); }
+        kernel = result.first->second;
+    }
+    return kernel;
+}
+
+}  // namespace jit
+}  // namespace cpu
@@ -0,0 +1,86 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/jit/Node.hpp>
+#include <optypes.hpp>
+#include <types.hpp>
+#include <af/defines.h>
+
+#include <vector>
+
+namespace cpu {
+namespace jit {
+
+/// The signature of the functions generated by the compiled JIT.
+///
+/// \param[in] args  The arguments set by the nodes followed by the output
+///                  pointers, the output dimensions and the output strides
+/// \param[in] begin The first element (linear) or row (strided) to evaluate
+/// \param[in] end   One past the last element or row to evaluate
+using CompiledKernel = void (*)(const void *const *args, dim_t begin,
+                                dim_t end);
+
+/// Returns true if the JIT trees should be compiled to native code.
+///
+/// Controlled by the AF_CPU_JIT_COMPILE environment variable
+bool isCompiledJitEnabled();
+
+/// Returns the name of the function in the generated source that performs
+/// \p op or nullptr if the operation is not supported by the compiled JIT
+const char *getOpName(af_op_t op);
+
+/// Returns the name of the type in the generated source or nullptr if the
+/// type is not supported by the compiled JIT
+template<typename T>
+inline const char *getTypeName() {
+    return nullptr;
+}
+
+#define TYPE_NAME(T, NAME)                \
+    template<>                            \
+    inline const char *getTypeName<T>() { \
+        return NAME;                      \
+    }
+
+TYPE_NAME(float, "float")
+TYPE_NAME(double, "double")
+TYPE_NAME(int, "int")
+TYPE_NAME(uint, "unsigned")
+TYPE_NAME(char, "char")
+TYPE_NAME(uchar, "unsigned char")
+TYPE_NAME(short, "short")
+TYPE_NAME(ushort, "unsigned short")
+TYPE_NAME(intl, "long long")
+TYPE_NAME(uintl, "unsigned long long")
+
+#undef TYPE_NAME
+
+/// Returns a native function that evaluates the JIT tree.
+///
+/// The source of the function is generated from the nodes and compiled with
+/// the compiler specified by AF_CPU_JIT_COMPILER. The compiled modules are
+/// cached in memory and, if enabled, on disk.
+///
+/// \param[in] out_types  The names of the types of the outputs
+/// \param[in] full_nodes The nodes of the tree as generated by getNodesMap
+/// \param[in] full_ids   The ids of the nodes as generated by getNodesMap
+/// \param[in] output_ids The ids of the output nodes
+/// \param[in] is_linear  True if all the buffers are linear
+///
+/// \returns the compiled function or nullptr if the tree cannot be compiled
+CompiledKernel getCompiledKernel(
+    const std::vector<const char *> &out_types,
+    const std::vector<common::Node *> &full_nodes,
+    const std::vector<common::Node_ids> &full_ids,
+    const std::vector<int> &output_ids, bool is_linear);
+
+}  // namespace jit
+}  // namespace cpu
@@ -0,0 +1,115 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <convert_half.hpp>
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define AF_HALF_X86_TARGETS
+#include <immintrin.h>
+#endif
+
+using common::half;
+
+namespace cpu {
+
+namespace {
+
+using half_to_float_fn = void (*)(float *, const half *, dim_t);
+using float_to_half_fn = void (*)(half *, const float *, dim_t);
+
+void halfToFloatScalar(float *out, const half *in, dim_t n) {
+    for (dim_t i = 0; i < n; ++i) { out[i] = static_cast<float>(in[i]); }
+}
+
+void floatToHalfScalar(half *out, const float *in, dim_t n) {
+    for (dim_t i = 0; i < n; ++i) { out[i] = half(in[i]); }
+}
+
+#ifdef AF_HALF_X86_TARGETS
+// These functions are compiled for the instruction sets in their target
+// attributes and are only called after checking the processor supports them
+
+__attribute__((target("avx,f16c"))) void halfToFloatF16C(float *out,
+                                                        const half *in,
+                                                        dim_t n) {
+    dim_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+    }
+    halfToFloatScalar(out + i, in + i, n - i);
+}
+
+__attribute__((target("avx,f16c"))) void floatToHalfF16C(half *out,
+                                                        const float *in,
+                                                        dim_t n) {
+    dim_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i),
+                                    _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), h);
+    }
+    floatToHalfScalar(out + i, in + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void halfToFloatAVX512(float *out,
+                                                         const half *in,
+                                                         dim_t n) {
+    dim_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i h =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        _mm512_storeu_ps(out + i, _mm512_cvtph_ps(h));
+    }
+    halfToFloatScalar(out + i, in + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void floatToHalfAVX512(half *out,
+                                                         const float *in,
+                                                         dim_t n) {
+    dim_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i h = _mm512_cvtps_ph(_mm512_loadu_ps(in + i),
+                                    _MM_FROUND_TO_NEAREST_INT);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), h);
+    }
+    floatToHalfScalar(out + i, in + i, n - i);
+}
+#endif
+
+half_to_float_fn selectHalfToFloat() {
+#ifdef AF_HALF_X86_TARGETS
+    if (__builtin_cpu_supports("avx512f")) { return halfToFloatAVX512; }
+    if (__builtin_cpu_supports("f16c")) { return halfToFloatF16C; }
+#endif
+    return halfToFloatScalar;
+}
+
+float_to_half_fn selectFloatToHalf() {
+#ifdef AF_HALF_X86_TARGETS
+    if (__builtin_cpu_supports("avx512f")) { return floatToHalfAVX512; }
+    if (__builtin_cpu_supports("f16c")) { return floatToHalfF16C; }
+#endif
+    return floatToHalfScalar;
+}
+
+}  // namespace
+
+void convertHalfToFloat(float *out, const half *in, dim_t n) {
+    static const half_to_float_fn convert = selectHalfToFloat();
+    convert(out, in, n);
+}
+
+void convertFloatToHalf(half *out, const float *in, dim_t n) {
+    static const float_to_half_fn convert = selectFloatToHalf();
+    convert(out, in, n);
+}
+
+}  // namespace cpu
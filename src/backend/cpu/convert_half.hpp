@@ -0,0 +1,59 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <common/bfloat16.hpp>
+#include <common/half.hpp>
+#include <af/defines.h>
+
+namespace cpu {
+
+/// Converts the \p n values of \p in to float
+///
+/// Uses the F16C or AVX-512 conversion instructions when the processor
+/// supports them and converts one value at a time otherwise.
+void convertHalfToFloat(float *out, const common::half *in, dim_t n);
+
+/// Converts the \p n values of \p in to half, rounding to the nearest value
+///
+/// Uses the F16C or AVX-512 conversion instructions when the processor
+/// supports them and converts one value at a time otherwise.
+void convertFloatToHalf(common::half *out, const float *in, dim_t n);
+
+/// Converts the \p n values of \p in to To
+template<typename To, typename Ti>
+void convertValues(To *out, const Ti *in, dim_t n) {
+    for (dim_t i = 0; i < n; ++i) { out[i] = static_cast<To>(in[i]); }
+}
+
+inline void convertValues(float *out, const common::half *in, dim_t n) {
+    convertHalfToFloat(out, in, n);
+}
+
+inline void convertValues(common::half *out, const float *in, dim_t n) {
+    convertFloatToHalf(out, in, n);
+}
+
+/// Converts the \p n values of \p in to float. The conversions only shift
+/// the bits of the values, so the compiler vectorizes the loop.
+inline void convertValues(float *out, const common::bfloat16 *in, dim_t n) {
+    for (dim_t i = 0; i < n; ++i) {
+        out[i] = common::bfloat162float(in[i].bits());
+    }
+}
+
+/// Converts the \p n values of \p in to bfloat16, rounding to the nearest
+/// value. The rounding has no branches, so the compiler vectorizes the loop.
+inline void convertValues(common::bfloat16 *out, const float *in, dim_t n) {
+    for (dim_t i = 0; i < n; ++i) {
+        out[i] = common::bfloat16::fromBits(common::float2bfloat16(in[i]));
+    }
+}
+
+}  // namespace cpu
@@ -9,25 +9,19 @@
 
 #include <Array.hpp>
 #include <arith.hpp>
-#include <blas.hpp>
 #include <common/defines.hpp>
 #include <common/half.hpp>
-#include <common/indexing_helpers.hpp>
 #include <convolve.hpp>
 #include <handle.hpp>
+#include <kernel/conv2_implicit.hpp>
 #include <kernel/convolve.hpp>
 #include <platform.hpp>
-#include <reorder.hpp>
-#include <transpose.hpp>
-#include <unwrap.hpp>
-#include <wrap.hpp>
 #include <vector>
 
 #include <af/defines.h>
 #include <af/dim4.hpp>
 
 using af::dim4;
-using common::flip;
 using common::half;
 
 namespace cpu {
@@ -66,7 +60,6 @@ template<typename T, typename accT>
 Array<T> convolve2(Array<T> const &signal, Array<accT> const &c_filter,
                    Array<accT> const &r_filter, const bool expand) {
     const auto &sDims = signal.dims();
-    dim4 tDims        = sDims;
     dim4 oDims        = sDims;
 
     if (expand) {
@@ -77,20 +70,18 @@ Array<T> convolve2(Array<T> const &signal, Array<accT> const &c_filter,
         auto rflen = rfDims.elements();
         // separable convolve only does AF_BATCH_NONE and standard
         // batch(AF_BATCH_LHS)
-        tDims[0] += cflen - 1;
         oDims[0] += cflen - 1;
         oDims[1] += rflen - 1;
     }
 
-    Array<T> out  = createEmptyArray<T>(oDims);
-    Array<T> temp = createEmptyArray<T>(tDims);
+    Array<T> out = createEmptyArray<T>(oDims);
 
     if (expand) {
         getQueue().enqueue(kernel::convolve2<T, accT, true>, out, signal,
-                           c_filter, r_filter, temp);
+                           c_filter, r_filter);
     } else {
         getQueue().enqueue(kernel::convolve2<T, accT, false>, out, signal,
-                           c_filter, r_filter, temp);
+                           c_filter, r_filter);
     }
     return out;
 }
@@ -117,9 +108,8 @@ INSTANTIATE(intl, float)
 #undef INSTANTIATE
 
 template<typename T>
-Array<T> convolve2_unwrap(const Array<T> &signal, const Array<T> &filter,
-                          const dim4 &stride, const dim4 &padding,
-                          const dim4 &dilation) {
+Array<T> convolve2(Array<T> const &signal, Array<T> const &filter,
+                   const dim4 stride, const dim4 padding, const dim4 dilation) {
     dim4 sDims = signal.dims();
     dim4 fDims = filter.dims();
 
@@ -130,33 +120,10 @@ Array<T> convolve2_unwrap(const Array<T> &signal, const Array<T> &filter,
         1 + (sDims[1] + 2 * padding[1] - (((fDims[1] - 1) * dilation[1]) + 1)) /
                 stride[1];
 
-    const bool retCols = false;
-    Array<T> unwrapped =
-        unwrap(signal, fDims[0], fDims[1], stride[0], stride[1], padding[0],
-               padding[1], dilation[0], dilation[1], retCols);
-
-    unwrapped  = reorder(unwrapped, dim4(1, 2, 0, 3));
-    dim4 uDims = unwrapped.dims();
-    unwrapped.modDims(dim4(uDims[0] * uDims[1], uDims[2] * uDims[3]));
-
-    Array<T> collapsedFilter = flip(filter, {1, 1, 0, 0});
-    collapsedFilter.modDims(dim4(fDims[0] * fDims[1] * fDims[2], fDims[3]));
-
-    Array<T> res =
-        matmul(unwrapped, collapsedFilter, AF_MAT_TRANS, AF_MAT_NONE);
-    res.modDims(dim4(outputWidth, outputHeight, signal.dims()[3],
-                     collapsedFilter.dims()[1]));
-    Array<T> out = reorder(res, dim4(0, 1, 3, 2));
-
-    return out;
-}
-
-template<typename T>
-Array<T> convolve2(Array<T> const &signal, Array<T> const &filter,
-                   const dim4 stride, const dim4 padding, const dim4 dilation) {
-    Array<T> out = createEmptyArray<T>(dim4());
-    out = convolve2_unwrap<T>(signal, filter, stride, padding, dilation);
-
+    Array<T> out = createEmptyArray<T>(
+        dim4(outputWidth, outputHeight, fDims[3], sDims[3]));
+    getQueue().enqueue(kernel::conv2Forward<T>, out, signal, filter, stride,
+                       padding, dilation);
     return out;
 }
 
@@ -177,29 +144,10 @@ Array<T> conv2DataGradient(const Array<T> &incoming_gradient,
                            const Array<T> & /*convolved_output*/,
                            af::dim4 stride, af::dim4 padding,
                            af::dim4 dilation) {
-    const dim4 &cDims = incoming_gradient.dims();
-    const dim4 &sDims = original_signal.dims();
-    const dim4 &fDims = original_filter.dims();
-
-    Array<T> collapsed_filter = flip(original_filter, {1, 1, 0, 0});
-    collapsed_filter.modDims(dim4(fDims[0] * fDims[1] * fDims[2], fDims[3]));
-
-    Array<T> collapsed_gradient = incoming_gradient;
-    collapsed_gradient          = reorder(collapsed_gradient, dim4(0, 1, 3, 2));
-    collapsed_gradient.modDims(dim4(cDims[0] * cDims[1] * cDims[3], cDims[2]));
-
-    Array<T> res =
-        matmul(collapsed_gradient, collapsed_filter, AF_MAT_NONE, AF_MAT_TRANS);
-    res.modDims(dim4(res.dims()[0] / sDims[3], sDims[3], fDims[0] * fDims[1],
-                     sDims[2]));
-    res = reorder(res, dim4(0, 2, 3, 1));
-
-    const bool retCols = false;
-    res = wrap_dilated(res, sDims[0], sDims[1], fDims[0], fDims[1], stride[0],
-                       stride[1], padding[0], padding[1], dilation[0],
-                       dilation[1], retCols);
-
-    return res;
+    Array<T> out = createEmptyArray<T>(original_signal.dims());
+    getQueue().enqueue(kernel::conv2DataGradient<T>, out, incoming_gradient,
+                       original_filter, stride, padding, dilation);
+    return out;
 }
 
 template<typename T>
@@ -209,27 +157,10 @@ Array<T> conv2FilterGradient(const Array<T> &incoming_gradient,
                              const Array<T> & /*convolved_output*/,
                              af::dim4 stride, af::dim4 padding,
                              af::dim4 dilation) {
-    const dim4 &cDims = incoming_gradient.dims();
-    const dim4 &fDims = original_filter.dims();
-
-    const bool retCols = false;
-    Array<T> unwrapped =
-        unwrap(original_signal, fDims[0], fDims[1], stride[0], stride[1],
-               padding[0], padding[1], dilation[0], dilation[1], retCols);
-
-    unwrapped  = reorder(unwrapped, dim4(1, 2, 0, 3));
-    dim4 uDims = unwrapped.dims();
-    unwrapped.modDims(dim4(uDims[0] * uDims[1], uDims[2] * uDims[3]));
-
-    Array<T> collapsed_gradient = incoming_gradient;
-    collapsed_gradient          = reorder(collapsed_gradient, dim4(0, 1, 3, 2));
-    collapsed_gradient.modDims(dim4(cDims[0] * cDims[1] * cDims[3], cDims[2]));
-
-    Array<T> res =
-        matmul(unwrapped, collapsed_gradient, AF_MAT_NONE, AF_MAT_NONE);
-    res.modDims(dim4(fDims[0], fDims[1], fDims[2], fDims[3]));
-
-    return flip(res, {1, 1, 0, 0});
+    Array<T> out = createEmptyArray<T>(original_filter.dims());
+    getQueue().enqueue(kernel::conv2FilterGradient<T>, out, original_signal,
+                       incoming_gradient, stride, padding, dilation);
+    return out;
 }
 
 #define INSTANTIATE(T)                                                      \
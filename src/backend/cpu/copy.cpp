@@ -9,6 +9,7 @@
 
 #include <Array.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/bfloat16.hpp>
 #include <common/complex.hpp>
 #include <common/half.hpp>
 #include <copy.hpp>
@@ -23,6 +24,7 @@
 #include <cstdio>
 #include <cstring>
 
+using common::bfloat16;  // NOLINT(misc-unused-using-decls) bug in clang-tidy
 using common::half;  // NOLINT(misc-unused-using-decls) bug in clang-tidy
 using common::is_complex;
 
@@ -58,9 +60,48 @@ void copyArray(Array<outType> &out, Array<inType> const &in) {
     getQueue().enqueue(kernel::copy<outType, inType>, out, in);
 }
 
-#define INSTANTIATE(T)                                         \
-    template void copyData<T>(T * data, const Array<T> &from); \
-    template Array<T> copyArray<T>(const Array<T> &A);
+template<typename T>
+void copyToArrayAsync(Array<T> &dst, const T *src, const size_t bytes,
+                      const size_t offset) {
+    if (!dst.isOwner()) { dst = copyArray<T>(dst); }
+    dst.eval();
+    // The data of the array is kept until the queue runs the copy
+    std::shared_ptr<T> data = dst.getData();
+    char *ptr               = reinterpret_cast<char *>(dst.get()) + offset;
+    getQueue().enqueue([data, ptr, src, bytes]() {
+        UNUSED(data);
+        memcpy(ptr, src, bytes);
+    });
+}
+
+template<typename T>
+void copyFromArrayAsync(T *dst, const Array<T> &src, const size_t bytes,
+                        const size_t offset) {
+    src.eval();
+    std::shared_ptr<T> data = src.getData();
+    const char *ptr = reinterpret_cast<const char *>(src.get()) + offset;
+    getQueue().enqueue([data, ptr, dst, bytes]() {
+        UNUSED(data);
+        memcpy(dst, ptr, bytes);
+    });
+}
+
+template<typename T>
+Array<T> copyToDevice(const Array<T> &in, int device) {
+    UNUSED(device);
+    return copyArray(in);
+}
+
+#define INSTANTIATE(T)                                                 \
+    template void copyData<T>(T * data, const Array<T> &from);         \
+    template Array<T> copyArray<T>(const Array<T> &A);                 \
+    template Array<T> copyToDevice<T>(const Array<T> &in, int device); \
+    template void copyToArrayAsync<T>(Array<T> & dst, const T *src,    \
+                                      const size_t bytes,              \
+                                      const size_t offset);            \
+    template void copyFromArrayAsync<T>(T * dst, const Array<T> &src,  \
+                                        const size_t bytes,            \
+                                        const size_t offset);
 
 INSTANTIATE(float)
 INSTANTIATE(double)
@@ -75,6 +116,7 @@ INSTANTIATE(uintl)
 INSTANTIATE(short)
 INSTANTIATE(ushort)
 INSTANTIATE(half)
+INSTANTIATE(bfloat16)
 
 #define INSTANTIATE_COPY_ARRAY(SRC_T)                                 \
     template void copyArray<SRC_T, float>(Array<float> & dst,         \
@@ -125,6 +167,11 @@ INSTANTIATE_COPY_ARRAY(half)
 INSTANTIATE_COPY_ARRAY_COMPLEX(cfloat)
 INSTANTIATE_COPY_ARRAY_COMPLEX(cdouble)
 
+// The bfloat16 arrays are only copied to bfloat16 arrays. The other types are
+// converted with cast.
+template void copyArray<bfloat16, bfloat16>(Array<bfloat16> &dst,
+                                            Array<bfloat16> const &src);
+
 template<typename T>
 T getScalar(const Array<T> &in) {
     in.eval();
@@ -147,4 +194,5 @@ INSTANTIATE_GETSCALAR(uintl)
 INSTANTIATE_GETSCALAR(short)
 INSTANTIATE_GETSCALAR(ushort)
 INSTANTIATE_GETSCALAR(half)
+INSTANTIATE_GETSCALAR(bfloat16)
 }  // namespace cpu
@@ -25,6 +25,23 @@ void copyData(T *to, const Array<T> &from);
 template<typename T>
 Array<T> copyArray(const Array<T> &A);
 
+/// Creates a copy of \p in on \p device. The CPU backend has a single
+/// device, so this is a deep copy of \p in.
+template<typename T>
+Array<T> copyToDevice(const Array<T> &in, int device);
+
+/// Enqueues a copy of \p bytes of host memory to the buffer of \p dst at
+/// the byte \p offset. \p src must not change until the copy completes.
+template<typename T>
+void copyToArrayAsync(Array<T> &dst, const T *src, const size_t bytes,
+                      const size_t offset);
+
+/// Enqueues a copy of \p bytes of the linear array \p src, starting at the
+/// byte \p offset, to host memory
+template<typename T>
+void copyFromArrayAsync(T *dst, const Array<T> &src, const size_t bytes,
+                        const size_t offset);
+
 template<typename inType, typename outType>
 void copyArray(Array<outType> &out, const Array<inType> &in);
 
@@ -10,12 +10,15 @@
 #include <common/DefaultMemoryManager.hpp>
 #include <common/err_common.hpp>
 #include <common/graphics_common.hpp>
+#include <common/util.hpp>
 #include <device_manager.hpp>
 #include <memory.hpp>
 #include <af/version.h>
 
+#include <algorithm>
 #include <cctype>
 #include <sstream>
+#include <thread>
 
 using common::memory::MemoryManagerBase;
 using std::string;
@@ -121,9 +124,26 @@ CPUInfo::CPUInfo()
 
 namespace cpu {
 
+namespace {
+/// Returns the number of threads used by the CPU kernels. The value of the
+/// AF_CPU_NUM_THREADS environment variable takes precedence over the number
+/// of hardware threads
+int getNumThreads(const CPUInfo& info) {
+    string env_var = getEnvVar("AF_CPU_NUM_THREADS");
+    if (!env_var.empty()) { return std::max(std::stoi(env_var), 1); }
+    int hw_threads = static_cast<int>(std::thread::hardware_concurrency());
+    return std::max({hw_threads, info.threads(), 1});
+}
+
+/// Returns true if the threads of the thread pool are bound to cores (see
+/// AF_CPU_THREAD_AFFINITY)
+bool pinThreads() { return getEnvVar("AF_CPU_THREAD_AFFINITY") == "1"; }
+}  // namespace
+
 DeviceManager::DeviceManager()
     : queues(MAX_QUEUES)
     , fgMngr(new graphics::ForgeManager())
+    , threadPool(new thread_pool(getNumThreads(cinfo), pinThreads()))
     , memManager(new common::DefaultMemoryManager(
           getDeviceCount(), common::MAX_BUFFERS,
           AF_MEM_DEBUG || AF_CPU_MEM_DEBUG)) {
@@ -11,6 +11,7 @@
 
 #include <platform.hpp>
 #include <queue.hpp>
+#include <thread_pool.hpp>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -119,6 +120,8 @@ class DeviceManager {
 
     friend graphics::ForgeManager& forgeManager();
 
+    friend thread_pool& getThreadPool();
+
     void setMemoryManager(std::unique_ptr<MemoryManagerBase> mgr);
 
     void resetMemoryManager();
@@ -138,6 +141,7 @@ class DeviceManager {
     std::vector<queue> queues;
     std::unique_ptr<graphics::ForgeManager> fgMngr;
     const CPUInfo cinfo;
+    std::unique_ptr<thread_pool> threadPool;
     std::unique_ptr<MemoryManagerBase> memManager;
     std::mutex mutex;
 };
@@ -10,7 +10,9 @@
 #include <fft.hpp>
 
 #include <Array.hpp>
+#include <common/FFTLayout.hpp>
 #include <copy.hpp>
+#include <fftw.hpp>
 #include <fftw3.h>
 #include <platform.hpp>
 #include <types.hpp>
@@ -20,132 +22,115 @@
 #include <type_traits>
 
 using af::dim4;
+using common::FFTBatch;
+using common::fftEmbed;
+using common::fftEmbeddable;
 using std::array;
 
 namespace cpu {
 
-template<typename T>
-struct fftw_transform;
-
-#define TRANSFORM(PRE, TY)                                             \
-    template<>                                                         \
-    struct fftw_transform<TY> {                                        \
-        typedef PRE##_plan plan_t;                                     \
-        typedef PRE##_complex ctype_t;                                 \
-                                                                       \
-        template<typename... Args>                                     \
-        plan_t create(Args... args) {                                  \
-            return PRE##_plan_many_dft(args...);                       \
-        }                                                              \
-        void execute(plan_t plan) { return PRE##_execute(plan); }      \
-        void destroy(plan_t plan) { return PRE##_destroy_plan(plan); } \
-    };
-
-TRANSFORM(fftwf, cfloat)
-TRANSFORM(fftw, cdouble)
-
-template<typename To, typename Ti>
-struct fftw_real_transform;
-
-#define TRANSFORM_REAL(PRE, To, Ti, POST)                              \
-    template<>                                                         \
-    struct fftw_real_transform<To, Ti> {                               \
-        typedef PRE##_plan plan_t;                                     \
-        typedef PRE##_complex ctype_t;                                 \
-                                                                       \
-        template<typename... Args>                                     \
-        plan_t create(Args... args) {                                  \
-            return PRE##_plan_many_dft_##POST(args...);                \
-        }                                                              \
-        void execute(plan_t plan) { return PRE##_execute(plan); }      \
-        void destroy(plan_t plan) { return PRE##_destroy_plan(plan); } \
-    };
-
-TRANSFORM_REAL(fftwf, cfloat, float, r2c)
-TRANSFORM_REAL(fftw, cdouble, double, r2c)
-TRANSFORM_REAL(fftwf, float, cfloat, c2r)
-TRANSFORM_REAL(fftw, double, cdouble, c2r)
-
 inline array<int, AF_MAX_DIMS> computeDims(const int rank, const dim4 &idims) {
     array<int, AF_MAX_DIMS> retVal = {};
     for (int i = 0; i < rank; i++) { retVal[i] = idims[(rank - 1) - i]; }
     return retVal;
 }
 
-void setFFTPlanCacheSize(size_t numPlans) { UNUSED(numPlans); }
-
-template<typename T>
-void fft_inplace(Array<T> &in, const int rank, const bool direction) {
-    auto func = [=](Param<T> in, const af::dim4 iDataDims) {
-        const af::dim4 idims = in.dims();
-
-        auto t_dims   = computeDims(rank, idims);
-        auto in_embed = computeDims(rank, iDataDims);
-
-        const af::dim4 istrides = in.strides();
-
-        using ctype_t = typename fftw_transform<T>::ctype_t;
-        typename fftw_transform<T>::plan_t plan;
+/// Returns the layout of the data of the transforms along the first \p rank
+/// dimensions of \p dims, with \p dist between the \p batch transforms of a
+/// plan execution
+FFTWLayout computeLayout(const int rank, const dim4 &dims, const dim4 &strides,
+                         const array<int, AF_MAX_DIMS> &embed, const int batch,
+                         const int dist) {
+    dim4 tdims(1, 1, 1, 1);
+    for (int i = 0; i < rank; i++) { tdims[i] = dims[i]; }
+    return {fftwElements(tdims, strides) + dim_t(batch - 1) * dist,
+            embed.data(), static_cast<int>(strides[0]), dist};
+}
 
-        fftw_transform<T> transform;
+void setFFTPlanCacheSize(size_t numPlans) { setFFTWPlanCacheSize(numPlans); }
 
-        int batch = 1;
-        for (int i = rank; i < 4; i++) { batch *= idims[i]; }
+// FFTW does not report the memory held by its plans, so the CPU plans are
+// only limited by their number
+void setFFTPlanCacheBytes(size_t bytes) { UNUSED(bytes); }
 
-        plan = transform.create(
-            rank, t_dims.data(), batch, reinterpret_cast<ctype_t *>(in.get()),
-            in_embed.data(), static_cast<int>(istrides[0]),
-            static_cast<int>(istrides[rank]),
-            reinterpret_cast<ctype_t *>(in.get()), in_embed.data(),
-            static_cast<int>(istrides[0]), static_cast<int>(istrides[rank]),
-            direction ? FFTW_FORWARD : FFTW_BACKWARD,
-            FFTW_ESTIMATE);  // NOLINT(hicpp-signed-bitwise)
+template<typename T>
+void fft_inplace(Array<T> &in, const int rank, const bool direction) {
+    if (!fftEmbeddable(rank, in.dims(), in.strides())) {
+        // The strides of the transformed dimensions are not multiples of
+        // each other, which the FFTW layouts can not describe
+        Array<T> packed = copyArray<T>(in);
+        fft_inplace<T>(packed, rank, direction);
+        copyArray<T>(in, packed);
+        return;
+    }
 
-        transform.execute(plan);
-        transform.destroy(plan);
+    auto func = [=](Param<T> in) {
+        const dim4 idims    = in.dims();
+        const dim4 istrides = in.strides();
+
+        auto t_dims = computeDims(rank, idims);
+        array<int, AF_MAX_DIMS> in_embed;
+        fftEmbed(in_embed, rank, idims, istrides);
+
+        const FFTBatch batch(rank, idims, istrides, istrides);
+        const FFTWLayout layout = computeLayout(
+            rank, idims, istrides, in_embed, batch.batch(), batch.idist());
+        const FFTWKind kind =
+            direction ? FFTWKind::Forward : FFTWKind::Backward;
+
+        // The batch dimensions which are not packed are iterated with the
+        // same plan, which is found again for the alignment of each offset
+        for (dim_t e = 0; e < batch.executions(); e++) {
+            T *ptr              = in.get() + batch.inOffset(e);
+            SharedFFTWPlan plan = findPlan(std::is_same<T, cdouble>::value,
+                                           kind, rank, t_dims.data(),
+                                           batch.batch(), ptr, layout, ptr,
+                                           layout, 0);
+            executePlan(*plan, kind, ptr, ptr);
+        }
     };
-    getQueue().enqueue(func, in, in.getDataDims());
+    getQueue().enqueue(func, in);
 }
 
 template<typename Tc, typename Tr>
 Array<Tc> fft_r2c(const Array<Tr> &in, const int rank) {
+    if (!fftEmbeddable(rank, in.dims(), in.strides())) {
+        return fft_r2c<Tc, Tr>(copyArray<Tr>(in), rank);
+    }
+
     dim4 odims    = in.dims();
     odims[0]      = odims[0] / 2 + 1;
     Array<Tc> out = createEmptyArray<Tc>(odims);
 
-    auto func = [=](Param<Tc> out, const af::dim4 oDataDims, CParam<Tr> in,
-                    const af::dim4 iDataDims) {
-        af::dim4 idims = in.dims();
-
-        auto t_dims    = computeDims(rank, idims);
-        auto in_embed  = computeDims(rank, iDataDims);
-        auto out_embed = computeDims(rank, oDataDims);
-
-        const af::dim4 istrides = in.strides();
-        const af::dim4 ostrides = out.strides();
-
-        using ctype_t = typename fftw_real_transform<Tc, Tr>::ctype_t;
-        using plan_t  = typename fftw_real_transform<Tc, Tr>::plan_t;
-        plan_t plan;
-
-        fftw_real_transform<Tc, Tr> transform;
-
-        int batch = 1;
-        for (int i = rank; i < 4; i++) { batch *= idims[i]; }
-
-        plan = transform.create(
-            rank, t_dims.data(), batch, const_cast<Tr *>(in.get()),
-            in_embed.data(), static_cast<int>(istrides[0]),
-            static_cast<int>(istrides[rank]),
-            reinterpret_cast<ctype_t *>(out.get()), out_embed.data(),
-            static_cast<int>(ostrides[0]), static_cast<int>(ostrides[rank]),
-            FFTW_ESTIMATE);
-
-        transform.execute(plan);
-        transform.destroy(plan);
+    auto func = [=](Param<Tc> out, CParam<Tr> in) {
+        const dim4 idims    = in.dims();
+        const dim4 istrides = in.strides();
+        const dim4 ostrides = out.strides();
+
+        auto t_dims = computeDims(rank, idims);
+        array<int, AF_MAX_DIMS> in_embed, out_embed;
+        fftEmbed(in_embed, rank, idims, istrides);
+        fftEmbed(out_embed, rank, out.dims(), ostrides);
+
+        const FFTBatch batch(rank, idims, istrides, ostrides);
+        const FFTWLayout inLayout = computeLayout(
+            rank, idims, istrides, in_embed, batch.batch(), batch.idist());
+        const FFTWLayout outLayout =
+            computeLayout(rank, out.dims(), ostrides, out_embed, batch.batch(),
+                          batch.odist());
+
+        for (dim_t e = 0; e < batch.executions(); e++) {
+            Tr *iptr = const_cast<Tr *>(in.get()) + batch.inOffset(e);
+            Tc *optr = out.get() + batch.outOffset(e);
+            SharedFFTWPlan plan = findPlan(
+                std::is_same<Tr, double>::value, FFTWKind::RealToComplex, rank,
+                t_dims.data(), batch.batch(), iptr, inLayout, optr, outLayout,
+                0);
+            executePlan(*plan, FFTWKind::RealToComplex, iptr, optr);
+        }
     };
 
-    getQueue().enqueue(func, out, out.getDataDims(), in, in.getDataDims());
+    getQueue().enqueue(func, out, in);
 
     return out;
 }
@@ -154,62 +139,56 @@ template<typename Tr, typename Tc>
 Array<Tr> fft_c2r(const Array<Tc> &in, const dim4 &odims, const int rank) {
     Array<Tr> out = createEmptyArray<Tr>(odims);
 
-    auto func = [=](Param<Tr> out, const af::dim4 oDataDims, CParam<Tc> in,
-                    const af::dim4 iDataDims, const af::dim4 odims) {
-        auto t_dims    = computeDims(rank, odims);
-        auto in_embed  = computeDims(rank, iDataDims);
-        auto out_embed = computeDims(rank, oDataDims);
+    auto func = [=](Param<Tr> out, CParam<Tc> in, const dim4 odims) {
+        const dim4 istrides = in.strides();
+        const dim4 ostrides = out.strides();
 
-        const af::dim4 istrides = in.strides();
-        const af::dim4 ostrides = out.strides();
+        auto t_dims = computeDims(rank, odims);
+        array<int, AF_MAX_DIMS> in_embed, out_embed;
+        fftEmbed(in_embed, rank, in.dims(), istrides);
+        fftEmbed(out_embed, rank, odims, ostrides);
 
-        using ctype_t = typename fftw_real_transform<Tr, Tc>::ctype_t;
-        using plan_t  = typename fftw_real_transform<Tr, Tc>::plan_t;
-        plan_t plan;
-
-        fftw_real_transform<Tr, Tc> transform;
-
-        int batch = 1;
-        for (int i = rank; i < 4; i++) { batch *= odims[i]; }
-
-        // By default, fftw estimate flag is sufficient for most transforms.
-        // However, complex to real transforms modify the input data memory
-        // while performing the transformation. To avoid that, we need to pass
+        // Complex to real transforms modify the input data memory while
+        // performing the transformation. To avoid that, we need to pass
         // FFTW_PRESERVE_INPUT also. This flag however only works for 1D
         // transforms and for higher level transformations, a copy of input
         // data is passed onto the upstream FFTW calls.
-        unsigned int flags = FFTW_ESTIMATE;  // NOLINT(hicpp-signed-bitwise)
+        unsigned int flags = 0;
         if (rank == 1) {
             flags |= FFTW_PRESERVE_INPUT;  // NOLINT(hicpp-signed-bitwise)
         }
 
-        plan = transform.create(
-            rank, t_dims.data(), batch,
-            reinterpret_cast<ctype_t *>(const_cast<Tc *>(in.get())),
-            in_embed.data(), static_cast<int>(istrides[0]),
-            static_cast<int>(istrides[rank]), out.get(), out_embed.data(),
-            static_cast<int>(ostrides[0]), static_cast<int>(ostrides[rank]),
-            flags);
-
-        transform.execute(plan);
-        transform.destroy(plan);
+        const FFTBatch batch(rank, odims, istrides, ostrides);
+        const FFTWLayout inLayout =
+            computeLayout(rank, in.dims(), istrides, in_embed, batch.batch(),
+                          batch.idist());
+        const FFTWLayout outLayout = computeLayout(
+            rank, odims, ostrides, out_embed, batch.batch(), batch.odist());
+
+        for (dim_t e = 0; e < batch.executions(); e++) {
+            Tc *iptr = const_cast<Tc *>(in.get()) + batch.inOffset(e);
+            Tr *optr = out.get() + batch.outOffset(e);
+            SharedFFTWPlan plan = findPlan(
+                std::is_same<Tr, double>::value, FFTWKind::ComplexToReal, rank,
+                t_dims.data(), batch.batch(), iptr, inLayout, optr, outLayout,
+                flags);
+            executePlan(*plan, FFTWKind::ComplexToReal, iptr, optr);
+        }
     };
 
 #ifdef USE_MKL
-    getQueue().enqueue(func, out, out.getDataDims(), in, in.getDataDims(),
-                       odims);
+    const bool preserves = true;
 #else
-    if (rank > 1 || odims.ndims() > 1) {
-        // FFTW does not have a input preserving algorithm for multidimensional
-        // c2r FFTs
-        Array<Tc> in_ = copyArray<Tc>(in);
-        getQueue().enqueue(func, out, out.getDataDims(), in_, in.getDataDims(),
-                           odims);
+    // FFTW does not have a input preserving algorithm for multidimensional
+    // c2r FFTs
+    const bool preserves = rank == 1 && odims.ndims() <= 1;
+#endif
+    if (preserves && fftEmbeddable(rank, in.dims(), in.strides())) {
+        getQueue().enqueue(func, out, in, odims);
     } else {
-        getQueue().enqueue(func, out, out.getDataDims(), in, in.getDataDims(),
-                           odims);
+        Array<Tc> in_ = copyArray<Tc>(in);
+        getQueue().enqueue(func, out, in_, odims);
     }
-#endif
 
     return out;
 }
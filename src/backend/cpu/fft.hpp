@@ -19,6 +19,8 @@ namespace cpu {
 
 void setFFTPlanCacheSize(size_t numPlans);
 
+void setFFTPlanCacheBytes(size_t bytes);
+
 template<typename T>
 void fft_inplace(Array<T> &in, const int rank, const bool direction);
 
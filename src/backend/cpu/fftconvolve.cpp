@@ -11,7 +11,7 @@
 
 #include <Array.hpp>
 #include <common/dispatch.hpp>
-#include <fftw3.h>
+#include <fftw.hpp>
 #include <kernel/fftconvolve.hpp>
 #include <queue.hpp>
 #include <af/dim4.hpp>
@@ -95,73 +95,32 @@ Array<T> fftconvolve(Array<T> const& signal, Array<T> const& filter,
                        paddedFilStrides, filter, offset);
 
     // NOLINTNEXTLINE(performance-unnecessary-value-param)
-    auto upstream_dft = [=](Param<convT> packed,
-                            const array<int, AF_MAX_DIMS> fftDims) {
+    auto transform = [=](Param<convT> packed,
+                         const array<int, AF_MAX_DIMS> fftDims,
+                         const FFTWKind fftKind) {
         const dim4 packedDims     = packed.dims();
         const dim4 packed_strides = packed.strides();
-        // Compute forward FFT
-        if (IsTypeDouble) {
-            fftw_plan plan = fftw_plan_many_dft(
-                rank, fftDims.data(), packedDims[rank],
-                reinterpret_cast<fftw_complex*>(packed.get()), nullptr,
-                packed_strides[0], packed_strides[rank] / 2,
-                reinterpret_cast<fftw_complex*>(packed.get()), nullptr,
-                packed_strides[0], packed_strides[rank] / 2, FFTW_FORWARD,
-                FFTW_ESTIMATE);  // NOLINT(hicpp-signed-bitwise)
-
-            fftw_execute(plan);
-            fftw_destroy_plan(plan);
-        } else {
-            fftwf_plan plan = fftwf_plan_many_dft(
-                rank, fftDims.data(), packedDims[rank],
-                reinterpret_cast<fftwf_complex*>(packed.get()), nullptr,
-                packed_strides[0], packed_strides[rank] / 2,
-                reinterpret_cast<fftwf_complex*>(packed.get()), nullptr,
-                packed_strides[0], packed_strides[rank] / 2, FFTW_FORWARD,
-                FFTW_ESTIMATE);  // NOLINT(hicpp-signed-bitwise)
-
-            fftwf_execute(plan);
-            fftwf_destroy_plan(plan);
-        }
+        // The packed data is complex, so its strides are halved
+        const FFTWLayout layout{packedDims.elements() / 2, nullptr,
+                                static_cast<int>(packed_strides[0]),
+                                static_cast<int>(packed_strides[rank] / 2)};
+        SharedFFTWPlan plan =
+            findPlan(IsTypeDouble, fftKind, rank, fftDims.data(),
+                     static_cast<int>(packedDims[rank]), packed.get(), layout,
+                     packed.get(), layout, 0);
+        executePlan(*plan, fftKind, packed.get(), packed.get());
     };
-    getQueue().enqueue(upstream_dft, packed, fftDims);
+
+    // Compute forward FFT
+    getQueue().enqueue(transform, packed, fftDims, FFTWKind::Forward);
 
     // Multiply filter and signal FFT arrays
     getQueue().enqueue(kernel::complexMultiply<convT>, packed, paddedSigDims,
                        paddedSigStrides, paddedFilDims, paddedFilStrides, kind,
                        offset);
 
-    // NOLINTNEXTLINE(performance-unnecessary-value-param)
-    auto upstream_idft = [=](Param<convT> packed,
-                             const array<int, AF_MAX_DIMS> fftDims) {
-        const dim4 packedDims     = packed.dims();
-        const dim4 packed_strides = packed.strides();
-        // Compute inverse FFT
-        if (IsTypeDouble) {
-            fftw_plan plan = fftw_plan_many_dft(
-                rank, fftDims.data(), packedDims[rank],
-                reinterpret_cast<fftw_complex*>(packed.get()), nullptr,
-                packed_strides[0], packed_strides[rank] / 2,
-                reinterpret_cast<fftw_complex*>(packed.get()), nullptr,
-                packed_strides[0], packed_strides[rank] / 2, FFTW_BACKWARD,
-                FFTW_ESTIMATE);  // NOLINT(hicpp-signed-bitwise)
-
-            fftw_execute(plan);
-            fftw_destroy_plan(plan);
-        } else {
-            fftwf_plan plan = fftwf_plan_many_dft(
-                rank, fftDims.data(), packedDims[rank],
-                reinterpret_cast<fftwf_complex*>(packed.get()), nullptr,
-                packed_strides[0], packed_strides[rank] / 2,
-                reinterpret_cast<fftwf_complex*>(packed.get()), nullptr,
-                packed_strides[0], packed_strides[rank] / 2, FFTW_BACKWARD,
-                FFTW_ESTIMATE);  // NOLINT(hicpp-signed-bitwise)
-
-            fftwf_execute(plan);
-            fftwf_destroy_plan(plan);
-        }
-    };
-    getQueue().enqueue(upstream_idft, packed, fftDims);
+    // Compute inverse FFT
+    getQueue().enqueue(transform, packed, fftDims, FFTWKind::Backward);
 
     // Compute output dimensions
     dim4 oDims(1);
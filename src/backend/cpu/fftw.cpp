@@ -0,0 +1,334 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <fftw.hpp>
+
+#include <common/defines.hpp>
+#include <common/util.hpp>
+#include <err_cpu.hpp>
+#include <fftw3.h>
+#include <platform.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using std::lock_guard;
+using std::recursive_mutex;
+using std::string;
+using std::to_string;
+using std::vector;
+
+namespace cpu {
+
+namespace {
+
+/// The buffers of the measured plans have the alignment of the arrays the
+/// plans are executed on modulo this alignment, which is a multiple of the
+/// SIMD alignment of FFTW
+constexpr uintptr_t FFTW_PLAN_ALIGNMENT = 64;
+
+/// The smallest number of elements of a transform per FFTW thread
+constexpr dim_t FFTW_MIN_THREAD_ELEMENTS = 1 << 15;
+
+template<typename Tr>
+struct fftw_api;
+
+#define FFTW_API(PRE, Tr)                                                     \
+    template<>                                                                \
+    struct fftw_api<Tr> {                                                     \
+        typedef PRE##_plan plan_t;                                            \
+        typedef PRE##_complex ctype_t;                                        \
+                                                                              \
+        static plan_t create(FFTWKind kind, int rank, const int *n,           \
+                             int batch, void *in, const FFTWLayout &il,       \
+                             void *out, const FFTWLayout &ol,                 \
+                             unsigned flags) {                                \
+            switch (kind) {                                                   \
+                case FFTWKind::RealToComplex:                                 \
+                    return PRE##_plan_many_dft_r2c(                           \
+                        rank, n, batch, static_cast<Tr *>(in), il.embed,      \
+                        il.stride, il.dist, static_cast<ctype_t *>(out),      \
+                        ol.embed, ol.stride, ol.dist, flags);                 \
+                case FFTWKind::ComplexToReal:                                 \
+                    return PRE##_plan_many_dft_c2r(                           \
+                        rank, n, batch, static_cast<ctype_t *>(in), il.embed, \
+                        il.stride, il.dist, static_cast<Tr *>(out), ol.embed, \
+                        ol.stride, ol.dist, flags);                           \
+                default:                                                      \
+                    return PRE##_plan_many_dft(                               \
+                        rank, n, batch, static_cast<ctype_t *>(in), il.embed, \
+                        il.stride, il.dist, static_cast<ctype_t *>(out),      \
+                        ol.embed, ol.stride, ol.dist,                         \
+                        kind == FFTWKind::Forward ? FFTW_FORWARD              \
+                                                  : FFTW_BACKWARD,            \
+                        flags);                                               \
+            }                                                                 \
+        }                                                                     \
+                                                                              \
+        static void execute(void *plan, FFTWKind kind, void *in, void *out) { \
+            plan_t p = static_cast<plan_t>(plan);                             \
+            switch (kind) {                                                   \
+                case FFTWKind::RealToComplex:                                 \
+                    PRE##_execute_dft_r2c(p, static_cast<Tr *>(in),           \
+                                          static_cast<ctype_t *>(out));       \
+                    break;                                                    \
+                case FFTWKind::ComplexToReal:                                 \
+                    PRE##_execute_dft_c2r(p, static_cast<ctype_t *>(in),      \
+                                          static_cast<Tr *>(out));            \
+                    break;                                                    \
+                default:                                                      \
+                    PRE##_execute_dft(p, static_cast<ctype_t *>(in),          \
+                                      static_cast<ctype_t *>(out));           \
+            }                                                                 \
+        }                                                                     \
+                                                                              \
+        static void destroy(void *plan) {                                     \
+            PRE##_destroy_plan(static_cast<plan_t>(plan));                    \
+        }                                                                     \
+        static void initThreads() { FFTW_INIT_THREADS(PRE); }                 \
+        static void planWithThreads(int n) { FFTW_PLAN_THREADS(PRE, n); }     \
+        static void importWisdom(const string &path) {                        \
+            FFTW_IMPORT_WISDOM(PRE, path);                                    \
+        }                                                                     \
+        static void exportWisdom(const string &path) {                        \
+            FFTW_EXPORT_WISDOM(PRE, path);                                    \
+        }                                                                     \
+    };
+
+#ifdef AF_WITH_FFTW_THREADS
+#define FFTW_INIT_THREADS(PRE) PRE##_init_threads()
+#define FFTW_PLAN_THREADS(PRE, n) PRE##_plan_with_nthreads(n)
+#else
+#define FFTW_INIT_THREADS(PRE)
+#define FFTW_PLAN_THREADS(PRE, n) UNUSED(n)
+#endif
+
+// The FFTW interface of MKL does not support wisdom
+#ifdef USE_MKL
+#define FFTW_IMPORT_WISDOM(PRE, path) UNUSED(path)
+#define FFTW_EXPORT_WISDOM(PRE, path) UNUSED(path)
+#else
+#define FFTW_IMPORT_WISDOM(PRE, path) \
+    PRE##_import_wisdom_from_filename(path.c_str())
+#define FFTW_EXPORT_WISDOM(PRE, path) \
+    PRE##_export_wisdom_to_filename(path.c_str())
+#endif
+
+FFTW_API(fftwf, float)
+FFTW_API(fftw, double)
+
+#undef FFTW_API
+#undef FFTW_INIT_THREADS
+#undef FFTW_PLAN_THREADS
+#undef FFTW_IMPORT_WISDOM
+#undef FFTW_EXPORT_WISDOM
+
+/// The FFTW planner is not thread safe, so it is only used with this mutex.
+/// The plans are destroyed with the mutex too, which may happen while a new
+/// plan is pushed into the cache.
+recursive_mutex &getPlannerMutex() {
+    static auto *plannerMutex = new recursive_mutex();
+    return *plannerMutex;
+}
+
+/// The plan cache is not freed because the plans may be executed while the
+/// static objects are destroyed
+PlanCache &fftManager() {
+    static auto *cache = new PlanCache();
+    return *cache;
+}
+
+string wisdomPath(bool isDouble) {
+    const string &directory = getCacheDirectory();
+    if (directory.empty()) { return string(); }
+    return directory + AF_PATH_SEPARATOR +
+           (isDouble ? "fftw3.wisdom" : "fftw3f.wisdom");
+}
+
+/// Initializes the FFTW threads and loads the wisdom of a precision before
+/// its first plan is created
+template<typename Tr>
+void initPlanner() {
+    static bool initialized = false;
+    if (initialized) { return; }
+    initialized = true;
+
+    fftw_api<Tr>::initThreads();
+    const string path = wisdomPath(std::is_same<Tr, double>::value);
+    if (!path.empty()) { fftw_api<Tr>::importWisdom(path); }
+}
+
+template<typename Tr>
+void saveWisdom() {
+    const string path = wisdomPath(std::is_same<Tr, double>::value);
+    if (path.empty()) { return; }
+    // Other processes may read the wisdom while it is written
+    const string tempPath = path + "." + makeTempFilename();
+    fftw_api<Tr>::exportWisdom(tempPath);
+    if (!renameFile(tempPath, path)) { removeFile(tempPath); }
+}
+
+unsigned rigorFlags() {
+    switch (getFFTPlanRigor()) {
+        case FFTPlanRigor::Measure: return FFTW_MEASURE;
+        case FFTPlanRigor::Patient: return FFTW_PATIENT;
+        default: return FFTW_ESTIMATE;
+    }
+}
+
+/// A buffer for measuring a plan with the alignment of the data the plan is
+/// executed on. Measuring overwrites the data, so it can not be done on the
+/// arrays of the transform.
+class MeasureBuffer {
+    vector<char> m_data;
+    void *m_ptr;
+
+   public:
+    MeasureBuffer(size_t bytes, const void *like)
+        : m_data(bytes + 2 * FFTW_PLAN_ALIGNMENT) {
+        const uintptr_t base = reinterpret_cast<uintptr_t>(m_data.data());
+        const uintptr_t offset =
+            reinterpret_cast<uintptr_t>(like) % FFTW_PLAN_ALIGNMENT;
+        const uintptr_t aligned =
+            (base + FFTW_PLAN_ALIGNMENT - 1) / FFTW_PLAN_ALIGNMENT *
+            FFTW_PLAN_ALIGNMENT;
+        m_ptr = reinterpret_cast<void *>(aligned + offset);
+    }
+
+    void *get() const { return m_ptr; }
+};
+
+void appendLayout(string &key, int rank, const FFTWLayout &layout) {
+    if (layout.embed) {
+        for (int r = 0; r < rank; ++r) {
+            key += to_string(layout.embed[r]) + ":";
+        }
+    }
+    key += to_string(layout.stride) + ":" + to_string(layout.dist) + ":";
+}
+
+template<typename Tr>
+SharedFFTWPlan createPlan(FFTWKind kind, int rank, const int *n, int batch,
+                          const void *in, const FFTWLayout &inLayout,
+                          const void *out, const FFTWLayout &outLayout,
+                          unsigned flags, int threads) {
+    const unsigned rigor = rigorFlags();
+    void *planIn         = const_cast<void *>(in);
+    void *planOut        = const_cast<void *>(out);
+
+    // FFTW_ESTIMATE does not touch the data, the other rigors overwrite it
+    vector<MeasureBuffer> buffers;
+    if (rigor != FFTW_ESTIMATE) {
+        const size_t complexBytes = 2 * sizeof(Tr);
+        const size_t inBytes =
+            inLayout.elements *
+            (kind == FFTWKind::RealToComplex ? sizeof(Tr) : complexBytes);
+        const size_t outBytes =
+            outLayout.elements *
+            (kind == FFTWKind::ComplexToReal ? sizeof(Tr) : complexBytes);
+        buffers.reserve(2);
+        buffers.emplace_back(std::max(inBytes, outBytes), in);
+        planIn = buffers.back().get();
+        if (in == out) {
+            planOut = planIn;
+        } else {
+            buffers.emplace_back(outBytes, out);
+            planOut = buffers.back().get();
+        }
+    }
+
+    fftw_api<Tr>::planWithThreads(threads);
+    typename fftw_api<Tr>::plan_t plan =
+        fftw_api<Tr>::create(kind, rank, n, batch, planIn, inLayout, planOut,
+                             outLayout, flags | rigor);
+    if (!plan) { AF_ERROR("Failed to create the FFTW plan", AF_ERR_INTERNAL); }
+    if (rigor != FFTW_ESTIMATE) { saveWisdom<Tr>(); }
+
+    return SharedFFTWPlan(new FFTWPlan{plan, std::is_same<Tr, double>::value},
+                          [](FFTWPlan *p) {
+                              lock_guard<recursive_mutex> lock(
+                                  getPlannerMutex());
+                              fftw_api<Tr>::destroy(p->plan);
+                              delete p;
+                          });
+}
+
+}  // namespace
+
+dim_t fftwElements(const af::dim4 &dims, const af::dim4 &strides) {
+    dim_t elements = 1;
+    for (int i = 0; i < AF_MAX_DIMS; ++i) {
+        if (dims[i] == 0) { return 0; }
+        elements += (dims[i] - 1) * strides[i];
+    }
+    return elements;
+}
+
+SharedFFTWPlan findPlan(bool isDouble, FFTWKind kind, int rank, const int *n,
+                        int batch, const void *in, const FFTWLayout &inLayout,
+                        const void *out, const FFTWLayout &outLayout,
+                        unsigned flags) {
+    dim_t elements = batch;
+    for (int r = 0; r < rank; ++r) { elements *= n[r]; }
+    const int threads = static_cast<int>(std::max<dim_t>(
+        1, std::min<dim_t>(getFFTMaxThreads(),
+                           elements / FFTW_MIN_THREAD_ELEMENTS)));
+
+    // The plans are executed on new arrays, which must have the alignment
+    // and the placement of the arrays of the plan
+    string key = to_string(isDouble) + ":" + to_string(static_cast<int>(kind)) +
+                 ":" + to_string(rank) + ":";
+    for (int r = 0; r < rank; ++r) { key += to_string(n[r]) + ":"; }
+    appendLayout(key, rank, inLayout);
+    appendLayout(key, rank, outLayout);
+    key += to_string(batch) + ":" + to_string(flags) + ":" +
+           to_string(threads) + ":" + to_string(rigorFlags()) + ":" +
+           to_string(in == out) + ":" +
+           to_string(reinterpret_cast<uintptr_t>(in) % FFTW_PLAN_ALIGNMENT) +
+           ":" +
+           to_string(reinterpret_cast<uintptr_t>(out) % FFTW_PLAN_ALIGNMENT);
+
+    lock_guard<recursive_mutex> lock(getPlannerMutex());
+    PlanCache &planner    = fftManager();
+    SharedFFTWPlan retVal = planner.find(key);
+    if (retVal) { return retVal; }
+
+    if (isDouble) {
+        initPlanner<double>();
+        retVal = createPlan<double>(kind, rank, n, batch, in, inLayout, out,
+                                    outLayout, flags, threads);
+    } else {
+        initPlanner<float>();
+        retVal = createPlan<float>(kind, rank, n, batch, in, inLayout, out,
+                                   outLayout, flags, threads);
+    }
+
+    // FFTW does not report the memory held by a plan
+    planner.push(key, retVal);
+    return retVal;
+}
+
+void executePlan(const FFTWPlan &plan, FFTWKind kind, void *in, void *out) {
+    if (plan.isDouble) {
+        fftw_api<double>::execute(plan.plan, kind, in, out);
+    } else {
+        fftw_api<float>::execute(plan.plan, kind, in, out);
+    }
+}
+
+void setFFTWPlanCacheSize(size_t numPlans) {
+    lock_guard<recursive_mutex> lock(getPlannerMutex());
+    fftManager().setMaxCacheSize(numPlans);
+}
+
+}  // namespace cpu
@@ -0,0 +1,84 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/FFTPlanCache.hpp>
+#include <af/dim4.hpp>
+
+#include <memory>
+
+namespace cpu {
+
+/// The kinds of FFTW transforms
+enum class FFTWKind { Forward, Backward, RealToComplex, ComplexToReal };
+
+/// An FFTW plan of either precision. The plans are created on buffers with
+/// the alignment of the arrays they are executed on, so they can be executed
+/// on any arrays of the same shape and alignment.
+struct FFTWPlan {
+    void *plan;
+    bool isDouble;
+};
+
+typedef std::shared_ptr<FFTWPlan> SharedFFTWPlan;
+
+/// The shape of the data of a batch of transforms (see fftw_plan_many_dft)
+struct FFTWLayout {
+    /// The number of elements of the data, including the gaps of strided
+    /// data. Used to allocate the buffers of the measured plans.
+    dim_t elements;
+    /// The embedded dimensions, from the slowest to the fastest varying, or
+    /// null if the data is not embedded
+    const int *embed;
+    int stride;
+    int dist;
+};
+
+/// Returns the number of elements spanned by data of \p dims and \p strides
+dim_t fftwElements(const af::dim4 &dims, const af::dim4 &strides);
+
+/// Finds the cached plan of a batch of transforms or creates a new one.
+///
+/// New plans are created with the rigor of AF_CPU_FFT_PLAN_RIGOR and the
+/// FFTW threads allowed by AF_CPU_FFT_THREADS. The plans which are measured
+/// are saved in the FFTW wisdom of the cache directory, so they are only
+/// measured once.
+///
+/// \param[in] isDouble Whether the plan is for double precision data
+/// \param[in] kind     The kind of the transforms
+/// \param[in] rank     The rank of the transforms
+/// \param[in] n        The size of the transforms, from the slowest to the
+///                     fastest varying dimension
+/// \param[in] batch    The number of transforms
+/// \param[in] in       The input of the transforms
+/// \param[in] inLayout The shape of the input
+/// \param[in] out      The output of the transforms, which may be \p in
+/// \param[in] outLayout The shape of the output
+/// \param[in] flags    The additional FFTW planner flags
+SharedFFTWPlan findPlan(bool isDouble, FFTWKind kind, int rank, const int *n,
+                        int batch, const void *in, const FFTWLayout &inLayout,
+                        const void *out, const FFTWLayout &outLayout,
+                        unsigned flags);
+
+/// Executes \p plan on \p in and \p out, which must have the shape and the
+/// alignment of the data the plan was found for
+void executePlan(const FFTWPlan &plan, FFTWKind kind, void *in, void *out);
+
+class PlanCache : public common::FFTPlanCache<PlanCache, FFTWPlan> {
+    friend SharedFFTWPlan findPlan(bool isDouble, FFTWKind kind, int rank,
+                                   const int *n, int batch, const void *in,
+                                   const FFTWLayout &inLayout, const void *out,
+                                   const FFTWLayout &outLayout, unsigned flags);
+};
+
+/// Sets the maximum number of cached FFTW plans
+void setFFTWPlanCacheSize(size_t numPlans);
+
+}  // namespace cpu
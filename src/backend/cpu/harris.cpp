@@ -8,7 +8,6 @@
  ********************************************************/
 
 #include <Array.hpp>
-#include <convolve.hpp>
 #include <gradient.hpp>
 #include <harris.hpp>
 #include <kernel/harris.hpp>
@@ -52,25 +51,14 @@ unsigned harris(Array<float> &x_out, Array<float> &y_out,
     // Compute first order derivatives
     gradient<T>(iy, ix, in);
 
-    Array<T> ixx = createEmptyArray<T>(idims);
-    Array<T> ixy = createEmptyArray<T>(idims);
-    Array<T> iyy = createEmptyArray<T>(idims);
-
-    // Compute second-order derivatives
-    getQueue().enqueue(kernel::second_order_deriv<T>, ixx, ixy, iyy,
-                       in.elements(), ix, iy);
-
-    // Convolve second-order derivatives with proper window filter
-    ixx = convolve2<T, convAccT>(ixx, filter, filter, false);
-    ixy = convolve2<T, convAccT>(ixy, filter, filter, false);
-    iyy = convolve2<T, convAccT>(iyy, filter, filter, false);
-
     const unsigned corner_lim = in.elements() * 0.2f;
 
     Array<T> responses = createEmptyArray<T>(dim4(in.elements()));
 
-    getQueue().enqueue(kernel::harris_responses<T>, responses, idims[0],
-                       idims[1], ixx, ixy, iyy, k_thr, border_len);
+    // Filters the products of the derivatives and computes the responses
+    // without intermediate arrays
+    getQueue().enqueue(kernel::harris_responses<T, convAccT>, responses, ix,
+                       iy, filter, k_thr, border_len);
 
     Array<float> xCorners    = createEmptyArray<float>(dim4(corner_lim));
     Array<float> yCorners    = createEmptyArray<float>(dim4(corner_lim));
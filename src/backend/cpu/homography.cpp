@@ -11,6 +11,7 @@
 #include <arith.hpp>
 #include <err_cpu.hpp>
 #include <homography.hpp>
+#include <parallel_for.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <af/dim4.hpp>
@@ -260,6 +261,24 @@ int computeHomography(T* H_ptr, const float* rnd_ptr, const float* x_src_ptr,
     return 0;
 }
 
+/// Returns the squared distance between the destination of sample \p j and
+/// its source transformed by \p H_ptr
+template<typename T>
+float transferError(const T* H_ptr, const float* x_src_ptr,
+                    const float* y_src_ptr, const float* x_dst_ptr,
+                    const float* y_dst_ptr, const unsigned j) {
+    float z = H_ptr[6] * x_src_ptr[j] + H_ptr[7] * y_src_ptr[j] + H_ptr[8];
+    float x =
+        (H_ptr[0] * x_src_ptr[j] + H_ptr[1] * y_src_ptr[j] + H_ptr[2]) / z;
+    float y =
+        (H_ptr[3] * x_src_ptr[j] + H_ptr[4] * y_src_ptr[j] + H_ptr[5]) / z;
+    return sq(x_dst_ptr[j] - x) + sq(y_dst_ptr[j] - y);
+}
+
+/// The number of hypotheses scored in parallel between the updates of the
+/// number of RANSAC iterations
+constexpr unsigned HYPOTHESIS_BLOCK = 64;
+
 // LMedS:
 // http://research.microsoft.com/en-us/um/people/zhang/INRIA/Publis/Tutorial-Estim/node25.html
 template<typename T>
@@ -286,67 +305,74 @@ int findBestHomography(Array<T>& bestH, const Array<float>& x_src,
     int bestInliers  = 0;
     float minMedian  = FLT_MAX;
 
-    for (unsigned i = 0; i < iter; i++) {
-        const unsigned Hidx = Hdims[0] * i;
-        T* H_ptr            = H.get() + Hidx;
-
-        const unsigned ridx  = rdims[0] * i;
-        const float* rnd_ptr = rnd.get() + ridx;
-
-        if (computeHomography<T>(H_ptr, rnd_ptr, x_src_ptr, y_src_ptr,
-                                 x_dst_ptr, y_dst_ptr)) {
-            continue;
-        }
-
-        if (htype == AF_HOMOGRAPHY_RANSAC) {
-            int inliers_count = 0;
-            for (unsigned j = 0; j < nsamples; j++) {
-                float z = H_ptr[6] * x_src_ptr[j] + H_ptr[7] * y_src_ptr[j] +
-                          H_ptr[8];
-                float x = (H_ptr[0] * x_src_ptr[j] + H_ptr[1] * y_src_ptr[j] +
-                           H_ptr[2]) /
-                          z;
-                float y = (H_ptr[3] * x_src_ptr[j] + H_ptr[4] * y_src_ptr[j] +
-                           H_ptr[5]) /
-                          z;
-
-                float dist = sq(x_dst_ptr[j] - x) + sq(y_dst_ptr[j] - y);
-                if (dist < (inlier_thr * inlier_thr)) { inliers_count++; }
-            }
-            iter =
-                updateIterations(static_cast<float>(nsamples - inliers_count) /
-                                     static_cast<float>(nsamples),
-                                 iter);
-            if (inliers_count > bestInliers) {
-                bestIdx     = i;
-                bestInliers = inliers_count;
-            }
-        } else if (htype == AF_HOMOGRAPHY_LMEDS) {
-            vector<float> err(nsamples);
-            for (unsigned j = 0; j < nsamples; j++) {
-                float z = H_ptr[6] * x_src_ptr[j] + H_ptr[7] * y_src_ptr[j] +
-                          H_ptr[8];
-                float x = (H_ptr[0] * x_src_ptr[j] + H_ptr[1] * y_src_ptr[j] +
-                           H_ptr[2]) /
-                          z;
-                float y = (H_ptr[3] * x_src_ptr[j] + H_ptr[4] * y_src_ptr[j] +
-                           H_ptr[5]) /
-                          z;
-
-                float dist = sq(x_dst_ptr[j] - x) + sq(y_dst_ptr[j] - y);
-                err[j]     = sqrt(dist);
-            }
-
-            stable_sort(err.begin(), err.end());
-
-            float median = err[nsamples / 2];
-            if (nsamples % 2 == 0) {
-                median = (median + err[nsamples / 2 - 1]) * 0.5f;
+    // The hypotheses of a block are scored by the thread pool. They are
+    // then visited in order, which updates the number of iterations as if
+    // they were scored one at a time, and ends the search early when the
+    // hypotheses past it are not needed.
+    vector<char> valid(HYPOTHESIS_BLOCK);
+    vector<int> inliers(HYPOTHESIS_BLOCK);
+    vector<float> medians(HYPOTHESIS_BLOCK);
+    for (unsigned first = 0; first < iter; first += HYPOTHESIS_BLOCK) {
+        const unsigned count = min(HYPOTHESIS_BLOCK, iter - first);
+
+        parallelFor(count, 64 * nsamples, [&](dim_t begin, dim_t end) {
+            vector<float> err(htype == AF_HOMOGRAPHY_LMEDS ? nsamples : 0);
+            for (dim_t k = begin; k < end; ++k) {
+                const unsigned i     = first + static_cast<unsigned>(k);
+                T* H_ptr             = H.get() + Hdims[0] * i;
+                const float* rnd_ptr = rnd.get() + rdims[0] * i;
+
+                valid[k] = computeHomography<T>(H_ptr, rnd_ptr, x_src_ptr,
+                                                y_src_ptr, x_dst_ptr,
+                                                y_dst_ptr) == 0;
+                if (!valid[k]) { continue; }
+
+                if (htype == AF_HOMOGRAPHY_RANSAC) {
+                    int inliers_count = 0;
+                    for (unsigned j = 0; j < nsamples; j++) {
+                        float dist = transferError(H_ptr, x_src_ptr, y_src_ptr,
+                                                   x_dst_ptr, y_dst_ptr, j);
+                        if (dist < (inlier_thr * inlier_thr)) {
+                            inliers_count++;
+                        }
+                    }
+                    inliers[k] = inliers_count;
+                } else if (htype == AF_HOMOGRAPHY_LMEDS) {
+                    for (unsigned j = 0; j < nsamples; j++) {
+                        err[j] = sqrt(transferError(H_ptr, x_src_ptr,
+                                                    y_src_ptr, x_dst_ptr,
+                                                    y_dst_ptr, j));
+                    }
+
+                    stable_sort(err.begin(), err.end());
+
+                    float median = err[nsamples / 2];
+                    if (nsamples % 2 == 0) {
+                        median = (median + err[nsamples / 2 - 1]) * 0.5f;
+                    }
+                    medians[k] = median;
+                }
             }
-
-            if (median < minMedian && median > FLT_EPSILON) {
-                minMedian = median;
-                bestIdx   = i;
+        });
+
+        for (unsigned i = first; i < first + count && i < iter; i++) {
+            const unsigned k = i - first;
+            if (!valid[k]) { continue; }
+
+            if (htype == AF_HOMOGRAPHY_RANSAC) {
+                iter = updateIterations(
+                    static_cast<float>(nsamples - inliers[k]) /
+                        static_cast<float>(nsamples),
+                    iter);
+                if (inliers[k] > bestInliers) {
+                    bestIdx     = i;
+                    bestInliers = inliers[k];
+                }
+            } else if (htype == AF_HOMOGRAPHY_LMEDS) {
+                if (medians[k] < minMedian && medians[k] > FLT_EPSILON) {
+                    minMedian = medians[k];
+                    bestIdx   = i;
+                }
             }
         }
     }
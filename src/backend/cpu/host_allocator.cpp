@@ -0,0 +1,150 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <host_allocator.hpp>
+
+#include <common/util.hpp>
+#include <parallel_for.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(OS_WIN)
+#include <malloc.h>
+#elif defined(OS_LNX)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using std::size_t;
+using std::string;
+using std::vector;
+
+namespace cpu {
+
+namespace {
+
+constexpr size_t ALIGNMENT       = 64;
+constexpr size_t HUGE_PAGE_BYTES = size_t(2) << 20;
+constexpr size_t PAGE_BYTES      = 4096;
+
+enum class NumaPolicy { System, Interleave, FirstTouch };
+
+/// Returns the NUMA policy of the large buffers (see AF_CPU_NUMA_POLICY)
+NumaPolicy numaPolicy() {
+    static const NumaPolicy policy = [] {
+        const string env = getEnvVar("AF_CPU_NUMA_POLICY");
+        if (env == "interleave") { return NumaPolicy::Interleave; }
+        if (env == "firsttouch") { return NumaPolicy::FirstTouch; }
+        return NumaPolicy::System;
+    }();
+    return policy;
+}
+
+#if defined(OS_LNX)
+/// Returns true if the large buffers use transparent huge pages (see
+/// AF_CPU_HUGE_PAGES)
+bool useHugePages() {
+    static const bool use = getEnvVar("AF_CPU_HUGE_PAGES") != "0";
+    return use;
+}
+
+/// Returns the mask of the online NUMA nodes, which is empty if the system
+/// has a single node. The list of /sys has the form "0-1,3".
+vector<unsigned long> onlineNodes() {
+    constexpr int bitsPerWord = 8 * sizeof(unsigned long);
+    vector<unsigned long> mask;
+    std::ifstream file("/sys/devices/system/node/online");
+    string list;
+    if (!(file >> list)) { return mask; }
+
+    int count  = 0;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == string::npos) { end = list.size(); }
+        const string range = list.substr(pos, end - pos);
+        const size_t dash  = range.find('-');
+        const int first    = std::stoi(range.substr(0, dash));
+        const int last =
+            dash == string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int node = first; node <= last; ++node) {
+            const size_t word = node / bitsPerWord;
+            if (mask.size() <= word) { mask.resize(word + 1, 0); }
+            mask[word] |= 1UL << (node % bitsPerWord);
+            ++count;
+        }
+        pos = end + 1;
+    }
+    if (count < 2) { mask.clear(); }
+    return mask;
+}
+
+/// Spreads the pages of the memory over all the nodes, so the threads of
+/// every node read it with the same bandwidth
+void interleave(void *ptr, const size_t bytes) {
+    constexpr int MPOL_INTERLEAVE_MODE = 3;
+    static const vector<unsigned long> nodes = onlineNodes();
+    if (nodes.empty()) { return; }
+    // The policy is a hint, so a failure keeps the policy of the system
+    syscall(SYS_mbind, ptr, bytes, MPOL_INTERLEAVE_MODE, nodes.data(),
+            nodes.size() * 8 * sizeof(unsigned long) + 1, 0);
+}
+#endif
+
+/// Writes the pages of the memory with the thread pool, in the contiguous
+/// ranges in which parallelFor splits work, so each page is placed on the
+/// node of the thread which is likely to process it. This matches the
+/// kernels best when the threads are bound to cores (see
+/// AF_CPU_THREAD_AFFINITY).
+void firstTouch(void *ptr, const size_t bytes) {
+    char *data        = static_cast<char *>(ptr);
+    const dim_t pages = divup(static_cast<dim_t>(bytes), PAGE_BYTES);
+    parallelFor(pages, PAGE_BYTES, [data](dim_t first, dim_t last) {
+        for (dim_t page = first; page < last; ++page) {
+            data[page * PAGE_BYTES] = 0;
+        }
+    });
+}
+
+}  // namespace
+
+void *hostAlloc(const size_t bytes) {
+    const bool large = bytes >= HUGE_PAGE_BYTES;
+#if defined(OS_WIN)
+    void *ptr = _aligned_malloc(bytes, ALIGNMENT);
+#else
+    void *ptr = nullptr;
+    const size_t alignment = large ? HUGE_PAGE_BYTES : ALIGNMENT;
+    if (posix_memalign(&ptr, alignment, bytes) != 0) { return nullptr; }
+#endif
+    if (!ptr || !large) { return ptr; }
+
+#if defined(OS_LNX)
+#if defined(MADV_HUGEPAGE)
+    if (useHugePages()) { madvise(ptr, bytes, MADV_HUGEPAGE); }
+#endif
+    if (numaPolicy() == NumaPolicy::Interleave) { interleave(ptr, bytes); }
+#endif
+    if (numaPolicy() == NumaPolicy::FirstTouch) { firstTouch(ptr, bytes); }
+    return ptr;
+}
+
+void hostFree(void *ptr) {
+#if defined(OS_WIN)
+    _aligned_free(ptr);
+#else
+    free(ptr);  // NOLINT(hicpp-no-malloc)
+#endif
+}
+
+}  // namespace cpu
@@ -0,0 +1,29 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+namespace cpu {
+
+/// Allocates the host memory of the buffers of the memory manager.
+///
+/// The buffers are aligned to 64 bytes, a cache line and an AVX-512 vector.
+/// On Linux the buffers of at least 2 MiB are aligned to 2 MiB and marked
+/// for transparent huge pages (see AF_CPU_HUGE_PAGES), and their pages are
+/// placed on the NUMA nodes by the policy of AF_CPU_NUMA_POLICY.
+///
+/// \returns the memory, or nullptr if it could not be allocated
+void *hostAlloc(std::size_t bytes);
+
+/// Frees memory allocated by hostAlloc
+void hostFree(void *ptr);
+
+}  // namespace cpu
@@ -10,17 +10,24 @@
 #include <kernel/identity.hpp>
 
 #include <Array.hpp>
+#include <common/complex.hpp>
 #include <common/half.hpp>
+#include <jit/IndexNode.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <af/dim4.hpp>
 
+#include <memory>
+
 using common::half;  // NOLINT(misc-unused-using-decls) bug in clang-tidy
 
 namespace cpu {
 
+namespace {
+
+// The JIT does not convert the comparison of the indices to complex values
 template<typename T>
-Array<T> identity(const dim4& dims) {
+common::if_complex<T, Array<T>> identityArray(const dim4& dims) {
     Array<T> out = createEmptyArray<T>(dims);
 
     getQueue().enqueue(kernel::identity<T>, out);
@@ -28,6 +35,20 @@ Array<T> identity(const dim4& dims) {
     return out;
 }
 
+template<typename T>
+common::if_real<T, Array<T>> identityArray(const dim4& dims) {
+    return createNodeArray<T>(
+        dims, std::make_shared<jit::IndexNode<T>>(
+                  common::IndexParams(common::IndexKind::Identity, dims)));
+}
+
+}  // namespace
+
+template<typename T>
+Array<T> identity(const dim4& dims) {
+    return identityArray<T>(dims);
+}
+
 #define INSTANTIATE_IDENTITY(T) \
     template Array<T> identity<T>(const af::dim4& dims);
 
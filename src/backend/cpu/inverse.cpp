@@ -21,6 +21,7 @@
 #include <identity.hpp>
 #include <lapack_helper.hpp>
 #include <lu.hpp>
+#include <parallel_for.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <solve.hpp>
@@ -60,8 +61,12 @@ Array<T> inverse(const Array<T> &in) {
     Array<int> pivot = lu_inplace<T>(A, false);
 
     auto func = [=](Param<T> A, Param<int> pivot, int M) {
-        getri_func<T>()(AF_LAPACK_COL_MAJOR, M, A.get(), A.strides(1),
-                        pivot.get());
+        parallelForSlices(A.dims(), M * M * M, [&](dim_t z, dim_t w) {
+            getri_func<T>()(
+                AF_LAPACK_COL_MAJOR, M,
+                A.get() + z * A.strides(2) + w * A.strides(3), A.strides(1),
+                pivot.get() + z * pivot.strides(2) + w * pivot.strides(3));
+        });
     };
     getQueue().enqueue(func, A, pivot, M);
 
@@ -7,13 +7,13 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 #include <iota.hpp>
-#include <kernel/iota.hpp>
 
 #include <Array.hpp>
 #include <common/half.hpp>
+#include <jit/IndexNode.hpp>
 #include <math.hpp>
-#include <platform.hpp>
-#include <queue.hpp>
+
+#include <memory>
 
 using common::half;  // NOLINT(misc-unused-using-decls) bug in clang-tidy
 
@@ -23,11 +23,9 @@ template<typename T>
 Array<T> iota(const dim4 &dims, const dim4 &tile_dims) {
     dim4 outdims = dims * tile_dims;
 
-    Array<T> out = createEmptyArray<T>(outdims);
-
-    getQueue().enqueue(kernel::iota<T>, out, dims);
-
-    return out;
+    return createNodeArray<T>(
+        outdims, std::make_shared<jit::IndexNode<T>>(common::IndexParams(
+                     common::IndexKind::Iota, outdims, 0, dims)));
 }
 
 #define INSTANTIATE(T) \
@@ -22,68 +22,25 @@ using common::half;
 
 namespace cpu {
 
-template<af_op_t op, typename T>
-using ireduce_dim_func =
-    std::function<void(Param<T>, Param<uint>, const dim_t, CParam<T>,
-                       const dim_t, const int, CParam<uint>)>;
-
 template<af_op_t op, typename T>
 void ireduce(Array<T> &out, Array<uint> &loc, const Array<T> &in,
              const int dim) {
-    dim4 odims       = in.dims();
-    odims[dim]       = 1;
     Array<uint> rlen = createEmptyArray<uint>(af::dim4(0));
-    static const ireduce_dim_func<op, T> ireduce_funcs[] = {
-        kernel::ireduce_dim<op, T, 1>(), kernel::ireduce_dim<op, T, 2>(),
-        kernel::ireduce_dim<op, T, 3>(), kernel::ireduce_dim<op, T, 4>()};
-
-    getQueue().enqueue(ireduce_funcs[in.ndims() - 1], out, loc, 0, in, 0, dim,
-                       rlen);
+    getQueue().enqueue(kernel::ireduce<op, T>, out, loc, in, dim, rlen);
 }
 
 template<af_op_t op, typename T>
 void rreduce(Array<T> &out, Array<uint> &loc, const Array<T> &in, const int dim,
              const Array<uint> &rlen) {
-    dim4 odims = in.dims();
-    odims[dim] = 1;
-
-    static const ireduce_dim_func<op, T> ireduce_funcs[] = {
-        kernel::ireduce_dim<op, T, 1>(), kernel::ireduce_dim<op, T, 2>(),
-        kernel::ireduce_dim<op, T, 3>(), kernel::ireduce_dim<op, T, 4>()};
-
-    getQueue().enqueue(ireduce_funcs[in.ndims() - 1], out, loc, 0, in, 0, dim,
-                       rlen);
+    getQueue().enqueue(kernel::ireduce<op, T>, out, loc, in, dim, rlen);
 }
 
 template<af_op_t op, typename T>
 T ireduce_all(unsigned *loc, const Array<T> &in) {
+    T out;
+    getQueue().enqueue(kernel::ireduce_all<op, T>, &out, loc, in);
     getQueue().sync();
-
-    af::dim4 dims    = in.dims();
-    af::dim4 strides = in.strides();
-    const T *inPtr   = in.get();
-
-    kernel::MinMaxOp<op, T> Op(inPtr[0], 0);
-
-    for (dim_t l = 0; l < dims[3]; l++) {
-        dim_t off3 = l * strides[3];
-
-        for (dim_t k = 0; k < dims[2]; k++) {
-            dim_t off2 = k * strides[2];
-
-            for (dim_t j = 0; j < dims[1]; j++) {
-                dim_t off1 = j * strides[1];
-
-                for (dim_t i = 0; i < dims[0]; i++) {
-                    dim_t idx = i + off1 + off2 + off3;
-                    Op(inPtr[idx], idx);
-                }
-            }
-        }
-    }
-
-    *loc = Op.m_idx;
-    return Op.m_val;
+    return out;
 }
 
 #define INSTANTIATE(ROp, T)                                           \
@@ -9,9 +9,13 @@
 
 #pragma once
 
+#include <compiled_jit.hpp>
 #include <math.hpp>
 #include <optypes.hpp>
 #include <array>
+#include <memory>
+#include <sstream>
+#include <string>
 #include <vector>
 #include "Node.hpp"
 
@@ -36,6 +40,27 @@ class BinaryNode : public TNode<compute_t<To>> {
         , m_lhs(reinterpret_cast<TNode<compute_t<Ti>> *>(lhs.get()))
         , m_rhs(reinterpret_cast<TNode<compute_t<Ti>> *>(rhs.get())) {}
 
+    common::Node_ptr clone() const final {
+        return common::makePooled<BinaryNode>(*this);
+    }
+
+    void replaceChild(int index, common::Node_ptr child) final {
+        auto *ptr = reinterpret_cast<TNode<compute_t<Ti>> *>(child.get());
+        if (index == 0) {
+            m_lhs = ptr;
+        } else {
+            m_rhs = ptr;
+        }
+        common::Node::replaceChild(index, std::move(child));
+    }
+
+    /// The operation is part of the type of the node so nodes of the same
+    /// type with the same children are equal
+    bool isEqual(const common::Node &other) const final {
+        UNUSED(other);
+        return true;
+    }
+
     void calc(int x, int y, int z, int w, int lim) final {
         UNUSED(x);
         UNUSED(y);
@@ -51,8 +76,14 @@ class BinaryNode : public TNode<compute_t<To>> {
 
     void genKerName(std::string &kerString,
                     const common::Node_ids &ids) const final {
-        UNUSED(kerString);
-        UNUSED(ids);
+        kerString += '_';
+        kerString += std::to_string(op);
+        kerString += ',';
+        kerString += std::to_string(ids.child_ids[0]);
+        kerString += ',';
+        kerString += std::to_string(ids.child_ids[1]);
+        kerString += ',';
+        kerString += std::to_string(ids.id);
     }
 
     void genParams(std::stringstream &kerStream, int id,
@@ -79,8 +110,15 @@ class BinaryNode : public TNode<compute_t<To>> {
 
     void genFuncs(std::stringstream &kerStream,
                   const common::Node_ids &ids) const final {
-        UNUSED(kerStream);
-        UNUSED(ids);
+        const char *type = getTypeName<compute_t<To>>();
+        kerStream << "const " << type << " v" << ids.id << " = "
+                  << getOpName(op) << "<" << type << ">(v" << ids.child_ids[0]
+                  << ", v" << ids.child_ids[1] << ");\n";
+    }
+
+    bool isCompilable() const final {
+        return getOpName(op) && getTypeName<compute_t<To>>() &&
+               getTypeName<compute_t<Ti>>();
     }
 };
 
@@ -9,10 +9,16 @@
 
 #pragma once
 
+#include <compiled_jit.hpp>
+#include <convert_half.hpp>
 #include <optypes.hpp>
 #include <af/defines.h>
 
+#include <algorithm>
+#include <memory>
 #include <mutex>
+#include <sstream>
+#include <string>
 #include <vector>
 #include "Node.hpp"
 namespace cpu {
@@ -34,6 +40,14 @@ class BufferNode : public TNode<T> {
    public:
     BufferNode() : TNode<T>(T(0), 0, {}) {}
 
+    common::Node_ptr clone() const final {
+        // std::once_flag is not copyable so the node is created from scratch
+        auto node = common::makePooled<BufferNode>();
+        node->setData(m_sptr, m_bytes, m_ptr - m_sptr.get(), m_dims,
+                      m_strides, m_linear_buffer);
+        return node;
+    }
+
     void setData(shared_ptr<T> data, unsigned bytes, dim_t data_off,
                  const dim_t *dims, const dim_t *strides,
                  const bool is_linear) {
@@ -59,9 +73,13 @@ class BufferNode : public TNode<T> {
         l_off += (y < (int)m_dims[1]) * y * m_strides[1];
         T *in_ptr   = m_ptr + l_off;
         Tc *out_ptr = this->m_val.data();
-        for (int i = 0; i < lim; i++) {
-            out_ptr[i] =
-                static_cast<Tc>(in_ptr[((x + i) < m_dims[0]) ? (x + i) : 0]);
+        if (x + lim <= m_dims[0]) {
+            convertValues(out_ptr, in_ptr + x, lim);
+        } else {
+            for (int i = 0; i < lim; i++) {
+                out_ptr[i] = static_cast<Tc>(
+                    in_ptr[((x + i) < m_dims[0]) ? (x + i) : 0]);
+            }
         }
     }
 
@@ -70,9 +88,7 @@ class BufferNode : public TNode<T> {
 
         T *in_ptr   = m_ptr + idx;
         Tc *out_ptr = this->m_val.data();
-        for (int i = 0; i < lim; i++) {
-            out_ptr[i] = static_cast<Tc>(in_ptr[i]);
-        }
+        convertValues(out_ptr, in_ptr, lim);
     }
 
     void getInfo(unsigned &len, unsigned &buf_count,
@@ -87,36 +103,55 @@ class BufferNode : public TNode<T> {
 
     void genKerName(std::string &kerString,
                     const common::Node_ids &ids) const final {
-        UNUSED(kerString);
-        UNUSED(ids);
+        kerString += '_';
+        kerString += std::to_string(this->m_type);
+        kerString += ',';
+        kerString += std::to_string(ids.id);
     }
 
     void genParams(std::stringstream &kerStream, int id,
                    bool is_linear) const final {
-        UNUSED(kerStream);
-        UNUSED(id);
         UNUSED(is_linear);
+        const char *type = getTypeName<T>();
+        kerStream << "const " << type << " *in" << id << " = (const " << type
+                  << " *)(*arg++);\n"
+                  << "const dim_t *dims" << id
+                  << " = (const dim_t *)(*arg++);\n"
+                  << "const dim_t *strides" << id
+                  << " = (const dim_t *)(*arg++);\n";
     }
 
     int setArgs(int start_id, bool is_linear,
                 std::function<void(int id, const void *ptr, size_t arg_size)>
                     setArg) const override {
         UNUSED(is_linear);
-        UNUSED(setArg);
-        return start_id++;
+        setArg(start_id, static_cast<const void *>(m_ptr), m_bytes);
+        setArg(start_id + 1, static_cast<const void *>(m_dims),
+               sizeof(m_dims));
+        setArg(start_id + 2, static_cast<const void *>(m_strides),
+               sizeof(m_strides));
+        return start_id + 3;
     }
 
     void genOffsets(std::stringstream &kerStream, int id,
                     bool is_linear) const final {
-        UNUSED(kerStream);
-        UNUSED(id);
-        UNUSED(is_linear);
+        kerStream << "const dim_t off" << id << " = ";
+        if (is_linear) {
+            kerStream << "idx;\n";
+            return;
+        }
+        for (int dim = 3; dim > 0; dim--) {
+            kerStream << "(id" << dim << " < dims" << id << "[" << dim
+                      << "]) * id" << dim << " * strides" << id << "[" << dim
+                      << "] + ";
+        }
+        kerStream << "(id0 < dims" << id << "[0] ? id0 : 0);\n";
     }
 
     void genFuncs(std::stringstream &kerStream,
                   const common::Node_ids &ids) const final {
-        UNUSED(kerStream);
-        UNUSED(ids);
+        kerStream << "const " << getTypeName<T>() << " v" << ids.id << " = in"
+                  << ids.id << "[off" << ids.id << "];\n";
     }
 
     bool isLinear(dim_t *dims) const final {
@@ -126,6 +161,23 @@ class BufferNode : public TNode<T> {
     }
 
     bool isBuffer() const final { return true; }
+
+    /// Returns the memory read by the node
+    const shared_ptr<T> &getData() const { return m_sptr; }
+
+    /// Returns the offset of the first element read by the node
+    dim_t getOffset() const { return m_ptr - m_sptr.get(); }
+
+    /// Buffers are equal if they read the same memory in the same way
+    bool isEqual(const common::Node &other) const final {
+        const auto &node = static_cast<const BufferNode &>(other);
+        return m_ptr == node.m_ptr && m_bytes == node.m_bytes &&
+               m_linear_buffer == node.m_linear_buffer &&
+               std::equal(m_dims, m_dims + 4, node.m_dims) &&
+               std::equal(m_strides, m_strides + 4, node.m_strides);
+    }
+
+    bool isCompilable() const final { return getTypeName<T>() != nullptr; }
 };
 
 }  // namespace jit
@@ -0,0 +1,111 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <common/jit/IndexNode.hpp>
+#include <compiled_jit.hpp>
+#include <memory>
+#include <sstream>
+#include <string>
+#include "Node.hpp"
+
+namespace cpu {
+
+namespace jit {
+
+/// Generates the values of a range, an iota or an identity array in the
+/// evaluation of the JIT tree which uses it, see common::IndexNode
+template<typename T>
+class IndexNode : public TNode<T> {
+   private:
+    common::IndexParams m_params;
+
+   public:
+    IndexNode(const common::IndexParams &params)
+        : TNode<T>(T(0), 0, {}), m_params(params) {
+        this->updateHash('I');
+        this->updateHash(m_params.kind);
+        this->updateHash(m_params.dim);
+    }
+
+    common::Node_ptr clone() const final {
+        return common::makePooled<IndexNode>(*this);
+    }
+
+    void calc(int x, int y, int z, int w, int lim) final {
+        using Tc = compute_t<T>;
+        for (int i = 0; i < lim; i++) {
+            this->m_val[i] = static_cast<Tc>(m_params.value(x + i, y, z, w));
+        }
+    }
+
+    void calc(int idx, int lim) final {
+        using Tc = compute_t<T>;
+        for (int i = 0; i < lim; i++) {
+            this->m_val[i] = static_cast<Tc>(m_params.value(idx + i));
+        }
+    }
+
+    void genKerName(std::string &kerString,
+                    const common::Node_ids &ids) const final {
+        kerString += '_';
+        kerString += m_params.getNameStr();
+        kerString += std::to_string(this->m_type);
+        kerString += ',';
+        kerString += std::to_string(ids.id);
+    }
+
+    void genParams(std::stringstream &kerStream, int id,
+                   bool is_linear) const final {
+        UNUSED(is_linear);
+        const char *names[2] = {"gdims", "gper"};
+        for (const char *name : names) {
+            kerStream << "const dim_t *" << name << id
+                      << " = (const dim_t *)(*arg++);\n";
+            for (int i = 0; i < 4; i++) {
+                kerStream << "const dim_t " << name << id << "_" << i << " = "
+                          << name << id << "[" << i << "];\n"
+                          << "(void)" << name << id << "_" << i << ";\n";
+            }
+        }
+    }
+
+    int setArgs(int start_id, bool is_linear,
+                std::function<void(int id, const void *ptr, size_t arg_size)>
+                    setArg) const override {
+        UNUSED(is_linear);
+        setArg(start_id, static_cast<const void *>(m_params.dims),
+               sizeof(m_params.dims));
+        setArg(start_id + 1, static_cast<const void *>(m_params.period),
+               sizeof(m_params.period));
+        return start_id + 2;
+    }
+
+    void genOffsets(std::stringstream &kerStream, int id,
+                    bool is_linear) const final {
+        m_params.genCoords(kerStream, id, is_linear);
+    }
+
+    void genFuncs(std::stringstream &kerStream,
+                  const common::Node_ids &ids) const final {
+        const char *type = getTypeName<T>();
+        kerStream << "const " << type << " v" << ids.id << " = (" << type
+                  << ")(" << m_params.genValue(ids.id) << ");\n";
+    }
+
+    bool isCompilable() const final { return getTypeName<T>() != nullptr; }
+
+    bool isEqual(const common::Node &other) const final {
+        return m_params == static_cast<const IndexNode &>(other).m_params;
+    }
+};
+
+}  // namespace jit
+
+}  // namespace cpu
@@ -48,6 +48,11 @@ class TNode : public common::Node {
         using namespace common;
         m_val.fill(static_cast<compute_t<T>>(val));
     }
+
+    /// All CPU nodes must be copyable so that they can be evaluated on
+    /// multiple threads
+    common::Node_ptr clone() const override = 0;
+
     virtual ~TNode() = default;
 };
 
@@ -8,7 +8,12 @@
  ********************************************************/
 
 #pragma once
+#include <compiled_jit.hpp>
 #include <optypes.hpp>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
 #include <vector>
 #include "Node.hpp"
 
@@ -21,25 +26,33 @@ class ScalarNode : public TNode<T> {
    public:
     ScalarNode(T val) : TNode<T>(val, 0, {}) {}
 
+    common::Node_ptr clone() const final {
+        return common::makePooled<ScalarNode>(*this);
+    }
+
     void genKerName(std::string &kerString,
                     const common::Node_ids &ids) const final {
-        UNUSED(kerString);
-        UNUSED(ids);
+        kerString += '_';
+        kerString += std::to_string(this->m_type);
+        kerString += ',';
+        kerString += std::to_string(ids.id);
     }
 
     void genParams(std::stringstream &kerStream, int id,
                    bool is_linear) const final {
-        UNUSED(kerStream);
-        UNUSED(id);
         UNUSED(is_linear);
+        const char *type = getTypeName<T>();
+        kerStream << "const " << type << " v" << id << " = *(const " << type
+                  << " *)(*arg++);\n";
     }
 
     int setArgs(int start_id, bool is_linear,
                 std::function<void(int id, const void *ptr, size_t arg_size)>
                     setArg) const override {
         UNUSED(is_linear);
-        UNUSED(setArg);
-        return start_id++;
+        setArg(start_id, static_cast<const void *>(this->m_val.data()),
+               sizeof(T));
+        return start_id + 1;
     }
 
     void genOffsets(std::stringstream &kerStream, int id,
@@ -54,6 +67,17 @@ class ScalarNode : public TNode<T> {
         UNUSED(kerStream);
         UNUSED(ids);
     }
+
+    bool isCompilable() const final { return getTypeName<T>() != nullptr; }
+
+    bool isScalar() const final { return true; }
+
+    /// Scalars are compared bitwise so NaNs with the same bits are merged
+    bool isEqual(const common::Node &other) const final {
+        const auto &node = static_cast<const ScalarNode &>(other);
+        return std::memcmp(this->m_val.data(), node.m_val.data(),
+                           sizeof(this->m_val[0])) == 0;
+    }
 };
 }  // namespace jit
 
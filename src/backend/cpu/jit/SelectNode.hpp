@@ -0,0 +1,137 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <compiled_jit.hpp>
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include "Node.hpp"
+
+namespace cpu {
+
+namespace jit {
+
+/// Selects the values of the second child where the condition, the first
+/// child, is true and the values of the third child elsewhere. The choice is
+/// inverted if \p flip is set, which is used to select between a scalar and
+/// an array in either order.
+template<typename T>
+class SelectNode : public TNode<compute_t<T>> {
+   protected:
+    using Tc = compute_t<T>;
+
+    TNode<char> *m_cond;
+    TNode<Tc> *m_lhs, *m_rhs;
+    bool m_flip;
+
+   public:
+    SelectNode(common::Node_ptr cond, common::Node_ptr lhs,
+               common::Node_ptr rhs, const bool flip)
+        : TNode<Tc>(Tc(0),
+                    std::max({cond->getHeight(), lhs->getHeight(),
+                              rhs->getHeight()}) +
+                        1,
+                    {{cond, lhs, rhs}})
+        , m_cond(reinterpret_cast<TNode<char> *>(cond.get()))
+        , m_lhs(reinterpret_cast<TNode<Tc> *>(lhs.get()))
+        , m_rhs(reinterpret_cast<TNode<Tc> *>(rhs.get()))
+        , m_flip(flip) {
+        this->updateHash(m_flip);
+    }
+
+    common::Node_ptr clone() const final {
+        return common::makePooled<SelectNode>(*this);
+    }
+
+    void replaceChild(int index, common::Node_ptr child) final {
+        switch (index) {
+            case 0:
+                m_cond = reinterpret_cast<TNode<char> *>(child.get());
+                break;
+            case 1: m_lhs = reinterpret_cast<TNode<Tc> *>(child.get()); break;
+            default:
+                m_rhs = reinterpret_cast<TNode<Tc> *>(child.get());
+                break;
+        }
+        common::Node::replaceChild(index, std::move(child));
+    }
+
+    bool isEqual(const common::Node &other) const final {
+        return m_flip == static_cast<const SelectNode &>(other).m_flip;
+    }
+
+    void calc(int x, int y, int z, int w, int lim) final {
+        UNUSED(x);
+        UNUSED(y);
+        UNUSED(z);
+        UNUSED(w);
+        select(lim);
+    }
+
+    void calc(int idx, int lim) final {
+        UNUSED(idx);
+        select(lim);
+    }
+
+    void genKerName(std::string &kerString,
+                    const common::Node_ids &ids) const final {
+        kerString += m_flip ? "_NS," : "_S,";
+        for (int i = 0; i < 3; i++) {
+            kerString += std::to_string(ids.child_ids[i]);
+            kerString += ',';
+        }
+        kerString += std::to_string(ids.id);
+    }
+
+    void genParams(std::stringstream &kerStream, int id,
+                   bool is_linear) const final {
+        UNUSED(kerStream);
+        UNUSED(id);
+        UNUSED(is_linear);
+    }
+
+    int setArgs(int start_id, bool is_linear,
+                std::function<void(int id, const void *ptr, size_t arg_size)>
+                    setArg) const override {
+        UNUSED(is_linear);
+        UNUSED(setArg);
+        return start_id;
+    }
+
+    void genOffsets(std::stringstream &kerStream, int id,
+                    bool is_linear) const final {
+        UNUSED(kerStream);
+        UNUSED(id);
+        UNUSED(is_linear);
+    }
+
+    void genFuncs(std::stringstream &kerStream,
+                  const common::Node_ids &ids) const final {
+        kerStream << "const " << getTypeName<Tc>() << " v" << ids.id << " = "
+                  << (m_flip ? "!" : "") << "v" << ids.child_ids[0] << " ? v"
+                  << ids.child_ids[1] << " : v" << ids.child_ids[2] << ";\n";
+    }
+
+    bool isCompilable() const final { return getTypeName<Tc>() != nullptr; }
+
+   private:
+    void select(int lim) {
+        for (int i = 0; i < lim; i++) {
+            const bool cond = m_flip ^ (m_cond->m_val[i] != 0);
+            this->m_val[i]  = cond ? m_lhs->m_val[i] : m_rhs->m_val[i];
+        }
+    }
+};
+
+}  // namespace jit
+
+}  // namespace cpu
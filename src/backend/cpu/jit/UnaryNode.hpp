@@ -8,11 +8,15 @@
  ********************************************************/
 
 #pragma once
+#include <compiled_jit.hpp>
 #include <math.hpp>
 #include <optypes.hpp>
 #include <types.hpp>
 #include "Node.hpp"
 
+#include <memory>
+#include <sstream>
+#include <string>
 #include <vector>
 
 namespace cpu {
@@ -35,6 +39,22 @@ class UnaryNode : public TNode<To> {
         : TNode<To>(To(0), child->getHeight() + 1, {{child}})
         , m_child(reinterpret_cast<TNode<Ti> *>(child.get())) {}
 
+    common::Node_ptr clone() const final {
+        return common::makePooled<UnaryNode>(*this);
+    }
+
+    void replaceChild(int index, common::Node_ptr child) final {
+        m_child = reinterpret_cast<TNode<Ti> *>(child.get());
+        common::Node::replaceChild(index, std::move(child));
+    }
+
+    /// The operation is part of the type of the node so nodes of the same
+    /// type with the same children are equal
+    bool isEqual(const common::Node &other) const final {
+        UNUSED(other);
+        return true;
+    }
+
     void calc(int x, int y, int z, int w, int lim) final {
         UNUSED(x);
         UNUSED(y);
@@ -50,14 +70,24 @@ class UnaryNode : public TNode<To> {
 
     void genKerName(std::string &kerString,
                     const common::Node_ids &ids) const final {
-        UNUSED(kerString);
-        UNUSED(ids);
+        kerString += '_';
+        kerString += std::to_string(op);
+        kerString += ',';
+        kerString += std::to_string(ids.child_ids[0]);
+        kerString += ',';
+        kerString += std::to_string(ids.id);
     }
 
     void genFuncs(std::stringstream &kerStream,
                   const common::Node_ids &ids) const final {
-        UNUSED(kerStream);
-        UNUSED(ids);
+        const char *type = getTypeName<To>();
+        kerStream << "const " << type << " v" << ids.id << " = "
+                  << getOpName(op) << "<" << type << ">(v" << ids.child_ids[0]
+                  << ");\n";
+    }
+
+    bool isCompilable() const final {
+        return getOpName(op) && getTypeName<To>() && getTypeName<Ti>();
     }
 };
 
@@ -9,82 +9,218 @@
 
 #pragma once
 #include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/jit/JitStats.hpp>
+#include <compiled_jit.hpp>
+#include <convert_half.hpp>
 #include <jit/Node.hpp>
 #include <platform.hpp>
+#include <thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
 #include <vector>
 
 namespace cpu {
 namespace kernel {
 
+/// Creates a copy of the nodes of a tree which can be evaluated on another
+/// thread.
+///
+/// \param[in]  full_nodes The nodes of the tree generated by getNodesMap
+/// \param[in]  ids        The ids of the nodes generated by getNodesMap
+/// \param[out] clones     Owns the copies of the nodes
+///
+/// \returns the copies of the nodes in the order of \p full_nodes
+inline std::vector<common::Node *> cloneTree(
+    const std::vector<common::Node *> &full_nodes,
+    const std::vector<common::Node_ids> &ids,
+    std::vector<common::Node_ptr> &clones) {
+    std::vector<common::Node *> wnodes;
+    clones.reserve(full_nodes.size());
+    wnodes.reserve(full_nodes.size());
+    for (size_t n = 0; n < full_nodes.size(); n++) {
+        clones.push_back(full_nodes[n]->clone());
+        clones[n]->relinkChildren(ids[n], clones);
+        wnodes.push_back(clones[n].get());
+    }
+    return wnodes;
+}
+
+/// An output of a kernel which evaluates trees of different types
+struct JitOutput {
+    /// The data of the output
+    void *ptr;
+    /// The name of the type of the output in the compiled kernels, or
+    /// nullptr if the type is not supported by the compiled JIT
+    const char *type;
+    /// Converts \p lim values of the output node \p node to the output
+    /// \p ptr, starting at the element \p offset
+    void (*write)(void *ptr, dim_t offset, common::Node *node, int lim);
+};
+
 template<typename T>
-void evalMultiple(std::vector<Param<T>> arrays,
-                  std::vector<common::Node_ptr> output_nodes_) {
-    af::dim4 odims = arrays[0].dims();
-    af::dim4 ostrs = arrays[0].strides();
+void writeOutput(void *ptr, dim_t offset, common::Node *node, int lim) {
+    convertValues(static_cast<T *>(ptr) + offset,
+                  static_cast<TNode<T> *>(node)->m_val.data(), lim);
+}
+
+template<typename T>
+JitOutput jitOutput(Param<T> &array) {
+    return {array.get(), jit::getTypeName<T>(), writeOutput<T>};
+}
 
+/// Evaluates the tree using a natively compiled kernel. Returns false if the
+/// tree could not be compiled.
+inline bool evalCompiled(const std::vector<JitOutput> &outputs,
+                         const af::dim4 &odims, const af::dim4 &ostrs,
+                         const std::vector<common::Node *> &full_nodes,
+                         const std::vector<common::Node_ids> &ids,
+                         const std::vector<int> &output_ids, bool is_linear) {
+    std::vector<const char *> out_types;
+    for (const auto &output : outputs) { out_types.push_back(output.type); }
+    jit::CompiledKernel kernel = jit::getCompiledKernel(
+        out_types, full_nodes, ids, output_ids, is_linear);
+    if (!kernel) { return false; }
+
+    std::vector<const void *> args;
+    auto setArg = [&args](int id, const void *ptr, size_t arg_size) {
+        UNUSED(arg_size);
+        args.resize(std::max(args.size(), static_cast<size_t>(id) + 1));
+        args[id] = ptr;
+    };
+    int nargs = 0;
+    for (auto node : full_nodes) {
+        nargs = node->setArgs(nargs, is_linear, setArg);
+    }
+    for (const auto &output : outputs) {
+        args.push_back(static_cast<const void *>(output.ptr));
+    }
+    args.push_back(static_cast<const void *>(odims.get()));
+    args.push_back(static_cast<const void *>(ostrs.get()));
+
+    // Linear kernels iterate over the elements and strided kernels iterate
+    // over the rows of the output
+    const dim_t nitems =
+        is_linear ? odims.elements() : odims[1] * odims[2] * odims[3];
+    const dim_t min_items =
+        is_linear ? getJitMinTaskElements()
+                  : getJitMinTaskElements() / std::max<dim_t>(odims[0], 1);
+    const dim_t task_items = std::max<dim_t>(min_items, 1);
+    const int ntasks       = static_cast<int>(divup(nitems, task_items));
+
+    getThreadPool().run(ntasks, [&](int task) {
+        dim_t begin = task * task_items;
+        dim_t end   = std::min(begin + task_items, nitems);
+        kernel(args.data(), begin, end);
+    });
+    return true;
+}
+
+/// Evaluates the trees \p output_nodes_ of any type to \p outputs, which
+/// have the dimensions \p odims and the strides \p ostrs
+inline void evalOutputs(std::vector<JitOutput> outputs, af::dim4 odims,
+                        af::dim4 ostrs,
+                        std::vector<common::Node_ptr> output_nodes_) {
     common::Node_map_t nodes;
-    std::vector<T *> ptrs;
-    std::vector<TNode<T> *> output_nodes;
+    common::Node_hash_map_t hashes;
+    std::vector<int> output_ids;
     std::vector<common::Node *> full_nodes;
     std::vector<common::Node_ids> ids;
 
-    int narrays = static_cast<int>(arrays.size());
-    for (int i = 0; i < narrays; i++) {
-        ptrs.push_back(arrays[i].get());
-        output_nodes.push_back(
-            reinterpret_cast<TNode<T> *>(output_nodes_[i].get()));
-        output_nodes_[i]->getNodesMap(nodes, full_nodes, ids);
+    for (auto &node : output_nodes_) {
+        output_ids.push_back(node->getNodesMap(nodes, full_nodes, ids, hashes));
     }
 
+    common::recordJitFusion(getActiveDeviceId(), full_nodes.size());
+
     bool is_linear = true;
     for (auto node : full_nodes) { is_linear &= node->isLinear(odims.get()); }
 
-    if (is_linear) {
-        int num = arrays[0].dims().elements();
-        int cnum =
-            jit::VECTOR_LENGTH * std::ceil(double(num) / jit::VECTOR_LENGTH);
-        for (int i = 0; i < cnum; i += jit::VECTOR_LENGTH) {
-            int lim = std::min(jit::VECTOR_LENGTH, num - i);
-            for (int n = 0; n < (int)full_nodes.size(); n++) {
-                full_nodes[n]->calc(i, lim);
-            }
-            for (int n = 0; n < (int)output_nodes.size(); n++) {
-                std::copy(output_nodes[n]->m_val.begin(),
-                          output_nodes[n]->m_val.begin() + lim, ptrs[n] + i);
-            }
-        }
-    } else {
-        for (int w = 0; w < (int)odims[3]; w++) {
-            dim_t offw = w * ostrs[3];
-
-            for (int z = 0; z < (int)odims[2]; z++) {
-                dim_t offz = z * ostrs[2] + offw;
-
-                for (int y = 0; y < (int)odims[1]; y++) {
-                    dim_t offy = y * ostrs[1] + offz;
-
-                    int dim0  = odims[0];
-                    int cdim0 = jit::VECTOR_LENGTH *
-                                std::ceil(double(dim0) / jit::VECTOR_LENGTH);
-                    for (int x = 0; x < (int)cdim0; x += jit::VECTOR_LENGTH) {
-                        int lim  = std::min(jit::VECTOR_LENGTH, dim0 - x);
-                        dim_t id = x + offy;
-
-                        for (int n = 0; n < (int)full_nodes.size(); n++) {
-                            full_nodes[n]->calc(x, y, z, w, lim);
-                        }
-                        for (int n = 0; n < (int)output_nodes.size(); n++) {
-                            std::copy(output_nodes[n]->m_val.begin(),
-                                      output_nodes[n]->m_val.begin() + lim,
-                                      ptrs[n] + id);
-                        }
-                    }
+    if (jit::isCompiledJitEnabled() &&
+        evalCompiled(outputs, odims, ostrs, full_nodes, ids, output_ids,
+                     is_linear)) {
+        return;
+    }
+
+    // The output is processed in chunks of jit::VECTOR_LENGTH elements along
+    // the first dimension. A linear output is treated as a single row.
+    const int dim0  = static_cast<int>(is_linear ? odims.elements() : odims[0]);
+    const int nrows = static_cast<int>(
+        is_linear ? 1 : odims[1] * odims[2] * odims[3]);
+    const int row_chunks  = divup(dim0, jit::VECTOR_LENGTH);
+    const dim_t nchunks   = static_cast<dim_t>(row_chunks) * nrows;
+    const int task_chunks = std::max(
+        1, static_cast<int>(getJitMinTaskElements() / jit::VECTOR_LENGTH));
+    const int ntasks = static_cast<int>(divup(nchunks, task_chunks));
+
+    thread_pool &pool  = getThreadPool();
+    const int nworkers = std::min(pool.size(), ntasks);
+
+    // The parents of merged common subexpressions still point to the merged
+    // nodes, so the original tree can only be evaluated if nothing was merged
+    const bool use_original = nodes.size() == full_nodes.size();
+
+    std::atomic<int> next_task(0);
+    auto worker = [&](int worker_id) {
+        // The intermediate results are stored in the nodes so every worker
+        // other than the first evaluates its own copy of the tree
+        std::vector<common::Node_ptr> clones;
+        std::vector<common::Node *> wnodes =
+            worker_id == 0 && use_original
+                ? full_nodes
+                : cloneTree(full_nodes, ids, clones);
+
+        std::vector<common::Node *> output_nodes;
+        for (int id : output_ids) { output_nodes.push_back(wnodes[id]); }
+
+        for (int task = next_task++; task < ntasks; task = next_task++) {
+            dim_t chunk_begin = static_cast<dim_t>(task) * task_chunks;
+            dim_t chunk_end   = std::min(chunk_begin + task_chunks, nchunks);
+
+            for (dim_t chunk = chunk_begin; chunk < chunk_end; chunk++) {
+                int row = static_cast<int>(chunk / row_chunks);
+                int x =
+                    static_cast<int>(chunk % row_chunks) * jit::VECTOR_LENGTH;
+                int lim = std::min(jit::VECTOR_LENGTH, dim0 - x);
+
+                dim_t id = x;
+                if (is_linear) {
+                    for (auto node : wnodes) { node->calc(x, lim); }
+                } else {
+                    int y = static_cast<int>(row % odims[1]);
+                    int z = static_cast<int>((row / odims[1]) % odims[2]);
+                    int w = static_cast<int>(row / (odims[1] * odims[2]));
+                    id += y * ostrs[1] + z * ostrs[2] + w * ostrs[3];
+
+                    for (auto node : wnodes) { node->calc(x, y, z, w, lim); }
+                }
+
+                for (int n = 0; n < (int)output_nodes.size(); n++) {
+                    outputs[n].write(outputs[n].ptr, id, output_nodes[n],
+                                     lim);
                 }
             }
         }
+    };
+
+    if (nworkers <= 1) {
+        worker(0);
+    } else {
+        pool.run(nworkers, worker);
     }
 }
 
+template<typename T>
+void evalMultiple(std::vector<Param<T>> arrays,
+                  std::vector<common::Node_ptr> output_nodes_) {
+    std::vector<JitOutput> outputs;
+    for (auto &array : arrays) { outputs.push_back(jitOutput(array)); }
+    evalOutputs(std::move(outputs), arrays[0].dims(), arrays[0].strides(),
+                std::move(output_nodes_));
+}
+
 template<typename T>
 void evalArray(Param<T> arr, common::Node_ptr node) {
     evalMultiple<T>({arr}, {node});
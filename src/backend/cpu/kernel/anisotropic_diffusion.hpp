@@ -131,9 +131,44 @@ float computeCurvatureBasedUpdate(const float mct, const float NW,
     return sqrt(prop_grad) * delta;
 }
 
+/// The sum of the squared gradients of all the images of \p in. The
+/// gradients are the central differences of the gradient function, one sided
+/// at the borders of the images.
+template<typename T>
+float gradientEnergy(CParam<T> in) {
+    const auto dims    = in.dims();
+    const auto strides = in.strides();
+
+    double sum = 0.0;
+    for (dim_t b3 = 0; b3 < dims[3]; ++b3) {
+        for (dim_t b2 = 0; b2 < dims[2]; ++b2) {
+            const T* img = in.get() + b2 * strides[2] + b3 * strides[3];
+            for (dim_t j = 0; j < dims[1]; ++j) {
+                const dim_t jl = std::max<dim_t>(j - 1, 0);
+                const dim_t jr = std::min<dim_t>(j + 1, dims[1] - 1);
+                const float f1 = (jr - jl == 2) ? 0.5f : 1.0f;
+                for (dim_t i = 0; i < dims[0]; ++i) {
+                    const dim_t il = std::max<dim_t>(i - 1, 0);
+                    const dim_t ir = std::min<dim_t>(i + 1, dims[0] - 1);
+                    const float f0 = (ir - il == 2) ? 0.5f : 1.0f;
+
+                    const float g0 =
+                        f0 * static_cast<float>(img[ir + j * strides[1]] -
+                                                img[il + j * strides[1]]);
+                    const float g1 =
+                        f1 * static_cast<float>(img[i + jr * strides[1]] -
+                                                img[i + jl * strides[1]]);
+                    sum += g0 * g0 + g1 * g1;
+                }
+            }
+        }
+    }
+    return static_cast<float>(sum);
+}
+
 template<typename T, bool isMCDE>
-void anisotropicDiffusion(Param<T> inout, const float dt, const float mct,
-                          const af_flux_function fftype) {
+void diffusionStep(Param<T> inout, const float dt, const float mct,
+                   const af_flux_function fftype) {
     const auto dims     = inout.dims();
     const auto strides  = inout.strides();
     const auto d1stride = strides[1];
@@ -186,5 +221,21 @@ void anisotropicDiffusion(Param<T> inout, const float dt, const float mct,
         }
     }
 }
+
+/// Runs all the timesteps in one task of the queue. The gradient energy of
+/// each step is summed directly from the image, without arrays of the
+/// gradients.
+template<typename T, bool isMCDE>
+void anisotropicDiffusion(Param<T> inout, const float dt, const float K,
+                          const unsigned iterations,
+                          const af_flux_function fftype) {
+    const float mctScale =
+        -static_cast<float>(inout.dims().elements()) / (2.0f * K * K);
+
+    for (unsigned it = 0; it < iterations; ++it) {
+        const float mct = mctScale / gradientEnergy<T>(inout);
+        diffusionStep<T, isMCDE>(inout, dt, mct, fftype);
+    }
+}
 }  // namespace kernel
 }  // namespace cpu
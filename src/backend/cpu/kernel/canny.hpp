@@ -9,9 +9,10 @@
 
 #pragma once
 #include <Param.hpp>
-#include <array>
+#include <parallel_for.hpp>
 #include <cassert>
-#include <list>
+#include <utility>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
@@ -21,158 +22,183 @@ void nonMaxSuppression(Param<T> output, CParam<T> magnitude, CParam<T> dxParam,
     const af::dim4 dims    = magnitude.dims();
     const af::dim4 strides = magnitude.strides();
 
-    T* out       = output.get();
-    const T* mag = magnitude.get();
-    const T* dX  = dxParam.get();
-    const T* dY  = dyParam.get();
-
-    for (dim_t b3 = 0; b3 < dims[3]; ++b3) {
-        for (dim_t b2 = 0; b2 < dims[2]; ++b2) {
-            dim_t offset;
-
-            offset = dims[0] + 1;
+    // Suppresses the non maximal magnitudes of the pixels of a column,
+    // except the first and the last one.
+    auto suppressColumn = [&](const dim_t column) {
+        T* out       = output.get() + column;
+        const T* mag = magnitude.get() + column;
+        const T* dX  = dxParam.get() + column;
+        const T* dY  = dyParam.get() + column;
+        for (dim_t offset = 1; offset < dims[0] - 1; ++offset) {
+            T curr = mag[offset];
+            if (curr == 0) {
+                out[offset] = (T)0;
+            } else {
+                const float se = mag[offset + dims[0] + 1];
+                const float nw = mag[offset - dims[0] - 1];
+                const float ea = mag[offset + 1];
+                const float we = mag[offset - 1];
+                const float ne = mag[offset - dims[0] + 1];
+                const float sw = mag[offset + dims[0] - 1];
+                const float no = mag[offset - dims[0]];
+                const float so = mag[offset + dims[0]];
+                const float dx = dX[offset];
+                const float dy = dY[offset];
+
+                float a1, a2, b1, b2, alpha;
+
+                if (dx >= 0) {
+                    if (dy >= 0) {
+                        const bool isDxMagGreater = (dx - dy) >= 0;
+
+                        a1    = isDxMagGreater ? ea : so;
+                        a2    = isDxMagGreater ? we : no;
+                        b1    = se;
+                        b2    = nw;
+                        alpha = isDxMagGreater ? dy / dx : dx / dy;
+                    } else {
+                        const bool isDyMagGreater = (dx + dy) >= 0;
 
-            for (dim_t j = 2; j < dims[1]; ++j, offset += 2) {
-                for (dim_t i = 2; i < dims[0]; ++i, ++offset) {
-                    T curr = mag[offset];
-                    if (curr == 0) {
-                        out[offset] = (T)0;
+                        a1    = isDyMagGreater ? ea : no;
+                        a2    = isDyMagGreater ? we : so;
+                        b1    = ne;
+                        b2    = sw;
+                        alpha = isDyMagGreater ? -dy / dx : dx / -dy;
+                    }
+                } else {
+                    if (dy >= 0) {
+                        const bool isDyMagGreater = (dx + dy) >= 0;
+
+                        a1    = isDyMagGreater ? so : we;
+                        a2    = isDyMagGreater ? no : ea;
+                        b1    = sw;
+                        b2    = ne;
+                        alpha = isDyMagGreater ? -dx / dy : dy / -dx;
                     } else {
-                        const float se = mag[offset + dims[0] + 1];
-                        const float nw = mag[offset - dims[0] - 1];
-                        const float ea = mag[offset + 1];
-                        const float we = mag[offset - 1];
-                        const float ne = mag[offset - dims[0] + 1];
-                        const float sw = mag[offset + dims[0] - 1];
-                        const float no = mag[offset - dims[0]];
-                        const float so = mag[offset + dims[0]];
-                        const float dx = dX[offset];
-                        const float dy = dY[offset];
-
-                        float a1, a2, b1, b2, alpha;
-
-                        if (dx >= 0) {
-                            if (dy >= 0) {
-                                const bool isDxMagGreater = (dx - dy) >= 0;
-
-                                a1    = isDxMagGreater ? ea : so;
-                                a2    = isDxMagGreater ? we : no;
-                                b1    = se;
-                                b2    = nw;
-                                alpha = isDxMagGreater ? dy / dx : dx / dy;
-                            } else {
-                                const bool isDyMagGreater = (dx + dy) >= 0;
-
-                                a1    = isDyMagGreater ? ea : no;
-                                a2    = isDyMagGreater ? we : so;
-                                b1    = ne;
-                                b2    = sw;
-                                alpha = isDyMagGreater ? -dy / dx : dx / -dy;
-                            }
-                        } else {
-                            if (dy >= 0) {
-                                const bool isDyMagGreater = (dx + dy) >= 0;
-
-                                a1    = isDyMagGreater ? so : we;
-                                a2    = isDyMagGreater ? no : ea;
-                                b1    = sw;
-                                b2    = ne;
-                                alpha = isDyMagGreater ? -dx / dy : dy / -dx;
-                            } else {
-                                const bool isDxMagGreater = (-dx + dy) >= 0;
-
-                                a1    = isDxMagGreater ? we : no;
-                                a2    = isDxMagGreater ? ea : so;
-                                b1    = nw;
-                                b2    = se;
-                                alpha = isDxMagGreater ? dy / dx : dx / dy;
-                            }
-                        }
-
-                        float mag1 = (1.0f - alpha) * a1 + alpha * b1;
-                        float mag2 = (1.0f - alpha) * a2 + alpha * b2;
-
-                        if (curr > mag1 && curr > mag2) {
-                            out[offset] = curr;
-                        } else {
-                            out[offset] = (T)0;
-                        }
+                        const bool isDxMagGreater = (-dx + dy) >= 0;
+
+                        a1    = isDxMagGreater ? we : no;
+                        a2    = isDxMagGreater ? ea : so;
+                        b1    = nw;
+                        b2    = se;
+                        alpha = isDxMagGreater ? dy / dx : dx / dy;
                     }
                 }
-            }
 
-            out += strides[2];
-            mag += strides[2];
-            dX += strides[2];
-            dY += strides[2];
-        }
-        out += strides[3];
-        mag += strides[3];
-        dX += strides[3];
-        dY += strides[3];
-    }
-}
+                float mag1 = (1.0f - alpha) * a1 + alpha * b1;
+                float mag2 = (1.0f - alpha) * a2 + alpha * b2;
 
-template<typename T>
-void traceEdge(T* out, const T* strong, const T* weak, int t, int width) {
-    if (!out || !strong || !weak) return;
-
-    const T EDGE = 1;
-
-    std::list<dim_t> edges;  // list of edges to be checked
-    edges.push_back(t);
-
-    do {
-        t = edges.front();
-        edges.pop_front();  // remove the last after read
-
-        // get indices of 8 neighbours
-        std::array<dim_t, 8> potentials;
-
-        potentials[0] = t - width - 1;      // north-west
-        potentials[1] = potentials[0] + 1;  // north
-        potentials[2] = potentials[1] + 1;  // north-east
-        potentials[3] = t - 1;              // west
-        potentials[4] = t + 1;              // east
-        potentials[5] = t + width - 1;      // south-west
-        potentials[6] = potentials[5] + 1;  // south
-        potentials[7] = potentials[6] + 1;  // south-east
-
-        // test 8 neighbours and add them into edge
-        // list only if they are also edges
-        for (auto it : potentials) {
-            if (weak[it] > 0 && out[it] != EDGE) {
-                out[it] = EDGE;
-                edges.emplace_back(it);
+                if (curr > mag1 && curr > mag2) {
+                    out[offset] = curr;
+                } else {
+                    out[offset] = (T)0;
+                }
             }
         }
-    } while (!edges.empty());
+    };
+
+    // The inner columns of all the slices are split across the thread pool
+    const dim_t columns = dims[1] * dims[2] * dims[3];
+    parallelFor(columns, dims[0], [&](dim_t first, dim_t last) {
+        for (dim_t c = first; c < last; ++c) {
+            const dim_t j     = c % dims[1];
+            const dim_t slice = c / dims[1];
+            if (j == 0 || j == dims[1] - 1) { continue; }
+            suppressColumn((slice % dims[2]) * strides[2] +
+                           (slice / dims[2]) * strides[3] + j * dims[0]);
+        }
+    });
 }
 
+/// Marks the pixels of the components of 8-connected weak and strong pixels
+/// which contain a strong pixel. The strong pixels on the border of the image
+/// do not start an edge.
+///
+/// The components of blocks of columns are found in parallel with a
+/// union-find forest, the blocks are then merged along their boundaries and
+/// the pixels are labeled in parallel.
 template<typename T>
 void edgeTrackingHysteresis(Param<T> out, CParam<T> strong, CParam<T> weak) {
     const af::dim4 dims = strong.dims();
-
-    dim_t t = dims[0] +
-              1;  // skip the first coloumn and first element of second coloumn
-    dim_t jMax = dims[1] - 1;  // max Y value to traverse, ignore right coloumn
-    dim_t iMax = dims[0] - 1;  // max X value to traverse, ignore bottom border
+    const dim_t nrows   = dims[0];
+    const dim_t ncols   = dims[1];
+    const dim_t columns = dims[1] * dims[2] * dims[3];
 
     T* optr       = out.get();
     const T* sptr = strong.get();
     const T* wptr = weak.get();
 
-    for (dim_t j = 1; j <= jMax; ++j) {
-        for (dim_t i = 1; i <= iMax; ++i, ++t) {
-            // if current pixel(sptr) is part of a edge
-            // and output doesn't have it marked already,
-            // mark it and trace the pixels from here.
-            if (sptr[t] > 0 && optr[t] != 1) {
-                optr[t] = 1;
-                traceEdge(optr, sptr, wptr, t, dims[0]);
+    auto isSeed = [&](dim_t i, dim_t j, dim_t t) {
+        return sptr[t] > 0 && i > 0 && i < nrows - 1 && j > 0 &&
+               j < ncols - 1;
+    };
+    auto isNode = [&](dim_t i, dim_t j, dim_t t) {
+        return wptr[t] > 0 || isSeed(i, j, t);
+    };
+
+    // The parent of each pixel of a component, or -1 for the other pixels
+    std::vector<dim_t> parent(columns * nrows);
+    std::vector<char> hasSeed(columns * nrows);
+    std::vector<char> blockStart(columns, 0);
+
+    auto find = [&](dim_t t) {
+        while (parent[t] != t) {
+            parent[t] = parent[parent[t]];
+            t         = parent[t];
+        }
+        return t;
+    };
+    auto unite = [&](dim_t a, dim_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) { return; }
+        if (a > b) { std::swap(a, b); }
+        parent[b] = a;
+        hasSeed[a] |= hasSeed[b];
+    };
+    // Joins the pixel t of row i with its neighbors in the previous column
+    auto uniteLeft = [&](dim_t i, dim_t t) {
+        const dim_t left = t - nrows;
+        if (i > 0 && parent[left - 1] >= 0) { unite(t, left - 1); }
+        if (parent[left] >= 0) { unite(t, left); }
+        if (i < nrows - 1 && parent[left + 1] >= 0) { unite(t, left + 1); }
+    };
+
+    parallelFor(columns, nrows, [&](dim_t first, dim_t last) {
+        blockStart[first] = 1;
+        for (dim_t c = first; c < last; ++c) {
+            const dim_t j = c % ncols;
+            for (dim_t i = 0; i < nrows; ++i) {
+                const dim_t t = c * nrows + i;
+                if (!isNode(i, j, t)) {
+                    parent[t] = -1;
+                    continue;
+                }
+                parent[t]  = t;
+                hasSeed[t] = isSeed(i, j, t);
+                if (i > 0 && parent[t - 1] >= 0) { unite(t, t - 1); }
+                if (j > 0 && c > first) { uniteLeft(i, t); }
             }
         }
+    });
+
+    // The blocks are disjoint until their boundaries are joined
+    for (dim_t c = 1; c < columns; ++c) {
+        if (!blockStart[c] || c % ncols == 0) { continue; }
+        for (dim_t i = 0; i < nrows; ++i) {
+            const dim_t t = c * nrows + i;
+            if (parent[t] >= 0) { uniteLeft(i, t); }
+        }
     }
+
+    parallelFor(columns, nrows, [&](dim_t first, dim_t last) {
+        for (dim_t t = first * nrows; t < last * nrows; ++t) {
+            if (parent[t] < 0) { continue; }
+            dim_t root = t;
+            while (parent[root] != root) { root = parent[root]; }
+            if (hasSeed[root]) { optr[t] = T(1); }
+        }
+    });
 }
 }  // namespace kernel
 }  // namespace cpu
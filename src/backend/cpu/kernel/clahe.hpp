@@ -0,0 +1,163 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <kernel/histogram.hpp>
+#include <parallel_for.hpp>
+#include <types.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+namespace cpu {
+namespace kernel {
+
+/// Computes the mapping of every tile of the 2D slices of \p in to the
+/// fraction of the pixels of the tile below each bin. \p lut has the
+/// dimensions nbins x gridRows x gridCols x slices.
+///
+/// The histogram of a tile is clipped at \p clipLimit times its average bin
+/// count and the clipped counts are spread over all the bins. Tile b along
+/// a dimension of length n covers the indices i with b = i * grid / n.
+template<typename T>
+void claheLut(Param<float> lut, CParam<T> in, const float clipLimit,
+              const float minval, const float maxval) {
+    const af::dim4 dims     = in.dims();
+    const af::dim4 iStrides = in.strides();
+    const af::dim4 lStrides = lut.strides();
+    const unsigned nbins    = lut.dims(0);
+    const dim_t gridRows    = lut.dims(1);
+    const dim_t gridCols    = lut.dims(2);
+    const float step        = (maxval - minval) / (float)nbins;
+    const auto minValT      = compute_t<T>(minval);
+
+    const dim_t tiles        = gridRows * gridCols;
+    const dim_t units        = tiles * dims[2] * dims[3];
+    const dim_t tileElements = dims[0] * dims[1] / tiles;
+
+    parallelFor(units, tileElements, [&](dim_t first, dim_t last) {
+        std::vector<uint> hist(nbins);
+        for (dim_t unit = first; unit < last; ++unit) {
+            const dim_t tile = unit % tiles;
+            const dim_t s    = unit / tiles;
+            const dim_t ty   = tile % gridRows;
+            const dim_t tx   = tile / gridRows;
+            const dim_t b2   = s % dims[2];
+            const dim_t b3   = s / dims[2];
+
+            const dim_t rowBeg = divup(ty * dims[0], gridRows);
+            const dim_t rowEnd = divup((ty + 1) * dims[0], gridRows);
+            const dim_t colBeg = divup(tx * dims[1], gridCols);
+            const dim_t colEnd = divup((tx + 1) * dims[1], gridCols);
+            const dim_t count  = (rowEnd - rowBeg) * (colEnd - colBeg);
+
+            const T* iptr = in.get() + b2 * iStrides[2] + b3 * iStrides[3];
+            std::fill(hist.begin(), hist.end(), 0);
+            for (dim_t j = colBeg; j < colEnd; ++j) {
+                histogramRow(hist.data(), iptr + j * iStrides[1] + rowBeg,
+                             rowEnd - rowBeg, nbins, minValT, step);
+            }
+
+            uint excess = 0;
+            if (clipLimit > 0) {
+                const uint limit = std::max(
+                    1u, static_cast<uint>(clipLimit * count / nbins));
+                for (unsigned b = 0; b < nbins; ++b) {
+                    if (hist[b] > limit) {
+                        excess += hist[b] - limit;
+                        hist[b] = limit;
+                    }
+                }
+            }
+
+            float* optr = lut.get() + ty * lStrides[1] + tx * lStrides[2] +
+                          s * lStrides[3];
+            const float redist = (float)excess / nbins;
+            const float scale  = 1.f / count;
+            float cdf          = 0.f;
+            for (unsigned b = 0; b < nbins; ++b) {
+                cdf += hist[b] + redist;
+                optr[b] = cdf * scale;
+            }
+        }
+    });
+}
+
+/// Maps every pixel of \p in by the mappings of the four tiles whose
+/// centers surround it, interpolated bilinearly, in one pass
+template<typename T>
+void claheApply(Param<T> out, CParam<T> in, CParam<float> lut,
+                const float minval, const float maxval) {
+    const af::dim4 dims     = in.dims();
+    const af::dim4 iStrides = in.strides();
+    const af::dim4 oStrides = out.strides();
+    const af::dim4 lStrides = lut.strides();
+    const int nbins         = lut.dims(0);
+    const int gridRows      = lut.dims(1);
+    const int gridCols      = lut.dims(2);
+    const float step        = (maxval - minval) / (float)nbins;
+    const auto minValT      = compute_t<T>(minval);
+
+    // The tiles above and below, and the weight of the tile below, of every
+    // row
+    std::vector<int> ty0(dims[0]);
+    std::vector<int> ty1(dims[0]);
+    std::vector<float> wy(dims[0]);
+    for (dim_t i = 0; i < dims[0]; ++i) {
+        const float fy = (i + 0.5f) * gridRows / dims[0] - 0.5f;
+        const int y0   = static_cast<int>(std::floor(fy));
+        wy[i]          = fy - y0;
+        ty0[i]         = std::max(y0, 0);
+        ty1[i]         = std::min(y0 + 1, gridRows - 1);
+    }
+
+    const dim_t units = dims[1] * dims[2] * dims[3];
+    parallelFor(units, dims[0], [&](dim_t first, dim_t last) {
+        for (dim_t unit = first; unit < last; ++unit) {
+            const dim_t j  = unit % dims[1];
+            const dim_t s  = unit / dims[1];
+            const dim_t b2 = s % dims[2];
+            const dim_t b3 = s / dims[2];
+
+            const float fx  = (j + 0.5f) * gridCols / dims[1] - 0.5f;
+            const int x0    = static_cast<int>(std::floor(fx));
+            const float wx  = fx - x0;
+            const int tx0   = std::max(x0, 0);
+            const int tx1   = std::min(x0 + 1, gridCols - 1);
+            const float* l0 = lut.get() + tx0 * lStrides[2] + s * lStrides[3];
+            const float* l1 = lut.get() + tx1 * lStrides[2] + s * lStrides[3];
+
+            const T* iptr = in.get() + b2 * iStrides[2] + b3 * iStrides[3] +
+                            j * iStrides[1];
+            T* optr = out.get() + b2 * oStrides[2] + b3 * oStrides[3] +
+                      j * oStrides[1];
+            for (dim_t i = 0; i < dims[0]; ++i) {
+                int bin = (int)((compute_t<T>(iptr[i]) - minValT) / step);
+                bin     = std::min(std::max(bin, 0), nbins - 1);
+
+                const dim_t r0  = ty0[i] * lStrides[1] + bin;
+                const dim_t r1  = ty1[i] * lStrides[1] + bin;
+                const float top = (1.f - wx) * l0[r0] + wx * l1[r0];
+                const float bot = (1.f - wx) * l0[r1] + wx * l1[r1];
+                const float res =
+                    minval + (maxval - minval) *
+                                 ((1.f - wy[i]) * top + wy[i] * bot);
+                optr[i] = static_cast<T>(std::is_integral<T>::value
+                                             ? std::floor(res + 0.5f)
+                                             : res);
+            }
+        }
+    });
+}
+
+}  // namespace kernel
+}  // namespace cpu
@@ -0,0 +1,225 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <types.hpp>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+#include <vector>
+
+// The convolutions of the neural network functions, computed with loops over
+// the taps of the filter instead of a product with the unwrapped signal. The
+// innermost loops run over the pixels of a row which are inside the signal,
+// so that they do not need to test the padding.
+
+namespace cpu {
+namespace kernel {
+
+/// Sets \p begin and \p end to the range of the output coordinates o for
+/// which o * \p stride + \p offset is inside [0, \p length). There are
+/// \p outputs output coordinates.
+inline void conv2Range(dim_t &begin, dim_t &end, const dim_t offset,
+                       const dim_t stride, const dim_t length,
+                       const dim_t outputs) {
+    begin = offset >= 0 ? 0 : divup(-offset, stride);
+    end   = length > offset ? std::min(outputs, divup(length - offset, stride))
+                            : 0;
+    end   = std::max(begin, end);
+}
+
+/// Computes the forward pass of the convolution of \p signal, of size
+/// (W, H, C, N), with \p filter, of size (fw, fh, C, K), into \p out, of size
+/// (oW, oH, K, N)
+template<typename T>
+void conv2Forward(Param<T> out, CParam<T> signal, CParam<T> filter,
+                  const af::dim4 stride, const af::dim4 padding,
+                  const af::dim4 dilation) {
+    using CT = compute_t<T>;
+
+    const af::dim4 oDims    = out.dims();
+    const af::dim4 oStrides = out.strides();
+    const af::dim4 sDims    = signal.dims();
+    const af::dim4 sStrides = signal.strides();
+    const af::dim4 fDims    = filter.dims();
+    const af::dim4 fStrides = filter.strides();
+
+    std::vector<CT> acc(oDims[0] * oDims[1]);
+    for (dim_t n = 0; n < oDims[3]; ++n) {
+        for (dim_t k = 0; k < oDims[2]; ++k) {
+            std::fill(acc.begin(), acc.end(), CT(0));
+            for (dim_t c = 0; c < fDims[2]; ++c) {
+                const T *sptr =
+                    signal.get() + c * sStrides[2] + n * sStrides[3];
+                for (dim_t j = 0; j < fDims[1]; ++j) {
+                    dim_t oyBegin, oyEnd;
+                    conv2Range(oyBegin, oyEnd, j * dilation[1] - padding[1],
+                               stride[1], sDims[1], oDims[1]);
+                    for (dim_t i = 0; i < fDims[0]; ++i) {
+                        dim_t oxBegin, oxEnd;
+                        conv2Range(oxBegin, oxEnd, i * dilation[0] - padding[0],
+                                   stride[0], sDims[0], oDims[0]);
+
+                        const CT w = static_cast<CT>(
+                            filter.get()[(fDims[0] - 1 - i) * fStrides[0] +
+                                         (fDims[1] - 1 - j) * fStrides[1] +
+                                         c * fStrides[2] + k * fStrides[3]]);
+                        for (dim_t oy = oyBegin; oy < oyEnd; ++oy) {
+                            const dim_t y =
+                                oy * stride[1] - padding[1] + j * dilation[1];
+                            const T *row = sptr + y * sStrides[1];
+                            CT *arow     = acc.data() + oy * oDims[0];
+                            for (dim_t ox = oxBegin; ox < oxEnd; ++ox) {
+                                const dim_t x = ox * stride[0] - padding[0] +
+                                                i * dilation[0];
+                                arow[ox] +=
+                                    w * static_cast<CT>(row[x * sStrides[0]]);
+                            }
+                        }
+                    }
+                }
+            }
+
+            T *optr = out.get() + k * oStrides[2] + n * oStrides[3];
+            for (dim_t oy = 0; oy < oDims[1]; ++oy) {
+                for (dim_t ox = 0; ox < oDims[0]; ++ox) {
+                    optr[oy * oStrides[1] + ox * oStrides[0]] =
+                        static_cast<T>(acc[oy * oDims[0] + ox]);
+                }
+            }
+        }
+    }
+}
+
+/// Computes the gradient \p out, of size (W, H, C, N), of the signal of a
+/// convolution with \p filter, of size (fw, fh, C, K), from the gradient
+/// \p grad of its output, of size (oW, oH, K, N)
+template<typename T>
+void conv2DataGradient(Param<T> out, CParam<T> grad, CParam<T> filter,
+                       const af::dim4 stride, const af::dim4 padding,
+                       const af::dim4 dilation) {
+    using CT = compute_t<T>;
+
+    const af::dim4 oDims    = out.dims();
+    const af::dim4 oStrides = out.strides();
+    const af::dim4 gDims    = grad.dims();
+    const af::dim4 gStrides = grad.strides();
+    const af::dim4 fDims    = filter.dims();
+    const af::dim4 fStrides = filter.strides();
+
+    // Each output gradient is added to the signal pixels which it was
+    // computed from
+    std::vector<CT> acc(oDims[0] * oDims[1]);
+    for (dim_t n = 0; n < oDims[3]; ++n) {
+        for (dim_t c = 0; c < oDims[2]; ++c) {
+            std::fill(acc.begin(), acc.end(), CT(0));
+            for (dim_t k = 0; k < gDims[2]; ++k) {
+                const T *gptr = grad.get() + k * gStrides[2] + n * gStrides[3];
+                for (dim_t j = 0; j < fDims[1]; ++j) {
+                    dim_t oyBegin, oyEnd;
+                    conv2Range(oyBegin, oyEnd, j * dilation[1] - padding[1],
+                               stride[1], oDims[1], gDims[1]);
+                    for (dim_t i = 0; i < fDims[0]; ++i) {
+                        dim_t oxBegin, oxEnd;
+                        conv2Range(oxBegin, oxEnd, i * dilation[0] - padding[0],
+                                   stride[0], oDims[0], gDims[0]);
+
+                        const CT w = static_cast<CT>(
+                            filter.get()[(fDims[0] - 1 - i) * fStrides[0] +
+                                         (fDims[1] - 1 - j) * fStrides[1] +
+                                         c * fStrides[2] + k * fStrides[3]]);
+                        for (dim_t oy = oyBegin; oy < oyEnd; ++oy) {
+                            const dim_t y =
+                                oy * stride[1] - padding[1] + j * dilation[1];
+                            const T *row = gptr + oy * gStrides[1];
+                            CT *arow     = acc.data() + y * oDims[0];
+                            for (dim_t ox = oxBegin; ox < oxEnd; ++ox) {
+                                const dim_t x = ox * stride[0] - padding[0] +
+                                                i * dilation[0];
+                                arow[x] +=
+                                    w * static_cast<CT>(row[ox * gStrides[0]]);
+                            }
+                        }
+                    }
+                }
+            }
+
+            T *optr = out.get() + c * oStrides[2] + n * oStrides[3];
+            for (dim_t y = 0; y < oDims[1]; ++y) {
+                for (dim_t x = 0; x < oDims[0]; ++x) {
+                    optr[y * oStrides[1] + x * oStrides[0]] =
+                        static_cast<T>(acc[y * oDims[0] + x]);
+                }
+            }
+        }
+    }
+}
+
+/// Computes the gradient \p out, of size (fw, fh, C, K), of the filter of a
+/// convolution of \p signal, of size (W, H, C, N), from the gradient \p grad
+/// of its output, of size (oW, oH, K, N)
+template<typename T>
+void conv2FilterGradient(Param<T> out, CParam<T> signal, CParam<T> grad,
+                         const af::dim4 stride, const af::dim4 padding,
+                         const af::dim4 dilation) {
+    using CT = compute_t<T>;
+
+    const af::dim4 oDims    = out.dims();
+    const af::dim4 oStrides = out.strides();
+    const af::dim4 sDims    = signal.dims();
+    const af::dim4 sStrides = signal.strides();
+    const af::dim4 gDims    = grad.dims();
+    const af::dim4 gStrides = grad.strides();
+
+    for (dim_t k = 0; k < oDims[3]; ++k) {
+        for (dim_t c = 0; c < oDims[2]; ++c) {
+            for (dim_t j = 0; j < oDims[1]; ++j) {
+                dim_t oyBegin, oyEnd;
+                conv2Range(oyBegin, oyEnd, j * dilation[1] - padding[1],
+                           stride[1], sDims[1], gDims[1]);
+                for (dim_t i = 0; i < oDims[0]; ++i) {
+                    dim_t oxBegin, oxEnd;
+                    conv2Range(oxBegin, oxEnd, i * dilation[0] - padding[0],
+                               stride[0], sDims[0], gDims[0]);
+
+                    CT acc = CT(0);
+                    for (dim_t n = 0; n < gDims[3]; ++n) {
+                        const T *sptr =
+                            signal.get() + c * sStrides[2] + n * sStrides[3];
+                        const T *gptr =
+                            grad.get() + k * gStrides[2] + n * gStrides[3];
+                        for (dim_t oy = oyBegin; oy < oyEnd; ++oy) {
+                            const dim_t y =
+                                oy * stride[1] - padding[1] + j * dilation[1];
+                            const T *srow = sptr + y * sStrides[1];
+                            const T *grow = gptr + oy * gStrides[1];
+                            for (dim_t ox = oxBegin; ox < oxEnd; ++ox) {
+                                const dim_t x = ox * stride[0] - padding[0] +
+                                                i * dilation[0];
+                                acc += static_cast<CT>(srow[x * sStrides[0]]) *
+                                       static_cast<CT>(grow[ox * gStrides[0]]);
+                            }
+                        }
+                    }
+
+                    out.get()[(oDims[0] - 1 - i) * oStrides[0] +
+                              (oDims[1] - 1 - j) * oStrides[1] +
+                              c * oStrides[2] + k * oStrides[3]] =
+                        static_cast<T>(acc);
+                }
+            }
+        }
+    }
+}
+
+}  // namespace kernel
+}  // namespace cpu
@@ -10,124 +10,74 @@
 #pragma once
 #include <Param.hpp>
 #include <math.hpp>
+#include <parallel_for.hpp>
 #include <af/defines.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace cpu {
 namespace kernel {
 
-template<typename InT, typename AccT>
-void one2one_1d(InT *optr, InT const *const iptr, AccT const *const fptr,
-                af::dim4 const &oDims, af::dim4 const &sDims,
-                af::dim4 const &fDims, af::dim4 const &sStrides,
-                const bool expand) {
-    dim_t start = (expand ? 0 : fDims[0] / 2);
-    dim_t end   = (expand ? oDims[0] : start + sDims[0]);
-    for (dim_t i = start; i < end; ++i) {
-        AccT accum = 0.0;
-        for (dim_t f = 0; f < fDims[0]; ++f) {
-            dim_t iIdx = i - f;
-            InT s_val =
-                ((iIdx >= 0 && iIdx < sDims[0]) ? iptr[iIdx * sStrides[0]]
-                                                : InT(0));
-            accum += AccT(s_val * fptr[f]);
+/// The number of outputs accumulated at once by the convolution kernels. The
+/// accumulators and the input lines they read stay in the L1 cache while
+/// all the taps of the filter are applied to them.
+constexpr dim_t CONVOLVE_TILE = 256;
+
+/// Caches the zero padded lines along dimension 0 of the input of a
+/// convolution, so that each line is converted and padded once while it is
+/// used by consecutive output lines.
+///
+/// The callers pick the slot of each line so that the lines of a sliding
+/// window never share a slot.
+template<typename AccT>
+class LineCache {
+    std::vector<AccT> m_data;
+    std::vector<dim_t> m_keys;
+    dim_t m_length;
+
+   public:
+    LineCache(const dim_t slots, const dim_t length)
+        : m_data(slots * length), m_keys(slots, -1), m_length(length) {}
+
+    /// Returns the line of \p key kept in \p slot, calling fill(line) if it
+    /// is not cached
+    template<typename F>
+    const AccT *get(const dim_t slot, const dim_t key, F fill) {
+        AccT *line = m_data.data() + slot * m_length;
+        if (m_keys[slot] != key) {
+            fill(line);
+            m_keys[slot] = key;
         }
-        optr[i - start] = InT(accum);
+        return line;
     }
-}
+};
 
+/// Copies \p length elements of \p in with a stride of \p stride into
+/// \p line after \p pad zeros and fills the rest of \p line with zeros
 template<typename InT, typename AccT>
-void one2one_2d(InT *optr, InT const *const iptr, AccT const *const fptr,
-                af::dim4 const &oDims, af::dim4 const &sDims,
-                af::dim4 const &fDims, af::dim4 const &oStrides,
-                af::dim4 const &sStrides, af::dim4 const &fStrides,
-                const bool expand) {
-    dim_t jStart = (expand ? 0 : fDims[1] / 2);
-    dim_t jEnd   = (expand ? oDims[1] : jStart + sDims[1]);
-    dim_t iStart = (expand ? 0 : fDims[0] / 2);
-    dim_t iEnd   = (expand ? oDims[0] : iStart + sDims[0]);
-
-    for (dim_t j = jStart; j < jEnd; ++j) {
-        dim_t joff = (j - jStart) * oStrides[1];
-
-        for (dim_t i = iStart; i < iEnd; ++i) {
-            AccT accum = AccT(0);
-            for (dim_t wj = 0; wj < fDims[1]; ++wj) {
-                dim_t jIdx    = j - wj;
-                dim_t w_joff  = wj * fStrides[1];
-                dim_t s_joff  = jIdx * sStrides[1];
-                bool isJValid = (jIdx >= 0 && jIdx < sDims[1]);
-
-                for (dim_t wi = 0; wi < fDims[0]; ++wi) {
-                    dim_t iIdx = i - wi;
-
-                    InT s_val = InT(0);
-                    if (isJValid && (iIdx >= 0 && iIdx < sDims[0])) {
-                        s_val = iptr[s_joff + iIdx * sStrides[0]];
-                    }
-
-                    accum += AccT(s_val * fptr[w_joff + wi * fStrides[0]]);
-                }
-            }
-            optr[joff + i - iStart] = InT(accum);
-        }
-    }
+void padLine(AccT *line, InT const *in, const dim_t stride, const dim_t length,
+             const dim_t pad, const dim_t lineLength) {
+    std::fill(line, line + pad, scalar<AccT>(0));
+    for (dim_t i = 0; i < length; ++i) { line[pad + i] = AccT(in[i * stride]); }
+    std::fill(line + pad + length, line + lineLength, scalar<AccT>(0));
 }
 
-template<typename InT, typename AccT>
-void one2one_3d(InT *optr, InT const *const iptr, AccT const *const fptr,
-                af::dim4 const &oDims, af::dim4 const &sDims,
-                af::dim4 const &fDims, af::dim4 const &oStrides,
-                af::dim4 const &sStrides, af::dim4 const &fStrides,
-                const bool expand) {
-    dim_t kStart = (expand ? 0 : fDims[2] / 2);
-    dim_t kEnd   = (expand ? oDims[2] : kStart + sDims[2]);
-    dim_t jStart = (expand ? 0 : fDims[1] / 2);
-    dim_t jEnd   = (expand ? oDims[1] : jStart + sDims[1]);
-    dim_t iStart = (expand ? 0 : fDims[0] / 2);
-    dim_t iEnd   = (expand ? oDims[0] : iStart + sDims[0]);
-
-    for (dim_t k = kStart; k < kEnd; ++k) {
-        dim_t koff = (k - kStart) * oStrides[2];
-
-        for (dim_t j = jStart; j < jEnd; ++j) {
-            dim_t joff = (j - jStart) * oStrides[1];
-
-            for (dim_t i = iStart; i < iEnd; ++i) {
-                AccT accum = AccT(0);
-                for (dim_t wk = 0; wk < fDims[2]; ++wk) {
-                    dim_t kIdx    = k - wk;
-                    dim_t w_koff  = wk * fStrides[2];
-                    dim_t s_koff  = kIdx * sStrides[2];
-                    bool isKValid = (kIdx >= 0 && kIdx < sDims[2]);
-
-                    for (dim_t wj = 0; wj < fDims[1]; ++wj) {
-                        dim_t jIdx    = j - wj;
-                        dim_t w_joff  = wj * fStrides[1];
-                        dim_t s_joff  = jIdx * sStrides[1];
-                        bool isJValid = (jIdx >= 0 && jIdx < sDims[1]);
-
-                        for (dim_t wi = 0; wi < fDims[0]; ++wi) {
-                            dim_t iIdx = i - wi;
-
-                            InT s_val = InT(0);
-                            if (isKValid && isJValid &&
-                                (iIdx >= 0 && iIdx < sDims[0])) {
-                                s_val =
-                                    iptr[s_koff + s_joff + iIdx * sStrides[0]];
-                            }
-
-                            accum +=
-                                AccT(s_val *
-                                     fptr[w_koff + w_joff + wi * fStrides[0]]);
-                        }
-                    }
-                }
-                optr[koff + joff + i - iStart] = InT(accum);
-            }  // i loop ends here
-        }      // j loop ends here
-    }          // k loop ends here
+/// Adds \p coeff times \p line to \p acc. The loop has no branches, so it is
+/// vectorized along dimension 0 by the compiler.
+template<typename AccT>
+inline void axpyLine(AccT *acc, AccT const *line, const AccT coeff,
+                     const dim_t length) {
+    for (dim_t t = 0; t < length; ++t) { acc[t] += line[t] * coeff; }
 }
 
+/// Direct convolution of rank 1, 2 or 3.
+///
+/// The input lines along dimension 0 are zero padded once into a LineCache,
+/// so the taps are applied without bounds checks. Each output line is
+/// accumulated in tiles of CONVOLVE_TILE elements from the lines of the
+/// input it overlaps. The output lines of all the batches are split across
+/// the thread pool.
 template<typename InT, typename AccT>
 void convolve_nd(Param<InT> out, CParam<InT> signal, CParam<AccT> filter,
                  AF_BATCH_KIND kind, const int rank, const bool expand) {
@@ -178,113 +128,158 @@ void convolve_nd(Param<InT> out, CParam<InT> signal, CParam<AccT> filter,
         }
     }
 
-    for (dim_t b3 = 0; b3 < batch[3]; ++b3) {
-        for (dim_t b2 = 0; b2 < batch[2]; ++b2) {
-            for (dim_t b1 = 0; b1 < batch[1]; ++b1) {
-                InT *out = optr + b1 * out_step[1] + b2 * out_step[2] +
-                           b3 * out_step[3];
-                InT const *in =
-                    iptr + b1 * in_step[1] + b2 * in_step[2] + b3 * in_step[3];
-                AccT const *filt = fptr + b1 * filt_step[1] +
-                                   b2 * filt_step[2] + b3 * filt_step[3];
-
-                switch (rank) {
-                    case 1:
-                        one2one_1d<InT, AccT>(out, in, filt, oDims, sDims,
-                                              fDims, sStrides, expand);
-                        break;
-                    case 2:
-                        one2one_2d<InT, AccT>(out, in, filt, oDims, sDims,
-                                              fDims, oStrides, sStrides,
-                                              fStrides, expand);
-                        break;
-                    case 3:
-                        one2one_3d<InT, AccT>(out, in, filt, oDims, sDims,
-                                              fDims, oStrides, sStrides,
-                                              fStrides, expand);
-                        break;
-                }
-            }
-        }
+    // The dimensions of a single convolution. The dimensions past the rank
+    // are batched.
+    dim_t sd[3], fd[3], od[3], start[3];
+    for (int d = 0; d < 3; ++d) {
+        sd[d]    = d < rank ? sDims[d] : 1;
+        fd[d]    = d < rank ? fDims[d] : 1;
+        od[d]    = expand ? sd[d] + fd[d] - 1 : sd[d];
+        start[d] = expand ? 0 : fd[d] / 2;
     }
-}
 
-template<typename InT, typename AccT, bool Expand, int ConvDim>
-void convolve2_separable(InT *optr, InT const *const iptr,
-                         AccT const *const fptr, af::dim4 const &oDims,
-                         af::dim4 const &sDims, af::dim4 const &orgDims,
-                         dim_t fDim, af::dim4 const &oStrides,
-                         af::dim4 const &sStrides, dim_t fStride) {
-    UNUSED(orgDims);
-    UNUSED(sStrides);
-    UNUSED(fStride);
-    for (dim_t j = 0; j < oDims[1]; ++j) {
-        dim_t jOff = j * oStrides[1];
-        dim_t cj   = j + (ConvDim == 1) * (Expand ? 0 : fDim >> 1);
-
-        for (dim_t i = 0; i < oDims[0]; ++i) {
-            dim_t iOff = i * oStrides[0];
-            dim_t ci   = i + (ConvDim == 0) * (Expand ? 0 : fDim >> 1);
-
-            AccT accum = scalar<AccT>(0);
-
-            for (dim_t f = 0; f < fDim; ++f) {
-                InT f_val = fptr[f];
-                InT s_val;
-
-                if (ConvDim == 0) {
-                    dim_t offi     = ci - f;
-                    bool isCIValid = offi >= 0 && offi < sDims[0];
-                    bool isCJValid = cj >= 0 && cj < sDims[1];
-                    s_val = (isCJValid && isCIValid ? iptr[cj * sDims[0] + offi]
-                                                    : scalar<InT>(0));
-                } else {
-                    dim_t offj     = cj - f;
-                    bool isCIValid = ci >= 0 && ci < sDims[0];
-                    bool isCJValid = offj >= 0 && offj < sDims[1];
-                    s_val = (isCJValid && isCIValid ? iptr[offj * sDims[0] + ci]
-                                                    : scalar<InT>(0));
+    // The input lines are padded by fd[0] - 1 zeros on each side
+    const dim_t lineLength = sd[0] + 2 * (fd[0] - 1);
+    const dim_t lines      = od[1] * od[2];
+    const dim_t slices     = batch[1] * batch[2] * batch[3];
+    const dim_t taps       = fd[0] * fd[1] * fd[2];
+
+    parallelFor(slices * lines, od[0] * taps, [&](dim_t first, dim_t last) {
+        LineCache<AccT> cache(fd[1] * fd[2], lineLength);
+        AccT acc[CONVOLVE_TILE];
+
+        for (dim_t unit = first; unit < last; ++unit) {
+            const dim_t slice = unit / lines;
+            const dim_t j     = unit % lines % od[1];
+            const dim_t k     = unit % lines / od[1];
+            const dim_t b1    = slice % batch[1];
+            const dim_t b2    = slice / batch[1] % batch[2];
+            const dim_t b3    = slice / (batch[1] * batch[2]);
+
+            InT *o = optr + b1 * out_step[1] + b2 * out_step[2] +
+                     b3 * out_step[3] + j * oStrides[1] + k * oStrides[2];
+            InT const *in =
+                iptr + b1 * in_step[1] + b2 * in_step[2] + b3 * in_step[3];
+            AccT const *filt = fptr + b1 * filt_step[1] +
+                               b2 * filt_step[2] + b3 * filt_step[3];
+
+            for (dim_t i0 = 0; i0 < od[0]; i0 += CONVOLVE_TILE) {
+                const dim_t tile = std::min(CONVOLVE_TILE, od[0] - i0);
+                std::fill(acc, acc + tile, scalar<AccT>(0));
+
+                for (dim_t wk = 0; wk < fd[2]; ++wk) {
+                    const dim_t p = k + start[2] - wk;
+                    if (p < 0 || p >= sd[2]) { continue; }
+
+                    for (dim_t wj = 0; wj < fd[1]; ++wj) {
+                        const dim_t r = j + start[1] - wj;
+                        if (r < 0 || r >= sd[1]) { continue; }
+
+                        const dim_t slot = r % fd[1] + fd[1] * (p % fd[2]);
+                        const dim_t key  = (slice * sd[2] + p) * sd[1] + r;
+                        AccT const *line = cache.get(slot, key, [&](AccT *dst) {
+                            padLine(dst,
+                                    in + r * sStrides[1] + p * sStrides[2],
+                                    sStrides[0], sd[0], fd[0] - 1, lineLength);
+                        });
+
+                        // Output i reads the padded input i + fd[0] - 1 - wi
+                        AccT const *src = line + i0 + start[0] + fd[0] - 1;
+                        AccT const *f   = filt + wj * fStrides[1] +
+                                        wk * fStrides[2];
+                        for (dim_t wi = 0; wi < fd[0]; ++wi) {
+                            axpyLine(acc, src - wi, f[wi * fStrides[0]], tile);
+                        }
+                    }
                 }
-
-                accum += AccT(s_val * f_val);
+                for (dim_t t = 0; t < tile; ++t) { o[i0 + t] = InT(acc[t]); }
             }
-            optr[iOff + jOff] = InT(accum);
         }
-    }
+    });
 }
 
+/// Separable convolution of the 2D slices of \p signal.
+///
+/// Each output row needs the column filtered rows it overlaps, which are
+/// computed into a LineCache of rflen rows instead of an intermediate
+/// image. The column filtered rows are rounded to InT like the
+/// intermediate image of the other backends.
 template<typename InT, typename AccT, bool Expand>
 void convolve2(Param<InT> out, CParam<InT> signal, CParam<AccT> c_filter,
-               CParam<AccT> r_filter, Param<InT> temp) {
-    dim_t cflen = (dim_t)c_filter.dims().elements();
-    dim_t rflen = (dim_t)r_filter.dims().elements();
-
-    auto oDims = out.dims();
-    auto sDims = signal.dims();
-
-    auto oStrides = out.strides();
-    auto sStrides = signal.strides();
-    auto tStrides = temp.strides();
-
-    for (dim_t b3 = 0; b3 < oDims[3]; ++b3) {
-        dim_t i_b3Off = b3 * sStrides[3];
-        dim_t t_b3Off = b3 * tStrides[3];
-        dim_t o_b3Off = b3 * oStrides[3];
-
-        for (dim_t b2 = 0; b2 < oDims[2]; ++b2) {
-            InT const *const iptr = signal.get() + b2 * sStrides[2] + i_b3Off;
-            InT *tptr             = temp.get() + b2 * tStrides[2] + t_b3Off;
-            InT *optr             = out.get() + b2 * oStrides[2] + o_b3Off;
-
-            convolve2_separable<InT, AccT, Expand, 0>(
-                tptr, iptr, c_filter.get(), temp.dims(), sDims, sDims, cflen,
-                tStrides, sStrides, c_filter.strides(0));
-
-            convolve2_separable<InT, AccT, Expand, 1>(
-                optr, tptr, r_filter.get(), oDims, temp.dims(), sDims, rflen,
-                oStrides, tStrides, r_filter.strides(0));
-        }
-    }
+               CParam<AccT> r_filter) {
+    const dim_t cflen = c_filter.dims().elements();
+    const dim_t rflen = r_filter.dims().elements();
+
+    const af::dim4 oDims    = out.dims();
+    const af::dim4 sDims    = signal.dims();
+    const af::dim4 oStrides = out.strides();
+    const af::dim4 sStrides = signal.strides();
+
+    AccT const *const cptr = c_filter.get();
+    AccT const *const rptr = r_filter.get();
+    const dim_t cstride    = c_filter.strides(0);
+    const dim_t rstride    = r_filter.strides(0);
+
+    const dim_t cstart     = Expand ? 0 : cflen / 2;
+    const dim_t rstart     = Expand ? 0 : rflen / 2;
+    const dim_t lineLength = sDims[0] + 2 * (cflen - 1);
+
+    const dim_t slices = oDims[2] * oDims[3];
+    parallelFor(
+        slices * oDims[1], oDims[0] * (cflen + rflen),
+        [&](dim_t first, dim_t last) {
+            // The padded signal row and the column filtered rows
+            std::vector<AccT> padded(lineLength);
+            LineCache<AccT> cache(rflen, oDims[0]);
+            AccT acc[CONVOLVE_TILE];
+            AccT rowAcc[CONVOLVE_TILE];
+
+            for (dim_t unit = first; unit < last; ++unit) {
+                const dim_t slice = unit / oDims[1];
+                const dim_t j     = unit % oDims[1];
+                const dim_t b2    = slice % oDims[2];
+                const dim_t b3    = slice / oDims[2];
+
+                InT const *in =
+                    signal.get() + b2 * sStrides[2] + b3 * sStrides[3];
+                InT *o = out.get() + b2 * oStrides[2] + b3 * oStrides[3] +
+                         j * oStrides[1];
+
+                auto filterRow = [&](dim_t r, AccT *dst) {
+                    padLine(padded.data(), in + r * sStrides[1], sStrides[0],
+                            sDims[0], cflen - 1, lineLength);
+                    for (dim_t i0 = 0; i0 < oDims[0]; i0 += CONVOLVE_TILE) {
+                        const dim_t tile =
+                            std::min(CONVOLVE_TILE, oDims[0] - i0);
+                        std::fill(rowAcc, rowAcc + tile, scalar<AccT>(0));
+                        AccT const *src =
+                            padded.data() + i0 + cstart + cflen - 1;
+                        for (dim_t f = 0; f < cflen; ++f) {
+                            axpyLine(rowAcc, src - f, cptr[f * cstride], tile);
+                        }
+                        for (dim_t t = 0; t < tile; ++t) {
+                            dst[i0 + t] = AccT(InT(rowAcc[t]));
+                        }
+                    }
+                };
+
+                for (dim_t i0 = 0; i0 < oDims[0]; i0 += CONVOLVE_TILE) {
+                    const dim_t tile = std::min(CONVOLVE_TILE, oDims[0] - i0);
+                    std::fill(acc, acc + tile, scalar<AccT>(0));
+                    for (dim_t f = 0; f < rflen; ++f) {
+                        const dim_t r = j + rstart - f;
+                        if (r < 0 || r >= sDims[1]) { continue; }
+                        AccT const *line =
+                            cache.get(r % rflen, slice * sDims[1] + r,
+                                      [&](AccT *dst) { filterRow(r, dst); });
+                        axpyLine(acc, line + i0, rptr[f * rstride], tile);
+                    }
+                    for (dim_t t = 0; t < tile; ++t) {
+                        o[i0 + t] = InT(acc[t]);
+                    }
+                }
+            }
+        });
 }
 
 }  // namespace kernel
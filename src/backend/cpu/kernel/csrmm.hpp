@@ -0,0 +1,248 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <math.hpp>
+#include <parallel_for.hpp>
+#include <platform.hpp>
+#include <thread_pool.hpp>
+#include <types.hpp>
+
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+namespace cpu {
+namespace kernel {
+
+// The products of a CSR or COO matrix and a dense matrix used when the CPU
+// backend is built without MKL
+
+template<typename T>
+T csrConjugate(const T &in) {
+    return in;
+}
+
+template<>
+inline cfloat csrConjugate(const cfloat &in) {
+    return std::conj(in);
+}
+
+template<>
+inline cdouble csrConjugate(const cdouble &in) {
+    return std::conj(in);
+}
+
+/// The number of tasks of the thread pool for \p work multiply-adds
+inline int csrTasks(const dim_t work) {
+    return static_cast<int>(std::max<dim_t>(
+        1, std::min<dim_t>(getThreadPool().size(),
+                           work / PARALLEL_MIN_TASK_ELEMENTS)));
+}
+
+/// Returns the nonzero \p v, conjugated when \p conjugate is true
+template<bool conjugate, typename T>
+T csrValue(const T &v) {
+    return conjugate ? csrConjugate(v) : v;
+}
+
+/// Returns the dot product of the nonzeros [\p begin, \p end) of a row with
+/// the dense vector \p x. The independent partial sums let the compiler
+/// compute the products in SIMD lanes with gathers of x.
+template<typename T, bool conjugate = false>
+T csrDot(const T *val, const int *col, const T *x, int begin, const int end) {
+    T s0 = scalar<T>(0), s1 = scalar<T>(0);
+    T s2 = scalar<T>(0), s3 = scalar<T>(0);
+    for (; begin + 4 <= end; begin += 4) {
+        s0 += csrValue<conjugate>(val[begin + 0]) * x[col[begin + 0]];
+        s1 += csrValue<conjugate>(val[begin + 1]) * x[col[begin + 1]];
+        s2 += csrValue<conjugate>(val[begin + 2]) * x[col[begin + 2]];
+        s3 += csrValue<conjugate>(val[begin + 3]) * x[col[begin + 3]];
+    }
+    for (; begin < end; ++begin) {
+        s0 += csrValue<conjugate>(val[begin]) * x[col[begin]];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+/// Finds the row and the nonzero where \p diagonal crosses the merge path of
+/// the row ends \p rowEnd and the \p nnz nonzeros of a CSR matrix
+inline void mergePathSearch(const int diagonal, const int *rowEnd,
+                            const int rows, const int nnz, int &row,
+                            int &idx) {
+    int lo = std::max(diagonal - nnz, 0);
+    int hi = std::min(diagonal, rows);
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (rowEnd[mid] <= diagonal - mid - 1) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    row = lo;
+    idx = diagonal - lo;
+}
+
+/// Computes out = lhs * rhs for the CSR matrix lhs, or out = conj(lhs) * rhs
+/// when \p conjugate is true.
+///
+/// The rows and the nonzeros are split evenly across the thread pool along
+/// their merge path, so long rows are shared by several tasks. A task which
+/// ends inside a row keeps the partial sum of that row, which is added to
+/// the output after all tasks finish.
+template<typename T, bool conjugate = false>
+void csrmm(Param<T> out, CParam<T> values, CParam<int> rowIdx,
+           CParam<int> colIdx, CParam<T> rhs) {
+    const int rows    = static_cast<int>(rowIdx.dims(0) - 1);
+    const dim_t ncols = rhs.dims(1);
+    const dim_t ldb   = rhs.strides(1);
+    const dim_t ldc   = out.strides(1);
+    const T *valPtr   = values.get();
+    const int *rowPtr = rowIdx.get();
+    const int *colPtr = colIdx.get();
+    const int nnz     = rowPtr[rows];
+    const int items   = rows + nnz;
+
+    const int ntasks = csrTasks(dim_t(items) * ncols);
+    std::vector<int> carryRow(ntasks);
+    std::vector<T> carry(ntasks * ncols);
+
+    auto task = [&](int t) {
+        const int perTask = divup(items, ntasks);
+        const int first   = std::min(t * perTask, items);
+        const int last    = std::min(first + perTask, items);
+        int row0, idx0, row1, idx1;
+        mergePathSearch(first, rowPtr + 1, rows, nnz, row0, idx0);
+        mergePathSearch(last, rowPtr + 1, rows, nnz, row1, idx1);
+
+        for (dim_t o = 0; o < ncols; ++o) {
+            const T *x = rhs.get() + o * ldb;
+            T *y       = out.get() + o * ldc;
+            int j      = idx0;
+            for (int row = row0; row < row1; ++row) {
+                y[row] = csrDot<T, conjugate>(valPtr, colPtr, x, j,
+                                              rowPtr[row + 1]);
+                j      = rowPtr[row + 1];
+            }
+            carry[t * ncols + o] =
+                csrDot<T, conjugate>(valPtr, colPtr, x, j, idx1);
+        }
+        carryRow[t] = row1;
+    };
+
+    if (ntasks == 1) {
+        task(0);
+    } else {
+        getThreadPool().run(ntasks, task);
+    }
+
+    for (int t = 0; t < ntasks; ++t) {
+        if (carryRow[t] >= rows) { continue; }
+        for (dim_t o = 0; o < ncols; ++o) {
+            out.get()[o * ldc + carryRow[t]] += carry[t * ncols + o];
+        }
+    }
+}
+
+/// Computes out = lhs * rhs with \p scatter, which adds the products of the
+/// nonzeros [begin, end) of lhs with the column x of rhs to the column y of
+/// the output.
+///
+/// Matrices with many columns are split by column. Otherwise the nonzeros
+/// are split evenly across the thread pool and each task scatters into its
+/// own accumulator, which are added in parallel.
+template<typename T, typename Scatter>
+void scatterMatmul(Param<T> out, CParam<T> rhs, const int nnz,
+                   Scatter scatter) {
+    const dim_t M     = out.dims(0);
+    const dim_t ncols = rhs.dims(1);
+    const dim_t ldb   = rhs.strides(1);
+    const dim_t ldc   = out.strides(1);
+
+    const int ntasks = csrTasks(dim_t(nnz) * ncols);
+    if (ncols >= ntasks) {
+        parallelFor(ncols, nnz, [&](dim_t first, dim_t last) {
+            for (dim_t o = first; o < last; ++o) {
+                T *y = out.get() + o * ldc;
+                std::fill(y, y + M, scalar<T>(0));
+                scatter(y, rhs.get() + o * ldb, 0, nnz);
+            }
+        });
+        return;
+    }
+
+    std::vector<T> acc(ntasks * M);
+    const int perTask = divup(nnz, ntasks);
+    for (dim_t o = 0; o < ncols; ++o) {
+        const T *x = rhs.get() + o * ldb;
+        T *y       = out.get() + o * ldc;
+        std::fill(acc.begin(), acc.end(), scalar<T>(0));
+        getThreadPool().run(ntasks, [&](int t) {
+            const int first = std::min(t * perTask, nnz);
+            const int last  = std::min(first + perTask, nnz);
+            scatter(acc.data() + t * M, x, first, last);
+        });
+        parallelFor(M, ntasks, [&](dim_t first, dim_t last) {
+            for (dim_t i = first; i < last; ++i) {
+                T sum = acc[i];
+                for (int t = 1; t < ntasks; ++t) { sum += acc[t * M + i]; }
+                y[i] = sum;
+            }
+        });
+    }
+}
+
+/// Computes out = op(lhs) * rhs for the CSR matrix lhs, where op is the
+/// transpose or the conjugate transpose. The nonzeros are scattered to the
+/// rows of the output.
+template<typename T, bool conjugate>
+void csrmtm(Param<T> out, CParam<T> values, CParam<int> rowIdx,
+            CParam<int> colIdx, CParam<T> rhs) {
+    const int rows    = static_cast<int>(rowIdx.dims(0) - 1);
+    const T *valPtr   = values.get();
+    const int *rowPtr = rowIdx.get();
+    const int *colPtr = colIdx.get();
+    const int nnz     = rowPtr[rows];
+
+    scatterMatmul(out, rhs, nnz, [&](T *y, const T *x, int begin, int end) {
+        int row = static_cast<int>(
+            std::upper_bound(rowPtr, rowPtr + rows + 1, begin) - rowPtr - 1);
+        for (; begin < end; ++begin) {
+            while (begin >= rowPtr[row + 1]) { ++row; }
+            y[colPtr[begin]] += csrValue<conjugate>(valPtr[begin]) * x[row];
+        }
+    });
+}
+
+/// Computes out = op(lhs) * rhs for the COO matrix lhs, where op is the
+/// identity, or the transpose or the conjugate transpose when \p transpose
+/// is true. The nonzeros may be in any order, so they are scattered to the
+/// rows of the output.
+template<typename T, bool transpose, bool conjugate>
+void coomm(Param<T> out, CParam<T> values, CParam<int> rowIdx,
+           CParam<int> colIdx, CParam<T> rhs) {
+    const T *valPtr   = values.get();
+    const int *outIdx = transpose ? colIdx.get() : rowIdx.get();
+    const int *inIdx  = transpose ? rowIdx.get() : colIdx.get();
+    const int nnz     = static_cast<int>(values.dims(0));
+
+    scatterMatmul(out, rhs, nnz, [&](T *y, const T *x, int begin, int end) {
+        for (; begin < end; ++begin) {
+            y[outIdx[begin]] +=
+                csrValue<conjugate>(valPtr[begin]) * x[inIdx[begin]];
+        }
+    });
+}
+
+}  // namespace kernel
+}  // namespace cpu
@@ -0,0 +1,56 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <math.hpp>
+#include <parallel_for.hpp>
+
+namespace cpu {
+namespace kernel {
+
+/// Solves the lower or the \p upper triangle of the CSR matrix of \p values,
+/// \p rowIdx and \p colIdx in place of the columns of \p x. The entries of
+/// the other triangle are ignored, and so is the diagonal when it is \p unit.
+///
+/// The rows of a column depend on each other, so the columns are split
+/// across the thread pool.
+template<typename T>
+void csrsv(Param<T> x, CParam<T> values, CParam<int> rowIdx,
+           CParam<int> colIdx, const bool upper, const bool unit) {
+    const int M       = static_cast<int>(x.dims(0));
+    const dim_t ldx   = x.strides(1);
+    const T *valPtr   = values.get();
+    const int *rowPtr = rowIdx.get();
+    const int *colPtr = colIdx.get();
+
+    parallelFor(x.dims(1), rowPtr[M], [&](dim_t first, dim_t last) {
+        for (dim_t o = first; o < last; ++o) {
+            T *y = x.get() + o * ldx;
+            for (int n = 0; n < M; ++n) {
+                const int row = upper ? M - 1 - n : n;
+                T sum         = y[row];
+                T diag        = scalar<T>(1);
+                for (int j = rowPtr[row]; j < rowPtr[row + 1]; ++j) {
+                    const int col = colPtr[j];
+                    if (upper ? col > row : col < row) {
+                        sum -= valPtr[j] * y[col];
+                    } else if (col == row) {
+                        diag = valPtr[j];
+                    }
+                }
+                y[row] = unit ? sum : sum / diag;
+            }
+        }
+    });
+}
+
+}  // namespace kernel
+}  // namespace cpu
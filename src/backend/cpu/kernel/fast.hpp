@@ -10,6 +10,10 @@
 #pragma once
 #include <Param.hpp>
 #include <math.hpp>
+#include <parallel_for.hpp>
+
+#include <algorithm>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
@@ -26,190 +30,131 @@ inline int idx_x(int i) {
     return idx_y(i - 12);
 }
 
-inline int idx(int y, int x, unsigned idim0) { return x * idim0 + y; }
-
-// test_greater()
-// Tests if a pixel x > p + thr
-inline int test_greater(float x, float p, float thr) { return (x > p + thr); }
-
-// test_smaller()
-// Tests if a pixel x < p - thr
-inline int test_smaller(float x, float p, float thr) { return (x < p - thr); }
-
-// test_pixel()
-// Returns -1 when x < p - thr
-// Returns  0 when x >= p - thr && x <= p + thr
-// Returns  1 when x > p + thr
-template<typename T>
-inline int test_pixel(const T *image, const float p, float thr, int y, int x,
-                      unsigned idim0) {
-    return -test_smaller((float)image[idx(y, x, idim0)], p, thr) +
-           test_greater((float)image[idx(y, x, idim0)], p, thr);
-}
-
 // abs_diff()
 // Returns absolute difference of x and y
-inline int abs_diff(int x, int y) { return abs(x - y); }
-inline unsigned abs_diff(unsigned x, unsigned y) {
-    return (unsigned)abs((int)x - (int)y);
-}
 inline float abs_diff(float x, float y) { return fabs(x - y); }
-inline double abs_diff(double x, double y) { return fabs(x - y); }
 
+// has_arc()
+// Returns true when the 16 bit \p mask of the pixels of the circle has a
+// cyclic run of \p arc_length set bits. Each step keeps the bits which start
+// a run one pixel longer.
+inline bool has_arc(unsigned mask, unsigned const arc_length) {
+    unsigned run = mask | (mask << 16);
+    for (unsigned i = 1; i < arc_length; i++) run &= run >> 1;
+    return (run & 0xFFFF) != 0;
+}
+
+struct Feature {
+    float x;
+    float y;
+    float score;
+};
+
+// Writes the score of the corners of \p in to \p score, which is zero for
+// the other pixels. The pixels of the circle are compared against the
+// threshold once, and the results are kept as masks of bright and dark
+// pixels whose arcs are found with bit operations.
+//
+// The columns of the image are split across the thread pool.
 template<typename T>
-void locate_features(CParam<T> in, Param<float> score, Param<float> x_out,
-                     Param<float> y_out, Param<float> score_out,
-                     unsigned *count, float const thr,
-                     unsigned const arc_length, unsigned const nonmax,
-                     unsigned const max_feat, unsigned const edge) {
+void locate_features(CParam<T> in, Param<float> score, float const thr,
+                     unsigned const arc_length, unsigned const edge) {
     af::dim4 in_dims = in.dims();
     T const *in_ptr  = in.get();
+    float *score_ptr = score.get();
+    dim_t const d0   = in_dims[0];
+
+    // Offsets of the pixels of the circle from its center
+    dim_t circle[16];
+    for (int i = 0; i < 16; i++) circle[i] = idx_x(i) * d0 + idx_y(i);
+
+    parallelFor(in_dims[1] - 2 * edge, 16 * d0, [&](dim_t first, dim_t last) {
+        for (dim_t x = first + edge; x < last + edge; x++) {
+            for (dim_t y = edge; y < d0 - edge; y++) {
+                T const *center = in_ptr + x * d0 + y;
+                float p         = *center;
+
+                // An arc of at least 9 pixels contains one pixel of each
+                // pair of opposite pixels of the compass points
+                unsigned bright = 0, dark = 0;
+                for (int i = 0; i < 16; i += 4) {
+                    float p_x = center[circle[i]];
+                    bright |= unsigned(p_x > p + thr) << i;
+                    dark |= unsigned(p_x < p - thr) << i;
+                }
+                bool maybe_bright =
+                    (bright & 0x0101) != 0 && (bright & 0x1010) != 0;
+                bool maybe_dark = (dark & 0x0101) != 0 && (dark & 0x1010) != 0;
+                if (!maybe_bright && !maybe_dark) continue;
+
+                float s_bright = 0, s_dark = 0;
+                for (int i = 0; i < 16; i++) {
+                    float p_x = center[circle[i]];
+                    bool b    = p_x > p + thr;
+                    bool d    = p_x < p - thr;
+                    bright |= unsigned(b) << i;
+                    dark |= unsigned(d) << i;
+
+                    float weight = abs_diff(p_x, p) - thr;
+                    s_bright += b * weight;
+                    s_dark += d * weight;
+                }
 
-    for (int y = edge; y < (int)(in_dims[0] - edge); y++) {
-        for (int x = edge; x < (int)(in_dims[1] - edge); x++) {
-            float p = in_ptr[idx(y, x, in_dims[0])];
-
-            // Start by testing opposite pixels of the circle that will result
-            // in a non-kepoint
-            int d;
-            d = test_pixel<T>(in_ptr, p, thr, y - 3, x, in_dims[0]) |
-                test_pixel<T>(in_ptr, p, thr, y + 3, x, in_dims[0]);
-            if (d == 0) continue;
-
-            d &= test_pixel<T>(in_ptr, p, thr, y - 2, x + 2, in_dims[0]) |
-                 test_pixel<T>(in_ptr, p, thr, y + 2, x - 2, in_dims[0]);
-            d &= test_pixel<T>(in_ptr, p, thr, y, x + 3, in_dims[0]) |
-                 test_pixel<T>(in_ptr, p, thr, y, x - 3, in_dims[0]);
-            d &= test_pixel<T>(in_ptr, p, thr, y + 2, x + 2, in_dims[0]) |
-                 test_pixel<T>(in_ptr, p, thr, y - 2, x - 2, in_dims[0]);
-            if (d == 0) continue;
-
-            d &= test_pixel<T>(in_ptr, p, thr, y - 3, x + 1, in_dims[0]) |
-                 test_pixel<T>(in_ptr, p, thr, y + 3, x - 1, in_dims[0]);
-            d &= test_pixel<T>(in_ptr, p, thr, y - 1, x + 3, in_dims[0]) |
-                 test_pixel<T>(in_ptr, p, thr, y + 1, x - 3, in_dims[0]);
-            d &= test_pixel<T>(in_ptr, p, thr, y + 1, x + 3, in_dims[0]) |
-                 test_pixel<T>(in_ptr, p, thr, y - 1, x - 3, in_dims[0]);
-            d &= test_pixel<T>(in_ptr, p, thr, y + 3, x + 1, in_dims[0]) |
-                 test_pixel<T>(in_ptr, p, thr, y - 3, x - 1, in_dims[0]);
-            if (d == 0) continue;
-
-            int sum = 0;
-
-            // Sum responses [-1, 0 or 1] of first arc_length pixels
-            for (int i = 0; i < static_cast<int>(arc_length); i++)
-                sum += test_pixel<T>(in_ptr, p, thr, y + idx_y(i), x + idx_x(i),
-                                     in_dims[0]);
-
-            // Test maximum and mininmum responses of first segment of
-            // arc_length pixels
-            int max_sum = 0, min_sum = 0;
-            max_sum = std::max(max_sum, sum);
-            min_sum = std::min(min_sum, sum);
-
-            // Sum responses and test the remaining 16-arc_length pixels of the
-            // circle
-            for (int i = arc_length; i < 16; i++) {
-                sum -= test_pixel<T>(in_ptr, p, thr, y + idx_y(i - arc_length),
-                                     x + idx_x(i - arc_length), in_dims[0]);
-                sum += test_pixel<T>(in_ptr, p, thr, y + idx_y(i), x + idx_x(i),
-                                     in_dims[0]);
-                max_sum = std::max(max_sum, sum);
-                min_sum = std::min(min_sum, sum);
-            }
-
-            // To completely test all possible segments, it's necessary to test
-            // segments that include the top junction of the circle
-            for (int i = 0; i < static_cast<int>(arc_length - 1); i++) {
-                sum -= test_pixel<T>(
-                    in_ptr, p, thr, y + idx_y(16 - arc_length + i),
-                    x + idx_x(16 - arc_length + i), in_dims[0]);
-                sum += test_pixel<T>(in_ptr, p, thr, y + idx_y(i), x + idx_x(i),
-                                     in_dims[0]);
-                max_sum = std::max(max_sum, sum);
-                min_sum = std::min(min_sum, sum);
-            }
-
-            float s_bright = 0, s_dark = 0;
-            for (int i = 0; i < 16; i++) {
-                float p_x =
-                    (float)in_ptr[idx(y + idx_y(i), x + idx_x(i), in_dims[0])];
-
-                s_bright +=
-                    test_greater(p_x, p, thr) * (abs_diff(p_x, p) - thr);
-                s_dark += test_smaller(p_x, p, thr) * (abs_diff(p, p_x) - thr);
-            }
-
-            // If sum at some point was equal to (+-)arc_length, there is a
-            // segment that for which all pixels are much brighter or much
-            // brighter than central pixel p.
-            if (max_sum == static_cast<int>(arc_length) ||
-                min_sum == -static_cast<int>(arc_length)) {
-                unsigned j = *count;
-                ++*count;
-                if (j < max_feat) {
-                    float *x_out_ptr     = x_out.get();
-                    float *y_out_ptr     = y_out.get();
-                    float *score_out_ptr = score_out.get();
-                    x_out_ptr[j]         = static_cast<float>(x);
-                    y_out_ptr[j]         = static_cast<float>(y);
-                    score_out_ptr[j] =
-                        static_cast<float>(std::max(s_bright, s_dark));
-                    if (nonmax == 1) {
-                        float *score_ptr = score.get();
-                        score_ptr[idx(y, x, in_dims[0])] =
-                            std::max(s_bright, s_dark);
-                    }
+                // A corner has a segment of arc_length pixels which are all
+                // much brighter or all much darker than the central pixel p
+                if (has_arc(bright, arc_length) || has_arc(dark, arc_length)) {
+                    score_ptr[x * d0 + y] = std::max(s_bright, s_dark);
                 }
             }
         }
-    }
+    });
 }
 
-void non_maximal(CParam<float> score, CParam<float> x_in, CParam<float> y_in,
-                 Param<float> x_out, Param<float> y_out, Param<float> score_out,
-                 unsigned *count, unsigned const total_feat,
-                 unsigned const edge) {
+// Returns the corners of \p score in column major order. With \p nonmax,
+// only the corners whose score is larger than the ones of their
+// 8-neighborhood are kept, at least edge + 2 pixels away from the border.
+inline std::vector<Feature> collect_features(CParam<float> score,
+                                             unsigned const nonmax,
+                                             unsigned const edge) {
+    af::dim4 dims          = score.dims();
     float const *score_ptr = score.get();
-    float const *x_in_ptr  = x_in.get();
-    float const *y_in_ptr  = y_in.get();
-
-    af::dim4 score_dims = score.dims();
-
-    for (unsigned k = 0; k < total_feat; k++) {
-        unsigned x = static_cast<unsigned>(round(x_in_ptr[k]));
-        unsigned y = static_cast<unsigned>(round(y_in_ptr[k]));
-
-        float v = score_ptr[y + score_dims[0] * x];
-        float max_v;
-        max_v = std::max(score_ptr[y - 1 + score_dims[0] * (x - 1)],
-                         score_ptr[y - 1 + score_dims[0] * x]);
-        max_v = std::max(max_v, score_ptr[y - 1 + score_dims[0] * (x + 1)]);
-        max_v = std::max(max_v, score_ptr[y + score_dims[0] * (x - 1)]);
-        max_v = std::max(max_v, score_ptr[y + score_dims[0] * (x + 1)]);
-        max_v = std::max(max_v, score_ptr[y + 1 + score_dims[0] * (x - 1)]);
-        max_v = std::max(max_v, score_ptr[y + 1 + score_dims[0] * (x)]);
-        max_v = std::max(max_v, score_ptr[y + 1 + score_dims[0] * (x + 1)]);
-
-        if (y >= score_dims[1] - edge - 1 || y <= edge + 1 ||
-            x >= score_dims[0] - edge - 1 || x <= edge + 1)
-            continue;
-
-        // Stores keypoint to feat_out if it's response is maximum compared to
-        // its 8-neighborhood
-        if (v > max_v) {
-            unsigned j = *count;
-            ++*count;
-
-            float *x_out_ptr     = x_out.get();
-            float *y_out_ptr     = y_out.get();
-            float *score_out_ptr = score_out.get();
-
-            x_out_ptr[j]     = static_cast<float>(x);
-            y_out_ptr[j]     = static_cast<float>(y);
-            score_out_ptr[j] = static_cast<float>(v);
+    dim_t const d0         = dims[0];
+
+    // The features of each range of columns, at the index of its first one
+    std::vector<std::vector<Feature>> blocks(dims[1]);
+    parallelFor(dims[1], d0, [&](dim_t first, dim_t last) {
+        std::vector<Feature> &feat = blocks[first];
+        for (dim_t x = first; x < last; x++) {
+            for (dim_t y = 0; y < d0; y++) {
+                float const *v = score_ptr + x * d0 + y;
+                if (*v <= 0.f) continue;
+
+                if (nonmax == 1) {
+                    if (y >= d0 - edge - 1 || y <= edge + 1 ||
+                        x >= dims[1] - edge - 1 || x <= edge + 1)
+                        continue;
+
+                    float max_v = std::max(v[-d0 - 1], v[-1]);
+                    max_v       = std::max(max_v, v[d0 - 1]);
+                    max_v       = std::max(max_v, v[-d0]);
+                    max_v       = std::max(max_v, v[d0]);
+                    max_v       = std::max(max_v, v[-d0 + 1]);
+                    max_v       = std::max(max_v, v[1]);
+                    max_v       = std::max(max_v, v[d0 + 1]);
+                    if (*v <= max_v) continue;
+                }
+
+                feat.push_back({static_cast<float>(x), static_cast<float>(y),
+                                *v});
+            }
         }
+    });
+
+    std::vector<Feature> features;
+    for (auto &feat : blocks) {
+        features.insert(features.end(), feat.begin(), feat.end());
     }
+    return features;
 }
 
 }  // namespace kernel
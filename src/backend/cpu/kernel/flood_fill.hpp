@@ -12,8 +12,8 @@
 #include <ParamIterator.hpp>
 #include <common/defines.hpp>
 
-#include <queue>
-#include <utility>
+#include <algorithm>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
@@ -25,7 +25,12 @@ namespace kernel {
 //                         using createValueArray helper at level of the
 //                         functions caller)
 // 1 - not valid
-// 2 - valid (candidate for neighborhood walk, pushed onto the queue)
+// 2 - valid (part of a span pushed onto the stack)
+//
+// The region is filled a span of a column at a time: each span looks for
+// new spans in its own column and the neighboring ones, over its extent
+// widened by one pixel. Every pixel is visited a constant number of times,
+// so the work is proportional to the area of the region.
 //
 // Once, the algorithm is finished, output is reset
 // to either zero or \p newValue for all valid pixels.
@@ -34,82 +39,72 @@ void floodFill(Param<T> out, CParam<T> in, CParam<uint> x, CParam<uint> y,
                T newValue, T lower, T upper, af::connectivity connectivity) {
     UNUSED(connectivity);
 
-    using af::dim4;
-    using PtrDist    = typename ParamIterator<T>::difference_type;
-    using Point      = std::pair<uint, uint>;
-    using Candidates = std::queue<Point>;
-
-    const dim4 dims    = in.dims();
-    const dim4 strides = in.strides();
+    // The column and the first and last rows of a run of valid pixels
+    struct Span {
+        uint col;
+        uint first;
+        uint last;
+    };
 
-    ParamIterator<T> endOfNeighborhood;
-    const dim4 nhoodRadii(1, 1, 0, 0);
-    const dim4 nhood(2 * nhoodRadii[0] + 1, 2 * nhoodRadii[1] + 1,
-                     2 * nhoodRadii[2] + 1, 2 * nhoodRadii[3] + 1);
+    const af::dim4 dims = in.dims();
+    const uint nrows    = static_cast<uint>(dims[0]);
+    const uint ncols    = static_cast<uint>(dims[1]);
+    const dim_t istride = in.strides(1);
+    const dim_t ostride = out.strides(1);
+    const T* inPtr      = in.get();
+    T* outPtr           = out.get();
 
-    auto isInside = [&dims](uint x, uint y) {
-        return (x >= 0 && x < dims[0] && y >= 0 && y < dims[1]);
-    };
-    auto leftTopPtr = [&strides, &nhoodRadii](T* ptr, const af::dim4& center) {
-        T* ltPtr = ptr;
-        for (dim_t d = 0; d < AF_MAX_DIMS; ++d) {
-            ltPtr += ((center[d] - nhoodRadii[d]) * strides[d]);
-        }
-        return ltPtr;
-    };
-    Candidates queue;
+    std::vector<Span> stack;
     {
-        auto oit = begin(out);
-        for (auto xit = begin(x), yit = begin(y);
-             xit != end(x) && yit != end(y); ++xit, ++yit) {
-            if (isInside(*xit, *yit)) {
-                queue.emplace(*xit, *yit);
-                oit.operator->()[(*xit) + (*yit) * dims[0]] = T(2);
+        const uint* xPtr = x.get();
+        const uint* yPtr = y.get();
+        const dim_t n    = std::min(x.dims().elements(), y.dims().elements());
+        for (dim_t i = 0; i < n; ++i) {
+            if (xPtr[i] < nrows && yPtr[i] < ncols) {
+                outPtr[xPtr[i] + yPtr[i] * ostride] = T(2);
+                stack.push_back({yPtr[i], xPtr[i], xPtr[i]});
             }
         }
     }
 
-    T* inPtr  = const_cast<T*>(in.get());
-    T* outPtr = out.get();
-
-    while (!queue.empty()) {
-        Point& p = queue.front();
-
-        const dim4 center(p.first, p.second, 0, 0);
-
-        CParam<T> inNHood(const_cast<const T*>(leftTopPtr(inPtr, center)),
-                          nhood, strides);
-        Param<T> outNHood(leftTopPtr(outPtr, center), nhood, strides);
-
-        ParamIterator<T> inIter(inNHood);
-        ParamIterator<T> outIter(outNHood);
-
-        while (inIter != endOfNeighborhood) {
-            const T* ptr     = inIter.operator->();
-            PtrDist dist     = ptr - inPtr;
-            const uint currx = static_cast<uint>(dist % dims[0]);
-            const uint curry = static_cast<uint>(dist / dims[0]);
-
-            if (isInside(currx, curry) && (*outIter == 0)) {
-                // Current point is inside image boundaries and hasn't been
-                // visited at all.
-                if (*inIter >= lower && *inIter <= upper) {
-                    // Current pixel is within threshold limits.
-                    // Mark as valid and push on to the queue
-                    *outIter = T(2);
-                    queue.emplace(currx, curry);
-                } else {
-                    // Not valid pixel
-                    *outIter = T(1);
+    while (!stack.empty()) {
+        const Span span = stack.back();
+        stack.pop_back();
+
+        const uint firstCol = span.col > 0 ? span.col - 1 : 0;
+        const uint lastCol  = std::min(span.col + 1, ncols - 1);
+        const uint firstRow = span.first > 0 ? span.first - 1 : 0;
+        const uint lastRow  = std::min(span.last + 1, nrows - 1);
+
+        for (uint col = firstCol; col <= lastCol; ++col) {
+            const T* iCol = inPtr + col * istride;
+            T* oCol       = outPtr + col * ostride;
+            auto isValid  = [&](uint row) {
+                return iCol[row] >= lower && iCol[row] <= upper;
+            };
+
+            for (uint row = firstRow; row <= lastRow; ++row) {
+                if (oCol[row] != T(0)) { continue; }
+                if (!isValid(row)) {
+                    oCol[row] = T(1);
+                    continue;
+                }
+                // Grow the new span in both directions past the extent
+                uint first = row;
+                uint last  = row;
+                while (first > 0 && oCol[first - 1] == T(0) &&
+                       isValid(first - 1)) {
+                    --first;
+                }
+                while (last + 1 < nrows && oCol[last + 1] == T(0) &&
+                       isValid(last + 1)) {
+                    ++last;
                 }
+                for (uint r = first; r <= last; ++r) { oCol[r] = T(2); }
+                stack.push_back({col, first, last});
+                row = last;
             }
-            // Both input and output neighborhood iterators
-            // should increment in lock step for this algorithm
-            // to work correctly
-            ++inIter;
-            ++outIter;
         }
-        queue.pop();
     }
 
     for (auto outIter = begin(out); outIter != end(out); ++outIter) {
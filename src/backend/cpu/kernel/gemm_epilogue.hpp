@@ -0,0 +1,75 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/complex.hpp>
+#include <af/defines.h>
+
+#include <cmath>
+#include <type_traits>
+
+namespace cpu {
+namespace kernel {
+
+// Complex values only get the bias. The API rejects their activations.
+template<typename T>
+common::if_complex<T, T> epilogueOp(const T val, const T *bias,
+                                    af_gemm_epilogue) {
+    return bias ? val + *bias : val;
+}
+
+template<typename T>
+common::if_real<T, T> epilogueOp(const T val, const T *bias,
+                                 af_gemm_epilogue epilogue) {
+    using CT = typename std::conditional<std::is_same<T, double>::value,
+                                         double, float>::type;
+
+    CT x = static_cast<CT>(val);
+    if (bias) { x += static_cast<CT>(*bias); }
+
+    switch (epilogue) {
+        case AF_GEMM_EPILOGUE_RELU: x = x > CT(0) ? x : CT(0); break;
+        case AF_GEMM_EPILOGUE_GELU: {
+            const CT k = CT(0.7978845608028654);  // sqrt(2 / pi)
+            x = CT(0.5) * x *
+                (CT(1) + std::tanh(k * (x + CT(0.044715) * x * x * x)));
+            break;
+        }
+        default: break;
+    }
+    return static_cast<T>(x);
+}
+
+/// Adds the column vector \p bias to every column of \p out and applies the
+/// activation of \p epilogue in place. An empty \p bias adds nothing.
+template<typename T>
+void gemmEpilogue(Param<T> out, CParam<T> bias, af_gemm_epilogue epilogue) {
+    const af::dim4 dims    = out.dims();
+    const af::dim4 strides = out.strides();
+    const T *bptr          = bias.dims().elements() > 0 ? bias.get() : nullptr;
+    const dim_t bstride    = bias.strides()[0];
+
+    for (dim_t w = 0; w < dims[3]; w++) {
+        for (dim_t z = 0; z < dims[2]; z++) {
+            for (dim_t j = 0; j < dims[1]; j++) {
+                T *optr = out.get() + w * strides[3] + z * strides[2] +
+                          j * strides[1];
+                for (dim_t i = 0; i < dims[0]; i++) {
+                    const T *b = bptr ? bptr + i * bstride : nullptr;
+                    optr[i]    = epilogueOp(optr[i], b, epilogue);
+                }
+            }
+        }
+    }
+}
+
+}  // namespace kernel
+}  // namespace cpu
@@ -0,0 +1,78 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <types.hpp>
+#include <af/defines.h>
+
+namespace cpu {
+namespace kernel {
+
+/// Computes out = (op(lhs) - lhsZero) (op(rhs) - rhsZero) in 32-bit integers.
+/// Every column of out is accumulated from the columns of op(lhs), which are
+/// contiguous unless lhs is transposed, so the inner loop is vectorized.
+inline void gemmQuantized(Param<int> out, CParam<uchar> lhs,
+                          CParam<uchar> rhs, af_mat_prop optLhs,
+                          af_mat_prop optRhs, int lhsZero, int rhsZero) {
+    const af::dim4 oDims    = out.dims();
+    const af::dim4 lDims    = lhs.dims();
+    const af::dim4 rDims    = rhs.dims();
+    const af::dim4 oStrides = out.strides();
+    const af::dim4 lStrides = lhs.strides();
+    const af::dim4 rStrides = rhs.strides();
+
+    const bool lTrans = optLhs != AF_MAT_NONE;
+    const bool rTrans = optRhs != AF_MAT_NONE;
+    const dim_t M     = oDims[0];
+    const dim_t N     = oDims[1];
+    const dim_t K     = lDims[lTrans ? 0 : 1];
+
+    // The strides of the rows and the columns of op(lhs) and op(rhs)
+    const dim_t lRow = lTrans ? lStrides[1] : 1;
+    const dim_t lCol = lTrans ? 1 : lStrides[1];
+    const dim_t rRow = rTrans ? rStrides[1] : 1;
+    const dim_t rCol = rTrans ? 1 : rStrides[1];
+
+    for (dim_t w = 0; w < oDims[3]; w++) {
+        for (dim_t z = 0; z < oDims[2]; z++) {
+            const uchar *lptr = lhs.get() +
+                                (lDims[2] == 1 ? 0 : z) * lStrides[2] +
+                                (lDims[3] == 1 ? 0 : w) * lStrides[3];
+            const uchar *rptr = rhs.get() +
+                                (rDims[2] == 1 ? 0 : z) * rStrides[2] +
+                                (rDims[3] == 1 ? 0 : w) * rStrides[3];
+            int *optr = out.get() + z * oStrides[2] + w * oStrides[3];
+
+            for (dim_t j = 0; j < N; j++) {
+                int *ocol = optr + j * oStrides[1];
+                for (dim_t i = 0; i < M; i++) { ocol[i] = 0; }
+
+                for (dim_t k = 0; k < K; k++) {
+                    const int r = rptr[k * rRow + j * rCol] - rhsZero;
+                    if (r == 0) { continue; }
+                    const uchar *lcol = lptr + k * lCol;
+                    if (lRow == 1) {
+                        for (dim_t i = 0; i < M; i++) {
+                            ocol[i] += (lcol[i] - lhsZero) * r;
+                        }
+                    } else {
+                        for (dim_t i = 0; i < M; i++) {
+                            ocol[i] += (lcol[i * lRow] - lhsZero) * r;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // namespace kernel
+}  // namespace cpu
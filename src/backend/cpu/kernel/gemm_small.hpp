@@ -0,0 +1,140 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <math.hpp>
+#include <parallel_for.hpp>
+#include <types.hpp>
+#include <af/defines.h>
+
+#include <complex>
+
+namespace cpu {
+namespace kernel {
+
+/// The largest M, N and K of the batched products computed by gemmSmall
+constexpr dim_t GEMM_SMALL_MAX_DIM = 32;
+
+template<typename T>
+T conjugateIf(T x, bool) {
+    return x;
+}
+
+inline cfloat conjugateIf(cfloat x, bool conjugate) {
+    return conjugate ? std::conj(x) : x;
+}
+
+inline cdouble conjugateIf(cdouble x, bool conjugate) {
+    return conjugate ? std::conj(x) : x;
+}
+
+/// Computes the product of one slice of a batch from op(lhs), which is
+/// packed in \p lpack as a contiguous M x K matrix. Each column of the
+/// output is accumulated in a local array, which the compiler keeps in
+/// registers and vectorizes when the number of rows \p Mt is known at
+/// compile time. Mt is 0 for the other sizes.
+template<typename T, int Mt>
+void gemmSmallSlice(T *optr, const T *lpack, const T *rptr, const dim_t M,
+                    const dim_t N, const dim_t K, const dim_t rRow,
+                    const dim_t rCol, const dim_t oCol, const bool rConj,
+                    const T alpha, const T beta) {
+    constexpr dim_t rows = Mt ? Mt : GEMM_SMALL_MAX_DIM;
+    const dim_t m        = Mt ? Mt : M;
+
+    for (dim_t j = 0; j < N; j++) {
+        T acc[rows];
+        for (dim_t i = 0; i < m; i++) { acc[i] = scalar<T>(0); }
+
+        for (dim_t k = 0; k < K; k++) {
+            const T r     = conjugateIf(rptr[k * rRow + j * rCol], rConj);
+            const T *lcol = lpack + k * m;
+            for (dim_t i = 0; i < m; i++) { acc[i] += lcol[i] * r; }
+        }
+
+        // The output is not read when beta is zero, as in BLAS
+        T *ocol = optr + j * oCol;
+        if (beta == scalar<T>(0)) {
+            for (dim_t i = 0; i < m; i++) { ocol[i] = alpha * acc[i]; }
+        } else {
+            for (dim_t i = 0; i < m; i++) {
+                ocol[i] = alpha * acc[i] + beta * ocol[i];
+            }
+        }
+    }
+}
+
+/// Computes out = alpha op(lhs) op(rhs) + beta out for batches of matrices
+/// whose dimensions are at most GEMM_SMALL_MAX_DIM. The call overhead of
+/// BLAS dominates these products, so they are computed here and the slices
+/// of the batch are distributed over the thread pool. The slices of lhs or
+/// rhs with a single matrix in a batch dimension are broadcast.
+template<typename T>
+void gemmSmall(Param<T> out, CParam<T> lhs, CParam<T> rhs, af_mat_prop optLhs,
+               af_mat_prop optRhs, const T alpha, const T beta) {
+    const af::dim4 oDims    = out.dims();
+    const af::dim4 lDims    = lhs.dims();
+    const af::dim4 rDims    = rhs.dims();
+    const af::dim4 oStrides = out.strides();
+    const af::dim4 lStrides = lhs.strides();
+    const af::dim4 rStrides = rhs.strides();
+
+    const bool lTrans = optLhs != AF_MAT_NONE;
+    const bool rTrans = optRhs != AF_MAT_NONE;
+    const bool lConj  = optLhs == AF_MAT_CTRANS;
+    const bool rConj  = optRhs == AF_MAT_CTRANS;
+    const dim_t M     = oDims[0];
+    const dim_t N     = oDims[1];
+    const dim_t K     = lDims[lTrans ? 0 : 1];
+
+    // The strides of the rows and the columns of op(lhs) and op(rhs)
+    const dim_t lRow = lTrans ? lStrides[1] : 1;
+    const dim_t lCol = lTrans ? 1 : lStrides[1];
+    const dim_t rRow = rTrans ? rStrides[1] : 1;
+    const dim_t rCol = rTrans ? 1 : rStrides[1];
+
+    parallelForSlices(oDims, M * N * K, [&](dim_t z, dim_t w) {
+        const T *lptr = lhs.get() + (lDims[2] == 1 ? 0 : z) * lStrides[2] +
+                        (lDims[3] == 1 ? 0 : w) * lStrides[3];
+        const T *rptr = rhs.get() + (rDims[2] == 1 ? 0 : z) * rStrides[2] +
+                        (rDims[3] == 1 ? 0 : w) * rStrides[3];
+        T *optr = out.get() + z * oStrides[2] + w * oStrides[3];
+
+        // op(lhs) is packed once, so the inner loop is contiguous whether
+        // lhs is transposed or not
+        T lpack[GEMM_SMALL_MAX_DIM * GEMM_SMALL_MAX_DIM];
+        for (dim_t k = 0; k < K; k++) {
+            for (dim_t i = 0; i < M; i++) {
+                lpack[k * M + i] =
+                    conjugateIf(lptr[i * lRow + k * lCol], lConj);
+            }
+        }
+
+        switch (M) {
+#define GEMM_SMALL_CASE(ROWS)                                           \
+    case ROWS:                                                          \
+        gemmSmallSlice<T, ROWS>(optr, lpack, rptr, M, N, K, rRow, rCol, \
+                                oStrides[1], rConj, alpha, beta);       \
+        break;
+            GEMM_SMALL_CASE(4)
+            GEMM_SMALL_CASE(8)
+            GEMM_SMALL_CASE(16)
+            GEMM_SMALL_CASE(32)
+#undef GEMM_SMALL_CASE
+            default:
+                gemmSmallSlice<T, 0>(optr, lpack, rptr, M, N, K, rRow, rCol,
+                                     oStrides[1], rConj, alpha, beta);
+                break;
+        }
+    });
+}
+
+}  // namespace kernel
+}  // namespace cpu
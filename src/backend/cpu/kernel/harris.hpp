@@ -9,48 +9,97 @@
 
 #pragma once
 #include <Param.hpp>
+#include <kernel/convolve.hpp>
+#include <parallel_for.hpp>
 #include <utility.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace cpu {
 namespace kernel {
 
-template<typename T>
-void second_order_deriv(Param<T> ixx, Param<T> ixy, Param<T> iyy,
-                        const unsigned in_len, CParam<T> ix, CParam<T> iy) {
-    T* ixx_out     = ixx.get();
-    T* ixy_out     = ixy.get();
-    T* iyy_out     = iyy.get();
-    const T* ix_in = ix.get();
-    const T* iy_in = iy.get();
-    for (unsigned x = 0; x < in_len; x++) {
-        ixx_out[x] = ix_in[x] * ix_in[x];
-        ixy_out[x] = ix_in[x] * iy_in[x];
-        iyy_out[x] = iy_in[x] * iy_in[x];
-    }
-}
+/// Computes the Harris responses of the pixels at least \p border_len away
+/// from the border of the image from its first order derivatives \p ix and
+/// \p iy.
+///
+/// The products of the derivatives of a column are computed and filtered by
+/// the window \p filter along dimension 0 into a LineCache of filter length
+/// columns, from which the responses of the output columns are accumulated.
+/// The products and the filtered products are never written to image sized
+/// arrays. The columns of the responses are split across the thread pool.
+template<typename T, typename convAccT>
+void harris_responses(Param<T> resp, CParam<T> ix, CParam<T> iy,
+                      CParam<convAccT> filter, const float k_thr,
+                      const unsigned border_len) {
+    const dim_t idim0 = ix.dims(0);
+    const dim_t idim1 = ix.dims(1);
+    const dim_t flen  = filter.dims().elements();
+    const dim_t start = flen / 2;
+    const dim_t r     = border_len;
+    if (idim0 <= 2 * r || idim1 <= 2 * r) { return; }
 
-template<typename T>
-void harris_responses(Param<T> resp, const unsigned idim0, const unsigned idim1,
-                      CParam<T> ixx, CParam<T> ixy, CParam<T> iyy,
-                      const float k_thr, const unsigned border_len) {
-    T* resp_out      = resp.get();
-    const T* ixx_in  = ixx.get();
-    const T* ixy_in  = ixy.get();
-    const T* iyy_in  = iyy.get();
-    const unsigned r = border_len;
+    // The rows of the responses, and the length of the three filtered
+    // products of a column
+    const dim_t rows   = idim0 - 2 * r;
+    const dim_t length = 3 * rows;
 
-    for (unsigned x = r; x < idim1 - r; x++) {
-        for (unsigned y = r; y < idim0 - r; y++) {
-            const unsigned idx = x * idim0 + y;
+    T* resp_out       = resp.get();
+    const T* ix_in    = ix.get();
+    const T* iy_in    = iy.get();
+    const convAccT* h = filter.get();
 
-            // Calculates matrix trace and determinant
-            T tr  = ixx_in[idx] + iyy_in[idx];
-            T det = ixx_in[idx] * iyy_in[idx] - ixy_in[idx] * ixy_in[idx];
+    parallelFor(idim1 - 2 * r, length * flen * 2, [&](dim_t first, dim_t last) {
+        LineCache<convAccT> cache(flen, length);
+        std::vector<convAccT> acc(length);
 
-            // Calculates local Harris response
-            resp_out[idx] = det - k_thr * (tr * tr);
+        // Filters the products of the derivatives of column c along
+        // dimension 0. Output row y reads the rows y + start - f.
+        auto filterColumn = [&](dim_t c, convAccT* dst) {
+            convAccT* xx = dst;
+            convAccT* xy = dst + rows;
+            convAccT* yy = dst + 2 * rows;
+            std::fill(dst, dst + length, scalar<convAccT>(0));
+            for (dim_t f = 0; f < flen; ++f) {
+                const T* dx = ix_in + c * idim0 + r + start - f;
+                const T* dy = iy_in + c * idim0 + r + start - f;
+                for (dim_t y = 0; y < rows; ++y) {
+                    xx[y] += convAccT(dx[y] * dx[y]) * h[f];
+                    xy[y] += convAccT(dx[y] * dy[y]) * h[f];
+                    yy[y] += convAccT(dy[y] * dy[y]) * h[f];
+                }
+            }
+            // Rounded like the intermediate image of convolve2
+            for (dim_t y = 0; y < length; ++y) {
+                dst[y] = convAccT(T(dst[y]));
+            }
+        };
+
+        for (dim_t unit = first; unit < last; ++unit) {
+            const dim_t x = unit + r;
+            std::fill(acc.begin(), acc.end(), scalar<convAccT>(0));
+            for (dim_t f = 0; f < flen; ++f) {
+                const dim_t c = x + start - f;
+                const convAccT* col = cache.get(
+                    c % flen, c, [&](convAccT* dst) { filterColumn(c, dst); });
+                axpyLine(acc.data(), col, h[f], length);
+            }
+
+            T* out = resp_out + x * idim0 + r;
+            for (dim_t y = 0; y < rows; ++y) {
+                const T ixx = T(acc[y]);
+                const T ixy = T(acc[rows + y]);
+                const T iyy = T(acc[2 * rows + y]);
+
+                // Calculates matrix trace and determinant
+                T tr  = ixx + iyy;
+                T det = ixx * iyy - ixy * ixy;
+
+                // Calculates local Harris response
+                out[y] = det - k_thr * (tr * tr);
+            }
         }
-    }
+    });
 }
 
 template<typename T>
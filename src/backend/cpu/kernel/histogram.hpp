@@ -9,11 +9,44 @@
 
 #pragma once
 #include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <platform.hpp>
+#include <thread_pool.hpp>
 #include <types.hpp>
 
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
 namespace cpu {
 namespace kernel {
 
+/// The number of elements whose bins are computed before the histogram is
+/// updated
+constexpr int HIST_BLOCK_ELEMENTS = 256;
+
+/// The minimum number of elements a thread bins into its own histogram
+constexpr dim_t HIST_MIN_TASK_ELEMENTS = 1 << 16;
+
+template<typename T>
+void histogramRow(uint* hist, const T* in, const dim_t len,
+                  const unsigned nbins, const compute_t<T> minValT,
+                  const float step) {
+    int bins[HIST_BLOCK_ELEMENTS];
+    const int maxBin = static_cast<int>(nbins - 1);
+    for (dim_t b = 0; b < len; b += HIST_BLOCK_ELEMENTS) {
+        const int blockLen = static_cast<int>(
+            std::min<dim_t>(HIST_BLOCK_ELEMENTS, len - b));
+        // The bins are computed separately from the updates of the histogram
+        // so this loop can be vectorized
+        for (int i = 0; i < blockLen; i++) {
+            int bin = (int)((compute_t<T>(in[b + i]) - minValT) / step);
+            bins[i] = std::min(std::max(bin, 0), maxBin);
+        }
+        for (int i = 0; i < blockLen; i++) { hist[bins[i]]++; }
+    }
+}
+
 template<typename T, bool IsLinear>
 void histogram(Param<uint> out, CParam<T> in, const unsigned nbins,
                const double minval, const double maxval) {
@@ -23,21 +56,50 @@ void histogram(Param<uint> out, CParam<T> in, const unsigned nbins,
     dim4 const iStrides = in.strides();
     dim4 const oStrides = out.strides();
     dim_t const nElems  = inDims[0] * inDims[1];
+    dim_t const rowLen  = IsLinear ? nElems : inDims[0];
 
     auto minValT = compute_t<T>(minval);
+
+    // Large images are split across the thread pool. Every thread updates
+    // its own histogram which are added to the output at the end.
+    thread_pool& pool = getThreadPool();
+    const int ntasks  = static_cast<int>(std::max<dim_t>(
+        1, std::min<dim_t>(pool.size(), nElems / HIST_MIN_TASK_ELEMENTS)));
+    std::vector<uint> taskHists(ntasks > 1 ? ntasks * nbins : 0);
+
+    auto binElements = [&](uint* hist, const T* inData, dim_t begin,
+                           dim_t end) {
+        while (begin < end) {
+            dim_t y   = begin / rowLen;
+            dim_t x   = begin - y * rowLen;
+            dim_t len = std::min(rowLen - x, end - begin);
+            histogramRow(hist, inData + y * iStrides[1] + x, len, nbins,
+                         minValT, step);
+            begin += len;
+        }
+    };
+
     for (dim_t b3 = 0; b3 < outDims[3]; b3++) {
         uint* outData   = out.get() + b3 * oStrides[3];
         const T* inData = in.get() + b3 * iStrides[3];
         for (dim_t b2 = 0; b2 < outDims[2]; b2++) {
-            for (dim_t i = 0; i < nElems; i++) {
-                int idx =
-                    IsLinear
-                        ? i
-                        : ((i % inDims[0]) + (i / inDims[0]) * iStrides[1]);
-                int bin = (int)((compute_t<T>(inData[idx]) - minValT) / step);
-                bin     = std::max(bin, 0);
-                bin     = std::min(bin, (int)(nbins - 1));
-                outData[bin]++;
+            if (ntasks == 1) {
+                binElements(outData, inData, 0, nElems);
+            } else {
+                std::fill(taskHists.begin(), taskHists.end(), 0);
+                const dim_t taskElems = divup(nElems, ntasks);
+                pool.run(ntasks, [&](int task) {
+                    dim_t begin = task * taskElems;
+                    dim_t end   = std::min(begin + taskElems, nElems);
+                    binElements(taskHists.data() + task * nbins, inData,
+                                begin, end);
+                });
+                for (int t = 0; t < ntasks; t++) {
+                    const uint* hist = taskHists.data() + t * nbins;
+                    for (unsigned bin = 0; bin < nbins; bin++) {
+                        outData[bin] += hist[bin];
+                    }
+                }
             }
             inData += iStrides[2];
             outData += oStrides[2];
@@ -45,5 +107,101 @@ void histogram(Param<uint> out, CParam<T> in, const unsigned nbins,
     }
 }
 
+
+/// Adds the pairs of values of \p x and \p y of the slice to \p out, which
+/// holds the xbins x ybins joint histogram of the slice. The pairs are
+/// counted when To is uint and their \p weights are summed when To is float.
+/// The large slices are split across the thread pool like the ones of
+/// histogram.
+template<typename T, typename To>
+void histogram2(Param<To> out, CParam<T> x, CParam<T> y, CParam<float> weights,
+                const unsigned xbins, const unsigned ybins, const double xmin,
+                const double xmax, const double ymin, const double ymax) {
+    constexpr bool weighted = std::is_same<To, float>::value;
+
+    dim4 const outDims   = out.dims();
+    dim4 const dims      = x.dims();
+    dim4 const oStrides  = out.strides();
+    dim4 const xStrides  = x.strides();
+    dim4 const yStrides  = y.strides();
+    dim4 const wStrides  = weights.strides();
+    dim_t const nElems   = dims[0] * dims[1];
+    unsigned const nbins = xbins * ybins;
+
+    float const xminf = static_cast<float>(xmin);
+    float const yminf = static_cast<float>(ymin);
+    float const xstep = (xmax - xmin) / (float)xbins;
+    float const ystep = (ymax - ymin) / (float)ybins;
+    int const maxXBin = static_cast<int>(xbins - 1);
+    int const maxYBin = static_cast<int>(ybins - 1);
+
+    thread_pool& pool = getThreadPool();
+    const int ntasks  = static_cast<int>(std::max<dim_t>(
+        1, std::min<dim_t>(pool.size(), nElems / HIST_MIN_TASK_ELEMENTS)));
+    std::vector<To> taskHists(ntasks > 1 ? ntasks * nbins : 0);
+
+    auto binElements = [&](To* hist, const T* xData, const T* yData,
+                           const float* wData, dim_t begin, dim_t end) {
+        int bins[HIST_BLOCK_ELEMENTS];
+        while (begin < end) {
+            dim_t i1 = begin / dims[0];
+            dim_t i0 = begin - i1 * dims[0];
+            int len  = static_cast<int>(std::min<dim_t>(
+                std::min<dim_t>(dims[0] - i0, end - begin),
+                HIST_BLOCK_ELEMENTS));
+
+            // The bins are computed separately from the updates of the
+            // histogram so this loop can be vectorized
+            const T* xRow = xData + i1 * xStrides[1] + i0;
+            const T* yRow = yData + i1 * yStrides[1] + i0;
+            for (int i = 0; i < len; i++) {
+                int xb  = (int)((static_cast<float>(xRow[i]) - xminf) / xstep);
+                int yb  = (int)((static_cast<float>(yRow[i]) - yminf) / ystep);
+                xb      = std::min(std::max(xb, 0), maxXBin);
+                yb      = std::min(std::max(yb, 0), maxYBin);
+                bins[i] = xb + yb * static_cast<int>(xbins);
+            }
+            if (weighted) {
+                const float* wRow = wData + i1 * wStrides[1] + i0;
+                for (int i = 0; i < len; i++) {
+                    hist[bins[i]] += static_cast<To>(wRow[i]);
+                }
+            } else {
+                for (int i = 0; i < len; i++) { hist[bins[i]]++; }
+            }
+            begin += len;
+        }
+    };
+
+    for (dim_t b3 = 0; b3 < outDims[3]; b3++) {
+        for (dim_t b2 = 0; b2 < outDims[2]; b2++) {
+            const T* xData = x.get() + b2 * xStrides[2] + b3 * xStrides[3];
+            const T* yData = y.get() + b2 * yStrides[2] + b3 * yStrides[3];
+            const float* wData =
+                weighted ? weights.get() + b2 * wStrides[2] + b3 * wStrides[3]
+                         : nullptr;
+            To* outData = out.get() + b2 * oStrides[2] + b3 * oStrides[3];
+            if (ntasks == 1) {
+                binElements(outData, xData, yData, wData, 0, nElems);
+                continue;
+            }
+            std::fill(taskHists.begin(), taskHists.end(), To(0));
+            const dim_t taskElems = divup(nElems, ntasks);
+            pool.run(ntasks, [&](int task) {
+                dim_t begin = task * taskElems;
+                dim_t end   = std::min(begin + taskElems, nElems);
+                binElements(taskHists.data() + task * nbins, xData, yData,
+                            wData, begin, end);
+            });
+            for (int t = 0; t < ntasks; t++) {
+                const To* hist = taskHists.data() + t * nbins;
+                for (unsigned bin = 0; bin < nbins; bin++) {
+                    outData[bin] += hist[bin];
+                }
+            }
+        }
+    }
+}
+
 }  // namespace kernel
 }  // namespace cpu
@@ -0,0 +1,48 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+
+#include <vector>
+
+namespace cpu {
+namespace kernel {
+
+/// Writes the vertices of \p components to \p out, with the components of a
+/// vertex next to each other. The component c of the vertex i is the element
+/// i of components[c], read with its dims and strides.
+template<typename T>
+void interleave(T *out, const std::vector<CParam<T>> &components) {
+    const size_t count = components.size();
+    for (size_t c = 0; c < count; ++c) {
+        const CParam<T> &in = components[c];
+        const af::dim4 dims = in.dims();
+        const af::dim4 strs = in.strides();
+        const T *const iptr = in.get();
+        T *optr             = out + c;
+
+        for (dim_t w = 0; w < dims[3]; ++w) {
+            for (dim_t z = 0; z < dims[2]; ++z) {
+                for (dim_t y = 0; y < dims[1]; ++y) {
+                    const T *row =
+                        iptr + w * strs[3] + z * strs[2] + y * strs[1];
+                    for (dim_t x = 0; x < dims[0]; ++x) {
+                        *optr = row[x * strs[0]];
+                        optr += count;
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // namespace kernel
+}  // namespace cpu
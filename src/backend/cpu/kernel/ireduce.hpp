@@ -10,7 +10,10 @@
 #pragma once
 #include <Param.hpp>
 #include <common/Binary.hpp>
+#include <kernel/lines.hpp>
+
 #include <algorithm>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
@@ -61,46 +64,146 @@ struct MinMaxOp<af_max_t, T> {
     }
 };
 
-template<af_op_t op, typename T, int D>
-struct ireduce_dim {
-    void operator()(Param<T> output, Param<uint> locParam,
-                    const dim_t outOffset, CParam<T> input,
-                    const dim_t inOffset, const int dim, CParam<uint> rlen) {
-        const af::dim4 odims    = output.dims();
-        const af::dim4 ostrides = output.strides();
-        const af::dim4 istrides = input.strides();
-        const int D1            = D - 1;
-        for (dim_t i = 0; i < odims[D1]; i++) {
-            ireduce_dim<op, T, D1>()(output, locParam,
-                                     outOffset + i * ostrides[D1], input,
-                                     inOffset + i * istrides[D1], dim, rlen);
+/// The value and index selected from a part of a line or an array
+template<typename T>
+struct IreducePartial {
+    T val;
+    uint idx;
+    /// False if the part has no selected value (see selectValues)
+    bool valid;
+};
+
+/// Selects a value of ptr[first], ..., ptr[last - 1], whose indices are
+/// index(first), ..., index(last - 1). The selection starts from the first
+/// value like a whole line, so a part which does not \p start the line and
+/// only starts with a NaN is not valid, because the initial value of the
+/// selection is not one of its values.
+template<af_op_t op, typename T, typename F>
+IreducePartial<T> selectValues(const T *ptr, const dim_t stride,
+                               const dim_t first, const dim_t last,
+                               const bool start, F index) {
+    if (first >= last && !start) { return {T(), 0, false}; }
+    const uint firstIdx = static_cast<uint>(index(first));
+    MinMaxOp<op, T> Op(ptr[first * stride], firstIdx);
+    for (dim_t i = first; i < last; i++) {
+        Op(ptr[i * stride], static_cast<uint>(index(i)));
+    }
+    const bool valid =
+        start || !(is_nan(ptr[first * stride]) && Op.m_idx == firstIdx);
+    return {Op.m_val, Op.m_idx, valid};
+}
+
+/// Merges the partial result \p part of a later part of a line into
+/// \p result
+template<af_op_t op, typename T>
+void mergePartial(IreducePartial<T> &result, const IreducePartial<T> &part) {
+    if (!part.valid) { return; }
+    if (!result.valid) {
+        result = part;
+        return;
+    }
+    MinMaxOp<op, T> Op(result.val, result.idx);
+    Op(part.val, part.idx);
+    result = {Op.m_val, Op.m_idx, true};
+}
+
+/// Selects the minimum or maximum along dimension \p dim of \p input and its
+/// index. When \p rlen is not empty, only the first rlen values of each line
+/// are compared.
+///
+/// Each line is split into blocks of LINE_BLOCK_ELEMENTS values. The values
+/// are compared with the same ordering in any order, so the blocks are
+/// searched by the thread pool and their results merged for each line.
+template<af_op_t op, typename T>
+void ireduce(Param<T> output, Param<uint> locParam, CParam<T> input,
+             const int dim, CParam<uint> rlen) {
+    const af::dim4 idims    = input.dims();
+    const af::dim4 istrides = input.strides();
+    const af::dim4 ostrides = output.strides();
+    const af::dim4 lstrides = locParam.strides();
+
+    const dim_t n      = idims[dim];
+    const dim_t stride = istrides[dim];
+    const dim_t nlines = lineCount(idims, dim);
+    const dim_t blocks = std::max<dim_t>(1, divup(n, LINE_BLOCK_ELEMENTS));
+    if (nlines == 0) { return; }
+
+    auto limit = [&](dim_t line) {
+        const uint *rlenptr = rlen.get();
+        if (!rlenptr) { return n; }
+        const dim_t len = rlenptr[lineOffset(idims, dim, line, ostrides)];
+        return std::min(n, len);
+    };
+    auto position = [](dim_t i) { return i; };
+
+    std::vector<IreducePartial<T>> partials(nlines * blocks);
+    parallelFor(nlines * blocks, std::min(n, LINE_BLOCK_ELEMENTS),
+                [&](dim_t first, dim_t last) {
+                    for (dim_t unit = first; unit < last; ++unit) {
+                        const dim_t line = unit / blocks;
+                        const dim_t begin =
+                            (unit % blocks) * LINE_BLOCK_ELEMENTS;
+                        const dim_t end =
+                            std::min(begin + LINE_BLOCK_ELEMENTS, limit(line));
+                        const T *ptr =
+                            input.get() +
+                            lineOffset(idims, dim, line, istrides);
+                        partials[unit] = selectValues<op>(
+                            ptr, stride, begin, end, begin == 0, position);
+                    }
+                });
+
+    for (dim_t line = 0; line < nlines; ++line) {
+        IreducePartial<T> result = partials[line * blocks];
+        for (dim_t b = 1; b < blocks; ++b) {
+            mergePartial<op>(result, partials[line * blocks + b]);
         }
+        output.get()[lineOffset(idims, dim, line, ostrides)] = result.val;
+        locParam.get()[lineOffset(idims, dim, line, lstrides)] = result.idx;
     }
-};
+}
 
+/// Selects the minimum or maximum of all the values of \p input and its
+/// offset. The elements are split into blocks like a single line.
 template<af_op_t op, typename T>
-struct ireduce_dim<op, T, 0> {
-    void operator()(Param<T> output, Param<uint> locParam,
-                    const dim_t outOffset, CParam<T> input,
-                    const dim_t inOffset, const int dim, CParam<uint> rlen) {
-        const af::dim4 idims    = input.dims();
-        const af::dim4 istrides = input.strides();
-
-        T const *const in   = input.get();
-        T *out              = output.get();
-        uint *loc           = locParam.get();
-        const uint *rlenptr = (rlen.get()) ? rlen.get() + outOffset : nullptr;
-
-        dim_t stride = istrides[dim];
-        MinMaxOp<op, T> Op(in[inOffset], 0);
-        int lim =
-            (rlenptr) ? std::min(idims[dim], (dim_t)*rlenptr) : idims[dim];
-        for (dim_t i = 0; i < lim; i++) { Op(in[inOffset + i * stride], i); }
-
-        out[outOffset] = Op.m_val;
-        loc[outOffset] = Op.m_idx;
+void ireduce_all(T *out, uint *loc, CParam<T> input) {
+    const af::dim4 dims    = input.dims();
+    const af::dim4 strides = input.strides();
+    const dim_t elements   = dims.elements();
+    const dim_t blocks     = divup(elements, LINE_BLOCK_ELEMENTS);
+    if (elements == 0) { return; }
+
+    std::vector<IreducePartial<T>> partials(blocks);
+    parallelFor(blocks, LINE_BLOCK_ELEMENTS, [&](dim_t first, dim_t last) {
+        for (dim_t b = first; b < last; ++b) {
+            dim_t e         = b * LINE_BLOCK_ELEMENTS;
+            const dim_t end = std::min(e + LINE_BLOCK_ELEMENTS, elements);
+            // The block is made of segments of the lines along dim 0, and
+            // the index of each value is its offset
+            bool start = b == 0;
+            IreducePartial<T> result{T(), 0, false};
+            while (e < end) {
+                const dim_t i    = e % dims[0];
+                const dim_t len  = std::min(dims[0] - i, end - e);
+                const dim_t base = lineOffset(dims, 0, e / dims[0], strides);
+                const IreducePartial<T> segment = selectValues<op>(
+                    input.get() + base, 1, i, i + len, start,
+                    [base](dim_t j) { return base + j; });
+                mergePartial<op>(result, segment);
+                start = false;
+                e += len;
+            }
+            partials[b] = result;
+        }
+    });
+
+    IreducePartial<T> result = partials[0];
+    for (dim_t b = 1; b < blocks; ++b) {
+        mergePartial<op>(result, partials[b]);
     }
-};
+    *out = result.val;
+    *loc = result.idx;
+}
 
 }  // namespace kernel
 }  // namespace cpu
@@ -0,0 +1,44 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <parallel_for.hpp>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+
+namespace cpu {
+namespace kernel {
+
+/// The number of elements of a line processed together. Long lines are
+/// split across the thread pool at multiples of LINE_BLOCK_ELEMENTS, and the
+/// blocks are combined in the same way on one thread, so the results never
+/// depend on the number of threads.
+constexpr dim_t LINE_BLOCK_ELEMENTS = 1 << 14;
+
+/// Returns the number of lines of \p dims along dimension \p dim
+inline dim_t lineCount(const af::dim4 &dims, const int dim) {
+    return dims.elements() / std::max<dim_t>(dims[dim], 1);
+}
+
+/// Returns the offset of the first element of line \p line of \p dims along
+/// dimension \p dim. The lines are ordered by the other dimensions.
+inline dim_t lineOffset(const af::dim4 &dims, const int dim, dim_t line,
+                        const af::dim4 &strides) {
+    dim_t offset = 0;
+    for (int d = 0; d < 4; ++d) {
+        if (d == dim) { continue; }
+        offset += (line % dims[d]) * strides[d];
+        line /= dims[d];
+    }
+    return offset;
+}
+
+}  // namespace kernel
+}  // namespace cpu
@@ -0,0 +1,106 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <platform.hpp>
+#include <thread_pool.hpp>
+#include <af/defines.h>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+
+namespace cpu {
+namespace kernel {
+
+/// The smallest number of elements reduced by one task of the thread pool
+constexpr dim_t MEANVAR_MIN_TASK_ELEMENTS = 1 << 16;
+
+/// The running weight, mean and sum of the weighted squared differences from
+/// the mean of a sequence of values (Welford's algorithm, extended to
+/// weights by West)
+template<typename T>
+struct Welford {
+    T weight = 0;
+    T mean   = 0;
+    T m2     = 0;
+
+    void operator()(const T value, const T w) {
+        if (w == T(0)) { return; }
+        weight += w;
+        const T delta = value - mean;
+        mean += delta * (w / weight);
+        m2 += w * delta * (value - mean);
+    }
+};
+
+/// Computes the mean and the variance of each line of \p in along \p dim in
+/// one pass. The values are weighted by \p weights when it is not empty.
+template<typename Ti, typename To>
+void meanvar(Param<To> mean, Param<To> var, CParam<Ti> in, CParam<To> weights,
+             const af_var_bias bias, const int dim) {
+    const af::dim4 idims    = in.dims();
+    const af::dim4 istrides = in.strides();
+    const af::dim4 wstrides = weights.strides();
+    const af::dim4 mstrides = mean.strides();
+    const af::dim4 vstrides = var.strides();
+    const bool isWeighted   = weights.dims().elements() != 0;
+
+    const dim_t n      = idims[dim];
+    const dim_t nlines = idims.elements() / n;
+    const To correction(bias == AF_VARIANCE_SAMPLE ? 1 : 0);
+
+    int lineDims[3];
+    for (int d = 0, i = 0; d < 4; ++d) {
+        if (d != dim) { lineDims[i++] = d; }
+    }
+
+    auto lineOffset = [&](dim_t line, const af::dim4 &strides) {
+        dim_t offset = 0;
+        for (int d : lineDims) {
+            offset += (line % idims[d]) * strides[d];
+            line /= idims[d];
+        }
+        return offset;
+    };
+
+    thread_pool &pool  = getThreadPool();
+    const dim_t ntasks = std::max<dim_t>(
+        1, std::min({static_cast<dim_t>(pool.size()), nlines,
+                     nlines * n / MEANVAR_MIN_TASK_ELEMENTS}));
+    const dim_t linesPerTask = divup(nlines, ntasks);
+
+    pool.run(static_cast<int>(ntasks), [&](int task) {
+        const dim_t first = task * linesPerTask;
+        const dim_t last  = std::min(first + linesPerTask, nlines);
+        for (dim_t line = first; line < last; ++line) {
+            const Ti *iptr = in.get() + lineOffset(line, istrides);
+            Welford<To> acc;
+            if (isWeighted) {
+                const To *wptr = weights.get() + lineOffset(line, wstrides);
+                for (dim_t i = 0; i < n; ++i) {
+                    acc(To(iptr[i * istrides[dim]]), wptr[i * wstrides[dim]]);
+                }
+            } else {
+                for (dim_t i = 0; i < n; ++i) {
+                    acc(To(iptr[i * istrides[dim]]), To(1));
+                }
+            }
+
+            mean.get()[lineOffset(line, mstrides)] = acc.mean;
+            var.get()[lineOffset(line, vstrides)] =
+                acc.m2 / (acc.weight - correction);
+        }
+    });
+}
+
+}  // namespace kernel
+}  // namespace cpu
@@ -10,194 +10,280 @@
 #pragma once
 
 #include <Param.hpp>
+#include <parallel_for.hpp>
+#include <types.hpp>
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <vector>
 
 namespace cpu {
 namespace kernel {
 
-template<typename T, af::borderType Pad>
-void medfilt1(Param<T> out, CParam<T> in, dim_t w_wid) {
+/// Returns the index of the element which pads position \p i of a dimension
+/// of length \p len, or -1 if the position is padded with zero
+template<af::borderType Pad>
+int padIndex(int i, int len) {
     constexpr bool IsValidPadType = (Pad == AF_PAD_ZERO || Pad == AF_PAD_SYM);
+    static_assert(IsValidPadType, "Unsupported padding type");
 
-    const af::dim4 dims     = in.dims();
-    const af::dim4 istrides = in.strides();
-    const af::dim4 ostrides = out.strides();
+    if (Pad == AF_PAD_ZERO) { return (i < 0 || i >= len) ? -1 : i; }
+    if (i < 0) { i = -i; }
+    if (i >= len) { i = 2 * (len - 1) - i; }
+    // Windows larger than the dimension reflect past the other edge
+    return std::min(std::max(i, 0), len - 1);
+}
 
-    std::vector<T> wind_vals;
-    wind_vals.reserve(w_wid);
-
-    for (int b3 = 0; b3 < (int)dims[3]; b3++) {
-        T const* in_ptr = in.get() + b3 * istrides[3];
-        T* out_ptr      = out.get() + b3 * ostrides[3];
-
-        for (int b2 = 0; b2 < (int)dims[2]; b2++) {
-            for (int col = 0; col < (int)dims[1]; col++) {
-                int ocol_off = col * ostrides[1];
-
-                for (int row = 0; row < (int)dims[0]; row++) {
-                    wind_vals.clear();
-                    for (int wi = 0; wi < (int)w_wid; ++wi) {
-                        int im_row = row + wi - w_wid / 2;
-                        int im_roff;
-                        switch (Pad) {
-                            case AF_PAD_ZERO:
-                                im_roff = im_row * istrides[0];
-                                if (im_row < 0 || im_row >= (int)dims[0])
-                                    wind_vals.push_back(0);
-                                else
-                                    wind_vals.push_back(in_ptr[im_roff]);
-                                break;
-                            case AF_PAD_SYM: {
-                                if (im_row < 0) { im_row *= -1; }
-
-                                if (im_row >= (int)dims[0]) {
-                                    im_row = 2 * ((int)dims[0] - 1) - im_row;
-                                }
-
-                                im_roff = im_row * istrides[0];
-                                wind_vals.push_back(in_ptr[im_roff]);
-                            } break;
-                            default:
-                                static_assert(IsValidPadType,
-                                              "Unsupported padding type");
-                                break;
-                        }
-                    }
-
-                    int off = wind_vals.size() / 2;
-                    std::stable_sort(wind_vals.begin(), wind_vals.end());
-                    if (wind_vals.size() % 2 == 0)
-                        out_ptr[ocol_off + row * ostrides[0]] =
-                            (wind_vals[off] + wind_vals[off - 1]) / 2;
-                    else {
-                        out_ptr[ocol_off + row * ostrides[0]] = wind_vals[off];
-                    }
-                }
+template<typename T>
+bool windowLess(T a, T b) {
+    return a < b;
+}
+
+// NaNs are ordered after the other values so they can be removed from the
+// sorted window
+inline bool windowLess(float a, float b) {
+    return a < b || (!std::isnan(a) && std::isnan(b));
+}
+
+inline bool windowLess(double a, double b) {
+    return a < b || (!std::isnan(a) && std::isnan(b));
+}
+
+/// The values of the median filter window kept in sorted order.
+///
+/// The values added to and removed from the window while it slides by one
+/// element are sorted and merged with the window in a single pass.
+template<typename T>
+class SortedWindow {
+    std::vector<T> m_values;
+    std::vector<T> m_merged;
+    std::vector<T> m_added;
+    std::vector<T> m_removed;
+    size_t m_count = 0;
+
+    static bool less(T a, T b) { return windowLess(a, b); }
+
+    void update() {
+        std::sort(m_added.begin(), m_added.end(), less);
+        std::sort(m_removed.begin(), m_removed.end(), less);
+
+        const T *value      = m_values.data();
+        const T *const vend = value + m_count;
+        const T *added      = m_added.data();
+        const T *const aend = added + m_added.size();
+        const T *removed    = m_removed.data();
+        const T *const rend = removed + m_removed.size();
+        T *merged           = m_merged.data();
+        for (; value != vend; ++value) {
+            while (added != aend && less(*added, *value)) {
+                *merged++ = *added++;
+            }
+            // The removed values are in the window, so the next removed
+            // value is never less than the current value
+            if (removed != rend && !less(*value, *removed)) {
+                ++removed;
+            } else {
+                *merged++ = *value;
             }
-            in_ptr += istrides[2];
-            out_ptr += ostrides[2];
         }
+        while (added != aend) { *merged++ = *added++; }
+
+        m_count = static_cast<size_t>(merged - m_merged.data());
+        std::swap(m_values, m_merged);
+        m_added.clear();
+        m_removed.clear();
     }
-}
 
-template<typename T, af::borderType Pad>
-void medfilt2(Param<T> out, CParam<T> in, dim_t w_len, dim_t w_wid) {
-    constexpr bool IsValidPadType = (Pad == AF_PAD_ZERO || Pad == AF_PAD_SYM);
+   public:
+    explicit SortedWindow(size_t size) : m_values(size), m_merged(size) {
+        m_added.reserve(size);
+        m_removed.reserve(size);
+    }
+
+    void add(T value) { m_added.push_back(value); }
+
+    /// Removes a value which was added before the last call to median
+    void remove(T value) { m_removed.push_back(value); }
+
+    T median() {
+        if (!m_added.empty() || !m_removed.empty()) { update(); }
+        const size_t off = m_count / 2;
+        if (m_count % 2 == 0) {
+            return (m_values[off] + m_values[off - 1]) / 2;
+        }
+        return m_values[off];
+    }
+};
+
+/// The values of the median filter window of 8 and 16 bit types kept in a
+/// histogram.
+///
+/// The median is tracked as the window slides (Huang's algorithm) so it only
+/// moves by the bins between the old and the new median.
+template<typename T>
+class HistogramWindow {
+    static constexpr unsigned BINS = 1u << (8 * sizeof(T));
+
+    std::vector<unsigned> m_hist;
+    unsigned m_count = 0;
+    /// The bin of the value of rank m_count / 2
+    unsigned m_bin = 0;
+    /// The number of values in the bins below m_bin
+    unsigned m_below = 0;
+
+    static unsigned bin(T value) {
+        return static_cast<unsigned>(static_cast<int>(value) -
+                                     std::numeric_limits<T>::min());
+    }
+
+    static int value(unsigned bin) {
+        return static_cast<int>(bin) + std::numeric_limits<T>::min();
+    }
+
+   public:
+    explicit HistogramWindow(size_t) : m_hist(BINS, 0) {}
+
+    void add(T value) {
+        const unsigned b = bin(value);
+        m_hist[b]++;
+        m_count++;
+        if (b < m_bin) { m_below++; }
+    }
 
+    void remove(T value) {
+        const unsigned b = bin(value);
+        m_hist[b]--;
+        m_count--;
+        if (b < m_bin) { m_below--; }
+    }
+
+    T median() {
+        const unsigned off = m_count / 2;
+        while (m_below > off) { m_below -= m_hist[--m_bin]; }
+        while (m_below + m_hist[m_bin] <= off) { m_below += m_hist[m_bin++]; }
+
+        const int upper = value(m_bin);
+        if (m_count % 2 != 0) { return static_cast<T>(upper); }
+
+        unsigned lower = m_bin;
+        if (off - 1 < m_below) {
+            do { --lower; } while (m_hist[lower] == 0);
+        }
+        return static_cast<T>((upper + value(lower)) / 2);
+    }
+};
+
+template<typename T>
+struct MedianWindow {
+    using type = SortedWindow<T>;
+};
+
+#define HISTOGRAM_WINDOW(T) \
+    template<>              \
+    struct MedianWindow<T> { using type = HistogramWindow<T>; };
+
+HISTOGRAM_WINDOW(char)
+HISTOGRAM_WINDOW(uchar)
+HISTOGRAM_WINDOW(short)
+HISTOGRAM_WINDOW(ushort)
+
+#undef HISTOGRAM_WINDOW
+
+/// Median filter with a window of w_len elements along the first dimension
+/// and w_wid elements along the second dimension.
+///
+/// The window slides down each column. Moving by one element removes the
+/// top row of the window and adds a new bottom row, so each output costs
+/// O(w_wid) window updates instead of gathering and sorting the window. The
+/// padded input columns under the window are kept in a ring of w_wid
+/// columns so each input column is padded once.
+template<typename T, af::borderType Pad>
+void medianFilter(Param<T> out, CParam<T> in, int w_len, int w_wid) {
     const af::dim4 dims     = in.dims();
     const af::dim4 istrides = in.strides();
     const af::dim4 ostrides = out.strides();
 
-    std::vector<T> wind_vals;
-    wind_vals.reserve(w_len * w_wid);
-
-    for (int b3 = 0; b3 < (int)dims[3]; b3++) {
-        T const* in_ptr = in.get() + b3 * istrides[3];
-        T* out_ptr      = out.get() + b3 * ostrides[3];
-
-        for (int b2 = 0; b2 < (int)dims[2]; b2++) {
-            for (int col = 0; col < (int)dims[1]; col++) {
-                int ocol_off = col * ostrides[1];
-
-                for (int row = 0; row < (int)dims[0]; row++) {
-                    wind_vals.clear();
-
-                    for (int wj = 0; wj < (int)w_wid; ++wj) {
-                        bool isColOff = false;
-
-                        int im_col  = col + wj - w_wid / 2;
-                        int im_coff = 0;
-                        switch (Pad) {
-                            case AF_PAD_ZERO:
-                                im_coff = im_col * istrides[1];
-                                if (im_col < 0 || im_col >= (int)dims[1])
-                                    isColOff = true;
-                                break;
-                            case AF_PAD_SYM: {
-                                if (im_col < 0) {
-                                    im_col *= -1;
-                                    isColOff = true;
-                                }
-
-                                if (im_col >= (int)dims[1]) {
-                                    im_col   = 2 * ((int)dims[1] - 1) - im_col;
-                                    isColOff = true;
-                                }
-
-                                im_coff = im_col * istrides[1];
-                            } break;
-                            default:
-                                static_assert(IsValidPadType,
-                                              "Unsupported padding type");
-                                break;
-                        }
-
-                        for (int wi = 0; wi < (int)w_len; ++wi) {
-                            bool isRowOff = false;
-
-                            int im_row  = row + wi - w_len / 2;
-                            int im_roff = 0;
-                            switch (Pad) {
-                                case AF_PAD_ZERO:
-                                    im_roff = im_row * istrides[0];
-                                    if (im_row < 0 || im_row >= (int)dims[0])
-                                        isRowOff = true;
-                                    break;
-                                case AF_PAD_SYM: {
-                                    if (im_row < 0) {
-                                        im_row *= -1;
-                                        isRowOff = true;
-                                    }
-
-                                    if (im_row >= (int)dims[0]) {
-                                        im_row =
-                                            2 * ((int)dims[0] - 1) - im_row;
-                                        isRowOff = true;
-                                    }
-
-                                    im_roff = im_row * istrides[0];
-                                } break;
-                                default:
-                                    static_assert(IsValidPadType,
-                                                  "Unsupported padding type");
-                                    break;
-                            }
-
-                            if (isRowOff || isColOff) {
-                                switch (Pad) {
-                                    case AF_PAD_ZERO:
-                                        wind_vals.push_back(0);
-                                        break;
-                                    case AF_PAD_SYM:
-                                        wind_vals.push_back(
-                                            in_ptr[im_coff + im_roff]);
-                                        break;
-                                    default:
-                                        static_assert(
-                                            IsValidPadType,
-                                            "Unsupported padding type");
-                                        break;
-                                }
-                            } else
-                                wind_vals.push_back(in_ptr[im_coff + im_roff]);
-                        }
-                    }
-
-                    std::stable_sort(wind_vals.begin(), wind_vals.end());
-                    int off = wind_vals.size() / 2;
-                    if (wind_vals.size() % 2 == 0)
-                        out_ptr[ocol_off + row * ostrides[0]] =
-                            (wind_vals[off] + wind_vals[off - 1]) / 2;
-                    else
-                        out_ptr[ocol_off + row * ostrides[0]] = wind_vals[off];
+    const int rows       = static_cast<int>(dims[0]);
+    const int cols       = static_cast<int>(dims[1]);
+    const int paddedRows = rows + w_len - 1;
+
+    std::vector<int> rowIndex(paddedRows);
+    for (int p = 0; p < paddedRows; ++p) {
+        rowIndex[p] = padIndex<Pad>(p - w_len / 2, rows);
+    }
+
+    // The columns of all the slices are split across the thread pool. Each
+    // task pads the columns under the window of its first column of a slice
+    // again.
+    const dim_t units      = cols * dims[2] * dims[3];
+    const dim_t windowSize = static_cast<dim_t>(w_len) * w_wid;
+    parallelFor(units, rows * w_wid, [&](dim_t first, dim_t last) {
+        std::vector<T> band(static_cast<size_t>(paddedRows) * w_wid);
+        typename MedianWindow<T>::type window(windowSize);
+
+        for (dim_t unit = first; unit < last; unit++) {
+            const int col  = static_cast<int>(unit % cols);
+            const dim_t b2 = (unit / cols) % dims[2];
+            const dim_t b3 = unit / (cols * dims[2]);
+
+            const T *in_ptr = in.get() + b2 * istrides[2] + b3 * istrides[3];
+            T *out_ptr = out.get() + b2 * ostrides[2] + b3 * ostrides[3];
+
+            // Pads the input column under padded column pc of the window
+            auto loadColumn = [&](int pc) {
+                T *dst            = band.data() + (pc % w_wid) * paddedRows;
+                const int src_col = padIndex<Pad>(pc - w_wid / 2, cols);
+                const T *src      = in_ptr + std::max(src_col, 0) * istrides[1];
+                for (int p = 0; p < paddedRows; ++p) {
+                    dst[p] = (src_col < 0 || rowIndex[p] < 0)
+                                 ? T(0)
+                                 : src[rowIndex[p] * istrides[0]];
+                }
+            };
+            if (unit == first || col == 0) {
+                for (int pc = col; pc < col + w_wid - 1; ++pc) {
+                    loadColumn(pc);
+                }
+            }
+            loadColumn(col + w_wid - 1);
+            T *ocol = out_ptr + col * ostrides[1];
+
+            for (int s = 0; s < w_wid; ++s) {
+                const T *column = band.data() + s * paddedRows;
+                for (int p = 0; p < w_len; ++p) { window.add(column[p]); }
+            }
+            ocol[0] = window.median();
+
+            for (int row = 1; row < rows; row++) {
+                for (int s = 0; s < w_wid; ++s) {
+                    const T *column = band.data() + s * paddedRows;
+                    window.remove(column[row - 1]);
+                    window.add(column[row + w_len - 1]);
+                }
+                ocol[row * ostrides[0]] = window.median();
+            }
+
+            // Empty the window for the next column
+            for (int s = 0; s < w_wid; ++s) {
+                const T *column = band.data() + s * paddedRows;
+                for (int p = rows - 1; p < paddedRows; ++p) {
+                    window.remove(column[p]);
                 }
             }
-            in_ptr += istrides[2];
-            out_ptr += ostrides[2];
         }
-    }
+    });
+}
+
+template<typename T, af::borderType Pad>
+void medfilt1(Param<T> out, CParam<T> in, dim_t w_wid) {
+    medianFilter<T, Pad>(out, in, static_cast<int>(w_wid), 1);
+}
+
+template<typename T, af::borderType Pad>
+void medfilt2(Param<T> out, CParam<T> in, dim_t w_len, dim_t w_wid) {
+    medianFilter<T, Pad>(out, in, static_cast<int>(w_len),
+                         static_cast<int>(w_wid));
 }
 
 }  // namespace kernel
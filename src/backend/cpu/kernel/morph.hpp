@@ -11,7 +11,11 @@
 #include <Param.hpp>
 #include <common/Binary.hpp>
 #include <utility.hpp>
+
+#include <algorithm>
 #include <limits>
+#include <utility>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
@@ -42,35 +46,242 @@ struct MorphFilterOp {
     }
 };
 
+/// The number of adjacent lines along the first dimension filtered together
+/// by the passes along the other dimensions
+constexpr dim_t MORPH_LINE_LANES = 256;
+
+/// Returns true if every element of the mask is set. Dilation and erosion
+/// with such a mask are separable into one pass along each dimension.
+template<typename T>
+bool isFlatMask(CParam<T> mask) {
+    const af::dim4 mdims    = mask.dims();
+    const af::dim4 fstrides = mask.strides();
+    const T* filter         = mask.get();
+    for (dim_t k = 0; k < mdims[2]; ++k) {
+        for (dim_t j = 0; j < mdims[1]; ++j) {
+            for (dim_t i = 0; i < mdims[0]; ++i) {
+                if (!(filter[getIdx(fstrides, i, j, k)] > (T)0)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/// Computes the extreme of each window of \p w elements of \p lanes lines
+/// with the van Herk/Gil-Werman algorithm.
+///
+/// Element x of a line is the extreme of elements [x, x + w - 1] of the
+/// source line, which holds n + w - 1 elements. The source is split into
+/// blocks of w elements. Every window spans the end of one block and the
+/// start of the next, so it is the combination of a suffix extreme and a
+/// prefix extreme. This costs three comparisons per element for any w.
+///
+/// \param[out] dst     The first element of the first line of the result
+/// \param[in] dstep    The distance between the elements of a line of dst
+/// \param[in] dlane    The distance between the lines of dst
+/// \param[in] src      The first element of the first line of the source
+/// \param[in] sstep    The distance between the elements of a line of src
+/// \param[in] slane    The distance between the lines of src
+/// \param[in] n        The number of elements of each line of the result
+/// \param[in] w        The length of the window
+/// \param[in] lanes    The number of lines
+/// \param[in] prefix   Scratch memory of (n + w - 1) * lanes elements
+/// \param[in] suffix   Scratch memory of (n + w - 1) * lanes elements
 template<typename T, bool IsDilation>
-void morph(Param<T> paddedOut, CParam<T> paddedIn, CParam<T> mask) {
+void runningExtreme(T* dst, dim_t dstep, dim_t dlane, const T* src,
+                    dim_t sstep, dim_t slane, dim_t n, dim_t w, dim_t lanes,
+                    T* prefix, T* suffix) {
+    MorphFilterOp<T, IsDilation> filterOp;
+    const dim_t len = n + w - 1;
+
+    for (dim_t x = 0; x < len; ++x) {
+        const T* s = src + x * sstep;
+        T* p       = prefix + x * lanes;
+        if (x % w == 0) {
+            for (dim_t l = 0; l < lanes; ++l) { p[l] = s[l * slane]; }
+        } else {
+            for (dim_t l = 0; l < lanes; ++l) {
+                p[l] = filterOp(p[l - lanes], s[l * slane]);
+            }
+        }
+    }
+    for (dim_t x = len - 1; x >= 0; --x) {
+        const T* s = src + x * sstep;
+        T* q       = suffix + x * lanes;
+        if (x == len - 1 || (x + 1) % w == 0) {
+            for (dim_t l = 0; l < lanes; ++l) { q[l] = s[l * slane]; }
+        } else {
+            for (dim_t l = 0; l < lanes; ++l) {
+                q[l] = filterOp(q[l + lanes], s[l * slane]);
+            }
+        }
+    }
+    for (dim_t x = 0; x < n; ++x) {
+        const T* q = suffix + x * lanes;
+        const T* p = prefix + (x + w - 1) * lanes;
+        T* d       = dst + x * dstep;
+        for (dim_t l = 0; l < lanes; ++l) {
+            d[l * dlane] = filterOp(q[l], p[l]);
+        }
+    }
+}
+
+/// Applies a flat window of \p w elements along dimension \p axis.
+///
+/// Element i of the result along the axis is the extreme of elements
+/// [i - w / 2, i - w / 2 + w - 1] of the source. If \p hasBorder is true
+/// the source holds these elements beyond the edges of \p dims, otherwise
+/// they are replaced by \p init. Lines along the other dimensions are
+/// filtered MORPH_LINE_LANES at a time so the inner loops stay contiguous.
+template<typename T, bool IsDilation>
+void morphAxis(T* dst, const af::dim4& dstrides, const T* src,
+               const af::dim4& sstrides, const af::dim4& dims, int axis,
+               dim_t w, bool hasBorder, T init) {
+    const dim_t n     = dims[axis];
+    const dim_t R     = w / 2;
+    const dim_t len   = n + w - 1;
+    const dim_t lanes = axis == 0 ? 1 : std::min(dims[0], MORPH_LINE_LANES);
+    const dim_t sstep = sstrides[axis];
+
+    std::vector<T> prefix(len * lanes), suffix(len * lanes), line;
+    if (!hasBorder) { line.resize(len * lanes); }
+
+    const dim_t d1 = axis == 1 ? 1 : dims[1];
+    const dim_t d2 = axis == 2 ? 1 : dims[2];
+    const dim_t d0 = axis == 0 ? 1 : dims[0];
+    for (dim_t i3 = 0; i3 < dims[3]; ++i3) {
+        for (dim_t i2 = 0; i2 < d2; ++i2) {
+            for (dim_t i1 = 0; i1 < d1; ++i1) {
+                for (dim_t i0 = 0; i0 < d0; i0 += lanes) {
+                    const dim_t m = std::min(lanes, d0 - i0);
+                    const T* s    = src + getIdx(sstrides, i0, i1, i2, i3);
+                    T* d          = dst + getIdx(dstrides, i0, i1, i2, i3);
+                    if (hasBorder) {
+                        runningExtreme<T, IsDilation>(
+                            d, dstrides[axis], dstrides[0], s - R * sstep,
+                            sstep, sstrides[0], n, w, m, prefix.data(),
+                            suffix.data());
+                        continue;
+                    }
+                    for (dim_t x = 0; x < len; ++x) {
+                        const dim_t p = x - R;
+                        T* l          = line.data() + x * m;
+                        if (p < 0 || p >= n) {
+                            std::fill(l, l + m, init);
+                        } else {
+                            for (dim_t k = 0; k < m; ++k) {
+                                l[k] = s[p * sstep + k * sstrides[0]];
+                            }
+                        }
+                    }
+                    runningExtreme<T, IsDilation>(
+                        d, dstrides[axis], dstrides[0], line.data(), m, 1, n,
+                        w, m, prefix.data(), suffix.data());
+                }
+            }
+        }
+    }
+}
+
+/// The value which replaces the elements beyond the edges of an image in
+/// the passes of morphAxis. Dilation pads the image with zeros. Erosion pads
+/// it with the nearest edge element, which is inside every flat window that
+/// holds the padded element, so it is the same as ignoring the padding.
+template<typename T, bool IsDilation>
+T flatBorder() {
+    return IsDilation ? T(0) : common::Binary<T, af_min_t>::init();
+}
+
+/// Dilation or erosion of an image with a flat mask of \p window elements,
+/// as one pass along each dimension
+template<typename T, bool IsDilation>
+void morphFlat(Param<T> out, CParam<T> in, const af::dim4& window) {
+    const af::dim4 dims = in.dims();
+    const af::dim4 tstrides(1, dims[0], dims[0] * dims[1],
+                            dims[0] * dims[1] * dims[2]);
+    std::vector<T> tmp(dims.elements());
+
+    const T border = flatBorder<T, IsDilation>();
+    morphAxis<T, IsDilation>(tmp.data(), tstrides, in.get(), in.strides(),
+                             dims, 0, window[0], false, border);
+    morphAxis<T, IsDilation>(out.get(), out.strides(), tmp.data(), tstrides,
+                             dims, 1, window[1], false, border);
+}
+
+/// Dilation or erosion of an image with any mask.
+///
+/// Dilation reads zeros beyond the edges of the image and erosion reads the
+/// nearest edge element. The windows which fit in the image read the input
+/// through the offsets of the mask elements, and only the windows along the
+/// edges check the bounds of each element.
+template<typename T, bool IsDilation>
+void morph(Param<T> out, CParam<T> in, CParam<T> mask) {
+    if (isFlatMask(mask)) {
+        morphFlat<T, IsDilation>(out, in, mask.dims());
+        return;
+    }
+
     MorphFilterOp<T, IsDilation> filterOp;
     T init = IsDilation ? common::Binary<T, af_max_t>::init()
                         : common::Binary<T, af_min_t>::init();
 
-    const af::dim4 ostrides = paddedOut.strides();
-    T* outData              = paddedOut.get();
-    const af::dim4 istrides = paddedIn.strides();
-    const af::dim4 dims     = paddedIn.dims();
-    const T* inData         = paddedIn.get();
+    const af::dim4 ostrides = out.strides();
+    const af::dim4 istrides = in.strides();
+    const af::dim4 dims     = in.dims();
+    const af::dim4 mdims    = mask.dims();
+    const af::dim4 fstrides = mask.strides();
+    const T* filter         = mask.get();
+    const dim_t R0          = mdims[0] / 2;
+    const dim_t R1          = mdims[1] / 2;
 
     std::vector<dim_t> offsets;
     getOffsets(offsets, istrides, mask);
 
-    const dim_t batchSize = dims[0] * dims[1];
-    const int batchCount  = dims[2] * dims[3];
-    for (int b = 0; b < batchCount; ++b) {
-        for (dim_t n = 0; n < batchSize; ++n) {
-            T filterResult = init;
-            for (size_t oi = 0; oi < offsets.size(); ++oi) {
-                dim_t x = n + offsets[oi];
-                if (x >= 0 && x < batchSize)
-                    filterResult = filterOp(filterResult, inData[x]);
+    std::vector<std::pair<dim_t, dim_t>> taps;
+    for (dim_t j = 0; j < mdims[1]; ++j) {
+        for (dim_t i = 0; i < mdims[0]; ++i) {
+            if (filter[getIdx(fstrides, i, j)] > (T)0) {
+                taps.emplace_back(i - R0, j - R1);
+            }
+        }
+    }
+
+    auto border = [&](const T* iptr, dim_t i, dim_t j) {
+        if (IsDilation) {
+            if (i < 0 || i >= dims[0] || j < 0 || j >= dims[1]) { return T(0); }
+        } else {
+            i = std::min(std::max(i, dim_t(0)), dims[0] - 1);
+            j = std::min(std::max(j, dim_t(0)), dims[1] - 1);
+        }
+        return iptr[i * istrides[0] + j * istrides[1]];
+    };
+
+    for (dim_t b3 = 0; b3 < dims[3]; ++b3) {
+        for (dim_t b2 = 0; b2 < dims[2]; ++b2) {
+            const T* iptr = in.get() + b2 * istrides[2] + b3 * istrides[3];
+            T* optr       = out.get() + b2 * ostrides[2] + b3 * ostrides[3];
+            for (dim_t j = 0; j < dims[1]; ++j) {
+                const bool innerJ = j >= R1 && j - R1 + mdims[1] <= dims[1];
+                for (dim_t i = 0; i < dims[0]; ++i) {
+                    T filterResult = init;
+                    if (innerJ && i >= R0 && i - R0 + mdims[0] <= dims[0]) {
+                        const T* p = iptr + i * istrides[0] + j * istrides[1];
+                        for (dim_t offset : offsets) {
+                            filterResult = filterOp(filterResult, p[offset]);
+                        }
+                    } else {
+                        for (const auto& tap : taps) {
+                            filterResult = filterOp(
+                                filterResult,
+                                border(iptr, i + tap.first, j + tap.second));
+                        }
+                    }
+                    optr[i * ostrides[0] + j * ostrides[1]] = filterResult;
+                }
             }
-            outData[n] = filterResult;
         }
-        outData += ostrides[2];
-        inData += istrides[2];
     }
 }
 
@@ -92,6 +303,19 @@ void morph3d(Param<T> out, CParam<T> in, CParam<T> mask) {
     T init = IsDilation ? common::Binary<T, af_max_t>::init()
                         : common::Binary<T, af_min_t>::init();
 
+    if (isFlatMask(mask)) {
+        std::vector<T> tmp0(dims.elements()), tmp1(dims.elements());
+        const af::dim4 tstrides(1, dims[0], dims[0] * dims[1],
+                                dims[0] * dims[1] * dims[2]);
+        morphAxis<T, IsDilation>(tmp0.data(), tstrides, inData, istrides,
+                                 dims, 0, window[0], false, init);
+        morphAxis<T, IsDilation>(tmp1.data(), tstrides, tmp0.data(),
+                                 tstrides, dims, 1, window[1], false, init);
+        morphAxis<T, IsDilation>(outData, ostrides, tmp1.data(), tstrides,
+                                 dims, 2, window[2], false, init);
+        return;
+    }
+
     for (dim_t batchId = 0; batchId < bCount; ++batchId) {
         // either channels or batch is handled by outer most loop
         for (dim_t k = 0; k < dims[2]; ++k) {
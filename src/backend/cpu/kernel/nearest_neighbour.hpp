@@ -9,6 +9,14 @@
 
 #pragma once
 #include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <platform.hpp>
+#include <thread_pool.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
@@ -20,6 +28,17 @@ namespace kernel {
 
 #endif
 
+/// The number of queries which are compared against a block of training
+/// samples while the block is in cache
+constexpr dim_t NN_QUERY_BLOCK = 32;
+
+/// The size of the block of training samples kept in cache
+constexpr dim_t NN_TRAIN_BLOCK_BYTES = 1 << 18;
+
+/// The minimum number of training samples a task handles when the training
+/// samples are split across the thread pool
+constexpr dim_t NN_MIN_TASK_TRAIN = 1 << 12;
+
 template<typename T, typename To, af_match_type dist_type>
 struct dist_op {
     To operator()(T v1, T v2) {
@@ -57,43 +76,258 @@ struct dist_op<ushort, To, AF_SHD> {
     To operator()(ushort v1, ushort v2) { return __builtin_popcount(v1 ^ v2); }
 };
 
+/// Returns the distance between two samples with \p len features each.
+///
+/// The features are accumulated in independent lanes so the loop can be
+/// vectorized without reordering the additions of a single lane.
 template<typename T, typename To, af_match_type dist_type>
-void nearest_neighbour(Param<To> dists, CParam<T> query, CParam<T> train,
-                       const uint dist_dim) {
-    uint sample_dim  = (dist_dim == 0) ? 1 : 0;
-    const dim4 qDims = query.dims();
-    const dim4 tDims = train.dims();
+To distance(const T* q, const T* t, const dim_t len) {
+    constexpr int LANES = 8;
+    dist_op<T, To, dist_type> op;
+
+    To lanes[LANES] = {};
+    dim_t k         = 0;
+    for (; k + LANES <= len; k += LANES) {
+        for (int l = 0; l < LANES; ++l) { lanes[l] += op(q[k + l], t[k + l]); }
+    }
+
+    To dist = 0;
+    for (; k < len; ++k) { dist += op(q[k], t[k]); }
+    for (int l = 0; l < LANES; ++l) { dist += lanes[l]; }
+    return dist;
+}
 
-    const unsigned distLength = qDims[dist_dim];
-    const unsigned nQuery     = qDims[sample_dim];
-    const unsigned nTrain     = tDims[sample_dim];
+/// Inserts a candidate into the sorted list of the \p k best candidates of a
+/// query. Candidates with the same distance keep the order in which they
+/// were inserted.
+///
+/// \param[inout] dists The distances of the best candidates
+/// \param[inout] idxs  The indices of the best candidates
+/// \param[inout] count The number of candidates in the list
+/// \param[in]    k     The maximum number of candidates in the list
+/// \param[in]    dist  The distance of the candidate
+/// \param[in]    idx   The index of the candidate
+template<typename To>
+void insertTopK(To* dists, uint* idxs, uint& count, const uint k,
+                const To dist, const uint idx) {
+    if (count == k) {
+        if (!(dist < dists[k - 1])) { return; }
+    } else {
+        count++;
+    }
+
+    uint pos = count - 1;
+    for (; pos > 0 && dist < dists[pos - 1]; --pos) {
+        dists[pos] = dists[pos - 1];
+        idxs[pos]  = idxs[pos - 1];
+    }
+    dists[pos] = dist;
+    idxs[pos]  = idx;
+}
+
+/// Finds the \p n_dist nearest training samples of each query sample.
+///
+/// The samples are the columns of \p query and \p train. Blocks of queries
+/// are compared against blocks of training samples which fit in cache and
+/// the best candidates are kept while the distances are computed, so the
+/// full distance matrix is never stored. The training samples are split
+/// across the thread pool as well when there are too few queries to keep
+/// all the threads busy.
+template<typename T, typename To, af_match_type dist_type>
+void nearest_neighbour(Param<uint> idx, Param<To> dist, CParam<T> query,
+                       CParam<T> train, const uint n_dist) {
+    const af::dim4 qDims    = query.dims();
+    const af::dim4 tDims    = train.dims();
+    const af::dim4 qStrides = query.strides();
+    const af::dim4 tStrides = train.strides();
+
+    const dim_t len    = qDims[0];
+    const dim_t nQuery = qDims[1];
+    const dim_t nTrain = tDims[1];
 
     const T* qPtr = query.get();
     const T* tPtr = train.get();
-    To* dPtr      = dists.get();
 
-    dist_op<T, To, dist_type> op;
+    thread_pool& pool     = getThreadPool();
+    const dim_t nqblocks  = divup(nQuery, NN_QUERY_BLOCK);
+    const dim_t nchunks   = std::max<dim_t>(
+        1, std::min(divup(static_cast<dim_t>(pool.size()), nqblocks),
+                    nTrain / NN_MIN_TASK_TRAIN));
+    const dim_t chunkSize = divup(nTrain, nchunks);
+    const dim_t tblock    = std::max<dim_t>(
+        1, NN_TRAIN_BLOCK_BYTES / std::max<dim_t>(1, len * sizeof(T)));
 
-    for (unsigned i = 0; i < nQuery; i++) {
-        for (unsigned j = 0; j < nTrain; j++) {
-            To local_dist = 0;
-            for (unsigned k = 0; k < distLength; k++) {
-                size_t qIdx, tIdx;
-                if (sample_dim == 0) {
-                    qIdx = k * qDims[0] + i;
-                    tIdx = k * tDims[0] + j;
-                } else {
-                    qIdx = i * qDims[0] + k;
-                    tIdx = j * tDims[0] + k;
-                }
+    // The best candidates of each query in each chunk of training samples
+    std::vector<To> chunkDists(nchunks * nQuery * n_dist);
+    std::vector<uint> chunkIdxs(nchunks * nQuery * n_dist);
+    std::vector<uint> chunkCounts(nchunks * nQuery, 0);
+
+    auto task = [&](int id) {
+        const dim_t qblock = id % nqblocks;
+        const dim_t chunk  = id / nqblocks;
+        const dim_t qBegin = qblock * NN_QUERY_BLOCK;
+        const dim_t qEnd   = std::min(qBegin + NN_QUERY_BLOCK, nQuery);
+        const dim_t tBegin = chunk * chunkSize;
+        const dim_t tEnd   = std::min(tBegin + chunkSize, nTrain);
 
-                local_dist += op(qPtr[qIdx], tPtr[tIdx]);
+        for (dim_t b = tBegin; b < tEnd; b += tblock) {
+            const dim_t bEnd = std::min(b + tblock, tEnd);
+            for (dim_t i = qBegin; i < qEnd; ++i) {
+                const T* q      = qPtr + i * qStrides[1];
+                const dim_t off = chunk * nQuery + i;
+                To* dists       = chunkDists.data() + off * n_dist;
+                uint* idxs      = chunkIdxs.data() + off * n_dist;
+                uint& count     = chunkCounts[off];
+                for (dim_t j = b; j < bEnd; ++j) {
+                    To d = distance<T, To, dist_type>(q, tPtr + j * tStrides[1],
+                                                      len);
+                    insertTopK(dists, idxs, count, n_dist, d,
+                               static_cast<uint>(j));
+                }
             }
+        }
+    };
+    pool.run(static_cast<int>(nqblocks * nchunks), task);
 
-            dPtr[i * nTrain + j] = local_dist;
+    // Merge the candidates of the chunks in the order of the training
+    // samples so ties are resolved in favour of the lower index
+    To* dPtr   = dist.get();
+    uint* iPtr = idx.get();
+    const af::dim4 dStrides = dist.strides();
+    const af::dim4 iStrides = idx.strides();
+    for (dim_t i = 0; i < nQuery; ++i) {
+        std::vector<To> dists(n_dist);
+        std::vector<uint> idxs(n_dist);
+        uint count = 0;
+        for (dim_t chunk = 0; chunk < nchunks; ++chunk) {
+            const dim_t off = chunk * nQuery + i;
+            for (uint c = 0; c < chunkCounts[off]; ++c) {
+                insertTopK(dists.data(), idxs.data(), count, n_dist,
+                           chunkDists[off * n_dist + c],
+                           chunkIdxs[off * n_dist + c]);
+            }
         }
+        for (uint c = 0; c < n_dist; ++c) {
+            dPtr[i * dStrides[1] + c] = dists[c];
+            iPtr[i * iStrides[1] + c] = idxs[c];
+        }
+    }
+}
+
+/// Computes the squared norm of each column of \p in
+template<typename T>
+void squaredNorms(Param<T> out, CParam<T> in) {
+    const af::dim4 dims    = in.dims();
+    const af::dim4 strides = in.strides();
+    const T* inPtr         = in.get();
+    T* outPtr              = out.get();
+    for (dim_t j = 0; j < dims[1]; ++j) {
+        const T* col = inPtr + j * strides[1];
+        T norm       = 0;
+        for (dim_t k = 0; k < dims[0]; ++k) { norm += col[k] * col[k]; }
+        outPtr[j] = norm;
     }
 }
 
+/// Adds the candidates of a block of training samples to the best candidates
+/// of each query using the squared euclidean distance
+/// ||q||^2 + ||t||^2 - 2 q.t
+///
+/// \param[inout] idx    The indices of the best candidates
+/// \param[inout] dist   The distances of the best candidates
+/// \param[in]    prods  The products -2 t.q of the training block and the
+///                      queries, one column per query
+/// \param[in]    qNorms The squared norms of the queries
+/// \param[in]    tNorms The squared norms of all the training samples
+/// \param[in]    offset The index of the first sample of the block
+/// \param[in]    n_dist The number of candidates to keep
+template<typename T>
+void mergeSSD(Param<uint> idx, Param<T> dist, CParam<T> prods,
+              CParam<T> qNorms, CParam<T> tNorms, const dim_t offset,
+              const uint n_dist) {
+    const dim_t len    = prods.dims()[0];
+    const dim_t nQuery = prods.dims()[1];
+
+    const T* pPtr  = prods.get();
+    const T* qnPtr = qNorms.get();
+    const T* tnPtr = tNorms.get() + offset;
+    T* dPtr        = dist.get();
+    uint* iPtr     = idx.get();
+
+    const dim_t pStride = prods.strides()[1];
+    const dim_t dStride = dist.strides()[1];
+    const dim_t iStride = idx.strides()[1];
+
+    // The lists already hold the best candidates of the previous blocks
+    const uint count0 = static_cast<uint>(
+        std::min<dim_t>(offset, static_cast<dim_t>(n_dist)));
+
+    const dim_t queriesPerTask = std::max<dim_t>(1, NN_MIN_TASK_TRAIN / len);
+    const int ntasks = static_cast<int>(divup(nQuery, queriesPerTask));
+    getThreadPool().run(ntasks, [&](int id) {
+        const dim_t begin = id * queriesPerTask;
+        const dim_t end   = std::min(begin + queriesPerTask, nQuery);
+        for (dim_t i = begin; i < end; ++i) {
+            const T* p  = pPtr + i * pStride;
+            T* dists    = dPtr + i * dStride;
+            uint* idxs  = iPtr + i * iStride;
+            uint count  = count0;
+            const T qn  = qnPtr[i];
+            for (dim_t j = 0; j < len; ++j) {
+                // Rounding can make the distance of close samples negative
+                T d = std::max(T(0), qn + tnPtr[j] + p[j]);
+                insertTopK(dists, idxs, count, n_dist, d,
+                           static_cast<uint>(offset + j));
+            }
+        }
+    });
+}
+
+/// Recomputes the distances of the selected candidates directly from the
+/// samples and sorts the candidates by them. This removes the rounding error
+/// of the norm based distances from the results.
+template<typename T>
+void refineSSD(Param<uint> idx, Param<T> dist, CParam<T> query,
+               CParam<T> train) {
+    const dim_t len    = query.dims()[0];
+    const dim_t nQuery = query.dims()[1];
+    const uint n_dist  = static_cast<uint>(dist.dims()[0]);
+
+    const T* qPtr = query.get();
+    const T* tPtr = train.get();
+    T* dPtr       = dist.get();
+    uint* iPtr    = idx.get();
+
+    const dim_t qStride = query.strides()[1];
+    const dim_t tStride = train.strides()[1];
+    const dim_t dStride = dist.strides()[1];
+    const dim_t iStride = idx.strides()[1];
+
+    const dim_t queriesPerTask = std::max<dim_t>(
+        1, NN_MIN_TASK_TRAIN / std::max<dim_t>(1, len * n_dist));
+    const int ntasks = static_cast<int>(divup(nQuery, queriesPerTask));
+    getThreadPool().run(ntasks, [&](int id) {
+        const dim_t begin = id * queriesPerTask;
+        const dim_t end   = std::min(begin + queriesPerTask, nQuery);
+        std::vector<std::pair<T, uint>> candidates(n_dist);
+        for (dim_t i = begin; i < end; ++i) {
+            T* dists   = dPtr + i * dStride;
+            uint* idxs = iPtr + i * iStride;
+            for (uint c = 0; c < n_dist; ++c) {
+                candidates[c] = {
+                    distance<T, T, AF_SSD>(qPtr + i * qStride,
+                                           tPtr + idxs[c] * tStride, len),
+                    idxs[c]};
+            }
+            // Ties are resolved in favour of the lower index
+            std::sort(candidates.begin(), candidates.end());
+            for (uint c = 0; c < n_dist; ++c) {
+                dists[c] = candidates[c].first;
+                idxs[c]  = candidates[c].second;
+            }
+        }
+    });
+}
+
 }  // namespace kernel
 }  // namespace cpu
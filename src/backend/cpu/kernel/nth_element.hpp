@@ -0,0 +1,88 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <platform.hpp>
+#include <thread_pool.hpp>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace cpu {
+namespace kernel {
+
+/// The smallest number of elements selected by one task of the thread pool
+constexpr dim_t NTH_ELEMENT_MIN_TASK_ELEMENTS = 1 << 16;
+
+/// Selects the values of rank \p rank and rank + 1 of each line along \p dim.
+///
+/// Each line is copied to a scratch buffer of the task and partitioned with
+/// std::nth_element, which takes linear time. The value of rank + 1 is the
+/// smallest value of the upper partition. Lines are split across the thread
+/// pool.
+template<typename T>
+void nth_element(Param<T> out, CParam<T> in, const int dim,
+                 const dim_t rank) {
+    const af::dim4 idims    = in.dims();
+    const af::dim4 istrides = in.strides();
+    const af::dim4 ostrides = out.strides();
+
+    const dim_t n      = idims[dim];
+    const dim_t nlines = idims.elements() / n;
+    const dim_t second = std::min(rank + 1, n - 1);
+
+    int lineDims[3];
+    for (int d = 0, i = 0; d < 4; ++d) {
+        if (d != dim) { lineDims[i++] = d; }
+    }
+
+    auto lineOffset = [&](dim_t line, const af::dim4 &strides) {
+        dim_t offset = 0;
+        for (int d : lineDims) {
+            offset += (line % idims[d]) * strides[d];
+            line /= idims[d];
+        }
+        return offset;
+    };
+
+    thread_pool &pool  = getThreadPool();
+    const dim_t ntasks = std::max<dim_t>(
+        1, std::min({static_cast<dim_t>(pool.size()), nlines,
+                     nlines * n / NTH_ELEMENT_MIN_TASK_ELEMENTS}));
+    const dim_t linesPerTask = divup(nlines, ntasks);
+
+    pool.run(static_cast<int>(ntasks), [&](int task) {
+        std::vector<T> scratch(n);
+        const dim_t first = task * linesPerTask;
+        const dim_t last  = std::min(first + linesPerTask, nlines);
+        for (dim_t line = first; line < last; ++line) {
+            const T *iptr = in.get() + lineOffset(line, istrides);
+            for (dim_t i = 0; i < n; ++i) {
+                scratch[i] = iptr[i * istrides[dim]];
+            }
+
+            auto nth = scratch.begin() + rank;
+            std::nth_element(scratch.begin(), nth, scratch.end());
+
+            T *optr             = out.get() + lineOffset(line, ostrides);
+            optr[0]             = *nth;
+            optr[ostrides[dim]] = second == rank
+                                      ? *nth
+                                      : *std::min_element(nth + 1,
+                                                          scratch.end());
+        }
+    });
+}
+
+}  // namespace kernel
+}  // namespace cpu
@@ -0,0 +1,280 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <common/dispatch.hpp>
+#include <err_cpu.hpp>
+#include <platform.hpp>
+#include <thread_pool.hpp>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace cpu {
+namespace kernel {
+
+/// Maps a key to an unsigned integer with the same ordering so the keys can
+/// be sorted one byte at a time
+template<typename T, typename Enable = void>
+struct RadixTraits;
+
+template<typename T>
+struct RadixTraits<
+    T, typename std::enable_if<std::is_integral<T>::value>::type> {
+    using bits_t = typename std::make_unsigned<T>::type;
+
+    static bits_t toBits(const T val) {
+        bits_t bits = static_cast<bits_t>(val);
+        // Negative values are placed before the positive values
+        if (std::is_signed<T>::value) {
+            bits ^= static_cast<bits_t>(bits_t(1) << (sizeof(T) * 8 - 1));
+        }
+        return bits;
+    }
+};
+
+template<typename T>
+struct RadixTraits<
+    T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    using bits_t = typename std::conditional<sizeof(T) == 4, uint32_t,
+                                             uint64_t>::type;
+
+    static bits_t toBits(const T val) {
+        constexpr bits_t sign = bits_t(1) << (sizeof(T) * 8 - 1);
+        bits_t bits;
+        std::memcpy(&bits, &val, sizeof(T));
+        // The order of the negative values is reversed by flipping all the
+        // bits. The positive values only need the sign bit set.
+        return bits ^ ((bits & sign) ? ~bits_t(0) : sign);
+    }
+};
+
+/// Lines shorter than this are sorted with an insertion sort
+constexpr dim_t RADIX_MIN_ELEMENTS = 64;
+
+/// The minimum number of elements a thread handles in a radix sort pass
+constexpr dim_t RADIX_MIN_TASK_ELEMENTS = 1 << 16;
+
+/// Sorts \p n keys, and the values which go with them, using a stable LSD
+/// radix sort with 8 bit digits.
+///
+/// \param[inout] keys        The keys to sort
+/// \param[inout] vals        The values moved along with the keys. Can be
+///                           nullptr to only sort the keys.
+/// \param[in]    n           The number of keys
+/// \param[in]    isAscending The order of the sort
+/// \param[in]    key_tmp     Scratch space for the keys
+/// \param[in]    val_tmp     Scratch space for the values
+/// \param[in]    parallel    If true, the passes are split across the
+///                           thread pool
+template<typename Tk, typename Tv>
+void radixSort(Tk *keys, Tv *vals, const dim_t n, const bool isAscending,
+               std::vector<Tk> &key_tmp, std::vector<Tv> &val_tmp,
+               const bool parallel) {
+    using traits = RadixTraits<Tk>;
+    using bits_t = typename traits::bits_t;
+
+    const bits_t flip = isAscending ? bits_t(0) : ~bits_t(0);
+    auto toBits       = [flip](const Tk key) {
+        return static_cast<bits_t>(traits::toBits(key) ^ flip);
+    };
+
+    if (n < RADIX_MIN_ELEMENTS) {
+        for (dim_t i = 1; i < n; ++i) {
+            Tk key      = keys[i];
+            bits_t bits = toBits(key);
+            Tv val      = vals ? vals[i] : Tv();
+            dim_t j     = i;
+            for (; j > 0 && toBits(keys[j - 1]) > bits; --j) {
+                keys[j] = keys[j - 1];
+                if (vals) { vals[j] = vals[j - 1]; }
+            }
+            keys[j] = key;
+            if (vals) { vals[j] = val; }
+        }
+        return;
+    }
+
+    constexpr int RADIX  = 256;
+    constexpr int PASSES = sizeof(bits_t);
+    using hist_t         = std::array<dim_t, RADIX>;
+
+    key_tmp.resize(n);
+    if (vals) { val_tmp.resize(n); }
+
+    thread_pool &pool = getThreadPool();
+    const int nblocks =
+        parallel ? std::max(1, std::min(pool.size(),
+                                        static_cast<int>(divup(
+                                            n, RADIX_MIN_TASK_ELEMENTS))))
+                 : 1;
+    const dim_t block_size = divup(n, static_cast<dim_t>(nblocks));
+    std::vector<hist_t> hists(nblocks);
+
+    auto runBlocks = [&](const std::function<void(int, dim_t, dim_t)> &fn) {
+        auto task = [&](int b) {
+            dim_t begin = b * block_size;
+            fn(b, begin, std::min(begin + block_size, n));
+        };
+        if (nblocks == 1) {
+            task(0);
+        } else {
+            pool.run(nblocks, task);
+        }
+    };
+
+    Tk *src_keys = keys;
+    Tv *src_vals = vals;
+    Tk *dst_keys = key_tmp.data();
+    Tv *dst_vals = vals ? val_tmp.data() : nullptr;
+
+    for (int pass = 0; pass < PASSES; ++pass) {
+        const int shift = 8 * pass;
+        runBlocks([&](int b, dim_t begin, dim_t end) {
+            hist_t &hist = hists[b];
+            hist.fill(0);
+            for (dim_t i = begin; i < end; ++i) {
+                hist[(toBits(src_keys[i]) >> shift) & (RADIX - 1)]++;
+            }
+        });
+
+        // Turn the counts into the output position of each block and skip
+        // the pass if all the keys have the same digit
+        bool skip    = false;
+        dim_t offset = 0;
+        for (int d = 0; d < RADIX; ++d) {
+            dim_t count = 0;
+            for (int b = 0; b < nblocks; ++b) {
+                dim_t c     = hists[b][d];
+                hists[b][d] = offset + count;
+                count += c;
+            }
+            if (count == n) {
+                skip = true;
+                break;
+            }
+            offset += count;
+        }
+        if (skip) { continue; }
+
+        runBlocks([&](int b, dim_t begin, dim_t end) {
+            hist_t &pos = hists[b];
+            for (dim_t i = begin; i < end; ++i) {
+                dim_t p =
+                    pos[(toBits(src_keys[i]) >> shift) & (RADIX - 1)]++;
+                dst_keys[p] = src_keys[i];
+                if (vals) { dst_vals[p] = src_vals[i]; }
+            }
+        });
+
+        std::swap(src_keys, dst_keys);
+        std::swap(src_vals, dst_vals);
+    }
+
+    if (src_keys != keys) {
+        std::copy(src_keys, src_keys + n, keys);
+        if (vals) { std::copy(src_vals, src_vals + n, vals); }
+    }
+}
+
+/// Sorts all the lines of \p keys along \p dim, moving \p vals with them.
+///
+/// The lines along dimension 0 are sorted in place. The lines along other
+/// dimensions are stored contiguously, one after the other, in the order of
+/// the remaining dimensions. The arrays need to be linear in that case.
+///
+/// Independent lines are sorted in parallel. A single long line is sorted
+/// with a parallel radix sort.
+///
+/// \param[inout] keys        The keys to sort
+/// \param[inout] vals        The values moved with the keys or nullptr
+/// \param[in]    dims        The dimensions of the arrays
+/// \param[in]    kstrides    The strides of \p keys
+/// \param[in]    vstrides    The strides of \p vals
+/// \param[in]    dim         The dimension to sort along
+/// \param[in]    isAscending The order of the sort
+template<typename Tk, typename Tv>
+void sortLines(Tk *keys, Tv *vals, const af::dim4 &dims,
+               const af::dim4 &kstrides, const af::dim4 &vstrides,
+               const int dim, const bool isAscending) {
+    const dim_t n      = dims[dim];
+    const dim_t nlines = n == 0 ? 0 : dims.elements() / n;
+    if (nlines == 0) { return; }
+
+    // The offset of the first element of the line in an array
+    auto lineOffset = [&](dim_t line, const af::dim4 &strides) {
+        dim_t offset = 0;
+        for (int d = 0; d < AF_MAX_DIMS; ++d) {
+            if (d == dim) { continue; }
+            offset += (line % dims[d]) * strides[d];
+            line /= dims[d];
+        }
+        return offset;
+    };
+
+    // Lines along the other dimensions are gathered from a copy because the
+    // sorted lines overwrite the input
+    const bool inplace = dim == 0;
+    std::vector<Tk> key_src;
+    std::vector<Tv> val_src;
+    if (!inplace) {
+        key_src.assign(keys, keys + dims.elements());
+        if (vals) { val_src.assign(vals, vals + dims.elements()); }
+    }
+
+    auto sortLine = [&](dim_t line, std::vector<Tk> &key_tmp,
+                        std::vector<Tv> &val_tmp, bool parallel) {
+        Tk *lkeys = keys + lineOffset(line, kstrides);
+        Tv *lvals = vals ? vals + lineOffset(line, vstrides) : nullptr;
+        if (!inplace) {
+            lkeys = keys + line * n;
+            lvals = vals ? vals + line * n : nullptr;
+
+            const Tk *ksrc      = key_src.data() + lineOffset(line, kstrides);
+            const dim_t kstride = kstrides[dim];
+            for (dim_t i = 0; i < n; ++i) { lkeys[i] = ksrc[i * kstride]; }
+            if (vals) {
+                const Tv *vsrc = val_src.data() + lineOffset(line, vstrides);
+                const dim_t vstride = vstrides[dim];
+                for (dim_t i = 0; i < n; ++i) { lvals[i] = vsrc[i * vstride]; }
+            }
+        }
+        radixSort(lkeys, lvals, n, isAscending, key_tmp, val_tmp, parallel);
+    };
+
+    if (nlines == 1) {
+        std::vector<Tk> key_tmp;
+        std::vector<Tv> val_tmp;
+        sortLine(0, key_tmp, val_tmp, true);
+        return;
+    }
+
+    thread_pool &pool = getThreadPool();
+    const dim_t lines_per_task =
+        std::max<dim_t>(1, RADIX_MIN_TASK_ELEMENTS / n);
+    const int ntasks = static_cast<int>(divup(nlines, lines_per_task));
+    pool.run(ntasks, [&](int task) {
+        std::vector<Tk> key_tmp;
+        std::vector<Tv> val_tmp;
+        dim_t begin = task * lines_per_task;
+        dim_t end   = std::min(begin + lines_per_task, nlines);
+        for (dim_t line = begin; line < end; ++line) {
+            sortLine(line, key_tmp, val_tmp, false);
+        }
+    });
+}
+
+}  // namespace kernel
+}  // namespace cpu
@@ -0,0 +1,113 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/internal_enums.hpp>
+#include <common/random_distributions.hpp>
+#include <kernel/random_engine.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace cpu {
+namespace kernel {
+
+/// The number of elements of a block of randomDistribution
+constexpr size_t RANDOM_DIST_BLOCK = 1024;
+
+/// The random values of an element of a distribution. They are the Philox
+/// values of the seed and of a counter made of the counter of the engine
+/// plus the index of the element, the index of the draw and
+/// RANDOM_DIST_STREAM, so they only depend on the position of the element.
+template<typename T>
+class PhiloxElementStream {
+   private:
+    uint m_key[2];
+    uint m_ctr[4];
+    uint m_words[4];
+    int m_next;
+    bool m_hasNormal;
+    T m_normal;
+
+    uint word() {
+        if (m_next == 4) {
+            uint key[2] = {m_key[0], m_key[1]};
+            std::copy(m_ctr, m_ctr + 4, m_words);
+            philox(key, m_words);
+            ++m_ctr[2];
+            m_next = 0;
+        }
+        return m_words[m_next++];
+    }
+
+    float uniform(float *) {
+        uint num = word();
+        return getFloat01(&num, 0);
+    }
+
+    double uniform(double *) {
+        uint nums[2] = {word(), word()};
+        return getDouble01(nums, 0);
+    }
+
+   public:
+    PhiloxElementStream(const uintl seed, const uintl counter,
+                        const uintl index)
+        : m_key{static_cast<uint>(seed), static_cast<uint>(seed >> 32)}
+        , m_ctr{0, 0, 0, common::RANDOM_DIST_STREAM}
+        , m_next(4)
+        , m_hasNormal(false)
+        , m_normal(0) {
+        addCounter(m_ctr, counter, index);
+    }
+
+    /// Returns a value in (0, 1]
+    T uniform() { return uniform(static_cast<T *>(nullptr)); }
+
+    /// Returns a value of the standard normal distribution. The values are
+    /// generated in pairs with the Box-Muller transform.
+    T normal() {
+        if (m_hasNormal) {
+            m_hasNormal = false;
+            return m_normal;
+        }
+        const T r     = std::sqrt(T(-2) * std::log(uniform()));
+        const T theta = T(2 * PI_VAL) * uniform();
+        m_normal      = r * std::sin(theta);
+        m_hasNormal   = true;
+        return r * std::cos(theta);
+    }
+};
+
+/// Writes a value of \p dist to each element of \p out, with the parameters
+/// of the same elements of \p param0 and \p param1. The arrays are linear.
+template<typename T>
+void randomDistribution(Param<T> out, CParam<T> param0, CParam<T> param1,
+                        const AF_RANDOM_DIST dist, const uintl seed,
+                        const uintl counter) {
+    T *const optr         = out.get();
+    const T *const p0     = param0.get();
+    const T *const p1     = param1.get();
+    const size_t elements = out.dims().elements();
+
+    auto generate = [&](size_t first, size_t last) {
+        const size_t end = std::min(last * RANDOM_DIST_BLOCK, elements);
+        for (size_t i = first * RANDOM_DIST_BLOCK; i < end; ++i) {
+            PhiloxElementStream<T> gen(seed, counter, i);
+            optr[i] = common::sampleDistribution(gen, dist, p0[i], p1[i]);
+        }
+    };
+    generateBlocks(divup(elements, RANDOM_DIST_BLOCK), RANDOM_DIST_BLOCK,
+                   generate);
+}
+
+}  // namespace kernel
+}  // namespace cpu
@@ -16,6 +16,8 @@
 #include <kernel/random_engine_mersenne.hpp>
 #include <kernel/random_engine_philox.hpp>
 #include <kernel/random_engine_threefry.hpp>
+#include <platform.hpp>
+#include <thread_pool.hpp>
 #include <types.hpp>
 
 #include <algorithm>
@@ -28,6 +30,11 @@ using std::memcpy;
 namespace cpu {
 namespace kernel {
 // Utils
+//
+// The factors of the conversions below are powers of two, so the products
+// are exact and a multiplication followed by an addition rounds like the
+// fused multiply-add of Random123. Unlike fmaf, it is vectorized on targets
+// without FMA instructions.
 static const double PI_VAL =
     3.1415926535897932384626433832795028841971693993751058209749445923078164;
 
@@ -55,7 +62,7 @@ float getFloat01(uint *val, uint index) {
          (static_cast<float>(std::numeric_limits<unsigned int>::max()) +
           (1.0f)));
     constexpr float half_factor = ((0.5f) * factor);
-    return fmaf(val[index], factor, half_factor);
+    return static_cast<float>(val[index]) * factor + half_factor;
 }
 
 // Generates rationals in (-1, 1]
@@ -66,14 +73,14 @@ static float getFloatNegative11(uint *val, uint index) {
          (static_cast<double>(std::numeric_limits<int>::max()) + (1.0)));
     constexpr float half_factor = ((0.5f) * factor);
 
-    return fmaf(static_cast<float>(val[index]), factor, half_factor);
+    return static_cast<float>(val[index]) * factor + half_factor;
 }
 
 // Generates rationals in [0, 1)
 common::half getHalf01(uint *val, uint index) {
     float v = val[index >> 1U] >> (16U * (index & 1U)) & 0x0000ffff;
     return static_cast<common::half>(
-        fmaf(v, unsigned_half_factor, unsigned_half_half_factor));
+        v * unsigned_half_factor + unsigned_half_half_factor);
 }
 
 // Generates rationals in (-1, 1]
@@ -84,7 +91,7 @@ static common::half getHalfNegative11(uint *val, uint index) {
         ((1.0f) / (std::numeric_limits<short>::max() + (1.0f)));
     constexpr float half_factor = ((0.5f) * factor);
 
-    return static_cast<common::half>(fmaf(v, factor, half_factor));
+    return static_cast<common::half>(v * factor + half_factor);
 }
 
 // Generates rationals in [0, 1)
@@ -94,19 +101,21 @@ double getDouble01(uint *val, uint index) {
         ((1.0) / (std::numeric_limits<unsigned long long>::max() +
                   static_cast<long double>(1.0l)));
     constexpr double half_factor((0.5) * factor);
-    return fma(v, factor, half_factor);
+    return static_cast<double>(v) * factor + half_factor;
 }
 
 template<>
 char transform<char>(uint *val, uint index) {
-    char v = val[index >> 2] >> (8 << (index & 3));
+    // Shifts by 32 bits or more are undefined, so the shift is masked like
+    // the x86 instruction which produced these values
+    char v = val[index >> 2] >> ((8U << (index & 3U)) & 31U);
     v      = (v & 0x1) ? 1 : 0;
     return v;
 }
 
 template<>
 uchar transform<uchar>(uint *val, uint index) {
-    uchar v = val[index >> 2] >> (index << 3);
+    uchar v = val[index >> 2] >> ((index & 3U) << 3U);
     return v;
 }
 
@@ -153,7 +162,7 @@ template<>
 common::half transform<common::half>(uint *val, uint index) {
     float v = val[index >> 1U] >> (16U * (index & 1U)) & 0x0000ffff;
     return static_cast<common::half>(
-        1.f - fmaf(v, unsigned_half_factor, unsigned_half_half_factor));
+        1.f - (v * unsigned_half_factor + unsigned_half_half_factor));
 }
 
 // Generates rationals in [-1, 1)
@@ -163,10 +172,38 @@ double getDoubleNegative11(uint *val, uint index) {
     constexpr double signed_factor =
         ((1.0l) / (std::numeric_limits<long long>::max() + (1.0l)));
     constexpr double half_factor = ((0.5) * signed_factor);
-    return fma(v, signed_factor, half_factor);
+    return static_cast<double>(v) * signed_factor + half_factor;
+}
+
+/// The smallest number of elements generated by one task of the thread pool
+constexpr size_t RANDOM_MIN_TASK_ELEMENTS = 1 << 16;
+
+/// Splits \p blocks blocks of \p blockElements elements into ranges and
+/// calls func(first, last) for each range on the thread pool. The numbers of
+/// a counter based generator only depend on their position, so the ranges
+/// can be generated in any order.
+template<typename F>
+void generateBlocks(const size_t blocks, const size_t blockElements, F func) {
+    if (blocks == 0) { return; }
+    thread_pool &pool    = getThreadPool();
+    const size_t ntasks  = std::max<size_t>(
+        1, std::min({static_cast<size_t>(pool.size()), blocks,
+                     blocks * blockElements / RANDOM_MIN_TASK_ELEMENTS}));
+    const size_t perTask = divup(blocks, ntasks);
+    pool.run(static_cast<int>(ntasks), [&](int task) {
+        const size_t first = task * perTask;
+        const size_t last  = std::min(first + perTask, blocks);
+        if (first < last) { func(first, last); }
+    });
+}
+
+/// Sets ctr to the 64 bit counter \p counter plus \p offset
+inline void addCounter(uint ctr[2], const uintl counter, const uintl offset) {
+    const uintl sum = counter + offset;
+    ctr[0]          = static_cast<uint>(sum);
+    ctr[1]          = static_cast<uint>(sum >> 32);
 }
 
-#define MAX_RESET_CTR_VAL 64
 #define WRITE_STRIDE 256
 
 // This implementation aims to emulate the corresponding method in the CUDA
@@ -177,71 +214,101 @@ double getDoubleNegative11(uint *val, uint index) {
 // ELEMS_PER_ITER correspond to elementsPerBlock in the CUDA backend, so each
 // "iter" (iteration) here correspond to a CUDA thread block doing its work.
 // This change was prompted by issue #2429
+//
+// The emulated CUDA threads of an iteration are encrypted PHILOX_LANES at a
+// time, and the iterations are distributed over the thread pool.
 template<typename T>
 void philoxUniform(T *out, size_t elements, const uintl seed, uintl counter) {
-    uint hi  = seed >> 32;
-    uint lo  = seed;
-    uint hic = counter >> 32;
-    uint loc = counter;
+    const uint hi  = seed >> 32;
+    const uint lo  = seed;
+    const uint hic = counter >> 32;
+    const uint loc = counter;
 
-    constexpr size_t RESET_CTR = MAX_RESET_CTR_VAL / sizeof(T);
     constexpr size_t ELEMS_PER_ITER =
         WRITE_STRIDE * 4 * sizeof(uint) / sizeof(T);
-
-    int num_iters = divup(elements, ELEMS_PER_ITER);
-    size_t len    = num_iters * ELEMS_PER_ITER;
-
     constexpr size_t NUM_WRITES = 16 / sizeof(T);
-    for (size_t iter = 0; iter < len; iter += ELEMS_PER_ITER) {
-        for (size_t i = 0; i < WRITE_STRIDE; i += RESET_CTR) {
-            for (size_t j = 0; j < RESET_CTR; ++j) {
-                // first_write_idx is the first of the 4 locations that will
-                // be written to
-                uintptr_t first_write_idx = iter + i + j;
+    static_assert(WRITE_STRIDE % PHILOX_LANES == 0,
+                  "The emulated CUDA threads must fill the lanes");
+
+    auto generate = [&](size_t first, size_t last) {
+        const uint key[2] = {lo, hi};
+        uint ctr[4][PHILOX_LANES];
+        uint val[PHILOX_LANES][4];
+        for (size_t iter = first * ELEMS_PER_ITER;
+             iter < last * ELEMS_PER_ITER; iter += ELEMS_PER_ITER) {
+            for (size_t i = 0; i < WRITE_STRIDE; i += PHILOX_LANES) {
+                // first_write_idx is the first of the locations that will
+                // be written to by each emulated CUDA thread
+                const size_t first_write_idx = iter + i;
                 if (first_write_idx >= elements) { break; }
 
-                // Recalculate key and ctr to emulate how the CUDA backend
-                // calculates these per thread
-                uint key[2] = {lo, hi};
-                uint ctr[4] = {loc + (uint)first_write_idx, 0, 0, 0};
-                ctr[1]      = hic + (ctr[0] < loc);
-                ctr[2]      = (ctr[1] < hic);
-                philox(key, ctr);
+                // Recalculate ctr to emulate how the CUDA backend calculates
+                // it per thread
+                for (int l = 0; l < PHILOX_LANES; ++l) {
+                    ctr[0][l] = loc + static_cast<uint>(first_write_idx + l);
+                    ctr[1][l] = hic + (ctr[0][l] < loc);
+                    ctr[2][l] = (ctr[1][l] < hic);
+                    ctr[3][l] = 0;
+                }
+                philoxLanes(key, ctr);
+                for (int l = 0; l < PHILOX_LANES; ++l) {
+                    for (int w = 0; w < 4; ++w) { val[l][w] = ctr[w][l]; }
+                }
 
-                // Use the same ctr array for each of the 4 locations,
-                // but each of the location gets a different ctr value
+                // Each of the locations of a thread gets a different value
+                // of its counter
+                T *ptr = out + first_write_idx;
+                if (first_write_idx + ELEMS_PER_ITER - WRITE_STRIDE +
+                        PHILOX_LANES <=
+                    elements) {
+                    for (int l = 0; l < PHILOX_LANES; ++l) {
+                        for (size_t buf_idx = 0; buf_idx < NUM_WRITES;
+                             ++buf_idx) {
+                            ptr[buf_idx * WRITE_STRIDE + l] =
+                                transform<T>(val[l], buf_idx);
+                        }
+                    }
+                    continue;
+                }
                 for (size_t buf_idx = 0; buf_idx < NUM_WRITES; ++buf_idx) {
-                    size_t out_idx = iter + buf_idx * WRITE_STRIDE + i + j;
-                    if (out_idx < elements) {
-                        out[out_idx] = transform<T>(ctr, buf_idx);
+                    for (int l = 0; l < PHILOX_LANES; ++l) {
+                        if (first_write_idx + buf_idx * WRITE_STRIDE + l <
+                            elements) {
+                            ptr[buf_idx * WRITE_STRIDE + l] =
+                                transform<T>(val[l], buf_idx);
+                        }
                     }
                 }
             }
         }
-    }
+    };
+    generateBlocks(divup(elements, ELEMS_PER_ITER), ELEMS_PER_ITER, generate);
 }
 
-#undef MAX_RESET_CTR_VAL
 #undef WRITE_STRIDE
 
 template<typename T>
 void threefryUniform(T *out, size_t elements, const uintl seed, uintl counter) {
-    uint hi     = seed >> 32;
-    uint lo     = seed;
-    uint hic    = counter >> 32;
-    uint loc    = counter;
-    uint key[2] = {lo, hi};
-    uint ctr[2] = {loc, hic};
-    uint val[2];
-
-    int reset = (2 * sizeof(uint)) / sizeof(T);
-    for (int i = 0; i < (int)elements; i += reset) {
-        threefry(key, ctr, val);
-        ++ctr[0];
-        ctr[1] += (ctr[0] == 0);
-        int lim = (reset < (int)(elements - i)) ? reset : (int)(elements - i);
-        for (int j = 0; j < lim; ++j) { out[i + j] = transform<T>(val, j); }
-    }
+    const uint hi = seed >> 32;
+    const uint lo = seed;
+
+    // Each block of values is generated from the counter plus its index
+    constexpr size_t reset = (2 * sizeof(uint)) / sizeof(T);
+    auto generate          = [&](size_t first, size_t last) {
+        uint key[2] = {lo, hi};
+        uint ctr[2];
+        uint val[2];
+        addCounter(ctr, counter, first);
+        T *const end = out + std::min(last * reset, elements);
+        for (T *ptr = out + first * reset; ptr < end; ptr += reset) {
+            threefry(key, ctr, val);
+            ++ctr[0];
+            ctr[1] += (ctr[0] == 0);
+            const size_t lim = std::min<size_t>(reset, end - ptr);
+            for (size_t j = 0; j < lim; ++j) { ptr[j] = transform<T>(val, j); }
+        }
+    };
+    generateBlocks(divup(elements, reset), reset, generate);
 }
 
 template<typename T>
@@ -282,6 +349,8 @@ void boxMullerTransform(uint val[4], common::half *temp) {
                              getHalf01(val, 7));
 }
 
+// Each block of values is encrypted from the output of the previous block, so
+// the blocks are generated sequentially
 template<typename T>
 void philoxNormal(T *out, size_t elements, const uintl seed, uintl counter) {
     uint hi     = seed >> 32;
@@ -303,27 +372,31 @@ void philoxNormal(T *out, size_t elements, const uintl seed, uintl counter) {
 
 template<typename T>
 void threefryNormal(T *out, size_t elements, const uintl seed, uintl counter) {
-    uint hi     = seed >> 32;
-    uint lo     = seed;
-    uint hic    = counter >> 32;
-    uint loc    = counter;
-    uint key[2] = {lo, hi};
-    uint ctr[2] = {loc, hic};
-    uint val[4];
-    T temp[(4 * sizeof(uint)) / sizeof(T)];
-
-    int reset = (4 * sizeof(uint)) / sizeof(T);
-    for (int i = 0; i < (int)elements; i += reset) {
-        threefry(key, ctr, val);
-        ++ctr[0];
-        ctr[1] += (ctr[0] == 0);
-        threefry(key, ctr, val + 2);
-        ++ctr[0];
-        ctr[1] += (ctr[0] == 0);
-        boxMullerTransform(val, temp);
-        int lim = (reset < (int)(elements - i)) ? reset : (int)(elements - i);
-        for (int j = 0; j < lim; ++j) { out[i + j] = temp[j]; }
-    }
+    const uint hi = seed >> 32;
+    const uint lo = seed;
+
+    // Each block of values is generated from two consecutive counters
+    constexpr size_t reset = (4 * sizeof(uint)) / sizeof(T);
+    auto generate          = [&](size_t first, size_t last) {
+        uint key[2] = {lo, hi};
+        uint ctr[2];
+        uint val[4];
+        T temp[reset];
+        addCounter(ctr, counter, 2 * first);
+        for (size_t i = first * reset; i < std::min(last * reset, elements);
+             i += reset) {
+            threefry(key, ctr, val);
+            ++ctr[0];
+            ctr[1] += (ctr[0] == 0);
+            threefry(key, ctr, val + 2);
+            ++ctr[0];
+            ctr[1] += (ctr[0] == 0);
+            boxMullerTransform(val, temp);
+            const size_t lim = std::min(reset, elements - i);
+            for (size_t j = 0; j < lim; ++j) { out[i + j] = temp[j]; }
+        }
+    };
+    generateBlocks(divup(elements, reset), reset, generate);
 }
 
 template<typename T>
@@ -12,55 +12,279 @@
 #include <common/Binary.hpp>
 #include <common/Transform.hpp>
 #include <common/half.hpp>
+#include <convert_half.hpp>
+#include <kernel/lines.hpp>
+#include <math.hpp>
+#include <types.hpp>
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
 
-template<af_op_t op, typename Ti, typename To, int D>
-struct reduce_dim {
-    void operator()(Param<To> out, const dim_t outOffset, CParam<Ti> in,
-                    const dim_t inOffset, const int dim, bool change_nan,
-                    double nanval) {
-        static const int D1 = D - 1;
-        reduce_dim<op, Ti, To, D1> reduce_dim_next;
+/// The number of interleaved accumulators of LineReducer
+constexpr int REDUCE_LANES = 8;
+
+/// Reduces the values of a line in a fixed order.
+///
+/// The values of each block of LINE_BLOCK_ELEMENTS values are accumulated
+/// in REDUCE_LANES interleaved lanes, which the compiler vectorizes, and the
+/// lanes are combined pairwise. The results of the blocks are then combined
+/// in order. The order only depends on the positions of the values in the
+/// line, so it does not change with the number of threads, or with the size
+/// of the chunks passed to add.
+///
+/// Float sums use Kahan summation in the lanes and across the blocks when
+/// \p compensated is true.
+template<af_op_t op, typename Ti, typename To>
+class LineReducer {
+    using T = compute_t<To>;
+    static constexpr bool CanCompensate =
+        op == af_add_t && std::is_floating_point<T>::value;
 
-        const af::dim4 ostrides = out.strides();
-        const af::dim4 istrides = in.strides();
-        const af::dim4 odims    = out.dims();
+    common::Transform<data_t<Ti>, T, op> m_transform;
+    common::Binary<T, op> m_reduce;
+    const bool m_changeNan;
+    const T m_nanval;
+    const bool m_compensated;
 
-        for (dim_t i = 0; i < odims[D1]; i++) {
-            reduce_dim_next(out, outOffset + i * ostrides[D1], in,
-                            inOffset + i * istrides[D1], dim, change_nan,
-                            nanval);
+    T m_lanes[REDUCE_LANES];
+    T m_errors[REDUCE_LANES];
+    T m_total;
+    T m_totalError;
+    /// The number of values added to the current block
+    dim_t m_count = 0;
+
+    template<typename V>
+    T value(const V &v) {
+        T val = m_transform(static_cast<data_t<Ti>>(v));
+        if (m_changeNan) { val = IS_NAN(val) ? m_nanval : val; }
+        return val;
+    }
+
+    /// The value of a half input which was converted to float by add. The
+    /// conversion is exact, so the transform of the float gives the same value
+    T value(const float &v) {
+        T val = common::Transform<float, T, op>()(v);
+        if (m_changeNan) { val = IS_NAN(val) ? m_nanval : val; }
+        return val;
+    }
+
+    static void kahanAdd(T &sum, T &error, const T val) {
+        const T y = val - error;
+        const T t = sum + y;
+        error     = (t - sum) - y;
+        sum       = t;
+    }
+
+    template<bool Kahan>
+    void accumulate(const int lane, const T val) {
+        if (Kahan) {
+            kahanAdd(m_lanes[lane], m_errors[lane], val);
+        } else {
+            m_lanes[lane] = m_reduce(val, m_lanes[lane]);
         }
     }
-};
 
-template<af_op_t op, typename Ti, typename To>
-struct reduce_dim<op, Ti, To, 0> {
-    common::Transform<data_t<Ti>, compute_t<To>, op> transform;
-    common::Binary<compute_t<To>, op> reduce;
-    void operator()(Param<To> out, const dim_t outOffset, CParam<Ti> in,
-                    const dim_t inOffset, const int dim, bool change_nan,
-                    double nanval) {
-        const af::dim4 istrides = in.strides();
-        const af::dim4 idims    = in.dims();
+    template<bool Kahan, typename V>
+    void addToLanes(const V *ptr, const dim_t stride, const dim_t n) {
+        int lane = static_cast<int>(m_count % REDUCE_LANES);
+        dim_t i  = 0;
+        for (; i < n && lane != 0; ++i, lane = (lane + 1) % REDUCE_LANES) {
+            accumulate<Kahan>(lane, value(ptr[i * stride]));
+        }
+        for (; i + REDUCE_LANES <= n; i += REDUCE_LANES) {
+            for (int l = 0; l < REDUCE_LANES; ++l) {
+                accumulate<Kahan>(l, value(ptr[(i + l) * stride]));
+            }
+        }
+        for (; i < n; ++i, ++lane) {
+            accumulate<Kahan>(lane, value(ptr[i * stride]));
+        }
+        m_count += n;
+    }
+
+    void resetLanes() {
+        for (int l = 0; l < REDUCE_LANES; ++l) {
+            m_lanes[l]  = common::Binary<T, op>::init();
+            m_errors[l] = scalar<T>(0);
+        }
+        m_count = 0;
+    }
+
+    /// Combines the lanes of the current block pairwise
+    T blockValue() {
+        T vals[REDUCE_LANES];
+        for (int l = 0; l < REDUCE_LANES; ++l) {
+            vals[l] = CanCompensate && m_compensated ? m_lanes[l] - m_errors[l]
+                                                     : m_lanes[l];
+        }
+        for (int width = REDUCE_LANES / 2; width > 0; width /= 2) {
+            for (int l = 0; l < width; ++l) {
+                vals[l] = m_reduce(vals[l + width], vals[l]);
+            }
+        }
+        return vals[0];
+    }
 
-        data_t<To> *const outPtr      = out.get() + outOffset;
-        data_t<Ti> const *const inPtr = in.get() + inOffset;
-        dim_t stride                  = istrides[dim];
+   public:
+    LineReducer(bool change_nan, double nanval, bool compensated)
+        : m_changeNan(change_nan)
+        , m_nanval(scalar<T>(nanval))
+        , m_compensated(compensated)
+        , m_total(common::Binary<T, op>::init())
+        , m_totalError(scalar<T>(0)) {
+        resetLanes();
+    }
+
+    /// Adds the \p n values ptr[0], ptr[stride], ... to the line
+    template<typename V>
+    void add(const V *ptr, const dim_t stride, dim_t n) {
+        while (n > 0) {
+            if (m_count == LINE_BLOCK_ELEMENTS) { addBlock(finishBlock()); }
+            const dim_t len = std::min(n, LINE_BLOCK_ELEMENTS - m_count);
+            if (CanCompensate && m_compensated) {
+                addToLanes<true>(ptr, stride, len);
+            } else {
+                addToLanes<false>(ptr, stride, len);
+            }
+            ptr += len * stride;
+            n -= len;
+        }
+    }
 
-        compute_t<To> out_val = common::Binary<compute_t<To>, op>::init();
-        for (dim_t i = 0; i < idims[dim]; i++) {
-            compute_t<To> in_val = transform(inPtr[i * stride]);
-            if (change_nan) in_val = IS_NAN(in_val) ? nanval : in_val;
-            out_val = reduce(in_val, out_val);
+    /// Adds the \p n values ptr[0], ptr[stride], ... to the line
+    ///
+    /// Contiguous half values are converted to float in chunks with the
+    /// vectorized conversions before they are accumulated.
+    void add(const common::half *ptr, const dim_t stride, dim_t n) {
+        if (stride != 1) {
+            add<common::half>(ptr, stride, n);
+            return;
         }
+        constexpr dim_t CHUNK = 256;
+        float vals[CHUNK];
+        while (n > 0) {
+            const dim_t len = std::min(n, CHUNK);
+            convertHalfToFloat(vals, ptr, len);
+            add<float>(vals, 1, len);
+            ptr += len;
+            n -= len;
+        }
+    }
 
-        *outPtr = data_t<To>(out_val);
+    /// Returns the reduction of the values added to the current block, which
+    /// holds at most LINE_BLOCK_ELEMENTS values, and starts a new block
+    T finishBlock() {
+        const T val = blockValue();
+        resetLanes();
+        return val;
+    }
+
+    /// Adds the value of a block returned by finishBlock to the line. The
+    /// blocks must be added in order.
+    void addBlock(const T val) {
+        if (CanCompensate && m_compensated) {
+            kahanAdd(m_total, m_totalError, val);
+        } else {
+            m_total = m_reduce(val, m_total);
+        }
+    }
+
+    /// Returns the reduction of the line
+    T result() {
+        if (m_count > 0) { addBlock(finishBlock()); }
+        return m_total;
     }
 };
 
+/// Reduces \p in along dimension \p dim.
+///
+/// Each line is split into blocks of LINE_BLOCK_ELEMENTS values. The blocks
+/// of all the lines are reduced by the thread pool and the blocks of each
+/// line are then combined in order, so long lines are split across the
+/// threads even when there are only a few of them.
+template<af_op_t op, typename Ti, typename To>
+void reduce(Param<To> out, CParam<Ti> in, const int dim, bool change_nan,
+            double nanval, bool compensated) {
+    using T                 = compute_t<To>;
+    const af::dim4 idims    = in.dims();
+    const af::dim4 istrides = in.strides();
+    const af::dim4 odims    = out.dims();
+    const af::dim4 ostrides = out.strides();
+
+    const dim_t n      = idims[dim];
+    const dim_t stride = istrides[dim];
+    const dim_t nlines = lineCount(odims, dim);
+    const dim_t blocks = std::max<dim_t>(1, divup(n, LINE_BLOCK_ELEMENTS));
+
+    // The value of each block in the order of the lines
+    std::vector<T> values(nlines * blocks);
+    parallelFor(nlines * blocks, std::min(n, LINE_BLOCK_ELEMENTS),
+                [&](dim_t first, dim_t last) {
+                    for (dim_t unit = first; unit < last; ++unit) {
+                        const dim_t line = unit / blocks;
+                        const dim_t begin =
+                            (unit % blocks) * LINE_BLOCK_ELEMENTS;
+                        const data_t<Ti> *ptr =
+                            in.get() + lineOffset(idims, dim, line, istrides) +
+                            begin * stride;
+                        LineReducer<op, Ti, To> reducer(change_nan, nanval,
+                                                        compensated);
+                        reducer.add(ptr, stride,
+                                    std::min(n - begin, LINE_BLOCK_ELEMENTS));
+                        values[unit] = reducer.finishBlock();
+                    }
+                });
+
+    data_t<To> *const outPtr = out.get();
+    for (dim_t line = 0; line < nlines; ++line) {
+        LineReducer<op, Ti, To> reducer(change_nan, nanval, compensated);
+        for (dim_t b = 0; b < blocks && b * LINE_BLOCK_ELEMENTS < n; ++b) {
+            reducer.addBlock(values[line * blocks + b]);
+        }
+        outPtr[lineOffset(odims, dim, line, ostrides)] =
+            data_t<To>(reducer.result());
+    }
+}
+
+/// Reduces all the values of \p in. The values are ordered like the
+/// elements of a linear array, and split into blocks like a single line.
+template<af_op_t op, typename Ti, typename To>
+void reduce_all(compute_t<To> *out, CParam<Ti> in, bool change_nan,
+                double nanval, bool compensated) {
+    using T                = compute_t<To>;
+    const af::dim4 dims    = in.dims();
+    const af::dim4 strides = in.strides();
+    const dim_t elements   = dims.elements();
+    const dim_t blocks     = divup(elements, LINE_BLOCK_ELEMENTS);
+
+    std::vector<T> values(blocks);
+    parallelFor(blocks, LINE_BLOCK_ELEMENTS, [&](dim_t first, dim_t last) {
+        for (dim_t b = first; b < last; ++b) {
+            LineReducer<op, Ti, To> reducer(change_nan, nanval, compensated);
+            dim_t e         = b * LINE_BLOCK_ELEMENTS;
+            const dim_t end = std::min(e + LINE_BLOCK_ELEMENTS, elements);
+            // The block is made of segments of the lines along dim 0
+            while (e < end) {
+                const dim_t i   = e % dims[0];
+                const dim_t len = std::min(dims[0] - i, end - e);
+                const dim_t off =
+                    i + lineOffset(dims, 0, e / dims[0], strides);
+                reducer.add(in.get() + off, 1, len);
+                e += len;
+            }
+            values[b] = reducer.finishBlock();
+        }
+    });
+
+    LineReducer<op, Ti, To> reducer(change_nan, nanval, compensated);
+    for (const T &val : values) { reducer.addBlock(val); }
+    *out = reducer.result();
+}
+
 template<typename Tk>
 void n_reduced_keys(Param<Tk> okeys, int *n_reduced, CParam<Tk> keys) {
     const af::dim4 kdims = keys.dims();
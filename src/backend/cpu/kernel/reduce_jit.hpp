@@ -0,0 +1,144 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <common/Binary.hpp>
+#include <common/Transform.hpp>
+#include <common/dispatch.hpp>
+#include <common/half.hpp>
+#include <jit/Node.hpp>
+#include <kernel/Array.hpp>
+#include <kernel/reduce.hpp>
+#include <platform.hpp>
+#include <thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace cpu {
+namespace kernel {
+
+/// Evaluates a JIT tree one row at a time and passes each chunk of
+/// jit::VECTOR_LENGTH values of a row to \p reduce_chunk.
+///
+/// The rows are split across the thread pool when \p parallel is true.
+/// Otherwise they are processed in order on the calling thread.
+///
+/// \param[in] node         The root of the tree
+/// \param[in] dims         The dimensions of the result of the tree
+/// \param[in] parallel     Splits the rows across the thread pool
+/// \param[in] reduce_chunk Called as reduce_chunk(row, values, lim) for
+///                         each chunk of a row in order
+template<typename Ti, typename F>
+void reduceJitRows(common::Node_ptr node, const af::dim4 dims,
+                   const bool parallel, F reduce_chunk) {
+    common::Node_map_t nodes;
+    common::Node_hash_map_t hashes;
+    std::vector<common::Node *> full_nodes;
+    std::vector<common::Node_ids> ids;
+    const int root_id = node->getNodesMap(nodes, full_nodes, ids, hashes);
+
+    const int dim0        = static_cast<int>(dims[0]);
+    const dim_t nrows     = dims[1] * dims[2] * dims[3];
+    const dim_t task_rows =
+        parallel ? std::max<dim_t>(1, getJitMinTaskElements() /
+                                          std::max<dim_t>(dims[0], 1))
+                 : std::max<dim_t>(nrows, 1);
+    const int ntasks = static_cast<int>(divup(nrows, task_rows));
+
+    thread_pool &pool  = getThreadPool();
+    const int nworkers = std::min(pool.size(), ntasks);
+
+    // The original tree can only be evaluated if no common subexpressions
+    // were merged by getNodesMap
+    const bool use_original = nodes.size() == full_nodes.size();
+
+    std::atomic<int> next_task(0);
+    auto worker = [&](int worker_id) {
+        std::vector<common::Node_ptr> clones;
+        std::vector<common::Node *> wnodes =
+            worker_id == 0 && use_original
+                ? full_nodes
+                : cloneTree(full_nodes, ids, clones);
+        const auto *root = reinterpret_cast<TNode<Ti> *>(wnodes[root_id]);
+
+        for (int task = next_task++; task < ntasks; task = next_task++) {
+            const dim_t row_begin = task * task_rows;
+            const dim_t row_end   = std::min(row_begin + task_rows, nrows);
+
+            for (dim_t row = row_begin; row < row_end; row++) {
+                int y = static_cast<int>(row % dims[1]);
+                int z = static_cast<int>((row / dims[1]) % dims[2]);
+                int w = static_cast<int>(row / (dims[1] * dims[2]));
+                for (int x = 0; x < dim0; x += jit::VECTOR_LENGTH) {
+                    int lim = std::min(jit::VECTOR_LENGTH, dim0 - x);
+                    for (auto n : wnodes) { n->calc(x, y, z, w, lim); }
+                    reduce_chunk(row, root->m_val.data(), lim);
+                }
+            }
+        }
+    };
+
+    if (nworkers <= 1) {
+        worker(0);
+    } else {
+        pool.run(nworkers, worker);
+    }
+}
+
+/// Reduces a JIT tree along the first dimension without storing the result
+/// of the tree. Each chunk of a row is reduced while it is in cache. The
+/// values are reduced in the same order as kernel::reduce.
+template<af_op_t op, typename Ti, typename To>
+void reduce_jit_dim0(Param<To> out, common::Node_ptr node,
+                     const af::dim4 idims, bool change_nan, double nanval,
+                     bool compensated) {
+    const af::dim4 odims    = out.dims();
+    const af::dim4 ostrides = out.strides();
+    data_t<To> *const outPtr = out.get();
+
+    // The rows are split between the workers so each row is reduced by a
+    // single thread
+    const dim_t nrows = odims[1] * odims[2] * odims[3];
+    std::vector<LineReducer<op, Ti, To>> acc(
+        nrows, LineReducer<op, Ti, To>(change_nan, nanval, compensated));
+
+    reduceJitRows<Ti>(node, idims, true,
+                      [&](dim_t row, const compute_t<Ti> *vals, int lim) {
+                          acc[row].add(vals, 1, lim);
+                      });
+
+    for (dim_t row = 0; row < nrows; row++) {
+        dim_t y = row % odims[1];
+        dim_t z = (row / odims[1]) % odims[2];
+        dim_t w = row / (odims[1] * odims[2]);
+        outPtr[y * ostrides[1] + z * ostrides[2] + w * ostrides[3]] =
+            data_t<To>(acc[row].result());
+    }
+}
+
+/// Reduces all the values of a JIT tree without storing the result of the
+/// tree. The values are reduced in order on a single thread, in the same
+/// order as kernel::reduce_all reduces an evaluated array.
+template<af_op_t op, typename Ti, typename To>
+void reduce_all_jit(compute_t<To> *out, common::Node_ptr node,
+                    const af::dim4 idims, bool change_nan, double nanval,
+                    bool compensated) {
+    LineReducer<op, Ti, To> reducer(change_nan, nanval, compensated);
+    reduceJitRows<Ti>(node, idims, false,
+                      [&](dim_t, const compute_t<Ti> *vals, int lim) {
+                          reducer.add(vals, 1, lim);
+                      });
+    *out = reducer.result();
+}
+
+}  // namespace kernel
+}  // namespace cpu
@@ -0,0 +1,107 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <common/region_stats.hpp>
+#include <types.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace cpu {
+namespace kernel {
+
+/// The sums of the coordinates of the pixels of a label. The sums are
+/// integers, so they are exact.
+struct RegionSums {
+    uint64_t area = 0;
+    uint64_t r    = 0;
+    uint64_t c    = 0;
+    uint64_t rr   = 0;
+    uint64_t cc   = 0;
+    uint64_t rc   = 0;
+    uint64_t r0   = 0;
+    uint64_t c0   = 0;
+    uint64_t r1   = 0;
+    uint64_t c1   = 0;
+};
+
+/// Computes the properties of the labels 1 to out.dims(1) of \p labels (see
+/// common::REGION_PROP_COUNT) in one pass over the label image
+template<typename T>
+void regionProps(Param<float> out, CParam<T> labels) {
+    const af::dim4 dims    = labels.dims();
+    const af::dim4 strides = labels.strides();
+    const dim_t nlabels    = out.dims(1);
+    const dim_t ostride    = out.strides(1);
+
+    std::vector<RegionSums> sums(nlabels);
+    for (dim_t j = 0; j < dims[1]; ++j) {
+        const T *col = labels.get() + j * strides[1];
+        for (dim_t i = 0; i < dims[0]; ++i) {
+            const dim_t label = static_cast<dim_t>(col[i]);
+            if (label < 1 || label > nlabels) { continue; }
+
+            RegionSums &s = sums[label - 1];
+            if (s.area++ == 0) {
+                s.r0 = s.r1 = i;
+                s.c0 = j;
+            }
+            // The pixels are visited in column major order, so the last
+            // column is the current one
+            s.r0 = std::min<uint64_t>(s.r0, i);
+            s.r1 = std::max<uint64_t>(s.r1, i);
+            s.c1 = j;
+            s.r += i;
+            s.c += j;
+            s.rr += i * i;
+            s.cc += j * j;
+            s.rc += i * j;
+        }
+    }
+
+    for (dim_t l = 0; l < nlabels; ++l) {
+        const RegionSums &s = sums[l];
+        float *optr         = out.get() + l * ostride;
+        std::fill(optr, optr + common::REGION_PROP_COUNT, 0.f);
+        if (s.area == 0) { continue; }
+
+        // The second order sums relative to the first row and column of the
+        // bounding box are exact, and small enough for the central moments
+        // to be computed in floating point without cancellation
+        const uint64_t a   = s.area;
+        const uint64_t sr  = s.r - a * s.r0;
+        const uint64_t sc  = s.c - a * s.c0;
+        const uint64_t srr = s.rr - 2 * s.r0 * s.r + a * s.r0 * s.r0;
+        const uint64_t scc = s.cc - 2 * s.c0 * s.c + a * s.c0 * s.c0;
+        const uint64_t src = s.rc - s.r0 * s.c - s.c0 * s.r + a * s.r0 * s.c0;
+
+        const double mr = static_cast<double>(sr) / a;
+        const double mc = static_cast<double>(sc) / a;
+
+        optr[0]  = static_cast<float>(a);
+        optr[1]  = static_cast<float>(s.r0 + mr);
+        optr[2]  = static_cast<float>(s.c0 + mc);
+        optr[3]  = static_cast<float>(s.r0);
+        optr[4]  = static_cast<float>(s.c0);
+        optr[5]  = static_cast<float>(s.r1);
+        optr[6]  = static_cast<float>(s.c1);
+        optr[7]  = static_cast<float>(s.r);
+        optr[8]  = static_cast<float>(s.c);
+        optr[9]  = static_cast<float>(s.rc);
+        optr[10] = static_cast<float>(srr - sr * mr);
+        optr[11] = static_cast<float>(scc - sc * mc);
+        optr[12] = static_cast<float>(src - sr * mc);
+    }
+}
+
+}  // namespace kernel
+}  // namespace cpu
@@ -9,160 +9,272 @@
 
 #pragma once
 #include <Param.hpp>
-#include <memory.hpp>
-#include <map>
-#include <set>
+#include <common/dispatch.hpp>
+#include <common/region_stats.hpp>
+#include <platform.hpp>
+#include <thread_pool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
 
-template<typename T>
-class LabelNode {
-   private:
-    T label;
-    T minLabel;
-    unsigned rank;
-    LabelNode* parent;
+/// The smallest number of pixels labelled by one task of the thread pool
+constexpr dim_t REGIONS_MIN_TASK_ELEMENTS = 1 << 16;
+
+using RegionStats = std::array<unsigned, common::REGION_STAT_COUNT>;
+
+/// The parents of a disjoint set forest of pixels indexed by their linear
+/// index. The root of each set is its pixel with the smallest index, so the
+/// sets can be merged by any number of threads without locks.
+class PixelForest {
+    std::vector<std::atomic<unsigned>> m_parent;
 
    public:
-    LabelNode() : label(0), minLabel(0), rank(0), parent(this) {}
-    LabelNode(T label) : label(label), minLabel(label), rank(0), parent(this) {}
+    /// The parent of a root after the roots are labelled (see label)
+    static constexpr unsigned LABELLED = 1u << 31;
+
+    explicit PixelForest(dim_t size) : m_parent(size) {}
 
-    T getLabel() { return label; }
+    void makeSet(unsigned x) {
+        m_parent[x].store(x, std::memory_order_relaxed);
+    }
 
-    T getMinLabel() { return minLabel; }
+    /// Finds the root of \p x and halves the path to it. Paths only point
+    /// to ancestors, so the stores of concurrent finds do not conflict.
+    unsigned find(unsigned x) {
+        unsigned parent = m_parent[x].load(std::memory_order_relaxed);
+        while (parent != x) {
+            const unsigned grand =
+                m_parent[parent].load(std::memory_order_relaxed);
+            m_parent[x].store(grand, std::memory_order_relaxed);
+            x      = parent;
+            parent = grand;
+        }
+        return x;
+    }
 
-    LabelNode* getParent() { return parent; }
+    /// Merges the sets of \p x and \p y by linking the larger root to the
+    /// smaller one. Another thread may link the larger root first, in which
+    /// case the roots are found again.
+    void merge(unsigned x, unsigned y) {
+        for (;;) {
+            x = find(x);
+            y = find(y);
+            if (x == y) { return; }
+            if (x < y) { std::swap(x, y); }
+            unsigned expected = x;
+            if (m_parent[x].compare_exchange_weak(expected, y)) { return; }
+        }
+    }
 
-    unsigned getRank() { return rank; }
+    /// Points \p x at its root and returns the root
+    unsigned flatten(unsigned x) {
+        const unsigned root = find(x);
+        m_parent[x].store(root, std::memory_order_relaxed);
+        return root;
+    }
 
-    void setMinLabel(T l) { minLabel = l; }
+    /// Replaces the parent of root \p x with its label. Every other pixel of
+    /// the set must point at the root already (see flatten).
+    void label(unsigned x, unsigned l) {
+        m_parent[x].store(LABELLED | l, std::memory_order_relaxed);
+    }
 
-    void setParent(LabelNode* p) { parent = p; }
+    bool isRoot(unsigned x) const {
+        return m_parent[x].load(std::memory_order_relaxed) == x;
+    }
 
-    void setRank(unsigned r) { rank = r; }
+    /// Returns the label of a pixel after its set is labelled
+    unsigned getLabel(unsigned x) const {
+        unsigned parent = m_parent[x].load(std::memory_order_relaxed);
+        if (!(parent & LABELLED)) {
+            parent = m_parent[parent].load(std::memory_order_relaxed);
+        }
+        return parent & ~LABELLED;
+    }
 };
 
-template<typename T>
-static LabelNode<T>* find(LabelNode<T>* x) {
-    if (x->getParent() != x) x->setParent(find(x->getParent()));
-    return x->getParent();
+inline void addToStats(RegionStats &stats, unsigned row, unsigned col) {
+    if (stats[0]++ == 0) {
+        stats = {1, row, col, row, col};
+        return;
+    }
+    stats[1] = std::min(stats[1], row);
+    stats[2] = std::min(stats[2], col);
+    stats[3] = std::max(stats[3], row);
+    stats[4] = std::max(stats[4], col);
 }
 
-template<typename T>
-static void setUnion(LabelNode<T>* x, LabelNode<T>* y) {
-    LabelNode<T>* xRoot = find(x);
-    LabelNode<T>* yRoot = find(y);
-    if (xRoot == yRoot) return;
-
-    T xMinLabel = xRoot->getMinLabel();
-    T yMinLabel = yRoot->getMinLabel();
-    xRoot->setMinLabel(std::min(xMinLabel, yMinLabel));
-    yRoot->setMinLabel(std::min(xMinLabel, yMinLabel));
-
-    if (xRoot->getRank() < yRoot->getRank())
-        xRoot->setParent(yRoot);
-    else if (xRoot->getRank() > yRoot->getRank())
-        yRoot->setParent(xRoot);
-    else {
-        yRoot->setParent(xRoot);
-        xRoot->setRank(xRoot->getRank() + 1);
+inline void mergeStats(RegionStats &stats, const RegionStats &other) {
+    if (stats[0] == 0) {
+        stats = other;
+        return;
     }
+    stats[0] += other[0];
+    stats[1] = std::min(stats[1], other[1]);
+    stats[2] = std::min(stats[2], other[2]);
+    stats[3] = std::max(stats[3], other[3]);
+    stats[4] = std::max(stats[4], other[4]);
 }
 
+/// Labels the connected components of the non-zero pixels of \p in.
+///
+/// The columns of the image are split into strips which are labelled by
+/// the threads independently. The sets of the pixels on either side of the
+/// first column of each strip are then merged in parallel. The components
+/// are numbered in the order of their first pixel, so the labels never
+/// depend on the number of threads.
+///
+/// \param[out] out   The labels, zero for the background
+/// \param[in]  in    The binary image
+/// \param[in]  connectivity Whether the diagonal neighbours are connected
+/// \param[out] stats The statistics of each region, REGION_STAT_COUNT values
+///                   per region in the order of the labels (see
+///                   common::regionStats). Not computed if it is null.
 template<typename T>
-void regions(Param<T> out, CParam<char> in, af_connectivity connectivity) {
-    const af::dim4 inDims = in.dims();
-    const char* inPtr     = in.get();
-    T* outPtr             = out.get();
-
-    // Map labels
-    typedef typename std::unique_ptr<LabelNode<T>> UnqLabelPtr;
-    typedef typename std::map<T, UnqLabelPtr> LabelMap;
-    typedef typename LabelMap::iterator LabelMapIterator;
-
-    LabelMap lmap;
-
-    // Initial label
-    T label = (T)1;
-
-    for (int j = 0; j < (int)inDims[1]; j++) {
-        for (int i = 0; i < (int)inDims[0]; i++) {
-            int idx = j * inDims[0] + i;
-            if (inPtr[idx] != 0) {
-                std::vector<T> l;
-
-                // Test neighbors
-                if (i > 0 && outPtr[j * (int)inDims[0] + i - 1] > 0)
-                    l.push_back(outPtr[j * inDims[0] + i - 1]);
-                if (j > 0 && outPtr[(j - 1) * (int)inDims[0] + i] > 0)
-                    l.push_back(outPtr[(j - 1) * inDims[0] + i]);
-                if (connectivity == AF_CONNECTIVITY_8 && i > 0 && j > 0 &&
-                    outPtr[(j - 1) * inDims[0] + i - 1] > 0)
-                    l.push_back(outPtr[(j - 1) * inDims[0] + i - 1]);
-                if (connectivity == AF_CONNECTIVITY_8 &&
-                    i < (int)inDims[0] - 1 && j > 0 &&
-                    outPtr[(j - 1) * inDims[0] + i + 1] != 0)
-                    l.push_back(outPtr[(j - 1) * inDims[0] + i + 1]);
-
-                if (!l.empty()) {
-                    T minl = l[0];
-                    for (size_t k = 0; k < l.size(); k++) {
-                        minl                        = std::min(l[k], minl);
-                        LabelMapIterator currentMap = lmap.find(l[k]);
-                        LabelNode<T>* node          = currentMap->second.get();
-                        // Group labels of the same region under a disjoint set
-                        for (size_t m = k + 1; m < l.size(); m++)
-                            setUnion(node, lmap.find(l[m])->second.get());
-                    }
-                    // Set label to smallest neighbor label
-                    outPtr[idx] = minl;
-                } else {
-                    // Insert new label in map
-                    lmap.insert(std::make_pair(
-                        label, UnqLabelPtr(new LabelNode<T>(label))));
-                    outPtr[idx] = label++;
-                }
+void regions(Param<T> out, CParam<char> in, af_connectivity connectivity,
+             std::vector<unsigned> *stats) {
+    const af::dim4 dims     = in.dims();
+    const af::dim4 istrides = in.strides();
+    const af::dim4 ostrides = out.strides();
+    const char *inPtr       = in.get();
+    T *outPtr               = out.get();
+
+    const dim_t rows = dims[0];
+    const dim_t cols = dims[1];
+    const bool diag  = connectivity == AF_CONNECTIVITY_8;
+    if (rows * cols == 0) { return; }
+
+    auto isSet = [&](dim_t i, dim_t j) {
+        return inPtr[i * istrides[0] + j * istrides[1]] != 0;
+    };
+
+    thread_pool &pool = getThreadPool();
+    const dim_t ntasks =
+        std::max<dim_t>(1, std::min({static_cast<dim_t>(pool.size()), cols,
+                                     rows * cols / REGIONS_MIN_TASK_ELEMENTS}));
+    const dim_t stripCols = divup(cols, ntasks);
+    auto stripBegin       = [&](dim_t task) {
+        return std::min(task * stripCols, cols);
+    };
+
+    PixelForest forest(rows * cols);
+
+    // Merges a pixel with its neighbours in the previous row and column.
+    // minCol is the first column of the strip of the pixel.
+    auto mergeNeighbours = [&](dim_t i, dim_t j, dim_t minCol) {
+        const unsigned p = static_cast<unsigned>(j * rows + i);
+        if (i > 0 && isSet(i - 1, j)) { forest.merge(p, p - 1); }
+        if (j == minCol) { return; }
+        const unsigned left = p - static_cast<unsigned>(rows);
+        if (isSet(i, j - 1)) { forest.merge(p, left); }
+        if (diag && i > 0 && isSet(i - 1, j - 1)) {
+            forest.merge(p, left - 1);
+        }
+        if (diag && i + 1 < rows && isSet(i + 1, j - 1)) {
+            forest.merge(p, left + 1);
+        }
+    };
+
+    pool.run(static_cast<int>(ntasks), [&](int task) {
+        const dim_t first = stripBegin(task);
+        const dim_t last  = stripBegin(task + 1);
+        for (dim_t j = first; j < last; ++j) {
+            for (dim_t i = 0; i < rows; ++i) {
+                if (!isSet(i, j)) { continue; }
+                forest.makeSet(static_cast<unsigned>(j * rows + i));
+                mergeNeighbours(i, j, first);
             }
         }
+    });
+
+    if (ntasks > 1) {
+        pool.run(static_cast<int>(ntasks - 1), [&](int task) {
+            const dim_t j = stripBegin(task + 1);
+            if (j >= cols) { return; }
+            for (dim_t i = 0; i < rows; ++i) {
+                if (isSet(i, j)) { mergeNeighbours(i, j, j - 1); }
+            }
+        });
     }
 
-    std::set<T> removed;
+    // The roots of the sets are numbered in order, so each strip numbers
+    // its roots after the roots of the previous strips
+    std::vector<unsigned> firstLabel(ntasks + 1, 0);
+    pool.run(static_cast<int>(ntasks), [&](int task) {
+        unsigned count = 0;
+        for (dim_t j = stripBegin(task); j < stripBegin(task + 1); ++j) {
+            for (dim_t i = 0; i < rows; ++i) {
+                if (!isSet(i, j)) { continue; }
+                const unsigned p = static_cast<unsigned>(j * rows + i);
+                if (forest.flatten(p) == p) { count++; }
+            }
+        }
+        firstLabel[task + 1] = count;
+    });
+    for (dim_t t = 0; t < ntasks; ++t) { firstLabel[t + 1] += firstLabel[t]; }
 
-    for (int j = 0; j < (int)inDims[1]; j++) {
-        for (int i = 0; i < (int)inDims[0]; i++) {
-            int idx = j * (int)inDims[0] + i;
-            if (inPtr[idx] != 0) {
-                T l                         = outPtr[idx];
-                LabelMapIterator currentMap = lmap.find(l);
+    pool.run(static_cast<int>(ntasks), [&](int task) {
+        unsigned label = firstLabel[task];
+        for (dim_t j = stripBegin(task); j < stripBegin(task + 1); ++j) {
+            for (dim_t i = 0; i < rows; ++i) {
+                if (!isSet(i, j)) { continue; }
+                const unsigned p = static_cast<unsigned>(j * rows + i);
+                if (forest.isRoot(p)) { forest.label(p, ++label); }
+            }
+        }
+    });
 
-                if (currentMap != lmap.end()) {
-                    LabelNode<T>* node = currentMap->second.get();
+    const unsigned nregions = firstLabel[ntasks];
+    std::vector<RegionStats> regionStats;
+    // The regions which start in an earlier strip. Their statistics are
+    // added to the shared statistics after the strips are written.
+    std::vector<std::unordered_map<unsigned, RegionStats>> earlierStats;
+    if (stats) {
+        regionStats.assign(nregions, RegionStats{});
+        earlierStats.resize(ntasks);
+    }
 
-                    LabelNode<T>* nodeRoot = find(node);
-                    outPtr[idx]            = nodeRoot->getMinLabel();
+    pool.run(static_cast<int>(ntasks), [&](int task) {
+        for (dim_t j = stripBegin(task); j < stripBegin(task + 1); ++j) {
+            T *col = outPtr + j * ostrides[1];
+            for (dim_t i = 0; i < rows; ++i) {
+                if (!isSet(i, j)) {
+                    col[i * ostrides[0]] = T(0);
+                    continue;
+                }
+                const unsigned label =
+                    forest.getLabel(static_cast<unsigned>(j * rows + i));
+                col[i * ostrides[0]] = static_cast<T>(label);
+                if (!stats) { continue; }
 
-                    // Mark removed labels (those that are part of a region
-                    // that contains a smaller label)
-                    if (node->getMinLabel() < l || nodeRoot->getMinLabel() < l)
-                        removed.insert(l);
-                    if (node->getLabel() > node->getMinLabel())
-                        removed.insert(node->getLabel());
+                const unsigned row = static_cast<unsigned>(i);
+                const unsigned c   = static_cast<unsigned>(j);
+                if (label > firstLabel[task]) {
+                    addToStats(regionStats[label - 1], row, c);
+                } else {
+                    addToStats(earlierStats[task][label], row, c);
                 }
             }
         }
-    }
+    });
 
-    // Calculate final neighbors (ensure final labels are sequential)
-    for (int j = 0; j < (int)inDims[1]; j++) {
-        for (int i = 0; i < (int)inDims[0]; i++) {
-            int idx = j * (int)inDims[0] + i;
-            if (outPtr[idx] > 0) {
-                outPtr[idx] -=
-                    distance(removed.begin(), removed.lower_bound(outPtr[idx]));
-            }
+    if (!stats) { return; }
+    for (const auto &partial : earlierStats) {
+        for (const auto &entry : partial) {
+            mergeStats(regionStats[entry.first - 1], entry.second);
         }
     }
+    stats->resize(static_cast<size_t>(nregions) * common::REGION_STAT_COUNT);
+    for (unsigned r = 0; r < nregions; ++r) {
+        std::copy(regionStats[r].begin(), regionStats[r].end(),
+                  stats->begin() + r * common::REGION_STAT_COUNT);
+    }
 }
 
 }  // namespace kernel
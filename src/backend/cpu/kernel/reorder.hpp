@@ -9,10 +9,27 @@
 
 #pragma once
 #include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <kernel/transpose.hpp>
+#include <platform.hpp>
+#include <thread_pool.hpp>
+
+#include <algorithm>
 
 namespace cpu {
 namespace kernel {
 
+/// The smallest number of elements copied by one task of the thread pool
+constexpr dim_t REORDER_MIN_TASK_ELEMENTS = 1 << 16;
+
+/// Reorders the dimensions of \p in. Dimension i of the output is
+/// dimension rdims[i] of the input.
+///
+/// If the first dimension stays in place the lines along it are copied.
+/// Otherwise the first dimension of the output and the dimension which the
+/// first dimension of the input moves to form a batch of transposed planes
+/// (for example 1-0-2-3 or 2-1-0-3), which are copied with the blocked
+/// transpose.
 template<typename T>
 void reorder(Param<T> out, CParam<T> in, const af::dim4 oDims,
              const af::dim4 rdims) {
@@ -22,28 +39,47 @@ void reorder(Param<T> out, CParam<T> in, const af::dim4 oDims,
     const af::dim4 ist = in.strides();
     const af::dim4 ost = out.strides();
 
-    dim_t ids[4] = {0};
-    for (dim_t ow = 0; ow < oDims[3]; ow++) {
-        const dim_t oW = ow * ost[3];
-        ids[rdims[3]]  = ow;
-        for (dim_t oz = 0; oz < oDims[2]; oz++) {
-            const dim_t oZW = oW + oz * ost[2];
-            ids[rdims[2]]   = oz;
-            for (dim_t oy = 0; oy < oDims[1]; oy++) {
-                const dim_t oYZW = oZW + oy * ost[1];
-                ids[rdims[1]]    = oy;
-                for (dim_t ox = 0; ox < oDims[0]; ox++) {
-                    const dim_t oIdx = oYZW + ox;
-
-                    ids[rdims[0]]    = ox;
-                    const dim_t iIdx = ids[3] * ist[3] + ids[2] * ist[2] +
-                                       ids[1] * ist[1] + ids[0];
-
-                    outPtr[oIdx] = inPtr[iIdx];
-                }
-            }
+    if (rdims[0] != 0) {
+        int e = 1;
+        while (rdims[e] != 0) { ++e; }
+
+        dim_t bdims[2], obstrides[2], ibstrides[2];
+        for (int d = 1, b = 0; d < 4; ++d) {
+            if (d == e) { continue; }
+            bdims[b]     = oDims[d];
+            obstrides[b] = ost[d];
+            ibstrides[b] = ist[rdims[d]];
+            b++;
         }
+        transposeBatched<T, false>(outPtr, ost[e], inPtr, ist[rdims[0]],
+                                   oDims[0], oDims[e], bdims, obstrides,
+                                   ibstrides);
+        return;
     }
+
+    const dim_t lines = oDims[1] * oDims[2] * oDims[3];
+    if (lines == 0 || oDims[0] == 0) { return; }
+
+    thread_pool& pool  = getThreadPool();
+    const dim_t ntasks = std::max<dim_t>(
+        1, std::min({static_cast<dim_t>(pool.size()), lines,
+                     lines * oDims[0] / REORDER_MIN_TASK_ELEMENTS}));
+    const dim_t linesPerTask = divup(lines, ntasks);
+
+    pool.run(static_cast<int>(ntasks), [&](int task) {
+        const dim_t first = task * linesPerTask;
+        const dim_t last  = std::min(first + linesPerTask, lines);
+        for (dim_t line = first; line < last; ++line) {
+            const dim_t oy = line % oDims[1];
+            const dim_t oz = (line / oDims[1]) % oDims[2];
+            const dim_t ow = line / (oDims[1] * oDims[2]);
+
+            const T* src = inPtr + oy * ist[rdims[1]] + oz * ist[rdims[2]] +
+                           ow * ist[rdims[3]];
+            T* dst = outPtr + oy * ost[1] + oz * ost[2] + ow * ost[3];
+            std::copy(src, src + oDims[0], dst);
+        }
+    });
 }
 
 }  // namespace kernel
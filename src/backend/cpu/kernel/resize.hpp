@@ -10,9 +10,12 @@
 #pragma once
 #include <Param.hpp>
 #include <common/complex.hpp>
+#include <kernel/lines.hpp>
 #include <math.hpp>
 #include <af/traits.hpp>
 
+#include <vector>
+
 namespace cpu {
 namespace kernel {
 
@@ -38,122 +41,87 @@ template<typename T>
 using vtype_t =
     typename conditional<common::is_complex<T>::value, T, wtype_t<T>>::type;
 
-template<typename T, af_interp_type method>
-struct resize_op {
-    void operator()(T *outPtr, const T *inPtr, const af::dim4 &odims,
-                    const af::dim4 &idims, const af::dim4 &ostrides,
-                    const af::dim4 &istrides, const dim_t x, const dim_t y) {
-        UNUSED(outPtr);
-        UNUSED(inPtr);
-        UNUSED(odims);
-        UNUSED(idims);
-        UNUSED(ostrides);
-        UNUSED(istrides);
-        UNUSED(x);
-        UNUSED(y);
-        return;
-    }
+/// The source positions of the output positions along one dimension of a
+/// resize. The positions are computed once and shared by every row and
+/// channel of the output.
+struct ResizeAxis {
+    /// The source position of each output position, rounded as the method
+    /// requires
+    std::vector<dim_t> first;
+    /// The source position after first for bilinear interpolation
+    std::vector<dim_t> second;
+    /// The distance of the output position from first for bilinear
+    /// interpolation
+    std::vector<float> frac;
 };
 
-template<typename T>
-struct resize_op<T, AF_INTERP_NEAREST> {
-    void operator()(T *outPtr, const T *inPtr, const af::dim4 &odims,
-                    const af::dim4 &idims, const af::dim4 &ostrides,
-                    const af::dim4 &istrides, const dim_t x, const dim_t y) {
-        // Compute Indices
-        dim_t i_x = round2int((float)x / (odims[0] / (float)idims[0]));
-        dim_t i_y = round2int((float)y / (odims[1] / (float)idims[1]));
-
-        if (i_x >= idims[0]) i_x = idims[0] - 1;
-        if (i_y >= idims[1]) i_y = idims[1] - 1;
-
-        dim_t i_off = i_y * istrides[1] + i_x;
-        dim_t o_off = y * ostrides[1] + x;
-        // Copy values from all channels
-        for (dim_t w = 0; w < odims[3]; w++) {
-            dim_t wost = w * ostrides[3];
-            dim_t wist = w * istrides[3];
-            for (dim_t z = 0; z < odims[2]; z++) {
-                outPtr[o_off + z * ostrides[2] + wost] =
-                    inPtr[i_off + z * istrides[2] + wist];
-            }
+template<af_interp_type method>
+ResizeAxis resizeAxis(const dim_t odim, const dim_t idim) {
+    ResizeAxis axis;
+    axis.first.resize(odim);
+    if (method == AF_INTERP_BILINEAR) {
+        axis.second.resize(odim);
+        axis.frac.resize(odim);
+    }
+    for (dim_t o = 0; o < odim; o++) {
+        const float f = (float)o / (odim / (float)idim);
+        dim_t i = method == AF_INTERP_NEAREST ? round2int(f) : (dim_t)floor(f);
+        if (i >= idim) i = idim - 1;
+        axis.first[o] = i;
+        if (method == AF_INTERP_BILINEAR) {
+            axis.second[o] = (i + 1 >= idim ? idim - 1 : i + 1);
+            axis.frac[o]   = f - i;
+        }
+    }
+    return axis;
+}
+
+/// Resizes row \p y of a channel by copying the values at the source
+/// positions
+template<typename T, af_interp_type method>
+struct resize_op {
+    void operator()(T *outRow, const T *inPtr, const dim_t inRowStride,
+                    const ResizeAxis &xs, const ResizeAxis &ys,
+                    const dim_t y) {
+        const T *inRow = inPtr + ys.first[y] * inRowStride;
+        for (size_t x = 0; x < xs.first.size(); x++) {
+            outRow[x] = inRow[xs.first[x]];
         }
     }
 };
 
 template<typename T>
 struct resize_op<T, AF_INTERP_BILINEAR> {
-    void operator()(T *outPtr, const T *inPtr, const af::dim4 &odims,
-                    const af::dim4 &idims, const af::dim4 &ostrides,
-                    const af::dim4 &istrides, const dim_t x, const dim_t y) {
-        // Compute Indices
-        float f_x = (float)x / (odims[0] / (float)idims[0]);
-        float f_y = (float)y / (odims[1] / (float)idims[1]);
-
-        dim_t i1_x = floor(f_x);
-        dim_t i1_y = floor(f_y);
-
-        if (i1_x >= idims[0]) i1_x = idims[0] - 1;
-        if (i1_y >= idims[1]) i1_y = idims[1] - 1;
-
-        float b = f_x - i1_x;
-        float a = f_y - i1_y;
-
-        dim_t i2_x = (i1_x + 1 >= idims[0] ? idims[0] - 1 : i1_x + 1);
-        dim_t i2_y = (i1_y + 1 >= idims[1] ? idims[1] - 1 : i1_y + 1);
-
+    void operator()(T *outRow, const T *inPtr, const dim_t inRowStride,
+                    const ResizeAxis &xs, const ResizeAxis &ys,
+                    const dim_t y) {
         typedef typename af::dtype_traits<T>::base_type BT;
         typedef wtype_t<BT> WT;
         typedef vtype_t<T> VT;
 
-        dim_t o_off = y * ostrides[1] + x;
-        // Copy values from all channels
-        for (dim_t w = 0; w < odims[3]; w++) {
-            dim_t wst = w * istrides[3];
-            for (dim_t z = 0; z < odims[2]; z++) {
-                dim_t zst         = z * istrides[2];
-                dim_t channel_off = zst + wst;
-                VT p1 = inPtr[i1_y * istrides[1] + i1_x + channel_off];
-                VT p2 = inPtr[i2_y * istrides[1] + i1_x + channel_off];
-                VT p3 = inPtr[i1_y * istrides[1] + i2_x + channel_off];
-                VT p4 = inPtr[i2_y * istrides[1] + i2_x + channel_off];
-
-                outPtr[o_off + z * ostrides[2] + w * ostrides[3]] =
-                    scalar<WT>((1.0f - a) * (1.0f - b)) * p1 +
-                    scalar<WT>((a) * (1.0f - b)) * p2 +
-                    scalar<WT>((1.0f - a) * (b)) * p3 +
-                    scalar<WT>((a) * (b)) * p4;
-            }
-        }
-    }
-};
-
-template<typename T>
-struct resize_op<T, AF_INTERP_LOWER> {
-    void operator()(T *outPtr, const T *inPtr, const af::dim4 &odims,
-                    const af::dim4 &idims, const af::dim4 &ostrides,
-                    const af::dim4 &istrides, const dim_t x, const dim_t y) {
-        // Compute Indices
-        dim_t i_x = floor((float)x / (odims[0] / (float)idims[0]));
-        dim_t i_y = floor((float)y / (odims[1] / (float)idims[1]));
-
-        if (i_x >= idims[0]) i_x = idims[0] - 1;
-        if (i_y >= idims[1]) i_y = idims[1] - 1;
-
-        dim_t i_off = i_y * istrides[1] + i_x;
-        dim_t o_off = y * ostrides[1] + x;
-        // Copy values from all channels
-        for (dim_t w = 0; w < odims[3]; w++) {
-            dim_t wost = w * ostrides[3];
-            dim_t wist = w * istrides[3];
-            for (dim_t z = 0; z < odims[2]; z++) {
-                outPtr[o_off + z * ostrides[2] + wost] =
-                    inPtr[i_off + z * istrides[2] + wist];
-            }
+        const float a   = ys.frac[y];
+        const T *inRow1 = inPtr + ys.first[y] * inRowStride;
+        const T *inRow2 = inPtr + ys.second[y] * inRowStride;
+        for (size_t x = 0; x < xs.first.size(); x++) {
+            const float b = xs.frac[x];
+            VT p1         = inRow1[xs.first[x]];
+            VT p2         = inRow2[xs.first[x]];
+            VT p3         = inRow1[xs.second[x]];
+            VT p4         = inRow2[xs.second[x]];
+
+            outRow[x] = scalar<WT>((1.0f - a) * (1.0f - b)) * p1 +
+                        scalar<WT>((a) * (1.0f - b)) * p2 +
+                        scalar<WT>((1.0f - a) * (b)) * p3 +
+                        scalar<WT>((a) * (b)) * p4;
         }
     }
 };
 
+/// Resizes the first two dimensions of \p in.
+///
+/// The source positions and weights of the output rows and columns are
+/// computed once, and the rows of all the channels are then resized by the
+/// thread pool.
 template<typename T, af_interp_type method>
 void resize(Param<T> out, CParam<T> in) {
     af::dim4 idims    = in.dims();
@@ -163,12 +131,21 @@ void resize(Param<T> out, CParam<T> in) {
     af::dim4 ostrides = out.strides();
     af::dim4 istrides = in.strides();
 
-    resize_op<T, method> op;
-    for (dim_t y = 0; y < odims[1]; y++) {
-        for (dim_t x = 0; x < odims[0]; x++) {
-            op(outPtr, inPtr, odims, idims, ostrides, istrides, x, y);
+    const ResizeAxis xs = resizeAxis<method>(odims[0], idims[0]);
+    const ResizeAxis ys = resizeAxis<method>(odims[1], idims[1]);
+
+    const dim_t rows = odims[1] * odims[2] * odims[3];
+    parallelFor(rows, odims[0], [&](dim_t first, dim_t last) {
+        resize_op<T, method> op;
+        for (dim_t row = first; row < last; row++) {
+            const dim_t y = row % odims[1];
+            const dim_t z = (row / odims[1]) % odims[2];
+            const dim_t w = row / (odims[1] * odims[2]);
+            op(outPtr + lineOffset(odims, 0, row, ostrides),
+               inPtr + z * istrides[2] + w * istrides[3], istrides[1], xs, ys,
+               y);
         }
-    }
+    });
 }
 
 }  // namespace kernel
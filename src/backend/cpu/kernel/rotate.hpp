@@ -11,6 +11,7 @@
 #include <Param.hpp>
 #include <err_cpu.hpp>
 #include <math.hpp>
+#include <parallel_for.hpp>
 #include <af/traits.hpp>
 #include "interp.hpp"
 
@@ -53,38 +54,45 @@ void rotate(Param<T> output, CParam<T> input, const float theta,
     int nimages = odims[2];
     T *out      = output.get();
 
-    for (int idw = 0; idw < (int)odims[3]; idw++) {
+    // All the images share the transform, so the rows of all the batches
+    // are rotated by the thread pool
+    auto rotateRow = [&](const int idw, const int idy) {
+        Interp2<T, WT, order> interp;
         int out_offw = idw * ostrides[3];
         int in_offw  = idw * istrides[3];
 
-        // Do transform for image
-        for (int idy = 0; idy < (int)odims[1]; idy++) {
-            for (int idx = 0; idx < (int)odims[0]; idx++) {
-                WT xidi = idx * tmat[0] + idy * tmat[1] + tmat[2];
-                WT yidi = idx * tmat[3] + idy * tmat[4] + tmat[5];
+        for (int idx = 0; idx < (int)odims[0]; idx++) {
+            WT xidi = idx * tmat[0] + idy * tmat[1] + tmat[2];
+            WT yidi = idx * tmat[3] + idy * tmat[4] + tmat[5];
 
-                // Special conditions to deal with boundaries for bilinear and
-                // bicubic
-                // FIXME: Ideally this condition should be removed or be present
-                // for all methods But tests are expecting a different behavior
-                // for bilinear and nearest
-                bool condX = xidi >= -0.0001 && xidi < idims[0];
-                bool condY = yidi >= -0.0001 && yidi < idims[1];
-                int ooff   = out_offw + idy * ostrides[1] + idx;
-                if (order == 1 || (condX && condY)) {
-                    // FIXME: Nearest and lower do not do clamping, but other
-                    // methods do Make it consistent
-                    bool clamp = order != 1;
-                    interp(output, ooff, input, in_offw, xidi, yidi, method,
-                           nimages, clamp);
-                } else {
-                    for (int n = 0; n < nimages; n++) {
-                        out[ooff + n * ostrides[2]] = scalar<T>(0);
-                    }
+            // Special conditions to deal with boundaries for bilinear and
+            // bicubic
+            // FIXME: Ideally this condition should be removed or be present
+            // for all methods But tests are expecting a different behavior
+            // for bilinear and nearest
+            bool condX = xidi >= -0.0001 && xidi < idims[0];
+            bool condY = yidi >= -0.0001 && yidi < idims[1];
+            int ooff   = out_offw + idy * ostrides[1] + idx;
+            if (order == 1 || (condX && condY)) {
+                // FIXME: Nearest and lower do not do clamping, but other
+                // methods do Make it consistent
+                bool clamp = order != 1;
+                interp(output, ooff, input, in_offw, xidi, yidi, method,
+                       nimages, clamp);
+            } else {
+                for (int n = 0; n < nimages; n++) {
+                    out[ooff + n * ostrides[2]] = scalar<T>(0);
                 }
             }
         }
-    }
+    };
+
+    parallelFor(odims[3] * odims[1], odims[0] * nimages,
+                [&](dim_t first, dim_t last) {
+                    for (dim_t unit = first; unit < last; unit++) {
+                        rotateRow(unit / odims[1], unit % odims[1]);
+                    }
+                });
 }
 
 }  // namespace kernel
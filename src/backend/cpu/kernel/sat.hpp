@@ -0,0 +1,58 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <platform.hpp>
+#include <thread_pool.hpp>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+
+namespace cpu {
+namespace kernel {
+
+/// Computes the summed-area table of each 2D slice of \p in in one pass. Each
+/// column is scanned along dim 0 and added to the table of the previous
+/// column, which is read back from the output while it is in the cache. The
+/// slices are split between the tasks of the thread pool.
+template<typename Ti, typename To>
+void sat(Param<To> out, CParam<Ti> in) {
+    const af::dim4 dims     = in.dims();
+    const af::dim4 istrides = in.strides();
+    const af::dim4 ostrides = out.strides();
+
+    const dim_t nslices = dims[2] * dims[3];
+    thread_pool &pool   = getThreadPool();
+    const dim_t ntasks  = std::min<dim_t>(pool.size(), nslices);
+
+    pool.run(static_cast<int>(ntasks), [&](int task) {
+        for (dim_t slice = task; slice < nslices; slice += ntasks) {
+            const dim_t z  = slice % dims[2];
+            const dim_t w  = slice / dims[2];
+            const Ti *iptr = in.get() + w * istrides[3] + z * istrides[2];
+            To *optr       = out.get() + w * ostrides[3] + z * ostrides[2];
+
+            for (dim_t j = 0; j < dims[1]; ++j) {
+                const Ti *icol = iptr + j * istrides[1];
+                To *ocol       = optr + j * ostrides[1];
+                const To *prev = ocol - ostrides[1];
+                To sum         = To(0);
+                for (dim_t i = 0; i < dims[0]; ++i) {
+                    sum += static_cast<To>(icol[i * istrides[0]]);
+                    ocol[i] = j == 0 ? sum : prev[i] + sum;
+                }
+            }
+        }
+    });
+}
+
+}  // namespace kernel
+}  // namespace cpu
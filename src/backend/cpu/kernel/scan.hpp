@@ -11,64 +11,121 @@
 #include <Param.hpp>
 #include <common/Binary.hpp>
 #include <common/Transform.hpp>
+#include <kernel/lines.hpp>
+
+#include <algorithm>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
 
-template<af_op_t op, typename Ti, typename To, int D, bool inclusive_scan>
-struct scan_dim {
-    void operator()(Param<To> out, dim_t outOffset, CParam<Ti> in,
-                    dim_t inOffset, const int dim) const {
-        const af::dim4 odims    = out.dims();
-        const af::dim4 ostrides = out.strides();
-        const af::dim4 istrides = in.strides();
-
-        const int D1 = D - 1;
-        for (dim_t i = 0; i < odims[D1]; i++) {
-            scan_dim<op, Ti, To, D1, inclusive_scan> func;
-            func(out, outOffset + i * ostrides[D1], in,
-                 inOffset + i * istrides[D1], dim);
-            if (D1 == dim) break;
-        }
-    }
-};
-
+/// Scans \p in along dimension \p dim.
+///
+/// Each line is split into blocks of LINE_BLOCK_ELEMENTS values which are
+/// scanned from the identity, and each scanned value is combined with the
+/// reduction of the previous blocks of the line. When there are fewer lines
+/// than threads, the blocks are reduced in parallel, the offsets of the
+/// blocks of each line are scanned, and the blocks are then scanned in
+/// parallel. Otherwise each line is scanned by one thread in a single pass.
+/// Both compute the same values, so the results never depend on the number
+/// of threads.
 template<af_op_t op, typename Ti, typename To, bool inclusive_scan>
-struct scan_dim<op, Ti, To, 0, inclusive_scan> {
-    void operator()(Param<To> output, dim_t outOffset, CParam<Ti> input,
-                    dim_t inOffset, const int dim) const {
-        const Ti* in = input.get() + inOffset;
-        To* out      = output.get() + outOffset;
+void scan(Param<To> out, CParam<Ti> in, const int dim) {
+    const af::dim4 dims     = in.dims();
+    const af::dim4 istrides = in.strides();
+    const af::dim4 ostrides = out.strides();
 
-        const af::dim4 ostrides = output.strides();
-        const af::dim4 istrides = input.strides();
-        const af::dim4 idims    = input.dims();
+    const dim_t n       = dims[dim];
+    const dim_t istride = istrides[dim];
+    const dim_t ostride = ostrides[dim];
+    const dim_t nlines  = lineCount(dims, dim);
+    const dim_t blocks  = divup(n, LINE_BLOCK_ELEMENTS);
+    if (nlines == 0 || n == 0) { return; }
 
-        dim_t istride = istrides[dim];
-        dim_t ostride = ostrides[dim];
+    common::Transform<Ti, To, op> transform;
+    // FIXME: Change the name to something better
+    common::Binary<To, op> scan;
+    const To init = common::Binary<To, op>::init();
 
-        common::Transform<Ti, To, op> transform;
-        // FIXME: Change the name to something better
-        common::Binary<To, op> scan;
+    // Scans the values [begin, end) of a line after the blocks which reduce
+    // to offset, and returns the reduction of the values. The values are
+    // only reduced when optr is null.
+    auto scanBlock = [&](const Ti *iptr, To *optr, const dim_t begin,
+                         const dim_t end, const To offset) {
+        To local = init;
+        for (dim_t i = begin; i < end; ++i) {
+            const To in_val = transform(iptr[i * istride]);
+            if (!optr) {
+                local = scan(in_val, local);
+            } else if (inclusive_scan) {
+                local             = scan(in_val, local);
+                optr[i * ostride] = scan(local, offset);
+            } else {
+                optr[i * ostride] = scan(local, offset);
+                local             = scan(in_val, local);
+            }
+        }
+        return local;
+    };
+    auto inLine = [&](dim_t line) {
+        return in.get() + lineOffset(dims, dim, line, istrides);
+    };
+    auto outLine = [&](dim_t line) {
+        return out.get() + lineOffset(dims, dim, line, ostrides);
+    };
+    auto blockEnd = [&](dim_t b) {
+        return std::min((b + 1) * LINE_BLOCK_ELEMENTS, n);
+    };
 
-        To out_val = common::Binary<To, op>::init();
-        for (dim_t i = 0; i < idims[dim]; i++) {
-            To in_val = transform(in[i * istride]);
-            out_val   = scan(in_val, out_val);
-            if (!inclusive_scan) {
-                // The loop shifts the output index by 1.
-                // The last index wraps around and writes the first element.
-                if (i == (idims[dim] - 1)) {
-                    out[0] = common::Binary<To, op>::init();
-                } else {
-                    out[(i + 1) * ostride] = out_val;
+    const dim_t threads = getThreadPool().size();
+    if (blocks == 1 || nlines >= threads) {
+        parallelFor(nlines, n, [&](dim_t first, dim_t last) {
+            for (dim_t line = first; line < last; ++line) {
+                To offset = init;
+                for (dim_t b = 0; b < blocks; ++b) {
+                    const To total =
+                        scanBlock(inLine(line), outLine(line),
+                                  b * LINE_BLOCK_ELEMENTS, blockEnd(b), offset);
+                    offset = scan(total, offset);
                 }
-            } else {
-                out[i * ostride] = out_val;
             }
+        });
+        return;
+    }
+
+    // The reduction of each block, which is then replaced by the reduction
+    // of the previous blocks of its line
+    std::vector<To> offsets(nlines * blocks);
+    parallelFor(nlines * blocks, LINE_BLOCK_ELEMENTS,
+                [&](dim_t first, dim_t last) {
+                    for (dim_t unit = first; unit < last; ++unit) {
+                        const dim_t b = unit % blocks;
+                        offsets[unit] = scanBlock(
+                            inLine(unit / blocks), nullptr,
+                            b * LINE_BLOCK_ELEMENTS, blockEnd(b), init);
+                    }
+                });
+
+    for (dim_t line = 0; line < nlines; ++line) {
+        To offset = init;
+        for (dim_t b = 0; b < blocks; ++b) {
+            const To total             = offsets[line * blocks + b];
+            offsets[line * blocks + b] = offset;
+            offset                     = scan(total, offset);
         }
     }
-};
+
+    parallelFor(nlines * blocks, LINE_BLOCK_ELEMENTS,
+                [&](dim_t first, dim_t last) {
+                    for (dim_t unit = first; unit < last; ++unit) {
+                        const dim_t line = unit / blocks;
+                        const dim_t b    = unit % blocks;
+                        scanBlock(inLine(line), outLine(line),
+                                  b * LINE_BLOCK_ELEMENTS, blockEnd(b),
+                                  offsets[unit]);
+                    }
+                });
+}
 
 }  // namespace kernel
 }  // namespace cpu
@@ -11,6 +11,7 @@
 #include <Param.hpp>
 #include <common/Binary.hpp>
 #include <common/Transform.hpp>
+#include <kernel/lines.hpp>
 
 namespace cpu {
 namespace kernel {
@@ -84,5 +85,26 @@ struct scan_dim_by_key<op, Ti, Tk, To, 0> {
     }
 };
 
+/// Scans \p in along dimension \p dim, restarting at each change of \p key.
+/// The lines are split across the thread pool.
+template<af_op_t op, typename Ti, typename Tk, typename To>
+void scan_by_key(Param<To> out, CParam<Tk> key, CParam<Ti> in, const int dim,
+                 bool inclusive_scan) {
+    const af::dim4 dims     = in.dims();
+    const af::dim4 ostrides = out.strides();
+    const af::dim4 kstrides = key.strides();
+    const af::dim4 istrides = in.strides();
+    if (dims[dim] == 0) { return; }
+
+    const scan_dim_by_key<op, Ti, Tk, To, 0> func(inclusive_scan);
+    parallelFor(lineCount(dims, dim), dims[dim], [&](dim_t first, dim_t last) {
+        for (dim_t line = first; line < last; ++line) {
+            func(out, lineOffset(dims, dim, line, ostrides), key,
+                 lineOffset(dims, dim, line, kstrides), in,
+                 lineOffset(dims, dim, line, istrides), dim);
+        }
+    });
+}
+
 }  // namespace kernel
 }  // namespace cpu
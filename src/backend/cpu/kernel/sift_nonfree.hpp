@@ -168,10 +168,14 @@ void gaussian1D(T* out, const int dim, double sigma = 0.0) {
     for (int k = 0; k < dim; k++) out[k] /= sum;
 }
 
+// Using 6-sigma rule
+inline unsigned gauss_filter_len(float sigma) {
+    return std::min((unsigned)round(sigma * 6 + 1) | 1, 31u);
+}
+
 template<typename T>
 Array<T> gauss_filter(float sigma) {
-    // Using 6-sigma rule
-    unsigned gauss_len = std::min((unsigned)round(sigma * 6 + 1) | 1, 31u);
+    unsigned gauss_len = gauss_filter_len(sigma);
 
     Array<T> filter = createEmptyArray<T>(gauss_len);
     gaussian1D((T*)getDevicePtr(filter), gauss_len, sigma);
@@ -203,16 +207,6 @@ void gaussianElimination(float* A, float* b, float* x) {
     }
 }
 
-template<typename T>
-void sub(Array<T>& out, const Array<T>& in1, const Array<T>& in2) {
-    size_t nel       = in1.elements();
-    T* out_ptr       = out.get();
-    const T* in1_ptr = in1.get();
-    const T* in2_ptr = in2.get();
-
-    for (size_t i = 0; i < nel; i++) { out_ptr[i] = in1_ptr[i] - in2_ptr[i]; }
-}
-
 #define CPTR(Y, X) (center_ptr[(Y)*idims[0] + (X)])
 #define PPTR(Y, X) (prev_ptr[(Y)*idims[0] + (X)])
 #define NPTR(Y, X) (next_ptr[(Y)*idims[0] + (X)])
@@ -828,11 +822,128 @@ Array<T> createInitialImage(const Array<T>& img, const float init_sigma,
     return init_img;
 }
 
+// Computes the Gaussian levels 1 to gauss.size() - 1 of an octave from its
+// level 0, and the DoG levels between them, in one pass over the columns.
+//
+// Level l is level l - 1 filtered by the separable filter filters[l], and
+// its columns lag the columns of level l - 1 by the radius of filters[l].
+// Each column of a level is filtered along dimension 0 for the next level
+// as soon as it is computed, into a ring of filter length columns, and the
+// DoG columns are written with the Gaussian columns, so the levels are read
+// while they are in the cache and no intermediate images are written. The
+// results are those of convolve2 and a subtraction.
+//
+// The rows are split in bands across the thread pool. The intermediate
+// levels of a band are computed for the rows around it which the later
+// levels of the band read.
+template<typename T, typename convAccT>
+void buildOctave(const std::vector<T*>& gauss, const std::vector<T*>& dog,
+                 const std::vector<std::vector<convAccT>>& filters,
+                 const dim_t idim0, const dim_t idim1) {
+    const size_t n_levels = gauss.size();
+    if (n_levels < 2) return;
+
+    // The lag of the columns of each level behind level 0, and the rows of
+    // each level read around a band by the later levels
+    std::vector<dim_t> lag(n_levels, 0);
+    std::vector<dim_t> halo(n_levels, 0);
+    dim_t cost = 0;
+    for (size_t l = 1; l < n_levels; l++) {
+        lag[l] = lag[l - 1] + (dim_t)filters[l].size() / 2;
+        cost += 2 * (dim_t)filters[l].size();
+    }
+    for (size_t l = n_levels - 1; l > 0; l--) {
+        halo[l - 1] = halo[l] + (dim_t)filters[l].size() / 2;
+    }
+
+    parallelFor(idim0, idim1 * cost, [&](dim_t first, dim_t last) {
+        // The rows [lo[l], hi[l]) of level l are computed by the band
+        std::vector<dim_t> lo(n_levels), hi(n_levels);
+        // The columns of level l - 1 filtered along dimension 0, and the
+        // current column of level l
+        std::vector<std::vector<convAccT>> rings(n_levels);
+        std::vector<std::vector<T>> cols(n_levels);
+        for (size_t l = 0; l < n_levels; l++) {
+            lo[l] = std::max<dim_t>(0, first - halo[l]);
+            hi[l] = std::min<dim_t>(idim0, last + halo[l]);
+            if (l > 0) {
+                rings[l].resize(filters[l].size() * (hi[l] - lo[l]));
+                cols[l].resize(hi[l] - lo[l]);
+            }
+        }
+        std::vector<convAccT> padded;
+        std::vector<convAccT> acc;
+
+        // Filters column c of level l - 1, whose first row is src_lo, along
+        // dimension 0 into the ring of level l
+        auto filterColumn = [&](size_t l, dim_t c, const T* src,
+                                dim_t src_lo) {
+            const std::vector<convAccT>& h = filters[l];
+            const dim_t flen      = h.size();
+            const dim_t len       = hi[l] - lo[l];
+            const dim_t first_row = lo[l] + flen / 2 + 1 - flen;
+
+            // The rows of the column read by the band, zero outside the image
+            padded.resize(len + flen - 1);
+            for (dim_t k = 0; k < len + flen - 1; k++) {
+                const dim_t row = first_row + k;
+                padded[k] = (row < 0 || row >= idim0)
+                                ? scalar<convAccT>(0)
+                                : convAccT(src[row - src_lo]);
+            }
+
+            convAccT* dst = rings[l].data() + (c % flen) * len;
+            std::fill(dst, dst + len, scalar<convAccT>(0));
+            for (dim_t f = 0; f < flen; f++) {
+                kernel::axpyLine(dst, padded.data() + flen - 1 - f, h[f], len);
+            }
+            // Rounded like the intermediate image of convolve2
+            for (dim_t i = 0; i < len; i++) { dst[i] = convAccT(T(dst[i])); }
+        };
+
+        for (dim_t j = 0; j < idim1 + lag.back(); j++) {
+            if (j < idim1) { filterColumn(1, j, gauss[0] + j * idim0, 0); }
+
+            for (size_t l = 1; l < n_levels; l++) {
+                const dim_t t = j - lag[l];
+                if (t < 0 || t >= idim1) continue;
+
+                const std::vector<convAccT>& h = filters[l];
+                const dim_t flen = h.size();
+                const dim_t len  = hi[l] - lo[l];
+
+                // Column t reads the columns t + flen / 2 - f of level l - 1
+                acc.assign(len, scalar<convAccT>(0));
+                for (dim_t f = 0; f < flen; f++) {
+                    const dim_t r = t + flen / 2 - f;
+                    if (r < 0 || r >= idim1) continue;
+                    kernel::axpyLine(acc.data(),
+                                     rings[l].data() + (r % flen) * len, h[f],
+                                     len);
+                }
+                T* col = cols[l].data();
+                for (dim_t i = 0; i < len; i++) { col[i] = T(acc[i]); }
+
+                // The rows of the band of the Gaussian and the DoG levels
+                T* g        = gauss[l] + t * idim0;
+                const T* gp = gauss[l - 1] + t * idim0;
+                T* d        = dog[l - 1] + t * idim0;
+                for (dim_t i = first; i < last; i++) {
+                    g[i] = col[i - lo[l]];
+                    d[i] = g[i] - gp[i];
+                }
+
+                if (l + 1 < n_levels) { filterColumn(l + 1, t, col, lo[l]); }
+            }
+        }
+    });
+}
+
 template<typename T, typename convAccT>
-std::vector<Array<T>> buildGaussPyr(const Array<T>& init_img,
-                                    const unsigned n_octaves,
-                                    const unsigned n_layers,
-                                    const float init_sigma) {
+void buildPyramids(std::vector<Array<T>>& gauss_pyr,
+                   std::vector<Array<T>>& dog_pyr, const Array<T>& init_img,
+                   const unsigned n_octaves, const unsigned n_layers,
+                   const float init_sigma) {
     // Precompute Gaussian sigmas using the following formula:
     // \sigma_{total}^2 = \sigma_{i}^2 + \sigma_{i-1}^2
     std::vector<float> sig_layers(n_layers + 3);
@@ -844,53 +955,50 @@ std::vector<Array<T>> buildGaussPyr(const Array<T>& init_img,
         sig_layers[i] = std::sqrt(sig_total * sig_total - sig_prev * sig_prev);
     }
 
-    // Gaussian Pyramid
-    std::vector<Array<T>> gauss_pyr(n_octaves * (n_layers + 3),
-                                    createEmptyArray<T>(af::dim4()));
-    for (unsigned o = 0; o < n_octaves; o++) {
-        for (unsigned l = 0; l < n_layers + 3; l++) {
-            unsigned src_idx = (l == 0) ? (o - 1) * (n_layers + 3) + n_layers
-                                        : o * (n_layers + 3) + l - 1;
-            unsigned idx = o * (n_layers + 3) + l;
-
-            if (o == 0 && l == 0) {
-                gauss_pyr[idx] = init_img;
-            } else if (l == 0) {
-                af::dim4 sdims = gauss_pyr[src_idx].dims();
-                gauss_pyr[idx] = resize<T>(gauss_pyr[src_idx], sdims[0] / 2,
-                                           sdims[1] / 2, AF_INTERP_BILINEAR);
-            } else {
-                Array<T> filter = gauss_filter<T>(sig_layers[l]);
-
-                gauss_pyr[idx] = convolve2<T, convAccT>(gauss_pyr[src_idx],
-                                                        filter, filter, false);
-            }
-        }
+    std::vector<std::vector<convAccT>> filters(n_layers + 3);
+    for (unsigned l = 1; l < n_layers + 3; l++) {
+        filters[l].resize(gauss_filter_len(sig_layers[l]));
+        gaussian1D(filters[l].data(), (int)filters[l].size(), sig_layers[l]);
     }
 
-    return gauss_pyr;
-}
-
-template<typename T>
-std::vector<Array<T>> buildDoGPyr(std::vector<Array<T>>& gauss_pyr,
-                                  const unsigned n_octaves,
-                                  const unsigned n_layers) {
-    // DoG Pyramid
-    std::vector<Array<T>> dog_pyr(n_octaves * (n_layers + 2),
-                                  createEmptyArray<T>(af::dim4()));
+    // Gaussian and DoG Pyramids
+    gauss_pyr.assign(n_octaves * (n_layers + 3),
+                     createEmptyArray<T>(af::dim4()));
+    dog_pyr.assign(n_octaves * (n_layers + 2), createEmptyArray<T>(af::dim4()));
     for (unsigned o = 0; o < n_octaves; o++) {
-        for (unsigned l = 0; l < n_layers + 2; l++) {
-            unsigned idx    = o * (n_layers + 2) + l;
-            unsigned bottom = o * (n_layers + 3) + l;
-            unsigned top    = o * (n_layers + 3) + l + 1;
+        unsigned idx = o * (n_layers + 3);
+
+        if (o == 0) {
+            gauss_pyr[idx] = init_img;
+        } else {
+            unsigned src_idx = (o - 1) * (n_layers + 3) + n_layers;
+            af::dim4 sdims   = gauss_pyr[src_idx].dims();
+            gauss_pyr[idx]   = resize<T>(gauss_pyr[src_idx], sdims[0] / 2,
+                                       sdims[1] / 2, AF_INTERP_BILINEAR);
+        }
 
-            dog_pyr[idx] = createEmptyArray<T>(gauss_pyr[bottom].dims());
+        af::dim4 odims = gauss_pyr[idx].dims();
+        std::vector<T*> gauss(n_layers + 3);
+        std::vector<T*> dog(n_layers + 2);
+        for (unsigned l = 1; l < n_layers + 3; l++) {
+            gauss_pyr[idx + l] = createEmptyArray<T>(odims);
+        }
+        for (unsigned l = 0; l < n_layers + 2; l++) {
+            dog_pyr[o * (n_layers + 2) + l] = createEmptyArray<T>(odims);
+        }
 
-            sub<T>(dog_pyr[idx], gauss_pyr[top], gauss_pyr[bottom]);
+        // The first level is computed by the queue
+        getQueue().sync();
+        for (unsigned l = 0; l < n_layers + 3; l++) {
+            gauss[l] = gauss_pyr[idx + l].get();
+        }
+        for (unsigned l = 0; l < n_layers + 2; l++) {
+            dog[l] = dog_pyr[o * (n_layers + 2) + l].get();
         }
-    }
 
-    return dog_pyr;
+        // One pass over the octave for all its levels
+        buildOctave<T, convAccT>(gauss, dog, filters, odims[0], odims[1]);
+    }
 }
 
 template<typename T, typename convAccT>
@@ -914,11 +1022,10 @@ unsigned sift_impl(Array<float>& x, Array<float>& y, Array<float>& score,
     Array<T> init_img =
         createInitialImage<T, convAccT>(in, init_sigma, double_input);
 
-    std::vector<Array<T>> gauss_pyr =
-        buildGaussPyr<T, convAccT>(init_img, n_octaves, n_layers, init_sigma);
-
-    std::vector<Array<T>> dog_pyr =
-        buildDoGPyr<T>(gauss_pyr, n_octaves, n_layers);
+    std::vector<Array<T>> gauss_pyr;
+    std::vector<Array<T>> dog_pyr;
+    buildPyramids<T, convAccT>(gauss_pyr, dog_pyr, init_img, n_octaves,
+                               n_layers, init_sigma);
 
     vector<uptr<float>> x_pyr(n_octaves);
     vector<uptr<float>> y_pyr(n_octaves);
@@ -17,29 +17,30 @@
 namespace cpu {
 namespace kernel {
 
-template<typename Ti, typename To, bool isDX>
-void derivative(Param<To> output, CParam<Ti> input) {
-    const af::dim4 dims     = input.dims();
-    const af::dim4 istrides = input.strides();
-    const af::dim4 ostrides = output.strides();
+/// Computes both Sobel derivatives of \p input from one read of the 3x3
+/// neighborhood of each pixel
+template<typename Ti, typename To>
+void derivatives(Param<To> dx, Param<To> dy, CParam<Ti> input) {
+    const af::dim4 dims      = input.dims();
+    const af::dim4 istrides  = input.strides();
+    const af::dim4 dxstrides = dx.strides();
+    const af::dim4 dystrides = dy.strides();
 
     auto reflect101 = [](int index, int endIndex) -> int {
         return std::abs(endIndex - std::abs(endIndex - index));
     };
 
     for (dim_t b3 = 0; b3 < dims[3]; ++b3) {
-        To* optr       = output.get() + b3 * ostrides[3];
+        To* dxptr      = dx.get() + b3 * dxstrides[3];
+        To* dyptr      = dy.get() + b3 * dystrides[3];
         const Ti* iptr = input.get() + b3 * istrides[3];
         for (dim_t b2 = 0; b2 < dims[2]; ++b2) {
             for (dim_t j = 0; j < dims[1]; ++j) {
-                int joff    = j;
-                int _joff   = reflect101(j - 1, static_cast<int>(dims[1] - 1));
-                int joff_   = reflect101(j + 1, static_cast<int>(dims[1] - 1));
-                int joffset = j * ostrides[1];
+                int joff  = j;
+                int _joff = reflect101(j - 1, static_cast<int>(dims[1] - 1));
+                int joff_ = reflect101(j + 1, static_cast<int>(dims[1] - 1));
 
                 for (dim_t i = 0; i < dims[0]; ++i) {
-                    To accum = To(0);
-
                     int ioff = i;
                     int _ioff =
                         reflect101(i - 1, static_cast<int>(dims[0] - 1));
@@ -51,21 +52,20 @@ void derivative(Param<To> output, CParam<Ti> input) {
                     To NE = iptr[joff_ * istrides[1] + _ioff * istrides[0]];
                     To SE = iptr[joff_ * istrides[1] + ioff_ * istrides[0]];
 
-                    if (isDX) {
-                        To N  = iptr[joff * istrides[1] + _ioff * istrides[0]];
-                        To S  = iptr[joff * istrides[1] + ioff_ * istrides[0]];
-                        accum = SW + SE - (NW + NE) + 2 * (S - N);
-                    } else {
-                        To W  = iptr[_joff * istrides[1] + ioff * istrides[0]];
-                        To E  = iptr[joff_ * istrides[1] + ioff * istrides[0]];
-                        accum = NE + SE - (NW + SW) + 2 * (E - W);
-                    }
+                    To N = iptr[joff * istrides[1] + _ioff * istrides[0]];
+                    To S = iptr[joff * istrides[1] + ioff_ * istrides[0]];
+                    To W = iptr[_joff * istrides[1] + ioff * istrides[0]];
+                    To E = iptr[joff_ * istrides[1] + ioff * istrides[0]];
 
-                    optr[joffset + i * ostrides[0]] = accum;
+                    dxptr[j * dxstrides[1] + i * dxstrides[0]] =
+                        SW + SE - (NW + NE) + 2 * (S - N);
+                    dyptr[j * dystrides[1] + i * dystrides[0]] =
+                        NE + SE - (NW + SW) + 2 * (E - W);
                 }
             }
 
-            optr += ostrides[2];
+            dxptr += dxstrides[2];
+            dyptr += dystrides[2];
             iptr += istrides[2];
         }
     }
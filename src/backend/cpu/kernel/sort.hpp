@@ -10,37 +10,23 @@
 #pragma once
 #include <Param.hpp>
 #include <err_cpu.hpp>
-#include <math.hpp>
-#include <algorithm>
-#include <functional>
-#include <numeric>
+#include <kernel/radix_sort.hpp>
 
 namespace cpu {
 namespace kernel {
 
-// Based off of http://stackoverflow.com/a/12399290
 template<typename T>
 void sort0Iterative(Param<T> val, bool isAscending) {
-    // initialize original index locations
-    T *val_ptr = val.get();
-
-    std::function<bool(T, T)> op = std::greater<T>();
-    if (isAscending) { op = std::less<T>(); }
-
-    T *comp_ptr = nullptr;
-    for (dim_t w = 0; w < val.dims(3); w++) {
-        dim_t valW = w * val.strides(3);
-        for (dim_t z = 0; z < val.dims(2); z++) {
-            dim_t valWZ = valW + z * val.strides(2);
-            for (dim_t y = 0; y < val.dims(1); y++) {
-                dim_t valOffset = valWZ + y * val.strides(1);
+    sortLines<T, T>(val.get(), nullptr, val.dims(), val.strides(),
+                    val.strides(), 0, isAscending);
+}
 
-                comp_ptr = val_ptr + valOffset;
-                std::sort(comp_ptr, comp_ptr + val.dims(0), op);
-            }
-        }
-    }
-    return;
+/// Sorts \p val along \p dim. The sorted lines are stored contiguously in
+/// the order of the remaining dimensions.
+template<typename T>
+void sortBatched(Param<T> val, const int dim, bool isAscending) {
+    sortLines<T, T>(val.get(), nullptr, val.dims(), val.strides(),
+                    val.strides(), dim, isAscending);
 }
 
 }  // namespace kernel
@@ -16,6 +16,8 @@ namespace kernel {
 template<typename Tk, typename Tv>
 void sort0ByKeyIterative(Param<Tk> okey, Param<Tv> oval, bool isAscending);
 
+/// Sorts the keys and values along \p dim. The sorted lines are stored
+/// contiguously in the order of the remaining dimensions.
 template<typename Tk, typename Tv>
 void sortByKeyBatched(Param<Tk> okey, Param<Tv> oval, const int dim,
                       bool isAscending);
@@ -0,0 +1,96 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <math.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace cpu {
+namespace kernel {
+
+/// Computes out = lhs * rhs for the BSR matrix lhs of \p values, \p rowIdx
+/// and \p colIdx
+template<typename T>
+void bsrmm(Param<T> out, CParam<T> values, CParam<int> rowIdx,
+           CParam<int> colIdx, CParam<T> rhs, const int blockSize) {
+    const int M     = out.dims(0);
+    const int N     = rhs.dims(0);
+    const int b     = blockSize;
+    const int Mb    = divup(M, b);
+    const T *vPtr   = values.get();
+    const int *rPtr = rowIdx.get();
+    const int *cPtr = colIdx.get();
+
+    for (dim_t o = 0; o < out.dims(1); ++o) {
+        T *oPtr       = out.get() + o * out.strides(1);
+        const T *xPtr = rhs.get() + o * rhs.strides(1);
+        std::fill(oPtr, oPtr + M, scalar<T>(0));
+
+        for (int br = 0; br < Mb; ++br) {
+            const int rows = std::min(b, M - br * b);
+            T *y           = oPtr + br * b;
+            for (int blk = rPtr[br]; blk < rPtr[br + 1]; ++blk) {
+                const T *v     = vPtr + blk * b * b;
+                const int col  = cPtr[blk] * b;
+                const int cols = std::min(b, N - col);
+                // Blocks are column major
+                for (int jj = 0; jj < cols; ++jj) {
+                    const T x = xPtr[col + jj];
+                    for (int ii = 0; ii < rows; ++ii) {
+                        y[ii] += v[jj * b + ii] * x;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// Computes out = lhs * rhs for the SELL matrix lhs of \p values, \p rowIdx
+/// and \p colIdx. The lanes of a slice are independent, so the inner loop
+/// over the rows of a slice vectorizes.
+template<typename T>
+void sellmm(Param<T> out, CParam<T> values, CParam<int> rowIdx,
+            CParam<int> colIdx, CParam<T> rhs, const int sliceSize) {
+    const int M       = out.dims(0);
+    const int C       = sliceSize;
+    const int S       = divup(M, C);
+    const T *vPtr     = values.get();
+    const int *offset = rowIdx.get();
+    const int *perm   = offset + S + 1;
+    const int *cPtr   = colIdx.get();
+
+    std::vector<T> acc(C);
+    for (dim_t o = 0; o < out.dims(1); ++o) {
+        T *oPtr       = out.get() + o * out.strides(1);
+        const T *xPtr = rhs.get() + o * rhs.strides(1);
+
+        for (int s = 0; s < S; ++s) {
+            const int width = (offset[s + 1] - offset[s]) / C;
+            std::fill(acc.begin(), acc.end(), scalar<T>(0));
+            for (int k = 0; k < width; ++k) {
+                const T *v   = vPtr + offset[s] + k * C;
+                const int *c = cPtr + offset[s] + k * C;
+                // The padding has the column -1 and the value 0
+                for (int r = 0; r < C; ++r) {
+                    acc[r] += v[r] * xPtr[std::max(c[r], 0)];
+                }
+            }
+            const int rows = std::min(C, M - s * C);
+            for (int r = 0; r < rows; ++r) { oPtr[perm[s * C + r]] = acc[r]; }
+        }
+    }
+}
+
+}  // namespace kernel
+}  // namespace cpu
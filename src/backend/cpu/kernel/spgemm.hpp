@@ -0,0 +1,121 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <math.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace cpu {
+namespace kernel {
+
+// The product of two CSR matrices is computed row by row (Gustavson). The
+// symbolic phase computes the pattern of the product and the numeric phase
+// its values, so a pattern can be reused by products with new values.
+
+/// Writes the row offsets of the product of the CSR matrices to \p oRowIdx
+static void spgemmRowIdx(Param<int> oRowIdx, CParam<int> lRowIdx,
+                         CParam<int> lColIdx, CParam<int> rRowIdx,
+                         CParam<int> rColIdx, const int N) {
+    const int M      = lRowIdx.dims(0) - 1;
+    int *orPtr       = oRowIdx.get();
+    const int *lrPtr = lRowIdx.get();
+    const int *lcPtr = lColIdx.get();
+    const int *rrPtr = rRowIdx.get();
+    const int *rcPtr = rColIdx.get();
+
+    // The last row each column was counted for
+    std::vector<int> marker(N, -1);
+    int nnz = 0;
+    for (int row = 0; row < M; ++row) {
+        orPtr[row] = nnz;
+        for (int l = lrPtr[row]; l < lrPtr[row + 1]; ++l) {
+            const int k = lcPtr[l];
+            for (int r = rrPtr[k]; r < rrPtr[k + 1]; ++r) {
+                const int col = rcPtr[r];
+                if (marker[col] != row) {
+                    marker[col] = row;
+                    nnz++;
+                }
+            }
+        }
+    }
+    orPtr[M] = nnz;
+}
+
+/// Writes the sorted column indices of each row of the product to \p oColIdx
+static void spgemmColIdx(Param<int> oColIdx, CParam<int> oRowIdx,
+                         CParam<int> lRowIdx, CParam<int> lColIdx,
+                         CParam<int> rRowIdx, CParam<int> rColIdx,
+                         const int N) {
+    const int M      = lRowIdx.dims(0) - 1;
+    int *ocPtr       = oColIdx.get();
+    const int *orPtr = oRowIdx.get();
+    const int *lrPtr = lRowIdx.get();
+    const int *lcPtr = lColIdx.get();
+    const int *rrPtr = rRowIdx.get();
+    const int *rcPtr = rColIdx.get();
+
+    std::vector<int> marker(N, -1);
+    for (int row = 0; row < M; ++row) {
+        int o = orPtr[row];
+        for (int l = lrPtr[row]; l < lrPtr[row + 1]; ++l) {
+            const int k = lcPtr[l];
+            for (int r = rrPtr[k]; r < rrPtr[k + 1]; ++r) {
+                const int col = rcPtr[r];
+                if (marker[col] != row) {
+                    marker[col] = row;
+                    ocPtr[o++]  = col;
+                }
+            }
+        }
+        std::sort(ocPtr + orPtr[row], ocPtr + orPtr[row + 1]);
+    }
+}
+
+/// Computes the values of the product in the pattern of \p oRowIdx and
+/// \p oColIdx
+template<typename T>
+void spgemmValues(Param<T> oVals, CParam<int> oRowIdx, CParam<int> oColIdx,
+                  CParam<T> lVals, CParam<int> lRowIdx, CParam<int> lColIdx,
+                  CParam<T> rVals, CParam<int> rRowIdx, CParam<int> rColIdx,
+                  const int N) {
+    const int M      = lRowIdx.dims(0) - 1;
+    T *ovPtr         = oVals.get();
+    const int *orPtr = oRowIdx.get();
+    const int *ocPtr = oColIdx.get();
+    const T *lvPtr   = lVals.get();
+    const int *lrPtr = lRowIdx.get();
+    const int *lcPtr = lColIdx.get();
+    const T *rvPtr   = rVals.get();
+    const int *rrPtr = rRowIdx.get();
+    const int *rcPtr = rColIdx.get();
+
+    // Dense accumulator of one row, which only holds zeros between the rows
+    std::vector<T> acc(N, scalar<T>(0));
+    for (int row = 0; row < M; ++row) {
+        for (int l = lrPtr[row]; l < lrPtr[row + 1]; ++l) {
+            const int k = lcPtr[l];
+            const T a   = lvPtr[l];
+            for (int r = rrPtr[k]; r < rrPtr[k + 1]; ++r) {
+                acc[rcPtr[r]] += a * rvPtr[r];
+            }
+        }
+        for (int o = orPtr[row]; o < orPtr[row + 1]; ++o) {
+            ovPtr[o]      = acc[ocPtr[o]];
+            acc[ocPtr[o]] = scalar<T>(0);
+        }
+    }
+}
+
+}  // namespace kernel
+}  // namespace cpu
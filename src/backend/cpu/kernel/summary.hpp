@@ -0,0 +1,91 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/Transform.hpp>
+#include <common/summary.hpp>
+#include <kernel/lines.hpp>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace cpu {
+namespace kernel {
+
+/// Accumulates the statistics of a summary in one pass over the values
+template<typename T>
+struct SummaryAccumulator {
+    using Ts = common::summary_sum_t<T>;
+
+    T min      = common::summaryMinInit<T>();
+    T max      = common::summaryMaxInit<T>();
+    Ts sum     = Ts(0);
+    Ts sumsq   = Ts(0);
+    uint count = 0;
+
+    void add(const T *ptr, const dim_t n) {
+        for (dim_t i = 0; i < n; ++i) {
+            const T v = ptr[i];
+            if (!IS_NAN(v)) {
+                min = std::min(min, v);
+                max = std::max(max, v);
+            }
+            const Ts s = static_cast<Ts>(v);
+            sum += s;
+            sumsq += s * s;
+            count += v != T(0);
+        }
+    }
+};
+
+/// Computes the statistics of all the values of \p in in one pass. The
+/// values are split into blocks of LINE_BLOCK_ELEMENTS values in the order
+/// of a linear array, which are reduced by the thread pool.
+template<typename T>
+void summary_all(common::Summary *out, CParam<T> in) {
+    using Ts               = common::summary_sum_t<T>;
+    const af::dim4 dims    = in.dims();
+    const af::dim4 strides = in.strides();
+    const dim_t elements   = dims.elements();
+    const dim_t blocks     = divup(elements, LINE_BLOCK_ELEMENTS);
+
+    std::vector<T> mins(blocks), maxs(blocks);
+    std::vector<Ts> sums(blocks), sumsqs(blocks);
+    std::vector<uint> counts(blocks);
+    parallelFor(blocks, LINE_BLOCK_ELEMENTS, [&](dim_t first, dim_t last) {
+        for (dim_t b = first; b < last; ++b) {
+            SummaryAccumulator<T> acc;
+            dim_t e         = b * LINE_BLOCK_ELEMENTS;
+            const dim_t end = std::min(e + LINE_BLOCK_ELEMENTS, elements);
+            // The block is made of segments of the lines along dim 0
+            while (e < end) {
+                const dim_t i   = e % dims[0];
+                const dim_t len = std::min(dims[0] - i, end - e);
+                const dim_t off =
+                    i + lineOffset(dims, 0, e / dims[0], strides);
+                acc.add(in.get() + off, len);
+                e += len;
+            }
+            mins[b]   = acc.min;
+            maxs[b]   = acc.max;
+            sums[b]   = acc.sum;
+            sumsqs[b] = acc.sumsq;
+            counts[b] = acc.count;
+        }
+    });
+
+    *out = common::combineSummaries<T>(mins.data(), maxs.data(), sums.data(),
+                                       sumsqs.data(), counts.data(), blocks);
+}
+
+}  // namespace kernel
+}  // namespace cpu
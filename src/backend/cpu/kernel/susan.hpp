@@ -9,6 +9,9 @@
 
 #pragma once
 #include <Param.hpp>
+#include <parallel_for.hpp>
+
+#include <algorithm>
 
 namespace cpu {
 namespace kernel {
@@ -23,7 +26,7 @@ void susan_responses(Param<T> output, CParam<T> input, const dim_t idim0,
     const unsigned r = border_len;
     const int rSqrd  = radius * radius;
 
-    for (dim_t y = r; y < idim1 - r; ++y) {
+    auto responseRow = [&](const dim_t y) {
         for (dim_t x = r; x < idim0 - r; ++x) {
             const dim_t idx = y * idim0 + x;
             T m_0           = in[idx];
@@ -44,7 +47,13 @@ void susan_responses(Param<T> output, CParam<T> input, const dim_t idim0,
 
             resp_out[idx] = nM < g ? g - nM : T(0);
         }
-    }
+    };
+
+    // The rows are independent, so they are split across the thread pool
+    const dim_t rowCount = std::max<dim_t>(idim1 - 2 * dim_t(r), 0);
+    parallelFor(rowCount, idim0 * 4 * rSqrd, [&](dim_t first, dim_t last) {
+        for (dim_t y = first; y < last; ++y) { responseRow(y + r); }
+    });
 }
 
 template<typename T>
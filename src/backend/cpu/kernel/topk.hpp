@@ -0,0 +1,180 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <platform.hpp>
+#include <thread_pool.hpp>
+#include <types.hpp>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace cpu {
+namespace kernel {
+
+/// The smallest number of elements selected by one task of the thread pool
+constexpr dim_t TOPK_MIN_TASK_ELEMENTS = 1 << 16;
+
+/// The number of elements compared with the worst selected value at once.
+/// Blocks without a better value do not touch the heap.
+constexpr dim_t TOPK_BLOCK_ELEMENTS = 16;
+
+/// A value and its index along the line
+template<typename T>
+using TopkEntry = std::pair<compute_t<T>, unsigned>;
+
+/// Orders the entries from the best to the worst. Equal values are ordered
+/// by their index so the first occurrences are selected.
+template<typename T, bool IsMax>
+struct TopkBetter {
+    bool operator()(const TopkEntry<T> &a, const TopkEntry<T> &b) const {
+        if (a.first == b.first) { return a.second < b.second; }
+        return IsMax ? a.first > b.first : a.first < b.first;
+    }
+};
+
+/// Selects the \p k best values of ptr[begin, end) into \p heap.
+///
+/// The heap holds the best values seen so far with the worst of them on
+/// top. Only the values better than the top are inserted, so most of the
+/// line is a comparison with the top which the compiler can vectorize.
+template<typename T, bool IsMax>
+void selectTopk(std::vector<TopkEntry<T>> &heap, const T *ptr,
+                const dim_t begin, const dim_t end, const int k) {
+    using value_t = compute_t<T>;
+    const TopkBetter<T, IsMax> better;
+
+    heap.clear();
+    dim_t i = begin;
+    for (; i < end && static_cast<int>(heap.size()) < k; ++i) {
+        heap.emplace_back(value_t(ptr[i]), static_cast<unsigned>(i));
+        std::push_heap(heap.begin(), heap.end(), better);
+    }
+
+    while (i < end) {
+        const dim_t blockEnd    = std::min(i + TOPK_BLOCK_ELEMENTS, end);
+        const value_t threshold = heap.front().first;
+
+        bool found = false;
+        for (dim_t j = i; j < blockEnd; ++j) {
+            const value_t val = value_t(ptr[j]);
+            found |= IsMax ? val > threshold : val < threshold;
+        }
+        if (found) {
+            for (dim_t j = i; j < blockEnd; ++j) {
+                TopkEntry<T> entry(value_t(ptr[j]), static_cast<unsigned>(j));
+                if (better(entry, heap.front())) {
+                    std::pop_heap(heap.begin(), heap.end(), better);
+                    heap.back() = entry;
+                    std::push_heap(heap.begin(), heap.end(), better);
+                }
+            }
+        }
+        i = blockEnd;
+    }
+}
+
+/// Selects the \p k best values along the first dimension of \p in.
+///
+/// Each line is streamed once through a heap of k entries, so no memory
+/// proportional to the input is allocated. Lines are split across the thread
+/// pool. When there are fewer lines than threads, long lines are split into
+/// segments whose selections are merged at the end.
+template<typename T, bool IsMax>
+void topk(Param<T> values, Param<unsigned> indices, CParam<T> in,
+          const int k) {
+    const af::dim4 idims    = in.dims();
+    const af::dim4 istrides = in.strides();
+    const af::dim4 vstrides = values.strides();
+    const af::dim4 xstrides = indices.strides();
+    const TopkBetter<T, IsMax> better;
+
+    const dim_t n      = idims[0];
+    const dim_t nlines = idims[1] * idims[2] * idims[3];
+    if (nlines == 0 || n == 0) { return; }
+
+    auto lineOffset = [&](dim_t line, const af::dim4 &strides) {
+        const dim_t i1 = line % idims[1];
+        const dim_t i2 = (line / idims[1]) % idims[2];
+        const dim_t i3 = line / (idims[1] * idims[2]);
+        return i1 * strides[1] + i2 * strides[2] + i3 * strides[3];
+    };
+
+    // Writes the selected entries of a line from the best to the worst
+    auto writeLine = [&](dim_t line, std::vector<TopkEntry<T>> &entries) {
+        std::sort(entries.begin(), entries.end(), better);
+        const T *iptr = in.get() + lineOffset(line, istrides);
+        T *vptr       = values.get() + lineOffset(line, vstrides);
+        unsigned *xptr = indices.get() + lineOffset(line, xstrides);
+        for (int j = 0; j < k; ++j) {
+            xptr[j] = entries[j].second;
+            vptr[j] = iptr[entries[j].second];
+        }
+    };
+
+    thread_pool &pool = getThreadPool();
+    const dim_t threads = pool.size();
+    const dim_t segments =
+        nlines >= threads
+            ? 1
+            : std::max<dim_t>(1, std::min(threads / nlines,
+                                          n / TOPK_MIN_TASK_ELEMENTS));
+
+    if (segments == 1) {
+        const dim_t ntasks = std::max<dim_t>(
+            1, std::min({threads, nlines,
+                         nlines * n / TOPK_MIN_TASK_ELEMENTS}));
+        const dim_t linesPerTask = divup(nlines, ntasks);
+        pool.run(static_cast<int>(ntasks), [&](int task) {
+            std::vector<TopkEntry<T>> heap;
+            heap.reserve(k);
+            const dim_t first = task * linesPerTask;
+            const dim_t last  = std::min(first + linesPerTask, nlines);
+            for (dim_t line = first; line < last; ++line) {
+                selectTopk<T, IsMax>(heap,
+                                     in.get() + lineOffset(line, istrides),
+                                     0, n, k);
+                writeLine(line, heap);
+            }
+        });
+        return;
+    }
+
+    const dim_t segmentLength = divup(n, segments);
+    std::vector<std::vector<TopkEntry<T>>> heaps(nlines * segments);
+    pool.run(static_cast<int>(nlines * segments), [&](int task) {
+        const dim_t line  = task / segments;
+        const dim_t begin = (task % segments) * segmentLength;
+        heaps[task].reserve(k);
+        selectTopk<T, IsMax>(heaps[task], in.get() + lineOffset(line, istrides),
+                             begin, std::min(begin + segmentLength, n), k);
+    });
+
+    std::vector<TopkEntry<T>> merged;
+    merged.reserve(segments * k);
+    for (dim_t line = 0; line < nlines; ++line) {
+        merged.clear();
+        for (dim_t s = 0; s < segments; ++s) {
+            const auto &heap = heaps[line * segments + s];
+            merged.insert(merged.end(), heap.begin(), heap.end());
+        }
+        std::nth_element(merged.begin(), merged.begin() + (k - 1),
+                         merged.end(), better);
+        merged.resize(k);
+        writeLine(line, merged);
+    }
+}
+
+}  // namespace kernel
+}  // namespace cpu
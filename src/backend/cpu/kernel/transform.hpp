@@ -10,8 +10,10 @@
 #pragma once
 #include <Param.hpp>
 #include <err_cpu.hpp>
+#include <parallel_for.hpp>
 #include <af/traits.hpp>
 #include <type_traits>
+#include <vector>
 #include "interp.hpp"
 
 namespace cpu {
@@ -88,54 +90,66 @@ void transform(Param<T> output, CParam<T> input, CParam<float> transform,
 
     int batch_size = 1;
     if (idims[2] != tdims[2]) batch_size = idims[2];
+    if (odims.elements() == 0) return;
+
+    // The inverse matrices of the images are computed once and the rows of
+    // all the images are then transformed by the thread pool
+    const int groups = divup((int)odims[2], batch_size);
+    const int images = groups * (int)odims[3];
+    std::vector<float> tmats(images * 9);
+    for (int image = 0; image < images; image++) {
+        const int idz = (image % groups) * batch_size;
+        const int idw = image / groups;
+        dim_t tf_off  = (tdims[3] > 1) * idw * tstrides[3] +
+                       (tdims[2] > 1) * idz * tstrides[2];
+        calc_transform_inverse(tmats.data() + image * 9, tf + tf_off, inverse,
+                               perspective, perspective ? 9 : 6);
+    }
 
-    Interp2<T, WT, order> interp;
-    for (int idw = 0; idw < (int)odims[3]; idw++) {
-        dim_t out_offw = idw * ostrides[3];
-        dim_t in_offw  = (idims[3] > 1) * idw * istrides[3];
-        dim_t tf_offw  = (tdims[3] > 1) * idw * tstrides[3];
-
-        for (int idz = 0; idz < (int)odims[2]; idz += batch_size) {
-            dim_t out_offzw = out_offw + idz * ostrides[2];
-            dim_t in_offzw  = in_offw + (idims[2] > 1) * idz * istrides[2];
-            dim_t tf_offzw  = tf_offw + (tdims[2] > 1) * idz * tstrides[2];
-
-            const float *tptr = tf + tf_offzw;
+    auto transformRow = [&](const int image, const int idy) {
+        Interp2<T, WT, order> interp;
+        const int idz = (image % groups) * batch_size;
+        const int idw = image / groups;
 
-            float tmat[9];
-            calc_transform_inverse(tmat, tptr, inverse, perspective,
-                                   perspective ? 9 : 6);
+        const float *tmat = tmats.data() + image * 9;
+        dim_t out_offzw   = idw * ostrides[3] + idz * ostrides[2];
+        dim_t in_offzw    = (idims[3] > 1) * idw * istrides[3] +
+                         (idims[2] > 1) * idz * istrides[2];
 
-            for (int idy = 0; idy < (int)odims[1]; idy++) {
-                for (int idx = 0; idx < (int)odims[0]; idx++) {
-                    WT xidi = idx * tmat[0] + idy * tmat[1] + tmat[2];
-                    WT yidi = idx * tmat[3] + idy * tmat[4] + tmat[5];
+        for (int idx = 0; idx < (int)odims[0]; idx++) {
+            WT xidi = idx * tmat[0] + idy * tmat[1] + tmat[2];
+            WT yidi = idx * tmat[3] + idy * tmat[4] + tmat[5];
 
-                    if (perspective) {
-                        WT W = idx * tmat[6] + idy * tmat[7] + tmat[8];
-                        xidi /= W;
-                        yidi /= W;
-                    }
+            if (perspective) {
+                WT W = idx * tmat[6] + idy * tmat[7] + tmat[8];
+                xidi /= W;
+                yidi /= W;
+            }
 
-                    // FIXME: Nearest and lower do not do clamping, but other
-                    // methods do Make it consistent
-                    bool clamp = order != 1;
-                    bool condX = xidi >= -0.0001 && xidi < idims[0];
-                    bool condY = yidi >= -0.0001 && yidi < idims[1];
-
-                    int ooff = out_offzw + idy * ostrides[1] + idx;
-                    if (condX && condY) {
-                        interp(output, ooff, input, in_offzw, xidi, yidi,
-                               method, batch_size, clamp);
-                    } else {
-                        for (int n = 0; n < batch_size; n++) {
-                            out[ooff + n * ostrides[2]] = scalar<T>(0);
-                        }
-                    }
+            // FIXME: Nearest and lower do not do clamping, but other
+            // methods do Make it consistent
+            bool clamp = order != 1;
+            bool condX = xidi >= -0.0001 && xidi < idims[0];
+            bool condY = yidi >= -0.0001 && yidi < idims[1];
+
+            int ooff = out_offzw + idy * ostrides[1] + idx;
+            if (condX && condY) {
+                interp(output, ooff, input, in_offzw, xidi, yidi, method,
+                       batch_size, clamp);
+            } else {
+                for (int n = 0; n < batch_size; n++) {
+                    out[ooff + n * ostrides[2]] = scalar<T>(0);
                 }
             }
         }
-    }
+    };
+
+    parallelFor(images * odims[1], odims[0] * batch_size,
+                [&](dim_t first, dim_t last) {
+                    for (dim_t unit = first; unit < last; unit++) {
+                        transformRow(unit / odims[1], unit % odims[1]);
+                    }
+                });
 }
 
 }  // namespace kernel
@@ -9,9 +9,14 @@
 
 #pragma once
 #include <Param.hpp>
+#include <common/dispatch.hpp>
 #include <err_cpu.hpp>
+#include <platform.hpp>
+#include <thread_pool.hpp>
 #include <utility.hpp>
 
+#include <algorithm>
+
 namespace cpu {
 namespace kernel {
 
@@ -22,119 +27,130 @@ T getConjugate(const T &in) {
 }
 
 template<>
-cfloat getConjugate(const cfloat &in) {
+inline cfloat getConjugate(const cfloat &in) {
     return std::conj(in);
 }
 
 template<>
-cdouble getConjugate(const cdouble &in) {
+inline cdouble getConjugate(const cdouble &in) {
     return std::conj(in);
 }
 
-template<typename T, int M, int N>
-void transpose_kernel(T *output, const T *input, int ostride, int istride) {
-    for (int j = 0; j < N; j++) {
-        for (int i = 0; i < M; i++) { output[i * ostride] = input[i]; }
-        input += istride;
-        output++;
-    }
-}
+/// The side of the blocks of the output written together
+constexpr dim_t TRANSPOSE_BLOCK = 8;
 
+/// The number of output columns transposed together. The input cache lines
+/// read for a block of rows are used by all the columns of the band before
+/// they are evicted, while the output columns are written sequentially.
+/// Wider bands of the larger types touch too many output pages at once.
 template<typename T>
-void transpose_real(Param<T> output, CParam<T> input) {
-    const af::dim4 odims    = output.dims();
-    const af::dim4 ostrides = output.strides();
-    const af::dim4 istrides = input.strides();
-
-    T *out            = output.get();
-    T const *const in = input.get();
-
-    constexpr int M = 8;
-    constexpr int N = 8;
+constexpr dim_t transposeBandWidth() {
+    return sizeof(T) <= 4 ? 4 * TRANSPOSE_BLOCK : TRANSPOSE_BLOCK;
+}
 
-    dim_t odims1_down = floor(odims[1] / N) * N;
-    dim_t odims0_down = floor(odims[0] / M) * M;
+/// The smallest number of elements transposed by one task of the thread pool
+constexpr dim_t TRANSPOSE_MIN_TASK_ELEMENTS = 1 << 16;
 
-    for (dim_t l = 0; l < odims[3]; ++l) {
-        for (dim_t k = 0; k < odims[2]; ++k) {
-            // Outermost loop handles batch mode
-            // if input has no data along third dimension
-            // this loop runs only once
-            T *out_      = out + l * ostrides[3] + k * ostrides[2];
-            const T *in_ = in + l * istrides[3] + k * istrides[2];
-
-            if (odims1_down > 0) {
-                for (dim_t j = 0; j <= odims1_down; j += N) {
-                    for (dim_t i = 0; i < odims0_down; i += M) {
-                        transpose_kernel<T, M, N>(out_, in_, ostrides[1],
-                                                  istrides[1]);
-                        out_ += M;
-                        in_ += istrides[1] * N;
-                    }
+template<typename T, bool conjugate>
+T transposeValue(const T &in) {
+    return conjugate ? getConjugate(in) : in;
+}
 
-                    for (dim_t jj = 0; jj < N; jj++) {
-                        for (dim_t i = odims0_down; i < odims[0]; i++) {
-                            *out_ = *in_;
-                            out_++;
-                            in_ += istrides[1];
-                        }
-                        out_ += ostrides[1] - (odims[0] - odims0_down);
-                        in_ -= (odims[0] - odims0_down) * istrides[1] - 1;
-                    }
-                    out_ = out + l * ostrides[3] + k * ostrides[2] +
-                           j * ostrides[1];
-                    in_ = in + l * istrides[3] + k * istrides[2] + j;
+/// Sets out[a + b * ostride] to in[b + a * istride] for a < na and b < nb.
+///
+/// The output is written in blocks of TRANSPOSE_BLOCK x TRANSPOSE_BLOCK
+/// elements. The columns of a block are written contiguously while its
+/// rows are read from the same few input cache lines.
+template<typename T, bool conjugate>
+void transposeBand(T *out, dim_t ostride, const T *in, dim_t istride,
+                   dim_t na, dim_t nb) {
+    constexpr dim_t B  = TRANSPOSE_BLOCK;
+    const dim_t naDown = na - na % B;
+    const dim_t nbDown = nb - nb % B;
+
+    for (dim_t a = 0; a < naDown; a += B) {
+        for (dim_t b = 0; b < nbDown; b += B) {
+            const T *src = in + b + a * istride;
+            T *dst       = out + a + b * ostride;
+            for (dim_t j = 0; j < B; ++j) {
+                for (dim_t i = 0; i < B; ++i) {
+                    dst[i + j * ostride] =
+                        transposeValue<T, conjugate>(src[j + i * istride]);
                 }
             }
-            for (dim_t j = odims1_down; j < odims[1]; j++) {
-                out_ =
-                    out + l * ostrides[3] + k * ostrides[2] + j * ostrides[1];
-                in_ = in + l * istrides[3] + k * istrides[2] + j;
-                for (dim_t i = 0; i < odims[0]; i++) {
-                    *out_ = *in_;
-                    out_++;
-                    in_ += istrides[1];
-                }
+        }
+        for (dim_t j = nbDown; j < nb; ++j) {
+            for (dim_t i = a; i < a + B; ++i) {
+                out[i + j * ostride] =
+                    transposeValue<T, conjugate>(in[j + i * istride]);
             }
         }
     }
+    for (dim_t j = 0; j < nb; ++j) {
+        for (dim_t i = naDown; i < na; ++i) {
+            out[i + j * ostride] =
+                transposeValue<T, conjugate>(in[j + i * istride]);
+        }
+    }
 }
 
-template<typename T>
-void transpose_conj(Param<T> output, CParam<T> input) {
+/// Transposes a batch of na x nb planes with transposeBand.
+///
+/// Element (a, b) of an output plane is element (b, a) of the input plane.
+/// The planes are ordered along two batch dimensions of \p bdims elements
+/// with the output strides \p obstrides and the input strides
+/// \p ibstrides. The bands of every plane are distributed over the thread
+/// pool.
+template<typename T, bool conjugate>
+void transposeBatched(T *out, dim_t ostride, const T *in, dim_t istride,
+                      dim_t na, dim_t nb, const dim_t bdims[2],
+                      const dim_t obstrides[2], const dim_t ibstrides[2]) {
+    constexpr dim_t band = transposeBandWidth<T>();
+    const dim_t bands    = divup(nb, band);
+    const dim_t units = bands * bdims[0] * bdims[1];
+    if (units == 0 || na == 0) { return; }
+
+    thread_pool &pool  = getThreadPool();
+    const dim_t ntasks = std::max<dim_t>(
+        1, std::min({static_cast<dim_t>(pool.size()), units,
+                     na * nb * bdims[0] * bdims[1] /
+                         TRANSPOSE_MIN_TASK_ELEMENTS}));
+    const dim_t unitsPerTask = divup(units, ntasks);
+
+    pool.run(static_cast<int>(ntasks), [&](int task) {
+        const dim_t first = task * unitsPerTask;
+        const dim_t last  = std::min(first + unitsPerTask, units);
+        for (dim_t unit = first; unit < last; ++unit) {
+            const dim_t b  = (unit % bands) * band;
+            const dim_t b0 = (unit / bands) % bdims[0];
+            const dim_t b1 = unit / (bands * bdims[0]);
+            T *o       = out + b0 * obstrides[0] + b1 * obstrides[1];
+            const T *i = in + b0 * ibstrides[0] + b1 * ibstrides[1];
+            transposeBand<T, conjugate>(o + b * ostride, ostride, i + b,
+                                        istride, na,
+                                        std::min(band, nb - b));
+        }
+    });
+}
+
+template<typename T, bool conjugate>
+void transpose_blocked(Param<T> output, CParam<T> input) {
     const af::dim4 odims    = output.dims();
     const af::dim4 ostrides = output.strides();
     const af::dim4 istrides = input.strides();
 
-    T *out            = output.get();
-    T const *const in = input.get();
-
-    for (dim_t l = 0; l < odims[3]; ++l) {
-        for (dim_t k = 0; k < odims[2]; ++k) {
-            // Outermost loop handles batch mode
-            // if input has no data along third dimension
-            // this loop runs only once
-
-            for (dim_t j = 0; j < odims[1]; ++j) {
-                for (dim_t i = 0; i < odims[0]; ++i) {
-                    // calculate array indices based on offsets and strides
-                    // the helper getIdx takes care of indices
-                    const dim_t inIdx  = getIdx(istrides, j, i, k, l);
-                    const dim_t outIdx = getIdx(ostrides, i, j, k, l);
-                    out[outIdx]        = getConjugate(in[inIdx]);
-                }
-            }
-            // outData and inData pointers doesn't need to be
-            // offset as the getIdx function is taking care
-            // of the batch parameter
-        }
-    }
+    const dim_t bdims[2]     = {odims[2], odims[3]};
+    const dim_t obstrides[2] = {ostrides[2], ostrides[3]};
+    const dim_t ibstrides[2] = {istrides[2], istrides[3]};
+    transposeBatched<T, conjugate>(output.get(), ostrides[1], input.get(),
+                                   istrides[1], odims[0], odims[1], bdims,
+                                   obstrides, ibstrides);
 }
 
 template<typename T>
 void transpose(Param<T> out, CParam<T> in, const bool conjugate) {
-    return (conjugate ? transpose_conj<T>(out, in)
-                      : transpose_real<T>(out, in));
+    return (conjugate ? transpose_blocked<T, true>(out, in)
+                      : transpose_blocked<T, false>(out, in));
 }
 
 template<typename T, bool conjugate>
@@ -9,8 +9,10 @@
 
 #pragma once
 #include <Param.hpp>
+#include <common/Binary.hpp>
 #include <err_cpu.hpp>
 #include <math.hpp>
+#include <parallel_for.hpp>
 
 namespace cpu {
 namespace kernel {
@@ -78,5 +80,58 @@ void unwrap_dim(Param<T> out, CParam<T> in, const dim_t wx, const dim_t wy,
     }
 }
 
+/// Reduces the windows which unwrap_dim copies to the columns of its output
+/// with \p op. The padding is reduced as zeros. out holds the nx x ny grid
+/// of the windows of each image.
+template<af_op_t op, typename T>
+void unwrapReduce(Param<T> out, CParam<T> in, const dim_t wx, const dim_t wy,
+                  const dim_t sx, const dim_t sy, const dim_t px,
+                  const dim_t py) {
+    const af::dim4 idims    = in.dims();
+    const af::dim4 odims    = out.dims();
+    const af::dim4 istrides = in.strides();
+    const af::dim4 ostrides = out.strides();
+
+    // The rows of windows of all the images are reduced by the thread pool
+    parallelFor(
+        odims[1] * odims[2] * odims[3], odims[0] * wx * wy,
+        [&](dim_t first, dim_t last) {
+            common::Binary<T, op> reduce;
+            for (dim_t row = first; row < last; ++row) {
+                const dim_t winy = row % odims[1];
+                const dim_t z    = (row / odims[1]) % odims[2];
+                const dim_t w    = row / (odims[1] * odims[2]);
+
+                const T *iptr = in.get() + w * istrides[3] + z * istrides[2];
+                T *optr = out.get() + w * ostrides[3] + z * ostrides[2] +
+                          winy * ostrides[1];
+
+                const dim_t spy = winy * sy - py;
+                for (dim_t winx = 0; winx < odims[0]; ++winx) {
+                    const dim_t spx = winx * sx - px;
+
+                    // Only the part of the window inside of the image is
+                    // read, the padding is reduced once as a zero
+                    const dim_t x0 = std::max<dim_t>(spx, 0);
+                    const dim_t x1 = std::min<dim_t>(spx + wx, idims[0]);
+                    const dim_t y0 = std::max<dim_t>(spy, 0);
+                    const dim_t y1 = std::min<dim_t>(spy + wy, idims[1]);
+
+                    T acc = common::Binary<T, op>::init();
+                    for (dim_t y = y0; y < y1; ++y) {
+                        const T *irow = iptr + y * istrides[1];
+                        for (dim_t x = x0; x < x1; ++x) {
+                            acc = reduce(acc, irow[x]);
+                        }
+                    }
+                    if ((x1 - x0) * (y1 - y0) < wx * wy) {
+                        acc = reduce(acc, scalar<T>(0));
+                    }
+                    optr[winx] = acc;
+                }
+            }
+        });
+}
+
 }  // namespace kernel
 }  // namespace cpu
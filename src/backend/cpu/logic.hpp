@@ -72,10 +72,9 @@ Array<char> logicOp(const Array<T> &lhs, const Array<T> &rhs,
     common::Node_ptr lhs_node = lhs.getNode();
     common::Node_ptr rhs_node = rhs.getNode();
 
-    jit::BinaryNode<char, T, op> *node =
-        new jit::BinaryNode<char, T, op>(lhs_node, rhs_node);
-
-    return createNodeArray<char>(odims, common::Node_ptr(node));
+    return createNodeArray<char>(
+        odims, common::makePooled<jit::BinaryNode<char, T, op>>(lhs_node,
+                                                                rhs_node));
 }
 
 #define BITWISE_FN(OP, op)                                               \
@@ -101,9 +100,8 @@ Array<T> bitOp(const Array<T> &lhs, const Array<T> &rhs,
     common::Node_ptr lhs_node = lhs.getNode();
     common::Node_ptr rhs_node = rhs.getNode();
 
-    jit::BinaryNode<T, T, op> *node =
-        new jit::BinaryNode<T, T, op>(lhs_node, rhs_node);
-
-    return createNodeArray<T>(odims, common::Node_ptr(node));
+    return createNodeArray<T>(
+        odims, common::makePooled<jit::BinaryNode<T, T, op>>(lhs_node,
+                                                             rhs_node));
 }
 }  // namespace cpu
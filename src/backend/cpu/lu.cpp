@@ -15,6 +15,7 @@
 #include <kernel/lu.hpp>
 #include <lapack_helper.hpp>
 #include <math.hpp>
+#include <parallel_for.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <range.hpp>
@@ -55,8 +56,8 @@ void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot,
     pivot            = lu_inplace(in_copy);
 
     // SPLIT into lower and upper
-    dim4 ldims(M, min(M, N));
-    dim4 udims(min(M, N), N);
+    dim4 ldims(M, min(M, N), iDims[2], iDims[3]);
+    dim4 udims(min(M, N), N, iDims[2], iDims[3]);
     lower = createEmptyArray<T>(ldims);
     upper = createEmptyArray<T>(udims);
 
@@ -65,19 +66,27 @@ void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot,
 
 template<typename T>
 Array<int> lu_inplace(Array<T> &in, const bool convert_pivot) {
-    dim4 iDims = in.dims();
-    Array<int> pivot =
-        createEmptyArray<int>(af::dim4(min(iDims[0], iDims[1]), 1, 1, 1));
+    dim4 iDims       = in.dims();
+    Array<int> pivot = createEmptyArray<int>(
+        af::dim4(min(iDims[0], iDims[1]), 1, iDims[2], iDims[3]));
 
+    // The matrices of a batch are factorized concurrently
     auto func = [=](Param<T> in, Param<int> pivot) {
         dim4 iDims = in.dims();
-        getrf_func<T>()(AF_LAPACK_COL_MAJOR, iDims[0], iDims[1], in.get(),
-                        in.strides(1), pivot.get());
+        parallelForSlices(
+            iDims, iDims[0] * iDims[1] * min(iDims[0], iDims[1]),
+            [&](dim_t z, dim_t w) {
+                getrf_func<T>()(
+                    AF_LAPACK_COL_MAJOR, iDims[0], iDims[1],
+                    in.get() + z * in.strides(2) + w * in.strides(3),
+                    in.strides(1),
+                    pivot.get() + z * pivot.strides(2) + w * pivot.strides(3));
+            });
     };
     getQueue().enqueue(func, in, pivot);
 
     if (convert_pivot) {
-        Array<int> p = range<int>(dim4(iDims[0]), 0);
+        Array<int> p = range<int>(dim4(iDims[0], 1, iDims[2], iDims[3]), 0);
         getQueue().enqueue(kernel::convertPivot, p, pivot);
         return p;
     } else {
@@ -10,9 +10,13 @@
 #include <memory.hpp>
 
 #include <common/DefaultMemoryManager.hpp>
+#include <common/GraphCapture.hpp>
 #include <common/Logger.hpp>
+#include <common/RegisteredHostMemory.hpp>
+#include <common/bfloat16.hpp>
 #include <common/half.hpp>
 #include <err_cpu.hpp>
+#include <host_allocator.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <spdlog/spdlog.h>
@@ -22,7 +26,9 @@
 #include <utility>
 
 using af::dim4;
+using common::bfloat16;
 using common::bytesToString;
+using common::keepCapturedBuffer;
 using common::half;
 using std::function;
 using std::move;
@@ -69,7 +75,15 @@ void *memAllocUser(const size_t &bytes) {
 
 template<typename T>
 void memFree(T *ptr) {
-    return memoryManager().unlock(static_cast<void *>(ptr), false);
+    // The replays of a graph use the buffers freed while it was captured
+    if (keepCapturedBuffer(static_cast<int>(getActiveDeviceId()), ptr)) {
+        return;
+    }
+    // A buffer freed while the tasks of its thread still use it must not be
+    // reused by the queue of another thread
+    releaseAfterQueuedTasks([ptr]() {
+        memoryManager().unlock(static_cast<void *>(ptr), false);
+    });
 }
 
 void memFreeUser(void *ptr) { memoryManager().unlock(ptr, true); }
@@ -99,6 +113,23 @@ void pinnedFree(T *ptr) {
     memoryManager().unlock(static_cast<void *>(ptr), false);
 }
 
+size_t pinnedAllocated(const void *ptr) {
+    const size_t bytes = memoryManager().allocated(const_cast<void *>(ptr));
+    return bytes ? bytes : common::registeredHostBytes(ptr);
+}
+
+// The CPU backend reads host memory directly, so the registration only
+// records the memory for the asynchronous transfers
+void registerHostMemory(void *ptr, const size_t bytes) {
+    common::addRegisteredHostMemory(ptr, bytes);
+}
+
+void unregisterHostMemory(void *ptr) {
+    if (!common::removeRegisteredHostMemory(ptr)) {
+        AF_ERROR("The host memory is not registered", AF_ERR_ARG);
+    }
+}
+
 #define INSTANTIATE(T)                                                \
     template std::unique_ptr<T[], std::function<void(T *)>> memAlloc( \
         const size_t &elements);                                      \
@@ -119,6 +150,7 @@ INSTANTIATE(uintl)
 INSTANTIATE(ushort)
 INSTANTIATE(short)
 INSTANTIATE(half)
+INSTANTIATE(bfloat16)
 
 Allocator::Allocator() { logger = common::loggerFactory("mem"); }
 
@@ -142,7 +174,7 @@ size_t Allocator::getMaxMemorySize(int id) {
 }
 
 void *Allocator::nativeAlloc(const size_t bytes) {
-    void *ptr = malloc(bytes);  // NOLINT(hicpp-no-malloc)
+    void *ptr = hostAlloc(bytes);
     AF_TRACE("nativeAlloc: {:>7} {}", bytesToString(bytes), ptr);
     if (!ptr) { AF_ERROR("Unable to allocate memory", AF_ERR_NO_MEM); }
     return ptr;
@@ -151,8 +183,8 @@ void *Allocator::nativeAlloc(const size_t bytes) {
 void Allocator::nativeFree(void *ptr) {
     AF_TRACE("nativeFree: {: >8} {}", " ", ptr);
     // Make sure this pointer is not being used on the queue before freeing the
-    // memory.
-    getQueue().sync();
-    free(ptr);  // NOLINT(hicpp-no-malloc)
+    // memory. The worker of a queue has already run the previous tasks.
+    if (!getQueue().is_worker()) { getQueue().sync(); }
+    hostFree(ptr);
 }
 }  // namespace cpu
@@ -8,50 +8,98 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <blas.hpp>
 #include <err_cpu.hpp>
 #include <kernel/nearest_neighbour.hpp>
 #include <math.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
-#include <topk.hpp>
+#include <transpose.hpp>
 #include <af/dim4.hpp>
 
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
 using af::dim4;
 
 namespace cpu {
 
+namespace {
+/// The maximum number of distances computed by a single matrix multiplication
+/// when the squared euclidean distances are computed from the norms
+constexpr dim_t NN_GEMM_BLOCK_ELEMENTS = 1 << 22;
+
+/// Finds the nearest neighbours using ||q||^2 + ||t||^2 - 2 q.t, where the
+/// products of the queries with a block of training samples are computed
+/// with gemm. The candidates of each block are merged into the results
+/// before the next block is computed.
+template<typename T, typename To>
+typename std::enable_if<std::is_floating_point<T>::value>::type
+nearestNeighbourSSD(Array<uint>& idx, Array<To>& dist, const Array<T>& query,
+                    const Array<T>& train, const uint n_dist) {
+    const dim_t nQuery = query.dims()[1];
+    const dim_t nTrain = train.dims()[1];
+
+    Array<T> qNorms = createEmptyArray<T>(dim4(nQuery));
+    Array<T> tNorms = createEmptyArray<T>(dim4(nTrain));
+    getQueue().enqueue(kernel::squaredNorms<T>, qNorms, query);
+    getQueue().enqueue(kernel::squaredNorms<T>, tNorms, train);
+
+    const T alpha = T(-2);
+    const T beta  = T(0);
+    const dim_t blockSize =
+        std::min(nTrain, std::max<dim_t>(1, NN_GEMM_BLOCK_ELEMENTS / nQuery));
+    for (dim_t offset = 0; offset < nTrain; offset += blockSize) {
+        const dim_t len = std::min(blockSize, nTrain - offset);
+        std::vector<af_seq> idxs(4, af_span);
+        idxs[1] = af_seq{double(offset), double(offset + len - 1), 1.0};
+
+        Array<T> block = createSubArray(train, idxs);
+        Array<T> prods = createEmptyArray<T>(dim4(len, nQuery));
+        gemm(prods, AF_MAT_TRANS, AF_MAT_NONE, &alpha, block, query, &beta);
+        getQueue().enqueue(kernel::mergeSSD<T>, idx, dist, prods, qNorms,
+                           tNorms, offset, n_dist);
+    }
+    getQueue().enqueue(kernel::refineSSD<T>, idx, dist, query, train);
+}
+
+/// The integer distances are exact and computed directly
+template<typename T, typename To>
+typename std::enable_if<!std::is_floating_point<T>::value>::type
+nearestNeighbourSSD(Array<uint>& idx, Array<To>& dist, const Array<T>& query,
+                    const Array<T>& train, const uint n_dist) {
+    getQueue().enqueue(kernel::nearest_neighbour<T, To, AF_SSD>, idx, dist,
+                       query, train, n_dist);
+}
+}  // namespace
+
 template<typename T, typename To>
 void nearest_neighbour(Array<uint>& idx, Array<To>& dist, const Array<T>& query,
                        const Array<T>& train, const uint dist_dim,
                        const uint n_dist, const af_match_type dist_type) {
-    uint sample_dim   = (dist_dim == 0) ? 1 : 0;
-    const dim4& qDims = query.dims();
-    const dim4& tDims = train.dims();
-    const dim4 outDims(n_dist, qDims[sample_dim]);
-    const dim4 distDims(tDims[sample_dim], qDims[sample_dim]);
-
-    Array<To> tmp_dists = createEmptyArray<To>(distDims);
+    // The kernels expect the features of a sample to be contiguous
+    const Array<T> q = dist_dim == 0 ? query : transpose(query, false);
+    const Array<T> t = dist_dim == 0 ? train : transpose(train, false);
+    const dim4 outDims(n_dist, q.dims()[1]);
 
     idx  = createEmptyArray<uint>(outDims);
     dist = createEmptyArray<To>(outDims);
 
     switch (dist_type) {
         case AF_SAD:
-            getQueue().enqueue(kernel::nearest_neighbour<T, To, AF_SAD>,
-                               tmp_dists, query, train, dist_dim);
+            getQueue().enqueue(kernel::nearest_neighbour<T, To, AF_SAD>, idx,
+                               dist, q, t, n_dist);
             break;
         case AF_SSD:
-            getQueue().enqueue(kernel::nearest_neighbour<T, To, AF_SSD>,
-                               tmp_dists, query, train, dist_dim);
+            nearestNeighbourSSD(idx, dist, q, t, n_dist);
             break;
         case AF_SHD:
-            getQueue().enqueue(kernel::nearest_neighbour<T, To, AF_SHD>,
-                               tmp_dists, query, train, dist_dim);
+            getQueue().enqueue(kernel::nearest_neighbour<T, To, AF_SHD>, idx,
+                               dist, q, t, n_dist);
             break;
         default: AF_ERROR("Unsupported dist_type", AF_ERR_NOT_CONFIGURED);
     }
-
-    cpu::topk(dist, idx, tmp_dists, n_dist, 0, AF_TOPK_MIN);
 }
 
 #define INSTANTIATE(T, To)                                             \
@@ -0,0 +1,72 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <common/dispatch.hpp>
+#include <platform.hpp>
+#include <thread_pool.hpp>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+
+namespace cpu {
+
+/// The smallest number of elements processed by one task of parallelFor
+constexpr dim_t PARALLEL_MIN_TASK_ELEMENTS = 1 << 16;
+
+/// Calls func(first, last) for contiguous ranges of the \p units
+/// independent units of work of a kernel, such as the rows or the batch
+/// slices of an image.
+///
+/// The ranges are processed by the thread pool, so the number of concurrent
+/// workers is limited by its size (see AF_CPU_NUM_THREADS). Each task gets
+/// at least PARALLEL_MIN_TASK_ELEMENTS elements of work, so small amounts of
+/// work are processed on the calling thread.
+///
+/// \param[in] units        The number of units of work
+/// \param[in] unitElements The cost of a unit in elements, e.g. the number
+///                         of outputs times the number of inputs of each
+/// \param[in] func         The function called with each range of units
+template<typename F>
+void parallelFor(const dim_t units, const dim_t unitElements, F func) {
+    if (units <= 0) { return; }
+    thread_pool &pool  = getThreadPool();
+    const dim_t ntasks = std::max<dim_t>(
+        1, std::min({static_cast<dim_t>(pool.size()), units,
+                     units * unitElements / PARALLEL_MIN_TASK_ELEMENTS}));
+    if (ntasks == 1) {
+        func(dim_t(0), units);
+        return;
+    }
+    const dim_t perTask = divup(units, ntasks);
+    pool.run(static_cast<int>(ntasks), [&](int task) {
+        const dim_t first = task * perTask;
+        const dim_t last  = std::min(first + perTask, units);
+        if (first < last) { func(first, last); }
+    });
+}
+
+/// Calls func(b2, b3) for each 2D slice of an array of dimensions \p dims.
+/// The slices are processed by the thread pool (see parallelFor).
+///
+/// \param[in] dims         The dimensions of the array
+/// \param[in] unitElements The cost of a slice in elements
+/// \param[in] func         The function called with the batch indices of
+///                         each slice
+template<typename F>
+void parallelForSlices(const af::dim4 &dims, const dim_t unitElements,
+                       F func) {
+    parallelFor(dims[2] * dims[3], unitElements, [&](dim_t first, dim_t last) {
+        for (dim_t slice = first; slice < last; ++slice) {
+            func(slice % dims[2], slice / dims[2]);
+        }
+    });
+}
+
+}  // namespace cpu
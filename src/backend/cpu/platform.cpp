@@ -9,10 +9,12 @@
 
 #include <common/MemoryManagerBase.hpp>
 #include <common/defines.hpp>
+#include <common/err_common.hpp>
 #include <common/host_memory.hpp>
 #include <device_manager.hpp>
 #include <platform.hpp>
 #include <version.hpp>
+#include <af/cpu.h>
 #include <af/version.h>
 
 #include <algorithm>
@@ -119,6 +121,73 @@ unsigned getMaxJitSize() {
     return length;
 }
 
+int getJitMinTaskElements() {
+    // Large enough to amortize the cost of cloning the JIT tree for each
+    // thread
+    const int MIN_TASK_ELEMENTS = 16 * 1024;
+
+    thread_local int elements = 0;
+    if (elements == 0) {
+        string env_var = getEnvVar("AF_CPU_JIT_MIN_TASK_ELEMENTS");
+        if (!env_var.empty()) {
+            elements = std::max(stoi(env_var), 1);
+        } else {
+            elements = MIN_TASK_ELEMENTS;
+        }
+    }
+    return elements;
+}
+
+bool useCompensatedSummation() {
+    thread_local int compensated = -1;
+    if (compensated == -1) {
+        compensated = getEnvVar("AF_CPU_SUMMATION") == "kahan";
+    }
+    return compensated == 1;
+}
+
+FFTPlanRigor getFFTPlanRigor() {
+    thread_local int rigor = -1;
+    if (rigor == -1) {
+        const string env_var = getEnvVar("AF_CPU_FFT_PLAN_RIGOR");
+        if (env_var == "measure") {
+            rigor = static_cast<int>(FFTPlanRigor::Measure);
+        } else if (env_var == "patient") {
+            rigor = static_cast<int>(FFTPlanRigor::Patient);
+        } else {
+            rigor = static_cast<int>(FFTPlanRigor::Estimate);
+        }
+    }
+    return static_cast<FFTPlanRigor>(rigor);
+}
+
+int getFFTMaxThreads() {
+    thread_local int threads = 0;
+    if (threads == 0) {
+        const string env_var = getEnvVar("AF_CPU_FFT_THREADS");
+        if (!env_var.empty()) {
+            threads = std::max(stoi(env_var), 1);
+        } else {
+            threads = getThreadPool().size();
+        }
+    }
+    return threads;
+}
+
+QueueFlushLimits getDefaultQueueFlushLimits() {
+    // Bound the memory and the latency of the queued work without waiting
+    // for every few small tasks
+    const size_t FLUSH_BYTES    = size_t(1) << 30;
+    const size_t FLUSH_ELEMENTS = size_t(1) << 26;
+
+    QueueFlushLimits limits{FLUSH_BYTES, FLUSH_ELEMENTS};
+    string env_var = getEnvVar("AF_CPU_QUEUE_FLUSH_BYTES");
+    if (!env_var.empty()) { limits.bytes = std::stoull(env_var); }
+    env_var = getEnvVar("AF_CPU_QUEUE_FLUSH_ELEMENTS");
+    if (!env_var.empty()) { limits.elements = std::stoull(env_var); }
+    return limits;
+}
+
 int getDeviceCount() { return DeviceManager::NUM_DEVICES; }
 
 // Get the currently active device id
@@ -144,12 +213,57 @@ int setDevice(int device) {
     return 0;
 }
 
+bool useThreadQueues() {
+    static const bool enabled = getEnvVar("AF_CPU_THREAD_QUEUES") == "1";
+    return enabled;
+}
+
+namespace {
+/// The queue of the calling thread, or of the queue whose worker is the
+/// calling thread. Null for the threads which never asked for a queue.
+thread_local queue* threadQueue = nullptr;
+
+/// The queue owned by a host thread. The buffers freed after it is destroyed
+/// at the exit of the thread are released immediately.
+struct ThreadQueue {
+    queue q;
+    ~ThreadQueue() {
+        q.sync();
+        threadQueue = nullptr;
+    }
+};
+}  // namespace
+
 queue& getQueue(int device) {
-    return DeviceManager::getInstance().queues[device];
+    if (!useThreadQueues()) {
+        return DeviceManager::getInstance().queues[device];
+    }
+    if (threadQueue == nullptr) {
+        thread_local ThreadQueue ownQueue;
+        threadQueue = &ownQueue.q;
+
+        // The worker finds its queue when it calls getQueue from a task
+        queue* q = &ownQueue.q;
+        q->enqueue([q]() { threadQueue = q; });
+    }
+    return *threadQueue;
+}
+
+void releaseAfterQueuedTasks(const std::function<void()>& release) {
+    if (!useThreadQueues() || threadQueue == nullptr ||
+        threadQueue->is_worker()) {
+        release();
+    } else {
+        threadQueue->enqueueRelease(release);
+    }
 }
 
 void sync(int device) { getQueue(device).sync(); }
 
+thread_pool& getThreadPool() {
+    return *(DeviceManager::getInstance().threadPool);
+}
+
 bool& evalFlag() {
     thread_local bool flag = true;
     return flag;
@@ -181,3 +295,24 @@ graphics::ForgeManager& forgeManager() {
 }
 
 }  // namespace cpu
+
+af_err afcpu_set_queue_flush_limits(unsigned long long bytes,
+                                    unsigned long long elements) {
+    try {
+        cpu::getQueue().setFlushLimits(
+            {static_cast<size_t>(bytes), static_cast<size_t>(elements)});
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err afcpu_get_queue_flush_limits(unsigned long long *bytes,
+                                    unsigned long long *elements) {
+    try {
+        const cpu::QueueFlushLimits limits = cpu::getQueue().getFlushLimits();
+        if (bytes) { *bytes = limits.bytes; }
+        if (elements) { *elements = limits.elements; }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
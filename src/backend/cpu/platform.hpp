@@ -10,6 +10,8 @@
 #pragma once
 
 #include <queue.hpp>
+
+#include <functional>
 #include <string>
 
 namespace graphics {
@@ -26,6 +28,8 @@ using common::memory::MemoryManagerBase;
 
 namespace cpu {
 
+class thread_pool;
+
 int getBackend();
 
 std::string getDeviceInfo() noexcept;
@@ -38,6 +42,24 @@ void devprop(char* d_name, char* d_platform, char* d_toolkit, char* d_compute);
 
 unsigned getMaxJitSize();
 
+/// Returns the minimum number of elements a single thread evaluates when a
+/// JIT tree is split across the thread pool
+int getJitMinTaskElements();
+
+/// Returns true if floating point sums are computed with Kahan summation
+/// instead of pairwise summation (see AF_CPU_SUMMATION)
+bool useCompensatedSummation();
+
+/// The rigor of the FFTW planner of the CPU FFTs
+enum class FFTPlanRigor { Estimate, Measure, Patient };
+
+/// Returns the rigor of the FFTW planner (see AF_CPU_FFT_PLAN_RIGOR)
+FFTPlanRigor getFFTPlanRigor();
+
+/// Returns the largest number of threads of a single FFT (see
+/// AF_CPU_FFT_THREADS)
+int getFFTMaxThreads();
+
 int getDeviceCount();
 
 unsigned getActiveDeviceId();
@@ -48,10 +70,25 @@ size_t getHostMemorySize();
 
 int setDevice(int device);
 
+/// Returns true if each host thread has its own queue and worker thread
+/// instead of sharing the queue of the device (see AF_CPU_THREAD_QUEUES)
+bool useThreadQueues();
+
+/// Returns the queue of the calling thread. With thread queues it is the
+/// queue created by the first call of the thread, or the queue whose worker
+/// is the calling thread.
 queue& getQueue(int device = 0);
 
+/// Calls \p release once the tasks the calling thread enqueued so far are
+/// done. Used to release the buffers of arrays which the tasks of the
+/// calling thread may still use when each thread has its own queue.
+void releaseAfterQueuedTasks(const std::function<void()>& release);
+
 void sync(int device);
 
+/// Returns the thread pool used to parallelize the CPU kernels
+thread_pool& getThreadPool();
+
 bool& evalFlag();
 
 MemoryManagerBase& memoryManager();
@@ -10,33 +10,46 @@
 #include <Array.hpp>
 #include <common/graphics_common.hpp>
 #include <err_cpu.hpp>
+#include <kernel/interleave.hpp>
 #include <platform.hpp>
 #include <plot.hpp>
 #include <queue.hpp>
 
+#include <vector>
+
 using af::dim4;
+using std::vector;
 
 namespace cpu {
 
 template<typename T>
-void copy_plot(const Array<T> &P, fg_plot plot) {
+void copy_plot(const vector<Array<T>> &components, fg_plot plot) {
     ForgeModule &_ = graphics::forgePlugin();
-    P.eval();
+    vector<CParam<T>> params;
+    for (const Array<T> &component : components) {
+        component.eval();
+        params.push_back(component);
+    }
     getQueue().sync();
 
     CheckGL("Before CopyArrayToVBO");
-    unsigned bytes = 0, buffer = 0;
+    unsigned buffer = 0;
     FG_CHECK(_.fg_get_plot_vertex_buffer(&buffer, plot));
-    FG_CHECK(_.fg_get_plot_vertex_buffer_size(&bytes, plot));
 
+    // The vertices are interleaved straight into the buffer of the plot
     glBindBuffer(GL_ARRAY_BUFFER, buffer);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, P.get());
+    auto *ptr = static_cast<T *>(glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY));
+    if (ptr) {
+        kernel::interleave(ptr, params);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     CheckGL("In CopyArrayToVBO");
 }
 
-#define INSTANTIATE(T) template void copy_plot<T>(const Array<T> &, fg_plot);
+#define INSTANTIATE(T)                                             \
+    template void copy_plot<T>(const vector<Array<T>> &, fg_plot);
 
 INSTANTIATE(float)
 INSTANTIATE(double)
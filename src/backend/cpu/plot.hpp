@@ -10,9 +10,13 @@
 #include <Array.hpp>
 #include <common/graphics_common.hpp>
 
+#include <vector>
+
 namespace cpu {
 
+/// Writes the vertices of \p plot from the x, y and z \p components, which
+/// are vectors or views of the rows or of the columns of an array of points
 template<typename T>
-void copy_plot(const Array<T> &P, fg_plot plot);
+void copy_plot(const std::vector<Array<T>> &components, fg_plot plot);
 
 }
@@ -9,10 +9,20 @@
 #pragma once
 
 #include <Param.hpp>
+#include <common/Profiler.hpp>
 #include <common/util.hpp>
 #include <memory.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 // FIXME: Is there a better way to check for std::future not being supported ?
 #if defined(AF_DISABLE_CPU_ASYNC) || \
@@ -50,51 +60,271 @@ using event_impl = threads::event;
 
 namespace cpu {
 
+/// The limits of the work queued on a cpu::queue before the calling thread
+/// waits for it. A limit of zero is disabled.
+struct QueueFlushLimits {
+    /// The bytes of the arrays used by the queued tasks
+    size_t bytes;
+    /// The estimated work of the queued tasks, in elements
+    size_t elements;
+};
+
+/// Returns the default flush limits of the CPU queues (see
+/// AF_CPU_QUEUE_FLUSH_BYTES and AF_CPU_QUEUE_FLUSH_ELEMENTS)
+QueueFlushLimits getDefaultQueueFlushLimits();
+
+/// The smallest work, in elements, a task adds to the queue, so tasks on
+/// small arrays still flush the queue eventually
+constexpr size_t QUEUE_TASK_MIN_ELEMENTS = 1 << 12;
+
+/// Tasks with less work, in elements, are merged into batches which are run
+/// by a single wake up of the worker thread
+constexpr size_t QUEUE_BATCH_TASK_ELEMENTS = 1 << 14;
+
+/// The largest work, in elements, of a batch of tasks
+constexpr size_t QUEUE_BATCH_ELEMENTS = 1 << 18;
+
+/// The largest number of tasks of a batch
+constexpr size_t QUEUE_BATCH_TASKS = 64;
+
+/// The size of the arrays used by a task, used to estimate its work
+struct TaskSize {
+    /// The elements of the largest array
+    size_t elements;
+    /// The bytes of all the arrays
+    size_t bytes;
+};
+
+template<typename T>
+TaskSize taskSize(const Param<T> &param) {
+    const size_t elements = static_cast<size_t>(param.dims().elements());
+    return {elements, elements * sizeof(T)};
+}
+
+template<typename T>
+TaskSize taskSize(const CParam<T> &param) {
+    const size_t elements = static_cast<size_t>(param.dims().elements());
+    return {elements, elements * sizeof(T)};
+}
+
+template<typename T>
+TaskSize taskSize(const T &) {
+    return {0, 0};
+}
+
+inline void addTaskSize(TaskSize &) {}
+
+template<typename T, typename... Rest>
+void addTaskSize(TaskSize &size, const T &arg, const Rest &... rest) {
+    const TaskSize argSize = taskSize(arg);
+    size.elements          = std::max(size.elements, argSize.elements);
+    size.bytes += argSize.bytes;
+    addTaskSize(size, rest...);
+}
+
+/// A task which records its run time on the worker thread in the profiler
+template<typename F>
+struct ProfiledTask {
+    F func;
+    /// The af_* function which enqueued the task
+    std::string function;
+
+    template<typename... Params>
+    void operator()(Params &&... params) const {
+        const double start = common::profileClock();
+        func(std::forward<Params>(params)...);
+        common::addProfileEvent({std::string(), function, std::string(), 0,
+                                 start, common::profileClock() - start});
+    }
+};
+
 /// Wraps the async_queue class
+///
+/// The calling thread waits for the queued tasks when the memory pressure is
+/// above its threshold or when the queued bytes or work exceed the flush
+/// limits. Consecutive small tasks are merged into batches so the worker is
+/// woken once per batch. Tasks without array arguments, whose work is not
+/// known, are never batched. The tasks enqueued while the queue is captured
+/// are recorded instead of being run, and are replayed as a single task.
+///
+/// The queue of a device is shared by all the host threads, so the batch and
+/// the flush limits are guarded by a mutex.
 class queue {
    public:
     queue()
-        : count(0)
-        , sync_calls(__SYNCHRONOUS_ARCH == 1 ||
-                     getEnvVar("AF_SYNCHRONOUS_CALLS") == "1") {}
+        : sync_calls(__SYNCHRONOUS_ARCH == 1 ||
+                     getEnvVar("AF_SYNCHRONOUS_CALLS") == "1")
+        , profiling(common::isProfiling())
+        , limits(getDefaultQueueFlushLimits()) {}
 
     template<typename F, typename... Args>
     void enqueue(const F func, Args &&... args) {
-        count++;
+        if (profiling) {
+            enqueueParams(
+                ProfiledTask<F>{func, common::getProfiledFunction()},
+                toParam(std::forward<Args>(args))...);
+        } else {
+            enqueueParams(func, toParam(std::forward<Args>(args))...);
+        }
+    }
+
+    void sync() {
+        queuedBytes    = 0;
+        queuedElements = 0;
+        if (!sync_calls) {
+            dispatchBatch();
+            aQueue.sync();
+        }
+    }
+
+    bool is_worker() const {
+        return (!sync_calls) ? aQueue.is_worker() : false;
+    }
+
+    void setFlushLimits(QueueFlushLimits value) {
+        std::lock_guard<std::mutex> lock(batchMutex);
+        limits = value;
+    }
+
+    /// Starts recording the enqueued tasks instead of running them
+    void beginCapture() {
+        dispatchBatch();
+        captured = std::make_shared<std::vector<std::function<void()>>>();
+    }
+
+    /// Stops recording and returns the recorded tasks
+    std::shared_ptr<const std::vector<std::function<void()>>> endCapture() {
+        return std::move(captured);
+    }
+
+    bool isCapturing() const { return static_cast<bool>(captured); }
+
+    /// Enqueues the tasks recorded by a capture as a single task
+    void replay(
+        const std::shared_ptr<const std::vector<std::function<void()>>>
+            &tasks) {
+        if (sync_calls) {
+            for (auto &task : *tasks) { task(); }
+        } else {
+            dispatchBatch();
+            aQueue.enqueue([tasks]() {
+                for (auto &task : *tasks) { task(); }
+            });
+        }
+    }
+
+    QueueFlushLimits getFlushLimits() const {
+        std::lock_guard<std::mutex> lock(batchMutex);
+        return limits;
+    }
+
+    /// Calls \p release on the worker after the queued tasks, without
+    /// dispatching the batch of small tasks
+    void enqueueRelease(const std::function<void()> &release) {
+        if (sync_calls) {
+            release();
+            return;
+        }
+        std::lock_guard<std::mutex> lock(batchMutex);
+        if (!batch.empty()) {
+            batch.push_back(release);
+        } else {
+            aQueue.enqueue(release);
+        }
+    }
+
+    friend class queue_event;
+
+   private:
+    template<typename F, typename... Params>
+    void enqueueParams(const F func, Params... params) {
+        if (captured) {
+            captured->emplace_back(
+                [func, params...]() mutable { func(params...); });
+            return;
+        }
+
+        TaskSize size{0, 0};
+        addTaskSize(size, params...);
+
+        QueueFlushLimits currLimits;
         if (sync_calls) {
-            func(toParam(std::forward<Args>(args))...);
+            func(params...);
+            currLimits = getFlushLimits();
         } else {
-            aQueue.enqueue(func, toParam(std::forward<Args>(args))...);
+            // The batch is dispatched before a large task under the same
+            // lock, so the tasks of each thread run in order
+            std::lock_guard<std::mutex> lock(batchMutex);
+            currLimits = limits;
+            if (size.elements > 0 &&
+                size.elements < QUEUE_BATCH_TASK_ELEMENTS) {
+                batch.emplace_back(
+                    [func, params...]() mutable { func(params...); });
+                batchElements += size.elements;
+                if (batchElements >= QUEUE_BATCH_ELEMENTS ||
+                    batch.size() >= QUEUE_BATCH_TASKS) {
+                    dispatchBatchLocked();
+                }
+            } else {
+                dispatchBatchLocked();
+                aQueue.enqueue(func, params...);
+            }
         }
+
+        queuedBytes += size.bytes;
+        queuedElements += std::max(size.elements, QUEUE_TASK_MIN_ELEMENTS);
 #ifndef NDEBUG
         sync();
 #else
+        auto exceeds = [](size_t value, size_t limit) {
+            return limit != 0 && value >= limit;
+        };
         if (getMemoryPressure() >= getMemoryPressureThreshold() ||
-            count >= 25) {
+            exceeds(queuedBytes, currLimits.bytes) ||
+            exceeds(queuedElements, currLimits.elements)) {
             sync();
         }
 #endif
     }
 
-    void sync() {
-        count = 0;
-        if (!sync_calls) aQueue.sync();
+    /// Enqueues the batched tasks as a single task of the async_queue
+    void dispatchBatch() {
+        std::lock_guard<std::mutex> lock(batchMutex);
+        dispatchBatchLocked();
     }
 
-    bool is_worker() const {
-        return (!sync_calls) ? aQueue.is_worker() : false;
+    /// dispatchBatch for callers which hold batchMutex
+    void dispatchBatchLocked() {
+        if (batch.empty()) { return; }
+        auto tasks =
+            std::make_shared<std::vector<std::function<void()>>>();
+        tasks->swap(batch);
+        batchElements = 0;
+        aQueue.enqueue([tasks]() {
+            for (auto &task : *tasks) { task(); }
+        });
     }
 
-    friend class queue_event;
-
-   private:
-    int count;
     const bool sync_calls;
+    /// Records the run time of each task (see AF_PROFILE)
+    const bool profiling;
+    /// Guards limits, batch and batchElements
+    mutable std::mutex batchMutex;
+    QueueFlushLimits limits;
+    std::atomic<size_t> queuedBytes{0};
+    std::atomic<size_t> queuedElements{0};
+    std::vector<std::function<void()>> batch;
+    size_t batchElements = 0;
+    /// The tasks recorded by the capture in progress, if any
+    std::shared_ptr<std::vector<std::function<void()>>> captured;
     queue_impl aQueue;
 };
 
 class queue_event {
     event_impl event_;
+    /// The time at which the queue reached the event, in nanoseconds of the
+    /// steady clock. Only set for timing events.
+    std::shared_ptr<std::atomic<int64_t>> time_;
 
    public:
     queue_event() = default;
@@ -102,8 +332,38 @@ class queue_event {
 
     int create() { return event_.create(); }
 
-    int mark(queue &q) { return event_.mark(q.aQueue); }
-    int wait(queue &q) { return event_.wait(q.aQueue); }
+    int createTiming() {
+        time_ = std::make_shared<std::atomic<int64_t>>(0);
+        return event_.create();
+    }
+
+    int mark(queue &q) {
+        q.dispatchBatch();
+        if (time_) {
+            // The time is recorded by the worker before the event completes
+            auto time = time_;
+            q.aQueue.enqueue([time]() {
+                *time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch())
+                            .count();
+            });
+        }
+        return event_.mark(q.aQueue);
+    }
+
+    /// Sets \p ms to the time between the completion of \p start and of
+    /// this event. Returns 1 if one of the events was not created for timing
+    int elapsed(float *ms, queue_event &start) noexcept {
+        if (!time_ || !start.time_) { return 1; }
+        start.sync();
+        sync();
+        *ms = static_cast<float>(*time_ - *start.time_) * 1e-6f;
+        return 0;
+    }
+    int wait(queue &q) {
+        q.dispatchBatch();
+        return event_.wait(q.aQueue);
+    }
     int sync() noexcept { return event_.sync(); }
     operator bool() const noexcept { return event_; }
 };
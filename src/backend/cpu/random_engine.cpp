@@ -9,9 +9,12 @@
 
 #include <Array.hpp>
 #include <common/half.hpp>
+#include <kernel/random_distributions.hpp>
 #include <kernel/random_engine.hpp>
 #include <af/dim4.hpp>
 
+#include <vector>
+
 using common::half;
 
 namespace cpu {
@@ -20,6 +23,19 @@ void initMersenneState(Array<uint> &state, const uintl seed,
     getQueue().enqueue(kernel::initMersenneState, state.get(), tbl.get(), seed);
 }
 
+void initMersenneStates(std::vector<Array<uint>> &states,
+                        const std::vector<uintl> &seeds,
+                        const Array<uint> &tbl) {
+    std::vector<uint *> ptrs(states.size());
+    for (size_t i = 0; i < states.size(); ++i) { ptrs[i] = states[i].get(); }
+    auto func = [ptrs, seeds](const uint *tbl) {
+        for (size_t i = 0; i < ptrs.size(); ++i) {
+            kernel::initMersenneState(ptrs[i], tbl, seeds[i]);
+        }
+    };
+    getQueue().enqueue(func, tbl.get());
+}
+
 template<typename T>
 Array<T> uniformDistribution(const af::dim4 &dims,
                              const af_random_engine_type type, const uintl seed,
@@ -68,6 +84,17 @@ Array<T> normalDistribution(const af::dim4 &dims, Array<uint> pos,
     return out;
 }
 
+template<typename T>
+Array<T> randomDistribution(const AF_RANDOM_DIST dist, const Array<T> &param0,
+                            const Array<T> &param1, const uintl seed,
+                            uintl &counter) {
+    Array<T> out = createEmptyArray<T>(param0.dims());
+    getQueue().enqueue(kernel::randomDistribution<T>, out, param0, param1,
+                       dist, seed, counter);
+    counter += out.elements();
+    return out;
+}
+
 #define INSTANTIATE_UNIFORM(T)                                   \
     template Array<T> uniformDistribution<T>(                    \
         const af::dim4 &dims, const af_random_engine_type type,  \
@@ -163,4 +190,12 @@ COMPLEX_UNIFORM_DISTRIBUTION(cfloat, float)    // NOLINT
 COMPLEX_NORMAL_DISTRIBUTION(cdouble, double)  // NOLINT
 COMPLEX_NORMAL_DISTRIBUTION(cfloat, float)    // NOLINT
 
+#define INSTANTIATE_DISTRIBUTION(T)                                            \
+    template Array<T> randomDistribution<T>(                                   \
+        const AF_RANDOM_DIST dist, const Array<T> &param0,                     \
+        const Array<T> &param1, const uintl seed, uintl &counter);
+
+INSTANTIATE_DISTRIBUTION(float)
+INSTANTIATE_DISTRIBUTION(double)
+
 }  // namespace cpu
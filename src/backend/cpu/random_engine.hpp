@@ -11,12 +11,21 @@
 
 #include <Array.hpp>
 #include <backend.hpp>
+#include <common/internal_enums.hpp>
 #include <af/defines.h>
 
+#include <vector>
+
 namespace cpu {
 void initMersenneState(Array<uint> &state, const uintl seed,
                        const Array<uint> &tbl);
 
+/// Initializes the states of several Mersenne engines, each one with its
+/// seed in \p seeds, in one launch
+void initMersenneStates(std::vector<Array<uint>> &states,
+                        const std::vector<uintl> &seeds,
+                        const Array<uint> &tbl);
+
 template<typename T>
 Array<T> uniformDistribution(const af::dim4 &dims,
                              const af_random_engine_type type,
@@ -40,4 +49,14 @@ Array<T> normalDistribution(const af::dim4 &dims, Array<uint> pos,
                             Array<uint> sh1, Array<uint> sh2, uint mask,
                             Array<uint> recursion_table,
                             Array<uint> temper_table, Array<uint> state);
+
+/// Samples \p dist with the parameters of each element of \p param0 and
+/// \p param1, which are linear arrays of the same dimensions. The values of
+/// an element only depend on \p seed, \p counter and the index of the
+/// element. \p counter is advanced by the number of elements.
+template<typename T>
+Array<T> randomDistribution(const AF_RANDOM_DIST dist, const Array<T> &param0,
+                            const Array<T> &param1,
+                            const unsigned long long seed,
+                            unsigned long long &counter);
 }  // namespace cpu
@@ -6,18 +6,14 @@
  * The complete license agreement can be obtained at:
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
-#include <kernel/range.hpp>
 #include <range.hpp>
 
 #include <Array.hpp>
 #include <err_cpu.hpp>
+#include <jit/IndexNode.hpp>
 #include <math.hpp>
-#include <platform.hpp>
-#include <queue.hpp>
 
-#include <algorithm>
-#include <numeric>
-#include <stdexcept>
+#include <memory>
 
 using common::half;
 
@@ -32,16 +28,13 @@ Array<T> range(const dim4& dims, const int seq_dim) {
         _seq_dim = 0;  // column wise sequence
     }
 
-    Array<T> out = createEmptyArray<T>(dims);
-    switch (_seq_dim) {
-        case 0: getQueue().enqueue(kernel::range<T, 0>, out); break;
-        case 1: getQueue().enqueue(kernel::range<T, 1>, out); break;
-        case 2: getQueue().enqueue(kernel::range<T, 2>, out); break;
-        case 3: getQueue().enqueue(kernel::range<T, 3>, out); break;
-        default: AF_ERROR("Invalid rep selection", AF_ERR_ARG);
-    }
+    if (_seq_dim > 3) { AF_ERROR("Invalid rep selection", AF_ERR_ARG); }
 
-    return out;
+    // The values are generated by the evaluation of the expressions which
+    // use the range
+    return createNodeArray<T>(
+        dims, std::make_shared<jit::IndexNode<T>>(common::IndexParams(
+                  common::IndexKind::Range, dims, _seq_dim)));
 }
 
 #define INSTANTIATE(T) \
@@ -10,8 +10,10 @@
 #include <Array.hpp>
 #include <common/Binary.hpp>
 #include <common/Transform.hpp>
+#include <common/bfloat16.hpp>
 #include <common/half.hpp>
 #include <kernel/reduce.hpp>
+#include <kernel/reduce_jit.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <reduce.hpp>
@@ -22,8 +24,8 @@
 
 using af::dim4;
 using common::Binary;
+using common::bfloat16;
 using common::half;
-using common::Transform;
 using cpu::cdouble;
 
 namespace common {
@@ -41,25 +43,26 @@ struct Binary<cdouble, af_add_t> {
 
 namespace cpu {
 
-template<af_op_t op, typename Ti, typename To>
-using reduce_dim_func = std::function<void(
-    Param<To>, const dim_t, CParam<Ti>, const dim_t, const int, bool, double)>;
-
 template<af_op_t op, typename Ti, typename To>
 Array<To> reduce(const Array<Ti> &in, const int dim, bool change_nan,
                  double nanval) {
     dim4 odims = in.dims();
     odims[dim] = 1;
 
-    Array<To> out = createEmptyArray<To>(odims);
-    static const reduce_dim_func<op, Ti, To> reduce_funcs[4] = {
-        kernel::reduce_dim<op, Ti, To, 1>(),
-        kernel::reduce_dim<op, Ti, To, 2>(),
-        kernel::reduce_dim<op, Ti, To, 3>(),
-        kernel::reduce_dim<op, Ti, To, 4>()};
+    Array<To> out          = createEmptyArray<To>(odims);
+    const bool compensated = useCompensatedSummation();
+
+    // The rows of a JIT tree are reduced while they are evaluated so the
+    // result of the tree is never stored
+    if (dim == 0 && !in.isReady() && in.elements() > 0) {
+        getQueue().enqueue(kernel::reduce_jit_dim0<op, Ti, To>, out,
+                           in.getNode(), in.dims(), change_nan, nanval,
+                           compensated);
+        return out;
+    }
 
-    getQueue().enqueue(reduce_funcs[in.ndims() - 1], out, 0, in, 0, dim,
-                       change_nan, nanval);
+    getQueue().enqueue(kernel::reduce<op, Ti, To>, out, in, dim, change_nan,
+                       nanval, compensated);
 
     return out;
 }
@@ -109,41 +112,18 @@ void reduce_by_key(Array<Tk> &keys_out, Array<To> &vals_out,
 
 template<af_op_t op, typename Ti, typename Taccumulate>
 Taccumulate reduce_all(const Array<Ti> &in, bool change_nan, double nanval) {
-    in.eval();
-    getQueue().sync();
-
-    Transform<Ti, compute_t<Taccumulate>, op> transform;
-    Binary<compute_t<Taccumulate>, op> reduce;
-
-    compute_t<Taccumulate> out = Binary<compute_t<Taccumulate>, op>::init();
-
-    // Decrement dimension of select dimension
-    af::dim4 dims           = in.dims();
-    af::dim4 strides        = in.strides();
-    const data_t<Ti> *inPtr = in.get();
-
-    for (dim_t l = 0; l < dims[3]; l++) {
-        dim_t off3 = l * strides[3];
-
-        for (dim_t k = 0; k < dims[2]; k++) {
-            dim_t off2 = k * strides[2];
-
-            for (dim_t j = 0; j < dims[1]; j++) {
-                dim_t off1 = j * strides[1];
-
-                for (dim_t i = 0; i < dims[0]; i++) {
-                    dim_t idx = i + off1 + off2 + off3;
-
-                    compute_t<Taccumulate> in_val = transform(inPtr[idx]);
-                    if (change_nan) {
-                        in_val = IS_NAN(in_val) ? nanval : in_val;
-                    }
-                    out = reduce(in_val, out);
-                }
-            }
-        }
+    const bool compensated = useCompensatedSummation();
+    compute_t<Taccumulate> out;
+    if (!in.isReady() && in.elements() > 0) {
+        getQueue().enqueue(kernel::reduce_all_jit<op, Ti, Taccumulate>, &out,
+                           in.getNode(), in.dims(), change_nan, nanval,
+                           compensated);
+    } else {
+        in.eval();
+        getQueue().enqueue(kernel::reduce_all<op, Ti, Taccumulate>, &out, in,
+                           change_nan, nanval, compensated);
     }
-
+    getQueue().sync();
     return data_t<Taccumulate>(out);
 }
 
@@ -212,6 +192,7 @@ INSTANTIATE(af_add_t, ushort, uint)
 INSTANTIATE(af_add_t, ushort, float)
 INSTANTIATE(af_add_t, half, float)
 INSTANTIATE(af_add_t, half, half)
+INSTANTIATE(af_add_t, bfloat16, float)
 
 // mul
 INSTANTIATE(af_mul_t, float, float)
@@ -227,6 +208,7 @@ INSTANTIATE(af_mul_t, uchar, uint)
 INSTANTIATE(af_mul_t, short, int)
 INSTANTIATE(af_mul_t, ushort, uint)
 INSTANTIATE(af_mul_t, half, float)
+INSTANTIATE(af_mul_t, bfloat16, float)
 
 // count
 INSTANTIATE(af_notzero_t, float, uint)
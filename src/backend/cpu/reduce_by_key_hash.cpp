@@ -0,0 +1,85 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <common/Binary.hpp>
+#include <copy.hpp>
+#include <platform.hpp>
+#include <queue.hpp>
+#include <reduce.hpp>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using af::dim4;
+using common::Binary;
+
+namespace cpu {
+
+// The host has no limit on the size of the table, so all the keys are reduced
+// with it
+template<af_op_t op, typename Ti, typename Tk, typename To>
+bool reduce_by_key_hash(Array<Tk> &keys_out, Array<To> &vals_out,
+                        const Array<Tk> &keys, const Array<Ti> &vals) {
+    const Array<Tk> ikeys = keys.isLinear() ? keys : copyArray<Tk>(keys);
+    const Array<Ti> ivals = vals.isLinear() ? vals : copyArray<Ti>(vals);
+    getQueue().sync();
+
+    const dim_t n  = ikeys.elements();
+    const Tk *kptr = ikeys.get();
+    const Ti *vptr = ivals.get();
+    Binary<To, op> reduce;
+
+    std::unordered_map<Tk, To> table;
+    for (dim_t i = 0; i < n; ++i) {
+        auto slot = table.emplace(kptr[i], Binary<To, op>::init()).first;
+        slot->second = reduce(slot->second, static_cast<To>(vptr[i]));
+    }
+
+    std::vector<std::pair<Tk, To>> sorted(table.begin(), table.end());
+    std::sort(sorted.begin(), sorted.end(),
+              [](const std::pair<Tk, To> &a, const std::pair<Tk, To> &b) {
+                  return a.first < b.first;
+              });
+
+    std::vector<Tk> okeys(sorted.size());
+    std::vector<To> ovals(sorted.size());
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        okeys[i] = sorted[i].first;
+        ovals[i] = sorted[i].second;
+    }
+
+    const dim4 odims(static_cast<dim_t>(sorted.size()));
+    keys_out = createHostDataArray<Tk>(odims, okeys.data());
+    vals_out = createHostDataArray<To>(odims, ovals.data());
+    return true;
+}
+
+#define INSTANTIATE(op, Tk, T)                                          \
+    template bool reduce_by_key_hash<op, T, Tk, T>(                     \
+        Array<Tk> &keys_out, Array<T> &vals_out, const Array<Tk> &keys, \
+        const Array<T> &vals);
+
+#define INSTANTIATE_KEYS(op, T) \
+    INSTANTIATE(op, int, T)     \
+    INSTANTIATE(op, uint, T)
+
+#define INSTANTIATE_OP(op)      \
+    INSTANTIATE_KEYS(op, float) \
+    INSTANTIATE_KEYS(op, int)   \
+    INSTANTIATE_KEYS(op, uint)
+
+INSTANTIATE_OP(af_add_t)
+INSTANTIATE_OP(af_min_t)
+INSTANTIATE_OP(af_max_t)
+
+}  // namespace cpu
@@ -0,0 +1,41 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <common/region_stats.hpp>
+#include <kernel/region_props.hpp>
+#include <platform.hpp>
+#include <queue.hpp>
+#include <region_props.hpp>
+#include <af/dim4.hpp>
+
+using af::dim4;
+
+namespace cpu {
+
+template<typename T>
+Array<float> regionProps(const Array<T> &labels, const unsigned nlabels) {
+    Array<float> out =
+        createEmptyArray<float>(dim4(common::REGION_PROP_COUNT, nlabels));
+    getQueue().enqueue(kernel::regionProps<T>, out, labels);
+    return out;
+}
+
+#define INSTANTIATE(T)                                            \
+    template Array<float> regionProps<T>(const Array<T> &labels, \
+                                         const unsigned nlabels);
+
+INSTANTIATE(float)
+INSTANTIATE(double)
+INSTANTIATE(int)
+INSTANTIATE(uint)
+INSTANTIATE(short)
+INSTANTIATE(ushort)
+
+}  // namespace cpu
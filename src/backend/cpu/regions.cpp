@@ -15,9 +15,7 @@
 #include <queue.hpp>
 #include <regions.hpp>
 #include <af/dim4.hpp>
-#include <algorithm>
-#include <map>
-#include <set>
+#include <vector>
 
 using af::dim4;
 
@@ -25,15 +23,33 @@ namespace cpu {
 
 template<typename T>
 Array<T> regions(const Array<char> &in, af_connectivity connectivity) {
-    Array<T> out = createValueArray(in.dims(), static_cast<T>(0));
-    getQueue().enqueue(kernel::regions<T>, out, in, connectivity);
+    Array<T> out = createEmptyArray<T>(in.dims());
+    getQueue().enqueue(kernel::regions<T>, out, in, connectivity, nullptr);
 
     return out;
 }
 
-#define INSTANTIATE(T)                                  \
-    template Array<T> regions<T>(const Array<char> &in, \
-                                 af_connectivity connectivity);
+template<typename T>
+Array<T> regions(const Array<char> &in, af_connectivity connectivity,
+                 Array<uint> &stats) {
+    Array<T> out = createEmptyArray<T>(in.dims());
+    std::vector<uint> values;
+    getQueue().enqueue(kernel::regions<T>, out, in, connectivity, &values);
+    // The number of regions is only known after they are labelled
+    getQueue().sync();
+
+    const dim_t count = values.size() / common::REGION_STAT_COUNT;
+    stats = createHostDataArray<uint>(dim4(common::REGION_STAT_COUNT, count),
+                                      values.data());
+    return out;
+}
+
+#define INSTANTIATE(T)                                                   \
+    template Array<T> regions<T>(const Array<char> &in,                  \
+                                 af_connectivity connectivity);          \
+    template Array<T> regions<T>(const Array<char> &in,                  \
+                                 af_connectivity connectivity,           \
+                                 Array<uint> &stats);
 
 INSTANTIATE(float)
 INSTANTIATE(double)
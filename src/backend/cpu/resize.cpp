@@ -22,7 +22,7 @@ Array<T> resize(const Array<T> &in, const dim_t odim0, const dim_t odim1,
     af::dim4 idims = in.dims();
     af::dim4 odims(odim0, odim1, idims[2], idims[3]);
     // Create output placeholder
-    Array<T> out = createValueArray(odims, static_cast<T>(0));
+    Array<T> out = createEmptyArray<T>(odims);
 
     switch (method) {
         case AF_INTERP_NEAREST:
@@ -26,43 +26,9 @@ Array<To> scan(const Array<Ti>& in, const int dim, bool inclusive_scan) {
     Array<To> out    = createEmptyArray<To>(dims);
 
     if (inclusive_scan) {
-        switch (in.ndims()) {
-            case 1:
-                kernel::scan_dim<op, Ti, To, 1, true> func1;
-                getQueue().enqueue(func1, out, 0, in, 0, dim);
-                break;
-            case 2:
-                kernel::scan_dim<op, Ti, To, 2, true> func2;
-                getQueue().enqueue(func2, out, 0, in, 0, dim);
-                break;
-            case 3:
-                kernel::scan_dim<op, Ti, To, 3, true> func3;
-                getQueue().enqueue(func3, out, 0, in, 0, dim);
-                break;
-            case 4:
-                kernel::scan_dim<op, Ti, To, 4, true> func4;
-                getQueue().enqueue(func4, out, 0, in, 0, dim);
-                break;
-        }
+        getQueue().enqueue(kernel::scan<op, Ti, To, true>, out, in, dim);
     } else {
-        switch (in.ndims()) {
-            case 1:
-                kernel::scan_dim<op, Ti, To, 1, false> func1;
-                getQueue().enqueue(func1, out, 0, in, 0, dim);
-                break;
-            case 2:
-                kernel::scan_dim<op, Ti, To, 2, false> func2;
-                getQueue().enqueue(func2, out, 0, in, 0, dim);
-                break;
-            case 3:
-                kernel::scan_dim<op, Ti, To, 3, false> func3;
-                getQueue().enqueue(func3, out, 0, in, 0, dim);
-                break;
-            case 4:
-                kernel::scan_dim<op, Ti, To, 4, false> func4;
-                getQueue().enqueue(func4, out, 0, in, 0, dim);
-                break;
-        }
+        getQueue().enqueue(kernel::scan<op, Ti, To, false>, out, in, dim);
     }
 
     return out;
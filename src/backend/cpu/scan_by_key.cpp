@@ -23,17 +23,8 @@ Array<To> scan(const Array<Tk>& key, const Array<Ti>& in, const int dim,
                bool inclusive_scan) {
     const dim4& dims = in.dims();
     Array<To> out    = createEmptyArray<To>(dims);
-    kernel::scan_dim_by_key<op, Ti, Tk, To, 1> func1(inclusive_scan);
-    kernel::scan_dim_by_key<op, Ti, Tk, To, 2> func2(inclusive_scan);
-    kernel::scan_dim_by_key<op, Ti, Tk, To, 3> func3(inclusive_scan);
-    kernel::scan_dim_by_key<op, Ti, Tk, To, 4> func4(inclusive_scan);
-
-    switch (in.ndims()) {
-        case 1: getQueue().enqueue(func1, out, 0, key, 0, in, 0, dim); break;
-        case 2: getQueue().enqueue(func2, out, 0, key, 0, in, 0, dim); break;
-        case 3: getQueue().enqueue(func3, out, 0, key, 0, in, 0, dim); break;
-        case 4: getQueue().enqueue(func4, out, 0, key, 0, in, 0, dim); break;
-    }
+    getQueue().enqueue(kernel::scan_by_key<op, Ti, Tk, To>, out, key, in, dim,
+                       inclusive_scan);
 
     return out;
 }
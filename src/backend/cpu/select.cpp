@@ -10,12 +10,21 @@
 #include <select.hpp>
 
 #include <Array.hpp>
+#include <common/PoolAllocator.hpp>
 #include <common/half.hpp>
+#include <common/jit/JitStats.hpp>
+#include <jit/SelectNode.hpp>
+#include <math.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 
+#include <algorithm>
+
 using af::dim4;
 using common::half;
+using common::JitEvalScope;
+using common::makePooled;
+using std::max;
 
 namespace cpu {
 
@@ -31,7 +40,65 @@ void select_scalar(Array<T> &out, const Array<char> &cond, const Array<T> &a,
     getQueue().enqueue(kernel::select_scalar<T, flip>, out, cond, a, b);
 }
 
+template<typename T>
+Array<T> createSelectNode(const Array<char> &cond, const Array<T> &a,
+                          const Array<T> &b, const dim4 &odims) {
+    auto cond_node = cond.getNode();
+    auto a_node    = a.getNode();
+    auto b_node    = b.getNode();
+    auto node =
+        makePooled<jit::SelectNode<T>>(cond_node, a_node, b_node, false);
+
+    const kJITHeuristics reason = passesJitHeuristics<T>(node.get());
+    if (reason == kJITHeuristics::Pass) {
+        return createNodeArray<T>(odims, node);
+    } else {
+        JitEvalScope scope(reason);
+        if (a_node->getHeight() >
+            max(b_node->getHeight(), cond_node->getHeight())) {
+            a.eval();
+        } else if (b_node->getHeight() > cond_node->getHeight()) {
+            b.eval();
+        } else {
+            cond.eval();
+        }
+        return createSelectNode<T>(cond, a, b, odims);
+    }
+}
+
+template<typename T, bool flip>
+Array<T> createSelectNode(const Array<char> &cond, const Array<T> &a,
+                          const double &b_val, const dim4 &odims) {
+    auto cond_node = cond.getNode();
+    auto a_node    = a.getNode();
+    Array<T> b     = createValueArray<T>(odims, scalar<T>(b_val));
+    auto node = makePooled<jit::SelectNode<T>>(cond_node, a_node, b.getNode(),
+                                               flip);
+
+    const kJITHeuristics reason = passesJitHeuristics<T>(node.get());
+    if (reason == kJITHeuristics::Pass) {
+        return createNodeArray<T>(odims, node);
+    } else {
+        JitEvalScope scope(reason);
+        if (a_node->getHeight() > cond_node->getHeight()) {
+            a.eval();
+        } else {
+            cond.eval();
+        }
+        return createSelectNode<T, flip>(cond, a, b_val, odims);
+    }
+}
+
 #define INSTANTIATE(T)                                                        \
+    template Array<T> createSelectNode<T>(                                    \
+        const Array<char> &cond, const Array<T> &a, const Array<T> &b,        \
+        const af::dim4 &odims);                                               \
+    template Array<T> createSelectNode<T, true>(                              \
+        const Array<char> &cond, const Array<T> &a, const double &b_val,      \
+        const af::dim4 &odims);                                               \
+    template Array<T> createSelectNode<T, false>(                             \
+        const Array<char> &cond, const Array<T> &a, const double &b_val,      \
+        const af::dim4 &odims);                                               \
     template void select<T>(Array<T> & out, const Array<char> &cond,          \
                             const Array<T> &a, const Array<T> &b);            \
     template void select_scalar<T, true>(Array<T> & out,                      \
@@ -20,17 +20,9 @@ void select_scalar(Array<T> &out, const Array<char> &cond, const Array<T> &a,
 
 template<typename T>
 Array<T> createSelectNode(const Array<char> &cond, const Array<T> &a,
-                          const Array<T> &b, const af::dim4 &odims) {
-    Array<T> out = createEmptyArray<T>(odims);
-    select(out, cond, a, b);
-    return out;
-}
+                          const Array<T> &b, const af::dim4 &odims);
 
 template<typename T, bool flip>
 Array<T> createSelectNode(const Array<char> &cond, const Array<T> &a,
-                          const double &b, const af::dim4 &odims) {
-    Array<T> out = createEmptyArray<T>(odims);
-    select_scalar<T, flip>(out, cond, a, b);
-    return out;
-}
+                          const double &b_val, const af::dim4 &odims);
 }  // namespace cpu
@@ -10,6 +10,7 @@
 #include <Array.hpp>
 #include <copy.hpp>
 #include <err_cpu.hpp>
+#include <join.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <set.hpp>
@@ -52,24 +53,34 @@ Array<T> setUnique(const Array<T> &in, const bool is_sorted) {
 template<typename T>
 Array<T> setUnion(const Array<T> &first, const Array<T> &second,
                   const bool is_unique) {
-    Array<T> uFirst  = first;
-    Array<T> uSecond = second;
-
+    // The union of the values is the unique values of both inputs, which are
+    // sorted once instead of deduplicating each input first
     if (!is_unique) {
-        // FIXME: Perhaps copy + unique would do ?
-        uFirst  = setUnique(first, false);
-        uSecond = setUnique(second, false);
+        Array<T> uFirst  = copyArray<T>(first);
+        Array<T> uSecond = copyArray<T>(second);
+        uFirst.eval();
+        uSecond.eval();
+        uFirst.modDims(dim4(first.elements()));
+        uSecond.modDims(dim4(second.elements()));
+        return setUnique(join<T>(0, uFirst, uSecond), false);
     }
 
-    dim_t first_elements  = uFirst.elements();
-    dim_t second_elements = uSecond.elements();
+    dim_t first_elements  = first.elements();
+    dim_t second_elements = second.elements();
     dim_t elements        = first_elements + second_elements;
 
     Array<T> out = createEmptyArray<T>(af::dim4(elements));
 
-    T *ptr  = out.get();
-    T *last = set_union(uFirst.get(), uFirst.get() + first_elements,
-                        uSecond.get(), uSecond.get() + second_elements, ptr);
+    const T *fptr = first.get();
+    const T *sptr = second.get();
+    T *ptr        = out.get();
+
+    // Need to sync old jobs since we need to
+    // operator on pointers directly in std::set_union
+    getQueue().sync();
+
+    T *last = set_union(fptr, fptr + first_elements, sptr,
+                        sptr + second_elements, ptr);
 
     auto dist = static_cast<dim_t>(distance(ptr, last));
     dim4 dims(dist, 1, 1, 1);
@@ -95,10 +106,16 @@ Array<T> setIntersect(const Array<T> &first, const Array<T> &second,
 
     Array<T> out = createEmptyArray<T>(af::dim4(elements));
 
-    T *ptr = out.get();
-    T *last =
-        set_intersection(uFirst.get(), uFirst.get() + first_elements,
-                         uSecond.get(), uSecond.get() + second_elements, ptr);
+    const T *fptr = uFirst.get();
+    const T *sptr = uSecond.get();
+    T *ptr        = out.get();
+
+    // Need to sync old jobs since we need to
+    // operator on pointers directly in std::set_intersection
+    getQueue().sync();
+
+    T *last = set_intersection(fptr, fptr + first_elements, sptr,
+                               sptr + second_elements, ptr);
 
     auto dist = static_cast<dim_t>(distance(ptr, last));
     dim4 dims(dist, 1, 1, 1);
@@ -20,6 +20,7 @@
 #include <vector>
 
 #ifdef AF_WITH_NONFREE_SIFT
+#include <kernel/convolve.hpp>
 #include <kernel/sift_nonfree.hpp>
 #endif
 
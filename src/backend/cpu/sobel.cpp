@@ -28,8 +28,7 @@ std::pair<Array<To>, Array<To>> sobelDerivatives(const Array<Ti> &img,
     Array<To> dx = createEmptyArray<To>(img.dims());
     Array<To> dy = createEmptyArray<To>(img.dims());
 
-    getQueue().enqueue(kernel::derivative<Ti, To, true>, dx, img);
-    getQueue().enqueue(kernel::derivative<Ti, To, false>, dy, img);
+    getQueue().enqueue(kernel::derivatives<Ti, To>, dx, dy, img);
 
     return std::make_pair(dx, dy);
 }
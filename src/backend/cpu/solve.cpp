@@ -15,6 +15,7 @@
 #include <copy.hpp>
 #include <lapack_helper.hpp>
 #include <math.hpp>
+#include <parallel_for.hpp>
 #include <queue.hpp>
 #include <af/dim4.hpp>
 
@@ -82,8 +83,13 @@ Array<T> solveLU(const Array<T> &A, const Array<int> &pivot, const Array<T> &b,
     // NOLINTNEXTLINE
     auto func = [=](CParam<T> A, Param<T> B, CParam<int> pivot, int N,
                     int NRHS) {
-        getrs_func<T>()(AF_LAPACK_COL_MAJOR, 'N', N, NRHS, A.get(),
-                        A.strides(1), pivot.get(), B.get(), B.strides(1));
+        parallelForSlices(A.dims(), N * N * NRHS, [&](dim_t z, dim_t w) {
+            getrs_func<T>()(
+                AF_LAPACK_COL_MAJOR, 'N', N, NRHS,
+                A.get() + z * A.strides(2) + w * A.strides(3), A.strides(1),
+                pivot.get() + z * pivot.strides(2) + w * pivot.strides(3),
+                B.get() + z * B.strides(2) + w * B.strides(3), B.strides(1));
+        });
     };
     getQueue().enqueue(func, A, B, pivot, N, NRHS);
 
@@ -99,10 +105,14 @@ Array<T> triangleSolve(const Array<T> &A, const Array<T> &b,
 
     auto func = [=](const CParam<T> A, Param<T> B, int N, int NRHS,
                     const af_mat_prop options) {
-        trtrs_func<T>()(AF_LAPACK_COL_MAJOR, options & AF_MAT_UPPER ? 'U' : 'L',
-                        'N',  // transpose flag
-                        options & AF_MAT_DIAG_UNIT ? 'U' : 'N', N, NRHS,
-                        A.get(), A.strides(1), B.get(), B.strides(1));
+        parallelForSlices(A.dims(), N * N * NRHS, [&](dim_t z, dim_t w) {
+            trtrs_func<T>()(
+                AF_LAPACK_COL_MAJOR, options & AF_MAT_UPPER ? 'U' : 'L',
+                'N',  // transpose flag
+                options & AF_MAT_DIAG_UNIT ? 'U' : 'N', N, NRHS,
+                A.get() + z * A.strides(2) + w * A.strides(3), A.strides(1),
+                B.get() + z * B.strides(2) + w * B.strides(3), B.strides(1));
+        });
     };
     getQueue().enqueue(func, A, B, N, NRHS, options);
 
@@ -130,12 +140,21 @@ Array<T> solve(const Array<T> &a, const Array<T> &b,
                       : padArrayBorders(b, NullShape, endPadding, AF_PAD_ZERO));
 
     if (M == N) {
-        Array<int> pivot = createEmptyArray<int>(dim4(N, 1, 1));
+        Array<int> pivot =
+            createEmptyArray<int>(dim4(N, 1, a.dims()[2], a.dims()[3]));
 
+        // The systems of a batch are solved concurrently
         auto func = [=](Param<T> A, Param<T> B, Param<int> pivot, int N,
                         int K) {
-            gesv_func<T>()(AF_LAPACK_COL_MAJOR, N, K, A.get(), A.strides(1),
-                           pivot.get(), B.get(), B.strides(1));
+            parallelForSlices(A.dims(), N * N * (N + K), [&](dim_t z, dim_t w) {
+                gesv_func<T>()(
+                    AF_LAPACK_COL_MAJOR, N, K,
+                    A.get() + z * A.strides(2) + w * A.strides(3),
+                    A.strides(1),
+                    pivot.get() + z * pivot.strides(2) + w * pivot.strides(3),
+                    B.get() + z * B.strides(2) + w * B.strides(3),
+                    B.strides(1));
+            });
         };
         getQueue().enqueue(func, A, B, pivot, N, K);
     } else {
@@ -13,9 +13,15 @@
 #include <mkl_spblas.h>
 #endif
 
+#include <common/SpgemmPattern.hpp>
 #include <common/complex.hpp>
 #include <common/err_common.hpp>
 #include <complex.hpp>
+#include <copy.hpp>
+#include <kernel/csrmm.hpp>
+#include <kernel/csrsv.hpp>
+#include <kernel/sparse_blocked.hpp>
+#include <kernel/spgemm.hpp>
 #include <math.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
@@ -23,6 +29,8 @@
 #include <af/dim4.hpp>
 
 #include <cassert>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 
@@ -90,6 +98,70 @@ sparse_operation_t toSparseTranspose(af_mat_prop opt) {
     return out;
 }
 
+/// The data of the products of a sparse array which is kept with the array:
+/// the MKL handle of the CSR, CSC or COO matrix and the operations it has
+/// been optimized for, and the pattern of the last sparse-sparse product. The
+/// MKL handle points to the indices and values of the sparse array.
+class SparseCache : public common::SparseArrayCache,
+                    public std::enable_shared_from_this<SparseCache> {
+   public:
+#ifdef USE_MKL
+    std::mutex mutex;
+    sparse_matrix_t matrix = nullptr;
+    unsigned hints         = 0;  ///< One bit per operation and mv or mm hint
+
+    ~SparseCache() override {
+        if (matrix) { mkl_sparse_destroy(matrix); }
+    }
+
+    /// The handle is created again by the next product, because
+    /// mkl_sparse_optimize may keep a copy of the values. The handle is
+    /// released after the queued copy of the values.
+    void valuesChanged() override {
+        std::shared_ptr<SparseCache> self = shared_from_this();
+        getQueue().enqueue([self]() {
+            std::lock_guard<std::mutex> lock(self->mutex);
+            if (self->matrix) { mkl_sparse_destroy(self->matrix); }
+            self->matrix = nullptr;
+            self->hints  = 0;
+        });
+    }
+#endif
+    std::shared_ptr<common::SpgemmPattern> spgemm;
+};
+
+/// Returns the cache of \p in, which is created on the first product of the
+/// matrix
+template<typename T>
+std::shared_ptr<SparseCache> sparseCache(const common::SparseArray<T> &in) {
+    auto cache = std::dynamic_pointer_cast<SparseCache>(in.getCache());
+    if (!cache) {
+        cache = std::make_shared<SparseCache>();
+        in.setCache(cache);
+    }
+    return cache;
+}
+
+/// Multiplies the BSR or SELL array \p lhs with the dense array \p rhs
+template<typename T>
+Array<T> blockedMatmul(const common::SparseArray<T> &lhs,
+                       const Array<T> &rhs) {
+    Array<T> out =
+        createEmptyArray<T>(af::dim4(lhs.dims()[0], rhs.dims()[1]));
+
+    const Array<T> &values   = lhs.getValues();
+    const Array<int> &rowIdx = lhs.getRowIdx();
+    const Array<int> &colIdx = lhs.getColIdx();
+    if (lhs.getStorage() == AF_STORAGE_BSR) {
+        getQueue().enqueue(kernel::bsrmm<T>, out, values, rowIdx, colIdx, rhs,
+                           lhs.getBlockSize());
+    } else {
+        getQueue().enqueue(kernel::sellmm<T>, out, values, rowIdx, colIdx, rhs,
+                           lhs.getBlockSize());
+    }
+    return out;
+}
+
 #ifdef USE_MKL
 
 template<>
@@ -115,6 +187,16 @@ sp_cdouble getScaleValue<const sp_cdouble, cdouble>(cdouble val) {
 //                 MKL_INT *rows_start, MKL_INT *rows_end,
 //                 MKL_INT *col_indx,
 //                 MKL_Complex16 *values);
+//
+// mkl_sparse_z_create_csc takes the column offsets and the row indices in
+// place of the row offsets and the column indices.
+//
+// sparse_status_t mkl_sparse_z_create_coo (
+//                 sparse_matrix_t *A,
+//                 sparse_index_base_t indexing,
+//                 MKL_INT rows, MKL_INT cols, MKL_INT nnz,
+//                 MKL_INT *row_indx, MKL_INT *col_indx,
+//                 MKL_Complex16 *values);
 
 template<typename T>
 using create_csr_func_def = sparse_status_t (*)(sparse_matrix_t *,
@@ -122,11 +204,22 @@ using create_csr_func_def = sparse_status_t (*)(sparse_matrix_t *,
                                                 int *, int *, int *,
                                                 ptr_type<T>);
 
+template<typename T>
+using create_csc_func_def = create_csr_func_def<T>;
+
+template<typename T>
+using create_coo_func_def = sparse_status_t (*)(sparse_matrix_t *,
+                                                sparse_index_base_t, int, int,
+                                                int, int *, int *,
+                                                ptr_type<T>);
+
 #define SPARSE_FUNC_DEF(FUNC) \
     template<typename T>      \
     FUNC##_func_def<T> FUNC##_func();
 
 SPARSE_FUNC_DEF(create_csr)
+SPARSE_FUNC_DEF(create_csc)
+SPARSE_FUNC_DEF(create_coo)
 
 #undef SPARSE_FUNC_DEF
 
@@ -141,6 +234,16 @@ SPARSE_FUNC(create_csr, double, d)
 SPARSE_FUNC(create_csr, cfloat, c)
 SPARSE_FUNC(create_csr, cdouble, z)
 
+SPARSE_FUNC(create_csc, float, s)
+SPARSE_FUNC(create_csc, double, d)
+SPARSE_FUNC(create_csc, cfloat, c)
+SPARSE_FUNC(create_csc, cdouble, z)
+
+SPARSE_FUNC(create_coo, float, s)
+SPARSE_FUNC(create_coo, double, d)
+SPARSE_FUNC(create_coo, cfloat, c)
+SPARSE_FUNC(create_coo, cdouble, z)
+
 #undef SPARSE_FUNC
 
 // sparse_status_t mkl_sparse_z_mv (
@@ -198,12 +301,42 @@ SPARSE_FUNC(mm, double, d)
 SPARSE_FUNC(mm, cfloat, c)
 SPARSE_FUNC(mm, cdouble, z)
 
+// sparse_status_t mkl_sparse_z_trsv (
+//                 sparse_operation_t operation,
+//                 MKL_Complex16 alpha,
+//                 const sparse_matrix_t A,
+//                 struct matrix_descr descr,
+//                 const MKL_Complex16 *x,
+//                 MKL_Complex16 *y);
+
+template<typename T>
+using trsv_func_def = sparse_status_t (*)(const sparse_operation_t,
+                                          scale_type<T>, const sparse_matrix_t,
+                                          matrix_descr, cptr_type<T>,
+                                          ptr_type<T>);
+
+SPARSE_FUNC_DEF(trsv)
+SPARSE_FUNC(trsv, float, s)
+SPARSE_FUNC(trsv, double, d)
+SPARSE_FUNC(trsv, cfloat, c)
+SPARSE_FUNC(trsv, cdouble, z)
+
+/// The number of products the MKL hints announce. The handle is kept with
+/// the sparse array, so the analysis pays off over repeated products.
+constexpr int MKL_EXPECTED_CALLS = 1000;
+
 template<typename T>
 Array<T> matmul(const common::SparseArray<T> &lhs, const Array<T> &rhs,
                 af_mat_prop optLhs, af_mat_prop optRhs) {
     // MKL: CSRMM Does not support optRhs
     UNUSED(optRhs);
 
+    // The blocked formats only support AF_MAT_NONE
+    const af_storage storage = lhs.getStorage();
+    if (storage == AF_STORAGE_BSR || storage == AF_STORAGE_SELL) {
+        return blockedMatmul(lhs, rhs);
+    }
+
     // Similar Operations to GEMM
     sparse_operation_t lOpts = toSparseTranspose(optLhs);
 
@@ -222,6 +355,8 @@ Array<T> matmul(const common::SparseArray<T> &lhs, const Array<T> &rhs,
 
     Array<T> out = createValueArray<T>(af::dim4(M, N, 1, 1), scalar<T>(0));
 
+    std::shared_ptr<SparseCache> handle = sparseCache(lhs);
+
     auto func = [=](Param<T> output, CParam<T> values, CParam<int> rowIdx,
                     CParam<int> colIdx, const dim_t sdim0, const dim_t sdim1,
                     CParam<T> right) {
@@ -231,34 +366,57 @@ Array<T> matmul(const common::SparseArray<T> &lhs, const Array<T> &rhs,
         int ldb = right.strides(1);
         int ldc = output.strides(1);
 
-        int *pB = const_cast<int *>(rowIdx.get());
-        int *pE = pB + 1;
-        T *vptr = const_cast<T *>(values.get());
-
-        sparse_matrix_t csrLhs;
-        create_csr_func<T>()(&csrLhs, SPARSE_INDEX_BASE_ZERO, sdim0, sdim1, pB,
-                             pE, const_cast<int *>(colIdx.get()),
-                             reinterpret_cast<ptr_type<T>>(vptr));
+        std::lock_guard<std::mutex> lock(handle->mutex);
+        if (!handle->matrix) {
+            // MKL computes the products of the CSC and COO matrices without
+            // converting them to CSR
+            int *rptr = const_cast<int *>(rowIdx.get());
+            int *cptr = const_cast<int *>(colIdx.get());
+            auto vptr = reinterpret_cast<ptr_type<T>>(
+                const_cast<T *>(values.get()));
+            if (storage == AF_STORAGE_COO) {
+                create_coo_func<T>()(&handle->matrix, SPARSE_INDEX_BASE_ZERO,
+                                     sdim0, sdim1, values.dims(0), rptr, cptr,
+                                     vptr);
+            } else if (storage == AF_STORAGE_CSC) {
+                create_csc_func<T>()(&handle->matrix, SPARSE_INDEX_BASE_ZERO,
+                                     sdim0, sdim1, cptr, cptr + 1, rptr, vptr);
+            } else {
+                create_csr_func<T>()(&handle->matrix, SPARSE_INDEX_BASE_ZERO,
+                                     sdim0, sdim1, rptr, rptr + 1, cptr, vptr);
+            }
+        }
 
         struct matrix_descr descrLhs {};
         descrLhs.type = SPARSE_MATRIX_TYPE_GENERAL;
 
-        mkl_sparse_optimize(csrLhs);
+        const bool isMv = rDims[rColDim] == 1;
+        const unsigned hint =
+            1u << (2 * (lOpts - SPARSE_OPERATION_NON_TRANSPOSE) + isMv);
+        if (!(handle->hints & hint)) {
+            if (isMv) {
+                mkl_sparse_set_mv_hint(handle->matrix, lOpts, descrLhs,
+                                       MKL_EXPECTED_CALLS);
+            } else {
+                mkl_sparse_set_mm_hint(handle->matrix, lOpts, descrLhs,
+                                       SPARSE_LAYOUT_COLUMN_MAJOR, N,
+                                       MKL_EXPECTED_CALLS);
+            }
+            mkl_sparse_optimize(handle->matrix);
+            handle->hints |= hint;
+        }
 
-        if (rDims[rColDim] == 1) {
-            mkl_sparse_set_mv_hint(csrLhs, lOpts, descrLhs, 1);
-            mv_func<T>()(lOpts, alpha, csrLhs, descrLhs,
+        if (isMv) {
+            mv_func<T>()(lOpts, alpha, handle->matrix, descrLhs,
                          reinterpret_cast<cptr_type<T>>(right.get()), beta,
                          reinterpret_cast<ptr_type<T>>(output.get()));
         } else {
-            mkl_sparse_set_mm_hint(csrLhs, lOpts, descrLhs,
-                                   SPARSE_LAYOUT_COLUMN_MAJOR, N, 1);
             mm_func<T>()(
-                lOpts, alpha, csrLhs, descrLhs, SPARSE_LAYOUT_COLUMN_MAJOR,
+                lOpts, alpha, handle->matrix, descrLhs,
+                SPARSE_LAYOUT_COLUMN_MAJOR,
                 reinterpret_cast<cptr_type<T>>(right.get()), N, ldb, beta,
                 reinterpret_cast<ptr_type<T>>(output.get()), ldc);
         }
-        mkl_sparse_destroy(csrLhs);
     };
 
     const Array<T> values   = lhs.getValues();
@@ -272,131 +430,82 @@ Array<T> matmul(const common::SparseArray<T> &lhs, const Array<T> &rhs,
     return out;
 }
 
-#else  // #if USE_MKL
 
 template<typename T>
-T getConjugate(const T &in) {
-    // For non-complex types return same
-    return in;
-}
+Array<T> solve(const common::SparseArray<T> &lhs, const Array<T> &rhs,
+               const af_mat_prop options) {
+    const bool upper = options & AF_MAT_UPPER;
+    const bool unit  = options & AF_MAT_DIAG_UNIT;
 
-template<>
-cfloat getConjugate(const cfloat &in) {
-    return std::conj(in);
-}
+    Array<T> out = createEmptyArray<T>(rhs.dims());
 
-template<>
-cdouble getConjugate(const cdouble &in) {
-    return std::conj(in);
-}
+    std::shared_ptr<SparseCache> handle = sparseCache(lhs);
 
-template<typename T, bool conjugate>
-void mv(Param<T> output, CParam<T> values, CParam<int> rowIdx,
-        CParam<int> colIdx, CParam<T> right, int M) {
-    UNUSED(M);
-    const T *valPtr   = values.get();
-    const int *rowPtr = rowIdx.get();
-    const int *colPtr = colIdx.get();
-    const T *rightPtr = right.get();
-
-    T *outPtr = output.get();
-
-    for (int i = 0; i < rowIdx.dims(0) - 1; ++i) {
-        outPtr[i] = scalar<T>(0);
-        for (int j = rowPtr[i]; j < rowPtr[i + 1]; ++j) {
-            // If stride[0] of right is not 1 then rightPtr[colPtr[j]*stride]
-            if (conjugate) {
-                outPtr[i] += getConjugate(valPtr[j]) * rightPtr[colPtr[j]];
-            } else {
-                outPtr[i] += valPtr[j] * rightPtr[colPtr[j]];
-            }
-        }
-    }
-}
+    auto func = [=](Param<T> output, CParam<T> values, CParam<int> rowIdx,
+                    CParam<int> colIdx, const dim_t sdim0, const dim_t sdim1,
+                    CParam<T> right) {
+        auto alpha = getScale<T, 1>();
 
-template<typename T, bool conjugate>
-void mtv(Param<T> output, CParam<T> values, CParam<int> rowIdx,
-         CParam<int> colIdx, CParam<T> right, int M) {
-    const T *valPtr   = values.get();
-    const int *rowPtr = rowIdx.get();
-    const int *colPtr = colIdx.get();
-    const T *rightPtr = right.get();
-    T *outPtr         = output.get();
-
-    for (int i = 0; i < M; ++i) { outPtr[i] = scalar<T>(0); }
-
-    for (int i = 0; i < rowIdx.dims(0) - 1; ++i) {
-        for (int j = rowPtr[i]; j < rowPtr[i + 1]; ++j) {
-            // If stride[0] of right is not 1 then rightPtr[i*stride]
-            if (conjugate) {
-                outPtr[colPtr[j]] += getConjugate(valPtr[j]) * rightPtr[i];
-            } else {
-                outPtr[colPtr[j]] += valPtr[j] * rightPtr[i];
-            }
+        std::lock_guard<std::mutex> lock(handle->mutex);
+        if (!handle->matrix) {
+            int *pB = const_cast<int *>(rowIdx.get());
+            int *pE = pB + 1;
+            T *vptr = const_cast<T *>(values.get());
+            create_csr_func<T>()(&handle->matrix, SPARSE_INDEX_BASE_ZERO,
+                                 sdim0, sdim1, pB, pE,
+                                 const_cast<int *>(colIdx.get()),
+                                 reinterpret_cast<ptr_type<T>>(vptr));
         }
-    }
-}
 
-template<typename T, bool conjugate>
-void mm(Param<T> output, CParam<T> values, CParam<int> rowIdx,
-        CParam<int> colIdx, CParam<T> right, int M, int N, int ldb, int ldc) {
-    UNUSED(M);
-    const T *valPtr   = values.get();
-    const int *rowPtr = rowIdx.get();
-    const int *colPtr = colIdx.get();
-    const T *rightPtr = right.get();
-    T *outPtr         = output.get();
-
-    for (int o = 0; o < N; ++o) {
-        for (int i = 0; i < rowIdx.dims(0) - 1; ++i) {
-            outPtr[i] = scalar<T>(0);
-            for (int j = rowPtr[i]; j < rowPtr[i + 1]; ++j) {
-                // If stride[0] of right is not 1 then
-                // rightPtr[colPtr[j]*stride]
-                if (conjugate) {
-                    outPtr[i] += getConjugate(valPtr[j]) * rightPtr[colPtr[j]];
-                } else {
-                    outPtr[i] += valPtr[j] * rightPtr[colPtr[j]];
-                }
-            }
+        struct matrix_descr descrLhs {};
+        descrLhs.type = SPARSE_MATRIX_TYPE_TRIANGULAR;
+        descrLhs.mode = upper ? SPARSE_FILL_MODE_UPPER : SPARSE_FILL_MODE_LOWER;
+        descrLhs.diag = unit ? SPARSE_DIAG_UNIT : SPARSE_DIAG_NON_UNIT;
+
+        // The bits after the hints of the products
+        const unsigned hint = 1u << (6 + 2 * upper + unit);
+        if (!(handle->hints & hint)) {
+            mkl_sparse_set_sv_hint(handle->matrix,
+                                   SPARSE_OPERATION_NON_TRANSPOSE, descrLhs,
+                                   MKL_EXPECTED_CALLS);
+            mkl_sparse_optimize(handle->matrix);
+            handle->hints |= hint;
         }
-        rightPtr += ldb;
-        outPtr += ldc;
-    }
-}
 
-template<typename T, bool conjugate>
-void mtm(Param<T> output, CParam<T> values, CParam<int> rowIdx,
-         CParam<int> colIdx, CParam<T> right, int M, int N, int ldb, int ldc) {
-    const T *valPtr   = values.get();
-    const int *rowPtr = rowIdx.get();
-    const int *colPtr = colIdx.get();
-    const T *rightPtr = right.get();
-    T *outPtr         = output.get();
-
-    for (int o = 0; o < N; ++o) {
-        for (int i = 0; i < M; ++i) { outPtr[i] = scalar<T>(0); }
-
-        for (int i = 0; i < rowIdx.dims(0) - 1; ++i) {
-            for (int j = rowPtr[i]; j < rowPtr[i + 1]; ++j) {
-                // If stride[0] of right is not 1 then rightPtr[i*stride]
-                if (conjugate) {
-                    outPtr[colPtr[j]] += getConjugate(valPtr[j]) * rightPtr[i];
-                } else {
-                    outPtr[colPtr[j]] += valPtr[j] * rightPtr[i];
-                }
-            }
+        for (dim_t o = 0; o < right.dims(1); ++o) {
+            trsv_func<T>()(SPARSE_OPERATION_NON_TRANSPOSE, alpha,
+                           handle->matrix, descrLhs,
+                           reinterpret_cast<cptr_type<T>>(
+                               right.get() + o * right.strides(1)),
+                           reinterpret_cast<ptr_type<T>>(
+                               output.get() + o * output.strides(1)));
         }
-        rightPtr += ldb;
-        outPtr += ldc;
-    }
+    };
+
+    const Array<T> values   = lhs.getValues();
+    const Array<int> rowIdx = lhs.getRowIdx();
+    const Array<int> colIdx = lhs.getColIdx();
+    af::dim4 ldims          = lhs.dims();
+
+    getQueue().enqueue(func, out, values, rowIdx, colIdx, ldims[0], ldims[1],
+                       rhs);
+
+    return out;
 }
 
+#else  // #if USE_MKL
+
 template<typename T>
 Array<T> matmul(const common::SparseArray<T> &lhs, const Array<T> &rhs,
                 af_mat_prop optLhs, af_mat_prop optRhs) {
     UNUSED(optRhs);
 
+    // The blocked formats only support AF_MAT_NONE
+    const af_storage storage = lhs.getStorage();
+    if (storage == AF_STORAGE_BSR || storage == AF_STORAGE_SELL) {
+        return blockedMatmul(lhs, rhs);
+    }
+
     // Similar Operations to GEMM
     sparse_operation_t lOpts = toSparseTranspose(optLhs);
 
@@ -409,32 +518,37 @@ Array<T> matmul(const common::SparseArray<T> &lhs, const Array<T> &rhs,
     int M             = lDims[lRowDim];
     int N             = rDims[rColDim];
 
-    Array<T> out = createValueArray<T>(af::dim4(M, N, 1, 1), scalar<T>(0));
+    Array<T> out = createEmptyArray<T>(af::dim4(M, N, 1, 1));
 
     auto func = [=](Param<T> output, CParam<T> values, CParam<int> rowIdx,
                     CParam<int> colIdx, CParam<T> right) {
-        int ldb = right.strides(1);
-        int ldc = output.strides(1);
-
-        if (rDims[rColDim] == 1) {
+        if (storage == AF_STORAGE_COO) {
             if (lOpts == SPARSE_OPERATION_NON_TRANSPOSE) {
-                mv<T, false>(output, values, rowIdx, colIdx, right, M);
+                kernel::coomm<T, false, false>(output, values, rowIdx, colIdx,
+                                               right);
             } else if (lOpts == SPARSE_OPERATION_TRANSPOSE) {
-                mtv<T, false>(output, values, rowIdx, colIdx, right, M);
+                kernel::coomm<T, true, false>(output, values, rowIdx, colIdx,
+                                              right);
             } else if (lOpts == SPARSE_OPERATION_CONJUGATE_TRANSPOSE) {
-                mtv<T, true>(output, values, rowIdx, colIdx, right, M);
+                kernel::coomm<T, true, true>(output, values, rowIdx, colIdx,
+                                             right);
             }
-        } else {
+        } else if (storage == AF_STORAGE_CSC) {
+            // The column offsets and the row indices of a CSC matrix are the
+            // CSR arrays of its transpose
             if (lOpts == SPARSE_OPERATION_NON_TRANSPOSE) {
-                mm<T, false>(output, values, rowIdx, colIdx, right, M, N, ldb,
-                             ldc);
+                kernel::csrmtm<T, false>(output, values, colIdx, rowIdx, right);
             } else if (lOpts == SPARSE_OPERATION_TRANSPOSE) {
-                mtm<T, false>(output, values, rowIdx, colIdx, right, M, N, ldb,
-                              ldc);
+                kernel::csrmm<T, false>(output, values, colIdx, rowIdx, right);
             } else if (lOpts == SPARSE_OPERATION_CONJUGATE_TRANSPOSE) {
-                mtm<T, true>(output, values, rowIdx, colIdx, right, M, N, ldb,
-                             ldc);
+                kernel::csrmm<T, true>(output, values, colIdx, rowIdx, right);
             }
+        } else if (lOpts == SPARSE_OPERATION_NON_TRANSPOSE) {
+            kernel::csrmm<T>(output, values, rowIdx, colIdx, right);
+        } else if (lOpts == SPARSE_OPERATION_TRANSPOSE) {
+            kernel::csrmtm<T, false>(output, values, rowIdx, colIdx, right);
+        } else if (lOpts == SPARSE_OPERATION_CONJUGATE_TRANSPOSE) {
+            kernel::csrmtm<T, true>(output, values, rowIdx, colIdx, right);
         }
     };
 
@@ -447,12 +561,69 @@ Array<T> matmul(const common::SparseArray<T> &lhs, const Array<T> &rhs,
     return out;
 }
 
+
+template<typename T>
+Array<T> solve(const common::SparseArray<T> &lhs, const Array<T> &rhs,
+               const af_mat_prop options) {
+    const bool upper = options & AF_MAT_UPPER;
+    const bool unit  = options & AF_MAT_DIAG_UNIT;
+
+    Array<T> out = copyArray<T>(rhs);
+    getQueue().enqueue(kernel::csrsv<T>, out, lhs.getValues(),
+                       lhs.getRowIdx(), lhs.getColIdx(), upper, unit);
+    return out;
+}
+
 #endif  // #if USE_MKL
 
-#define INSTANTIATE_SPARSE(T)                                            \
-    template Array<T> matmul<T>(const common::SparseArray<T> &lhs,       \
-                                const Array<T> &rhs, af_mat_prop optLhs, \
-                                af_mat_prop optRhs);
+// MKL's mkl_sparse_spmm computes the pattern and the values of the product in
+// one call, so both builds use the two phases of kernel/spgemm.hpp and keep
+// the pattern with the left hand side.
+template<typename T>
+common::SparseArray<T> matmul(const common::SparseArray<T> &lhs,
+                              const common::SparseArray<T> &rhs) {
+    const int M = lhs.dims()[0];
+    const int N = rhs.dims()[1];
+
+    const Array<int> lRowIdx = lhs.getRowIdx();
+    const Array<int> lColIdx = lhs.getColIdx();
+    const Array<int> rRowIdx = rhs.getRowIdx();
+    const Array<int> rColIdx = rhs.getColIdx();
+
+    std::shared_ptr<SparseCache> cache             = sparseCache(lhs);
+    std::shared_ptr<common::SpgemmPattern> pattern = cache->spgemm;
+    if (!pattern || !pattern->matches(rhs)) {
+        Array<int> rowIdx = createEmptyArray<int>(dim4(M + 1));
+        getQueue().enqueue(kernel::spgemmRowIdx, rowIdx, lRowIdx, lColIdx,
+                           rRowIdx, rColIdx, N);
+        getQueue().sync();
+        const int nnz = rowIdx.get()[M];
+
+        Array<int> colIdx = createEmptyArray<int>(dim4(nnz));
+        getQueue().enqueue(kernel::spgemmColIdx, colIdx, rowIdx, lRowIdx,
+                           lColIdx, rRowIdx, rColIdx, N);
+
+        pattern = std::make_shared<common::SpgemmPattern>(rhs, rowIdx, colIdx);
+        cache->spgemm = pattern;
+    }
+
+    Array<T> values = createEmptyArray<T>(dim4(pattern->getNNZ()));
+    getQueue().enqueue(kernel::spgemmValues<T>, values, pattern->rowIdx,
+                       pattern->colIdx, lhs.getValues(), lRowIdx, lColIdx,
+                       rhs.getValues(), rRowIdx, rColIdx, N);
+
+    return common::createArrayDataSparseArray<T>(
+        dim4(M, N), values, pattern->rowIdx, pattern->colIdx, AF_STORAGE_CSR);
+}
+
+#define INSTANTIATE_SPARSE(T)                                                \
+    template Array<T> matmul<T>(const common::SparseArray<T> &lhs,           \
+                                const Array<T> &rhs, af_mat_prop optLhs,     \
+                                af_mat_prop optRhs);                         \
+    template common::SparseArray<T> matmul<T>(const common::SparseArray<T> &, \
+                                              const common::SparseArray<T> &); \
+    template Array<T> solve<T>(const common::SparseArray<T> &lhs,            \
+                               const Array<T> &rhs, const af_mat_prop options);
 
 INSTANTIATE_SPARSE(float)
 INSTANTIATE_SPARSE(double)
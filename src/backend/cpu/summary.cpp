@@ -0,0 +1,41 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <summary.hpp>
+
+#include <Array.hpp>
+#include <kernel/summary.hpp>
+#include <platform.hpp>
+#include <queue.hpp>
+#include <types.hpp>
+
+namespace cpu {
+template<typename T>
+common::Summary summary_all(const Array<T> &in) {
+    in.eval();
+    common::Summary out{};
+    getQueue().enqueue(kernel::summary_all<T>, &out, in);
+    getQueue().sync();
+    return out;
+}
+
+#define INSTANTIATE(T) \
+    template common::Summary summary_all<T>(const Array<T> &in);
+
+INSTANTIATE(float)
+INSTANTIATE(double)
+INSTANTIATE(int)
+INSTANTIATE(uint)
+INSTANTIATE(intl)
+INSTANTIATE(uintl)
+INSTANTIATE(short)
+INSTANTIATE(ushort)
+INSTANTIATE(char)
+INSTANTIATE(uchar)
+}  // namespace cpu
@@ -0,0 +1,19 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <common/summary.hpp>
+
+namespace cpu {
+/// Computes the minimum and the maximum of the values of \p in, ignoring NaN
+/// values, the sum of the values and of their squares, and the number of
+/// nonzero values, reading the input once.
+template<typename T>
+common::Summary summary_all(const Array<T> &in);
+}  // namespace cpu
@@ -9,35 +9,58 @@
 
 #include <Array.hpp>
 #include <common/graphics_common.hpp>
+#include <common/graphics_vertices.hpp>
 #include <err_cpu.hpp>
+#include <kernel/interleave.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <surface.hpp>
 
+#include <vector>
+
 using af::dim4;
+using common::surfaceComponent;
+using common::VertexComponent;
+using std::vector;
 
 namespace cpu {
 
 template<typename T>
-void copy_surface(const Array<T> &P, fg_surface surface) {
+void copy_surface(const Array<T> &x, const Array<T> &y, const Array<T> &z,
+                  fg_surface surface) {
     ForgeModule &_ = graphics::forgePlugin();
-    P.eval();
+    x.eval();
+    y.eval();
+    z.eval();
     getQueue().sync();
 
+    const dim_t vertices = z.elements();
+    const VertexComponent xc =
+        surfaceComponent(vertices, x.dims(), x.strides(), 0);
+    const VertexComponent yc =
+        surfaceComponent(vertices, y.dims(), y.strides(), 1);
+    vector<CParam<T>> params = {CParam<T>(x.get(), xc.dims, xc.strides),
+                                CParam<T>(y.get(), yc.dims, yc.strides), z};
+
     CheckGL("Before CopyArrayToVBO");
-    unsigned bytes = 0, buffer = 0;
+    unsigned buffer = 0;
     FG_CHECK(_.fg_get_surface_vertex_buffer(&buffer, surface));
-    FG_CHECK(_.fg_get_surface_vertex_buffer_size(&bytes, surface));
 
+    // The vertices are interleaved straight into the buffer of the surface
     glBindBuffer(GL_ARRAY_BUFFER, buffer);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, P.get());
+    auto *ptr = static_cast<T *>(glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY));
+    if (ptr) {
+        kernel::interleave(ptr, params);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     CheckGL("In CopyArrayToVBO");
 }
 
-#define INSTANTIATE(T) \
-    template void copy_surface<T>(const Array<T> &, fg_surface);
+#define INSTANTIATE(T)                                                \
+    template void copy_surface<T>(const Array<T> &, const Array<T> &, \
+                                  const Array<T> &, fg_surface);
 
 INSTANTIATE(float)
 INSTANTIATE(double)
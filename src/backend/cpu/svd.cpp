@@ -57,6 +57,20 @@ SVD_FUNC(gesvd, cdouble, double, z)
 
 #endif
 
+// Computes the SVD of the M x N matrix in, which is overwritten
+template<typename T, typename Tr>
+void svdMatrix(int M, int N, T *in, int ldin, Tr *s, T *u, int ldu, T *vt,
+               int ldvt) {
+#if defined(USE_MKL) || defined(__APPLE__)
+    svd_func<T, Tr>()(AF_LAPACK_COL_MAJOR, 'A', M, N, in, ldin, s, u, ldu, vt,
+                      ldvt);
+#else
+    std::vector<Tr> superb(std::min(M, N));
+    svd_func<T, Tr>()(AF_LAPACK_COL_MAJOR, 'A', 'A', M, N, in, ldin, s, u, ldu,
+                      vt, ldvt, &superb[0]);
+#endif
+}
+
 template<typename T, typename Tr>
 void svdInPlace(Array<Tr> &s, Array<T> &u, Array<T> &vt, Array<T> &in) {
     auto func = [=](Param<Tr> s, Param<T> u, Param<T> vt, Param<T> in) {
@@ -64,16 +78,8 @@ void svdInPlace(Array<Tr> &s, Array<T> &u, Array<T> &vt, Array<T> &in) {
         int M      = iDims[0];
         int N      = iDims[1];
 
-#if defined(USE_MKL) || defined(__APPLE__)
-        svd_func<T, Tr>()(AF_LAPACK_COL_MAJOR, 'A', M, N, in.get(),
-                          in.strides(1), s.get(), u.get(), u.strides(1),
-                          vt.get(), vt.strides(1));
-#else
-        std::vector<Tr> superb(std::min(M, N));
-        svd_func<T, Tr>()(AF_LAPACK_COL_MAJOR, 'A', 'A', M, N, in.get(),
-                          in.strides(1), s.get(), u.get(), u.strides(1),
-                          vt.get(), vt.strides(1), &superb[0]);
-#endif
+        svdMatrix<T, Tr>(M, N, in.get(), in.strides(1), s.get(), u.get(),
+                         u.strides(1), vt.get(), vt.strides(1));
     };
     getQueue().enqueue(func, s, u, vt, in);
 }
@@ -84,6 +90,30 @@ void svd(Array<Tr> &s, Array<T> &u, Array<T> &vt, const Array<T> &in) {
     svdInPlace(s, u, vt, in_copy);
 }
 
+template<typename T, typename Tr>
+void svdBatched(Array<Tr> &s, Array<T> &u, Array<T> &vt, const Array<T> &in) {
+    Array<T> in_copy = copyArray<T>(in);
+
+    auto func = [=](Param<Tr> s, Param<T> u, Param<T> vt, Param<T> in) {
+        dim4 iDims = in.dims();
+        int M      = iDims[0];
+        int N      = iDims[1];
+
+        for (dim_t j = 0; j < iDims[3]; ++j) {
+            for (dim_t i = 0; i < iDims[2]; ++i) {
+                svdMatrix<T, Tr>(
+                    M, N, in.get() + i * in.strides(2) + j * in.strides(3),
+                    in.strides(1),
+                    s.get() + i * s.strides(2) + j * s.strides(3),
+                    u.get() + i * u.strides(2) + j * u.strides(3), u.strides(1),
+                    vt.get() + i * vt.strides(2) + j * vt.strides(3),
+                    vt.strides(1));
+            }
+        }
+    };
+    getQueue().enqueue(func, s, u, vt, in_copy);
+}
+
 }  // namespace cpu
 
 #else  // WITH_LINEAR_ALGEBRA
@@ -100,6 +130,11 @@ void svdInPlace(Array<Tr> &s, Array<T> &u, Array<T> &vt, Array<T> &in) {
     AF_ERROR("Linear Algebra is disabled on CPU", AF_ERR_NOT_CONFIGURED);
 }
 
+template<typename T, typename Tr>
+void svdBatched(Array<Tr> &s, Array<T> &u, Array<T> &vt, const Array<T> &in) {
+    AF_ERROR("Linear Algebra is disabled on CPU", AF_ERR_NOT_CONFIGURED);
+}
+
 }  // namespace cpu
 
 #endif  // WITH_LINEAR_ALGEBRA
@@ -110,7 +145,9 @@ namespace cpu {
     template void svd<T, Tr>(Array<Tr> & s, Array<T> & u, Array<T> & vt, \
                              const Array<T> &in);                        \
     template void svdInPlace<T, Tr>(Array<Tr> & s, Array<T> & u,         \
-                                    Array<T> & vt, Array<T> & in);
+                                    Array<T> & vt, Array<T> & in);       \
+    template void svdBatched<T, Tr>(Array<Tr> & s, Array<T> & u,         \
+                                    Array<T> & vt, const Array<T> &in);
 
 INSTANTIATE_SVD(float, float)
 INSTANTIATE_SVD(double, double)
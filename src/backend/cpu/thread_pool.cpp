@@ -0,0 +1,127 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <thread_pool.hpp>
+
+#include <algorithm>
+
+#if defined(OS_LNX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using std::function;
+using std::lock_guard;
+using std::mutex;
+using std::unique_lock;
+
+namespace cpu {
+
+namespace {
+/// Binds the calling thread to \p core, modulo the number of cores
+void pinToCore(int core) {
+#if defined(OS_LNX)
+    const int cores = std::max<int>(std::thread::hardware_concurrency(), 1);
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % cores, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)core;
+#endif
+}
+}  // namespace
+
+thread_pool::thread_pool(int num_threads, bool pin_threads)
+    : pin(pin_threads), stop(false) {
+    int nworkers = std::max(num_threads, 1) - 1;
+    workers.reserve(nworkers);
+    for (int i = 0; i < nworkers; i++) {
+        workers.emplace_back(&thread_pool::workerLoop, this, i);
+    }
+}
+
+thread_pool::~thread_pool() {
+    {
+        lock_guard<mutex> lock(state_mutex);
+        stop = true;
+    }
+    work_cv.notify_all();
+    for (auto &worker : workers) { worker.join(); }
+}
+
+void thread_pool::runTasks(region &r) {
+    for (int id = r.next++; id < r.count; id = r.next++) {
+        try {
+            (*r.task)(id);
+        } catch (...) {
+            lock_guard<mutex> lock(state_mutex);
+            if (!r.error) { r.error = std::current_exception(); }
+        }
+    }
+}
+
+thread_pool::region *thread_pool::findRegion() {
+    for (region *r : regions) {
+        if (r->next.load() < r->count) { return r; }
+    }
+    return nullptr;
+}
+
+void thread_pool::workerLoop(int index) {
+    if (pin) { pinToCore(index + 1); }
+
+    unique_lock<mutex> lock(state_mutex);
+    while (true) {
+        region *r = nullptr;
+        work_cv.wait(lock, [&] {
+            r = findRegion();
+            return stop || r != nullptr;
+        });
+        if (stop) { return; }
+
+        r->users++;
+        lock.unlock();
+        runTasks(*r);
+        lock.lock();
+
+        if (--r->users == 0) { done_cv.notify_all(); }
+    }
+}
+
+void thread_pool::run(int num_tasks, const function<void(int)> &task) {
+    if (num_tasks <= 0) { return; }
+
+    if (num_tasks == 1 || workers.empty()) {
+        for (int id = 0; id < num_tasks; id++) { task(id); }
+        return;
+    }
+
+    region r;
+    r.task  = &task;
+    r.count = num_tasks;
+    r.next  = 0;
+    r.users = 0;
+    {
+        lock_guard<mutex> lock(state_mutex);
+        regions.push_back(&r);
+    }
+    work_cv.notify_all();
+
+    runTasks(r);
+
+    // All the tasks are claimed, so the workers which still use the region
+    // are running its last tasks
+    unique_lock<mutex> lock(state_mutex);
+    regions.erase(std::find(regions.begin(), regions.end(), &r));
+    done_cv.wait(lock, [&] { return r.users == 0; });
+    if (r.error) { std::rethrow_exception(r.error); }
+}
+
+}  // namespace cpu
@@ -0,0 +1,84 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cpu {
+
+/// A fixed set of worker threads used to split kernels across multiple
+/// cores.
+///
+/// Each call to run is a parallel region whose tasks are claimed one at a
+/// time by the calling thread and by the idle workers. Several regions, from
+/// the queues of several threads or nested in the tasks of another region,
+/// share the workers: a worker which runs out of tasks in its region takes
+/// the tasks left in the others. The thread that calls run only executes the
+/// tasks of its own region, so a pool of size N creates N - 1 threads.
+class thread_pool {
+   public:
+    /// Creates a pool that executes tasks on \p num_threads threads. When
+    /// \p pin_threads is true, worker i is bound to core i + 1.
+    explicit thread_pool(int num_threads, bool pin_threads = false);
+
+    ~thread_pool();
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    /// Returns the number of threads that execute tasks, including the
+    /// thread calling run
+    int size() const noexcept { return static_cast<int>(workers.size()) + 1; }
+
+    /// Calls \p task once for each index in [0, num_tasks) and waits for all
+    /// of them to finish.
+    ///
+    /// \param[in] num_tasks The number of times \p task is called
+    /// \param[in] task      The function that is called with the task index
+    ///
+    /// \note The first exception thrown by a task will be rethrown on the
+    ///       calling thread after all the tasks are done
+    void run(int num_tasks, const std::function<void(int)> &task);
+
+   private:
+    /// The tasks of a call to run
+    struct region {
+        const std::function<void(int)> *task;
+        int count;
+        std::atomic<int> next;
+        /// The threads running tasks of the region, protected by state_mutex
+        int users;
+        std::exception_ptr error;
+    };
+
+    void workerLoop(int index);
+    void runTasks(region &r);
+    /// Returns a region with tasks left, or null. Requires state_mutex.
+    region *findRegion();
+
+    std::vector<std::thread> workers;
+    const bool pin;
+
+    /// Protects the list of regions and their users
+    std::mutex state_mutex;
+    std::condition_variable work_cv;
+    std::condition_variable done_cv;
+
+    std::vector<region *> regions;
+    bool stop;
+};
+
+}  // namespace cpu
@@ -9,20 +9,14 @@
 
 #include <Array.hpp>
 #include <common/half.hpp>
-#include <index.hpp>
-#include <sort.hpp>
-#include <sort_index.hpp>
+#include <kernel/topk.hpp>
+#include <platform.hpp>
+#include <queue.hpp>
 
 #include <algorithm>
-#include <cmath>
-#include <numeric>
-#include <vector>
 
 using common::half;
-using std::iota;
 using std::min;
-using std::partial_sort_copy;
-using std::vector;
 
 namespace cpu {
 template<typename T>
@@ -43,46 +37,11 @@ void topk(Array<T>& vals, Array<unsigned>& idxs, const Array<T>& in,
     auto values  = createEmptyArray<T>(out_dims);
     auto indices = createEmptyArray<unsigned>(out_dims);
 
-    auto func = [=](Param<T> values, Param<unsigned> indices, CParam<T> in) {
-        const T* ptr   = in.get();
-        unsigned* iptr = indices.get();
-        T* vptr        = values.get();
-
-        // Create a linear index
-        vector<uint> idx(in.dims().elements());
-        iota(begin(idx), end(idx), 0);
-
-        int iter = in.dims()[1] * in.dims()[2] * in.dims()[3];
-        for (int i = 0; i < iter; i++) {
-            auto idx_itr = begin(idx) + i * in.strides()[1];
-            auto* kiptr  = iptr + k * i;
-
-            if (order == AF_TOPK_MIN) {
-                // Sort the top k values in each column
-                partial_sort_copy(
-                    idx_itr, idx_itr + in.strides()[1], kiptr, kiptr + k,
-                    [ptr](const uint lhs, const uint rhs) -> bool {
-                        return compute_t<T>(ptr[lhs]) < compute_t<T>(ptr[rhs]);
-                    });
-            } else {
-                partial_sort_copy(
-                    idx_itr, idx_itr + in.strides()[1], kiptr, kiptr + k,
-                    [ptr](const uint lhs, const uint rhs) -> bool {
-                        return compute_t<T>(ptr[lhs]) >= compute_t<T>(ptr[rhs]);
-                    });
-            }
-
-            auto* kvptr = vptr + k * i;
-            for (int j = 0; j < k; j++) {
-                // Update the value arrays with the original values
-                kvptr[j] = ptr[kiptr[j]];
-                // Convert linear indices back to column indices
-                kiptr[j] -= i * in.strides()[1];
-            }
-        }
-    };
-
-    getQueue().enqueue(func, values, indices, in);
+    if (order == AF_TOPK_MIN) {
+        getQueue().enqueue(kernel::topk<T, false>, values, indices, in, k);
+    } else {
+        getQueue().enqueue(kernel::topk<T, true>, values, indices, in, k);
+    }
 
     vals = values;
     idxs = indices;
@@ -47,6 +47,7 @@ template<typename T>
 struct kernel_type;
 
 class half;
+class bfloat16;
 
 template<>
 struct kernel_type<common::half> {
@@ -57,4 +58,14 @@ struct kernel_type<common::half> {
 
     using compute = float;
 };
+
+template<>
+struct kernel_type<common::bfloat16> {
+    using data = common::bfloat16;
+
+    // These are the types within a kernel
+    using native = float;
+
+    using compute = float;
+};
 }  // namespace common
@@ -12,6 +12,7 @@
 #include <err_cpu.hpp>
 #include <jit/UnaryNode.hpp>
 #include <optypes.hpp>
+#include <vector_math.hpp>
 #include <cmath>
 
 namespace cpu {
@@ -80,6 +81,24 @@ UNARY_OP_FN(noop, )  /// Empty second parameter so it does nothing
 
 UNARY_OP_FN(bitnot, ~)
 
+// The float versions of these functions are computed for the whole vector
+// of the node at once
+#define UNARY_OP_VECTOR(op, fn)                                        \
+    template<>                                                         \
+    struct UnOp<float, float, af_##op##_t> {                           \
+        void eval(jit::array<float> &out, const jit::array<float> &in, \
+                  int lim) {                                           \
+            fn(out.data(), in.data(), lim);                            \
+        }                                                              \
+    };
+
+UNARY_OP_VECTOR(exp, vectorExp)
+UNARY_OP_VECTOR(log, vectorLog)
+UNARY_OP_VECTOR(sin, vectorSin)
+UNARY_OP_VECTOR(cos, vectorCos)
+UNARY_OP_VECTOR(sigmoid, vectorSigmoid)
+
+#undef UNARY_OP_VECTOR
 #undef UNARY_OP
 #undef UNARY_OP_FN
 
@@ -88,10 +107,10 @@ Array<T> unaryOp(const Array<T> &in, dim4 outDim = dim4(-1, -1, -1, -1)) {
     using UnaryNode = jit::UnaryNode<T, T, op>;
 
     common::Node_ptr in_node = in.getNode();
-    UnaryNode *node          = new UnaryNode(in_node);
 
     if (outDim == dim4(-1, -1, -1, -1)) { outDim = in.dims(); }
-    return createNodeArray<T>(outDim, common::Node_ptr(node));
+    return createNodeArray<T>(outDim,
+                              common::makePooled<UnaryNode>(in_node));
 }
 
 #define iszero(a) ((a) == 0)
@@ -113,11 +132,10 @@ CHECK_FN(iszero, iszero)
 template<typename T, af_op_t op>
 Array<char> checkOp(const Array<T> &in, dim4 outDim = dim4(-1, -1, -1, -1)) {
     common::Node_ptr in_node = in.getNode();
-    jit::UnaryNode<char, T, op> *node =
-        new jit::UnaryNode<char, T, op>(in_node);
 
     if (outDim == dim4(-1, -1, -1, -1)) { outDim = in.dims(); }
-    return createNodeArray<char>(outDim, common::Node_ptr(node));
+    return createNodeArray<char>(
+        outDim, common::makePooled<jit::UnaryNode<char, T, op>>(in_node));
 }
 
 }  // namespace cpu
@@ -14,4 +14,9 @@ template<typename T>
 Array<T> unwrap(const Array<T> &in, const dim_t wx, const dim_t wy,
                 const dim_t sx, const dim_t sy, const dim_t px, const dim_t py,
                 const dim_t dx, const dim_t dy, const bool is_column);
+
+template<af_op_t op, typename T>
+Array<T> unwrapReduce(const Array<T> &in, const dim_t wx, const dim_t wy,
+                      const dim_t sx, const dim_t sy, const dim_t px,
+                      const dim_t py);
 }
@@ -10,44 +10,59 @@
 #include <Array.hpp>
 #include <common/graphics_common.hpp>
 #include <err_cpu.hpp>
+#include <kernel/interleave.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <vector_field.hpp>
 
+#include <vector>
+
 using af::dim4;
+using std::vector;
 
 namespace cpu {
 
 template<typename T>
-void copy_vector_field(const Array<T> &points, const Array<T> &directions,
+void copy_vector_field(const vector<Array<T>> &points,
+                       const vector<Array<T>> &directions,
                        fg_vector_field vfield) {
     ForgeModule &_ = graphics::forgePlugin();
-    points.eval();
-    directions.eval();
+    vector<CParam<T>> pParams;
+    vector<CParam<T>> dParams;
+    for (size_t i = 0; i < points.size(); ++i) {
+        points[i].eval();
+        directions[i].eval();
+        pParams.push_back(points[i]);
+        dParams.push_back(directions[i]);
+    }
     getQueue().sync();
 
     CheckGL("Before CopyArrayToVBO");
 
-    unsigned size1 = 0, size2 = 0;
     unsigned buff1 = 0, buff2 = 0;
-    FG_CHECK(_.fg_get_vector_field_vertex_buffer_size(&size1, vfield));
-    FG_CHECK(_.fg_get_vector_field_direction_buffer_size(&size2, vfield));
     FG_CHECK(_.fg_get_vector_field_vertex_buffer(&buff1, vfield));
     FG_CHECK(_.fg_get_vector_field_direction_buffer(&buff2, vfield));
 
-    glBindBuffer(GL_ARRAY_BUFFER, buff1);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, size1, points.get());
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    glBindBuffer(GL_ARRAY_BUFFER, buff2);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, size2, directions.get());
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // The vertices are interleaved straight into the buffers of the field
+    auto write = [](unsigned buffer, const vector<CParam<T>> &params) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        auto *ptr =
+            static_cast<T *>(glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY));
+        if (ptr) {
+            kernel::interleave(ptr, params);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    };
+    write(buff1, pParams);
+    write(buff2, dParams);
 
     CheckGL("In CopyArrayToVBO");
 }
 
-#define INSTANTIATE(T)                                                     \
-    template void copy_vector_field<T>(const Array<T> &, const Array<T> &, \
+#define INSTANTIATE(T)                                           \
+    template void copy_vector_field<T>(const vector<Array<T>> &, \
+                                       const vector<Array<T>> &, \
                                        fg_vector_field);
 
 INSTANTIATE(float)
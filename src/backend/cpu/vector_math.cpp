@@ -0,0 +1,306 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <vector_math.hpp>
+
+#include <common/util.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define AF_MATH_X86_TARGETS
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define AF_MATH_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define AF_MATH_INLINE __forceinline
+#else
+#define AF_MATH_INLINE inline
+#endif
+
+namespace cpu {
+
+namespace {
+
+using vector_fn = void (*)(float *, const float *, dim_t);
+
+AF_MATH_INLINE float asFloat(int32_t value) {
+    float out;
+    std::memcpy(&out, &value, sizeof(out));
+    return out;
+}
+
+AF_MATH_INLINE int32_t asInt(float value) {
+    int32_t out;
+    std::memcpy(&out, &value, sizeof(out));
+    return out;
+}
+
+/// Returns \p a if \p cond is true and \p b otherwise. Both values are
+/// computed, which lets the compiler vectorize the loops that call it, since
+/// the floating point operations of a conditional expression are only
+/// evaluated when it is taken.
+AF_MATH_INLINE float selectValue(bool cond, float a, float b) {
+    const int32_t mask = -static_cast<int32_t>(cond);
+    return asFloat((asInt(a) & mask) | (asInt(b) & ~mask));
+}
+
+// The approximations follow the single precision functions of the Cephes
+// library. They are written without branches so the loops which call them
+// are vectorized by the compiler.
+
+/// Rounds \p x to the nearest integer. |x| must be less than 2^22.
+AF_MATH_INLINE float roundNearest(float x) {
+    const float shift = 12582912.f;  // 1.5 * 2^23
+    return (x + shift) - shift;
+}
+
+AF_MATH_INLINE float expValue(float x) {
+    // The clamped input still overflows to infinity and underflows to zero,
+    // and NaN is clamped so the conversion to int is defined
+    float c = selectValue(x >= -104.f, x, -104.f);
+    c       = selectValue(c > 89.f, 89.f, c);
+
+    const float n = roundNearest(c * 1.44269504088896341f);
+    float r       = c - n * 0.693359375f;
+    r             = r - n * -2.12194440e-4f;
+
+    float p = 1.9875691500e-4f;
+    p       = p * r + 1.3981999507e-3f;
+    p       = p * r + 8.3334519073e-3f;
+    p       = p * r + 4.1665795894e-2f;
+    p       = p * r + 1.6666665459e-1f;
+    p       = p * r + 5.0000001201e-1f;
+    p       = p * r * r + r + 1.f;
+
+    // 2^n is applied in two steps so each factor is a normal float
+    const int32_t e  = static_cast<int32_t>(n);
+    const int32_t e1 = e / 2;
+    const int32_t e2 = e - e1;
+    const float out =
+        p * asFloat((e1 + 127) << 23) * asFloat((e2 + 127) << 23);
+    return selectValue(x != x, x, out);
+}
+
+AF_MATH_INLINE float logValue(float x) {
+    // Subnormal inputs are scaled to normal floats
+    const bool sub = x < std::numeric_limits<float>::min();
+    const float s  = selectValue(sub, x * 8388608.f, x);
+
+    const int32_t bits = asInt(s);
+    float e  = static_cast<float>(((bits >> 23) & 0xff) - 126 - 23 * sub);
+    float m = asFloat((bits & 0x007fffff) | 0x3f000000);
+
+    const bool low = m < 0.707106781186547524f;
+    e              = selectValue(low, e - 1.f, e);
+    m              = selectValue(low, m + m - 1.f, m - 1.f);
+
+    const float z = m * m;
+    float p       = 7.0376836292e-2f;
+    p             = p * m - 1.1514610310e-1f;
+    p             = p * m + 1.1676998740e-1f;
+    p             = p * m - 1.2420140846e-1f;
+    p             = p * m + 1.4249322787e-1f;
+    p             = p * m - 1.6668057665e-1f;
+    p             = p * m + 2.0000714765e-1f;
+    p             = p * m - 2.4999993993e-1f;
+    p             = p * m + 3.3333331174e-1f;
+
+    float y = p * m * z;
+    y       = y + e * -2.12194440e-4f;
+    y       = y - 0.5f * z;
+    float out = m + y;
+    out       = out + e * 0.693359375f;
+
+    const float inf = std::numeric_limits<float>::infinity();
+    out             = selectValue(x == inf, inf, out);
+    out             = selectValue(x == 0.f, -inf, out);
+    // Negative inputs and NaN give NaN
+    return selectValue(x >= 0.f, out,
+                       std::numeric_limits<float>::quiet_NaN());
+}
+
+/// The largest magnitude whose range reduction keeps the precision of the
+/// approximations of sine and cosine
+constexpr float MAX_TRIG_ARG = 64.f;
+
+AF_MATH_INLINE float sinPoly(float x, float z) {
+    float p = -1.9515295891e-4f;
+    p       = p * z + 8.3321608736e-3f;
+    p       = p * z - 1.6666654611e-1f;
+    return p * z * x + x;
+}
+
+AF_MATH_INLINE float cosPoly(float z) {
+    float p = 2.443315711809948e-5f;
+    p       = p * z - 1.388731625493765e-3f;
+    p       = p * z + 4.166664568298827e-2f;
+    return p * z * z - 0.5f * z + 1.f;
+}
+
+/// Reduces |x| to [-pi/4, pi/4] and returns the octant of |x| in \p j
+AF_MATH_INLINE float reduceTrig(float x, int32_t &j) {
+    float ax = std::fabs(x);
+    ax       = selectValue(ax <= MAX_TRIG_ARG, ax, 0.f);
+
+    j = static_cast<int32_t>(ax * 1.27323954473516f);
+    j = j + (j & 1);
+
+    const float y = static_cast<float>(j);
+    float r       = ax - y * 0.78515625f;
+    r             = r - y * 2.4187564849853515625e-4f;
+    r             = r - y * 3.77489497744594108e-8f;
+    return r;
+}
+
+AF_MATH_INLINE float sinValue(float x) {
+    int32_t j;
+    const float r = reduceTrig(x, j);
+    const float z = r * r;
+
+    // The sign flips for negative inputs and in the lower half circle
+    const bool neg = (x < 0.f) != ((j & 4) != 0);
+    const bool cos = (j & 2) != 0;
+
+    const float out = selectValue(cos, cosPoly(z), sinPoly(r, z));
+    return selectValue(neg, -out, out);
+}
+
+AF_MATH_INLINE float cosValue(float x) {
+    int32_t j;
+    const float r = reduceTrig(x, j);
+    const float z = r * r;
+
+    const bool neg = ((j & 4) != 0) != ((j & 2) != 0);
+    const bool sin = (j & 2) != 0;
+
+    const float out = selectValue(sin, sinPoly(r, z), cosPoly(z));
+    return selectValue(neg, -out, out);
+}
+
+AF_MATH_INLINE float sigmoidValue(float x) {
+    return 1.f / (1.f + expValue(-x));
+}
+
+#ifdef AF_MATH_X86_TARGETS
+// These functions are compiled for the instruction sets in their target
+// attributes and are only called after checking the processor supports them
+#define VECTOR_FN_X86(NAME, VALUE)                               \
+    __attribute__((target("avx2,fma"))) void NAME##AVX2(         \
+        float *out, const float *in, dim_t n) {                  \
+        for (dim_t i = 0; i < n; ++i) { out[i] = VALUE(in[i]); } \
+    }                                                            \
+    __attribute__((target("avx512f"))) void NAME##AVX512(        \
+        float *out, const float *in, dim_t n) {                  \
+        for (dim_t i = 0; i < n; ++i) { out[i] = VALUE(in[i]); } \
+    }
+#else
+#define VECTOR_FN_X86(NAME, VALUE)
+#endif
+
+/// Defines the loops which apply \p VALUE for each instruction set. The
+/// default loop uses the vector instructions of the build target, such as
+/// SSE2 or NEON.
+#define VECTOR_FN(NAME, VALUE)                                   \
+    void NAME##Default(float *out, const float *in, dim_t n) {   \
+        for (dim_t i = 0; i < n; ++i) { out[i] = VALUE(in[i]); } \
+    }                                                            \
+    VECTOR_FN_X86(NAME, VALUE)
+
+VECTOR_FN(exp, expValue)
+VECTOR_FN(log, logValue)
+VECTOR_FN(sin, sinValue)
+VECTOR_FN(cos, cosValue)
+VECTOR_FN(sigmoid, sigmoidValue)
+
+#undef VECTOR_FN
+#undef VECTOR_FN_X86
+
+bool isVectorMathEnabled() {
+    static const bool enabled = getEnvVar("AF_CPU_VECTOR_MATH") != "0";
+    return enabled;
+}
+
+#ifdef AF_MATH_X86_TARGETS
+#define SELECT_VECTOR_FN(NAME)                                              \
+    (__builtin_cpu_supports("avx512f")                                      \
+         ? NAME##AVX512                                                     \
+         : (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") \
+                ? NAME##AVX2                                                \
+                : NAME##Default))
+#else
+#define SELECT_VECTOR_FN(NAME) NAME##Default
+#endif
+
+/// Applies \p func of the C library to the \p n values of \p in
+template<typename F>
+void applyLibm(float *out, const float *in, dim_t n, F func) {
+    for (dim_t i = 0; i < n; ++i) { out[i] = func(in[i]); }
+}
+
+/// Recomputes the values of \p out whose input is too large for the range
+/// reduction of sine and cosine, or is not finite, with \p func
+template<typename F>
+void fixLargeTrig(float *out, const float *in, dim_t n, F func) {
+    for (dim_t i = 0; i < n; ++i) {
+        if (!(std::fabs(in[i]) <= MAX_TRIG_ARG)) { out[i] = func(in[i]); }
+    }
+}
+
+}  // namespace
+
+void vectorExp(float *out, const float *in, dim_t n) {
+    static const vector_fn func = SELECT_VECTOR_FN(exp);
+    if (!isVectorMathEnabled()) {
+        return applyLibm(out, in, n, [](float x) { return std::exp(x); });
+    }
+    func(out, in, n);
+}
+
+void vectorLog(float *out, const float *in, dim_t n) {
+    static const vector_fn func = SELECT_VECTOR_FN(log);
+    if (!isVectorMathEnabled()) {
+        return applyLibm(out, in, n, [](float x) { return std::log(x); });
+    }
+    func(out, in, n);
+}
+
+void vectorSin(float *out, const float *in, dim_t n) {
+    static const vector_fn func = SELECT_VECTOR_FN(sin);
+    auto libm                   = [](float x) { return std::sin(x); };
+    if (!isVectorMathEnabled()) { return applyLibm(out, in, n, libm); }
+    func(out, in, n);
+    fixLargeTrig(out, in, n, libm);
+}
+
+void vectorCos(float *out, const float *in, dim_t n) {
+    static const vector_fn func = SELECT_VECTOR_FN(cos);
+    auto libm                   = [](float x) { return std::cos(x); };
+    if (!isVectorMathEnabled()) { return applyLibm(out, in, n, libm); }
+    func(out, in, n);
+    fixLargeTrig(out, in, n, libm);
+}
+
+void vectorSigmoid(float *out, const float *in, dim_t n) {
+    static const vector_fn func = SELECT_VECTOR_FN(sigmoid);
+    if (!isVectorMathEnabled()) {
+        return applyLibm(out, in, n,
+                         [](float x) { return 1.f / (1.f + std::exp(-x)); });
+    }
+    func(out, in, n);
+}
+
+#undef SELECT_VECTOR_FN
+
+}  // namespace cpu
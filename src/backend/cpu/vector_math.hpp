@@ -0,0 +1,43 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <af/defines.h>
+
+namespace cpu {
+
+// The functions below compute a math function for the \p n values of \p in.
+// They evaluate polynomial approximations without branches, which are
+// compiled for AVX-512 and AVX2 and chosen from the instruction sets the
+// processor supports. The results are within 6 ULP of the C library for
+// finite inputs, and the C library is used instead when AF_CPU_VECTOR_MATH
+// is set to 0.
+
+/// Computes the exponential of the \p n values of \p in
+void vectorExp(float *out, const float *in, dim_t n);
+
+/// Computes the natural logarithm of the \p n values of \p in
+void vectorLog(float *out, const float *in, dim_t n);
+
+/// Computes the sine of the \p n values of \p in
+///
+/// The values larger than 64 in magnitude use the C library, since the
+/// range reduction of the approximation loses precision for them.
+void vectorSin(float *out, const float *in, dim_t n);
+
+/// Computes the cosine of the \p n values of \p in
+///
+/// The values larger than 64 in magnitude use the C library, since the
+/// range reduction of the approximation loses precision for them.
+void vectorCos(float *out, const float *in, dim_t n);
+
+/// Computes the logistic sigmoid of the \p n values of \p in
+void vectorSigmoid(float *out, const float *in, dim_t n);
+
+}  // namespace cpu
@@ -61,7 +61,44 @@ Array<uint> where(const Array<T> &in) {
     return out;
 }
 
-#define INSTANTIATE(T) template Array<uint> where<T>(const Array<T> &in);
+template<typename T>
+Array<T> compact(const Array<T> &in, const Array<char> &mask) {
+    const dim_t *dims     = mask.dims().get();
+    const dim_t *mstrides = mask.strides().get();
+    const dim_t *istrides = in.strides().get();
+
+    const char *mptr = mask.get();
+    const T *iptr    = in.get();
+    auto out_vec     = memAlloc<T>(mask.elements());
+    getQueue().sync();
+
+    dim_t count = 0;
+    for (dim_t w = 0; w < dims[3]; w++) {
+        for (dim_t z = 0; z < dims[2]; z++) {
+            for (dim_t y = 0; y < dims[1]; y++) {
+                const char *mline = mptr + w * mstrides[3] +
+                                    z * mstrides[2] + y * mstrides[1];
+                const T *iline = iptr + w * istrides[3] + z * istrides[2] +
+                                 y * istrides[1];
+
+                for (dim_t x = 0; x < dims[0]; x++) {
+                    if (mline[x * mstrides[0]]) {
+                        out_vec[count++] = iline[x * istrides[0]];
+                    }
+                }
+            }
+        }
+    }
+
+    Array<T> out = createDeviceDataArray<T>(dim4(count), out_vec.get());
+    out_vec.release();
+    return out;
+}
+
+#define INSTANTIATE(T)                                 \
+    template Array<uint> where<T>(const Array<T> &in); \
+    template Array<T> compact<T>(const Array<T> &in,   \
+                                 const Array<char> &mask);
 
 INSTANTIATE(float)
 INSTANTIATE(cfloat)
@@ -12,4 +12,9 @@
 namespace cpu {
 template<typename T>
 Array<uint> where(const Array<T>& in);
+
+/// Copies the values of \p in where \p mask is true into a vector, in the
+/// order of their linear indices
+template<typename T>
+Array<T> compact(const Array<T>& in, const Array<char>& mask);
 }
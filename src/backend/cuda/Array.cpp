@@ -8,8 +8,12 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <common/ExternalRelease.hpp>
+#include <common/bfloat16.hpp>
 #include <common/half.hpp>
+#include <common/jit/JitHeuristics.hpp>
 #include <common/jit/NodeIterator.hpp>
+#include <common/visit_array.hpp>
 #include <copy.hpp>
 #include <err_cuda.hpp>
 #include <jit/BufferNode.hpp>
@@ -24,14 +28,22 @@
 #include <utility>
 
 using af::dim4;
+using common::array_value_t;
+using common::bfloat16;
+using common::callJitHeuristic;
+using common::getJitTreeInfo;
 using common::half;
+using common::hasJitHeuristic;
+using common::isExternal;
 using common::Node;
 using common::Node_ptr;
 using common::NodeIterator;
+using common::visitArray;
 using cuda::jit::BufferNode;
 
 using std::accumulate;
 using std::move;
+using std::pair;
 using std::shared_ptr;
 using std::vector;
 
@@ -50,8 +62,16 @@ void verifyTypeSupport() {
 
 template<typename T>
 Node_ptr bufferNodePtr() {
-    return Node_ptr(
-        new BufferNode<T>(static_cast<af::dtype>(dtype_traits<T>::af_type)));
+    return common::makePooled<BufferNode<T>>(
+        static_cast<af::dtype>(dtype_traits<T>::af_type));
+}
+
+/// Allocates the data of an evaluated array. The control block of the
+/// shared pointer is allocated from the block cache.
+template<typename T>
+shared_ptr<T> allocData(const dim_t elements) {
+    return shared_ptr<T>(memAlloc<T>(elements).release(), memFree<T>,
+                         common::PoolAllocator<T>());
 }
 
 template<typename T>
@@ -135,6 +155,17 @@ Array<T>::Array(const af::dim4 &dims, common::Node_ptr n)
     , ready(false)
     , owner(true) {}
 
+template<typename T>
+Array<T>::Array(const af::dim4 &dims, const af::dim4 &strides, dim_t offset_,
+                shared_ptr<T> in_data)
+    : info(getActiveDeviceId(), dims, offset_, strides,
+           static_cast<af_dtype>(dtype_traits<T>::af_type))
+    , data(move(in_data))
+    , data_dims(dims)
+    , node(bufferNodePtr<T>())
+    , ready(true)
+    , owner(true) {}
+
 template<typename T>
 Array<T>::Array(const af::dim4 &dims, const af::dim4 &strides, dim_t offset_,
                 const T *const in_data, bool is_device)
@@ -156,12 +187,41 @@ Array<T>::Array(const af::dim4 &dims, const af::dim4 &strides, dim_t offset_,
     }
 }
 
+/// Returns the buffer of a node in the tree of \p root which the evaluation
+/// of the tree can overwrite, or nullptr if there is none.
+///
+/// The generated kernel reads each element of a linear buffer with the
+/// dimensions of the output at the index it writes, so the output can be
+/// written in place when no other array or tree reads the buffer.
+template<typename T>
+shared_ptr<T> getReusableBuffer(const Node_ptr &root, const dim4 &dims) {
+    if (root.use_count() > 1 || !root->hasExclusiveChildren()) {
+        return nullptr;
+    }
+
+    dim_t odims[4] = {dims[0], dims[1], dims[2], dims[3]};
+    for (NodeIterator<> it(root.get()), end; it != end; ++it) {
+        if (!it->isBuffer() ||
+            it->getType() != static_cast<af::dtype>(dtype_traits<T>::af_type)) {
+            continue;
+        }
+        const auto &buffer        = static_cast<const BufferNode<T> &>(*it);
+        const shared_ptr<T> &data = buffer.getData();
+        if (data.use_count() == 1 && !isExternal(data) &&
+            buffer.getParam().ptr == data.get() && buffer.isLinear(odims)) {
+            return data;
+        }
+    }
+    return nullptr;
+}
+
 template<typename T>
 void Array<T>::eval() {
     if (isReady()) { return; }
 
     this->setId(getActiveDeviceId());
-    this->data = shared_ptr<T>(memAlloc<T>(elements()).release(), memFree<T>);
+    this->data = getReusableBuffer<T>(node, dims());
+    if (!this->data) { this->data = allocData<T>(elements()); }
 
     ready = true;
     evalNodes<T>(*this, this->getNode().get());
@@ -184,6 +244,22 @@ void Array<T>::eval() const {
     const_cast<Array<T> *>(this)->eval();
 }
 
+/// Returns the size of the parameters of the tree of \p root in a batched
+/// JIT kernel, or 0 if the tree has too many elements to be batched or is
+/// not linear.
+template<typename T>
+size_t getBatchParamBytes(const Node_ptr &root, const dim4 &dims) {
+    if (dims.elements() > common::kJitBatchMaxElements) { return 0; }
+
+    dim_t odims[4] = {dims[0], dims[1], dims[2], dims[3]};
+    size_t bytes   = sizeof(Param<T>) + sizeof(int);
+    for (NodeIterator<> it(root.get()), end; it != end; ++it) {
+        if (!it->isLinear(odims)) { return 0; }
+        bytes += it->isBuffer() ? sizeof(T *) : it->getParamBytes();
+    }
+    return bytes;
+}
+
 template<typename T>
 void evalMultiple(std::vector<Array<T> *> arrays) {
     vector<Param<T>> outputs;
@@ -196,9 +272,50 @@ void evalMultiple(std::vector<Array<T> *> arrays) {
                                      return l->dims() != r->dims();
                                  });
 
-    // If they are not the same. eval individually
+    // If they are not the same, the small linear arrays are evaluated in
+    // batches with a single kernel and the others individually
     if (it != end(arrays)) {
-        for (auto ptr : arrays) { ptr->eval(); }
+        // The parameter space of CUDA kernels less the grid size and the
+        // padding used by passesJitHeuristics
+        constexpr size_t max_param_size = 4096 - sizeof(uint) - 256;
+        size_t param_size               = 0;
+
+        auto evalBatch = [&]() {
+            if (outputs.size() > 1) {
+                evalNodesBatched(outputs, nodes);
+            } else if (outputs.size() == 1) {
+                evalNodes(outputs, nodes);
+            }
+            for (Array<T> *array : output_arrays) {
+                array->node = bufferNodePtr<T>();
+            }
+            outputs.clear();
+            output_arrays.clear();
+            nodes.clear();
+            param_size = 0;
+        };
+
+        for (Array<T> *array : arrays) {
+            if (array->isReady()) { continue; }
+
+            const size_t bytes =
+                getBatchParamBytes<T>(array->node, array->dims());
+            if (bytes == 0) {
+                array->eval();
+                continue;
+            }
+            if (param_size + bytes > max_param_size) { evalBatch(); }
+            param_size += bytes;
+
+            array->ready = true;
+            array->setId(getActiveDeviceId());
+            array->data = allocData<T>(array->elements());
+
+            outputs.push_back(*array);
+            output_arrays.push_back(array);
+            nodes.push_back(array->node.get());
+        }
+        evalBatch();
         return;
     }
 
@@ -207,8 +324,7 @@ void evalMultiple(std::vector<Array<T> *> arrays) {
 
         array->ready = true;
         array->setId(getActiveDeviceId());
-        array->data =
-            shared_ptr<T>(memAlloc<T>(array->elements()).release(), memFree<T>);
+        array->data = allocData<T>(array->elements());
 
         outputs.push_back(*array);
         output_arrays.push_back(array);
@@ -220,6 +336,36 @@ void evalMultiple(std::vector<Array<T> *> arrays) {
     for (Array<T> *array : output_arrays) { array->node = bufferNodePtr<T>(); }
 }
 
+void evalMultiple(const vector<pair<af::dtype, void *>> &arrays) {
+    vector<Param<void>> outputs;
+    vector<Node *> nodes;
+    vector<pair<af::dtype, void *>> output_arrays;
+
+    for (const auto &array : arrays) {
+        visitArray(array.first, array.second, [&](auto &arr) {
+            using T = array_value_t<decltype(arr)>;
+            if (arr.isReady()) { return; }
+
+            arr.ready = true;
+            arr.setId(getActiveDeviceId());
+            arr.data = allocData<T>(arr.elements());
+
+            Param<data_t<T>> param = arr;
+            outputs.emplace_back(param.ptr, param.dims, param.strides);
+            output_arrays.push_back(array);
+            nodes.push_back(arr.node.get());
+        });
+    }
+
+    evalNodes(outputs, nodes);
+
+    for (const auto &array : output_arrays) {
+        visitArray(array.first, array.second, [](auto &arr) {
+            arr.node = bufferNodePtr<array_value_t<decltype(arr)>>();
+        });
+    }
+}
+
 template<typename T>
 Node_ptr Array<T>::getNode() {
     if (node->isBuffer()) {
@@ -254,6 +400,27 @@ Node_ptr Array<T>::getNode() const {
 template<typename T>
 kJITHeuristics passesJitHeuristics(Node *root_node) {
     if (!evalFlag()) { return kJITHeuristics::Pass; }
+
+    // The size of the parameters without any extra arguments from the
+    // JIT tree. This includes one output Param object and 4 integers.
+    constexpr size_t base_param_size = sizeof(Param<T>) + (4 * sizeof(uint));
+
+    // extra padding for safety to avoid failure during compilation
+    constexpr size_t jit_padding_size = 256;  //@umar dontfix!
+    // This is the maximum size of the params that can be allowed by the
+    // CUDA platform.
+    constexpr size_t max_param_size =
+        4096 - base_param_size - jit_padding_size;
+
+    if (hasJitHeuristic()) {
+        af_jit_tree_info info = getJitTreeInfo(root_node, sizeof(Param<T>));
+        info.max_height       = static_cast<int>(getMaxJitSize());
+        info.max_param_bytes  = max_param_size;
+        info.exceeds_memory_pressure =
+            jitTreeExceedsMemoryPressure(info.buffer_bytes);
+        return callJitHeuristic(info);
+    }
+
     if (root_node->getHeight() >= static_cast<int>(getMaxJitSize())) {
         return kJITHeuristics::TreeHeight;
     }
@@ -262,18 +429,6 @@ kJITHeuristics passesJitHeuristics(Node *root_node) {
     // inexpensive operation and does not traverse the JIT tree.
     if (root_node->getHeight() > 6 ||
         getMemoryPressure() >= getMemoryPressureThreshold()) {
-        // The size of the parameters without any extra arguments from the
-        // JIT tree. This includes one output Param object and 4 integers.
-        constexpr size_t base_param_size =
-            sizeof(Param<T>) + (4 * sizeof(uint));
-
-        // extra padding for safety to avoid failure during compilation
-        constexpr size_t jit_padding_size = 256;  //@umar dontfix!
-        // This is the maximum size of the params that can be allowed by the
-        // CUDA platform.
-        constexpr size_t max_param_size =
-            4096 - base_param_size - jit_padding_size;
-
         struct tree_info {
             size_t total_buffer_size;
             size_t num_buffers;
@@ -336,6 +491,13 @@ Array<T> createDeviceDataArray(const dim4 &dims, void *data) {
     return Array<T>(dims, static_cast<T *>(data), is_device, copy_device);
 }
 
+template<typename T>
+Array<T> createSharedDataArray(const dim4 &dims, const dim4 &strides,
+                               dim_t offset, shared_ptr<T> data) {
+    verifyTypeSupport<T>();
+    return Array<T>(dims, strides, offset, move(data));
+}
+
 template<typename T>
 Array<T> createValueArray(const dim4 &dims, const T &value) {
     verifyTypeSupport<T>();
@@ -353,18 +515,12 @@ Array<T> createSubArray(const Array<T> &parent,
                         const std::vector<af_seq> &index, bool copy) {
     parent.eval();
 
-    dim4 dDims          = parent.getDataDims();
-    dim4 dStrides       = calcStrides(dDims);
-    dim4 parent_strides = parent.strides();
-
-    if (dStrides != parent_strides) {
-        const Array<T> parentCopy = copyArray(parent);
-        return createSubArray(parentCopy, index, copy);
-    }
-
-    const dim4 &pDims = parent.dims();
-    dim4 dims         = toDims(index, pDims);
-    dim4 strides      = toStride(index, dDims);
+    // The strides of the parent are scaled, so the views of views share the
+    // buffer of the parent instead of a linearized copy of it
+    const dim4 &parent_strides = parent.strides();
+    const dim4 &pDims          = parent.dims();
+    dim4 dims                  = toDims(index, pDims);
+    dim4 strides               = toViewStride(index, parent_strides);
 
     // Find total offsets after indexing
     dim4 offsets = toOffset(index, pDims);
@@ -394,10 +550,10 @@ void destroyArray(Array<T> *A) {
 
 template<typename T>
 void writeHostDataArray(Array<T> &arr, const T *const data,
-                        const size_t bytes) {
+                        const size_t bytes, const size_t offset) {
     if (!arr.isOwner()) { arr = copyArray<T>(arr); }
 
-    T *ptr = arr.get();
+    char *ptr = reinterpret_cast<char *>(arr.get()) + offset;
 
     CUDA_CHECK(cudaMemcpyAsync(ptr, data, bytes, cudaMemcpyHostToDevice,
                                cuda::getActiveStream()));
@@ -426,6 +582,9 @@ void Array<T>::setDataDims(const dim4 &new_dims) {
     template Array<T> createHostDataArray<T>(const dim4 &size,                \
                                              const T *const data);            \
     template Array<T> createDeviceDataArray<T>(const dim4 &size, void *data); \
+    template Array<T> createSharedDataArray<T>(                               \
+        const dim4 &dims, const dim4 &strides, dim_t offset,                  \
+        shared_ptr<T> data);                                                  \
     template Array<T> createValueArray<T>(const dim4 &size, const T &value);  \
     template Array<T> createEmptyArray<T>(const dim4 &size);                  \
     template Array<T> createParamArray<T>(Param<T> & tmp, bool owner);        \
@@ -445,7 +604,8 @@ void Array<T>::setDataDims(const dim4 &new_dims) {
     template void Array<T>::eval() const;                                     \
     template T *Array<T>::device();                                           \
     template void writeHostDataArray<T>(Array<T> & arr, const T *const data,  \
-                                        const size_t bytes);                  \
+                                        const size_t bytes,                   \
+                                        const size_t offset);                 \
     template void writeDeviceDataArray<T>(                                    \
         Array<T> & arr, const void *const data, const size_t bytes);          \
     template void evalMultiple<T>(std::vector<Array<T> *> arrays);            \
@@ -465,5 +625,6 @@ INSTANTIATE(uintl)
 INSTANTIATE(short)
 INSTANTIATE(ushort)
 INSTANTIATE(half)
+INSTANTIATE(bfloat16)
 
 }  // namespace cuda
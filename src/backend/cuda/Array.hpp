@@ -12,6 +12,7 @@
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/MemoryManagerBase.hpp>
+#include <common/PoolAllocator.hpp>
 #include <common/jit/Node.hpp>
 #include <cuda.h>
 #include <cuda_runtime_api.h>
@@ -21,6 +22,7 @@
 #include <af/dim4.hpp>
 #include "traits.hpp"
 
+#include <utility>
 #include <vector>
 
 namespace cuda {
@@ -36,9 +38,23 @@ template<typename T>
 void evalNodes(std::vector<Param<T>> &out,
                const std::vector<common::Node *> &nodes);
 
+/// Evaluates trees of different types. The outputs have the types of the
+/// trees in \p nodes.
+void evalNodes(std::vector<Param<void>> &outputs,
+               const std::vector<common::Node *> &nodes);
+
+/// Evaluates linear trees with different dimensions with a single kernel
+template<typename T>
+void evalNodesBatched(std::vector<Param<T>> &outputs,
+                      const std::vector<common::Node *> &nodes);
+
 template<typename T>
 void evalMultiple(std::vector<Array<T> *> arrays);
 
+/// Evaluates arrays of different types with the same dimensions. Each
+/// element of \p arrays is the type of an array and a pointer to its Array.
+void evalMultiple(const std::vector<std::pair<af::dtype, void *>> &arrays);
+
 template<typename T>
 Array<T> createNodeArray(const af::dim4 &dims, common::Node_ptr node);
 
@@ -55,6 +71,15 @@ Array<T> createHostDataArray(const af::dim4 &dims, const T *const data);
 template<typename T>
 Array<T> createDeviceDataArray(const af::dim4 &dims, void *data);
 
+/// Creates an array which uses \p data as its buffer without copying it
+///
+/// The array keeps a reference to \p data. The memory is released by the
+/// deleter of \p data once the array and all the arrays which share its
+/// buffer are destroyed.
+template<typename T>
+Array<T> createSharedDataArray(const af::dim4 &dims, const af::dim4 &strides,
+                               dim_t offset, std::shared_ptr<T> data);
+
 template<typename T>
 Array<T> createStridedArray(const af::dim4 &dims, const af::dim4 &strides,
                             dim_t offset, const T *const in_data,
@@ -63,8 +88,11 @@ Array<T> createStridedArray(const af::dim4 &dims, const af::dim4 &strides,
 }
 
 /// Copies data to an existing Array object from a host pointer
+///
+/// \p bytes bytes are written starting \p offset bytes into the array
 template<typename T>
-void writeHostDataArray(Array<T> &arr, const T *const data, const size_t bytes);
+void writeHostDataArray(Array<T> &arr, const T *const data, const size_t bytes,
+                        const size_t offset = 0);
 
 /// Copies data to an existing Array object from a device pointer
 template<typename T>
@@ -86,6 +114,14 @@ Array<T> createEmptyArray(const af::dim4 &dims);
 template<typename T>
 Array<T> createParamArray(Param<T> &tmp, bool owner);
 
+/// Creates a view of \p parent without copying its data. The views of views
+/// share the buffer of the first parent.
+///
+/// \param[in] parent The array to index
+/// \param[in] index  The sequences of the view along each dimension
+/// \param[in] copy   False if the caller handles any strides. If true, views
+///                   with non contiguous columns or negative strides are
+///                   copied into a linear array.
 template<typename T>
 Array<T> createSubArray(const Array<T> &parent,
                         const std::vector<af_seq> &index, bool copy = true);
@@ -134,8 +170,14 @@ class Array {
           const dim4 &stride);
     Array(Param<T> &tmp, bool owner);
     Array(const af::dim4 &dims, common::Node_ptr n);
+    Array(const af::dim4 &dims, const af::dim4 &strides, dim_t offset,
+          std::shared_ptr<T> in_data);
 
    public:
+    // The handles of the arrays are created and destroyed by every call of
+    // the API, so they are allocated from the block cache of the thread
+    AF_POOL_ALLOCATED
+
     Array(const Array<T> &other) = default;
 
     Array(Array<T> &&other) noexcept = default;
@@ -258,10 +300,16 @@ class Array {
     common::Node_ptr getNode() const;
 
     friend void evalMultiple<T>(std::vector<Array<T> *> arrays);
+    friend void evalMultiple(
+        const std::vector<std::pair<af::dtype, void *>> &arrays);
     friend Array<T> createValueArray<T>(const af::dim4 &size, const T &value);
     friend Array<T> createHostDataArray<T>(const af::dim4 &dims,
                                            const T *const data);
     friend Array<T> createDeviceDataArray<T>(const af::dim4 &dims, void *data);
+    friend Array<T> createSharedDataArray<T>(const af::dim4 &dims,
+                                             const af::dim4 &strides,
+                                             dim_t offset,
+                                             std::shared_ptr<T> data);
     friend Array<T> createStridedArray<T>(const af::dim4 &dims,
                                           const af::dim4 &strides, dim_t offset,
                                           const T *const in_data,
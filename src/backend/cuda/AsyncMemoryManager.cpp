@@ -0,0 +1,359 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <AsyncMemoryManager.hpp>
+
+#include <common/DefaultMemoryManager.hpp>
+#include <common/Logger.hpp>
+#include <common/dispatch.hpp>
+#include <common/err_common.hpp>
+#include <common/util.hpp>
+#include <cuda_runtime.h>
+#include <err_cuda.hpp>
+#include <platform.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+using common::bytesToString;
+using std::max;
+using std::string;
+
+// Stream ordered allocations were added in CUDA 11.2
+#if CUDART_VERSION >= 11020
+#define AF_CUDA_HAS_MEMPOOL 1
+#endif
+
+namespace cuda {
+
+namespace {
+#ifdef AF_CUDA_HAS_MEMPOOL
+cudaMemPool_t getMemPool(int device) {
+    cudaMemPool_t pool;
+    CUDA_CHECK(cudaDeviceGetDefaultMemPool(&pool, getDeviceNativeId(device)));
+    return pool;
+}
+#endif
+}  // namespace
+
+bool isAsyncMemoryManagerSupported() {
+#ifdef AF_CUDA_HAS_MEMPOOL
+    for (int n = 0; n < getDeviceCount(); n++) {
+        int supported = 0;
+        cudaError_t err = cudaDeviceGetAttribute(
+            &supported, cudaDevAttrMemoryPoolsSupported, getDeviceNativeId(n));
+        if (err != cudaSuccess || supported == 0) {
+            cudaGetLastError();  // Reset Errors
+            return false;
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool isAsyncMemoryManagerRequested() {
+    static const bool requested =
+        getEnvVar("AF_CUDA_MEMORY_MANAGER") == "async";
+    return requested;
+}
+
+void setMemPoolReleaseThreshold(int device, uint64_t bytes) {
+#ifdef AF_CUDA_HAS_MEMPOOL
+    CUDA_CHECK(cudaMemPoolSetAttribute(
+        getMemPool(device), cudaMemPoolAttrReleaseThreshold, &bytes));
+#else
+    UNUSED(device);
+    UNUSED(bytes);
+    AF_ERROR("Memory pools require CUDA 11.2 or newer", AF_ERR_NOT_SUPPORTED);
+#endif
+}
+
+uint64_t getMemPoolReleaseThreshold(int device) {
+#ifdef AF_CUDA_HAS_MEMPOOL
+    uint64_t bytes = 0;
+    CUDA_CHECK(cudaMemPoolGetAttribute(
+        getMemPool(device), cudaMemPoolAttrReleaseThreshold, &bytes));
+    return bytes;
+#else
+    UNUSED(device);
+    AF_ERROR("Memory pools require CUDA 11.2 or newer", AF_ERR_NOT_SUPPORTED);
+#endif
+}
+
+AsyncMemoryManager::memory_info &AsyncMemoryManager::getCurrentMemoryInfo() {
+    return memory[this->getActiveDeviceId()];
+}
+
+AsyncMemoryManager::AsyncMemoryManager(int num_devices)
+    : mem_step_size(1024), stats_enabled(false), memory(num_devices) {
+    string env_var = getEnvVar("AF_MEM_STATS");
+    if (!env_var.empty()) { this->stats_enabled = env_var[0] != '0'; }
+}
+
+void AsyncMemoryManager::initialize() {
+    // By default the pool releases all of its unused memory every time the
+    // device is synchronized. Keep the memory cached unless requested
+    // otherwise.
+    uint64_t threshold = std::numeric_limits<uint64_t>::max();
+    string env_var     = getEnvVar("AF_CUDA_MEM_POOL_RELEASE_THRESHOLD");
+    if (!env_var.empty()) { threshold = std::stoull(env_var); }
+
+    for (unsigned n = 0; n < memory.size(); n++) {
+        // Same heuristic as the default memory manager
+        size_t memsize = this->getMaxMemorySize(static_cast<int>(n));
+        memory[n].max_bytes =
+            memsize == 0
+                ? common::ONE_GB
+                : max(memsize * 0.75,
+                      static_cast<double>(memsize - common::ONE_GB));
+        setMemPoolReleaseThreshold(static_cast<int>(n), threshold);
+    }
+}
+
+void AsyncMemoryManager::shutdown() { signalMemoryCleanup(); }
+
+void AsyncMemoryManager::addMemoryManagement(int device) {
+    if (static_cast<size_t>(device) < memory.size()) { return; }
+    memory.resize(device + 1);
+}
+
+void AsyncMemoryManager::removeMemoryManagement(int device) {
+    if (static_cast<size_t>(device) >= memory.size()) {
+        AF_ERROR("No matching device found", AF_ERR_ARG);
+    }
+}
+
+void *AsyncMemoryManager::alloc(bool user_lock, const unsigned ndims,
+                                dim_t *dims, const unsigned element_size) {
+    size_t bytes = element_size;
+    for (unsigned i = 0; i < ndims; ++i) { bytes *= dims[i]; }
+    if (bytes == 0) { return nullptr; }
+
+    size_t alloc_bytes = divup(bytes, mem_step_size) * mem_step_size;
+
+    void *ptr = nullptr;
+#ifdef AF_CUDA_HAS_MEMPOOL
+    cudaStream_t stream = getActiveStream();
+    cudaError_t err     = cudaMallocAsync(&ptr, alloc_bytes, stream);
+    if (err == cudaErrorMemoryAllocation) {
+        // Return the unused memory of the pool and try again
+        cudaGetLastError();  // Reset Errors
+        signalMemoryCleanup();
+        err = cudaMallocAsync(&ptr, alloc_bytes, stream);
+    }
+    CUDA_CHECK(err);
+#else
+    AF_ERROR("Memory pools require CUDA 11.2 or newer", AF_ERR_NOT_SUPPORTED);
+#endif
+    AF_TRACE("cudaMallocAsync: {:>7} {}", bytesToString(alloc_bytes), ptr);
+
+    common::lock_guard_t lock(this->memory_mutex);
+    memory_info &current    = this->getCurrentMemoryInfo();
+    current.locked_map[ptr] = {!user_lock, user_lock, alloc_bytes};
+    current.lock_bytes += alloc_bytes;
+    current.lock_buffers++;
+    if (this->stats_enabled) {
+        current.stats.record(bytes, false, current.lock_bytes,
+                             current.lock_buffers);
+    }
+    return ptr;
+}
+
+size_t AsyncMemoryManager::allocated(void *ptr) {
+    if (!ptr) { return 0; }
+    common::lock_guard_t lock(this->memory_mutex);
+    memory_info &current = this->getCurrentMemoryInfo();
+    auto locked_iter     = current.locked_map.find(ptr);
+    if (locked_iter == current.locked_map.end()) { return 0; }
+    return locked_iter->second.bytes;
+}
+
+void AsyncMemoryManager::unlock(void *ptr, bool user_unlock) {
+    // Shortcut for empty arrays
+    if (!ptr) { return; }
+
+    bool from_pool = true;
+    {
+        common::lock_guard_t lock(this->memory_mutex);
+        memory_info &current = this->getCurrentMemoryInfo();
+
+        auto locked_iter = current.locked_map.find(ptr);
+        if (locked_iter == current.locked_map.end()) {
+            // Pointer not found in locked map. Probably came from user
+            from_pool = false;
+        } else {
+            locked_info &info = locked_iter->second;
+            if (user_unlock) {
+                info.user_lock = false;
+            } else {
+                info.manager_lock = false;
+            }
+
+            // Return early if either one is locked
+            if (info.user_lock || info.manager_lock) { return; }
+
+            // Buffers locked by the user without being allocated by the
+            // memory manager are not counted
+            from_pool = info.bytes > 0;
+            if (from_pool) {
+                current.lock_bytes -= info.bytes;
+                current.lock_buffers--;
+            }
+            current.locked_map.erase(locked_iter);
+        }
+    }
+
+    AF_TRACE("cudaFreeAsync:         {}", ptr);
+    cudaError_t err = cudaSuccess;
+#ifdef AF_CUDA_HAS_MEMPOOL
+    err = from_pool ? cudaFreeAsync(ptr, getActiveStream()) : cudaFree(ptr);
+#else
+    err = cudaFree(ptr);
+#endif
+    if (err != cudaErrorCudartUnloading) { CUDA_CHECK(err); }
+}
+
+void AsyncMemoryManager::signalMemoryCleanup() {
+#ifdef AF_CUDA_HAS_MEMPOOL
+    const int device = this->getActiveDeviceId();
+    AF_TRACE("GC: Trimming the memory pool of device {}", device);
+    cudaError_t err = cudaMemPoolTrimTo(getMemPool(device), 0);
+    if (err != cudaErrorCudartUnloading) { CUDA_CHECK(err); }
+#endif
+}
+
+void AsyncMemoryManager::printInfo(const char *msg, const int device) {
+    UNUSED(device);
+    printf("%s\n", msg);
+    printf(
+        "---------------------------------------------------------\n"
+        "|     POINTER      |    SIZE    |  AF LOCK  | USER LOCK |\n"
+        "---------------------------------------------------------\n");
+
+    common::lock_guard_t lock(this->memory_mutex);
+    const memory_info &current = this->getCurrentMemoryInfo();
+    for (const auto &kv : current.locked_map) {
+        const char *unit = "KB";
+        double size      = static_cast<double>(kv.second.bytes) / 1024;
+        if (size >= 1024) {
+            size = size / 1024;
+            unit = "MB";
+        }
+
+        printf("|  %14p  |  %6.f %s | %9s | %9s |\n", kv.first, size, unit,
+               kv.second.manager_lock ? "Yes" : " No",
+               kv.second.user_lock ? "Yes" : " No");
+    }
+
+    printf("---------------------------------------------------------\n");
+}
+
+void AsyncMemoryManager::usageInfo(size_t *alloc_bytes, size_t *alloc_buffers,
+                                   size_t *lock_bytes, size_t *lock_buffers) {
+    size_t reserved = 0;
+#ifdef AF_CUDA_HAS_MEMPOOL
+    // The memory reserved by the pool includes the freed buffers which have
+    // not been returned to the system yet
+    uint64_t pool_bytes = 0;
+    CUDA_CHECK(cudaMemPoolGetAttribute(
+        getMemPool(this->getActiveDeviceId()),
+        cudaMemPoolAttrReservedMemCurrent, &pool_bytes));
+    reserved = static_cast<size_t>(pool_bytes);
+#endif
+
+    common::lock_guard_t lock(this->memory_mutex);
+    const memory_info &current = this->getCurrentMemoryInfo();
+    if (alloc_bytes) { *alloc_bytes = max(reserved, current.lock_bytes); }
+    if (alloc_buffers) { *alloc_buffers = current.lock_buffers; }
+    if (lock_bytes) { *lock_bytes = current.lock_bytes; }
+    if (lock_buffers) { *lock_buffers = current.lock_buffers; }
+}
+
+void AsyncMemoryManager::userLock(const void *ptr) {
+    common::lock_guard_t lock(this->memory_mutex);
+    memory_info &current = this->getCurrentMemoryInfo();
+
+    auto locked_iter = current.locked_map.find(const_cast<void *>(ptr));
+    if (locked_iter != current.locked_map.end()) {
+        locked_iter->second.user_lock = true;
+    } else {
+        // Zero bytes marks buffers that were not allocated by this manager
+        current.locked_map[const_cast<void *>(ptr)] = {false, true, 0};
+    }
+}
+
+void AsyncMemoryManager::userUnlock(const void *ptr) {
+    this->unlock(const_cast<void *>(ptr), true);
+}
+
+bool AsyncMemoryManager::isUserLocked(const void *ptr) {
+    common::lock_guard_t lock(this->memory_mutex);
+    memory_info &current = this->getCurrentMemoryInfo();
+    auto locked_iter     = current.locked_map.find(const_cast<void *>(ptr));
+    if (locked_iter == current.locked_map.end()) { return false; }
+    return locked_iter->second.user_lock;
+}
+
+size_t AsyncMemoryManager::getMemStepSize() {
+    common::lock_guard_t lock(this->memory_mutex);
+    return this->mem_step_size;
+}
+
+void AsyncMemoryManager::setMemStepSize(size_t new_step_size) {
+    common::lock_guard_t lock(this->memory_mutex);
+    this->mem_step_size = new_step_size;
+}
+
+float AsyncMemoryManager::getMemoryPressure() {
+    common::lock_guard_t lock(this->memory_mutex);
+    memory_info &current = this->getCurrentMemoryInfo();
+    return current.lock_bytes > current.max_bytes ? 1.0 : 0.0;
+}
+
+bool AsyncMemoryManager::jitTreeExceedsMemoryPressure(size_t bytes) {
+    common::lock_guard_t lock(this->memory_mutex);
+    memory_info &current = this->getCurrentMemoryInfo();
+    return 2 * bytes > current.lock_bytes;
+}
+
+void AsyncMemoryManager::setStatsEnabled(bool enabled) {
+    common::lock_guard_t lock(this->memory_mutex);
+    this->stats_enabled = enabled;
+}
+
+void AsyncMemoryManager::resetStats(int device) {
+    common::lock_guard_t lock(this->memory_mutex);
+    memory_info &current = memory[device];
+    current.stats.reset(current.lock_bytes, current.lock_buffers);
+}
+
+void AsyncMemoryManager::getStats(af_mem_stats *stats, int device) {
+    common::lock_guard_t lock(this->memory_mutex);
+    *stats = memory[device].stats.getTotals();
+}
+
+string AsyncMemoryManager::getStatsJson(int device) {
+    common::lock_guard_t lock(this->memory_mutex);
+    const memory_info &current = memory[device];
+    return current.stats.toJson(device, this->stats_enabled,
+                                current.lock_bytes, current.lock_buffers,
+                                current.lock_bytes, current.lock_buffers);
+}
+
+// The stream ordered pool already serves the temporaries without a
+// device allocation, so the allocations of a scope are not moved to a slab
+void AsyncMemoryManager::beginScope(size_t bytes) { UNUSED(bytes); }
+
+void AsyncMemoryManager::endScope() {}
+
+}  // namespace cuda
@@ -0,0 +1,111 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/MemoryManagerBase.hpp>
+#include <common/MemoryStats.hpp>
+#include <common/defines.hpp>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cuda {
+
+/// Returns true if the stream ordered memory manager can be used on all the
+/// devices. Requires CUDA 11.2 and a device that supports memory pools.
+bool isAsyncMemoryManagerSupported();
+
+/// Returns true if the user requested the stream ordered memory manager
+/// using the AF_CUDA_MEMORY_MANAGER environment variable
+bool isAsyncMemoryManagerRequested();
+
+/// Sets the number of bytes the memory pool of \p device keeps reserved
+/// when the pool is trimmed implicitly during synchronization
+void setMemPoolReleaseThreshold(int device, uint64_t bytes);
+
+/// Returns the release threshold of the memory pool of \p device
+uint64_t getMemPoolReleaseThreshold(int device);
+
+/// A memory manager which allocates buffers from the default memory pool of
+/// the device using cudaMallocAsync and cudaFreeAsync.
+///
+/// The buffers are allocated and freed in the order of the active stream so
+/// freeing memory never synchronizes the device. The caching is done by the
+/// CUDA memory pool instead of the memory manager. The release threshold of
+/// the pool determines how much memory is retained by the pool.
+class AsyncMemoryManager final : public common::memory::MemoryManagerBase {
+    struct locked_info {
+        bool manager_lock;
+        bool user_lock;
+        size_t bytes;
+    };
+
+    using locked_t = std::unordered_map<void *, locked_info>;
+
+    struct memory_info {
+        locked_t locked_map;
+        size_t max_bytes;
+        size_t lock_bytes;
+        size_t lock_buffers;
+        common::MemoryStats stats;
+
+        memory_info() : max_bytes(0), lock_bytes(0), lock_buffers(0) {}
+    };
+
+    size_t mem_step_size;
+    bool stats_enabled;
+    common::mutex_t memory_mutex;
+    std::vector<memory_info> memory;
+
+    memory_info &getCurrentMemoryInfo();
+
+   public:
+    explicit AsyncMemoryManager(int num_devices);
+
+    void initialize() override;
+    void shutdown() override;
+    void *alloc(bool user_lock, const unsigned ndims, dim_t *dims,
+                const unsigned element_size) override;
+    size_t allocated(void *ptr) override;
+    void unlock(void *ptr, bool user_unlock) override;
+
+    /// Returns the unused memory of the pool to the system. This does not
+    /// synchronize the device.
+    void signalMemoryCleanup() override;
+
+    void printInfo(const char *msg, const int device) override;
+    void usageInfo(size_t *alloc_bytes, size_t *alloc_buffers,
+                   size_t *lock_bytes, size_t *lock_buffers) override;
+    void userLock(const void *ptr) override;
+    void userUnlock(const void *ptr) override;
+    bool isUserLocked(const void *ptr) override;
+    size_t getMemStepSize() override;
+    void setMemStepSize(size_t new_step_size) override;
+    float getMemoryPressure() override;
+    bool jitTreeExceedsMemoryPressure(size_t bytes) override;
+
+    /// The buffers are cached by the pool, so every allocation is recorded
+    /// as a cache miss
+    void setStatsEnabled(bool enabled) override;
+    void resetStats(int device) override;
+    void getStats(af_mem_stats *stats, int device) override;
+    std::string getStatsJson(int device) override;
+    void beginScope(size_t bytes) override;
+    void endScope() override;
+
+    void addMemoryManagement(int device) override;
+    void removeMemoryManagement(int device) override;
+
+    ~AsyncMemoryManager() = default;
+};
+
+}  // namespace cuda
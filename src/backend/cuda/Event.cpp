@@ -68,4 +68,40 @@ af_event createAndMarkEvent() {
     return handle;
 }
 
+af_event createTimingEvent() {
+    getActiveStream();
+    auto e = std::make_unique<Event>();
+    if (e->createTiming() != CUDA_SUCCESS) {
+        AF_ERROR("Could not create event", AF_ERR_RUNTIME);
+    }
+    return getHandle(*(e.release()));
+}
+
+float elapsedTime(af_event start, af_event end) {
+    float ms = 0.f;
+    // Fails with CUDA_ERROR_INVALID_HANDLE for events created without timing
+    if (getEvent(end).elapsed(&ms, getEvent(start)) != CUDA_SUCCESS) {
+        AF_ERROR("Could not measure the time between the events", AF_ERR_ARG);
+    }
+    return ms;
+}
+
+void waitForNativeQueue(void* queue) {
+    Event event;
+    if (event.create() != CUDA_SUCCESS ||
+        event.mark(static_cast<cudaStream_t>(queue)) != CUDA_SUCCESS ||
+        event.enqueueWait(getActiveStream()) != CUDA_SUCCESS) {
+        AF_ERROR("Could not wait for the stream", AF_ERR_RUNTIME);
+    }
+}
+
+void signalNativeQueue(void* queue) {
+    Event event;
+    if (event.create() != CUDA_SUCCESS ||
+        event.mark(getActiveStream()) != CUDA_SUCCESS ||
+        event.enqueueWait(static_cast<cudaStream_t>(queue)) != CUDA_SUCCESS) {
+        AF_ERROR("Could not signal the stream", AF_ERR_RUNTIME);
+    }
+}
+
 }  // namespace cuda
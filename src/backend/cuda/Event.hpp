@@ -28,6 +28,17 @@ class CUDARuntimeEventPolicy {
         return err;
     }
 
+    static ErrorType createTimingEvent(CUevent *e) noexcept {
+        return cuEventCreate(e, CU_EVENT_DEFAULT);
+    }
+
+    static ErrorType elapsedTime(float *ms, CUevent *start,
+                                 CUevent *end) noexcept {
+        auto err = cuEventSynchronize(*end);
+        if (err != CUDA_SUCCESS) { return err; }
+        return cuEventElapsedTime(ms, *start, *end);
+    }
+
     static ErrorType markEvent(CUevent *e, QueueType &stream) noexcept {
         auto err = cuEventRecord(*e, stream);
         return err;
@@ -63,4 +74,19 @@ void block(af_event eventHandle);
 
 af_event createAndMarkEvent();
 
+/// \brief Creates an event which can be timed with elapsedTime
+af_event createTimingEvent();
+
+/// \brief Returns the milliseconds between the completion of two timing
+///        events
+float elapsedTime(af_event start, af_event end);
+
+/// \brief Makes the active queue wait for the work enqueued so far on the
+///        native \p queue of another library
+void waitForNativeQueue(void *queue);
+
+/// \brief Makes the native \p queue of another library wait for the work
+///        enqueued so far on the active queue
+void signalNativeQueue(void *queue);
+
 }  // namespace cuda
@@ -0,0 +1,86 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Graph.hpp>
+
+#include <AsyncMemoryManager.hpp>
+#include <common/GraphCapture.hpp>
+#include <common/MemoryManagerBase.hpp>
+#include <common/err_common.hpp>
+#include <err_cuda.hpp>
+#include <platform.hpp>
+
+#include <memory>
+
+using common::beginGraphCapture;
+using common::endGraphCapture;
+using common::isCapturingGraph;
+using std::unique_ptr;
+
+namespace cuda {
+
+Graph::~Graph() {
+    if (exec) { cudaGraphExecDestroy(exec); }
+    if (graph) { cudaGraphDestroy(graph); }
+    for (void *ptr : buffers) { memoryManager().unlock(ptr, false); }
+}
+
+void beginCapture() {
+    // The stream ordered allocations would be owned by the graph
+    if (dynamic_cast<AsyncMemoryManager *>(&memoryManager())) {
+        AF_ERROR("Graphs can not be captured with the asynchronous memory "
+                 "manager",
+                 AF_ERR_NOT_SUPPORTED);
+    }
+    const int device = static_cast<int>(getActiveDeviceId());
+    beginGraphCapture(device);
+    // The relaxed mode lets the memory manager allocate during the capture
+    cudaError_t err = cudaStreamBeginCapture(getActiveStream(),
+                                             cudaStreamCaptureModeRelaxed);
+    if (err != cudaSuccess) {
+        endGraphCapture(device);
+        CUDA_CHECK(err);
+    }
+}
+
+af_graph endCapture() {
+    const int device = static_cast<int>(getActiveDeviceId());
+    unique_ptr<Graph> res(new Graph());
+    res->device  = device;
+    res->buffers = endGraphCapture(device);
+    CUDA_CHECK(cudaStreamEndCapture(getActiveStream(), &res->graph));
+    CUDA_CHECK(
+        cudaGraphInstantiate(&res->exec, res->graph, nullptr, nullptr, 0));
+    return static_cast<af_graph>(res.release());
+}
+
+void replayGraph(const af_graph graph) {
+    const Graph &g = *static_cast<const Graph *>(graph);
+    if (g.device != static_cast<int>(getActiveDeviceId())) {
+        AF_ERROR("The graph was not captured on the active device",
+                 AF_ERR_DEVICE);
+    }
+    CUDA_CHECK(cudaGraphLaunch(g.exec, getActiveStream()));
+}
+
+void releaseGraph(af_graph graph) {
+    Graph *g       = static_cast<Graph *>(graph);
+    const int prev = setDevice(g->device);
+    // The replays still running use the buffers of the graph
+    cudaError_t err = cudaStreamSynchronize(getActiveStream());
+    delete g;
+    setDevice(prev);
+    CUDA_CHECK(err);
+}
+
+bool isCapturing() {
+    return isCapturingGraph(static_cast<int>(getActiveDeviceId()));
+}
+
+}  // namespace cuda
@@ -0,0 +1,46 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+#pragma once
+
+#include <cuda_runtime_api.h>
+#include <af/graph.h>
+
+#include <vector>
+
+namespace cuda {
+
+/// The CUDA graph captured from the stream of a device and the buffers it
+/// uses which were freed during the capture
+struct Graph {
+    int device           = 0;
+    cudaGraph_t graph    = nullptr;
+    cudaGraphExec_t exec = nullptr;
+    std::vector<void *> buffers;
+
+    Graph()                         = default;
+    Graph(const Graph &)            = delete;
+    Graph &operator=(const Graph &) = delete;
+    ~Graph();
+};
+
+/// Starts capturing the stream of the active device
+void beginCapture();
+
+/// Stops capturing and returns the instantiated graph
+af_graph endCapture();
+
+/// Launches \p graph on the stream of the active device
+void replayGraph(const af_graph graph);
+
+void releaseGraph(af_graph graph);
+
+/// Returns true if the stream of the active device is being captured
+bool isCapturing();
+
+}  // namespace cuda
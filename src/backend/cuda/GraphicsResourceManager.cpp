@@ -16,7 +16,52 @@
 #include <err_cuda.hpp>
 #include <platform.hpp>
 
+#include <utility>
+
 namespace cuda {
+GraphicsResourceManager::GraphicsResourceManager() {
+    CUDA_CHECK(cudaStreamCreateWithFlags(&mStream, cudaStreamNonBlocking));
+    CUDA_CHECK(cudaEventCreateWithFlags(&mReady, cudaEventDisableTiming));
+}
+
+GraphicsResourceManager::~GraphicsResourceManager() {
+    // No CUDA_CHECK for the same reasons as the unregistration of the
+    // resources below
+    cudaStreamSynchronize(mStream);
+    for (auto &copy : mPending) { cudaEventDestroy(copy.done); }
+    cudaEventDestroy(mReady);
+    cudaStreamDestroy(mStream);
+}
+
+void GraphicsResourceManager::popCopy() {
+    cudaEventDestroy(mPending.front().done);
+    mPending.pop_front();
+}
+
+cudaStream_t GraphicsResourceManager::beginCopy() {
+    while (!mPending.empty() &&
+           cudaEventQuery(mPending.front().done) == cudaSuccess) {
+        popCopy();
+    }
+    if (mPending.size() >= MAX_PENDING_COPIES) {
+        CUDA_CHECK(cudaEventSynchronize(mPending.front().done));
+        popCopy();
+    }
+
+    CUDA_CHECK(cudaEventRecord(mReady, getActiveStream()));
+    CUDA_CHECK(cudaStreamWaitEvent(mStream, mReady, 0));
+    return mStream;
+}
+
+void GraphicsResourceManager::endCopy(
+    std::vector<std::shared_ptr<const void>> inputs) {
+    PendingCopy copy;
+    copy.inputs = std::move(inputs);
+    CUDA_CHECK(cudaEventCreateWithFlags(&copy.done, cudaEventDisableTiming));
+    CUDA_CHECK(cudaEventRecord(copy.done, mStream));
+    mPending.push_back(std::move(copy));
+}
+
 GraphicsResourceManager::ShrdResVector
 GraphicsResourceManager::registerResources(
     const std::vector<uint32_t>& resources) {
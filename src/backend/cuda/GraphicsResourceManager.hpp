@@ -12,7 +12,9 @@
 #include <common/InteropManager.hpp>
 #include <driver_types.h>
 
+#include <deque>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace cuda {
@@ -22,12 +24,42 @@ class GraphicsResourceManager
    public:
     using ShrdResVector = std::vector<std::shared_ptr<cudaGraphicsResource_t>>;
 
-    GraphicsResourceManager() {}
+    /// The largest number of copies in flight on the graphics stream. The
+    /// next frame is copied while the previous one is still being copied or
+    /// drawn, and older frames are waited for.
+    static constexpr size_t MAX_PENDING_COPIES = 2;
+
+    GraphicsResourceManager();
+    ~GraphicsResourceManager();
     static ShrdResVector registerResources(
         const std::vector<uint32_t> &resources);
 
+    /// Returns the stream of the copies into the interop resources, after
+    /// making it wait for the work queued so far on the active stream. The
+    /// active stream never waits for the graphics stream, so drawing does
+    /// not stall compute. The inputs of the copy must be evaluated first.
+    cudaStream_t beginCopy();
+
+    /// Keeps \p inputs alive until the copies queued so far on the graphics
+    /// stream are done, as the active stream may reuse their memory as soon
+    /// as the arrays are released.
+    void endCopy(std::vector<std::shared_ptr<const void>> inputs);
+
    protected:
     GraphicsResourceManager(GraphicsResourceManager const &);
     void operator=(GraphicsResourceManager const &);
+
+   private:
+    struct PendingCopy {
+        cudaEvent_t done;
+        std::vector<std::shared_ptr<const void>> inputs;
+    };
+
+    /// Releases the oldest pending copy
+    void popCopy();
+
+    cudaStream_t mStream;
+    cudaEvent_t mReady;
+    std::deque<PendingCopy> mPending;
 };
 }  // namespace cuda
@@ -10,25 +10,37 @@
 #pragma once
 
 #include <common/KernelInterface.hpp>
+#include <common/Profiler.hpp>
 
 #include <EnqueueArgs.hpp>
 #include <backend.hpp>
 #include <cu_check_macro.hpp>
+#include <profiled_launch.hpp>
+
+#include <memory>
+#include <utility>
 
 namespace cuda {
 
 struct Enqueuer {
     template<typename... Args>
-    void operator()(void* ker, const EnqueueArgs& qArgs, Args... args) {
+    void operator()(CUmodule mod, void* ker, const EnqueueArgs& qArgs,
+                    Args... args) {
         void* params[] = {reinterpret_cast<void*>(&args)...};
         for (auto& event : qArgs.mEvents) {
             CU_CHECK(cuStreamWaitEvent(qArgs.mStream, event, 0));
         }
+        CUevent start = beginProfiledLaunch(qArgs.mStream);
         CU_CHECK(cuLaunchKernel(static_cast<CUfunction>(ker), qArgs.mBlocks.x,
                                 qArgs.mBlocks.y, qArgs.mBlocks.z,
                                 qArgs.mThreads.x, qArgs.mThreads.y,
                                 qArgs.mThreads.z, qArgs.mSharedMemSize,
                                 qArgs.mStream, params, NULL));
+        if (start) {
+            endProfiledLaunch(start, qArgs.mStream,
+                              common::getProfiledName(ker),
+                              common::getProfiledName(mod));
+        }
     }
 };
 
@@ -44,6 +56,10 @@ class Kernel
 
     Kernel() : BaseClass(nullptr, nullptr) {}
     Kernel(ModuleType mod, KernelType ker) : BaseClass(mod, ker) {}
+    /// \p owner keeps the module of the kernel loaded while the kernel
+    /// exists, see common::shareModule
+    Kernel(ModuleType mod, KernelType ker, std::shared_ptr<void> owner)
+        : BaseClass(mod, ker), mModuleOwner(std::move(owner)) {}
 
     DevPtrType getDevPtr(const char* name) final;
 
@@ -53,6 +69,9 @@ class Kernel
                  const bool syncCopy = false) final;
 
     int getFlag(DevPtrType src) final;
+
+   private:
+    std::shared_ptr<void> mModuleOwner;
 };
 
 }  // namespace cuda
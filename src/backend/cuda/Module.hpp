@@ -14,6 +14,7 @@
 
 #include <cuda.h>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -23,6 +24,9 @@ namespace cuda {
 class Module : public common::ModuleInterface<CUmodule> {
    private:
     std::unordered_map<std::string, std::string> mInstanceMangledNames;
+    /// Shared by the copies of a cached module and the kernels taken from
+    /// it. The module is unloaded when the last of them is destroyed.
+    std::shared_ptr<void> mOwner;
 
    public:
     using ModuleType = CUmodule;
@@ -36,10 +40,19 @@ class Module : public common::ModuleInterface<CUmodule> {
     operator bool() const final { return get(); }
 
     void unload() final {
-        CU_CHECK(cuModuleUnload(get()));
+        // A shared module is unloaded by its owner when it is not used
+        if (mOwner) {
+            mOwner.reset();
+        } else {
+            CU_CHECK(cuModuleUnload(get()));
+        }
         set(nullptr);
     }
 
+    void setOwner(std::shared_ptr<void> owner) { mOwner = std::move(owner); }
+
+    const std::shared_ptr<void>& owner() const { return mOwner; }
+
     const std::string mangledName(const std::string& instantiation) const {
         auto iter = mInstanceMangledNames.find(instantiation);
         if (iter != mInstanceMangledNames.end()) {
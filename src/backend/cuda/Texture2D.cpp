@@ -0,0 +1,154 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Texture2D.hpp>
+
+#include <common/util.hpp>
+#include <err_cuda.hpp>
+#include <platform.hpp>
+
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+using std::lock_guard;
+using std::mutex;
+using std::pair;
+using std::vector;
+
+namespace cuda {
+
+namespace {
+
+/// The textures released while work which samples them may still be
+/// queued, with an event recorded after that work
+struct PendingTextures {
+    mutex lock;
+    vector<pair<cudaEvent_t, cudaTextureObject_t>> textures;
+};
+
+PendingTextures &pendingTextures() {
+    static PendingTextures *pending = new PendingTextures();
+    return *pending;
+}
+
+/// Destroys the pending textures whose events have completed. Must be
+/// called with the lock of \p pending held. Errors are ignored, since this
+/// runs in destructors.
+void destroyCompleted(PendingTextures &pending) {
+    auto &textures = pending.textures;
+    for (size_t i = 0; i < textures.size();) {
+        if (cudaEventQuery(textures[i].first) != cudaSuccess) {
+            ++i;
+            continue;
+        }
+        cudaDestroyTextureObject(textures[i].second);
+        cudaEventDestroy(textures[i].first);
+        textures[i] = textures.back();
+        textures.pop_back();
+    }
+}
+
+}  // namespace
+
+Texture2D::Texture2D(CParam<float> in, const bool linear) : mTexture(0) {
+    const cudaDeviceProp &prop = getDeviceProp(getActiveDeviceId());
+
+    // The images must be packed, so the rows of all of them are evenly
+    // spaced
+    const size_t pitch = in.strides[1] * sizeof(float);
+    const dim_t width  = in.dims[0];
+    const dim_t height = in.dims[1] * in.dims[2] * in.dims[3];
+    const auto address = reinterpret_cast<size_t>(in.ptr);
+    const bool packed  = in.strides[0] == 1 &&
+                        in.strides[2] == in.strides[1] * in.dims[1] &&
+                        in.strides[3] == in.strides[2] * in.dims[2];
+    const bool fits = width <= prop.maxTexture2DLinear[0] &&
+                      height <= prop.maxTexture2DLinear[1] &&
+                      pitch <= static_cast<size_t>(prop.maxTexture2DLinear[2]);
+    if (!packed || !fits || address % prop.textureAlignment != 0 ||
+        pitch % prop.texturePitchAlignment != 0) {
+        return;
+    }
+
+    cudaResourceDesc resDesc;
+    memset(&resDesc, 0, sizeof(resDesc));
+    resDesc.resType                  = cudaResourceTypePitch2D;
+    resDesc.res.pitch2D.devPtr       = const_cast<float *>(in.ptr);
+    resDesc.res.pitch2D.desc         = cudaCreateChannelDesc<float>();
+    resDesc.res.pitch2D.width        = width;
+    resDesc.res.pitch2D.height       = height;
+    resDesc.res.pitch2D.pitchInBytes = pitch;
+
+    cudaTextureDesc texDesc;
+    memset(&texDesc, 0, sizeof(texDesc));
+    texDesc.addressMode[0] = cudaAddressModeClamp;
+    texDesc.addressMode[1] = cudaAddressModeClamp;
+    texDesc.filterMode = linear ? cudaFilterModeLinear : cudaFilterModePoint;
+    texDesc.readMode   = cudaReadModeElementType;
+
+    PendingTextures &pending = pendingTextures();
+    {
+        lock_guard<mutex> guard(pending.lock);
+        destroyCompleted(pending);
+    }
+    CUDA_CHECK(cudaCreateTextureObject(&mTexture, &resDesc, &texDesc, NULL));
+}
+
+Texture2D::~Texture2D() {
+    if (mTexture == 0) { return; }
+
+    // Destructors must not throw, so the errors are not checked. The queued
+    // work is waited for if the event can not be recorded.
+    cudaStream_t stream = getActiveStream();
+    cudaEvent_t done    = 0;
+    if (cudaEventCreateWithFlags(&done, cudaEventDisableTiming) !=
+            cudaSuccess ||
+        cudaEventRecord(done, stream) != cudaSuccess) {
+        if (done) { cudaEventDestroy(done); }
+        cudaStreamSynchronize(stream);
+        cudaDestroyTextureObject(mTexture);
+        return;
+    }
+
+    PendingTextures &pending = pendingTextures();
+    lock_guard<mutex> guard(pending.lock);
+    pending.textures.emplace_back(done, mTexture);
+    destroyCompleted(pending);
+}
+
+bool useTextureInterp() {
+    static const bool useTexture = getEnvVar("AF_CUDA_TEXTURE_INTERP") == "1";
+    return useTexture;
+}
+
+template<>
+std::unique_ptr<Texture2D> interpTexture<float>(CParam<float> in,
+                                                const af::interpType method,
+                                                const int order) {
+    if (!useTextureInterp()) { return nullptr; }
+
+    bool linear = false;
+    if (order == 1 &&
+        (method == AF_INTERP_NEAREST || method == AF_INTERP_LOWER)) {
+        linear = false;
+    } else if (order == 2 &&
+               (method == AF_INTERP_LINEAR || method == AF_INTERP_BILINEAR)) {
+        linear = true;
+    } else {
+        return nullptr;
+    }
+
+    std::unique_ptr<Texture2D> texture(new Texture2D(in, linear));
+    if (texture->get() == 0) { return nullptr; }
+    return texture;
+}
+
+}  // namespace cuda
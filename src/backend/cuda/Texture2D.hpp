@@ -0,0 +1,74 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <af/defines.h>
+
+#include <cuda_runtime.h>
+#include <memory>
+
+namespace cuda {
+
+/// A 2D texture object over the images of a float array, which are stacked
+/// along the rows of the texture. Image i of the array starts at row
+/// i * dims[1] of the texture, and out of range coordinates are clamped.
+///
+/// The texture is only created when the rows of the array meet the
+/// alignment and size limits of pitched textures of the active device.
+/// Otherwise get() returns 0 and the callers use global memory loads.
+class Texture2D {
+   public:
+    Texture2D()                       = delete;
+    Texture2D(const Texture2D &)      = delete;
+    Texture2D(Texture2D &&)           = delete;
+    Texture2D &operator=(const Texture2D &) = delete;
+    Texture2D &operator=(Texture2D &&) = delete;
+
+    /// Creates a texture of \p in, with bilinear filtering if \p linear is
+    /// true, and point sampling otherwise
+    Texture2D(CParam<float> in, const bool linear);
+
+    /// The texture is destroyed once the work queued on the active stream
+    /// before the destructor has finished, so it can be released right
+    /// after the kernels which sample it are launched
+    ~Texture2D();
+
+    cudaTextureObject_t get() const noexcept { return mTexture; }
+
+   private:
+    cudaTextureObject_t mTexture;
+};
+
+/// The texture path of the interpolation kernels is used when
+/// AF_CUDA_TEXTURE_INTERP is 1
+bool useTextureInterp();
+
+/// Returns the texture which the 2D interpolation kernels sample \p in from
+/// with \p method of \p order, or nullptr if they read global memory.
+///
+/// Textures are used for float images when useTextureInterp() is true, with
+/// point sampling for the nearest and lower methods and with the bilinear
+/// filtering of the hardware for the linear and bilinear methods. Point
+/// sampling returns the same values as the loads from global memory, but the
+/// weights of hardware filtering only have 8 fractional bits.
+template<typename T>
+std::unique_ptr<Texture2D> interpTexture(CParam<T> in,
+                                         const af::interpType method,
+                                         const int order) {
+    return nullptr;
+}
+
+template<>
+std::unique_ptr<Texture2D> interpTexture<float>(CParam<float> in,
+                                                const af::interpType method,
+                                                const int order);
+
+}  // namespace cuda
@@ -14,17 +14,27 @@
 
 namespace cuda {
 template<typename T>
-void anisotropicDiffusion(Array<T>& inout, const float dt, const float mct,
+void anisotropicDiffusion(Array<T>& inout, const float dt, const float K,
+                          const unsigned iterations,
                           const af::fluxFunction fftype,
                           const af::diffusionEq eq) {
-    kernel::anisotropicDiffusion<T>(inout, dt, mct, fftype,
-                                    eq == AF_DIFFUSION_MCDE);
+    // The conductance of a step is exp(gradient * mct) with
+    // mct = -elements / (2 K^2 energy)
+    const float mctScale =
+        -static_cast<float>(inout.elements()) / (2.0f * K * K);
+
+    Array<T> tmp = createEmptyArray<T>(inout.dims());
+    if (kernel::anisotropicDiffusion<T>(inout, tmp, dt, mctScale, iterations,
+                                        fftype, eq == AF_DIFFUSION_MCDE)) {
+        inout = tmp;
+    }
 }
 
-#define INSTANTIATE(T)                                     \
-    template void anisotropicDiffusion<T>(                 \
-        Array<T> & inout, const float dt, const float mct, \
-        const af::fluxFunction fftype, const af::diffusionEq eq);
+#define INSTANTIATE(T)                                            \
+    template void anisotropicDiffusion<T>(                        \
+        Array<T> & inout, const float dt, const float K,          \
+        const unsigned iterations, const af::fluxFunction fftype, \
+        const af::diffusionEq eq);
 
 INSTANTIATE(double)
 INSTANTIATE(float)
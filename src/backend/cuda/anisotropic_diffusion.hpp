@@ -11,7 +11,11 @@
 
 namespace cuda {
 template<typename T>
-void anisotropicDiffusion(Array<T>& inout, const float dt, const float mct,
+/// Diffuses \p inout for \p iterations timesteps of length \p dt. The
+/// conductance of a step is scaled by \p K and by the gradient energy of the
+/// input of the step.
+void anisotropicDiffusion(Array<T>& inout, const float dt, const float K,
+                          const unsigned iterations,
                           const af::fluxFunction fftype,
                           const af::diffusionEq eq);
 }
@@ -11,15 +11,20 @@
 
 #include <arith.hpp>
 #include <cast.hpp>
+#include <common/bfloat16.hpp>
+#include <common/defines.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <complex.hpp>
 #include <copy.hpp>
 #include <cublas.hpp>
 #include <cublas_v2.h>
+#include <cuda.h>
 #include <cudaDataType.hpp>
 #include <cuda_runtime.h>
 #include <err_cuda.hpp>
+#include <kernel/gemm_epilogue.hpp>
+#include <kernel/gemm_quantized.hpp>
 #include <math.hpp>
 #include <platform.hpp>
 #include <reduce.hpp>
@@ -33,6 +38,16 @@
 #include <string>
 #include <vector>
 
+#if CUDA_VERSION >= 11000
+#include <cublasLt.h>
+
+DEFINE_HANDLER(cublasLtMatmulDesc_t, cublasLtMatmulDescCreate,
+               cublasLtMatmulDescDestroy);
+DEFINE_HANDLER(cublasLtMatrixLayout_t, cublasLtMatrixLayoutCreate,
+               cublasLtMatrixLayoutDestroy);
+#endif
+
+using common::bfloat16;
 using common::half;
 using common::kernel_type;
 using std::is_same;
@@ -61,6 +76,12 @@ using gemmBatched_func_def = std::function<cublasStatus_t(
     cublasHandle_t, cublasOperation_t, cublasOperation_t, int, int, int,
     const T *, const T **, int, const T **, int, const T *, T **, int, int)>;
 
+template<typename T>
+using gemmStridedBatched_func_def = std::function<cublasStatus_t(
+    cublasHandle_t, cublasOperation_t, cublasOperation_t, int, int, int,
+    const T *, const T *, int, long long, const T *, int, long long,
+    const T *, T *, int, long long, int)>;
+
 template<typename T>
 using trsm_func_def = std::function<cublasStatus_t(
     cublasHandle_t, cublasSideMode_t, cublasFillMode_t, cublasOperation_t,
@@ -90,6 +111,13 @@ BLAS_FUNC(gemmBatched, double, D)
 BLAS_FUNC(gemmBatched, cdouble, Z)
 BLAS_FUNC(gemmBatched, __half, H)
 
+BLAS_FUNC_DEF(gemmStridedBatched)
+BLAS_FUNC(gemmStridedBatched, float, S)
+BLAS_FUNC(gemmStridedBatched, cfloat, C)
+BLAS_FUNC(gemmStridedBatched, double, D)
+BLAS_FUNC(gemmStridedBatched, cdouble, Z)
+BLAS_FUNC(gemmStridedBatched, __half, H)
+
 BLAS_FUNC_DEF(trsm)
 BLAS_FUNC(trsm, float, S)
 BLAS_FUNC(trsm, cfloat, C)
@@ -149,7 +177,7 @@ cublasGemmAlgo_t selectGEMMAlgorithm() {
 
 template<>
 cublasGemmAlgo_t selectGEMMAlgorithm<common::half>() {
-    auto dev              = getDeviceProp(getActiveDeviceId());
+    const auto &dev       = getDeviceProp(getActiveDeviceId());
     cublasGemmAlgo_t algo = CUBLAS_GEMM_DEFAULT;
     if (dev.major >= 7) { algo = CUBLAS_GEMM_DEFAULT_TENSOR_OP; }
     return algo;
@@ -160,155 +188,409 @@ cublasGemmAlgo_t selectGEMMAlgorithm<__half>() {
     return selectGEMMAlgorithm<common::half>();
 }
 
+// Returns true if the matrices an operand contributes to the batch of oDims
+// are evenly spaced in memory, which lets the strided batched GEMM skip the
+// arrays of pointers. The stride of a broadcast operand is 0.
+bool batchStride(long long &stride, const dim4 &dims, const dim4 &strides,
+                 const dim4 &oDims) {
+    const bool d2 = oDims[2] > 1 && dims[2] == oDims[2];
+    const bool d3 = oDims[3] > 1 && dims[3] == oDims[3];
+    if (d2 && d3) {
+        stride = strides[2];
+        return strides[3] == strides[2] * dims[2];
+    } else if (d2) {
+        stride = strides[2];
+        return oDims[3] == 1;
+    } else if (d3) {
+        stride = strides[3];
+        return oDims[2] == 1;
+    }
+    stride = 0;
+    return true;
+}
+
+/// Returns the device array of the pointers to the matrices an operand
+/// contributes to the batch of oDims. A broadcast operand repeats its matrix.
 template<typename T>
-cublasStatus_t gemmDispatch(BlasHandle handle, cublasOperation_t lOpts,
-                            cublasOperation_t rOpts, int M, int N, int K,
-                            const T *alpha, const Array<T> &lhs, dim_t lStride,
-                            const Array<T> &rhs, dim_t rStride, const T *beta,
-                            Array<T> &out, dim_t oleading) {
-    auto prop = getDeviceProp(getActiveDeviceId());
+uptr<uchar> batchPointers(const Array<T> &in, const dim4 &oDims) {
+    const dim4 dims    = in.dims();
+    const dim4 strides = in.strides();
+    const bool d2      = oDims[2] == dims[2];
+    const bool d3      = oDims[3] == dims[3];
+
+    T *ptr = const_cast<T *>(in.get());
+    vector<T *> ptrs(oDims[2] * oDims[3]);
+    for (dim_t w = 0; w < oDims[3]; w++) {
+        for (dim_t z = 0; z < oDims[2]; z++) {
+            ptrs[w * oDims[2] + z] =
+                ptr + z * (d2 * strides[2]) + w * (d3 * strides[3]);
+        }
+    }
+
+    size_t bytes = ptrs.size() * sizeof(T *);
+    auto d_ptrs  = memAlloc<uchar>(bytes);
+    CUDA_CHECK(cudaMemcpyAsync(d_ptrs.get(), ptrs.data(), bytes,
+                               cudaMemcpyHostToDevice, getActiveStream()));
+    // The host pointers are freed when this function returns
+    CUDA_CHECK(cudaStreamSynchronize(getActiveStream()));
+    return d_ptrs;
+}
+
+/// The dimensions of a GEMM and the batch strides of its operands
+struct GemmShape {
+    int M, N, K;
+    bool strided;
+    long long lBatchStride, rBatchStride, oBatchStride;
+};
+
+template<typename Ti, typename To>
+GemmShape gemmShape(cublasOperation_t lOpts, cublasOperation_t rOpts,
+                    const Array<Ti> &lhs, const Array<Ti> &rhs,
+                    const Array<To> &out) {
+    const int aRowDim = (lOpts == CUBLAS_OP_N) ? 0 : 1;
+    const int aColDim = (lOpts == CUBLAS_OP_N) ? 1 : 0;
+    const int bColDim = (rOpts == CUBLAS_OP_N) ? 1 : 0;
+
+    const dim4 oDims = out.dims();
+    GemmShape shape;
+    shape.M       = lhs.dims()[aRowDim];
+    shape.N       = rhs.dims()[bColDim];
+    shape.K       = lhs.dims()[aColDim];
+    shape.strided = batchStride(shape.lBatchStride, lhs.dims(),
+                                lhs.strides(), oDims) &&
+                    batchStride(shape.rBatchStride, rhs.dims(),
+                                rhs.strides(), oDims) &&
+                    batchStride(shape.oBatchStride, oDims, out.strides(),
+                                oDims);
+    return shape;
+}
+
 #if __CUDACC_VER_MAJOR__ >= 10
-    if (prop.major > 3 && __CUDACC_VER_MAJOR__ >= 10) {
-        return cublasGemmEx(
-            blasHandle(), lOpts, rOpts, M, N, K, alpha, lhs.get(), getType<T>(),
-            lStride, rhs.get(), getType<T>(), rStride, beta, out.get(),
-            getType<T>(), out.strides()[1],
-            getComputeType<T>(),  // Compute type
-
-            // NOTE: When using the CUBLAS_GEMM_DEFAULT_TENSOR_OP algorithm
-            // for the cublasGemm*Ex functions, the performance of the
-            // fp32 numbers seem to increase dramatically. Their numerical
-            // accuracy is also different compared to regular gemm fuctions.
-            // The CUBLAS_GEMM_DEFAULT algorithm selection does not experience
-            // this change. Does this imply that the TENSOR_OP function
-            // performs the computation in fp16 bit even when the compute
-            // type is CUDA_R_32F?
-            selectGEMMAlgorithm<T>());
-    } else {
+/// Calls the cublasGemm*Ex function for the layout of the batch. The inputs
+/// and the output can have different types, and alpha and beta have the type
+/// the compute type scales with.
+template<typename Ti, typename To, typename ComputeType>
+cublasStatus_t gemmEx(Array<To> &out, cublasOperation_t lOpts,
+                      cublasOperation_t rOpts, const void *alpha,
+                      const Array<Ti> &lhs, const Array<Ti> &rhs,
+                      const void *beta, ComputeType computeType,
+                      cublasGemmAlgo_t algo) {
+    const GemmShape s = gemmShape(lOpts, rOpts, lhs, rhs, out);
+    const dim4 oDims  = out.dims();
+    const int lStride = lhs.strides()[1];
+    const int rStride = rhs.strides()[1];
+    const int oStride = out.strides()[1];
+
+    if (oDims.ndims() <= 2) {
+        return cublasGemmEx(blasHandle(), lOpts, rOpts, s.M, s.N, s.K, alpha,
+                            lhs.get(), getType<Ti>(), lStride, rhs.get(),
+                            getType<Ti>(), rStride, beta, out.get(),
+                            getType<To>(), oStride, computeType, algo);
+    } else if (s.strided) {
+        return cublasGemmStridedBatchedEx(
+            blasHandle(), lOpts, rOpts, s.M, s.N, s.K, alpha, lhs.get(),
+            getType<Ti>(), lStride, s.lBatchStride, rhs.get(), getType<Ti>(),
+            rStride, s.rBatchStride, beta, out.get(), getType<To>(), oStride,
+            s.oBatchStride, oDims[2] * oDims[3], computeType, algo);
+    }
+    auto d_lptrs = batchPointers(lhs, oDims);
+    auto d_rptrs = batchPointers(rhs, oDims);
+    auto d_optrs = batchPointers(out, oDims);
+    return cublasGemmBatchedEx(
+        blasHandle(), lOpts, rOpts, s.M, s.N, s.K, alpha,
+        (const void **)d_lptrs.get(), getType<Ti>(), lStride,
+        (const void **)d_rptrs.get(), getType<Ti>(), rStride, beta,
+        (void **)d_optrs.get(), getType<To>(), oStride, oDims[2] * oDims[3],
+        computeType, algo);
+}
 #endif
-        using Nt = typename common::kernel_type<T>::native;
-        return gemm_func<Nt>()(blasHandle(), lOpts, rOpts, M, N, K, (Nt *)alpha,
-                               (Nt *)lhs.get(), lStride, (Nt *)rhs.get(),
-                               rStride, (Nt *)beta, (Nt *)out.get(), oleading);
+
+template<typename T>
+void gemm(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs, const T *alpha,
+          const Array<T> &lhs, const Array<T> &rhs, const T *beta) {
+    const cublasOperation_t lOpts = toCblasTranspose(optLhs);
+    const cublasOperation_t rOpts = toCblasTranspose(optRhs);
 
 #if __CUDACC_VER_MAJOR__ >= 10
+    if (getDeviceProp(getActiveDeviceId()).major > 3) {
+        // NOTE: When using the CUBLAS_GEMM_DEFAULT_TENSOR_OP algorithm
+        // for the cublasGemm*Ex functions, the performance of the
+        // fp32 numbers seem to increase dramatically. Their numerical
+        // accuracy is also different compared to regular gemm fuctions.
+        // The CUBLAS_GEMM_DEFAULT algorithm selection does not experience
+        // this change. Does this imply that the TENSOR_OP function
+        // performs the computation in fp16 bit even when the compute
+        // type is CUDA_R_32F?
+        CUBLAS_CHECK(gemmEx(out, lOpts, rOpts, alpha, lhs, rhs, beta,
+                            getComputeType<T>(), selectGEMMAlgorithm<T>()));
+        return;
     }
 #endif
+
+    using Nt          = typename common::kernel_type<T>::native;
+    const GemmShape s = gemmShape(lOpts, rOpts, lhs, rhs, out);
+    const dim4 oDims  = out.dims();
+    const int lStride = lhs.strides()[1];
+    const int rStride = rhs.strides()[1];
+    const int oStride = out.strides()[1];
+
+    if (oDims.ndims() <= 2) {
+        CUBLAS_CHECK(gemm_func<Nt>()(
+            blasHandle(), lOpts, rOpts, s.M, s.N, s.K, (const Nt *)alpha,
+            (const Nt *)lhs.get(), lStride, (const Nt *)rhs.get(), rStride,
+            (const Nt *)beta, (Nt *)out.get(), oStride));
+    } else if (s.strided) {
+        CUBLAS_CHECK(gemmStridedBatched_func<Nt>()(
+            blasHandle(), lOpts, rOpts, s.M, s.N, s.K, (const Nt *)alpha,
+            (const Nt *)lhs.get(), lStride, s.lBatchStride,
+            (const Nt *)rhs.get(), rStride, s.rBatchStride, (const Nt *)beta,
+            (Nt *)out.get(), oStride, s.oBatchStride, oDims[2] * oDims[3]));
+    } else {
+        auto d_lptrs = batchPointers(lhs, oDims);
+        auto d_rptrs = batchPointers(rhs, oDims);
+        auto d_optrs = batchPointers(out, oDims);
+        CUBLAS_CHECK(gemmBatched_func<Nt>()(
+            blasHandle(), lOpts, rOpts, s.M, s.N, s.K, (const Nt *)alpha,
+            (const Nt **)d_lptrs.get(), lStride, (const Nt **)d_rptrs.get(),
+            rStride, (const Nt *)beta, (Nt **)d_optrs.get(), oStride,
+            oDims[2] * oDims[3]));
+    }
 }
 
-template<typename T>
-cublasStatus_t gemmBatchedDispatch(BlasHandle handle, cublasOperation_t lOpts,
-                                   cublasOperation_t rOpts, int M, int N, int K,
-                                   const T *alpha, const T **lptrs,
-                                   int lStrides, const T **rptrs, int rStrides,
-                                   const T *beta, T **optrs, int oStrides,
-                                   int batchSize) {
-    auto prop = getDeviceProp(getActiveDeviceId());
 #if __CUDACC_VER_MAJOR__ >= 10
-    if (prop.major > 3) {
-        return cublasGemmBatchedEx(
-            blasHandle(), lOpts, rOpts, M, N, K, alpha, (const void **)lptrs,
-            getType<T>(), lStrides, (const void **)rptrs, getType<T>(),
-            rStrides, beta, (void **)optrs, getType<T>(), oStrides, batchSize,
-            getComputeType<T>(),  // compute type
-            // NOTE: When using the CUBLAS_GEMM_DEFAULT_TENSOR_OP algorithm
-            // for the cublasGemm*Ex functions, the performance of the
-            // fp32 numbers seem to increase dramatically. Their numerical
-            // accuracy is also different compared to regular gemm fuctions.
-            // The CUBLAS_GEMM_DEFAULT algorithm selection does not experience
-            // this change. Does this imply that the TENSOR_OP function
-            // performs the computation in fp16 bit even when the compute
-            // type is CUDA_R_32F?
-            selectGEMMAlgorithm<T>());
-    } else {
+/// Multiplies the f16 inputs on the tensor cores, which accumulate the
+/// products in f32. Returns false when the device has no such tensor cores.
+template<typename Ti, typename To>
+bool gemmTensorF32(Array<To> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+                   const float *alpha, const Array<Ti> &lhs,
+                   const Array<Ti> &rhs, const float *beta) {
+    // The tensor cores of Volta and newer accumulate in f32. Older devices do
+    // not compute f32 from f16 inputs reliably, see getComputeType.
+    if (getDeviceProp(getActiveDeviceId()).major < 7) { return false; }
+    CUBLAS_CHECK(gemmEx(out, toCblasTranspose(optLhs),
+                        toCblasTranspose(optRhs), alpha, lhs, rhs, beta,
+                        CUDA_R_32F, CUBLAS_GEMM_DEFAULT_TENSOR_OP));
+    return true;
+}
+
+#if CUDA_VERSION >= 11000
+/// The bf16 inputs are multiplied by the tensor cores of Ampere and newer
+template<typename To>
+bool gemmTensorF32(Array<To> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+                   const float *alpha, const Array<bfloat16> &lhs,
+                   const Array<bfloat16> &rhs, const float *beta) {
+    if (getDeviceProp(getActiveDeviceId()).major < 8) { return false; }
+    CUBLAS_CHECK(gemmEx(out, toCblasTranspose(optLhs),
+                        toCblasTranspose(optRhs), alpha, lhs, rhs, beta,
+                        CUDA_R_32F, CUBLAS_GEMM_DEFAULT_TENSOR_OP));
+    return true;
+}
+#else
+/// cuBLAS has no bf16 inputs before CUDA 11
+template<typename To>
+bool gemmTensorF32(Array<To> &, af_mat_prop, af_mat_prop, const float *,
+                   const Array<bfloat16> &, const Array<bfloat16> &,
+                   const float *) {
+    return false;
+}
+#endif
 #endif
-        using Nt = typename common::kernel_type<T>::native;
-        return gemmBatched_func<Nt>()(
-            blasHandle(), lOpts, rOpts, M, N, K, (const Nt *)alpha,
-            (const Nt **)lptrs, lStrides, (const Nt **)rptrs, rStrides,
-            (const Nt *)beta, (Nt **)optrs, oStrides, batchSize);
+
+/// Multiplies the f16 or bf16 inputs and accumulates the products in f32
+template<typename Ti, typename To>
+void gemmF32(Array<To> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+             const To *alpha, const Array<Ti> &lhs, const Array<Ti> &rhs,
+             const To *beta) {
+    const float alphaF = static_cast<float>(*alpha);
+    const float betaF  = static_cast<float>(*beta);
 #if __CUDACC_VER_MAJOR__ >= 10
+    if (gemmTensorF32(out, optLhs, optRhs, &alphaF, lhs, rhs, &betaF)) {
+        return;
     }
 #endif
+    // The other devices multiply the inputs converted to f32
+    Array<float> outF = createEmptyArray<float>(out.dims());
+    if (betaF != 0.f) { copyArray(outF, cast<float>(out)); }
+    gemm<float>(outF, optLhs, optRhs, &alphaF, cast<float>(lhs),
+                cast<float>(rhs), &betaF);
+    copyArray(out, cast<To>(outF));
 }
 
+template<typename Ti, typename To>
+void gemmMixed(Array<To> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+               const To *alpha, const Array<Ti> &lhs, const Array<Ti> &rhs,
+               const To *beta, af_gemm_compute_type compute) {
+#if CUDA_VERSION >= 11000
+    // TF32 rounds the f32 inputs to 10 bits of mantissa on the tensor cores
+    // of Ampere and newer
+    if (compute == AF_GEMM_COMPUTE_TF32 &&
+        (is_same<To, float>::value || is_same<To, cfloat>::value) &&
+        getDeviceProp(getActiveDeviceId()).major >= 8) {
+        CUBLAS_CHECK(gemmEx(out, toCblasTranspose(optLhs),
+                            toCblasTranspose(optRhs), alpha, lhs, rhs, beta,
+                            CUBLAS_COMPUTE_32F_FAST_TF32,
+                            CUBLAS_GEMM_DEFAULT_TENSOR_OP));
+        return;
+    }
+#endif
+    UNUSED(compute);
+    gemm<To>(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+}
+
+template<>
+void gemmMixed<half, half>(Array<half> &out, af_mat_prop optLhs,
+                           af_mat_prop optRhs, const half *alpha,
+                           const Array<half> &lhs, const Array<half> &rhs,
+                           const half *beta, af_gemm_compute_type compute) {
+    if (compute == AF_GEMM_COMPUTE_DEFAULT) {
+        gemm<half>(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+    } else {
+        gemmF32(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+    }
+}
+
+template<>
+void gemmMixed<half, float>(Array<float> &out, af_mat_prop optLhs,
+                            af_mat_prop optRhs, const float *alpha,
+                            const Array<half> &lhs, const Array<half> &rhs,
+                            const float *beta, af_gemm_compute_type) {
+    gemmF32(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+}
+
+template<>
+void gemmMixed<bfloat16, bfloat16>(Array<bfloat16> &out, af_mat_prop optLhs,
+                                   af_mat_prop optRhs, const bfloat16 *alpha,
+                                   const Array<bfloat16> &lhs,
+                                   const Array<bfloat16> &rhs,
+                                   const bfloat16 *beta, af_gemm_compute_type) {
+    gemmF32(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+}
+
+template<>
+void gemmMixed<bfloat16, float>(Array<float> &out, af_mat_prop optLhs,
+                                af_mat_prop optRhs, const float *alpha,
+                                const Array<bfloat16> &lhs,
+                                const Array<bfloat16> &rhs, const float *beta,
+                                af_gemm_compute_type) {
+    gemmF32(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+}
+
+/// cuBLAS has no bf16 GEMM with a bf16 compute type, so the products are
+/// always accumulated in f32
+template<>
+void gemm<bfloat16>(Array<bfloat16> &out, af_mat_prop optLhs,
+                    af_mat_prop optRhs, const bfloat16 *alpha,
+                    const Array<bfloat16> &lhs, const Array<bfloat16> &rhs,
+                    const bfloat16 *beta) {
+    gemmF32(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+}
+
+#if CUDA_VERSION >= 11000
+// Only the f32 and f16 epilogues are fused by cuBLASLt
 template<typename T>
-void gemm(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs, const T *alpha,
-          const Array<T> &lhs, const Array<T> &rhs, const T *beta) {
-    const cublasOperation_t lOpts = toCblasTranspose(optLhs);
-    const cublasOperation_t rOpts = toCblasTranspose(optRhs);
+cublasComputeType_t ltComputeType() {
+    return CUBLAS_COMPUTE_32F;
+}
 
-    const int aRowDim = (lOpts == CUBLAS_OP_N) ? 0 : 1;
-    const int aColDim = (lOpts == CUBLAS_OP_N) ? 1 : 0;
-    const int bColDim = (rOpts == CUBLAS_OP_N) ? 1 : 0;
+template<>
+cublasComputeType_t ltComputeType<half>() {
+    return CUBLAS_COMPUTE_16F;
+}
 
+/// Computes the GEMM, the bias and the activation with one cuBLASLt call.
+/// Returns false without launching anything if cuBLASLt has no epilogue for
+/// the arguments.
+template<typename T>
+bool gemmEpilogueLt(Array<T> &out, cublasOperation_t lOpts,
+                    cublasOperation_t rOpts, const T *alpha,
+                    const Array<T> &lhs, const Array<T> &rhs, const T *beta,
+                    const Array<T> &bias, af_gemm_epilogue epilogue) {
+    if (!(is_same<T, float>::value || is_same<T, half>::value)) {
+        return false;
+    }
     const dim4 lDims = lhs.dims();
     const dim4 rDims = rhs.dims();
-    const int M      = lDims[aRowDim];
-    const int N      = rDims[bColDim];
-    const int K      = lDims[aColDim];
     const dim4 oDims = out.dims();
+    if (oDims.ndims() > 2 || (bias.elements() > 0 && !bias.isLinear())) {
+        return false;
+    }
 
-    dim4 lStrides = lhs.strides();
-    dim4 rStrides = rhs.strides();
-    dim4 oStrides = out.strides();
+    const bool hasBias    = bias.elements() > 0;
+    cublasLtEpilogue_t ep = CUBLASLT_EPILOGUE_DEFAULT;
+    switch (epilogue) {
+        case AF_GEMM_EPILOGUE_NONE:
+            ep = hasBias ? CUBLASLT_EPILOGUE_BIAS : CUBLASLT_EPILOGUE_DEFAULT;
+            break;
+        case AF_GEMM_EPILOGUE_RELU:
+            ep = hasBias ? CUBLASLT_EPILOGUE_RELU_BIAS : CUBLASLT_EPILOGUE_RELU;
+            break;
+        case AF_GEMM_EPILOGUE_GELU:
+#if CUDA_VERSION >= 11030
+            ep = hasBias ? CUBLASLT_EPILOGUE_GELU_BIAS : CUBLASLT_EPILOGUE_GELU;
+            break;
+#else
+            return false;
+#endif
+    }
 
-    if (oDims.ndims() <= 2) {
-        CUBLAS_CHECK(gemmDispatch<T>(blasHandle(), lOpts, rOpts, M, N, K, alpha,
-                                     lhs, lStrides[1], rhs, rStrides[1], beta,
-                                     out, oStrides[1]));
-    } else {
-        int batchSize = oDims[2] * oDims[3];
-        vector<const T *> lptrs(batchSize);
-        vector<const T *> rptrs(batchSize);
-        vector<T *> optrs(batchSize);
-
-        bool is_l_d2_batched = oDims[2] == lDims[2];
-        bool is_l_d3_batched = oDims[3] == lDims[3];
-
-        bool is_r_d2_batched = oDims[2] == rDims[2];
-        bool is_r_d3_batched = oDims[3] == rDims[3];
-
-        const T *lptr = lhs.get();
-        const T *rptr = rhs.get();
-        T *optr       = out.get();
-
-        for (int n = 0; n < batchSize; n++) {
-            int w    = n / oDims[2];
-            int z    = n - w * oDims[2];
-            int loff = z * (is_l_d2_batched * lStrides[2]) +
-                       w * (is_l_d3_batched * lStrides[3]);
-            int roff = z * (is_r_d2_batched * rStrides[2]) +
-                       w * (is_r_d3_batched * rStrides[3]);
-            lptrs[n] = lptr + loff;
-            rptrs[n] = rptr + roff;
-            optrs[n] = optr + z * oStrides[2] + w * oStrides[3];
-        }
+    auto desc = common::make_handle<cublasLtMatmulDesc_t>(ltComputeType<T>(),
+                                                          getType<T>());
+    auto aLayout = common::make_handle<cublasLtMatrixLayout_t>(
+        getType<T>(), lDims[0], lDims[1], lhs.strides()[1]);
+    auto bLayout = common::make_handle<cublasLtMatrixLayout_t>(
+        getType<T>(), rDims[0], rDims[1], rhs.strides()[1]);
+    auto cLayout = common::make_handle<cublasLtMatrixLayout_t>(
+        getType<T>(), oDims[0], oDims[1], out.strides()[1]);
+    if (!desc || !aLayout || !bLayout || !cLayout) { return false; }
+
+    CUBLAS_CHECK(cublasLtMatmulDescSetAttribute(
+        desc, CUBLASLT_MATMUL_DESC_TRANSA, &lOpts, sizeof(lOpts)));
+    CUBLAS_CHECK(cublasLtMatmulDescSetAttribute(
+        desc, CUBLASLT_MATMUL_DESC_TRANSB, &rOpts, sizeof(rOpts)));
+    CUBLAS_CHECK(cublasLtMatmulDescSetAttribute(
+        desc, CUBLASLT_MATMUL_DESC_EPILOGUE, &ep, sizeof(ep)));
+    if (hasBias) {
+        const T *bptr = bias.get();
+        CUBLAS_CHECK(cublasLtMatmulDescSetAttribute(
+            desc, CUBLASLT_MATMUL_DESC_BIAS_POINTER, &bptr, sizeof(bptr)));
+    }
+
+    // A cublasHandle_t can be used as a cublasLtHandle_t. Without a
+    // workspace, cuBLASLt picks a heuristic which does not need one.
+    CUBLAS_CHECK(cublasLtMatmul(
+        reinterpret_cast<cublasLtHandle_t>(blasHandle()), desc, alpha,
+        lhs.get(), aLayout, rhs.get(), bLayout, beta, out.get(), cLayout,
+        out.get(), cLayout, nullptr, nullptr, 0, getActiveStream()));
+    return true;
+}
+#endif
 
-        size_t bytes = batchSize * sizeof(T **);
-        auto d_lptrs = memAlloc<uchar>(bytes);
-        auto d_rptrs = memAlloc<uchar>(bytes);
-        auto d_optrs = memAlloc<uchar>(bytes);
-        CUDA_CHECK(cudaMemcpyAsync(d_lptrs.get(), lptrs.data(), bytes,
-                                   cudaMemcpyHostToDevice, getActiveStream()));
-        CUDA_CHECK(cudaMemcpyAsync(d_rptrs.get(), rptrs.data(), bytes,
-                                   cudaMemcpyHostToDevice, getActiveStream()));
-        CUDA_CHECK(cudaMemcpyAsync(d_optrs.get(), optrs.data(), bytes,
-                                   cudaMemcpyHostToDevice, getActiveStream()));
-
-        // Call this before the gemm call so that you don't have to wait for the
-        // computation. Even though it would make more sense to put it
-        // afterwards
-        CUDA_CHECK(cudaStreamSynchronize(getActiveStream()));
-
-        using Nt = typename common::kernel_type<T>::native;
-        CUBLAS_CHECK(gemmBatchedDispatch(
-            blasHandle(), lOpts, rOpts, M, N, K, alpha,
-            (const T **)d_lptrs.get(), lStrides[1], (const T **)d_rptrs.get(),
-            rStrides[1], beta, (T **)d_optrs.get(), oStrides[1], batchSize));
+template<typename T>
+void gemmEpilogue(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+                  const T *alpha, const Array<T> &lhs, const Array<T> &rhs,
+                  const T *beta, const Array<T> &bias,
+                  af_gemm_epilogue epilogue) {
+#if CUDA_VERSION >= 11000
+    if (gemmEpilogueLt<T>(out, toCblasTranspose(optLhs),
+                          toCblasTranspose(optRhs), alpha, lhs, rhs, beta, bias,
+                          epilogue)) {
+        return;
+    }
+#endif
+    gemm<T>(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+    if (bias.elements() > 0 || epilogue != AF_GEMM_EPILOGUE_NONE) {
+        kernel::gemmEpilogue<T>(out, bias, epilogue);
     }
 }
 
+// The int8 GEMM of cublasGemmEx multiplies signed values without zero
+// points, so the u8 products with zero points use a kernel of their own
+void gemmQuantized(Array<int> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+                   const Array<uchar> &lhs, const int lhsZero,
+                   const Array<uchar> &rhs, const int rhsZero) {
+    kernel::gemmQuantized(out, lhs, rhs, optLhs, optRhs, lhsZero, rhsZero);
+}
+
 template<typename T>
 Array<T> dot(const Array<T> &lhs, const Array<T> &rhs, af_mat_prop optLhs,
              af_mat_prop optRhs) {
@@ -351,6 +633,29 @@ INSTANTIATE_GEMM(double)
 INSTANTIATE_GEMM(cdouble)
 INSTANTIATE_GEMM(half)
 
+#define INSTANTIATE_GEMM_EPILOGUE(TYPE)                                   \
+    template void gemmEpilogue<TYPE>(                                     \
+        Array<TYPE> & out, af_mat_prop optLhs, af_mat_prop optRhs,        \
+        const TYPE *alpha, const Array<TYPE> &lhs, const Array<TYPE> &rhs, \
+        const TYPE *beta, const Array<TYPE> &bias, af_gemm_epilogue epilogue);
+
+INSTANTIATE_GEMM_EPILOGUE(float)
+INSTANTIATE_GEMM_EPILOGUE(cfloat)
+INSTANTIATE_GEMM_EPILOGUE(double)
+INSTANTIATE_GEMM_EPILOGUE(cdouble)
+INSTANTIATE_GEMM_EPILOGUE(half)
+
+#define INSTANTIATE_GEMM_MIXED(TI, TO)                               \
+    template void gemmMixed<TI, TO>(                                 \
+        Array<TO> & out, af_mat_prop optLhs, af_mat_prop optRhs,     \
+        const TO *alpha, const Array<TI> &lhs, const Array<TI> &rhs, \
+        const TO *beta, af_gemm_compute_type compute);
+
+INSTANTIATE_GEMM_MIXED(float, float)
+INSTANTIATE_GEMM_MIXED(cfloat, cfloat)
+INSTANTIATE_GEMM_MIXED(double, double)
+INSTANTIATE_GEMM_MIXED(cdouble, cdouble)
+
 #define INSTANTIATE_DOT(TYPE)                                                  \
     template Array<TYPE> dot<TYPE>(const Array<TYPE> &lhs,                     \
                                    const Array<TYPE> &rhs, af_mat_prop optLhs, \
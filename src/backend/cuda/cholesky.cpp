@@ -12,12 +12,17 @@
 
 #include <copy.hpp>
 #include <cublas_v2.h>
+#include <cuda.h>
 #include <cusolverDn.hpp>
+#include <err_cuda.hpp>
 #include <identity.hpp>
+#include <matrix_pointers.hpp>
 #include <memory.hpp>
 #include <platform.hpp>
 #include <triangle.hpp>
 
+#include <vector>
+
 #include <common/err_common.hpp>
 #include <math.hpp>
 
@@ -80,6 +85,83 @@ CH_FUNC(potrf, double, D)
 CH_FUNC(potrf, cfloat, C)
 CH_FUNC(potrf, cdouble, Z)
 
+#if CUDA_VERSION >= 9010
+// cusolverStatus_t cusolverDn<>potrfBatched(
+//        cusolverDnHandle_t handle,
+//        cublasFillMode_t uplo,
+//        int n,
+//        <> *Aarray[],
+//        int lda,
+//        int *infoArray,
+//        int batchSize);
+
+template<typename T>
+struct potrfBatched_func_def_t {
+    using potrfBatched_func_def = cusolverStatus_t (*)(cusolverDnHandle_t,
+                                                       cublasFillMode_t, int,
+                                                       T **, int, int *, int);
+};
+
+template<typename T>
+typename potrfBatched_func_def_t<T>::potrfBatched_func_def
+potrfBatched_func();
+
+#define CH_BATCHED_FUNC(FUNC, TYPE, PREFIX)                                 \
+    template<>                                                              \
+    typename FUNC##_func_def_t<TYPE>::FUNC##_func_def FUNC##_func<TYPE>() { \
+        return (FUNC##_func_def_t<TYPE>::FUNC##_func_def) &                 \
+               cusolverDn##PREFIX##FUNC;                                    \
+    }
+
+CH_BATCHED_FUNC(potrfBatched, float, S)
+CH_BATCHED_FUNC(potrfBatched, double, D)
+CH_BATCHED_FUNC(potrfBatched, cfloat, C)
+CH_BATCHED_FUNC(potrfBatched, cdouble, Z)
+#endif
+
+/// Factorizes the matrices of a batch and returns the info of its first
+/// matrix which is not positive definite
+template<typename T>
+int choleskyBatched(Array<T> &in, cublasFillMode_t uplo) {
+    dim4 iDims = in.dims();
+    int N      = iDims[0];
+    int batch  = iDims[2] * iDims[3];
+
+    auto d_info = memAlloc<int>(batch);
+#if CUDA_VERSION >= 9010
+    auto ptrs = matrixPointers(in);
+    CUSOLVER_CHECK(potrfBatched_func<T>()(solverDnHandle(), uplo, N,
+                                          (T **)ptrs.get(), in.strides()[1],
+                                          d_info.get(), batch));
+#else
+    // cuSOLVER has no batched Cholesky decomposition before CUDA 9.1
+    int lwork = 0;
+    CUSOLVER_CHECK(potrf_buf_func<T>()(solverDnHandle(), uplo, N, in.get(),
+                                       in.strides()[1], &lwork));
+
+    auto workspace = memAlloc<T>(lwork);
+    for (dim_t w = 0; w < iDims[3]; w++) {
+        for (dim_t z = 0; z < iDims[2]; z++) {
+            T *ptr = in.get() + z * in.strides()[2] + w * in.strides()[3];
+            CUSOLVER_CHECK(potrf_func<T>()(
+                solverDnHandle(), uplo, N, ptr, in.strides()[1],
+                workspace.get(), lwork, d_info.get() + w * iDims[2] + z));
+        }
+    }
+#endif
+
+    std::vector<int> h_info(batch);
+    CUDA_CHECK(cudaMemcpyAsync(h_info.data(), d_info.get(),
+                               batch * sizeof(int), cudaMemcpyDeviceToHost,
+                               getActiveStream()));
+    CUDA_CHECK(cudaStreamSynchronize(getActiveStream()));
+
+    for (int info : h_info) {
+        if (info != 0) { return info; }
+    }
+    return 0;
+}
+
 template<typename T>
 Array<T> cholesky(int *info, const Array<T> &in, const bool is_upper) {
     Array<T> out = copyArray<T>(in);
@@ -100,6 +182,8 @@ int cholesky_inplace(Array<T> &in, const bool is_upper) {
     cublasFillMode_t uplo = CUBLAS_FILL_MODE_LOWER;
     if (is_upper) { uplo = CUBLAS_FILL_MODE_UPPER; }
 
+    if (iDims[2] * iDims[3] > 1) { return choleskyBatched(in, uplo); }
+
     CUSOLVER_CHECK(potrf_buf_func<T>()(solverDnHandle(), uplo, N, in.get(),
                                        in.strides()[1], &lwork));
 
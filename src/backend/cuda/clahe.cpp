@@ -0,0 +1,47 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <clahe.hpp>
+#include <err_cuda.hpp>
+#include <kernel/clahe.hpp>
+#include <af/dim4.hpp>
+
+using af::dim4;
+
+namespace cuda {
+
+template<typename T>
+Array<T> clahe(const Array<T> &in, const unsigned gridRows,
+               const unsigned gridCols, const float clipLimit,
+               const unsigned nbins, const float minval, const float maxval) {
+    const dim4 &dims = in.dims();
+    Array<float> lut = createEmptyArray<float>(
+        dim4(nbins, gridRows, gridCols, dims[2] * dims[3]));
+    Array<T> out = createEmptyArray<T>(dims);
+
+    kernel::claheLut<T>(lut, in, clipLimit, minval, maxval);
+    kernel::claheApply<T>(out, in, lut, minval, maxval);
+    return out;
+}
+
+#define INSTANTIATE(T)                                                      \
+    template Array<T> clahe<T>(const Array<T> &, const unsigned,            \
+                               const unsigned, const float, const unsigned, \
+                               const float, const float);
+
+INSTANTIATE(float)
+INSTANTIATE(double)
+INSTANTIATE(int)
+INSTANTIATE(uint)
+INSTANTIATE(uchar)
+INSTANTIATE(short)
+INSTANTIATE(ushort)
+
+}  // namespace cuda
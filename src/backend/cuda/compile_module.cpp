@@ -12,9 +12,12 @@
 
 #include <Module.hpp>
 #include <common/Logger.hpp>
+#include <common/Profiler.hpp>
 #include <common/internal_enums.hpp>
+#include <common/kernel_disk_cache.hpp>
 #include <common/util.hpp>
 #include <device_manager.hpp>
+#include <err_cuda.hpp>
 #include <kernel_headers/jit_cuh.hpp>
 #include <nvrtc_kernel_headers/Binary_hpp.hpp>
 #include <nvrtc_kernel_headers/Param_hpp.hpp>
@@ -60,6 +63,10 @@
 
 using namespace cuda;
 
+using common::addCachedKernel;
+using common::CachedKernel;
+using common::removeCachedKernel;
+using common::touchCachedKernel;
 using detail::Module;
 using std::accumulate;
 using std::array;
@@ -72,6 +79,7 @@ using std::make_pair;
 using std::map;
 using std::ofstream;
 using std::pair;
+using std::shared_ptr;
 using std::string;
 using std::to_string;
 using std::transform;
@@ -262,11 +270,11 @@ Module compileModule(const string &moduleKey, const vector<string> &sources,
         "--generate-line-info"
 #endif
     };
+    // The options of the JIT kernels only select the precision mode
+    transform(begin(opts), end(opts),
+              back_insert_iterator<vector<const char *>>(compiler_options),
+              [](const string &s) { return s.data(); });
     if (!sourceIsJIT) {
-        transform(begin(opts), end(opts),
-                  back_insert_iterator<vector<const char *>>(compiler_options),
-                  [](const string &s) { return s.data(); });
-
         for (auto &instantiation : kInstances) {
             NVRTC_CHECK(nvrtcAddNameExpression(prog, instantiation.c_str()));
         }
@@ -309,6 +317,7 @@ Module compileModule(const string &moduleKey, const vector<string> &sources,
     auto link_end = high_resolution_clock::now();
 
     Module retVal(modOut);
+    retVal.setBytes(cubinSize);
     if (!sourceIsJIT) {
         for (auto &instantiation : kInstances) {
             // memory allocated & destroyed by nvrtcProgram for below var
@@ -323,8 +332,8 @@ Module compileModule(const string &moduleKey, const vector<string> &sources,
     // save kernel in cache
     const string &cacheDirectory = getCacheDirectory();
     if (!cacheDirectory.empty()) {
-        const string cacheFile = cacheDirectory + AF_PATH_SEPARATOR +
-                                 getKernelCacheFilename(device, moduleKey);
+        const string cacheName = getKernelCacheFilename(device, moduleKey);
+        const string cacheFile = cacheDirectory + AF_PATH_SEPARATOR + cacheName;
         const string tempFile =
             cacheDirectory + AF_PATH_SEPARATOR + makeTempFilename();
         try {
@@ -357,12 +366,18 @@ Module compileModule(const string &moduleKey, const vector<string> &sources,
             out.write(reinterpret_cast<const char *>(&cubinSize),
                       sizeof(cubinSize));
             out.write(static_cast<const char *>(cubin), cubinSize);
+            const size_t fileSize = static_cast<size_t>(out.tellp());
             out.close();
 
             // try to rename temporary file into final cache file, if this fails
             // this means another thread has finished compiling this kernel
             // before the current thread.
-            if (!renameFile(tempFile, cacheFile)) { removeFile(tempFile); }
+            if (renameFile(tempFile, cacheFile)) {
+                addCachedKernel(CachedKernel{moduleKey, cacheName, fileSize,
+                                             cubinHash, sourceIsJIT, 0});
+            } else {
+                removeFile(tempFile);
+            }
         } catch (const std::ios_base::failure &e) {
             AF_TRACE("{{{:<30} : failed saving binary to {} for {}, {}}}",
                      moduleKey, cacheFile, getDeviceProp(device).name,
@@ -390,13 +405,34 @@ Module compileModule(const string &moduleKey, const vector<string> &sources,
     return retVal;
 }
 
-Module loadModuleFromDisk(const int device, const string &moduleKey,
-                          const bool isJIT) {
-    const string &cacheDirectory = getCacheDirectory();
-    if (cacheDirectory.empty()) return Module{nullptr};
+namespace {
+
+/// Returns the read-only directory of the kernel binaries which were
+/// precompiled when the library was built. AF_CUDA_KERNEL_BUNDLE_DIRECTORY
+/// overrides the install location. Empty if there is no bundle.
+const string &getKernelBundleDirectory() {
+    static const string directory = [] {
+        string dir = getEnvVar("AF_CUDA_KERNEL_BUNDLE_DIRECTORY");
+#if defined(AF_CUDA_KERNEL_BUNDLE_DIR)
+        if (dir.empty()) { dir = AF_CUDA_KERNEL_BUNDLE_DIR; }
+#endif
+        return dir;
+    }();
+    return directory;
+}
 
-    const string cacheFile = cacheDirectory + AF_PATH_SEPARATOR +
-                             getKernelCacheFilename(device, moduleKey);
+/// Loads the module stored in \p cacheName in \p directory
+///
+/// Binaries in the kernel cache directory are tracked by the kernel cache
+/// index and are removed if they cannot be loaded. The bundle directory is
+/// read-only so its binaries are left alone.
+Module loadModuleFromFile(const int device, const string &moduleKey,
+                          const bool isJIT, const string &directory,
+                          const string &cacheName, const bool isBundle) {
+    const string cacheFile = directory + AF_PATH_SEPARATOR + cacheName;
+    auto discard           = [&]() {
+        if (!isBundle) { removeCachedKernel(cacheName); }
+    };
 
     CUmodule modOut = nullptr;
     Module retVal{nullptr};
@@ -405,7 +441,7 @@ Module loadModuleFromDisk(const int device, const string &moduleKey,
         if (!in) {
             AF_TRACE("{{{:<20} : Unable to open {} for {}}}", moduleKey,
                      cacheFile, getDeviceProp(device).name);
-            removeFile(cacheFile);  // Remove if exists
+            discard();  // Remove if exists
             return Module{nullptr};
         }
         in.exceptions(std::ios::failbit | std::ios::badbit);
@@ -438,6 +474,7 @@ Module loadModuleFromDisk(const int device, const string &moduleKey,
         in.read(reinterpret_cast<char *>(&cubinSize), sizeof(cubinSize));
         vector<char> cubin(cubinSize);
         in.read(cubin.data(), cubinSize);
+        const size_t fileSize = static_cast<size_t>(in.tellg());
         in.close();
 
         // check CUBIN binary data has not been corrupted
@@ -446,6 +483,12 @@ Module loadModuleFromDisk(const int device, const string &moduleKey,
         if (recomputedHash != cubinHash) {
             AF_ERROR("Module on disk seems to be corrupted", AF_ERR_LOAD_SYM);
         }
+        if (!isBundle &&
+            !touchCachedKernel(CachedKernel{moduleKey, cacheName, fileSize,
+                                            cubinHash, isJIT, 0})) {
+            AF_ERROR("Module on disk does not match the kernel cache index",
+                     AF_ERR_LOAD_SYM);
+        }
 
         CU_CHECK(cuModuleLoadData(&modOut, cubin.data()));
 
@@ -453,15 +496,15 @@ Module loadModuleFromDisk(const int device, const string &moduleKey,
                  getDeviceProp(device).name);
 
         retVal.set(modOut);
+        retVal.setBytes(cubinSize);
     } catch (const std::ios_base::failure &e) {
         AF_TRACE("{{{:<20} : Unable to read {} for {}}}", moduleKey, cacheFile,
                  getDeviceProp(device).name);
-        removeFile(cacheFile);
+        discard();
     } catch (const AfError &e) {
         if (e.getError() == AF_ERR_LOAD_SYM) {
-            AF_TRACE(
-                "{{{:<20} : Corrupt binary({}) found on disk for {}, removed}}",
-                moduleKey, cacheFile, getDeviceProp(device).name);
+            AF_TRACE("{{{:<20} : Corrupt binary({}) found on disk for {}}}",
+                     moduleKey, cacheFile, getDeviceProp(device).name);
         } else {
             if (modOut != nullptr) { CU_CHECK(cuModuleUnload(modOut)); }
             AF_TRACE(
@@ -469,17 +512,65 @@ Module loadModuleFromDisk(const int device, const string &moduleKey,
                 "{}, {}}}",
                 moduleKey, cacheFile, getDeviceProp(device).name, e.what());
         }
-        removeFile(cacheFile);
+        discard();
     }
     return retVal;
 }
 
+}  // namespace
+
+Module loadModuleFromDisk(const int device, const string &moduleKey,
+                          const bool isJIT) {
+    const string cacheName = getKernelCacheFilename(device, moduleKey);
+
+    // The precompiled bundle is checked first so kernels which were
+    // instantiated at build time are never compiled at runtime
+    const string &bundleDirectory = getKernelBundleDirectory();
+    if (!bundleDirectory.empty()) {
+        Module mod = loadModuleFromFile(device, moduleKey, isJIT,
+                                        bundleDirectory, cacheName, true);
+        if (mod) { return mod; }
+    }
+
+    const string &cacheDirectory = getCacheDirectory();
+    if (cacheDirectory.empty()) return Module{nullptr};
+    return loadModuleFromFile(device, moduleKey, isJIT, cacheDirectory,
+                              cacheName, false);
+}
+
 Kernel getKernel(const Module &mod, const string &nameExpr,
                  const bool sourceWasJIT) {
     std::string name  = (sourceWasJIT ? nameExpr : mod.mangledName(nameExpr));
     CUfunction kernel = nullptr;
     CU_CHECK(cuModuleGetFunction(&kernel, mod.get(), name.c_str()));
-    return {mod.get(), kernel};
+    if (isProfiling()) { setProfiledName(kernel, nameExpr); }
+    return {mod.get(), kernel, mod.owner()};
+}
+
+void shareModule(Module &mod, const int device) {
+    mod.setOwner(shared_ptr<void>(mod.get(), [device](void *handle) {
+        // The kernels of the module may still be running on any stream of
+        // the device, including the streams of other threads
+        try {
+            const int current = cuda::setDevice(device);
+            CUDA_CHECK(cudaDeviceSynchronize());
+            CU_CHECK(cuModuleUnload(static_cast<CUmodule>(handle)));
+            cuda::setDevice(current);
+        } catch (const AfError &err) {
+            AF_TRACE("Failed to unload an evicted module: {}", err.what());
+        }
+    }));
+}
+
+vector<string> getPrecisionOptions(const int /*device*/,
+                                   const af_precision_mode mode) {
+    switch (mode) {
+        case AF_PRECISION_STRICT: return {"--fmad=false"};
+        case AF_PRECISION_RELAXED:
+            return {"--prec-div=false", "--prec-sqrt=false"};
+        case AF_PRECISION_FAST: return {"--use_fast_math"};
+        default: return {};
+    }
 }
 
 }  // namespace common
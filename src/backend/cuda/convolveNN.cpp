@@ -10,34 +10,32 @@
 #include <convolve.hpp>
 
 #include <Array.hpp>
-#include <blas.hpp>
 #include <cast.hpp>
 #include <common/half.hpp>
-#include <common/indexing_helpers.hpp>
 #include <common/unique_handle.hpp>
 #ifdef WITH_CUDNN
 #include <cudnn.hpp>
+#include <cudnnAlgorithmCache.hpp>
 #endif
 #include <err_cuda.hpp>
+#include <kernel/conv2_implicit.hpp>
 #include <kernel/convolve.hpp>
 #include <platform.hpp>
-#include <reorder.hpp>
-#include <transpose.hpp>
-#include <unwrap.hpp>
-#include <wrap.hpp>
+#include <reduce.hpp>
 #include <af/dim4.hpp>
 
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 using af::dim4;
-using common::flip;
 using common::half;
 using common::make_handle;
 using std::conditional;
 using std::is_same;
 using std::pair;
+using std::string;
 using std::tie;
 using std::vector;
 
@@ -58,12 +56,39 @@ template<typename T>
 using scale_type =
     typename conditional<is_same<T, double>::value, double, float>::type;
 
+/// Selects the fastest algorithm of \p perfResults whose workspace is not
+/// larger than \p workspaceLimit. Returns false if there is none.
+template<typename PerfType, typename AlgoType>
+bool selectAlgorithm(const vector<PerfType> &perfResults, int count,
+                     size_t workspaceLimit, AlgoType &algorithm,
+                     size_t &workspace_bytes) {
+    for (int i = 0; i < count; ++i) {
+        if (perfResults[i].status == CUDNN_STATUS_SUCCESS &&
+            perfResults[i].memory <= workspaceLimit) {
+            algorithm       = perfResults[i].algo;
+            workspace_bytes = perfResults[i].memory;
+            return true;
+        }
+    }
+    return false;
+}
+
 pair<cudnnConvolutionFwdAlgo_t, size_t> getForwardAlgorithm(
-    cudnnHandle_t cudnn, cudnnTensorDescriptor_t input_descriptor,
+    cudnnHandle_t cudnn, const string &key,
+    cudnnTensorDescriptor_t input_descriptor,
     cudnnFilterDescriptor_t filter_descriptor,
     cudnnConvolutionDescriptor_t convolution_descriptor,
     cudnnTensorDescriptor_t output_descriptor) {
-    cudnnConvolutionFwdAlgo_t convolution_algorithm;
+    const size_t workspaceLimit = getConvolutionWorkspaceLimit();
+    ConvolutionAlgorithm cached{};
+    if (findConvolutionAlgorithm(key, workspaceLimit, cached)) {
+        return {static_cast<cudnnConvolutionFwdAlgo_t>(cached.algo),
+                cached.workspaceBytes};
+    }
+
+    // The implicit GEMM algorithm does not need a workspace
+    cudnnConvolutionFwdAlgo_t convolution_algorithm =
+        CUDNN_CONVOLUTION_FWD_ALGO_IMPLICIT_GEMM;
     size_t workspace_bytes = 0;
 
     auto version = getCudnnPlugin().getVersion();
@@ -79,25 +104,19 @@ pair<cudnnConvolutionFwdAlgo_t, size_t> getForwardAlgorithm(
             output_descriptor, maxAlgoCount, &returnAlgoCount,
             perfResults.data()));
 
-        for (int i = 0; i < returnAlgoCount; ++i) {
-            if (perfResults[i].status == CUDNN_STATUS_SUCCESS) {
-                convolution_algorithm = perfResults[i].algo;
-                workspace_bytes       = perfResults[i].memory;
-                break;
-            }
-        }
+        selectAlgorithm(perfResults, returnAlgoCount, workspaceLimit,
+                        convolution_algorithm, workspace_bytes);
     } else {
-        const int memory_limit =
-            0;  // TODO: set to remaining space in memory manager?
         CUDNN_CHECK(cuda::cudnnGetConvolutionForwardAlgorithm(
             cudnn, input_descriptor, filter_descriptor, convolution_descriptor,
-            output_descriptor, CUDNN_CONVOLUTION_FWD_PREFER_FASTEST,
-            memory_limit, &convolution_algorithm));
+            output_descriptor, CUDNN_CONVOLUTION_FWD_SPECIFY_WORKSPACE_LIMIT,
+            workspaceLimit, &convolution_algorithm));
         CUDNN_CHECK(cuda::cudnnGetConvolutionForwardWorkspaceSize(
             cudnn, input_descriptor, filter_descriptor, convolution_descriptor,
             output_descriptor, convolution_algorithm, &workspace_bytes));
     }
 
+    cacheConvolutionAlgorithm(key, {convolution_algorithm, workspace_bytes});
     return {convolution_algorithm, workspace_bytes};
 }
 
@@ -141,8 +160,11 @@ Array<T> convolve2_cudnn(const Array<T> &signal, const Array<T> &filter,
     cudnnConvolutionFwdAlgo_t convolution_algorithm;
     size_t workspace_bytes = 0;
 
+    const string key = convolutionAlgorithmKey(
+        ConvolutionPass::Forward, cudnn_dtype, signal.dims(), filter.dims(),
+        stride, padding, dilation);
     tie(convolution_algorithm, workspace_bytes) =
-        getForwardAlgorithm(cudnn, input_descriptor, filter_descriptor,
+        getForwardAlgorithm(cudnn, key, input_descriptor, filter_descriptor,
                             convolution_descriptor, output_descriptor);
 
     auto workspace_buffer = memAlloc<char>(workspace_bytes);
@@ -183,33 +205,11 @@ Array<T> convolve2_base(const Array<T> &signal, const Array<T> &filter,
         1 + (sDims[1] + 2 * padding[1] - (((fDims[1] - 1) * dilation[1]) + 1)) /
                 stride[1];
 
-    const bool retCols = false;
-    Array<T> unwrapped =
-        unwrap(signal, fDims[0], fDims[1], stride[0], stride[1], padding[0],
-               padding[1], dilation[0], dilation[1], retCols);
-
-    unwrapped  = reorder(unwrapped, dim4(1, 2, 0, 3));
-    dim4 uDims = unwrapped.dims();
-    unwrapped.modDims(dim4(uDims[0] * uDims[1], uDims[2] * uDims[3]));
-
-    Array<T> collapsedFilter = filter;
-
-    collapsedFilter = flip(collapsedFilter, {1, 1, 0, 0});
-    collapsedFilter.modDims(dim4(fDims[0] * fDims[1] * fDims[2], fDims[3]));
-
-    T alpha        = scalar<T>(1.0);
-    T beta         = scalar<T>(0.0);
-    const int Mdim = 1;
-    const int Ndim = 1;
-    Array<T> res   = createEmptyArray<T>(
-        dim4(unwrapped.dims()[Mdim], collapsedFilter.dims()[Ndim],
-             unwrapped.dims()[2], unwrapped.dims()[3]));
-    gemm(res, AF_MAT_TRANS, AF_MAT_NONE, &alpha, unwrapped, collapsedFilter,
-         &beta);
-    res.modDims(dim4(outputWidth, outputHeight, signal.dims()[3],
-                     collapsedFilter.dims()[1]));
-    Array<T> out = reorder(res, dim4(0, 1, 3, 2));
-
+    Array<T> out = createEmptyArray<T>(
+        dim4(outputWidth, outputHeight, fDims[3], sDims[3]));
+    kernel::conv2Implicit<T>(out, signal, filter, AF_CONV2_FORWARD, fDims[0],
+                             fDims[1], stride, padding, dilation,
+                             fDims[0] * fDims[1] * fDims[2]);
     return out;
 }
 
@@ -243,40 +243,68 @@ Array<T> data_gradient_base(const Array<T> &incoming_gradient,
                             af::dim4 padding, af::dim4 dilation) {
     UNUSED(convolved_output);
     const dim4 &cDims = incoming_gradient.dims();
-    const dim4 &sDims = original_signal.dims();
     const dim4 &fDims = original_filter.dims();
 
-    Array<T> collapsed_filter = original_filter;
-
-    collapsed_filter = flip(collapsed_filter, {1, 1, 0, 0});
-    collapsed_filter.modDims(dim4(fDims[0] * fDims[1] * fDims[2], fDims[3]));
-
-    Array<T> collapsed_gradient = incoming_gradient;
-    collapsed_gradient          = reorder(collapsed_gradient, dim4(0, 1, 3, 2));
-    collapsed_gradient.modDims(dim4(cDims[0] * cDims[1] * cDims[3], cDims[2]));
-
-    T alpha        = scalar<T>(1.0);
-    T beta         = scalar<T>(0.0);
-    const int Mdim = 0;
-    const int Ndim = 0;
-    Array<T> res   = createEmptyArray<T>(
-        dim4(collapsed_gradient.dims()[Mdim], collapsed_filter.dims()[Ndim],
-             collapsed_gradient.dims()[3], collapsed_gradient.dims()[3]));
-    gemm(res, AF_MAT_NONE, AF_MAT_TRANS, &alpha, collapsed_gradient,
-         collapsed_filter, &beta);
-    res.modDims(dim4(res.dims()[0] / sDims[3], sDims[3], fDims[0] * fDims[1],
-                     sDims[2]));
-    res = reorder(res, dim4(0, 2, 3, 1));
-
-    const bool retCols = false;
-    res = wrap_dilated(res, sDims[0], sDims[1], fDims[0], fDims[1], stride[0],
-                       stride[1], padding[0], padding[1], dilation[0],
-                       dilation[1], retCols);
-
-    return res;
+    Array<T> out = createEmptyArray<T>(original_signal.dims());
+    kernel::conv2Implicit<T>(out, incoming_gradient, original_filter,
+                             AF_CONV2_DATA_GRADIENT, fDims[0], fDims[1], stride,
+                             padding, dilation, fDims[0] * fDims[1] * cDims[2]);
+    return out;
 }
 
 #ifdef WITH_CUDNN
+template<typename T>
+pair<cudnnConvolutionBwdDataAlgo_t, size_t> getBackwardDataAlgorithm(
+    cudnnHandle_t cudnn, const string &key,
+    cudnnFilterDescriptor_t w_descriptor,
+    cudnnTensorDescriptor_t dy_descriptor,
+    cudnnConvolutionDescriptor_t convolution_descriptor,
+    cudnnTensorDescriptor_t dx_descriptor, const dim4 &dilation) {
+    const size_t workspaceLimit = getConvolutionWorkspaceLimit();
+    ConvolutionAlgorithm cached{};
+    if (findConvolutionAlgorithm(key, workspaceLimit, cached)) {
+        return {static_cast<cudnnConvolutionBwdDataAlgo_t>(cached.algo),
+                cached.workspaceBytes};
+    }
+
+    // These algorithms support every data type and dilation
+    cudnnConvolutionBwdDataAlgo_t bwd_data_convolution_algorithm;
+    if ((dilation[0] == 1 && dilation[1] == 1) || is_same<T, half>::value) {
+        bwd_data_convolution_algorithm = CUDNN_CONVOLUTION_BWD_DATA_ALGO_1;
+    } else {
+        bwd_data_convolution_algorithm = CUDNN_CONVOLUTION_BWD_DATA_ALGO_0;
+    }
+    size_t workspace_bytes = 0;
+
+    auto version = getCudnnPlugin().getVersion();
+    bool found   = false;
+    if (std::get<0>(version) >= 8) {
+        int maxAlgoCount = 0;
+        CUDNN_CHECK(cuda::cudnnGetConvolutionBackwardDataAlgorithmMaxCount(
+            cudnn, &maxAlgoCount));
+
+        vector<cudnnConvolutionBwdDataAlgoPerf_t> perfResults(maxAlgoCount);
+        int returnAlgoCount = 0;
+        CUDNN_CHECK(cuda::cudnnFindConvolutionBackwardDataAlgorithm(
+            cudnn, w_descriptor, dy_descriptor, convolution_descriptor,
+            dx_descriptor, maxAlgoCount, &returnAlgoCount,
+            perfResults.data()));
+
+        found = selectAlgorithm(perfResults, returnAlgoCount, workspaceLimit,
+                                bwd_data_convolution_algorithm,
+                                workspace_bytes);
+    }
+    if (!found) {
+        CUDNN_CHECK(cuda::cudnnGetConvolutionBackwardDataWorkspaceSize(
+            cudnn, w_descriptor, dy_descriptor, convolution_descriptor,
+            dx_descriptor, bwd_data_convolution_algorithm, &workspace_bytes));
+    }
+
+    cacheConvolutionAlgorithm(
+        key, {bwd_data_convolution_algorithm, workspace_bytes});
+    return {bwd_data_convolution_algorithm, workspace_bytes};
+}
+
 template<typename T>
 Array<T> data_gradient_cudnn(const Array<T> &incoming_gradient,
                              const Array<T> &original_signal,
@@ -309,18 +337,18 @@ Array<T> data_gradient_cudnn(const Array<T> &incoming_gradient,
         convolution_descriptor, padding[1], padding[0], stride[1], stride[0],
         dilation[1], dilation[0], CUDNN_CONVOLUTION, cudnn_dtype));
 
+    // determine algorithm to use
     cudnnConvolutionBwdDataAlgo_t bwd_data_convolution_algorithm;
-    if ((dilation[0] == 1 && dilation[1] == 1) || is_same<T, half>::value) {
-        bwd_data_convolution_algorithm = CUDNN_CONVOLUTION_BWD_DATA_ALGO_1;
-    } else {
-        bwd_data_convolution_algorithm = CUDNN_CONVOLUTION_BWD_DATA_ALGO_0;
-    }
-
     // figure out scratch space memory requirements
-    size_t workspace_bytes;
-    CUDNN_CHECK(cuda::cudnnGetConvolutionBackwardDataWorkspaceSize(
-        cudnn, w_descriptor, dy_descriptor, convolution_descriptor,
-        dx_descriptor, bwd_data_convolution_algorithm, &workspace_bytes));
+    size_t workspace_bytes = 0;
+
+    const string key = convolutionAlgorithmKey(
+        ConvolutionPass::BackwardData, cudnn_dtype, sDims, fDims, stride,
+        padding, dilation);
+    tie(bwd_data_convolution_algorithm, workspace_bytes) =
+        getBackwardDataAlgorithm<T>(cudnn, key, w_descriptor, dy_descriptor,
+                                    convolution_descriptor, dx_descriptor,
+                                    dilation);
 
     dim4 odims(sDims[0], sDims[1], sDims[2], sDims[3]);
     Array<T> out = createEmptyArray<T>(odims);
@@ -370,42 +398,40 @@ Array<T> filter_gradient_base(const Array<T> &incoming_gradient,
     const dim4 &cDims = incoming_gradient.dims();
     const dim4 &fDims = original_filter.dims();
 
-    const bool retCols = false;
-    Array<T> unwrapped =
-        unwrap(original_signal, fDims[0], fDims[1], stride[0], stride[1],
-               padding[0], padding[1], dilation[0], dilation[1], retCols);
-
-    unwrapped  = reorder(unwrapped, dim4(1, 2, 0, 3));
-    dim4 uDims = unwrapped.dims();
-    unwrapped.modDims(dim4(uDims[0] * uDims[1], uDims[2] * uDims[3]));
-
-    Array<T> collapsed_gradient = incoming_gradient;
-    collapsed_gradient          = reorder(collapsed_gradient, dim4(0, 1, 3, 2));
-    collapsed_gradient.modDims(dim4(cDims[0] * cDims[1] * cDims[3], cDims[2]));
-
-    T alpha        = scalar<T>(1.0);
-    T beta         = scalar<T>(0.0);
-    const int Mdim = 0;
-    const int Ndim = 1;
-    Array<T> res   = createEmptyArray<T>(
-        dim4(unwrapped.dims()[Mdim], collapsed_gradient.dims()[Ndim],
-             unwrapped.dims()[2], unwrapped.dims()[3]));
-    gemm(res, AF_MAT_NONE, AF_MAT_NONE, &alpha, unwrapped, collapsed_gradient,
-         &beta);
-    res.modDims(dim4(fDims[0], fDims[1], fDims[2], fDims[3]));
-
-    return flip(res, {1, 1, 0, 0});
+    // The sum over all the output pixels is split in parts, which are
+    // computed by different blocks and added afterwards
+    const dim_t pixels = cDims[0] * cDims[1] * cDims[3];
+    const dim_t chunk  = kernel::conv2GradientChunk(pixels);
+
+    Array<T> partial = createEmptyArray<T>(
+        dim4(fDims[0] * fDims[1] * fDims[2], fDims[3], divup(pixels, chunk)));
+    kernel::conv2Implicit<T>(partial, original_signal, incoming_gradient,
+                             AF_CONV2_FILTER_GRADIENT, fDims[0], fDims[1],
+                             stride, padding, dilation, chunk);
+
+    Array<T> res = reduce<af_add_t, T, T>(partial, 2);
+    res.modDims(fDims);
+    return res;
 }
 
 #ifdef WITH_CUDNN
 
 pair<cudnnConvolutionBwdFilterAlgo_t, size_t> getBackwardFilterAlgorithm(
-    cudnnHandle_t cudnn, cudnnTensorDescriptor_t x_descriptor,
+    cudnnHandle_t cudnn, const string &key,
+    cudnnTensorDescriptor_t x_descriptor,
     cudnnTensorDescriptor_t dy_descriptor,
     cudnnConvolutionDescriptor_t convolution_descriptor,
     cudnnFilterDescriptor_t dw_descriptor) {
-    // determine algorithm to use
-    cudnnConvolutionBwdFilterAlgo_t bwd_filt_convolution_algorithm;
+    const size_t workspaceLimit = getConvolutionWorkspaceLimit();
+    ConvolutionAlgorithm cached{};
+    if (findConvolutionAlgorithm(key, workspaceLimit, cached)) {
+        return {static_cast<cudnnConvolutionBwdFilterAlgo_t>(cached.algo),
+                cached.workspaceBytes};
+    }
+
+    // determine algorithm to use. This one does not need a workspace.
+    cudnnConvolutionBwdFilterAlgo_t bwd_filt_convolution_algorithm =
+        CUDNN_CONVOLUTION_BWD_FILTER_ALGO_0;
     // figure out scratch space memory requirements
     size_t workspace_bytes = 0;
 
@@ -421,22 +447,20 @@ pair<cudnnConvolutionBwdFilterAlgo_t, size_t> getBackwardFilterAlgorithm(
             cudnn, x_descriptor, dy_descriptor, convolution_descriptor,
             dw_descriptor, maxAlgoCount, &returnAlgoCount, perfResults.data()));
 
-        for (int i = 0; i < returnAlgoCount; ++i) {
-            if (perfResults[i].status == CUDNN_STATUS_SUCCESS) {
-                bwd_filt_convolution_algorithm = perfResults[i].algo;
-                workspace_bytes                = perfResults[i].memory;
-                break;
-            }
-        }
+        selectAlgorithm(perfResults, returnAlgoCount, workspaceLimit,
+                        bwd_filt_convolution_algorithm, workspace_bytes);
     } else {
         CUDNN_CHECK(cuda::cudnnGetConvolutionBackwardFilterAlgorithm(
             cudnn, x_descriptor, dy_descriptor, convolution_descriptor,
-            dw_descriptor, CUDNN_CONVOLUTION_BWD_FILTER_PREFER_FASTEST, 0,
-            &bwd_filt_convolution_algorithm));
+            dw_descriptor, CUDNN_CONVOLUTION_BWD_FILTER_SPECIFY_WORKSPACE_LIMIT,
+            workspaceLimit, &bwd_filt_convolution_algorithm));
         CUDNN_CHECK(cuda::cudnnGetConvolutionBackwardFilterWorkspaceSize(
             cudnn, x_descriptor, dy_descriptor, convolution_descriptor,
             dw_descriptor, bwd_filt_convolution_algorithm, &workspace_bytes));
     }
+
+    cacheConvolutionAlgorithm(
+        key, {bwd_filt_convolution_algorithm, workspace_bytes});
     return {bwd_filt_convolution_algorithm, workspace_bytes};
 }
 
@@ -472,8 +496,11 @@ Array<T> filter_gradient_cudnn(const Array<T> &incoming_gradient,
     // figure out scratch space memory requirements
     size_t workspace_bytes = 0;
 
+    const string key = convolutionAlgorithmKey(
+        ConvolutionPass::BackwardFilter, cudnn_dtype, original_signal.dims(),
+        fDims, stride, padding, dilation);
     tie(bwd_filt_convolution_algorithm, workspace_bytes) =
-        getBackwardFilterAlgorithm(cudnn, x_descriptor, dy_descriptor,
+        getBackwardFilterAlgorithm(cudnn, key, x_descriptor, dy_descriptor,
                                    convolution_descriptor, dw_descriptor);
 
     // prepare output array and scratch space
@@ -10,17 +10,56 @@
 #include <copy.hpp>
 
 #include <Array.hpp>
+#include <Event.hpp>
+#include <common/bfloat16.hpp>
 #include <common/complex.hpp>
 #include <common/half.hpp>
 #include <cuda_runtime_api.h>
+#include <err_cuda.hpp>
 #include <kernel/memcopy.hpp>
 #include <math.hpp>
+#include <platform.hpp>
 
+#include <map>
+#include <mutex>
+#include <utility>
+
+using af::dim4;
+using common::bfloat16;
 using common::half;
 using common::is_complex;
 
 namespace cuda {
 
+namespace {
+
+/// Copies a view whose columns are contiguous to the host with a single
+/// pitched copy, instead of linearizing it on the device first. Returns
+/// false if the layout of the view needs a linear copy.
+template<typename T>
+bool copyPitchedData(T *dst, const Array<T> &src, cudaStream_t stream) {
+    const dim4 &dims = src.dims();
+    dim4 strides;
+    // The planes of a 3D copy have to be a whole number of rows apart
+    if (!isPitchedView(dims, src.strides(), strides) ||
+        strides[2] % strides[1] != 0) {
+        return false;
+    }
+
+    const size_t width = dims[0] * sizeof(T);
+    cudaMemcpy3DParms params{};
+    params.srcPtr = make_cudaPitchedPtr(const_cast<T *>(src.get()),
+                                        strides[1] * sizeof(T), width,
+                                        strides[2] / strides[1]);
+    params.dstPtr = make_cudaPitchedPtr(dst, width, width, dims[1]);
+    params.extent = make_cudaExtent(width, dims[1], dims[2] * dims[3]);
+    params.kind   = cudaMemcpyDeviceToHost;
+    CUDA_CHECK(cudaMemcpy3DAsync(&params, stream));
+    return true;
+}
+
+}  // namespace
+
 template<typename T>
 void copyData(T *dst, const Array<T> &src) {
     // FIXME: Merge this with copyArray
@@ -28,19 +67,22 @@ void copyData(T *dst, const Array<T> &src) {
 
     Array<T> out = src;
     const T *ptr = NULL;
+    auto stream  = cuda::getActiveStream();
 
     if (src.isLinear() ||  // No offsets, No strides
         src.ndims() == 1   // Simple offset, no strides.
     ) {
         // A.get() gets data with offsets
         ptr = src.get();
+    } else if (src.elements() > 0 && copyPitchedData(dst, src, stream)) {
+        CUDA_CHECK(cudaStreamSynchronize(stream));
+        return;
     } else {
         // FIXME: Think about implementing eval
         out = copyArray(src);
         ptr = out.get();
     }
 
-    auto stream = cuda::getActiveStream();
     CUDA_CHECK(cudaMemcpyAsync(dst, ptr, src.elements() * sizeof(T),
                                cudaMemcpyDeviceToHost, stream));
     CUDA_CHECK(cudaStreamSynchronize(stream));
@@ -96,10 +138,102 @@ void copyArray(Array<outType> &out, Array<inType> const &in) {
     copyFn(out, in);
 }
 
-#define INSTANTIATE(T)                                       \
-    template void copyData<T>(T * dst, const Array<T> &src); \
-    template Array<T> copyArray<T>(const Array<T> &src);     \
-    template void multiply_inplace<T>(Array<T> & in, double norm);
+template<typename T>
+void copyToArrayAsync(Array<T> &dst, const T *src, const size_t bytes,
+                      const size_t offset) {
+    if (!dst.isOwner()) { dst = copyArray<T>(dst); }
+    char *ptr = reinterpret_cast<char *>(dst.get()) + offset;
+    CUDA_CHECK(cudaMemcpyAsync(ptr, src, bytes, cudaMemcpyHostToDevice,
+                               cuda::getActiveStream()));
+}
+
+template<typename T>
+void copyFromArrayAsync(T *dst, const Array<T> &src, const size_t bytes,
+                        const size_t offset) {
+    const char *ptr = reinterpret_cast<const char *>(src.get()) + offset;
+    CUDA_CHECK(cudaMemcpyAsync(dst, ptr, bytes, cudaMemcpyDeviceToHost,
+                               cuda::getActiveStream()));
+}
+
+namespace {
+/// Enables the access of \p device to the memory of \p peer the first time
+/// the pair is used. The copies between devices without peer access are
+/// staged through the host by the driver.
+void enablePeerAccess(int device, int peer) {
+    static std::mutex mutex;
+    static std::map<std::pair<int, int>, bool> enabled;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    bool &done = enabled[std::make_pair(device, peer)];
+    if (done) { return; }
+    done = true;
+
+    const int nativeDevice = getDeviceNativeId(device);
+    const int nativePeer   = getDeviceNativeId(peer);
+    int canAccess          = 0;
+    CUDA_CHECK(cudaDeviceCanAccessPeer(&canAccess, nativeDevice, nativePeer));
+    if (!canAccess) { return; }
+
+    // Peer access is enabled for the current device
+    const int oldDevice = setDevice(device);
+    cudaError_t err     = cudaDeviceEnablePeerAccess(nativePeer, 0);
+    setDevice(oldDevice);
+    if (err == cudaErrorPeerAccessAlreadyEnabled) {
+        // Clears the error of the runtime
+        cudaGetLastError();
+    } else {
+        CUDA_CHECK(err);
+    }
+}
+}  // namespace
+
+template<typename T>
+Array<T> copyToDevice(const Array<T> &in, int device) {
+    const int srcDevice = in.getDevId();
+    const int oldDevice = setDevice(srcDevice);
+    in.eval();
+    if (srcDevice == device) {
+        Array<T> out = copyArray(in);
+        setDevice(oldDevice);
+        return out;
+    }
+
+    enablePeerAccess(device, srcDevice);
+    setDevice(device);
+    Array<T> out = createEmptyArray<T>(in.dims());
+    {
+        setDevice(srcDevice);
+        Array<T> src           = in.isLinear() ? in : copyArray(in);
+        cudaStream_t srcStream = getStream(srcDevice);
+        cudaStream_t dstStream = getStream(device);
+
+        Event ready = makeEvent(srcStream);
+        ready.enqueueWait(dstStream);
+        CUDA_CHECK(cudaMemcpyPeerAsync(
+            out.get(), getDeviceNativeId(device), src.get(),
+            getDeviceNativeId(srcDevice), in.elements() * sizeof(T),
+            dstStream));
+
+        // The buffer of src can be reused by the source stream once it is
+        // freed, so the stream waits for the copy
+        Event done = makeEvent(dstStream);
+        done.enqueueWait(srcStream);
+    }
+    setDevice(oldDevice);
+    return out;
+}
+
+#define INSTANTIATE(T)                                                 \
+    template void copyData<T>(T * dst, const Array<T> &src);           \
+    template Array<T> copyToDevice<T>(const Array<T> &in, int device); \
+    template Array<T> copyArray<T>(const Array<T> &src);               \
+    template void multiply_inplace<T>(Array<T> & in, double norm);     \
+    template void copyToArrayAsync<T>(Array<T> & dst, const T *src,    \
+                                      const size_t bytes,              \
+                                      const size_t offset);            \
+    template void copyFromArrayAsync<T>(T * dst, const Array<T> &src,  \
+                                        const size_t bytes,            \
+                                        const size_t offset);
 
 INSTANTIATE(float)
 INSTANTIATE(double)
@@ -114,6 +248,7 @@ INSTANTIATE(uintl)
 INSTANTIATE(short)
 INSTANTIATE(ushort)
 INSTANTIATE(half)
+INSTANTIATE(bfloat16)
 
 #define INSTANTIATE_COPY_ARRAY(SRC_T)                                 \
     template void copyArray<SRC_T, float>(Array<float> & dst,         \
@@ -164,6 +299,11 @@ INSTANTIATE_COPY_ARRAY(half)
 INSTANTIATE_COPY_ARRAY_COMPLEX(cfloat)
 INSTANTIATE_COPY_ARRAY_COMPLEX(cdouble)
 
+// The bfloat16 arrays are only copied to bfloat16 arrays. The other types are
+// converted with cast.
+template void copyArray<bfloat16, bfloat16>(Array<bfloat16> &dst,
+                                            Array<bfloat16> const &src);
+
 template<typename T>
 T getScalar(const Array<T> &in) {
     T retVal{};
@@ -189,5 +329,6 @@ INSTANTIATE_GETSCALAR(uintl)
 INSTANTIATE_GETSCALAR(short)
 INSTANTIATE_GETSCALAR(ushort)
 INSTANTIATE_GETSCALAR(half)
+INSTANTIATE_GETSCALAR(bfloat16)
 
 }  // namespace cuda
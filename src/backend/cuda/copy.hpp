@@ -28,6 +28,42 @@ void copyData(T *dst, const Array<T> &src);
 template<typename T>
 Array<T> copyArray(const Array<T> &src);
 
+// Creates a copy of \p in on \p device. The data is copied between the
+// devices directly, with peer access enabled when the devices support it.
+// The copy is ordered after the work on the stream of the source device,
+// and the active device is not changed.
+//
+// \param   in      The source Array<T> object on any device
+// \param   device  The ArrayFire id of the destination device
+// \returns         A linear copy of \p in on \p device
+template<typename T>
+Array<T> copyToDevice(const Array<T> &in, int device);
+
+// Enqueues a copy of host memory to an Array<T> object on the active stream.
+// The copy does not block the calling thread, so \p src must not be changed
+// or freed until the stream completes the copy.
+//
+// \param dst    The destination array. The data is written to the buffer of
+//               the array without its strides.
+// \param src    The source pointer on the host system
+// \param bytes  The number of bytes to copy
+// \param offset The byte offset in the buffer of \p dst
+template<typename T>
+void copyToArrayAsync(Array<T> &dst, const T *src, const size_t bytes,
+                      const size_t offset);
+
+// Enqueues a copy of the data of a linear Array<T> object to host memory on
+// the active stream. The host memory is written when the stream completes
+// the copy.
+//
+// \param dst    The destination pointer on the host system
+// \param src    The source array. It has to be linear.
+// \param bytes  The number of bytes to copy
+// \param offset The byte offset in the data of \p src
+template<typename T>
+void copyFromArrayAsync(T *dst, const Array<T> &src, const size_t bytes,
+                        const size_t offset);
+
 template<typename inType, typename outType>
 void copyArray(Array<outType> &out, const Array<inType> &in);
 
@@ -9,7 +9,9 @@
 
 #pragma once
 
+#include <common/bfloat16.hpp>
 #include <common/half.hpp>
+#include <cuda.h>
 #include <library_types.h>  // cudaDataType enum
 #include <types.hpp>
 
@@ -43,6 +45,13 @@ inline cudaDataType_t getType<common::half>() {
     return CUDA_R_16F;
 }
 
+#if CUDA_VERSION >= 11000
+template<>
+inline cudaDataType_t getType<common::bfloat16>() {
+    return CUDA_R_16BF;
+}
+#endif
+
 template<typename T>
 inline cudaDataType_t getComputeType() {
     return getType<T>();
@@ -187,6 +187,12 @@ cudnnStatus_t cudnnGetConvolutionBackwardFilterAlgorithmMaxCount(
         handle, count);
 }
 
+cudnnStatus_t cudnnGetConvolutionBackwardDataAlgorithmMaxCount(
+    cudnnHandle_t handle, int *count) {
+    return getCudnnPlugin().cudnnGetConvolutionBackwardDataAlgorithmMaxCount(
+        handle, count);
+}
+
 cudnnStatus_t cudnnGetConvolutionForwardWorkspaceSize(
     cudnnHandle_t handle, const cudnnTensorDescriptor_t xDesc,
     const cudnnFilterDescriptor_t wDesc,
@@ -229,6 +235,17 @@ cudnnStatus_t cudnnFindConvolutionBackwardFilterAlgorithm(
         returnedAlgoCount, perfResults);
 }
 
+cudnnStatus_t cudnnFindConvolutionBackwardDataAlgorithm(
+    cudnnHandle_t handle, const cudnnFilterDescriptor_t wDesc,
+    const cudnnTensorDescriptor_t dyDesc,
+    const cudnnConvolutionDescriptor_t convDesc,
+    const cudnnTensorDescriptor_t dxDesc, const int requestedAlgoCount,
+    int *returnedAlgoCount, cudnnConvolutionBwdDataAlgoPerf_t *perfResults) {
+    return getCudnnPlugin().cudnnFindConvolutionBackwardDataAlgorithm(
+        handle, wDesc, dyDesc, convDesc, dxDesc, requestedAlgoCount,
+        returnedAlgoCount, perfResults);
+}
+
 cudnnStatus_t cudnnGetConvolutionForwardAlgorithm(
     cudnnHandle_t handle, const cudnnTensorDescriptor_t xDesc,
     const cudnnFilterDescriptor_t wDesc,
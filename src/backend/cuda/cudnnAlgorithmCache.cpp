@@ -0,0 +1,175 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <cudnnAlgorithmCache.hpp>
+
+#include <common/MemoryManagerBase.hpp>
+#include <common/defines.hpp>
+#include <common/util.hpp>
+#include <cudnnModule.hpp>
+#include <device_manager.hpp>
+#include <err_cuda.hpp>
+#include <platform.hpp>
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+using af::dim4;
+using std::get;
+using std::ifstream;
+using std::lock_guard;
+using std::mutex;
+using std::ofstream;
+using std::once_flag;
+using std::ostringstream;
+using std::string;
+using std::to_string;
+using std::unordered_map;
+
+namespace cuda {
+
+namespace {
+
+using AlgorithmMap = unordered_map<string, ConvolutionAlgorithm>;
+
+/// The algorithms are shared by the threads which use the same device
+struct AlgorithmCache {
+    mutex lock;
+    AlgorithmMap algorithms[DeviceManager::MAX_DEVICES];
+    once_flag loadFlags[DeviceManager::MAX_DEVICES];
+};
+
+AlgorithmCache &algorithmCache() {
+    static auto *cache = new AlgorithmCache();
+    return *cache;
+}
+
+bool persistAlgorithms() {
+    static const bool persist =
+        getEnvVar("AF_CUDA_CUDNN_ALGORITHM_CACHE") == "1";
+    return persist;
+}
+
+/// The selected algorithms depend on the device and the cuDNN library, so
+/// each pair is saved in its own file
+string algorithmFilePath(int device) {
+    const string &directory = getCacheDirectory();
+    if (directory.empty()) { return string(); }
+
+    auto version    = getCudnnPlugin().getVersion();
+    const string id = string(getDeviceProp(device).name) + ":" +
+                      to_string(get<0>(version)) + "." +
+                      to_string(get<1>(version)) + "." +
+                      to_string(get<2>(version));
+    return directory + AF_PATH_SEPARATOR + "cudnn_algorithms_" +
+           to_string(deterministicHash(id)) + ".txt";
+}
+
+/// Reads the algorithms saved by earlier runs. The file is appended to, so
+/// the later lines of a key replace the earlier ones.
+void loadAlgorithms(int device, AlgorithmMap &algorithms) {
+    if (!persistAlgorithms()) { return; }
+    const string path = algorithmFilePath(device);
+    if (path.empty()) { return; }
+
+    ifstream file(path);
+    string key;
+    ConvolutionAlgorithm algorithm{};
+    while (file >> key >> algorithm.algo >> algorithm.workspaceBytes) {
+        algorithms[key] = algorithm;
+    }
+}
+
+void saveAlgorithm(int device, const string &key,
+                   const ConvolutionAlgorithm &algorithm) {
+    if (!persistAlgorithms()) { return; }
+    const string path = algorithmFilePath(device);
+    if (path.empty()) { return; }
+
+    // Each line is written at once so that the concurrent writers of other
+    // processes do not interleave
+    ostringstream line;
+    line << key << " " << algorithm.algo << " " << algorithm.workspaceBytes
+         << "\n";
+    ofstream file(path, std::ios::app);
+    file << line.str() << std::flush;
+}
+
+AlgorithmMap &deviceAlgorithms(int device) {
+    AlgorithmCache &cache = algorithmCache();
+    std::call_once(cache.loadFlags[device], [&] {
+        lock_guard<mutex> lock(cache.lock);
+        loadAlgorithms(device, cache.algorithms[device]);
+    });
+    return cache.algorithms[device];
+}
+
+void appendDims(string &key, const dim4 &dims) {
+    for (int i = 0; i < AF_MAX_DIMS; ++i) { key += to_string(dims[i]) + ","; }
+}
+
+}  // namespace
+
+string convolutionAlgorithmKey(ConvolutionPass pass, cudnnDataType_t dataType,
+                               const dim4 &signalDims, const dim4 &filterDims,
+                               const dim4 &stride, const dim4 &padding,
+                               const dim4 &dilation) {
+    string key = to_string(static_cast<int>(pass)) + ":" +
+                 to_string(static_cast<int>(dataType)) + ":";
+    appendDims(key, signalDims);
+    appendDims(key, filterDims);
+    appendDims(key, stride);
+    appendDims(key, padding);
+    appendDims(key, dilation);
+    return key;
+}
+
+bool findConvolutionAlgorithm(const string &key, size_t workspaceLimit,
+                              ConvolutionAlgorithm &algorithm) {
+    const int device         = static_cast<int>(getActiveDeviceId());
+    AlgorithmMap &algorithms = deviceAlgorithms(device);
+
+    lock_guard<mutex> lock(algorithmCache().lock);
+    auto iter = algorithms.find(key);
+    if (iter == algorithms.end() ||
+        iter->second.workspaceBytes > workspaceLimit) {
+        return false;
+    }
+    algorithm = iter->second;
+    return true;
+}
+
+void cacheConvolutionAlgorithm(const string &key,
+                               const ConvolutionAlgorithm &algorithm) {
+    const int device         = static_cast<int>(getActiveDeviceId());
+    AlgorithmMap &algorithms = deviceAlgorithms(device);
+
+    lock_guard<mutex> lock(algorithmCache().lock);
+    algorithms[key] = algorithm;
+    saveAlgorithm(device, key, algorithm);
+}
+
+size_t getConvolutionWorkspaceLimit() {
+    size_t freeBytes  = 0;
+    size_t totalBytes = 0;
+    CUDA_CHECK(cudaMemGetInfo(&freeBytes, &totalBytes));
+
+    // The memory manager frees its unused buffers when an allocation fails,
+    // so they can hold the workspace too
+    size_t allocBytes = 0, allocBuffers = 0, lockBytes = 0, lockBuffers = 0;
+    memoryManager().usageInfo(&allocBytes, &allocBuffers, &lockBytes,
+                              &lockBuffers);
+    return freeBytes + (allocBytes > lockBytes ? allocBytes - lockBytes : 0);
+}
+
+}  // namespace cuda
@@ -0,0 +1,60 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <cudnn.hpp>
+#include <af/dim4.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace cuda {
+
+/// The passes of a convolution which select their own cuDNN algorithm
+enum class ConvolutionPass { Forward, BackwardData, BackwardFilter };
+
+/// A cuDNN convolution algorithm and the workspace it needs
+struct ConvolutionAlgorithm {
+    int algo;
+    size_t workspaceBytes;
+};
+
+/// Returns the key of the algorithm of a convolution pass. The key contains
+/// everything the tensor, filter and convolution descriptors are created
+/// from.
+std::string convolutionAlgorithmKey(ConvolutionPass pass,
+                                    cudnnDataType_t dataType,
+                                    const af::dim4 &signalDims,
+                                    const af::dim4 &filterDims,
+                                    const af::dim4 &stride,
+                                    const af::dim4 &padding,
+                                    const af::dim4 &dilation);
+
+/// Finds the algorithm of \p key selected earlier on the active device.
+///
+/// Algorithms whose workspace is larger than \p workspaceLimit are not
+/// returned, so they are selected again with the memory that is available.
+///
+/// \returns true if the algorithm was found
+bool findConvolutionAlgorithm(const std::string &key, size_t workspaceLimit,
+                              ConvolutionAlgorithm &algorithm);
+
+/// Caches the algorithm of \p key selected on the active device. The
+/// algorithm is also saved in the cache directory when
+/// AF_CUDA_CUDNN_ALGORITHM_CACHE is set to 1.
+void cacheConvolutionAlgorithm(const std::string &key,
+                               const ConvolutionAlgorithm &algorithm);
+
+/// Returns the largest workspace a convolution algorithm may use on the
+/// active device. This is the free device memory and the memory held but
+/// not used by the memory manager.
+size_t getConvolutionWorkspaceLimit();
+
+}  // namespace cuda
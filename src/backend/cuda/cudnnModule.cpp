@@ -133,10 +133,12 @@ cudnnModule::cudnnModule()
     MODULE_FUNCTION_INIT(cudnnGetConvolutionBackwardDataWorkspaceSize);
     MODULE_FUNCTION_INIT(cudnnGetConvolutionForwardAlgorithmMaxCount);
     MODULE_FUNCTION_INIT(cudnnGetConvolutionBackwardFilterAlgorithmMaxCount);
+    MODULE_FUNCTION_INIT(cudnnGetConvolutionBackwardDataAlgorithmMaxCount);
     MODULE_FUNCTION_INIT(cudnnGetConvolutionForwardWorkspaceSize);
     MODULE_FUNCTION_INIT(cudnnGetConvolutionBackwardFilterWorkspaceSize);
     MODULE_FUNCTION_INIT(cudnnFindConvolutionForwardAlgorithm);
     MODULE_FUNCTION_INIT(cudnnFindConvolutionBackwardFilterAlgorithm);
+    MODULE_FUNCTION_INIT(cudnnFindConvolutionBackwardDataAlgorithm);
     if (major < 8) {
         MODULE_FUNCTION_INIT(cudnnGetConvolutionForwardAlgorithm);
         MODULE_FUNCTION_INIT(cudnnGetConvolutionBackwardFilterAlgorithm);
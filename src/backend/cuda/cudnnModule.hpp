@@ -83,8 +83,10 @@ class cudnnModule {
     MODULE_MEMBER(cudnnGetConvolutionBackwardDataWorkspaceSize);
     MODULE_MEMBER(cudnnGetConvolutionForwardAlgorithmMaxCount);
     MODULE_MEMBER(cudnnGetConvolutionBackwardFilterAlgorithmMaxCount);
+    MODULE_MEMBER(cudnnGetConvolutionBackwardDataAlgorithmMaxCount);
     MODULE_MEMBER(cudnnFindConvolutionForwardAlgorithm);
     MODULE_MEMBER(cudnnFindConvolutionBackwardFilterAlgorithm);
+    MODULE_MEMBER(cudnnFindConvolutionBackwardDataAlgorithm);
     MODULE_MEMBER(cudnnGetConvolutionForwardWorkspaceSize);
     MODULE_MEMBER(cudnnGetConvolutionBackwardFilterWorkspaceSize);
     MODULE_MEMBER(cudnnGetConvolutionForwardAlgorithm);
@@ -114,8 +114,12 @@ SharedPlan findPlan(int rank, int *n, int *inembed, int istride, int idist,
         cufftDestroy(*p);
         free(p);
     });
+    // The workspace of the plan is accounted for by the plan cache
+    size_t workSize = 0;
+    if (cufftGetSize(*retVal, &workSize) != CUFFT_SUCCESS) { workSize = 0; }
+
     // push the plan into plan cache
-    planner.push(key_string, retVal);
+    planner.push(key_string, retVal, workSize);
 
     return retVal;
 }
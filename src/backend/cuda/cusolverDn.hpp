@@ -13,6 +13,8 @@
 #include <cusolverDn.h>
 
 DEFINE_HANDLER(cusolverDnHandle_t, cusolverDnCreate, cusolverDnDestroy);
+DEFINE_HANDLER(gesvdjInfo_t, cusolverDnCreateGesvdjInfo,
+               cusolverDnDestroyGesvdjInfo);
 
 namespace cuda {
 
@@ -11,6 +11,7 @@
 #include <windows.h>
 #endif
 
+#include <AsyncMemoryManager.hpp>
 #include <GraphicsResourceManager.hpp>
 #include <common/DefaultMemoryManager.hpp>
 #include <common/Logger.hpp>
@@ -348,6 +349,21 @@ DeviceManager &DeviceManager::getInstance() {
     return *my_instance;
 }
 
+std::unique_ptr<MemoryManagerBase> DeviceManager::createMemoryManager() {
+    if (isAsyncMemoryManagerRequested()) {
+        if (isAsyncMemoryManagerSupported()) {
+            AF_TRACE("Using the stream ordered memory manager");
+            return std::make_unique<AsyncMemoryManager>(getDeviceCount());
+        }
+        AF_TRACE(
+            "The stream ordered memory manager is not supported. Using the "
+            "default memory manager");
+    }
+    return std::make_unique<common::DefaultMemoryManager>(
+        getDeviceCount(), common::MAX_BUFFERS,
+        AF_MEM_DEBUG || AF_CUDA_MEM_DEBUG);
+}
+
 void DeviceManager::setMemoryManager(
     std::unique_ptr<MemoryManagerBase> newMgr) {
     std::lock_guard<std::mutex> l(mutex);
@@ -367,10 +383,7 @@ void DeviceManager::setMemoryManager(
 
 void DeviceManager::resetMemoryManager() {
     // Replace with default memory manager
-    std::unique_ptr<MemoryManagerBase> mgr(
-        new common::DefaultMemoryManager(getDeviceCount(), common::MAX_BUFFERS,
-                                         AF_MEM_DEBUG || AF_CUDA_MEM_DEBUG));
-    setMemoryManager(std::move(mgr));
+    setMemoryManager(createMemoryManager());
 }
 
 void DeviceManager::setMemoryManagerPinned(
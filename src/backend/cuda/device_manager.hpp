@@ -90,7 +90,7 @@ class DeviceManager {
 
     friend int setDevice(int device);
 
-    friend cudaDeviceProp getDeviceProp(int device);
+    friend const cudaDeviceProp &getDeviceProp(int device);
 
     friend std::pair<int, int> getComputeCapability(const int device);
 
@@ -114,6 +114,12 @@ class DeviceManager {
 
     int setActiveDevice(int device, int nId = -1);
 
+    /// Creates the memory manager used when the user has not set one. This is
+    /// the stream ordered memory manager if requested by
+    /// AF_CUDA_MEMORY_MANAGER and supported by the devices. Otherwise it is
+    /// the default memory manager.
+    std::unique_ptr<MemoryManagerBase> createMemoryManager();
+
     std::shared_ptr<spdlog::logger> logger;
 
     std::vector<cudaDevice_t> cuDevices;
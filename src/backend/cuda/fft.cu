@@ -10,6 +10,7 @@
 #include <fft.hpp>
 
 #include <Array.hpp>
+#include <common/FFTLayout.hpp>
 #include <copy.hpp>
 #include <cufft.hpp>
 #include <debug_cuda.hpp>
@@ -20,6 +21,8 @@
 #include <array>
 
 using af::dim4;
+using common::FFTBatch;
+using common::fftEmbed;
 using std::array;
 using std::string;
 
@@ -28,6 +31,10 @@ void setFFTPlanCacheSize(size_t numPlans) {
     fftManager().setMaxCacheSize(numPlans);
 }
 
+void setFFTPlanCacheBytes(size_t bytes) {
+    fftManager().setMaxCacheBytes(bytes);
+}
+
 template<typename T>
 struct cufft_transform;
 
@@ -72,76 +79,100 @@ void fft_inplace(Array<T> &in, const int rank, const bool direction) {
     const dim4 idims    = in.dims();
     const dim4 istrides = in.strides();
 
-    auto t_dims   = computeDims(rank, idims);
-    auto in_embed = computeDims(rank, in.getDataDims());
-
-    int batch = 1;
-    for (int i = rank; i < 4; i++) { batch *= idims[i]; }
-
-    SharedPlan plan =
-        findPlan(rank, t_dims.data(), in_embed.data(), istrides[0],
-                 istrides[rank], in_embed.data(), istrides[0], istrides[rank],
-                 (cufftType)cufft_transform<T>::type, batch);
-
+    array<int, AF_MAX_DIMS> in_embed;
+    if (!fftEmbed(in_embed, rank, idims, istrides)) {
+        // The strides of the transformed dimensions are not multiples of
+        // each other, which the cuFFT layouts can not describe
+        Array<T> packed = copyArray<T>(in);
+        fft_inplace<T>(packed, rank, direction);
+        copyArray<T>(in, packed);
+        return;
+    }
+
+    auto t_dims = computeDims(rank, idims);
+
+    const FFTBatch batch(rank, idims, istrides, istrides);
+    SharedPlan plan = findPlan(
+        rank, t_dims.data(), in_embed.data(), istrides[0], batch.idist(),
+        in_embed.data(), istrides[0], batch.idist(),
+        (cufftType)cufft_transform<T>::type, batch.batch());
+
+    // The batch dimensions which are not packed are iterated with the same
+    // plan
     cufft_transform<T> transform;
     CUFFT_CHECK(cufftSetStream(*plan.get(), cuda::getActiveStream()));
-    CUFFT_CHECK(transform(*plan.get(), (T *)in.get(), in.get(),
-                          direction ? CUFFT_FORWARD : CUFFT_INVERSE));
+    for (dim_t e = 0; e < batch.executions(); e++) {
+        T *ptr = in.get() + batch.inOffset(e);
+        CUFFT_CHECK(transform(*plan.get(), ptr, ptr,
+                              direction ? CUFFT_FORWARD : CUFFT_INVERSE));
+    }
 }
 
 template<typename Tc, typename Tr>
 Array<Tc> fft_r2c(const Array<Tr> &in, const int rank) {
-    dim4 idims = in.dims();
-    dim4 odims = in.dims();
-
-    odims[0] = odims[0] / 2 + 1;
+    const dim4 idims    = in.dims();
+    const dim4 istrides = in.strides();
 
-    Array<Tc> out = createEmptyArray<Tc>(odims);
+    array<int, AF_MAX_DIMS> in_embed;
+    if (!fftEmbed(in_embed, rank, idims, istrides)) {
+        return fft_r2c<Tc, Tr>(copyArray<Tr>(in), rank);
+    }
 
-    auto t_dims    = computeDims(rank, idims);
-    auto in_embed  = computeDims(rank, in.getDataDims());
-    auto out_embed = computeDims(rank, out.getDataDims());
+    dim4 odims = idims;
+    odims[0]   = odims[0] / 2 + 1;
 
-    int batch = 1;
-    for (int i = rank; i < AF_MAX_DIMS; i++) { batch *= idims[i]; }
+    Array<Tc> out       = createEmptyArray<Tc>(odims);
+    const dim4 ostrides = out.strides();
 
-    dim4 istrides = in.strides();
-    dim4 ostrides = out.strides();
+    auto t_dims = computeDims(rank, idims);
+    array<int, AF_MAX_DIMS> out_embed;
+    fftEmbed(out_embed, rank, odims, ostrides);
 
-    SharedPlan plan =
-        findPlan(rank, t_dims.data(), in_embed.data(), istrides[0],
-                 istrides[rank], out_embed.data(), ostrides[0], ostrides[rank],
-                 (cufftType)cufft_real_transform<Tc, Tr>::type, batch);
+    const FFTBatch batch(rank, idims, istrides, ostrides);
+    SharedPlan plan = findPlan(
+        rank, t_dims.data(), in_embed.data(), istrides[0], batch.idist(),
+        out_embed.data(), ostrides[0], batch.odist(),
+        (cufftType)cufft_real_transform<Tc, Tr>::type, batch.batch());
 
     cufft_real_transform<Tc, Tr> transform;
     CUFFT_CHECK(cufftSetStream(*plan.get(), cuda::getActiveStream()));
-    CUFFT_CHECK(transform(*plan.get(), (Tr *)in.get(), out.get()));
+    for (dim_t e = 0; e < batch.executions(); e++) {
+        CUFFT_CHECK(transform(*plan.get(),
+                              const_cast<Tr *>(in.get()) + batch.inOffset(e),
+                              out.get() + batch.outOffset(e)));
+    }
     return out;
 }
 
 template<typename Tr, typename Tc>
 Array<Tr> fft_c2r(const Array<Tc> &in, const dim4 &odims, const int rank) {
-    Array<Tr> out = createEmptyArray<Tr>(odims);
-
-    auto t_dims    = computeDims(rank, odims);
-    auto in_embed  = computeDims(rank, in.getDataDims());
-    auto out_embed = computeDims(rank, out.getDataDims());
+    const dim4 istrides = in.strides();
 
-    int batch = 1;
-    for (int i = rank; i < AF_MAX_DIMS; i++) { batch *= odims[i]; }
+    array<int, AF_MAX_DIMS> in_embed;
+    if (!fftEmbed(in_embed, rank, in.dims(), istrides)) {
+        return fft_c2r<Tr, Tc>(copyArray<Tc>(in), odims, rank);
+    }
 
-    dim4 istrides = in.strides();
-    dim4 ostrides = out.strides();
+    Array<Tr> out       = createEmptyArray<Tr>(odims);
+    const dim4 ostrides = out.strides();
 
-    cufft_real_transform<Tr, Tc> transform;
+    auto t_dims = computeDims(rank, odims);
+    array<int, AF_MAX_DIMS> out_embed;
+    fftEmbed(out_embed, rank, odims, ostrides);
 
-    SharedPlan plan =
-        findPlan(rank, t_dims.data(), in_embed.data(), istrides[0],
-                 istrides[rank], out_embed.data(), ostrides[0], ostrides[rank],
-                 (cufftType)cufft_real_transform<Tr, Tc>::type, batch);
+    const FFTBatch batch(rank, odims, istrides, ostrides);
+    SharedPlan plan = findPlan(
+        rank, t_dims.data(), in_embed.data(), istrides[0], batch.idist(),
+        out_embed.data(), ostrides[0], batch.odist(),
+        (cufftType)cufft_real_transform<Tr, Tc>::type, batch.batch());
 
+    cufft_real_transform<Tr, Tc> transform;
     CUFFT_CHECK(cufftSetStream(*plan.get(), cuda::getActiveStream()));
-    CUFFT_CHECK(transform(*plan.get(), (Tc *)in.get(), out.get()));
+    for (dim_t e = 0; e < batch.executions(); e++) {
+        CUFFT_CHECK(transform(*plan.get(),
+                              const_cast<Tc *>(in.get()) + batch.inOffset(e),
+                              out.get() + batch.outOffset(e)));
+    }
     return out;
 }
 
@@ -18,11 +18,11 @@ namespace cuda {
 
 template<typename T>
 void copy_histogram(const Array<T> &data, fg_histogram hist) {
-    auto stream = cuda::getActiveStream();
+    const T *d_P                     = data.get();
+    GraphicsResourceManager &interop = interopManager();
+    cudaStream_t stream              = interop.beginCopy();
     if (DeviceManager::checkGraphicsInteropCapability()) {
-        const T *d_P = data.get();
-
-        auto res = interopManager().getHistogramResources(hist);
+        auto res = interop.getHistogramResources(hist);
 
         size_t bytes = 0;
         T *d_vbo     = NULL;
@@ -46,7 +46,7 @@ void copy_histogram(const Array<T> &data, fg_histogram hist) {
         auto *ptr =
             static_cast<GLubyte *>(glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY));
         if (ptr) {
-            CUDA_CHECK(cudaMemcpyAsync(ptr, data.get(), bytes,
+            CUDA_CHECK(cudaMemcpyAsync(ptr, d_P, bytes,
                                        cudaMemcpyDeviceToHost, stream));
             CUDA_CHECK(cudaStreamSynchronize(stream));
             glUnmapBuffer(GL_ARRAY_BUFFER);
@@ -54,6 +54,7 @@ void copy_histogram(const Array<T> &data, fg_histogram hist) {
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         CheckGL("End CUDA fallback-resource copy");
     }
+    interop.endCopy({data.getData()});
 }
 
 #define INSTANTIATE(T) \
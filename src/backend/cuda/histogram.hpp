@@ -14,4 +14,14 @@ template<typename T>
 Array<uint> histogram(const Array<T> &in, const unsigned &nbins,
                       const double &minval, const double &maxval,
                       const bool isLinear);
+
+/// The \p xbins x \p ybins joint histogram of the pairs of values of \p x
+/// and \p y, which sums the \p weights of the pairs when To is float and
+/// counts them when To is uint, in which case \p weights is not read
+template<typename T, typename To>
+Array<To> histogram2(const Array<T> &x, const Array<T> &y,
+                     const Array<float> &weights, const unsigned &xbins,
+                     const unsigned &ybins, const double &xmin,
+                     const double &xmax, const double &ymin,
+                     const double &ymax);
 }
@@ -10,20 +10,41 @@
 #include <kernel/identity.hpp>
 
 #include <Array.hpp>
+#include <common/complex.hpp>
 #include <common/half.hpp>
+#include <common/jit/IndexNode.hpp>
 #include <debug_cuda.hpp>
 #include <af/dim4.hpp>
 
+#include <memory>
+
 using common::half;
 
 namespace cuda {
+namespace {
+
+// The JIT does not convert the comparison of the indices to complex values
 template<typename T>
-Array<T> identity(const dim4& dims) {
+common::if_complex<T, Array<T>> identityArray(const dim4& dims) {
     Array<T> out = createEmptyArray<T>(dims);
     kernel::identity<T>(out);
     return out;
 }
 
+template<typename T>
+common::if_real<T, Array<T>> identityArray(const dim4& dims) {
+    return createNodeArray<T>(
+        dims, std::make_shared<common::IndexNode<T>>(
+                  common::IndexParams(common::IndexKind::Identity, dims)));
+}
+
+}  // namespace
+
+template<typename T>
+Array<T> identity(const dim4& dims) {
+    return identityArray<T>(dims);
+}
+
 #define INSTANTIATE_IDENTITY(T) \
     template Array<T> identity<T>(const af::dim4& dims);
 
@@ -23,11 +23,12 @@ namespace cuda {
 
 template<typename T>
 void copy_image(const Array<T> &in, fg_image image) {
-    auto stream = cuda::getActiveStream();
+    const T *d_X                     = in.get();
+    GraphicsResourceManager &interop = interopManager();
+    cudaStream_t stream              = interop.beginCopy();
     if (DeviceManager::checkGraphicsInteropCapability()) {
-        auto res = interopManager().getImageResources(image);
+        auto res = interop.getImageResources(image);
 
-        const T *d_X = in.get();
         size_t bytes = 0;
         T *d_pixels  = NULL;
         cudaGraphicsMapResources(1, res[0].get(), stream);
@@ -50,7 +51,7 @@ void copy_image(const Array<T> &in, fg_image image) {
         auto *ptr = static_cast<GLubyte *>(
             glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
         if (ptr) {
-            CUDA_CHECK(cudaMemcpyAsync(ptr, in.get(), data_size,
+            CUDA_CHECK(cudaMemcpyAsync(ptr, d_X, data_size,
                                        cudaMemcpyDeviceToHost, stream));
             CUDA_CHECK(cudaStreamSynchronize(stream));
             glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
@@ -58,6 +59,7 @@ void copy_image(const Array<T> &in, fg_image image) {
         glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
         CheckGL("End CUDA fallback-resource copy");
     }
+    interop.endCopy({in.getData()});
 }
 
 #define INSTANTIATE(T) template void copy_image<T>(const Array<T> &, fg_image);
@@ -9,10 +9,11 @@
 
 #include <Array.hpp>
 #include <common/half.hpp>
+#include <common/jit/IndexNode.hpp>
 #include <err_cuda.hpp>
 #include <iota.hpp>
-#include <kernel/iota.hpp>
 #include <math.hpp>
+#include <memory>
 #include <stdexcept>
 
 using common::half;
@@ -22,10 +23,9 @@ template<typename T>
 Array<T> iota(const dim4 &dims, const dim4 &tile_dims) {
     dim4 outdims = dims * tile_dims;
 
-    Array<T> out = createEmptyArray<T>(outdims);
-    kernel::iota<T>(out, dims);
-
-    return out;
+    return createNodeArray<T>(
+        outdims, std::make_shared<common::IndexNode<T>>(common::IndexParams(
+                     common::IndexKind::Iota, outdims, 0, dims)));
 }
 
 #define INSTANTIATE(T) \
@@ -9,8 +9,11 @@
 
 #include <Array.hpp>
 #include <Kernel.hpp>
+#include <common/Profiler.hpp>
+#include <common/bfloat16.hpp>
 #include <common/dispatch.hpp>
 #include <common/half.hpp>
+#include <common/jit/JitStats.hpp>
 #include <common/jit/Node.hpp>
 #include <common/kernel_cache.hpp>
 #include <common/util.hpp>
@@ -18,22 +21,30 @@
 #include <debug_cuda.hpp>
 #include <device_manager.hpp>
 #include <err_cuda.hpp>
+#include <jit/BufferNode.hpp>
 #include <kernel_headers/jit_cuh.hpp>
 #include <math.hpp>
 #include <platform.hpp>
+#include <profiled_launch.hpp>
+#include <type_util.hpp>
 #include <af/dim4.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdio>
 #include <stdexcept>
 #include <string>
 #include <thread>
 #include <vector>
 
+using common::bfloat16;
 using common::findModule;
 using common::getFuncName;
+using common::getTreeString;
 using common::half;
 using common::Node;
 using common::Node_ids;
+using common::Node_hash_map_t;
 using common::Node_map_t;
 
 using std::string;
@@ -43,10 +54,9 @@ using std::vector;
 
 namespace cuda {
 
-static string getKernelString(const string &funcName,
-                              const vector<Node *> &full_nodes,
-                              const vector<Node_ids> &full_ids,
-                              const vector<int> &output_ids, bool is_linear) {
+/// Returns the typedefs, the headers and the Param struct used by the JIT
+/// kernels
+static string getKernelPrelude() {
     const std::string includeFileStr(jit_cuh, jit_cuh_len);
 
     const std::string paramTStr = R"JIT(
@@ -56,6 +66,11 @@ struct Param {
     dim_t strides[4];
     T *ptr;
 };
+
+template<typename T, int N>
+struct alignas(sizeof(T) * N < 16 ? sizeof(T) * N : 16) JitVec {
+    T v[N];
+};
 )JIT";
 
     std::string typedefStr = "typedef unsigned int uint;\n";
@@ -63,6 +78,56 @@ struct Param {
     typedefStr += getFullName<dim_t>();
     typedefStr += " dim_t;\n";
 
+    return typedefStr + includeFileStr + "\n\n" + paramTStr + "\n";
+}
+
+/// The number of consecutive elements read and written by a thread of the
+/// vectorized linear kernels
+static constexpr int vecWidth = 4;
+
+/// Returns true if \p ptr is aligned like the vectors of vecWidth elements
+/// of \p bytes each, whose alignment is set by JitVec
+static bool isVecAligned(const void *ptr, const size_t bytes) {
+    const size_t alignment = std::min<size_t>(16, vecWidth * bytes);
+    return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+template<typename T>
+static bool isBufferVecAligned(const Node &node) {
+    const auto &buffer = static_cast<const jit::BufferNode<T> &>(node);
+    return isVecAligned(buffer.getParam().ptr, sizeof(T));
+}
+
+/// Returns true if the buffer \p node can be read with vector loads
+static bool isBufferVecAligned(const Node &node) {
+    switch (node.getType()) {
+        case f32: return isBufferVecAligned<float>(node);
+        case f64: return isBufferVecAligned<double>(node);
+        case c32: return isBufferVecAligned<cfloat>(node);
+        case c64: return isBufferVecAligned<cdouble>(node);
+        case s32: return isBufferVecAligned<int>(node);
+        case u32: return isBufferVecAligned<uint>(node);
+        case b8: return isBufferVecAligned<char>(node);
+        case u8: return isBufferVecAligned<uchar>(node);
+        case s64: return isBufferVecAligned<intl>(node);
+        case u64: return isBufferVecAligned<uintl>(node);
+        case s16: return isBufferVecAligned<short>(node);
+        case u16: return isBufferVecAligned<ushort>(node);
+        case f16: return isBufferVecAligned<half>(node);
+        case bf16: return isBufferVecAligned<bfloat16>(node);
+        default: return false;
+    }
+}
+
+/// Generates the kernel of the trees. If \p vectorize is set, the linear
+/// kernel reads and writes vecWidth consecutive elements per thread with
+/// vector loads and stores, and the elements after the last full vector
+/// are computed one at a time.
+static string getKernelString(const string &funcName,
+                              const vector<Node *> &full_nodes,
+                              const vector<Node_ids> &full_ids,
+                              const vector<int> &output_ids, bool is_linear,
+                              bool vectorize) {
     // Common CUDA code
     // This part of the code does not change with the kernel.
 
@@ -136,21 +201,57 @@ struct Param {
     }
 
     outrefstream << "const Param<" << full_nodes[output_ids[0]]->getTypeStr()
-                 << "> &outref = out" << output_ids[0] << ";\n";
+                 << "> &outref = out0;\n";
 
-    for (int id : output_ids) {
+    // The outputs are named by their index because equal outputs are merged
+    // into the same node
+    for (int k = 0; k < static_cast<int>(output_ids.size()); k++) {
+        const int id = output_ids[k];
         // Generate output parameters
         outParamStream << "Param<" << full_nodes[id]->getTypeStr() << "> out"
-                       << id << ", \n";
+                       << k << ", \n";
         // Generate code to write the output
-        outWriteStream << "out" << id << ".ptr[idx] = val" << id << ";\n";
+        outWriteStream << "out" << k << ".ptr[idx] = val" << id << ";\n";
+    }
+
+    // The buffers are read into vectors before the loop over the elements
+    // of the vectors, which reads their values from the vectors. The values
+    // of the outputs are collected into vectors stored after the loop.
+    stringstream vecLoadStream;
+    stringstream vecOpsStream;
+    stringstream vecStoreStream;
+    if (vectorize) {
+        for (int i = 0; i < static_cast<int>(full_nodes.size()); i++) {
+            const auto &node   = full_nodes[i];
+            const int id       = full_ids[i].id;
+            const string type  = node->getTypeStr();
+            const string vtype = "JitVec<" + type + ", " +
+                                 to_string(vecWidth) + ">";
+            if (node->isBuffer()) {
+                vecLoadStream << "const " << vtype << " vin" << id
+                              << " = *reinterpret_cast<const " << vtype
+                              << " *>(in" << id << "_ptr + base);\n";
+                vecOpsStream << type << " val" << id << " = vin" << id
+                             << ".v[k];\n";
+            } else {
+                node->genOffsets(vecOpsStream, id, true);
+                node->genFuncs(vecOpsStream, full_ids[i]);
+            }
+        }
+        for (int k = 0; k < static_cast<int>(output_ids.size()); k++) {
+            const int id       = output_ids[k];
+            const string vtype = "JitVec<" + full_nodes[id]->getTypeStr() +
+                                 ", " + to_string(vecWidth) + ">";
+            vecLoadStream << vtype << " vout" << k << ";\n";
+            vecOpsStream << "vout" << k << ".v[k] = val" << id << ";\n";
+            vecStoreStream << "*reinterpret_cast<" << vtype << " *>(out" << k
+                           << ".ptr + base) = vout" << k << ";\n";
+        }
     }
 
     // Put various blocks into a single stream
     stringstream kerStream;
-    kerStream << typedefStr;
-    kerStream << includeFileStr << "\n\n";
-    kerStream << paramTStr << "\n";
+    kerStream << getKernelPrelude();
     kerStream << kernelVoid;
     kerStream << funcName;
     kerStream << "(\n";
@@ -161,27 +262,126 @@ struct Param {
     kerStream << blockStart;
     kerStream << outrefstream.str();
     kerStream << loopStart;
-    if (is_linear) {
-        kerStream << linearIndex;
+    if (vectorize) {
+        kerStream << "uint threadId = threadIdx.x;\n"
+                  << "long long base = ((long long)blockIdx_x * blockDim.x * "
+                  << "blockDim.y + threadId) * " << vecWidth << ";\n"
+                  << "long long elements = outref.dims[3] * "
+                  << "outref.strides[3];\n"
+                  << "if (base >= elements) return;\n";
+        kerStream << "if (base + " << vecWidth << " <= elements) {\n";
+        kerStream << vecLoadStream.str();
+        kerStream << "#pragma unroll\n";
+        kerStream << "for (int k = 0; k < " << vecWidth << "; ++k) {\n";
+        kerStream << "long long idx = base + k;\n";
+        kerStream << vecOpsStream.str();
+        kerStream << "}\n";
+        kerStream << vecStoreStream.str();
+        kerStream << "} else {\n";
+        kerStream << "for (long long idx = base; idx < elements; ++idx) {\n";
+        kerStream << offsetsStream.str();
+        kerStream << opsStream.str();
+        kerStream << outWriteStream.str();
+        kerStream << "}\n}\n";
     } else {
-        kerStream << generalIndex;
+        if (is_linear) {
+            kerStream << linearIndex;
+        } else {
+            kerStream << generalIndex;
+        }
+        kerStream << offsetsStream.str();
+        kerStream << opsStream.str();
+        kerStream << outWriteStream.str();
     }
-    kerStream << offsetsStream.str();
-    kerStream << opsStream.str();
-    kerStream << outWriteStream.str();
     kerStream << loopEnd;
     kerStream << blockEnd;
 
     return kerStream.str();
 }
 
-static CUfunction getKernel(const vector<Node *> &output_nodes,
-                            const vector<int> &output_ids,
-                            const vector<Node *> &full_nodes,
-                            const vector<Node_ids> &full_ids,
-                            const bool is_linear) {
+/// Generates a kernel which evaluates several linear trees with different
+/// numbers of elements. The threads are split between the trees by the ends
+/// of their ranges of indices, which are passed after each output.
+static string getBatchKernelString(const string &funcName,
+                                   const vector<Node *> &full_nodes,
+                                   const vector<Node_ids> &full_ids,
+                                   const vector<int> &output_ids,
+                                   const vector<vector<int>> &tree_ids) {
+    stringstream inParamStream;
+    stringstream outParamStream;
+    stringstream treesStream;
+
+    for (int i = 0; i < static_cast<int>(full_nodes.size()); i++) {
+        full_nodes[i]->genParams(inParamStream, full_ids[i].id, true);
+    }
+
+    for (int k = 0; k < static_cast<int>(output_ids.size()); k++) {
+        const int id = output_ids[k];
+        outParamStream << "Param<" << full_nodes[id]->getTypeStr() << "> out"
+                       << k << ", int end" << k << ",\n";
+
+        // Each tree only generates the code of its own nodes
+        treesStream << (k == 0 ? "if" : "else if") << " (gidx < end" << k
+                    << ") {\n";
+        treesStream << "long long idx = gidx";
+        if (k > 0) { treesStream << " - end" << k - 1; }
+        treesStream << ";\n";
+        for (int i : tree_ids[k]) {
+            full_nodes[i]->genOffsets(treesStream, full_ids[i].id, true);
+        }
+        for (int i : tree_ids[k]) {
+            full_nodes[i]->genFuncs(treesStream, full_ids[i]);
+        }
+        treesStream << "out" << k << ".ptr[idx] = val" << id << ";\n}\n";
+    }
+
+    stringstream kerStream;
+    kerStream << getKernelPrelude();
+    kerStream << "extern \"C\" __global__ void\n";
+    kerStream << funcName;
+    kerStream << "(\n";
+    kerStream << inParamStream.str();
+    kerStream << outParamStream.str();
+    kerStream << "uint blocks_x_total)\n{\n";
+    kerStream << R"JIT(
+    for (int blockIdx_x = blockIdx.x; blockIdx_x < blocks_x_total;
+         blockIdx_x += gridDim.x) {
+        long long gidx = (long long)blockIdx_x * blockDim.x + threadIdx.x;
+    )JIT";
+    kerStream << treesStream.str();
+    kerStream << "}\n}\n";
+
+    return kerStream.str();
+}
+
+static Kernel getBatchKernel(const vector<Node *> &output_nodes,
+                             const vector<int> &output_ids,
+                             const vector<Node *> &full_nodes,
+                             const vector<Node_ids> &full_ids,
+                             const vector<vector<int>> &tree_ids) {
+    const string funcName  = "B" + getFuncName(output_nodes, full_ids, true);
+    const string moduleKey = to_string(deterministicHash(funcName));
+
+    auto entry = findModule(getActiveDeviceId(), moduleKey);
+
+    if (entry.get() == nullptr) {
+        const string jitKer = getBatchKernelString(
+            funcName, full_nodes, full_ids, output_ids, tree_ids);
+        saveKernel(funcName, jitKer, ".cu");
+
+        return common::getKernel(funcName, {jitKer}, {}, {}, true);
+    }
+    common::recordKernelCacheLookup(getActiveDeviceId(), true);
+    return common::getKernel(entry, funcName, true);
+}
+
+static Kernel getKernel(const vector<Node *> &output_nodes,
+                        const vector<int> &output_ids,
+                        const vector<Node *> &full_nodes,
+                        const vector<Node_ids> &full_ids,
+                        const bool is_linear, const bool vectorize) {
     const string funcName =
-        getFuncName(output_nodes, full_nodes, full_ids, is_linear);
+        (vectorize ? "V" : "") + getFuncName(output_nodes, full_ids, is_linear);
     const string moduleKey = to_string(deterministicHash(funcName));
 
     // A forward lookup in module cache helps avoid recompiling the jit
@@ -191,16 +391,21 @@ static CUfunction getKernel(const vector<Node *> &output_nodes,
 
     if (entry.get() == nullptr) {
         const string jitKer = getKernelString(funcName, full_nodes, full_ids,
-                                              output_ids, is_linear);
-        saveKernel(funcName, jitKer, ".cu");
-
-        return common::getKernel(funcName, {jitKer}, {}, {}, true).get();
+                                              output_ids, is_linear,
+                                              vectorize);
+        // The saved kernel starts with the description of the tree
+        const string tree =
+            getTreeString(output_nodes, full_nodes, full_ids, is_linear);
+        saveKernel(funcName, "// " + tree + "\n" + jitKer, ".cu");
+
+        return common::getKernel(funcName, {jitKer}, {}, {}, true);
     }
-    return common::getKernel(entry, funcName, true).get();
+    common::recordKernelCacheLookup(getActiveDeviceId(), true);
+    return common::getKernel(entry, funcName, true);
 }
 
-template<typename T>
-void evalNodes(vector<Param<T>> &outputs, const vector<Node *> &output_nodes) {
+void evalNodes(vector<Param<void>> &outputs,
+               const vector<Node *> &output_nodes) {
     size_t num_outputs = outputs.size();
     int device         = getActiveDeviceId();
 
@@ -208,6 +413,7 @@ void evalNodes(vector<Param<T>> &outputs, const vector<Node *> &output_nodes) {
 
     // Use thread local to reuse the memory every time you are here.
     thread_local Node_map_t nodes;
+    thread_local Node_hash_map_t hashes;
     thread_local vector<Node *> full_nodes;
     thread_local vector<Node_ids> full_ids;
     thread_local vector<int> output_ids;
@@ -215,31 +421,47 @@ void evalNodes(vector<Param<T>> &outputs, const vector<Node *> &output_nodes) {
     // Reserve some space to improve performance at smaller sizes
     if (nodes.empty()) {
         nodes.reserve(1024);
+        hashes.reserve(1024);
         output_ids.reserve(output_nodes.size());
         full_nodes.reserve(1024);
         full_ids.reserve(1024);
     }
 
     for (auto &node : output_nodes) {
-        int id = node->getNodesMap(nodes, full_nodes, full_ids);
+        int id = node->getNodesMap(nodes, full_nodes, full_ids, hashes);
         output_ids.push_back(id);
     }
+    common::recordJitEval(device);
+    common::recordJitFusion(device, full_nodes.size());
 
     bool is_linear = true;
     for (auto node : full_nodes) {
         is_linear &= node->isLinear(outputs[0].dims);
     }
 
-    CUfunction ker =
-        getKernel(output_nodes, output_ids, full_nodes, full_ids, is_linear);
+    // The linear kernels use vector loads and stores when all the buffers
+    // and the outputs are aligned to the vectors
+    bool vectorize = is_linear;
+    for (auto node : full_nodes) {
+        if (!vectorize) { break; }
+        if (node->isBuffer()) { vectorize = isBufferVecAligned(*node); }
+    }
+    for (size_t i = 0; vectorize && i < num_outputs; i++) {
+        vectorize = isVecAligned(outputs[i].ptr,
+                                 size_of(output_nodes[i]->getType()));
+    }
+
+    Kernel kernel = getKernel(output_nodes, output_ids, full_nodes, full_ids,
+                              is_linear, vectorize);
+    CUfunction ker = kernel.get();
 
     int threads_x = 1, threads_y = 1;
     int blocks_x_ = 1, blocks_y_ = 1;
     int blocks_x = 1, blocks_y = 1, blocks_z = 1, blocks_x_total;
 
-    cudaDeviceProp properties    = getDeviceProp(device);
-    const long long max_blocks_x = properties.maxGridSize[0];
-    const long long max_blocks_y = properties.maxGridSize[1];
+    const cudaDeviceProp &properties = getDeviceProp(device);
+    const long long max_blocks_x     = properties.maxGridSize[0];
+    const long long max_blocks_y     = properties.maxGridSize[1];
 
     int num_odims = 4;
     while (num_odims >= 1) {
@@ -254,9 +476,10 @@ void evalNodes(vector<Param<T>> &outputs, const vector<Node *> &output_nodes) {
         threads_x = 256;
         threads_y = 1;
 
-        blocks_x_total = divup((outputs[0].dims[0] * outputs[0].dims[1] *
-                                outputs[0].dims[2] * outputs[0].dims[3]),
-                               threads_x);
+        const dim_t elements = outputs[0].dims[0] * outputs[0].dims[1] *
+                               outputs[0].dims[2] * outputs[0].dims[3];
+        blocks_x_total =
+            divup(vectorize ? divup(elements, vecWidth) : elements, threads_x);
 
         int repeat_x = divup(blocks_x_total, max_blocks_x);
         blocks_x     = divup(blocks_x_total, repeat_x);
@@ -296,17 +519,98 @@ void evalNodes(vector<Param<T>> &outputs, const vector<Node *> &output_nodes) {
     args.push_back(static_cast<void *>(&blocks_x_total));
     args.push_back(static_cast<void *>(&num_odims));
 
+    CUstream stream = getActiveStream();
+    CUevent start   = beginProfiledLaunch(stream);
     CU_CHECK(cuLaunchKernel(ker, blocks_x, blocks_y, blocks_z, threads_x,
-                            threads_y, 1, 0, getActiveStream(), args.data(),
-                            NULL));
+                            threads_y, 1, 0, stream, args.data(), NULL));
+    if (start) {
+        endProfiledLaunch(start, stream, common::getProfiledName(ker),
+                          common::getProfiledName(kernel.getModuleHandle()));
+    }
 
     // Reset the thread local vectors
     nodes.clear();
+    hashes.clear();
     output_ids.clear();
     full_nodes.clear();
     full_ids.clear();
 }
 
+template<typename T>
+void evalNodes(vector<Param<T>> &outputs, const vector<Node *> &output_nodes) {
+    vector<Param<void>> params;
+    params.reserve(outputs.size());
+    for (auto &output : outputs) {
+        params.emplace_back(output.ptr, output.dims, output.strides);
+    }
+    evalNodes(params, output_nodes);
+}
+
+template<typename T>
+void evalNodesBatched(vector<Param<T>> &outputs,
+                      const vector<Node *> &output_nodes) {
+    if (outputs.empty()) { return; }
+    const int device = getActiveDeviceId();
+
+    Node_map_t nodes;
+    Node_hash_map_t hashes;
+    vector<Node *> full_nodes;
+    vector<Node_ids> full_ids;
+    vector<int> output_ids;
+    vector<vector<int>> tree_ids;
+
+    for (auto &node : output_nodes) {
+        output_ids.push_back(
+            node->getNodesMap(nodes, full_nodes, full_ids, hashes));
+    }
+    for (auto &node : output_nodes) {
+        tree_ids.push_back(common::getTreeIds(node, nodes));
+    }
+    common::recordJitEval(device);
+    common::recordJitFusion(device, full_nodes.size());
+
+    Kernel kernel = getBatchKernel(output_nodes, output_ids, full_nodes,
+                                   full_ids, tree_ids);
+    CUfunction ker = kernel.get();
+
+    // The end of the range of indices of each output
+    vector<int> ends;
+    int elements = 0;
+    for (const auto &out : outputs) {
+        elements += static_cast<int>(out.dims[0] * out.dims[1] *
+                                     out.dims[2] * out.dims[3]);
+        ends.push_back(elements);
+    }
+
+    const int threads_x        = 256;
+    const long long max_blocks = getDeviceProp(device).maxGridSize[0];
+    int blocks_x_total         = divup(elements, threads_x);
+
+    int blocks_x = divup(blocks_x_total, divup(blocks_x_total, max_blocks));
+
+    vector<void *> args;
+    for (const auto &node : full_nodes) {
+        node->setArgs(0, true,
+                      [&](int /*id*/, const void *ptr, size_t /*size*/) {
+                          args.push_back(const_cast<void *>(ptr));
+                      });
+    }
+    for (size_t k = 0; k < outputs.size(); k++) {
+        args.push_back(static_cast<void *>(&outputs[k]));
+        args.push_back(static_cast<void *>(&ends[k]));
+    }
+    args.push_back(static_cast<void *>(&blocks_x_total));
+
+    CUstream stream = getActiveStream();
+    CUevent start   = beginProfiledLaunch(stream);
+    CU_CHECK(cuLaunchKernel(ker, blocks_x, 1, 1, threads_x, 1, 1, 0, stream,
+                            args.data(), NULL));
+    if (start) {
+        endProfiledLaunch(start, stream, common::getProfiledName(ker),
+                          common::getProfiledName(kernel.getModuleHandle()));
+    }
+}
+
 template<typename T>
 void evalNodes(Param<T> out, Node *node) {
     vector<Param<T>> outputs;
@@ -330,6 +634,7 @@ template void evalNodes<uintl>(Param<uintl> out, Node *node);
 template void evalNodes<short>(Param<short> out, Node *node);
 template void evalNodes<ushort>(Param<ushort> out, Node *node);
 template void evalNodes<half>(Param<half> out, Node *node);
+template void evalNodes<bfloat16>(Param<bfloat16> out, Node *node);
 
 template void evalNodes<float>(vector<Param<float>> &out,
                                const vector<Node *> &node);
@@ -357,4 +662,35 @@ template void evalNodes<ushort>(vector<Param<ushort>> &out,
                                 const vector<Node *> &node);
 template void evalNodes<half>(vector<Param<half>> &out,
                               const vector<Node *> &node);
+template void evalNodes<bfloat16>(vector<Param<bfloat16>> &out,
+                                  const vector<Node *> &node);
+
+template void evalNodesBatched<float>(vector<Param<float>> &out,
+                                      const vector<Node *> &node);
+template void evalNodesBatched<double>(vector<Param<double>> &out,
+                                       const vector<Node *> &node);
+template void evalNodesBatched<cfloat>(vector<Param<cfloat>> &out,
+                                       const vector<Node *> &node);
+template void evalNodesBatched<cdouble>(vector<Param<cdouble>> &out,
+                                        const vector<Node *> &node);
+template void evalNodesBatched<int>(vector<Param<int>> &out,
+                                    const vector<Node *> &node);
+template void evalNodesBatched<uint>(vector<Param<uint>> &out,
+                                     const vector<Node *> &node);
+template void evalNodesBatched<char>(vector<Param<char>> &out,
+                                     const vector<Node *> &node);
+template void evalNodesBatched<uchar>(vector<Param<uchar>> &out,
+                                      const vector<Node *> &node);
+template void evalNodesBatched<intl>(vector<Param<intl>> &out,
+                                     const vector<Node *> &node);
+template void evalNodesBatched<uintl>(vector<Param<uintl>> &out,
+                                      const vector<Node *> &node);
+template void evalNodesBatched<short>(vector<Param<short>> &out,
+                                      const vector<Node *> &node);
+template void evalNodesBatched<ushort>(vector<Param<ushort>> &out,
+                                       const vector<Node *> &node);
+template void evalNodesBatched<half>(vector<Param<half>> &out,
+                                     const vector<Node *> &node);
+template void evalNodesBatched<bfloat16>(vector<Param<bfloat16>> &out,
+                                         const vector<Node *> &node);
 }  // namespace cuda
@@ -130,63 +130,146 @@ float curvatureUpdate(const float mct, const float C, const float S,
     return sqrtf(prop_grad) * delta;
 }
 
-template<typename T, af_flux_function FluxEnum, bool isMCDE>
-__global__
-void diffUpdate(Param<T> inout, const float dt, const float mct,
-                const unsigned blkX, const unsigned blkY) {
-    const unsigned RADIUS = 1;
-    const unsigned SHRD_MEM_WIDTH = THREADS_X + 2 * RADIUS;
-    const unsigned SHRD_MEM_HEIGHT = THREADS_Y * YDIM_LOAD + 2 * RADIUS;
-
-    __shared__ float shrdMem[SHRD_MEM_HEIGHT][SHRD_MEM_WIDTH];
+// The sum of the squared gradients at the pixel u of an image with rows of
+// pitch elements in shared memory. The gradients are the central differences
+// of the gradient function, one sided at the borders of the image.
+__device__
+float gradientEnergy(const float *u, const int pitch, const int x,
+                     const int y, const int dim0, const int dim1) {
+    float g0 = 0.0f;
+    float g1 = 0.0f;
+    if (dim0 > 1) {
+        if (x == 0) {
+            g0 = u[1] - u[0];
+        } else if (x == dim0 - 1) {
+            g0 = u[0] - u[-1];
+        } else {
+            g0 = 0.5f * (u[1] - u[-1]);
+        }
+    }
+    if (dim1 > 1) {
+        if (y == 0) {
+            g1 = u[pitch] - u[0];
+        } else if (y == dim1 - 1) {
+            g1 = u[0] - u[-pitch];
+        } else {
+            g1 = 0.5f * (u[pitch] - u[-pitch]);
+        }
+    }
+    return g0 * g0 + g1 * g1;
+}
 
-    const int l0 = inout.dims[0];
-    const int l1 = inout.dims[1];
-    const int s0 = inout.strides[0];
-    const int s1 = inout.strides[1];
+// One timestep of the diffusion from in to out. The conductance of step iter
+// is scaled by the gradient energy of its input in energy[iter % 3].
+//
+// The tile of the block is loaded with a halo of two pixels, so the block
+// also updates a ring of one pixel around its tile. The gradients of the
+// updated tile are then read from shared memory and their energy, which
+// scales the next step, is added to energy[(iter + 1) % 3]. energy[(iter +
+// 2) % 3] was read by the previous step and is cleared for the next one.
+//
+// If UpdateImage is false, only the gradient energy of in is added to
+// energy[iter % 3].
+template<typename T, af_flux_function FluxEnum, bool isMCDE, bool UpdateImage>
+__global__
+void diffUpdate(Param<T> out, CParam<T> in, const float dt,
+                const float mctScale, float *energy, const unsigned iter,
+                const bool accumulate, const unsigned blkX,
+                const unsigned blkY) {
+    const int TILE_W = THREADS_X;
+    const int TILE_H = THREADS_Y * YDIM_LOAD;
+    const int HALO   = 2;
+    const int IN_W   = TILE_W + 2 * HALO;
+    const int IN_H   = TILE_H + 2 * HALO;
+    const int UP_W   = TILE_W + 2;
+    const int UP_H   = TILE_H + 2;
+
+    __shared__ float inTile[IN_H][IN_W];
+    __shared__ float upTile[UP_H][UP_W];
+    __shared__ float blkEnergy;
+
+    const int l0 = in.dims[0];
+    const int l1 = in.dims[1];
 
     const int lx = threadIdx.x;
     const int ly = threadIdx.y;
 
+    const int by = blockIdx.y + blockIdx.z * gridDim.y;
     const int b2 = blockIdx.x / blkX;
-    const int b3 = blockIdx.y / blkY;
+    const int b3 = by / blkY;
 
-    const int gx = blockDim.x * (blockIdx.x - b2 * blkX) + lx;
-          int gy = blockDim.y * (blockIdx.y - b3 * blkY) + ly;
+    if (b3 >= in.dims[3]) return;
 
-    T* img = (T*)inout.ptr + (b3 * inout.strides[3] + b2 * inout.strides[2]);
+    const int ox = TILE_W * (blockIdx.x - b2 * blkX);
+    const int oy = TILE_H * (by - b3 * blkY);
 
-#pragma unroll
-    for (int b = ly, gy2 = gy - RADIUS; b < SHRD_MEM_HEIGHT;
-         b += blockDim.y, gy2 += blockDim.y) {
-#pragma unroll
-        for (int a = lx, gx2 = gx - RADIUS; a < SHRD_MEM_WIDTH;
-             a += blockDim.x, gx2 += blockDim.x) {
-            shrdMem[b][a] = img[ index(gx2, gy2, l0, l1, s0, s1) ];
+    const T *iptr = in.ptr + (b3 * in.strides[3] + b2 * in.strides[2]);
+    T *optr       = out.ptr + (b3 * out.strides[3] + b2 * out.strides[2]);
+
+    for (int b = ly; b < IN_H; b += blockDim.y) {
+        for (int a = lx; a < IN_W; a += blockDim.x) {
+            inTile[b][a] = iptr[index(ox + a - HALO, oy + b - HALO, l0, l1,
+                                      in.strides[0], in.strides[1])];
         }
     }
+    if (lx == 0 && ly == 0) { blkEnergy = 0.0f; }
     __syncthreads();
 
-    int i = lx + RADIUS;
-    int j = ly + RADIUS;
+    if (UpdateImage) {
+        if (blockIdx.x == 0 && by == 0 && lx == 0 && ly == 0) {
+            energy[(iter + 2) % 3] = 0.0f;
+        }
+        const float mct = mctScale / energy[iter % 3];
+
+        for (int b = ly; b < UP_H; b += blockDim.y) {
+            for (int a = lx; a < UP_W; a += blockDim.x) {
+                const int i = a + 1;
+                const int j = b + 1;
+                float C     = inTile[j][i];
+                float delta = 0.0f;
+                if (isMCDE) {
+                    delta = curvatureUpdate(
+                        mct, C, inTile[j][i + 1], inTile[j][i - 1],
+                        inTile[j - 1][i], inTile[j + 1][i],
+                        inTile[j + 1][i + 1], inTile[j - 1][i + 1],
+                        inTile[j + 1][i - 1], inTile[j - 1][i - 1]);
+                } else {
+                    delta = gradientUpdate<FluxEnum>(
+                        mct, C, inTile[j][i + 1], inTile[j][i - 1],
+                        inTile[j - 1][i], inTile[j + 1][i],
+                        inTile[j + 1][i + 1], inTile[j - 1][i + 1],
+                        inTile[j + 1][i - 1], inTile[j - 1][i - 1]);
+                }
+                upTile[b][a] = (float)((T)(C + delta * dt));
+            }
+        }
+        __syncthreads();
+    }
 
+    const int gx = ox + lx;
+    float sum    = 0.0f;
 #pragma unroll
-    for (int ld = 0; ld < YDIM_LOAD; ++ld, j+= blockDim.y, gy += blockDim.y) {
-        float C = shrdMem[j][i];
-        float delta = 0.0f;
-        if (isMCDE) {
-            delta = curvatureUpdate(
-                    mct, C, shrdMem[j][i + 1], shrdMem[j][i - 1], shrdMem[j - 1][i],
-                    shrdMem[j + 1][i], shrdMem[j + 1][i + 1], shrdMem[j - 1][i + 1],
-                    shrdMem[j + 1][i - 1], shrdMem[j - 1][i - 1]);
-        } else {
-            delta = gradientUpdate<FluxEnum>(
-                    mct, C, shrdMem[j][i + 1], shrdMem[j][i - 1], shrdMem[j - 1][i],
-                    shrdMem[j + 1][i], shrdMem[j + 1][i + 1], shrdMem[j - 1][i + 1],
-                    shrdMem[j + 1][i - 1], shrdMem[j - 1][i - 1]);
+    for (int ld = 0; ld < YDIM_LOAD; ++ld) {
+        const int ty = ly + ld * THREADS_Y;
+        const int gy = oy + ty;
+        if (gx >= l0 || gy >= l1) continue;
+
+        const float *u = UpdateImage ? &upTile[ty + 1][lx + 1]
+                                     : &inTile[ty + HALO][lx + HALO];
+        if (UpdateImage) {
+            optr[gx * out.strides[0] + gy * out.strides[1]] = (T)(*u);
+        }
+        if (accumulate) {
+            sum += gradientEnergy(u, UpdateImage ? UP_W : IN_W, gx, gy, l0,
+                                  l1);
         }
-        if (gy < l1 && gx < l0) {
-            img[gx * s0 + gy * s1] = (T)(C + delta * dt);
+    }
+
+    if (accumulate) {
+        atomicAdd(&blkEnergy, sum);
+        __syncthreads();
+        if (lx == 0 && ly == 0) {
+            atomicAdd(energy + (UpdateImage ? iter + 1 : iter) % 3, blkEnergy);
         }
     }
 }
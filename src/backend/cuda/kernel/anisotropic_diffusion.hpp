@@ -13,6 +13,7 @@
 #include <common/dispatch.hpp>
 #include <common/kernel_cache.hpp>
 #include <debug_cuda.hpp>
+#include <memory.hpp>
 #include <nvrtc_kernel_headers/anisotropic_diffusion_cuh.hpp>
 #include <af/defines.h>
 
@@ -25,39 +26,71 @@ constexpr int THREADS_X = 32;
 constexpr int THREADS_Y = 8;
 constexpr int YDIM_LOAD = 2 * THREADS_X / THREADS_Y;
 
+/// Launches one timestep of the diffusion from \p in to \p out, or only the
+/// gradient energy of \p in if \p update is false (see diffUpdate)
 template<typename T>
-void anisotropicDiffusion(Param<T> inout, const float dt, const float mct,
-                          const af::fluxFunction fftype, bool isMCDE) {
+void diffusionStep(Param<T> out, CParam<T> in, float *energy, const float dt,
+                   const float mctScale, const unsigned iter,
+                   const bool accumulate, const af::fluxFunction fftype,
+                   const bool isMCDE, const bool update) {
     static const std::string source(anisotropic_diffusion_cuh,
                                     anisotropic_diffusion_cuh_len);
     auto diffUpdate = common::getKernel(
         "cuda::diffUpdate", {source},
-        {TemplateTypename<T>(), TemplateArg(fftype), TemplateArg(isMCDE)},
+        {TemplateTypename<T>(), TemplateArg(fftype), TemplateArg(isMCDE),
+         TemplateArg(update)},
         {DefineValue(THREADS_X), DefineValue(THREADS_Y),
          DefineValue(YDIM_LOAD)});
 
     dim3 threads(THREADS_X, THREADS_Y, 1);
 
-    int blkX = divup(inout.dims[0], threads.x);
-    int blkY = divup(inout.dims[1], threads.y * YDIM_LOAD);
+    int blkX = divup(in.dims[0], threads.x);
+    int blkY = divup(in.dims[1], threads.y * YDIM_LOAD);
 
-    dim3 blocks(blkX * inout.dims[2], blkY * inout.dims[3], 1);
+    dim3 blocks(blkX * in.dims[2], blkY * in.dims[3], 1);
 
     const int maxBlkY =
         cuda::getDeviceProp(cuda::getActiveDeviceId()).maxGridSize[1];
     const int blkZ = divup(blocks.y, maxBlkY);
 
     if (blkZ > 1) {
-        blocks.y = maxBlkY;
+        blocks.y = divup(blocks.y, blkZ);
         blocks.z = blkZ;
     }
 
     EnqueueArgs qArgs(blocks, threads, getActiveStream());
 
-    diffUpdate(qArgs, inout, dt, mct, blkX, blkY);
+    diffUpdate(qArgs, out, in, dt, mctScale, energy, iter, accumulate, blkX,
+               blkY);
 
     POST_LAUNCH_CHECK();
 }
 
+/// Diffuses \p in for \p iterations timesteps into \p out, using \p tmp as
+/// the second buffer of the steps. The gradient energy which scales the
+/// conductance of each step is computed by the previous step, so the steps
+/// are enqueued without reading anything back.
+///
+/// \returns true if the result is in \p tmp
+template<typename T>
+bool anisotropicDiffusion(Param<T> inout, Param<T> tmp, const float dt,
+                          const float mctScale, const unsigned iterations,
+                          const af::fluxFunction fftype, bool isMCDE) {
+    auto energy = memAlloc<float>(3);
+    CUDA_CHECK(cudaMemsetAsync(energy.get(), 0, 3 * sizeof(float),
+                               getActiveStream()));
+
+    diffusionStep<T>(tmp, inout, energy.get(), dt, mctScale, 0, true, fftype,
+                     isMCDE, false);
+
+    Param<T> bufs[2] = {inout, tmp};
+    for (unsigned it = 0; it < iterations; ++it) {
+        diffusionStep<T>(bufs[(it + 1) % 2], bufs[it % 2], energy.get(), dt,
+                         mctScale, it, it + 1 < iterations, fftype, isMCDE,
+                         true);
+    }
+    return iterations % 2 == 1;
+}
+
 }  // namespace kernel
 }  // namespace cuda
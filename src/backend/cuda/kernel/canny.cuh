@@ -10,11 +10,6 @@
 #include <Param.hpp>
 #include <math.hpp>
 
-// hasChanged is a variable in kernel space
-// used to track the convergence of
-// the breath first search algorithm
-__device__ int hasChanged = 0;
-
 namespace cuda {
 
 __forceinline__ __device__
@@ -176,7 +171,12 @@ void initEdgeOut(Param<T> output, CParam<T> strong, CParam<T> weak,
 
 template<typename T>
 __global__
-void edgeTrack(Param<T> output, unsigned nBBS0, unsigned nBBS1) {
+void edgeTrack(Param<T> output, unsigned nBBS0, unsigned nBBS1,
+               int *hasChanged, int iter) {
+    // The previous launch of the batch changed nothing, so the tracking has
+    // converged
+    if (iter > 0 && hasChanged[iter - 1] == 0) return;
+
     const unsigned SHRD_MEM_WIDTH  = THREADS_X + 2;  // Cols
     const unsigned SHRD_MEM_HEIGHT = THREADS_Y + 2;  // Rows
 
@@ -287,7 +287,7 @@ void edgeTrack(Param<T> output, unsigned nBBS0, unsigned nBBS1) {
 
     if (__syncthreads_or(cu == STRONG && hasWeakNeighbour) && lx == 0 &&
         ly == 0)
-        atomicAdd(&hasChanged, 1);
+        atomicAdd(hasChanged + iter, 1);
 
     // Update output with shared memory result
     if (gx < (output.dims[0] - 2) && gy < (output.dims[1] - 2))
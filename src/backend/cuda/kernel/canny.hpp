@@ -11,6 +11,7 @@
 #include <common/dispatch.hpp>
 #include <common/kernel_cache.hpp>
 #include <debug_cuda.hpp>
+#include <kernel/converge.hpp>
 #include <nvrtc_kernel_headers/canny_cuh.hpp>
 
 #include <string>
@@ -79,16 +80,10 @@ void edgeTrackingHysteresis(Param<T> output, CParam<T> strong, CParam<T> weak) {
     initEdgeOut(qArgs, output, strong, weak, blk_x, blk_y);
     POST_LAUNCH_CHECK();
 
-    auto flagPtr = edgeTrack.getDevPtr("hasChanged");
-
-    int notFinished = 1;
-    while (notFinished) {
-        notFinished = 0;
-        edgeTrack.setFlag(flagPtr, &notFinished);
-        edgeTrack(qArgs, output, blk_x, blk_y);
+    launchUntilConverged([&](int *flags, int iter) {
+        edgeTrack(qArgs, output, blk_x, blk_y, flags, iter);
         POST_LAUNCH_CHECK();
-        notFinished = edgeTrack.getFlag(flagPtr);
-    }
+    });
     suppressLeftOver(qArgs, output, blk_x, blk_y);
     POST_LAUNCH_CHECK();
 }
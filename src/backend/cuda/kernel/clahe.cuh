@@ -0,0 +1,135 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Param.hpp>
+#include <math.hpp>
+#include <shared.hpp>
+
+namespace cuda {
+
+// One block computes the mapping of one tile of a slice to the fraction of
+// the pixels of the tile below each bin. The histogram is counted, clipped
+// and accumulated in shared memory. Tile b along a dimension of length n
+// covers the indices i with b = i * grid / n.
+template<typename T>
+__global__ void claheLut(Param<float> lut, CParam<T> in, float clipLimit,
+                         float minval, float maxval) {
+    SharedMemory<uint> shared;
+    uint *hist = shared.getPointer();
+    __shared__ uint excess;
+
+    const int nbins    = lut.dims[0];
+    const int gridRows = lut.dims[1];
+    const int gridCols = lut.dims[2];
+    const int ty       = blockIdx.x % gridRows;
+    const int tx       = blockIdx.x / gridRows;
+    const int b2       = blockIdx.y % in.dims[2];
+    const int b3       = blockIdx.y / in.dims[2];
+
+    const int rowBeg = (ty * in.dims[0] + gridRows - 1) / gridRows;
+    const int rowEnd = ((ty + 1) * in.dims[0] + gridRows - 1) / gridRows;
+    const int colBeg = (tx * in.dims[1] + gridCols - 1) / gridCols;
+    const int colEnd = ((tx + 1) * in.dims[1] + gridCols - 1) / gridCols;
+    const int rows   = rowEnd - rowBeg;
+    const int count  = rows * (colEnd - colBeg);
+
+    const T *iptr = in.ptr + b2 * in.strides[2] + b3 * in.strides[3] +
+                    colBeg * in.strides[1] + rowBeg;
+    const float step = (maxval - minval) / (float)nbins;
+
+    for (int b = threadIdx.x; b < nbins; b += blockDim.x) hist[b] = 0;
+    if (threadIdx.x == 0) excess = 0;
+    __syncthreads();
+
+    for (int e = threadIdx.x; e < count; e += blockDim.x) {
+        const int i = e % rows;
+        const int j = e / rows;
+        int bin = (int)((static_cast<float>(iptr[j * in.strides[1] + i]) -
+                         minval) /
+                        step);
+        bin     = min(max(bin, 0), nbins - 1);
+        atomicAdd(hist + bin, 1u);
+    }
+    __syncthreads();
+
+    if (clipLimit > 0) {
+        const uint limit = max(1u, (uint)(clipLimit * count / nbins));
+        uint clipped     = 0;
+        for (int b = threadIdx.x; b < nbins; b += blockDim.x) {
+            if (hist[b] > limit) {
+                clipped += hist[b] - limit;
+                hist[b] = limit;
+            }
+        }
+        atomicAdd(&excess, clipped);
+        __syncthreads();
+    }
+
+    // The histograms are small, so one thread accumulates the cdf
+    if (threadIdx.x == 0) {
+        float *optr = lut.ptr + ty * lut.strides[1] + tx * lut.strides[2] +
+                      blockIdx.y * lut.strides[3];
+        const float redist = (float)excess / nbins;
+        const float scale  = 1.f / count;
+        float cdf          = 0.f;
+        for (int b = 0; b < nbins; b++) {
+            cdf += hist[b] + redist;
+            optr[b] = cdf * scale;
+        }
+    }
+}
+
+// Maps every pixel by the mappings of the four tiles whose centers surround
+// it, interpolated bilinearly
+template<typename T, bool IsIntegral>
+__global__ void claheApply(Param<T> out, CParam<T> in, CParam<float> lut,
+                           float minval, float maxval) {
+    const int i  = blockIdx.x * blockDim.x + threadIdx.x;
+    const int j  = blockIdx.y * blockDim.y + threadIdx.y;
+    const int s  = blockIdx.z;
+    const int b2 = s % in.dims[2];
+    const int b3 = s / in.dims[2];
+    if (i >= in.dims[0] || j >= in.dims[1]) return;
+
+    const int nbins    = lut.dims[0];
+    const int gridRows = lut.dims[1];
+    const int gridCols = lut.dims[2];
+    const float step   = (maxval - minval) / (float)nbins;
+
+    const T v = in.ptr[b2 * in.strides[2] + b3 * in.strides[3] +
+                       j * in.strides[1] + i];
+    int bin   = (int)((static_cast<float>(v) - minval) / step);
+    bin       = min(max(bin, 0), nbins - 1);
+
+    const float fy  = (i + 0.5f) * gridRows / in.dims[0] - 0.5f;
+    const float fx  = (j + 0.5f) * gridCols / in.dims[1] - 0.5f;
+    const int y0    = (int)floorf(fy);
+    const int x0    = (int)floorf(fx);
+    const float wy  = fy - y0;
+    const float wx  = fx - x0;
+    const int ty0   = max(y0, 0);
+    const int ty1   = min(y0 + 1, gridRows - 1);
+    const int tx0   = max(x0, 0);
+    const int tx1   = min(x0 + 1, gridCols - 1);
+    const float *lp = lut.ptr + s * lut.strides[3] + bin;
+    const float *l0 = lp + ty0 * lut.strides[1];
+    const float *l1 = lp + ty1 * lut.strides[1];
+    const int c0    = tx0 * lut.strides[2];
+    const int c1    = tx1 * lut.strides[2];
+
+    const float top  = (1.f - wx) * l0[c0] + wx * l0[c1];
+    const float bot  = (1.f - wx) * l1[c0] + wx * l1[c1];
+    const float frac = (1.f - wy) * top + wy * bot;
+    const float res  = minval + (maxval - minval) * frac;
+
+    out.ptr[b2 * out.strides[2] + b3 * out.strides[3] + j * out.strides[1] +
+            i] = (T)(IsIntegral ? floorf(res + 0.5f) : res);
+}
+
+}  // namespace cuda
@@ -0,0 +1,65 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_cuda.hpp>
+#include <nvrtc_kernel_headers/clahe_cuh.hpp>
+
+#include <string>
+#include <type_traits>
+
+namespace cuda {
+namespace kernel {
+
+constexpr int CLAHE_THREADS   = 256;
+constexpr int CLAHE_THREADS_X = 32;
+constexpr int CLAHE_THREADS_Y = 8;
+
+template<typename T>
+void claheLut(Param<float> lut, CParam<T> in, float clipLimit, float minval,
+              float maxval) {
+    static const std::string source(clahe_cuh, clahe_cuh_len);
+
+    auto claheLut = common::getKernel("cuda::claheLut", {source},
+                                      {TemplateTypename<T>()});
+
+    const int nbins = lut.dims[0];
+    dim3 threads(CLAHE_THREADS);
+    dim3 blocks(lut.dims[1] * lut.dims[2], lut.dims[3]);
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream(),
+                      nbins * sizeof(uint));
+    claheLut(qArgs, lut, in, clipLimit, minval, maxval);
+    POST_LAUNCH_CHECK();
+}
+
+template<typename T>
+void claheApply(Param<T> out, CParam<T> in, CParam<float> lut, float minval,
+                float maxval) {
+    static const std::string source(clahe_cuh, clahe_cuh_len);
+
+    constexpr bool IsIntegral = std::is_integral<T>::value;
+
+    auto claheApply =
+        common::getKernel("cuda::claheApply", {source},
+                          {TemplateTypename<T>(), TemplateArg(IsIntegral)});
+
+    dim3 threads(CLAHE_THREADS_X, CLAHE_THREADS_Y);
+    dim3 blocks(divup(in.dims[0], threads.x), divup(in.dims[1], threads.y),
+                in.dims[2] * in.dims[3]);
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream());
+    claheApply(qArgs, out, in, lut, minval, maxval);
+    POST_LAUNCH_CHECK();
+}
+
+}  // namespace kernel
+}  // namespace cuda
@@ -0,0 +1,185 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <types.hpp>
+
+namespace cuda {
+
+// The values of AF_CONV2_PASS
+#define CONV2_FORWARD 0
+#define CONV2_DATA_GRADIENT 1
+#define CONV2_FILTER_GRADIENT 2
+
+/// Returns the element (x, y, c, n) of \p in, or 0 outside of the first two
+/// dimensions, which is the padding of the convolution
+template<typename T>
+__device__ compute_t<T> conv2Value(const CParam<T> &in, dim_t x, dim_t y,
+                                   dim_t c, dim_t n) {
+    if (x < 0 || y < 0 || x >= in.dims[0] || y >= in.dims[1]) {
+        return compute_t<T>(0);
+    }
+    return static_cast<compute_t<T>>(in.ptr[x * in.strides[0] +
+                                            y * in.strides[1] +
+                                            c * in.strides[2] +
+                                            n * in.strides[3]]);
+}
+
+/// The geometry of the convolution: the size of the filter and the stride,
+/// the padding and the dilation of each dimension
+struct Conv2Geometry {
+    int fw, fh;
+    int sx, sy;
+    int px, py;
+    int dx, dy;
+};
+
+/// Returns the element (row, t) of the left operand of the product, the
+/// unwrapped signal for the forward pass and the filter gradient, and the
+/// unwrapped output gradient for the data gradient. \p lhs is the signal or
+/// the output gradient, and \p out the output of the pass.
+template<typename T, int pass>
+__device__ compute_t<T> conv2Lhs(const Param<T> &out, const CParam<T> &lhs,
+                                 const CParam<T> &rhs, const Conv2Geometry &g,
+                                 dim_t row, dim_t t) {
+    if (pass == CONV2_FORWARD) {
+        // row is the output pixel (ox, oy, n), t the tap (i, j, c)
+        const dim_t ox = row % out.dims[0];
+        const dim_t oy = (row / out.dims[0]) % out.dims[1];
+        const dim_t n  = row / (out.dims[0] * out.dims[1]);
+        const dim_t i  = t % g.fw;
+        const dim_t j  = (t / g.fw) % g.fh;
+        const dim_t c  = t / (g.fw * g.fh);
+        return conv2Value(lhs, ox * g.sx - g.px + i * g.dx,
+                          oy * g.sy - g.py + j * g.dy, c, n);
+    } else if (pass == CONV2_DATA_GRADIENT) {
+        // row is the signal pixel (x, y, n), t the tap (i, j, k). The pixel
+        // gets the gradient of the outputs whose tap (i, j) reads it.
+        const dim_t x  = row % out.dims[0];
+        const dim_t y  = (row / out.dims[0]) % out.dims[1];
+        const dim_t n  = row / (out.dims[0] * out.dims[1]);
+        const dim_t i  = t % g.fw;
+        const dim_t j  = (t / g.fw) % g.fh;
+        const dim_t k  = t / (g.fw * g.fh);
+        const dim_t xo = x + g.px - i * g.dx;
+        const dim_t yo = y + g.py - j * g.dy;
+        if (xo < 0 || yo < 0 || xo % g.sx != 0 || yo % g.sy != 0) {
+            return compute_t<T>(0);
+        }
+        return conv2Value(lhs, xo / g.sx, yo / g.sy, k, n);
+    } else {
+        // row is the tap (i, j, c), t the output pixel (ox, oy, n)
+        const dim_t i  = row % g.fw;
+        const dim_t j  = (row / g.fw) % g.fh;
+        const dim_t c  = row / (g.fw * g.fh);
+        const dim_t ox = t % rhs.dims[0];
+        const dim_t oy = (t / rhs.dims[0]) % rhs.dims[1];
+        const dim_t n  = t / (rhs.dims[0] * rhs.dims[1]);
+        return conv2Value(lhs, ox * g.sx - g.px + i * g.dx,
+                          oy * g.sy - g.py + j * g.dy, c, n);
+    }
+}
+
+/// Returns the element (t, col) of the right operand of the product, the
+/// flipped filter for the forward pass and the data gradient, and the output
+/// gradient for the filter gradient
+template<typename T, int pass>
+__device__ compute_t<T> conv2Rhs(const CParam<T> &rhs, const Conv2Geometry &g,
+                                 dim_t t, dim_t col) {
+    if (pass == CONV2_FILTER_GRADIENT) {
+        const dim_t ox = t % rhs.dims[0];
+        const dim_t oy = (t / rhs.dims[0]) % rhs.dims[1];
+        const dim_t n  = t / (rhs.dims[0] * rhs.dims[1]);
+        return conv2Value(rhs, ox, oy, col, n);
+    } else {
+        // t is the tap (i, j, c) of the forward pass, and (i, j, k) of the
+        // data gradient
+        const dim_t i = t % g.fw;
+        const dim_t j = (t / g.fw) % g.fh;
+        const dim_t z = t / (g.fw * g.fh);
+        const dim_t c = pass == CONV2_FORWARD ? z : col;
+        const dim_t k = pass == CONV2_FORWARD ? col : z;
+        return conv2Value(rhs, g.fw - 1 - i, g.fh - 1 - j, c, k);
+    }
+}
+
+/// Stores the element (row, col) of the product. The filter gradient is a
+/// partial sum of the \p split part of the output pixels, stored flipped.
+template<typename T, int pass>
+__device__ void conv2Store(Param<T> &out, const Conv2Geometry &g, dim_t row,
+                           dim_t col, dim_t split, compute_t<T> value) {
+    if (pass == CONV2_FILTER_GRADIENT) {
+        const dim_t i = row % g.fw;
+        const dim_t j = (row / g.fw) % g.fh;
+        const dim_t c = row / (g.fw * g.fh);
+        const dim_t flipped =
+            (g.fw - 1 - i) + g.fw * ((g.fh - 1 - j) + g.fh * c);
+        out.ptr[flipped * out.strides[0] + col * out.strides[1] +
+                split * out.strides[2]] = static_cast<T>(value);
+    } else {
+        // row is the pixel (x, y, n) of the output, col its channel
+        const dim_t x = row % out.dims[0];
+        const dim_t y = (row / out.dims[0]) % out.dims[1];
+        const dim_t n = row / (out.dims[0] * out.dims[1]);
+        out.ptr[x * out.strides[0] + y * out.strides[1] +
+                col * out.strides[2] + n * out.strides[3]] =
+            static_cast<T>(value);
+    }
+}
+
+/// Computes a tile x tile block of the product of the unwrapped operand,
+/// which is read from \p lhs as it is needed, with \p rhs. The reduction
+/// runs over the \p chunk elements of the part blockIdx.z.
+template<typename T, int pass, int tile>
+__global__ void conv2Implicit(Param<T> out, CParam<T> lhs, CParam<T> rhs,
+                              int fw, int fh, int sx, int sy, int px, int py,
+                              int dx, int dy, dim_t rows, dim_t cols,
+                              dim_t depth, dim_t chunk) {
+    using CT = compute_t<T>;
+    __shared__ CT lhsTile[tile][tile + 1];
+    __shared__ CT rhsTile[tile][tile + 1];
+
+    const Conv2Geometry g = {fw, fh, sx, sy, px, py, dx, dy};
+
+    const int tx      = threadIdx.x;
+    const int ty      = threadIdx.y;
+    const dim_t row   = blockIdx.x * static_cast<dim_t>(tile) + tx;
+    const dim_t col   = blockIdx.y * static_cast<dim_t>(tile) + ty;
+    const dim_t begin = blockIdx.z * chunk;
+    const dim_t end   = min(begin + chunk, depth);
+
+    CT acc = CT(0);
+    for (dim_t t0 = begin; t0 < end; t0 += tile) {
+        // The threads along x read consecutive rows of lhs and consecutive
+        // reduction indices of rhs, which are the contiguous ones
+        const dim_t tl = t0 + ty;
+        const dim_t tr = t0 + tx;
+        lhsTile[ty][tx] = (row < rows && tl < end)
+                              ? conv2Lhs<T, pass>(out, lhs, rhs, g, row, tl)
+                              : CT(0);
+        rhsTile[tx][ty] = (col < cols && tr < end)
+                              ? conv2Rhs<T, pass>(rhs, g, tr, col)
+                              : CT(0);
+        __syncthreads();
+
+#pragma unroll
+        for (int k = 0; k < tile; ++k) {
+            acc += lhsTile[k][tx] * rhsTile[k][ty];
+        }
+        __syncthreads();
+    }
+
+    if (row < rows && col < cols) {
+        conv2Store<T, pass>(out, g, row, col, blockIdx.z, acc);
+    }
+}
+
+}  // namespace cuda
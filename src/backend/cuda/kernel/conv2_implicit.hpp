@@ -0,0 +1,92 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/internal_enums.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_cuda.hpp>
+#include <nvrtc_kernel_headers/conv2_implicit_cuh.hpp>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace cuda {
+namespace kernel {
+
+/// The side of the tiles of the products of conv2Implicit
+constexpr int CONV2_TILE = 16;
+
+/// Returns the number of output pixels added by each part of the filter
+/// gradient. Large outputs are split in up to 64 parts of at least 8192
+/// pixels, which are multiples of the tiles, so that the products of the
+/// small filter gradients are computed by enough blocks.
+inline dim_t conv2GradientChunk(const dim_t pixels) {
+    const dim_t parts = std::min<dim_t>(std::max<dim_t>(pixels / 8192, 1), 64);
+    return std::max<dim_t>(divup(divup(pixels, parts), CONV2_TILE), 1) *
+           CONV2_TILE;
+}
+
+/// Computes a \p pass of the convolution of the neural network functions as
+/// a product of matrices, without the unwrapped matrix. Its elements are
+/// read from the signal or the output gradient by the blocks of the product
+/// which use them.
+///
+/// \p lhs and \p rhs are the signal and the filter for the forward pass, the
+/// output gradient and the filter for the data gradient, and the signal and
+/// the output gradient for the filter gradient. The filter gradient is
+/// written to \p out as partial sums of \p chunk output pixels each, along
+/// its third dimension, with the taps in the first dimension and the filters
+/// in the second one.
+template<typename T>
+void conv2Implicit(Param<T> out, CParam<T> lhs, CParam<T> rhs,
+                   AF_CONV2_PASS pass, const dim_t fw, const dim_t fh,
+                   const af::dim4 &stride, const af::dim4 &padding,
+                   const af::dim4 &dilation, const dim_t chunk) {
+    static const std::string source(conv2_implicit_cuh,
+                                    conv2_implicit_cuh_len);
+
+    auto conv2Op = common::getKernel(
+        "cuda::conv2Implicit", {source},
+        {TemplateTypename<T>(), TemplateArg(static_cast<int>(pass)),
+         TemplateArg(CONV2_TILE)});
+
+    // The rows are the output pixels of the forward pass, the signal pixels
+    // of the data gradient and the taps of the filter gradient. The columns
+    // are the channels of the output.
+    dim_t rows = 0, cols = 0, depth = 0;
+    if (pass == AF_CONV2_FILTER_GRADIENT) {
+        rows  = out.dims[0];
+        cols  = out.dims[1];
+        depth = rhs.dims[0] * rhs.dims[1] * rhs.dims[3];
+    } else {
+        rows  = out.dims[0] * out.dims[1] * out.dims[3];
+        cols  = out.dims[2];
+        depth = fw * fh * lhs.dims[2];
+    }
+
+    dim3 threads(CONV2_TILE, CONV2_TILE);
+    dim3 blocks(divup(rows, CONV2_TILE), divup(cols, CONV2_TILE),
+                divup(depth, chunk));
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream());
+
+    conv2Op(qArgs, out, lhs, rhs, static_cast<int>(fw), static_cast<int>(fh),
+            static_cast<int>(stride[0]), static_cast<int>(stride[1]),
+            static_cast<int>(padding[0]), static_cast<int>(padding[1]),
+            static_cast<int>(dilation[0]), static_cast<int>(dilation[1]),
+            rows, cols, depth, chunk);
+    POST_LAUNCH_CHECK();
+}
+
+}  // namespace kernel
+}  // namespace cuda
@@ -0,0 +1,53 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <err_cuda.hpp>
+#include <memory.hpp>
+#include <platform.hpp>
+
+#include <algorithm>
+
+namespace cuda {
+namespace kernel {
+
+/// The most launches of an iterative kernel between two checks of its
+/// convergence
+constexpr int MAX_UNCHECKED_LAUNCHES = 32;
+
+/// Launches an iterative kernel until one of its iterations changes nothing.
+///
+/// The flag of the kernel is read on the host once per batch of launches
+/// instead of after every launch. \p launch(flags, iter) enqueues iteration
+/// \p iter of a batch. The kernel sets flags[iter] when it changes its output
+/// and returns at once if iter > 0 and flags[iter - 1] is zero, because the
+/// previous iteration has converged. The batches start with one launch and
+/// double up to MAX_UNCHECKED_LAUNCHES, so the kernels which converge quickly
+/// waste few launches.
+template<typename F>
+void launchUntilConverged(F launch) {
+    auto flags  = memAlloc<int>(MAX_UNCHECKED_LAUNCHES);
+    int changed = 1;
+    for (int launches = 1; changed;
+         launches = std::min(2 * launches, MAX_UNCHECKED_LAUNCHES)) {
+        CUDA_CHECK(cudaMemsetAsync(flags.get(), 0, launches * sizeof(int),
+                                   getActiveStream()));
+        for (int iter = 0; iter < launches; ++iter) {
+            launch(flags.get(), iter);
+        }
+        CUDA_CHECK(cudaMemcpyAsync(&changed, flags.get() + launches - 1,
+                                   sizeof(int), cudaMemcpyDeviceToHost,
+                                   getActiveStream()));
+        CUDA_CHECK(cudaStreamSynchronize(getActiveStream()));
+    }
+}
+
+}  // namespace kernel
+}  // namespace cuda
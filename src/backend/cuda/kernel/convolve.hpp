@@ -15,11 +15,13 @@
 #include <common/kernel_cache.hpp>
 #include <debug_cuda.hpp>
 #include <nvrtc_kernel_headers/convolve1_cuh.hpp>
+#include <nvrtc_kernel_headers/convolve2_bank_cuh.hpp>
 #include <nvrtc_kernel_headers/convolve2_cuh.hpp>
 #include <nvrtc_kernel_headers/convolve3_cuh.hpp>
 #include <nvrtc_kernel_headers/convolve_separable_cuh.hpp>
 #include <traits.hpp>
 
+#include <algorithm>
 #include <string>
 
 using std::string;
@@ -43,8 +45,12 @@ static const int MAX_CONV1_FILTER_LEN = 129;
 static const int MAX_CONV2_FILTER_LEN = 17;
 static const int MAX_CONV3_FILTER_LEN = 5;
 
+// Bytes of constant memory used by the filters of one filter bank launch
+static const int CONV2_BANK_BYTES = 32768;
+
 constexpr static const char* conv_c_name  = "cFilter";
 constexpr static const char* sconv_c_name = "sFilter";
+constexpr static const char* bconv_c_name = "cFilterBank";
 
 struct conv_kparam_t {
     dim3 mBlocks;
@@ -148,9 +154,8 @@ void convolve_1d(conv_kparam_t& p, Param<T> out, CParam<T> sig, CParam<aT> filt,
     }
 }
 
-template<typename T, typename aT>
-void conv2Helper(const conv_kparam_t& p, Param<T> out, CParam<T> sig,
-                 const aT* fptr, int f0, int f1, const bool expand) {
+/// Checks that the 2D convolution kernels support a \p f0 x \p f1 filter
+inline void checkConv2FilterSize(int f0, int f1) {
     const bool isFilterSizeLt5  = (f0 <= 5 && f1 <= 5);
     const bool isFilterGt5AndSq = (f0 == f1 && f0 > 5 && f0 < 18);
 
@@ -160,6 +165,12 @@ void conv2Helper(const conv_kparam_t& p, Param<T> out, CParam<T> sig,
                  "\nCUDA Convolution doesn't support %dx%d kernel\n", f0, f1);
         CUDA_NOT_SUPPORTED(errMessage);
     }
+}
+
+template<typename T, typename aT>
+void conv2Helper(const conv_kparam_t& p, Param<T> out, CParam<T> sig,
+                 const aT* fptr, int f0, int f1, const bool expand) {
+    checkConv2FilterSize(f0, f1);
 
     static const std::string src(convolve2_cuh, convolve2_cuh_len);
 
@@ -181,11 +192,57 @@ void conv2Helper(const conv_kparam_t& p, Param<T> out, CParam<T> sig,
     POST_LAUNCH_CHECK();
 }
 
+/// Convolves a single signal with a bank of filters. The filters are copied
+/// to constant memory in chunks and each launch reads the tiles of the signal
+/// once for all the filters of its chunk, instead of once per filter.
+template<typename T, typename aT>
+void convolve_2d_bank(const conv_kparam_t& p, Param<T> out, CParam<T> sig,
+                      CParam<aT> filt, const bool expand) {
+    const int f0 = filt.dims[0];
+    const int f1 = filt.dims[1];
+    checkConv2FilterSize(f0, f1);
+
+    static const std::string src(convolve2_bank_cuh, convolve2_bank_cuh_len);
+
+    auto convolve2Bank = common::getKernel(
+        "cuda::convolve2Bank", {src},
+        {TemplateTypename<T>(), TemplateTypename<aT>(), TemplateArg(expand),
+         TemplateArg(f0), TemplateArg(f1)},
+        {DefineValue(CONV2_BANK_BYTES), DefineValue(CONV2_THREADS_X),
+         DefineValue(CONV2_THREADS_Y)});
+
+    const int fDim2    = filt.dims[2];
+    const int fCount   = fDim2 * filt.dims[3];
+    const size_t fSize = f0 * f1 * sizeof(aT);
+    const int chunk    = static_cast<int>(CONV2_BANK_BYTES / fSize);
+
+    auto constMemPtr = convolve2Bank.getDevPtr(bconv_c_name);
+    for (int fBegin = 0; fBegin < fCount; fBegin += chunk) {
+        const int count = std::min(chunk, fCount - fBegin);
+
+        // FIXME: case where filter array is strided
+        const aT* fptr = filt.ptr + fBegin * f0 * f1;
+        convolve2Bank.copyToReadOnly(
+            constMemPtr, reinterpret_cast<CUdeviceptr>(fptr), count * fSize);
+
+        EnqueueArgs qArgs(p.mBlocks, p.mThreads, getActiveStream());
+        convolve2Bank(qArgs, out, sig, fBegin, count, fDim2);
+        POST_LAUNCH_CHECK();
+    }
+}
+
 template<typename T, typename aT>
 void convolve_2d(conv_kparam_t& p, Param<T> out, CParam<T> sig, CParam<aT> filt,
                  const bool expand) {
     prepareKernelArgs<T>(p, out.dims, filt.dims, 2);
 
+    // A single signal convolved with many filters shares its tiles
+    const bool isBank = p.launchMoreBlocks && p.inHasNoOffset;
+    if (isBank && filt.dims[2] * filt.dims[3] > 1) {
+        convolve_2d_bank<T, aT>(p, out, sig, filt, expand);
+        return;
+    }
+
     for (int b3 = 0; b3 < filt.dims[3]; ++b3) {
         int f3Off = b3 * filt.strides[3];
 
@@ -0,0 +1,89 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Param.hpp>
+#include <math.hpp>
+
+__constant__ char cFilterBank[CONV2_BANK_BYTES];
+
+namespace cuda {
+
+// Convolves one signal with fCount filters of a filter bank, which are packed
+// one after the other in cFilterBank. The tile of the signal is loaded to
+// shared memory once and reused by all the filters, and filter k of the bank
+// is written to the slice (k % fDim2, k / fDim2) of the output.
+template<typename T, typename aT, bool expand, int fLen0, int fLen1>
+__global__
+void convolve2Bank(Param<T> out, CParam<T> signal, int fBegin, int fCount,
+                   int fDim2) {
+    const size_t C_SIZE = (CONV2_THREADS_X + 2 * (fLen0 - 1)) *
+                          (CONV2_THREADS_Y + 2 * (fLen1 - 1));
+    __shared__ T shrdMem[C_SIZE];
+
+    const int radius0  = fLen0 - 1;
+    const int radius1  = fLen1 - 1;
+    const int padding0 = 2 * radius0;
+    const int padding1 = 2 * radius1;
+    const int shrdLen0 = CONV2_THREADS_X + padding0;
+    const int shrdLen1 = CONV2_THREADS_Y + padding1;
+
+    const T *src = (const T *)signal.ptr;
+
+    int lx = threadIdx.x;
+    int ly = threadIdx.y;
+    int gx = CONV2_THREADS_X * blockIdx.x + lx;
+    int gy = CONV2_THREADS_Y * (blockIdx.y + blockIdx.z * gridDim.y) + ly;
+
+    int s0 = signal.strides[0];
+    int s1 = signal.strides[1];
+    int d0 = signal.dims[0];
+    int d1 = signal.dims[1];
+#pragma unroll
+    for (int b = ly, gy2 = gy; b < shrdLen1;
+         b += CONV2_THREADS_Y, gy2 += CONV2_THREADS_Y) {
+        int j     = gy2 - radius1;
+        bool is_j = j >= 0 && j < d1;
+#pragma unroll
+        for (int a = lx, gx2 = gx; a < shrdLen0;
+             a += CONV2_THREADS_X, gx2 += CONV2_THREADS_X) {
+            int i     = gx2 - radius0;
+            bool is_i = i >= 0 && i < d0;
+            shrdMem[b * shrdLen0 + a] =
+                (is_i && is_j ? src[i * s0 + j * s1] : scalar<T>(0));
+        }
+    }
+    __syncthreads();
+
+    if (gx < out.dims[0] && gy < out.dims[1]) {
+        int ci = lx + radius0 + (expand ? 0 : fLen0 >> 1);
+        int cj = ly + radius1 + (expand ? 0 : fLen1 >> 1);
+
+        for (int f = 0; f < fCount; ++f) {
+            const aT *impulse = (const aT *)cFilterBank + f * fLen0 * fLen1;
+
+            aT accum = scalar<aT>(0);
+#pragma unroll
+            for (int fj = 0; fj < fLen1; ++fj) {
+#pragma unroll
+                for (int fi = 0; fi < fLen0; ++fi) {
+                    aT f_val = impulse[fj * fLen0 + fi];
+                    T s_val  = shrdMem[(cj - fj) * shrdLen0 + (ci - fi)];
+                    accum    = accum + s_val * f_val;
+                }
+            }
+
+            int k  = fBegin + f;
+            T *dst = (T *)out.ptr + (k % fDim2) * out.strides[2] +
+                     (k / fDim2) * out.strides[3];
+            dst[gy * out.strides[1] + gx] = (T)accum;
+        }
+    }
+}
+
+}  // namespace cuda
@@ -0,0 +1,71 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <math.hpp>
+
+namespace cuda {
+
+__device__ void cooAtomicAdd(float *ptr, float value) {
+    atomicAdd(ptr, value);
+}
+
+__device__ void cooAtomicAdd(double *ptr, double value) {
+    atomicAdd(ptr, value);
+}
+
+__device__ void cooAtomicAdd(cfloat *ptr, cfloat value) {
+    atomicAdd(&ptr->x, value.x);
+    atomicAdd(&ptr->y, value.y);
+}
+
+__device__ void cooAtomicAdd(cdouble *ptr, cdouble value) {
+    atomicAdd(&ptr->x, value.x);
+    atomicAdd(&ptr->y, value.y);
+}
+
+// Each thread adds the products of nnzPerThread consecutive nonzeros with one
+// column of rhs to the output, which is zero. The nonzeros may be in any
+// order. The products of consecutive nonzeros of the same output row are
+// summed before they are added atomically, so the nonzeros which are sorted
+// by row take one atomic add per row of each thread.
+
+template<typename T, bool transpose, bool conjugate>
+__global__ void coomm(Param<T> out, CParam<T> values, CParam<int> rowIdx,
+                      CParam<int> colIdx, CParam<T> rhs,
+                      const int nnzPerThread) {
+    const int nnz     = values.dims[0];
+    const int first   = (blockIdx.x * blockDim.x + threadIdx.x) * nnzPerThread;
+    const int last    = min(first + nnzPerThread, nnz);
+    const int *outIdx = transpose ? colIdx.ptr : rowIdx.ptr;
+    const int *inIdx  = transpose ? rowIdx.ptr : colIdx.ptr;
+
+    for (int o = blockIdx.y; o < out.dims[1]; o += gridDim.y) {
+        const T *x = rhs.ptr + o * rhs.strides[1];
+        T *y       = out.ptr + o * out.strides[1];
+
+        int row = -1;
+        T sum   = scalar<T>(0);
+        for (int id = first; id < last; ++id) {
+            const int r = outIdx[id];
+            if (r != row) {
+                if (row >= 0) { cooAtomicAdd(y + row, sum); }
+                row = r;
+                sum = scalar<T>(0);
+            }
+            const T v = conjugate ? conj(values.ptr[id]) : values.ptr[id];
+            sum       = sum + v * x[inIdx[id]];
+        }
+        if (row >= 0) { cooAtomicAdd(y + row, sum); }
+    }
+}
+
+}  // namespace cuda
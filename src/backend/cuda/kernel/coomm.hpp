@@ -0,0 +1,57 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_cuda.hpp>
+#include <nvrtc_kernel_headers/coomm_cuh.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace cuda {
+namespace kernel {
+
+constexpr int COOMM_THREADS        = 256;
+constexpr int COOMM_NNZ_PER_THREAD = 8;
+
+/// Adds op(lhs) * rhs to \p out, which is zero, for the COO matrix lhs of
+/// \p values, \p rowIdx and \p colIdx. op is the identity, or the transpose
+/// or the conjugate transpose when \p transpose is true.
+template<typename T>
+void coomm(Param<T> out, CParam<T> values, CParam<int> rowIdx,
+           CParam<int> colIdx, CParam<T> rhs, const bool transpose,
+           const bool conjugate) {
+    const int nnz = values.dims[0];
+    if (nnz == 0) { return; }
+
+    static const std::string source(coomm_cuh, coomm_cuh_len);
+
+    auto coomm = common::getKernel("cuda::coomm", {source},
+                                   {TemplateTypename<T>(),
+                                    TemplateArg(transpose),
+                                    TemplateArg(conjugate)});
+
+    const int maxBlocksY =
+        cuda::getDeviceProp(cuda::getActiveDeviceId()).maxGridSize[1];
+    dim3 threads(COOMM_THREADS);
+    dim3 blocks(divup(divup(nnz, COOMM_NNZ_PER_THREAD), COOMM_THREADS),
+                std::min<int>(out.dims[1], maxBlocksY));
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream());
+
+    coomm(qArgs, out, values, rowIdx, colIdx, rhs, COOMM_NNZ_PER_THREAD);
+    POST_LAUNCH_CHECK();
+}
+
+}  // namespace kernel
+}  // namespace cuda
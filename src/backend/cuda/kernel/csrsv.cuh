@@ -0,0 +1,46 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <math.hpp>
+
+namespace cuda {
+
+// One thread solves one row of a level of the triangle for one column of x.
+// The rows of the previous levels are already solved.
+
+template<typename T, bool upper, bool unit>
+__global__ void csrsvLevel(Param<T> x, CParam<T> values, CParam<int> rowIdx,
+                           CParam<int> colIdx, CParam<int> levelRows,
+                           const int first, const int count) {
+    const int id = blockIdx.x * blockDim.x + threadIdx.x;
+    if (id >= count) return;
+
+    const int row = levelRows.ptr[first + id];
+    const int end = rowIdx.ptr[row + 1];
+
+    for (int o = blockIdx.y; o < x.dims[1]; o += gridDim.y) {
+        T *y   = x.ptr + o * x.strides[1];
+        T sum  = y[row];
+        T diag = scalar<T>(1);
+        for (int j = rowIdx.ptr[row]; j < end; ++j) {
+            const int col = colIdx.ptr[j];
+            if (upper ? col > row : col < row) {
+                sum = sum - values.ptr[j] * y[col];
+            } else if (col == row) {
+                diag = values.ptr[j];
+            }
+        }
+        y[row] = unit ? sum : sum / diag;
+    }
+}
+
+}  // namespace cuda
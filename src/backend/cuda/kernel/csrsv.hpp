@@ -0,0 +1,60 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <common/sparse_triangular.hpp>
+#include <debug_cuda.hpp>
+#include <nvrtc_kernel_headers/csrsv_cuh.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace cuda {
+namespace kernel {
+
+constexpr int CSRSV_THREADS = 256;
+
+/// Solves the lower or the \p upper triangle of the CSR matrix of \p values,
+/// \p rowIdx and \p colIdx in place of the columns of \p x, one level of
+/// \p levels after the other
+template<typename T>
+void csrsv(Param<T> x, CParam<T> values, CParam<int> rowIdx,
+           CParam<int> colIdx, const common::TriangularLevels &levels,
+           const bool upper, const bool unit) {
+    static const std::string source(csrsv_cuh, csrsv_cuh_len);
+
+    auto csrsvLevel = common::getKernel(
+        "cuda::csrsvLevel", {source},
+        {TemplateTypename<T>(), TemplateArg(upper), TemplateArg(unit)});
+
+    const int maxBlocksY =
+        cuda::getDeviceProp(cuda::getActiveDeviceId()).maxGridSize[1];
+    const int cols = std::min<int>(x.dims[1], maxBlocksY);
+
+    CParam<int> levelRows = levels.rows;
+    for (size_t l = 0; l + 1 < levels.offsets.size(); ++l) {
+        const int first = levels.offsets[l];
+        const int count = levels.offsets[l + 1] - first;
+
+        dim3 threads(CSRSV_THREADS);
+        dim3 blocks(divup(count, CSRSV_THREADS), cols);
+
+        EnqueueArgs qArgs(blocks, threads, getActiveStream());
+
+        csrsvLevel(qArgs, x, values, rowIdx, colIdx, levelRows, first, count);
+        POST_LAUNCH_CHECK();
+    }
+}
+
+}  // namespace kernel
+}  // namespace cuda
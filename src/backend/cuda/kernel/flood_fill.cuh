@@ -11,11 +11,6 @@
 #include <af/defines.h>
 #include <math.hpp>
 
-/// doAnotherLaunch is a variable in kernel space
-/// used to track the convergence of
-/// the breath first search algorithm
-__device__ int doAnotherLaunch = 0;
-
 namespace cuda {
 
 /// Output array is set to the following values during the progression
@@ -44,7 +39,12 @@ void initSeeds(Param<T> out, CParam<uint> seedsx, CParam<uint> seedsy) {
 
 template<typename T>
 __global__
-void floodStep(Param<T> out, CParam<T> img, T lowValue, T highValue) {
+void floodStep(Param<T> out, CParam<T> img, T lowValue, T highValue,
+               int *doAnotherLaunch, int iter) {
+    // The previous launch of the batch changed nothing, so the search has
+    // converged
+    if (iter > 0 && doAnotherLaunch[iter - 1] == 0) return;
+
     constexpr int RADIUS      = 1;
     constexpr int SMEM_WIDTH  = THREADS_X + 2 * RADIUS;
     constexpr int SMEM_HEIGHT = THREADS_Y + 2 * RADIUS;
@@ -117,7 +117,7 @@ void floodStep(Param<T> out, CParam<T> img, T lowValue, T highValue) {
         // Atleast one border pixel changed. Therefore, mark for
         // another kernel launch to propogate changes beyond border
         // of this block
-        doAnotherLaunch = 1;
+        doAnotherLaunch[iter] = 1;
     }
 
     if (gx < d0 && gy < d1) {
@@ -14,6 +14,7 @@
 #include <common/dispatch.hpp>
 #include <common/kernel_cache.hpp>
 #include <debug_cuda.hpp>
+#include <kernel/converge.hpp>
 #include <nvrtc_kernel_headers/flood_fill_cuh.hpp>
 
 #include <string>
@@ -67,15 +68,10 @@ void floodFill(Param<T> out, CParam<T> image, CParam<uint> seedsx,
                 divup(image.dims[1], threads.y));
     EnqueueArgs fQArgs(blocks, threads, getActiveStream());
 
-    auto continueFlagPtr = floodStep.getDevPtr("doAnotherLaunch");
-
-    for (int doAnotherLaunch = 1; doAnotherLaunch > 0;) {
-        doAnotherLaunch = 0;
-        floodStep.setFlag(continueFlagPtr, &doAnotherLaunch);
-        floodStep(fQArgs, out, image, lowValue, highValue);
+    launchUntilConverged([&](int *flags, int iter) {
+        floodStep(fQArgs, out, image, lowValue, highValue, flags, iter);
         POST_LAUNCH_CHECK();
-        doAnotherLaunch = floodStep.getFlag(continueFlagPtr);
-    }
+    });
     finalizeOutput(fQArgs, out, newValue);
     POST_LAUNCH_CHECK();
 }
@@ -0,0 +1,64 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <math.hpp>
+#include <types.hpp>
+
+namespace cuda {
+
+// Complex values are only launched with AF_GEMM_EPILOGUE_NONE
+template<typename T, af::gemmEpilogue epilogue>
+struct gemmActivation {
+    __device__ T operator()(T x) const { return x; }
+};
+
+template<typename T>
+struct gemmActivation<T, AF_GEMM_EPILOGUE_RELU> {
+    __device__ T operator()(T x) const { return x > T(0) ? x : T(0); }
+};
+
+template<typename T>
+struct gemmActivation<T, AF_GEMM_EPILOGUE_GELU> {
+    __device__ T operator()(T x) const {
+        const T k = T(0.7978845608028654);  // sqrt(2 / pi)
+        return T(0.5) * x * (T(1) + tanh(k * (x + T(0.044715) * x * x * x)));
+    }
+};
+
+template<typename T, bool hasBias, af::gemmEpilogue epilogue>
+__global__ void gemmEpilogue(Param<T> out, CParam<T> bias, int blocks_x,
+                             int blocks_y) {
+    using CT = compute_t<T>;
+
+    const int idz = blockIdx.x / blocks_x;
+    const int idw = (blockIdx.y + blockIdx.z * gridDim.y) / blocks_y;
+
+    const int blockIdx_x = blockIdx.x - idz * blocks_x;
+    const int blockIdx_y =
+        (blockIdx.y + blockIdx.z * gridDim.y) - idw * blocks_y;
+
+    const int idx = threadIdx.x + blockIdx_x * blockDim.x;
+    const int idy = threadIdx.y + blockIdx_y * blockDim.y;
+
+    if (idx >= out.dims[0] || idy >= out.dims[1] || idz >= out.dims[2] ||
+        idw >= out.dims[3])
+        return;
+
+    T *optr = out.ptr + idw * out.strides[3] + idz * out.strides[2] +
+              idy * out.strides[1] + idx;
+
+    CT x = static_cast<CT>(*optr);
+    if (hasBias) { x = x + static_cast<CT>(bias.ptr[idx * bias.strides[0]]); }
+    *optr = static_cast<T>(gemmActivation<CT, epilogue>()(x));
+}
+
+}  // namespace cuda
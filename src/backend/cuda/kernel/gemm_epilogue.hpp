@@ -0,0 +1,53 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_cuda.hpp>
+#include <nvrtc_kernel_headers/gemm_epilogue_cuh.hpp>
+#include <af/defines.h>
+
+#include <string>
+
+namespace cuda {
+namespace kernel {
+
+/// Adds the column vector \p bias to every column of \p out and applies the
+/// activation of \p epilogue in place. An empty \p bias adds nothing.
+template<typename T>
+void gemmEpilogue(Param<T> out, CParam<T> bias, af_gemm_epilogue epilogue) {
+    static const std::string source(gemm_epilogue_cuh, gemm_epilogue_cuh_len);
+
+    const bool hasBias = bias.dims[0] > 0;
+
+    auto epilogueOp = common::getKernel(
+        "cuda::gemmEpilogue", {source},
+        {TemplateTypename<T>(), TemplateArg(hasBias), TemplateArg(epilogue)});
+
+    dim3 threads(32, 8);
+    int blocks_x = divup(out.dims[0], threads.x);
+    int blocks_y = divup(out.dims[1], threads.y);
+    dim3 blocks(blocks_x * out.dims[2], blocks_y * out.dims[3]);
+
+    const int maxBlocksY =
+        cuda::getDeviceProp(cuda::getActiveDeviceId()).maxGridSize[1];
+    blocks.z = divup(blocks.y, maxBlocksY);
+    blocks.y = divup(blocks.y, blocks.z);
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream());
+
+    epilogueOp(qArgs, out, bias, blocks_x, blocks_y);
+    POST_LAUNCH_CHECK();
+}
+
+}  // namespace kernel
+}  // namespace cuda
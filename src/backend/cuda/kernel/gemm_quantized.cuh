@@ -0,0 +1,83 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <types.hpp>
+
+namespace cuda {
+
+// Every block computes a TILE x TILE tile of the product. The zero points
+// are subtracted while the tiles of op(lhs) and op(rhs) are loaded.
+template<bool lhsTrans, bool rhsTrans>
+__global__ void gemmQuantized(Param<int> out, CParam<uchar> lhs,
+                              CParam<uchar> rhs, int lhsZero, int rhsZero,
+                              int blocks_x, int blocks_y) {
+    constexpr int TILE = 16;
+    __shared__ int lTile[TILE][TILE + 1];
+    __shared__ int rTile[TILE][TILE + 1];
+
+    const int idz = blockIdx.x / blocks_x;
+    const int idw = (blockIdx.y + blockIdx.z * gridDim.y) / blocks_y;
+    if (idz >= out.dims[2] || idw >= out.dims[3]) return;
+
+    const int blockIdx_x = blockIdx.x - idz * blocks_x;
+    const int blockIdx_y =
+        (blockIdx.y + blockIdx.z * gridDim.y) - idw * blocks_y;
+
+    const int tx  = threadIdx.x;
+    const int ty  = threadIdx.y;
+    const int row = blockIdx_x * TILE + tx;
+    const int col = blockIdx_y * TILE + ty;
+    const int M   = out.dims[0];
+    const int N   = out.dims[1];
+    const int K   = lhsTrans ? lhs.dims[0] : lhs.dims[1];
+
+    const uchar *lptr = lhs.ptr +
+                        (lhs.dims[2] == 1 ? 0 : idz) * lhs.strides[2] +
+                        (lhs.dims[3] == 1 ? 0 : idw) * lhs.strides[3];
+    const uchar *rptr = rhs.ptr +
+                        (rhs.dims[2] == 1 ? 0 : idz) * rhs.strides[2] +
+                        (rhs.dims[3] == 1 ? 0 : idw) * rhs.strides[3];
+    const int lStride = lhs.strides[1];
+    const int rStride = rhs.strides[1];
+
+    int acc = 0;
+    for (int k0 = 0; k0 < K; k0 += TILE) {
+        // lTile[ty][tx] is op(lhs)(row, k0 + ty) and rTile[ty][tx] is
+        // op(rhs)(k0 + tx, col)
+        int k = k0 + ty;
+        lTile[ty][tx] =
+            (row < M && k < K)
+                ? lptr[lhsTrans ? k + row * lStride : row + k * lStride] -
+                      lhsZero
+                : 0;
+        k = k0 + tx;
+        rTile[ty][tx] =
+            (col < N && k < K)
+                ? rptr[rhsTrans ? col + k * rStride : k + col * rStride] -
+                      rhsZero
+                : 0;
+        __syncthreads();
+
+#pragma unroll
+        for (int kk = 0; kk < TILE; kk++) {
+            acc += lTile[kk][tx] * rTile[ty][kk];
+        }
+        __syncthreads();
+    }
+
+    if (row < M && col < N) {
+        out.ptr[idw * out.strides[3] + idz * out.strides[2] +
+                col * out.strides[1] + row] = acc;
+    }
+}
+
+}  // namespace cuda
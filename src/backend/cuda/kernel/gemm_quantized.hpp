@@ -0,0 +1,53 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_cuda.hpp>
+#include <nvrtc_kernel_headers/gemm_quantized_cuh.hpp>
+#include <af/defines.h>
+
+#include <string>
+
+namespace cuda {
+namespace kernel {
+
+/// Computes out = (op(lhs) - lhsZero) (op(rhs) - rhsZero) in 32-bit integers
+inline void gemmQuantized(Param<int> out, CParam<uchar> lhs, CParam<uchar> rhs,
+                          af_mat_prop optLhs, af_mat_prop optRhs, int lhsZero,
+                          int rhsZero) {
+    static const std::string source(gemm_quantized_cuh,
+                                    gemm_quantized_cuh_len);
+
+    auto gemmOp = common::getKernel("cuda::gemmQuantized", {source},
+                                    {TemplateArg(optLhs != AF_MAT_NONE),
+                                     TemplateArg(optRhs != AF_MAT_NONE)});
+
+    // The kernel uses tiles of 16 x 16
+    dim3 threads(16, 16);
+    int blocks_x = divup(out.dims[0], threads.x);
+    int blocks_y = divup(out.dims[1], threads.y);
+    dim3 blocks(blocks_x * out.dims[2], blocks_y * out.dims[3]);
+
+    const int maxBlocksY =
+        cuda::getDeviceProp(cuda::getActiveDeviceId()).maxGridSize[1];
+    blocks.z = divup(blocks.y, maxBlocksY);
+    blocks.y = divup(blocks.y, blocks.z);
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream());
+
+    gemmOp(qArgs, out, lhs, rhs, lhsZero, rhsZero, blocks_x, blocks_y);
+    POST_LAUNCH_CHECK();
+}
+
+}  // namespace kernel
+}  // namespace cuda
@@ -16,7 +16,6 @@
 #include <af/constants.h>
 
 #include "config.hpp"
-#include "convolve.hpp"
 #include "gradient.hpp"
 #include "range.hpp"
 #include "sort_by_key.hpp"
@@ -58,38 +57,86 @@ inline __device__ double max_val(const double x, const double y) {
     return fmax(x, y);
 }
 
-template<typename T>
-__global__ void second_order_deriv(T* ixx_out, T* ixy_out, T* iyy_out,
-                                   const unsigned in_len, const T* ix_in,
-                                   const T* iy_in) {
-    const unsigned x = blockDim.x * blockIdx.x + threadIdx.x;
-
-    if (x < in_len) {
-        ixx_out[x] = ix_in[x] * ix_in[x];
-        ixy_out[x] = ix_in[x] * iy_in[x];
-        iyy_out[x] = iy_in[x] * iy_in[x];
-    }
-}
+// The largest window filter, see af_harris
+static const unsigned MAX_FILTER_LEN = 32;
 
-template<typename T>
+// Computes the Harris responses of a BLOCK_SIZE x BLOCK_SIZE tile of pixels
+// at least border_len away from the border from the first order derivatives.
+// The threads of a block first filter the products of the derivatives along
+// dimension 0 for all the columns the windows of the tile overlap, into
+// shared memory, and then filter them along dimension 1 and compute the
+// responses. The products and the filtered products are never written to
+// global memory.
+template<typename T, typename convAccT>
 __global__ void harris_responses(T* resp_out, const unsigned idim0,
-                                 const unsigned idim1, const T* ixx_in,
-                                 const T* ixy_in, const T* iyy_in,
-                                 const float k_thr, const unsigned border_len) {
-    const unsigned r = border_len;
-
-    const unsigned x = blockDim.x * blockIdx.x + threadIdx.x + r;
-    const unsigned y = blockDim.y * blockIdx.y + threadIdx.y + r;
+                                 const unsigned idim1, const T* ix_in,
+                                 const T* iy_in, const convAccT* filter,
+                                 const unsigned filter_len, const float k_thr,
+                                 const unsigned border_len) {
+    __shared__ convAccT s_filter[MAX_FILTER_LEN];
+    __shared__ T s_xx[BLOCK_SIZE + MAX_FILTER_LEN - 1][BLOCK_SIZE];
+    __shared__ T s_xy[BLOCK_SIZE + MAX_FILTER_LEN - 1][BLOCK_SIZE];
+    __shared__ T s_yy[BLOCK_SIZE + MAX_FILTER_LEN - 1][BLOCK_SIZE];
+
+    const unsigned r     = border_len;
+    const unsigned start = filter_len / 2;
+
+    const unsigned tid = threadIdx.y * blockDim.x + threadIdx.x;
+    if (tid < filter_len) { s_filter[tid] = filter[tid]; }
+
+    // Consecutive threads read consecutive rows of the derivatives
+    const unsigned y  = blockDim.x * blockIdx.x + threadIdx.x + r;
+    const unsigned x0 = blockDim.y * blockIdx.y + r;
+    const bool rowIn  = y < idim0 - r;
+
+    __syncthreads();
+
+    // Column j of the tile is column x0 + start + 1 - filter_len + j of the
+    // image. It is not negative because border_len > filter_len / 2.
+    const unsigned cols = blockDim.y + filter_len - 1;
+    for (unsigned j = threadIdx.y; j < cols; j += blockDim.y) {
+        const unsigned c = x0 + start + 1 - filter_len + j;
+
+        convAccT xx = 0, xy = 0, yy = 0;
+        if (rowIn && c < idim1) {
+            const T* dx = ix_in + c * idim0 + y + start;
+            const T* dy = iy_in + c * idim0 + y + start;
+            for (unsigned f = 0; f < filter_len; f++) {
+                const T vx = dx[-(int)f];
+                const T vy = dy[-(int)f];
+                xx += (convAccT)(vx * vx) * s_filter[f];
+                xy += (convAccT)(vx * vy) * s_filter[f];
+                yy += (convAccT)(vy * vy) * s_filter[f];
+            }
+        }
+        s_xx[j][threadIdx.x] = (T)xx;
+        s_xy[j][threadIdx.x] = (T)xy;
+        s_yy[j][threadIdx.x] = (T)yy;
+    }
 
-    if (x < idim1 - r && y < idim0 - r) {
-        const unsigned idx = x * idim0 + y;
+    __syncthreads();
+
+    const unsigned x = x0 + threadIdx.y;
+    if (rowIn && x < idim1 - r) {
+        // Column x + start - f of the image is column
+        // threadIdx.y + filter_len - 1 - f of the tile
+        convAccT xx = 0, xy = 0, yy = 0;
+        for (unsigned f = 0; f < filter_len; f++) {
+            const unsigned j = threadIdx.y + filter_len - 1 - f;
+            xx += (convAccT)s_xx[j][threadIdx.x] * s_filter[f];
+            xy += (convAccT)s_xy[j][threadIdx.x] * s_filter[f];
+            yy += (convAccT)s_yy[j][threadIdx.x] * s_filter[f];
+        }
+        const T ixx = (T)xx;
+        const T ixy = (T)xy;
+        const T iyy = (T)yy;
 
         // Calculates matrix trace and determinant
-        T tr  = ixx_in[idx] + iyy_in[idx];
-        T det = ixx_in[idx] * iyy_in[idx] - ixy_in[idx] * ixy_in[idx];
+        T tr  = ixx + iyy;
+        T det = ixx * iyy - ixy * ixy;
 
         // Calculates local Harris response
-        resp_out[idx] = det - k_thr * (tr * tr);
+        resp_out[x * idim0 + y] = det - k_thr * (tr * tr);
     }
 }
 
@@ -195,43 +242,6 @@ void harris(unsigned* corners_out, float** x_out, float** y_out,
     // Compute first-order derivatives as gradients
     gradient<T>(iy, ix, in);
 
-    Param<T> ixx, ixy, iyy;
-    Param<T> ixx_tmp, ixy_tmp, iyy_tmp;
-    for (dim_t i = 0; i < 4; i++) {
-        ixx.dims[i] = ixy.dims[i] = iyy.dims[i] = in.dims[i];
-        ixx_tmp.dims[i] = ixy_tmp.dims[i] = iyy_tmp.dims[i] = in.dims[i];
-        ixx.strides[i] = ixy.strides[i] = iyy.strides[i] = in.strides[i];
-        ixx_tmp.strides[i] = ixy_tmp.strides[i] = iyy_tmp.strides[i] =
-            in.strides[i];
-    }
-    auto ixx_alloc = memAlloc<T>(ixx.dims[3] * ixx.strides[3]);
-    auto ixy_alloc = memAlloc<T>(ixy.dims[3] * ixy.strides[3]);
-    auto iyy_alloc = memAlloc<T>(iyy.dims[3] * iyy.strides[3]);
-    ixx.ptr        = ixx_alloc.get();
-    ixy.ptr        = ixy_alloc.get();
-    iyy.ptr        = iyy_alloc.get();
-
-    // Compute second-order derivatives
-    dim3 threads(THREADS_PER_BLOCK, 1);
-    dim3 blocks(divup(in.dims[3] * in.strides[3], threads.x), 1);
-    CUDA_LAUNCH((second_order_deriv<T>), blocks, threads, ixx.ptr, ixy.ptr,
-                iyy.ptr, in.dims[3] * in.strides[3], ix.ptr, iy.ptr);
-
-    auto ixx_tmp_alloc = memAlloc<T>(ixx_tmp.dims[3] * ixx_tmp.strides[3]);
-    auto ixy_tmp_alloc = memAlloc<T>(ixy_tmp.dims[3] * ixy_tmp.strides[3]);
-    auto iyy_tmp_alloc = memAlloc<T>(iyy_tmp.dims[3] * iyy_tmp.strides[3]);
-    ixx_tmp.ptr        = ixx_tmp_alloc.get();
-    ixy_tmp.ptr        = ixy_tmp_alloc.get();
-    iyy_tmp.ptr        = iyy_tmp_alloc.get();
-
-    // Convolve second-order derivatives with proper window filter
-    convolve2<T, convAccT>(ixx_tmp, CParam<T>(ixx), filter, 0, false);
-    convolve2<T, convAccT>(ixx, CParam<T>(ixx_tmp), filter, 1, false);
-    convolve2<T, convAccT>(ixy_tmp, CParam<T>(ixy), filter, 0, false);
-    convolve2<T, convAccT>(ixy, CParam<T>(ixy_tmp), filter, 1, false);
-    convolve2<T, convAccT>(iyy_tmp, CParam<T>(iyy), filter, 0, false);
-    convolve2<T, convAccT>(iyy, CParam<T>(iyy_tmp), filter, 1, false);
-
     // Number of corners is not known a priori, limit maximum number of corners
     // according to image dimensions
     unsigned corner_lim = in.dims[3] * in.strides[3] * 0.2f;
@@ -246,13 +256,18 @@ void harris(unsigned* corners_out, float** x_out, float** y_out,
 
     auto d_responses = memAlloc<T>(in.dims[3] * in.strides[3]);
 
-    // Calculate Harris responses for all pixels
-    threads = dim3(BLOCK_SIZE, BLOCK_SIZE);
-    blocks  = dim3(divup(in.dims[1] - border_len * 2, threads.x),
-                  divup(in.dims[0] - border_len * 2, threads.y));
-    CUDA_LAUNCH((harris_responses<T>), blocks, threads, d_responses.get(),
-                in.dims[0], in.dims[1], ixx.ptr, ixy.ptr, iyy.ptr, k_thr,
-                border_len);
+    // Calculate Harris responses for all pixels, filtering the products of
+    // the derivatives in shared memory
+    dim3 threads(BLOCK_SIZE, BLOCK_SIZE);
+    dim3 blocks(divup(in.dims[0] - border_len * 2, threads.x),
+                divup(in.dims[1] - border_len * 2, threads.y));
+    CUDA_LAUNCH((harris_responses<T, convAccT>), blocks, threads,
+                d_responses.get(), in.dims[0], in.dims[1], ix.ptr, iy.ptr,
+                filter.ptr, filter_len, k_thr, border_len);
+
+    // Non-maximal suppression kernel sizes
+    blocks = dim3(divup(in.dims[1] - border_len * 2, threads.x),
+                 divup(in.dims[0] - border_len * 2, threads.y));
 
     const float min_r = (max_corners > 0) ? 0.f : min_response;
 
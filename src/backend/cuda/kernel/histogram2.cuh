@@ -0,0 +1,91 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Param.hpp>
+#include <shared.hpp>
+
+namespace cuda {
+
+template<typename To>
+__device__ To binWeight(const float *weights, int idx);
+
+template<>
+__device__ uint binWeight<uint>(const float *weights, int idx) {
+    return 1;
+}
+
+template<>
+__device__ float binWeight<float>(const float *weights, int idx) {
+    return weights[idx];
+}
+
+__device__ int binIndex(float value, float minval, float step, int nbins) {
+    int bin = (int)((value - minval) / step);
+    bin     = (bin < 0) ? 0 : bin;
+    return (bin >= nbins) ? (nbins - 1) : bin;
+}
+
+// Each block adds THRD_LOAD * blockDim.x pairs to the joint histogram. The
+// updates go to copies of the histogram in shared memory, which are added to
+// the output at the end, so the threads of different copies do not contend
+// on the same bins. The copies are shared by the warps when copies is the
+// number of warps, by the block when it is 1, and the updates go to the
+// output directly when it is 0.
+template<typename T, typename To>
+__global__ void histogram2(Param<To> out, CParam<T> x, CParam<T> y,
+                           CParam<float> weights, int len, int xbins,
+                           int ybins, float xmin, float xstep, float ymin,
+                           float ystep, int copies, int nBBS) {
+    SharedMemory<To> shared;
+    To *shrdMem = shared.getPointer();
+
+    // offset inputs and output to account for batch ops
+    const int nbins   = xbins * ybins;
+    const unsigned b2 = blockIdx.x / nBBS;
+    const unsigned b3 = blockIdx.y;
+    const T *xptr     = x.ptr + b2 * x.strides[2] + b3 * x.strides[3];
+    const T *yptr     = y.ptr + b2 * y.strides[2] + b3 * y.strides[3];
+    const float *wptr =
+        weights.ptr + b2 * weights.strides[2] + b3 * weights.strides[3];
+    To *optr = out.ptr + b2 * out.strides[2] + b3 * out.strides[3];
+
+    for (int i = threadIdx.x; i < nbins * copies; i += blockDim.x) {
+        shrdMem[i] = 0;
+    }
+    if (copies > 0) { __syncthreads(); }
+
+    To *hist =
+        copies > 0 ? shrdMem + (threadIdx.x * copies / blockDim.x) * nbins
+                   : optr;
+
+    int start = (blockIdx.x - b2 * nBBS) * THRD_LOAD * blockDim.x + threadIdx.x;
+    int end   = min((start + THRD_LOAD * blockDim.x), len);
+
+    for (int i = start; i < end; i += blockDim.x) {
+        const int i0   = i % x.dims[0];
+        const int i1   = i / x.dims[0];
+        const float xv = static_cast<float>(xptr[i0 + i1 * x.strides[1]]);
+        const float yv = static_cast<float>(yptr[i0 + i1 * y.strides[1]]);
+        const int xb   = binIndex(xv, xmin, xstep, xbins);
+        const int yb   = binIndex(yv, ymin, ystep, ybins);
+        atomicAdd(hist + xb + yb * xbins,
+                  binWeight<To>(wptr, i0 + i1 * weights.strides[1]));
+    }
+
+    if (copies > 0) {
+        __syncthreads();
+        for (int i = threadIdx.x; i < nbins; i += blockDim.x) {
+            To sum = 0;
+            for (int c = 0; c < copies; ++c) { sum += shrdMem[c * nbins + i]; }
+            if (sum != To(0)) { atomicAdd(optr + i, sum); }
+        }
+    }
+}
+
+}  // namespace cuda
@@ -0,0 +1,80 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_cuda.hpp>
+#include <nvrtc_kernel_headers/histogram2_cuh.hpp>
+#include <platform.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace cuda {
+namespace kernel {
+
+constexpr int HIST2_THREADS   = 256;
+constexpr int HIST2_THRD_LOAD = 16;
+
+/// The number of copies of a histogram of \p nbins bins of \p binSize bytes
+/// that a block of \p threads threads keeps in \p sharedSize bytes of shared
+/// memory for \p blockElems elements. Each warp has its own copy when the
+/// copies fit and there are fewer bins than elements per warp, and the block
+/// has one copy when it fits and there are fewer bins than elements.
+/// Otherwise the copies would cost more to clear and add than the updates
+/// they save, and there are none.
+inline int histogramCopies(const int nbins, const int blockElems,
+                           const int threads, const size_t binSize,
+                           const size_t sharedSize) {
+    const int warps = threads / 32;
+    if (nbins * warps * binSize <= sharedSize && nbins <= blockElems / warps) {
+        return warps;
+    }
+    if (nbins * binSize <= sharedSize && nbins <= blockElems) { return 1; }
+    return 0;
+}
+
+template<typename T, typename To>
+void histogram2(Param<To> out, CParam<T> x, CParam<T> y, CParam<float> weights,
+                const unsigned xbins, const unsigned ybins, const double xmin,
+                const double xmax, const double ymin, const double ymax) {
+    static const std::string source(histogram2_cuh, histogram2_cuh_len);
+
+    auto histogram2 = common::getKernel(
+        "cuda::histogram2", {source},
+        {TemplateTypename<T>(), TemplateTypename<To>()},
+        {DefineKeyValue(THRD_LOAD, HIST2_THRD_LOAD)});
+
+    const int nElems     = x.dims[0] * x.dims[1];
+    const int nbins      = xbins * ybins;
+    const int blk_x      = divup(nElems, HIST2_THRD_LOAD * HIST2_THREADS);
+    const int blockElems = std::min(nElems, HIST2_THRD_LOAD * HIST2_THREADS);
+    const size_t sharedSize =
+        getDeviceProp(getActiveDeviceId()).sharedMemPerBlock;
+    const int copies = histogramCopies(nbins, blockElems, HIST2_THREADS,
+                                       sizeof(To), sharedSize);
+
+    dim3 threads(HIST2_THREADS, 1);
+    dim3 blocks(blk_x * x.dims[2], x.dims[3]);
+
+    const float xstep = (xmax - xmin) / (float)xbins;
+    const float ystep = (ymax - ymin) / (float)ybins;
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream(),
+                      nbins * copies * sizeof(To));
+    histogram2(qArgs, out, x, y, weights, nElems, xbins, ybins, float(xmin),
+               xstep, float(ymin), ystep, copies, blk_x);
+    POST_LAUNCH_CHECK();
+}
+
+}  // namespace kernel
+}  // namespace cuda
@@ -0,0 +1,42 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+
+namespace cuda {
+
+/// Returns the element \p i of \p in, in column major order
+template<typename T>
+__device__ T vertexComponent(const CParam<T> &in, dim_t i) {
+    const dim_t i0 = i % in.dims[0];
+    i /= in.dims[0];
+    const dim_t i1 = i % in.dims[1];
+    i /= in.dims[1];
+    const dim_t i2 = i % in.dims[2];
+    const dim_t i3 = i / in.dims[2];
+    return in.ptr[i0 * in.strides[0] + i1 * in.strides[1] +
+                  i2 * in.strides[2] + i3 * in.strides[3]];
+}
+
+template<typename T, int components>
+__global__ void interleave(T *out, CParam<T> c0, CParam<T> c1, CParam<T> c2,
+                           const dim_t vertices) {
+    const dim_t step = static_cast<dim_t>(gridDim.x) * blockDim.x;
+    for (dim_t i = blockIdx.x * static_cast<dim_t>(blockDim.x) + threadIdx.x;
+         i < vertices; i += step) {
+        T *vertex = out + i * components;
+        vertex[0] = vertexComponent(c0, i);
+        vertex[1] = vertexComponent(c1, i);
+        if (components == 3) { vertex[2] = vertexComponent(c2, i); }
+    }
+}
+
+}  // namespace cuda
@@ -0,0 +1,55 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_cuda.hpp>
+#include <nvrtc_kernel_headers/interleave_cuh.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace cuda {
+namespace kernel {
+
+/// Writes the vertices of the 2 or 3 \p components to \p out on \p stream,
+/// with the components of a vertex next to each other. The component c of
+/// the vertex i is the element i of components[c], read with its dims and
+/// strides, so \p out can be the mapped buffer of a Forge object.
+template<typename T>
+void interleave(T *out, const std::vector<CParam<T>> &components,
+                cudaStream_t stream) {
+    constexpr int THREADS    = 256;
+    constexpr int MAX_BLOCKS = 65535;
+
+    static const std::string src(interleave_cuh, interleave_cuh_len);
+
+    const int count      = static_cast<int>(components.size());
+    const dim_t vertices = components[0].elements();
+    if (vertices == 0) { return; }
+
+    auto interleave = common::getKernel(
+        "cuda::interleave", {src}, {TemplateTypename<T>(), TemplateArg(count)});
+
+    const int blocks = static_cast<int>(
+        std::min<dim_t>(divup(vertices, THREADS), MAX_BLOCKS));
+
+    EnqueueArgs qArgs(dim3(blocks), dim3(THREADS), stream);
+
+    interleave(qArgs, out, components[0], components[1],
+               components[count - 1], vertices);
+    POST_LAUNCH_CHECK();
+}
+
+}  // namespace kernel
+}  // namespace cuda
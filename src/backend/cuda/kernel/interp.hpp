@@ -327,4 +327,66 @@ struct Interp2<Ty, Tp, xdim, ydim, 3> {
     }
 };
 
+// Samples the first channel of the texture object tex at the unnormalized
+// coordinates (x, y). Written in PTX, so the kernels do not need the texture
+// headers of the runtime.
+__device__ inline float texSample2D(unsigned long long tex, float x, float y) {
+    float r, g, b, a;
+    asm volatile("tex.2d.v4.f32.f32 {%0, %1, %2, %3}, [%4, {%5, %6}];"
+                 : "=f"(r), "=f"(g), "=f"(b), "=f"(a)
+                 : "l"(tex), "f"(x), "f"(y));
+    return r;
+}
+
+// Interpolation of images stacked along the rows of a texture (see
+// Texture2D.hpp), starting at row row0. It has the boundary behavior of
+// Interp2 without clamping for nearest and with clamping for bilinear. Only
+// float images are sampled from textures.
+template<typename Ty, int order>
+struct TexInterp2 {
+    __device__ void operator()(Param<Ty> out, int ooff,
+                               unsigned long long tex, int row0, int x_lim,
+                               int y_lim, float x, float y,
+                               af::interpType method, int batch,
+                               int batch_dim = 2) {}
+};
+
+template<>
+struct TexInterp2<float, 1> {
+    __device__ void operator()(Param<float> out, int ooff,
+                               unsigned long long tex, int row0, int x_lim,
+                               int y_lim, float x, float y,
+                               af::interpType method, int batch,
+                               int batch_dim = 2) {
+        const int xid   = (method == AF_INTERP_LOWER ? floor(x) : round(x));
+        const int yid   = (method == AF_INTERP_LOWER ? floor(y) : round(y));
+        const bool cond = xid >= 0 && xid < x_lim && yid >= 0 && yid < y_lim;
+
+        for (int n = 0; n < batch; n++) {
+            const float row = row0 + n * y_lim + yid + 0.5f;
+            out.ptr[ooff + n * out.strides[batch_dim]] =
+                cond ? texSample2D(tex, xid + 0.5f, row) : 0.f;
+        }
+    }
+};
+
+template<>
+struct TexInterp2<float, 2> {
+    __device__ void operator()(Param<float> out, int ooff,
+                               unsigned long long tex, int row0, int x_lim,
+                               int y_lim, float x, float y,
+                               af::interpType method, int batch,
+                               int batch_dim = 2) {
+        // The texture clamps the columns, but the rows are clamped here so
+        // the rows of the neighboring images are never blended in
+        const float yc = fminf(fmaxf(y, 0.f), y_lim - 1.f);
+
+        for (int n = 0; n < batch; n++) {
+            const float row = row0 + n * y_lim + yc + 0.5f;
+            out.ptr[ooff + n * out.strides[batch_dim]] =
+                texSample2D(tex, x + 0.5f, row);
+        }
+    }
+};
+
 }  // namespace cuda
@@ -23,6 +23,13 @@ typedef cuDoubleComplex cdouble;
 #define __not_select(cond, a, b) (cond) ? (b) : (a)
 #define __circular_mod(a, b) ((a) < (b)) ? (a) : (a - b)
 
+// Maps an out of range lookup index back into [0, len) like trimIndex
+__device__ int __trim_index(int idx, int len) {
+    if (idx < 0) { return (abs(idx) - 1) % len; }
+    if (idx >= len) { return len - idx % len - 1; }
+    return idx;
+}
+
 // ----------------------------------------------
 // REAL NUMBER OPERATIONS
 // ----------------------------------------------
@@ -71,6 +78,18 @@ typedef cuDoubleComplex cdouble;
     __double2int_rn(pow(__int2double_rn(lhs), __int2double_rn(rhs)))
 
 #define __convert_char(val) (char)((val) != 0)
+
+// The bfloat16 values are stored as unsigned short. They are the upper half
+// of the bits of a float, rounded to the nearest even value.
+__device__ float __bfloat16_to_float(unsigned short in) {
+    return __uint_as_float(static_cast<unsigned>(in) << 16);
+}
+
+__device__ unsigned short __float_to_bfloat16(float in) {
+    unsigned bits = __float_as_uint(in);
+    if ((bits & 0x7FFFFFFFu) > 0x7F800000u) { return (bits >> 16) | 0x40u; }
+    return (bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16;
+}
 #define frem(lhs, rhs) remainder((lhs), (rhs))
 
 // ----------------------------------------------
@@ -243,3 +262,64 @@ int __isnan<__half>(const __half in) {
 #define __convert_cdouble(real) __cplx2(real, 0)
 #define __convert_z2z(in) (in)
 #define __convert_c2z(in) __cplx2((double)in.x, (double)in.y)
+
+// ----------------------------------------------
+// RANDOM NUMBER GENERATION
+// ----------------------------------------------
+
+// The Philox4x32-10 generator of the random engine
+__device__ __inline__ void __philoxRound(const uint k[2], uint c[4]) {
+    const uint hi0 = __umulhi(0xD2511F53, c[0]);
+    const uint lo0 = 0xD2511F53 * c[0];
+    const uint hi1 = __umulhi(0xCD9E8D57, c[2]);
+    const uint lo1 = 0xCD9E8D57 * c[2];
+    c[0]           = hi1 ^ c[1] ^ k[0];
+    c[1]           = lo1;
+    c[2]           = hi0 ^ c[3] ^ k[1];
+    c[3]           = lo0;
+}
+
+// Encrypts the counter of the thread of the uniform Philox kernel which writes
+// the value at idx. Each thread of the kernel writes perThread values, 256
+// values apart. Returns the index of the value among them.
+__device__ __inline__ uint __philoxValues(uint ctr[4], uint idx,
+                                          uint perThread, uint lo, uint hi,
+                                          uint loc, uint hic) {
+    const uint perBlock = 256 * perThread;
+    const uint index    = (idx / perBlock) * perBlock + idx % 256;
+    uint key[2]         = {lo, hi};
+    ctr[0]              = loc + index;
+    ctr[1]              = hic + (ctr[0] < loc);
+    ctr[2]              = (ctr[1] < hic);
+    ctr[3]              = 0;
+    for (int round = 0; round < 9; ++round) {
+        __philoxRound(key, ctr);
+        key[0] += 0x9E3779B9;
+        key[1] += 0xBB67AE85;
+    }
+    __philoxRound(key, ctr);
+    return (idx % perBlock) / 256;
+}
+
+// The value of a uniform float Philox array at idx
+__device__ __inline__ float __philoxUniformFloat(uint idx, uint lo, uint hi,
+                                                 uint loc, uint hic) {
+    // 2^-32, which maps the 32 bit values into (0, 1]
+    const float factor = 2.3283064365386962890625e-10f;
+    uint ctr[4];
+    const uint word = __philoxValues(ctr, idx, 4, lo, hi, loc, hic);
+    return 1.f - fmaf((float)ctr[word], factor, 0.5f * factor);
+}
+
+// The value of a uniform double Philox array at idx
+__device__ __inline__ double __philoxUniformDouble(uint idx, uint lo, uint hi,
+                                                   uint loc, uint hic) {
+    // 2^-64, which maps the 64 bit values into (0, 1]
+    const double factor =
+        2.3283064365386962890625e-10 * 2.3283064365386962890625e-10;
+    uint ctr[4];
+    const uint word = __philoxValues(ctr, idx, 2, lo, hi, loc, hic);
+    const unsigned long long num =
+        ((unsigned long long)ctr[2 * word] << 32) | ctr[2 * word + 1];
+    return 1.0 - fma((double)num, factor, 0.5 * factor);
+}
@@ -9,20 +9,57 @@
 
 #include <Param.hpp>
 #include <math.hpp>
+#include <shared.hpp>
 
 namespace cuda {
 
-template<typename AccType, typename T, int channels>
+// The pixels of the block and a halo of width halo around them are loaded
+// into shared memory when UseTile is true. The windows which lie inside the
+// tile are read from shared memory, the windows of means which shifted
+// further away are read from global memory.
+template<typename AccType, typename T, int channels, bool UseTile>
 __global__
-void meanshift(Param<T> out, CParam<T> in, int radius, float cvar,
+void meanshift(Param<T> out, CParam<T> in, int radius, int halo, float cvar,
                uint numIters, int nBBS0, int nBBS1) {
     unsigned b2 = blockIdx.x / nBBS0;
     unsigned b3 = blockIdx.y / nBBS1;
     const T* iptr =
         (const T*)in.ptr + (b2 * in.strides[2] + b3 * in.strides[3]);
     T* optr      = (T*)out.ptr + (b2 * out.strides[2] + b3 * out.strides[3]);
-    const int gx = blockDim.x * (blockIdx.x - b2 * nBBS0) + threadIdx.x;
-    const int gy = blockDim.y * (blockIdx.y - b3 * nBBS1) + threadIdx.y;
+    const int ox = blockDim.x * (blockIdx.x - b2 * nBBS0);
+    const int oy = blockDim.y * (blockIdx.y - b3 * nBBS1);
+    const int gx = ox + threadIdx.x;
+    const int gy = oy + threadIdx.y;
+
+    const int dim0LenLmt = in.dims[0] - 1;
+    const int dim1LenLmt = in.dims[1] - 1;
+
+    // The tile starts halo pixels before the block, its pixels are stored
+    // with interleaved channels
+    const int tileX = ox - halo;
+    const int tileY = oy - halo;
+    const int tileW = blockDim.x + 2 * halo;
+    const int tileH = blockDim.y + 2 * halo;
+
+    SharedMemory<T> shared;
+    T* tile = shared.getPointer();
+
+    if (UseTile) {
+        for (int b = threadIdx.y; b < tileH; b += blockDim.y) {
+            const int tj = tileY + b;
+            if (tj < 0 || tj > dim1LenLmt) continue;
+            for (int a = threadIdx.x; a < tileW; a += blockDim.x) {
+                const int ti = tileX + a;
+                if (ti < 0 || ti > dim0LenLmt) continue;
+#pragma unroll
+                for (int ch = 0; ch < channels; ++ch)
+                    tile[(b * tileW + a) * channels + ch] =
+                        iptr[ti * in.strides[0] + tj * in.strides[1] +
+                             ch * in.strides[2]];
+            }
+        }
+        __syncthreads();
+    }
 
     if (gx >= in.dims[0] || gy >= in.dims[1]) return;
 
@@ -39,9 +76,6 @@ void meanshift(Param<T> out, CParam<T> in, int radius, float cvar,
         currentCenterColors[ch] = iptr[(
             gx * in.strides[0] + gy * in.strides[1] + ch * in.strides[2])];
 
-    const int dim0LenLmt = in.dims[0] - 1;
-    const int dim1LenLmt = in.dims[1] - 1;
-
     // scope of meanshift iterations begin
     for (uint it = 0; it < numIters; ++it) {
         int oldMeanPosJ = meanPosJ;
@@ -51,6 +85,18 @@ void meanshift(Param<T> out, CParam<T> in, int radius, float cvar,
         int shift_x = 0;
         int shift_y = 0;
 
+        // The window is read from the tile if it lies inside of it
+        const bool inTile =
+            UseTile && meanPosI - radius >= tileX &&
+            meanPosI + radius < tileX + tileW && meanPosJ - radius >= tileY &&
+            meanPosJ + radius < tileY + tileH;
+        const T* wptr  = inTile ? tile : iptr;
+        const int offI = inTile ? tileX : 0;
+        const int offJ = inTile ? tileY : 0;
+        const int s0   = inTile ? channels : in.strides[0];
+        const int s1   = inTile ? tileW * channels : in.strides[1];
+        const int s2   = inTile ? 1 : in.strides[2];
+
 #pragma unroll
         for (int ch = 0; ch < channels; ++ch) currentMeanColors[ch] = 0;
 
@@ -68,9 +114,8 @@ void meanshift(Param<T> out, CParam<T> in, int radius, float cvar,
                 AccType norm = 0;
 #pragma unroll
                 for (int ch = 0; ch < channels; ++ch) {
-                    tempColors[ch] =
-                        iptr[(ti * in.strides[0] + tj * in.strides[1] +
-                              ch * in.strides[2])];
+                    tempColors[ch] = wptr[(ti - offI) * s0 +
+                                          (tj - offJ) * s1 + ch * s2];
                     AccType diff = (AccType)currentCenterColors[ch] -
                                    (AccType)tempColors[ch];
                     norm += (diff * diff);
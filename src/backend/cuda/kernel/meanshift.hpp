@@ -12,6 +12,7 @@
 #include <common/kernel_cache.hpp>
 #include <debug_cuda.hpp>
 #include <nvrtc_kernel_headers/meanshift_cuh.hpp>
+#include <platform.hpp>
 
 #include <string>
 #include <type_traits>
@@ -21,6 +22,7 @@ namespace kernel {
 
 static const int THREADS_X = 16;
 static const int THREADS_Y = 16;
+static const int TILE_SLACK = 4;
 
 template<typename T>
 void meanshift(Param<T> out, CParam<T> in, const float spatialSigma,
@@ -29,18 +31,12 @@ void meanshift(Param<T> out, CParam<T> in, const float spatialSigma,
                                       float>::type AccType;
     static const std::string source(meanshift_cuh, meanshift_cuh_len);
 
-    auto meanshift = common::getKernel(
-        "cuda::meanshift", {source},
-        {
-            TemplateTypename<AccType>(), TemplateTypename<T>(),
-            TemplateArg((IsColor ? 3 : 1))  // channels
-        });
-
     static dim3 threads(kernel::THREADS_X, kernel::THREADS_Y);
 
     int blk_x        = divup(in.dims[0], THREADS_X);
     int blk_y        = divup(in.dims[1], THREADS_Y);
     const int bCount = (IsColor ? 1 : in.dims[2]);
+    const int nchan  = (IsColor ? 3 : 1);
 
     dim3 blocks(blk_x * bCount, blk_y * in.dims[3]);
 
@@ -48,8 +44,28 @@ void meanshift(Param<T> out, CParam<T> in, const float spatialSigma,
     int radius       = std::max((int)(spatialSigma * 1.5f), 1);
     const float cvar = chromaticSigma * chromaticSigma;
 
-    EnqueueArgs qArgs(blocks, threads, getActiveStream());
-    meanshift(qArgs, out, in, radius, cvar, numIters, blk_x, blk_y);
+    // The tile covers the windows of the pixels of the block, and of the
+    // means which shifted by up to TILE_SLACK pixels out of the block. The
+    // windows are read from global memory if the tile does not fit into
+    // shared memory.
+    const int halo         = radius + TILE_SLACK;
+    const size_t tileBytes = sizeof(T) * nchan * (THREADS_X + 2 * halo) *
+                             (THREADS_Y + 2 * halo);
+    const size_t maxShrdSize =
+        getDeviceProp(getActiveDeviceId()).sharedMemPerBlock;
+    const bool useTile = tileBytes <= maxShrdSize;
+
+    auto meanshift = common::getKernel(
+        "cuda::meanshift", {source},
+        {
+            TemplateTypename<AccType>(), TemplateTypename<T>(),
+            TemplateArg(nchan),  // channels
+            TemplateArg(useTile),
+        });
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream(),
+                      useTile ? tileBytes : 0);
+    meanshift(qArgs, out, in, radius, halo, cvar, numIters, blk_x, blk_y);
     POST_LAUNCH_CHECK();
 }
 
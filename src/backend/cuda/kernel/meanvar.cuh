@@ -0,0 +1,169 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Param.hpp>
+
+namespace cuda {
+
+// The running weight, mean and sum of the weighted squared differences from
+// the mean of a sequence of values
+template<typename To>
+struct Welford {
+    To weight;
+    To mean;
+    To m2;
+};
+
+template<typename To>
+__device__ void welfordAdd(Welford<To> &acc, To value, To w) {
+    if (w == To(0)) { return; }
+    acc.weight += w;
+    const To delta = value - acc.mean;
+    acc.mean += delta * (w / acc.weight);
+    acc.m2 += w * delta * (value - acc.mean);
+}
+
+// Combines the statistics of two sequences (Chan et al.)
+template<typename To>
+__device__ void welfordCombine(Welford<To> &acc, const Welford<To> &other) {
+    const To weight = acc.weight + other.weight;
+    if (other.weight == To(0)) { return; }
+    const To delta = other.mean - acc.mean;
+    const To ratio = other.weight / weight;
+    acc.mean += delta * ratio;
+    acc.m2 += other.m2 + delta * delta * acc.weight * ratio;
+    acc.weight = weight;
+}
+
+// The offset of a line of the dimensions other than dim
+__device__ dim_t meanVarLineOffset(dim_t line, const dim_t *dims,
+                                   const dim_t *strides, int dim) {
+    dim_t offset = 0;
+    for (int d = 0; d < 4; ++d) {
+        if (d == dim) { continue; }
+        offset += (line % dims[d]) * strides[d];
+        line /= dims[d];
+    }
+    return offset;
+}
+
+// The weights are empty when isWeighted is false
+template<typename To, bool isWeighted>
+__device__ const To *weightsOfLine(const CParam<To> &wt, dim_t line, int dim) {
+    if (!isWeighted) { return wt.ptr; }
+    return wt.ptr + meanVarLineOffset(line, wt.dims, wt.strides, dim);
+}
+
+template<typename Ti, typename To, bool isWeighted>
+__device__ void meanVarLine(Welford<To> &acc, const Ti *iptr, const To *wptr,
+                            dim_t istride, dim_t wstride, dim_t begin,
+                            dim_t end, dim_t step) {
+    for (dim_t i = begin; i < end; i += step) {
+        welfordAdd(acc, To(iptr[i * istride]),
+                   isWeighted ? wptr[i * wstride] : To(1));
+    }
+}
+
+// Reduces parts of the lines along dim into partial statistics, stored at
+// line * parts + part.
+//
+// When alongLine is true the lines are contiguous (dim is 0). The threads of
+// a block read consecutive values of a part of a line and the block combines
+// their statistics. Otherwise each thread reduces a part of a line and the
+// threads of a block take consecutive lines, which are contiguous.
+template<typename Ti, typename To, bool isWeighted, bool alongLine>
+__global__ void meanVarParts(To *pWeight, To *pMean, To *pM2, CParam<Ti> in,
+                             CParam<To> wt, int dim, dim_t lines) {
+    const dim_t n = in.dims[dim];
+    Welford<To> acc{To(0), To(0), To(0)};
+
+    if (alongLine) {
+        __shared__ To s_weight[THREADS];
+        __shared__ To s_mean[THREADS];
+        __shared__ To s_m2[THREADS];
+
+        const int tid     = threadIdx.x;
+        const dim_t parts = gridDim.x;
+        const dim_t part  = blockIdx.x;
+
+        for (dim_t line = blockIdx.y; line < lines; line += gridDim.y) {
+            acc = Welford<To>{To(0), To(0), To(0)};
+            meanVarLine<Ti, To, isWeighted>(
+                acc, in.ptr + meanVarLineOffset(line, in.dims, in.strides, dim),
+                weightsOfLine<To, isWeighted>(wt, line, dim), in.strides[dim],
+                wt.strides[dim], part * THREADS + tid, n, parts * THREADS);
+
+            s_weight[tid] = acc.weight;
+            s_mean[tid]   = acc.mean;
+            s_m2[tid]     = acc.m2;
+            __syncthreads();
+
+            for (int offset = THREADS / 2; offset > 0; offset /= 2) {
+                if (tid < offset) {
+                    Welford<To> other{s_weight[tid + offset],
+                                      s_mean[tid + offset], s_m2[tid + offset]};
+                    welfordCombine(acc, other);
+                    s_weight[tid] = acc.weight;
+                    s_mean[tid]   = acc.mean;
+                    s_m2[tid]     = acc.m2;
+                }
+                __syncthreads();
+            }
+
+            if (tid == 0) {
+                pWeight[line * parts + part] = acc.weight;
+                pMean[line * parts + part]   = acc.mean;
+                pM2[line * parts + part]     = acc.m2;
+            }
+        }
+    } else {
+        const dim_t line = blockIdx.x * (dim_t)blockDim.x + threadIdx.x;
+        if (line >= lines) { return; }
+
+        const dim_t parts      = gridDim.y;
+        const dim_t part       = blockIdx.y;
+        const dim_t partLength = (n + parts - 1) / parts;
+        const dim_t begin      = part * partLength;
+        const dim_t end = begin + partLength < n ? begin + partLength : n;
+
+        meanVarLine<Ti, To, isWeighted>(
+            acc, in.ptr + meanVarLineOffset(line, in.dims, in.strides, dim),
+            weightsOfLine<To, isWeighted>(wt, line, dim), in.strides[dim],
+            wt.strides[dim], begin, end, 1);
+
+        pWeight[line * parts + part] = acc.weight;
+        pMean[line * parts + part]   = acc.mean;
+        pM2[line * parts + part]     = acc.m2;
+    }
+}
+
+// Combines the partial statistics of each line and writes its mean and its
+// variance
+template<typename To>
+__global__ void meanVarCombine(Param<To> mean, Param<To> var,
+                             const To *pWeight, const To *pMean,
+                             const To *pM2, int dim, dim_t lines, int parts,
+                             To correction) {
+    const dim_t line = blockIdx.x * (dim_t)blockDim.x + threadIdx.x;
+    if (line >= lines) { return; }
+
+    const dim_t first = line * parts;
+    Welford<To> acc{pWeight[first], pMean[first], pM2[first]};
+    for (int part = 1; part < parts; ++part) {
+        Welford<To> other{pWeight[first + part], pMean[first + part],
+                          pM2[first + part]};
+        welfordCombine(acc, other);
+    }
+
+    mean.ptr[meanVarLineOffset(line, mean.dims, mean.strides, dim)] = acc.mean;
+    var.ptr[meanVarLineOffset(line, var.dims, var.strides, dim)] =
+        acc.m2 / (acc.weight - correction);
+}
+
+}  // namespace cuda
@@ -0,0 +1,100 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_cuda.hpp>
+#include <memory.hpp>
+#include <nvrtc_kernel_headers/meanvar_cuh.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace cuda {
+namespace kernel {
+
+constexpr int MEANVAR_THREADS = 256;
+/// The number of values reduced by a thread before the partial statistics
+/// are combined
+constexpr dim_t MEANVAR_THREAD_ELEMENTS = 64;
+/// The number of threads which keeps the device busy
+constexpr dim_t MEANVAR_TARGET_THREADS = 1 << 16;
+constexpr dim_t MEANVAR_MAX_PARTS      = 256;
+constexpr dim_t MEANVAR_MAX_BLOCKS     = 65535;
+
+/// Computes the mean and the variance of each line of \p in along \p dim in
+/// one pass.
+///
+/// Each line is split into parts whose weight, mean and sum of squared
+/// differences are computed with Welford's algorithm. A second kernel
+/// combines the parts of each line. When \p dim is 0 the threads of a block
+/// read a part of a line together. Otherwise each thread reads a part of a
+/// line, and the threads of a block read consecutive lines.
+template<typename Ti, typename To>
+void meanvar(Param<To> mean, Param<To> var, CParam<Ti> in, CParam<To> weights,
+             const af_var_bias bias, const int dim) {
+    static const std::string source(meanvar_cuh, meanvar_cuh_len);
+
+    const dim_t weightElements =
+        weights.dims[0] * weights.dims[1] * weights.dims[2] * weights.dims[3];
+    const bool isWeighted = weightElements != 0;
+    const bool alongLine  = dim == 0;
+
+    auto reduceParts = common::getKernel(
+        "cuda::meanVarParts", {source},
+        {TemplateTypename<Ti>(), TemplateTypename<To>(),
+         TemplateArg(isWeighted), TemplateArg(alongLine)},
+        {DefineKeyValue(THREADS, MEANVAR_THREADS)});
+    auto combineParts = common::getKernel("cuda::meanVarCombine", {source},
+                                          {TemplateTypename<To>()});
+
+    const dim_t n     = in.dims[dim];
+    const dim_t lines = in.dims[0] * in.dims[1] * in.dims[2] * in.dims[3] / n;
+
+    dim_t parts = 0;
+    dim3 blocks;
+    if (alongLine) {
+        parts = std::min({divup(n, MEANVAR_THREADS * MEANVAR_THREAD_ELEMENTS),
+                          divup(MEANVAR_TARGET_THREADS,
+                                lines * MEANVAR_THREADS),
+                          MEANVAR_MAX_PARTS});
+        blocks = dim3(static_cast<unsigned>(parts),
+                      static_cast<unsigned>(
+                          std::min(lines, MEANVAR_MAX_BLOCKS)));
+    } else {
+        parts  = std::min({divup(n, MEANVAR_THREAD_ELEMENTS),
+                           divup(MEANVAR_TARGET_THREADS, lines),
+                           MEANVAR_MAX_PARTS});
+        blocks = dim3(static_cast<unsigned>(divup(lines, MEANVAR_THREADS)),
+                      static_cast<unsigned>(parts));
+    }
+
+    auto pWeight = memAlloc<To>(lines * parts);
+    auto pMean   = memAlloc<To>(lines * parts);
+    auto pM2     = memAlloc<To>(lines * parts);
+
+    EnqueueArgs reduceArgs(blocks, MEANVAR_THREADS, getActiveStream());
+    reduceParts(reduceArgs, pWeight.get(), pMean.get(), pM2.get(), in, weights,
+                dim, lines);
+    POST_LAUNCH_CHECK();
+
+    const To correction(bias == AF_VARIANCE_SAMPLE ? 1 : 0);
+    EnqueueArgs combineArgs(
+        dim3(static_cast<unsigned>(divup(lines, MEANVAR_THREADS))),
+        MEANVAR_THREADS, getActiveStream());
+    combineParts(combineArgs, mean, var, pWeight.get(), pMean.get(), pM2.get(),
+                 dim, lines, static_cast<int>(parts), correction);
+    POST_LAUNCH_CHECK();
+}
+
+}  // namespace kernel
+}  // namespace cuda
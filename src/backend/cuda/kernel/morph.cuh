@@ -226,4 +226,63 @@ __global__ void morph3D(Param<T> out, CParam<T> in, int nBBS) {
     }
 }
 
+// Applies a flat window of windLen elements along dimension axis with the
+// van Herk/Gil-Werman algorithm. Each thread computes windLen consecutive
+// outputs along the axis. All of their windows span the end of one block of
+// windLen inputs and the start of the next, so each output combines a
+// suffix extreme with a prefix extreme at a constant cost per element.
+// Elements beyond the edges are the identity of the operation.
+template<typename T, bool isDilation>
+__global__ void morphLine(Param<T> out, CParam<T> in, int axis, int windLen,
+                          int nBlocks) {
+    const T init = isDilation ? common::Binary<T, af_max_t>::init()
+                              : common::Binary<T, af_min_t>::init();
+
+    int rem = blockIdx.x * blockDim.x + threadIdx.x;
+    int idx[4];
+#pragma unroll
+    for (int k = 0; k < 4; ++k) {
+        const int len = (k == axis ? nBlocks : in.dims[k]);
+        idx[k]        = rem % len;
+        rem /= len;
+    }
+    if (rem > 0) return;
+
+    const int x0 = idx[axis] * windLen;
+    idx[axis]    = 0;
+    const T* iptr =
+        in.ptr + (idx[0] * in.strides[0] + idx[1] * in.strides[1] +
+                  idx[2] * in.strides[2] + idx[3] * in.strides[3]);
+    T* optr = out.ptr + (idx[0] * out.strides[0] + idx[1] * out.strides[1] +
+                         idx[2] * out.strides[2] + idx[3] * out.strides[3]);
+
+    const int len     = in.dims[axis];
+    const int istride = in.strides[axis];
+    const int ostride = out.strides[axis];
+    // The first input of the next block
+    const int split = x0 - windLen / 2 + windLen;
+
+    T acc = init;
+    for (int i = windLen - 1; i >= 0; --i) {
+        const int p = split - windLen + i;
+        if (p >= 0 && p < len) {
+            const T cur = iptr[p * istride];
+            acc         = isDilation ? max(acc, cur) : min(acc, cur);
+        }
+        if (x0 + i < len) optr[(x0 + i) * ostride] = acc;
+    }
+
+    acc = init;
+    for (int i = 0; i < windLen && x0 + i < len; ++i) {
+        T* o = optr + (x0 + i) * ostride;
+        *o   = isDilation ? max(*o, acc) : min(*o, acc);
+
+        const int p = split + i;
+        if (p >= 0 && p < len) {
+            const T cur = iptr[p * istride];
+            acc         = isDilation ? max(acc, cur) : min(acc, cur);
+        }
+    }
+}
+
 }  // namespace cuda
@@ -102,5 +102,31 @@ void morph3d(Param<T> out, CParam<T> in, CParam<T> mask, bool isDilation) {
     POST_LAUNCH_CHECK();
 }
 
+template<typename T>
+void morphLine(Param<T> out, CParam<T> in, int axis, int windLen,
+               bool isDilation) {
+    static const std::string source(morph_cuh, morph_cuh_len);
+
+    auto morphLine = common::getKernel(
+        "cuda::morphLine", {source},
+        {TemplateTypename<T>(), TemplateArg(isDilation)},
+        {
+            DefineValue(MAX_MORPH_FILTER_LEN),
+        });
+
+    const int nBlocks = divup(in.dims[axis], windLen);
+    int lines         = 1;
+    for (int k = 0; k < 4; ++k) {
+        if (k != axis) { lines *= in.dims[k]; }
+    }
+
+    dim3 threads(kernel::THREADS_X * kernel::THREADS_Y);
+    dim3 blocks(divup(lines * nBlocks, threads.x));
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream());
+    morphLine(qArgs, out, in, axis, windLen, nBlocks);
+    POST_LAUNCH_CHECK();
+}
+
 }  // namespace kernel
 }  // namespace cuda
@@ -159,9 +159,9 @@ void all_distances(Param<To> dist, CParam<T> query, CParam<T> train,
     dim3 blocks(divup(ntrain, threads.x), 1);
 
     // Determine maximum feat_len capable of using shared memory (faster)
-    int device          = getActiveDeviceId();
-    cudaDeviceProp prop = getDeviceProp(device);
-    size_t avail_smem   = prop.sharedMemPerBlock;
+    int device                 = getActiveDeviceId();
+    const cudaDeviceProp &prop = getDeviceProp(device);
+    size_t avail_smem          = prop.sharedMemPerBlock;
     size_t smem_predef =
         2 * THREADS * sizeof(unsigned) + max_kern_feat_len * sizeof(T);
     size_t strain_sz = threads.x * max_kern_feat_len * sizeof(T);
@@ -0,0 +1,135 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Param.hpp>
+
+namespace cuda {
+
+typedef unsigned long long nth_key_t;
+
+// The keys are unsigned integers which are ordered like the values
+__device__ nth_key_t toKey(float v) {
+    unsigned bits = __float_as_uint(v);
+    return bits ^ ((bits >> 31) ? 0xffffffffu : 0x80000000u);
+}
+
+__device__ nth_key_t toKey(double v) {
+    nth_key_t bits = __double_as_longlong(v);
+    return bits ^ ((bits >> 63) ? ~0ull : (1ull << 63));
+}
+
+__device__ nth_key_t toKey(int v) { return unsigned(v) ^ 0x80000000u; }
+__device__ nth_key_t toKey(short v) { return (unsigned short)(v) ^ 0x8000u; }
+__device__ nth_key_t toKey(unsigned v) { return v; }
+__device__ nth_key_t toKey(unsigned short v) { return v; }
+__device__ nth_key_t toKey(unsigned char v) { return v; }
+
+__device__ void fromKey(float &v, nth_key_t key) {
+    unsigned bits = key;
+    v = __uint_as_float(bits ^ ((bits >> 31) ? 0x80000000u : 0xffffffffu));
+}
+
+__device__ void fromKey(double &v, nth_key_t key) {
+    v = __longlong_as_double(key ^ ((key >> 63) ? (1ull << 63) : ~0ull));
+}
+
+__device__ void fromKey(int &v, nth_key_t key) {
+    v = unsigned(key) ^ 0x80000000u;
+}
+__device__ void fromKey(short &v, nth_key_t key) {
+    v = (unsigned short)(key) ^ 0x8000u;
+}
+__device__ void fromKey(unsigned &v, nth_key_t key) { v = key; }
+__device__ void fromKey(unsigned short &v, nth_key_t key) { v = key; }
+__device__ void fromKey(unsigned char &v, nth_key_t key) { v = key; }
+
+// The offset of a line of the dimensions other than dim
+__device__ dim_t lineOffset(dim_t line, const dim_t *dims,
+                            const dim_t *strides, int dim) {
+    dim_t offset = 0;
+    for (int d = 0; d < 4; ++d) {
+        if (d == dim) { continue; }
+        offset += (line % dims[d]) * strides[d];
+        line /= dims[d];
+    }
+    return offset;
+}
+
+// Counts the digits at shift of the values whose higher digits match the
+// prefix of the two ranks selected in each line
+template<typename T>
+__global__ void nthElementHistogram(unsigned *hist, const nth_key_t *prefix,
+                                    CParam<T> in, int dim, dim_t lines,
+                                    int shift, nth_key_t highMask) {
+    __shared__ unsigned s_hist[2 * 256];
+
+    const dim_t n      = in.dims[dim];
+    const dim_t stride = in.strides[dim];
+
+    for (dim_t line = blockIdx.y; line < lines; line += gridDim.y) {
+        for (int i = threadIdx.x; i < 2 * 256; i += blockDim.x) {
+            s_hist[i] = 0;
+        }
+        __syncthreads();
+
+        const nth_key_t prefix0 = prefix[2 * line];
+        const nth_key_t prefix1 = prefix[2 * line + 1];
+
+        const T *iptr = in.ptr + lineOffset(line, in.dims, in.strides, dim);
+        for (dim_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n;
+             i += blockDim.x * gridDim.x) {
+            const nth_key_t key  = toKey(iptr[i * stride]);
+            const int digit      = (key >> shift) & 0xff;
+            const nth_key_t high = key & highMask;
+            if (high == prefix0) { atomicAdd(s_hist + digit, 1u); }
+            if (high == prefix1) { atomicAdd(s_hist + 256 + digit, 1u); }
+        }
+        __syncthreads();
+
+        unsigned *hptr = hist + 2 * 256 * line;
+        for (int i = threadIdx.x; i < 2 * 256; i += blockDim.x) {
+            if (s_hist[i]) { atomicAdd(hptr + i, s_hist[i]); }
+        }
+        __syncthreads();
+    }
+}
+
+// Finds the digit of each rank and appends it to its prefix. The rank is
+// made relative to the values of the prefix. The last pass writes the values.
+template<typename T>
+__global__ void nthElementSelect(Param<T> out, nth_key_t *prefix,
+                                 dim_t *ranks, const unsigned *hist, int dim,
+                                 dim_t lines, dim_t n, dim_t rank, int shift,
+                                 bool firstPass, bool lastPass) {
+    const dim_t query = blockIdx.x * blockDim.x + threadIdx.x;
+    if (query >= 2 * lines) { return; }
+
+    dim_t r = rank + (query & 1);
+    if (firstPass) {
+        r = r < n ? r : n - 1;
+    } else {
+        r = ranks[query];
+    }
+
+    const unsigned *hptr = hist + 256 * query;
+    int digit            = 0;
+    for (; digit < 255 && r >= hptr[digit]; ++digit) { r -= hptr[digit]; }
+
+    const nth_key_t key = prefix[query] | (nth_key_t(digit) << shift);
+    prefix[query]       = key;
+    ranks[query]        = r;
+
+    if (lastPass) {
+        const dim_t line = query / 2;
+        T *optr = out.ptr + lineOffset(line, out.dims, out.strides, dim);
+        fromKey(optr[(query & 1) * out.strides[dim]], key);
+    }
+}
+
+}  // namespace cuda
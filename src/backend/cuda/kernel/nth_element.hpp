@@ -0,0 +1,89 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_cuda.hpp>
+#include <memory.hpp>
+#include <nvrtc_kernel_headers/nth_element_cuh.hpp>
+#include <types.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace cuda {
+namespace kernel {
+
+constexpr int NTH_ELEMENT_THREADS        = 256;
+constexpr int NTH_ELEMENT_BLOCK_ELEMENTS = 32 * NTH_ELEMENT_THREADS;
+constexpr dim_t NTH_ELEMENT_MAX_BLOCKS   = 65535;
+
+/// Selects the values of rank \p rank and rank + 1 of each line along \p dim
+/// with a most significant digit radix select.
+///
+/// The values are mapped to unsigned keys with the same order. Each pass
+/// counts the next 8 bit digit of the keys whose higher digits match the
+/// prefix found so far, then picks the digit holding each rank. After
+/// sizeof(T) passes the prefixes are the selected keys. Each pass reads the
+/// input once, and the only memory allocated is a histogram of 256 counters
+/// for each selected value.
+template<typename T>
+void nthElement(Param<T> out, CParam<T> in, const int dim, const dim_t rank) {
+    static const std::string source(nth_element_cuh, nth_element_cuh_len);
+
+    auto histogram = common::getKernel("cuda::nthElementHistogram", {source},
+                                       {TemplateTypename<T>()});
+    auto select    = common::getKernel("cuda::nthElementSelect", {source},
+                                       {TemplateTypename<T>()});
+
+    const dim_t n       = in.dims[dim];
+    const dim_t lines   = in.dims[0] * in.dims[1] * in.dims[2] * in.dims[3] / n;
+    const dim_t queries = 2 * lines;
+
+    auto hist   = memAlloc<unsigned>(queries * 256);
+    auto prefix = memAlloc<uintl>(queries);
+    auto ranks  = memAlloc<dim_t>(queries);
+    CUDA_CHECK(cudaMemsetAsync(prefix.get(), 0, queries * sizeof(uintl),
+                               getActiveStream()));
+
+    const dim_t blocksPerLine =
+        std::min(divup(n, NTH_ELEMENT_BLOCK_ELEMENTS), NTH_ELEMENT_MAX_BLOCKS);
+    const dim3 histBlocks(static_cast<unsigned>(blocksPerLine),
+                          static_cast<unsigned>(
+                              std::min(lines, NTH_ELEMENT_MAX_BLOCKS)));
+    const dim3 selectBlocks(
+        static_cast<unsigned>(divup(queries, NTH_ELEMENT_THREADS)));
+
+    EnqueueArgs histArgs(histBlocks, NTH_ELEMENT_THREADS, getActiveStream());
+    EnqueueArgs selectArgs(selectBlocks, NTH_ELEMENT_THREADS,
+                           getActiveStream());
+
+    const int passes = sizeof(T);
+    for (int pass = 0; pass < passes; ++pass) {
+        const int shift = (passes - 1 - pass) * 8;
+        const uintl highMask =
+            shift + 8 >= 64 ? 0 : ~((uintl(1) << (shift + 8)) - 1);
+
+        CUDA_CHECK(cudaMemsetAsync(hist.get(), 0,
+                                   queries * 256 * sizeof(unsigned),
+                                   getActiveStream()));
+        histogram(histArgs, hist.get(), prefix.get(), in, dim, lines, shift,
+                  highMask);
+        POST_LAUNCH_CHECK();
+
+        select(selectArgs, out, prefix.get(), ranks.get(), hist.get(), dim,
+               lines, n, rank, shift, pass == 0, pass == passes - 1);
+        POST_LAUNCH_CHECK();
+    }
+}
+
+}  // namespace kernel
+}  // namespace cuda
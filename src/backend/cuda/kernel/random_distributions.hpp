@@ -0,0 +1,123 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/dispatch.hpp>
+#include <common/internal_enums.hpp>
+#include <common/random_distributions.hpp>
+#include <debug_cuda.hpp>
+#include <kernel/random_engine.hpp>
+
+#include <algorithm>
+
+namespace cuda {
+namespace kernel {
+
+/// The largest number of blocks of randomDistribution. The threads of the
+/// blocks step through the elements of larger arrays.
+static const int RANDOM_DIST_MAX_BLOCKS = 65535;
+
+/// The random values of an element of a distribution. They are the Philox
+/// values of the seed and of a counter made of the counter of the engine
+/// plus the index of the element, the index of the draw and
+/// RANDOM_DIST_STREAM, so they only depend on the position of the element.
+template<typename T>
+class PhiloxElementStream {
+   private:
+    uint m_key[2];
+    uint m_ctr[4];
+    uint m_words[4];
+    int m_next;
+    bool m_hasNormal;
+    T m_normal;
+
+    __device__ uint word() {
+        if (m_next == 4) {
+            uint key[2] = {m_key[0], m_key[1]};
+            for (int i = 0; i < 4; ++i) { m_words[i] = m_ctr[i]; }
+            philox(key, m_words);
+            ++m_ctr[2];
+            m_next = 0;
+        }
+        return m_words[m_next++];
+    }
+
+    __device__ float uniform(float *) { return getFloat01(word()); }
+
+    __device__ double uniform(double *) {
+        const uint num1 = word();
+        return getDouble01(num1, word());
+    }
+
+   public:
+    __device__ PhiloxElementStream(const uint lo, const uint hi,
+                                   const uintl counter, const uintl index)
+        : m_key{lo, hi}
+        , m_ctr{static_cast<uint>(counter + index),
+                static_cast<uint>((counter + index) >> 32), 0,
+                common::RANDOM_DIST_STREAM}
+        , m_next(4)
+        , m_hasNormal(false)
+        , m_normal(0) {}
+
+    /// Returns a value in (0, 1]
+    __device__ T uniform() { return uniform(static_cast<T *>(nullptr)); }
+
+    /// Returns a value of the standard normal distribution. The values are
+    /// generated in pairs with the Box-Muller transform.
+    __device__ T normal() {
+        if (m_hasNormal) {
+            m_hasNormal = false;
+            return m_normal;
+        }
+        const T r = common::random::rSqrt(T(-2) *
+                                          common::random::rLog(uniform()));
+        T c;
+        sincos(two_pi<T>() * uniform(), &m_normal, &c);
+        m_normal *= r;
+        m_hasNormal = true;
+        return r * c;
+    }
+};
+
+template<typename T>
+__global__ void distributionPhilox(T *out, const T *param0, const T *param1,
+                                   const AF_RANDOM_DIST dist, uint hi, uint lo,
+                                   uintl counter, uintl elements) {
+    const uintl step = static_cast<uintl>(gridDim.x) * blockDim.x;
+    for (uintl i = blockIdx.x * static_cast<uintl>(blockDim.x) + threadIdx.x;
+         i < elements; i += step) {
+        PhiloxElementStream<T> gen(lo, hi, counter, i);
+        out[i] = common::sampleDistribution(gen, dist, param0[i], param1[i]);
+    }
+}
+
+/// Writes a value of \p dist to each element of \p out, with the parameters
+/// of the same elements of \p param0 and \p param1. The arrays are linear.
+///
+/// Each thread samples its elements independently. The samplers accept most
+/// of their proposals, so the threads of a warp rarely diverge for long.
+template<typename T>
+void randomDistribution(T *out, const T *param0, const T *param1,
+                        const size_t elements, const AF_RANDOM_DIST dist,
+                        const uintl &seed, uintl &counter) {
+    if (elements == 0) { return; }
+    const int threads = THREADS;
+    const int blocks  = static_cast<int>(std::min<size_t>(
+        divup(elements, threads), RANDOM_DIST_MAX_BLOCKS));
+    const uint hi     = seed >> 32;
+    const uint lo     = seed;
+    CUDA_LAUNCH(distributionPhilox<T>, blocks, threads, out, param0, param1,
+                dist, hi, lo, counter, static_cast<uintl>(elements));
+    counter += elements;
+}
+
+}  // namespace kernel
+}  // namespace cuda
@@ -98,7 +98,8 @@ static inline __device__ uint temper(const uint *const temper_table,
 
 // Initialization
 
-__global__ void initState(uint *state, const uint *tbl, uintl seed) {
+static inline __device__ void initBlockState(uint *state, const uint *tbl,
+                                             uintl seed) {
     __shared__ uint lstate[N];
     const uint *ltbl = tbl + (TABLE_SIZE * blockIdx.x);
     uint hidden_seed = ltbl[4] ^ (ltbl[8] << 16);
@@ -123,8 +124,29 @@ __global__ void initState(uint *state, const uint *tbl, uintl seed) {
     state[N * blockIdx.x + threadIdx.x] = lstate[threadIdx.x];
 }
 
+__global__ void initState(uint *state, const uint *tbl, uintl seed) {
+    initBlockState(state, tbl, seed);
+}
+
+// Initializes the state of the engine blockIdx.y of a batch
+__global__ void initStates(uint *const *states, const uintl *seeds,
+                           const uint *tbl) {
+    initBlockState(states[blockIdx.y], tbl, seeds[blockIdx.y]);
+}
+
 void initMersenneState(uint *state, const uint *tbl, uintl seed) {
     CUDA_LAUNCH(initState, BLOCKS, N, state, tbl, seed);
 }
+
+void initMersenneStates(uint *const *states, const uintl *seeds,
+                        const uint *tbl, const int count) {
+    constexpr int MAX_BATCH = 65535;
+    for (int first = 0; first < count; first += MAX_BATCH) {
+        const int left  = count - first;
+        const int batch = left < MAX_BATCH ? left : MAX_BATCH;
+        CUDA_LAUNCH(initStates, dim3(BLOCKS, batch), N, states + first,
+                    seeds + first, tbl);
+    }
+}
 }  // namespace kernel
 }  // namespace cuda
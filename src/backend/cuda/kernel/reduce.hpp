@@ -298,6 +298,101 @@ void reduce_first_launcher(Param<To> out, CParam<Ti> in, const uint blocks_x,
     POST_LAUNCH_CHECK();
 }
 
+/// The blocks of reduce_all_kernel. The last block to finish combines the
+/// results of all the blocks, so their number is kept low.
+static const uint REDUCE_ALL_MAX_BLOCKS = 1024;
+
+/// Reduces the values of the threads of a one dimensional block of
+/// THREADS_PER_BLOCK threads. The result is valid in the first thread.
+template<typename To, af_op_t op>
+__device__ static compute_t<To> reduce_block(compute_t<To> val) {
+    common::Binary<compute_t<To>, op> reduce;
+    __shared__ compute_t<To> s_val[THREADS_PER_BLOCK];
+
+    const uint tid = threadIdx.x;
+    s_val[tid]     = val;
+    __syncthreads();
+
+    for (uint n = THREADS_PER_BLOCK / 2; n >= 32; n /= 2) {
+        if (tid < n) s_val[tid] = reduce(s_val[tid], s_val[tid + n]);
+        __syncthreads();
+    }
+
+    typedef cub::WarpReduce<compute_t<To>> WarpReduce;
+    __shared__ typename WarpReduce::TempStorage temp_storage;
+    if (tid < 32) val = WarpReduce(temp_storage).Reduce(s_val[tid], reduce);
+    return val;
+}
+
+/// Reduces the linear array \p in to \p out[0] in a single launch. Each
+/// block writes its result to \p partials and takes a ticket from \p
+/// retired, and the last block to take one combines the results of all the
+/// blocks. \p retired must be zero before the launch and is zero again after
+/// it.
+template<typename Ti, typename To, af_op_t op>
+__global__ static void reduce_all_kernel(data_t<To> *out,
+                                         data_t<To> *partials, uint *retired,
+                                         CParam<Ti> in, int elements,
+                                         uint repeat, bool change_nan,
+                                         To nanval) {
+    const uint tid = threadIdx.x;
+    const uint xid = blockIdx.x * THREADS_PER_BLOCK * repeat + tid;
+
+    common::Binary<compute_t<To>, op> reduce;
+    common::Transform<Ti, compute_t<To>, op> transform;
+
+    int lim = min((int)(xid + repeat * THREADS_PER_BLOCK), elements);
+
+    compute_t<To> out_val = common::Binary<compute_t<To>, op>::init();
+    for (int id = xid; id < lim; id += THREADS_PER_BLOCK) {
+        compute_t<To> in_val = transform(in.ptr[id]);
+        if (change_nan)
+            in_val =
+                !IS_NAN(in_val) ? in_val : static_cast<compute_t<To>>(nanval);
+        out_val = reduce(in_val, out_val);
+    }
+    out_val = reduce_block<To, op>(out_val);
+
+    __shared__ bool s_last;
+    if (tid == 0) {
+        partials[blockIdx.x] = data_t<To>(out_val);
+        // The result must be visible to the last block before the ticket
+        __threadfence();
+        const uint ticket = atomicInc(retired, gridDim.x - 1);
+        s_last            = ticket == gridDim.x - 1;
+    }
+    __syncthreads();
+    if (!s_last) return;
+
+    out_val = common::Binary<compute_t<To>, op>::init();
+    for (uint i = tid; i < gridDim.x; i += THREADS_PER_BLOCK) {
+        out_val = reduce(out_val, compute_t<To>(partials[i]));
+    }
+    out_val = reduce_block<To, op>(out_val);
+
+    if (tid == 0) out[0] = data_t<To>(out_val);
+}
+
+/// Reduces the first \p elements values of the linear array \p in to the
+/// device value \p out with one launch
+template<typename Ti, typename To, af_op_t op>
+void reduce_all_launcher(To *out, CParam<Ti> in, int elements,
+                         bool change_nan, double nanval) {
+    const uint blocks = std::min<uint>(
+        divup(elements, THREADS_PER_BLOCK * REPEAT), REDUCE_ALL_MAX_BLOCKS);
+    const uint repeat = divup(elements, blocks * THREADS_PER_BLOCK);
+
+    auto partials = memAlloc<To>(blocks);
+    auto retired  = memAlloc<uint>(1);
+    CUDA_CHECK(cudaMemsetAsync(retired.get(), 0, sizeof(uint),
+                               getActiveStream()));
+
+    CUDA_LAUNCH((reduce_all_kernel<Ti, To, op>), blocks, THREADS_PER_BLOCK,
+                out, partials.get(), retired.get(), in, elements, repeat,
+                change_nan, scalar<To>(nanval));
+    POST_LAUNCH_CHECK();
+}
+
 template<typename Ti, typename To, af_op_t op>
 void reduce_first(Param<To> out, CParam<Ti> in, bool change_nan,
                   double nanval) {
@@ -308,6 +403,13 @@ void reduce_first(Param<To> out, CParam<Ti> in, bool change_nan,
     uint blocks_x = divup(in.dims[0], threads_x * REPEAT);
     uint blocks_y = divup(in.dims[1], threads_y);
 
+    // A single row is reduced with one launch instead of two
+    if (blocks_x > 1 && in.strides[0] == 1 &&
+        in.dims[1] * in.dims[2] * in.dims[3] == 1) {
+        return reduce_all_launcher<Ti, To, op>(out.ptr, in, in.dims[0],
+                                               change_nan, nanval);
+    }
+
     Param<To> tmp = out;
     uptr<To> tmp_alloc;
     if (blocks_x > 1) {
@@ -354,14 +456,18 @@ To reduce_all(CParam<Ti> in, bool change_nan, double nanval) {
     }
 
     // FIXME: Use better heuristics to get to the optimum number
-    if (in_elements > 4096 || !is_linear) {
-        if (is_linear) {
-            in.dims[0] = in_elements;
-            for (int k = 1; k < 4; k++) {
-                in.dims[k]    = 1;
-                in.strides[k] = in_elements;
-            }
-        }
+    if (in_elements > 4096 && is_linear) {
+        auto out = memAlloc<To>(1);
+        reduce_all_launcher<Ti, To, op>(out.get(), in, in_elements, change_nan,
+                                        nanval);
+
+        To h_out;
+        CUDA_CHECK(cudaMemcpyAsync(&h_out, out.get(), sizeof(To),
+                                   cudaMemcpyDeviceToHost,
+                                   cuda::getActiveStream()));
+        CUDA_CHECK(cudaStreamSynchronize(cuda::getActiveStream()));
+        return h_out;
+    } else if (!is_linear) {
         uint threads_x = nextpow2(std::max(32u, (uint)in.dims[0]));
         threads_x      = std::min(threads_x, THREADS_PER_BLOCK);
         uint threads_y = THREADS_PER_BLOCK / threads_x;
@@ -0,0 +1,109 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Param.hpp>
+#include <optypes.hpp>
+
+namespace cuda {
+
+// The finalizer of MurmurHash3, which spreads consecutive keys over the slots
+__device__ unsigned hashReduceHash(unsigned key) {
+    key ^= key >> 16;
+    key *= 0x85ebca6bu;
+    key ^= key >> 13;
+    key *= 0xc2b2ae35u;
+    key ^= key >> 16;
+    return key;
+}
+
+template<typename T, af_op_t op>
+struct HashReduceAtomic;
+
+template<typename T>
+struct HashReduceAtomic<T, af_add_t> {
+    __device__ void operator()(T *ptr, T value) { atomicAdd(ptr, value); }
+};
+
+template<typename T>
+struct HashReduceAtomic<T, af_min_t> {
+    __device__ void operator()(T *ptr, T value) { atomicMin(ptr, value); }
+};
+
+template<typename T>
+struct HashReduceAtomic<T, af_max_t> {
+    __device__ void operator()(T *ptr, T value) { atomicMax(ptr, value); }
+};
+
+// The minimum and the maximum of floats replace the value until it does not
+// change concurrently. NaN values are ignored.
+template<>
+struct HashReduceAtomic<float, af_min_t> {
+    __device__ void operator()(float *ptr, float value) {
+        int *iptr = reinterpret_cast<int *>(ptr);
+        int old   = *iptr;
+        while (value < __int_as_float(old)) {
+            const int prev = atomicCAS(iptr, old, __float_as_int(value));
+            if (prev == old) { break; }
+            old = prev;
+        }
+    }
+};
+
+template<>
+struct HashReduceAtomic<float, af_max_t> {
+    __device__ void operator()(float *ptr, float value) {
+        int *iptr = reinterpret_cast<int *>(ptr);
+        int old   = *iptr;
+        while (value > __int_as_float(old)) {
+            const int prev = atomicCAS(iptr, old, __float_as_int(value));
+            if (prev == old) { break; }
+            old = prev;
+        }
+    }
+};
+
+// Reduces the value of each key into the slot of the key in a hash table with
+// open addressing. The slot of a key is claimed by swapping it with the empty
+// key, and the slots after it are probed when it belongs to another key. The
+// empty key itself is reduced into the extra slot at the end of the table.
+//
+// flags[0] is set when a key does not find a slot within maxProbes, and
+// flags[1] when the empty key is one of the keys.
+template<typename Ti, typename Tk, typename To, af_op_t op>
+__global__ void reduceByKeyHash(Tk *tableKeys, To *tableVals, uint *flags,
+                                const Tk *keys, const Ti *vals, dim_t n,
+                                unsigned slots, Tk emptyKey,
+                                unsigned maxProbes) {
+    HashReduceAtomic<To, op> reduce;
+    for (dim_t i = blockIdx.x * (dim_t)blockDim.x + threadIdx.x; i < n;
+         i += (dim_t)gridDim.x * blockDim.x) {
+        const Tk key  = keys[i];
+        unsigned slot = slots;
+        if (key == emptyKey) {
+            flags[1] = 1;
+        } else {
+            unsigned probe = hashReduceHash((unsigned)key) & (slots - 1);
+            for (unsigned p = 0; p < maxProbes; ++p) {
+                const Tk prev = atomicCAS(tableKeys + probe, emptyKey, key);
+                if (prev == emptyKey || prev == key) {
+                    slot = probe;
+                    break;
+                }
+                probe = (probe + 1) & (slots - 1);
+            }
+            if (slot == slots) {
+                flags[0] = 1;
+                continue;
+            }
+        }
+        reduce(tableVals + slot, To(vals[i]));
+    }
+}
+
+}  // namespace cuda
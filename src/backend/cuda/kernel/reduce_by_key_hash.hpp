@@ -0,0 +1,75 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/dispatch.hpp>
+#include <common/hash_reduce.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_cuda.hpp>
+#include <err_cuda.hpp>
+#include <nvrtc_kernel_headers/reduce_by_key_hash_cuh.hpp>
+#include <platform.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace cuda {
+namespace kernel {
+
+constexpr int HASH_REDUCE_THREADS = 256;
+/// The largest number of blocks, whose threads loop over the keys
+constexpr dim_t HASH_REDUCE_MAX_BLOCKS = 1024;
+
+/// Reduces the \p n values of \p vals by key into the hash table of
+/// \p tableKeys and \p tableVals, and copies the table to the host with one
+/// synchronization. The table has slots + 1 slots, filled with the empty key
+/// and the initial value of \p op, and \p flags holds two zeros.
+template<af_op_t op, typename Ti, typename Tk, typename To>
+common::HashReduceTable<Tk, To> reduceByKeyHash(Tk *tableKeys, To *tableVals,
+                                                uint *flags, const Tk *keys,
+                                                const Ti *vals, const dim_t n,
+                                                const dim_t slots) {
+    static const std::string source(reduce_by_key_hash_cuh,
+                                    reduce_by_key_hash_cuh_len);
+
+    auto reduceHash = common::getKernel(
+        "cuda::reduceByKeyHash", {source},
+        {TemplateTypename<Ti>(), TemplateTypename<Tk>(), TemplateTypename<To>(),
+         TemplateArg(op)});
+
+    const dim_t blocks =
+        std::min(divup(n, dim_t(HASH_REDUCE_THREADS)), HASH_REDUCE_MAX_BLOCKS);
+    EnqueueArgs qArgs(dim3(static_cast<unsigned>(blocks)),
+                      HASH_REDUCE_THREADS, getActiveStream());
+    reduceHash(qArgs, tableKeys, tableVals, flags, keys, vals, n,
+               static_cast<unsigned>(slots), common::hashReduceEmptyKey<Tk>(),
+               common::HASH_REDUCE_MAX_PROBES);
+    POST_LAUNCH_CHECK();
+
+    common::HashReduceTable<Tk, To> table;
+    table.keys.resize(slots + 1);
+    table.vals.resize(slots + 1);
+    uint hflags[2];
+    auto copy = [&](void *dst, const void *src, size_t bytes) {
+        CUDA_CHECK(cudaMemcpyAsync(dst, src, bytes, cudaMemcpyDeviceToHost,
+                                   getActiveStream()));
+    };
+    copy(table.keys.data(), tableKeys, (slots + 1) * sizeof(Tk));
+    copy(table.vals.data(), tableVals, (slots + 1) * sizeof(To));
+    copy(hflags, flags, sizeof(hflags));
+    CUDA_CHECK(cudaStreamSynchronize(getActiveStream()));
+
+    table.full          = hflags[0] != 0;
+    table.emptyKeyFound = hflags[1] != 0;
+    return table;
+}
+
+}  // namespace kernel
+}  // namespace cuda
@@ -0,0 +1,114 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Param.hpp>
+
+namespace cuda {
+
+typedef unsigned long long region_sum_t;
+
+// The accumulators of a label are REGION_ACC_WORDS words: the 64-bit sums
+// of the rows, the columns, the squared rows, the squared columns and the
+// products of the rows and columns, then the 32-bit area and the bitwise
+// complements of the first row and column and the last row and column. The
+// complements let all the accumulators start at zero.
+__device__ void flushRun(uint *acc, region_sum_t count, region_sum_t sr,
+                         region_sum_t srr, uint row0, uint row1, uint col) {
+    region_sum_t *sums = reinterpret_cast<region_sum_t *>(acc);
+    atomicAdd(sums + 0, sr);
+    atomicAdd(sums + 1, count * col);
+    atomicAdd(sums + 2, srr);
+    atomicAdd(sums + 3, count * col * col);
+    atomicAdd(sums + 4, sr * col);
+    atomicAdd(acc + 10, (uint)count);
+    atomicMax(acc + 11, ~row0);
+    atomicMax(acc + 12, ~col);
+    atomicMax(acc + 13, row1);
+    atomicMax(acc + 14, col);
+}
+
+// Every thread accumulates a run of RUN_LENGTH rows of a column, and
+// flushes its sums to the accumulators of a label when the label changes,
+// so the pixels of large regions cost few atomics
+template<typename T>
+__global__ void regionSums(Param<uint> acc, CParam<T> labels, int nlabels) {
+    const int j  = blockIdx.y * blockDim.y + threadIdx.y;
+    const int i0 = (blockIdx.x * blockDim.x + threadIdx.x) * RUN_LENGTH;
+    if (j >= labels.dims[1] || i0 >= labels.dims[0]) return;
+
+    const int i1 = min(i0 + RUN_LENGTH, (int)labels.dims[0]);
+    const T *col = labels.ptr + j * labels.strides[1];
+
+    int current      = 0;
+    int row0         = 0;
+    region_sum_t sr  = 0;
+    region_sum_t srr = 0;
+    for (int i = i0; i <= i1; ++i) {
+        const int label = i < i1 ? (int)col[i] : 0;
+        if (label != current) {
+            if (current >= 1 && current <= nlabels) {
+                flushRun(acc.ptr + (current - 1) * acc.strides[1], i - row0,
+                         sr, srr, row0, i - 1, j);
+            }
+            current = label;
+            row0    = i;
+            sr      = 0;
+            srr     = 0;
+        }
+        sr += i;
+        srr += (region_sum_t)i * i;
+    }
+}
+
+// Computes the properties of every label from its accumulators. The second
+// order sums are shifted to the first row and column of the bounding box,
+// which is exact in 64-bit integers, so the central moments do not suffer
+// from cancellation.
+__global__ void regionProps(Param<float> out, CParam<uint> acc) {
+    const int l = blockIdx.x * blockDim.x + threadIdx.x;
+    if (l >= out.dims[1]) return;
+
+    const uint *a           = acc.ptr + l * acc.strides[1];
+    const region_sum_t *sum = reinterpret_cast<const region_sum_t *>(a);
+    float *optr             = out.ptr + l * out.strides[1];
+
+    const region_sum_t area = a[10];
+    if (area == 0) {
+        for (int p = 0; p < REGION_PROP_COUNT; ++p) optr[p] = 0.f;
+        return;
+    }
+
+    const region_sum_t r0  = ~a[11];
+    const region_sum_t c0  = ~a[12];
+    const region_sum_t sr  = sum[0] - area * r0;
+    const region_sum_t sc  = sum[1] - area * c0;
+    const region_sum_t srr = sum[2] - 2 * r0 * sum[0] + area * r0 * r0;
+    const region_sum_t scc = sum[3] - 2 * c0 * sum[1] + area * c0 * c0;
+    const region_sum_t src =
+        sum[4] - r0 * sum[1] - c0 * sum[0] + area * r0 * c0;
+
+    const double mr = (double)sr / area;
+    const double mc = (double)sc / area;
+
+    optr[0]  = (float)area;
+    optr[1]  = (float)(r0 + mr);
+    optr[2]  = (float)(c0 + mc);
+    optr[3]  = (float)r0;
+    optr[4]  = (float)c0;
+    optr[5]  = (float)a[13];
+    optr[6]  = (float)a[14];
+    optr[7]  = (float)sum[0];
+    optr[8]  = (float)sum[1];
+    optr[9]  = (float)sum[4];
+    optr[10] = (float)(srr - sr * mr);
+    optr[11] = (float)(scc - sc * mc);
+    optr[12] = (float)(src - sr * mc);
+}
+
+}  // namespace cuda
@@ -0,0 +1,71 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <common/region_stats.hpp>
+#include <debug_cuda.hpp>
+#include <nvrtc_kernel_headers/region_props_cuh.hpp>
+
+#include <string>
+#include <vector>
+
+namespace cuda {
+namespace kernel {
+
+/// The number of 32-bit accumulators of each label
+constexpr int REGION_ACC_WORDS = 16;
+/// The number of rows of a column accumulated by a thread
+constexpr int RUN_LENGTH = 16;
+
+inline std::vector<std::string> regionPropsOptions() {
+    return {DefineValue(RUN_LENGTH),
+            DefineKeyValue(REGION_PROP_COUNT, common::REGION_PROP_COUNT)};
+}
+
+/// Accumulates the sums of the pixel coordinates of the labels 1 to
+/// \p nlabels into \p acc, which is REGION_ACC_WORDS x nlabels and zeroed
+template<typename T>
+void regionSums(Param<uint> acc, CParam<T> labels, int nlabels) {
+    static const std::string source(region_props_cuh, region_props_cuh_len);
+
+    auto regionSums =
+        common::getKernel("cuda::regionSums", {source}, {TemplateTypename<T>()},
+                          regionPropsOptions());
+
+    dim3 threads(32, 8);
+    dim3 blocks(divup(labels.dims[0], threads.x * RUN_LENGTH),
+                divup(labels.dims[1], threads.y));
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream());
+    regionSums(qArgs, acc, labels, nlabels);
+    POST_LAUNCH_CHECK();
+}
+
+/// Computes the properties of the labels from the accumulators of
+/// regionSums
+inline void regionProps(Param<float> out, CParam<uint> acc) {
+    static const std::string source(region_props_cuh, region_props_cuh_len);
+
+    auto regionProps = common::getKernel("cuda::regionProps", {source}, {},
+                                         regionPropsOptions());
+
+    dim3 threads(256);
+    dim3 blocks(divup(out.dims[1], threads.x));
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream());
+    regionProps(qArgs, out, acc);
+    POST_LAUNCH_CHECK();
+}
+
+}  // namespace kernel
+}  // namespace cuda
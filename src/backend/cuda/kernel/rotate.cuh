@@ -16,11 +16,13 @@ typedef struct {
     float tmat[6];
 } tmat_t;
 
-template<typename T, int order>
+// When UseTexture is true, the input is sampled from the texture tex (see
+// Texture2D.hpp) instead of global memory
+template<typename T, int order, bool UseTexture>
 __global__ void rotate(Param<T> out, CParam<T> in, const tmat_t t,
                        const int nimages, const int nbatches,
                        const int blocksXPerImage, const int blocksYPerImage,
-                       af::interpType method) {
+                       af::interpType method, unsigned long long tex) {
     // Compute which image set
     const int setId      = blockIdx.x / blocksXPerImage;
     const int blockIdx_x = blockIdx.x - setId * blocksXPerImage;
@@ -61,6 +63,15 @@ __global__ void rotate(Param<T> out, CParam<T> in, const tmat_t t,
         }
     }
 
+    if (UseTexture) {
+        // The images are packed, so the offset of an image is a whole
+        // number of rows
+        TexInterp2<T, order> interp;
+        interp(out, loco, tex, inoff / in.strides[1], in.dims[0], in.dims[1],
+               xidi, yidi, method, limages);
+        return;
+    }
+
     Interp2<T, WT, 0, 1, order> interp;
     // FIXME: Nearest and lower do not do clamping, but other methods do
     // Make it consistent
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <Param.hpp>
+#include <Texture2D.hpp>
 #include <common/dispatch.hpp>
 #include <common/kernel_cache.hpp>
 #include <debug_cuda.hpp>
@@ -36,8 +37,12 @@ void rotate(Param<T> out, CParam<T> in, const float theta,
             const af::interpType method, const int order) {
     static const std::string source(rotate_cuh, rotate_cuh_len);
 
-    auto rotate = common::getKernel(
-        "cuda::rotate", {source}, {TemplateTypename<T>(), TemplateArg(order)});
+    auto texture          = interpTexture<T>(in, method, order);
+    const bool useTexture = texture != nullptr;
+
+    auto rotate = common::getKernel("cuda::rotate", {source},
+                                    {TemplateTypename<T>(), TemplateArg(order),
+                                     TemplateArg(useTexture)});
 
     const float c = cos(-theta), s = sin(-theta);
     float tx, ty;
@@ -81,7 +86,8 @@ void rotate(Param<T> out, CParam<T> in, const float theta,
     EnqueueArgs qArgs(blocks, threads, getActiveStream());
 
     rotate(qArgs, out, in, t, nimages, nbatches, blocksXPerImage,
-           blocksYPerImage, method);
+           blocksYPerImage, method,
+           static_cast<unsigned long long>(useTexture ? texture->get() : 0));
 
     POST_LAUNCH_CHECK();
 }
@@ -0,0 +1,194 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Param.hpp>
+
+namespace cuda {
+
+// The summed-area table of each 2D slice is computed in tiles of TILE x TILE
+// values. satTileSums writes the sums of the columns and of the rows of each
+// tile, satColumnCarries and satRowCarries turn them into the sums of the
+// values above and to the left of each tile, and satTiles computes the table
+// of each tile with these carries. The carries of a slice are stored after
+// the carries of the previous slices.
+
+// Loads the tile at (i0, j0) of a slice, transposed so that the threads which
+// scan it read different banks
+template<typename Ti, typename To>
+__device__ void satLoad(To (*tile)[TILE + 1], const CParam<Ti> &in,
+                        uint slice, dim_t i0, dim_t j0) {
+    const Ti *iptr = in.ptr + (slice % in.dims[2]) * in.strides[2] +
+                     (slice / in.dims[2]) * in.strides[3];
+    const dim_t i = i0 + threadIdx.x;
+    for (int j = threadIdx.y; j < TILE; j += blockDim.y) {
+        const dim_t gj = j0 + j;
+        tile[j][threadIdx.x] =
+            i < in.dims[0] && gj < in.dims[1]
+                ? To(iptr[i * in.strides[0] + gj * in.strides[1]])
+                : To(0);
+    }
+    __syncthreads();
+}
+
+// Scans the columns of the tile along dim 0, one thread per column
+template<typename To>
+__device__ void satScanColumns(To (*tile)[TILE + 1]) {
+    const int tid = threadIdx.y * blockDim.x + threadIdx.x;
+    if (tid < TILE) {
+        To sum = To(0);
+        for (int i = 0; i < TILE; ++i) {
+            sum += tile[tid][i];
+            tile[tid][i] = sum;
+        }
+    }
+    __syncthreads();
+}
+
+// Scans the rows of the tile along dim 1, one thread per row
+template<typename To>
+__device__ void satScanRows(To (*tile)[TILE + 1]) {
+    const int tid = threadIdx.y * blockDim.x + threadIdx.x;
+    if (tid < TILE) {
+        To sum = To(0);
+        for (int j = 0; j < TILE; ++j) {
+            sum += tile[j][tid];
+            tile[j][tid] = sum;
+        }
+    }
+    __syncthreads();
+}
+
+// Writes the sum of each column of each tile to colSums, and the sum of each
+// row of the tile, up to the row, to rowSums
+template<typename Ti, typename To>
+__global__ void satTileSums(To *colSums, To *rowSums, CParam<Ti> in,
+                            uint tilesI, uint tilesJ) {
+    __shared__ To tile[TILE][TILE + 1];
+
+    const uint n     = blockIdx.x;
+    const uint m     = blockIdx.y;
+    const uint slice = blockIdx.z;
+    const dim_t i0   = (dim_t)m * TILE;
+    const dim_t j0   = (dim_t)n * TILE;
+    const dim_t H    = in.dims[0];
+    const dim_t W    = in.dims[1];
+    const int tid    = threadIdx.y * blockDim.x + threadIdx.x;
+
+    satLoad<Ti, To>(tile, in, slice, i0, j0);
+    satScanColumns(tile);
+    if (tid < TILE && j0 + tid < W) {
+        colSums[(slice * tilesI + m) * W + j0 + tid] = tile[tid][TILE - 1];
+    }
+    __syncthreads();
+
+    satScanRows(tile);
+    if (tid < TILE && i0 + tid < H) {
+        rowSums[(slice * tilesJ + n) * H + i0 + tid] = tile[TILE - 1][tid];
+    }
+}
+
+// Replaces the sums of the columns of the tiles by the sums of the values
+// above the tiles, and writes the sum of these carries over the columns of
+// each tile to tileCarries. The blocks have one thread per column of a tile.
+template<typename To>
+__global__ void satColumnCarries(To *colSums, To *tileCarries, dim_t W,
+                                 uint tilesI, uint tilesJ) {
+    __shared__ To s_carry[TILE];
+
+    const uint n     = blockIdx.x;
+    const uint slice = blockIdx.y;
+    const int tid    = threadIdx.x;
+    const dim_t j    = (dim_t)n * TILE + tid;
+
+    To running = To(0);
+    for (uint m = 0; m < tilesI; ++m) {
+        To carry = To(0);
+        if (j < W) {
+            To *ptr = colSums + (slice * tilesI + m) * W + j;
+            carry   = running;
+            running += *ptr;
+            *ptr = carry;
+        }
+
+        s_carry[tid] = carry;
+        __syncthreads();
+        for (int off = TILE / 2; off > 0; off /= 2) {
+            if (tid < off) { s_carry[tid] += s_carry[tid + off]; }
+            __syncthreads();
+        }
+        if (tid == 0) {
+            tileCarries[(slice * tilesI + m) * tilesJ + n] = s_carry[0];
+        }
+        __syncthreads();
+    }
+}
+
+// Replaces the sums of the rows of the tiles by the sums of the values to the
+// left of the tiles and above the rows, one thread per row
+template<typename To>
+__global__ void satRowCarries(To *rowSums, const To *tileCarries, dim_t H,
+                              uint tilesI, uint tilesJ) {
+    const dim_t i    = blockIdx.x * (dim_t)blockDim.x + threadIdx.x;
+    const uint slice = blockIdx.y;
+    if (i >= H) { return; }
+
+    const To *carries = tileCarries + (slice * tilesI + i / TILE) * tilesJ;
+    To running        = To(0);
+    for (uint n = 0; n < tilesJ; ++n) {
+        To *ptr       = rowSums + (slice * tilesJ + n) * H + i;
+        const To sums = *ptr;
+        *ptr          = running;
+        running += sums + carries[n];
+    }
+}
+
+// Computes the summed-area table of each tile, adding the values above the
+// tile to its columns and the values to its left to its first column before
+// the scan along dim 1
+template<typename Ti, typename To>
+__global__ void satTiles(Param<To> out, CParam<Ti> in, const To *colCarries,
+                         const To *rowCarries, uint tilesI, uint tilesJ) {
+    __shared__ To tile[TILE][TILE + 1];
+
+    const uint n     = blockIdx.x;
+    const uint m     = blockIdx.y;
+    const uint slice = blockIdx.z;
+    const dim_t i0   = (dim_t)m * TILE;
+    const dim_t j0   = (dim_t)n * TILE;
+    const dim_t H    = in.dims[0];
+    const dim_t W    = in.dims[1];
+    const dim_t i    = i0 + threadIdx.x;
+
+    satLoad<Ti, To>(tile, in, slice, i0, j0);
+    satScanColumns(tile);
+
+    for (int j = threadIdx.y; j < TILE; j += blockDim.y) {
+        const dim_t gj = j0 + j;
+        To carry       = To(0);
+        if (gj < W) { carry = colCarries[(slice * tilesI + m) * W + gj]; }
+        if (j == 0 && i < H) {
+            carry += rowCarries[(slice * tilesJ + n) * H + i];
+        }
+        tile[j][threadIdx.x] += carry;
+    }
+    __syncthreads();
+
+    satScanRows(tile);
+
+    To *optr = out.ptr + (slice % out.dims[2]) * out.strides[2] +
+               (slice / out.dims[2]) * out.strides[3];
+    for (int j = threadIdx.y; j < TILE; j += blockDim.y) {
+        const dim_t gj = j0 + j;
+        if (i < H && gj < W) {
+            optr[i + gj * out.strides[1]] = tile[j][threadIdx.x];
+        }
+    }
+}
+
+}  // namespace cuda
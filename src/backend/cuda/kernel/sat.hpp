@@ -0,0 +1,96 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_cuda.hpp>
+#include <memory.hpp>
+#include <nvrtc_kernel_headers/sat_cuh.hpp>
+
+#include <string>
+#include <vector>
+
+namespace cuda {
+namespace kernel {
+
+/// The size of the square tiles of the summed-area table
+constexpr unsigned SAT_TILE        = 32;
+constexpr unsigned SAT_THREADS_Y   = 8;
+constexpr unsigned SAT_ROW_THREADS = 256;
+
+/// Computes the summed-area table of each 2D slice of \p in.
+///
+/// The slices are split in tiles. A first kernel writes the sums of the
+/// columns and of the rows of each tile, two small kernels scan these sums
+/// across the tiles, and a last kernel computes the table of each tile with
+/// the carries of the tiles above and to its left. The input is read twice
+/// and the output written once, without an intermediate image.
+template<typename Ti, typename To>
+void sat(Param<To> out, CParam<Ti> in) {
+    static const std::string source(sat_cuh, sat_cuh_len);
+
+    const std::vector<std::string> options = {
+        DefineKeyValue(TILE, SAT_TILE),
+    };
+    auto tileSums = common::getKernel(
+        "cuda::satTileSums", {source},
+        {TemplateTypename<Ti>(), TemplateTypename<To>()}, options);
+    auto columnCarries = common::getKernel(
+        "cuda::satColumnCarries", {source}, {TemplateTypename<To>()}, options);
+    auto rowCarries = common::getKernel(
+        "cuda::satRowCarries", {source}, {TemplateTypename<To>()}, options);
+    auto tiles = common::getKernel(
+        "cuda::satTiles", {source},
+        {TemplateTypename<Ti>(), TemplateTypename<To>()}, options);
+
+    const dim_t H      = in.dims[0];
+    const dim_t W      = in.dims[1];
+    const dim_t slices = in.dims[2] * in.dims[3];
+    const dim_t tilesI = divup(H, dim_t(SAT_TILE));
+    const dim_t tilesJ = divup(W, dim_t(SAT_TILE));
+
+    auto colSums     = memAlloc<To>(slices * tilesI * W);
+    auto rowSums     = memAlloc<To>(slices * tilesJ * H);
+    auto tileCarries = memAlloc<To>(slices * tilesI * tilesJ);
+
+    const dim3 tileThreads(SAT_TILE, SAT_THREADS_Y);
+    const dim3 tileBlocks(static_cast<unsigned>(tilesJ),
+                          static_cast<unsigned>(tilesI),
+                          static_cast<unsigned>(slices));
+
+    EnqueueArgs sumArgs(tileBlocks, tileThreads, getActiveStream());
+    tileSums(sumArgs, colSums.get(), rowSums.get(), in,
+             static_cast<unsigned>(tilesI), static_cast<unsigned>(tilesJ));
+    POST_LAUNCH_CHECK();
+
+    EnqueueArgs columnArgs(dim3(static_cast<unsigned>(tilesJ),
+                                static_cast<unsigned>(slices)),
+                           SAT_TILE, getActiveStream());
+    columnCarries(columnArgs, colSums.get(), tileCarries.get(), W,
+                  static_cast<unsigned>(tilesI), static_cast<unsigned>(tilesJ));
+    POST_LAUNCH_CHECK();
+
+    EnqueueArgs rowArgs(dim3(static_cast<unsigned>(divup(H, SAT_ROW_THREADS)),
+                             static_cast<unsigned>(slices)),
+                        SAT_ROW_THREADS, getActiveStream());
+    rowCarries(rowArgs, rowSums.get(), tileCarries.get(), H,
+               static_cast<unsigned>(tilesI), static_cast<unsigned>(tilesJ));
+    POST_LAUNCH_CHECK();
+
+    EnqueueArgs tileArgs(tileBlocks, tileThreads, getActiveStream());
+    tiles(tileArgs, out, in, colSums.get(), rowSums.get(),
+          static_cast<unsigned>(tilesI), static_cast<unsigned>(tilesJ));
+    POST_LAUNCH_CHECK();
+}
+
+}  // namespace kernel
+}  // namespace cuda
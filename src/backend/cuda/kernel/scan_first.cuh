@@ -133,4 +133,161 @@ __global__ void scan_first_bcast(Param<To> out, CParam<To> tmp, uint blocks_x,
     }
 }
 
+// The states of the tiles of scan_first_lookback
+enum ScanTileState : uint {
+    SCAN_TILE_EMPTY     = 0,  // The tile has not published a value yet
+    SCAN_TILE_AGGREGATE = 1,  // The reduction of the tile is published
+    SCAN_TILE_PREFIX    = 2   // The scan up to the end of the tile is published
+};
+
+// Reads a value published by another block, bypassing the caches
+template<typename T>
+__device__ T loadPublished(const T *ptr) {
+    static_assert(sizeof(T) % sizeof(uint) == 0, "unsupported scan type");
+    T val;
+    const volatile uint *src = reinterpret_cast<const volatile uint *>(ptr);
+    uint *dst                = reinterpret_cast<uint *>(&val);
+#pragma unroll
+    for (int i = 0; i < sizeof(T) / sizeof(uint); ++i) { dst[i] = src[i]; }
+    return val;
+}
+
+// Publishes the value of a tile to the other blocks. The value is visible
+// before the state.
+template<typename T>
+__device__ void publishTile(T *values, uint *states, uint tile, T val,
+                            ScanTileState state) {
+    volatile uint *dst = reinterpret_cast<volatile uint *>(values + tile);
+    const uint *src    = reinterpret_cast<const uint *>(&val);
+#pragma unroll
+    for (int i = 0; i < sizeof(T) / sizeof(uint); ++i) { dst[i] = src[i]; }
+    __threadfence();
+    reinterpret_cast<volatile uint *>(states)[tile] = state;
+}
+
+// Scans the lines along dim 0 in one pass with decoupled look-back (Merrill
+// and Garland, "Single-pass Parallel Prefix Scan with Decoupled Look-back").
+//
+// Each block scans a tile of LOOKBACK_THREADS * LOOKBACK_ITEMS values of a
+// line, publishes the reduction of the tile, and then adds the values
+// published by the previous tiles of the line until one of them has
+// published the scan up to its end. The tiles are numbered in the order in
+// which the blocks start, so the tiles a block waits for are already running.
+//
+// The values and states of the tiles start empty, and counter starts at 0.
+template<typename Ti, typename To, af_op_t op, bool inclusive_scan>
+__global__ void scan_first_lookback(Param<To> out, CParam<Ti> in,
+                                    To *aggregates, To *prefixes,
+                                    uint *states, uint *counter,
+                                    uint tiles_x) {
+    constexpr int TILE = LOOKBACK_THREADS * LOOKBACK_ITEMS;
+
+    __shared__ To s_vals[TILE];
+    __shared__ To s_scan[2 * LOOKBACK_THREADS];
+    __shared__ uint s_tile;
+    __shared__ To s_prefix;
+
+    const int tid = threadIdx.x;
+    if (tid == 0) { s_tile = atomicAdd(counter, 1U); }
+    __syncthreads();
+
+    const uint tile = s_tile;
+    const uint line = tile / tiles_x;
+    const uint tx   = tile - line * tiles_x;
+
+    const uint yid = line % out.dims[1];
+    const uint zid = (line / out.dims[1]) % out.dims[2];
+    const uint wid = line / (out.dims[1] * out.dims[2]);
+
+    const Ti *iptr = in.ptr + wid * in.strides[3] + zid * in.strides[2] +
+                     yid * in.strides[1];
+    To *optr = out.ptr + wid * out.strides[3] + zid * out.strides[2] +
+               yid * out.strides[1];
+
+    common::Transform<Ti, To, op> transform;
+    common::Binary<To, op> binop;
+    const To init = common::Binary<To, op>::init();
+
+    // Coalesced loads of the tile, scanned by each thread in a row
+    const dim_t first = (dim_t)tx * TILE;
+#pragma unroll
+    for (int i = 0; i < LOOKBACK_ITEMS; ++i) {
+        const int k    = i * LOOKBACK_THREADS + tid;
+        const dim_t id = first + k;
+        s_vals[k]      = id < out.dims[0] ? transform(iptr[id]) : init;
+    }
+    __syncthreads();
+
+    To vals[LOOKBACK_ITEMS];
+    To threadAgg = init;
+#pragma unroll
+    for (int i = 0; i < LOOKBACK_ITEMS; ++i) {
+        vals[i]   = s_vals[tid * LOOKBACK_ITEMS + i];
+        threadAgg = binop(threadAgg, vals[i]);
+    }
+
+    // Inclusive scan of the reductions of the threads
+    int pin     = 0;
+    s_scan[tid] = threadAgg;
+    __syncthreads();
+    for (int off = 1; off < LOOKBACK_THREADS; off *= 2) {
+        To val = s_scan[pin * LOOKBACK_THREADS + tid];
+        if (tid >= off) {
+            val = binop(s_scan[pin * LOOKBACK_THREADS + tid - off], val);
+        }
+        pin                                  = 1 - pin;
+        s_scan[pin * LOOKBACK_THREADS + tid] = val;
+        __syncthreads();
+    }
+    const To *scanned = s_scan + pin * LOOKBACK_THREADS;
+    const To blockAgg = scanned[LOOKBACK_THREADS - 1];
+    To running        = tid == 0 ? init : scanned[tid - 1];
+
+    if (tid == 0) {
+        To prefix = init;
+        if (tx == 0) {
+            publishTile(prefixes, states, tile, blockAgg, SCAN_TILE_PREFIX);
+        } else {
+            publishTile(aggregates, states, tile, blockAgg,
+                        SCAN_TILE_AGGREGATE);
+
+            const volatile uint *vstates = states;
+            for (uint prev = tile - 1;; --prev) {
+                uint state;
+                while ((state = vstates[prev]) == SCAN_TILE_EMPTY) {}
+                __threadfence();
+                if (state == SCAN_TILE_PREFIX) {
+                    prefix = binop(loadPublished(prefixes + prev), prefix);
+                    break;
+                }
+                prefix = binop(loadPublished(aggregates + prev), prefix);
+            }
+            publishTile(prefixes, states, tile, binop(prefix, blockAgg),
+                        SCAN_TILE_PREFIX);
+        }
+        s_prefix = prefix;
+    }
+    __syncthreads();
+
+    running = binop(s_prefix, running);
+#pragma unroll
+    for (int i = 0; i < LOOKBACK_ITEMS; ++i) {
+        if (inclusive_scan) {
+            running                          = binop(running, vals[i]);
+            s_vals[tid * LOOKBACK_ITEMS + i] = running;
+        } else {
+            s_vals[tid * LOOKBACK_ITEMS + i] = running;
+            running                          = binop(running, vals[i]);
+        }
+    }
+    __syncthreads();
+
+#pragma unroll
+    for (int i = 0; i < LOOKBACK_ITEMS; ++i) {
+        const int k    = i * LOOKBACK_THREADS + tid;
+        const dim_t id = first + k;
+        if (id < out.dims[0]) { optr[id] = s_vals[k]; }
+    }
+}
+
 }  // namespace cuda
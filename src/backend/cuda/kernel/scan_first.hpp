@@ -11,6 +11,7 @@
 #include <backend.hpp>
 #include <common/dispatch.hpp>
 #include <common/kernel_cache.hpp>
+#include <common/util.hpp>
 #include <debug_cuda.hpp>
 #include <err_cuda.hpp>
 #include <memory.hpp>
@@ -72,6 +73,50 @@ static void bcast_first_launcher(Param<To> out, CParam<To> tmp,
     POST_LAUNCH_CHECK();
 }
 
+constexpr uint SCAN_LOOKBACK_THREADS = 256;
+/// The number of values scanned by a thread of scan_first_lookback
+constexpr uint SCAN_LOOKBACK_ITEMS = 8;
+
+/// Scans the lines along dim 0 in one pass, which reads and writes each value
+/// once, where the reduce, scan and broadcast kernels read and write it twice.
+/// The tiles of a line wait for the previous ones, so this is only used for
+/// lines which span several blocks.
+template<typename Ti, typename To, af_op_t op>
+static void scan_first_lookback(Param<To> out, CParam<Ti> in,
+                                bool inclusive_scan) {
+    auto scan_lookback = common::getKernel(
+        "cuda::scan_first_lookback", {ScanFirstSource},
+        {TemplateTypename<Ti>(), TemplateTypename<To>(), TemplateArg(op),
+         TemplateArg(inclusive_scan)},
+        {DefineValue(THREADS_PER_BLOCK),
+         DefineKeyValue(LOOKBACK_THREADS, SCAN_LOOKBACK_THREADS),
+         DefineKeyValue(LOOKBACK_ITEMS, SCAN_LOOKBACK_ITEMS)});
+
+    const dim_t tiles_x =
+        divup(out.dims[0], dim_t(SCAN_LOOKBACK_THREADS * SCAN_LOOKBACK_ITEMS));
+    const dim_t tiles = tiles_x * out.dims[1] * out.dims[2] * out.dims[3];
+
+    // The states of the tiles are followed by the counter of the tiles
+    auto aggregates = memAlloc<To>(tiles);
+    auto prefixes   = memAlloc<To>(tiles);
+    auto states     = memAlloc<uint>(tiles + 1);
+    CUDA_CHECK(cudaMemsetAsync(states.get(), 0, (tiles + 1) * sizeof(uint),
+                               getActiveStream()));
+
+    EnqueueArgs qArgs(dim3(static_cast<uint>(tiles)), SCAN_LOOKBACK_THREADS,
+                      getActiveStream());
+    scan_lookback(qArgs, out, in, aggregates.get(), prefixes.get(),
+                  states.get(), states.get() + tiles,
+                  static_cast<uint>(tiles_x));
+    POST_LAUNCH_CHECK();
+}
+
+/// The single-pass scan is used unless AF_CUDA_SCAN_LOOKBACK is 0
+static inline bool useScanLookback() {
+    static const bool useLookback = getEnvVar("AF_CUDA_SCAN_LOOKBACK") != "0";
+    return useLookback;
+}
+
 template<typename Ti, typename To, af_op_t op>
 static void scan_first(Param<To> out, CParam<Ti> in, bool inclusive_scan) {
     uint threads_x = nextpow2(std::max(32u, (uint)out.dims[0]));
@@ -85,6 +130,8 @@ static void scan_first(Param<To> out, CParam<Ti> in, bool inclusive_scan) {
         scan_first_launcher<Ti, To, op>(out, out, in, blocks_x, blocks_y,
                                         threads_x, true, inclusive_scan);
 
+    } else if (useScanLookback()) {
+        scan_first_lookback<Ti, To, op>(out, in, inclusive_scan);
     } else {
         Param<To> tmp = out;
 
@@ -0,0 +1,74 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_cuda.hpp>
+#include <nvrtc_kernel_headers/set_cuh.hpp>
+
+#include <string>
+
+namespace cuda {
+namespace kernel {
+
+constexpr int SET_THREADS = 256;
+
+/// Flags the values kept by the compaction of the first \p length[0] values
+/// of \p values, which are sorted. The first value of each run of equal
+/// values is kept, or the values equal to the next one when \p duplicates
+/// is true. All the \p capacity flags are written.
+template<typename T>
+void setFlags(uint *flags, const T *values, const uint *length,
+              const dim_t capacity, const bool duplicates) {
+    static const std::string source(set_cuh, set_cuh_len);
+    auto flagValues =
+        common::getKernel("cuda::setFlags", {source},
+                          {TemplateTypename<T>(), TemplateArg(duplicates)});
+
+    EnqueueArgs qArgs(dim3(static_cast<unsigned>(divup(capacity, SET_THREADS))),
+                      SET_THREADS, getActiveStream());
+    flagValues(qArgs, flags, values, length, capacity);
+    POST_LAUNCH_CHECK();
+}
+
+/// Writes the values flagged by setFlags at the positions given by the
+/// inclusive scan of the flags, and their number in \p outLength[0]
+template<typename T>
+void setScatter(T *out, uint *outLength, const T *values, const uint *flags,
+                const uint *positions, const dim_t capacity) {
+    static const std::string source(set_cuh, set_cuh_len);
+    auto scatter = common::getKernel("cuda::setScatter", {source},
+                                     {TemplateTypename<T>()});
+
+    EnqueueArgs qArgs(dim3(static_cast<unsigned>(divup(capacity, SET_THREADS))),
+                      SET_THREADS, getActiveStream());
+    scatter(qArgs, out, outLength, values, flags, positions, capacity);
+    POST_LAUNCH_CHECK();
+}
+
+/// Merges the first \p aLength[0] values of \p a and the first \p bLength[0]
+/// values of \p b, which are sorted, along the merge path. The lengths are
+/// only read on the device, and \p capacity is at least their sum.
+template<typename T>
+void setMerge(T *out, uint *outLength, const T *a, const uint *aLength,
+              const T *b, const uint *bLength, const dim_t capacity) {
+    static const std::string source(set_cuh, set_cuh_len);
+    auto merge = common::getKernel("cuda::setMerge", {source},
+                                   {TemplateTypename<T>()});
+
+    EnqueueArgs qArgs(dim3(static_cast<unsigned>(divup(capacity, SET_THREADS))),
+                      SET_THREADS, getActiveStream());
+    merge(qArgs, out, outLength, a, aLength, b, bLength, capacity);
+    POST_LAUNCH_CHECK();
+}
+
+}  // namespace kernel
+}  // namespace cuda
@@ -9,17 +9,101 @@
 
 #include <Param.hpp>
 #include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
 #include <debug_cuda.hpp>
 #include <err_cuda.hpp>
 #include <handle.hpp>
 #include <iota.hpp>
 #include <kernel/thrust_sort_by_key.hpp>
 #include <math.hpp>
+#include <memory.hpp>
+#include <nvrtc_kernel_headers/sort_short_cuh.hpp>
+#include <thrust/sequence.h>
 #include <thrust/sort.h>
 #include <thrust_utils.hpp>
 
+#include <cub/device/device_segmented_radix_sort.cuh>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
 namespace cuda {
 namespace kernel {
+
+constexpr int SORT_SHORT_THREADS = 256;
+constexpr int SORT_SHORT_LENGTH  = 4096;
+
+/// The value which pads the columns of the short sorts. It is ordered after
+/// all the other values.
+template<typename T>
+T sortPadding(bool isAscending) {
+    using limits = std::numeric_limits<T>;
+    if (limits::has_infinity) {
+        return isAscending ? limits::infinity() : -limits::infinity();
+    }
+    return isAscending ? limits::max() : limits::lowest();
+}
+
+/// Sorts the columns of at most SORT_SHORT_LENGTH values in one launch.
+/// Each block sorts one column in shared memory.
+template<typename T>
+void sort0Short(Param<T> val, bool isAscending) {
+    static const std::string source(sort_short_cuh, sort_short_cuh_len);
+
+    auto sortShort =
+        common::getKernel("cuda::sortShort", {source},
+                          {TemplateTypename<T>(), TemplateArg(isAscending)});
+
+    int length = 1;
+    while (length < val.dims[0]) { length *= 2; }
+    const int lines   = val.dims[1] * val.dims[2] * val.dims[3];
+    const int threads = std::min(SORT_SHORT_THREADS, std::max(length / 2, 32));
+
+    EnqueueArgs qArgs(dim3(lines), dim3(threads), getActiveStream(),
+                      length * sizeof(T));
+    sortShort(qArgs, val, length, sortPadding<T>(isAscending));
+    POST_LAUNCH_CHECK();
+}
+
+/// Sorts all the columns of a linear \p val with one segmented radix sort
+template<typename T>
+void sort0Segmented(Param<T> val, bool isAscending) {
+    const int n        = val.dims[0];
+    const int segments = val.dims[1] * val.dims[2] * val.dims[3];
+    const int elements = n * segments;
+
+    auto offsets = memAlloc<int>(segments + 1);
+    THRUST_SELECT(thrust::sequence, offsets.get(),
+                  offsets.get() + segments + 1, 0, n);
+
+    auto buffer = memAlloc<T>(elements);
+    cub::DoubleBuffer<T> keys(val.ptr, buffer.get());
+
+    size_t tempBytes = 0;
+    auto sortKeys    = [&](void *temp) {
+        if (isAscending) {
+            CUDA_CHECK(cub::DeviceSegmentedRadixSort::SortKeys(
+                temp, tempBytes, keys, elements, segments, offsets.get(),
+                offsets.get() + 1, 0, sizeof(T) * 8, getActiveStream()));
+        } else {
+            CUDA_CHECK(cub::DeviceSegmentedRadixSort::SortKeysDescending(
+                temp, tempBytes, keys, elements, segments, offsets.get(),
+                offsets.get() + 1, 0, sizeof(T) * 8, getActiveStream()));
+        }
+    };
+    sortKeys(nullptr);
+    auto temp = memAlloc<char>(tempBytes);
+    sortKeys(temp.get());
+
+    if (keys.Current() != val.ptr) {
+        CUDA_CHECK(cudaMemcpyAsync(val.ptr, keys.Current(),
+                                   elements * sizeof(T),
+                                   cudaMemcpyDeviceToDevice,
+                                   getActiveStream()));
+    }
+}
+
 // Wrapper functions
 template<typename T>
 void sort0Iterative(Param<T> val, bool isAscending) {
@@ -69,14 +153,24 @@ void sortBatched(Param<T> pVal, int dim, bool isAscending) {
     thrustSortByKey(pKey.get(), pVal.ptr, pVal.dims[0], true);
 }
 
+/// Sorts the columns of the linear \p val. Short columns are sorted by one
+/// block each and longer ones by a segmented radix sort, so a batch takes a
+/// fixed number of launches. A single column uses the sort of thrust.
 template<typename T>
 void sort0(Param<T> val, bool isAscending) {
-    int higherDims = val.dims[1] * val.dims[2] * val.dims[3];
+    const dim_t higherDims = val.dims[1] * val.dims[2] * val.dims[3];
+    const dim_t elements   = val.dims[0] * higherDims;
+    if (elements == 0) { return; }
 
-    if (higherDims > 10)
+    if (val.dims[0] <= SORT_SHORT_LENGTH) {
+        sort0Short<T>(val, isAscending);
+    } else if (higherDims == 1) {
+        sort0Iterative<T>(val, isAscending);
+    } else if (elements <= std::numeric_limits<int>::max()) {
+        sort0Segmented<T>(val, isAscending);
+    } else {
         sortBatched<T>(val, 0, isAscending);
-    else
-        kernel::sort0Iterative<T>(val, isAscending);
+    }
 }
 }  // namespace kernel
 }  // namespace cuda
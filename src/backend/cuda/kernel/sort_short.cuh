@@ -0,0 +1,58 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Param.hpp>
+#include <shared.hpp>
+
+namespace cuda {
+
+// Sorts each column of val in shared memory with a bitonic sorting network,
+// one block per column. The columns are padded to length, a power of two,
+// with a value which is ordered after all the others.
+template<typename T, bool isAscending>
+__global__ void sortShort(Param<T> val, const int length, const T padding) {
+    SharedMemory<T> shared;
+    T *s_val = shared.getPointer();
+
+    const int n    = val.dims[0];
+    const int line = blockIdx.x;
+    const int y    = line % val.dims[1];
+    const int z    = (line / val.dims[1]) % val.dims[2];
+    const int w    = line / (val.dims[1] * val.dims[2]);
+    T *ptr = val.ptr + y * val.strides[1] + z * val.strides[2] +
+             w * val.strides[3];
+
+    for (int i = threadIdx.x; i < length; i += blockDim.x) {
+        s_val[i] = i < n ? ptr[i] : padding;
+    }
+    __syncthreads();
+
+    const int pairs = length / 2;
+    for (int k = 2; k <= length; k <<= 1) {
+        for (int j = k / 2; j > 0; j /= 2) {
+            for (int p = threadIdx.x; p < pairs; p += blockDim.x) {
+                const int i = 2 * j * (p / j) + (p % j);
+                // The sequences of k values are sorted in alternating
+                // directions, which makes each pair of them bitonic
+                const bool up = ((i & k) == 0) == isAscending;
+                const T a     = s_val[i];
+                const T b     = s_val[i + j];
+                if (up ? b < a : a < b) {
+                    s_val[i]     = b;
+                    s_val[i + j] = a;
+                }
+            }
+            __syncthreads();
+        }
+    }
+
+    for (int i = threadIdx.x; i < n; i += blockDim.x) { ptr[i] = s_val[i]; }
+}
+
+}  // namespace cuda
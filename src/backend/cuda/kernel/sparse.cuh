@@ -10,6 +10,7 @@
 #pragma once
 
 #include <Param.hpp>
+#include <math.hpp>
 
 namespace cuda {
 
@@ -32,4 +33,105 @@ __global__ void coo2Dense(Param<T> output, CParam<T> values, CParam<int> rowIdx,
     }
 }
 
+// The conversions of dense arrays count the nonzeros of each row or column,
+// scan the counts into offsets and write each row or column at its offset
+
+template<typename T>
+__global__ void nnzPerRow(Param<int> counts, CParam<T> in) {
+    const int row = blockIdx.x * blockDim.x + threadIdx.x;
+    if (row > in.dims[0]) return;
+
+    // The extra count makes the last offset of the exclusive scan the nnz
+    int count = 0;
+    if (row < in.dims[0]) {
+        const T *ptr = in.ptr + row * in.strides[0];
+        for (int j = 0; j < in.dims[1]; ++j) {
+            count += ptr[j * in.strides[1]] != scalar<T>(0);
+        }
+    }
+    counts.ptr[row] = count;
+}
+
+template<typename T>
+__global__ void dense2CsrRows(Param<T> values, Param<int> colIdx, CParam<T> in,
+                              CParam<int> offsets) {
+    const int row = blockIdx.x * blockDim.x + threadIdx.x;
+    if (row >= in.dims[0]) return;
+
+    // The threads of a warp read consecutive rows of each column
+    const T *ptr = in.ptr + row * in.strides[0];
+    int k        = offsets.ptr[row];
+    for (int j = 0; j < in.dims[1]; ++j) {
+        const T v = ptr[j * in.strides[1]];
+        if (v != scalar<T>(0)) {
+            values.ptr[k] = v;
+            colIdx.ptr[k] = j;
+            ++k;
+        }
+    }
+}
+
+template<typename T, int threads>
+__global__ void nnzPerCol(Param<int> counts, CParam<T> in) {
+    __shared__ int s_count[threads];
+
+    const int col = blockIdx.x;
+    const int tid = threadIdx.x;
+
+    int count = 0;
+    if (col < in.dims[1]) {
+        const T *ptr = in.ptr + col * in.strides[1];
+        for (int i = tid; i < in.dims[0]; i += threads) {
+            count += ptr[i * in.strides[0]] != scalar<T>(0);
+        }
+    }
+    s_count[tid] = count;
+    __syncthreads();
+
+    for (int n = threads / 2; n > 0; n /= 2) {
+        if (tid < n) { s_count[tid] += s_count[tid + n]; }
+        __syncthreads();
+    }
+    if (tid == 0) { counts.ptr[col] = s_count[0]; }
+}
+
+// One block writes one column in chunks. The nonzeros of a chunk are placed
+// with an exclusive scan of their flags in shared memory.
+template<typename T, int threads, bool writeCol>
+__global__ void dense2SparseCols(Param<T> values, Param<int> rowIdx,
+                                 Param<int> colIdx, CParam<T> in,
+                                 CParam<int> offsets) {
+    __shared__ int s_flag[threads];
+
+    const int col = blockIdx.x;
+    const int tid = threadIdx.x;
+    const int M   = in.dims[0];
+    const T *ptr  = in.ptr + col * in.strides[1];
+
+    int base = offsets.ptr[col];
+    for (int start = 0; start < M; start += threads) {
+        const int i    = start + tid;
+        const T v      = i < M ? ptr[i * in.strides[0]] : scalar<T>(0);
+        const int flag = v != scalar<T>(0);
+
+        s_flag[tid] = flag;
+        __syncthreads();
+        for (int n = 1; n < threads; n *= 2) {
+            const int add = tid >= n ? s_flag[tid - n] : 0;
+            __syncthreads();
+            s_flag[tid] += add;
+            __syncthreads();
+        }
+
+        if (flag) {
+            const int k   = base + s_flag[tid] - 1;
+            values.ptr[k] = v;
+            rowIdx.ptr[k] = i;
+            if (writeCol) { colIdx.ptr[k] = col; }
+        }
+        base += s_flag[threads - 1];
+        __syncthreads();
+    }
+}
+
 }  // namespace cuda
@@ -41,5 +41,88 @@ void coo2dense(Param<T> output, CParam<T> values, CParam<int> rowIdx,
     POST_LAUNCH_CHECK();
 }
 
+constexpr int DENSE2SPARSE_THREADS = 256;
+
+/// Writes the number of nonzeros of each row of \p in to \p counts, which
+/// has one more element than the rows. The extra element is set to 0.
+template<typename T>
+void nnzPerRow(Param<int> counts, CParam<T> in) {
+    static const std::string source(sparse_cuh, sparse_cuh_len);
+
+    auto nnzPerRow =
+        common::getKernel("cuda::nnzPerRow", {source}, {TemplateTypename<T>()});
+
+    dim3 threads(DENSE2SPARSE_THREADS);
+    dim3 blocks(divup(counts.dims[0], threads.x));
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream());
+
+    nnzPerRow(qArgs, counts, in);
+    POST_LAUNCH_CHECK();
+}
+
+/// Writes the nonzeros of each row of \p in at the row's offset of
+/// \p offsets
+template<typename T>
+void dense2csrRows(Param<T> values, Param<int> colIdx, CParam<T> in,
+                   CParam<int> offsets) {
+    if (in.dims[0] == 0) { return; }
+    static const std::string source(sparse_cuh, sparse_cuh_len);
+
+    auto dense2CsrRows = common::getKernel("cuda::dense2CsrRows", {source},
+                                           {TemplateTypename<T>()});
+
+    dim3 threads(DENSE2SPARSE_THREADS);
+    dim3 blocks(divup(in.dims[0], threads.x));
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream());
+
+    dense2CsrRows(qArgs, values, colIdx, in, offsets);
+    POST_LAUNCH_CHECK();
+}
+
+/// Writes the number of nonzeros of each column of \p in to \p counts,
+/// which has one more element than the columns. The extra element is set
+/// to 0.
+template<typename T>
+void nnzPerCol(Param<int> counts, CParam<T> in) {
+    static const std::string source(sparse_cuh, sparse_cuh_len);
+
+    auto nnzPerCol = common::getKernel(
+        "cuda::nnzPerCol", {source},
+        {TemplateTypename<T>(), TemplateArg(DENSE2SPARSE_THREADS)});
+
+    dim3 threads(DENSE2SPARSE_THREADS);
+    dim3 blocks(counts.dims[0]);
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream());
+
+    nnzPerCol(qArgs, counts, in);
+    POST_LAUNCH_CHECK();
+}
+
+/// Writes the nonzeros of each column of \p in at the column's offset of
+/// \p offsets in column major order. The column indices are only written
+/// to \p colIdx if \p writeCol is true.
+template<typename T, bool writeCol>
+void dense2sparseCols(Param<T> values, Param<int> rowIdx, Param<int> colIdx,
+                      CParam<T> in, CParam<int> offsets) {
+    if (in.dims[1] == 0) { return; }
+    static const std::string source(sparse_cuh, sparse_cuh_len);
+
+    auto dense2SparseCols = common::getKernel(
+        "cuda::dense2SparseCols", {source},
+        {TemplateTypename<T>(), TemplateArg(DENSE2SPARSE_THREADS),
+         TemplateArg(writeCol)});
+
+    dim3 threads(DENSE2SPARSE_THREADS);
+    dim3 blocks(in.dims[1]);
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream());
+
+    dense2SparseCols(qArgs, values, rowIdx, colIdx, in, offsets);
+    POST_LAUNCH_CHECK();
+}
+
 }  // namespace kernel
 }  // namespace cuda
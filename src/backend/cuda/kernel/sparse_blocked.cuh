@@ -0,0 +1,77 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <math.hpp>
+
+namespace cuda {
+
+// One thread computes one row of one column of the output
+
+template<typename T>
+__global__ void bsrmm(Param<T> out, CParam<T> values, CParam<int> rowIdx,
+                      CParam<int> colIdx, CParam<T> rhs, const int blockSize) {
+    const int row = blockIdx.x * blockDim.x + threadIdx.x;
+    const int M   = out.dims[0];
+    const int N   = rhs.dims[0];
+    if (row >= M) return;
+
+    const int b  = blockSize;
+    const int br = row / b;
+    const int ii = row - br * b;
+
+    for (int o = blockIdx.y; o < out.dims[1]; o += gridDim.y) {
+        const T *x = rhs.ptr + o * rhs.strides[1];
+        T y        = scalar<T>(0);
+        for (int blk = rowIdx.ptr[br]; blk < rowIdx.ptr[br + 1]; ++blk) {
+            // Blocks are column major
+            const T *v     = values.ptr + blk * b * b + ii;
+            const int col  = colIdx.ptr[blk] * b;
+            const int cols = min(b, N - col);
+            for (int jj = 0; jj < cols; ++jj) {
+                y = y + v[jj * b] * x[col + jj];
+            }
+        }
+        out.ptr[o * out.strides[1] + row] = y;
+    }
+}
+
+// The threads of a slice read consecutive values and columns
+
+template<typename T>
+__global__ void sellmm(Param<T> out, CParam<T> values, CParam<int> rowIdx,
+                       CParam<int> colIdx, CParam<T> rhs, const int sliceSize,
+                       const int nSlices) {
+    const int p = blockIdx.x * blockDim.x + threadIdx.x;
+    if (p >= out.dims[0]) return;
+
+    const int C      = sliceSize;
+    const int s      = p / C;
+    const int r      = p - s * C;
+    const int *perm  = rowIdx.ptr + nSlices + 1;
+    const int start  = rowIdx.ptr[s];
+    const int width  = (rowIdx.ptr[s + 1] - start) / C;
+    const int outRow = perm[p];
+
+    for (int o = blockIdx.y; o < out.dims[1]; o += gridDim.y) {
+        const T *x = rhs.ptr + o * rhs.strides[1];
+        T y        = scalar<T>(0);
+        for (int k = 0; k < width; ++k) {
+            const int idx = start + k * C + r;
+            const int c   = colIdx.ptr[idx];
+            // The padding has the column -1
+            if (c >= 0) { y = y + values.ptr[idx] * x[c]; }
+        }
+        out.ptr[o * out.strides[1] + outRow] = y;
+    }
+}
+
+}  // namespace cuda
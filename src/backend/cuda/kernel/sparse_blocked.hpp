@@ -0,0 +1,75 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_cuda.hpp>
+#include <nvrtc_kernel_headers/sparse_blocked_cuh.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace cuda {
+namespace kernel {
+
+constexpr int SPARSE_BLOCKED_THREADS = 256;
+
+inline dim3 sparseBlockedBlocks(const int rows, const int cols) {
+    const int maxBlocksY =
+        cuda::getDeviceProp(cuda::getActiveDeviceId()).maxGridSize[1];
+    return dim3(divup(rows, SPARSE_BLOCKED_THREADS),
+                std::min(cols, maxBlocksY));
+}
+
+/// Computes out = lhs * rhs for the BSR matrix lhs of \p values, \p rowIdx
+/// and \p colIdx
+template<typename T>
+void bsrmm(Param<T> out, CParam<T> values, CParam<int> rowIdx,
+           CParam<int> colIdx, CParam<T> rhs, const int blockSize) {
+    static const std::string source(sparse_blocked_cuh,
+                                    sparse_blocked_cuh_len);
+
+    auto bsrmm =
+        common::getKernel("cuda::bsrmm", {source}, {TemplateTypename<T>()});
+
+    dim3 threads(SPARSE_BLOCKED_THREADS);
+    dim3 blocks = sparseBlockedBlocks(out.dims[0], out.dims[1]);
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream());
+
+    bsrmm(qArgs, out, values, rowIdx, colIdx, rhs, blockSize);
+    POST_LAUNCH_CHECK();
+}
+
+/// Computes out = lhs * rhs for the SELL matrix lhs of \p values, \p rowIdx
+/// and \p colIdx
+template<typename T>
+void sellmm(Param<T> out, CParam<T> values, CParam<int> rowIdx,
+            CParam<int> colIdx, CParam<T> rhs, const int sliceSize) {
+    static const std::string source(sparse_blocked_cuh,
+                                    sparse_blocked_cuh_len);
+
+    auto sellmm =
+        common::getKernel("cuda::sellmm", {source}, {TemplateTypename<T>()});
+
+    dim3 threads(SPARSE_BLOCKED_THREADS);
+    dim3 blocks = sparseBlockedBlocks(out.dims[0], out.dims[1]);
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream());
+
+    const int nSlices = divup(out.dims[0], sliceSize);
+    sellmm(qArgs, out, values, rowIdx, colIdx, rhs, sliceSize, nSlices);
+    POST_LAUNCH_CHECK();
+}
+
+}  // namespace kernel
+}  // namespace cuda
@@ -0,0 +1,103 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Param.hpp>
+
+namespace cuda {
+
+// The statistics of a summary accumulated by a thread
+template<typename T, typename Ts>
+struct SummaryAcc {
+    T min;
+    T max;
+    Ts sum;
+    Ts sumsq;
+    uint count;
+};
+
+template<typename T, typename Ts>
+__device__ void summaryCombine(SummaryAcc<T, Ts> &acc,
+                               const SummaryAcc<T, Ts> &other) {
+    acc.min = other.min < acc.min ? other.min : acc.min;
+    acc.max = other.max > acc.max ? other.max : acc.max;
+    acc.sum += other.sum;
+    acc.sumsq += other.sumsq;
+    acc.count += other.count;
+}
+
+// Reduces the values of in into the statistics of each block, stored at
+// blockIdx.y * gridDim.x + blockIdx.x. The blocks along y take the lines along
+// dim 0, and the blocks along x split each line. NaN values are ignored by the
+// minimum and the maximum.
+template<typename T, typename Ts>
+__global__ void summaryParts(T *pMin, T *pMax, Ts *pSum, Ts *pSumSq,
+                             uint *pCount, CParam<T> in, dim_t lines,
+                             T minInit, T maxInit) {
+    __shared__ T s_min[THREADS];
+    __shared__ T s_max[THREADS];
+    __shared__ Ts s_sum[THREADS];
+    __shared__ Ts s_sumsq[THREADS];
+    __shared__ uint s_count[THREADS];
+
+    const int tid = threadIdx.x;
+    SummaryAcc<T, Ts> acc{minInit, maxInit, Ts(0), Ts(0), 0};
+
+    for (dim_t line = blockIdx.y; line < lines; line += gridDim.y) {
+        const dim_t i1 = line % in.dims[1];
+        const dim_t i2 = (line / in.dims[1]) % in.dims[2];
+        const dim_t i3 = line / (in.dims[1] * in.dims[2]);
+        const T *iptr  = in.ptr + i1 * in.strides[1] + i2 * in.strides[2] +
+                        i3 * in.strides[3];
+        for (dim_t i = blockIdx.x * (dim_t)THREADS + tid; i < in.dims[0];
+             i += gridDim.x * (dim_t)THREADS) {
+            const T v = iptr[i];
+            if (v == v) {
+                acc.min = v < acc.min ? v : acc.min;
+                acc.max = v > acc.max ? v : acc.max;
+            }
+            const Ts s = Ts(v);
+            acc.sum += s;
+            acc.sumsq += s * s;
+            acc.count += v != T(0);
+        }
+    }
+
+    s_min[tid]   = acc.min;
+    s_max[tid]   = acc.max;
+    s_sum[tid]   = acc.sum;
+    s_sumsq[tid] = acc.sumsq;
+    s_count[tid] = acc.count;
+    __syncthreads();
+
+    for (int offset = THREADS / 2; offset > 0; offset /= 2) {
+        if (tid < offset) {
+            SummaryAcc<T, Ts> other{s_min[tid + offset], s_max[tid + offset],
+                                    s_sum[tid + offset], s_sumsq[tid + offset],
+                                    s_count[tid + offset]};
+            summaryCombine(acc, other);
+            s_min[tid]   = acc.min;
+            s_max[tid]   = acc.max;
+            s_sum[tid]   = acc.sum;
+            s_sumsq[tid] = acc.sumsq;
+            s_count[tid] = acc.count;
+        }
+        __syncthreads();
+    }
+
+    if (tid == 0) {
+        const dim_t part = blockIdx.y * (dim_t)gridDim.x + blockIdx.x;
+        pMin[part]       = acc.min;
+        pMax[part]       = acc.max;
+        pSum[part]       = acc.sum;
+        pSumSq[part]     = acc.sumsq;
+        pCount[part]     = acc.count;
+    }
+}
+
+}  // namespace cuda
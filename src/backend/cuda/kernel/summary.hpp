@@ -0,0 +1,112 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <common/summary.hpp>
+#include <debug_cuda.hpp>
+#include <err_cuda.hpp>
+#include <memory.hpp>
+#include <nvrtc_kernel_headers/summary_cuh.hpp>
+#include <platform.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace cuda {
+namespace kernel {
+
+constexpr int SUMMARY_THREADS = 256;
+/// The number of values reduced by a thread before the statistics of the
+/// threads of a block are combined
+constexpr dim_t SUMMARY_THREAD_ELEMENTS = 64;
+/// The largest number of blocks, whose statistics are combined on the host
+constexpr dim_t SUMMARY_MAX_PARTS  = 1024;
+constexpr dim_t SUMMARY_MAX_BLOCKS = 65535;
+
+/// Computes the statistics of all the values of \p in in one pass.
+///
+/// Each block reduces parts of the lines along dim 0 into a tuple of the
+/// minimum, the maximum, the sum, the sum of the squares and the number of
+/// nonzero values. The statistics of the blocks are copied to the host with
+/// one synchronization, and combined there like reduce_all.
+template<typename T>
+common::Summary summary_all(CParam<T> in) {
+    using Ts = common::summary_sum_t<T>;
+    static const std::string source(summary_cuh, summary_cuh_len);
+
+    const dim_t elements = in.dims[0] * in.dims[1] * in.dims[2] * in.dims[3];
+    if (elements == 0) {
+        return common::combineSummaries<T>(nullptr, nullptr, nullptr, nullptr,
+                                           nullptr, 0);
+    }
+
+    bool isLinear = in.strides[0] == 1;
+    for (int k = 1; k < 4; ++k) {
+        isLinear &= in.strides[k] == in.strides[k - 1] * in.dims[k - 1];
+    }
+    if (isLinear) {
+        in.dims[0] = elements;
+        for (int k = 1; k < 4; ++k) {
+            in.dims[k]    = 1;
+            in.strides[k] = elements;
+        }
+    }
+
+    auto reduceParts = common::getKernel(
+        "cuda::summaryParts", {source},
+        {TemplateTypename<T>(), TemplateTypename<Ts>()},
+        {DefineKeyValue(THREADS, SUMMARY_THREADS)});
+
+    const dim_t lines  = in.dims[1] * in.dims[2] * in.dims[3];
+    const dim_t partsX = std::min(
+        divup(in.dims[0], SUMMARY_THREADS * SUMMARY_THREAD_ELEMENTS),
+        SUMMARY_MAX_PARTS);
+    const dim_t partsY = std::min(
+        {lines, divup(SUMMARY_MAX_PARTS, partsX), SUMMARY_MAX_BLOCKS});
+    const dim_t parts = partsX * partsY;
+
+    auto pMin   = memAlloc<T>(parts);
+    auto pMax   = memAlloc<T>(parts);
+    auto pSum   = memAlloc<Ts>(parts);
+    auto pSumSq = memAlloc<Ts>(parts);
+    auto pCount = memAlloc<uint>(parts);
+
+    EnqueueArgs qArgs(dim3(static_cast<unsigned>(partsX),
+                           static_cast<unsigned>(partsY)),
+                      SUMMARY_THREADS, getActiveStream());
+    reduceParts(qArgs, pMin.get(), pMax.get(), pSum.get(), pSumSq.get(),
+                pCount.get(), in, lines, common::summaryMinInit<T>(),
+                common::summaryMaxInit<T>());
+    POST_LAUNCH_CHECK();
+
+    std::vector<T> mins(parts), maxs(parts);
+    std::vector<Ts> sums(parts), sumsqs(parts);
+    std::vector<uint> counts(parts);
+    auto copy = [&](void *dst, const void *src, size_t bytes) {
+        CUDA_CHECK(cudaMemcpyAsync(dst, src, bytes, cudaMemcpyDeviceToHost,
+                                   getActiveStream()));
+    };
+    copy(mins.data(), pMin.get(), parts * sizeof(T));
+    copy(maxs.data(), pMax.get(), parts * sizeof(T));
+    copy(sums.data(), pSum.get(), parts * sizeof(Ts));
+    copy(sumsqs.data(), pSumSq.get(), parts * sizeof(Ts));
+    copy(counts.data(), pCount.get(), parts * sizeof(uint));
+    CUDA_CHECK(cudaStreamSynchronize(getActiveStream()));
+
+    return common::combineSummaries<T>(mins.data(), maxs.data(), sums.data(),
+                                       sumsqs.data(), counts.data(), parts);
+}
+
+}  // namespace kernel
+}  // namespace cuda
@@ -8,17 +8,25 @@
  ********************************************************/
 
 #include <cub/block/block_radix_sort.cuh>
+#include <cub/device/device_segmented_radix_sort.cuh>
 
 #include <Array.hpp>
 #include <Param.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/dispatch.hpp>
+#include <common/half.hpp>
 #include <debug_cuda.hpp>
+#include <err_cuda.hpp>
 #include <math.hpp>
+#include <memory.hpp>
+#include <thrust/sequence.h>
+#include <thrust_utils.hpp>
 #include <types.hpp>
 
+#include <algorithm>
 #include <limits>
+#include <type_traits>
 
 using cub::BlockRadixSort;
 
@@ -149,12 +157,260 @@ void topkDim0(Param<T> ovals, Param<uint> oidxs, CParam<T> ivals, const int k,
     } while (prevBlocksX > 1);
 }
 
+static const int TOPK_MAX_BLOCK_K         = TOPK_THRDS_PER_BLK;
+static const int TOPK_SELECT_THRDS        = 256;
+static const int TOPK_SELECT_BLK_ELEMENTS = 32 * TOPK_SELECT_THRDS;
+static const dim_t TOPK_MAX_BLOCKS        = 65535;
+
+template<int Bytes>
+struct TopkBits;
+template<>
+struct TopkBits<2> {
+    using type = unsigned short;
+};
+template<>
+struct TopkBits<4> {
+    using type = unsigned;
+};
+template<>
+struct TopkBits<8> {
+    using type = uintl;
+};
+
+// The keys are unsigned integers which are ordered like the values for
+// AF_TOPK_MIN and in the reverse order for AF_TOPK_MAX, so the top k values
+// always have the smallest keys
+template<typename T>
+__device__ uintl topkKey(const T* ptr, const dim_t i, const bool isMax) {
+    constexpr int bits = 8 * sizeof(T);
+    constexpr bool isFloat = std::is_floating_point<T>::value ||
+                             std::is_same<T, common::half>::value;
+    constexpr uintl sign = 1ull << (bits - 1);
+    constexpr uintl mask = bits == 64 ? ~0ull : (1ull << (bits % 64)) - 1;
+
+    using Bits     = typename TopkBits<sizeof(T)>::type;
+    const uintl in = reinterpret_cast<const Bits*>(ptr)[i];
+
+    uintl key = in;
+    if (isFloat) {
+        key = (in & sign) ? ~in & mask : in | sign;
+    } else if (std::is_signed<T>::value) {
+        key = in ^ sign;
+    }
+    return isMax ? ~key & mask : key;
+}
+
+static __device__ dim_t topkLineOffset(const dim_t line, const dim_t* dims,
+                                       const dim_t* strides) {
+    const dim_t y = line % dims[1];
+    const dim_t z = (line / dims[1]) % dims[2];
+    const dim_t w = line / (dims[1] * dims[2]);
+    return y * strides[1] + z * strides[2] + w * strides[3];
+}
+
+// Counts the digits at shift of the keys whose higher digits match the
+// prefix of the k-th key of each line
+template<typename T>
+static __global__ void kerTopkHistogram(uint* hist, const uintl* prefix,
+                                        CParam<T> ivals, const dim_t lines,
+                                        const bool isMax, const int shift,
+                                        const uintl highMask) {
+    __shared__ uint s_hist[256];
+
+    const dim_t n = ivals.dims[0];
+    for (dim_t line = blockIdx.y; line < lines; line += gridDim.y) {
+        for (int i = threadIdx.x; i < 256; i += blockDim.x) { s_hist[i] = 0; }
+        __syncthreads();
+
+        const T* iptr =
+            ivals.ptr + topkLineOffset(line, ivals.dims, ivals.strides);
+        const uintl high = prefix[line];
+        for (dim_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n;
+             i += blockDim.x * gridDim.x) {
+            const uintl key = topkKey(iptr, i, isMax);
+            if ((key & highMask) == high) {
+                atomicAdd(s_hist + ((key >> shift) & 0xff), 1u);
+            }
+        }
+        __syncthreads();
+
+        for (int i = threadIdx.x; i < 256; i += blockDim.x) {
+            if (s_hist[i]) { atomicAdd(hist + 256 * line + i, s_hist[i]); }
+        }
+        __syncthreads();
+    }
+}
+
+// Appends the digit of the k-th key of each line to its prefix. The rank is
+// made relative to the keys of the prefix, so after the last pass it is the
+// number of keys equal to the k-th key which are selected, minus one.
+static __global__ void kerTopkSelect(uintl* prefix, uint* ranks,
+                                     const uint* hist, const dim_t lines,
+                                     const int k, const int shift,
+                                     const bool firstPass) {
+    const dim_t line = blockIdx.x * blockDim.x + threadIdx.x;
+    if (line >= lines) { return; }
+
+    uint r           = firstPass ? k - 1 : ranks[line];
+    const uint* hptr = hist + 256 * line;
+    int digit        = 0;
+    for (; digit < 255 && r >= hptr[digit]; ++digit) { r -= hptr[digit]; }
+
+    prefix[line] |= uintl(digit) << shift;
+    ranks[line] = r;
+}
+
+// Gathers the keys smaller than the k-th key of each line and the first
+// keys equal to it, with their indices
+template<typename T>
+static __global__ void kerTopkCompact(uintl* okeys, uint* oidxs, uint* counts,
+                                      const uintl* prefix, const uint* ranks,
+                                      CParam<T> ivals, const dim_t lines,
+                                      const int k, const bool isMax) {
+    const dim_t n = ivals.dims[0];
+    for (dim_t line = blockIdx.y; line < lines; line += gridDim.y) {
+        const T* iptr =
+            ivals.ptr + topkLineOffset(line, ivals.dims, ivals.strides);
+        const uintl kth    = prefix[line];
+        const uint ties    = ranks[line] + 1;
+        const uint slots   = k;
+        const uint smaller = slots - ties;
+        uintl* kptr        = okeys + line * k;
+        uint* iout         = oidxs + line * k;
+
+        for (dim_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n;
+             i += blockDim.x * gridDim.x) {
+            const uintl key = topkKey(iptr, i, isMax);
+            uint pos        = slots;
+            if (key < kth) {
+                pos = atomicAdd(counts + 2 * line, 1u);
+            } else if (key == kth) {
+                const uint tie = atomicAdd(counts + 2 * line + 1, 1u);
+                if (tie < ties) { pos = smaller + tie; }
+            }
+            if (pos < slots) {
+                kptr[pos] = key;
+                iout[pos] = i;
+            }
+        }
+    }
+}
+
+// Writes the sorted indices of each line and their values
+template<typename T>
+static __global__ void kerTopkGather(Param<T> ovals, Param<uint> oidxs,
+                                     const uint* idxs, CParam<T> ivals,
+                                     const dim_t lines, const int k) {
+    const int j = blockIdx.x * blockDim.x + threadIdx.x;
+    if (j >= k) { return; }
+
+    for (dim_t line = blockIdx.y; line < lines; line += gridDim.y) {
+        const uint idx = idxs[line * k + j];
+        const dim_t ioff =
+            topkLineOffset(line, ivals.dims, ivals.strides) + idx;
+        const dim_t ooff =
+            topkLineOffset(line, ovals.dims, ovals.strides) + j;
+        ovals.ptr[ooff] = ivals.ptr[ioff];
+        oidxs.ptr[topkLineOffset(line, oidxs.dims, oidxs.strides) + j] =
+            idx;
+    }
+}
+
+/// Selects the top \p k values of each column without a limit on \p k.
+///
+/// The values are mapped to unsigned keys in which the top values are the
+/// smallest. A most significant digit radix select finds the k-th key of
+/// each column with one histogram pass over the input for each byte of
+/// the keys. The keys before it and enough keys equal to it are gathered
+/// into k slots of each column, which are then sorted by one segmented
+/// radix sort. All the columns are processed by each launch.
+template<typename T>
+void topkSelectDim0(Param<T> ovals, Param<uint> oidxs, CParam<T> ivals,
+                    const int k, const af::topkFunction order) {
+    const bool isMax    = order == AF_TOPK_MAX;
+    const dim_t n       = ivals.dims[0];
+    const dim_t lines   = ivals.dims[1] * ivals.dims[2] * ivals.dims[3];
+    const dim_t entries = lines * k;
+    if (entries > std::numeric_limits<int>::max()) {
+        AF_ERROR("topk supports at most 2^31 - 1 selected values",
+                 AF_ERR_NOT_SUPPORTED);
+    }
+
+    auto hist   = memAlloc<uint>(lines * 256);
+    auto prefix = memAlloc<uintl>(lines);
+    auto ranks  = memAlloc<uint>(lines);
+    CUDA_CHECK(cudaMemsetAsync(prefix.get(), 0, lines * sizeof(uintl),
+                               getActiveStream()));
+
+    const dim3 threads(TOPK_SELECT_THRDS);
+    const dim3 blocks(
+        static_cast<unsigned>(std::min(divup(n, TOPK_SELECT_BLK_ELEMENTS),
+                                       TOPK_MAX_BLOCKS)),
+        static_cast<unsigned>(std::min(lines, TOPK_MAX_BLOCKS)));
+    const dim3 selectBlocks(
+        static_cast<unsigned>(divup(lines, TOPK_SELECT_THRDS)));
+
+    const int passes = sizeof(T);
+    for (int pass = 0; pass < passes; ++pass) {
+        const int shift = (passes - 1 - pass) * 8;
+        const uintl highMask =
+            shift + 8 >= 64 ? 0 : ~((uintl(1) << (shift + 8)) - 1);
+
+        CUDA_CHECK(cudaMemsetAsync(hist.get(), 0, lines * 256 * sizeof(uint),
+                                   getActiveStream()));
+        CUDA_LAUNCH((kerTopkHistogram<T>), blocks, threads, hist.get(),
+                    prefix.get(), ivals, lines, isMax, shift, highMask);
+        POST_LAUNCH_CHECK();
+        CUDA_LAUNCH(kerTopkSelect, selectBlocks, threads, prefix.get(),
+                    ranks.get(), hist.get(), lines, k, shift, pass == 0);
+        POST_LAUNCH_CHECK();
+    }
+
+    auto counts = memAlloc<uint>(2 * lines);
+    auto keys   = memAlloc<uintl>(2 * entries);
+    auto idxs   = memAlloc<uint>(2 * entries);
+    CUDA_CHECK(cudaMemsetAsync(counts.get(), 0, 2 * lines * sizeof(uint),
+                               getActiveStream()));
+    CUDA_LAUNCH((kerTopkCompact<T>), blocks, threads, keys.get(), idxs.get(),
+                counts.get(), prefix.get(), ranks.get(), ivals, lines, k,
+                isMax);
+    POST_LAUNCH_CHECK();
+
+    auto offsets = memAlloc<int>(lines + 1);
+    THRUST_SELECT(thrust::sequence, offsets.get(), offsets.get() + lines + 1,
+                  0, k);
+
+    cub::DoubleBuffer<uintl> sortKeys(keys.get(), keys.get() + entries);
+    cub::DoubleBuffer<uint> sortIdxs(idxs.get(), idxs.get() + entries);
+    size_t tempBytes = 0;
+    CUDA_CHECK(cub::DeviceSegmentedRadixSort::SortPairs(
+        nullptr, tempBytes, sortKeys, sortIdxs, static_cast<int>(entries),
+        static_cast<int>(lines), offsets.get(), offsets.get() + 1, 0,
+        8 * sizeof(T), getActiveStream()));
+    auto temp = memAlloc<char>(tempBytes);
+    CUDA_CHECK(cub::DeviceSegmentedRadixSort::SortPairs(
+        temp.get(), tempBytes, sortKeys, sortIdxs, static_cast<int>(entries),
+        static_cast<int>(lines), offsets.get(), offsets.get() + 1, 0,
+        8 * sizeof(T), getActiveStream()));
+
+    const dim3 gatherBlocks(
+        static_cast<unsigned>(divup(k, TOPK_SELECT_THRDS)),
+        static_cast<unsigned>(std::min(lines, TOPK_MAX_BLOCKS)));
+    CUDA_LAUNCH((kerTopkGather<T>), gatherBlocks, threads, ovals, oidxs,
+                sortIdxs.Current(), ivals, lines, k);
+    POST_LAUNCH_CHECK();
+}
+
 template<typename T>
 inline void topk(Param<T> ovals, Param<uint> oidxs, CParam<T> ivals,
                  const int k, const int dim, const af::topkFunction order) {
     assert(dim == 0);
     // TODO Add switch statement when support for other dims is added
-    topkDim0<T>(ovals, oidxs, ivals, k, order);
+    if (k <= TOPK_MAX_BLOCK_K) {
+        topkDim0<T>(ovals, oidxs, ivals, k, order);
+    } else {
+        topkSelectDim0<T>(ovals, oidxs, ivals, k, order);
+    }
 }
 }  // namespace kernel
 }  // namespace cuda
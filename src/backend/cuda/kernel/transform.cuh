@@ -55,14 +55,17 @@ void calc_transf_inverse(T *txo, const T *txi, const bool perspective) {
     }
 }
 
-template<typename T, bool inverse, int order>
+// When UseTexture is true, the input is sampled from the texture tex (see
+// Texture2D.hpp) instead of global memory
+template<typename T, bool inverse, int order, bool UseTexture>
 __global__
 void transform(Param<T> out, CParam<T> in,
                const int nImg2, const int nImg3,
                const int nTfs2, const int nTfs3,
                const int batchImg2,
                const int blocksXPerImage, const int blocksYPerImage,
-               const bool perspective, af::interpType method) {
+               const bool perspective, af::interpType method,
+               unsigned long long tex) {
     // Image Ids
     const int imgId2 = blockIdx.x / blocksXPerImage;
     const int imgId3 = blockIdx.y / blocksYPerImage;
@@ -164,6 +167,15 @@ void transform(Param<T> out, CParam<T> in,
         return;
     }
 
+    if (UseTexture) {
+        // The images are packed, so the offset of an image is a whole
+        // number of rows
+        TexInterp2<T, order> interp;
+        interp(out, loco, tex, inoff / in.strides[1], in.dims[0], in.dims[1],
+               xidi, yidi, method, limages);
+        return;
+    }
+
     Interp2<T, WT, 0, 1, order> interp;
     // FIXME: Nearest and lower do not do clamping, but other methods do
     // Make it consistent
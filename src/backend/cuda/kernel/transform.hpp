@@ -10,6 +10,7 @@
 #pragma once
 
 #include <Param.hpp>
+#include <Texture2D.hpp>
 #include <common/dispatch.hpp>
 #include <common/kernel_cache.hpp>
 #include <debug_cuda.hpp>
@@ -33,9 +34,13 @@ void transform(Param<T> out, CParam<T> in, CParam<float> tf, const bool inverse,
                const bool perspective, const af::interpType method, int order) {
     static const std::string src(transform_cuh, transform_cuh_len);
 
+    auto texture          = interpTexture<T>(in, method, order);
+    const bool useTexture = texture != nullptr;
+
     auto transform = common::getKernel(
         "cuda::transform", {src},
-        {TemplateTypename<T>(), TemplateArg(inverse), TemplateArg(order)});
+        {TemplateTypename<T>(), TemplateArg(inverse), TemplateArg(order),
+         TemplateArg(useTexture)});
 
     const unsigned int nImg2  = in.dims[2];
     const unsigned int nImg3  = in.dims[3];
@@ -69,7 +74,8 @@ void transform(Param<T> out, CParam<T> in, CParam<float> tf, const bool inverse,
     EnqueueArgs qArgs(blocks, threads, getActiveStream());
 
     transform(qArgs, out, in, nImg2, nImg3, nTfs2, nTfs3, batchImg2,
-              blocksXPerImage, blocksYPerImage, perspective, method);
+              blocksXPerImage, blocksYPerImage, perspective, method,
+              static_cast<unsigned long long>(useTexture ? texture->get() : 0));
 
     POST_LAUNCH_CHECK();
 }
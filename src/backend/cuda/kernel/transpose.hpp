@@ -10,6 +10,7 @@
 #pragma once
 
 #include <Param.hpp>
+#include <common/LaunchTuning.hpp>
 #include <common/dispatch.hpp>
 #include <common/kernel_cache.hpp>
 #include <debug_cuda.hpp>
@@ -24,19 +25,14 @@ static const int TILE_DIM  = 32;
 static const int THREADS_X = TILE_DIM;
 static const int THREADS_Y = 256 / TILE_DIM;
 
+// The heights of the blocks tried by the launch autotuner
+static const int TUNED_THREADS_Y[] = {4, 8, 16, 32};
+
 template<typename T>
 void transpose(Param<T> out, CParam<T> in, const bool conjugate,
                const bool is32multiple) {
     static const std::string source(transpose_cuh, transpose_cuh_len);
 
-    auto transpose =
-        common::getKernel("cuda::transpose", {source},
-                          {TemplateTypename<T>(), TemplateArg(conjugate),
-                           TemplateArg(is32multiple)},
-                          {DefineValue(TILE_DIM), DefineValue(THREADS_Y)});
-
-    dim3 threads(kernel::THREADS_X, kernel::THREADS_Y);
-
     int blk_x = divup(in.dims[0], TILE_DIM);
     int blk_y = divup(in.dims[1], TILE_DIM);
     dim3 blocks(blk_x * in.dims[2], blk_y * in.dims[3]);
@@ -45,9 +41,27 @@ void transpose(Param<T> out, CParam<T> in, const bool conjugate,
     blocks.z = divup(blocks.y, maxBlocksY);
     blocks.y = divup(blocks.y, blocks.z);
 
-    EnqueueArgs qArgs(blocks, threads, getActiveStream());
+    auto launch = [&](int config) {
+        const int threadsY = TUNED_THREADS_Y[config];
+        auto transpose     = common::getKernel(
+            "cuda::transpose", {source},
+            {TemplateTypename<T>(), TemplateArg(conjugate),
+             TemplateArg(is32multiple)},
+            {DefineValue(TILE_DIM), DefineKeyValue(THREADS_Y, threadsY)});
+
+        dim3 threads(kernel::THREADS_X, threadsY);
+        EnqueueArgs qArgs(blocks, threads, getActiveStream());
+        transpose(qArgs, out, in, blk_x, blk_y);
+    };
 
-    transpose(qArgs, out, in, blk_x, blk_y);
+    // transpose only writes the output, so it can be launched again while
+    // the configurations are tuned
+    const std::string name =
+        "transpose:" + TemplateArg(TemplateTypename<T>())._tparam;
+    const int config = common::tuneLaunch(
+        name, in.dims[0] * in.dims[1] * in.dims[2] * in.dims[3],
+        sizeof(TUNED_THREADS_Y) / sizeof(TUNED_THREADS_Y[0]), 1, launch);
+    launch(config);
 
     POST_LAUNCH_CHECK();
 }
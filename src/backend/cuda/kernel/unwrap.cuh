@@ -10,6 +10,7 @@
 #pragma once
 
 #include <Param.hpp>
+#include <common/Binary.hpp>
 #include <math.hpp>
 
 namespace cuda {
@@ -78,4 +79,39 @@ __global__ void unwrap(Param<T> out, CParam<T> in, const int wx, const int wy,
     }
 }
 
+// Every thread reduces one window of the unwrap output columns, the padding
+// is reduced once as a zero
+template<typename T, af_op_t op>
+__global__ void unwrapReduce(Param<T> out, CParam<T> in, const int wx,
+                             const int wy, const int sx, const int sy,
+                             const int px, const int py, const int nBBS0,
+                             const int nBBS1) {
+    const int z    = blockIdx.x / nBBS0;
+    const int w    = blockIdx.y / nBBS1;
+    const int winx = blockDim.x * (blockIdx.x - z * nBBS0) + threadIdx.x;
+    const int winy = blockDim.y * (blockIdx.y - w * nBBS1) + threadIdx.y;
+
+    if (winx >= out.dims[0] || winy >= out.dims[1]) return;
+
+    const T *iptr = in.ptr + w * in.strides[3] + z * in.strides[2];
+
+    const int spx = winx * sx - px;
+    const int spy = winy * sy - py;
+    const int x0  = max(spx, 0);
+    const int x1  = min(spx + wx, in.dims[0]);
+    const int y0  = max(spy, 0);
+    const int y1  = min(spy + wy, in.dims[1]);
+
+    common::Binary<T, op> reduce;
+    T acc = common::Binary<T, op>::init();
+    for (int y = y0; y < y1; ++y) {
+        const T *irow = iptr + y * in.strides[1];
+        for (int x = x0; x < x1; ++x) { acc = reduce(acc, irow[x]); }
+    }
+    if ((x1 - x0) * (y1 - y0) < wx * wy) { acc = reduce(acc, scalar<T>(0)); }
+
+    out.ptr[w * out.strides[3] + z * out.strides[2] + winy * out.strides[1] +
+            winx] = acc;
+}
+
 }  // namespace cuda
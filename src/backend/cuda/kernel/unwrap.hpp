@@ -59,5 +59,25 @@ void unwrap(Param<T> out, CParam<T> in, const int wx, const int wy,
     POST_LAUNCH_CHECK();
 }
 
+template<af_op_t op, typename T>
+void unwrapReduce(Param<T> out, CParam<T> in, const int wx, const int wy,
+                  const int sx, const int sy, const int px, const int py) {
+    static const std::string source(unwrap_cuh, unwrap_cuh_len);
+
+    auto unwrapReduce =
+        common::getKernel("cuda::unwrapReduce", {source},
+                          {TemplateTypename<T>(), TemplateArg(op)});
+
+    dim3 threads(THREADS_X, THREADS_Y);
+    const int blk_x = divup(out.dims[0], threads.x);
+    const int blk_y = divup(out.dims[1], threads.y);
+    dim3 blocks(blk_x * out.dims[2], blk_y * out.dims[3]);
+
+    EnqueueArgs qArgs(blocks, threads, getActiveStream());
+
+    unwrapReduce(qArgs, out, in, wx, wy, sx, sy, px, py, blk_x, blk_y);
+    POST_LAUNCH_CHECK();
+}
+
 }  // namespace kernel
 }  // namespace cuda
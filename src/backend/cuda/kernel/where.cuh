@@ -56,4 +56,45 @@ void where(uint *optr, CParam<uint> otmp, CParam<uint> rtmp, CParam<T> in,
     }
 }
 
+// Copies the values of in where mask is nonzero to optr, at the positions of
+// their indices in the output of where
+template<typename T>
+__global__ void compact(T *optr, CParam<uint> otmp, CParam<uint> rtmp,
+                        CParam<char> mask, CParam<T> in, uint blocks_x,
+                        uint blocks_y, uint lim) {
+    const uint tidx = threadIdx.x;
+    const uint tidy = threadIdx.y;
+
+    const uint zid        = blockIdx.x / blocks_x;
+    const uint wid        = (blockIdx.y + blockIdx.z * gridDim.y) / blocks_y;
+    const uint blockIdx_x = blockIdx.x - (blocks_x)*zid;
+    const uint blockIdx_y =
+        (blockIdx.y + blockIdx.z * gridDim.y) - (blocks_y)*wid;
+    const uint xid = blockIdx_x * blockDim.x * lim + tidx;
+    const uint yid = blockIdx_y * blockDim.y + tidy;
+
+    const uint bid = wid * rtmp.strides[3] + zid * rtmp.strides[2] +
+                     yid * rtmp.strides[1] + blockIdx_x;
+
+    const uint *otptr = otmp.ptr + wid * otmp.strides[3] +
+                        zid * otmp.strides[2] + yid * otmp.strides[1];
+    const char *mptr = mask.ptr + wid * mask.strides[3] +
+                       zid * mask.strides[2] + yid * mask.strides[1];
+    const T *iptr = in.ptr + wid * in.strides[3] + zid * in.strides[2] +
+                    yid * in.strides[1];
+
+    bool cond =
+        (yid < otmp.dims[1]) && (zid < otmp.dims[2]) && (wid < otmp.dims[3]);
+    if (!cond) return;
+
+    uint accum = (bid == 0) ? 0 : rtmp.ptr[bid - 1];
+
+    for (uint k = 0, id = xid; k < lim && id < otmp.dims[0];
+         k++, id += blockDim.x) {
+        if (mptr[id] != 0) {
+            optr[otptr[id] + accum - 1] = iptr[id * in.strides[0]];
+        }
+    }
+}
+
 }
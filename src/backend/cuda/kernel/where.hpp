@@ -21,11 +21,25 @@
 namespace cuda {
 namespace kernel {
 
+/// The scan of the nonzero values of an array, shared by where and compact
+struct WhereScan {
+    Param<uint> otmp;  ///< The running count of each block along dim 0
+    Param<uint> rtmp;  ///< The running count of the blocks of all the lines
+    uptr<uint> otmpAlloc;
+    uptr<uint> rtmpAlloc;
+    uint threads_x;
+    uint blocks_x;
+    uint blocks_y;
+    uint total;  ///< The number of nonzero values, read back to the host
+};
+
+/// Counts the nonzero values of \p in within each block along dim 0, then
+/// scans the counts of the blocks of all the lines
 template<typename T>
-static void where(Param<uint> &out, CParam<T> in) {
-    static const std::string src(where_cuh, where_cuh_len);
-    auto where =
-        common::getKernel("cuda::where", {src}, {TemplateTypename<T>()});
+static WhereScan whereScan(CParam<T> in) {
+    WhereScan scan;
+    Param<uint> &rtmp = scan.rtmp;
+    Param<uint> &otmp = scan.otmp;
 
     uint threads_x = nextpow2(std::max(32u, (uint)in.dims[0]));
     threads_x      = std::min(threads_x, THREADS_PER_BLOCK);
@@ -34,8 +48,6 @@ static void where(Param<uint> &out, CParam<T> in) {
     uint blocks_x = divup(in.dims[0], threads_x * REPEAT);
     uint blocks_y = divup(in.dims[1], threads_y);
 
-    Param<uint> rtmp;
-    Param<uint> otmp;
     rtmp.dims[0]    = blocks_x;
     otmp.dims[0]    = in.dims[0];
     rtmp.strides[0] = 1;
@@ -51,10 +63,10 @@ static void where(Param<uint> &out, CParam<T> in) {
 
     int rtmp_elements = rtmp.strides[3] * rtmp.dims[3];
     int otmp_elements = otmp.strides[3] * otmp.dims[3];
-    auto rtmp_alloc   = memAlloc<uint>(rtmp_elements);
-    auto otmp_alloc   = memAlloc<uint>(otmp_elements);
-    rtmp.ptr          = rtmp_alloc.get();
-    otmp.ptr          = otmp_alloc.get();
+    scan.rtmpAlloc    = memAlloc<uint>(rtmp_elements);
+    scan.otmpAlloc    = memAlloc<uint>(otmp_elements);
+    rtmp.ptr          = scan.rtmpAlloc.get();
+    otmp.ptr          = scan.otmpAlloc.get();
 
     scan_first_launcher<T, uint, af_notzero_t>(
         otmp, rtmp, in, blocks_x, blocks_y, threads_x, false, true);
@@ -69,14 +81,35 @@ static void where(Param<uint> &out, CParam<T> in) {
 
     scan_first<uint, uint, af_add_t>(ltmp, ltmp, true);
 
-    // Get output size and allocate output
-    uint total;
-    CUDA_CHECK(cudaMemcpyAsync(&total, rtmp.ptr + rtmp_elements - 1,
+    // Get output size
+    CUDA_CHECK(cudaMemcpyAsync(&scan.total, rtmp.ptr + rtmp_elements - 1,
                                sizeof(uint), cudaMemcpyDeviceToHost,
                                cuda::getActiveStream()));
     CUDA_CHECK(cudaStreamSynchronize(cuda::getActiveStream()));
 
-    auto out_alloc = memAlloc<uint>(total);
+    scan.threads_x = threads_x;
+    scan.blocks_x  = blocks_x;
+    scan.blocks_y  = blocks_y;
+    return scan;
+}
+
+/// The launch configuration of the kernels which write the outputs of \p scan
+static EnqueueArgs whereArgs(const WhereScan &scan, const dim_t *dims) {
+    dim3 threads(scan.threads_x, THREADS_PER_BLOCK / scan.threads_x);
+    dim3 blocks(scan.blocks_x * dims[2], scan.blocks_y * dims[3]);
+
+    const int maxBlocksY =
+        cuda::getDeviceProp(cuda::getActiveDeviceId()).maxGridSize[1];
+    blocks.z = divup(blocks.y, maxBlocksY);
+    blocks.y = divup(blocks.y, blocks.z);
+
+    return EnqueueArgs(blocks, threads, getActiveStream());
+}
+
+/// Allocates the vector \p out of \p total elements
+template<typename T>
+static uptr<T> whereOutput(Param<T> &out, const uint total) {
+    auto out_alloc = memAlloc<T>(total);
     out.ptr        = out_alloc.get();
 
     out.dims[0]    = total;
@@ -85,23 +118,49 @@ static void where(Param<uint> &out, CParam<T> in) {
         out.dims[k]    = 1;
         out.strides[k] = total;
     }
+    return out_alloc;
+}
 
-    dim3 threads(threads_x, THREADS_PER_BLOCK / threads_x);
-    dim3 blocks(blocks_x * in.dims[2], blocks_y * in.dims[3]);
+template<typename T>
+static void where(Param<uint> &out, CParam<T> in) {
+    static const std::string src(where_cuh, where_cuh_len);
+    auto where =
+        common::getKernel("cuda::where", {src}, {TemplateTypename<T>()});
 
-    uint lim = divup(otmp.dims[0], (threads_x * blocks_x));
+    WhereScan scan = whereScan<T>(in);
+    auto out_alloc = whereOutput<uint>(out, scan.total);
 
-    const int maxBlocksY =
-        cuda::getDeviceProp(cuda::getActiveDeviceId()).maxGridSize[1];
-    blocks.z = divup(blocks.y, maxBlocksY);
-    blocks.y = divup(blocks.y, blocks.z);
+    uint lim = divup(scan.otmp.dims[0], (scan.threads_x * scan.blocks_x));
 
-    EnqueueArgs qArgs(blocks, threads, getActiveStream());
-    where(qArgs, out.ptr, otmp, rtmp, in, blocks_x, blocks_y, lim);
+    where(whereArgs(scan, in.dims), out.ptr, scan.otmp, scan.rtmp, in,
+          scan.blocks_x, scan.blocks_y, lim);
     POST_LAUNCH_CHECK();
 
     out_alloc.release();
 }
 
+/// Copies the values of \p in where \p mask is nonzero to the vector \p out.
+/// The positions of the values are scanned like in where, and the values are
+/// gathered by the kernel which would write their indices.
+template<typename T>
+static void compact(Param<T> &out, CParam<T> in, CParam<char> mask) {
+    static const std::string src(where_cuh, where_cuh_len);
+    auto compact =
+        common::getKernel("cuda::compact", {src}, {TemplateTypename<T>()});
+
+    WhereScan scan = whereScan<char>(mask);
+    auto out_alloc = whereOutput<T>(out, scan.total);
+
+    if (scan.total > 0) {
+        uint lim = divup(scan.otmp.dims[0], (scan.threads_x * scan.blocks_x));
+
+        compact(whereArgs(scan, mask.dims), out.ptr, scan.otmp, scan.rtmp,
+                mask, in, scan.blocks_x, scan.blocks_y, lim);
+        POST_LAUNCH_CHECK();
+    }
+
+    out_alloc.release();
+}
+
 }  // namespace kernel
 }  // namespace cuda
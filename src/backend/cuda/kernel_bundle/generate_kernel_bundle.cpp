@@ -0,0 +1,242 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+/// Generates the bundle of precompiled CUDA kernels which is installed with
+/// the CUDA backend.
+///
+/// The CUDA kernels are compiled by NVRTC the first time they are launched
+/// with a given set of template arguments. This program launches the kernels
+/// in the requested groups for each of the requested types while the kernel
+/// cache directory points to a staging directory. The binaries of the
+/// templated kernels are then copied from the staging directory to the bundle
+/// directory. The binaries of the JIT kernels are left out because they
+/// depend on the expressions of the application.
+///
+/// Usage: generate_kernel_bundle <bundle dir> <staging dir> <types> <groups>
+///
+/// <types> and <groups> are comma separated lists. "all" selects every
+/// group.
+
+#include <arrayfire.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using af::array;
+using af::dim4;
+using std::function;
+using std::map;
+using std::string;
+using std::vector;
+
+namespace {
+
+vector<string> split(const string &list) {
+    vector<string> items;
+    std::istringstream in(list);
+    string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty()) { items.push_back(item); }
+    }
+    return items;
+}
+
+const map<string, af::dtype> &types() {
+    static const map<string, af::dtype> names = {
+        {"f32", f32}, {"c32", c32}, {"f64", f64}, {"c64", c64},
+        {"b8", b8},   {"s32", s32}, {"u32", u32}, {"u8", u8},
+        {"s64", s64}, {"u64", u64}, {"s16", s16}, {"u16", u16},
+        {"f16", f16}};
+    return names;
+}
+
+bool isReal(af::dtype type) { return type != c32 && type != c64; }
+
+bool isFloating(af::dtype type) {
+    return type == f32 || type == f64 || type == f16;
+}
+
+/// The kernels launched for each group. Each function launches the kernels
+/// of its group for a single type.
+const map<string, function<void(af::dtype)>> &groups() {
+    static const map<string, function<void(af::dtype)>> launchers = {
+        {"copy",
+         [](af::dtype type) {
+             array in = af::constant(1, 33, 17, 3, type);
+             af::eval(in(af::seq(1, 20), af::seq(2, 10)).copy());
+             af::eval(af::join(0, in, in), af::join(1, in, in));
+             af::eval(af::tile(in, 2, 2), af::reorder(in, 1, 0, 2));
+             af::eval(af::flip(in, 0), af::shift(in, 3, 1));
+         }},
+        {"create",
+         [](af::dtype type) {
+             af::eval(af::identity(33, 17, type),
+                      af::range(dim4(33, 17), 0, type));
+             af::eval(af::iota(dim4(33, 17), dim4(1), type));
+             array in = af::constant(1, 33, type);
+             af::eval(af::diag(in), af::diag(af::diag(in)));
+         }},
+        {"index",
+         [](af::dtype type) {
+             array in  = af::constant(1, 33, 17, type);
+             array idx = af::range(dim4(10), 0, u32);
+             array sub = in(idx, af::span);
+             af::eval(sub, af::lookup(in, idx, 1));
+             in(idx, af::span) = af::constant(2, 10, 17, type);
+             af::eval(in);
+         }},
+        {"transpose",
+         [](af::dtype type) {
+             af::eval(af::transpose(af::constant(1, 33, 17, type)));
+             af::eval(af::transpose(af::constant(1, 64, 32, type)));
+             array square = af::constant(1, 33, 33, type);
+             af::transposeInPlace(square);
+             af::eval(square);
+         }},
+        {"scan",
+         [](af::dtype type) {
+             if (type == f16) { return; }
+             array in = af::constant(1, 33, 17, type);
+             af::eval(af::accum(in, 0), af::accum(in, 1));
+             af::eval(af::where(in));
+         }},
+        {"reduce",
+         [](af::dtype type) {
+             if (type == f16) { return; }
+             array in = af::constant(1, 33, 17, type);
+             array val, idx;
+             af::min(val, idx, in, 0);
+             af::eval(val, idx);
+             af::max(val, idx, in, 1);
+             af::eval(val, idx);
+         }},
+        {"diff",
+         [](af::dtype type) {
+             if (type == f16) { return; }
+             array in = af::constant(1, 33, 17, type);
+             af::eval(af::diff1(in, 0), af::diff2(in, 1));
+         }},
+        {"triangle",
+         [](af::dtype type) {
+             array in = af::constant(1, 33, 17, type);
+             af::eval(af::lower(in), af::upper(in, true));
+             array cond = af::constant(1, 33, 17, b8);
+             af::eval(af::select(cond, in, in));
+         }},
+        {"image",
+         [](af::dtype type) {
+             if (!isFloating(type) || type == f16) { return; }
+             array in = af::constant(1, 33, 17, type);
+             af::eval(af::resize(in, 66, 34), af::rotate(in, 0.5f));
+             af::eval(af::convolve(in, af::constant(1, 3, 3, type)));
+         }},
+        {"complex",
+         [](af::dtype type) {
+             if (isReal(type)) { return; }
+             array in = af::constant(1, 33, 17, type);
+             af::eval(af::transpose(in, true));
+         }},
+    };
+    return launchers;
+}
+
+/// Copies the binaries of the templated kernels listed in the kernel cache
+/// index of \p staging to \p bundle. Returns the number of binaries copied.
+int copyBinaries(const string &staging, const string &bundle) {
+    std::ifstream index(staging + "/kernel_cache.index");
+    if (!index) { return 0; }
+
+    int count = 0;
+    string line;
+    std::getline(index, line);  // header
+    while (std::getline(index, line)) {
+        // key, bytes, checksum, isJIT, last use, filename
+        vector<string> fields;
+        std::istringstream in(line);
+        string field;
+        while (std::getline(in, field, '\t')) { fields.push_back(field); }
+        if (fields.size() != 6 || fields[3] != "0") { continue; }
+
+        std::ifstream src(staging + "/" + fields[5], std::ios::binary);
+        std::ofstream dst(bundle + "/" + fields[5], std::ios::binary);
+        if (!src || !dst) { continue; }
+        dst << src.rdbuf();
+        count++;
+    }
+    return count;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    if (argc != 5) {
+        fprintf(stderr,
+                "Usage: %s <bundle dir> <staging dir> <types> <groups>\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    const string bundle  = argv[1];
+    const string staging = argv[2];
+
+    vector<string> groupNames = split(argv[4]);
+    if (groupNames.size() == 1 && groupNames[0] == "all") {
+        groupNames.clear();
+        for (const auto &group : groups()) {
+            groupNames.push_back(group.first);
+        }
+    }
+
+    try {
+        af::setBackend(AF_BACKEND_CUDA);
+        af::info();
+        for (const string &typeName : split(argv[3])) {
+            auto type = types().find(typeName);
+            if (type == types().end()) {
+                fprintf(stderr, "Unknown type: %s\n", typeName.c_str());
+                return EXIT_FAILURE;
+            }
+            if (type->second == f64 || type->second == c64) {
+                if (!af::isDoubleAvailable(af::getDevice())) { continue; }
+            }
+            if (type->second == f16 &&
+                !af::isHalfAvailable(af::getDevice())) {
+                continue;
+            }
+            for (const string &groupName : groupNames) {
+                auto group = groups().find(groupName);
+                if (group == groups().end()) {
+                    fprintf(stderr, "Unknown kernel group: %s\n",
+                            groupName.c_str());
+                    return EXIT_FAILURE;
+                }
+                // Types which a kernel does not support are skipped
+                try {
+                    group->second(type->second);
+                } catch (const af::exception &e) {
+                    fprintf(stderr, "Skipped %s for %s: %s\n",
+                            groupName.c_str(), typeName.c_str(), e.what());
+                }
+            }
+        }
+        af::sync();
+    } catch (const af::exception &e) {
+        fprintf(stderr, "%s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    printf("Bundled %d CUDA kernels in %s\n", copyBinaries(staging, bundle),
+           bundle.c_str());
+    return EXIT_SUCCESS;
+}
@@ -11,12 +11,27 @@
 
 #include <Array.hpp>
 #include <common/half.hpp>
+#include <common/jit/GatherNodeBase.hpp>
+#include <copy.hpp>
 #include <err_cuda.hpp>
+#include <jit/BufferNode.hpp>
 #include <kernel/lookup.hpp>
 
+#include <memory>
+#include <type_traits>
+
+using common::GatherNodeBase;
 using common::half;
+using common::Node_ptr;
+using cuda::jit::BufferNode;
+using std::is_same;
+using std::make_shared;
+using std::static_pointer_cast;
 
 namespace cuda {
+template<typename T>
+using GatherNode = GatherNodeBase<BufferNode<T>>;
+
 template<typename in_t, typename idx_t>
 Array<in_t> lookup(const Array<in_t> &input, const Array<idx_t> &indices,
                    const unsigned dim) {
@@ -27,6 +42,27 @@ Array<in_t> lookup(const Array<in_t> &input, const Array<idx_t> &indices,
         oDims[d] = (d == dim ? indices.elements() : iDims[d]);
     }
 
+    // The lookup is read through a node of the JIT tree, so it is fused into
+    // the expression which uses it. The conversion of half indices to int is
+    // ambiguous in the generated code, they are gathered by the kernel.
+    if (!is_same<idx_t, half>::value) {
+        input.eval();
+        indices.eval();
+
+        // The indices are laid along dim so they are broadcast along the
+        // other dimensions of the output
+        Array<idx_t> idx = indices.isLinear() ? indices : copyArray(indices);
+        dim4 idxDims(1);
+        idxDims[dim] = indices.elements();
+        idx.setDataDims(idxDims);
+
+        auto node = make_shared<GatherNode<in_t>>(
+            static_cast<af::dtype>(af::dtype_traits<in_t>::af_type),
+            static_pointer_cast<BufferNode<in_t>>(input.getNode()),
+            idx.getNode(), dim);
+        return createNodeArray<in_t>(oDims, Node_ptr(node));
+    }
+
     Array<in_t> out = createEmptyArray<in_t>(oDims);
 
     dim_t nDims = iDims.ndims();
@@ -11,8 +11,10 @@
 
 #include <common/err_common.hpp>
 #include <copy.hpp>
+#include <cublas.hpp>
 #include <cusolverDn.hpp>
 #include <kernel/lu_split.hpp>
+#include <matrix_pointers.hpp>
 #include <memory.hpp>
 #include <platform.hpp>
 
@@ -74,21 +76,60 @@ LU_FUNC(getrf, double, D)
 LU_FUNC(getrf, cfloat, C)
 LU_FUNC(getrf, cdouble, Z)
 
-void convertPivot(Array<int> &pivot, int out_sz) {
-    dim_t d0 = pivot.dims()[0];
+// cublasStatus_t cublas<>getrfBatched(
+//        cublasHandle_t handle,
+//        int n,
+//        <> *const Aarray[],
+//        int lda,
+//        int *PivotArray,
+//        int *infoArray,
+//        int batchSize);
+
+template<typename T>
+struct getrfBatched_func_def_t {
+    using getrfBatched_func_def = cublasStatus_t (*)(cublasHandle_t, int,
+                                                     T *const *, int, int *,
+                                                     int *, int);
+};
 
-    std::vector<int> d_po(out_sz);
-    for (int i = 0; i < out_sz; i++) { d_po[i] = i; }
+#define LU_BATCHED_FUNC_DEF(FUNC) \
+    template<typename T>          \
+    typename FUNC##_func_def_t<T>::FUNC##_func_def FUNC##_func();
 
-    std::vector<int> d_pi(d0);
+#define LU_BATCHED_FUNC(FUNC, TYPE, PREFIX)                                 \
+    template<>                                                              \
+    typename FUNC##_func_def_t<TYPE>::FUNC##_func_def FUNC##_func<TYPE>() { \
+        return (FUNC##_func_def_t<TYPE>::FUNC##_func_def) &                 \
+               cublas##PREFIX##FUNC;                                        \
+    }
+
+LU_BATCHED_FUNC_DEF(getrfBatched)
+LU_BATCHED_FUNC(getrfBatched, float, S)
+LU_BATCHED_FUNC(getrfBatched, double, D)
+LU_BATCHED_FUNC(getrfBatched, cfloat, C)
+LU_BATCHED_FUNC(getrfBatched, cdouble, Z)
+
+void convertPivot(Array<int> &pivot, int out_sz) {
+    dim4 pDims  = pivot.dims();
+    dim_t d0    = pDims[0];
+    dim_t batch = pDims[2] * pDims[3];
+
+    std::vector<int> d_po(out_sz * batch);
+    std::vector<int> d_pi(d0 * batch);
     copyData(&d_pi[0], pivot);
 
-    for (int j = 0; j < d0; j++) {
-        // 1 indexed in pivot
-        std::swap(d_po[j], d_po[d_pi[j] - 1]);
+    for (dim_t b = 0; b < batch; b++) {
+        int *po       = &d_po[b * out_sz];
+        const int *pi = &d_pi[b * d0];
+        for (int i = 0; i < out_sz; i++) { po[i] = i; }
+        for (int j = 0; j < d0; j++) {
+            // 1 indexed in pivot
+            std::swap(po[j], po[pi[j] - 1]);
+        }
     }
 
-    pivot = createHostDataArray<int>(out_sz, &d_po[0]);
+    pivot = createHostDataArray<int>(dim4(out_sz, 1, pDims[2], pDims[3]),
+                                     &d_po[0]);
 }
 
 template<typename T>
@@ -102,8 +143,8 @@ void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot,
     pivot            = lu_inplace(in_copy);
 
     // SPLIT into lower and upper
-    dim4 ldims(M, std::min(M, N));
-    dim4 udims(std::min(M, N), N);
+    dim4 ldims(M, std::min(M, N), iDims[2], iDims[3]);
+    dim4 udims(std::min(M, N), N, iDims[2], iDims[3]);
     lower = createEmptyArray<T>(ldims);
     upper = createEmptyArray<T>(udims);
     kernel::lu_split<T>(lower, upper, in_copy);
@@ -114,8 +155,23 @@ Array<int> lu_inplace(Array<T> &in, const bool convert_pivot) {
     dim4 iDims = in.dims();
     int M      = iDims[0];
     int N      = iDims[1];
-
-    Array<int> pivot = createEmptyArray<int>(af::dim4(std::min(M, N), 1, 1, 1));
+    int batch  = iDims[2] * iDims[3];
+
+    Array<int> pivot = createEmptyArray<int>(
+        af::dim4(std::min(M, N), 1, iDims[2], iDims[3]));
+
+    if (batch > 1) {
+        // Batches only have square matrices, which cuBLAS factorizes
+        // together
+        auto ptrs = matrixPointers(in);
+        auto info = memAlloc<int>(batch);
+        CUBLAS_CHECK(getrfBatched_func<T>()(blasHandle(), N, (T **)ptrs.get(),
+                                            in.strides()[1], pivot.get(),
+                                            info.get(), batch));
+
+        if (convert_pivot) { convertPivot(pivot, M); }
+        return pivot;
+    }
 
     int lwork = 0;
 
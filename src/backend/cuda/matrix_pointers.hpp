@@ -0,0 +1,46 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Array.hpp>
+#include <err_cuda.hpp>
+#include <memory.hpp>
+#include <platform.hpp>
+
+#include <vector>
+
+namespace cuda {
+
+/// Returns the device array of the pointers to the 2D matrices of \p in,
+/// which is the argument of the batched cuBLAS and cuSOLVER routines. The
+/// matrices are ordered by the third and then the fourth dimension.
+template<typename T>
+uptr<uchar> matrixPointers(const Array<T> &in) {
+    const dim4 dims    = in.dims();
+    const dim4 strides = in.strides();
+
+    T *ptr = const_cast<T *>(in.get());
+    std::vector<T *> ptrs(dims[2] * dims[3]);
+    for (dim_t w = 0; w < dims[3]; w++) {
+        for (dim_t z = 0; z < dims[2]; z++) {
+            ptrs[w * dims[2] + z] = ptr + z * strides[2] + w * strides[3];
+        }
+    }
+
+    size_t bytes = ptrs.size() * sizeof(T *);
+    auto d_ptrs  = memAlloc<uchar>(bytes);
+    CUDA_CHECK(cudaMemcpyAsync(d_ptrs.get(), ptrs.data(), bytes,
+                               cudaMemcpyHostToDevice, getActiveStream()));
+    // The host pointers are freed when this function returns
+    CUDA_CHECK(cudaStreamSynchronize(getActiveStream()));
+    return d_ptrs;
+}
+
+}  // namespace cuda
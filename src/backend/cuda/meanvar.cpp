@@ -0,0 +1,49 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <meanvar.hpp>
+
+#include <Array.hpp>
+#include <err_cuda.hpp>
+#include <kernel/meanvar.hpp>
+#include <types.hpp>
+#include <af/dim4.hpp>
+
+using af::dim4;
+
+namespace cuda {
+template<typename Ti, typename To>
+void meanvar(Array<To> &mean, Array<To> &var, const Array<Ti> &in,
+             const Array<To> &weights, const af_var_bias bias, const int dim) {
+    dim4 odims = in.dims();
+    odims[dim] = 1;
+
+    Array<To> meanOut = createEmptyArray<To>(odims);
+    Array<To> varOut  = createEmptyArray<To>(odims);
+    kernel::meanvar<Ti, To>(meanOut, varOut, in, weights, bias, dim);
+    mean = meanOut;
+    var  = varOut;
+}
+
+#define INSTANTIATE(Ti, To)                                                    \
+    template void meanvar<Ti, To>(Array<To> &, Array<To> &, const Array<Ti> &, \
+                                  const Array<To> &, const af_var_bias,        \
+                                  const int);
+
+INSTANTIATE(float, float)
+INSTANTIATE(double, double)
+INSTANTIATE(int, float)
+INSTANTIATE(uint, float)
+INSTANTIATE(short, float)
+INSTANTIATE(ushort, float)
+INSTANTIATE(intl, double)
+INSTANTIATE(uintl, double)
+INSTANTIATE(uchar, float)
+INSTANTIATE(char, float)
+}  // namespace cuda
@@ -9,9 +9,13 @@
 
 #include <memory.hpp>
 
+#include <AsyncMemoryManager.hpp>
 #include <Event.hpp>
+#include <common/GraphCapture.hpp>
 #include <common/Logger.hpp>
 #include <common/MemoryManagerBase.hpp>
+#include <common/RegisteredHostMemory.hpp>
+#include <common/bfloat16.hpp>
 #include <common/dispatch.hpp>
 #include <common/half.hpp>
 #include <common/util.hpp>
@@ -28,8 +32,10 @@
 #include <utility>
 
 using af::dim4;
+using common::bfloat16;
 using common::bytesToString;
 using common::half;
+using common::keepCapturedBuffer;
 
 using std::move;
 
@@ -73,12 +79,44 @@ void *memAllocUser(const size_t &bytes) {
     return ptr;
 }
 
+namespace {
+/// Freed buffers are shared between all the streams by the default memory
+/// manager. When threads have their own streams, wait for the work on the
+/// stream of the calling thread so that a buffer is not reused by another
+/// stream while it is still in use. The stream ordered memory manager frees
+/// the buffers in the order of the stream and does not need to wait.
+void waitForThreadStream() {
+    if (!hasThreadStreams()) { return; }
+    if (dynamic_cast<AsyncMemoryManager *>(&memoryManager())) { return; }
+    CUDA_CHECK(cudaStreamSynchronize(getActiveStream()));
+}
+
+/// Returns true if the buffers of \p device are allocated with
+/// cudaMallocManaged, which is requested by setting AF_CUDA_MEMORY_MANAGER
+/// to managed. The device must access managed memory concurrently with the
+/// host, so that its pages can be evicted to the host when the buffers
+/// exceed the memory of the device, and migrated back when they are used.
+bool useManagedMemory(int device) {
+    static const bool requested =
+        getEnvVar("AF_CUDA_MEMORY_MANAGER") == "managed";
+    return requested && getDeviceProp(device).concurrentManagedAccess != 0;
+}
+}  // namespace
+
 template<typename T>
 void memFree(T *ptr) {
+    // The replays of a graph use the buffers freed while it was captured
+    if (keepCapturedBuffer(static_cast<int>(getActiveDeviceId()), ptr)) {
+        return;
+    }
+    if (ptr) { waitForThreadStream(); }
     memoryManager().unlock(static_cast<void *>(ptr), false);
 }
 
-void memFreeUser(void *ptr) { memoryManager().unlock(ptr, true); }
+void memFreeUser(void *ptr) {
+    if (ptr) { waitForThreadStream(); }
+    memoryManager().unlock(ptr, true);
+}
 
 void memLock(const void *ptr) {
     memoryManager().userLock(const_cast<void *>(ptr));
@@ -111,6 +149,31 @@ void pinnedFree(T *ptr) {
     pinnedMemoryManager().unlock(static_cast<void *>(ptr), false);
 }
 
+size_t pinnedAllocated(const void *ptr) {
+    const size_t bytes =
+        pinnedMemoryManager().allocated(const_cast<void *>(ptr));
+    return bytes ? bytes : common::registeredHostBytes(ptr);
+}
+
+void registerHostMemory(void *ptr, const size_t bytes) {
+    common::addRegisteredHostMemory(ptr, bytes);
+    // Portable memory is pinned for all the devices, like the memory of
+    // pinnedAlloc
+    const cudaError_t err =
+        cudaHostRegister(ptr, bytes, cudaHostRegisterPortable);
+    if (err != cudaSuccess) {
+        common::removeRegisteredHostMemory(ptr);
+        CUDA_CHECK(err);
+    }
+}
+
+void unregisterHostMemory(void *ptr) {
+    if (!common::removeRegisteredHostMemory(ptr)) {
+        AF_ERROR("The host memory is not registered", AF_ERR_ARG);
+    }
+    CUDA_CHECK(cudaHostUnregister(ptr));
+}
+
 #define INSTANTIATE(T)                                 \
     template uptr<T> memAlloc(const size_t &elements); \
     template void memFree(T *ptr);                     \
@@ -130,6 +193,7 @@ INSTANTIATE(uintl)
 INSTANTIATE(short)
 INSTANTIATE(ushort)
 INSTANTIATE(half)
+INSTANTIATE(bfloat16)
 
 template void memFree(void *ptr);
 
@@ -149,12 +213,34 @@ void Allocator::shutdown() {
 int Allocator::getActiveDeviceId() { return cuda::getActiveDeviceId(); }
 
 size_t Allocator::getMaxMemorySize(int id) {
+    // Managed buffers can use the memory of the host too
+    if (useManagedMemory(id)) {
+        return cuda::getDeviceMemorySize(id) + cuda::getHostMemorySize();
+    }
     return cuda::getDeviceMemorySize(id);
 }
 
+size_t Allocator::getFreeMemorySize(int id) {
+    // The free memory of the device does not limit the managed buffers
+    if (useManagedMemory(id)) { return 0; }
+    return cuda::getDeviceFreeMemorySize(id);
+}
+
 void *Allocator::nativeAlloc(const size_t bytes) {
-    void *ptr = NULL;
-    CUDA_CHECK(cudaMalloc(&ptr, bytes));
+    void *ptr        = NULL;
+    const int device = getActiveDeviceId();
+    if (useManagedMemory(device)) {
+        // The pages stay on the device while it has room, and are populated
+        // there before the first kernel uses them
+        const int nativeId = getDeviceNativeId(device);
+        CUDA_CHECK(cudaMallocManaged(&ptr, bytes));
+        CUDA_CHECK(cudaMemAdvise(ptr, bytes, cudaMemAdviseSetPreferredLocation,
+                                 nativeId));
+        CUDA_CHECK(
+            cudaMemPrefetchAsync(ptr, bytes, nativeId, getActiveStream()));
+    } else {
+        CUDA_CHECK(cudaMalloc(&ptr, bytes));
+    }
     AF_TRACE("nativeAlloc: {:>7} {}", bytesToString(bytes), ptr);
     return ptr;
 }
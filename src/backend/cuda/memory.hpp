@@ -44,6 +44,18 @@ T *pinnedAlloc(const size_t &elements);
 template<typename T>
 void pinnedFree(T *ptr);
 
+/// Returns the size of the pinned allocation which starts at \p ptr, or
+/// the number of bytes from \p ptr to the end of the host memory registered
+/// by registerHostMemory which holds it. Returns zero for other memory.
+size_t pinnedAllocated(const void *ptr);
+
+/// Registers \p bytes of host memory at \p ptr, so transfers from and to
+/// the memory are asynchronous like those of pinned memory
+void registerHostMemory(void *ptr, const size_t bytes);
+
+/// Unregisters the host memory registered at \p ptr
+void unregisterHostMemory(void *ptr);
+
 void deviceMemoryInfo(size_t *alloc_bytes, size_t *alloc_buffers,
                       size_t *lock_bytes, size_t *lock_buffers);
 void signalMemoryCleanup();
@@ -67,6 +79,7 @@ class Allocator final : public common::memory::AllocatorInterface {
     size_t getMaxMemorySize(int id) override;
     void *nativeAlloc(const size_t bytes) override;
     void nativeFree(void *ptr) override;
+    size_t getFreeMemorySize(int id) override;
 };
 
 // CUDA Pinned Memory does not depend on device
@@ -0,0 +1,40 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <nth_element.hpp>
+
+#include <Array.hpp>
+#include <err_cuda.hpp>
+#include <kernel/nth_element.hpp>
+#include <af/dim4.hpp>
+
+using af::dim4;
+
+namespace cuda {
+template<typename T>
+Array<T> nth_element(const Array<T> &in, const int dim, const dim_t rank) {
+    dim4 odims = in.dims();
+    odims[dim] = 2;
+
+    Array<T> out = createEmptyArray<T>(odims);
+    kernel::nthElement<T>(out, in, dim, rank);
+    return out;
+}
+
+#define INSTANTIATE(T) \
+    template Array<T> nth_element<T>(const Array<T> &, const int, const dim_t);
+
+INSTANTIATE(float)
+INSTANTIATE(double)
+INSTANTIATE(int)
+INSTANTIATE(uint)
+INSTANTIATE(short)
+INSTANTIATE(ushort)
+INSTANTIATE(uchar)
+}  // namespace cuda
@@ -0,0 +1,19 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+
+namespace cuda {
+/// Returns the values of rank \p rank and rank + 1 of each line of \p in
+/// along \p dim, as if the line was sorted in ascending order. The output has
+/// a length of 2 along \p dim. The second value is the last value of the line
+/// when \p rank is the last rank.
+template<typename T>
+Array<T> nth_element(const Array<T> &in, const int dim, const dim_t rank);
+}
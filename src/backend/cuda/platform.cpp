@@ -16,6 +16,7 @@
 #include <cudnnModule.hpp>
 #endif
 
+#include <AsyncMemoryManager.hpp>
 #include <GraphicsResourceManager.hpp>
 #include <common/DefaultMemoryManager.hpp>
 #include <common/Logger.hpp>
@@ -42,6 +43,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdio>
 #include <memory>
 #include <mutex>
@@ -95,12 +97,9 @@ unique_handle<cublasHandle_t> *cublasManager(const int deviceId) {
 
     call_once(initFlags[deviceId], [&] {
         handles[deviceId].create();
-        // TODO(pradeep) When multiple streams per device
-        // is added to CUDA backend, move the cublasSetStream
-        // call outside of call_once scope.
-        CUBLAS_CHECK(
-            cublasSetStream(handles[deviceId], cuda::getStream(deviceId)));
     });
+    // The stream bound to the thread can change between calls
+    CUBLAS_CHECK(cublasSetStream(handles[deviceId], cuda::getStream(deviceId)));
 
     return &handles[deviceId];
 }
@@ -148,12 +147,10 @@ unique_handle<cusolverDnHandle_t> *cusolverManager(const int deviceId) {
     thread_local once_flag initFlags[DeviceManager::MAX_DEVICES];
     call_once(initFlags[deviceId], [&] {
         handles[deviceId].create();
-        // TODO(pradeep) When multiple streams per device
-        // is added to CUDA backend, move the cublasSetStream
-        // call outside of call_once scope.
-        CUSOLVER_CHECK(
-            cusolverDnSetStream(handles[deviceId], cuda::getStream(deviceId)));
     });
+    // The stream bound to the thread can change between calls
+    CUSOLVER_CHECK(
+        cusolverDnSetStream(handles[deviceId], cuda::getStream(deviceId)));
     // TODO(pradeep) prior to this change, stream was being synced in get solver
     // handle because of some cusolver bug. Re-enable that if this change
     // doesn't work and sovler tests fail.
@@ -170,12 +167,10 @@ unique_handle<cusparseHandle_t> *cusparseManager(const int deviceId) {
     thread_local once_flag initFlags[DeviceManager::MAX_DEVICES];
     call_once(initFlags[deviceId], [&] {
         handles[deviceId].create();
-        // TODO(pradeep) When multiple streams per device
-        // is added to CUDA backend, move the cublasSetStream
-        // call outside of call_once scope.
-        CUSPARSE_CHECK(
-            cusparseSetStream(handles[deviceId], cuda::getStream(deviceId)));
     });
+    // The stream bound to the thread can change between calls
+    CUSPARSE_CHECK(
+        cusparseSetStream(handles[deviceId], cuda::getStream(deviceId)));
     return &handles[deviceId];
 }
 
@@ -210,7 +205,7 @@ DeviceManager::~DeviceManager() {
 int getBackend() { return AF_BACKEND_CUDA; }
 
 string getDeviceInfo(int device) noexcept {
-    cudaDeviceProp dev = getDeviceProp(device);
+    const cudaDeviceProp &dev = getDeviceProp(device);
 
     size_t mem_gpu_total = dev.totalGlobalMem;
     // double cc = double(dev.major) + double(dev.minor) / 10;
@@ -262,9 +257,9 @@ bool isHalfSupported(int device) {
         std::array<bool, DeviceManager::MAX_DEVICES> out{};
         int count = getDeviceCount();
         for (int i = 0; i < count; i++) {
-            auto prop   = getDeviceProp(i);
-            int compute = prop.major * 1000 + prop.minor * 10;
-            out[i]      = compute >= 5030;
+            const auto &prop = getDeviceProp(i);
+            int compute      = prop.major * 1000 + prop.minor * 10;
+            out[i]           = compute >= 5030;
         }
         return out;
     }();
@@ -274,7 +269,7 @@ bool isHalfSupported(int device) {
 void devprop(char *d_name, char *d_platform, char *d_toolkit, char *d_compute) {
     if (getDeviceCount() <= 0) { return; }
 
-    cudaDeviceProp dev = getDeviceProp(getActiveDeviceId());
+    const cudaDeviceProp &dev = getDeviceProp(getActiveDeviceId());
 
     // Name
     snprintf(d_name, 256, "%s", dev.name);
@@ -376,7 +371,81 @@ int getDeviceIdFromNativeId(int nativeId) {
     return devId;
 }
 
+namespace {
+/// The number of streams bound to threads in the process
+std::atomic<int> boundStreamCount{0};
+
+/// The streams bound to the calling thread. A null stream means the thread
+/// uses the stream of the device shared by all threads.
+struct ThreadStreams {
+    cudaStream_t streams[DeviceManager::MAX_DEVICES]{};
+    // True if the stream was created by ArrayFire and must be destroyed
+    bool owned[DeviceManager::MAX_DEVICES]{};
+
+    void release(int device) {
+        if (!streams[device]) { return; }
+        if (owned[device]) {
+            // The runtime may have been unloaded before the thread exits
+            cudaError_t err = cudaStreamSynchronize(streams[device]);
+            if (err == cudaSuccess) { cudaStreamDestroy(streams[device]); }
+            owned[device] = false;
+        }
+        streams[device] = nullptr;
+        boundStreamCount--;
+    }
+
+    ~ThreadStreams() {
+        for (int i = 0; i < DeviceManager::MAX_DEVICES; ++i) { release(i); }
+    }
+};
+
+ThreadStreams &threadStreams() {
+    thread_local ThreadStreams streams;
+    return streams;
+}
+
+bool isStreamPerThread() {
+    static const bool perThread =
+        getEnvVar("AF_CUDA_STREAM_PER_THREAD") == "1";
+    return perThread;
+}
+}  // namespace
+
+void setThreadStream(int device, cudaStream_t stream) {
+    if (device < 0 || device >= getDeviceCount()) {
+        AF_ERROR("Invalid device id", AF_ERR_ARG);
+    }
+    ThreadStreams &tstreams = threadStreams();
+    tstreams.release(device);
+    if (stream) {
+        tstreams.streams[device] = stream;
+        boundStreamCount++;
+    }
+}
+
+cudaStream_t createThreadStream(int device) {
+    if (device < 0 || device >= getDeviceCount()) {
+        AF_ERROR("Invalid device id", AF_ERR_ARG);
+    }
+    int currDevice = getActiveDeviceId();
+    setDevice(device);
+    cudaStream_t stream = nullptr;
+    cudaError_t err = cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking);
+    setDevice(currDevice);
+    CUDA_CHECK(err);
+
+    setThreadStream(device, stream);
+    threadStreams().owned[device] = true;
+    return stream;
+}
+
+bool hasThreadStreams() { return boundStreamCount > 0; }
+
 cudaStream_t getStream(int device) {
+    cudaStream_t tstream = threadStreams().streams[device];
+    if (tstream) { return tstream; }
+    if (isStreamPerThread()) { return createThreadStream(device); }
+
     static std::once_flag streamInitFlags[DeviceManager::MAX_DEVICES];
 
     std::call_once(streamInitFlags[device], [device]() {
@@ -393,13 +462,22 @@ size_t getDeviceMemorySize(int device) {
     return getDeviceProp(device).totalGlobalMem;
 }
 
+size_t getDeviceFreeMemorySize(int device) {
+    // cudaMemGetInfo reports the device of the calling thread
+    if (device != static_cast<int>(getActiveDeviceId())) { return 0; }
+    size_t freeBytes  = 0;
+    size_t totalBytes = 0;
+    CUDA_CHECK(cudaMemGetInfo(&freeBytes, &totalBytes));
+    return freeBytes;
+}
+
 size_t getHostMemorySize() { return common::getHostMemorySize(); }
 
 int setDevice(int device) {
     return DeviceManager::getInstance().setActiveDevice(device);
 }
 
-cudaDeviceProp getDeviceProp(int device) {
+const cudaDeviceProp &getDeviceProp(int device) {
     if (device <
         static_cast<int>(DeviceManager::getInstance().cuDevices.size())) {
         return DeviceManager::getInstance().cuDevices[device].prop;
@@ -414,9 +492,7 @@ MemoryManagerBase &memoryManager() {
 
     std::call_once(flag, [&]() {
         // By default, create an instance of the default memory manager
-        inst.memManager = std::make_unique<common::DefaultMemoryManager>(
-            getDeviceCount(), common::MAX_BUFFERS,
-            AF_MEM_DEBUG || AF_CUDA_MEM_DEBUG);
+        inst.memManager = inst.createMemoryManager();
         // Set the memory manager's device memory manager
         std::unique_ptr<cuda::Allocator> deviceMemoryManager(
             new cuda::Allocator());
@@ -564,6 +640,38 @@ af_err afcu_cublasSetMathMode(cublasMath_t mode) {
     return AF_SUCCESS;
 }
 
+af_err afcu_set_mem_pool_release_threshold(int id, unsigned long long bytes) {
+    try {
+        cuda::setMemPoolReleaseThreshold(id, bytes);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err afcu_get_mem_pool_release_threshold(unsigned long long *bytes, int id) {
+    try {
+        *bytes = cuda::getMemPoolReleaseThreshold(id);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err afcu_set_stream(int id, cudaStream_t stream) {
+    try {
+        cuda::setThreadStream(id, stream);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err afcu_create_stream(cudaStream_t *stream, int id) {
+    try {
+        *stream = cuda::createThreadStream(id);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
 namespace af {
 template<>
 __half *array::device<__half>() const {
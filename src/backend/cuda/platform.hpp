@@ -88,8 +88,25 @@ cudaStream_t getStream(int device);
 
 cudaStream_t getActiveStream();
 
+/// Binds \p stream to the calling thread for \p device. The kernels, library
+/// calls and memory operations issued by the thread on \p device are enqueued
+/// on \p stream. A null stream restores the stream shared by all threads.
+void setThreadStream(int device, cudaStream_t stream);
+
+/// Creates a stream owned by ArrayFire and binds it to the calling thread for
+/// \p device. The stream is destroyed when it is unbound or the thread exits.
+cudaStream_t createThreadStream(int device);
+
+/// Returns true if any thread has a stream bound using setThreadStream or
+/// createThreadStream
+bool hasThreadStreams();
+
 size_t getDeviceMemorySize(int device);
 
+/// Returns the free memory of \p device, which counts the memory used by
+/// other processes, or 0 when \p device is not the active device
+size_t getDeviceFreeMemorySize(int device);
+
 size_t getHostMemorySize();
 
 int setDevice(int device);
@@ -99,7 +116,7 @@ void sync(int device);
 // Returns true if the AF_SYNCHRONIZE_CALLS environment variable is set to 1
 bool synchronize_calls();
 
-cudaDeviceProp getDeviceProp(int device);
+const cudaDeviceProp &getDeviceProp(int device);
 
 std::pair<int, int> getComputeCapability(const int device);
 
@@ -12,32 +12,47 @@
 #include <debug_cuda.hpp>
 #include <device_manager.hpp>
 #include <err_cuda.hpp>
+#include <kernel/interleave.hpp>
 #include <plot.hpp>
 
+#include <memory>
+#include <vector>
+
 using af::dim4;
+using std::shared_ptr;
+using std::vector;
 
 namespace cuda {
 
 template<typename T>
-void copy_plot(const Array<T> &P, fg_plot plot) {
-    auto stream = cuda::getActiveStream();
+void copy_plot(const vector<Array<T>> &components, fg_plot plot) {
+    vector<CParam<T>> params(components.begin(), components.end());
+    vector<shared_ptr<const void>> inputs;
+    for (const Array<T> &component : components) {
+        inputs.push_back(component.getData());
+    }
+    GraphicsResourceManager &interop = interopManager();
+    cudaStream_t stream              = interop.beginCopy();
     if (DeviceManager::checkGraphicsInteropCapability()) {
-        const T *d_P = P.get();
-
-        auto res = interopManager().getPlotResources(plot);
+        auto res = interop.getPlotResources(plot);
 
         size_t bytes = 0;
         T *d_vbo     = NULL;
         cudaGraphicsMapResources(1, res[0].get(), stream);
         cudaGraphicsResourceGetMappedPointer((void **)&d_vbo, &bytes,
                                              *(res[0].get()));
-        cudaMemcpyAsync(d_vbo, d_P, bytes, cudaMemcpyDeviceToDevice, stream);
+        kernel::interleave(d_vbo, params, stream);
         cudaGraphicsUnmapResources(1, res[0].get(), stream);
 
         CheckGL("After cuda resource copy");
 
         POST_LAUNCH_CHECK();
     } else {
+        Array<T> P = createEmptyArray<T>(
+            dim4(params.size() * components[0].elements()));
+        kernel::interleave(P.get(), params, stream);
+        inputs.push_back(P.getData());
+
         ForgeModule &_ = graphics::forgePlugin();
         unsigned bytes = 0, buffer = 0;
         FG_CHECK(_.fg_get_plot_vertex_buffer(&buffer, plot));
@@ -56,9 +71,11 @@ void copy_plot(const Array<T> &P, fg_plot plot) {
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         CheckGL("End CUDA fallback-resource copy");
     }
+    interop.endCopy(inputs);
 }
 
-#define INSTANTIATE(T) template void copy_plot<T>(const Array<T> &, fg_plot);
+#define INSTANTIATE(T)                                             \
+    template void copy_plot<T>(const vector<Array<T>> &, fg_plot);
 
 INSTANTIATE(float)
 INSTANTIATE(double)
@@ -8,8 +8,10 @@
  ********************************************************/
 
 #include "reduce_impl.hpp"
+#include <common/bfloat16.hpp>
 #include <common/half.hpp>
 
+using common::bfloat16;
 using common::half;
 
 namespace cuda {
@@ -27,4 +29,5 @@ INSTANTIATE(af_mul_t, uchar, uint)
 INSTANTIATE(af_mul_t, short, int)
 INSTANTIATE(af_mul_t, ushort, uint)
 INSTANTIATE(af_mul_t, half, float)
+INSTANTIATE(af_mul_t, bfloat16, float)
 }  // namespace cuda
@@ -0,0 +1,137 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <profiled_launch.hpp>
+
+#include <common/Profiler.hpp>
+#include <cu_check_macro.hpp>
+#include <device_manager.hpp>
+#include <platform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+using common::addProfileEvent;
+using common::getProfiledFunction;
+using common::isProfiling;
+using common::ProfileEvent;
+using common::profileClock;
+using std::lock_guard;
+using std::mutex;
+using std::string;
+using std::vector;
+
+namespace cuda {
+
+namespace {
+
+/// A launch whose end event was not reached yet
+struct PendingLaunch {
+    CUevent start;
+    CUevent end;
+    ProfileEvent event;
+};
+
+/// An event of a device which was reached at a known host time. The device
+/// timestamps of the launches are measured from it.
+struct DeviceOrigin {
+    CUevent event = nullptr;
+    double host   = 0.0;
+};
+
+struct ProfiledLaunches {
+    mutex launchesMutex;
+    vector<PendingLaunch> pending;
+    std::array<DeviceOrigin, DeviceManager::MAX_DEVICES> origins;
+};
+
+ProfiledLaunches& getProfiledLaunches() {
+    // Never released, so the pending launches can be flushed when the
+    // profiler writes its timeline at exit
+    static auto* launches = new ProfiledLaunches();
+    return *launches;
+}
+
+/// Adds the completed launches to the timeline of the profiler. If \p wait
+/// is true, the launches which are still running are waited for.
+void resolveLaunches(ProfiledLaunches& launches, bool wait) {
+    auto resolved = [&](PendingLaunch& launch) {
+        CUresult status = wait ? cuEventSynchronize(launch.end)
+                               : cuEventQuery(launch.end);
+        if (status == CUDA_ERROR_NOT_READY) { return false; }
+
+        const DeviceOrigin& origin = launches.origins[launch.event.device];
+        float offset = 0.0f, duration = 0.0f;
+        if (status == CUDA_SUCCESS &&
+            cuEventElapsedTime(&offset, origin.event, launch.start) ==
+                CUDA_SUCCESS &&
+            cuEventElapsedTime(&duration, launch.start, launch.end) ==
+                CUDA_SUCCESS) {
+            launch.event.start    = origin.host + offset * 1000.0;
+            launch.event.duration = duration * 1000.0;
+            addProfileEvent(std::move(launch.event));
+        }
+        cuEventDestroy(launch.start);
+        cuEventDestroy(launch.end);
+        return true;
+    };
+    auto& pending = launches.pending;
+    pending.erase(std::remove_if(pending.begin(), pending.end(), resolved),
+                  pending.end());
+}
+
+}  // namespace
+
+CUevent beginProfiledLaunch(CUstream stream) {
+    if (!isProfiling()) { return nullptr; }
+
+    ProfiledLaunches& launches = getProfiledLaunches();
+    static std::once_flag flushFlag;
+    std::call_once(flushFlag, [&launches]() {
+        common::setProfileFlush([&launches]() {
+            lock_guard<mutex> lock(launches.launchesMutex);
+            resolveLaunches(launches, true);
+        });
+    });
+
+    lock_guard<mutex> lock(launches.launchesMutex);
+    DeviceOrigin& origin = launches.origins[getActiveDeviceId()];
+    if (!origin.event) {
+        CU_CHECK(cuEventCreate(&origin.event, CU_EVENT_DEFAULT));
+        CU_CHECK(cuEventRecord(origin.event, stream));
+        CU_CHECK(cuEventSynchronize(origin.event));
+        origin.host = profileClock();
+    }
+
+    CUevent start;
+    CU_CHECK(cuEventCreate(&start, CU_EVENT_DEFAULT));
+    CU_CHECK(cuEventRecord(start, stream));
+    return start;
+}
+
+void endProfiledLaunch(CUevent start, CUstream stream, string name,
+                       string module) {
+    CUevent end;
+    CU_CHECK(cuEventCreate(&end, CU_EVENT_DEFAULT));
+    CU_CHECK(cuEventRecord(end, stream));
+
+    ProfileEvent event{std::move(name), getProfiledFunction(),
+                       std::move(module), getActiveDeviceId(), 0.0, 0.0};
+
+    ProfiledLaunches& launches = getProfiledLaunches();
+    lock_guard<mutex> lock(launches.launchesMutex);
+    launches.pending.push_back({start, end, std::move(event)});
+    resolveLaunches(launches, false);
+}
+
+}  // namespace cuda
@@ -0,0 +1,37 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <cuda.h>
+
+#include <string>
+
+namespace cuda {
+
+/// Records the start of a kernel launch on \p stream if the launches are
+/// profiled (see AF_PROFILE)
+///
+/// \returns the event which marks the start of the launch, or a null event
+///          if the launches are not profiled
+CUevent beginProfiledLaunch(CUstream stream);
+
+/// Records the end of a launch started by beginProfiledLaunch
+///
+/// The launch is added to the timeline of the profiler once it completes,
+/// with the time measured between its events on the device.
+///
+/// \param[in] start the event returned by beginProfiledLaunch
+/// \param[in] stream the stream the kernel was launched on
+/// \param[in] name the name of the kernel
+/// \param[in] module the key of the module of the kernel
+void endProfiledLaunch(CUevent start, CUstream stream, std::string name,
+                       std::string module);
+
+}  // namespace cuda
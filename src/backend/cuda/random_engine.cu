@@ -9,9 +9,14 @@
 
 #include <Array.hpp>
 #include <common/half.hpp>
+#include <common/jit/RandomNode.hpp>
+#include <kernel/random_distributions.hpp>
 #include <kernel/random_engine.hpp>
 #include <af/dim4.hpp>
 #include <cassert>
+#include <memory>
+#include <type_traits>
+#include <vector>
 
 using common::half;
 
@@ -21,16 +26,64 @@ void initMersenneState(Array<uint> &state, const uintl seed,
     kernel::initMersenneState(state.get(), tbl.get(), seed);
 }
 
+void initMersenneStates(std::vector<Array<uint>> &states,
+                        const std::vector<uintl> &seeds,
+                        const Array<uint> &tbl) {
+    // The pointers to the states are followed by the seeds, so they are
+    // copied to the device at once
+    const int count = static_cast<int>(states.size());
+    std::vector<uintl> args(2 * count);
+    for (int i = 0; i < count; ++i) {
+        args[i]         = reinterpret_cast<uintl>(states[i].get());
+        args[count + i] = seeds[i];
+    }
+    Array<uintl> dArgs =
+        createHostDataArray<uintl>(af::dim4(2 * count), args.data());
+    const uintl *ptr = dArgs.get();
+    kernel::initMersenneStates(reinterpret_cast<uint *const *>(ptr),
+                               ptr + count, tbl.get(), count);
+}
+
+/// Generates a uniform array of a counter based engine with its kernel
 template<typename T>
-Array<T> uniformDistribution(const af::dim4 &dims,
-                             const af_random_engine_type type,
-                             const uintl &seed, uintl &counter) {
+Array<T> uniformKernelArray(const af::dim4 &dims,
+                            const af_random_engine_type type,
+                            const uintl &seed, uintl &counter) {
     Array<T> out = createEmptyArray<T>(dims);
     kernel::uniformDistributionCBRNG<T>(out.get(), out.elements(), type, seed,
                                         counter);
     return out;
 }
 
+/// Floating point arrays of the Philox engine are generated by the JIT
+/// kernels which use them. Their values are the ones written by the kernel.
+template<typename T>
+typename std::enable_if<std::is_floating_point<T>::value, Array<T>>::type
+uniformCBRNG(const af::dim4 &dims, const af_random_engine_type type,
+             const uintl &seed, uintl &counter) {
+    if (type != AF_RANDOM_ENGINE_PHILOX_4X32_10) {
+        return uniformKernelArray<T>(dims, type, seed, counter);
+    }
+    Array<T> out = createNodeArray<T>(
+        dims, std::make_shared<common::RandomNode<T>>(seed, counter));
+    counter += dims.elements();
+    return out;
+}
+
+template<typename T>
+typename std::enable_if<!std::is_floating_point<T>::value, Array<T>>::type
+uniformCBRNG(const af::dim4 &dims, const af_random_engine_type type,
+             const uintl &seed, uintl &counter) {
+    return uniformKernelArray<T>(dims, type, seed, counter);
+}
+
+template<typename T>
+Array<T> uniformDistribution(const af::dim4 &dims,
+                             const af_random_engine_type type,
+                             const uintl &seed, uintl &counter) {
+    return uniformCBRNG<T>(dims, type, seed, counter);
+}
+
 template<typename T>
 Array<T> normalDistribution(const af::dim4 &dims,
                             const af_random_engine_type type, const uintl &seed,
@@ -65,6 +118,16 @@ Array<T> normalDistribution(const af::dim4 &dims, Array<uint> pos,
     return out;
 }
 
+template<typename T>
+Array<T> randomDistribution(const AF_RANDOM_DIST dist, const Array<T> &param0,
+                            const Array<T> &param1, const uintl seed,
+                            uintl &counter) {
+    Array<T> out = createEmptyArray<T>(param0.dims());
+    kernel::randomDistribution<T>(out.get(), param0.get(), param1.get(),
+                                  out.elements(), dist, seed, counter);
+    return out;
+}
+
 #define INSTANTIATE_UNIFORM(T)                                   \
     template Array<T> uniformDistribution<T>(                    \
         const af::dim4 &dims, const af_random_engine_type type,  \
@@ -157,4 +220,12 @@ COMPLEX_UNIFORM_DISTRIBUTION(cfloat, float)
 COMPLEX_NORMAL_DISTRIBUTION(cdouble, double)
 COMPLEX_NORMAL_DISTRIBUTION(cfloat, float)
 
+#define INSTANTIATE_DISTRIBUTION(T)                                            \
+    template Array<T> randomDistribution<T>(                                   \
+        const AF_RANDOM_DIST dist, const Array<T> &param0,                     \
+        const Array<T> &param1, const uintl seed, uintl &counter);
+
+INSTANTIATE_DISTRIBUTION(float)
+INSTANTIATE_DISTRIBUTION(double)
+
 }  // namespace cuda
@@ -10,10 +10,11 @@
 #include <range.hpp>
 
 #include <Array.hpp>
+#include <common/jit/IndexNode.hpp>
 #include <err_cuda.hpp>
-#include <kernel/range.hpp>
 #include <math.hpp>
 
+#include <memory>
 #include <stdexcept>
 
 using common::half;
@@ -32,10 +33,11 @@ Array<T> range(const dim4& dim, const int seq_dim) {
         AF_ERROR("Invalid rep selection", AF_ERR_ARG);
     }
 
-    Array<T> out = createEmptyArray<T>(dim);
-    kernel::range<T>(out, _seq_dim);
-
-    return out;
+    // The values are generated by the kernels of the expressions which use
+    // the range
+    return createNodeArray<T>(
+        dim, std::make_shared<common::IndexNode<T>>(common::IndexParams(
+                 common::IndexKind::Range, dim, _seq_dim)));
 }
 
 #define INSTANTIATE(T) \
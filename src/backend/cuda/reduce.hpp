@@ -20,6 +20,15 @@ void reduce_by_key(Array<Tk> &keys_out, Array<To> &vals_out,
                    const Array<Tk> &keys, const Array<Ti> &vals, const int dim,
                    bool change_nan = false, double nanval = 0);
 
+/// Reduces the values of each distinct key of the vector \p keys with a hash
+/// table, without sorting the keys. The keys are sorted in \p keys_out like
+/// the results of sort_by_key and reduce_by_key. Returns false, and leaves the
+/// outputs unchanged, when the keys have too many distinct values for the
+/// table.
+template<af_op_t op, typename Ti, typename Tk, typename To>
+bool reduce_by_key_hash(Array<Tk> &keys_out, Array<To> &vals_out,
+                        const Array<Tk> &keys, const Array<Ti> &vals);
+
 template<af_op_t op, typename Ti, typename To>
 To reduce_all(const Array<Ti> &in, bool change_nan = false, double nanval = 0);
 }  // namespace cuda
@@ -0,0 +1,19 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Array.hpp>
+
+namespace cuda {
+/// Computes the properties of the labels 1 to \p nlabels of the label image
+/// \p labels. Label i is described by column i - 1 of the result, which has
+/// common::REGION_PROP_COUNT rows. The other labels are ignored.
+template<typename T>
+Array<float> regionProps(const Array<T> &labels, const unsigned nlabels);
+}  // namespace cuda
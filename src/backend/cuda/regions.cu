@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <common/region_stats.hpp>
 #include <err_cuda.hpp>
 #include <kernel/regions.hpp>
 #include <regions.hpp>
@@ -61,9 +62,20 @@ Array<T> regions(const Array<char> &in, af_connectivity connectivity) {
     return out;
 }
 
-#define INSTANTIATE(T)                                  \
-    template Array<T> regions<T>(const Array<char> &in, \
-                                 af_connectivity connectivity);
+template<typename T>
+Array<T> regions(const Array<char> &in, af_connectivity connectivity,
+                 Array<uint> &stats) {
+    Array<T> out = regions<T>(in, connectivity);
+    stats        = common::regionStats(out);
+    return out;
+}
+
+#define INSTANTIATE(T)                                                   \
+    template Array<T> regions<T>(const Array<char> &in,                  \
+                                 af_connectivity connectivity);          \
+    template Array<T> regions<T>(const Array<char> &in,                  \
+                                 af_connectivity connectivity,           \
+                                 Array<uint> &stats);
 
 INSTANTIATE(float)
 INSTANTIATE(double)
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#pragma once
 #include <Array.hpp>
 #include <common/jit/ScalarNode.hpp>
 #include <math.hpp>
@@ -28,7 +29,7 @@ Array<T> createScalarNode(const dim4 &size, const T val) {
     return createNodeArray<T>(size, ScalarNodePtr(new ScalarNode(val)));
 #else
     return createNodeArray<T>(size,
-                              std::make_shared<common::ScalarNode<T>>(val));
+                              common::makePooled<common::ScalarNode<T>>(val));
 #endif
 }
 
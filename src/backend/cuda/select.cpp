@@ -11,6 +11,7 @@
 
 #include <Array.hpp>
 #include <common/half.hpp>
+#include <common/jit/JitStats.hpp>
 #include <common/jit/NaryNode.hpp>
 #include <err_cuda.hpp>
 #include <kernel/select.hpp>
@@ -19,6 +20,7 @@
 #include <memory>
 
 using common::half;
+using common::JitEvalScope;
 using common::NaryNode;
 using common::Node_ptr;
 using std::make_shared;
@@ -50,9 +52,11 @@ Array<T> createSelectNode(const Array<char> &cond, const Array<T> &a,
         static_cast<af::dtype>(dtype_traits<T>::af_type), "__select", 3,
         {{cond_node, a_node, b_node}}, static_cast<int>(af_select_t), height));
 
-    if (detail::passesJitHeuristics<T>(node.get()) == kJITHeuristics::Pass) {
+    const kJITHeuristics reason = detail::passesJitHeuristics<T>(node.get());
+    if (reason == kJITHeuristics::Pass) {
         return createNodeArray<T>(odims, node);
     } else {
+        JitEvalScope scope(reason);
         if (a_node->getHeight() >
             max(b_node->getHeight(), cond_node->getHeight())) {
             a.eval();
@@ -80,9 +84,11 @@ Array<T> createSelectNode(const Array<char> &cond, const Array<T> &a,
         (flip ? "__not_select" : "__select"), 3, {{cond_node, a_node, b_node}},
         static_cast<int>(flip ? af_not_select_t : af_select_t), height));
 
-    if (detail::passesJitHeuristics<T>(node.get()) == kJITHeuristics::Pass) {
+    const kJITHeuristics reason = detail::passesJitHeuristics<T>(node.get());
+    if (reason == kJITHeuristics::Pass) {
         return createNodeArray<T>(odims, node);
     } else {
+        JitEvalScope scope(reason);
         if (a_node->getHeight() >
             max(b_node->getHeight(), cond_node->getHeight())) {
             a.eval();
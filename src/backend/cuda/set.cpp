@@ -0,0 +1,138 @@
+/*******************************************************
+ * Copyright (c) 2014, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <copy.hpp>
+#include <err_cuda.hpp>
+#include <join.hpp>
+#include <kernel/set.hpp>
+#include <scan.hpp>
+#include <set.hpp>
+#include <sort.hpp>
+#include <af/dim4.hpp>
+
+namespace cuda {
+using af::dim4;
+
+namespace {
+
+/// The values of a set and their number, which stays on the device until the
+/// result is returned. Only the first length[0] values are valid.
+template<typename T>
+struct DeviceSet {
+    Array<T> values;
+    Array<uint> length;
+};
+
+template<typename T>
+Array<T> flat(const Array<T> &in) {
+    Array<T> out = in.isLinear() ? in : copyArray<T>(in);
+    out.eval();
+    out.modDims(dim4(in.elements()));
+    return out;
+}
+
+template<typename T>
+DeviceSet<T> sortedSet(const Array<T> &in, const bool is_sorted) {
+    Array<T> values = is_sorted ? flat(in) : sort<T>(flat(in), 0, true);
+    Array<uint> length =
+        createValueArray<uint>(dim4(1), static_cast<uint>(in.elements()));
+    length.eval();
+    return {values, length};
+}
+
+/// Keeps the first value of each run of equal values of the sorted set, or one
+/// value of each run of at least two values when \p duplicates is true
+template<typename T>
+DeviceSet<T> compact(const DeviceSet<T> &set, const bool duplicates) {
+    const dim_t capacity = set.values.elements();
+
+    Array<uint> flags = createEmptyArray<uint>(dim4(capacity));
+    kernel::setFlags<T>(flags.get(), set.values.get(), set.length.get(),
+                        capacity, duplicates);
+    const Array<uint> positions = scan<af_add_t, uint, uint>(flags, 0, true);
+
+    DeviceSet<T> out{createEmptyArray<T>(dim4(capacity)),
+                     createEmptyArray<uint>(dim4(1))};
+    kernel::setScatter<T>(out.values.get(), out.length.get(),
+                          set.values.get(), flags.get(), positions.get(),
+                          capacity);
+    return out;
+}
+
+template<typename T>
+DeviceSet<T> merge(const DeviceSet<T> &first, const DeviceSet<T> &second) {
+    const dim_t capacity = first.values.elements() + second.values.elements();
+
+    DeviceSet<T> out{createEmptyArray<T>(dim4(capacity)),
+                     createEmptyArray<uint>(dim4(1))};
+    kernel::setMerge<T>(out.values.get(), out.length.get(),
+                        first.values.get(), first.length.get(),
+                        second.values.get(), second.length.get(), capacity);
+    return out;
+}
+
+/// Reads the length of the set, which is the only synchronization of the set
+/// operations, and returns its values
+template<typename T>
+Array<T> toArray(DeviceSet<T> set) {
+    set.values.resetDims(dim4(getScalar<uint>(set.length)));
+    return set.values;
+}
+
+}  // namespace
+
+template<typename T>
+Array<T> setUnique(const Array<T> &in, const bool is_sorted) {
+    return toArray(compact(sortedSet(in, is_sorted), false));
+}
+
+template<typename T>
+Array<T> setUnion(const Array<T> &first, const Array<T> &second,
+                  const bool is_unique) {
+    if (!is_unique) {
+        return setUnique(join<T>(0, flat(first), flat(second)), false);
+    }
+    return toArray(compact(
+        merge(sortedSet(first, true), sortedSet(second, true)), false));
+}
+
+template<typename T>
+Array<T> setIntersect(const Array<T> &first, const Array<T> &second,
+                      const bool is_unique) {
+    DeviceSet<T> uFirst  = sortedSet(first, is_unique);
+    DeviceSet<T> uSecond = sortedSet(second, is_unique);
+
+    if (!is_unique) {
+        uFirst  = compact(uFirst, false);
+        uSecond = compact(uSecond, false);
+    }
+
+    // The values of both sets appear twice in their merge
+    return toArray(compact(merge(uFirst, uSecond), true));
+}
+
+#define INSTANTIATE(T)                                                        \
+    template Array<T> setUnique<T>(const Array<T> &in, const bool is_sorted); \
+    template Array<T> setUnion<T>(                                            \
+        const Array<T> &first, const Array<T> &second, const bool is_unique); \
+    template Array<T> setIntersect<T>(                                        \
+        const Array<T> &first, const Array<T> &second, const bool is_unique);
+
+INSTANTIATE(float)
+INSTANTIATE(double)
+INSTANTIATE(int)
+INSTANTIATE(uint)
+INSTANTIATE(char)
+INSTANTIATE(uchar)
+INSTANTIATE(short)
+INSTANTIATE(ushort)
+INSTANTIATE(intl)
+INSTANTIATE(uintl)
+}  // namespace cuda
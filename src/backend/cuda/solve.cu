@@ -12,11 +12,13 @@
 #include <blas.hpp>
 #include <common/err_common.hpp>
 #include <copy.hpp>
+#include <cublas.hpp>
 #include <cublas_v2.h>
 #include <cusolverDn.hpp>
 #include <identity.hpp>
 #include <lu.hpp>
 #include <math.hpp>
+#include <matrix_pointers.hpp>
 #include <memory.hpp>
 #include <platform.hpp>
 #include <qr.hpp>
@@ -58,6 +60,59 @@ SOLVE_FUNC(getrs, double, D)
 SOLVE_FUNC(getrs, cfloat, C)
 SOLVE_FUNC(getrs, cdouble, Z)
 
+// cublasStatus_t cublas<>getrsBatched(
+//    cublasHandle_t handle,
+//    cublasOperation_t trans,
+//    int n, int nrhs,
+//    const <> *const Aarray[], int lda,
+//    const int *devIpiv,
+//    <> *const Barray[], int ldb,
+//    int *info, int batchSize);
+//
+// cublasStatus_t cublas<>trsmBatched(
+//    cublasHandle_t handle,
+//    cublasSideMode_t side, cublasFillMode_t uplo,
+//    cublasOperation_t trans, cublasDiagType_t diag,
+//    int m, int n,
+//    const <> *alpha,
+//    const <> *const A[], int lda,
+//    <> *const B[], int ldb,
+//    int batchCount);
+
+template<typename T>
+struct getrsBatched_func_def_t {
+    typedef cublasStatus_t (*getrsBatched_func_def)(
+        cublasHandle_t, cublasOperation_t, int, int, const T *const *, int,
+        const int *, T *const *, int, int *, int);
+};
+
+template<typename T>
+struct trsmBatched_func_def_t {
+    typedef cublasStatus_t (*trsmBatched_func_def)(
+        cublasHandle_t, cublasSideMode_t, cublasFillMode_t, cublasOperation_t,
+        cublasDiagType_t, int, int, const T *, const T *const *, int,
+        T *const *, int, int);
+};
+
+#define BATCHED_FUNC(FUNC, TYPE, PREFIX)                                    \
+    template<>                                                              \
+    typename FUNC##_func_def_t<TYPE>::FUNC##_func_def FUNC##_func<TYPE>() { \
+        return (FUNC##_func_def_t<TYPE>::FUNC##_func_def) &                 \
+               cublas##PREFIX##FUNC;                                        \
+    }
+
+SOLVE_FUNC_DEF(getrsBatched)
+BATCHED_FUNC(getrsBatched, float, S)
+BATCHED_FUNC(getrsBatched, double, D)
+BATCHED_FUNC(getrsBatched, cfloat, C)
+BATCHED_FUNC(getrsBatched, cdouble, Z)
+
+SOLVE_FUNC_DEF(trsmBatched)
+BATCHED_FUNC(trsmBatched, float, S)
+BATCHED_FUNC(trsmBatched, double, D)
+BATCHED_FUNC(trsmBatched, cfloat, C)
+BATCHED_FUNC(trsmBatched, cdouble, Z)
+
 // cusolverStatus_t cusolverDn<>geqrf_bufferSize(
 //        cusolverDnHandle_t handle,
 //        int m, int n,
@@ -154,6 +209,23 @@ MQR_FUNC(mqr, double, Dormqr)
 MQR_FUNC(mqr, cfloat, Cunmqr)
 MQR_FUNC(mqr, cdouble, Zunmqr)
 
+/// Solves the systems of a batch of LU factorized matrices in place of \p B
+template<typename T>
+void solveBatched(const Array<T> &A, const Array<int> &pivot, Array<T> &B) {
+    int batch = A.dims()[2] * A.dims()[3];
+
+    // cuBLAS reads the pivots of the matrices from one contiguous buffer
+    Array<int> ipiv = pivot.isLinear() ? pivot : copyArray<int>(pivot);
+    auto aptrs      = matrixPointers(A);
+    auto bptrs      = matrixPointers(B);
+
+    int info = 0;
+    CUBLAS_CHECK(getrsBatched_func<T>()(
+        blasHandle(), CUBLAS_OP_N, A.dims()[0], B.dims()[1],
+        (const T **)aptrs.get(), A.strides()[1], ipiv.get(),
+        (T **)bptrs.get(), B.strides()[1], &info, batch));
+}
+
 template<typename T>
 Array<T> solveLU(const Array<T> &A, const Array<int> &pivot, const Array<T> &b,
                  const af_mat_prop options) {
@@ -163,6 +235,11 @@ Array<T> solveLU(const Array<T> &A, const Array<int> &pivot, const Array<T> &b,
 
     Array<T> B = copyArray<T>(b);
 
+    if (A.dims()[2] * A.dims()[3] > 1) {
+        solveBatched<T>(A, pivot, B);
+        return B;
+    }
+
     auto info = memAlloc<int>(1);
 
     CUSOLVER_CHECK(getrs_func<T>()(solverDnHandle(), CUBLAS_OP_N, N, NRHS,
@@ -182,6 +259,11 @@ Array<T> generalSolve(const Array<T> &a, const Array<T> &b) {
     Array<T> B       = copyArray<T>(b);
     Array<int> pivot = lu_inplace(A, false);
 
+    if (A.dims()[2] * A.dims()[3] > 1) {
+        solveBatched<T>(A, pivot, B);
+        return B;
+    }
+
     auto info = memAlloc<int>(1);
 
     CUSOLVER_CHECK(getrs_func<T>()(solverDnHandle(), CUBLAS_OP_N, N, K, A.get(),
@@ -306,6 +388,24 @@ template<typename T>
 Array<T> triangleSolve(const Array<T> &A, const Array<T> &b,
                        const af_mat_prop options) {
     Array<T> B = copyArray<T>(b);
+
+    int batch = A.dims()[2] * A.dims()[3];
+    if (batch > 1) {
+        auto aptrs = matrixPointers(A);
+        auto bptrs = matrixPointers(B);
+        T alpha    = scalar<T>(1);
+        CUBLAS_CHECK(trsmBatched_func<T>()(
+            blasHandle(), CUBLAS_SIDE_LEFT,
+            options & AF_MAT_UPPER ? CUBLAS_FILL_MODE_UPPER
+                                   : CUBLAS_FILL_MODE_LOWER,
+            CUBLAS_OP_N,
+            options & AF_MAT_DIAG_UNIT ? CUBLAS_DIAG_UNIT
+                                       : CUBLAS_DIAG_NON_UNIT,
+            B.dims()[0], B.dims()[1], &alpha, (const T **)aptrs.get(),
+            A.strides()[1], (T **)bptrs.get(), B.strides()[1], batch));
+        return B;
+    }
+
     trsm(A, B,
          AF_MAT_NONE,  // transpose flag
          options & AF_MAT_UPPER ? true : false,
@@ -9,17 +9,14 @@
 
 #include <sparse.hpp>
 
-#include <arith.hpp>
-#include <cast.hpp>
 #include <common/err_common.hpp>
 #include <complex.hpp>
 #include <copy.hpp>
 #include <cusparse.hpp>
 #include <kernel/sparse.hpp>
-#include <lookup.hpp>
 #include <math.hpp>
 #include <platform.hpp>
-#include <where.hpp>
+#include <scan.hpp>
 
 #include <stdexcept>
 #include <string>
@@ -28,36 +25,6 @@ namespace cuda {
 
 using namespace common;
 
-// cusparseStatus_t cusparseZdense2csr(cusparseHandle_t handle,
-//                                    int m, int n,
-//                                    const cusparseMatDescr_t descrA,
-//                                    const cuDoubleComplex *A, int lda,
-//                                    const int *nnzPerRow,
-//                                    cuDoubleComplex *csrValA,
-//                                    int *csrRowPtrA, int *csrColIndA)
-template<typename T>
-struct dense2csr_func_def_t {
-    typedef cusparseStatus_t (*dense2csr_func_def)(cusparseHandle_t, int, int,
-                                                   const cusparseMatDescr_t,
-                                                   const T *, int, const int *,
-                                                   T *, int *, int *);
-};
-
-// cusparseStatus_t cusparseZdense2csc(cusparseHandle_t handle,
-//                                    int m, int n,
-//                                    const cusparseMatDescr_t descrA,
-//                                    const cuDoubleComplex *A, int lda,
-//                                    const int *nnzPerCol,
-//                                    cuDoubleComplex *cscValA,
-//                                    int *cscRowIndA, int *cscColPtrA)
-template<typename T>
-struct dense2csc_func_def_t {
-    typedef cusparseStatus_t (*dense2csc_func_def)(cusparseHandle_t, int, int,
-                                                   const cusparseMatDescr_t,
-                                                   const T *, int, const int *,
-                                                   T *, int *, int *);
-};
-
 // cusparseStatus_t cusparseZcsr2dense(cusparseHandle_t handle,
 //                                    int m, int n,
 //                                    const cusparseMatDescr_t descrA,
@@ -88,21 +55,6 @@ struct csc2dense_func_def_t {
                                                    const int *, T *, int);
 };
 
-// cusparseStatus_t cusparseZnnz(cusparseHandle_t handle,
-//                              cusparseDirection_t dirA,
-//                              int m, int n,
-//                              const cusparseMatDescr_t descrA,
-//                              const cuDoubleComplex *A, int lda,
-//                              int *nnzPerRowColumn,
-//                              int *nnzTotalDevHostPtr)
-template<typename T>
-struct nnz_func_def_t {
-    typedef cusparseStatus_t (*nnz_func_def)(cusparseHandle_t,
-                                             cusparseDirection_t, int, int,
-                                             const cusparseMatDescr_t,
-                                             const T *, int, int *, int *);
-};
-
 // cusparseStatus_t cusparseZgthr(cusparseHandle_t handle,
 //                               int nnz,
 //                               const cuDoubleComplex *y,
@@ -126,18 +78,6 @@ struct gthr_func_def_t {
                cusparse##PREFIX##FUNC;                                      \
     }
 
-SPARSE_FUNC_DEF(dense2csr)
-SPARSE_FUNC(dense2csr, float, S)
-SPARSE_FUNC(dense2csr, double, D)
-SPARSE_FUNC(dense2csr, cfloat, C)
-SPARSE_FUNC(dense2csr, cdouble, Z)
-
-SPARSE_FUNC_DEF(dense2csc)
-SPARSE_FUNC(dense2csc, float, S)
-SPARSE_FUNC(dense2csc, double, D)
-SPARSE_FUNC(dense2csc, cfloat, C)
-SPARSE_FUNC(dense2csc, cdouble, Z)
-
 SPARSE_FUNC_DEF(csr2dense)
 SPARSE_FUNC(csr2dense, float, S)
 SPARSE_FUNC(csr2dense, double, D)
@@ -150,12 +90,6 @@ SPARSE_FUNC(csc2dense, double, D)
 SPARSE_FUNC(csc2dense, cfloat, C)
 SPARSE_FUNC(csc2dense, cdouble, Z)
 
-SPARSE_FUNC_DEF(nnz)
-SPARSE_FUNC(nnz, float, S)
-SPARSE_FUNC(nnz, double, D)
-SPARSE_FUNC(nnz, cfloat, C)
-SPARSE_FUNC(nnz, cdouble, Z)
-
 SPARSE_FUNC_DEF(gthr)
 SPARSE_FUNC(gthr, float, S)
 SPARSE_FUNC(gthr, double, D)
@@ -165,81 +99,57 @@ SPARSE_FUNC(gthr, cdouble, Z)
 #undef SPARSE_FUNC
 #undef SPARSE_FUNC_DEF
 
-// Partial template specialization of sparseConvertDenseToStorage for COO
-// However, template specialization is not allowed
+/// Returns the exclusive scan of the number of nonzeros of the rows or of
+/// the columns of \p in. The last of the offsets is the number of nonzeros.
 template<typename T>
-SparseArray<T> sparseConvertDenseToCOO(const Array<T> &in) {
-    Array<uint> nonZeroIdx_ = where<T>(in);
-    Array<int> nonZeroIdx   = cast<int, uint>(nonZeroIdx_);
-
-    dim_t nNZ = nonZeroIdx.elements();
-
-    Array<int> constDim = createValueArray<int>(dim4(nNZ), in.dims()[0]);
-
-    Array<int> rowIdx =
-        arithOp<int, af_mod_t>(nonZeroIdx, constDim, nonZeroIdx.dims());
-    Array<int> colIdx =
-        arithOp<int, af_div_t>(nonZeroIdx, constDim, nonZeroIdx.dims());
-
-    Array<T> values = copyArray<T>(in);
-    values.modDims(dim4(values.elements()));
-    values = lookup<T, int>(values, nonZeroIdx, 0);
+Array<int> nnzOffsets(const Array<T> &in, const bool byRow) {
+    const dim_t lines = byRow ? in.dims()[0] : in.dims()[1];
+    Array<int> counts = createEmptyArray<int>(dim4(lines + 1));
+    if (byRow) {
+        kernel::nnzPerRow<T>(counts, in);
+    } else {
+        kernel::nnzPerCol<T>(counts, in);
+    }
+    return scan<af_add_t, int, int>(counts, 0, false);
+}
 
-    return createArrayDataSparseArray<T>(in.dims(), values, rowIdx, colIdx,
-                                         AF_STORAGE_COO);
+/// Reads the last offset of \p offsets. This is the only synchronization of
+/// the conversions of dense arrays.
+static int readNNZ(const Array<int> &offsets) {
+    int nNZ = 0;
+    CUDA_CHECK(cudaMemcpyAsync(&nNZ, offsets.get() + offsets.elements() - 1,
+                               sizeof(int), cudaMemcpyDeviceToHost,
+                               cuda::getActiveStream()));
+    CUDA_CHECK(cudaStreamSynchronize(cuda::getActiveStream()));
+    return nNZ;
 }
 
 template<typename T, af_storage stype>
 SparseArray<T> sparseConvertDenseToStorage(const Array<T> &in) {
-    const int M = in.dims()[0];
-    const int N = in.dims()[1];
-
-    // Create Sparse Matrix Descriptor
-    cusparseMatDescr_t descr = 0;
-    CUSPARSE_CHECK(cusparseCreateMatDescr(&descr));
-    cusparseSetMatType(descr, CUSPARSE_MATRIX_TYPE_GENERAL);
-    cusparseSetMatIndexBase(descr, CUSPARSE_INDEX_BASE_ZERO);
-
-    int d                   = -1;
-    cusparseDirection_t dir = CUSPARSE_DIRECTION_ROW;
+    // CSR is written by row. CSC and COO, which is column major, are written
+    // by column.
+    const bool byRow   = stype == AF_STORAGE_CSR;
+    Array<int> offsets = nnzOffsets(in, byRow);
+    const int nNZ      = readNNZ(offsets);
 
+    Array<T> values = createEmptyArray<T>(dim4(nNZ));
     if (stype == AF_STORAGE_CSR) {
-        d   = M;
-        dir = CUSPARSE_DIRECTION_ROW;
-    } else {
-        d   = N;
-        dir = CUSPARSE_DIRECTION_COLUMN;
+        Array<int> colIdx = createEmptyArray<int>(dim4(nNZ));
+        kernel::dense2csrRows<T>(values, colIdx, in, offsets);
+        return createArrayDataSparseArray<T>(in.dims(), values, offsets,
+                                             colIdx, stype);
     }
-    Array<int> nnzPerDir = createEmptyArray<int>(dim4(d));
 
-    int nNZ = -1;
-    CUSPARSE_CHECK(nnz_func<T>()(sparseHandle(), dir, M, N, descr, in.get(),
-                                 in.strides()[1], nnzPerDir.get(), &nNZ));
-
-    Array<int> rowIdx = createEmptyArray<int>(dim4());
-    Array<int> colIdx = createEmptyArray<int>(dim4());
-
-    if (stype == AF_STORAGE_CSR) {
-        rowIdx = createEmptyArray<int>(dim4(M + 1));
-        colIdx = createEmptyArray<int>(dim4(nNZ));
-    } else {
-        rowIdx = createEmptyArray<int>(dim4(nNZ));
-        colIdx = createEmptyArray<int>(dim4(N + 1));
+    Array<int> rowIdx = createEmptyArray<int>(dim4(nNZ));
+    if (stype == AF_STORAGE_CSC) {
+        kernel::dense2sparseCols<T, false>(values, rowIdx, rowIdx, in,
+                                           offsets);
+        return createArrayDataSparseArray<T>(in.dims(), values, rowIdx,
+                                             offsets, stype);
     }
-    Array<T> values = createEmptyArray<T>(dim4(nNZ));
-
-    if (stype == AF_STORAGE_CSR)
-        CUSPARSE_CHECK(dense2csr_func<T>()(
-            sparseHandle(), M, N, descr, in.get(), in.strides()[1],
-            nnzPerDir.get(), values.get(), rowIdx.get(), colIdx.get()));
-    else
-        CUSPARSE_CHECK(dense2csc_func<T>()(
-            sparseHandle(), M, N, descr, in.get(), in.strides()[1],
-            nnzPerDir.get(), values.get(), rowIdx.get(), colIdx.get()));
-
-    // Destory Sparse Matrix Descriptor
-    CUSPARSE_CHECK(cusparseDestroyMatDescr(descr));
 
+    Array<int> colIdx = createEmptyArray<int>(dim4(nNZ));
+    kernel::dense2sparseCols<T, true>(values, rowIdx, colIdx, in, offsets);
     return createArrayDataSparseArray<T>(in.dims(), values, rowIdx, colIdx,
                                          stype);
 }
@@ -402,22 +312,19 @@ SparseArray<T> sparseConvertStorageToStorage(const SparseArray<T> &in) {
     sparseConvertStorageToStorage<T, S, AF_STORAGE_COO>( \
         const SparseArray<T> &in);
 
-#define INSTANTIATE_COO_SPECIAL(T)                                 \
-    template<>                                                     \
-    SparseArray<T> sparseConvertDenseToStorage<T, AF_STORAGE_COO>( \
-        const Array<T> &in) {                                      \
-        return sparseConvertDenseToCOO<T>(in);                     \
-    }                                                              \
-    template<>                                                     \
-    Array<T> sparseConvertStorageToDense<T, AF_STORAGE_COO>(       \
-        const SparseArray<T> &in) {                                \
-        return sparseConvertCOOToDense<T>(in);                     \
+#define INSTANTIATE_COO_SPECIAL(T)                           \
+    template<>                                               \
+    Array<T> sparseConvertStorageToDense<T, AF_STORAGE_COO>( \
+        const SparseArray<T> &in) {                          \
+        return sparseConvertCOOToDense<T>(in);               \
     }
 
 #define INSTANTIATE_SPARSE(T)                                               \
     template SparseArray<T> sparseConvertDenseToStorage<T, AF_STORAGE_CSR>( \
         const Array<T> &in);                                                \
     template SparseArray<T> sparseConvertDenseToStorage<T, AF_STORAGE_CSC>( \
+        const Array<T> &in);                                                \
+    template SparseArray<T> sparseConvertDenseToStorage<T, AF_STORAGE_COO>( \
         const Array<T> &in);                                                \
                                                                             \
     template Array<T> sparseConvertStorageToDense<T, AF_STORAGE_CSR>(       \
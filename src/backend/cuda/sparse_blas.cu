@@ -9,17 +9,45 @@
 
 #include <sparse_blas.hpp>
 
+#include <common/SpgemmPattern.hpp>
+#include <common/complex.hpp>
 #include <common/err_common.hpp>
+#include <common/sparse_helpers.hpp>
+#include <common/sparse_triangular.hpp>
 #include <complex.hpp>
+#include <copy.hpp>
 #include <cudaDataType.hpp>
 #include <cuda_runtime.h>
 #include <cusparse.hpp>
 #include <cusparse_descriptor_helpers.hpp>
+#include <kernel/coomm.hpp>
+#include <kernel/csrsv.hpp>
+#include <kernel/sparse_blocked.hpp>
 #include <math.hpp>
+#include <memory.hpp>
 #include <platform.hpp>
 
+#include <map>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <tuple>
+#include <utility>
+
+#if defined(AF_USE_NEW_CUSPARSE_API) && CUDA_VERSION >= 11030
+// CUDA 11.3 or later, whose SpGEMMreuse routines split the product of sparse
+// matrices in a symbolic and a numeric phase, and whose SpSV routines split
+// the triangular solves in an analysis and a solve phase
+#define AF_USE_SPGEMM_REUSE
+#define AF_USE_SPSV
+DEFINE_HANDLER(cusparseSpGEMMDescr_t, cusparseSpGEMM_createDescr,
+               cusparseSpGEMM_destroyDescr);
+DEFINE_HANDLER(cusparseSpSVDescr_t, cusparseSpSV_createDescr,
+               cusparseSpSV_destroyDescr);
+#else
+DEFINE_HANDLER(csrgemm2Info_t, cusparseCreateCsrgemm2Info,
+               cusparseDestroyCsrgemm2Info);
+#endif
 
 namespace cuda {
 
@@ -126,13 +154,218 @@ SPARSE_FUNC(csrmv, cdouble, Z)
 
 #endif
 
+#if !defined(AF_USE_SPGEMM_REUSE)
+
+template<typename T>
+struct csrgemm2_bufferSizeExt_func_def_t {
+    typedef cusparseStatus_t (*csrgemm2_bufferSizeExt_func_def)(
+        cusparseHandle_t handle, int m, int n, int k, const T *alpha,
+        const cusparseMatDescr_t descrA, int nnzA, const int *csrRowPtrA,
+        const int *csrColIndA, const cusparseMatDescr_t descrB, int nnzB,
+        const int *csrRowPtrB, const int *csrColIndB, const T *beta,
+        const cusparseMatDescr_t descrD, int nnzD, const int *csrRowPtrD,
+        const int *csrColIndD, csrgemm2Info_t info, size_t *bufferSize);
+};
+
+template<typename T>
+struct csrgemm2_func_def_t {
+    typedef cusparseStatus_t (*csrgemm2_func_def)(
+        cusparseHandle_t handle, int m, int n, int k, const T *alpha,
+        const cusparseMatDescr_t descrA, int nnzA, const T *csrValA,
+        const int *csrRowPtrA, const int *csrColIndA,
+        const cusparseMatDescr_t descrB, int nnzB, const T *csrValB,
+        const int *csrRowPtrB, const int *csrColIndB, const T *beta,
+        const cusparseMatDescr_t descrD, int nnzD, const T *csrValD,
+        const int *csrRowPtrD, const int *csrColIndD,
+        const cusparseMatDescr_t descrC, T *csrValC, const int *csrRowPtrC,
+        int *csrColIndC, const csrgemm2Info_t info, void *buffer);
+};
+
+#define SPARSE_FUNC_DEF(FUNC) \
+    template<typename T>      \
+    typename FUNC##_func_def_t<T>::FUNC##_func_def FUNC##_func();
+
+#define SPARSE_FUNC(FUNC, TYPE, PREFIX)                                     \
+    template<>                                                              \
+    typename FUNC##_func_def_t<TYPE>::FUNC##_func_def FUNC##_func<TYPE>() { \
+        return (FUNC##_func_def_t<TYPE>::FUNC##_func_def) &                 \
+               cusparse##PREFIX##FUNC;                                      \
+    }
+
+SPARSE_FUNC_DEF(csrgemm2_bufferSizeExt)
+SPARSE_FUNC(csrgemm2_bufferSizeExt, float, S)
+SPARSE_FUNC(csrgemm2_bufferSizeExt, double, D)
+SPARSE_FUNC(csrgemm2_bufferSizeExt, cfloat, C)
+SPARSE_FUNC(csrgemm2_bufferSizeExt, cdouble, Z)
+
+SPARSE_FUNC_DEF(csrgemm2)
+SPARSE_FUNC(csrgemm2, float, S)
+SPARSE_FUNC(csrgemm2, double, D)
+SPARSE_FUNC(csrgemm2, cfloat, C)
+SPARSE_FUNC(csrgemm2, cdouble, Z)
+
+#undef SPARSE_FUNC
+#undef SPARSE_FUNC_DEF
+
+#endif
+
+/// The pattern of the product of a sparse array with another sparse array and
+/// the cuSPARSE state which computes the values of the product
+struct CusparseSpgemm {
+    std::shared_ptr<common::SpgemmPattern> pattern;
+#if defined(AF_USE_SPGEMM_REUSE)
+    common::unique_handle<cusparseSpGEMMDescr_t> descr;
+    common::unique_handle<cusparseSpMatDescr_t> matB;
+    common::unique_handle<cusparseSpMatDescr_t> matC;
+    uptr<char> buffer3;  ///< Only needed until the pattern is copied to C
+    uptr<char> buffer4;
+    uptr<char> buffer5;
+#else
+    common::unique_handle<csrgemm2Info_t> info;
+    uptr<char> buffer;
+#endif
+};
+
+#if defined(AF_USE_SPSV)
+/// The analysis of a triangle of a CSR matrix for SpSV. The descriptor of
+/// the matrix has the fill mode and the diagonal type of the triangle.
+struct CusparseSpsv {
+    common::unique_handle<cusparseSpMatDescr_t> mat;
+    common::unique_handle<cusparseSpSVDescr_t> descr;
+    uptr<char> buffer;
+};
+#endif
+
+/// The cuSPARSE descriptor of a CSR matrix and the workspace of its
+/// products, which are kept with the sparse array. The descriptor of a CSC
+/// matrix is the CSR descriptor of its transpose.
+class CusparseCache : public common::SparseArrayCache {
+   public:
+#if defined(AF_USE_NEW_CUSPARSE_API)
+    common::unique_handle<cusparseSpMatDescr_t> spMat;
+
+    /// The workspace sizes by operation, rhs operation and rhs columns
+    std::map<std::tuple<int, int, dim_t>, size_t> bufferSizes;
+    uptr<char> buffer;
+    size_t bufferBytes = 0;
+
+    /// Returns a workspace of at least \p bytes, which is reused by the
+    /// following products
+    void *workspace(size_t bytes) {
+        if (bytes > bufferBytes) {
+            buffer      = memAlloc<char>(bytes);
+            bufferBytes = bytes;
+        }
+        return buffer.get();
+    }
+#else
+    common::unique_handle<cusparseMatDescr_t> descr;
+#endif
+    std::shared_ptr<CusparseSpgemm> spgemm;  ///< The last sparse product
+
+#if defined(AF_USE_SPSV)
+    /// The analysis of the triangular solves by upper and unit diagonal
+    std::map<std::pair<bool, bool>, std::shared_ptr<CusparseSpsv>> spsv;
+
+    /// The analysis of SpSV may keep the values
+    void valuesChanged() override { spsv.clear(); }
+#else
+    /// The levels of the lower and the upper triangle
+    std::shared_ptr<common::TriangularLevels> levels[2];
+#endif
+};
+
+/// Returns the cuSPARSE data cached with \p in, which is created on the
+/// first product of the matrix
+template<typename T>
+std::shared_ptr<CusparseCache> cusparseCache(const common::SparseArray<T> &in) {
+    auto cache = std::dynamic_pointer_cast<CusparseCache>(in.getCache());
+    if (!cache) {
+        cache = std::make_shared<CusparseCache>();
+#if defined(AF_USE_NEW_CUSPARSE_API)
+        // The column offsets and the row indices of a CSC matrix are the CSR
+        // arrays of its transpose
+        const bool csc            = in.getStorage() == AF_STORAGE_CSC;
+        const dim4 dims           = in.dims();
+        const Array<int> &offsets = csc ? in.getColIdx() : in.getRowIdx();
+        const Array<int> &indices = csc ? in.getRowIdx() : in.getColIdx();
+        CUSPARSE_CHECK(static_cast<cusparseStatus_t>(cache->spMat.create(
+            dims[csc], dims[!csc], in.getNNZ(), (void *)(offsets.get()),
+            (void *)(indices.get()), (void *)(in.getValues().get()),
+            CUSPARSE_INDEX_32I, CUSPARSE_INDEX_32I, CUSPARSE_INDEX_BASE_ZERO,
+            getType<T>())));
+#else
+        CUSPARSE_CHECK(
+            static_cast<cusparseStatus_t>(cache->descr.create()));
+        CUSPARSE_CHECK(
+            cusparseSetMatType(cache->descr, CUSPARSE_MATRIX_TYPE_GENERAL));
+        CUSPARSE_CHECK(
+            cusparseSetMatIndexBase(cache->descr, CUSPARSE_INDEX_BASE_ZERO));
+#endif
+        in.setCache(cache);
+    }
+    return cache;
+}
+
+/// Multiplies the BSR or SELL array \p lhs with the dense array \p rhs.
+/// cuSPARSE's bsrmm needs operands padded to whole blocks and its sliced ELL
+/// has no row permutation, so both formats use their own kernels.
+template<typename T>
+Array<T> blockedMatmul(const common::SparseArray<T> &lhs,
+                       const Array<T> &rhs) {
+    Array<T> out =
+        createEmptyArray<T>(af::dim4(lhs.dims()[0], rhs.dims()[1]));
+    if (lhs.getStorage() == AF_STORAGE_BSR) {
+        kernel::bsrmm<T>(out, lhs.getValues(), lhs.getRowIdx(),
+                         lhs.getColIdx(), rhs, lhs.getBlockSize());
+    } else {
+        kernel::sellmm<T>(out, lhs.getValues(), lhs.getRowIdx(),
+                          lhs.getColIdx(), rhs, lhs.getBlockSize());
+    }
+    return out;
+}
+
+/// Multiplies the COO array \p lhs with the dense array \p rhs. The COO
+/// routines of cuSPARSE need the nonzeros sorted by row, which the COO
+/// arrays created from their indices are not, so they use their own kernel.
 template<typename T>
-Array<T> matmul(const common::SparseArray<T> &lhs, const Array<T> &rhs,
+Array<T> cooMatmul(const common::SparseArray<T> &lhs, const Array<T> &rhs,
+                   af_mat_prop optLhs) {
+    const int M = lhs.dims()[optLhs == AF_MAT_NONE ? 0 : 1];
+    Array<T> out =
+        createValueArray<T>(af::dim4(M, rhs.dims()[1]), scalar<T>(0));
+    out.eval();
+    kernel::coomm<T>(out, lhs.getValues(), lhs.getRowIdx(), lhs.getColIdx(),
+                     rhs, optLhs != AF_MAT_NONE, optLhs == AF_MAT_CTRANS);
+    return out;
+}
+
+template<typename T>
+Array<T> matmul(const common::SparseArray<T> &lhs, const Array<T> &rhsIn,
                 af_mat_prop optLhs, af_mat_prop optRhs) {
+    // The blocked formats only support AF_MAT_NONE
+    const af_storage storage = lhs.getStorage();
+    if (storage == AF_STORAGE_BSR || storage == AF_STORAGE_SELL) {
+        return blockedMatmul(lhs, rhsIn);
+    }
+    if (storage == AF_STORAGE_COO) { return cooMatmul(lhs, rhsIn, optLhs); }
+
+    // A CSC matrix is multiplied through the CSR descriptor of its transpose
+    // with the transposed operation. cuSPARSE does not conjugate without
+    // transposing, so conj(A^T) * rhs is computed as conj(A^T * conj(rhs)).
+    const bool csc        = storage == AF_STORAGE_CSC;
+    const bool conjugated =
+        csc && optLhs == AF_MAT_CTRANS && common::is_complex<T>::value;
+    af_mat_prop csrOpt    = optLhs;
+    if (csc) { csrOpt = (optLhs == AF_MAT_NONE) ? AF_MAT_TRANS : AF_MAT_NONE; }
+
+    Array<T> rhs = conjugated ? conj(rhsIn) : rhsIn;
+    rhs.eval();
+
     // Similar Operations to GEMM
-    cusparseOperation_t lOpts = toCusparseTranspose(optLhs);
+    cusparseOperation_t lOpts = toCusparseTranspose(csrOpt);
 
-    int lRowDim = (lOpts == CUSPARSE_OPERATION_NON_TRANSPOSE) ? 0 : 1;
+    int lRowDim = (optLhs == AF_MAT_NONE) ? 0 : 1;
     // int lColDim = (lOpts == CUSPARSE_OPERATION_NON_TRANSPOSE) ? 1 : 0;
     static const int rColDim = 1;  // Unsupported : (rOpts ==
                                    // CUSPARSE_OPERATION_NON_TRANSPOSE) ? 1 : 0;
@@ -151,63 +384,352 @@ Array<T> matmul(const common::SparseArray<T> &lhs, const Array<T> &rhs,
 
 #if defined(AF_USE_NEW_CUSPARSE_API)
 
-    auto spMat = csrMatDescriptor<T>(lhs);
+    auto cache  = cusparseCache(lhs);
+    auto &spMat = cache->spMat;
 
     if (rDims[rColDim] == 1) {
         auto dnVec = denVecDescriptor<T>(rhs);
         auto dnOut = denVecDescriptor<T>(out);
-        size_t bufferSize =
-            spmvBufferSize<T>(lOpts, &alpha, spMat, dnVec, &beta, dnOut);
-        auto tempBuffer = createEmptyArray<char>(dim4(bufferSize));
-        spmv<T>(lOpts, &alpha, spMat, dnVec, &beta, dnOut, tempBuffer.get());
+        auto key   = std::make_tuple(static_cast<int>(lOpts), -1, dim_t(1));
+        auto size  = cache->bufferSizes.find(key);
+        if (size == cache->bufferSizes.end()) {
+            size = cache->bufferSizes
+                       .emplace(key, spmvBufferSize<T>(lOpts, &alpha, spMat,
+                                                       dnVec, &beta, dnOut))
+                       .first;
+        }
+        spmv<T>(lOpts, &alpha, spMat, dnVec, &beta, dnOut,
+                cache->workspace(size->second));
     } else {
         cusparseOperation_t rOpts = toCusparseTranspose(optRhs);
 
         auto dnMat = denMatDescriptor<T>(rhs);
         auto dnOut = denMatDescriptor<T>(out);
-        size_t bufferSize =
-            spmmBufferSize<T>(lOpts, rOpts, &alpha, spMat, dnMat, &beta, dnOut);
-        auto tempBuffer = createEmptyArray<char>(dim4(bufferSize));
+        auto key   = std::make_tuple(static_cast<int>(lOpts),
+                                     static_cast<int>(rOpts), rDims[rColDim]);
+        auto size  = cache->bufferSizes.find(key);
+        if (size == cache->bufferSizes.end()) {
+            size = cache->bufferSizes
+                       .emplace(key,
+                                spmmBufferSize<T>(lOpts, rOpts, &alpha, spMat,
+                                                  dnMat, &beta, dnOut))
+                       .first;
+        }
         spmm<T>(lOpts, rOpts, &alpha, spMat, dnMat, &beta, dnOut,
-                tempBuffer.get());
+                cache->workspace(size->second));
     }
 
 #else
 
-    // Create Sparse Matrix Descriptor
-    cusparseMatDescr_t descr = 0;
-    CUSPARSE_CHECK(cusparseCreateMatDescr(&descr));
-    CUSPARSE_CHECK(cusparseSetMatType(descr, CUSPARSE_MATRIX_TYPE_GENERAL));
-    CUSPARSE_CHECK(cusparseSetMatIndexBase(descr, CUSPARSE_INDEX_BASE_ZERO));
+    auto cache                     = cusparseCache(lhs);
+    const cusparseMatDescr_t descr = cache->descr;
+
+    // The column offsets and the row indices of a CSC matrix are the CSR
+    // arrays of its transpose
+    const Array<int> &offsets = csc ? lhs.getColIdx() : lhs.getRowIdx();
+    const Array<int> &indices = csc ? lhs.getRowIdx() : lhs.getColIdx();
+    const int csrRows         = lDims[csc];
+    const int csrCols         = lDims[!csc];
 
     // Call Matrix-Vector or Matrix-Matrix
     // Note:
-    // Do not use M, N, K here. Use lDims and rDims instead.
+    // Do not use M, N, K here. Use csrRows and csrCols instead.
     // This is because the function wants row/col of A
     // and not OP(A) (gemm wants row/col of OP(A)).
     if (rDims[rColDim] == 1) {
         CUSPARSE_CHECK(csrmv_func<T>()(
-            sparseHandle(), lOpts, lDims[0], lDims[1], lhs.getNNZ(), &alpha,
-            descr, lhs.getValues().get(), lhs.getRowIdx().get(),
-            lhs.getColIdx().get(), rhs.get(), &beta, out.get()));
+            sparseHandle(), lOpts, csrRows, csrCols, lhs.getNNZ(), &alpha,
+            descr, lhs.getValues().get(), offsets.get(), indices.get(),
+            rhs.get(), &beta, out.get()));
     } else {
         CUSPARSE_CHECK(csrmm_func<T>()(
-            sparseHandle(), lOpts, lDims[0], rDims[rColDim], lDims[1],
-            lhs.getNNZ(), &alpha, descr, lhs.getValues().get(),
-            lhs.getRowIdx().get(), lhs.getColIdx().get(), rhs.get(),
-            rStrides[1], &beta, out.get(), out.dims()[0]));
+            sparseHandle(), lOpts, csrRows, rDims[rColDim], csrCols,
+            lhs.getNNZ(), &alpha, descr, lhs.getValues().get(), offsets.get(),
+            indices.get(), rhs.get(), rStrides[1], &beta, out.get(),
+            out.dims()[0]));
+    }
+#endif
+
+    return conjugated ? conj(out) : out;
+}
+
+#if defined(AF_USE_SPGEMM_REUSE)
+
+/// Runs the work estimation and the nnz steps of the symbolic phase of
+/// \p lhs * \p rhs. The pattern is copied to C once its values are allocated.
+template<typename T>
+std::shared_ptr<CusparseSpgemm> spgemmNnz(const common::SparseArray<T> &lhs,
+                                          const common::SparseArray<T> &rhs,
+                                          const cusparseSpMatDescr_t matA) {
+    const cusparseOperation_t op  = CUSPARSE_OPERATION_NON_TRANSPOSE;
+    const cusparseSpGEMMAlg_t alg = CUSPARSE_SPGEMM_DEFAULT;
+    const dim4 lDims              = lhs.dims();
+    const dim4 rDims              = rhs.dims();
+
+    auto spgemm       = std::make_shared<CusparseSpgemm>();
+    Array<int> rowIdx = createEmptyArray<int>(dim4(lDims[0] + 1));
+
+    CUSPARSE_CHECK(static_cast<cusparseStatus_t>(spgemm->descr.create()));
+    CUSPARSE_CHECK(static_cast<cusparseStatus_t>(spgemm->matB.create(
+        rDims[0], rDims[1], rhs.getNNZ(), (void *)(rhs.getRowIdx().get()),
+        (void *)(rhs.getColIdx().get()), (void *)(rhs.getValues().get()),
+        CUSPARSE_INDEX_32I, CUSPARSE_INDEX_32I, CUSPARSE_INDEX_BASE_ZERO,
+        getType<T>())));
+    CUSPARSE_CHECK(static_cast<cusparseStatus_t>(spgemm->matC.create(
+        lDims[0], rDims[1], 0, (void *)(rowIdx.get()), nullptr, nullptr,
+        CUSPARSE_INDEX_32I, CUSPARSE_INDEX_32I, CUSPARSE_INDEX_BASE_ZERO,
+        getType<T>())));
+
+    size_t bytes1 = 0;
+    CUSPARSE_CHECK(cusparseSpGEMMreuse_workEstimation(
+        sparseHandle(), op, op, matA, spgemm->matB, spgemm->matC, alg,
+        spgemm->descr, &bytes1, nullptr));
+    auto buffer1 = memAlloc<char>(bytes1);
+    CUSPARSE_CHECK(cusparseSpGEMMreuse_workEstimation(
+        sparseHandle(), op, op, matA, spgemm->matB, spgemm->matC, alg,
+        spgemm->descr, &bytes1, buffer1.get()));
+
+    size_t bytes2 = 0, bytes3 = 0, bytes4 = 0;
+    CUSPARSE_CHECK(cusparseSpGEMMreuse_nnz(
+        sparseHandle(), op, op, matA, spgemm->matB, spgemm->matC, alg,
+        spgemm->descr, &bytes2, nullptr, &bytes3, nullptr, &bytes4, nullptr));
+    auto buffer2    = memAlloc<char>(bytes2);
+    spgemm->buffer3 = memAlloc<char>(bytes3);
+    spgemm->buffer4 = memAlloc<char>(bytes4);
+    CUSPARSE_CHECK(cusparseSpGEMMreuse_nnz(
+        sparseHandle(), op, op, matA, spgemm->matB, spgemm->matC, alg,
+        spgemm->descr, &bytes2, buffer2.get(), &bytes3, spgemm->buffer3.get(),
+        &bytes4, spgemm->buffer4.get()));
+
+    int64_t rows = 0, cols = 0, nnz = 0;
+    CUSPARSE_CHECK(cusparseSpMatGetSize(spgemm->matC, &rows, &cols, &nnz));
+
+    Array<int> colIdx = createEmptyArray<int>(dim4(nnz));
+    spgemm->pattern =
+        std::make_shared<common::SpgemmPattern>(rhs, rowIdx, colIdx);
+    return spgemm;
+}
+
+template<typename T>
+common::SparseArray<T> matmul(const common::SparseArray<T> &lhs,
+                              const common::SparseArray<T> &rhs) {
+    const cusparseOperation_t op  = CUSPARSE_OPERATION_NON_TRANSPOSE;
+    const cusparseSpGEMMAlg_t alg = CUSPARSE_SPGEMM_DEFAULT;
+    T alpha                       = scalar<T>(1);
+    T beta                        = scalar<T>(0);
+
+    auto cache  = cusparseCache(lhs);
+    auto spgemm = cache->spgemm;
+
+    const bool symbolic = !spgemm || !spgemm->pattern->matches(rhs);
+    if (symbolic) { spgemm = spgemmNnz(lhs, rhs, cache->spMat); }
+
+    const common::SpgemmPattern &pattern = *spgemm->pattern;
+    Array<T> values = createEmptyArray<T>(dim4(pattern.getNNZ()));
+
+    // The descriptors are reused with the values of this product
+    CUSPARSE_CHECK(cusparseCsrSetPointers(
+        spgemm->matB, (void *)(rhs.getRowIdx().get()),
+        (void *)(rhs.getColIdx().get()), (void *)(rhs.getValues().get())));
+    CUSPARSE_CHECK(cusparseCsrSetPointers(
+        spgemm->matC, (void *)(pattern.rowIdx.get()),
+        (void *)(pattern.colIdx.get()), (void *)(values.get())));
+
+    if (symbolic) {
+        size_t bytes5 = 0;
+        CUSPARSE_CHECK(cusparseSpGEMMreuse_copy(
+            sparseHandle(), op, op, cache->spMat, spgemm->matB, spgemm->matC,
+            alg, spgemm->descr, &bytes5, nullptr));
+        spgemm->buffer5 = memAlloc<char>(bytes5);
+        CUSPARSE_CHECK(cusparseSpGEMMreuse_copy(
+            sparseHandle(), op, op, cache->spMat, spgemm->matB, spgemm->matC,
+            alg, spgemm->descr, &bytes5, spgemm->buffer5.get()));
+        spgemm->buffer3.reset();
+        cache->spgemm = spgemm;
     }
-    CUSPARSE_CHECK(cusparseDestroyMatDescr(descr));
+
+    CUSPARSE_CHECK(cusparseSpGEMMreuse_compute(
+        sparseHandle(), op, op, &alpha, cache->spMat, spgemm->matB, &beta,
+        spgemm->matC, getComputeType<T>(), alg, spgemm->descr));
+
+    return common::createArrayDataSparseArray<T>(
+        dim4(lhs.dims()[0], rhs.dims()[1]), values, pattern.rowIdx,
+        pattern.colIdx, AF_STORAGE_CSR);
+}
+
+#else
+
+template<typename T>
+common::SparseArray<T> matmul(const common::SparseArray<T> &lhs,
+                              const common::SparseArray<T> &rhs) {
+    const int M = lhs.dims()[0];
+    const int N = rhs.dims()[1];
+    const int K = lhs.dims()[1];
+    T alpha     = scalar<T>(1);
+
+    const int nnzA     = lhs.getNNZ();
+    const int nnzB     = rhs.getNNZ();
+    const int *lRowIdx = lhs.getRowIdx().get();
+    const int *lColIdx = lhs.getColIdx().get();
+    const int *rRowIdx = rhs.getRowIdx().get();
+    const int *rColIdx = rhs.getColIdx().get();
+
+    auto descr  = common::make_handle<cusparseMatDescr_t>();
+    auto cache  = cusparseCache(lhs);
+    auto spgemm = cache->spgemm;
+
+    if (!spgemm || !spgemm->pattern->matches(rhs)) {
+        spgemm = std::make_shared<CusparseSpgemm>();
+        CUSPARSE_CHECK(static_cast<cusparseStatus_t>(spgemm->info.create()));
+
+        // C = alpha * A * B without the D term
+        size_t bytes = 0;
+        CUSPARSE_CHECK(csrgemm2_bufferSizeExt_func<T>()(
+            sparseHandle(), M, N, K, &alpha, descr, nnzA, lRowIdx, lColIdx,
+            descr, nnzB, rRowIdx, rColIdx, nullptr, descr, 0, nullptr,
+            nullptr, spgemm->info, &bytes));
+        spgemm->buffer = memAlloc<char>(bytes);
+
+        Array<int> rowIdx = createEmptyArray<int>(dim4(M + 1));
+        int nnz           = 0;
+        CUSPARSE_CHECK(cusparseXcsrgemm2Nnz(
+            sparseHandle(), M, N, K, descr, nnzA, lRowIdx, lColIdx, descr,
+            nnzB, rRowIdx, rColIdx, descr, 0, nullptr, nullptr, descr,
+            rowIdx.get(), &nnz, spgemm->info, spgemm->buffer.get()));
+
+        Array<int> colIdx = createEmptyArray<int>(dim4(nnz));
+        spgemm->pattern =
+            std::make_shared<common::SpgemmPattern>(rhs, rowIdx, colIdx);
+        cache->spgemm = spgemm;
+    }
+
+    // csrgemm2 writes the column indices of the pattern again, which leaves
+    // them unchanged
+    const common::SpgemmPattern &pattern = *spgemm->pattern;
+    Array<T> values = createEmptyArray<T>(dim4(pattern.getNNZ()));
+    CUSPARSE_CHECK(csrgemm2_func<T>()(
+        sparseHandle(), M, N, K, &alpha, descr, nnzA, lhs.getValues().get(),
+        lRowIdx, lColIdx, descr, nnzB, rhs.getValues().get(), rRowIdx,
+        rColIdx, nullptr, descr, 0, nullptr, nullptr, nullptr, descr,
+        values.get(), pattern.rowIdx.get(),
+        const_cast<int *>(pattern.colIdx.get()), spgemm->info,
+        spgemm->buffer.get()));
+
+    return common::createArrayDataSparseArray<T>(
+        dim4(M, N), values, pattern.rowIdx, pattern.colIdx, AF_STORAGE_CSR);
+}
 
 #endif
 
+#if defined(AF_USE_SPSV)
+
+/// Returns the SpSV analysis of a triangle of \p lhs, which is cached with
+/// \p lhs
+template<typename T>
+std::shared_ptr<CusparseSpsv> spsvAnalysis(const common::SparseArray<T> &lhs,
+                                           const Array<T> &rhs,
+                                           const Array<T> &out,
+                                           const bool upper, const bool unit) {
+    auto cache = cusparseCache(lhs);
+    auto &spsv = cache->spsv[std::make_pair(upper, unit)];
+    if (spsv) { return spsv; }
+
+    T alpha         = scalar<T>(1);
+    const dim4 dims = lhs.dims();
+    auto analysis   = std::make_shared<CusparseSpsv>();
+    CUSPARSE_CHECK(static_cast<cusparseStatus_t>(analysis->mat.create(
+        dims[0], dims[1], lhs.getNNZ(), (void *)(lhs.getRowIdx().get()),
+        (void *)(lhs.getColIdx().get()), (void *)(lhs.getValues().get()),
+        CUSPARSE_INDEX_32I, CUSPARSE_INDEX_32I, CUSPARSE_INDEX_BASE_ZERO,
+        getType<T>())));
+
+    cusparseFillMode_t fill =
+        upper ? CUSPARSE_FILL_MODE_UPPER : CUSPARSE_FILL_MODE_LOWER;
+    cusparseDiagType_t diag =
+        unit ? CUSPARSE_DIAG_TYPE_UNIT : CUSPARSE_DIAG_TYPE_NON_UNIT;
+    CUSPARSE_CHECK(cusparseSpMatSetAttribute(
+        analysis->mat, CUSPARSE_SPMAT_FILL_MODE, &fill, sizeof(fill)));
+    CUSPARSE_CHECK(cusparseSpMatSetAttribute(
+        analysis->mat, CUSPARSE_SPMAT_DIAG_TYPE, &diag, sizeof(diag)));
+    CUSPARSE_CHECK(static_cast<cusparseStatus_t>(analysis->descr.create()));
+
+    // The analysis does not depend on the vectors
+    auto vecX = common::make_handle<cusparseDnVecDescr_t>(
+        dims[0], (void *)(rhs.get()), getType<T>());
+    auto vecY = common::make_handle<cusparseDnVecDescr_t>(
+        dims[0], (void *)(out.get()), getType<T>());
+
+    size_t bytes = 0;
+    CUSPARSE_CHECK(cusparseSpSV_bufferSize(
+        sparseHandle(), CUSPARSE_OPERATION_NON_TRANSPOSE, &alpha,
+        analysis->mat, vecX, vecY, getComputeType<T>(),
+        CUSPARSE_SPSV_ALG_DEFAULT, analysis->descr, &bytes));
+    analysis->buffer = memAlloc<char>(bytes);
+    CUSPARSE_CHECK(cusparseSpSV_analysis(
+        sparseHandle(), CUSPARSE_OPERATION_NON_TRANSPOSE, &alpha,
+        analysis->mat, vecX, vecY, getComputeType<T>(),
+        CUSPARSE_SPSV_ALG_DEFAULT, analysis->descr, analysis->buffer.get()));
+
+    spsv = analysis;
+    return spsv;
+}
+
+template<typename T>
+Array<T> solve(const common::SparseArray<T> &lhs, const Array<T> &rhs,
+               const af_mat_prop options) {
+    const bool upper = options & AF_MAT_UPPER;
+    const bool unit  = options & AF_MAT_DIAG_UNIT;
+    const dim4 dims  = rhs.dims();
+    T alpha          = scalar<T>(1);
+
+    Array<T> out = createEmptyArray<T>(dims);
+    auto spsv    = spsvAnalysis(lhs, rhs, out, upper, unit);
+
+    for (dim_t o = 0; o < dims[1]; ++o) {
+        auto vecX = common::make_handle<cusparseDnVecDescr_t>(
+            dims[0], (void *)(rhs.get() + o * rhs.strides()[1]),
+            getType<T>());
+        auto vecY = common::make_handle<cusparseDnVecDescr_t>(
+            dims[0], (void *)(out.get() + o * out.strides()[1]),
+            getType<T>());
+        CUSPARSE_CHECK(cusparseSpSV_solve(
+            sparseHandle(), CUSPARSE_OPERATION_NON_TRANSPOSE, &alpha,
+            spsv->mat, vecX, vecY, getComputeType<T>(),
+            CUSPARSE_SPSV_ALG_DEFAULT, spsv->descr));
+    }
+    return out;
+}
+
+#else
+
+// The triangular solves of cuSPARSE before SpSV are deprecated, so the rows
+// of each level of the triangle are solved by a kernel
+template<typename T>
+Array<T> solve(const common::SparseArray<T> &lhs, const Array<T> &rhs,
+               const af_mat_prop options) {
+    const bool upper = options & AF_MAT_UPPER;
+    const bool unit  = options & AF_MAT_DIAG_UNIT;
+
+    auto cache   = cusparseCache(lhs);
+    auto &levels = cache->levels[upper];
+    if (!levels) { levels = common::triangularLevels(lhs, upper); }
+
+    Array<T> out = copyArray<T>(rhs);
+    kernel::csrsv<T>(out, lhs.getValues(), lhs.getRowIdx(), lhs.getColIdx(),
+                     *levels, upper, unit);
     return out;
 }
 
-#define INSTANTIATE_SPARSE(T)                                            \
-    template Array<T> matmul<T>(const common::SparseArray<T> &lhs,       \
-                                const Array<T> &rhs, af_mat_prop optLhs, \
-                                af_mat_prop optRhs);
+#endif
+
+#define INSTANTIATE_SPARSE(T)                                                \
+    template Array<T> matmul<T>(const common::SparseArray<T> &lhs,           \
+                                const Array<T> &rhs, af_mat_prop optLhs,     \
+                                af_mat_prop optRhs);                         \
+    template common::SparseArray<T> matmul<T>(const common::SparseArray<T> &, \
+                                              const common::SparseArray<T> &); \
+    template Array<T> solve<T>(const common::SparseArray<T> &lhs,            \
+                               const Array<T> &rhs, const af_mat_prop options);
 
 INSTANTIATE_SPARSE(float)
 INSTANTIATE_SPARSE(double)
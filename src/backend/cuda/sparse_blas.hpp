@@ -16,4 +16,20 @@ template<typename T>
 Array<T> matmul(const common::SparseArray<T>& lhs, const Array<T>& rhs,
                 af_mat_prop optLhs, af_mat_prop optRhs);
 
+/// The product of two CSR arrays. The pattern of the product is cached with
+/// \p lhs, so products with right hand sides of the same pattern only compute
+/// the values.
+template<typename T>
+common::SparseArray<T> matmul(const common::SparseArray<T>& lhs,
+                              const common::SparseArray<T>& rhs);
+
+/// Solves the lower or the upper triangle of the CSR array \p lhs, as given
+/// by AF_MAT_LOWER or AF_MAT_UPPER in \p options, for the columns of
+/// \p rhs. The entries of the other triangle are ignored, and so is the
+/// diagonal with AF_MAT_DIAG_UNIT. The analysis of the triangle is cached
+/// with \p lhs.
+template<typename T>
+Array<T> solve(const common::SparseArray<T>& lhs, const Array<T>& rhs,
+               const af_mat_prop options);
+
 }
@@ -8,8 +8,10 @@
  ********************************************************/
 
 #include "reduce_impl.hpp"
+#include <common/bfloat16.hpp>
 #include <common/half.hpp>
 
+using common::bfloat16;
 using common::half;
 
 namespace cuda {
@@ -36,5 +38,6 @@ INSTANTIATE(af_add_t, ushort, uint)
 INSTANTIATE(af_add_t, ushort, float)
 INSTANTIATE(af_add_t, half, half)
 INSTANTIATE(af_add_t, half, float)
+INSTANTIATE(af_add_t, bfloat16, float)
 
 }  // namespace cuda
@@ -9,35 +9,58 @@
 
 #include <Array.hpp>
 #include <GraphicsResourceManager.hpp>
+#include <common/graphics_vertices.hpp>
 #include <debug_cuda.hpp>
 #include <device_manager.hpp>
 #include <err_cuda.hpp>
+#include <kernel/interleave.hpp>
 #include <surface.hpp>
 
+#include <memory>
+#include <vector>
+
 using af::dim4;
+using common::surfaceComponent;
+using common::VertexComponent;
+using std::shared_ptr;
+using std::vector;
 
 namespace cuda {
 
 template<typename T>
-void copy_surface(const Array<T> &P, fg_surface surface) {
-    auto stream = cuda::getActiveStream();
+void copy_surface(const Array<T> &x, const Array<T> &y, const Array<T> &z,
+                  fg_surface surface) {
+    const dim_t vertices = z.elements();
+    const VertexComponent xc =
+        surfaceComponent(vertices, x.dims(), x.strides(), 0);
+    const VertexComponent yc =
+        surfaceComponent(vertices, y.dims(), y.strides(), 1);
+    vector<CParam<T>> params = {
+        CParam<T>(x.get(), xc.dims.get(), xc.strides.get()),
+        CParam<T>(y.get(), yc.dims.get(), yc.strides.get()), z};
+    vector<shared_ptr<const void>> inputs = {x.getData(), y.getData(),
+                                             z.getData()};
+    GraphicsResourceManager &interop      = interopManager();
+    cudaStream_t stream                   = interop.beginCopy();
     if (DeviceManager::checkGraphicsInteropCapability()) {
-        const T *d_P = P.get();
-
-        auto res = interopManager().getSurfaceResources(surface);
+        auto res = interop.getSurfaceResources(surface);
 
         size_t bytes = 0;
         T *d_vbo     = NULL;
         cudaGraphicsMapResources(1, res[0].get(), stream);
         cudaGraphicsResourceGetMappedPointer((void **)&d_vbo, &bytes,
                                              *(res[0].get()));
-        cudaMemcpyAsync(d_vbo, d_P, bytes, cudaMemcpyDeviceToDevice, stream);
+        kernel::interleave(d_vbo, params, stream);
         cudaGraphicsUnmapResources(1, res[0].get(), stream);
 
         CheckGL("After cuda resource copy");
 
         POST_LAUNCH_CHECK();
     } else {
+        Array<T> P = createEmptyArray<T>(dim4(3 * vertices));
+        kernel::interleave(P.get(), params, stream);
+        inputs.push_back(P.getData());
+
         ForgeModule &_ = graphics::forgePlugin();
         unsigned bytes = 0, buffer = 0;
         FG_CHECK(_.fg_get_surface_vertex_buffer(&buffer, surface));
@@ -56,10 +79,12 @@ void copy_surface(const Array<T> &P, fg_surface surface) {
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         CheckGL("End CUDA fallback-resource copy");
     }
+    interop.endCopy(inputs);
 }
 
-#define INSTANTIATE(T) \
-    template void copy_surface<T>(const Array<T> &, fg_surface);
+#define INSTANTIATE(T)                                                \
+    template void copy_surface<T>(const Array<T> &, const Array<T> &, \
+                                  const Array<T> &, fg_surface);
 
 INSTANTIATE(float)
 INSTANTIATE(double)
@@ -18,6 +18,11 @@
 #include "transpose.hpp"
 
 #include <cusolverDn.hpp>
+#include <af/seq.h>
+
+#include <vector>
+
+using std::vector;
 
 namespace cuda {
 template<typename T>
@@ -65,6 +70,56 @@ SVD_SPECIALIZE(double, double, D);
 SVD_SPECIALIZE(cfloat, float, C);
 SVD_SPECIALIZE(cdouble, double, Z);
 
+#undef SVD_SPECIALIZE
+
+template<typename T, typename Tr>
+cusolverStatus_t gesvdj_batched_buf_func(
+    cusolverDnHandle_t /*handle*/, cusolverEigMode_t /*jobz*/, int /*m*/,
+    int /*n*/, const T * /*A*/, int /*lda*/, const Tr * /*S*/, const T * /*U*/,
+    int /*ldu*/, const T * /*V*/, int /*ldv*/, int * /*lwork*/,
+    gesvdjInfo_t /*params*/, int /*batchSize*/) {
+    return CUSOLVER_STATUS_ARCH_MISMATCH;
+}
+
+template<typename T, typename Tr>
+cusolverStatus_t gesvdj_batched_func(
+    cusolverDnHandle_t /*handle*/, cusolverEigMode_t /*jobz*/, int /*m*/,
+    int /*n*/, T * /*A*/, int /*lda*/, Tr * /*S*/, T * /*U*/, int /*ldu*/,
+    T * /*V*/, int /*ldv*/, T * /*work*/, int /*lwork*/, int * /*info*/,
+    gesvdjInfo_t /*params*/, int /*batchSize*/) {
+    return CUSOLVER_STATUS_ARCH_MISMATCH;
+}
+
+#define SVD_SPECIALIZE(T, Tr, X)                                              \
+    template<>                                                                \
+    cusolverStatus_t gesvdj_batched_buf_func<T, Tr>(                          \
+        cusolverDnHandle_t handle, cusolverEigMode_t jobz, int m, int n,      \
+        const T *A, int lda, const Tr *S, const T *U, int ldu, const T *V,    \
+        int ldv, int *lwork, gesvdjInfo_t params, int batchSize) {            \
+        return cusolverDn##X##gesvdjBatched_bufferSize(                       \
+            handle, jobz, m, n, A, lda, S, U, ldu, V, ldv, lwork, params,     \
+            batchSize);                                                       \
+    }                                                                         \
+    template<>                                                                \
+    cusolverStatus_t gesvdj_batched_func<T, Tr>(                              \
+        cusolverDnHandle_t handle, cusolverEigMode_t jobz, int m, int n, T *A, \
+        int lda, Tr *S, T *U, int ldu, T *V, int ldv, T *work, int lwork,     \
+        int *info, gesvdjInfo_t params, int batchSize) {                      \
+        return cusolverDn##X##gesvdjBatched(handle, jobz, m, n, A, lda, S, U, \
+                                            ldu, V, ldv, work, lwork, info,   \
+                                            params, batchSize);               \
+    }
+
+SVD_SPECIALIZE(float, float, S);
+SVD_SPECIALIZE(double, double, D);
+SVD_SPECIALIZE(cfloat, float, C);
+SVD_SPECIALIZE(cdouble, double, Z);
+
+#undef SVD_SPECIALIZE
+
+/// The largest matrices of the Jacobi SVD of gesvdjBatched
+constexpr int SVD_BATCHED_MAX_DIM = 32;
+
 template<typename T, typename Tr>
 void svdInPlace(Array<Tr> &s, Array<T> &u, Array<T> &vt, Array<T> &in) {
     dim4 iDims = in.dims();
@@ -102,11 +157,60 @@ void svd(Array<Tr> &s, Array<T> &u, Array<T> &vt, const Array<T> &in) {
     }
 }
 
+template<typename T, typename Tr>
+void svdBatched(Array<Tr> &s, Array<T> &u, Array<T> &vt, const Array<T> &in) {
+    dim4 iDims = in.dims();
+    int M      = iDims[0];
+    int N      = iDims[1];
+    int batch  = iDims[2] * iDims[3];
+
+    if (M > SVD_BATCHED_MAX_DIM || N > SVD_BATCHED_MAX_DIM) {
+        // The matrices are too large for the Jacobi SVD of gesvdjBatched
+        for (dim_t j = 0; j < iDims[3]; ++j) {
+            for (dim_t i = 0; i < iDims[2]; ++i) {
+                const vector<af_seq> slice = {
+                    af_span, af_span,
+                    {static_cast<double>(i), static_cast<double>(i), 1.},
+                    {static_cast<double>(j), static_cast<double>(j), 1.}};
+                Array<Tr> sSlice = createSubArray(s, slice, false);
+                Array<T> uSlice  = createSubArray(u, slice, false);
+                Array<T> vtSlice = createSubArray(vt, slice, false);
+                svd<T, Tr>(sSlice, uSlice, vtSlice,
+                           createSubArray(in, slice, false));
+            }
+        }
+        return;
+    }
+
+    Array<T> in_copy = copyArray(in);
+    Array<T> v       = createEmptyArray<T>(dim4(N, N, iDims[2], iDims[3]));
+
+    auto params = common::make_handle<gesvdjInfo_t>();
+
+    int lwork = 0;
+    CUSOLVER_CHECK(gesvdj_batched_buf_func<T, Tr>(
+        solverDnHandle(), CUSOLVER_EIG_MODE_VECTOR, M, N, in_copy.get(), M,
+        s.get(), u.get(), M, v.get(), N, &lwork, params, batch));
+
+    auto workspace = memAlloc<T>(lwork);
+    auto info      = memAlloc<int>(batch);
+
+    CUSOLVER_CHECK(gesvdj_batched_func<T, Tr>(
+        solverDnHandle(), CUSOLVER_EIG_MODE_VECTOR, M, N, in_copy.get(), M,
+        s.get(), u.get(), M, v.get(), N, workspace.get(), lwork, info.get(),
+        params, batch));
+
+    // gesvdjBatched returns V instead of V^H
+    vt = transpose(v, true);
+}
+
 #define INSTANTIATE(T, Tr)                                               \
     template void svd<T, Tr>(Array<Tr> & s, Array<T> & u, Array<T> & vt, \
                              const Array<T> &in);                        \
     template void svdInPlace<T, Tr>(Array<Tr> & s, Array<T> & u,         \
-                                    Array<T> & vt, Array<T> & in);
+                                    Array<T> & vt, Array<T> & in);       \
+    template void svdBatched<T, Tr>(Array<Tr> & s, Array<T> & u,         \
+                                    Array<T> & vt, const Array<T> &in);
 
 INSTANTIATE(float, float)
 INSTANTIATE(double, double)
@@ -11,14 +11,23 @@
 
 #include <Array.hpp>
 #include <common/half.hpp>
+#include <common/jit/TileNodeBase.hpp>
 #include <err_cuda.hpp>
-#include <kernel/tile.hpp>
+#include <jit/BufferNode.hpp>
 
-#include <stdexcept>
+#include <memory>
 
 using common::half;
+using common::Node_ptr;
+using common::TileNodeBase;
+using cuda::jit::BufferNode;
+using std::make_shared;
+using std::static_pointer_cast;
 
 namespace cuda {
+template<typename T>
+using TileNode = TileNodeBase<BufferNode<T>>;
+
 template<typename T>
 Array<T> tile(const Array<T> &in, const af::dim4 &tileDims) {
     const af::dim4 &iDims = in.dims();
@@ -29,11 +38,22 @@ Array<T> tile(const Array<T> &in, const af::dim4 &tileDims) {
         AF_ERROR("Elements are 0", AF_ERR_SIZE);
     }
 
-    Array<T> out = createEmptyArray<T>(oDims);
+    // The tiled array is read through a node of the JIT tree, so it is
+    // fused into the expression which uses it instead of being copied.
+    // Force input to be evaluated so that in is always a buffer.
+    in.eval();
 
-    kernel::tile<T>(out, in);
+    // The buffer is broadcast if it is only repeated along the dimensions
+    // of size one
+    bool broadcast = true;
+    for (int i = 0; i < AF_MAX_DIMS; i++) {
+        broadcast &= tileDims[i] == 1 || iDims[i] == 1;
+    }
 
-    return out;
+    auto node = make_shared<TileNode<T>>(
+        static_cast<af::dtype>(af::dtype_traits<T>::af_type),
+        static_pointer_cast<BufferNode<T>>(in.getNode()), broadcast);
+    return createNodeArray<T>(oDims, Node_ptr(node));
 }
 
 #define INSTANTIATE(T) \
@@ -14,6 +14,7 @@
 #include <cuda_fp16.h>
 
 namespace common {
+class bfloat16;
 class half;
 }
 
@@ -102,6 +103,10 @@ template<>
 inline const char *shortname<common::half>(bool caps) {
     return caps ? "H" : "h";
 }
+template<>
+inline const char *shortname<common::bfloat16>(bool caps) {
+    return caps ? "B" : "b";
+}
 
 template<typename T>
 inline const char *getFullName();
@@ -129,6 +134,13 @@ template<>
 inline const char *getFullName<common::half>() {
     return "half";
 }
+
+// The bfloat16 values are stored as unsigned short in the JIT kernels, and
+// the casts convert them to and from float
+template<>
+inline const char *getFullName<common::bfloat16>() {
+    return "unsigned short";
+}
 #undef SPECIALIZE
 }  // namespace
 #endif  //__CUDACC_RTC__
@@ -169,4 +181,11 @@ struct kernel_type<common::half> {
 
 #endif  // __CUDA_ARCH__
 };
+
+template<>
+struct kernel_type<common::bfloat16> {
+    using data    = common::bfloat16;
+    using compute = float;
+    using native  = float;
+};
 }  // namespace common
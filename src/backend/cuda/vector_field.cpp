@@ -12,41 +12,52 @@
 #include <debug_cuda.hpp>
 #include <device_manager.hpp>
 #include <err_cuda.hpp>
+#include <kernel/interleave.hpp>
 #include <vector_field.hpp>
 
+#include <memory>
+#include <vector>
+
 using af::dim4;
+using std::shared_ptr;
+using std::vector;
 
 namespace cuda {
 
 template<typename T>
-void copy_vector_field(const Array<T> &points, const Array<T> &directions,
+void copy_vector_field(const vector<Array<T>> &points,
+                       const vector<Array<T>> &directions,
                        fg_vector_field vfield) {
-    auto stream = cuda::getActiveStream();
+    vector<CParam<T>> pParams(points.begin(), points.end());
+    vector<CParam<T>> dParams(directions.begin(), directions.end());
+    vector<shared_ptr<const void>> inputs;
+    for (size_t i = 0; i < points.size(); ++i) {
+        inputs.push_back(points[i].getData());
+        inputs.push_back(directions[i].getData());
+    }
+    GraphicsResourceManager &interop = interopManager();
+    cudaStream_t stream              = interop.beginCopy();
     if (DeviceManager::checkGraphicsInteropCapability()) {
-        auto res = interopManager().getVectorFieldResources(vfield);
+        auto res = interop.getVectorFieldResources(vfield);
         cudaGraphicsResource_t resources[2] = {*res[0].get(), *res[1].get()};
 
         cudaGraphicsMapResources(2, resources, stream);
 
         // Points
         {
-            const T *ptr = points.get();
             size_t bytes = 0;
             T *d_vbo     = NULL;
             cudaGraphicsResourceGetMappedPointer((void **)&d_vbo, &bytes,
                                                  resources[0]);
-            cudaMemcpyAsync(d_vbo, ptr, bytes, cudaMemcpyDeviceToDevice,
-                            stream);
+            kernel::interleave(d_vbo, pParams, stream);
         }
         // Directions
         {
-            const T *ptr = directions.get();
             size_t bytes = 0;
             T *d_vbo     = NULL;
             cudaGraphicsResourceGetMappedPointer((void **)&d_vbo, &bytes,
                                                  resources[1]);
-            cudaMemcpyAsync(d_vbo, ptr, bytes, cudaMemcpyDeviceToDevice,
-                            stream);
+            kernel::interleave(d_vbo, dParams, stream);
         }
         cudaGraphicsUnmapResources(2, resources, stream);
 
@@ -54,6 +65,14 @@ void copy_vector_field(const Array<T> &points, const Array<T> &directions,
 
         POST_LAUNCH_CHECK();
     } else {
+        const dim4 vdims(pParams.size() * points[0].elements());
+        Array<T> pVertices = createEmptyArray<T>(vdims);
+        Array<T> dVertices = createEmptyArray<T>(vdims);
+        kernel::interleave(pVertices.get(), pParams, stream);
+        kernel::interleave(dVertices.get(), dParams, stream);
+        inputs.push_back(pVertices.getData());
+        inputs.push_back(dVertices.getData());
+
         ForgeModule &_ = graphics::forgePlugin();
         CheckGL("Begin CUDA fallback-resource copy");
         unsigned size1 = 0, size2 = 0;
@@ -68,7 +87,7 @@ void copy_vector_field(const Array<T> &points, const Array<T> &directions,
         auto *ptr =
             static_cast<GLubyte *>(glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY));
         if (ptr) {
-            CUDA_CHECK(cudaMemcpyAsync(ptr, points.get(), size1,
+            CUDA_CHECK(cudaMemcpyAsync(ptr, pVertices.get(), size1,
                                        cudaMemcpyDeviceToHost, stream));
             CUDA_CHECK(cudaStreamSynchronize(stream));
             glUnmapBuffer(GL_ARRAY_BUFFER);
@@ -80,7 +99,7 @@ void copy_vector_field(const Array<T> &points, const Array<T> &directions,
         ptr =
             static_cast<GLubyte *>(glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY));
         if (ptr) {
-            CUDA_CHECK(cudaMemcpyAsync(ptr, directions.get(), size2,
+            CUDA_CHECK(cudaMemcpyAsync(ptr, dVertices.get(), size2,
                                        cudaMemcpyDeviceToHost, stream));
             CUDA_CHECK(cudaStreamSynchronize(stream));
             glUnmapBuffer(GL_ARRAY_BUFFER);
@@ -89,10 +108,12 @@ void copy_vector_field(const Array<T> &points, const Array<T> &directions,
 
         CheckGL("End CUDA fallback-resource copy");
     }
+    interop.endCopy(inputs);
 }
 
-#define INSTANTIATE(T)                                                     \
-    template void copy_vector_field<T>(const Array<T> &, const Array<T> &, \
+#define INSTANTIATE(T)                                           \
+    template void copy_vector_field<T>(const vector<Array<T>> &, \
+                                       const vector<Array<T>> &, \
                                        fg_vector_field);
 
 INSTANTIATE(float)
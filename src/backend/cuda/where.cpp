@@ -24,7 +24,17 @@ Array<uint> where(const Array<T> &in) {
     return createParamArray<uint>(out, true);
 }
 
-#define INSTANTIATE(T) template Array<uint> where<T>(const Array<T> &in);
+template<typename T>
+Array<T> compact(const Array<T> &in, const Array<char> &mask) {
+    Param<T> out;
+    kernel::compact<T>(out, in, mask);
+    return createParamArray<T>(out, true);
+}
+
+#define INSTANTIATE(T)                                 \
+    template Array<uint> where<T>(const Array<T> &in); \
+    template Array<T> compact<T>(const Array<T> &in,   \
+                                 const Array<char> &mask);
 
 INSTANTIATE(float)
 INSTANTIATE(cfloat)
@@ -9,9 +9,13 @@
 
 #include <Array.hpp>
 
+#include <common/ExternalRelease.hpp>
+#include <common/bfloat16.hpp>
 #include <common/half.hpp>
+#include <common/jit/JitHeuristics.hpp>
 #include <common/jit/NodeIterator.hpp>
 #include <common/util.hpp>
+#include <common/visit_array.hpp>
 #include <copy.hpp>
 #include <err_opencl.hpp>
 #include <jit/BufferNode.hpp>
@@ -31,21 +35,36 @@ using af::dtype_traits;
 
 using cl::Buffer;
 
+using common::array_value_t;
+using common::bfloat16;
+using common::callJitHeuristic;
+using common::getJitTreeInfo;
 using common::half;
+using common::hasJitHeuristic;
+using common::isExternal;
 using common::Node;
 using common::Node_ptr;
 using common::NodeIterator;
+using common::visitArray;
 using opencl::jit::BufferNode;
 
 using std::accumulate;
 using std::is_standard_layout;
-using std::make_shared;
+using std::pair;
 using std::vector;
 
 namespace opencl {
+/// Allocates the buffer of an evaluated array of \p elements. The control
+/// block of the shared pointer is allocated from the block cache.
+template<typename T>
+Buffer_ptr allocData(const dim_t elements) {
+    return Buffer_ptr(memAlloc<T>(elements).release(), bufferFree,
+                      common::PoolAllocator<Buffer>());
+}
+
 template<typename T>
 Node_ptr bufferNodePtr() {
-    return make_shared<BufferNode>(
+    return common::makePooled<BufferNode>(
         static_cast<af::dtype>(dtype_traits<T>::af_type));
 }
 
@@ -112,8 +131,7 @@ Array<T>::Array(const dim4 &dims, const T *const in_data)
     static_assert(
         offsetof(Array<T>, info) == 0,
         "Array<T>::info must be the first member variable of Array<T>");
-    getQueue().enqueueWriteBuffer(*data.get(), CL_TRUE, 0,
-                                  sizeof(T) * info.elements(), in_data);
+    writeBuffer(*data.get(), 0, sizeof(T) * info.elements(), in_data);
 }
 
 template<typename T>
@@ -162,6 +180,17 @@ Array<T>::Array(Param &tmp, bool owner_)
     , ready(true)
     , owner(owner_) {}
 
+template<typename T>
+Array<T>::Array(const dim4 &dims, const dim4 &strides, dim_t offset_,
+                Buffer_ptr in_data)
+    : info(getActiveDeviceId(), dims, offset_, strides,
+           static_cast<af_dtype>(dtype_traits<T>::af_type))
+    , data(std::move(in_data))
+    , data_dims(dims)
+    , node(bufferNodePtr<T>())
+    , ready(true)
+    , owner(true) {}
+
 template<typename T>
 Array<T>::Array(const dim4 &dims, const dim4 &strides, dim_t offset_,
                 const T *const in_data, bool is_device)
@@ -182,12 +211,43 @@ Array<T>::Array(const dim4 &dims, const dim4 &strides, dim_t offset_,
     }
 }
 
+/// Returns the buffer of a node in the tree of \p root which the evaluation
+/// of the tree can overwrite, or nullptr if there is none.
+///
+/// The generated kernel reads each element of a linear buffer with the
+/// dimensions of the output at the index it writes, so the output can be
+/// written in place when no other array or tree reads the buffer.
+template<typename T>
+Buffer_ptr getReusableBuffer(const Node_ptr &root, const dim4 &dims) {
+    if (root.use_count() > 1 || !root->hasExclusiveChildren()) {
+        return nullptr;
+    }
+
+    dim_t odims[4] = {dims[0], dims[1], dims[2], dims[3]};
+    for (NodeIterator<> it(root.get()), end; it != end; ++it) {
+        if (!it->isBuffer() ||
+            it->getType() != static_cast<af::dtype>(dtype_traits<T>::af_type)) {
+            continue;
+        }
+        const auto &buffer     = static_cast<const BufferNode &>(*it);
+        const Buffer_ptr &data = buffer.getData();
+        if (data.use_count() == 1 && !isExternal(data) &&
+            buffer.getParam().offset == 0 && buffer.isLinear(odims)) {
+            return data;
+        }
+    }
+    return nullptr;
+}
+
 template<typename T>
 void Array<T>::eval() {
     if (isReady()) { return; }
 
     this->setId(getActiveDeviceId());
-    data = Buffer_ptr(memAlloc<T>(info.elements()).release(), bufferFree);
+    data = getReusableBuffer<T>(node, dims());
+    if (!data) {
+        data = allocData<T>(info.elements());
+    }
 
     // Do not replace this with cast operator
     KParam info = {{dims()[0], dims()[1], dims()[2], dims()[3]},
@@ -215,33 +275,34 @@ Buffer *Array<T>::device() {
     return this->get();
 }
 
+/// Returns the size of the parameters of the tree of \p root in a batched
+/// JIT kernel, or 0 if the tree has too many elements to be batched or is
+/// not linear.
+static size_t getBatchParamBytes(const Node_ptr &root, const dim4 &dims) {
+    if (dims.elements() > common::kJitBatchMaxElements) { return 0; }
+
+    dim_t odims[4] = {dims[0], dims[1], dims[2], dims[3]};
+    size_t bytes   = sizeof(cl_mem) + sizeof(int);
+    for (NodeIterator<> it(root.get()), end; it != end; ++it) {
+        if (!it->isLinear(odims)) { return 0; }
+        bytes += it->isBuffer() ? sizeof(cl_mem) + sizeof(dim_t)
+                                : it->getParamBytes();
+    }
+    return bytes;
+}
+
 template<typename T>
 void evalMultiple(vector<Array<T> *> arrays) {
     vector<Param> outputs;
     vector<Array<T> *> output_arrays;
     vector<Node *> nodes;
 
-    // Check if all the arrays have the same dimension
-    auto it = std::adjacent_find(begin(arrays), end(arrays),
-                                 [](const Array<T> *l, const Array<T> *r) {
-                                     return l->dims() != r->dims();
-                                 });
-
-    // If they are not the same. eval individually
-    if (it != end(arrays)) {
-        for (auto ptr : arrays) { ptr->eval(); }
-        return;
-    }
-
-    for (Array<T> *array : arrays) {
-        if (array->isReady()) { continue; }
-
+    auto addOutput = [&](Array<T> *array) {
         const ArrayInfo info = array->info;
 
         array->ready = true;
         array->setId(getActiveDeviceId());
-        array->data =
-            Buffer_ptr(memAlloc<T>(info.elements()).release(), bufferFree);
+        array->data = allocData<T>(info.elements());
 
         // Do not replace this with cast operator
         KParam kInfo = {
@@ -253,11 +314,99 @@ void evalMultiple(vector<Array<T> *> arrays) {
         outputs.emplace_back(array->data.get(), kInfo);
         output_arrays.push_back(array);
         nodes.push_back(array->node.get());
+    };
+
+    // Check if all the arrays have the same dimension
+    auto it = std::adjacent_find(begin(arrays), end(arrays),
+                                 [](const Array<T> *l, const Array<T> *r) {
+                                     return l->dims() != r->dims();
+                                 });
+
+    // If they are not the same, the small linear arrays are evaluated in
+    // batches with a single kernel and the others individually
+    if (it != end(arrays)) {
+        // The parameter space of the device less a padding for safety
+        const size_t max_param_size =
+            getDevice().getInfo<CL_DEVICE_MAX_PARAMETER_SIZE>() - 256;
+        size_t param_size = 0;
+
+        auto evalBatch = [&]() {
+            if (outputs.size() > 1) {
+                evalNodesBatched(outputs, nodes);
+            } else if (outputs.size() == 1) {
+                evalNodes(outputs, nodes);
+            }
+            for (Array<T> *array : output_arrays) {
+                array->node = bufferNodePtr<T>();
+            }
+            outputs.clear();
+            output_arrays.clear();
+            nodes.clear();
+            param_size = 0;
+        };
+
+        for (Array<T> *array : arrays) {
+            if (array->isReady()) { continue; }
+
+            const size_t bytes = getBatchParamBytes(array->node, array->dims());
+            if (bytes == 0) {
+                array->eval();
+                continue;
+            }
+            if (param_size + bytes > max_param_size) { evalBatch(); }
+            param_size += bytes;
+            addOutput(array);
+        }
+        evalBatch();
+        return;
+    }
+
+    for (Array<T> *array : arrays) {
+        if (array->isReady()) { continue; }
+        addOutput(array);
     }
     evalNodes(outputs, nodes);
     for (Array<T> *array : output_arrays) { array->node = bufferNodePtr<T>(); }
 }
 
+void evalMultiple(const vector<pair<af::dtype, void *>> &arrays) {
+    vector<Param> outputs;
+    vector<Node *> nodes;
+    vector<pair<af::dtype, void *>> output_arrays;
+
+    for (const auto &array : arrays) {
+        visitArray(array.first, array.second, [&](auto &arr) {
+            using T = array_value_t<decltype(arr)>;
+            if (arr.isReady()) { return; }
+
+            const ArrayInfo info = arr.info;
+
+            arr.ready = true;
+            arr.setId(getActiveDeviceId());
+            arr.data = allocData<T>(info.elements());
+
+            KParam kInfo = {
+                {info.dims()[0], info.dims()[1], info.dims()[2],
+                 info.dims()[3]},
+                {info.strides()[0], info.strides()[1], info.strides()[2],
+                 info.strides()[3]},
+                0};
+
+            outputs.emplace_back(arr.data.get(), kInfo);
+            output_arrays.push_back(array);
+            nodes.push_back(arr.node.get());
+        });
+    }
+
+    evalNodes(outputs, nodes);
+
+    for (const auto &array : output_arrays) {
+        visitArray(array.first, array.second, [](auto &arr) {
+            arr.node = bufferNodePtr<array_value_t<decltype(arr)>>();
+        });
+    }
+}
+
 template<typename T>
 Node_ptr Array<T>::getNode() {
     if (node->isBuffer()) {
@@ -292,6 +441,24 @@ Node_ptr Array<T>::getNode() const {
 template<typename T>
 kJITHeuristics passesJitHeuristics(Node *root_node) {
     if (!evalFlag()) { return kJITHeuristics::Pass; }
+
+    // This is the base parameter size if the kernel had no
+    // arguments
+    constexpr size_t base_param_size =
+        sizeof(T *) + sizeof(KParam) + (3 * sizeof(uint));
+
+    if (hasJitHeuristic()) {
+        af_jit_tree_info info =
+            getJitTreeInfo(root_node, sizeof(KParam) + sizeof(T *));
+        info.max_height = static_cast<int>(getMaxJitSize());
+        info.max_param_bytes =
+            getDevice().getInfo<CL_DEVICE_MAX_PARAMETER_SIZE>() -
+            base_param_size;
+        info.exceeds_memory_pressure =
+            jitTreeExceedsMemoryPressure(info.buffer_bytes);
+        return callJitHeuristic(info);
+    }
+
     if (root_node->getHeight() >= static_cast<int>(getMaxJitSize())) {
         return kJITHeuristics::TreeHeight;
     }
@@ -311,11 +478,6 @@ kJITHeuristics passesJitHeuristics(Node *root_node) {
     // an inexpensive operation and does not traverse the JIT tree.
     bool isParamLimit = (root_node->getHeight() >= heightCheckLimit);
     if (isParamLimit || isBufferLimit) {
-        // This is the base parameter size if the kernel had no
-        // arguments
-        constexpr size_t base_param_size =
-            sizeof(T *) + sizeof(KParam) + (3 * sizeof(uint));
-
         const cl::Device &device = getDevice();
         size_t max_param_size = device.getInfo<CL_DEVICE_MAX_PARAMETER_SIZE>();
         // typical values:
@@ -379,19 +541,12 @@ Array<T> createSubArray(const Array<T> &parent, const vector<af_seq> &index,
                         bool copy) {
     parent.eval();
 
-    dim4 dDims          = parent.getDataDims();
-    dim4 dStrides       = calcStrides(dDims);
-    dim4 parent_strides = parent.strides();
-
-    if (dStrides != parent_strides) {
-        const Array<T> parentCopy = copyArray(parent);
-        return createSubArray(parentCopy, index, copy);
-    }
-
-    const dim4 &pDims = parent.dims();
-
-    dim4 dims    = toDims(index, pDims);
-    dim4 strides = toStride(index, dDims);
+    // The strides of the parent are scaled, so the views of views share the
+    // buffer of the parent instead of a linearized copy of it
+    const dim4 &parent_strides = parent.strides();
+    const dim4 &pDims          = parent.dims();
+    dim4 dims                  = toDims(index, pDims);
+    dim4 strides               = toViewStride(index, parent_strides);
 
     // Find total offsets after indexing
     dim4 offsets = toOffset(index, pDims);
@@ -423,6 +578,13 @@ Array<T> createDeviceDataArray(const dim4 &dims, void *data) {
     return Array<T>(dims, static_cast<cl_mem>(data), 0, copy_device);
 }
 
+template<typename T>
+Array<T> createSharedDataArray(const dim4 &dims, const dim4 &strides,
+                               dim_t offset, Buffer_ptr data) {
+    verifyTypeSupport<T>();
+    return Array<T>(dims, strides, offset, std::move(data));
+}
+
 template<typename T>
 Array<T> createValueArray(const dim4 &dims, const T &value) {
     verifyTypeSupport<T>();
@@ -448,11 +610,11 @@ void destroyArray(Array<T> *A) {
 
 template<typename T>
 void writeHostDataArray(Array<T> &arr, const T *const data,
-                        const size_t bytes) {
+                        const size_t bytes, const size_t offset) {
     if (!arr.isOwner()) { arr = copyArray<T>(arr); }
 
-    getQueue().enqueueWriteBuffer(*arr.get(), CL_TRUE, arr.getOffset(), bytes,
-                                  data);
+    writeBuffer(*arr.get(), arr.getOffset() * sizeof(T) + offset, bytes,
+                data);
 }
 
 template<typename T>
@@ -490,6 +652,9 @@ size_t Array<T>::getAllocatedBytes() const {
     template Array<T> createHostDataArray<T>(const dim4 &dims,                \
                                              const T *const data);            \
     template Array<T> createDeviceDataArray<T>(const dim4 &dims, void *data); \
+    template Array<T> createSharedDataArray<T>(                               \
+        const dim4 &dims, const dim4 &strides, dim_t offset,                  \
+        Buffer_ptr data);                                                     \
     template Array<T> createValueArray<T>(const dim4 &dims, const T &value);  \
     template Array<T> createEmptyArray<T>(const dim4 &dims);                  \
     template Array<T> createParamArray<T>(Param & tmp, bool owner);           \
@@ -508,7 +673,8 @@ size_t Array<T>::getAllocatedBytes() const {
     template void Array<T>::eval() const;                                     \
     template Buffer *Array<T>::device();                                      \
     template void writeHostDataArray<T>(Array<T> & arr, const T *const data,  \
-                                        const size_t bytes);                  \
+                                        const size_t bytes,                   \
+                                        const size_t offset);                 \
     template void writeDeviceDataArray<T>(                                    \
         Array<T> & arr, const void *const data, const size_t bytes);          \
     template void evalMultiple<T>(vector<Array<T> *> arrays);                 \
@@ -530,5 +696,6 @@ INSTANTIATE(uintl)
 INSTANTIATE(short)
 INSTANTIATE(ushort)
 INSTANTIATE(half)
+INSTANTIATE(bfloat16)
 
 }  // namespace opencl
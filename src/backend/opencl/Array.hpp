@@ -13,6 +13,7 @@
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/MemoryManagerBase.hpp>
+#include <common/PoolAllocator.hpp>
 #include <common/jit/Node.hpp>
 #include <err_opencl.hpp>
 #include <memory.hpp>
@@ -22,6 +23,8 @@
 #include <af/dim4.hpp>
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace opencl {
 typedef std::shared_ptr<cl::Buffer> Buffer_ptr;
@@ -32,10 +35,18 @@ class Array;
 template<typename T>
 void evalMultiple(std::vector<Array<T> *> arrays);
 
+/// Evaluates arrays of different types with the same dimensions. Each
+/// element of \p arrays is the type of an array and a pointer to its Array.
+void evalMultiple(const std::vector<std::pair<af::dtype, void *>> &arrays);
+
 void evalNodes(Param &out, common::Node *node);
 void evalNodes(std::vector<Param> &outputs,
                const std::vector<common::Node *> &nodes);
 
+/// Evaluates linear trees with different dimensions with a single kernel
+void evalNodesBatched(std::vector<Param> &outputs,
+                      const std::vector<common::Node *> &nodes);
+
 /// Creates a new Array object on the heap and returns a reference to it.
 template<typename T>
 Array<T> createNodeArray(const af::dim4 &dims, common::Node_ptr node);
@@ -51,6 +62,15 @@ Array<T> createHostDataArray(const af::dim4 &dims, const T *const data);
 template<typename T>
 Array<T> createDeviceDataArray(const af::dim4 &dims, void *data);
 
+/// Creates an array which uses \p data as its buffer without copying it
+///
+/// The array keeps a reference to \p data. The memory is released by the
+/// deleter of \p data once the array and all the arrays which share its
+/// buffer are destroyed.
+template<typename T>
+Array<T> createSharedDataArray(const af::dim4 &dims, const af::dim4 &strides,
+                               dim_t offset, Buffer_ptr data);
+
 template<typename T>
 Array<T> createStridedArray(const af::dim4 &dims, const af::dim4 &strides,
                             dim_t offset, const T *const in_data,
@@ -59,8 +79,11 @@ Array<T> createStridedArray(const af::dim4 &dims, const af::dim4 &strides,
 }
 
 /// Copies data to an existing Array object from a host pointer
+///
+/// \p bytes bytes are written starting \p offset bytes into the array
 template<typename T>
-void writeHostDataArray(Array<T> &arr, const T *const data, const size_t bytes);
+void writeHostDataArray(Array<T> &arr, const T *const data, const size_t bytes,
+                        const size_t offset = 0);
 
 /// Copies data to an existing Array object from a device pointer
 template<typename T>
@@ -82,6 +105,14 @@ Array<T> createEmptyArray(const af::dim4 &dims);
 template<typename T>
 Array<T> createParamArray(Param &tmp, bool owner);
 
+/// Creates a view of \p parent without copying its data. The views of views
+/// share the buffer of the first parent.
+///
+/// \param[in] parent The array to index
+/// \param[in] index  The sequences of the view along each dimension
+/// \param[in] copy   False if the caller handles any strides. If true, views
+///                   with non contiguous columns or negative strides are
+///                   copied into a linear array.
 template<typename T>
 Array<T> createSubArray(const Array<T> &parent,
                         const std::vector<af_seq> &index, bool copy = true);
@@ -130,10 +161,16 @@ class Array {
           const dim4 &stride);
     Array(Param &tmp, bool owner);
     explicit Array(const af::dim4 &dims, common::Node_ptr n);
+    Array(const af::dim4 &dims, const af::dim4 &strides, dim_t offset,
+          Buffer_ptr in_data);
     explicit Array(const af::dim4 &dims, const T *const in_data);
     explicit Array(const af::dim4 &dims, cl_mem mem, size_t offset, bool copy);
 
    public:
+    // The handles of the arrays are created and destroyed by every call of
+    // the API, so they are allocated from the block cache of the thread
+    AF_POOL_ALLOCATED
+
     Array(const Array<T> &other) = default;
 
     Array(Array<T> &&other) noexcept = default;
@@ -279,11 +316,16 @@ class Array {
     }
 
     friend void evalMultiple<T>(std::vector<Array<T> *> arrays);
+    friend void evalMultiple(
+        const std::vector<std::pair<af::dtype, void *>> &arrays);
 
     friend Array<T> createValueArray<T>(const af::dim4 &dims, const T &value);
     friend Array<T> createHostDataArray<T>(const af::dim4 &dims,
                                            const T *const data);
     friend Array<T> createDeviceDataArray<T>(const af::dim4 &dims, void *data);
+    friend Array<T> createSharedDataArray<T>(const af::dim4 &dims,
+                                             const af::dim4 &strides,
+                                             dim_t offset, Buffer_ptr data);
     friend Array<T> createStridedArray<T>(const af::dim4 &dims,
                                           const af::dim4 &strides, dim_t offset,
                                           const T *const in_data,
@@ -69,4 +69,45 @@ af_event createAndMarkEvent() {
     return handle;
 }
 
+af_event createTimingEvent() {
+    auto e = make_unique<Event>();
+    getQueue()();
+    if (e->createTiming() != CL_SUCCESS) {
+        AF_ERROR("Could not create event", AF_ERR_RUNTIME);
+    }
+    Event& ref = *e.release();
+    return getHandle(ref);
+}
+
+float elapsedTime(af_event start, af_event end) {
+    float ms   = 0.f;
+    cl_int err = getEvent(end).elapsed(&ms, getEvent(start));
+    if (err == CL_PROFILING_INFO_NOT_AVAILABLE) {
+        AF_ERROR("The queue does not record timestamps", AF_ERR_NOT_SUPPORTED);
+    }
+    if (err != CL_SUCCESS) {
+        AF_ERROR("Could not measure the time between the events", AF_ERR_ARG);
+    }
+    return ms;
+}
+
+void waitForNativeQueue(void* queue) {
+    Event event;
+    if (event.create() != CL_SUCCESS ||
+        event.mark(static_cast<cl_command_queue>(queue)) != CL_SUCCESS ||
+        event.enqueueWait(getQueue()()) != CL_SUCCESS) {
+        AF_ERROR("Could not wait for the queue", AF_ERR_RUNTIME);
+    }
+}
+
+void signalNativeQueue(void* queue) {
+    Event event;
+    if (event.create() != CL_SUCCESS ||
+        event.mark(getQueue()()) != CL_SUCCESS ||
+        event.enqueueWait(static_cast<cl_command_queue>(queue)) !=
+            CL_SUCCESS) {
+        AF_ERROR("Could not signal the queue", AF_ERR_RUNTIME);
+    }
+}
+
 }  // namespace opencl
@@ -24,6 +24,29 @@ class OpenCLEventPolicy {
         return CL_SUCCESS;
     }
 
+    static cl_int createTimingEvent(cl_event *e) noexcept {
+        // The timestamps of the markers are recorded by the queue
+        return CL_SUCCESS;
+    }
+
+    static cl_int elapsedTime(float *ms, cl_event *start,
+                              cl_event *end) noexcept {
+        cl_int err = clWaitForEvents(1, end);
+        if (err != CL_SUCCESS) { return err; }
+        cl_ulong begin = 0, finish = 0;
+        // Fails with CL_PROFILING_INFO_NOT_AVAILABLE if the queue does not
+        // record timestamps
+        err = clGetEventProfilingInfo(*start, CL_PROFILING_COMMAND_END,
+                                      sizeof(begin), &begin, nullptr);
+        if (err != CL_SUCCESS) { return err; }
+        err = clGetEventProfilingInfo(*end, CL_PROFILING_COMMAND_END,
+                                      sizeof(finish), &finish, nullptr);
+        if (err != CL_SUCCESS) { return err; }
+        double ns = static_cast<double>(finish) - static_cast<double>(begin);
+        *ms       = static_cast<float>(ns * 1e-6);
+        return CL_SUCCESS;
+    }
+
     static cl_int markEvent(cl_event *e, cl_command_queue stream) noexcept {
         return clEnqueueMarkerWithWaitList(stream, 0, nullptr, e);
     }
@@ -56,4 +79,20 @@ void block(af_event eventHandle);
 
 af_event createAndMarkEvent();
 
+/// \brief Creates an event which can be timed with elapsedTime
+af_event createTimingEvent();
+
+/// \brief Returns the milliseconds between the completion of two timing
+///        events. The events have to be marked on queues which record
+///        timestamps.
+float elapsedTime(af_event start, af_event end);
+
+/// \brief Makes the active queue wait for the work enqueued so far on the
+///        native \p queue of another library
+void waitForNativeQueue(void *queue);
+
+/// \brief Makes the native \p queue of another library wait for the work
+///        enqueued so far on the active queue
+void signalNativeQueue(void *queue);
+
 }  // namespace opencl
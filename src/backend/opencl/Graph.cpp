@@ -0,0 +1,36 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Graph.hpp>
+
+#include <common/err_common.hpp>
+
+namespace opencl {
+
+void beginCapture() {
+    AF_ERROR("Graphs are not supported by the OpenCL backend",
+             AF_ERR_NOT_SUPPORTED);
+}
+
+af_graph endCapture() {
+    AF_ERROR("Graphs are not supported by the OpenCL backend",
+             AF_ERR_NOT_SUPPORTED);
+}
+
+void replayGraph(const af_graph graph) {
+    UNUSED(graph);
+    AF_ERROR("Graphs are not supported by the OpenCL backend",
+             AF_ERR_NOT_SUPPORTED);
+}
+
+void releaseGraph(af_graph graph) { UNUSED(graph); }
+
+bool isCapturing() { return false; }
+
+}  // namespace opencl
@@ -0,0 +1,27 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+#pragma once
+
+#include <af/graph.h>
+
+namespace opencl {
+
+// OpenCL 1.2 queues can not record commands, so graphs are not supported
+
+void beginCapture();
+
+af_graph endCapture();
+
+void replayGraph(const af_graph graph);
+
+void releaseGraph(af_graph graph);
+
+bool isCapturing();
+
+}  // namespace opencl
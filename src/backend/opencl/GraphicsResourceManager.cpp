@@ -10,7 +10,14 @@
 #include <GraphicsResourceManager.hpp>
 #include <platform.hpp>
 
+#include <vector>
+
 namespace opencl {
+GraphicsResourceManager::GraphicsResourceManager()
+    : mQueue(new cl::CommandQueue(getContext(), getDevice())) {}
+
+GraphicsResourceManager::~GraphicsResourceManager() = default;
+
 GraphicsResourceManager::ShrdResVector
 GraphicsResourceManager::registerResources(
     const std::vector<uint32_t>& resources) {
@@ -24,4 +31,12 @@ GraphicsResourceManager::registerResources(
 
     return output;
 }
+
+cl::CommandQueue& GraphicsResourceManager::beginCopy() {
+    cl::Event ready;
+    getQueue().enqueueMarkerWithWaitList(nullptr, &ready);
+    std::vector<cl::Event> events = {ready};
+    mQueue->enqueueBarrierWithWaitList(&events);
+    return *mQueue;
+}
 }  // namespace opencl
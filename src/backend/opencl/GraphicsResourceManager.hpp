@@ -12,11 +12,13 @@
 #include <common/InteropManager.hpp>
 
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace cl {
 class Buffer;
-}
+class CommandQueue;
+}  // namespace cl
 
 namespace opencl {
 class GraphicsResourceManager
@@ -24,12 +26,22 @@ class GraphicsResourceManager
    public:
     using ShrdResVector = std::vector<std::shared_ptr<cl::Buffer>>;
 
-    GraphicsResourceManager() {}
+    GraphicsResourceManager();
+    ~GraphicsResourceManager();
     static ShrdResVector registerResources(
         const std::vector<uint32_t>& resources);
 
+    /// Returns the queue of the copies to the graphics buffers, after the
+    /// work enqueued on the compute queue so far. The queue waits on a
+    /// marker of the compute queue, so the compute queue never waits on the
+    /// copies.
+    cl::CommandQueue& beginCopy();
+
    protected:
     GraphicsResourceManager(GraphicsResourceManager const&);
     void operator=(GraphicsResourceManager const&);
+
+   private:
+    std::unique_ptr<cl::CommandQueue> mQueue;
 };
 }  // namespace opencl
@@ -13,15 +13,20 @@
 
 #include <backend.hpp>
 #include <cl2hpp.hpp>
+#include <common/defines.hpp>
+#include <profiled_launch.hpp>
 
 namespace opencl {
 
 struct Enqueuer {
     template<typename... Args>
-    void operator()(cl::Kernel ker, const cl::EnqueueArgs& qArgs,
-                    Args... args) {
-        auto launchOp = cl::KernelFunctor<Args...>(ker);
-        launchOp(qArgs, std::forward<Args>(args)...);
+    void operator()(const cl::Program* mod, cl::Kernel ker,
+                    const cl::EnqueueArgs& qArgs, Args... args) {
+        // The module of a profiled launch is read from the kernel
+        UNUSED(mod);
+        auto launchOp  = cl::KernelFunctor<Args...>(ker);
+        cl::Event done = launchOp(qArgs, std::forward<Args>(args)...);
+        addProfiledLaunch(done, ker);
     }
 };
 
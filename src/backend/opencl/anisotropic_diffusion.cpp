@@ -15,20 +15,32 @@
 
 namespace opencl {
 template<typename T>
-void anisotropicDiffusion(Array<T>& inout, const float dt, const float mct,
+void anisotropicDiffusion(Array<T>& inout, const float dt, const float K,
+                          const unsigned iterations,
                           const af::fluxFunction fftype,
                           const af::diffusionEq eq) {
+    // The conductance of a step is exp(gradient * mct) with
+    // mct = -elements / (2 K^2 energy)
+    const float mctScale =
+        -static_cast<float>(inout.elements()) / (2.0f * K * K);
+
+    Array<T> tmp = createEmptyArray<T>(inout.dims());
+    bool inTmp   = false;
     if (eq == AF_DIFFUSION_MCDE) {
-        kernel::anisotropicDiffusion<T, true>(inout, dt, mct, fftype);
+        inTmp = kernel::anisotropicDiffusion<T, true>(inout, tmp, dt, mctScale,
+                                                      iterations, fftype);
     } else {
-        kernel::anisotropicDiffusion<T, false>(inout, dt, mct, fftype);
+        inTmp = kernel::anisotropicDiffusion<T, false>(
+            inout, tmp, dt, mctScale, iterations, fftype);
     }
+    if (inTmp) { inout = tmp; }
 }
 
-#define INSTANTIATE(T)                                     \
-    template void anisotropicDiffusion<T>(                 \
-        Array<T> & inout, const float dt, const float mct, \
-        const af::fluxFunction fftype, const af::diffusionEq eq);
+#define INSTANTIATE(T)                                            \
+    template void anisotropicDiffusion<T>(                        \
+        Array<T> & inout, const float dt, const float K,          \
+        const unsigned iterations, const af::fluxFunction fftype, \
+        const af::diffusionEq eq);
 
 INSTANTIATE(double)
 INSTANTIATE(float)
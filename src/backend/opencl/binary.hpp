@@ -12,6 +12,7 @@
 #include <common/jit/BinaryNode.hpp>
 #include <math.hpp>
 #include <optypes.hpp>
+#include <scalar.hpp>
 #include <af/dim4.hpp>
 
 namespace opencl {
@@ -134,11 +135,20 @@ Array<To> createBinaryNode(const Array<Ti> &lhs, const Array<Ti> &rhs,
     using common::Node;
     using common::Node_ptr;
 
+    // Operations on two scalars are computed once on the host instead of by
+    // every thread of the kernel
+    To folded{};
+    if (!lhs.isReady() && !rhs.isReady() &&
+        common::foldScalarNodes<To, Ti, op>(folded, *lhs.getNode(),
+                                            *rhs.getNode())) {
+        return createScalarNode<To>(odims, folded);
+    }
+
     auto createBinary = [](std::array<Node_ptr, 2> &operands) -> Node_ptr {
         BinOp<To, Ti, op> bop;
-        return Node_ptr(new common::BinaryNode(
+        return common::makePooled<common::BinaryNode>(
             static_cast<af::dtype>(dtype_traits<To>::af_type), bop.name(),
-            operands[0], operands[1], (int)(op)));
+            operands[0], operands[1], (int)(op));
     };
 
     Node_ptr out =
@@ -11,28 +11,48 @@
 
 #include <Array.hpp>
 #include <arith.hpp>
+#include <cast.hpp>
+#include <common/bfloat16.hpp>
 #include <common/half.hpp>
 #include <common/traits.hpp>
 #include <complex.hpp>
+#include <copy.hpp>
 #include <err_opencl.hpp>
+#include <kernel/gemm_epilogue.hpp>
+#include <kernel/gemm_quantized.hpp>
 #include <math.hpp>
+#include <offload.hpp>
 #include <reduce.hpp>
 #include <transpose.hpp>
 
 #include <complex>
+#include <mutex>
 #include <vector>
 
 // Includes one of the supported OpenCL BLAS back-ends (e.g. clBLAS, CLBlast)
 #include <cpu/cpu_blas.hpp>
 #include <magma/magma_blas.h>
 
+using common::bfloat16;
 using common::half;
 
 namespace opencl {
 
-void initBlas() { gpu_blas_init(); }
+namespace {
+std::once_flag blasSetupFlag;
+bool blasSetupDone = false;
+}  // namespace
 
-void deInitBlas() { gpu_blas_deinit(); }
+void initBlas() {
+    std::call_once(blasSetupFlag, []() {
+        gpu_blas_init();
+        blasSetupDone = true;
+    });
+}
+
+void deInitBlas() {
+    if (blasSetupDone) { gpu_blas_deinit(); }
+}
 
 // Converts an af_mat_prop options to a transpose type for one of the OpenCL
 // BLAS back-ends
@@ -66,10 +86,15 @@ void gemm(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs, const T *alpha,
           const Array<T> &lhs, const Array<T> &rhs, const T *beta) {
 #if defined(WITH_LINEAR_ALGEBRA)
     // Do not force offload gemm on OSX Intel devices
-    if (OpenCLCPUOffload(false) &&
-        static_cast<af_dtype>(dtype_traits<T>::af_type) != f16) {
-        gemm_fallback(out, optLhs, optRhs, alpha, lhs, rhs, beta);
-        return;
+    const af_dtype type = static_cast<af_dtype>(dtype_traits<T>::af_type);
+    if (type != f16) {
+        const dim4 &dims = out.dims();
+        const dim_t K    = lhs.dims()[optLhs == AF_MAT_NONE ? 1 : 0];
+        if (OpenCLCPUOffload(OffloadOp::Gemm, type, dims[0], dims[1], K,
+                             dims[2] * dims[3])) {
+            gemm_fallback(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+            return;
+        }
     }
 #endif
     const auto lOpts = toBlasTranspose(optLhs);
@@ -130,6 +155,87 @@ void gemm(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs, const T *alpha,
     }
 }
 
+template<typename T>
+void gemmEpilogue(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+                  const T *alpha, const Array<T> &lhs, const Array<T> &rhs,
+                  const T *beta, const Array<T> &bias,
+                  af_gemm_epilogue epilogue) {
+    // Neither clBLAS nor CLBlast can apply an epilogue, so it is applied by
+    // one kernel after the GEMM
+    gemm<T>(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+    if (bias.elements() > 0 || epilogue != AF_GEMM_EPILOGUE_NONE) {
+        kernel::gemmEpilogue<T>(out, bias, epilogue);
+    }
+}
+
+/// Accumulates the f16 or bf16 products in f32 with the f32 GEMM of the
+/// casts. Neither clBLAS nor CLBlast has a mixed precision GEMM.
+template<typename Ti, typename To>
+void gemmF32(Array<To> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+             const To *alpha, const Array<Ti> &lhs, const Array<Ti> &rhs,
+             const To *beta) {
+    const float alphaF = static_cast<float>(*alpha);
+    const float betaF  = static_cast<float>(*beta);
+    Array<float> outF  = createEmptyArray<float>(out.dims());
+    if (betaF != 0.f) { copyArray(outF, cast<float>(out)); }
+    gemm<float>(outF, optLhs, optRhs, &alphaF, cast<float>(lhs),
+                cast<float>(rhs), &betaF);
+    copyArray(out, cast<To>(outF));
+}
+
+/// The OpenCL BLAS libraries have no bf16 GEMM
+template<>
+void gemm<bfloat16>(Array<bfloat16> &out, af_mat_prop optLhs,
+                    af_mat_prop optRhs, const bfloat16 *alpha,
+                    const Array<bfloat16> &lhs, const Array<bfloat16> &rhs,
+                    const bfloat16 *beta) {
+    gemmF32(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+}
+
+// Neither clBLAS nor CLBlast has an 8-bit integer GEMM
+void gemmQuantized(Array<int> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+                   const Array<uchar> &lhs, const int lhsZero,
+                   const Array<uchar> &rhs, const int rhsZero) {
+    kernel::gemmQuantized(out, lhs, rhs, optLhs, optRhs, lhsZero, rhsZero);
+}
+
+// TF32 is ignored because the OpenCL BLAS libraries have no such mode
+template<typename Ti, typename To>
+void gemmMixed(Array<To> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+               const To *alpha, const Array<Ti> &lhs, const Array<Ti> &rhs,
+               const To *beta, af_gemm_compute_type /*compute*/) {
+    gemm<To>(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+}
+
+template<>
+void gemmMixed<half, half>(Array<half> &out, af_mat_prop optLhs,
+                           af_mat_prop optRhs, const half *alpha,
+                           const Array<half> &lhs, const Array<half> &rhs,
+                           const half *beta, af_gemm_compute_type compute) {
+    if (compute == AF_GEMM_COMPUTE_DEFAULT) {
+        gemm<half>(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+    } else {
+        gemmF32(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+    }
+}
+
+template<>
+void gemmMixed<half, float>(Array<float> &out, af_mat_prop optLhs,
+                            af_mat_prop optRhs, const float *alpha,
+                            const Array<half> &lhs, const Array<half> &rhs,
+                            const float *beta, af_gemm_compute_type) {
+    gemmF32(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+}
+
+template<>
+void gemmMixed<bfloat16, float>(Array<float> &out, af_mat_prop optLhs,
+                                af_mat_prop optRhs, const float *alpha,
+                                const Array<bfloat16> &lhs,
+                                const Array<bfloat16> &rhs, const float *beta,
+                                af_gemm_compute_type) {
+    gemmF32(out, optLhs, optRhs, alpha, lhs, rhs, beta);
+}
+
 template<typename T>
 Array<T> dot(const Array<T> &lhs, const Array<T> &rhs, af_mat_prop optLhs,
              af_mat_prop optRhs) {
@@ -152,6 +258,30 @@ INSTANTIATE_GEMM(double)
 INSTANTIATE_GEMM(cdouble)
 INSTANTIATE_GEMM(half)
 
+#define INSTANTIATE_GEMM_EPILOGUE(TYPE)                                   \
+    template void gemmEpilogue<TYPE>(                                     \
+        Array<TYPE> & out, af_mat_prop optLhs, af_mat_prop optRhs,        \
+        const TYPE *alpha, const Array<TYPE> &lhs, const Array<TYPE> &rhs, \
+        const TYPE *beta, const Array<TYPE> &bias, af_gemm_epilogue epilogue);
+
+INSTANTIATE_GEMM_EPILOGUE(float)
+INSTANTIATE_GEMM_EPILOGUE(cfloat)
+INSTANTIATE_GEMM_EPILOGUE(double)
+INSTANTIATE_GEMM_EPILOGUE(cdouble)
+INSTANTIATE_GEMM_EPILOGUE(half)
+
+#define INSTANTIATE_GEMM_MIXED(TI, TO)                               \
+    template void gemmMixed<TI, TO>(                                 \
+        Array<TO> & out, af_mat_prop optLhs, af_mat_prop optRhs,     \
+        const TO *alpha, const Array<TI> &lhs, const Array<TI> &rhs, \
+        const TO *beta, af_gemm_compute_type compute);
+
+INSTANTIATE_GEMM_MIXED(float, float)
+INSTANTIATE_GEMM_MIXED(cfloat, cfloat)
+INSTANTIATE_GEMM_MIXED(double, double)
+INSTANTIATE_GEMM_MIXED(cdouble, cdouble)
+INSTANTIATE_GEMM_MIXED(bfloat16, bfloat16)
+
 #define INSTANTIATE_DOT(TYPE)                                                  \
     template Array<TYPE> dot<TYPE>(const Array<TYPE> &lhs,                     \
                                    const Array<TYPE> &rhs, af_mat_prop optLhs, \
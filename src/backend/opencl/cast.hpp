@@ -9,6 +9,7 @@
 
 #pragma once
 #include <Array.hpp>
+#include <common/bfloat16.hpp>
 #include <common/jit/UnaryNode.hpp>
 #include <err_opencl.hpp>
 #include <math.hpp>
@@ -67,18 +68,44 @@ struct CastOp<cdouble, cdouble> {
     const char *name() { return "__convert_z2z"; }
 };
 
+// The bfloat16 values are stored as ushort in the JIT kernels. They are
+// converted to float, and then to the output type.
+template<typename Ti>
+struct CastOp<common::bfloat16, Ti> {
+    const char *name() { return "__float_to_bfloat16"; }
+};
+
+#define CAST_BF16(TYPE, NAME)                                     \
+    template<>                                                    \
+    struct CastOp<TYPE, common::bfloat16> {                       \
+        const char *name() { return NAME "__bfloat16_to_float"; } \
+    };
+
+CAST_BF16(int, "(int)")
+CAST_BF16(uint, "(uint)")
+CAST_BF16(uchar, "(uchar)")
+CAST_BF16(ushort, "(ushort)")
+CAST_BF16(short, "(short)")
+CAST_BF16(intl, "(long)")
+CAST_BF16(uintl, "(ulong)")
+CAST_BF16(float, "")
+CAST_BF16(double, "(double)")
+CAST_BF16(char, "(char)(bool)")
+CAST_BF16(common::half, "(half)")
+
 #undef CAST_FN
 #undef CAST_CFN
+#undef CAST_BF16
 
 template<typename To, typename Ti>
 struct CastWrapper {
     Array<To> operator()(const Array<Ti> &in) {
         CastOp<To, Ti> cop;
         common::Node_ptr in_node = in.getNode();
-        common::UnaryNode *node  = new common::UnaryNode(
+        common::Node_ptr node    = common::makePooled<common::UnaryNode>(
             static_cast<af::dtype>(dtype_traits<To>::af_type), cop.name(),
             in_node, af_cast_t);
-        return createNodeArray<To>(in.dims(), common::Node_ptr(node));
+        return createNodeArray<To>(in.dims(), node);
     }
 };
 
@@ -14,30 +14,60 @@
 
 #if defined(WITH_LINEAR_ALGEBRA)
 #include <cpu/cpu_cholesky.hpp>
+#include <kernel/lapack_batched.hpp>
 #include <magma/magma.h>
+#include <offload.hpp>
 #include <triangle.hpp>
 
+#include <vector>
+
 namespace opencl {
 
 template<typename T>
 int cholesky_inplace(Array<T> &in, const bool is_upper) {
-    if (OpenCLCPUOffload()) { return cpu::cholesky_inplace(in, is_upper); }
+    if (OpenCLCPUOffload(OffloadOp::Cholesky, in)) {
+        return cpu::cholesky_inplace(in, is_upper);
+    }
 
     dim4 iDims = in.dims();
     int N      = iDims[0];
 
     magma_uplo_t uplo = is_upper ? MagmaUpper : MagmaLower;
-
-    int info           = 0;
+    int batch         = iDims[2] * iDims[3];
+
+    if (batch > 1 && N <= kernel::LAPACK_BATCHED_MAX_SIZE) {
+        Array<int> info = createEmptyArray<int>(dim4(batch));
+        kernel::potrfBatched<T>(in, info, is_upper);
+
+        std::vector<int> h_info(batch);
+        copyData(&h_info[0], info);
+        // A batch reports the failure of its first failing matrix
+        for (int i : h_info) {
+            if (i != 0) { return i; }
+        }
+        return 0;
+    }
+
+    int firstInfo      = 0;
     cl::Buffer *in_buf = in.get();
-    magma_potrf_gpu<T>(uplo, N, (*in_buf)(), in.getOffset(), in.strides()[1],
-                       getQueue()(), &info);
-    return info;
+    for (dim_t w = 0; w < iDims[3]; w++) {
+        for (dim_t z = 0; z < iDims[2]; z++) {
+            int info     = 0;
+            dim_t offset = in.getOffset() + z * in.strides()[2] +
+                           w * in.strides()[3];
+            magma_potrf_gpu<T>(uplo, N, (*in_buf)(), offset, in.strides()[1],
+                               getQueue()(), &info);
+            if (firstInfo == 0) { firstInfo = info; }
+        }
+    }
+    return firstInfo;
 }
 
 template<typename T>
 Array<T> cholesky(int *info, const Array<T> &in, const bool is_upper) {
-    if (OpenCLCPUOffload()) { return cpu::cholesky(info, in, is_upper); }
+    if (OpenCLCPUOffload(OffloadOp::Cholesky, in)) {
+        return cpu::cholesky(info, in, is_upper);
+    }
 
     Array<T> out = copyArray<T>(in);
     *info        = cholesky_inplace(out, is_upper);
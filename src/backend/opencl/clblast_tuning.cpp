@@ -0,0 +1,140 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <clblast_tuning.hpp>
+
+#include <common/defines.hpp>
+
+#if defined(USE_CLBLAST)
+
+#include <clblast.h>
+#include <common/util.hpp>
+#include <kernel_headers/clblast_database.hpp>
+
+#include <fstream>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using std::istream;
+using std::string;
+using std::unordered_map;
+using std::vector;
+
+namespace opencl {
+
+namespace {
+
+/// The parameters of a CLBlast kernel on a device
+struct TunedKernel {
+    string device;
+    string kernel;
+    clblast::Precision precision;
+    unordered_map<string, size_t> parameters;
+};
+
+/// Removes the spaces and the null characters around \p name
+string trimName(const string &name) {
+    const char *blank  = " \t\r\n";
+    const size_t first = name.find_first_not_of(blank);
+    if (first == string::npos) { return string(); }
+    string out = name.substr(first);
+    out.erase(out.find_last_not_of(string(blank) + '\0') + 1);
+    return out;
+}
+
+/// Reads the lines of a tuning database, which are the name of a device,
+/// the name of a CLBlast kernel, its precision (16, 32, 64, 3232 or 6464)
+/// and its parameters separated by tabs. The parameters are NAME=value
+/// pairs separated by spaces. The empty lines and the lines which start
+/// with # are skipped.
+void readDatabase(istream &in, vector<TunedKernel> &kernels) {
+    string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') { continue; }
+        vector<string> fields;
+        std::istringstream columns(line);
+        string field;
+        while (std::getline(columns, field, '\t')) {
+            fields.push_back(field);
+        }
+        if (fields.size() != 4) { continue; }
+
+        TunedKernel entry;
+        entry.device = trimName(fields[0]);
+        entry.kernel = fields[1];
+        try {
+            entry.precision =
+                static_cast<clblast::Precision>(std::stoi(fields[2]));
+            std::istringstream params(fields[3]);
+            string param;
+            while (params >> param) {
+                const size_t equal = param.find('=');
+                if (equal == string::npos) { continue; }
+                entry.parameters[param.substr(0, equal)] =
+                    std::stoull(param.substr(equal + 1));
+            }
+        } catch (...) {
+            // Ignore the lines which are not well formed
+            continue;
+        }
+        kernels.push_back(std::move(entry));
+    }
+}
+
+/// The entries of the bundled database followed by the ones of the database
+/// in the cache directory, so the latter are applied last
+const vector<TunedKernel> &tuningDatabase() {
+    static const vector<TunedKernel> database = [] {
+        vector<TunedKernel> out;
+        std::istringstream bundled(
+            string(clblast_database_txt, clblast_database_txt_len));
+        readDatabase(bundled, out);
+
+        const string &directory = common::getCacheDirectory();
+        if (!directory.empty()) {
+            std::ifstream user(directory + AF_PATH_SEPARATOR +
+                               "clblast_tuning.txt");
+            readDatabase(user, out);
+        }
+        return out;
+    }();
+    return database;
+}
+
+}  // namespace
+
+void applyBlasTuning(const cl::Device &device) {
+    const vector<TunedKernel> &database = tuningDatabase();
+    if (database.empty()) { return; }
+
+    const string name = trimName(device.getInfo<CL_DEVICE_NAME>());
+    for (const TunedKernel &entry : database) {
+        if (entry.device != name) { continue; }
+        // CLBlast rejects the entries which do not have all the parameters
+        // of their kernel, which keeps its defaults
+        clblast::OverrideParameters(device(), entry.kernel, entry.precision,
+                                    entry.parameters);
+    }
+}
+
+}  // namespace opencl
+
+#else
+
+namespace opencl {
+
+void applyBlasTuning(const cl::Device &device) { UNUSED(device); }
+
+}  // namespace opencl
+
+#endif
@@ -0,0 +1,29 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+/// The database of the kernel parameters of CLBlast tuned for each device.
+///
+/// The parameters of CLBlast are tuned for the devices it knows, and the
+/// other devices use generic defaults which can be several times slower.
+/// The database bundled with ArrayFire is read first, followed by the
+/// clblast_tuning.txt file in the cache directory, whose entries replace
+/// the bundled ones. The tune_clblast target runs the tuners of CLBlast and
+/// writes their results to the bundled database.
+#pragma once
+
+#include <cl2hpp.hpp>
+
+namespace opencl {
+
+/// Overrides the parameters of the CLBlast kernels for \p device with the
+/// entries of the tuning database which match its name. It does nothing
+/// when the BLAS library is not CLBlast.
+void applyBlasTuning(const cl::Device &device);
+
+}  // namespace opencl
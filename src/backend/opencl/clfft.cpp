@@ -172,8 +172,14 @@ SharedPlan findPlan(clfftLayout iLayout, clfftLayout oLayout, clfftDim rank,
         delete p;
 #endif
     });
+    // The temporary buffer of the plan is accounted for by the plan cache
+    size_t workSize = 0;
+    if (clfftGetTmpBufSize(*retVal, &workSize) != CLFFT_SUCCESS) {
+        workSize = 0;
+    }
+
     // push the plan into plan cache
-    planner.push(key_string, retVal);
+    planner.push(key_string, retVal, workSize);
 
     return retVal;
 }
@@ -13,6 +13,7 @@
 #include <cl2hpp.hpp>
 #include <common/Logger.hpp>
 #include <common/defines.hpp>
+#include <common/kernel_disk_cache.hpp>
 #include <common/util.hpp>
 #include <debug_opencl.hpp>
 #include <err_opencl.hpp>
@@ -24,13 +25,18 @@
 #include <cctype>
 #include <cstdio>
 #include <fstream>
+#include <iterator>
 #include <sstream>
 #include <string>
 #include <vector>
 
 using cl::Error;
 using cl::Program;
+using common::addCachedKernel;
+using common::CachedKernel;
 using common::loggerFactory;
+using common::removeCachedKernel;
+using common::touchCachedKernel;
 using fmt::format;
 using opencl::getActiveDeviceId;
 using opencl::getDevice;
@@ -40,6 +46,9 @@ using spdlog::logger;
 
 using std::begin;
 using std::end;
+using std::ifstream;
+using std::istreambuf_iterator;
+using std::istringstream;
 using std::ofstream;
 using std::ostringstream;
 using std::shared_ptr;
@@ -132,6 +141,102 @@ Program buildProgram(const vector<string> &kernelSources,
     return retVal;
 }
 
+/// Returns the directory of the SPIR-V modules of the kernels, which is set
+/// with AF_OPENCL_SPIRV_PATH or when the library is built with
+/// AF_OPENCL_SPIRV
+const string &getSpirvDirectory() {
+    static const string directory = [] {
+        string path = getEnvVar("AF_OPENCL_SPIRV_PATH");
+#ifdef AF_OPENCL_SPIRV_DIR
+        if (path.empty()) { path = AF_OPENCL_SPIRV_DIR; }
+#endif
+        return path;
+    }();
+    return directory;
+}
+
+string getSpirvFilename(const string &moduleKey) {
+    return "KER" + moduleKey + "_AF_" + to_string(AF_API_VERSION_CURRENT);
+}
+
+/// Builds the program from its SPIR-V module. An empty program is returned
+/// if there is no module or if the device can not load it, in which case
+/// the program is built from its source.
+Program buildProgramFromIL(const string &moduleKey,
+                           const vector<string> &compileOpts) {
+    const string &directory = getSpirvDirectory();
+    if (directory.empty()) { return Program(); }
+
+    auto device = getDevice();
+    if (device.getInfo<CL_DEVICE_EXTENSIONS>().find("cl_khr_il_program") ==
+        string::npos) {
+        return Program();
+    }
+
+    ifstream in(directory + AF_PATH_SEPARATOR + getSpirvFilename(moduleKey) +
+                    ".spv",
+                std::ios::binary);
+    if (!in.is_open()) { return Program(); }
+    const vector<char> il((istreambuf_iterator<char>(in)),
+                          istreambuf_iterator<char>());
+
+    using createProgramWithIL_t =
+        cl_program(CL_API_CALL *)(cl_context, const void *, size_t, cl_int *);
+    auto createProgramWithIL = reinterpret_cast<createProgramWithIL_t>(
+        clGetExtensionFunctionAddressForPlatform(
+            device.getInfo<CL_DEVICE_PLATFORM>(), "clCreateProgramWithILKHR"));
+    if (!createProgramWithIL) { return Program(); }
+
+    cl_int err      = CL_SUCCESS;
+    cl_program prog = createProgramWithIL(getContext()(), il.data(),
+                                          il.size(), &err);
+    if (err != CL_SUCCESS) { return Program(); }
+    Program program(prog);
+
+    // The definitions were applied when the module was compiled, so only
+    // the other options are passed to the build
+    ostringstream options;
+    for (auto &opt : compileOpts) {
+        istringstream tokens(opt);
+        string token;
+        while (tokens >> token) {
+            if (token == "-D") {
+                tokens >> token;
+            } else if (token.compare(0, 2, "-D") != 0) {
+                options << " " << token;
+            }
+        }
+    }
+    try {
+        program.build({device}, options.str().c_str());
+    } catch (const Error &e) {
+        AF_TRACE("{{{:<20} : Building the SPIR-V module failed, {}}}",
+                 moduleKey, e.what());
+        return Program();
+    }
+    return program;
+}
+
+/// Writes the source and the options of a program to the directory set with
+/// AF_OPENCL_SPIRV_EXPORT_DIR, which are compiled to SPIR-V modules by
+/// CMakeModules/CompileSPIRV.cmake
+void exportProgram(const string &moduleKey, const vector<string> &sources,
+                   const vector<string> &compileOpts) {
+    static const string directory = getEnvVar("AF_OPENCL_SPIRV_EXPORT_DIR");
+    if (directory.empty()) { return; }
+
+    const string name =
+        directory + AF_PATH_SEPARATOR + getSpirvFilename(moduleKey);
+    ofstream source(name + ".cl");
+    source << DEFAULT_MACROS_STR;
+    source.write(KParam_hpp, KParam_hpp_len);
+    for (auto &src : sources) { source << "\n" << src; }
+
+    ofstream options(name + ".opts");
+    options << " -D dim_t=" << dtype_traits<dim_t>::getName();
+    for (auto &opt : compileOpts) { options << opt; }
+}
+
 }  // namespace opencl
 
 string getKernelCacheFilename(const int device, const string &key) {
@@ -155,18 +260,22 @@ Module compileModule(const string &moduleKey, const vector<string> &sources,
                      const vector<string> &options,
                      const vector<string> &kInstances, const bool isJIT) {
     UNUSED(kInstances);
-    UNUSED(isJIT);
 
     auto compileBegin = high_resolution_clock::now();
-    auto program      = opencl::buildProgram(sources, options);
-    auto compileEnd   = high_resolution_clock::now();
+    Program program;
+    if (!isJIT) { program = opencl::buildProgramFromIL(moduleKey, options); }
+    if (!program()) {
+        program = opencl::buildProgram(sources, options);
+        if (!isJIT) { opencl::exportProgram(moduleKey, sources, options); }
+    }
+    auto compileEnd = high_resolution_clock::now();
 
 #ifdef AF_CACHE_KERNELS_TO_DISK
     const int device             = opencl::getActiveDeviceId();
     const string &cacheDirectory = getCacheDirectory();
     if (!cacheDirectory.empty()) {
-        const string cacheFile = cacheDirectory + AF_PATH_SEPARATOR +
-                                 getKernelCacheFilename(device, moduleKey);
+        const string cacheName = getKernelCacheFilename(device, moduleKey);
+        const string cacheFile = cacheDirectory + AF_PATH_SEPARATOR + cacheName;
         const string tempFile =
             cacheDirectory + AF_PATH_SEPARATOR + makeTempFilename();
         try {
@@ -192,7 +301,14 @@ Module compileModule(const string &moduleKey, const vector<string> &sources,
             // try to rename temporary file into final cache file, if this fails
             // this means another thread has finished compiling this kernel
             // before the current thread.
-            if (!renameFile(tempFile, cacheFile)) { removeFile(tempFile); }
+            if (renameFile(tempFile, cacheFile)) {
+                const size_t fileSize =
+                    sizeof(clbinHash) + sizeof(clbinSize) + clbinSize;
+                addCachedKernel(CachedKernel{moduleKey, cacheName, fileSize,
+                                             clbinHash, isJIT, 0});
+            } else {
+                removeFile(tempFile);
+            }
         } catch (const cl::Error &e) {
             AF_TRACE("{{{:<20} : Failed to fetch opencl binary for {}, {}}}",
                      moduleKey,
@@ -212,7 +328,9 @@ Module compileModule(const string &moduleKey, const vector<string> &sources,
              fmt::join(options, " "),
              getDevice(getActiveDeviceId()).getInfo<CL_DEVICE_NAME>());
 
-    return {program};
+    Module retVal(program);
+    retVal.setBytes(program.getInfo<CL_PROGRAM_BINARY_SIZES>()[0]);
+    return retVal;
 }
 
 Module loadModuleFromDisk(const int device, const string &moduleKey,
@@ -221,8 +339,8 @@ Module loadModuleFromDisk(const int device, const string &moduleKey,
     if (cacheDirectory.empty()) return Module{};
 
     auto &dev              = opencl::getDevice(device);
-    const string cacheFile = cacheDirectory + AF_PATH_SEPARATOR +
-                             getKernelCacheFilename(device, moduleKey);
+    const string cacheName = getKernelCacheFilename(device, moduleKey);
+    const string cacheFile = cacheDirectory + AF_PATH_SEPARATOR + cacheName;
     Program program;
     Module retVal{};
     try {
@@ -247,12 +365,20 @@ Module loadModuleFromDisk(const int device, const string &moduleKey,
         if (recomputedHash != clbinHash) {
             AF_ERROR("Binary on disk seems to be corrupted", AF_ERR_LOAD_SYM);
         }
+        const size_t fileSize =
+            sizeof(clbinHash) + sizeof(clbinSize) + clbinSize;
+        if (!touchCachedKernel(CachedKernel{moduleKey, cacheName, fileSize,
+                                            clbinHash, isJIT, 0})) {
+            AF_ERROR("Binary on disk does not match the kernel cache index",
+                     AF_ERR_LOAD_SYM);
+        }
         program = Program(opencl::getContext(), {dev}, {clbin});
         program.build();
 
         AF_TRACE("{{{:<20} : loaded from {} for {} }}", moduleKey, cacheFile,
                  dev.getInfo<CL_DEVICE_NAME>());
         retVal.set(program);
+        retVal.setBytes(clbinSize);
     } catch (const AfError &e) {
         if (e.getError() == AF_ERR_LOAD_SYM) {
             AF_TRACE(
@@ -262,18 +388,18 @@ Module loadModuleFromDisk(const int device, const string &moduleKey,
             AF_TRACE("{{{:<20} : Unable to open {} for {}}}", moduleKey,
                      cacheFile, dev.getInfo<CL_DEVICE_NAME>());
         }
-        removeFile(cacheFile);
+        removeCachedKernel(cacheName);
     } catch (const std::ios_base::failure &e) {
         AF_TRACE("{{{:<20} : IO failure while loading {} for {}; {}}}",
                  moduleKey, cacheFile, dev.getInfo<CL_DEVICE_NAME>(), e.what());
-        removeFile(cacheFile);
+        removeCachedKernel(cacheName);
     } catch (const cl::Error &e) {
         AF_TRACE(
             "{{{:<20} : Loading OpenCL binary({}) failed for {}; {}, Build "
             "Log: {}}}",
             moduleKey, cacheFile, dev.getInfo<CL_DEVICE_NAME>(), e.what(),
             getProgramBuildLog(program));
-        removeFile(cacheFile);
+        removeCachedKernel(cacheName);
     }
     return retVal;
 }
@@ -284,4 +410,30 @@ Kernel getKernel(const Module &mod, const string &nameExpr,
     return {&mod.get(), cl::Kernel(mod.get(), nameExpr.c_str())};
 }
 
+void shareModule(Module &mod, const int device) {
+    // The kernels created from a program and their enqueued launches retain
+    // it, so the program is released by the runtime when they are done
+    UNUSED(mod);
+    UNUSED(device);
+}
+
+vector<string> getPrecisionOptions(const int device,
+                                   const af_precision_mode mode) {
+    switch (mode) {
+        case AF_PRECISION_STRICT: {
+            // Contractions can only be disabled in the source, so only the
+            // rounding of division and square root is controlled
+            const cl_device_fp_config config =
+                opencl::getDevice(device).getInfo<CL_DEVICE_SINGLE_FP_CONFIG>();
+            if (config & CL_FP_CORRECTLY_ROUNDED_DIVIDE_SQRT) {
+                return {" -cl-fp32-correctly-rounded-divide-sqrt"};
+            }
+            return {};
+        }
+        case AF_PRECISION_RELAXED: return {" -cl-mad-enable"};
+        case AF_PRECISION_FAST: return {" -cl-fast-relaxed-math"};
+        default: return {};
+    }
+}
+
 }  // namespace common
@@ -8,23 +8,18 @@
  ********************************************************/
 
 #include <Array.hpp>
-#include <blas.hpp>
 #include <common/half.hpp>
-#include <common/indexing_helpers.hpp>
 #include <convolve.hpp>
 #include <err_opencl.hpp>
 #include <handle.hpp>
+#include <kernel/conv2_implicit.hpp>
 #include <kernel/convolve.hpp>
-#include <reorder.hpp>
-#include <transpose.hpp>
-#include <unwrap.hpp>
-#include <wrap.hpp>
+#include <reduce.hpp>
 #include <af/defines.h>
 #include <af/dim4.hpp>
 #include <vector>
 
 using af::dim4;
-using common::flip;
 using common::half;
 using std::vector;
 
@@ -105,9 +100,8 @@ INSTANTIATE(intl, float)
 #undef INSTANTIATE
 
 template<typename T>
-Array<T> convolve2_unwrap(const Array<T> &signal, const Array<T> &filter,
-                          const dim4 &stride, const dim4 &padding,
-                          const dim4 &dilation) {
+Array<T> convolve2(Array<T> const &signal, Array<T> const &filter,
+                   const dim4 stride, const dim4 padding, const dim4 dilation) {
     dim4 sDims = signal.dims();
     dim4 fDims = filter.dims();
 
@@ -118,35 +112,11 @@ Array<T> convolve2_unwrap(const Array<T> &signal, const Array<T> &filter,
         1 + (sDims[1] + 2 * padding[1] - (((fDims[1] - 1) * dilation[1]) + 1)) /
                 stride[1];
 
-    const bool retCols = false;
-    Array<T> unwrapped =
-        unwrap(signal, fDims[0], fDims[1], stride[0], stride[1], padding[0],
-               padding[1], dilation[0], dilation[1], retCols);
-
-    unwrapped  = reorder(unwrapped, dim4(1, 2, 0, 3));
-    dim4 uDims = unwrapped.dims();
-    unwrapped.modDims(dim4(uDims[0] * uDims[1], uDims[2] * uDims[3]));
-
-    Array<T> collapsedFilter = filter;
-
-    collapsedFilter = flip(collapsedFilter, {1, 1, 0, 0});
-    collapsedFilter.modDims(dim4(fDims[0] * fDims[1] * fDims[2], fDims[3]));
-
-    Array<T> res =
-        matmul(unwrapped, collapsedFilter, AF_MAT_TRANS, AF_MAT_NONE);
-    res.modDims(dim4(outputWidth, outputHeight, signal.dims()[3],
-                     collapsedFilter.dims()[1]));
-    Array<T> out = reorder(res, dim4(0, 1, 3, 2));
-
-    return out;
-}
-
-template<typename T>
-Array<T> convolve2(Array<T> const &signal, Array<T> const &filter,
-                   const dim4 stride, const dim4 padding, const dim4 dilation) {
-    Array<T> out =
-        convolve2_unwrap<T>(signal, filter, stride, padding, dilation);
-
+    Array<T> out = createEmptyArray<T>(
+        dim4(outputWidth, outputHeight, fDims[3], sDims[3]));
+    kernel::conv2Implicit<T>(out, signal, filter, AF_CONV2_FORWARD, fDims[0],
+                             fDims[1], stride, padding, dilation,
+                             fDims[0] * fDims[1] * fDims[2]);
     return out;
 }
 
@@ -168,30 +138,13 @@ Array<T> conv2DataGradient(const Array<T> &incoming_gradient,
                            af::dim4 stride, af::dim4 padding,
                            af::dim4 dilation) {
     const dim4 &cDims = incoming_gradient.dims();
-    const dim4 &sDims = original_signal.dims();
     const dim4 &fDims = original_filter.dims();
 
-    Array<T> collapsed_filter = original_filter;
-
-    collapsed_filter = flip(collapsed_filter, {1, 1, 0, 0});
-    collapsed_filter.modDims(dim4(fDims[0] * fDims[1] * fDims[2], fDims[3]));
-
-    Array<T> collapsed_gradient = incoming_gradient;
-    collapsed_gradient          = reorder(collapsed_gradient, dim4(0, 1, 3, 2));
-    collapsed_gradient.modDims(dim4(cDims[0] * cDims[1] * cDims[3], cDims[2]));
-
-    Array<T> res =
-        matmul(collapsed_gradient, collapsed_filter, AF_MAT_NONE, AF_MAT_TRANS);
-    res.modDims(dim4(res.dims()[0] / sDims[3], sDims[3], fDims[0] * fDims[1],
-                     sDims[2]));
-    res = reorder(res, dim4(0, 2, 3, 1));
-
-    const bool retCols = false;
-    res = wrap_dilated(res, sDims[0], sDims[1], fDims[0], fDims[1], stride[0],
-                       stride[1], padding[0], padding[1], dilation[0],
-                       dilation[1], retCols);
-
-    return res;
+    Array<T> out = createEmptyArray<T>(original_signal.dims());
+    kernel::conv2Implicit<T>(out, incoming_gradient, original_filter,
+                             AF_CONV2_DATA_GRADIENT, fDims[0], fDims[1], stride,
+                             padding, dilation, fDims[0] * fDims[1] * cDims[2]);
+    return out;
 }
 
 template<typename T>
@@ -204,24 +157,20 @@ Array<T> conv2FilterGradient(const Array<T> &incoming_gradient,
     const dim4 &cDims = incoming_gradient.dims();
     const dim4 &fDims = original_filter.dims();
 
-    const bool retCols = false;
-    Array<T> unwrapped =
-        unwrap(original_signal, fDims[0], fDims[1], stride[0], stride[1],
-               padding[0], padding[1], dilation[0], dilation[1], retCols);
+    // The sum over all the output pixels is split in parts, which are
+    // computed by different groups and added afterwards
+    const dim_t pixels = cDims[0] * cDims[1] * cDims[3];
+    const dim_t chunk  = kernel::conv2GradientChunk(pixels);
 
-    unwrapped  = reorder(unwrapped, dim4(1, 2, 0, 3));
-    dim4 uDims = unwrapped.dims();
-    unwrapped.modDims(dim4(uDims[0] * uDims[1], uDims[2] * uDims[3]));
+    Array<T> partial = createEmptyArray<T>(
+        dim4(fDims[0] * fDims[1] * fDims[2], fDims[3], divup(pixels, chunk)));
+    kernel::conv2Implicit<T>(partial, original_signal, incoming_gradient,
+                             AF_CONV2_FILTER_GRADIENT, fDims[0], fDims[1],
+                             stride, padding, dilation, chunk);
 
-    Array<T> collapsed_gradient = incoming_gradient;
-    collapsed_gradient          = reorder(collapsed_gradient, dim4(0, 1, 3, 2));
-    collapsed_gradient.modDims(dim4(cDims[0] * cDims[1] * cDims[3], cDims[2]));
-
-    Array<T> res =
-        matmul(unwrapped, collapsed_gradient, AF_MAT_NONE, AF_MAT_NONE);
-    res.modDims(dim4(fDims[0], fDims[1], fDims[2], fDims[3]));
-
-    return flip(res, {1, 1, 0, 0});
+    Array<T> res = reduce<af_add_t, T, T>(partial, 2);
+    res.modDims(fDims);
+    return res;
 }
 
 #define INSTANTIATE(T)                                                      \
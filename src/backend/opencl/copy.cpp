@@ -10,13 +10,21 @@
 #include <kernel/memcopy.hpp>
 
 #include <Array.hpp>
+#include <common/bfloat16.hpp>
 #include <common/complex.hpp>
 #include <common/half.hpp>
 #include <err_opencl.hpp>
 #include <math.hpp>
+#include <memory.hpp>
+#include <platform.hpp>
 
+#include <vector>
+
+using af::dim4;
+using common::bfloat16;
 using common::half;
 using common::is_complex;
+using std::vector;
 
 namespace opencl {
 
@@ -28,12 +36,29 @@ void copyData(T *data, const Array<T> &A) {
     dim_t offset = 0;
     cl::Buffer buf;
     Array<T> out = A;
+    dim4 pitch;
 
     if (A.isLinear() ||  // No offsets, No strides
         A.ndims() == 1   // Simple offset, no strides.
     ) {
         buf    = *A.get();
         offset = A.getOffset();
+    } else if (A.elements() > 0 &&
+               isPitchedView(A.dims(), A.strides(), pitch)) {
+        // The view is read with a single rectangular copy instead of being
+        // linearized on the device first
+        using rect        = cl::array<cl::size_type, 3>;
+        const dim4 &dims  = A.dims();
+        const size_t rows = dims[1];
+        const size_t cols = dims[0] * sizeof(T);
+        const rect bufferOrigin{A.getOffset() * sizeof(T), 0, 0};
+        const rect hostOrigin{0, 0, 0};
+        const rect region{cols, rows, static_cast<size_t>(dims[2] * dims[3])};
+        getQueue().enqueueReadBufferRect(
+            *A.get(), CL_TRUE, bufferOrigin, hostOrigin, region,
+            pitch[1] * sizeof(T), pitch[2] * sizeof(T), cols, cols * rows,
+            data);
+        return;
     } else {
         // FIXME: Think about implementing eval
         out    = copyArray(A);
@@ -42,8 +67,7 @@ void copyData(T *data, const Array<T> &A) {
     }
 
     // FIXME: Add checks
-    getQueue().enqueueReadBuffer(buf, CL_TRUE, sizeof(T) * offset,
-                                 sizeof(T) * A.elements(), data);
+    readBuffer(buf, sizeof(T) * offset, sizeof(T) * A.elements(), data);
 }
 
 template<typename T>
@@ -101,10 +125,52 @@ void copyArray(Array<outType> &out, Array<inType> const &in) {
     copyFn(out, in);
 }
 
-#define INSTANTIATE(T)                                         \
-    template void copyData<T>(T * data, const Array<T> &from); \
-    template Array<T> copyArray<T>(const Array<T> &A);         \
-    template void multiply_inplace<T>(Array<T> & in, double norm);
+template<typename T>
+void copyToArrayAsync(Array<T> &dst, const T *src, const size_t bytes,
+                      const size_t offset) {
+    if (!dst.isOwner()) { dst = copyArray<T>(dst); }
+    getQueue().enqueueWriteBuffer(*dst.get(), CL_FALSE,
+                                  sizeof(T) * dst.getOffset() + offset, bytes,
+                                  src);
+}
+
+template<typename T>
+void copyFromArrayAsync(T *dst, const Array<T> &src, const size_t bytes,
+                        const size_t offset) {
+    getQueue().enqueueReadBuffer(*src.get(), CL_FALSE,
+                                 sizeof(T) * src.getOffset() + offset, bytes,
+                                 dst);
+}
+
+template<typename T>
+Array<T> copyToDevice(const Array<T> &in, int device) {
+    const int srcDevice = in.getDevId();
+    const int oldDevice = setDevice(srcDevice);
+    if (srcDevice == device) {
+        Array<T> out = copyArray(in);
+        setDevice(oldDevice);
+        return out;
+    }
+
+    vector<T> host(in.elements());
+    copyData(host.data(), in);
+    setDevice(device);
+    Array<T> out = createHostDataArray<T>(in.dims(), host.data());
+    setDevice(oldDevice);
+    return out;
+}
+
+#define INSTANTIATE(T)                                                 \
+    template void copyData<T>(T * data, const Array<T> &from);         \
+    template Array<T> copyArray<T>(const Array<T> &A);                 \
+    template Array<T> copyToDevice<T>(const Array<T> &in, int device); \
+    template void multiply_inplace<T>(Array<T> & in, double norm);     \
+    template void copyToArrayAsync<T>(Array<T> & dst, const T *src,    \
+                                      const size_t bytes,              \
+                                      const size_t offset);            \
+    template void copyFromArrayAsync<T>(T * dst, const Array<T> &src,  \
+                                        const size_t bytes,            \
+                                        const size_t offset);
 
 INSTANTIATE(float)
 INSTANTIATE(double)
@@ -119,6 +185,7 @@ INSTANTIATE(uintl)
 INSTANTIATE(short)
 INSTANTIATE(ushort)
 INSTANTIATE(half)
+INSTANTIATE(bfloat16)
 
 #define INSTANTIATE_COPY_ARRAY(SRC_T)                                 \
     template void copyArray<SRC_T, float>(Array<float> & dst,         \
@@ -169,6 +236,11 @@ INSTANTIATE_COPY_ARRAY(half)
 INSTANTIATE_COPY_ARRAY_COMPLEX(cfloat)
 INSTANTIATE_COPY_ARRAY_COMPLEX(cdouble)
 
+// The bfloat16 arrays are only copied to bfloat16 arrays. The other types are
+// converted with cast.
+template void copyArray<bfloat16, bfloat16>(Array<bfloat16> &dst,
+                                            Array<bfloat16> const &src);
+
 template<typename T>
 T getScalar(const Array<T> &in) {
     T retVal{};
@@ -192,5 +264,6 @@ INSTANTIATE_GETSCALAR(uintl)
 INSTANTIATE_GETSCALAR(short)
 INSTANTIATE_GETSCALAR(ushort)
 INSTANTIATE_GETSCALAR(half)
+INSTANTIATE_GETSCALAR(bfloat16)
 
 }  // namespace opencl
@@ -63,8 +63,17 @@ int cholesky_inplace(Array<T> &in, const bool is_upper) {
 
     mapped_ptr<T> inPtr = in.getMappedPtr();
 
-    int info = potrf_func<T>()(AF_LAPACK_COL_MAJOR, uplo, N, inPtr.get(),
-                               in.strides()[1]);
+    // A batch reports the failure of its first failing matrix
+    int info = 0;
+    for (dim_t w = 0; w < iDims[3]; w++) {
+        for (dim_t z = 0; z < iDims[2]; z++) {
+            int sliceInfo = potrf_func<T>()(
+                AF_LAPACK_COL_MAJOR, uplo, N,
+                inPtr.get() + z * in.strides()[2] + w * in.strides()[3],
+                in.strides()[1]);
+            if (info == 0) { info = sliceInfo; }
+        }
+    }
 
     return info;
 }
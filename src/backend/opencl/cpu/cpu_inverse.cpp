@@ -53,8 +53,15 @@ Array<T> inverse(const Array<T> &in) {
     mapped_ptr<T> aPtr   = A.getMappedPtr();
     mapped_ptr<int> pPtr = pivot.getMappedPtr();
 
-    getri_func<T>()(AF_LAPACK_COL_MAJOR, M, aPtr.get(), A.strides()[1],
-                    pPtr.get());
+    for (dim_t w = 0; w < A.dims()[3]; w++) {
+        for (dim_t z = 0; z < A.dims()[2]; z++) {
+            getri_func<T>()(
+                AF_LAPACK_COL_MAJOR, M,
+                aPtr.get() + z * A.strides()[2] + w * A.strides()[3],
+                A.strides()[1],
+                pPtr.get() + z * pivot.strides()[2] + w * pivot.strides()[3]);
+        }
+    }
 
     return A;
 }
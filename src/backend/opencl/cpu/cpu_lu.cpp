@@ -114,8 +114,8 @@ void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot,
     pivot            = lu_inplace(in_copy);
 
     // SPLIT into lower and upper
-    dim4 ldims(M, min(M, N));
-    dim4 udims(min(M, N), N);
+    dim4 ldims(M, min(M, N), iDims[2], iDims[3]);
+    dim4 udims(min(M, N), N, iDims[2], iDims[3]);
     lower = createEmptyArray<T>(ldims);
     upper = createEmptyArray<T>(udims);
 
@@ -129,16 +129,28 @@ Array<int> lu_inplace(Array<T> &in, const bool convert_pivot) {
     int N      = iDims[1];
 
     int pivot_dim    = min(M, N);
-    Array<int> pivot = createEmptyArray<int>(af::dim4(pivot_dim, 1, 1, 1));
-    if (convert_pivot) { pivot = range<int>(af::dim4(M, 1, 1, 1)); }
+    Array<int> pivot = createEmptyArray<int>(
+        af::dim4(pivot_dim, 1, iDims[2], iDims[3]));
+    if (convert_pivot) {
+        pivot = range<int>(af::dim4(M, 1, iDims[2], iDims[3]));
+    }
 
     mapped_ptr<T> inPtr   = in.getMappedPtr();
     mapped_ptr<int> piPtr = pivot.getMappedPtr();
 
-    getrf_func<T>()(AF_LAPACK_COL_MAJOR, M, N, inPtr.get(), in.strides()[1],
-                    piPtr.get());
+    for (dim_t w = 0; w < iDims[3]; w++) {
+        for (dim_t z = 0; z < iDims[2]; z++) {
+            T *inSlice =
+                inPtr.get() + z * in.strides()[2] + w * in.strides()[3];
+            int *piSlice =
+                piPtr.get() + z * pivot.strides()[2] + w * pivot.strides()[3];
+
+            getrf_func<T>()(AF_LAPACK_COL_MAJOR, M, N, inSlice,
+                            in.strides()[1], piSlice);
 
-    if (convert_pivot) { convertPivot(piPtr.get(), M, min(M, N)); }
+            if (convert_pivot) { convertPivot(piSlice, M, min(M, N)); }
+        }
+    }
 
     return pivot;
 }
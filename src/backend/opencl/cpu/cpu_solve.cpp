@@ -78,8 +78,17 @@ Array<T> solveLU(const Array<T> &A, const Array<int> &pivot, const Array<T> &b,
     mapped_ptr<T> bPtr   = B.getMappedPtr();
     mapped_ptr<int> pPtr = pivot.getMappedPtr();
 
-    getrs_func<T>()(AF_LAPACK_COL_MAJOR, 'N', N, NRHS, aPtr.get(),
-                    A.strides()[1], pPtr.get(), bPtr.get(), B.strides()[1]);
+    for (dim_t w = 0; w < A.dims()[3]; w++) {
+        for (dim_t z = 0; z < A.dims()[2]; z++) {
+            getrs_func<T>()(
+                AF_LAPACK_COL_MAJOR, 'N', N, NRHS,
+                aPtr.get() + z * A.strides()[2] + w * A.strides()[3],
+                A.strides()[1],
+                pPtr.get() + z * pivot.strides()[2] + w * pivot.strides()[3],
+                bPtr.get() + z * B.strides()[2] + w * B.strides()[3],
+                B.strides()[1]);
+        }
+    }
 
     return B;
 }
@@ -94,10 +103,18 @@ Array<T> triangleSolve(const Array<T> &A, const Array<T> &b,
     mapped_ptr<T> aPtr = A.getMappedPtr();
     mapped_ptr<T> bPtr = B.getMappedPtr();
 
-    trtrs_func<T>()(AF_LAPACK_COL_MAJOR, options & AF_MAT_UPPER ? 'U' : 'L',
-                    'N',  // transpose flag
-                    options & AF_MAT_DIAG_UNIT ? 'U' : 'N', N, NRHS, aPtr.get(),
-                    A.strides()[1], bPtr.get(), B.strides()[1]);
+    for (dim_t w = 0; w < A.dims()[3]; w++) {
+        for (dim_t z = 0; z < A.dims()[2]; z++) {
+            trtrs_func<T>()(
+                AF_LAPACK_COL_MAJOR, options & AF_MAT_UPPER ? 'U' : 'L',
+                'N',  // transpose flag
+                options & AF_MAT_DIAG_UNIT ? 'U' : 'N', N, NRHS,
+                aPtr.get() + z * A.strides()[2] + w * A.strides()[3],
+                A.strides()[1],
+                bPtr.get() + z * B.strides()[2] + w * B.strides()[3],
+                B.strides()[1]);
+        }
+    }
 
     return B;
 }
@@ -126,8 +143,16 @@ Array<T> solve(const Array<T> &a, const Array<T> &b,
 
     if (M == N) {
         std::vector<int> pivot(N);
-        gesv_func<T>()(AF_LAPACK_COL_MAJOR, N, K, aPtr.get(), A.strides()[1],
-                       &pivot.front(), bPtr.get(), B.strides()[1]);
+        for (dim_t w = 0; w < A.dims()[3]; w++) {
+            for (dim_t z = 0; z < A.dims()[2]; z++) {
+                gesv_func<T>()(
+                    AF_LAPACK_COL_MAJOR, N, K,
+                    aPtr.get() + z * A.strides()[2] + w * A.strides()[3],
+                    A.strides()[1], &pivot.front(),
+                    bPtr.get() + z * B.strides()[2] + w * B.strides()[3],
+                    B.strides()[1]);
+            }
+        }
     } else {
         int sM = a.strides()[1];
         int sN = a.strides()[2] / sM;
@@ -13,6 +13,7 @@
 
 #include <GraphicsResourceManager.hpp>
 #include <blas.hpp>
+#include <clblast_tuning.hpp>
 #include <clfft.hpp>
 #include <common/DefaultMemoryManager.hpp>
 #include <common/Logger.hpp>
@@ -22,6 +23,7 @@
 #include <device_manager.hpp>
 #include <err_opencl.hpp>
 #include <errorcodes.hpp>
+#include <profiled_launch.hpp>
 #include <version.hpp>
 #include <af/opencl.h>
 #include <af/version.h>
@@ -35,6 +37,7 @@
 #include <boost/compute/utility/program_cache.hpp>
 
 #include <algorithm>
+#include <future>
 #include <iterator>
 #include <sstream>
 #include <string>
@@ -176,7 +179,8 @@ DeviceManager::DeviceManager()
     : logger(common::loggerFactory("platform"))
     , mUserDeviceOffset(0)
     , fgMngr(nullptr)
-    , mFFTSetup(new clfftSetupData) {
+    , mFFTSetup(new clfftSetupData)
+    , mFFTSetupDone(false) {
     vector<Platform> platforms;
     try {
         Platform::get(&platforms);
@@ -244,19 +248,32 @@ DeviceManager::DeviceManager()
     // Sort OpenCL devices based on default criteria
     stable_sort(mDevices.begin(), mDevices.end(), compare_default);
 
-    // Create contexts and queues once the sort is done
+    // Create contexts and queues once the sort is done. Creating a context
+    // can take a long time, so the contexts of the devices are created in
+    // parallel.
+    mContexts.resize(nDevices);
+    mQueues.resize(nDevices);
+    vector<std::future<void>> contextsCreated;
+    for (int i = 0; i < nDevices; i++) {
+        contextsCreated.push_back(std::async(std::launch::async, [this, i]() {
+            cl_platform_id device_platform =
+                mDevices[i]->getInfo<CL_DEVICE_PLATFORM>();
+            cl_context_properties cps[3] = {
+                CL_CONTEXT_PLATFORM, (cl_context_properties)(device_platform),
+                0};
+
+            mContexts[i] = make_unique<Context>(*mDevices[i], cps);
+            mQueues[i]   = make_unique<CommandQueue>(
+                *mContexts[i], *mDevices[i], getQueueProperties());
+        }));
+    }
+    for (auto& created : contextsCreated) { created.get(); }
+
     for (int i = 0; i < nDevices; i++) {
-        cl_platform_id device_platform =
-            mDevices[i]->getInfo<CL_DEVICE_PLATFORM>();
-        cl_context_properties cps[3] = {
-            CL_CONTEXT_PLATFORM, (cl_context_properties)(device_platform), 0};
-
-        mContexts.push_back(make_unique<Context>(*mDevices[i], cps));
-        mQueues.push_back(make_unique<CommandQueue>(
-            *mContexts.back(), *mDevices[i], cl::QueueProperties::None));
         mIsGLSharingOn.push_back(false);
         mDeviceTypes.push_back(getDeviceTypeEnum(*mDevices[i]));
         mPlatforms.push_back(getPlatformEnum(*mDevices[i]));
+        applyBlasTuning(*mDevices[i]);
     }
 
     bool default_device_set = false;
@@ -318,12 +335,8 @@ DeviceManager::DeviceManager()
     }
 
     mUserDeviceOffset = mDevices.size();
-    // Initialize FFT setup data structure
-    CLFFT_CHECK(clfftInitSetupData(mFFTSetup.get()));
-    CLFFT_CHECK(clfftSetup(mFFTSetup.get()));
 
-    // Initialize clBlas library
-    initBlas();
+    // clFFT and the BLAS library are set up by their first use
 
     // Cache Boost program_cache
     namespace compute = boost::compute;
@@ -337,6 +350,14 @@ DeviceManager::DeviceManager()
 
 spdlog::logger* DeviceManager::getLogger() { return logger.get(); }
 
+void DeviceManager::setupFFT() {
+    std::call_once(mFFTSetupFlag, [this]() {
+        CLFFT_CHECK(clfftInitSetupData(mFFTSetup.get()));
+        CLFFT_CHECK(clfftSetup(mFFTSetup.get()));
+        mFFTSetupDone = true;
+    });
+}
+
 DeviceManager& DeviceManager::getInstance() {
     static auto* my_instance = new DeviceManager();
     return *my_instance;
@@ -401,7 +422,7 @@ DeviceManager::~DeviceManager() {
     // TODO: FIXME:
     // clfftTeardown() causes a "Pure Virtual Function Called" crash on
     // Windows for Intel devices. This causes tests to fail.
-    clfftTeardown();
+    if (mFFTSetupDone) { clfftTeardown(); }
 #endif
 
     deInitBlas();
@@ -518,7 +539,8 @@ void DeviceManager::markDeviceForInterop(const int device,
 
             // Change current device to use GL sharing
             auto ctx = make_unique<Context>(*mDevices[device], cps);
-            auto cq  = make_unique<CommandQueue>(*ctx, *mDevices[device]);
+            auto cq  = make_unique<CommandQueue>(*ctx, *mDevices[device],
+                                                getQueueProperties());
 
             mQueues[device]        = move(cq);
             mContexts[device]      = move(ctx);
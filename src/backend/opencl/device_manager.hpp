@@ -138,6 +138,10 @@ class DeviceManager {
 
     spdlog::logger* getLogger();
 
+    /// Sets up clFFT on the first call. It is not set up by the constructor
+    /// because most programs never compute an FFT.
+    void setupFFT();
+
    protected:
     using clfftSetupData = clfftSetupData_;
 
@@ -168,6 +172,8 @@ class DeviceManager {
     std::unique_ptr<MemoryManagerBase> pinnedMemManager;
     std::unique_ptr<GraphicsResourceManager> gfxManagers[MAX_DEVICES];
     std::unique_ptr<clfftSetupData> mFFTSetup;
+    std::once_flag mFFTSetupFlag;
+    bool mFFTSetupDone;
     std::mutex mutex;
 
     using BoostProgCache = boost::shared_ptr<boost::compute::program_cache>;
@@ -9,19 +9,66 @@
 
 #include <fft.hpp>
 
+#include <Array.hpp>
+#include <cast.hpp>
 #include <clfft.hpp>
+#include <common/FFTLayout.hpp>
+#include <common/FFTPlanCache.hpp>
+#include <complex.hpp>
 #include <copy.hpp>
+#include <device_manager.hpp>
 #include <err_opencl.hpp>
+#include <kernel/fft_bluestein.hpp>
 #include <math.hpp>
 #include <memory.hpp>
+#include <platform.hpp>
+#include <reorder.hpp>
+#include <traits.hpp>
+#include <af/constants.h>
 #include <af/dim4.hpp>
 
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
 using af::dim4;
+using common::FFTBatch;
+using std::string;
+using std::to_string;
+using std::vector;
 
 namespace opencl {
 
+namespace {
+
+/// The chirp of the Bluestein transforms of length N, and the transform of
+/// length M of its conjugate, which is the filter of the convolution
+struct BluesteinPlan {
+    cl::Buffer chirp;
+    cl::Buffer filter;
+    int M;
+};
+
+class BluesteinCache
+    : public common::FFTPlanCache<BluesteinCache, BluesteinPlan> {};
+
+BluesteinCache &bluesteinManager() {
+    thread_local BluesteinCache managers[DeviceManager::MAX_DEVICES];
+    return managers[getActiveDeviceId()];
+}
+
+}  // namespace
+
 void setFFTPlanCacheSize(size_t numPlans) {
     fftManager().setMaxCacheSize(numPlans);
+    bluesteinManager().setMaxCacheSize(numPlans);
+}
+
+void setFFTPlanCacheBytes(size_t bytes) {
+    fftManager().setMaxCacheBytes(bytes);
+    bluesteinManager().setMaxCacheBytes(bytes);
 }
 
 template<typename T>
@@ -63,32 +110,213 @@ inline bool isSupLen(dim_t length) {
     return true;
 }
 
-void verifySupported(const int rank, const dim4 &dims) {
-    for (int i = 0; i < rank; i++) { ARG_ASSERT(1, isSupLen(dims[i])); }
+bool isSupported(const int rank, const dim4 &dims) {
+    for (int i = 0; i < rank; i++) {
+        if (!isSupLen(dims[i])) { return false; }
+    }
+    return true;
+}
+
+/// clFFT transforms start at the beginning of their buffers, so the
+/// transforms of the other elements are executed on sub-buffers, which must
+/// start at a multiple of the base address alignment of the device
+template<typename T>
+bool isSubBufferOffset(const dim_t offset) {
+    const size_t align =
+        getDevice().getInfo<CL_DEVICE_MEM_BASE_ADDR_ALIGN>() / 8;
+    return (offset * sizeof(T)) % align == 0;
+}
+
+/// Returns true if every execution of \p batch can start on a sub-buffer of
+/// the input \p in and the output \p out
+template<typename Ti, typename To>
+bool isExecutable(const FFTBatch &batch, const Array<Ti> &in,
+                  const Array<To> &out) {
+    for (dim_t e = 0; e < batch.executions(); e++) {
+        if (!isSubBufferOffset<Ti>(in.getOffset() + batch.inOffset(e)) ||
+            !isSubBufferOffset<To>(out.getOffset() + batch.outOffset(e))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Returns the memory of \p arr from the element \p offset of its buffer
+template<typename T>
+cl::Buffer bufferAt(const Array<T> &arr, const dim_t offset) {
+    cl::Buffer buf = *arr.get();
+    if (offset == 0) { return buf; }
+    const size_t origin     = offset * sizeof(T);
+    cl_buffer_region region = {origin, buf.getInfo<CL_MEM_SIZE>() - origin};
+    return buf.createSubBuffer(CL_MEM_READ_WRITE, CL_BUFFER_CREATE_TYPE_REGION,
+                               &region);
+}
+
+/// Returns the chirp and the filter of the Bluestein transforms of length
+/// \p N. They are cached with the clFFT plans.
+template<typename T>
+std::shared_ptr<BluesteinPlan> findBluesteinPlan(const int N,
+                                                 const bool direction) {
+    using R = typename dtype_traits<T>::base_type;
+
+    const string key = "bluestein:" + to_string(N) + ":" +
+                       to_string(static_cast<int>(Precision<T>::type)) + ":" +
+                       to_string(direction);
+    BluesteinCache &cache                = bluesteinManager();
+    std::shared_ptr<BluesteinPlan> found = cache.find(key);
+    if (found) { return found; }
+
+    // The length of the convolution is at least 2N - 1, and a power of 2
+    int M = 1;
+    while (M < 2 * N - 1) { M *= 2; }
+
+    // The angles use n^2 mod 2N, which keeps them exact for long transforms
+    vector<T> chirp(N);
+    vector<T> filter(M);
+    for (int i = 0; i < M; i++) { filter[i].s[0] = filter[i].s[1] = R(0); }
+    const double sign = direction ? -1.0 : 1.0;
+    for (int n = 0; n < N; n++) {
+        const uint64_t nn = static_cast<uint64_t>(n) * n % (2 * N);
+        const double angle = sign * af::Pi * static_cast<double>(nn) / N;
+        chirp[n].s[0]      = static_cast<R>(std::cos(angle));
+        chirp[n].s[1]      = static_cast<R>(std::sin(angle));
+        filter[n].s[0]     = chirp[n].s[0];
+        filter[n].s[1]     = -chirp[n].s[1];
+        if (n > 0) { filter[M - n] = filter[n]; }
+    }
+
+    auto plan   = std::make_shared<BluesteinPlan>();
+    plan->M     = M;
+    plan->chirp = cl::Buffer(getContext(), CL_MEM_READ_WRITE, N * sizeof(T));
+    plan->filter =
+        cl::Buffer(getContext(), CL_MEM_READ_WRITE, M * sizeof(T));
+    getQueue().enqueueWriteBuffer(plan->chirp, CL_TRUE, 0, N * sizeof(T),
+                                  chirp.data());
+    getQueue().enqueueWriteBuffer(plan->filter, CL_TRUE, 0, M * sizeof(T),
+                                  filter.data());
+
+    size_t len = M, stride = 1;
+    SharedPlan fftPlan = findPlan(
+        CLFFT_COMPLEX_INTERLEAVED, CLFFT_COMPLEX_INTERLEAVED, CLFFT_1D, &len,
+        &stride, len, &stride, len,
+        static_cast<clfftPrecision>(Precision<T>::type), 1);
+    cl_mem fmem            = plan->filter();
+    cl_command_queue queue = getQueue()();
+    CLFFT_CHECK(clfftEnqueueTransform(*fftPlan.get(), CLFFT_FORWARD, 1,
+                                      &queue, 0, NULL, NULL, &fmem, &fmem,
+                                      NULL));
+
+    cache.push(key, plan, (N + M) * sizeof(T));
+    return plan;
+}
+
+/// Transforms the columns of the linear array \p x in place. The lengths
+/// which clFFT does not support use the Bluestein transform, which computes
+/// the DFT as a convolution of power of 2 length.
+template<typename T>
+void fftColumns(Array<T> &x, const bool direction) {
+    using R = typename dtype_traits<T>::base_type;
+
+    const int N     = static_cast<int>(x.dims()[0]);
+    const int batch = static_cast<int>(x.elements() / N);
+    const auto precision = static_cast<clfftPrecision>(Precision<T>::type);
+    cl_command_queue queue = getQueue()();
+
+    if (isSupLen(N)) {
+        size_t len = N, stride = 1;
+        SharedPlan plan =
+            findPlan(CLFFT_COMPLEX_INTERLEAVED, CLFFT_COMPLEX_INTERLEAVED,
+                     CLFFT_1D, &len, &stride, len, &stride, len, precision,
+                     batch);
+        cl_mem xmem = (*x.get())();
+        CLFFT_CHECK(clfftEnqueueTransform(
+            *plan.get(), direction ? CLFFT_FORWARD : CLFFT_BACKWARD, 1,
+            &queue, 0, NULL, NULL, &xmem, &xmem, NULL));
+        return;
+    }
+
+    std::shared_ptr<BluesteinPlan> bluestein =
+        findBluesteinPlan<T>(N, direction);
+    const int M = bluestein->M;
+
+    Array<T> work = createEmptyArray<T>(dim4(M, batch));
+    kernel::bluesteinChirp<T>(*work.get(), *x.get(), bluestein->chirp, N, M,
+                              batch);
+
+    size_t len = M, stride = 1;
+    SharedPlan plan =
+        findPlan(CLFFT_COMPLEX_INTERLEAVED, CLFFT_COMPLEX_INTERLEAVED,
+                 CLFFT_1D, &len, &stride, len, &stride, len, precision, batch);
+    cl_mem wmem = (*work.get())();
+    CLFFT_CHECK(clfftEnqueueTransform(*plan.get(), CLFFT_FORWARD, 1, &queue,
+                                      0, NULL, NULL, &wmem, &wmem, NULL));
+    kernel::bluesteinFilter<T>(*work.get(), bluestein->filter, M, batch);
+    CLFFT_CHECK(clfftEnqueueTransform(*plan.get(), CLFFT_BACKWARD, 1, &queue,
+                                      0, NULL, NULL, &wmem, &wmem, NULL));
+
+    kernel::bluesteinOutput<T>(*x.get(), *work.get(), bluestein->chirp, N, M,
+                               batch, R(1) / R(M));
+}
+
+/// Returns the transform of the dimensions \p first to \p rank - 1 of
+/// \p in, computed one dimension at a time. The other dimensions are moved
+/// to the front and back for their transforms.
+template<typename T>
+Array<T> fftSeparable(const Array<T> &in, const int rank,
+                      const bool direction, const int first = 0) {
+    Array<T> res = copyArray<T>(in);
+    for (int d = first; d < rank; d++) {
+        if (res.dims()[d] == 1) { continue; }
+        if (d == 0) {
+            fftColumns(res, direction);
+            continue;
+        }
+        dim4 perm(0, 1, 2, 3);
+        perm[0]    = d;
+        perm[d]    = 0;
+        Array<T> t = reorder<T>(res, perm);
+        fftColumns(t, direction);
+        res = reorder<T>(t, perm);
+    }
+    return res;
 }
 
 template<typename T>
 void fft_inplace(Array<T> &in, const int rank, const bool direction) {
-    verifySupported(rank, in.dims());
+    if (!isSupported(rank, in.dims())) {
+        Array<T> res = fftSeparable(in, rank, direction);
+        copyArray(in, res);
+        return;
+    }
     size_t tdims[AF_MAX_DIMS], istrides[AF_MAX_DIMS];
 
     computeDims(tdims, in.dims());
     computeDims(istrides, in.strides());
 
-    int batch = 1;
-    for (int i = rank; i < AF_MAX_DIMS; i++) { batch *= tdims[i]; }
+    const FFTBatch batch(rank, in.dims(), in.strides(), in.strides());
+    if (!isExecutable(batch, in, in)) {
+        Array<T> packed = copyArray<T>(in);
+        fft_inplace<T>(packed, rank, direction);
+        copyArray(in, packed);
+        return;
+    }
 
     SharedPlan plan = findPlan(
         CLFFT_COMPLEX_INTERLEAVED, CLFFT_COMPLEX_INTERLEAVED,
-        static_cast<clfftDim>(rank), tdims, istrides, istrides[rank], istrides,
-        istrides[rank], static_cast<clfftPrecision>(Precision<T>::type), batch);
+        static_cast<clfftDim>(rank), tdims, istrides, batch.idist(), istrides,
+        batch.idist(), static_cast<clfftPrecision>(Precision<T>::type),
+        batch.batch());
 
-    cl_mem imem            = (*in.get())();
+    // The batch dimensions which are not packed are iterated with the same
+    // plan
     cl_command_queue queue = getQueue()();
-
-    CLFFT_CHECK(clfftEnqueueTransform(
-        *plan.get(), direction ? CLFFT_FORWARD : CLFFT_BACKWARD, 1, &queue, 0,
-        NULL, NULL, &imem, &imem, NULL));
+    for (dim_t e = 0; e < batch.executions(); e++) {
+        cl::Buffer ibuf = bufferAt(in, in.getOffset() + batch.inOffset(e));
+        cl_mem imem     = ibuf();
+        CLFFT_CHECK(clfftEnqueueTransform(
+            *plan.get(), direction ? CLFFT_FORWARD : CLFFT_BACKWARD, 1, &queue,
+            0, NULL, NULL, &imem, &imem, NULL));
+    }
 }
 
 template<typename Tc, typename Tr>
@@ -97,58 +325,87 @@ Array<Tc> fft_r2c(const Array<Tr> &in, const int rank) {
 
     odims[0] = odims[0] / 2 + 1;
 
-    Array<Tc> out = createEmptyArray<Tc>(odims);
+    if (!isSupported(rank, in.dims())) {
+        // The complex transform of the real values keeps the first
+        // N / 2 + 1 coefficients
+        Array<Tc> full = fftSeparable<Tc>(cast<Tc, Tr>(in), rank, true);
+        vector<af_seq> index(AF_MAX_DIMS, af_span);
+        index[0] = {0, static_cast<double>(odims[0] - 1), 1};
+        return copyArray<Tc>(createSubArray(full, index));
+    }
 
-    verifySupported(rank, in.dims());
+    Array<Tc> out = createEmptyArray<Tc>(odims);
     size_t tdims[AF_MAX_DIMS], istrides[AF_MAX_DIMS], ostrides[AF_MAX_DIMS];
 
     computeDims(tdims, in.dims());
     computeDims(istrides, in.strides());
     computeDims(ostrides, out.strides());
 
-    int batch = 1;
-    for (int i = rank; i < AF_MAX_DIMS; i++) { batch *= tdims[i]; }
+    const FFTBatch batch(rank, in.dims(), in.strides(), out.strides());
+    if (!isExecutable(batch, in, out)) {
+        return fft_r2c<Tc, Tr>(copyArray<Tr>(in), rank);
+    }
 
     SharedPlan plan = findPlan(
         CLFFT_REAL, CLFFT_HERMITIAN_INTERLEAVED, static_cast<clfftDim>(rank),
-        tdims, istrides, istrides[rank], ostrides, ostrides[rank],
-        static_cast<clfftPrecision>(Precision<Tc>::type), batch);
+        tdims, istrides, batch.idist(), ostrides, batch.odist(),
+        static_cast<clfftPrecision>(Precision<Tc>::type), batch.batch());
 
-    cl_mem imem            = (*in.get())();
-    cl_mem omem            = (*out.get())();
     cl_command_queue queue = getQueue()();
-
-    CLFFT_CHECK(clfftEnqueueTransform(*plan.get(), CLFFT_FORWARD, 1, &queue, 0,
-                                      NULL, NULL, &imem, &omem, NULL));
+    for (dim_t e = 0; e < batch.executions(); e++) {
+        cl::Buffer ibuf = bufferAt(in, in.getOffset() + batch.inOffset(e));
+        cl::Buffer obuf = bufferAt(out, batch.outOffset(e));
+        cl_mem imem     = ibuf();
+        cl_mem omem     = obuf();
+        CLFFT_CHECK(clfftEnqueueTransform(*plan.get(), CLFFT_FORWARD, 1,
+                                          &queue, 0, NULL, NULL, &imem, &omem,
+                                          NULL));
+    }
 
     return out;
 }
 
 template<typename Tr, typename Tc>
 Array<Tr> fft_c2r(const Array<Tc> &in, const dim4 &odims, const int rank) {
-    Array<Tr> out = createEmptyArray<Tr>(odims);
+    if (!isSupported(rank, odims)) {
+        // The inverse transforms of the other dimensions leave Hermitian
+        // symmetric columns, which are expanded for the last transform
+        Array<Tc> part = fftSeparable<Tc>(in, rank, false, 1);
+        Array<Tc> full = createEmptyArray<Tc>(odims);
+        const int N    = static_cast<int>(odims[0]);
+        kernel::hermitianExpand<Tc>(*full.get(), *part.get(), N,
+                                    static_cast<int>(odims.elements() / N));
+        fftColumns(full, false);
+        return real<Tr, Tc>(full);
+    }
 
-    verifySupported(rank, odims);
+    Array<Tr> out = createEmptyArray<Tr>(odims);
     size_t tdims[AF_MAX_DIMS], istrides[AF_MAX_DIMS], ostrides[AF_MAX_DIMS];
 
     computeDims(tdims, odims);
     computeDims(istrides, in.strides());
     computeDims(ostrides, out.strides());
 
-    int batch = 1;
-    for (int i = rank; i < AF_MAX_DIMS; i++) { batch *= tdims[i]; }
+    const FFTBatch batch(rank, odims, in.strides(), out.strides());
+    if (!isExecutable(batch, in, out)) {
+        return fft_c2r<Tr, Tc>(copyArray<Tc>(in), odims, rank);
+    }
 
     SharedPlan plan = findPlan(
         CLFFT_HERMITIAN_INTERLEAVED, CLFFT_REAL, static_cast<clfftDim>(rank),
-        tdims, istrides, istrides[rank], ostrides, ostrides[rank],
-        static_cast<clfftPrecision>(Precision<Tc>::type), batch);
+        tdims, istrides, batch.idist(), ostrides, batch.odist(),
+        static_cast<clfftPrecision>(Precision<Tc>::type), batch.batch());
 
-    cl_mem imem            = (*in.get())();
-    cl_mem omem            = (*out.get())();
     cl_command_queue queue = getQueue()();
-
-    CLFFT_CHECK(clfftEnqueueTransform(*plan.get(), CLFFT_BACKWARD, 1, &queue, 0,
-                                      NULL, NULL, &imem, &omem, NULL));
+    for (dim_t e = 0; e < batch.executions(); e++) {
+        cl::Buffer ibuf = bufferAt(in, in.getOffset() + batch.inOffset(e));
+        cl::Buffer obuf = bufferAt(out, batch.outOffset(e));
+        cl_mem imem     = ibuf();
+        cl_mem omem     = obuf();
+        CLFFT_CHECK(clfftEnqueueTransform(*plan.get(), CLFFT_BACKWARD, 1,
+                                          &queue, 0, NULL, NULL, &imem, &omem,
+                                          NULL));
+    }
 
     return out;
 }
@@ -17,11 +17,12 @@ namespace opencl {
 
 template<typename T>
 void copy_histogram(const Array<T> &data, fg_histogram hist) {
-    ForgeModule &_ = graphics::forgePlugin();
+    ForgeModule &_          = graphics::forgePlugin();
+    const cl::Buffer *d_P   = data.get();
+    cl::CommandQueue &queue = interopManager().beginCopy();
     if (isGLSharingSupported()) {
         CheckGL("Begin OpenCL resource copy");
-        const cl::Buffer *d_P = data.get();
-        unsigned bytes        = 0;
+        unsigned bytes = 0;
         FG_CHECK(_.fg_get_histogram_vertex_buffer_size(&bytes, hist));
 
         auto res = interopManager().getHistogramResources(hist);
@@ -35,14 +36,14 @@ void copy_histogram(const Array<T> &data, fg_histogram hist) {
         // https://www.khronos.org/registry/cl/sdk/1.1/docs/man/xhtml/clEnqueueReleaseGLObjects.html
         cl::Event event;
 
-        getQueue().enqueueAcquireGLObjects(&shared_objects, NULL, &event);
+        queue.enqueueAcquireGLObjects(&shared_objects, NULL, &event);
         event.wait();
-        getQueue().enqueueCopyBuffer(*d_P, *(res[0].get()), 0, 0, bytes, NULL,
-                                     &event);
-        getQueue().enqueueReleaseGLObjects(&shared_objects, NULL, &event);
+        queue.enqueueCopyBuffer(*d_P, *(res[0].get()), 0, 0, bytes, NULL,
+                                &event);
+        queue.enqueueReleaseGLObjects(&shared_objects, NULL, &event);
         event.wait();
 
-        CL_DEBUG_FINISH(getQueue());
+        CL_DEBUG_FINISH(queue);
         CheckGL("End OpenCL resource copy");
     } else {
         unsigned bytes = 0, buffer = 0;
@@ -54,7 +55,7 @@ void copy_histogram(const Array<T> &data, fg_histogram hist) {
         auto *ptr =
             static_cast<GLubyte *>(glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY));
         if (ptr) {
-            getQueue().enqueueReadBuffer(*data.get(), CL_TRUE, 0, bytes, ptr);
+            queue.enqueueReadBuffer(*d_P, CL_TRUE, 0, bytes, ptr);
             glUnmapBuffer(GL_ARRAY_BUFFER);
         }
         glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -12,6 +12,7 @@
 #include <err_opencl.hpp>
 #include <histogram.hpp>
 #include <kernel/histogram.hpp>
+#include <kernel/histogram2.hpp>
 #include <af/dim4.hpp>
 
 using af::dim4;
@@ -30,6 +31,22 @@ Array<uint> histogram(const Array<T> &in, const unsigned &nbins,
     return out;
 }
 
+template<typename T, typename To>
+Array<To> histogram2(const Array<T> &x, const Array<T> &y,
+                     const Array<float> &weights, const unsigned &xbins,
+                     const unsigned &ybins, const double &xmin,
+                     const double &xmax, const double &ymin,
+                     const double &ymax) {
+    const dim4 &dims = x.dims();
+    Array<To> out =
+        createValueArray<To>(dim4(xbins, ybins, dims[2], dims[3]), To(0));
+    if (x.elements() > 0) {
+        kernel::histogram2<T, To>(out, x, y, weights, xbins, ybins, xmin, xmax,
+                                  ymin, ymax);
+    }
+    return out;
+}
+
 #define INSTANTIATE(T)                                                    \
     template Array<uint> histogram<T>(const Array<T> &, const unsigned &, \
                                       const double &, const double &,     \
@@ -47,4 +64,22 @@ INSTANTIATE(intl)
 INSTANTIATE(uintl)
 INSTANTIATE(half)
 
+#define INSTANTIATE2(T, To)                                                 \
+    template Array<To> histogram2<T, To>(                                   \
+        const Array<T> &, const Array<T> &, const Array<float> &,           \
+        const unsigned &, const unsigned &, const double &, const double &, \
+        const double &, const double &);
+
+#define INSTANTIATE_HISTOGRAM2(T) \
+    INSTANTIATE2(T, uint)         \
+    INSTANTIATE2(T, float)
+
+INSTANTIATE_HISTOGRAM2(float)
+INSTANTIATE_HISTOGRAM2(double)
+INSTANTIATE_HISTOGRAM2(int)
+INSTANTIATE_HISTOGRAM2(uint)
+INSTANTIATE_HISTOGRAM2(uchar)
+INSTANTIATE_HISTOGRAM2(short)
+INSTANTIATE_HISTOGRAM2(ushort)
+
 }  // namespace opencl
@@ -20,14 +20,14 @@ namespace opencl {
 
 template<typename T>
 void copy_image(const Array<T> &in, fg_image image) {
-    ForgeModule &_ = graphics::forgePlugin();
+    ForgeModule &_          = graphics::forgePlugin();
+    const cl::Buffer *d_X   = in.get();
+    cl::CommandQueue &queue = interopManager().beginCopy();
     if (isGLSharingSupported()) {
         CheckGL("Begin opencl resource copy");
 
         auto res = interopManager().getImageResources(image);
 
-        const cl::Buffer *d_X = in.get();
-
         unsigned bytes = 0;
         FG_CHECK(_.fg_get_image_size(&bytes, image));
 
@@ -40,14 +40,14 @@ void copy_image(const Array<T> &in, fg_image image) {
         // https://www.khronos.org/registry/cl/sdk/1.1/docs/man/xhtml/clEnqueueReleaseGLObjects.html
         cl::Event event;
 
-        getQueue().enqueueAcquireGLObjects(&shared_objects, NULL, &event);
+        queue.enqueueAcquireGLObjects(&shared_objects, NULL, &event);
         event.wait();
-        getQueue().enqueueCopyBuffer(*d_X, *(res[0].get()), 0, 0, bytes, NULL,
-                                     &event);
-        getQueue().enqueueReleaseGLObjects(&shared_objects, NULL, &event);
+        queue.enqueueCopyBuffer(*d_X, *(res[0].get()), 0, 0, bytes, NULL,
+                                &event);
+        queue.enqueueReleaseGLObjects(&shared_objects, NULL, &event);
         event.wait();
 
-        CL_DEBUG_FINISH(getQueue());
+        CL_DEBUG_FINISH(queue);
         CheckGL("End opencl resource copy");
     } else {
         CheckGL("Begin OpenCL fallback-resource copy");
@@ -60,7 +60,7 @@ void copy_image(const Array<T> &in, fg_image image) {
         auto *ptr = static_cast<GLubyte *>(
             glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
         if (ptr) {
-            getQueue().enqueueReadBuffer(*in.get(), CL_TRUE, 0, bytes, ptr);
+            queue.enqueueReadBuffer(*d_X, CL_TRUE, 0, bytes, ptr);
             glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
         }
         glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
@@ -13,13 +13,14 @@
 
 #if defined(WITH_LINEAR_ALGEBRA)
 #include <cpu/cpu_inverse.hpp>
+#include <offload.hpp>
 #include <platform.hpp>
 
 namespace opencl {
 
 template<typename T>
 Array<T> inverse(const Array<T> &in) {
-    if (OpenCLCPUOffload()) {
+    if (OpenCLCPUOffload(OffloadOp::Inverse, in)) {
         if (in.dims()[0] == in.dims()[1]) { return cpu::inverse(in); }
     }
     Array<T> I = identity<T>(in.dims());
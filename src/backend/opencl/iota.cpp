@@ -7,13 +7,14 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 #include <iota.hpp>
-#include <kernel/iota.hpp>
 
 #include <Array.hpp>
 #include <common/half.hpp>
+#include <common/jit/IndexNode.hpp>
 #include <err_opencl.hpp>
 #include <math.hpp>
 
+#include <memory>
 #include <stdexcept>
 
 using common::half;
@@ -23,10 +24,9 @@ template<typename T>
 Array<T> iota(const dim4 &dims, const dim4 &tile_dims) {
     dim4 outdims = dims * tile_dims;
 
-    Array<T> out = createEmptyArray<T>(outdims);
-    kernel::iota<T>(out, dims);
-
-    return out;
+    return createNodeArray<T>(
+        outdims, std::make_shared<common::IndexNode<T>>(common::IndexParams(
+                     common::IndexKind::Iota, outdims, 0, dims)));
 }
 
 #define INSTANTIATE(T) \
@@ -8,8 +8,10 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <common/Profiler.hpp>
 #include <common/compile_module.hpp>
 #include <common/dispatch.hpp>
+#include <common/jit/JitStats.hpp>
 #include <common/jit/Node.hpp>
 #include <common/kernel_cache.hpp>
 #include <common/util.hpp>
@@ -17,6 +19,7 @@
 #include <device_manager.hpp>
 #include <err_opencl.hpp>
 #include <kernel_headers/jit.hpp>
+#include <profiled_launch.hpp>
 #include <af/dim4.hpp>
 #include <af/opencl.h>
 
@@ -26,8 +29,10 @@
 #include <vector>
 
 using common::getFuncName;
+using common::getTreeString;
 using common::Node;
 using common::Node_ids;
+using common::Node_hash_map_t;
 using common::Node_map_t;
 
 using cl::Kernel;
@@ -36,10 +41,78 @@ using cl::NullRange;
 
 using std::string;
 using std::stringstream;
+using std::to_string;
 using std::vector;
 
 namespace opencl {
 
+namespace {
+
+/// The number of consecutive elements computed by a work item of the linear
+/// kernels
+constexpr int vecWidth = 4;
+
+// vloadn and vstoren take pointers to any scalar type and only need them to
+// be aligned to the scalar. The half values are read and written as float
+// vectors by vload_half and vstore_half, and the complex values as vectors of
+// twice as many real values.
+
+/// The type of the vectors of vecWidth values of \p node
+string vecType(const Node &node) {
+    switch (node.getType()) {
+        case c32: return "float" + to_string(2 * vecWidth);
+        case c64: return "double" + to_string(2 * vecWidth);
+        case f16: return "float" + to_string(vecWidth);
+        default: return node.getTypeStr() + to_string(vecWidth);
+    }
+}
+
+/// The expression which reads the vector of values of \p node at \p ptr
+string vecLoad(const Node &node, const string &ptr) {
+    const string width  = to_string(vecWidth);
+    const string cwidth = to_string(2 * vecWidth);
+    switch (node.getType()) {
+        case c32:
+            return "vload" + cwidth + "(0, (__global float *)(" + ptr + "))";
+        case c64:
+            return "vload" + cwidth + "(0, (__global double *)(" + ptr + "))";
+        case f16: return "vload_half" + width + "(0, " + ptr + ")";
+        default: return "vload" + width + "(0, " + ptr + ")";
+    }
+}
+
+/// The statement which writes the vector \p vec of values of \p node at
+/// \p ptr
+string vecStore(const Node &node, const string &vec, const string &ptr) {
+    const string width  = to_string(vecWidth);
+    const string cwidth = to_string(2 * vecWidth);
+    switch (node.getType()) {
+        case c32:
+            return "vstore" + cwidth + "(" + vec + ", 0, (__global float *)(" +
+                   ptr + "));\n";
+        case c64:
+            return "vstore" + cwidth + "(" + vec + ", 0, (__global double *)(" +
+                   ptr + "));\n";
+        case f16:
+            return "vstore_half" + width + "(" + vec + ", 0, " + ptr + ");\n";
+        default: return "vstore" + width + "(" + vec + ", 0, " + ptr + ");\n";
+    }
+}
+
+/// The components of the vector of \p node which hold the value \p k
+string vecComponents(const Node &node, int k) {
+    if (node.getType() == c32 || node.getType() == c64) {
+        return ".s" + to_string(2 * k) + to_string(2 * k + 1);
+    }
+    return ".s" + to_string(k);
+}
+
+}  // namespace
+
+/// Generates the kernel of the trees. The linear kernels compute vecWidth
+/// consecutive elements per work item. They read each buffer with one vector
+/// load and write each output with one vector store, and the elements after
+/// the last full vector are computed one at a time.
 string getKernelString(const string &funcName, const vector<Node *> &full_nodes,
                        const vector<Node_ids> &full_ids,
                        const vector<int> &output_ids, bool is_linear) {
@@ -55,8 +128,10 @@ string getKernelString(const string &funcName, const vector<Node *> &full_nodes,
     static const char *linearIndex = R"JIT(
         uint groupId  = get_group_id(1) * get_num_groups(0) + get_group_id(0);
         uint threadId = get_local_id(0);
-        int idx = groupId * get_local_size(0) * get_local_size(1) + threadId;
-        if (idx >= oInfo.dims[3] * oInfo.strides[3]) return;
+        int base = (groupId * get_local_size(0) * get_local_size(1) +
+                    threadId) * VEC_WIDTH;
+        int elements = oInfo.dims[3] * oInfo.strides[3];
+        if (base >= elements) return;
         )JIT";
 
     static const char *generalIndex = R"JIT(
@@ -106,16 +181,70 @@ string getKernelString(const string &funcName, const vector<Node *> &full_nodes,
         node->genFuncs(opsStream, ids_curr);
     }
 
-    for (int id : output_ids) {
+    // The outputs are named by their index because equal outputs are merged
+    // into the same node
+    for (size_t k = 0; k < output_ids.size(); k++) {
+        const int id = output_ids[k];
         // Generate output parameters
         outParamStream << "__global " << full_nodes[id]->getTypeStr() << " *out"
-                       << id << ", \n";
+                       << k << ", \n";
         // Generate code to write the output
-        outWriteStream << "out" << id << "[idx] = val" << id << ";\n";
+        outWriteStream << "out" << k << "[idx] = val" << id << ";\n";
+    }
+
+    // The buffers are read into vectors before the blocks which compute the
+    // elements of the vectors, and the values of the outputs are collected
+    // into vectors written after them
+    stringstream vecLoadStream;
+    stringstream vecOpsStream;
+    stringstream vecStoreStream;
+    if (is_linear) {
+        for (int k = 0; k < vecWidth; k++) {
+            vecOpsStream << "{\nint idx = base + " << k << ";\n";
+            for (size_t i = 0; i < full_nodes.size(); i++) {
+                const auto &node = full_nodes[i];
+                const int id     = full_ids[i].id;
+                if (node->isBuffer()) {
+                    const string vin = "vin" + to_string(id);
+                    if (k == 0) {
+                        vecLoadStream << vecType(*node) << " " << vin << " = "
+                                      << vecLoad(*node, "in" + to_string(id) +
+                                                            " + iInfo" +
+                                                            to_string(id) +
+                                                            "_offset + base")
+                                      << ";\n";
+                    }
+                    vecOpsStream << node->getTypeStr() << " val" << id
+                                 << " = ";
+                    if (node->getType() == f16) { vecOpsStream << "(half)"; }
+                    vecOpsStream << vin << vecComponents(*node, k) << ";\n";
+                } else {
+                    node->genOffsets(vecOpsStream, id, true);
+                    node->genFuncs(vecOpsStream, full_ids[i]);
+                }
+            }
+            for (size_t o = 0; o < output_ids.size(); o++) {
+                const int id      = output_ids[o];
+                const auto &node  = *full_nodes[id];
+                const string vout = "vout" + to_string(o);
+                vecOpsStream << vout << vecComponents(node, k) << " = ";
+                if (node.getType() == f16) { vecOpsStream << "(float)"; }
+                vecOpsStream << "val" << id << ";\n";
+            }
+            vecOpsStream << "}\n";
+        }
+        for (size_t o = 0; o < output_ids.size(); o++) {
+            const auto &node  = *full_nodes[output_ids[o]];
+            const string vout = "vout" + to_string(o);
+            vecLoadStream << vecType(node) << " " << vout << ";\n";
+            vecStoreStream << vecStore(node, vout,
+                                       "out" + to_string(o) + " + base");
+        }
     }
 
     // Put various blocks into a single stream
     stringstream kerStream;
+    kerStream << "#define VEC_WIDTH " << vecWidth << "\n";
     kerStream << kernelVoid;
     kerStream << funcName;
     kerStream << "(\n";
@@ -126,23 +255,122 @@ string getKernelString(const string &funcName, const vector<Node *> &full_nodes,
     kerStream << blockStart;
     if (is_linear) {
         kerStream << linearIndex;
+        kerStream << "if (base + VEC_WIDTH <= elements) {\n";
+        kerStream << vecLoadStream.str();
+        kerStream << vecOpsStream.str();
+        kerStream << vecStoreStream.str();
+        kerStream << "} else {\n";
+        kerStream << "for (int idx = base; idx < elements; ++idx) {\n";
+        kerStream << offsetsStream.str();
+        kerStream << opsStream.str();
+        kerStream << outWriteStream.str();
+        kerStream << "}\n}\n";
     } else {
         kerStream << generalIndex;
+        kerStream << offsetsStream.str();
+        kerStream << opsStream.str();
+        kerStream << outWriteStream.str();
     }
-    kerStream << offsetsStream.str();
-    kerStream << opsStream.str();
-    kerStream << outWriteStream.str();
     kerStream << blockEnd;
 
     return kerStream.str();
 }
 
+/// Generates a kernel which evaluates several linear trees with different
+/// numbers of elements. The work items are split between the trees by the
+/// ends of their ranges of indices, which are passed after each output.
+string getBatchKernelString(const string &funcName,
+                            const vector<Node *> &full_nodes,
+                            const vector<Node_ids> &full_ids,
+                            const vector<int> &output_ids,
+                            const vector<vector<int>> &tree_ids) {
+    stringstream inParamStream;
+    stringstream outParamStream;
+    stringstream treesStream;
+
+    for (size_t i = 0; i < full_nodes.size(); i++) {
+        full_nodes[i]->genParams(inParamStream, full_ids[i].id, true);
+    }
+
+    for (size_t k = 0; k < output_ids.size(); k++) {
+        const int id = output_ids[k];
+        if (k > 0) { outParamStream << ",\n"; }
+        outParamStream << "__global " << full_nodes[id]->getTypeStr()
+                       << " *out" << k << ", int end" << k;
+
+        // Each tree only generates the code of its own nodes
+        treesStream << (k == 0 ? "if" : "else if") << " (gidx < end" << k
+                    << ") {\n";
+        treesStream << "int idx = gidx";
+        if (k > 0) { treesStream << " - end" << k - 1; }
+        treesStream << ";\n";
+        for (int i : tree_ids[k]) {
+            full_nodes[i]->genOffsets(treesStream, full_ids[i].id, true);
+        }
+        for (int i : tree_ids[k]) {
+            full_nodes[i]->genFuncs(treesStream, full_ids[i]);
+        }
+        treesStream << "out" << k << "[idx] = val" << id << ";\n}\n";
+    }
+
+    stringstream kerStream;
+    kerStream << "__kernel void\n";
+    kerStream << funcName;
+    kerStream << "(\n";
+    kerStream << inParamStream.str();
+    kerStream << outParamStream.str();
+    kerStream << ")\n{\n";
+    kerStream << R"JIT(
+        uint groupId = get_group_id(1) * get_num_groups(0) + get_group_id(0);
+        int gidx     = groupId * get_local_size(0) + get_local_id(0);
+        )JIT";
+    kerStream << treesStream.str();
+    kerStream << "}\n";
+
+    return kerStream.str();
+}
+
+cl::Kernel getBatchKernel(const vector<Node *> &output_nodes,
+                          const vector<int> &output_ids,
+                          const vector<Node *> &full_nodes,
+                          const vector<Node_ids> &full_ids,
+                          const vector<vector<int>> &tree_ids) {
+    const string funcName  = "B" + getFuncName(output_nodes, full_ids, true);
+    const string moduleKey = std::to_string(deterministicHash(funcName));
+
+    auto entry = common::findModule(getActiveDeviceId(), moduleKey);
+
+    if (!entry) {
+        static const string jit(jit_cl, jit_cl_len);
+
+        string jitKer = getBatchKernelString(funcName, full_nodes, full_ids,
+                                             output_ids, tree_ids);
+        int device    = getActiveDeviceId();
+        vector<string> options;
+        if (isDoubleSupported(device)) {
+            options.emplace_back(DefineKey(USE_DOUBLE));
+        }
+        if (isHalfSupported(device)) {
+            options.emplace_back(DefineKey(USE_HALF));
+        }
+        saveKernel(funcName, jitKer, ".cl");
+
+        return common::getKernel(funcName, {jit, jitKer}, {}, options, true)
+            .get();
+    }
+    common::recordKernelCacheLookup(getActiveDeviceId(), true);
+    return common::getKernel(entry, funcName, true).get();
+}
+
 cl::Kernel getKernel(const vector<Node *> &output_nodes,
                      const vector<int> &output_ids,
                      const vector<Node *> &full_nodes,
                      const vector<Node_ids> &full_ids, const bool is_linear) {
+    // The vectorized linear kernels are launched with fewer work items than
+    // the scalar ones, so they must not be mistaken for scalar kernels cached
+    // on disk by earlier builds
     const string funcName =
-        getFuncName(output_nodes, full_nodes, full_ids, is_linear);
+        (is_linear ? "V" : "") + getFuncName(output_nodes, full_ids, is_linear);
     const string moduleKey = std::to_string(deterministicHash(funcName));
 
     // A forward lookup in module cache helps avoid recompiling the jit
@@ -164,11 +392,15 @@ cl::Kernel getKernel(const vector<Node *> &output_nodes,
             options.emplace_back(DefineKey(USE_HALF));
         }
 
-        saveKernel(funcName, jitKer, ".cl");
+        // The saved kernel starts with the description of the tree
+        const string tree =
+            getTreeString(output_nodes, full_nodes, full_ids, is_linear);
+        saveKernel(funcName, "// " + tree + "\n" + jitKer, ".cl");
 
         return common::getKernel(funcName, {jit, jitKer}, {}, options, true)
             .get();
     }
+    common::recordKernelCacheLookup(getActiveDeviceId(), true);
     return common::getKernel(entry, funcName, true).get();
 }
 
@@ -181,6 +413,7 @@ void evalNodes(vector<Param> &outputs, const vector<Node *> &output_nodes) {
 
     // Use thread local to reuse the memory every time you are here.
     thread_local Node_map_t nodes;
+    thread_local Node_hash_map_t hashes;
     thread_local vector<Node *> full_nodes;
     thread_local vector<Node_ids> full_ids;
     thread_local vector<int> output_ids;
@@ -188,15 +421,19 @@ void evalNodes(vector<Param> &outputs, const vector<Node *> &output_nodes) {
     // Reserve some space to improve performance at smaller sizes
     if (nodes.empty()) {
         nodes.reserve(1024);
+        hashes.reserve(1024);
         output_ids.reserve(output_nodes.size());
         full_nodes.reserve(1024);
         full_ids.reserve(1024);
     }
 
     for (auto &node : output_nodes) {
-        int id = node->getNodesMap(nodes, full_nodes, full_ids);
+        int id = node->getNodesMap(nodes, full_nodes, full_ids, hashes);
         output_ids.push_back(id);
     }
+    const int device = getActiveDeviceId();
+    common::recordJitEval(device);
+    common::recordJitFusion(device, full_nodes.size());
 
     bool is_linear = true;
     for (auto node : full_nodes) {
@@ -229,7 +466,7 @@ void evalNodes(vector<Param> &outputs, const vector<Node *> &output_nodes) {
     if (is_linear) {
         local_0           = work_group_size;
         uint out_elements = out_info.dims[3] * out_info.strides[3];
-        uint groups       = divup(out_elements, local_0);
+        uint groups       = divup(divup(out_elements, vecWidth), local_0);
 
         global_1 = divup(groups, 1000) * local_1;
         global_0 = divup(groups, global_1) * local_0;
@@ -270,15 +507,89 @@ void evalNodes(vector<Param> &outputs, const vector<Node *> &output_nodes) {
     ker.setArg(nargs + 2, groups_1);
     ker.setArg(nargs + 3, num_odims);
 
-    getQueue().enqueueNDRangeKernel(ker, NullRange, global, local);
+    if (common::isProfiling()) {
+        cl::Event done;
+        getQueue().enqueueNDRangeKernel(ker, NullRange, global, local, nullptr,
+                                        &done);
+        addProfiledLaunch(done, ker);
+    } else {
+        getQueue().enqueueNDRangeKernel(ker, NullRange, global, local);
+    }
 
     // Reset the thread local vectors
     nodes.clear();
+    hashes.clear();
     output_ids.clear();
     full_nodes.clear();
     full_ids.clear();
 }
 
+void evalNodesBatched(vector<Param> &outputs,
+                      const vector<Node *> &output_nodes) {
+    if (outputs.empty()) { return; }
+    const int device = getActiveDeviceId();
+
+    Node_map_t nodes;
+    Node_hash_map_t hashes;
+    vector<Node *> full_nodes;
+    vector<Node_ids> full_ids;
+    vector<int> output_ids;
+    vector<vector<int>> tree_ids;
+
+    for (auto &node : output_nodes) {
+        output_ids.push_back(
+            node->getNodesMap(nodes, full_nodes, full_ids, hashes));
+    }
+    for (auto &node : output_nodes) {
+        tree_ids.push_back(common::getTreeIds(node, nodes));
+    }
+    common::recordJitEval(device);
+    common::recordJitFusion(device, full_nodes.size());
+
+    auto ker = getBatchKernel(output_nodes, output_ids, full_nodes, full_ids,
+                              tree_ids);
+
+    // The end of the range of indices of each output
+    vector<int> ends;
+    int elements = 0;
+    for (const auto &out : outputs) {
+        elements += static_cast<int>(out.info.dims[0] * out.info.dims[1] *
+                                     out.info.dims[2] * out.info.dims[3]);
+        ends.push_back(elements);
+    }
+
+    // CPUs seem to perform better with work group size 1024
+    const uint local_0 =
+        (getActiveDeviceType() == AFCL_DEVICE_TYPE_CPU) ? 1024 : 256;
+    const uint groups   = divup(elements, local_0);
+    const uint global_1 = divup(groups, 1000);
+    const uint global_0 = divup(groups, global_1) * local_0;
+
+    NDRange local(local_0, 1);
+    NDRange global(global_0, global_1);
+
+    int nargs = 0;
+    for (const auto &node : full_nodes) {
+        nargs = node->setArgs(nargs, true,
+                              [&](int id, const void *ptr, size_t arg_size) {
+                                  ker.setArg(id, arg_size, ptr);
+                              });
+    }
+    for (size_t k = 0; k < outputs.size(); k++) {
+        ker.setArg(nargs++, *(outputs[k].data));
+        ker.setArg(nargs++, ends[k]);
+    }
+
+    if (common::isProfiling()) {
+        cl::Event done;
+        getQueue().enqueueNDRangeKernel(ker, NullRange, global, local, nullptr,
+                                        &done);
+        addProfiledLaunch(done, ker);
+    } else {
+        getQueue().enqueueNDRangeKernel(ker, NullRange, global, local);
+    }
+}
+
 void evalNodes(Param &out, Node *node) {
     vector<Param> outputs{out};
     vector<Node *> nodes{node};
@@ -98,6 +98,64 @@ inline void generateShiftNodeOffsets(std::stringstream& kerStream, int id,
               << ".dims[0]) * " << id_str << "0 + " << info_str << ".offset;\n";
 }
 
+/// Generates the code to calculate the offsets for a tiled buffer
+inline void generateTileNodeOffsets(std::stringstream& kerStream, int id,
+                                    bool is_linear,
+                                    const std::string& type_str) {
+    UNUSED(is_linear);
+    UNUSED(type_str);
+    std::string idx_str  = std::string("idx") + std::to_string(id);
+    std::string info_str = std::string("iInfo") + std::to_string(id);
+
+    kerStream << "int " << idx_str << " = (id3 % " << info_str
+              << ".dims[3]) * " << info_str << ".strides[3];\n";
+    kerStream << idx_str << " += (id2 % " << info_str << ".dims[2]) * "
+              << info_str << ".strides[2];\n";
+    kerStream << idx_str << " += (id1 % " << info_str << ".dims[1]) * "
+              << info_str << ".strides[1];\n";
+    kerStream << idx_str << " += id0 % " << info_str << ".dims[0] + "
+              << info_str << ".offset;\n";
+}
+
+/// Generates the code to calculate the index of the element of a random node.
+/// It is the linear index of the element in the output, whose values are
+/// contiguous like the values of the random array.
+inline void generateRandomNodeOffsets(std::stringstream& kerStream, int id,
+                                      bool is_linear) {
+    kerStream << "uint rid" << id << " = ";
+    if (is_linear) {
+        kerStream << "idx;\n";
+    } else {
+        kerStream << "id0 + oInfo.dims[0] * (id1 + oInfo.dims[1] * "
+                     "(id2 + oInfo.dims[2] * id3));\n";
+    }
+}
+
+/// Generates the code to read a buffer at the indices in the value of the
+/// node \p idx_id along the dimension \p dim
+inline void generateGatherNodeRead(std::stringstream& kerStream, int id,
+                                   int idx_id, int dim,
+                                   const std::string& type_str) {
+    std::string idx_str  = std::string("idx") + std::to_string(id);
+    std::string info_str = std::string("iInfo") + std::to_string(id);
+
+    kerStream << "int " << idx_str << " = " << info_str << ".offset;\n";
+    for (int i = 0; i < 4; i++) {
+        std::string dims_str = info_str + ".dims[" + std::to_string(i) + "]";
+        kerStream << idx_str << " += " << info_str << ".strides[" << i
+                  << "] * ";
+        if (i == dim) {
+            kerStream << "__trim_index((int)val" << idx_id << ", "
+                      << dims_str << ");\n";
+        } else {
+            kerStream << "(id" << i << " < " << dims_str << ") * id" << i
+                      << ";\n";
+        }
+    }
+    kerStream << type_str << " val" << id << " = in" << id << "[" << idx_str
+              << "];\n";
+}
+
 inline void generateShiftNodeRead(std::stringstream& kerStream, int id,
                                   const std::string& type_str) {
     kerStream << type_str << " val" << id << " = in" << id << "[idx" << id
@@ -7,8 +7,6 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
-int lIndex(const int j, const int i) { return j * SHRD_MEM_WIDTH + i; }
-
 int gIndex(const int x, const int y, const int dim0, const int dim1,
            const int stride0, const int stride1) {
     return clamp(x, 0, dim0 - 1) * stride0 + clamp(y, 0, dim1 - 1) * stride1;
@@ -118,14 +116,82 @@ float curvatureUpdate(const float mct, const float C, const float S,
     return sqrt(prop_grad) * delta;
 }
 
-kernel void aisoDiffUpdate(global T* inout, KParam info, const float dt,
-                           const float mct, unsigned blkX, unsigned blkY) {
-    local T localMem[SHRD_MEM_HEIGHT][SHRD_MEM_WIDTH];
+void atomicAddLocal(volatile local float *ptr, const float val) {
+    union {
+        unsigned int intVal;
+        float floatVal;
+    } newVal, prevVal, expVal;
+
+    prevVal.floatVal = *ptr;
+    do {
+        expVal.floatVal = prevVal.floatVal;
+        newVal.floatVal = expVal.floatVal + val;
+        prevVal.intVal  = atomic_cmpxchg((volatile local unsigned int *)ptr,
+                                        expVal.intVal, newVal.intVal);
+    } while (expVal.intVal != prevVal.intVal);
+}
+
+void atomicAddGlobal(volatile global float *ptr, const float val) {
+    union {
+        unsigned int intVal;
+        float floatVal;
+    } newVal, prevVal, expVal;
+
+    prevVal.floatVal = *ptr;
+    do {
+        expVal.floatVal = prevVal.floatVal;
+        newVal.floatVal = expVal.floatVal + val;
+        prevVal.intVal  = atomic_cmpxchg((volatile global unsigned int *)ptr,
+                                        expVal.intVal, newVal.intVal);
+    } while (expVal.intVal != prevVal.intVal);
+}
+
+// The sum of the squared gradients at the pixel u of an image with rows of
+// pitch elements in local memory. The gradients are the central differences
+// of the gradient function, one sided at the borders of the image.
+float gradientEnergy(local const float *u, const int pitch, const int x,
+                     const int y, const int dim0, const int dim1) {
+    float g0 = 0.0f;
+    float g1 = 0.0f;
+    if (dim0 > 1) {
+        if (x == 0) {
+            g0 = u[1] - u[0];
+        } else if (x == dim0 - 1) {
+            g0 = u[0] - u[-1];
+        } else {
+            g0 = 0.5f * (u[1] - u[-1]);
+        }
+    }
+    if (dim1 > 1) {
+        if (y == 0) {
+            g1 = u[pitch] - u[0];
+        } else if (y == dim1 - 1) {
+            g1 = u[0] - u[-pitch];
+        } else {
+            g1 = 0.5f * (u[pitch] - u[-pitch]);
+        }
+    }
+    return g0 * g0 + g1 * g1;
+}
+
+// One timestep of the diffusion from in to out, see the diffUpdate kernel of
+// the CUDA backend. The tile is loaded with a halo of two pixels, so the
+// gradient energy of the updated tile, which scales the next step, is
+// computed by the same launch. If UPDATE_IMAGE is 0 only the gradient energy
+// of in is added to energy[iter % 3].
+kernel void aisoDiffUpdate(global T *d_out, KParam out, global const T *d_in,
+                           KParam in, const float dt, const float mctScale,
+                           global float *energy, const unsigned iter,
+                           const int accumulate, unsigned blkX,
+                           unsigned blkY) {
+    local float inTile[IN_H][IN_W];
+#if UPDATE_IMAGE == 1
+    local float upTile[UP_H][UP_W];
+#endif
+    local float blkEnergy;
 
-    const int l0 = info.dims[0];
-    const int l1 = info.dims[1];
-    const int s0 = info.strides[0];
-    const int s1 = info.strides[1];
+    const int l0 = in.dims[0];
+    const int l1 = in.dims[1];
 
     const int lx = get_local_id(0);
     const int ly = get_local_id(1);
@@ -133,43 +199,73 @@ kernel void aisoDiffUpdate(global T* inout, KParam info, const float dt,
     const int b2 = get_group_id(0) / blkX;
     const int b3 = get_group_id(1) / blkY;
 
-    const int gx = get_local_size(0) * (get_group_id(0) - b2 * blkX) + lx;
-    int gy       = get_local_size(1) * (get_group_id(1) - b3 * blkY) + ly;
+    const int ox = TILE_W * (get_group_id(0) - b2 * blkX);
+    const int oy = TILE_H * (get_group_id(1) - b3 * blkY);
 
-    global T* img =
-        inout + (b3 * info.strides[3] + b2 * info.strides[2]) + info.offset;
+    global const T *iptr =
+        d_in + (b3 * in.strides[3] + b2 * in.strides[2]) + in.offset;
+    global T *optr =
+        d_out + (b3 * out.strides[3] + b2 * out.strides[2]) + out.offset;
 
-    for (int b = ly, gy2 = gy - 1; b < SHRD_MEM_HEIGHT;
-         b += get_local_size(1), gy2 += get_local_size(1)) {
-        for (int a = lx, gx2 = gx - 1; a < SHRD_MEM_WIDTH;
-             a += get_local_size(0), gx2 += get_local_size(0)) {
-            localMem[b][a] = img[gIndex(gx2, gy2, l0, l1, s0, s1)];
+    for (int b = ly; b < IN_H; b += get_local_size(1)) {
+        for (int a = lx; a < IN_W; a += get_local_size(0)) {
+            inTile[b][a] = iptr[gIndex(ox + a - HALO, oy + b - HALO, l0, l1,
+                                       in.strides[0], in.strides[1])];
         }
     }
-
+    if (lx == 0 && ly == 0) { blkEnergy = 0.0f; }
     barrier(CLK_LOCAL_MEM_FENCE);
 
-    int i = lx + 1;
-    int j = ly + 1;
+#if UPDATE_IMAGE == 1
+    if (get_group_id(0) == 0 && get_group_id(1) == 0 && lx == 0 && ly == 0) {
+        energy[(iter + 2) % 3] = 0.0f;
+    }
+    const float mct = mctScale / energy[iter % 3];
 
-#pragma unroll
-    for (int ld = 0; ld < YDIM_LOAD;
-         ++ld, j += get_local_size(1), gy += get_local_size(1)) {
-        float C     = localMem[j][i];
-        float delta = 0;
+    for (int b = ly; b < UP_H; b += get_local_size(1)) {
+        for (int a = lx; a < UP_W; a += get_local_size(0)) {
+            const int i = a + 1;
+            const int j = b + 1;
+            float C     = inTile[j][i];
 #if IS_MCDE == 1
-        delta = curvatureUpdate(mct, C, localMem[j][i + 1], localMem[j][i - 1],
-                                localMem[j - 1][i], localMem[j + 1][i],
-                                localMem[j + 1][i + 1], localMem[j - 1][i + 1],
-                                localMem[j + 1][i - 1], localMem[j - 1][i - 1]);
+            float delta = curvatureUpdate(
+                mct, C, inTile[j][i + 1], inTile[j][i - 1], inTile[j - 1][i],
+                inTile[j + 1][i], inTile[j + 1][i + 1], inTile[j - 1][i + 1],
+                inTile[j + 1][i - 1], inTile[j - 1][i - 1]);
 #else
-        delta = gradientUpdate(mct, C, localMem[j][i + 1], localMem[j][i - 1],
-                               localMem[j - 1][i], localMem[j + 1][i],
-                               localMem[j + 1][i + 1], localMem[j - 1][i + 1],
-                               localMem[j + 1][i - 1], localMem[j - 1][i - 1]);
+            float delta = gradientUpdate(
+                mct, C, inTile[j][i + 1], inTile[j][i - 1], inTile[j - 1][i],
+                inTile[j + 1][i], inTile[j + 1][i + 1], inTile[j - 1][i + 1],
+                inTile[j + 1][i - 1], inTile[j - 1][i - 1]);
+#endif
+            upTile[b][a] = (float)((T)(C + delta * dt));
+        }
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
 #endif
-        if (gx < l0 && gy < l1) {
-            img[gx * s0 + gy * s1] = (T)(C + delta * dt);
+
+    const int gx = ox + lx;
+    float sum    = 0.0f;
+    for (int ld = 0; ld < YDIM_LOAD; ++ld) {
+        const int ty = ly + ld * get_local_size(1);
+        const int gy = oy + ty;
+        if (gx >= l0 || gy >= l1) continue;
+
+#if UPDATE_IMAGE == 1
+        local const float *u = &upTile[ty + 1][lx + 1];
+        optr[gx * out.strides[0] + gy * out.strides[1]] = (T)(*u);
+        if (accumulate) { sum += gradientEnergy(u, UP_W, gx, gy, l0, l1); }
+#else
+        local const float *u = &inTile[ty + HALO][lx + HALO];
+        if (accumulate) { sum += gradientEnergy(u, IN_W, gx, gy, l0, l1); }
+#endif
+    }
+
+    if (accumulate) {
+        atomicAddLocal(&blkEnergy, sum);
+        barrier(CLK_LOCAL_MEM_FENCE);
+        if (lx == 0 && ly == 0) {
+            atomicAddGlobal(energy + (iter + UPDATE_IMAGE) % 3, blkEnergy);
         }
     }
 }
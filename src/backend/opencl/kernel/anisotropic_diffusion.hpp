@@ -14,6 +14,7 @@
 #include <common/kernel_cache.hpp>
 #include <debug_opencl.hpp>
 #include <kernel_headers/anisotropic_diffusion.hpp>
+#include <memory.hpp>
 #include <traits.hpp>
 
 #include <string>
@@ -22,17 +23,25 @@
 namespace opencl {
 namespace kernel {
 
+constexpr int THREADS_X = 32;
+constexpr int THREADS_Y = 8;
+constexpr int YDIM_LOAD = 2 * THREADS_X / THREADS_Y;
+
+/// Launches one timestep of the diffusion from \p in to \p out, or only the
+/// gradient energy of \p in if \p update is false (see aisoDiffUpdate)
 template<typename T, bool isMCDE>
-void anisotropicDiffusion(Param inout, const float dt, const float mct,
-                          const int fluxFnCode) {
+void diffusionStep(Param out, const Param in, cl::Buffer *energy,
+                   const float dt, const float mctScale, const unsigned iter,
+                   const bool accumulate, const int fluxFnCode,
+                   const bool update) {
     using cl::EnqueueArgs;
     using cl::NDRange;
     using std::string;
     using std::vector;
 
-    constexpr int THREADS_X = 32;
-    constexpr int THREADS_Y = 8;
-    constexpr int YDIM_LOAD = 2 * THREADS_X / THREADS_Y;
+    constexpr int TILE_W = THREADS_X;
+    constexpr int TILE_H = THREADS_Y * YDIM_LOAD;
+    constexpr int HALO   = 2;
 
     static const string src(anisotropic_diffusion_cl,
                             anisotropic_diffusion_cl_len);
@@ -41,13 +50,20 @@ void anisotropicDiffusion(Param inout, const float dt, const float mct,
         TemplateTypename<T>(),
         TemplateArg(isMCDE),
         TemplateArg(fluxFnCode),
+        TemplateArg(update),
     };
     vector<string> compileOpts = {
         DefineKeyValue(T, dtype_traits<T>::getName()),
-        DefineKeyValue(SHRD_MEM_HEIGHT, (THREADS_Y * YDIM_LOAD + 2)),
-        DefineKeyValue(SHRD_MEM_WIDTH, (THREADS_X + 2)),
+        DefineValue(TILE_W),
+        DefineValue(TILE_H),
+        DefineValue(HALO),
+        DefineKeyValue(IN_W, (TILE_W + 2 * HALO)),
+        DefineKeyValue(IN_H, (TILE_H + 2 * HALO)),
+        DefineKeyValue(UP_W, (TILE_W + 2)),
+        DefineKeyValue(UP_H, (TILE_H + 2)),
         DefineKeyValue(IS_MCDE, isMCDE),
         DefineKeyValue(FLUX_FN, fluxFnCode),
+        DefineKeyValue(UPDATE_IMAGE, update),
         DefineValue(YDIM_LOAD),
     };
     compileOpts.emplace_back(getTypeBuildDefinition<T>());
@@ -57,16 +73,42 @@ void anisotropicDiffusion(Param inout, const float dt, const float mct,
 
     NDRange local(THREADS_X, THREADS_Y, 1);
 
-    int blkX = divup(inout.info.dims[0], local[0]);
-    int blkY = divup(inout.info.dims[1], local[1] * YDIM_LOAD);
+    int blkX = divup(in.info.dims[0], TILE_W);
+    int blkY = divup(in.info.dims[1], TILE_H);
 
-    NDRange global(local[0] * blkX * inout.info.dims[2],
-                   local[1] * blkY * inout.info.dims[3], 1);
+    NDRange global(local[0] * blkX * in.info.dims[2],
+                   local[1] * blkY * in.info.dims[3], 1);
 
-    diffUpdate(EnqueueArgs(getQueue(), global, local), *inout.data, inout.info,
-               dt, mct, blkX, blkY);
+    diffUpdate(EnqueueArgs(getQueue(), global, local), *out.data, out.info,
+               *in.data, in.info, dt, mctScale, *energy, iter,
+               static_cast<int>(accumulate), blkX, blkY);
     CL_DEBUG_FINISH(getQueue());
 }
 
+/// Diffuses \p inout for \p iterations timesteps, using \p tmp as the
+/// second buffer of the steps. The gradient energy which scales the
+/// conductance of each step is computed by the previous step, so the steps
+/// are enqueued without reading anything back.
+///
+/// \returns true if the result is in \p tmp
+template<typename T, bool isMCDE>
+bool anisotropicDiffusion(Param inout, Param tmp, const float dt,
+                          const float mctScale, const unsigned iterations,
+                          const int fluxFnCode) {
+    auto energy = memAlloc<float>(3);
+    getQueue().enqueueFillBuffer(*energy, 0.0f, 0, 3 * sizeof(float));
+
+    diffusionStep<T, isMCDE>(tmp, inout, energy.get(), dt, mctScale, 0, true,
+                             fluxFnCode, false);
+
+    Param bufs[2] = {inout, tmp};
+    for (unsigned it = 0; it < iterations; ++it) {
+        diffusionStep<T, isMCDE>(bufs[(it + 1) % 2], bufs[it % 2],
+                                 energy.get(), dt, mctScale, it,
+                                 it + 1 < iterations, fluxFnCode, true);
+    }
+    return iterations % 2 == 1;
+}
+
 }  // namespace kernel
 }  // namespace opencl
@@ -13,6 +13,7 @@
 #include <common/dispatch.hpp>
 #include <common/kernel_cache.hpp>
 #include <debug_opencl.hpp>
+#include <kernel/converge.hpp>
 #include <kernel_headers/nonmax_suppression.hpp>
 #include <kernel_headers/trace_edge.hpp>
 #include <memory.hpp>
@@ -162,17 +163,11 @@ void edgeTrackingHysteresis(Param output, const Param strong,
 
     initEdgeOut<T>(output, strong, weak);
 
-    int notFinished = 1;
-    auto dContinue  = memAlloc<T>(sizeof(int));
-
-    while (notFinished > 0) {
-        notFinished = 0;
-        edgeTraceOp.setFlag(dContinue.get(), &notFinished);
+    launchUntilConverged([&](cl::Buffer &flags, int iter) {
         edgeTraceOp(EnqueueArgs(getQueue(), global, threads), *output.data,
-                    output.info, blk_x, blk_y, *dContinue);
+                    output.info, blk_x, blk_y, flags, iter);
         CL_DEBUG_FINISH(getQueue());
-        notFinished = edgeTraceOp.getFlag(dContinue.get());
-    }
+    });
     suppressLeftOver<T>(output);
 }
 }  // namespace kernel
@@ -0,0 +1,134 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// One group computes the mapping of one tile of a slice to the fraction of
+// the pixels of the tile below each bin. The histogram is counted, clipped
+// and accumulated in local memory. Tile b along a dimension of length n
+// covers the indices i with b = i * grid / n.
+kernel void claheLut(global float *d_lut, KParam lInfo, global const T *d_in,
+                     KParam iInfo, local uint *hist, float clipLimit,
+                     float minval, float maxval) {
+    local uint excess;
+
+    const int nbins    = lInfo.dims[0];
+    const int gridRows = lInfo.dims[1];
+    const int gridCols = lInfo.dims[2];
+    const int ty       = get_group_id(0) % gridRows;
+    const int tx       = get_group_id(0) / gridRows;
+    const int slice    = get_group_id(1);
+    const int b2       = slice % iInfo.dims[2];
+    const int b3       = slice / iInfo.dims[2];
+    const int lid      = get_local_id(0);
+    const int lsz      = get_local_size(0);
+
+    const int rowBeg = (ty * iInfo.dims[0] + gridRows - 1) / gridRows;
+    const int rowEnd = ((ty + 1) * iInfo.dims[0] + gridRows - 1) / gridRows;
+    const int colBeg = (tx * iInfo.dims[1] + gridCols - 1) / gridCols;
+    const int colEnd = ((tx + 1) * iInfo.dims[1] + gridCols - 1) / gridCols;
+    const int rows   = rowEnd - rowBeg;
+    const int count  = rows * (colEnd - colBeg);
+
+    global const T *in = d_in + iInfo.offset + b2 * iInfo.strides[2] +
+                         b3 * iInfo.strides[3] + colBeg * iInfo.strides[1] +
+                         rowBeg;
+    const float step = (maxval - minval) / (float)nbins;
+
+    for (int b = lid; b < nbins; b += lsz) hist[b] = 0;
+    if (lid == 0) excess = 0;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (int e = lid; e < count; e += lsz) {
+        const int i = e % rows;
+        const int j = e / rows;
+        int bin = (int)(((float)in[j * iInfo.strides[1] + i] - minval) / step);
+        bin     = min(max(bin, 0), nbins - 1);
+        atomic_inc(hist + bin);
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    if (clipLimit > 0) {
+        const uint limit = max(1u, (uint)(clipLimit * count / nbins));
+        uint clipped     = 0;
+        for (int b = lid; b < nbins; b += lsz) {
+            if (hist[b] > limit) {
+                clipped += hist[b] - limit;
+                hist[b] = limit;
+            }
+        }
+        atomic_add(&excess, clipped);
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    // The histograms are small, so one work item accumulates the cdf
+    if (lid == 0) {
+        global float *lut = d_lut + lInfo.offset + ty * lInfo.strides[1] +
+                            tx * lInfo.strides[2] + slice * lInfo.strides[3];
+        const float redist = (float)excess / nbins;
+        const float scale  = 1.f / count;
+        float cdf          = 0.f;
+        for (int b = 0; b < nbins; b++) {
+            cdf += hist[b] + redist;
+            lut[b] = cdf * scale;
+        }
+    }
+}
+
+// Maps every pixel by the mappings of the four tiles whose centers surround
+// it, interpolated bilinearly
+kernel void claheApply(global T *d_out, KParam oInfo, global const T *d_in,
+                       KParam iInfo, global const float *d_lut, KParam lInfo,
+                       float minval, float maxval) {
+    const int i  = get_global_id(0);
+    const int j  = get_global_id(1);
+    const int s  = get_global_id(2);
+    const int b2 = s % iInfo.dims[2];
+    const int b3 = s / iInfo.dims[2];
+    if (i >= iInfo.dims[0] || j >= iInfo.dims[1]) return;
+
+    const int nbins    = lInfo.dims[0];
+    const int gridRows = lInfo.dims[1];
+    const int gridCols = lInfo.dims[2];
+    const float step   = (maxval - minval) / (float)nbins;
+
+    const T v = d_in[iInfo.offset + b2 * iInfo.strides[2] +
+                     b3 * iInfo.strides[3] + j * iInfo.strides[1] + i];
+    int bin   = (int)(((float)v - minval) / step);
+    bin       = min(max(bin, 0), nbins - 1);
+
+    const float fy = (i + 0.5f) * gridRows / iInfo.dims[0] - 0.5f;
+    const float fx = (j + 0.5f) * gridCols / iInfo.dims[1] - 0.5f;
+    const int y0   = (int)floor(fy);
+    const int x0   = (int)floor(fx);
+    const float wy = fy - y0;
+    const float wx = fx - x0;
+    const int ty0  = max(y0, 0);
+    const int ty1  = min(y0 + 1, gridRows - 1);
+    const int tx0  = max(x0, 0);
+    const int tx1  = min(x0 + 1, gridCols - 1);
+
+    global const float *lp =
+        d_lut + lInfo.offset + s * lInfo.strides[3] + bin;
+    global const float *l0 = lp + ty0 * lInfo.strides[1];
+    global const float *l1 = lp + ty1 * lInfo.strides[1];
+    const int c0           = tx0 * lInfo.strides[2];
+    const int c1           = tx1 * lInfo.strides[2];
+
+    const float top  = (1.f - wx) * l0[c0] + wx * l0[c1];
+    const float bot  = (1.f - wx) * l1[c0] + wx * l1[c1];
+    const float frac = (1.f - wy) * top + wy * bot;
+    const float res  = minval + (maxval - minval) * frac;
+
+#if defined(IS_INTEGRAL)
+    d_out[oInfo.offset + b2 * oInfo.strides[2] + b3 * oInfo.strides[3] +
+          j * oInfo.strides[1] + i] = (T)floor(res + 0.5f);
+#else
+    d_out[oInfo.offset + b2 * oInfo.strides[2] + b3 * oInfo.strides[3] +
+          j * oInfo.strides[1] + i] = (T)res;
+#endif
+}
@@ -0,0 +1,83 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/clahe.hpp>
+#include <traits.hpp>
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+template<typename T>
+std::vector<std::string> claheOptions() {
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+    if (std::is_integral<T>::value) {
+        options.emplace_back(DefineKey(IS_INTEGRAL));
+    }
+    return options;
+}
+
+template<typename T>
+void claheLut(Param lut, const Param in, float clipLimit, float minval,
+              float maxval) {
+    constexpr int THREADS = 256;
+
+    static const std::string src(clahe_cl, clahe_cl_len);
+
+    auto claheLut = common::getKernel(
+        "claheLut", {src}, {TemplateTypename<T>()}, claheOptions<T>());
+
+    const int nbins = lut.info.dims[0];
+    cl::NDRange local(THREADS, 1);
+    cl::NDRange global(lut.info.dims[1] * lut.info.dims[2] * THREADS,
+                       lut.info.dims[3]);
+
+    claheLut(cl::EnqueueArgs(getQueue(), global, local), *lut.data, lut.info,
+             *in.data, in.info, cl::Local(nbins * sizeof(uint)), clipLimit,
+             minval, maxval);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+template<typename T>
+void claheApply(Param out, const Param in, const Param lut, float minval,
+                float maxval) {
+    constexpr int THREADS_X = 32;
+    constexpr int THREADS_Y = 8;
+
+    static const std::string src(clahe_cl, clahe_cl_len);
+
+    auto claheApply =
+        common::getKernel("claheApply", {src}, {TemplateTypename<T>()},
+                          claheOptions<T>());
+
+    cl::NDRange local(THREADS_X, THREADS_Y, 1);
+    cl::NDRange global(divup(in.info.dims[0], THREADS_X) * THREADS_X,
+                       divup(in.info.dims[1], THREADS_Y) * THREADS_Y,
+                       in.info.dims[2] * in.info.dims[3]);
+
+    claheApply(cl::EnqueueArgs(getQueue(), global, local), *out.data,
+               out.info, *in.data, in.info, *lut.data, lut.info, minval,
+               maxval);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+}  // namespace kernel
+}  // namespace opencl
@@ -0,0 +1,167 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#ifdef USE_DOUBLE
+#define CT double
+#else
+#define CT float
+#endif
+
+// The values of AF_CONV2_PASS
+#define CONV2_FORWARD 0
+#define CONV2_DATA_GRADIENT 1
+#define CONV2_FILTER_GRADIENT 2
+
+// The geometry of the convolution: the size of the filter and the stride,
+// the padding and the dilation of each dimension
+typedef struct {
+    int fw, fh;
+    int sx, sy;
+    int px, py;
+    int dx, dy;
+} Conv2Geometry;
+
+// Returns the element (x, y, c, n) of in, or 0 outside of the first two
+// dimensions, which is the padding of the convolution
+CT conv2Value(const global T *in, KParam info, long x, long y, long c,
+              long n) {
+    if (x < 0 || y < 0 || x >= info.dims[0] || y >= info.dims[1]) {
+        return (CT)0;
+    }
+    return (CT)in[info.offset + x * info.strides[0] + y * info.strides[1] +
+                  c * info.strides[2] + n * info.strides[3]];
+}
+
+// Returns the element (row, t) of the left operand of the product, the
+// unwrapped signal for the forward pass and the filter gradient, and the
+// unwrapped output gradient for the data gradient
+CT conv2Lhs(KParam oInfo, const global T *lhs, KParam lInfo, KParam rInfo,
+            Conv2Geometry g, long row, long t) {
+#if PASS == CONV2_FORWARD
+    // row is the output pixel (ox, oy, n), t the tap (i, j, c)
+    const long ox = row % oInfo.dims[0];
+    const long oy = (row / oInfo.dims[0]) % oInfo.dims[1];
+    const long n  = row / (oInfo.dims[0] * oInfo.dims[1]);
+    const long i  = t % g.fw;
+    const long j  = (t / g.fw) % g.fh;
+    const long c  = t / (g.fw * g.fh);
+    return conv2Value(lhs, lInfo, ox * g.sx - g.px + i * g.dx,
+                      oy * g.sy - g.py + j * g.dy, c, n);
+#elif PASS == CONV2_DATA_GRADIENT
+    // row is the signal pixel (x, y, n), t the tap (i, j, k). The pixel gets
+    // the gradient of the outputs whose tap (i, j) reads it.
+    const long x  = row % oInfo.dims[0];
+    const long y  = (row / oInfo.dims[0]) % oInfo.dims[1];
+    const long n  = row / (oInfo.dims[0] * oInfo.dims[1]);
+    const long i  = t % g.fw;
+    const long j  = (t / g.fw) % g.fh;
+    const long k  = t / (g.fw * g.fh);
+    const long xo = x + g.px - i * g.dx;
+    const long yo = y + g.py - j * g.dy;
+    if (xo < 0 || yo < 0 || xo % g.sx != 0 || yo % g.sy != 0) {
+        return (CT)0;
+    }
+    return conv2Value(lhs, lInfo, xo / g.sx, yo / g.sy, k, n);
+#else
+    // row is the tap (i, j, c), t the output pixel (ox, oy, n)
+    const long i  = row % g.fw;
+    const long j  = (row / g.fw) % g.fh;
+    const long c  = row / (g.fw * g.fh);
+    const long ox = t % rInfo.dims[0];
+    const long oy = (t / rInfo.dims[0]) % rInfo.dims[1];
+    const long n  = t / (rInfo.dims[0] * rInfo.dims[1]);
+    return conv2Value(lhs, lInfo, ox * g.sx - g.px + i * g.dx,
+                      oy * g.sy - g.py + j * g.dy, c, n);
+#endif
+}
+
+// Returns the element (t, col) of the right operand of the product, the
+// flipped filter for the forward pass and the data gradient, and the output
+// gradient for the filter gradient
+CT conv2Rhs(const global T *rhs, KParam rInfo, Conv2Geometry g, long t,
+            long col) {
+#if PASS == CONV2_FILTER_GRADIENT
+    const long ox = t % rInfo.dims[0];
+    const long oy = (t / rInfo.dims[0]) % rInfo.dims[1];
+    const long n  = t / (rInfo.dims[0] * rInfo.dims[1]);
+    return conv2Value(rhs, rInfo, ox, oy, col, n);
+#else
+    // t is the tap (i, j, c) of the forward pass, and (i, j, k) of the data
+    // gradient
+    const long i = t % g.fw;
+    const long j = (t / g.fw) % g.fh;
+    const long z = t / (g.fw * g.fh);
+#if PASS == CONV2_FORWARD
+    return conv2Value(rhs, rInfo, g.fw - 1 - i, g.fh - 1 - j, z, col);
+#else
+    return conv2Value(rhs, rInfo, g.fw - 1 - i, g.fh - 1 - j, col, z);
+#endif
+#endif
+}
+
+// Computes a TILE x TILE block of the product of the unwrapped operand,
+// which is read from lhs as it is needed, with rhs. The reduction runs over
+// the chunk elements of the part get_group_id(2).
+kernel void conv2Implicit(global T *out, KParam oInfo, const global T *lhs,
+                          KParam lInfo, const global T *rhs, KParam rInfo,
+                          int fw, int fh, int sx, int sy, int px, int py,
+                          int dx, int dy, long rows, long cols, long depth,
+                          long chunk) {
+    local CT lhsTile[TILE][TILE + 1];
+    local CT rhsTile[TILE][TILE + 1];
+
+    const Conv2Geometry g = {fw, fh, sx, sy, px, py, dx, dy};
+
+    const int tx     = get_local_id(0);
+    const int ty     = get_local_id(1);
+    const long row   = get_group_id(0) * (long)TILE + tx;
+    const long col   = get_group_id(1) * (long)TILE + ty;
+    const long split = get_group_id(2);
+    const long begin = split * chunk;
+    const long end   = min(begin + chunk, depth);
+
+    CT acc = (CT)0;
+    for (long t0 = begin; t0 < end; t0 += TILE) {
+        // The work-items along x read consecutive rows of lhs and
+        // consecutive reduction indices of rhs, which are the contiguous ones
+        const long tl = t0 + ty;
+        const long tr = t0 + tx;
+        lhsTile[ty][tx] =
+            (row < rows && tl < end)
+                ? conv2Lhs(oInfo, lhs, lInfo, rInfo, g, row, tl)
+                : (CT)0;
+        rhsTile[tx][ty] =
+            (col < cols && tr < end) ? conv2Rhs(rhs, rInfo, g, tr, col) : (CT)0;
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        for (int k = 0; k < TILE; ++k) {
+            acc += lhsTile[k][tx] * rhsTile[k][ty];
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    if (row >= rows || col >= cols) { return; }
+
+#if PASS == CONV2_FILTER_GRADIENT
+    // The partial sum of the part is stored with the flipped tap
+    const long i       = row % g.fw;
+    const long j       = (row / g.fw) % g.fh;
+    const long c       = row / (g.fw * g.fh);
+    const long flipped = (g.fw - 1 - i) + g.fw * ((g.fh - 1 - j) + g.fh * c);
+    out[oInfo.offset + flipped * oInfo.strides[0] + col * oInfo.strides[1] +
+        split * oInfo.strides[2]] = (T)acc;
+#else
+    // row is the pixel (x, y, n) of the output, col its channel
+    const long x = row % oInfo.dims[0];
+    const long y = (row / oInfo.dims[0]) % oInfo.dims[1];
+    const long n = row / (oInfo.dims[0] * oInfo.dims[1]);
+    out[oInfo.offset + x * oInfo.strides[0] + y * oInfo.strides[1] +
+        col * oInfo.strides[2] + n * oInfo.strides[3]] = (T)acc;
+#endif
+}
@@ -0,0 +1,105 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/internal_enums.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/conv2_implicit.hpp>
+#include <traits.hpp>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+/// The side of the tiles of the products of conv2Implicit
+constexpr int CONV2_TILE = 16;
+
+/// Returns the number of output pixels added by each part of the filter
+/// gradient. Large outputs are split in up to 64 parts of at least 8192
+/// pixels, which are multiples of the tiles, so that the products of the
+/// small filter gradients are computed by enough groups.
+inline dim_t conv2GradientChunk(const dim_t pixels) {
+    const dim_t parts = std::min<dim_t>(std::max<dim_t>(pixels / 8192, 1), 64);
+    return std::max<dim_t>(divup(divup(pixels, parts), CONV2_TILE), 1) *
+           CONV2_TILE;
+}
+
+/// Computes a \p pass of the convolution of the neural network functions as
+/// a product of matrices, without the unwrapped matrix. Its elements are
+/// read from the signal or the output gradient by the groups of the product
+/// which use them.
+///
+/// \p lhs and \p rhs are the signal and the filter for the forward pass, the
+/// output gradient and the filter for the data gradient, and the signal and
+/// the output gradient for the filter gradient. The filter gradient is
+/// written to \p out as partial sums of \p chunk output pixels each, along
+/// its third dimension, with the taps in the first dimension and the filters
+/// in the second one.
+template<typename T>
+void conv2Implicit(Param out, const Param lhs, const Param rhs,
+                   AF_CONV2_PASS pass, const dim_t fw, const dim_t fh,
+                   const af::dim4 &stride, const af::dim4 &padding,
+                   const af::dim4 &dilation, const dim_t chunk) {
+    static const std::string src(conv2_implicit_cl, conv2_implicit_cl_len);
+
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<T>(),
+        TemplateArg(static_cast<int>(pass)),
+        TemplateArg(CONV2_TILE),
+    };
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(PASS, static_cast<int>(pass)),
+        DefineKeyValue(TILE, CONV2_TILE),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+
+    auto conv2Op = common::getKernel("conv2Implicit", {src}, targs, options);
+
+    // The rows are the output pixels of the forward pass, the signal pixels
+    // of the data gradient and the taps of the filter gradient. The columns
+    // are the channels of the output.
+    const dim_t *oDims = out.info.dims;
+    dim_t rows = 0, cols = 0, depth = 0;
+    if (pass == AF_CONV2_FILTER_GRADIENT) {
+        rows  = oDims[0];
+        cols  = oDims[1];
+        depth = rhs.info.dims[0] * rhs.info.dims[1] * rhs.info.dims[3];
+    } else {
+        rows  = oDims[0] * oDims[1] * oDims[3];
+        cols  = oDims[2];
+        depth = fw * fh * lhs.info.dims[2];
+    }
+
+    cl::NDRange local(CONV2_TILE, CONV2_TILE, 1);
+    cl::NDRange global(divup(rows, CONV2_TILE) * CONV2_TILE,
+                       divup(cols, CONV2_TILE) * CONV2_TILE,
+                       divup(depth, chunk));
+
+    conv2Op(cl::EnqueueArgs(getQueue(), global, local), *out.data, out.info,
+            *lhs.data, lhs.info, *rhs.data, rhs.info, static_cast<int>(fw),
+            static_cast<int>(fh), static_cast<int>(stride[0]),
+            static_cast<int>(stride[1]), static_cast<int>(padding[0]),
+            static_cast<int>(padding[1]), static_cast<int>(dilation[0]),
+            static_cast<int>(dilation[1]), static_cast<cl_long>(rows),
+            static_cast<cl_long>(cols), static_cast<cl_long>(depth),
+            static_cast<cl_long>(chunk));
+    CL_DEBUG_FINISH(getQueue());
+}
+
+}  // namespace kernel
+}  // namespace opencl
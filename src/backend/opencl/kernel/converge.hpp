@@ -0,0 +1,51 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <memory.hpp>
+#include <platform.hpp>
+
+#include <algorithm>
+
+namespace opencl {
+namespace kernel {
+
+/// The most launches of an iterative kernel between two checks of its
+/// convergence
+constexpr int MAX_UNCHECKED_LAUNCHES = 32;
+
+/// Launches an iterative kernel until one of its iterations changes nothing.
+///
+/// The flag of the kernel is read on the host once per batch of launches
+/// instead of after every launch. \p launch(flags, iter) enqueues iteration
+/// \p iter of a batch. The kernel sets flags[iter] when it changes its output
+/// and returns at once if iter > 0 and flags[iter - 1] is zero, because the
+/// previous iteration has converged. The batches start with one launch and
+/// double up to MAX_UNCHECKED_LAUNCHES, so the kernels which converge quickly
+/// waste few launches.
+template<typename F>
+void launchUntilConverged(F launch) {
+    auto flags  = memAlloc<int>(MAX_UNCHECKED_LAUNCHES);
+    int changed = 1;
+    for (int launches = 1; changed;
+         launches = std::min(2 * launches, MAX_UNCHECKED_LAUNCHES)) {
+        getQueue().enqueueFillBuffer(*flags, cl_int(0), 0,
+                                     launches * sizeof(int));
+        for (int iter = 0; iter < launches; ++iter) {
+            launch(*flags, iter);
+        }
+        getQueue().enqueueReadBuffer(*flags, CL_TRUE,
+                                     (launches - 1) * sizeof(int), sizeof(int),
+                                     &changed);
+    }
+}
+
+}  // namespace kernel
+}  // namespace opencl
@@ -141,6 +141,72 @@ kernel void convolve(global T *out, KParam oInfo, global T const *signal,
         dst[gy * oInfo.strides[1] + gx] = (T)accum;
     }
 }
+
+// Convolves one signal with fCount filters of a filter bank, which are packed
+// one after the other in impulse. The tile of the signal is loaded to local
+// memory once and reused by all the filters, and filter k of the bank is
+// written to the slice (k % fDim2, k / fDim2) of the output.
+kernel void convolve2Bank(global T *out, KParam oInfo, global T const *signal,
+                          KParam sInfo, constant accType const *impulse,
+                          int fBegin, int fCount, int fDim2) {
+    local T localMem[C_SIZE];
+
+    int radius0  = FLEN0 - 1;
+    int radius1  = FLEN1 - 1;
+    int padding0 = 2 * radius0;
+    int padding1 = 2 * radius1;
+    int shrdLen0 = get_local_size(0) + padding0;
+    int shrdLen1 = get_local_size(1) + padding1;
+
+    global const T *src = signal + sInfo.offset;
+
+    int lx = get_local_id(0);
+    int ly = get_local_id(1);
+    int gx = get_global_id(0);
+    int gy = get_global_id(1);
+
+    int s0 = sInfo.strides[0];
+    int s1 = sInfo.strides[1];
+    int d0 = sInfo.dims[0];
+    int d1 = sInfo.dims[1];
+    for (int b = ly, gy2 = gy; b < shrdLen1;
+         b += get_local_size(1), gy2 += get_local_size(1)) {
+        int j     = gy2 - radius1;
+        bool is_j = j >= 0 && j < d1;
+        for (int a = lx, gx2 = gx; a < shrdLen0;
+             a += get_local_size(0), gx2 += get_local_size(0)) {
+            int i     = gx2 - radius0;
+            bool is_i = i >= 0 && i < d0;
+            localMem[b * shrdLen0 + a] =
+                (is_i && is_j ? src[i * s0 + j * s1] : (T)(0));
+        }
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    if (gx < oInfo.dims[0] && gy < oInfo.dims[1]) {
+        int ci = lx + radius0 + (EXPAND ? 0 : FLEN0 >> 1);
+        int cj = ly + radius1 + (EXPAND ? 0 : FLEN1 >> 1);
+
+        for (int f = 0; f < fCount; ++f) {
+            constant accType const *filt = impulse + f * FLEN0 * FLEN1;
+
+            accType accum = (accType)(0);
+            for (int fj = 0; fj < FLEN1; ++fj) {
+                for (int fi = 0; fi < FLEN0; ++fi) {
+                    accType f_val = filt[fj * FLEN0 + fi];
+                    T s_val = localMem[(cj - fj) * shrdLen0 + (ci - fi)];
+                    accum   = accum + binOp((accType)s_val, (accType)f_val);
+                }
+            }
+
+            int k = fBegin + f;
+            global T *dst =
+                out + (k % fDim2) * oInfo.strides[2] +
+                (k / fDim2) * oInfo.strides[3];
+            dst[gy * oInfo.strides[1] + gx] = (T)accum;
+        }
+    }
+}
 #endif
 
 #if RANK == 3
@@ -12,14 +12,14 @@
 #include <common/kernel_cache.hpp>
 #include <kernel/convolve/conv_common.hpp>
 
+#include <algorithm>
+
 namespace opencl {
 namespace kernel {
 
 template<typename T, typename aT>
-void conv2Helper(const conv_kparam_t& param, Param out, const Param signal,
-                 const Param filter, const bool expand) {
-    using cl::EnqueueArgs;
-    using cl::NDRange;
+auto getConv2Kernel(const char* name, const int f0, const int f1,
+                    const bool expand) {
     using std::string;
     using std::vector;
 
@@ -29,8 +29,6 @@ void conv2Helper(const conv_kparam_t& param, Param out, const Param signal,
     static const string src1(ops_cl, ops_cl_len);
     static const string src2(convolve_cl, convolve_cl_len);
 
-    const int f0 = filter.info.dims[0];
-    const int f1 = filter.info.dims[1];
     const size_t LOC_SIZE =
         (THREADS_X + 2 * (f0 - 1)) * (THREADS_Y + 2 * (f1 - 1));
 
@@ -53,8 +51,16 @@ void conv2Helper(const conv_kparam_t& param, Param out, const Param signal,
     };
     compileOpts.emplace_back(getTypeBuildDefinition<T>());
 
-    auto convolve =
-        common::getKernel("convolve", {src1, src2}, tmpltArgs, compileOpts);
+    return common::getKernel(name, {src1, src2}, tmpltArgs, compileOpts);
+}
+
+template<typename T, typename aT>
+void conv2Helper(const conv_kparam_t& param, Param out, const Param signal,
+                 const Param filter, const bool expand) {
+    using cl::EnqueueArgs;
+
+    auto convolve = getConv2Kernel<T, aT>(
+        "convolve", filter.info.dims[0], filter.info.dims[1], expand);
 
     convolve(EnqueueArgs(getQueue(), param.global, param.local), *out.data,
              out.info, *signal.data, signal.info, *param.impulse, filter.info,
@@ -62,9 +68,50 @@ void conv2Helper(const conv_kparam_t& param, Param out, const Param signal,
              param.s[2]);
 }
 
+/// Convolves a single signal with a bank of filters. The filters are copied
+/// to constant memory in chunks and each launch reads the tiles of the signal
+/// once for all the filters of its chunk, instead of once per filter.
+template<typename T, typename aT>
+void conv2Bank(conv_kparam_t& p, Param& out, const Param& sig,
+               const Param& filt, const bool expand) {
+    using cl::EnqueueArgs;
+
+    const int f0       = filt.info.dims[0];
+    const int f1       = filt.info.dims[1];
+    const int fDim2    = filt.info.dims[2];
+    const int fCount   = fDim2 * filt.info.dims[3];
+    const size_t fSize = f0 * f1 * sizeof(aT);
+    const int chunk    = std::max(1, static_cast<int>(BANK_BYTES / fSize));
+
+    p.impulse = bufferAlloc(std::min(chunk, fCount) * fSize);
+
+    auto convolve = getConv2Kernel<T, aT>("convolve2Bank", f0, f1, expand);
+
+    for (int fBegin = 0; fBegin < fCount; fBegin += chunk) {
+        const int count = std::min(chunk, fCount - fBegin);
+
+        // FIXME: if the filter array is strided, direct copy of symbols
+        // might cause issues
+        getQueue().enqueueCopyBuffer(
+            *filt.data, *p.impulse,
+            (filt.info.offset * sizeof(aT)) + fBegin * fSize, 0,
+            count * fSize);
+
+        convolve(EnqueueArgs(getQueue(), p.global, p.local), *out.data,
+                 out.info, *sig.data, sig.info, *p.impulse, fBegin, count,
+                 fDim2);
+    }
+}
+
 template<typename T, typename aT>
 void conv2(conv_kparam_t& p, Param& out, const Param& sig, const Param& filt,
            const bool expand) {
+    const bool isBank = p.launchMoreBlocks && p.inHasNoOffset;
+    if (isBank && filt.info.dims[2] * filt.info.dims[3] > 1) {
+        conv2Bank<T, aT>(p, out, sig, filt, expand);
+        return;
+    }
+
     size_t se_size = filt.info.dims[0] * filt.info.dims[1] * sizeof(aT);
     p.impulse      = bufferAlloc(se_size);
     int f0Off      = filt.info.offset;
@@ -34,6 +34,9 @@ constexpr int CUBE_X    = 8;
 constexpr int CUBE_Y    = 8;
 constexpr int CUBE_Z    = 4;
 
+// Bytes of constant memory used by the filters of one filter bank launch
+constexpr size_t BANK_BYTES = 32768;
+
 struct conv_kparam_t {
     cl::NDRange global;
     cl::NDRange local;
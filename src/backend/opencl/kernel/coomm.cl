@@ -0,0 +1,104 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#if IS_CPLX
+T __cmul(T lhs, T rhs) {
+    T out;
+    out.x = lhs.x * rhs.x - lhs.y * rhs.y;
+    out.y = lhs.x * rhs.y + lhs.y * rhs.x;
+    return out;
+}
+
+T __ccmul(T lhs, T rhs) {
+    T out;
+    out.x = lhs.x * rhs.x + lhs.y * rhs.y;
+    out.y = lhs.x * rhs.y - lhs.y * rhs.x;
+    return out;
+}
+
+#if IS_CONJ
+#define CMUL(a, b) __ccmul(a, b)
+#else
+#define CMUL(a, b) __cmul(a, b)
+#endif
+
+#else
+#define CMUL(a, b) (a) * (b)
+#endif
+
+#ifdef USE_DOUBLE
+#pragma OPENCL EXTENSION cl_khr_int64_base_atomics : enable
+
+void atomicAddReal(global TR *ptr, const TR val) {
+    volatile global long *iptr = (volatile global long *)ptr;
+    long old                   = *iptr;
+    long prev;
+    do {
+        prev = old;
+        old  = atom_cmpxchg(iptr, prev, as_long(as_double(prev) + val));
+    } while (old != prev);
+}
+#else
+void atomicAddReal(global TR *ptr, const TR val) {
+    volatile global int *iptr = (volatile global int *)ptr;
+    int old                   = *iptr;
+    int prev;
+    do {
+        prev = old;
+        old  = atomic_cmpxchg(iptr, prev, as_int(as_float(prev) + val));
+    } while (old != prev);
+}
+#endif
+
+void atomicAddValue(global T *ptr, const T val) {
+#if IS_CPLX
+    atomicAddReal((global TR *)ptr, val.x);
+    atomicAddReal((global TR *)ptr + 1, val.y);
+#else
+    atomicAddReal(ptr, val);
+#endif
+}
+
+// Each thread adds the products of NNZ_PER_THREAD consecutive nonzeros with
+// one column of rhs to the output, which is zero. The nonzeros may be in any
+// order. The products of consecutive nonzeros of the same output row are
+// summed before they are added atomically, so the nonzeros which are sorted
+// by row take one atomic add per row of each thread.
+kernel void coomm(global T *output, const KParam oinfo,
+                  global const T *values, global const int *rowidx,
+                  global const int *colidx, const int nnz,
+                  global const T *rhs, const KParam rinfo) {
+    const int first = get_global_id(0) * NNZ_PER_THREAD;
+    const int last  = min(first + NNZ_PER_THREAD, nnz);
+    const int col   = get_global_id(1);
+
+    output += oinfo.offset + col * oinfo.strides[1];
+    rhs += rinfo.offset + col * rinfo.strides[1];
+
+#if IS_TRANS
+    global const int *outidx = colidx;
+    global const int *inidx  = rowidx;
+#else
+    global const int *outidx = rowidx;
+    global const int *inidx  = colidx;
+#endif
+
+    int row = -1;
+    T sum   = 0;
+    for (int id = first; id < last; id++) {
+        const int r = outidx[id];
+        if (r != row) {
+            if (row >= 0) { atomicAddValue(output + row, sum); }
+            row = r;
+            sum = 0;
+        }
+        sum += CMUL(values[id], rhs[inidx[id]]);
+    }
+    if (row >= 0) { atomicAddValue(output + row, sum); }
+}
@@ -0,0 +1,72 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/coomm.hpp>
+#include <traits.hpp>
+#include <af/opencl.h>
+
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+/// Adds op(lhs) * rhs to \p out, which is zero, for the COO matrix lhs of
+/// \p values, \p rowIdx and \p colIdx. op is the identity, or the transpose
+/// or the conjugate transpose when \p transpose is true.
+template<typename T>
+void coomm(Param out, const Param &values, const Param &rowIdx,
+           const Param &colIdx, const Param &rhs, const bool transpose,
+           const bool is_conj) {
+    constexpr int threads        = 256;
+    constexpr int nnz_per_thread = 8;
+
+    const int nnz = values.info.dims[0];
+    const int N   = out.info.dims[1];
+    if (nnz == 0) { return; }
+
+    static const std::string src(coomm_cl, coomm_cl_len);
+
+    using BT = typename dtype_traits<T>::base_type;
+
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<T>(),
+        TemplateArg(transpose),
+        TemplateArg(is_conj),
+    };
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(TR, dtype_traits<BT>::getName()),
+        DefineKeyValue(IS_TRANS, transpose),
+        DefineKeyValue(IS_CONJ, is_conj),
+        DefineKeyValue(NNZ_PER_THREAD, nnz_per_thread),
+        DefineKeyValue(IS_CPLX, (af::iscplx<T>() ? 1 : 0)),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+
+    auto coommKernel = common::getKernel("coomm", {src}, targs, options);
+
+    cl::NDRange local(threads, 1);
+    const int groups_x = divup(divup(nnz, nnz_per_thread), threads);
+    cl::NDRange global(local[0] * groups_x, N);
+
+    coommKernel(cl::EnqueueArgs(getQueue(), global, local), *out.data,
+                out.info, *values.data, *rowIdx.data, *colIdx.data, nnz,
+                *rhs.data, rhs.info);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+}  // namespace kernel
+}  // namespace opencl
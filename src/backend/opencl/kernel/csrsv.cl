@@ -0,0 +1,63 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// Each work item solves one row of a level of the triangle for one column of
+// x. The rows of the previous levels are already solved.
+
+#if IS_CPLX
+T __mul(T lhs, T rhs) {
+    T out;
+    out.x = lhs.x * rhs.x - lhs.y * rhs.y;
+    out.y = lhs.x * rhs.y + lhs.y * rhs.x;
+    return out;
+}
+
+T __div(T lhs, T rhs) {
+    T conj = {rhs.x, -rhs.y};
+    return __mul(lhs, conj) / (rhs.x * rhs.x + rhs.y * rhs.y);
+}
+
+#define ONE ((T)(1, 0))
+#else
+#define ONE ((T)(1))
+#define __mul(lhs, rhs) ((lhs) * (rhs))
+#define __div(lhs, rhs) ((lhs) / (rhs))
+#endif
+
+kernel void csrsvLevel(global T *x, KParam xinfo, global const T *values,
+                       global const int *rowIdx, global const int *colIdx,
+                       global const int *levelRows, const int first,
+                       const int count) {
+    const int id = get_global_id(0);
+    const int o  = get_global_id(1);
+    if (id >= count || o >= xinfo.dims[1]) return;
+
+    const int row = levelRows[first + id];
+    global T *y   = x + xinfo.offset + o * xinfo.strides[1];
+
+    T sum  = y[row];
+    T diag = ONE;
+    for (int j = rowIdx[row]; j < rowIdx[row + 1]; ++j) {
+        const int col = colIdx[j];
+#if IS_UPPER
+        if (col > row) {
+#else
+        if (col < row) {
+#endif
+            sum -= __mul(values[j], y[col]);
+        } else if (col == row) {
+            diag = values[j];
+        }
+    }
+#if IS_UNIT
+    y[row] = sum;
+#else
+    y[row] = __div(sum, diag);
+#endif
+}
@@ -0,0 +1,69 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <common/sparse_triangular.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/csrsv.hpp>
+#include <traits.hpp>
+
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+constexpr int CSRSV_THREADS = 256;
+
+/// Solves the lower or the \p upper triangle of the CSR matrix of \p values,
+/// \p rowIdx and \p colIdx in place of the columns of \p x, one level of
+/// \p levels after the other
+template<typename T>
+void csrsv(Param x, const Param &values, const Param &rowIdx,
+           const Param &colIdx, const common::TriangularLevels &levels,
+           const bool upper, const bool unit) {
+    static const std::string src(csrsv_cl, csrsv_cl_len);
+
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<T>(),
+        TemplateArg(upper),
+        TemplateArg(unit),
+    };
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(IS_UPPER, (upper ? 1 : 0)),
+        DefineKeyValue(IS_UNIT, (unit ? 1 : 0)),
+        DefineKeyValue(IS_CPLX, (af::iscplx<T>() ? 1 : 0)),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+
+    auto csrsvLevel = common::getKernel("csrsvLevel", {src}, targs, options);
+
+    const Param levelRows = levels.rows;
+    for (size_t l = 0; l + 1 < levels.offsets.size(); ++l) {
+        const int first = levels.offsets[l];
+        const int count = levels.offsets[l + 1] - first;
+
+        cl::NDRange local(CSRSV_THREADS, 1);
+        cl::NDRange global(divup(count, local[0]) * local[0],
+                           x.info.dims[1]);
+
+        csrsvLevel(cl::EnqueueArgs(getQueue(), global, local), *x.data,
+                   x.info, *values.data, *rowIdx.data, *colIdx.data,
+                   *levelRows.data, first, count);
+        CL_DEBUG_FINISH(getQueue());
+    }
+}
+
+}  // namespace kernel
+}  // namespace opencl
@@ -7,34 +7,117 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+// The conversions of dense arrays count the nonzeros of each row or column,
+// scan the counts into offsets and write each row or column at its offset
+
 #if IS_CPLX
 #define IS_ZERO(val) ((val.x == 0) && (val.y == 0))
 #else
 #define IS_ZERO(val) (val == 0)
 #endif
 
-kernel void dense2Csr(global T *svalptr, global int *scolptr,
-                      global const T *dvalptr, const KParam valinfo,
-                      global const int *dcolptr, const KParam colinfo,
-                      global const int *rowptr) {
-    int gidx = get_global_id(0);
-    int gidy = get_global_id(1);
+kernel void nnzPerRow(global int *counts, global const T *in,
+                      const KParam iinfo) {
+    const int row = get_global_id(0);
+    if (row > iinfo.dims[0]) return;
+
+    // The extra count makes the last offset of the exclusive scan the nnz
+    int count = 0;
+    if (row < iinfo.dims[0]) {
+        global const T *ptr = in + iinfo.offset + row * iinfo.strides[0];
+        for (int j = 0; j < iinfo.dims[1]; ++j) {
+            T v = ptr[j * iinfo.strides[1]];
+            count += IS_ZERO(v) ? 0 : 1;
+        }
+    }
+    counts[row] = count;
+}
 
-    if (gidx >= valinfo.dims[0]) return;
-    if (gidy >= valinfo.dims[1]) return;
+// The work items of a group read consecutive rows of each column
+kernel void dense2CsrRows(global T *values, global int *colIdx,
+                          global const T *in, const KParam iinfo,
+                          global const int *offsets) {
+    const int row = get_global_id(0);
+    if (row >= iinfo.dims[0]) return;
 
-    int rowoff = rowptr[gidx];
-    svalptr += rowoff;
-    scolptr += rowoff;
+    global const T *ptr = in + iinfo.offset + row * iinfo.strides[0];
+    int k               = offsets[row];
+    for (int j = 0; j < iinfo.dims[1]; ++j) {
+        T v = ptr[j * iinfo.strides[1]];
+        if (!IS_ZERO(v)) {
+            values[k] = v;
+            colIdx[k] = j;
+            ++k;
+        }
+    }
+}
 
-    dvalptr += valinfo.offset;
-    dcolptr += colinfo.offset;
+kernel void nnzPerCol(global int *counts, global const T *in,
+                      const KParam iinfo) {
+    local int l_count[THREADS];
 
-    int idx = gidx + gidy * valinfo.strides[1];
-    T val   = dvalptr[gidx + gidy * valinfo.strides[1]];
-    if (IS_ZERO(val)) return;
+    const int col = get_group_id(0);
+    const int tid = get_local_id(0);
+
+    int count = 0;
+    if (col < iinfo.dims[1]) {
+        global const T *ptr = in + iinfo.offset + col * iinfo.strides[1];
+        for (int i = tid; i < iinfo.dims[0]; i += THREADS) {
+            T v = ptr[i * iinfo.strides[0]];
+            count += IS_ZERO(v) ? 0 : 1;
+        }
+    }
+    l_count[tid] = count;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (int n = THREADS / 2; n > 0; n /= 2) {
+        if (tid < n) { l_count[tid] += l_count[tid + n]; }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    if (tid == 0) { counts[col] = l_count[0]; }
+}
 
-    int oloc          = dcolptr[gidx + gidy * colinfo.strides[1]];
-    svalptr[oloc - 1] = val;
-    scolptr[oloc - 1] = gidy;
+// One group writes one column in chunks. The nonzeros of a chunk are placed
+// with an exclusive scan of their flags in local memory.
+kernel void dense2SparseCols(global T *values, global int *rowIdx,
+                             global int *colIdx, global const T *in,
+                             const KParam iinfo, global const int *offsets) {
+    local int l_flag[THREADS];
+
+    const int col = get_group_id(0);
+    const int tid = get_local_id(0);
+    const int M   = iinfo.dims[0];
+
+    global const T *ptr = in + iinfo.offset + col * iinfo.strides[1];
+
+    int base = offsets[col];
+    for (int start = 0; start < M; start += THREADS) {
+        const int i = start + tid;
+        T v;
+        int flag = 0;
+        if (i < M) {
+            v    = ptr[i * iinfo.strides[0]];
+            flag = IS_ZERO(v) ? 0 : 1;
+        }
+
+        l_flag[tid] = flag;
+        barrier(CLK_LOCAL_MEM_FENCE);
+        for (int n = 1; n < THREADS; n *= 2) {
+            const int add = tid >= n ? l_flag[tid - n] : 0;
+            barrier(CLK_LOCAL_MEM_FENCE);
+            l_flag[tid] += add;
+            barrier(CLK_LOCAL_MEM_FENCE);
+        }
+
+        if (flag) {
+            const int k = base + l_flag[tid] - 1;
+            values[k]   = v;
+            rowIdx[k]   = i;
+#if WRITE_COL
+            colIdx[k] = col;
+#endif
+        }
+        base += l_flag[THREADS - 1];
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
 }
@@ -0,0 +1,64 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// The Bluestein transform of the columns of length N computes the DFT as
+// the convolution of the chirp weighted columns with the conjugate chirp.
+// The convolution is a product of transforms of the power of two length M.
+
+T cmul(T a, T b) {
+    return (T)(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);
+}
+
+// out[m, b] = in[m, b] * chirp[m] for m < N, and 0 up to M
+kernel void bluesteinChirp(global T *out, const global T *in,
+                           const global T *chirp, int N, int M, int batch) {
+    const int m = get_global_id(0);
+    const int b = get_global_id(1);
+    if (m >= M || b >= batch) return;
+
+    out[b * M + m] = m < N ? cmul(in[b * N + m], chirp[m]) : (T)(0);
+}
+
+// data[m, b] *= filter[m]
+kernel void bluesteinFilter(global T *data, const global T *filter, int M,
+                            int batch) {
+    const int m = get_global_id(0);
+    const int b = get_global_id(1);
+    if (m >= M || b >= batch) return;
+
+    data[b * M + m] = cmul(data[b * M + m], filter[m]);
+}
+
+// out[k, b] = in[k, b] * chirp[k] * scale for k < N. scale is 1 / M, which
+// clFFT does not apply to the inverse transforms of ArrayFire.
+kernel void bluesteinOutput(global T *out, const global T *in,
+                            const global T *chirp, int N, int M, int batch,
+                            R scale) {
+    const int k = get_global_id(0);
+    const int b = get_global_id(1);
+    if (k >= N || b >= batch) return;
+
+    out[b * N + k] = cmul(in[b * M + k], chirp[k]) * scale;
+}
+
+// Expands the columns of the first N / 2 + 1 coefficients of the transforms
+// of real columns to the N coefficients, which are Hermitian symmetric
+kernel void hermitianExpand(global T *out, const global T *in, int N, int Nh,
+                            int batch) {
+    const int k = get_global_id(0);
+    const int b = get_global_id(1);
+    if (k >= N || b >= batch) return;
+
+    if (k < Nh) {
+        out[b * N + k] = in[b * Nh + k];
+    } else {
+        const T val    = in[b * Nh + N - k];
+        out[b * N + k] = (T)(val.x, -val.y);
+    }
+}
@@ -0,0 +1,92 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/fft_bluestein.hpp>
+#include <traits.hpp>
+#include <types.hpp>
+
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+template<typename T>
+Kernel getBluesteinKernel(const char *name) {
+    using R = typename dtype_traits<T>::base_type;
+    static const std::string src(fft_bluestein_cl, fft_bluestein_cl_len);
+
+    std::vector<TemplateArg> targs = {TemplateTypename<T>()};
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(R, dtype_traits<R>::getName()),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+
+    return common::getKernel(name, {src}, targs, options);
+}
+
+/// Returns the launch of one work item per value of \p batch columns of
+/// length \p len
+inline cl::EnqueueArgs bluesteinArgs(int len, int batch) {
+    constexpr int THREADS_X = 64;
+    constexpr int THREADS_Y = 4;
+    const cl::NDRange local(THREADS_X, THREADS_Y);
+    const cl::NDRange global(divup(len, THREADS_X) * THREADS_X,
+                             divup(batch, THREADS_Y) * THREADS_Y);
+    return cl::EnqueueArgs(getQueue(), global, local);
+}
+
+/// Weights the columns of length \p N of \p in with \p chirp and pads them
+/// with zeros to the columns of length \p M of \p out
+template<typename T>
+void bluesteinChirp(cl::Buffer &out, const cl::Buffer &in,
+                    const cl::Buffer &chirp, int N, int M, int batch) {
+    auto chirpOp = getBluesteinKernel<T>("bluesteinChirp");
+    chirpOp(bluesteinArgs(M, batch), out, in, chirp, N, M, batch);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+/// Multiplies the columns of length \p M of \p data by \p filter
+template<typename T>
+void bluesteinFilter(cl::Buffer &data, const cl::Buffer &filter, int M,
+                     int batch) {
+    auto filterOp = getBluesteinKernel<T>("bluesteinFilter");
+    filterOp(bluesteinArgs(M, batch), data, filter, M, batch);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+/// Weights the first \p N values of the columns of length \p M of \p in
+/// with \p chirp and \p scale into the columns of length \p N of \p out
+template<typename T>
+void bluesteinOutput(cl::Buffer &out, const cl::Buffer &in,
+                     const cl::Buffer &chirp, int N, int M, int batch,
+                     typename dtype_traits<T>::base_type scale) {
+    auto outputOp = getBluesteinKernel<T>("bluesteinOutput");
+    outputOp(bluesteinArgs(N, batch), out, in, chirp, N, M, batch, scale);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+/// Expands the columns of the \p N / 2 + 1 coefficients of \p in to the
+/// columns of the \p N Hermitian symmetric coefficients of \p out
+template<typename T>
+void hermitianExpand(cl::Buffer &out, const cl::Buffer &in, int N,
+                     int batch) {
+    auto expandOp = getBluesteinKernel<T>("hermitianExpand");
+    expandOp(bluesteinArgs(N, batch), out, in, N, N / 2 + 1, batch);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+}  // namespace kernel
+}  // namespace opencl
@@ -54,7 +54,11 @@ int barrierOR(local int *predicates) {
 
 kernel void flood_step(global T *out, KParam oInfo, global const T *img,
                        KParam iInfo, T lowValue, T highValue,
-                       global volatile int *notFinished) {
+                       global volatile int *notFinished, int iter) {
+    // The previous launch of the batch changed nothing, so the search has
+    // converged
+    if (iter > 0 && notFinished[iter - 1] == 0) return;
+
     local T lmem[LMEM_HEIGHT][LMEM_WIDTH];
     local int predicates[GROUP_SIZE];
 
@@ -121,7 +125,7 @@ kernel void flood_step(global T *out, KParam oInfo, global const T *img,
             // Atleast one border pixel changed. Therefore, mark for
             // another kernel launch to propogate changes beyond border
             // of this block
-            atomic_inc(notFinished);
+            atomic_inc(notFinished + iter);
         }
         out[(gx * s0 + gy * s1)] = lmem[j][i];
     }
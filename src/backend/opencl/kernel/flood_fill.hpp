@@ -13,6 +13,7 @@
 #include <common/dispatch.hpp>
 #include <common/kernel_cache.hpp>
 #include <debug_opencl.hpp>
+#include <kernel/converge.hpp>
 #include <kernel_headers/flood_fill.hpp>
 #include <memory.hpp>
 #include <traits.hpp>
@@ -105,19 +106,12 @@ void floodFill(Param out, const Param image, const Param seedsx,
 
     initSeeds<T>(out, seedsx, seedsy);
 
-    int notFinished       = 1;
-    cl::Buffer* dContinue = bufferAlloc(sizeof(int));
-
-    while (notFinished) {
-        notFinished = 0;
-        floodStep.setFlag(dContinue, &notFinished);
+    launchUntilConverged([&](cl::Buffer &flags, int iter) {
         floodStep(cl::EnqueueArgs(getQueue(), global, local), *out.data,
                   out.info, *image.data, image.info, lowValue, highValue,
-                  *dContinue);
+                  flags, iter);
         CL_DEBUG_FINISH(getQueue());
-        notFinished = floodStep.getFlag(dContinue);
-    }
-    bufferFree(dContinue);
+    });
     finalizeOutput<T>(out, newValue);
 }
 
@@ -0,0 +1,54 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#ifdef USE_DOUBLE
+#define CT double
+#else
+#define CT float
+#endif
+
+kernel void gemmEpilogue(global T *oData, KParam oInfo, const global T *bData,
+                         KParam bInfo, int groups_x, int groups_y) {
+    const int idz = get_group_id(0) / groups_x;
+    const int idw = get_group_id(1) / groups_y;
+
+    const int groupId_x = get_group_id(0) - idz * groups_x;
+    const int groupId_y = get_group_id(1) - idw * groups_y;
+
+    const int idx = get_local_id(0) + groupId_x * get_local_size(0);
+    const int idy = get_local_id(1) + groupId_y * get_local_size(1);
+
+    if (idx >= oInfo.dims[0] || idy >= oInfo.dims[1] || idz >= oInfo.dims[2] ||
+        idw >= oInfo.dims[3])
+        return;
+
+    global T *optr = oData + oInfo.offset + idw * oInfo.strides[3] +
+                     idz * oInfo.strides[2] + idy * oInfo.strides[1] + idx;
+
+#if IS_CPLX
+    // Complex values only get the bias
+#if HAS_BIAS
+    *optr = *optr + bData[bInfo.offset + idx * bInfo.strides[0]];
+#endif
+#else
+    CT x = (CT)(*optr);
+#if HAS_BIAS
+    x += (CT)(bData[bInfo.offset + idx * bInfo.strides[0]]);
+#endif
+
+#if EPILOGUE == AF_GEMM_EPILOGUE_RELU
+    x = fmax(x, (CT)0);
+#elif EPILOGUE == AF_GEMM_EPILOGUE_GELU
+    // The tanh approximation of the GELU. 0.7978845608028654 is sqrt(2 / pi)
+    x = (CT)0.5 * x *
+        ((CT)1 + tanh((CT)0.7978845608028654 * (x + (CT)0.044715 * x * x * x)));
+#endif
+    *optr = (T)x;
+#endif
+}
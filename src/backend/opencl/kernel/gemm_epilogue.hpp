@@ -0,0 +1,67 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/gemm_epilogue.hpp>
+#include <traits.hpp>
+#include <af/defines.h>
+
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+/// Adds the column vector \p bias to every column of \p out and applies the
+/// activation of \p epilogue in place. An empty \p bias adds nothing.
+template<typename T>
+void gemmEpilogue(Param out, const Param bias, af_gemm_epilogue epilogue) {
+    static const std::string src(gemm_epilogue_cl, gemm_epilogue_cl_len);
+
+    const bool hasBias = bias.info.dims[0] > 0;
+
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<T>(),
+        TemplateArg(hasBias),
+        TemplateArg(static_cast<int>(epilogue)),
+    };
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(HAS_BIAS, (hasBias ? 1 : 0)),
+        DefineKeyValue(EPILOGUE, static_cast<int>(epilogue)),
+        DefineKeyValue(AF_GEMM_EPILOGUE_RELU,
+                       static_cast<int>(AF_GEMM_EPILOGUE_RELU)),
+        DefineKeyValue(AF_GEMM_EPILOGUE_GELU,
+                       static_cast<int>(AF_GEMM_EPILOGUE_GELU)),
+        DefineKeyValue(IS_CPLX, (af::iscplx<T>() ? 1 : 0)),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+
+    auto epilogueOp = common::getKernel("gemmEpilogue", {src}, targs, options);
+
+    cl::NDRange local(32, 8);
+    int groups_x = divup(out.info.dims[0], local[0]);
+    int groups_y = divup(out.info.dims[1], local[1]);
+    cl::NDRange global(groups_x * out.info.dims[2] * local[0],
+                       groups_y * out.info.dims[3] * local[1]);
+
+    // The bias is not read without HAS_BIAS, so out stands in for it
+    epilogueOp(cl::EnqueueArgs(getQueue(), global, local), *out.data,
+               out.info, hasBias ? *bias.data : *out.data, bias.info,
+               groups_x, groups_y);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+}  // namespace kernel
+}  // namespace opencl
@@ -0,0 +1,78 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// Every group computes a TILE x TILE tile of the product. The zero points
+// are subtracted while the tiles of op(lhs) and op(rhs) are loaded.
+kernel void gemmQuantized(global int *oData, KParam oInfo,
+                          const global uchar *lData, KParam lInfo,
+                          const global uchar *rData, KParam rInfo,
+                          int lhsZero, int rhsZero, int groups_x,
+                          int groups_y) {
+    local int lTile[TILE][TILE + 1];
+    local int rTile[TILE][TILE + 1];
+
+    const int idz = get_group_id(0) / groups_x;
+    const int idw = get_group_id(1) / groups_y;
+
+    const int groupId_x = get_group_id(0) - idz * groups_x;
+    const int groupId_y = get_group_id(1) - idw * groups_y;
+
+    const int tx  = get_local_id(0);
+    const int ty  = get_local_id(1);
+    const int row = groupId_x * TILE + tx;
+    const int col = groupId_y * TILE + ty;
+    const int M   = oInfo.dims[0];
+    const int N   = oInfo.dims[1];
+    const int K   = LHS_TRANS ? lInfo.dims[0] : lInfo.dims[1];
+
+    const int lz = lInfo.dims[2] == 1 ? 0 : idz;
+    const int lw = lInfo.dims[3] == 1 ? 0 : idw;
+    const int rz = rInfo.dims[2] == 1 ? 0 : idz;
+    const int rw = rInfo.dims[3] == 1 ? 0 : idw;
+
+    const global uchar *lptr = lData + lInfo.offset +
+                               lz * lInfo.strides[2] + lw * lInfo.strides[3];
+    const global uchar *rptr = rData + rInfo.offset +
+                               rz * rInfo.strides[2] + rw * rInfo.strides[3];
+    const int lStride = lInfo.strides[1];
+    const int rStride = rInfo.strides[1];
+
+    int acc = 0;
+    for (int k0 = 0; k0 < K; k0 += TILE) {
+        // lTile[ty][tx] is op(lhs)(row, k0 + ty) and rTile[ty][tx] is
+        // op(rhs)(k0 + tx, col)
+        int k = k0 + ty;
+#if LHS_TRANS
+        const int lIdx = k + row * lStride;
+#else
+        const int lIdx = row + k * lStride;
+#endif
+        lTile[ty][tx] = (row < M && k < K) ? lptr[lIdx] - lhsZero : 0;
+
+        k = k0 + tx;
+#if RHS_TRANS
+        const int rIdx = col + k * rStride;
+#else
+        const int rIdx = k + col * rStride;
+#endif
+        rTile[ty][tx] = (col < N && k < K) ? rptr[rIdx] - rhsZero : 0;
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+#pragma unroll
+        for (int kk = 0; kk < TILE; kk++) {
+            acc += lTile[kk][tx] * rTile[ty][kk];
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    if (row < M && col < N) {
+        oData[oInfo.offset + idw * oInfo.strides[3] + idz * oInfo.strides[2] +
+              col * oInfo.strides[1] + row] = acc;
+    }
+}
@@ -0,0 +1,60 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/gemm_quantized.hpp>
+#include <af/defines.h>
+
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+/// Computes out = (op(lhs) - lhsZero) (op(rhs) - rhsZero) in 32-bit integers
+inline void gemmQuantized(Param out, const Param lhs, const Param rhs,
+                          af_mat_prop optLhs, af_mat_prop optRhs, int lhsZero,
+                          int rhsZero) {
+    static const std::string src(gemm_quantized_cl, gemm_quantized_cl_len);
+    constexpr int TILE = 16;
+
+    const bool lhsTrans = optLhs != AF_MAT_NONE;
+    const bool rhsTrans = optRhs != AF_MAT_NONE;
+
+    std::vector<TemplateArg> targs = {
+        TemplateArg(lhsTrans),
+        TemplateArg(rhsTrans),
+    };
+    std::vector<std::string> options = {
+        DefineValue(TILE),
+        DefineKeyValue(LHS_TRANS, (lhsTrans ? 1 : 0)),
+        DefineKeyValue(RHS_TRANS, (rhsTrans ? 1 : 0)),
+    };
+
+    auto gemmOp = common::getKernel("gemmQuantized", {src}, targs, options);
+
+    cl::NDRange local(TILE, TILE);
+    int groups_x = divup(out.info.dims[0], local[0]);
+    int groups_y = divup(out.info.dims[1], local[1]);
+    cl::NDRange global(groups_x * out.info.dims[2] * local[0],
+                       groups_y * out.info.dims[3] * local[1]);
+
+    gemmOp(cl::EnqueueArgs(getQueue(), global, local), *out.data, out.info,
+           *lhs.data, lhs.info, *rhs.data, rhs.info, lhsZero, rhsZero,
+           groups_x, groups_y);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+}  // namespace kernel
+}  // namespace opencl
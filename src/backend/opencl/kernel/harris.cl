@@ -9,36 +9,84 @@
 
 #define MAX_VAL(A, B) (A) < (B) ? (B) : (A)
 
-kernel void second_order_deriv(global T* ixx_out, global T* ixy_out,
-                               global T* iyy_out, const dim_t in_len,
-                               global const T* ix_in, global const T* iy_in) {
-    const unsigned x = get_global_id(0);
-
-    if (x < in_len) {
-        ixx_out[x] = ix_in[x] * ix_in[x];
-        ixy_out[x] = ix_in[x] * iy_in[x];
-        iyy_out[x] = iy_in[x] * iy_in[x];
-    }
-}
-
+// Computes the Harris responses of a BLOCK_X x BLOCK_Y tile of pixels at
+// least border_len away from the border from the first order derivatives.
+// The work items first filter the products of the derivatives along
+// dimension 0 for all the columns the windows of the tile overlap, into local
+// memory, and then filter them along dimension 1 and compute the responses.
+// The products and the filtered products are never written to global memory.
 kernel void harris_responses(global T* resp_out, const unsigned idim0,
-                             const unsigned idim1, global const T* ixx_in,
-                             global const T* ixy_in, global const T* iyy_in,
-                             const float k_thr, const unsigned border_len) {
-    const unsigned r = border_len;
+                             const unsigned idim1, global const T* ix_in,
+                             global const T* iy_in,
+                             global const accType* filter,
+                             const unsigned filter_len, const float k_thr,
+                             const unsigned border_len) {
+    local accType l_filter[MAX_FILTER_LEN];
+    local T l_xx[BLOCK_Y + MAX_FILTER_LEN - 1][BLOCK_X];
+    local T l_xy[BLOCK_Y + MAX_FILTER_LEN - 1][BLOCK_X];
+    local T l_yy[BLOCK_Y + MAX_FILTER_LEN - 1][BLOCK_X];
 
-    const unsigned x = get_global_id(0) + r;
-    const unsigned y = get_global_id(1) + r;
+    const unsigned r     = border_len;
+    const unsigned start = filter_len / 2;
+    const unsigned lx    = get_local_id(0);
+    const unsigned ly    = get_local_id(1);
 
-    if (x < idim1 - r && y < idim0 - r) {
-        const unsigned idx = x * idim0 + y;
+    const unsigned lid = ly * BLOCK_X + lx;
+    if (lid < filter_len) { l_filter[lid] = filter[lid]; }
+
+    // Consecutive work items read consecutive rows of the derivatives
+    const unsigned y  = get_global_id(0) + r;
+    const unsigned x0 = get_group_id(1) * BLOCK_Y + r;
+    const bool rowIn  = y < idim0 - r;
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // Column j of the tile is column x0 + start + 1 - filter_len + j of the
+    // image. It is not negative because border_len > filter_len / 2.
+    const unsigned cols = BLOCK_Y + filter_len - 1;
+    for (unsigned j = ly; j < cols; j += BLOCK_Y) {
+        const unsigned c = x0 + start + 1 - filter_len + j;
+
+        accType xx = 0, xy = 0, yy = 0;
+        if (rowIn && c < idim1) {
+            global const T* dx = ix_in + c * idim0 + y + start;
+            global const T* dy = iy_in + c * idim0 + y + start;
+            for (unsigned f = 0; f < filter_len; f++) {
+                const T vx = *(dx - f);
+                const T vy = *(dy - f);
+                xx += (accType)(vx * vx) * l_filter[f];
+                xy += (accType)(vx * vy) * l_filter[f];
+                yy += (accType)(vy * vy) * l_filter[f];
+            }
+        }
+        l_xx[j][lx] = (T)xx;
+        l_xy[j][lx] = (T)xy;
+        l_yy[j][lx] = (T)yy;
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    const unsigned x = x0 + ly;
+    if (rowIn && x < idim1 - r) {
+        // Column x + start - f of the image is column ly + filter_len - 1 - f
+        // of the tile
+        accType xx = 0, xy = 0, yy = 0;
+        for (unsigned f = 0; f < filter_len; f++) {
+            const unsigned j = ly + filter_len - 1 - f;
+            xx += (accType)l_xx[j][lx] * l_filter[f];
+            xy += (accType)l_xy[j][lx] * l_filter[f];
+            yy += (accType)l_yy[j][lx] * l_filter[f];
+        }
+        const T ixx = (T)xx;
+        const T ixy = (T)xy;
+        const T iyy = (T)yy;
 
         // Calculates matrix trace and determinant
-        T tr  = ixx_in[idx] + iyy_in[idx];
-        T det = ixx_in[idx] * iyy_in[idx] - ixy_in[idx] * ixy_in[idx];
+        T tr  = ixx + iyy;
+        T det = ixx * iyy - ixy * ixy;
 
         // Calculates local Harris response
-        resp_out[idx] = det - k_thr * (tr * tr);
+        resp_out[x * idim0 + y] = det - k_thr * (tr * tr);
     }
 }
 
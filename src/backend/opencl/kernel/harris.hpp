@@ -13,7 +13,6 @@
 #include <common/dispatch.hpp>
 #include <common/kernel_cache.hpp>
 #include <debug_opencl.hpp>
-#include <kernel/convolve_separable.hpp>
 #include <kernel/gradient.hpp>
 #include <kernel/range.hpp>
 #include <kernel/sort_by_key.hpp>
@@ -45,35 +44,30 @@ void gaussian1D(T *out, const int dim, double sigma = 0.0) {
     for (int k = 0; k < dim; k++) out[k] /= sum;
 }
 
-template<typename T, typename convAccT>
-void conv_helper(Array<T> &ixx, Array<T> &ixy, Array<T> &iyy,
-                 Array<convAccT> &filter) {
-    Array<convAccT> ixx_tmp = createEmptyArray<convAccT>(ixx.dims());
-    Array<convAccT> ixy_tmp = createEmptyArray<convAccT>(ixy.dims());
-    Array<convAccT> iyy_tmp = createEmptyArray<convAccT>(iyy.dims());
-
-    convSep<T, convAccT>(ixx_tmp, ixx, filter, 0, false);
-    convSep<T, convAccT>(ixx, ixx_tmp, filter, 1, false);
-    convSep<T, convAccT>(ixy_tmp, ixy, filter, 0, false);
-    convSep<T, convAccT>(ixy, ixy_tmp, filter, 1, false);
-    convSep<T, convAccT>(iyy_tmp, iyy, filter, 0, false);
-    convSep<T, convAccT>(iyy, iyy_tmp, filter, 1, false);
-}
+// The tile of the responses computed by a work group and the largest window
+// filter, see af_harris
+constexpr unsigned HARRIS_BLOCK_X        = 16;
+constexpr unsigned HARRIS_BLOCK_Y        = 16;
+constexpr unsigned HARRIS_MAX_FILTER_LEN = 32;
 
-template<typename T>
-std::array<Kernel, 4> getHarrisKernels() {
+template<typename T, typename convAccT>
+std::array<Kernel, 3> getHarrisKernels() {
     static const std::string src(harris_cl, harris_cl_len);
 
     std::vector<TemplateArg> targs = {
         TemplateTypename<T>(),
+        TemplateTypename<convAccT>(),
     };
     std::vector<std::string> options = {
         DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(accType, dtype_traits<convAccT>::getName()),
+        DefineKeyValue(BLOCK_X, HARRIS_BLOCK_X),
+        DefineKeyValue(BLOCK_Y, HARRIS_BLOCK_Y),
+        DefineKeyValue(MAX_FILTER_LEN, HARRIS_MAX_FILTER_LEN),
     };
     options.emplace_back(getTypeBuildDefinition<T>());
 
     return {
-        common::getKernel("second_order_deriv", {src}, targs, options),
         common::getKernel("keep_corners", {src}, targs, options),
         common::getKernel("harris_responses", {src}, targs, options),
         common::getKernel("non_maximal", {src}, targs, options),
@@ -93,11 +87,10 @@ void harris(unsigned *corners_out, Param &x_out, Param &y_out, Param &resp_out,
     using cl::EnqueueArgs;
     using cl::NDRange;
 
-    auto kernels = getHarrisKernels<T>();
-    auto soOp    = kernels[0];
-    auto kcOp    = kernels[1];
-    auto hrOp    = kernels[2];
-    auto nmOp    = kernels[3];
+    auto kernels = getHarrisKernels<T, convAccT>();
+    auto kcOp    = kernels[0];
+    auto hrOp    = kernels[1];
+    auto nmOp    = kernels[2];
 
     // Window filter
     std::vector<convAccT> h_filter(filter_len);
@@ -120,43 +113,34 @@ void harris(unsigned *corners_out, Param &x_out, Param &y_out, Param &resp_out,
     // Compute first-order derivatives as gradients
     gradient<T>(iy, ix, in);
 
-    Array<T> ixx = createEmptyArray<T>(dim4(4, in.info.dims));
-    Array<T> ixy = createEmptyArray<T>(dim4(4, in.info.dims));
-    Array<T> iyy = createEmptyArray<T>(dim4(4, in.info.dims));
-
-    // Second order-derivatives kernel sizes
-    const unsigned blk_x_so =
-        divup(in.info.dims[3] * in.info.strides[3], HARRIS_THREADS_PER_GROUP);
-    const NDRange local_so(HARRIS_THREADS_PER_GROUP, 1);
-    const NDRange global_so(blk_x_so * HARRIS_THREADS_PER_GROUP, 1);
-
-    // Compute second-order derivatives
-    soOp(EnqueueArgs(getQueue(), global_so, local_so), *ixx.get(), *ixy.get(),
-         *iyy.get(), in.info.dims[3] * in.info.strides[3], *ix.get(),
-         *iy.get());
-    CL_DEBUG_FINISH(getQueue());
-
-    // Convolve second order derivatives with proper window filter
-    conv_helper<T, convAccT>(ixx, ixy, iyy, filter);
-
     cl::Buffer *d_responses =
         bufferAlloc(in.info.dims[3] * in.info.strides[3] * sizeof(T));
 
     // Harris responses kernel sizes
-    unsigned blk_x_hr =
-        divup(in.info.dims[0] - border_len * 2, HARRIS_THREADS_X);
-    unsigned blk_y_hr =
-        divup(in.info.dims[1] - border_len * 2, HARRIS_THREADS_Y);
-    const NDRange local_hr(HARRIS_THREADS_X, HARRIS_THREADS_Y);
-    const NDRange global_hr(blk_x_hr * HARRIS_THREADS_X,
-                            blk_y_hr * HARRIS_THREADS_Y);
-
-    // Calculate Harris responses for all pixels
+    const NDRange local_hr(HARRIS_BLOCK_X, HARRIS_BLOCK_Y);
+    const NDRange global_hr(
+        divup(in.info.dims[0] - border_len * 2, HARRIS_BLOCK_X) *
+            HARRIS_BLOCK_X,
+        divup(in.info.dims[1] - border_len * 2, HARRIS_BLOCK_Y) *
+            HARRIS_BLOCK_Y);
+
+    // Calculate Harris responses for all pixels, filtering the products of
+    // the derivatives in local memory
     hrOp(EnqueueArgs(getQueue(), global_hr, local_hr), *d_responses,
          static_cast<uint>(in.info.dims[0]), static_cast<uint>(in.info.dims[1]),
-         *ixx.get(), *ixy.get(), *iyy.get(), k_thr, border_len);
+         *ix.get(), *iy.get(), *filter.get(), filter_len, k_thr, border_len);
     CL_DEBUG_FINISH(getQueue());
 
+    // Non-maximal suppression kernel sizes, the first dimension of the
+    // kernel is the second dimension of the image
+    unsigned blk_x_nm =
+        divup(in.info.dims[1] - border_len * 2, HARRIS_THREADS_X);
+    unsigned blk_y_nm =
+        divup(in.info.dims[0] - border_len * 2, HARRIS_THREADS_Y);
+    const NDRange local_nm(HARRIS_THREADS_X, HARRIS_THREADS_Y);
+    const NDRange global_nm(blk_x_nm * HARRIS_THREADS_X,
+                            blk_y_nm * HARRIS_THREADS_Y);
+
     // Number of corners is not known a priori, limit maximum number of corners
     // according to image dimensions
     unsigned corner_lim = in.info.dims[3] * in.info.strides[3] * 0.2f;
@@ -173,7 +157,7 @@ void harris(unsigned *corners_out, Param &x_out, Param &y_out, Param &resp_out,
     const float min_r = (max_corners > 0) ? 0.f : min_response;
 
     // Perform non-maximal suppression
-    nmOp(EnqueueArgs(getQueue(), global_hr, local_hr), *d_x_corners,
+    nmOp(EnqueueArgs(getQueue(), global_nm, local_nm), *d_x_corners,
          *d_y_corners, *d_resp_corners, *d_corners_found, *d_responses,
          static_cast<uint>(in.info.dims[0]), static_cast<uint>(in.info.dims[1]),
          min_r, border_len, corner_lim);
@@ -0,0 +1,104 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#if IS_WEIGHTED
+void atomicAddLocal(local float *ptr, const float val) {
+    volatile local int *iptr = (volatile local int *)ptr;
+    int old                  = *iptr;
+    int prev;
+    do {
+        prev = old;
+        old  = atomic_cmpxchg(iptr, prev, as_int(as_float(prev) + val));
+    } while (old != prev);
+}
+
+void atomicAddGlobal(global float *ptr, const float val) {
+    volatile global int *iptr = (volatile global int *)ptr;
+    int old                   = *iptr;
+    int prev;
+    do {
+        prev = old;
+        old  = atomic_cmpxchg(iptr, prev, as_int(as_float(prev) + val));
+    } while (old != prev);
+}
+#else
+#define atomicAddLocal(ptr, val) atomic_add(ptr, val)
+#define atomicAddGlobal(ptr, val) atomic_add(ptr, val)
+#endif
+
+int binIndex(float value, float minval, float step, int nbins) {
+    int bin = (int)((value - minval) / step);
+    return clamp(bin, 0, nbins - 1);
+}
+
+// Each group adds THRD_LOAD * get_local_size(0) pairs to the joint
+// histogram. The updates go to copies of the histogram in local memory,
+// which are added to the output at the end, so the work items of different
+// copies do not contend on the same bins. The copies are shared by the
+// subgroups of 32 work items when copies is their number, by the group when
+// it is 1, and the updates go to the output directly when it is 0.
+kernel void histogram2(global To *d_dst, KParam oInfo, global const T *d_x,
+                       KParam xInfo, global const T *d_y, KParam yInfo,
+                       global const float *d_w, KParam wInfo,
+                       local To *localMem, int len, int xbins, int ybins,
+                       float xmin, float xstep, float ymin, float ystep,
+                       int copies, int nBBS) {
+    const int nbins   = xbins * ybins;
+    const unsigned b2 = get_group_id(0) / nBBS;
+    const unsigned b3 = get_group_id(1);
+    const int lid     = get_local_id(0);
+    const int lsize   = get_local_size(0);
+
+    // offset inputs and output to account for batch ops
+    global const T *xptr =
+        d_x + b2 * xInfo.strides[2] + b3 * xInfo.strides[3] + xInfo.offset;
+    global const T *yptr =
+        d_y + b2 * yInfo.strides[2] + b3 * yInfo.strides[3] + yInfo.offset;
+#if IS_WEIGHTED
+    global const float *wptr =
+        d_w + b2 * wInfo.strides[2] + b3 * wInfo.strides[3] + wInfo.offset;
+#endif
+    global To *optr = d_dst + b2 * oInfo.strides[2] + b3 * oInfo.strides[3];
+
+    for (int i = lid; i < nbins * copies; i += lsize) { localMem[i] = 0; }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    local To *hist = localMem + (lid * copies / lsize) * nbins;
+
+    int start = (get_group_id(0) - b2 * nBBS) * THRD_LOAD * lsize + lid;
+    int end   = min((int)(start + THRD_LOAD * lsize), len);
+
+    for (int i = start; i < end; i += lsize) {
+        const int i0 = i % xInfo.dims[0];
+        const int i1 = i / xInfo.dims[0];
+        const int xb = binIndex((float)xptr[i0 + i1 * xInfo.strides[1]], xmin,
+                                xstep, xbins);
+        const int yb = binIndex((float)yptr[i0 + i1 * yInfo.strides[1]], ymin,
+                                ystep, ybins);
+#if IS_WEIGHTED
+        const To value = wptr[i0 + i1 * wInfo.strides[1]];
+#else
+        const To value = 1;
+#endif
+        if (copies > 0) {
+            atomicAddLocal(hist + xb + yb * xbins, value);
+        } else {
+            atomicAddGlobal(optr + xb + yb * xbins, value);
+        }
+    }
+
+    if (copies > 0) {
+        barrier(CLK_LOCAL_MEM_FENCE);
+        for (int i = lid; i < nbins; i += lsize) {
+            To sum = 0;
+            for (int c = 0; c < copies; ++c) { sum += localMem[c * nbins + i]; }
+            if (sum != 0) { atomicAddGlobal(optr + i, sum); }
+        }
+    }
+}
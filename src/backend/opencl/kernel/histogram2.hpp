@@ -0,0 +1,97 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/histogram2.hpp>
+#include <traits.hpp>
+
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+/// The number of copies of a histogram of \p nbins bins of \p binSize bytes
+/// that a group of \p threads work items keeps in \p localSize bytes of
+/// local memory for \p groupElems elements. Each subgroup of 32 work items
+/// has its own copy when the copies fit and there are fewer bins than
+/// elements per subgroup, and the group has one copy when it fits and there
+/// are fewer bins than elements. Otherwise the copies would cost more to
+/// clear and add than the updates they save, and there are none.
+inline int histogramCopies(const int nbins, const int groupElems,
+                           const int threads, const size_t binSize,
+                           const size_t localSize) {
+    const int warps = threads / 32;
+    if (nbins * warps * binSize <= localSize && nbins <= groupElems / warps) {
+        return warps;
+    }
+    if (nbins * binSize <= localSize && nbins <= groupElems) { return 1; }
+    return 0;
+}
+
+template<typename T, typename To>
+void histogram2(Param out, const Param x, const Param y, const Param weights,
+                const unsigned xbins, const unsigned ybins, const double xmin,
+                const double xmax, const double ymin, const double ymax) {
+    constexpr int THREADS_X   = 256;
+    constexpr int THRD_LOAD   = 16;
+    constexpr bool isWeighted = std::is_same<To, float>::value;
+
+    static const std::string src(histogram2_cl, histogram2_cl_len);
+
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<T>(),
+        TemplateTypename<To>(),
+    };
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(To, dtype_traits<To>::getName()),
+        DefineKeyValue(IS_WEIGHTED, isWeighted),
+        DefineValue(THRD_LOAD),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+
+    auto histogram2 = common::getKernel("histogram2", {src}, targs, options);
+
+    const int nElems     = x.info.dims[0] * x.info.dims[1];
+    const int nbins      = xbins * ybins;
+    const int blk_x      = divup(nElems, THRD_LOAD * THREADS_X);
+    const int groupElems = std::min(nElems, THRD_LOAD * THREADS_X);
+    const size_t localSize =
+        getDevice(getActiveDeviceId()).getInfo<CL_DEVICE_LOCAL_MEM_SIZE>();
+    const int copies = histogramCopies(nbins, groupElems, THREADS_X,
+                                       sizeof(To), localSize);
+    const size_t locSize = std::max<size_t>(nbins * copies * sizeof(To), 1);
+
+    cl::NDRange local(THREADS_X, 1);
+    cl::NDRange global(blk_x * x.info.dims[2] * THREADS_X, x.info.dims[3]);
+
+    // The weights are not read by the kernel of the counts, which takes the
+    // buffer of x in their place
+    const Param &w = isWeighted ? weights : x;
+
+    const float xstep = (xmax - xmin) / (float)xbins;
+    const float ystep = (ymax - ymin) / (float)ybins;
+
+    histogram2(cl::EnqueueArgs(getQueue(), global, local), *out.data,
+               out.info, *x.data, x.info, *y.data, y.info, *w.data, w.info,
+               cl::Local(locSize), nElems, int(xbins), int(ybins),
+               float(xmin), xstep, float(ymin), ystep, copies, blk_x);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+}  // namespace kernel
+}  // namespace opencl
@@ -0,0 +1,36 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// Returns the element i of in, in column major order
+T vertexComponent(global const T *in, const KParam p, dim_t i) {
+    const dim_t i0 = i % p.dims[0];
+    i /= p.dims[0];
+    const dim_t i1 = i % p.dims[1];
+    i /= p.dims[1];
+    const dim_t i2 = i % p.dims[2];
+    const dim_t i3 = i / p.dims[2];
+    return in[p.offset + i0 * p.strides[0] + i1 * p.strides[1] +
+              i2 * p.strides[2] + i3 * p.strides[3]];
+}
+
+// Writes the vertices with the COMPONENTS components of a vertex next to
+// each other, so out can be the buffer of a Forge object
+kernel void interleave(global T *out, global const T *c0, const KParam p0,
+                       global const T *c1, const KParam p1,
+                       global const T *c2, const KParam p2,
+                       const dim_t vertices) {
+    for (dim_t i = get_global_id(0); i < vertices; i += get_global_size(0)) {
+        global T *vertex = out + i * COMPONENTS;
+        vertex[0]        = vertexComponent(c0, p0, i);
+        vertex[1]        = vertexComponent(c1, p1, i);
+#if COMPONENTS == 3
+        vertex[2] = vertexComponent(c2, p2, i);
+#endif
+    }
+}
@@ -0,0 +1,71 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/interleave.hpp>
+#include <traits.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+/// Writes the vertices of the 2 or 3 \p components to \p out, with the
+/// components of a vertex next to each other. The component c of the vertex
+/// i is the element i of components[c], read with its dims and strides, so
+/// \p out can be the shared buffer of a Forge object. The kernel runs on
+/// \p queue.
+template<typename T>
+void interleave(cl::Buffer out, const std::vector<Param> &components,
+                cl::CommandQueue &queue) {
+    constexpr int THREADS       = 256;
+    constexpr size_t MAX_GROUPS = 65535;
+
+    static const std::string src(interleave_cl, interleave_cl_len);
+
+    const int count      = static_cast<int>(components.size());
+    const KParam &info   = components[0].info;
+    const dim_t vertices = info.dims[0] * info.dims[1] * info.dims[2] *
+                           info.dims[3];
+    if (vertices == 0) { return; }
+
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<T>(),
+        TemplateArg(count),
+    };
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(COMPONENTS, count),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+
+    auto interleaveOp = common::getKernel("interleave", {src}, targs, options);
+
+    const Param &c0 = components[0];
+    const Param &c1 = components[1];
+    const Param &c2 = components[count - 1];
+
+    const size_t groups =
+        std::min<size_t>(divup(vertices, THREADS), MAX_GROUPS);
+    cl::NDRange local(THREADS, 1);
+    cl::NDRange global(THREADS * groups, 1);
+    interleaveOp(cl::EnqueueArgs(queue, global, local), out, *c0.data,
+                 c0.info, *c1.data, c1.info, *c2.data, c2.info, vertices);
+    CL_DEBUG_FINISH(queue);
+}
+
+}  // namespace kernel
+}  // namespace opencl
@@ -11,6 +11,13 @@
 #define __not_select(cond, a, b) (cond) ? (b) : (a)
 #define __circular_mod(a, b) ((a) < (b)) ? (a) : (a - b)
 
+// Maps an out of range lookup index back into [0, len) like trimIndex
+int __trim_index(int idx, int len) {
+    if (idx < 0) { return (abs(idx) - 1) % len; }
+    if (idx >= len) { return len - idx % len - 1; }
+    return idx;
+}
+
 #define __noop(a) (a)
 #define __add(lhs, rhs) (lhs) + (rhs)
 #define __sub(lhs, rhs) (lhs) - (rhs)
@@ -146,6 +153,16 @@ float2 __convert_cfloat(float in) {
 
 #define __convert_char(val) (char)(convert_char((val)) != 0)
 
+// The bfloat16 values are stored as ushort. They are the upper half of the
+// bits of a float, rounded to the nearest even value.
+float __bfloat16_to_float(ushort in) { return as_float((uint)in << 16); }
+
+ushort __float_to_bfloat16(float in) {
+    uint bits = as_uint(in);
+    if ((bits & 0x7FFFFFFFu) > 0x7F800000u) { return (bits >> 16) | 0x40u; }
+    return (bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16;
+}
+
 #define frem(lhs, rhs) remainder((lhs), (rhs))
 
 #define iszero(a) ((a) == 0)
@@ -220,3 +237,59 @@ double2 __convert_c2z(float2 in) {
 double2 __convert_z2z(double2 in) { return in; }
 
 #endif  // USE_DOUBLE
+
+// The Philox4x32-10 generator of the random engine
+void __philoxRound(const uint k[2], uint c[4]) {
+    const uint hi0 = mul_hi((uint)0xD2511F53, c[0]);
+    const uint lo0 = 0xD2511F53 * c[0];
+    const uint hi1 = mul_hi((uint)0xCD9E8D57, c[2]);
+    const uint lo1 = 0xCD9E8D57 * c[2];
+    c[0]           = hi1 ^ c[1] ^ k[0];
+    c[1]           = lo1;
+    c[2]           = hi0 ^ c[3] ^ k[1];
+    c[3]           = lo0;
+}
+
+// Encrypts the counter of the work-item of the uniform Philox kernel which
+// writes the value at idx. Each work-item of the kernel writes perThread
+// values, 256 values apart. Returns the index of the value among them.
+uint __philoxValues(uint ctr[4], uint idx, uint perThread, uint lo, uint hi,
+                    uint loc, uint hic) {
+    const uint perBlock = 256 * perThread;
+    const uint index    = (idx / perBlock) * perBlock + idx % 256;
+    uint key[2]         = {lo, hi};
+    ctr[0]              = loc + index;
+    ctr[1]              = hic + (ctr[0] < loc);
+    ctr[2]              = (ctr[1] < hic);
+    ctr[3]              = 0;
+    for (int round = 0; round < 9; ++round) {
+        __philoxRound(key, ctr);
+        key[0] += 0x9E3779B9;
+        key[1] += 0xBB67AE85;
+    }
+    __philoxRound(key, ctr);
+    return (idx % perBlock) / 256;
+}
+
+// The value of a uniform float Philox array at idx
+float __philoxUniformFloat(uint idx, uint lo, uint hi, uint loc, uint hic) {
+    // 2^-32, which maps the 32 bit values into (0, 1]
+    const float factor = 2.3283064365386962890625e-10f;
+    uint ctr[4];
+    const uint word = __philoxValues(ctr, idx, 4, lo, hi, loc, hic);
+    return 1.f - fma((float)ctr[word], factor, 0.5f * factor);
+}
+
+#ifdef USE_DOUBLE
+// The value of a uniform double Philox array at idx
+double __philoxUniformDouble(uint idx, uint lo, uint hi, uint loc, uint hic) {
+    // 2^-64, which maps the 64 bit values into (0, 1]
+    const double factor =
+        2.3283064365386962890625e-10 * 2.3283064365386962890625e-10;
+    uint ctr[4];
+    const uint word = __philoxValues(ctr, idx, 2, lo, hi, loc, hic);
+    const ulong num =
+        (((ulong)ctr[2 * word]) << 32) | ((ulong)ctr[2 * word + 1]);
+    return 1.0 - fma((double)num, factor, 0.5 * factor);
+}
+#endif  // USE_DOUBLE
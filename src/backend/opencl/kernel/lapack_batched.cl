@@ -0,0 +1,237 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// Each work item factorizes or solves one MAT_N x MAT_N matrix of a batch in
+// its private memory
+
+#ifdef USE_DOUBLE
+#define TR double
+#else
+#define TR float
+#endif
+
+#if IS_CPLX
+T __mul(T lhs, T rhs) {
+    T out;
+    out.x = lhs.x * rhs.x - lhs.y * rhs.y;
+    out.y = lhs.x * rhs.y + lhs.y * rhs.x;
+    return out;
+}
+
+T __conj(T in) {
+    T out = {in.x, -in.y};
+    return out;
+}
+
+T __div(T lhs, T rhs) {
+    T out;
+    TR den = (rhs.x * rhs.x + rhs.y * rhs.y);
+    T num  = __mul(lhs, __conj(rhs));
+
+    out.x = num.x / den;
+    out.y = num.y / den;
+
+    return out;
+}
+
+#define __abs1(in) (fabs((in).x) + fabs((in).y))
+#define __abs2(in) ((in).x * (in).x + (in).y * (in).y)
+#define __real(in) ((in).x)
+#define __fromReal(in) ((T)((in), 0))
+#else
+#define __mul(lhs, rhs) ((lhs) * (rhs))
+#define __conj(in) (in)
+#define __div(lhs, rhs) ((lhs) / (rhs))
+#define __abs1(in) fabs(in)
+#define __abs2(in) ((in) * (in))
+#define __real(in) (in)
+#define __fromReal(in) (in)
+#endif
+
+#define MAT(a, i, j) a[(j)*MAT_N + (i)]
+
+void loadMatrix(T *a, const global T *d_a, const int lda) {
+    for (int j = 0; j < MAT_N; j++) {
+        for (int i = 0; i < MAT_N; i++) { MAT(a, i, j) = d_a[j * lda + i]; }
+    }
+}
+
+void storeMatrix(global T *d_a, const int lda, const T *a) {
+    for (int j = 0; j < MAT_N; j++) {
+        for (int i = 0; i < MAT_N; i++) { d_a[j * lda + i] = MAT(a, i, j); }
+    }
+}
+
+/// LU decomposition with partial pivoting. The pivots are 1 based, like the
+/// pivots of LAPACK's getrf.
+kernel void getrfBatched(global T *aptr, KParam ainfo, global int *pptr,
+                         KParam pinfo, global int *info, const int batch) {
+    const int id = get_global_id(0);
+    if (id >= batch) return;
+
+    const int z = id % ainfo.dims[2];
+    const int w = id / ainfo.dims[2];
+
+    global T *d_a = aptr + ainfo.offset + z * ainfo.strides[2] +
+                    w * ainfo.strides[3];
+    global int *d_p = pptr + pinfo.offset + z * pinfo.strides[2] +
+                      w * pinfo.strides[3];
+
+    T a[MAT_N * MAT_N];
+    loadMatrix(a, d_a, ainfo.strides[1]);
+
+    int singular = 0;
+    for (int k = 0; k < MAT_N; k++) {
+        int p   = k;
+        TR pmax = __abs1(MAT(a, k, k));
+        for (int i = k + 1; i < MAT_N; i++) {
+            TR val = __abs1(MAT(a, i, k));
+            if (val > pmax) {
+                pmax = val;
+                p    = i;
+            }
+        }
+        d_p[k] = p + 1;
+
+        if (pmax == 0) {
+            // Like getrf, the factorization continues past a zero pivot
+            if (singular == 0) singular = k + 1;
+            continue;
+        }
+
+        if (p != k) {
+            for (int j = 0; j < MAT_N; j++) {
+                T tmp        = MAT(a, k, j);
+                MAT(a, k, j) = MAT(a, p, j);
+                MAT(a, p, j) = tmp;
+            }
+        }
+
+        for (int i = k + 1; i < MAT_N; i++) {
+            T l          = __div(MAT(a, i, k), MAT(a, k, k));
+            MAT(a, i, k) = l;
+            for (int j = k + 1; j < MAT_N; j++) {
+                MAT(a, i, j) = MAT(a, i, j) - __mul(l, MAT(a, k, j));
+            }
+        }
+    }
+
+    storeMatrix(d_a, ainfo.strides[1], a);
+    info[id] = singular;
+}
+
+/// Solves one column of B with the LU decomposition of getrfBatched
+kernel void getrsBatched(const global T *aptr, KParam ainfo,
+                         const global int *pptr, KParam pinfo, global T *bptr,
+                         KParam binfo, const int batch) {
+    const int id  = get_global_id(0);
+    const int col = get_global_id(1);
+    if (id >= batch || col >= binfo.dims[1]) return;
+
+    const int z = id % ainfo.dims[2];
+    const int w = id / ainfo.dims[2];
+
+    const global T *d_a = aptr + ainfo.offset + z * ainfo.strides[2] +
+                          w * ainfo.strides[3];
+    const global int *d_p = pptr + pinfo.offset + z * pinfo.strides[2] +
+                            w * pinfo.strides[3];
+    global T *d_b = bptr + binfo.offset + z * binfo.strides[2] +
+                    w * binfo.strides[3] + col * binfo.strides[1];
+    const int lda = ainfo.strides[1];
+
+    T x[MAT_N];
+    for (int i = 0; i < MAT_N; i++) { x[i] = d_b[i]; }
+
+    for (int k = 0; k < MAT_N; k++) {
+        const int p = d_p[k] - 1;
+        if (p != k) {
+            T tmp = x[k];
+            x[k]  = x[p];
+            x[p]  = tmp;
+        }
+    }
+
+    // L has a unit diagonal
+    for (int j = 0; j < MAT_N; j++) {
+        for (int i = j + 1; i < MAT_N; i++) {
+            x[i] = x[i] - __mul(d_a[j * lda + i], x[j]);
+        }
+    }
+
+    for (int j = MAT_N - 1; j >= 0; j--) {
+        x[j] = __div(x[j], d_a[j * lda + j]);
+        for (int i = 0; i < j; i++) {
+            x[i] = x[i] - __mul(d_a[j * lda + i], x[j]);
+        }
+    }
+
+    for (int i = 0; i < MAT_N; i++) { d_b[i] = x[i]; }
+}
+
+/// Cholesky decomposition. Like LAPACK's potrf, only the triangle of the
+/// factor is read and written, and info is the order of the first leading
+/// minor which is not positive definite.
+kernel void potrfBatched(global T *aptr, KParam ainfo, global int *info,
+                         const int batch) {
+    const int id = get_global_id(0);
+    if (id >= batch) return;
+
+    const int z = id % ainfo.dims[2];
+    const int w = id / ainfo.dims[2];
+
+    global T *d_a = aptr + ainfo.offset + z * ainfo.strides[2] +
+                    w * ainfo.strides[3];
+
+    T a[MAT_N * MAT_N];
+    loadMatrix(a, d_a, ainfo.strides[1]);
+
+    int failed = 0;
+    for (int j = 0; j < MAT_N; j++) {
+#if IS_UPPER
+        // A = U^H * U
+        TR d = __real(MAT(a, j, j));
+        for (int k = 0; k < j; k++) { d -= __abs2(MAT(a, k, j)); }
+        if (!(d > 0)) {
+            failed = j + 1;
+            break;
+        }
+        const TR ujj = sqrt(d);
+        MAT(a, j, j) = __fromReal(ujj);
+
+        for (int i = j + 1; i < MAT_N; i++) {
+            T s = MAT(a, j, i);
+            for (int k = 0; k < j; k++) {
+                s = s - __mul(__conj(MAT(a, k, j)), MAT(a, k, i));
+            }
+            MAT(a, j, i) = s / ujj;
+        }
+#else
+        // A = L * L^H
+        TR d = __real(MAT(a, j, j));
+        for (int k = 0; k < j; k++) { d -= __abs2(MAT(a, j, k)); }
+        if (!(d > 0)) {
+            failed = j + 1;
+            break;
+        }
+        const TR ljj = sqrt(d);
+        MAT(a, j, j) = __fromReal(ljj);
+
+        for (int i = j + 1; i < MAT_N; i++) {
+            T s = MAT(a, i, j);
+            for (int k = 0; k < j; k++) {
+                s = s - __mul(MAT(a, i, k), __conj(MAT(a, j, k)));
+            }
+            MAT(a, i, j) = s / ljj;
+        }
+#endif
+    }
+
+    storeMatrix(d_a, ainfo.strides[1], a);
+    info[id] = failed;
+}
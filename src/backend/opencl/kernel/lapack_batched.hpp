@@ -0,0 +1,101 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/lapack_batched.hpp>
+#include <traits.hpp>
+
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+/// The largest matrices the batched kernels factorize in private memory.
+/// Larger matrices are factorized one at a time with MAGMA.
+constexpr int LAPACK_BATCHED_MAX_SIZE = 16;
+
+constexpr int LAPACK_BATCHED_THREADS = 64;
+
+template<typename T>
+Kernel getLapackBatchedKernel(const char *name, const int n,
+                              const bool is_upper = false) {
+    static const std::string src(lapack_batched_cl, lapack_batched_cl_len);
+
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<T>(),
+        TemplateArg(n),
+        TemplateArg(is_upper),
+    };
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(MAT_N, n),
+        DefineKeyValue(IS_UPPER, (is_upper ? 1 : 0)),
+        DefineKeyValue(IS_CPLX, (af::iscplx<T>() ? 1 : 0)),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+
+    return common::getKernel(name, {src}, targs, options);
+}
+
+/// Factorizes each square matrix of \p a in place and writes its 1 based
+/// pivots to \p pivot and the index of its first zero pivot to \p info
+template<typename T>
+void getrfBatched(Param a, Param pivot, Param info) {
+    const int batch = a.info.dims[2] * a.info.dims[3];
+    auto getrf = getLapackBatchedKernel<T>("getrfBatched", a.info.dims[0]);
+
+    cl::NDRange local(LAPACK_BATCHED_THREADS);
+    cl::NDRange global(divup(batch, LAPACK_BATCHED_THREADS) * local[0]);
+
+    getrf(cl::EnqueueArgs(getQueue(), global, local), *a.data, a.info,
+          *pivot.data, pivot.info, *info.data, batch);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+/// Solves the systems of the matrices factorized by getrfBatched in place of
+/// \p b
+template<typename T>
+void getrsBatched(const Param a, const Param pivot, Param b) {
+    const int batch = a.info.dims[2] * a.info.dims[3];
+    auto getrs = getLapackBatchedKernel<T>("getrsBatched", a.info.dims[0]);
+
+    cl::NDRange local(LAPACK_BATCHED_THREADS, 1);
+    cl::NDRange global(divup(batch, LAPACK_BATCHED_THREADS) * local[0],
+                       b.info.dims[1]);
+
+    getrs(cl::EnqueueArgs(getQueue(), global, local), *a.data, a.info,
+          *pivot.data, pivot.info, *b.data, b.info, batch);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+/// Computes the Cholesky factor of each matrix of \p a in place and writes
+/// the order of its first leading minor which is not positive definite to
+/// \p info
+template<typename T>
+void potrfBatched(Param a, Param info, const bool is_upper) {
+    const int batch = a.info.dims[2] * a.info.dims[3];
+    auto potrf =
+        getLapackBatchedKernel<T>("potrfBatched", a.info.dims[0], is_upper);
+
+    cl::NDRange local(LAPACK_BATCHED_THREADS);
+    cl::NDRange global(divup(batch, LAPACK_BATCHED_THREADS) * local[0]);
+
+    potrf(cl::EnqueueArgs(getQueue(), global, local), *a.data, a.info,
+          *info.data, batch);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+}  // namespace kernel
+}  // namespace opencl
@@ -0,0 +1,153 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// The running weight, mean and sum of the weighted squared differences from
+// the mean of a sequence of values
+typedef struct {
+    To weight;
+    To mean;
+    To m2;
+} Welford;
+
+void welfordAdd(Welford *acc, To value, To w) {
+    if (w == (To)0) { return; }
+    acc->weight += w;
+    const To delta = value - acc->mean;
+    acc->mean += delta * (w / acc->weight);
+    acc->m2 += w * delta * (value - acc->mean);
+}
+
+// Combines the statistics of two sequences (Chan et al.)
+void welfordCombine(Welford *acc, To weight, To mean, To m2) {
+    if (weight == (To)0) { return; }
+    const To total = acc->weight + weight;
+    const To delta = mean - acc->mean;
+    const To ratio = weight / total;
+    acc->mean += delta * ratio;
+    acc->m2 += m2 + delta * delta * acc->weight * ratio;
+    acc->weight = total;
+}
+
+// The offset of a line of the dimensions other than dim
+dim_t lineOffset(dim_t line, KParam info, int dim) {
+    dim_t offset = info.offset;
+    for (int d = 0; d < 4; ++d) {
+        if (d == dim) { continue; }
+        offset += (line % info.dims[d]) * info.strides[d];
+        line /= info.dims[d];
+    }
+    return offset;
+}
+
+void meanVarLine(Welford *acc, global const Ti *in, KParam iInfo,
+                 global const To *wt, KParam wInfo, int dim, dim_t line,
+                 dim_t begin, dim_t end, dim_t step) {
+    global const Ti *iptr = in + lineOffset(line, iInfo, dim);
+    const dim_t istride   = iInfo.strides[dim];
+#if IS_WEIGHTED
+    global const To *wptr = wt + lineOffset(line, wInfo, dim);
+    const dim_t wstride   = wInfo.strides[dim];
+#endif
+    for (dim_t i = begin; i < end; i += step) {
+#if IS_WEIGHTED
+        welfordAdd(acc, (To)iptr[i * istride], wptr[i * wstride]);
+#else
+        welfordAdd(acc, (To)iptr[i * istride], (To)1);
+#endif
+    }
+}
+
+// Reduces parts of the lines along dim into partial statistics, stored at
+// line * parts + part.
+//
+// With ALONG_LINE the lines are contiguous (dim is 0). The work-items of a
+// group read consecutive values of a part of a line and the group combines
+// their statistics. Otherwise each work-item reduces a part of a line and the
+// work-items of a group take consecutive lines, which are contiguous.
+kernel void meanVarParts(global To *pWeight, global To *pMean, global To *pM2,
+                         global const Ti *in, KParam iInfo,
+                         global const To *wt, KParam wInfo, int dim,
+                         dim_t lines) {
+    const dim_t n = iInfo.dims[dim];
+    Welford acc   = {0, 0, 0};
+
+#if ALONG_LINE
+    local To l_weight[THREADS];
+    local To l_mean[THREADS];
+    local To l_m2[THREADS];
+
+    const int lid     = get_local_id(0);
+    const dim_t parts = get_num_groups(0);
+    const dim_t part  = get_group_id(0);
+
+    for (dim_t line = get_group_id(1); line < lines;
+         line += get_num_groups(1)) {
+        acc = (Welford){0, 0, 0};
+        meanVarLine(&acc, in, iInfo, wt, wInfo, dim, line,
+                    part * THREADS + lid, n, parts * THREADS);
+
+        l_weight[lid] = acc.weight;
+        l_mean[lid]   = acc.mean;
+        l_m2[lid]     = acc.m2;
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        for (int offset = THREADS / 2; offset > 0; offset /= 2) {
+            if (lid < offset) {
+                welfordCombine(&acc, l_weight[lid + offset],
+                               l_mean[lid + offset], l_m2[lid + offset]);
+                l_weight[lid] = acc.weight;
+                l_mean[lid]   = acc.mean;
+                l_m2[lid]     = acc.m2;
+            }
+            barrier(CLK_LOCAL_MEM_FENCE);
+        }
+
+        if (lid == 0) {
+            pWeight[line * parts + part] = acc.weight;
+            pMean[line * parts + part]   = acc.mean;
+            pM2[line * parts + part]     = acc.m2;
+        }
+    }
+#else
+    const dim_t line = get_global_id(0);
+    if (line >= lines) { return; }
+
+    const dim_t parts      = get_num_groups(1);
+    const dim_t part       = get_group_id(1);
+    const dim_t partLength = (n + parts - 1) / parts;
+    const dim_t begin      = part * partLength;
+    const dim_t end        = min(begin + partLength, n);
+
+    meanVarLine(&acc, in, iInfo, wt, wInfo, dim, line, begin, end, 1);
+
+    pWeight[line * parts + part] = acc.weight;
+    pMean[line * parts + part]   = acc.mean;
+    pM2[line * parts + part]     = acc.m2;
+#endif
+}
+
+// Combines the partial statistics of each line and writes its mean and its
+// variance
+kernel void meanVarCombine(global To *mean, KParam mInfo, global To *var,
+                           KParam vInfo, global const To *pWeight,
+                           global const To *pMean, global const To *pM2,
+                           int dim, dim_t lines, int parts, To correction) {
+    const dim_t line = get_global_id(0);
+    if (line >= lines) { return; }
+
+    const dim_t first = line * parts;
+    Welford acc       = {pWeight[first], pMean[first], pM2[first]};
+    for (int part = 1; part < parts; ++part) {
+        welfordCombine(&acc, pWeight[first + part], pMean[first + part],
+                       pM2[first + part]);
+    }
+
+    mean[lineOffset(line, mInfo, dim)] = acc.mean;
+    var[lineOffset(line, vInfo, dim)]  = acc.m2 / (acc.weight - correction);
+}
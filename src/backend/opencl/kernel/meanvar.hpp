@@ -0,0 +1,116 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/meanvar.hpp>
+#include <memory.hpp>
+#include <traits.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+constexpr int MEANVAR_THREADS = 256;
+/// The number of values reduced by a work-item before the partial statistics
+/// are combined
+constexpr dim_t MEANVAR_THREAD_ELEMENTS = 64;
+/// The number of work-items which keeps the device busy
+constexpr dim_t MEANVAR_TARGET_THREADS = 1 << 16;
+constexpr dim_t MEANVAR_MAX_PARTS      = 256;
+constexpr dim_t MEANVAR_MAX_GROUPS     = 65535;
+
+/// Computes the mean and the variance of each line of \p in along \p dim in
+/// one pass.
+///
+/// Each line is split into parts whose weight, mean and sum of squared
+/// differences are computed with Welford's algorithm. A second kernel
+/// combines the parts of each line. When \p dim is 0 the work-items of a
+/// group read a part of a line together. Otherwise each work-item reads a
+/// part of a line, and the work-items of a group read consecutive lines.
+template<typename Ti, typename To>
+void meanvar(Param mean, Param var, const Param in, const Param weights,
+             const af_var_bias bias, const int dim) {
+    static const std::string src(meanvar_cl, meanvar_cl_len);
+
+    const dim_t weightElements = weights.info.dims[0] * weights.info.dims[1] *
+                                 weights.info.dims[2] * weights.info.dims[3];
+    const bool isWeighted      = weightElements != 0;
+    const bool alongLine       = dim == 0;
+
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<Ti>(),
+        TemplateTypename<To>(),
+        TemplateArg(isWeighted),
+        TemplateArg(alongLine),
+    };
+    std::vector<std::string> options = {
+        DefineKeyValue(Ti, dtype_traits<Ti>::getName()),
+        DefineKeyValue(To, dtype_traits<To>::getName()),
+        DefineKeyValue(IS_WEIGHTED, static_cast<int>(isWeighted)),
+        DefineKeyValue(ALONG_LINE, static_cast<int>(alongLine)),
+        DefineKeyValue(THREADS, MEANVAR_THREADS),
+    };
+    options.emplace_back(getTypeBuildDefinition<Ti, To>());
+
+    auto reduceParts =
+        common::getKernel("meanVarParts", {src}, targs, options);
+    auto combineParts =
+        common::getKernel("meanVarCombine", {src}, targs, options);
+
+    const dim_t n     = in.info.dims[dim];
+    const dim_t lines = in.info.dims[0] * in.info.dims[1] * in.info.dims[2] *
+                        in.info.dims[3] / n;
+
+    dim_t parts = 0;
+    cl::NDRange global;
+    if (alongLine) {
+        parts  = std::min({divup(n, MEANVAR_THREADS * MEANVAR_THREAD_ELEMENTS),
+                           divup(MEANVAR_TARGET_THREADS,
+                                 lines * MEANVAR_THREADS),
+                           MEANVAR_MAX_PARTS});
+        global = cl::NDRange(parts * MEANVAR_THREADS,
+                             std::min(lines, MEANVAR_MAX_GROUPS));
+    } else {
+        parts  = std::min({divup(n, MEANVAR_THREAD_ELEMENTS),
+                           divup(MEANVAR_TARGET_THREADS, lines),
+                           MEANVAR_MAX_PARTS});
+        global = cl::NDRange(divup(lines, MEANVAR_THREADS) * MEANVAR_THREADS,
+                             parts);
+    }
+    const cl::NDRange local(MEANVAR_THREADS, 1);
+
+    auto pWeight = memAlloc<To>(lines * parts);
+    auto pMean   = memAlloc<To>(lines * parts);
+    auto pM2     = memAlloc<To>(lines * parts);
+
+    // The weights are not read when they are empty
+    const cl::Buffer &wt = isWeighted ? *weights.data : *mean.data;
+    reduceParts(cl::EnqueueArgs(getQueue(), global, local), *pWeight, *pMean,
+                *pM2, *in.data, in.info, wt, weights.info, dim, lines);
+    CL_DEBUG_FINISH(getQueue());
+
+    const To correction(bias == AF_VARIANCE_SAMPLE ? 1 : 0);
+    const cl::NDRange combineGlobal(
+        divup(lines, MEANVAR_THREADS) * MEANVAR_THREADS, 1);
+    combineParts(cl::EnqueueArgs(getQueue(), combineGlobal, local), *mean.data,
+                 mean.info, *var.data, var.info, *pWeight, *pMean, *pM2, dim,
+                 lines, static_cast<int>(parts), correction);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+}  // namespace kernel
+}  // namespace opencl
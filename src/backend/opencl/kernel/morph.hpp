@@ -15,6 +15,7 @@
 #include <common/kernel_cache.hpp>
 #include <debug_opencl.hpp>
 #include <kernel_headers/morph.hpp>
+#include <kernel_headers/morph_line.hpp>
 #include <memory.hpp>
 #include <traits.hpp>
 
@@ -147,5 +148,48 @@ void morph3d(Param out, const Param in, const Param mask, bool isDilation) {
             *in.data, in.info, *mBuff, cl::Local(locSize * sizeof(T)), blk_x);
     CL_DEBUG_FINISH(getQueue());
 }
+template<typename T>
+void morphLine(Param out, const Param in, int axis, int windLen,
+               bool isDilation) {
+    using cl::EnqueueArgs;
+    using cl::NDRange;
+    using std::string;
+    using std::vector;
+
+    constexpr int THREADS = 256;
+
+    ToNumStr<T> toNumStr;
+    const T DefaultVal = isDilation ? common::Binary<T, af_max_t>::init()
+                                    : common::Binary<T, af_min_t>::init();
+
+    static const string src(morph_line_cl, morph_line_cl_len);
+
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<T>(),
+        TemplateArg(isDilation),
+    };
+    vector<string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineValue(isDilation),
+        DefineKeyValue(init, toNumStr(DefaultVal)),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+
+    auto morphLineOp = common::getKernel("morphLine", {src}, targs, options);
+
+    const int nBlocks = divup(in.info.dims[axis], windLen);
+    int lines         = 1;
+    for (int k = 0; k < 4; ++k) {
+        if (k != axis) { lines *= in.info.dims[k]; }
+    }
+
+    NDRange local(THREADS);
+    NDRange global(divup(lines * nBlocks, THREADS) * THREADS);
+
+    morphLineOp(EnqueueArgs(getQueue(), global, local), *out.data, out.info,
+                *in.data, in.info, axis, windLen, nBlocks);
+    CL_DEBUG_FINISH(getQueue());
+}
+
 }  // namespace kernel
 }  // namespace opencl
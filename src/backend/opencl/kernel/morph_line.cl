@@ -0,0 +1,60 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+T morphOp(T a, T b) { return isDilation ? max(a, b) : min(a, b); }
+
+// Applies a flat window of windLen elements along dimension axis with the
+// van Herk/Gil-Werman algorithm. Each work item computes windLen consecutive
+// outputs along the axis. All of their windows span the end of one block of
+// windLen inputs and the start of the next, so each output combines a
+// suffix extreme with a prefix extreme at a constant cost per element.
+// Elements beyond the edges are init.
+kernel void morphLine(global T *out, KParam oInfo, global const T *in,
+                      KParam iInfo, int axis, int windLen, int nBlocks) {
+    int rem = get_global_id(0);
+    int idx[4];
+#pragma unroll
+    for (int k = 0; k < 4; ++k) {
+        const int len = (k == axis ? nBlocks : iInfo.dims[k]);
+        idx[k]        = rem % len;
+        rem /= len;
+    }
+    if (rem > 0) return;
+
+    const int x0 = idx[axis] * windLen;
+    idx[axis]    = 0;
+    in += iInfo.offset + idx[0] * iInfo.strides[0] +
+          idx[1] * iInfo.strides[1] + idx[2] * iInfo.strides[2] +
+          idx[3] * iInfo.strides[3];
+    out += oInfo.offset + idx[0] * oInfo.strides[0] +
+           idx[1] * oInfo.strides[1] + idx[2] * oInfo.strides[2] +
+           idx[3] * oInfo.strides[3];
+
+    const int len     = iInfo.dims[axis];
+    const int istride = iInfo.strides[axis];
+    const int ostride = oInfo.strides[axis];
+    // The first input of the next block
+    const int split = x0 - windLen / 2 + windLen;
+
+    T acc = init;
+    for (int i = windLen - 1; i >= 0; --i) {
+        const int p = split - windLen + i;
+        if (p >= 0 && p < len) acc = morphOp(acc, in[p * istride]);
+        if (x0 + i < len) out[(x0 + i) * ostride] = acc;
+    }
+
+    acc = init;
+    for (int i = 0; i < windLen && x0 + i < len; ++i) {
+        const int o = (x0 + i) * ostride;
+        out[o]      = morphOp(out[o], acc);
+
+        const int p = split + i;
+        if (p >= 0 && p < len) acc = morphOp(acc, in[p * istride]);
+    }
+}
@@ -0,0 +1,119 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// The keys are unsigned integers which are ordered like the values
+ulong toKey(T v) {
+#if IS_FLOAT && KEY_BITS == 64
+    ulong bits = as_ulong(v);
+    return bits ^ ((bits >> 63) ? ~0UL : (1UL << 63));
+#elif IS_FLOAT
+    uint bits = as_uint(v);
+    return bits ^ ((bits >> 31) ? 0xffffffffu : 0x80000000u);
+#elif IS_SIGNED
+    return ((ulong)v ^ (1UL << (KEY_BITS - 1))) & ((1UL << KEY_BITS) - 1);
+#else
+    return (ulong)v;
+#endif
+}
+
+T fromKey(ulong key) {
+#if IS_FLOAT && KEY_BITS == 64
+    return as_double(key ^ ((key >> 63) ? (1UL << 63) : ~0UL));
+#elif IS_FLOAT
+    uint bits = (uint)key;
+    return as_float(bits ^ ((bits >> 31) ? 0x80000000u : 0xffffffffu));
+#elif IS_SIGNED
+    return (T)(key ^ (1UL << (KEY_BITS - 1)));
+#else
+    return (T)key;
+#endif
+}
+
+// The offset of a line of the dimensions other than dim
+dim_t lineOffset(dim_t line, KParam info, int dim) {
+    dim_t offset = info.offset;
+    for (int d = 0; d < 4; ++d) {
+        if (d == dim) { continue; }
+        offset += (line % info.dims[d]) * info.strides[d];
+        line /= info.dims[d];
+    }
+    return offset;
+}
+
+// Counts the digits at shift of the values whose higher digits match the
+// prefix of the two ranks selected in each line
+kernel void nthElementHistogram(global uint *hist, global const ulong *prefix,
+                                global const T *in, KParam iInfo, int dim,
+                                dim_t lines, int shift, ulong highMask) {
+    local uint l_hist[2 * 256];
+
+    const int lid       = get_local_id(0);
+    const dim_t n       = iInfo.dims[dim];
+    const dim_t stride  = iInfo.strides[dim];
+    const dim_t threads = get_global_size(0);
+
+    for (dim_t line = get_group_id(1); line < lines;
+         line += get_num_groups(1)) {
+        for (int i = lid; i < 2 * 256; i += get_local_size(0)) {
+            l_hist[i] = 0;
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        const ulong prefix0 = prefix[2 * line];
+        const ulong prefix1 = prefix[2 * line + 1];
+
+        global const T *iptr = in + lineOffset(line, iInfo, dim);
+        for (dim_t i = get_global_id(0); i < n; i += threads) {
+            const ulong key  = toKey(iptr[i * stride]);
+            const int digit  = (key >> shift) & 0xff;
+            const ulong high = key & highMask;
+            if (high == prefix0) { atomic_inc(l_hist + digit); }
+            if (high == prefix1) { atomic_inc(l_hist + 256 + digit); }
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        global uint *hptr = hist + 2 * 256 * line;
+        for (int i = lid; i < 2 * 256; i += get_local_size(0)) {
+            if (l_hist[i]) { atomic_add(hptr + i, l_hist[i]); }
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+}
+
+// Finds the digit of each rank and appends it to its prefix. The rank is
+// made relative to the values of the prefix. The last pass writes the values.
+kernel void nthElementSelect(global T *out, KParam oInfo,
+                             global ulong *prefix, global dim_t *ranks,
+                             global const uint *hist, int dim, dim_t lines,
+                             dim_t n, dim_t rank, int shift, int firstPass,
+                             int lastPass) {
+    const dim_t query = get_global_id(0);
+    if (query >= 2 * lines) { return; }
+
+    dim_t r = rank + (query & 1);
+    if (firstPass) {
+        r = r < n ? r : n - 1;
+    } else {
+        r = ranks[query];
+    }
+
+    global const uint *hptr = hist + 256 * query;
+    int digit               = 0;
+    for (; digit < 255 && r >= hptr[digit]; ++digit) { r -= hptr[digit]; }
+
+    const ulong key = prefix[query] | ((ulong)digit << shift);
+    prefix[query]   = key;
+    ranks[query]    = r;
+
+    if (lastPass) {
+        const dim_t line = query / 2;
+        out[lineOffset(line, oInfo, dim) + (query & 1) * oInfo.strides[dim]] =
+            fromKey(key);
+    }
+}
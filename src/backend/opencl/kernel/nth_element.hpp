@@ -0,0 +1,101 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/nth_element.hpp>
+#include <memory.hpp>
+#include <traits.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+constexpr int NTH_ELEMENT_THREADS        = 256;
+constexpr int NTH_ELEMENT_BLOCK_ELEMENTS = 32 * NTH_ELEMENT_THREADS;
+constexpr dim_t NTH_ELEMENT_MAX_GROUPS   = 65535;
+
+/// Selects the values of rank \p rank and rank + 1 of each line along \p dim
+/// with a most significant digit radix select.
+///
+/// The values are mapped to unsigned keys with the same order. Each pass
+/// counts the next 8 bit digit of the keys whose higher digits match the
+/// prefix found so far, then picks the digit holding each rank. After
+/// sizeof(T) passes the prefixes are the selected keys. Each pass reads the
+/// input once, and the only memory allocated is a histogram of 256 counters
+/// for each selected value.
+template<typename T>
+void nthElement(Param out, const Param in, const int dim, const dim_t rank) {
+    static const std::string src(nth_element_cl, nth_element_cl_len);
+
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<T>(),
+    };
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(IS_FLOAT, !std::numeric_limits<T>::is_integer),
+        DefineKeyValue(IS_SIGNED, std::numeric_limits<T>::is_signed),
+        DefineKeyValue(KEY_BITS, static_cast<int>(sizeof(T) * 8)),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+
+    auto histogram =
+        common::getKernel("nthElementHistogram", {src}, targs, options);
+    auto select = common::getKernel("nthElementSelect", {src}, targs, options);
+
+    const dim_t n       = in.info.dims[dim];
+    const dim_t lines   = in.info.dims[0] * in.info.dims[1] *
+                        in.info.dims[2] * in.info.dims[3] / n;
+    const dim_t queries = 2 * lines;
+
+    auto hist   = memAlloc<uint>(queries * 256);
+    auto prefix = memAlloc<uintl>(queries);
+    auto ranks  = memAlloc<intl>(queries);
+    getQueue().enqueueFillBuffer(*prefix, cl_ulong(0), 0,
+                                 queries * sizeof(cl_ulong));
+
+    const dim_t groupsPerLine =
+        std::min(divup(n, NTH_ELEMENT_BLOCK_ELEMENTS), NTH_ELEMENT_MAX_GROUPS);
+    const cl::NDRange local(NTH_ELEMENT_THREADS, 1);
+    const cl::NDRange histGlobal(
+        groupsPerLine * NTH_ELEMENT_THREADS,
+        std::min(lines, NTH_ELEMENT_MAX_GROUPS));
+    const cl::NDRange selectGlobal(
+        divup(queries, NTH_ELEMENT_THREADS) * NTH_ELEMENT_THREADS, 1);
+
+    const int passes = sizeof(T);
+    for (int pass = 0; pass < passes; ++pass) {
+        const int shift = (passes - 1 - pass) * 8;
+        const cl_ulong highMask =
+            shift + 8 >= 64 ? 0 : ~((cl_ulong(1) << (shift + 8)) - 1);
+
+        getQueue().enqueueFillBuffer(*hist, cl_uint(0), 0,
+                                     queries * 256 * sizeof(cl_uint));
+        histogram(cl::EnqueueArgs(getQueue(), histGlobal, local), *hist,
+                  *prefix, *in.data, in.info, dim, lines, shift, highMask);
+        CL_DEBUG_FINISH(getQueue());
+
+        select(cl::EnqueueArgs(getQueue(), selectGlobal, local), *out.data,
+               out.info, *prefix, *ranks, *hist, dim, lines, n, rank, shift,
+               static_cast<int>(pass == 0),
+               static_cast<int>(pass == passes - 1));
+        CL_DEBUG_FINISH(getQueue());
+    }
+}
+
+}  // namespace kernel
+}  // namespace opencl
@@ -9,10 +9,18 @@
 
 #define IS_NAN(in) !((in) == (in))
 
+// The bfloat16 values are read as ushort, and are the upper half of the bits
+// of a float
+#if IS_BF16
+#define CONVERT_IN(in) as_float((uint)(in) << 16)
+#else
+#define CONVERT_IN(in) (in)
+#endif
+
 #ifdef ADD_OP
 T binOp(T lhs, T rhs) { return lhs + rhs; }
 
-To transform(Ti in) { return (To)(in); }
+To transform(Ti in) { return (To)(CONVERT_IN(in)); }
 #endif
 
 #ifdef MUL_OP
@@ -27,7 +35,7 @@ T binOp(T lhs, T rhs) {
 T binOp(T lhs, T rhs) { return lhs * rhs; }
 #endif
 
-To transform(Ti in) { return (To)(in); }
+To transform(Ti in) { return (To)(CONVERT_IN(in)); }
 #endif
 
 #ifdef OR_OP
@@ -0,0 +1,202 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// Samplers of the distributions with per element parameters. They implement
+// the algorithms of common/random_distributions.hpp, which are shared by the
+// CPU and CUDA kernels. SAMPLE is the sampler of the kernel.
+
+// The largest number of proposals of a rejection sampler
+#define MAX_TRIALS 1000
+// The index of the stream of the values of an element, in the last word of
+// the Philox counter. The uniform and normal kernels leave it at 0.
+#define DIST_STREAM 1
+
+// The random values of an element. They are the Philox values of the seed
+// and of a counter made of the counter of the engine plus the index of the
+// element, the index of the draw and DIST_STREAM.
+typedef struct {
+    uint key[2];
+    uint ctr[4];
+    uint words[4];
+    int next;
+    int hasNormal;
+    T normal;
+} ElementStream;
+
+void initStream(ElementStream *s, uint hi, uint lo, ulong counter) {
+    s->key[0]    = lo;
+    s->key[1]    = hi;
+    s->ctr[0]    = (uint)counter;
+    s->ctr[1]    = (uint)(counter >> 32);
+    s->ctr[2]    = 0;
+    s->ctr[3]    = DIST_STREAM;
+    s->next      = 4;
+    s->hasNormal = 0;
+    s->normal    = 0;
+}
+
+uint streamWord(ElementStream *s) {
+    if (s->next == 4) {
+        uint key[2] = {s->key[0], s->key[1]};
+        for (int i = 0; i < 4; ++i) { s->words[i] = s->ctr[i]; }
+        philox(key, s->words);
+        ++s->ctr[2];
+        s->next = 0;
+    }
+    return s->words[s->next++];
+}
+
+// Returns a value in (0, 1]
+T streamUniform(ElementStream *s) {
+#ifdef USE_DOUBLE
+    uint num1 = streamWord(s);
+    return getDouble01(num1, streamWord(s));
+#else
+    return getFloat01(streamWord(s));
+#endif
+}
+
+// Returns a value of the standard normal distribution. The values are
+// generated in pairs with the Box-Muller transform.
+T streamNormal(ElementStream *s) {
+    if (s->hasNormal) {
+        s->hasNormal = 0;
+        return s->normal;
+    }
+    T r          = sqrt((T)(-2.0) * log(streamUniform(s)));
+    T turns      = (T)(2.0) * streamUniform(s);
+    s->normal    = r * sinpi(turns);
+    s->hasNormal = 1;
+    return r * cospi(turns);
+}
+
+T sampleExponential(ElementStream *s, T rate, T unused) {
+    if (!(rate > (T)(0))) { return (T)NAN; }
+    return -log(streamUniform(s)) / rate;
+}
+
+// Marsaglia and Tsang (2000). Shapes below 1 are boosted by 1 and the value
+// is multiplied by u^(1 / shape).
+T sampleGamma(ElementStream *s, T shape, T scale) {
+    if (!(shape > (T)(0)) || !(scale > (T)(0))) { return (T)NAN; }
+
+    bool boost = shape < (T)(1);
+    T d        = (boost ? shape + (T)(1) : shape) - (T)(1.0 / 3.0);
+    T c        = (T)(1) / sqrt((T)(9) * d);
+    for (int trial = 0; trial < MAX_TRIALS; ++trial) {
+        T x = streamNormal(s);
+        T v = (T)(1) + c * x;
+        if (v <= (T)(0)) { continue; }
+        v *= v * v;
+
+        T u  = streamUniform(s);
+        T x2 = x * x;
+        if (u < (T)(1) - (T)(0.0331) * x2 * x2 ||
+            log(u) < (T)(0.5) * x2 + d * ((T)(1) - v + log(v))) {
+            T value = d * v * scale;
+            if (!boost) { return value; }
+            return value * exp(log(streamUniform(s)) / shape);
+        }
+    }
+    return (T)NAN;
+}
+
+// Knuth below a mean of 10, transformed rejection (PTRS) of Hörmann (1993)
+// above
+T samplePoisson(ElementStream *s, T lambda, T unused) {
+    if (!(lambda >= (T)(0))) { return (T)NAN; }
+    if (lambda == (T)(0)) { return (T)(0); }
+
+    if (lambda < (T)(10)) {
+        T limit   = exp(-lambda);
+        T product = streamUniform(s);
+        T k       = (T)(0);
+        while (product > limit && k < (T)(MAX_TRIALS)) {
+            product *= streamUniform(s);
+            k += (T)(1);
+        }
+        return k;
+    }
+
+    T logLambda = log(lambda);
+    T b         = (T)(0.931) + (T)(2.53) * sqrt(lambda);
+    T a         = (T)(-0.059) + (T)(0.02483) * b;
+    T invAlpha  = (T)(1.1239) + (T)(1.1328) / (b - (T)(3.4));
+    T vr        = (T)(0.9277) - (T)(3.6224) / (b - (T)(2));
+    for (int trial = 0; trial < MAX_TRIALS; ++trial) {
+        T u  = streamUniform(s) - (T)(0.5);
+        T v  = streamUniform(s);
+        T us = (T)(0.5) - fabs(u);
+        T k  = floor(((T)(2) * a / us + b) * u + lambda + (T)(0.43));
+        if (us >= (T)(0.07) && v <= vr) { return k; }
+        if (k < (T)(0) || (us < (T)(0.013) && v > us)) { continue; }
+        if (log(v) + log(invAlpha) - log(a / (us * us) + b) <=
+            -lambda + k * logLambda - lgamma(k + (T)(1))) {
+            return k;
+        }
+    }
+    return (T)NAN;
+}
+
+// Robert (1995): normal proposals when the interval contains 0 and is wide,
+// uniform proposals when it is narrow, and shifted exponential proposals in
+// a tail. Tails below 0 are mirrored.
+T sampleTruncatedNormal(ElementStream *s, T lower, T upper) {
+    if (!(lower < upper)) { return (T)NAN; }
+
+    bool mirror = upper <= (T)(0);
+    T a         = mirror ? -upper : lower;
+    T b         = mirror ? -lower : upper;
+    T sign      = mirror ? (T)(-1) : (T)(1);
+    // sqrt(2 pi)
+    T wide = (T)(2.5066282746310002);
+
+    for (int trial = 0; trial < MAX_TRIALS; ++trial) {
+        if (a <= (T)(0)) {
+            if (b - a >= wide) {
+                T z = streamNormal(s);
+                if (a <= z && z <= b) { return sign * z; }
+            } else {
+                T z = a + (b - a) * streamUniform(s);
+                if (streamUniform(s) <= exp((T)(-0.5) * z * z)) {
+                    return sign * z;
+                }
+            }
+            continue;
+        }
+
+        T root   = sqrt(a * a + (T)(4));
+        T alpha  = (T)(0.5) * (a + root);
+        T narrow = a + (T)(2) / (a + root) *
+                           exp((T)(0.25) * (a * a - a * root) + (T)(0.5));
+        if (b < narrow) {
+            T z = a + (b - a) * streamUniform(s);
+            if (streamUniform(s) <= exp((T)(0.5) * (a * a - z * z))) {
+                return sign * z;
+            }
+        } else {
+            T z  = a - log(streamUniform(s)) / alpha;
+            T sh = z - alpha;
+            if (z <= b && streamUniform(s) <= exp((T)(-0.5) * sh * sh)) {
+                return sign * z;
+            }
+        }
+    }
+    return (T)NAN;
+}
+
+kernel void randomDistribution(global T *out, global const T *param0,
+                               global const T *param1, uint hi, uint lo,
+                               ulong counter, ulong elements) {
+    for (ulong i = get_global_id(0); i < elements; i += get_global_size(0)) {
+        ElementStream s;
+        initStream(&s, hi, lo, counter + i);
+        out[i] = SAMPLE(&s, param0[i], param1[i]);
+    }
+}
@@ -0,0 +1,88 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/dispatch.hpp>
+#include <common/internal_enums.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/random_distributions.hpp>
+#include <kernel_headers/random_engine_philox.hpp>
+#include <kernel_headers/random_engine_write.hpp>
+#include <traits.hpp>
+#include <af/defines.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+constexpr int RANDOM_DIST_THREADS = 256;
+/// The largest number of groups of randomDistribution. The work-items of the
+/// groups step through the elements of larger arrays.
+constexpr size_t RANDOM_DIST_MAX_GROUPS = 65535;
+
+/// Writes a value of \p dist to each element of \p out, with the parameters
+/// of the same elements of \p param0 and \p param1. The arrays are linear.
+///
+/// The sampler of \p dist is selected when the kernel is compiled, and
+/// Philox is compiled with the write functions of the uniform kernel.
+template<typename T>
+void randomDistribution(cl::Buffer out, cl::Buffer param0, cl::Buffer param1,
+                        const size_t elements, const AF_RANDOM_DIST dist,
+                        const uintl &seed, uintl &counter) {
+    if (elements == 0) { return; }
+
+    const char *sampler = nullptr;
+    switch (dist) {
+        case AF_RANDOM_EXPONENTIAL: sampler = "sampleExponential"; break;
+        case AF_RANDOM_GAMMA: sampler = "sampleGamma"; break;
+        case AF_RANDOM_POISSON: sampler = "samplePoisson"; break;
+        case AF_RANDOM_TRUNCATED_NORMAL:
+            sampler = "sampleTruncatedNormal";
+            break;
+    }
+
+    std::vector<std::string> sources = {
+        std::string(random_engine_write_cl, random_engine_write_cl_len),
+        std::string(random_engine_philox_cl, random_engine_philox_cl_len),
+        std::string(random_distributions_cl, random_distributions_cl_len)};
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<T>(),
+        TemplateArg(sampler),
+    };
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(THREADS, RANDOM_DIST_THREADS),
+        DefineKeyValue(RAND_DIST, 0),
+        DefineKeyValue(ELEMENTS_PER_BLOCK,
+                       RANDOM_DIST_THREADS * 4 * sizeof(uint) / sizeof(T)),
+        DefineKeyValue(SAMPLE, sampler),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+
+    auto distOp =
+        common::getKernel("randomDistribution", sources, targs, options);
+
+    const size_t groups = std::min(divup(elements, RANDOM_DIST_THREADS),
+                                   RANDOM_DIST_MAX_GROUPS);
+    cl::NDRange local(RANDOM_DIST_THREADS, 1);
+    cl::NDRange global(RANDOM_DIST_THREADS * groups, 1);
+    distOp(cl::EnqueueArgs(getQueue(), global, local), out, param0, param1,
+           static_cast<uint>(seed >> 32), static_cast<uint>(seed),
+           static_cast<cl_ulong>(counter), static_cast<cl_ulong>(elements));
+    counter += elements;
+    CL_DEBUG_FINISH(getQueue());
+}
+
+}  // namespace kernel
+}  // namespace opencl
@@ -13,6 +13,7 @@
 #include <Param.hpp>
 #include <common/Binary.hpp>
 #include <common/Transform.hpp>
+#include <common/bfloat16.hpp>
 #include <common/dispatch.hpp>
 #include <common/half.hpp>
 #include <common/kernel_cache.hpp>
@@ -20,10 +21,12 @@
 #include <kernel/config.hpp>
 #include <kernel/names.hpp>
 #include <kernel_headers/ops.hpp>
+#include <kernel_headers/reduce_all.hpp>
 #include <kernel_headers/reduce_dim.hpp>
 #include <kernel_headers/reduce_first.hpp>
 #include <math.hpp>
 #include <memory.hpp>
+#include <platform.hpp>
 #include <traits.hpp>
 
 #include <string>
@@ -44,6 +47,7 @@ void reduceDimLauncher(Param out, Param in, const int dim, const uint threads_y,
         TemplateTypename<Ti>(), TemplateTypename<To>(), TemplateArg(dim),
         TemplateArg(op),        TemplateArg(threads_y),
     };
+    constexpr bool IsBf16 = std::is_same<Ti, common::bfloat16>::value;
     std::vector<std::string> options = {
         DefineKeyValue(Ti, dtype_traits<Ti>::getName()),
         DefineKeyValue(To, dtype_traits<To>::getName()),
@@ -54,6 +58,7 @@ void reduceDimLauncher(Param out, Param in, const int dim, const uint threads_y,
         DefineKeyValue(init, toNumStr(common::Binary<To, op>::init())),
         DefineKeyFromStr(binOpName<op>()),
         DefineKeyValue(CPLX, af::iscplx<Ti>()),
+        DefineKeyValue(IS_BF16, IsBf16),
     };
     options.emplace_back(getTypeBuildDefinition<Ti, To>());
 
@@ -119,6 +124,10 @@ void reduceFirstLauncher(Param out, Param in, const uint groups_x,
     static const std::string src1(ops_cl, ops_cl_len);
     static const std::string src2(reduce_first_cl, reduce_first_cl_len);
 
+    // The complex types are vectors, which the subgroup shuffles do not take
+    const bool useSubgroups =
+        !af::iscplx<To>() && isSubgroupShuffleSupported(getActiveDeviceId());
+
     ToNumStr<To> toNumStr;
     std::vector<TemplateArg> targs = {
         TemplateTypename<Ti>(),
@@ -126,6 +135,7 @@ void reduceFirstLauncher(Param out, Param in, const uint groups_x,
         TemplateArg(op),
         TemplateArg(threads_x),
     };
+    constexpr bool IsBf16 = std::is_same<Ti, common::bfloat16>::value;
     std::vector<std::string> options = {
         DefineKeyValue(Ti, dtype_traits<Ti>::getName()),
         DefineKeyValue(To, dtype_traits<To>::getName()),
@@ -135,6 +145,8 @@ void reduceFirstLauncher(Param out, Param in, const uint groups_x,
         DefineKeyValue(init, toNumStr(common::Binary<To, op>::init())),
         DefineKeyFromStr(binOpName<op>()),
         DefineKeyValue(CPLX, af::iscplx<Ti>()),
+        DefineKeyValue(IS_BF16, IsBf16),
+        DefineKeyValue(USE_SUBGROUPS, useSubgroups),
     };
     options.emplace_back(getTypeBuildDefinition<Ti, To>());
 
@@ -153,6 +165,63 @@ void reduceFirstLauncher(Param out, Param in, const uint groups_x,
     CL_DEBUG_FINISH(getQueue());
 }
 
+/// The groups of reduce_all_partials. The values of the groups are combined
+/// by a single group, so their number is kept low.
+static const uint REDUCE_ALL_MAX_GROUPS = 1024;
+
+/// Reduces the first \p elements values of the linear array \p in to the
+/// first value of \p out. The groups of the first launch reduce tiles of the
+/// input and a single group combines their values in a second launch, so
+/// only one value is copied to the host.
+template<typename Ti, typename To, af_op_t op>
+void reduceAllLauncher(cl::Buffer *out, Param in, int elements,
+                       int change_nan, double nanval) {
+    static const std::string src1(ops_cl, ops_cl_len);
+    static const std::string src2(reduce_all_cl, reduce_all_cl_len);
+
+    ToNumStr<To> toNumStr;
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<Ti>(),
+        TemplateTypename<To>(),
+        TemplateArg(op),
+    };
+    constexpr bool IsBf16 = std::is_same<Ti, common::bfloat16>::value;
+    std::vector<std::string> options = {
+        DefineKeyValue(Ti, dtype_traits<Ti>::getName()),
+        DefineKeyValue(To, dtype_traits<To>::getName()),
+        DefineKeyValue(T, "To"),
+        DefineValue(THREADS_PER_GROUP),
+        DefineKeyValue(init, toNumStr(common::Binary<To, op>::init())),
+        DefineKeyFromStr(binOpName<op>()),
+        DefineKeyValue(CPLX, af::iscplx<Ti>()),
+        DefineKeyValue(IS_BF16, IsBf16),
+    };
+    options.emplace_back(getTypeBuildDefinition<Ti, To>());
+
+    auto partials =
+        common::getKernel("reduce_all_partials", {src1, src2}, targs, options);
+    auto combine =
+        common::getKernel("reduce_all_combine", {src1, src2}, targs, options);
+
+    const uint groups = std::min<uint>(
+        divup(elements, THREADS_PER_GROUP * REPEAT), REDUCE_ALL_MAX_GROUPS);
+    const uint repeat = divup(elements, groups * THREADS_PER_GROUP);
+
+    cl::Buffer *pData = bufferAlloc(groups * sizeof(To));
+
+    cl::NDRange local(THREADS_PER_GROUP);
+    cl::NDRange global(groups * THREADS_PER_GROUP);
+
+    partials(cl::EnqueueArgs(getQueue(), global, local), *pData, *in.data,
+             in.info, elements, repeat, change_nan, scalar<To>(nanval));
+    CL_DEBUG_FINISH(getQueue());
+
+    combine(cl::EnqueueArgs(getQueue(), local, local), *out, *pData, groups);
+    CL_DEBUG_FINISH(getQueue());
+
+    bufferFree(pData);
+}
+
 template<typename Ti, typename To, af_op_t op>
 void reduceFirst(Param out, Param in, int change_nan, double nanval) {
     uint threads_x = nextpow2(std::max(32u, (uint)in.info.dims[0]));
@@ -208,15 +277,16 @@ To reduceAll(Param in, int change_nan, double nanval) {
     }
 
     // FIXME: Use better heuristics to get to the optimum number
-    if (in_elements > 4096 || !is_linear) {
-        if (is_linear) {
-            in.info.dims[0] = in_elements;
-            for (int k = 1; k < 4; k++) {
-                in.info.dims[k]    = 1;
-                in.info.strides[k] = in_elements;
-            }
-        }
-
+    if (in_elements > 4096 && is_linear) {
+        Array<To> out = createEmptyArray<To>(af::dim4(1));
+        reduceAllLauncher<Ti, To, op>(out.get(), in, in_elements, change_nan,
+                                      nanval);
+
+        To h_out;
+        getQueue().enqueueReadBuffer(*out.get(), CL_TRUE, 0, sizeof(To),
+                                     &h_out);
+        return h_out;
+    } else if (!is_linear) {
         uint threads_x = nextpow2(std::max(32u, (uint)in.info.dims[0]));
         threads_x      = std::min(threads_x, THREADS_PER_GROUP);
         uint threads_y = THREADS_PER_GROUP / threads_x;
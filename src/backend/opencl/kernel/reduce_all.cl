@@ -0,0 +1,64 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// Reduces the values of the work items of a group to s_val[0]
+void reduceGroup(local To *s_val, To val) {
+    const uint lid = get_local_id(0);
+    s_val[lid]     = val;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (uint n = THREADS_PER_GROUP / 2; n > 0; n /= 2) {
+        if (lid < n) s_val[lid] = binOp(s_val[lid], s_val[lid + n]);
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+}
+
+// Reduces a tile of the linear array iData per group to pData. The values of
+// the groups are combined by reduce_all_combine in a second launch, because
+// OpenCL 1.2 does not make the global writes of a group visible to the other
+// groups of the same launch.
+kernel void reduce_all_partials(global To *pData, const global Ti *iData,
+                                KParam iInfo, int elements, uint repeat,
+                                int change_nan, To nanval) {
+    const uint lid = get_local_id(0);
+    const uint xid = get_group_id(0) * THREADS_PER_GROUP * repeat + lid;
+
+    iData += iInfo.offset;
+
+    local To s_val[THREADS_PER_GROUP];
+
+    int last   = (xid + repeat * THREADS_PER_GROUP);
+    int lim    = last > elements ? elements : last;
+    To out_val = init;
+
+    for (int id = xid; id < lim; id += THREADS_PER_GROUP) {
+        To in_val = transform(iData[id]);
+        if (change_nan) in_val = !IS_NAN(in_val) ? in_val : nanval;
+        out_val = binOp(in_val, out_val);
+    }
+    reduceGroup(s_val, out_val);
+
+    if (lid == 0) pData[get_group_id(0)] = s_val[0];
+}
+
+// Reduces the ngroups values of pData to oData[0] with a single group
+kernel void reduce_all_combine(global To *oData, const global To *pData,
+                               uint ngroups) {
+    const uint lid = get_local_id(0);
+
+    local To s_val[THREADS_PER_GROUP];
+
+    To out_val = init;
+    for (uint i = lid; i < ngroups; i += THREADS_PER_GROUP) {
+        out_val = binOp(out_val, pData[i]);
+    }
+    reduceGroup(s_val, out_val);
+
+    if (lid == 0) oData[0] = s_val[0];
+}
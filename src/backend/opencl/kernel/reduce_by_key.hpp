@@ -10,6 +10,7 @@
 #pragma once
 
 #include <Param.hpp>
+#include <common/bfloat16.hpp>
 #include <common/dispatch.hpp>
 #include <common/kernel_cache.hpp>
 #include <debug_opencl.hpp>
@@ -54,6 +55,7 @@ void reduceBlocksByKeyDim(cl::Buffer *reduced_block_sizes, Param keys_out,
         TemplateTypename<Ti>(), TemplateTypename<To>(), TemplateTypename<Tk>(),
         TemplateArg(op),        TemplateArg(threads_x),
     };
+    constexpr bool IsBf16 = std::is_same<Ti, common::bfloat16>::value;
     std::vector<std::string> compileOpts = {
         DefineKeyValue(Tk, dtype_traits<Tk>::getName()),
         DefineKeyValue(Ti, dtype_traits<Ti>::getName()),
@@ -64,6 +66,7 @@ void reduceBlocksByKeyDim(cl::Buffer *reduced_block_sizes, Param keys_out,
         DefineKeyValue(init, toNumStr(common::Binary<To, op>::init())),
         DefineKeyFromStr(binOpName<op>()),
         DefineKeyValue(CPLX, af::iscplx<Ti>()),
+        DefineKeyValue(IS_BF16, IsBf16),
     };
     compileOpts.emplace_back(getTypeBuildDefinition<Ti>());
 
@@ -100,6 +103,7 @@ void reduceBlocksByKey(cl::Buffer *reduced_block_sizes, Param keys_out,
         TemplateTypename<Ti>(), TemplateTypename<To>(), TemplateTypename<Tk>(),
         TemplateArg(op),        TemplateArg(threads_x),
     };
+    constexpr bool IsBf16 = std::is_same<Ti, common::bfloat16>::value;
     std::vector<std::string> compileOpts = {
         DefineKeyValue(Tk, dtype_traits<Tk>::getName()),
         DefineKeyValue(Ti, dtype_traits<Ti>::getName()),
@@ -109,6 +113,7 @@ void reduceBlocksByKey(cl::Buffer *reduced_block_sizes, Param keys_out,
         DefineKeyValue(init, toNumStr(common::Binary<To, op>::init())),
         DefineKeyFromStr(binOpName<op>()),
         DefineKeyValue(CPLX, af::iscplx<Ti>()),
+        DefineKeyValue(IS_BF16, IsBf16),
     };
     compileOpts.emplace_back(getTypeBuildDefinition<Ti>());
 
@@ -0,0 +1,84 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// The finalizer of MurmurHash3, which spreads consecutive keys over the slots
+uint hashReduceHash(uint key) {
+    key ^= key >> 16;
+    key *= 0x85ebca6bu;
+    key ^= key >> 13;
+    key *= 0xc2b2ae35u;
+    key ^= key >> 16;
+    return key;
+}
+
+// Reduces value into *ptr atomically. Floats are replaced until they do not
+// change concurrently, and the minimum and the maximum ignore NaN values.
+void hashReduceAtomic(global To *ptr, To value) {
+#if IS_FLOAT
+    volatile global uint *uptr = (volatile global uint *)ptr;
+    uint old                   = *uptr;
+    while (true) {
+        const To current = as_float(old);
+#if IS_ADD
+        const To next = current + value;
+#elif IS_MIN
+        if (!(value < current)) { return; }
+        const To next = value;
+#else
+        if (!(value > current)) { return; }
+        const To next = value;
+#endif
+        const uint prev = atomic_cmpxchg(uptr, old, as_uint(next));
+        if (prev == old) { return; }
+        old = prev;
+    }
+#elif IS_ADD
+    atomic_add(ptr, value);
+#elif IS_MIN
+    atomic_min(ptr, value);
+#else
+    atomic_max(ptr, value);
+#endif
+}
+
+// Reduces the value of each key into the slot of the key in a hash table with
+// open addressing. The slot of a key is claimed by swapping it with the empty
+// key, and the slots after it are probed when it belongs to another key. The
+// empty key itself is reduced into the extra slot at the end of the table.
+//
+// flags[0] is set when a key does not find a slot within maxProbes, and
+// flags[1] when the empty key is one of the keys.
+kernel void reduceByKeyHash(global Tk *tableKeys, global To *tableVals,
+                            global uint *flags, global const Tk *keys,
+                            global const Ti *vals, dim_t n, uint slots,
+                            Tk emptyKey, uint maxProbes) {
+    for (dim_t i = get_global_id(0); i < n; i += get_global_size(0)) {
+        const Tk key = keys[i];
+        uint slot    = slots;
+        if (key == emptyKey) {
+            flags[1] = 1;
+        } else {
+            uint probe = hashReduceHash((uint)key) & (slots - 1);
+            for (uint p = 0; p < maxProbes; ++p) {
+                const Tk prev =
+                    atomic_cmpxchg(tableKeys + probe, emptyKey, key);
+                if (prev == emptyKey || prev == key) {
+                    slot = probe;
+                    break;
+                }
+                probe = (probe + 1) & (slots - 1);
+            }
+            if (slot == slots) {
+                flags[0] = 1;
+                continue;
+            }
+        }
+        hashReduceAtomic(tableVals + slot, (To)vals[i]);
+    }
+}
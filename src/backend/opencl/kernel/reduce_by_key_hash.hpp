@@ -0,0 +1,89 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/dispatch.hpp>
+#include <common/hash_reduce.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/reduce_by_key_hash.hpp>
+#include <traits.hpp>
+
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+constexpr int HASH_REDUCE_THREADS = 256;
+/// The largest number of groups, whose work-items loop over the keys
+constexpr dim_t HASH_REDUCE_MAX_GROUPS = 1024;
+
+/// Reduces the \p n values of \p vals by key into the hash table of
+/// \p tableKeys and \p tableVals, and reads the table back with one blocking
+/// read. The table has slots + 1 slots, filled with the empty key and the
+/// initial value of \p op, and \p flags holds two zeros.
+template<af_op_t op, typename Ti, typename Tk, typename To>
+common::HashReduceTable<Tk, To> reduceByKeyHash(
+    const cl::Buffer &tableKeys, const cl::Buffer &tableVals,
+    const cl::Buffer &flags, const cl::Buffer &keys, const cl::Buffer &vals,
+    const dim_t n, const dim_t slots) {
+    static const std::string src(reduce_by_key_hash_cl,
+                                 reduce_by_key_hash_cl_len);
+
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<Ti>(),
+        TemplateTypename<Tk>(),
+        TemplateTypename<To>(),
+        TemplateArg(op),
+    };
+    std::vector<std::string> options = {
+        DefineKeyValue(Ti, dtype_traits<Ti>::getName()),
+        DefineKeyValue(Tk, dtype_traits<Tk>::getName()),
+        DefineKeyValue(To, dtype_traits<To>::getName()),
+        DefineKeyValue(IS_FLOAT, (std::is_floating_point<To>::value)),
+        DefineKeyValue(IS_ADD, (op == af_add_t)),
+        DefineKeyValue(IS_MIN, (op == af_min_t)),
+    };
+    options.emplace_back(getTypeBuildDefinition<Ti, To>());
+
+    auto reduceHash =
+        common::getKernel("reduceByKeyHash", {src}, targs, options);
+
+    const dim_t groups =
+        std::min(divup(n, dim_t(HASH_REDUCE_THREADS)), HASH_REDUCE_MAX_GROUPS);
+    const cl::NDRange local(HASH_REDUCE_THREADS);
+    const cl::NDRange global(groups * HASH_REDUCE_THREADS);
+    reduceHash(cl::EnqueueArgs(getQueue(), global, local), tableKeys,
+               tableVals, flags, keys, vals, n, static_cast<unsigned>(slots),
+               common::hashReduceEmptyKey<Tk>(),
+               common::HASH_REDUCE_MAX_PROBES);
+    CL_DEBUG_FINISH(getQueue());
+
+    // The queue is in order, so the last blocking read waits for all of them
+    common::HashReduceTable<Tk, To> table;
+    table.keys.resize(slots + 1);
+    table.vals.resize(slots + 1);
+    unsigned hflags[2];
+    getQueue().enqueueReadBuffer(tableKeys, CL_FALSE, 0,
+                                 (slots + 1) * sizeof(Tk), table.keys.data());
+    getQueue().enqueueReadBuffer(tableVals, CL_FALSE, 0,
+                                 (slots + 1) * sizeof(To), table.vals.data());
+    getQueue().enqueueReadBuffer(flags, CL_TRUE, 0, sizeof(hflags), hflags);
+
+    table.full          = hflags[0] != 0;
+    table.emptyKeyFound = hflags[1] != 0;
+    return table;
+}
+
+}  // namespace kernel
+}  // namespace opencl
@@ -7,6 +7,11 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#if USE_SUBGROUPS
+#pragma OPENCL EXTENSION cl_khr_subgroups : enable
+#pragma OPENCL EXTENSION cl_khr_subgroup_shuffle : enable
+#endif
+
 kernel void reduce_first_kernel(global To *oData, KParam oInfo,
                                   const global Ti *iData, KParam iInfo,
                                   uint groups_x, uint groups_y, uint repeat,
@@ -42,6 +47,33 @@ kernel void reduce_first_kernel(global To *oData, KParam oInfo,
         out_val = binOp(in_val, out_val);
     }
 
+#if USE_SUBGROUPS
+    // When the group is a single row, the subgroups reduce their values with
+    // shuffles instead of the barriers below. Subgroups of every size are
+    // full and the same for the whole group, so the branch is uniform.
+    const uint sg_size = get_max_sub_group_size();
+    if (DIMX == THREADS_PER_GROUP && (sg_size & (sg_size - 1)) == 0 &&
+        THREADS_PER_GROUP % sg_size == 0) {
+        for (uint offset = sg_size / 2; offset > 0; offset /= 2) {
+            out_val = binOp(out_val, sub_group_shuffle_xor(out_val, offset));
+        }
+
+        if (get_sub_group_local_id() == 0) {
+            s_val[get_sub_group_id()] = out_val;
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        if (cond && lid == 0) {
+            out_val = s_val[0];
+            for (uint i = 1; i < get_num_sub_groups(); i++) {
+                out_val = binOp(out_val, s_val[i]);
+            }
+            oData[groupId_x] = out_val;
+        }
+        return;
+    }
+#endif
+
     s_val[lid] = out_val;
     barrier(CLK_LOCAL_MEM_FENCE);
     local To *s_ptr = s_val + lidy * DIMX;
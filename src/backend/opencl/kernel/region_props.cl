@@ -0,0 +1,122 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// The accumulators of a label are REGION_ACC_WORDS words: the 64-bit sums
+// of the rows, the columns, the squared rows, the squared columns and the
+// products of the rows and columns, then the 32-bit area and the bitwise
+// complements of the first row and column and the last row and column. The
+// complements let all the accumulators start at zero.
+
+// Adds val to the 64-bit integer in the words lo and lo + 1 with 32-bit
+// atomics. The high word gets the carry of the low word.
+void atomicAdd64(global uint *lo, ulong val) {
+    const uint vlo  = (uint)val;
+    uint vhi        = (uint)(val >> 32);
+    const uint prev = atomic_add(lo, vlo);
+    if (prev + vlo < prev) vhi++;
+    if (vhi) atomic_add(lo + 1, vhi);
+}
+
+void flushRun(global uint *acc, ulong count, ulong sr, ulong srr, uint row0,
+              uint row1, uint col) {
+    atomicAdd64(acc + 0, sr);
+    atomicAdd64(acc + 2, count * col);
+    atomicAdd64(acc + 4, srr);
+    atomicAdd64(acc + 6, count * col * col);
+    atomicAdd64(acc + 8, sr * col);
+    atomic_add(acc + 10, (uint)count);
+    atomic_max(acc + 11, ~row0);
+    atomic_max(acc + 12, ~col);
+    atomic_max(acc + 13, row1);
+    atomic_max(acc + 14, col);
+}
+
+// Every work item accumulates a run of RUN_LENGTH rows of a column, and
+// flushes its sums to the accumulators of a label when the label changes,
+// so the pixels of large regions cost few atomics
+kernel void regionSums(global uint *d_acc, KParam aInfo,
+                       global const T *d_labels, KParam lInfo, int nlabels) {
+    const int j  = get_global_id(1);
+    const int i0 = get_global_id(0) * RUN_LENGTH;
+    if (j >= lInfo.dims[1] || i0 >= lInfo.dims[0]) return;
+
+    const int i1        = min(i0 + RUN_LENGTH, (int)lInfo.dims[0]);
+    global const T *col = d_labels + lInfo.offset + j * lInfo.strides[1];
+
+    int current = 0;
+    int row0    = 0;
+    ulong sr    = 0;
+    ulong srr   = 0;
+    for (int i = i0; i <= i1; ++i) {
+        const int label = i < i1 ? (int)col[i] : 0;
+        if (label != current) {
+            if (current >= 1 && current <= nlabels) {
+                flushRun(d_acc + (current - 1) * aInfo.strides[1], i - row0,
+                         sr, srr, row0, i - 1, j);
+            }
+            current = label;
+            row0    = i;
+            sr      = 0;
+            srr     = 0;
+        }
+        sr += i;
+        srr += (ulong)i * i;
+    }
+}
+
+// Computes the properties of every label from its accumulators. The second
+// order sums are shifted to the first row and column of the bounding box,
+// which is exact in 64-bit integers, so the central moments do not suffer
+// from cancellation.
+kernel void regionProps(global float *d_out, KParam oInfo,
+                        global const uint *d_acc, KParam aInfo) {
+    const int l = get_global_id(0);
+    if (l >= oInfo.dims[1]) return;
+
+    global const uint *a = d_acc + l * aInfo.strides[1];
+    global float *optr   = d_out + l * oInfo.strides[1];
+
+    const ulong area = a[10];
+    if (area == 0) {
+        for (int p = 0; p < REGION_PROP_COUNT; ++p) optr[p] = 0.f;
+        return;
+    }
+
+    ulong sum[5];
+    for (int k = 0; k < 5; ++k) {
+        sum[k] = (ulong)a[2 * k] | ((ulong)a[2 * k + 1] << 32);
+    }
+
+    const ulong r0  = ~a[11];
+    const ulong c0  = ~a[12];
+    const ulong sr  = sum[0] - area * r0;
+    const ulong sc  = sum[1] - area * c0;
+    const ulong srr = sum[2] - 2 * r0 * sum[0] + area * r0 * r0;
+    const ulong scc = sum[3] - 2 * c0 * sum[1] + area * c0 * c0;
+    const ulong src = sum[4] - r0 * sum[1] - c0 * sum[0] + area * r0 * c0;
+
+    // Double is optional in OpenCL, and the shifted sums are small enough
+    // for float
+    const float mr = (float)sr / area;
+    const float mc = (float)sc / area;
+
+    optr[0]  = (float)area;
+    optr[1]  = r0 + mr;
+    optr[2]  = c0 + mc;
+    optr[3]  = (float)r0;
+    optr[4]  = (float)c0;
+    optr[5]  = (float)a[13];
+    optr[6]  = (float)a[14];
+    optr[7]  = (float)sum[0];
+    optr[8]  = (float)sum[1];
+    optr[9]  = (float)sum[4];
+    optr[10] = (float)srr - sr * mr;
+    optr[11] = (float)scc - sc * mc;
+    optr[12] = (float)src - sr * mc;
+}
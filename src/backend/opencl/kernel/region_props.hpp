@@ -0,0 +1,81 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <common/region_stats.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/region_props.hpp>
+#include <traits.hpp>
+
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+/// The number of 32-bit accumulators of each label
+constexpr int REGION_ACC_WORDS = 16;
+/// The number of rows of a column accumulated by a work item
+constexpr int RUN_LENGTH = 16;
+
+template<typename T>
+std::vector<std::string> regionPropsOptions() {
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineValue(RUN_LENGTH),
+        DefineKeyValue(REGION_PROP_COUNT, common::REGION_PROP_COUNT),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+    return options;
+}
+
+/// Accumulates the sums of the pixel coordinates of the labels 1 to
+/// \p nlabels into \p acc, which is REGION_ACC_WORDS x nlabels and zeroed
+template<typename T>
+void regionSums(Param acc, const Param labels, int nlabels) {
+    static const std::string src(region_props_cl, region_props_cl_len);
+
+    auto regionSums = common::getKernel(
+        "regionSums", {src}, {TemplateTypename<T>()}, regionPropsOptions<T>());
+
+    cl::NDRange local(32, 8);
+    cl::NDRange global(divup(labels.info.dims[0], 32 * RUN_LENGTH) * 32,
+                       divup(labels.info.dims[1], 8) * 8);
+
+    regionSums(cl::EnqueueArgs(getQueue(), global, local), *acc.data,
+               acc.info, *labels.data, labels.info, nlabels);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+/// Computes the properties of the labels from the accumulators of
+/// regionSums
+inline void regionProps(Param out, const Param acc) {
+    constexpr int THREADS = 256;
+
+    static const std::string src(region_props_cl, region_props_cl_len);
+
+    // The accumulators do not depend on the type of the labels
+    auto regionProps =
+        common::getKernel("regionProps", {src}, {TemplateTypename<uint>()},
+                          regionPropsOptions<uint>());
+
+    cl::NDRange local(THREADS);
+    cl::NDRange global(divup(out.info.dims[1], THREADS) * THREADS);
+
+    regionProps(cl::EnqueueArgs(getQueue(), global, local), *out.data,
+                out.info, *acc.data, acc.info);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+}  // namespace kernel
+}  // namespace opencl
@@ -0,0 +1,187 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// The summed-area table of each 2D slice is computed in tiles of TILE x TILE
+// values. satTileSums writes the sums of the columns and of the rows of each
+// tile, satColumnCarries and satRowCarries turn them into the sums of the
+// values above and to the left of each tile, and satTiles computes the table
+// of each tile with these carries. The carries of a slice are stored after
+// the carries of the previous slices.
+
+// Loads the tile at (i0, j0) of a slice, transposed so that the work-items
+// which scan it read different banks
+void satLoad(local To (*tile)[TILE + 1], global const Ti *in, KParam iInfo,
+             uint slice, dim_t i0, dim_t j0) {
+    global const Ti *iptr = in + iInfo.offset +
+                            (slice % iInfo.dims[2]) * iInfo.strides[2] +
+                            (slice / iInfo.dims[2]) * iInfo.strides[3];
+    const dim_t i = i0 + get_local_id(0);
+    for (int j = get_local_id(1); j < TILE; j += get_local_size(1)) {
+        const dim_t gj = j0 + j;
+        tile[j][get_local_id(0)] =
+            i < iInfo.dims[0] && gj < iInfo.dims[1]
+                ? (To)iptr[i * iInfo.strides[0] + gj * iInfo.strides[1]]
+                : (To)0;
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+}
+
+// Scans the columns of the tile along dim 0, one work-item per column
+void satScanColumns(local To (*tile)[TILE + 1]) {
+    const int lid = get_local_id(1) * get_local_size(0) + get_local_id(0);
+    if (lid < TILE) {
+        To sum = 0;
+        for (int i = 0; i < TILE; ++i) {
+            sum += tile[lid][i];
+            tile[lid][i] = sum;
+        }
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+}
+
+// Scans the rows of the tile along dim 1, one work-item per row
+void satScanRows(local To (*tile)[TILE + 1]) {
+    const int lid = get_local_id(1) * get_local_size(0) + get_local_id(0);
+    if (lid < TILE) {
+        To sum = 0;
+        for (int j = 0; j < TILE; ++j) {
+            sum += tile[j][lid];
+            tile[j][lid] = sum;
+        }
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+}
+
+// Writes the sum of each column of each tile to colSums, and the sum of each
+// row of the tile, up to the row, to rowSums
+kernel void satTileSums(global To *colSums, global To *rowSums,
+                        global const Ti *in, KParam iInfo, uint tilesI,
+                        uint tilesJ) {
+    local To tile[TILE][TILE + 1];
+
+    const uint n     = get_group_id(0);
+    const uint m     = get_group_id(1);
+    const uint slice = get_group_id(2);
+    const dim_t i0   = (dim_t)m * TILE;
+    const dim_t j0   = (dim_t)n * TILE;
+    const dim_t H    = iInfo.dims[0];
+    const dim_t W    = iInfo.dims[1];
+    const int lid    = get_local_id(1) * get_local_size(0) + get_local_id(0);
+
+    satLoad(tile, in, iInfo, slice, i0, j0);
+    satScanColumns(tile);
+    if (lid < TILE && j0 + lid < W) {
+        colSums[(slice * tilesI + m) * W + j0 + lid] = tile[lid][TILE - 1];
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    satScanRows(tile);
+    if (lid < TILE && i0 + lid < H) {
+        rowSums[(slice * tilesJ + n) * H + i0 + lid] = tile[TILE - 1][lid];
+    }
+}
+
+// Replaces the sums of the columns of the tiles by the sums of the values
+// above the tiles, and writes the sum of these carries over the columns of
+// each tile to tileCarries. The groups have one work-item per column of a
+// tile.
+kernel void satColumnCarries(global To *colSums, global To *tileCarries,
+                             dim_t W, uint tilesI, uint tilesJ) {
+    local To l_carry[TILE];
+
+    const uint n     = get_group_id(0);
+    const uint slice = get_group_id(1);
+    const int lid    = get_local_id(0);
+    const dim_t j    = (dim_t)n * TILE + lid;
+
+    To running = 0;
+    for (uint m = 0; m < tilesI; ++m) {
+        To carry = 0;
+        if (j < W) {
+            global To *ptr = colSums + (slice * tilesI + m) * W + j;
+            carry          = running;
+            running += *ptr;
+            *ptr = carry;
+        }
+
+        l_carry[lid] = carry;
+        barrier(CLK_LOCAL_MEM_FENCE);
+        for (int off = TILE / 2; off > 0; off /= 2) {
+            if (lid < off) { l_carry[lid] += l_carry[lid + off]; }
+            barrier(CLK_LOCAL_MEM_FENCE);
+        }
+        if (lid == 0) {
+            tileCarries[(slice * tilesI + m) * tilesJ + n] = l_carry[0];
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+}
+
+// Replaces the sums of the rows of the tiles by the sums of the values to the
+// left of the tiles and above the rows, one work-item per row
+kernel void satRowCarries(global To *rowSums, global const To *tileCarries,
+                          dim_t H, uint tilesI, uint tilesJ) {
+    const dim_t i    = get_global_id(0);
+    const uint slice = get_group_id(1);
+    if (i >= H) { return; }
+
+    global const To *carries =
+        tileCarries + (slice * tilesI + i / TILE) * tilesJ;
+    To running = 0;
+    for (uint n = 0; n < tilesJ; ++n) {
+        global To *ptr = rowSums + (slice * tilesJ + n) * H + i;
+        const To sums  = *ptr;
+        *ptr           = running;
+        running += sums + carries[n];
+    }
+}
+
+// Computes the summed-area table of each tile, adding the values above the
+// tile to its columns and the values to its left to its first column before
+// the scan along dim 1
+kernel void satTiles(global To *out, KParam oInfo, global const Ti *in,
+                     KParam iInfo, global const To *colCarries,
+                     global const To *rowCarries, uint tilesI, uint tilesJ) {
+    local To tile[TILE][TILE + 1];
+
+    const uint n     = get_group_id(0);
+    const uint m     = get_group_id(1);
+    const uint slice = get_group_id(2);
+    const dim_t i0   = (dim_t)m * TILE;
+    const dim_t j0   = (dim_t)n * TILE;
+    const dim_t H    = iInfo.dims[0];
+    const dim_t W    = iInfo.dims[1];
+    const dim_t i    = i0 + get_local_id(0);
+
+    satLoad(tile, in, iInfo, slice, i0, j0);
+    satScanColumns(tile);
+
+    for (int j = get_local_id(1); j < TILE; j += get_local_size(1)) {
+        const dim_t gj = j0 + j;
+        To carry       = 0;
+        if (gj < W) { carry = colCarries[(slice * tilesI + m) * W + gj]; }
+        if (j == 0 && i < H) {
+            carry += rowCarries[(slice * tilesJ + n) * H + i];
+        }
+        tile[j][get_local_id(0)] += carry;
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    satScanRows(tile);
+
+    global To *optr = out + oInfo.offset +
+                      (slice % oInfo.dims[2]) * oInfo.strides[2] +
+                      (slice / oInfo.dims[2]) * oInfo.strides[3];
+    for (int j = get_local_id(1); j < TILE; j += get_local_size(1)) {
+        const dim_t gj = j0 + j;
+        if (i < H && gj < W) {
+            optr[i + gj * oInfo.strides[1]] = tile[j][get_local_id(0)];
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/sat.hpp>
+#include <memory.hpp>
+#include <traits.hpp>
+
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+/// The size of the square tiles of the summed-area table
+constexpr unsigned SAT_TILE        = 32;
+constexpr unsigned SAT_THREADS_Y   = 8;
+constexpr unsigned SAT_ROW_THREADS = 256;
+
+/// Computes the summed-area table of each 2D slice of \p in.
+///
+/// The slices are split in tiles. A first kernel writes the sums of the
+/// columns and of the rows of each tile, two small kernels scan these sums
+/// across the tiles, and a last kernel computes the table of each tile with
+/// the carries of the tiles above and to its left. The input is read twice
+/// and the output written once, without an intermediate image.
+template<typename Ti, typename To>
+void sat(Param out, const Param in) {
+    static const std::string src(sat_cl, sat_cl_len);
+
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<Ti>(),
+        TemplateTypename<To>(),
+    };
+    std::vector<std::string> options = {
+        DefineKeyValue(Ti, dtype_traits<Ti>::getName()),
+        DefineKeyValue(To, dtype_traits<To>::getName()),
+        DefineKeyValue(TILE, SAT_TILE),
+    };
+    options.emplace_back(getTypeBuildDefinition<Ti, To>());
+
+    auto tileSums = common::getKernel("satTileSums", {src}, targs, options);
+    auto columnCarries =
+        common::getKernel("satColumnCarries", {src}, targs, options);
+    auto rowCarries = common::getKernel("satRowCarries", {src}, targs, options);
+    auto tiles      = common::getKernel("satTiles", {src}, targs, options);
+
+    const dim_t H      = in.info.dims[0];
+    const dim_t W      = in.info.dims[1];
+    const dim_t slices = in.info.dims[2] * in.info.dims[3];
+    const dim_t tilesI = divup(H, dim_t(SAT_TILE));
+    const dim_t tilesJ = divup(W, dim_t(SAT_TILE));
+
+    auto colSums     = memAlloc<To>(slices * tilesI * W);
+    auto rowSums     = memAlloc<To>(slices * tilesJ * H);
+    auto tileCarries = memAlloc<To>(slices * tilesI * tilesJ);
+
+    const cl::NDRange tileLocal(SAT_TILE, SAT_THREADS_Y, 1);
+    const cl::NDRange tileGlobal(tilesJ * SAT_TILE, tilesI * SAT_THREADS_Y,
+                                 slices);
+
+    tileSums(cl::EnqueueArgs(getQueue(), tileGlobal, tileLocal), *colSums,
+             *rowSums, *in.data, in.info, static_cast<unsigned>(tilesI),
+             static_cast<unsigned>(tilesJ));
+    CL_DEBUG_FINISH(getQueue());
+
+    columnCarries(cl::EnqueueArgs(getQueue(),
+                                  cl::NDRange(tilesJ * SAT_TILE, slices),
+                                  cl::NDRange(SAT_TILE, 1)),
+                  *colSums, *tileCarries, W, static_cast<unsigned>(tilesI),
+                  static_cast<unsigned>(tilesJ));
+    CL_DEBUG_FINISH(getQueue());
+
+    rowCarries(
+        cl::EnqueueArgs(getQueue(),
+                        cl::NDRange(divup(H, SAT_ROW_THREADS) * SAT_ROW_THREADS,
+                                    slices),
+                        cl::NDRange(SAT_ROW_THREADS, 1)),
+        *rowSums, *tileCarries, H, static_cast<unsigned>(tilesI),
+        static_cast<unsigned>(tilesJ));
+    CL_DEBUG_FINISH(getQueue());
+
+    tiles(cl::EnqueueArgs(getQueue(), tileGlobal, tileLocal), *out.data,
+          out.info, *in.data, in.info, *colSums, *rowSums,
+          static_cast<unsigned>(tilesI), static_cast<unsigned>(tilesJ));
+    CL_DEBUG_FINISH(getQueue());
+}
+
+}  // namespace kernel
+}  // namespace opencl
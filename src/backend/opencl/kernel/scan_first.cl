@@ -7,6 +7,11 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#if USE_SUBGROUPS
+#pragma OPENCL EXTENSION cl_khr_subgroups : enable
+#pragma OPENCL EXTENSION cl_khr_subgroup_shuffle : enable
+#endif
+
 kernel void scanFirst(global To *oData, KParam oInfo, global To *tData,
                       KParam tInfo, const global Ti *iData, KParam iInfo,
                       uint groups_x, uint groups_y, uint lim) {
@@ -46,21 +51,52 @@ kernel void scanFirst(global To *oData, KParam oInfo, global To *tData,
 
     const bool isLast = (lidx == (DIMX - 1));
 
+#if USE_SUBGROUPS
+    // The shuffles are used when the group is a single row made of full
+    // subgroups. The condition is the same for the whole group.
+    const uint sg_size = get_max_sub_group_size();
+    const bool useSubgroups =
+        DIMX == SHARED_MEM_SIZE && SHARED_MEM_SIZE % sg_size == 0;
+#endif
+
     for (int k = 0; k < lim; k++) {
         if (isLast) l_tmp[lidy] = val;
 
-        bool cond  = ((id < iInfo.dims[0]) && cond_yzw);
-        val        = cond ? transform(iData[id]) : init_val;
-        l_val[lid] = val;
-        barrier(CLK_LOCAL_MEM_FENCE);
+        bool cond = ((id < iInfo.dims[0]) && cond_yzw);
+        val       = cond ? transform(iData[id]) : init_val;
+
+#if USE_SUBGROUPS
+        if (useSubgroups) {
+            // Each subgroup scans its values with shuffles, and the last
+            // value of every subgroup is added to the values of the
+            // subgroups after it
+            const uint sg_lid = get_sub_group_local_id();
+            for (uint off = 1; off < sg_size; off *= 2) {
+                const To prev =
+                    sub_group_shuffle(val, sg_lid >= off ? sg_lid - off : 0);
+                if (sg_lid >= off) val = binOp(val, prev);
+            }
 
-        for (int off = 1; off < DIMX; off *= 2) {
-            if (lidx >= off) val = binOp(val, l_val[lid - off]);
+            if (sg_lid == sg_size - 1) l_val[get_sub_group_id()] = val;
+            barrier(CLK_LOCAL_MEM_FENCE);
 
-            flip       = 1 - flip;
-            l_val      = flip ? l_val1 : l_val0;
+            for (uint i = 0; i < get_sub_group_id(); i++) {
+                val = binOp(val, l_val[i]);
+            }
+        } else
+#endif
+        {
             l_val[lid] = val;
             barrier(CLK_LOCAL_MEM_FENCE);
+
+            for (int off = 1; off < DIMX; off *= 2) {
+                if (lidx >= off) val = binOp(val, l_val[lid - off]);
+
+                flip       = 1 - flip;
+                l_val      = flip ? l_val1 : l_val0;
+                l_val[lid] = val;
+                barrier(CLK_LOCAL_MEM_FENCE);
+            }
         }
 
         val = binOp(val, l_tmp[lidy]);
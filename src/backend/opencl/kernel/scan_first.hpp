@@ -18,6 +18,7 @@
 #include <kernel/names.hpp>
 #include <kernel_headers/ops.hpp>
 #include <kernel_headers/scan_first.hpp>
+#include <platform.hpp>
 #include <traits.hpp>
 
 #include <string>
@@ -41,6 +42,10 @@ static opencl::Kernel getScanFirstKernel(const std::string key,
     const uint SHARED_MEM_SIZE = THREADS_PER_GROUP;
     ToNumStr<To> toNumStr;
 
+    // The complex types are vectors, which the subgroup shuffles do not take
+    const bool useSubgroups =
+        !af::iscplx<To>() && isSubgroupShuffleSupported(getActiveDeviceId());
+
     vector<TemplateArg> tmpltArgs = {
         TemplateTypename<Ti>(),   TemplateTypename<To>(),
         TemplateArg(isFinalPass), TemplateArg(op),
@@ -58,6 +63,7 @@ static opencl::Kernel getScanFirstKernel(const std::string key,
         DefineKeyValue(CPLX, af::iscplx<Ti>()),
         DefineKeyValue(IS_FINAL_PASS, (isFinalPass ? 1 : 0)),
         DefineKeyValue(INCLUSIVE_SCAN, inclusiveScan),
+        DefineKeyValue(USE_SUBGROUPS, useSubgroups),
     };
     compileOpts.emplace_back(getTypeBuildDefinition<Ti>());
 
@@ -0,0 +1,70 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// Flags the values kept by the compaction of the first *length values, which
+// are sorted: the first value of each run of equal values, or with DUPLICATES
+// the values which are equal to the next one.
+kernel void setFlags(global uint *flags, global const T *values,
+                     global const uint *length, dim_t capacity) {
+    const dim_t k = get_global_id(0);
+    if (k >= capacity) { return; }
+
+    const dim_t n = *length;
+    bool keep     = false;
+    if (k < n) {
+#if DUPLICATES
+        keep = k + 1 < n && values[k] == values[k + 1];
+#else
+        keep = k == 0 || values[k] != values[k - 1];
+#endif
+    }
+    flags[k] = keep;
+}
+
+// Writes the flagged values at the positions given by the inclusive scan of
+// the flags, and the number of values written
+kernel void setScatter(global T *out, global uint *outLength,
+                       global const T *values, global const uint *flags,
+                       global const uint *positions, dim_t capacity) {
+    const dim_t k = get_global_id(0);
+    if (k >= capacity) { return; }
+
+    if (k == capacity - 1) { *outLength = positions[k]; }
+    if (flags[k]) { out[positions[k] - 1] = values[k]; }
+}
+
+// Merges the first *aLength values of a and the first *bLength values of b,
+// which are sorted. Each work-item finds the number of values of a before its
+// output with a binary search along its diagonal of the merge path.
+kernel void setMerge(global T *out, global uint *outLength, global const T *a,
+                     global const uint *aLength, global const T *b,
+                     global const uint *bLength, dim_t capacity) {
+    const dim_t k = get_global_id(0);
+    if (k >= capacity) { return; }
+
+    const dim_t na = *aLength;
+    const dim_t nb = *bLength;
+    if (k == 0) { *outLength = na + nb; }
+    if (k >= na + nb) { return; }
+
+    dim_t lo = k > nb ? k - nb : 0;
+    dim_t hi = k < na ? k : na;
+    while (lo < hi) {
+        const dim_t mid = (lo + hi) / 2;
+        if (a[mid] <= b[k - 1 - mid]) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    const dim_t i = lo;
+    const dim_t j = k - lo;
+    out[k]        = (j >= nb || (i < na && a[i] <= b[j])) ? a[i] : b[j];
+}
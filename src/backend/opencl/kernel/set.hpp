@@ -0,0 +1,94 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/set.hpp>
+#include <traits.hpp>
+
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+constexpr int SET_THREADS = 256;
+
+template<typename T>
+std::vector<std::string> setOptions(const bool duplicates) {
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(DUPLICATES, static_cast<int>(duplicates)),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+    return options;
+}
+
+inline cl::EnqueueArgs setRange(const dim_t capacity) {
+    const cl::NDRange local(SET_THREADS);
+    const cl::NDRange global(divup(capacity, SET_THREADS) * SET_THREADS);
+    return cl::EnqueueArgs(getQueue(), global, local);
+}
+
+/// Flags the values kept by the compaction of the first \p length[0] values
+/// of \p values, which are sorted. The first value of each run of equal
+/// values is kept, or the values equal to the next one when \p duplicates
+/// is true. All the \p capacity flags are written.
+template<typename T>
+void setFlags(const cl::Buffer &flags, const cl::Buffer &values,
+              const cl::Buffer &length, const dim_t capacity,
+              const bool duplicates) {
+    static const std::string src(set_cl, set_cl_len);
+    auto flagValues =
+        common::getKernel("setFlags", {src},
+                          {TemplateTypename<T>(), TemplateArg(duplicates)},
+                          setOptions<T>(duplicates));
+
+    flagValues(setRange(capacity), flags, values, length, capacity);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+/// Writes the values flagged by setFlags at the positions given by the
+/// inclusive scan of the flags, and their number in \p outLength[0]
+template<typename T>
+void setScatter(const cl::Buffer &out, const cl::Buffer &outLength,
+                const cl::Buffer &values, const cl::Buffer &flags,
+                const cl::Buffer &positions, const dim_t capacity) {
+    static const std::string src(set_cl, set_cl_len);
+    auto scatter = common::getKernel("setScatter", {src},
+                                     {TemplateTypename<T>()},
+                                     setOptions<T>(false));
+
+    scatter(setRange(capacity), out, outLength, values, flags, positions,
+            capacity);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+/// Merges the first \p aLength[0] values of \p a and the first \p bLength[0]
+/// values of \p b, which are sorted, along the merge path. The lengths are
+/// only read on the device, and \p capacity is at least their sum.
+template<typename T>
+void setMerge(const cl::Buffer &out, const cl::Buffer &outLength,
+              const cl::Buffer &a, const cl::Buffer &aLength,
+              const cl::Buffer &b, const cl::Buffer &bLength,
+              const dim_t capacity) {
+    static const std::string src(set_cl, set_cl_len);
+    auto merge = common::getKernel("setMerge", {src}, {TemplateTypename<T>()},
+                                   setOptions<T>(false));
+
+    merge(setRange(capacity), out, outLength, a, aLength, b, bLength,
+          capacity);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+}  // namespace kernel
+}  // namespace opencl
@@ -11,11 +11,18 @@
 
 #include <Param.hpp>
 #include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
 #include <debug_opencl.hpp>
 #include <iota.hpp>
 #include <kernel/sort_helper.hpp>
+#include <kernel_headers/sort_short.hpp>
 #include <traits.hpp>
 
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
 AF_DEPRECATED_WARNINGS_OFF
 #include <boost/compute/algorithm/sort.hpp>
 #include <boost/compute/algorithm/sort_by_key.hpp>
@@ -28,6 +35,63 @@ namespace compute = boost::compute;
 
 namespace opencl {
 namespace kernel {
+
+constexpr int SORT_SHORT_THREADS = 256;
+constexpr int SORT_SHORT_LENGTH  = 4096;
+
+/// The longest column sorted by sort0Short, which is limited by the local
+/// memory of the device
+template<typename T>
+int sortShortLength() {
+    const size_t localBytes =
+        getDevice(getActiveDeviceId()).getInfo<CL_DEVICE_LOCAL_MEM_SIZE>();
+    int length = SORT_SHORT_LENGTH;
+    while (length > 1 && length * sizeof(T) > localBytes) { length /= 2; }
+    return length;
+}
+
+/// The value which pads the columns of the short sorts. It is ordered after
+/// all the other values.
+template<typename T>
+T sortPadding(bool isAscending) {
+    using limits = std::numeric_limits<T>;
+    if (limits::has_infinity) {
+        return isAscending ? limits::infinity() : -limits::infinity();
+    }
+    return isAscending ? limits::max() : limits::lowest();
+}
+
+/// Sorts the columns of at most sortShortLength values in one launch. Each
+/// work group sorts one column in local memory.
+template<typename T>
+void sort0Short(Param val, bool isAscending) {
+    static const std::string src(sort_short_cl, sort_short_cl_len);
+
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<T>(),
+        TemplateArg(isAscending),
+    };
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(IS_ASCENDING, static_cast<int>(isAscending)),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+
+    auto sortShort = common::getKernel("sortShort", {src}, targs, options);
+
+    int length = 1;
+    while (length < val.info.dims[0]) { length *= 2; }
+    const int lines = val.info.dims[1] * val.info.dims[2] * val.info.dims[3];
+    const int threads = std::min(SORT_SHORT_THREADS, std::max(length / 2, 32));
+
+    const cl::NDRange local(threads);
+    const cl::NDRange global(lines * threads);
+    sortShort(cl::EnqueueArgs(getQueue(), global, local), *val.data,
+              val.info, length, sortPadding<T>(isAscending),
+              cl::Local(length * sizeof(T)));
+    CL_DEBUG_FINISH(getQueue());
+}
+
 template<typename T>
 void sort0Iterative(Param val, bool isAscending) {
     compute::command_queue c_queue(getQueue()());
@@ -117,11 +181,16 @@ void sortBatched(Param pVal, int dim, bool isAscending) {
     CL_DEBUG_FINISH(getQueue());
 }
 
+/// Sorts the columns of \p val. The short columns are sorted in one launch
+/// with a work group each.
 template<typename T>
 void sort0(Param val, bool isAscending) {
     int higherDims = val.info.dims[1] * val.info.dims[2] * val.info.dims[3];
-    // TODO Make a better heurisitic
-    if (higherDims > 10)
+    if (val.info.dims[0] * higherDims == 0) { return; }
+
+    if (val.info.dims[0] <= sortShortLength<T>())
+        sort0Short<T>(val, isAscending);
+    else if (higherDims > 10)
         sortBatched<T>(val, 0, isAscending);
     else
         kernel::sort0Iterative<T>(val, isAscending);
@@ -0,0 +1,51 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// Sorts each column of val in local memory with a bitonic sorting network,
+// one work group per column. The columns are padded to length, a power of
+// two, with a value which is ordered after all the others.
+kernel void sortShort(global T *val, KParam info, const int length,
+                      const T padding, local T *l_val) {
+    const int n    = info.dims[0];
+    const int line = get_group_id(0);
+    const int y    = line % info.dims[1];
+    const int z    = (line / info.dims[1]) % info.dims[2];
+    const int w    = line / (info.dims[1] * info.dims[2]);
+    global T *ptr  = val + info.offset + y * info.strides[1] +
+                    z * info.strides[2] + w * info.strides[3];
+
+    const int lid     = get_local_id(0);
+    const int threads = get_local_size(0);
+
+    for (int i = lid; i < length; i += threads) {
+        l_val[i] = i < n ? ptr[i] : padding;
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    const int pairs = length / 2;
+    for (int k = 2; k <= length; k <<= 1) {
+        for (int j = k / 2; j > 0; j /= 2) {
+            for (int p = lid; p < pairs; p += threads) {
+                const int i = 2 * j * (p / j) + (p % j);
+                // The sequences of k values are sorted in alternating
+                // directions, which makes each pair of them bitonic
+                const bool up = ((i & k) == 0) == IS_ASCENDING;
+                const T a     = l_val[i];
+                const T b     = l_val[i + j];
+                if (up ? b < a : a < b) {
+                    l_val[i]     = b;
+                    l_val[i + j] = a;
+                }
+            }
+            barrier(CLK_LOCAL_MEM_FENCE);
+        }
+    }
+
+    for (int i = lid; i < n; i += threads) { ptr[i] = l_val[i]; }
+}
@@ -14,9 +14,6 @@
 #include <common/kernel_cache.hpp>
 #include <debug_opencl.hpp>
 #include <kernel/config.hpp>
-#include <kernel/reduce.hpp>
-#include <kernel/scan_dim.hpp>
-#include <kernel/scan_first.hpp>
 #include <kernel/sort_by_key.hpp>
 #include <kernel_headers/coo2dense.hpp>
 #include <kernel_headers/csr2coo.hpp>
@@ -91,53 +88,89 @@ void csr2dense(Param output, const Param values, const Param rowIdx,
     CL_DEBUG_FINISH(getQueue());
 }
 
-template<typename T>
-void dense2csr(Param values, Param rowIdx, Param colIdx, const Param dense) {
-    constexpr bool IsComplex =
-        std::is_same<T, cfloat>::value || std::is_same<T, cdouble>::value;
+constexpr int DENSE2SPARSE_THREADS = 256;
 
+template<typename T>
+Kernel getDense2SparseKernel(const char *name, const bool writeCol = false) {
     static const std::string src(dense2csr_cl, dense2csr_cl_len);
 
     std::vector<TemplateArg> tmpltArgs = {
         TemplateTypename<T>(),
+        TemplateArg(writeCol),
     };
     std::vector<std::string> compileOpts = {
         DefineKeyValue(T, dtype_traits<T>::getName()),
-        DefineKeyValue(IS_CPLX, (IsComplex ? 1 : 0)),
+        DefineKeyValue(THREADS, DENSE2SPARSE_THREADS),
+        DefineKeyValue(WRITE_COL, (writeCol ? 1 : 0)),
+        DefineKeyValue(IS_CPLX, (af::iscplx<T>() ? 1 : 0)),
     };
     compileOpts.emplace_back(getTypeBuildDefinition<T>());
 
-    auto dense2Csr =
-        common::getKernel("dense2Csr", {src}, tmpltArgs, compileOpts);
+    return common::getKernel(name, {src}, tmpltArgs, compileOpts);
+}
+
+/// Writes the number of nonzeros of each row of \p in to \p counts, which
+/// has one more element than the rows. The extra element is set to 0.
+template<typename T>
+void nnzPerRow(Param counts, const Param in) {
+    auto nnzPerRow = getDense2SparseKernel<T>("nnzPerRow");
+
+    cl::NDRange local(DENSE2SPARSE_THREADS);
+    cl::NDRange global(divup(counts.info.dims[0], local[0]) * local[0]);
+
+    nnzPerRow(cl::EnqueueArgs(getQueue(), global, local), *counts.data,
+              *in.data, in.info);
+    CL_DEBUG_FINISH(getQueue());
+}
 
-    int num_rows = dense.info.dims[0];
-    int num_cols = dense.info.dims[1];
+/// Writes the nonzeros of each row of \p in at the row's offset of
+/// \p offsets
+template<typename T>
+void dense2csrRows(Param values, Param colIdx, const Param in,
+                   const Param offsets) {
+    if (in.info.dims[0] == 0) { return; }
+    auto dense2CsrRows = getDense2SparseKernel<T>("dense2CsrRows");
 
-    // sd1 contains output of scan along dim 1 of dense
-    Array<int> sd1 = createEmptyArray<int>(dim4(num_rows, num_cols));
-    // rd1 contains output of nonzero count along dim 1 along dense
-    Array<int> rd1 = createEmptyArray<int>(num_rows);
+    cl::NDRange local(DENSE2SPARSE_THREADS);
+    cl::NDRange global(divup(in.info.dims[0], local[0]) * local[0]);
 
-    scanDim<T, int, af_notzero_t>(sd1, dense, 1, true);
-    reduceDim<T, int, af_notzero_t>(rd1, dense, 0, 0, 1);
-    scanFirst<int, int, af_add_t>(rowIdx, rd1, false);
+    dense2CsrRows(cl::EnqueueArgs(getQueue(), global, local), *values.data,
+                  *colIdx.data, *in.data, in.info, *offsets.data);
+    CL_DEBUG_FINISH(getQueue());
+}
 
-    int nnz = values.info.dims[0];
-    getQueue().enqueueWriteBuffer(
-        *rowIdx.data, CL_TRUE,
-        rowIdx.info.offset + (rowIdx.info.dims[0] - 1) * sizeof(int),
-        sizeof(int), (void *)&nnz);
+/// Writes the number of nonzeros of each column of \p in to \p counts,
+/// which has one more element than the columns. The extra element is set
+/// to 0.
+template<typename T>
+void nnzPerCol(Param counts, const Param in) {
+    auto nnzPerCol = getDense2SparseKernel<T>("nnzPerCol");
 
-    cl::NDRange local(THREADS_X, THREADS_Y);
-    int groups_x = divup(dense.info.dims[0], local[0]);
-    int groups_y = divup(dense.info.dims[1], local[1]);
-    cl::NDRange global(groups_x * local[0], groups_y * local[1]);
+    cl::NDRange local(DENSE2SPARSE_THREADS);
+    cl::NDRange global(counts.info.dims[0] * local[0]);
 
-    const Param sdParam = sd1;
+    nnzPerCol(cl::EnqueueArgs(getQueue(), global, local), *counts.data,
+              *in.data, in.info);
+    CL_DEBUG_FINISH(getQueue());
+}
 
-    dense2Csr(cl::EnqueueArgs(getQueue(), global, local), *values.data,
-              *colIdx.data, *dense.data, dense.info, *sdParam.data,
-              sdParam.info, *rowIdx.data);
+/// Writes the nonzeros of each column of \p in at the column's offset of
+/// \p offsets in column major order. The column indices are only written
+/// to \p colIdx if \p writeCol is true.
+template<typename T>
+void dense2sparseCols(Param values, Param rowIdx, Param colIdx,
+                      const Param in, const Param offsets,
+                      const bool writeCol) {
+    if (in.info.dims[1] == 0) { return; }
+    auto dense2SparseCols =
+        getDense2SparseKernel<T>("dense2SparseCols", writeCol);
+
+    cl::NDRange local(DENSE2SPARSE_THREADS);
+    cl::NDRange global(in.info.dims[1] * local[0]);
+
+    dense2SparseCols(cl::EnqueueArgs(getQueue(), global, local),
+                     *values.data, *rowIdx.data, *colIdx.data, *in.data,
+                     in.info, *offsets.data);
     CL_DEBUG_FINISH(getQueue());
 }
 
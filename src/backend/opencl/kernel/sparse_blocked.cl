@@ -0,0 +1,76 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// Each work item computes one row of one column of the output
+
+#if IS_CPLX
+T __mul(T lhs, T rhs) {
+    T out;
+    out.x = lhs.x * rhs.x - lhs.y * rhs.y;
+    out.y = lhs.x * rhs.y + lhs.y * rhs.x;
+    return out;
+}
+#else
+#define __mul(lhs, rhs) ((lhs) * (rhs))
+#endif
+
+kernel void bsrmm(global T *out, KParam oinfo, global const T *values,
+                  global const int *rowIdx, global const int *colIdx,
+                  global const T *rhs, KParam rinfo, const int blockSize) {
+    const int row = get_global_id(0);
+    const int o   = get_global_id(1);
+    const int M   = oinfo.dims[0];
+    const int N   = rinfo.dims[0];
+    if (row >= M || o >= oinfo.dims[1]) return;
+
+    const int b  = blockSize;
+    const int br = row / b;
+    const int ii = row - br * b;
+
+    global const T *x = rhs + rinfo.offset + o * rinfo.strides[1];
+    T y               = (T)(0);
+    for (int blk = rowIdx[br]; blk < rowIdx[br + 1]; ++blk) {
+        // Blocks are column major
+        global const T *v = values + blk * b * b + ii;
+        const int col     = colIdx[blk] * b;
+        const int cols    = min(b, N - col);
+        for (int jj = 0; jj < cols; ++jj) {
+            y += __mul(v[jj * b], x[col + jj]);
+        }
+    }
+    out[oinfo.offset + o * oinfo.strides[1] + row] = y;
+}
+
+// The work items of a slice read consecutive values and columns
+kernel void sellmm(global T *out, KParam oinfo, global const T *values,
+                   global const int *rowIdx, global const int *colIdx,
+                   global const T *rhs, KParam rinfo, const int sliceSize,
+                   const int nSlices) {
+    const int p = get_global_id(0);
+    const int o = get_global_id(1);
+    if (p >= oinfo.dims[0] || o >= oinfo.dims[1]) return;
+
+    const int C     = sliceSize;
+    const int s     = p / C;
+    const int r     = p - s * C;
+    const int start = rowIdx[s];
+    const int width = (rowIdx[s + 1] - start) / C;
+
+    global const T *x = rhs + rinfo.offset + o * rinfo.strides[1];
+    T y               = (T)(0);
+    for (int k = 0; k < width; ++k) {
+        const int idx = start + k * C + r;
+        const int c   = colIdx[idx];
+        // The padding has the column -1
+        if (c >= 0) { y += __mul(values[idx], x[c]); }
+    }
+    // The row permutation follows the slice offsets
+    const int outRow = rowIdx[nSlices + 1 + p];
+    out[oinfo.offset + o * oinfo.strides[1] + outRow] = y;
+}
@@ -0,0 +1,77 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/sparse_blocked.hpp>
+#include <traits.hpp>
+
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+constexpr int SPARSE_BLOCKED_THREADS = 256;
+
+template<typename T>
+Kernel getSparseBlockedKernel(const char *name) {
+    static const std::string src(sparse_blocked_cl, sparse_blocked_cl_len);
+
+    std::vector<TemplateArg> targs   = {TemplateTypename<T>()};
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(IS_CPLX, (af::iscplx<T>() ? 1 : 0)),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+
+    return common::getKernel(name, {src}, targs, options);
+}
+
+/// Computes out = lhs * rhs for the BSR matrix lhs of \p values, \p rowIdx
+/// and \p colIdx
+template<typename T>
+void bsrmm(Param out, const Param &values, const Param &rowIdx,
+           const Param &colIdx, const Param &rhs, const int blockSize) {
+    auto bsrmm = getSparseBlockedKernel<T>("bsrmm");
+
+    cl::NDRange local(SPARSE_BLOCKED_THREADS, 1);
+    cl::NDRange global(divup(out.info.dims[0], local[0]) * local[0],
+                       out.info.dims[1]);
+
+    bsrmm(cl::EnqueueArgs(getQueue(), global, local), *out.data, out.info,
+          *values.data, *rowIdx.data, *colIdx.data, *rhs.data, rhs.info,
+          blockSize);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+/// Computes out = lhs * rhs for the SELL matrix lhs of \p values, \p rowIdx
+/// and \p colIdx
+template<typename T>
+void sellmm(Param out, const Param &values, const Param &rowIdx,
+            const Param &colIdx, const Param &rhs, const int sliceSize) {
+    auto sellmm = getSparseBlockedKernel<T>("sellmm");
+
+    cl::NDRange local(SPARSE_BLOCKED_THREADS, 1);
+    cl::NDRange global(divup(out.info.dims[0], local[0]) * local[0],
+                       out.info.dims[1]);
+
+    const int nSlices = divup(out.info.dims[0], sliceSize);
+    sellmm(cl::EnqueueArgs(getQueue(), global, local), *out.data, out.info,
+           *values.data, *rowIdx.data, *colIdx.data, *rhs.data, rhs.info,
+           sliceSize, nSlices);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+}  // namespace kernel
+}  // namespace opencl
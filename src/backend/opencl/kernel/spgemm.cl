@@ -0,0 +1,137 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// Each work item computes one row of the product C = A * B of CSR matrices.
+// The symbolic phase merges the columns of the rows of B in a hash table in
+// global memory, which has one slot for every product of the row.
+
+#if IS_CPLX
+T __mul(T lhs, T rhs) {
+    T out;
+    out.x = lhs.x * rhs.x - lhs.y * rhs.y;
+    out.y = lhs.x * rhs.y + lhs.y * rhs.x;
+    return out;
+}
+#else
+#define __mul(lhs, rhs) ((lhs) * (rhs))
+#endif
+
+/// Writes the number of products of each row to flops[row + 1]
+kernel void spgemm_row_flops(global int *flops, const int M,
+                             global const int *lRowIdx,
+                             global const int *lColIdx,
+                             global const int *rRowIdx) {
+    const int row = get_global_id(0);
+    if (row >= M) return;
+
+    int count = 0;
+    for (int l = lRowIdx[row]; l < lRowIdx[row + 1]; l++) {
+        const int k = lColIdx[l];
+        count += rRowIdx[k + 1] - rRowIdx[k];
+    }
+    flops[row + 1] = count;
+}
+
+/// Inserts the columns of each row of C in its part of \p table and writes
+/// the number of distinct columns to counts[row + 1]
+kernel void spgemm_symbolic(global int *counts, global int *table,
+                            global const int *offsets, const int M,
+                            global const int *lRowIdx,
+                            global const int *lColIdx,
+                            global const int *rRowIdx,
+                            global const int *rColIdx) {
+    const int row = get_global_id(0);
+    if (row >= M) return;
+
+    global int *keys = table + offsets[row];
+    const int size   = offsets[row + 1] - offsets[row];
+    for (int i = 0; i < size; i++) { keys[i] = -1; }
+
+    int count = 0;
+    for (int l = lRowIdx[row]; l < lRowIdx[row + 1]; l++) {
+        const int k = lColIdx[l];
+        for (int r = rRowIdx[k]; r < rRowIdx[k + 1]; r++) {
+            const int col = rColIdx[r];
+
+            // Linear probing, which always finds a slot because the table
+            // has a slot for every product
+            int h = col % size;
+            while (keys[h] != -1 && keys[h] != col) {
+                h = (h + 1 == size ? 0 : h + 1);
+            }
+            if (keys[h] == -1) {
+                keys[h] = col;
+                count++;
+            }
+        }
+    }
+    counts[row + 1] = count;
+}
+
+/// Copies the columns of each row from \p table to \p oColIdx in ascending
+/// order
+kernel void spgemm_columns(global int *oColIdx, global const int *oRowIdx,
+                           global const int *table, global const int *offsets,
+                           const int M) {
+    const int row = get_global_id(0);
+    if (row >= M) return;
+
+    const global int *keys = table + offsets[row];
+    const int size         = offsets[row + 1] - offsets[row];
+    global int *cols       = oColIdx + oRowIdx[row];
+
+    int n = 0;
+    for (int i = 0; i < size; i++) {
+        const int key = keys[i];
+        if (key == -1) continue;
+
+        int j = n++;
+        while (j > 0 && cols[j - 1] > key) {
+            cols[j] = cols[j - 1];
+            j--;
+        }
+        cols[j] = key;
+    }
+}
+
+/// Computes the values of each row of C in the pattern of the symbolic phase
+kernel void spgemm_values(global T *oVals, global const int *oRowIdx,
+                          global const int *oColIdx, const int M,
+                          global const T *lVals, global const int *lRowIdx,
+                          global const int *lColIdx, global const T *rVals,
+                          global const int *rRowIdx,
+                          global const int *rColIdx) {
+    const int row = get_global_id(0);
+    if (row >= M) return;
+
+    const int begin = oRowIdx[row];
+    const int end   = oRowIdx[row + 1];
+    for (int o = begin; o < end; o++) { oVals[o] = (T)(0); }
+
+    for (int l = lRowIdx[row]; l < lRowIdx[row + 1]; l++) {
+        const int k = lColIdx[l];
+        const T a   = lVals[l];
+        for (int r = rRowIdx[k]; r < rRowIdx[k + 1]; r++) {
+            const int col = rColIdx[r];
+
+            // The column is in the sorted columns of the row
+            int lo = begin;
+            int hi = end - 1;
+            while (lo < hi) {
+                const int mid = (lo + hi) / 2;
+                if (oColIdx[mid] < col) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            oVals[lo] = oVals[lo] + __mul(a, rVals[r]);
+        }
+    }
+}
@@ -0,0 +1,107 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/spgemm.hpp>
+#include <traits.hpp>
+
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+constexpr int SPGEMM_THREADS = 256;
+
+template<typename T>
+Kernel getSpgemmKernel(const char *name) {
+    static const std::string src(spgemm_cl, spgemm_cl_len);
+
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<T>(),
+    };
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(IS_CPLX, (af::iscplx<T>() ? 1 : 0)),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+
+    return common::getKernel(name, {src}, targs, options);
+}
+
+/// Writes the number of products of each row of lhs * rhs to flops[row + 1]
+template<typename T>
+void spgemmRowFlops(Param flops, const int M, const Param lRowIdx,
+                    const Param lColIdx, const Param rRowIdx) {
+    auto rowFlops = getSpgemmKernel<T>("spgemm_row_flops");
+
+    cl::NDRange local(SPGEMM_THREADS);
+    cl::NDRange global(divup(M, SPGEMM_THREADS) * local[0]);
+
+    rowFlops(cl::EnqueueArgs(getQueue(), global, local), *flops.data, M,
+             *lRowIdx.data, *lColIdx.data, *rRowIdx.data);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+/// Collects the columns of each row of lhs * rhs in the part of \p table at
+/// \p offsets and writes their number to counts[row + 1]
+template<typename T>
+void spgemmSymbolic(Param counts, Param table, const Param offsets,
+                    const int M, const Param lRowIdx, const Param lColIdx,
+                    const Param rRowIdx, const Param rColIdx) {
+    auto symbolic = getSpgemmKernel<T>("spgemm_symbolic");
+
+    cl::NDRange local(SPGEMM_THREADS);
+    cl::NDRange global(divup(M, SPGEMM_THREADS) * local[0]);
+
+    symbolic(cl::EnqueueArgs(getQueue(), global, local), *counts.data,
+             *table.data, *offsets.data, M, *lRowIdx.data, *lColIdx.data,
+             *rRowIdx.data, *rColIdx.data);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+/// Writes the sorted columns of each row from \p table to \p oColIdx
+template<typename T>
+void spgemmColumns(Param oColIdx, const Param oRowIdx, const Param table,
+                   const Param offsets, const int M) {
+    auto columns = getSpgemmKernel<T>("spgemm_columns");
+
+    cl::NDRange local(SPGEMM_THREADS);
+    cl::NDRange global(divup(M, SPGEMM_THREADS) * local[0]);
+
+    columns(cl::EnqueueArgs(getQueue(), global, local), *oColIdx.data,
+            *oRowIdx.data, *table.data, *offsets.data, M);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+/// Computes the values of lhs * rhs in the pattern of \p oRowIdx and
+/// \p oColIdx
+template<typename T>
+void spgemmValues(Param oVals, const Param oRowIdx, const Param oColIdx,
+                  const int M, const Param lVals, const Param lRowIdx,
+                  const Param lColIdx, const Param rVals, const Param rRowIdx,
+                  const Param rColIdx) {
+    auto values = getSpgemmKernel<T>("spgemm_values");
+
+    cl::NDRange local(SPGEMM_THREADS);
+    cl::NDRange global(divup(M, SPGEMM_THREADS) * local[0]);
+
+    values(cl::EnqueueArgs(getQueue(), global, local), *oVals.data,
+           *oRowIdx.data, *oColIdx.data, M, *lVals.data, *lRowIdx.data,
+           *lColIdx.data, *rVals.data, *rRowIdx.data, *rColIdx.data);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+}  // namespace kernel
+}  // namespace opencl
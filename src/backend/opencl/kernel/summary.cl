@@ -0,0 +1,86 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// Reduces the values of in into the statistics of each group, stored at
+// get_group_id(1) * get_num_groups(0) + get_group_id(0). The groups along 1
+// take the lines along dim 0, and the groups along 0 split each line. NaN
+// values are ignored by the minimum and the maximum.
+kernel void summaryParts(global T *pMin, global T *pMax, global Ts *pSum,
+                         global Ts *pSumSq, global uint *pCount,
+                         global const T *in, KParam iInfo, dim_t lines,
+                         T minInit, T maxInit) {
+    local T l_min[THREADS];
+    local T l_max[THREADS];
+    local Ts l_sum[THREADS];
+    local Ts l_sumsq[THREADS];
+    local uint l_count[THREADS];
+
+    const int lid = get_local_id(0);
+    T vmin        = minInit;
+    T vmax        = maxInit;
+    Ts sum        = 0;
+    Ts sumsq      = 0;
+    uint count    = 0;
+
+    for (dim_t line = get_group_id(1); line < lines;
+         line += get_num_groups(1)) {
+        const dim_t i1       = line % iInfo.dims[1];
+        const dim_t i2       = (line / iInfo.dims[1]) % iInfo.dims[2];
+        const dim_t i3       = line / (iInfo.dims[1] * iInfo.dims[2]);
+        global const T *iptr = in + iInfo.offset + i1 * iInfo.strides[1] +
+                               i2 * iInfo.strides[2] + i3 * iInfo.strides[3];
+        for (dim_t i = get_global_id(0); i < iInfo.dims[0];
+             i += get_global_size(0)) {
+            const T v = iptr[i];
+            if (v == v) {
+                vmin = v < vmin ? v : vmin;
+                vmax = v > vmax ? v : vmax;
+            }
+            const Ts s = (Ts)v;
+            sum += s;
+            sumsq += s * s;
+            count += v != (T)0;
+        }
+    }
+
+    l_min[lid]   = vmin;
+    l_max[lid]   = vmax;
+    l_sum[lid]   = sum;
+    l_sumsq[lid] = sumsq;
+    l_count[lid] = count;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (int offset = THREADS / 2; offset > 0; offset /= 2) {
+        if (lid < offset) {
+            const T omin = l_min[lid + offset];
+            const T omax = l_max[lid + offset];
+            vmin         = omin < vmin ? omin : vmin;
+            vmax         = omax > vmax ? omax : vmax;
+            sum += l_sum[lid + offset];
+            sumsq += l_sumsq[lid + offset];
+            count += l_count[lid + offset];
+            l_min[lid]   = vmin;
+            l_max[lid]   = vmax;
+            l_sum[lid]   = sum;
+            l_sumsq[lid] = sumsq;
+            l_count[lid] = count;
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    if (lid == 0) {
+        const dim_t part =
+            get_group_id(1) * get_num_groups(0) + get_group_id(0);
+        pMin[part]   = vmin;
+        pMax[part]   = vmax;
+        pSum[part]   = sum;
+        pSumSq[part] = sumsq;
+        pCount[part] = count;
+    }
+}
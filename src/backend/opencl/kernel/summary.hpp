@@ -0,0 +1,120 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/kernel_cache.hpp>
+#include <common/summary.hpp>
+#include <debug_opencl.hpp>
+#include <kernel_headers/summary.hpp>
+#include <memory.hpp>
+#include <traits.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+constexpr int SUMMARY_THREADS = 256;
+/// The number of values reduced by a work-item before the statistics of the
+/// work-items of a group are combined
+constexpr dim_t SUMMARY_THREAD_ELEMENTS = 64;
+/// The largest number of groups, whose statistics are combined on the host
+constexpr dim_t SUMMARY_MAX_PARTS  = 1024;
+constexpr dim_t SUMMARY_MAX_GROUPS = 65535;
+
+/// Computes the statistics of all the values of \p in in one pass.
+///
+/// Each group reduces parts of the lines along dim 0 into a tuple of the
+/// minimum, the maximum, the sum, the sum of the squares and the number of
+/// nonzero values. The statistics of the groups are read back with one
+/// blocking read, and combined on the host like reduceAll.
+template<typename T>
+common::Summary summary_all(Param in) {
+    using Ts = common::summary_sum_t<T>;
+    static const std::string src(summary_cl, summary_cl_len);
+
+    const dim_t elements = in.info.dims[0] * in.info.dims[1] *
+                           in.info.dims[2] * in.info.dims[3];
+    if (elements == 0) {
+        return common::combineSummaries<T>(nullptr, nullptr, nullptr, nullptr,
+                                           nullptr, 0);
+    }
+
+    bool isLinear = in.info.strides[0] == 1;
+    for (int k = 1; k < 4; ++k) {
+        isLinear &=
+            in.info.strides[k] == in.info.strides[k - 1] * in.info.dims[k - 1];
+    }
+    if (isLinear) {
+        in.info.dims[0] = elements;
+        for (int k = 1; k < 4; ++k) {
+            in.info.dims[k]    = 1;
+            in.info.strides[k] = elements;
+        }
+    }
+
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<T>(),
+    };
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(Ts, dtype_traits<Ts>::getName()),
+        DefineKeyValue(THREADS, SUMMARY_THREADS),
+    };
+    options.emplace_back(getTypeBuildDefinition<T, Ts>());
+
+    auto reduceParts = common::getKernel("summaryParts", {src}, targs, options);
+
+    const dim_t lines  = in.info.dims[1] * in.info.dims[2] * in.info.dims[3];
+    const dim_t partsX = std::min(
+        divup(in.info.dims[0], SUMMARY_THREADS * SUMMARY_THREAD_ELEMENTS),
+        SUMMARY_MAX_PARTS);
+    const dim_t partsY = std::min(
+        {lines, divup(SUMMARY_MAX_PARTS, partsX), SUMMARY_MAX_GROUPS});
+    const dim_t parts = partsX * partsY;
+
+    auto pMin   = memAlloc<T>(parts);
+    auto pMax   = memAlloc<T>(parts);
+    auto pSum   = memAlloc<Ts>(parts);
+    auto pSumSq = memAlloc<Ts>(parts);
+    auto pCount = memAlloc<uint>(parts);
+
+    const cl::NDRange local(SUMMARY_THREADS, 1);
+    const cl::NDRange global(partsX * SUMMARY_THREADS, partsY);
+    reduceParts(cl::EnqueueArgs(getQueue(), global, local), *pMin, *pMax,
+                *pSum, *pSumSq, *pCount, *in.data, in.info, lines,
+                common::summaryMinInit<T>(), common::summaryMaxInit<T>());
+    CL_DEBUG_FINISH(getQueue());
+
+    // The queue is in order, so the last blocking read waits for all of them
+    std::vector<T> mins(parts), maxs(parts);
+    std::vector<Ts> sums(parts), sumsqs(parts);
+    std::vector<uint> counts(parts);
+    getQueue().enqueueReadBuffer(*pMin, CL_FALSE, 0, parts * sizeof(T),
+                                 mins.data());
+    getQueue().enqueueReadBuffer(*pMax, CL_FALSE, 0, parts * sizeof(T),
+                                 maxs.data());
+    getQueue().enqueueReadBuffer(*pSum, CL_FALSE, 0, parts * sizeof(Ts),
+                                 sums.data());
+    getQueue().enqueueReadBuffer(*pSumSq, CL_FALSE, 0, parts * sizeof(Ts),
+                                 sumsqs.data());
+    getQueue().enqueueReadBuffer(*pCount, CL_TRUE, 0, parts * sizeof(uint),
+                                 counts.data());
+
+    return common::combineSummaries<T>(mins.data(), maxs.data(), sums.data(),
+                                       sumsqs.data(), counts.data(), parts);
+}
+
+}  // namespace kernel
+}  // namespace opencl
@@ -0,0 +1,183 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#if USE_SUBGROUPS
+#pragma OPENCL EXTENSION cl_khr_subgroups : enable
+#endif
+
+// The keys are unsigned integers which are ordered like the values for the
+// smallest values and in the reverse order for the largest ones, so the top
+// k values always have the smallest keys
+ulong toKey(T v) {
+#if KEY_BITS == 64
+    const ulong in   = as_ulong(v);
+    const ulong mask = ~0UL;
+#elif KEY_BITS == 32
+    const ulong in   = as_uint(v);
+    const ulong mask = 0xffffffffUL;
+#else
+    const ulong in   = as_ushort(v);
+    const ulong mask = 0xffffUL;
+#endif
+    const ulong sign = 1UL << (KEY_BITS - 1);
+#if IS_FLOAT
+    const ulong key = (in & sign) ? ~in & mask : in | sign;
+#elif IS_SIGNED
+    const ulong key = in ^ sign;
+#else
+    const ulong key = in;
+#endif
+#if IS_MAX
+    return ~key & mask;
+#else
+    return key;
+#endif
+}
+
+// The offset of a column
+dim_t lineOffset(dim_t line, KParam info) {
+    const dim_t y = line % info.dims[1];
+    const dim_t z = (line / info.dims[1]) % info.dims[2];
+    const dim_t w = line / (info.dims[1] * info.dims[2]);
+    return info.offset + y * info.strides[1] + z * info.strides[2] +
+           w * info.strides[3];
+}
+
+// Counts the digits at shift of the keys whose higher digits match the
+// prefix of the k-th key of each line
+kernel void topkHistogram(global uint *hist, global const ulong *prefix,
+                          global const T *in, KParam iInfo, dim_t lines,
+                          int shift, ulong highMask) {
+    local uint l_hist[256];
+
+    const int lid       = get_local_id(0);
+    const dim_t n       = iInfo.dims[0];
+    const dim_t threads = get_global_size(0);
+
+    for (dim_t line = get_group_id(1); line < lines;
+         line += get_num_groups(1)) {
+        for (int i = lid; i < 256; i += get_local_size(0)) { l_hist[i] = 0; }
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        const ulong high     = prefix[line];
+        global const T *iptr = in + lineOffset(line, iInfo);
+        for (dim_t i = get_global_id(0); i < n; i += threads) {
+            const ulong key = toKey(iptr[i]);
+            if ((key & highMask) == high) {
+                atomic_inc(l_hist + ((key >> shift) & 0xff));
+            }
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        global uint *hptr = hist + 256 * line;
+        for (int i = lid; i < 256; i += get_local_size(0)) {
+            if (l_hist[i]) { atomic_add(hptr + i, l_hist[i]); }
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+}
+
+// Appends the digit of the k-th key of each line to its prefix. The rank is
+// made relative to the keys of the prefix, so after the last pass it is the
+// number of keys equal to the k-th key which are selected, minus one.
+kernel void topkSelect(global ulong *prefix, global uint *ranks,
+                       global const uint *hist, dim_t lines, int k, int shift,
+                       int firstPass) {
+    const dim_t line = get_global_id(0);
+    if (line >= lines) { return; }
+
+    uint r                  = firstPass ? k - 1 : ranks[line];
+    global const uint *hptr = hist + 256 * line;
+    int digit               = 0;
+    for (; digit < 255 && r >= hptr[digit]; ++digit) { r -= hptr[digit]; }
+
+    prefix[line] |= (ulong)digit << shift;
+    ranks[line] = r;
+}
+
+// Writes the values before the k-th value of each line and the first values
+// equal to it, with their indices
+kernel void topkCompact(global T *ovals, KParam oInfo, global uint *oidxs,
+                        KParam idxInfo, global uint *counts,
+                        global const ulong *prefix, global const uint *ranks,
+                        global const T *in, KParam iInfo, dim_t lines,
+                        int k) {
+    const dim_t n       = iInfo.dims[0];
+    const dim_t threads = get_global_size(0);
+
+    for (dim_t line = get_group_id(1); line < lines;
+         line += get_num_groups(1)) {
+        const ulong kth    = prefix[line];
+        const uint ties    = ranks[line] + 1;
+        const uint slots   = k;
+        const uint smaller = slots - ties;
+
+        global const T *iptr = in + lineOffset(line, iInfo);
+        global T *vptr       = ovals + lineOffset(line, oInfo);
+        global uint *iout    = oidxs + lineOffset(line, idxInfo);
+
+#if USE_SUBGROUPS
+        // Each subgroup takes the positions of its values with one atomic
+        // for each counter. The bound of the loop is the same for the whole
+        // group so that every work item reaches the subgroup functions.
+        for (dim_t base = 0; base < n; base += threads) {
+            const dim_t i     = base + get_global_id(0);
+            const bool valid  = i < n;
+            const T val       = valid ? iptr[i] : (T)0;
+            const ulong key   = toKey(val);
+            const uint isLess = valid && key < kth;
+            const uint isTie  = valid && key == kth;
+
+            const uint lessRank = sub_group_scan_exclusive_add(isLess);
+            const uint tieRank  = sub_group_scan_exclusive_add(isTie);
+            const uint numLess  = sub_group_reduce_add(isLess);
+            const uint numTies  = sub_group_reduce_add(isTie);
+
+            global uint *lessCount = counts + 2 * line;
+            global uint *tieCount  = counts + 2 * line + 1;
+            uint lessBase          = 0;
+            uint tieBase           = 0;
+            if (get_sub_group_local_id() == 0) {
+                if (numLess) { lessBase = atomic_add(lessCount, numLess); }
+                if (numTies) { tieBase = atomic_add(tieCount, numTies); }
+            }
+            lessBase = sub_group_broadcast(lessBase, 0);
+            tieBase  = sub_group_broadcast(tieBase, 0);
+
+            uint pos = slots;
+            if (isLess) {
+                pos = lessBase + lessRank;
+            } else if (isTie) {
+                const uint tie = tieBase + tieRank;
+                if (tie < ties) { pos = smaller + tie; }
+            }
+            if (pos < slots) {
+                vptr[pos] = val;
+                iout[pos] = i;
+            }
+        }
+#else
+        for (dim_t i = get_global_id(0); i < n; i += threads) {
+            const T val     = iptr[i];
+            const ulong key = toKey(val);
+            uint pos        = slots;
+            if (key < kth) {
+                pos = atomic_inc(counts + 2 * line);
+            } else if (key == kth) {
+                const uint tie = atomic_inc(counts + 2 * line + 1);
+                if (tie < ties) { pos = smaller + tie; }
+            }
+            if (pos < slots) {
+                vptr[pos] = val;
+                iout[pos] = i;
+            }
+        }
+#endif
+    }
+}
@@ -0,0 +1,115 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <common/half.hpp>
+#include <common/kernel_cache.hpp>
+#include <debug_opencl.hpp>
+#include <kernel/sort_by_key.hpp>
+#include <kernel_headers/topk.hpp>
+#include <memory.hpp>
+#include <platform.hpp>
+#include <traits.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace opencl {
+namespace kernel {
+
+constexpr int TOPK_SELECT_THREADS        = 256;
+constexpr int TOPK_SELECT_BLOCK_ELEMENTS = 32 * TOPK_SELECT_THREADS;
+constexpr dim_t TOPK_MAX_GROUPS          = 65535;
+
+/// Selects the top \p k values of each column of \p in into the k rows of
+/// \p vals and their indices into \p idxs.
+///
+/// The values are mapped to unsigned keys in which the top values are the
+/// smallest. A most significant digit radix select finds the k-th key of
+/// each column with one histogram pass over the input for each byte of the
+/// keys. The values before it and enough values equal to it are written to
+/// the output, which is then sorted. Only the k selected values of each
+/// column are sorted, and all the columns are processed by each launch.
+template<typename T>
+void topkSelect(Param vals, Param idxs, const Param in, const int k,
+                const af::topkFunction order) {
+    static const std::string src(topk_cl, topk_cl_len);
+
+    const bool isMax = order == AF_TOPK_MAX;
+    std::vector<TemplateArg> targs = {
+        TemplateTypename<T>(),
+        TemplateArg(isMax),
+    };
+    std::vector<std::string> options = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(IS_FLOAT, !std::numeric_limits<T>::is_integer),
+        DefineKeyValue(IS_SIGNED, std::numeric_limits<T>::is_signed),
+        DefineKeyValue(IS_MAX, static_cast<int>(isMax)),
+        DefineKeyValue(KEY_BITS, static_cast<int>(sizeof(T) * 8)),
+        DefineKeyValue(USE_SUBGROUPS,
+                       isSubgroupShuffleSupported(getActiveDeviceId())),
+    };
+    options.emplace_back(getTypeBuildDefinition<T>());
+
+    auto histogram = common::getKernel("topkHistogram", {src}, targs, options);
+    auto select    = common::getKernel("topkSelect", {src}, targs, options);
+    auto compact   = common::getKernel("topkCompact", {src}, targs, options);
+
+    const dim_t n     = in.info.dims[0];
+    const dim_t lines = in.info.dims[1] * in.info.dims[2] * in.info.dims[3];
+
+    auto hist   = memAlloc<uint>(lines * 256);
+    auto prefix = memAlloc<uintl>(lines);
+    auto ranks  = memAlloc<uint>(lines);
+    auto counts = memAlloc<uint>(2 * lines);
+    getQueue().enqueueFillBuffer(*prefix, cl_ulong(0), 0,
+                                 lines * sizeof(cl_ulong));
+    getQueue().enqueueFillBuffer(*counts, cl_uint(0), 0,
+                                 2 * lines * sizeof(cl_uint));
+
+    const dim_t groupsPerLine =
+        std::min(divup(n, TOPK_SELECT_BLOCK_ELEMENTS), TOPK_MAX_GROUPS);
+    const cl::NDRange local(TOPK_SELECT_THREADS, 1);
+    const cl::NDRange global(groupsPerLine * TOPK_SELECT_THREADS,
+                             std::min(lines, TOPK_MAX_GROUPS));
+    const cl::NDRange selectGlobal(
+        divup(lines, TOPK_SELECT_THREADS) * TOPK_SELECT_THREADS, 1);
+
+    const int passes = sizeof(T);
+    for (int pass = 0; pass < passes; ++pass) {
+        const int shift = (passes - 1 - pass) * 8;
+        const cl_ulong highMask =
+            shift + 8 >= 64 ? 0 : ~((cl_ulong(1) << (shift + 8)) - 1);
+
+        getQueue().enqueueFillBuffer(*hist, cl_uint(0), 0,
+                                     lines * 256 * sizeof(cl_uint));
+        histogram(cl::EnqueueArgs(getQueue(), global, local), *hist, *prefix,
+                  *in.data, in.info, lines, shift, highMask);
+        CL_DEBUG_FINISH(getQueue());
+
+        select(cl::EnqueueArgs(getQueue(), selectGlobal, local), *prefix,
+               *ranks, *hist, lines, k, shift, static_cast<int>(pass == 0));
+        CL_DEBUG_FINISH(getQueue());
+    }
+
+    compact(cl::EnqueueArgs(getQueue(), global, local), *vals.data, vals.info,
+            *idxs.data, idxs.info, *counts, *prefix, *ranks, *in.data, in.info,
+            lines, k);
+    CL_DEBUG_FINISH(getQueue());
+
+    sort0ByKey<T, uint>(vals, idxs, !isMax);
+}
+
+}  // namespace kernel
+}  // namespace opencl
@@ -56,7 +56,11 @@ kernel void initEdgeOutKernel(global T* output, KParam oInfo,
 #if defined(EDGE_TRACER)
 kernel void edgeTrackKernel(global T* output, KParam oInfo, unsigned nBBS0,
                               unsigned nBBS1,
-                              global volatile int* hasChanged) {
+                              global volatile int* hasChanged, int iter) {
+    // The previous launch of the batch changed nothing, so the tracking has
+    // converged
+    if (iter > 0 && hasChanged[iter - 1] == 0) return;
+
     // shared memory with 1 pixel border
     // strong and weak images are binary(char) images thus,
     // occupying only (16+2)*(16+2) = 324 bytes per shared memory tile
@@ -185,7 +189,7 @@ kernel void edgeTrackKernel(global T* output, KParam oInfo, unsigned nBBS0,
 
     continueIter = predicates[0];
 
-    if (continueIter && lx == 0 && ly == 0) atomic_inc(hasChanged);
+    if (continueIter && lx == 0 && ly == 0) atomic_inc(hasChanged + iter);
 
     // Update output with shared memory result
     if (gx < (oInfo.dims[0] - 1) && gy < (oInfo.dims[1] - 1))
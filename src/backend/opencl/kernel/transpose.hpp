@@ -10,6 +10,7 @@
 #pragma once
 
 #include <Param.hpp>
+#include <common/LaunchTuning.hpp>
 #include <common/dispatch.hpp>
 #include <common/kernel_cache.hpp>
 #include <debug_opencl.hpp>
@@ -26,6 +27,10 @@ constexpr int TILE_DIM  = 32;
 constexpr int THREADS_X = TILE_DIM;
 constexpr int THREADS_Y = 256 / TILE_DIM;
 
+// The heights of the work groups tried by the launch autotuner. The largest
+// has 256 work items, the smallest limit of the OpenCL devices supported.
+constexpr int TUNED_THREADS_Y[] = {2, 4, 8};
+
 template<typename T>
 void transpose(Param out, const Param in, cl::CommandQueue queue,
                const bool conjugate, const bool IS32MULTIPLE) {
@@ -41,28 +46,39 @@ void transpose(Param out, const Param in, cl::CommandQueue queue,
         TemplateArg(conjugate),
         TemplateArg(IS32MULTIPLE),
     };
-    vector<string> compileOpts = {
-        DefineValue(TILE_DIM),
-        DefineValue(THREADS_Y),
-        DefineValue(IS32MULTIPLE),
-        DefineKeyValue(DOCONJUGATE, (conjugate && af::iscplx<T>())),
-        DefineKeyValue(T, dtype_traits<T>::getName()),
-    };
-    compileOpts.emplace_back(getTypeBuildDefinition<T>());
+    const int blk_x = divup(in.info.dims[0], TILE_DIM);
+    const int blk_y = divup(in.info.dims[1], TILE_DIM);
 
-    auto transpose =
-        common::getKernel("transpose", {src}, tmpltArgs, compileOpts);
+    auto launch = [&](int config) {
+        const int threadsY         = TUNED_THREADS_Y[config];
+        vector<string> compileOpts = {
+            DefineValue(TILE_DIM),
+            DefineKeyValue(THREADS_Y, threadsY),
+            DefineValue(IS32MULTIPLE),
+            DefineKeyValue(DOCONJUGATE, (conjugate && af::iscplx<T>())),
+            DefineKeyValue(T, dtype_traits<T>::getName()),
+        };
+        compileOpts.emplace_back(getTypeBuildDefinition<T>());
 
-    NDRange local(THREADS_X, THREADS_Y);
+        auto transpose =
+            common::getKernel("transpose", {src}, tmpltArgs, compileOpts);
 
-    const int blk_x = divup(in.info.dims[0], TILE_DIM);
-    const int blk_y = divup(in.info.dims[1], TILE_DIM);
+        NDRange local(THREADS_X, threadsY);
+        NDRange global(blk_x * local[0] * in.info.dims[2],
+                       blk_y * local[1] * in.info.dims[3]);
 
-    NDRange global(blk_x * local[0] * in.info.dims[2],
-                   blk_y * local[1] * in.info.dims[3]);
+        transpose(EnqueueArgs(queue, global, local), *out.data, out.info,
+                  *in.data, in.info, blk_x, blk_y);
+    };
 
-    transpose(EnqueueArgs(queue, global, local), *out.data, out.info, *in.data,
-              in.info, blk_x, blk_y);
+    // transpose only writes the output, so it can be launched again while
+    // the configurations are tuned
+    const string name = string("transpose:") + dtype_traits<T>::getName();
+    const int config = common::tuneLaunch(
+        name,
+        in.info.dims[0] * in.info.dims[1] * in.info.dims[2] * in.info.dims[3],
+        sizeof(TUNED_THREADS_Y) / sizeof(TUNED_THREADS_Y[0]), 2, launch);
+    launch(config);
     CL_DEBUG_FINISH(queue);
 }
 
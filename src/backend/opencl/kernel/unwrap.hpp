@@ -10,11 +10,15 @@
 #pragma once
 
 #include <Param.hpp>
+#include <common/Binary.hpp>
 #include <common/dispatch.hpp>
 #include <common/kernel_cache.hpp>
 #include <debug_opencl.hpp>
 #include <kernel/config.hpp>
+#include <kernel/names.hpp>
+#include <kernel_headers/ops.hpp>
 #include <kernel_headers/unwrap.hpp>
+#include <kernel_headers/unwrap_reduce.hpp>
 #include <math.hpp>
 #include <traits.hpp>
 
@@ -78,5 +82,51 @@ void unwrap(Param out, const Param in, const dim_t wx, const dim_t wy,
     CL_DEBUG_FINISH(getQueue());
 }
 
+template<af_op_t op, typename T>
+void unwrapReduce(Param out, const Param in, const dim_t wx, const dim_t wy,
+                  const dim_t sx, const dim_t sy, const dim_t px,
+                  const dim_t py) {
+    using cl::EnqueueArgs;
+    using cl::NDRange;
+    using std::string;
+    using std::vector;
+
+    static const string src1(ops_cl, ops_cl_len);
+    static const string src2(unwrap_reduce_cl, unwrap_reduce_cl_len);
+
+    ToNumStr<T> toNumStr;
+    vector<TemplateArg> tmpltArgs = {
+        TemplateTypename<T>(),
+        TemplateArg(op),
+    };
+    vector<string> compileOpts = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(Ti, "T"),
+        DefineKeyValue(To, "T"),
+        DefineKeyValue(ZERO, toNumStr(scalar<T>(0))),
+        DefineKeyValue(init, toNumStr(common::Binary<T, op>::init())),
+        DefineKeyFromStr(binOpName<op>()),
+        DefineKeyValue(CPLX, af::iscplx<T>()),
+        DefineKeyValue(IS_BF16, 0),
+    };
+    compileOpts.emplace_back(getTypeBuildDefinition<T>());
+
+    auto unwrapReduce =
+        common::getKernel("unwrapReduce", {src1, src2}, tmpltArgs, compileOpts);
+
+    NDRange local(THREADS_X, THREADS_Y);
+    const dim_t blk_x = divup(out.info.dims[0], local[0]);
+    const dim_t blk_y = divup(out.info.dims[1], local[1]);
+    NDRange global(local[0] * blk_x * out.info.dims[2],
+                   local[1] * blk_y * out.info.dims[3]);
+
+    unwrapReduce(EnqueueArgs(getQueue(), global, local), *out.data, out.info,
+                 *in.data, in.info, static_cast<int>(wx), static_cast<int>(wy),
+                 static_cast<int>(sx), static_cast<int>(sy),
+                 static_cast<int>(px), static_cast<int>(py),
+                 static_cast<int>(blk_x), static_cast<int>(blk_y));
+    CL_DEBUG_FINISH(getQueue());
+}
+
 }  // namespace kernel
 }  // namespace opencl
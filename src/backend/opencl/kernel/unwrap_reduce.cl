@@ -0,0 +1,45 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// Every work item reduces one window of the unwrap output columns, the
+// padding is reduced once as a zero
+kernel void unwrapReduce(global T *d_out, const KParam out,
+                         global const T *d_in, const KParam in, const int wx,
+                         const int wy, const int sx, const int sy,
+                         const int px, const int py, const int nBBS0,
+                         const int nBBS1) {
+    const int z    = get_group_id(0) / nBBS0;
+    const int w    = get_group_id(1) / nBBS1;
+    const int winx = get_local_size(0) * (get_group_id(0) - z * nBBS0) +
+                     get_local_id(0);
+    const int winy = get_local_size(1) * (get_group_id(1) - w * nBBS1) +
+                     get_local_id(1);
+
+    if (winx >= out.dims[0] || winy >= out.dims[1]) return;
+
+    global const T *iptr =
+        d_in + in.offset + w * in.strides[3] + z * in.strides[2];
+
+    const int spx = winx * sx - px;
+    const int spy = winy * sy - py;
+    const int x0  = max(spx, 0);
+    const int x1  = min(spx + wx, (int)in.dims[0]);
+    const int y0  = max(spy, 0);
+    const int y1  = min(spy + wy, (int)in.dims[1]);
+
+    T acc = init;
+    for (int y = y0; y < y1; ++y) {
+        global const T *irow = iptr + y * in.strides[1];
+        for (int x = x0; x < x1; ++x) { acc = binOp(acc, irow[x]); }
+    }
+    if ((x1 - x0) * (y1 - y0) < wx * wy) { acc = binOp(acc, ZERO); }
+
+    d_out[out.offset + w * out.strides[3] + z * out.strides[2] +
+          winy * out.strides[1] + winx] = acc;
+}
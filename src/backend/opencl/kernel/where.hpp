@@ -25,6 +25,19 @@
 
 namespace opencl {
 namespace kernel {
+/// The program of where and compact for the values of type T
+template<typename T>
+static std::vector<std::string> whereOptions() {
+    ToNumStr<T> toNumStr;
+    std::vector<std::string> compileOpts = {
+        DefineKeyValue(T, dtype_traits<T>::getName()),
+        DefineKeyValue(ZERO, toNumStr(scalar<T>(0))),
+        DefineKeyValue(CPLX, af::iscplx<T>()),
+    };
+    compileOpts.emplace_back(getTypeBuildDefinition<T>());
+    return compileOpts;
+}
+
 template<typename T>
 static void get_out_idx(cl::Buffer *out_data, Param &otmp, Param &rtmp,
                         Param &in, uint threads_x, uint groups_x,
@@ -36,19 +49,12 @@ static void get_out_idx(cl::Buffer *out_data, Param &otmp, Param &rtmp,
 
     static const string src(where_cl, where_cl_len);
 
-    ToNumStr<T> toNumStr;
     vector<TemplateArg> tmpltArgs = {
         TemplateTypename<T>(),
     };
-    vector<string> compileOpts = {
-        DefineKeyValue(T, dtype_traits<T>::getName()),
-        DefineKeyValue(ZERO, toNumStr(scalar<T>(0))),
-        DefineKeyValue(CPLX, af::iscplx<T>()),
-    };
-    compileOpts.emplace_back(getTypeBuildDefinition<T>());
 
     auto getIdx =
-        common::getKernel("get_out_idx", {src}, tmpltArgs, compileOpts);
+        common::getKernel("get_out_idx", {src}, tmpltArgs, whereOptions<T>());
 
     NDRange local(threads_x, THREADS_PER_GROUP / threads_x);
     NDRange global(local[0] * groups_x * in.info.dims[2],
@@ -62,8 +68,53 @@ static void get_out_idx(cl::Buffer *out_data, Param &otmp, Param &rtmp,
     CL_DEBUG_FINISH(getQueue());
 }
 
+/// Copies the values of \p in where \p mask is nonzero to \p out_data, at
+/// the positions written by get_out_idx
 template<typename T>
-static void where(Param &out, Param &in) {
+static void compact_values(cl::Buffer *out_data, Param &otmp, Param &rtmp,
+                           Param &mask, Param &in, uint threads_x,
+                           uint groups_x, uint groups_y) {
+    using cl::EnqueueArgs;
+    using cl::NDRange;
+    using std::string;
+    using std::vector;
+
+    static const string src(where_cl, where_cl_len);
+
+    vector<TemplateArg> tmpltArgs = {
+        TemplateTypename<T>(),
+    };
+
+    auto compact =
+        common::getKernel("compact", {src}, tmpltArgs, whereOptions<T>());
+
+    NDRange local(threads_x, THREADS_PER_GROUP / threads_x);
+    NDRange global(local[0] * groups_x * mask.info.dims[2],
+                   local[1] * groups_y * mask.info.dims[3]);
+
+    uint lim = divup(otmp.info.dims[0], (threads_x * groups_x));
+
+    compact(EnqueueArgs(getQueue(), global, local), *out_data, *otmp.data,
+            otmp.info, *rtmp.data, rtmp.info, *mask.data, mask.info, *in.data,
+            in.info, groups_x, groups_y, lim);
+    CL_DEBUG_FINISH(getQueue());
+}
+
+/// The scan of the nonzero values of an array, shared by where and compact.
+/// Its buffers are freed by whereFree.
+struct WhereScan {
+    Param otmp;  ///< The running count of each group along dim 0
+    Param rtmp;  ///< The running count of the groups of all the lines
+    uint threads_x;
+    uint groups_x;
+    uint groups_y;
+    uint total;  ///< The number of nonzero values, read back to the host
+};
+
+/// Counts the nonzero values of \p in within each group along dim 0, then
+/// scans the counts of the groups of all the lines
+template<typename T>
+static WhereScan whereScan(Param &in) {
     uint threads_x = nextpow2(std::max(32u, (uint)in.info.dims[0]));
     threads_x      = std::min(threads_x, THREADS_PER_GROUP);
     uint threads_y = THREADS_PER_GROUP / threads_x;
@@ -71,8 +122,9 @@ static void where(Param &out, Param &in) {
     uint groups_x = divup(in.info.dims[0], threads_x * REPEAT);
     uint groups_y = divup(in.info.dims[1], threads_y);
 
-    Param rtmp;
-    Param otmp;
+    WhereScan scan;
+    Param &rtmp = scan.rtmp;
+    Param &otmp = scan.otmp;
 
     rtmp.info.dims[0] = groups_x;
     otmp.info.dims[0] = in.info.dims[0];
@@ -111,26 +163,61 @@ static void where(Param &out, Param &in) {
 
     scanFirst<uint, uint, af_add_t>(ltmp, ltmp);
 
-    // Get output size and allocate output
-    uint total;
+    // Get output size
     getQueue().enqueueReadBuffer(*rtmp.data, CL_TRUE,
                                  sizeof(uint) * (rtmp_elements - 1),
-                                 sizeof(uint), &total);
+                                 sizeof(uint), &scan.total);
 
-    out.data = bufferAlloc(total * sizeof(uint));
+    scan.threads_x = threads_x;
+    scan.groups_x  = groups_x;
+    scan.groups_y  = groups_y;
+    return scan;
+}
 
+static inline void whereFree(WhereScan &scan) {
+    bufferFree(scan.rtmp.data);
+    bufferFree(scan.otmp.data);
+}
+
+/// Allocates the vector \p out of \p total elements of type T
+template<typename T>
+static void whereOutput(Param &out, const uint total) {
+    out.data = bufferAlloc(total * sizeof(T));
+
+    out.info.offset     = 0;
     out.info.dims[0]    = total;
     out.info.strides[0] = 1;
     for (int k = 1; k < 4; k++) {
         out.info.dims[k]    = 1;
         out.info.strides[k] = total;
     }
+}
+
+template<typename T>
+static void where(Param &out, Param &in) {
+    WhereScan scan = whereScan<T>(in);
+    whereOutput<uint>(out, scan.total);
+
+    if (scan.total > 0)
+        get_out_idx<T>(out.data, scan.otmp, scan.rtmp, in, scan.threads_x,
+                       scan.groups_x, scan.groups_y);
+
+    whereFree(scan);
+}
+
+/// Copies the values of \p in where \p mask is nonzero to the vector \p out.
+/// The positions of the values are scanned like in where, and the values are
+/// gathered by the kernel which would write their indices.
+template<typename T>
+static void compact(Param &out, Param &in, Param &mask) {
+    WhereScan scan = whereScan<char>(mask);
+    whereOutput<T>(out, scan.total);
 
-    if (total > 0)
-        get_out_idx<T>(out.data, otmp, rtmp, in, threads_x, groups_x, groups_y);
+    if (scan.total > 0)
+        compact_values<T>(out.data, scan.otmp, scan.rtmp, mask, in,
+                          scan.threads_x, scan.groups_x, scan.groups_y);
 
-    bufferFree(rtmp.data);
-    bufferFree(otmp.data);
+    whereFree(scan);
 }
 }  // namespace kernel
 }  // namespace opencl
@@ -7,17 +7,28 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
-#include <kernel/lookup.hpp>
 #include <lookup.hpp>
 
 #include <Array.hpp>
 #include <common/half.hpp>
+#include <common/jit/GatherNodeBase.hpp>
+#include <copy.hpp>
 #include <err_opencl.hpp>
+#include <traits.hpp>
 #include <af/dim4.hpp>
 
+#include <memory>
+
+using common::GatherNodeBase;
 using common::half;
+using common::Node_ptr;
+using opencl::jit::BufferNode;
+using std::make_shared;
+using std::static_pointer_cast;
 
 namespace opencl {
+using GatherNode = GatherNodeBase<BufferNode>;
+
 template<typename in_t, typename idx_t>
 Array<in_t> lookup(const Array<in_t> &input, const Array<idx_t> &indices,
                    const unsigned dim) {
@@ -28,11 +39,22 @@ Array<in_t> lookup(const Array<in_t> &input, const Array<idx_t> &indices,
         oDims[d] = (d == int(dim) ? indices.elements() : iDims[d]);
     }
 
-    Array<in_t> out = createEmptyArray<in_t>(oDims);
+    // The lookup is read through a node of the JIT tree, so it is fused into
+    // the expression which uses it instead of being gathered into a buffer
+    input.eval();
+    indices.eval();
 
-    kernel::lookup<in_t, idx_t>(out, input, indices, dim);
+    // The indices are laid along dim so they are broadcast along the other
+    // dimensions of the output
+    Array<idx_t> idx = indices.isLinear() ? indices : copyArray(indices);
+    dim4 idxDims(1);
+    idxDims[dim] = indices.elements();
+    idx.setDataDims(idxDims);
 
-    return out;
+    auto node = make_shared<GatherNode>(
+        static_cast<af::dtype>(dtype_traits<in_t>::af_type),
+        static_pointer_cast<BufferNode>(input.getNode()), idx.getNode(), dim);
+    return createNodeArray<in_t>(oDims, Node_ptr(node));
 }
 
 #define INSTANTIATE(T)                                                         \
@@ -14,31 +14,76 @@
 #include <blas.hpp>
 #include <copy.hpp>
 #include <cpu/cpu_lu.hpp>
+#include <kernel/lapack_batched.hpp>
 #include <kernel/lu_split.hpp>
 #include <magma/magma.h>
+#include <offload.hpp>
 #include <platform.hpp>
 
 namespace opencl {
 
-Array<int> convertPivot(int *ipiv, int in_sz, int out_sz) {
-    std::vector<int> out(out_sz);
+Array<int> convertPivot(int *ipiv, int in_sz, int out_sz, dim_t d2 = 1,
+                        dim_t d3 = 1) {
+    std::vector<int> out(out_sz * d2 * d3);
 
-    for (int i = 0; i < out_sz; i++) { out[i] = i; }
+    for (dim_t b = 0; b < d2 * d3; b++) {
+        int *po       = &out[b * out_sz];
+        const int *pi = &ipiv[b * in_sz];
+        for (int i = 0; i < out_sz; i++) { po[i] = i; }
 
-    for (int j = 0; j < in_sz; j++) {
-        // 1 indexed in pivot
-        std::swap(out[j], out[ipiv[j] - 1]);
+        for (int j = 0; j < in_sz; j++) {
+            // 1 indexed in pivot
+            std::swap(po[j], po[pi[j] - 1]);
+        }
     }
 
-    Array<int> res = createHostDataArray(dim4(out_sz), &out[0]);
+    Array<int> res = createHostDataArray(dim4(out_sz, 1, d2, d3), &out[0]);
 
     return res;
 }
 
+/// Factorizes the square matrices of a batch. The small matrices are
+/// factorized together by one kernel and the others one at a time by MAGMA.
+template<typename T>
+Array<int> luBatched(Array<T> &in, const bool convert_pivot) {
+    dim4 iDims = in.dims();
+    int N      = iDims[0];
+    int batch  = iDims[2] * iDims[3];
+    dim4 pdims(N, 1, iDims[2], iDims[3]);
+    std::vector<int> ipiv(N * batch);
+
+    if (N <= kernel::LAPACK_BATCHED_MAX_SIZE) {
+        Array<int> pivot = createEmptyArray<int>(pdims);
+        Array<int> info  = createEmptyArray<int>(dim4(batch));
+        kernel::getrfBatched<T>(in, pivot, info);
+
+        if (!convert_pivot) { return pivot; }
+        copyData(&ipiv[0], pivot);
+    } else {
+        cl::Buffer *in_buf = in.get();
+        int info           = 0;
+        for (dim_t w = 0; w < iDims[3]; w++) {
+            for (dim_t z = 0; z < iDims[2]; z++) {
+                dim_t offset = in.getOffset() + z * in.strides()[2] +
+                               w * in.strides()[3];
+                magma_getrf_gpu<T>(N, N, (*in_buf)(), offset, in.strides()[1],
+                                   &ipiv[(w * iDims[2] + z) * N], getQueue()(),
+                                   &info);
+            }
+        }
+
+        if (!convert_pivot) { return createHostDataArray(pdims, &ipiv[0]); }
+    }
+
+    return convertPivot(&ipiv[0], N, N, iDims[2], iDims[3]);
+}
+
 template<typename T>
 void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot,
         const Array<T> &in) {
-    if (OpenCLCPUOffload()) { return cpu::lu(lower, upper, pivot, in); }
+    if (OpenCLCPUOffload(OffloadOp::LU, in)) {
+        return cpu::lu(lower, upper, pivot, in);
+    }
 
     dim4 iDims = in.dims();
     int M      = iDims[0];
@@ -49,8 +94,8 @@ void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot,
     pivot            = lu_inplace(in_copy);
 
     // SPLIT into lower and upper
-    dim4 ldims(M, MN);
-    dim4 udims(MN, N);
+    dim4 ldims(M, MN, iDims[2], iDims[3]);
+    dim4 udims(MN, N, iDims[2], iDims[3]);
     lower = createEmptyArray<T>(ldims);
     upper = createEmptyArray<T>(udims);
     kernel::luSplit<T>(lower, upper, in_copy);
@@ -58,12 +103,17 @@ void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot,
 
 template<typename T>
 Array<int> lu_inplace(Array<T> &in, const bool convert_pivot) {
-    if (OpenCLCPUOffload()) { return cpu::lu_inplace(in, convert_pivot); }
+    if (OpenCLCPUOffload(OffloadOp::LU, in)) {
+        return cpu::lu_inplace(in, convert_pivot);
+    }
 
     dim4 iDims = in.dims();
     int M      = iDims[0];
     int N      = iDims[1];
     int MN     = std::min(M, N);
+
+    if (iDims[2] * iDims[3] > 1) { return luBatched(in, convert_pivot); }
+
     std::vector<int> ipiv(MN);
 
     cl::Buffer *in_buf = in.get();
@@ -44,15 +44,19 @@ clblasSide clblas_side_const(magma_side_t side);
 #define OPENCL_BLAS_UNIT_DIAGONAL clblasUnit
 #define OPENCL_BLAS_NON_UNIT_DIAGONAL clblasNonUnit
 
+namespace opencl {
+void initBlas();
+}
+
 // Initialization of the OpenCL BLAS library
-// Only meant to be once and from constructor
-// of DeviceManager singleton
+// Only meant to be called once, by opencl::initBlas
+// on the first call of a BLAS function
 // DONT'T CALL FROM ANY OTHER LOCATION
 inline void gpu_blas_init() { clblasSetup(); }
 
 // tear down of the OpenCL BLAS library
 // Only meant to be called from destructor
-// of DeviceManager singleton
+// of DeviceManager singleton, by opencl::deInitBlas
 // DONT'T CALL FROM ANY OTHER LOCATION
 inline void gpu_blas_deinit() {
 #ifndef OS_WIN
@@ -71,6 +75,7 @@ inline void gpu_blas_deinit() {
     struct gpu_blas_##NAME##_func<TYPE> {                            \
         template<typename... Args>                                   \
         clblasStatus operator()(Args... args) {                      \
+            opencl::initBlas();                                      \
             return clblas##PREFIX##NAME(clblasColumnMajor, args...); \
         }                                                            \
     };
@@ -111,8 +111,7 @@ struct CLBlastBasicType<cdouble> {
 };
 
 // Initialization of the OpenCL BLAS library
-// Only meant to be once and from constructor
-// of DeviceManager singleton
+// Only meant to be called once, by opencl::initBlas
 // DONT'T CALL FROM ANY OTHER LOCATION
 inline void gpu_blas_init() {
     // Nothing to do here for CLBlast
@@ -120,7 +119,7 @@ inline void gpu_blas_init() {
 
 // tear down of the OpenCL BLAS library
 // Only meant to be called from destructor
-// of DeviceManager singleton
+// of DeviceManager singleton, by opencl::deInitBlas
 // DONT'T CALL FROM ANY OTHER LOCATION
 inline void gpu_blas_deinit() {
     // Nothing to do here for CLBlast
@@ -0,0 +1,20 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <af/defines.h>
+
+namespace opencl {
+/// Computes the mean and the variance of each line of \p in along \p dim,
+/// reading the input once with Welford's algorithm. The values are weighted
+/// by \p weights, which has the dimensions of \p in, unless it is empty.
+template<typename Ti, typename To>
+void meanvar(Array<To> &mean, Array<To> &var, const Array<Ti> &in,
+             const Array<To> &weights, const af_var_bias bias, const int dim);
+}
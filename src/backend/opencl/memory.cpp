@@ -9,7 +9,10 @@
 
 #include <common/Logger.hpp>
 #include <common/MemoryManagerBase.hpp>
+#include <common/RegisteredHostMemory.hpp>
+#include <common/bfloat16.hpp>
 #include <common/half.hpp>
+#include <common/util.hpp>
 #include <err_opencl.hpp>
 #include <errorcodes.hpp>
 #include <memory.hpp>
@@ -18,6 +21,7 @@
 #include <types.hpp>
 #include <af/dim4.hpp>
 
+#include <cstring>
 #include <utility>
 
 using common::bytesToString;
@@ -77,8 +81,19 @@ void *memAllocUser(const size_t &bytes) {
     return new cl::Buffer(buf, true);
 }
 
+namespace {
+/// Freed buffers are shared between all the queues by the memory manager.
+/// When threads have their own queues, wait for the work on the queue of the
+/// calling thread so that a buffer is not reused by another queue while it
+/// is still in use.
+void waitForThreadQueue() {
+    if (hasThreadQueues()) { getQueue().finish(); }
+}
+}  // namespace
+
 template<typename T>
 void memFree(T *ptr) {
+    if (ptr) { waitForThreadQueue(); }
     cl::Buffer *buf = reinterpret_cast<cl::Buffer *>(ptr);
     cl_mem mem      = static_cast<cl_mem>((*buf)());
     delete buf;
@@ -86,6 +101,7 @@ void memFree(T *ptr) {
 }
 
 void memFreeUser(void *ptr) {
+    if (ptr) { waitForThreadQueue(); }
     cl::Buffer *buf = static_cast<cl::Buffer *>(ptr);
     cl_mem mem      = (*buf)();
     delete buf;
@@ -106,12 +122,50 @@ cl::Buffer *bufferAlloc(const size_t &bytes) {
 
 void bufferFree(cl::Buffer *buf) {
     if (buf) {
+        waitForThreadQueue();
         cl_mem mem = (*buf)();
         delete buf;
         memoryManager().unlock(static_cast<void *>(mem), false);
     }
 }
 
+bool isUnifiedMemoryEnabled() {
+    static const bool enabled = getEnvVar("AF_OPENCL_UNIFIED_MEMORY") == "1";
+    return enabled && isHostUnifiedMemory(getDevice());
+}
+
+void writeBuffer(const cl::Buffer &buf, size_t offset, size_t bytes,
+                 const void *data) {
+    if (bytes == 0) { return; }
+    cl::CommandQueue &queue = getQueue();
+    if (!isUnifiedMemoryEnabled()) {
+        queue.enqueueWriteBuffer(buf, CL_TRUE, offset, bytes, data);
+        return;
+    }
+
+    // The previous contents of the region are not needed, so the map does
+    // not read them
+    void *ptr = queue.enqueueMapBuffer(
+        buf, CL_TRUE, CL_MAP_WRITE_INVALIDATE_REGION, offset, bytes);
+    std::memcpy(ptr, data, bytes);
+    queue.enqueueUnmapMemObject(buf, ptr);
+}
+
+void readBuffer(const cl::Buffer &buf, size_t offset, size_t bytes,
+                void *data) {
+    if (bytes == 0) { return; }
+    cl::CommandQueue &queue = getQueue();
+    if (!isUnifiedMemoryEnabled()) {
+        queue.enqueueReadBuffer(buf, CL_TRUE, offset, bytes, data);
+        return;
+    }
+
+    void *ptr =
+        queue.enqueueMapBuffer(buf, CL_TRUE, CL_MAP_READ, offset, bytes);
+    std::memcpy(data, ptr, bytes);
+    queue.enqueueUnmapMemObject(buf, ptr);
+}
+
 void memLock(const cl::Buffer *ptr) {
     cl_mem mem = static_cast<cl_mem>((*ptr)());
     memoryManager().userLock(static_cast<void *>(mem));
@@ -145,6 +199,25 @@ void pinnedFree(T *ptr) {
     pinnedMemoryManager().unlock(static_cast<void *>(ptr), false);
 }
 
+size_t pinnedAllocated(const void *ptr) {
+    const size_t bytes =
+        pinnedMemoryManager().allocated(const_cast<void *>(ptr));
+    return bytes ? bytes : common::registeredHostBytes(ptr);
+}
+
+// OpenCL can not pin existing host memory. The memory is only recorded, so
+// it is written to the buffers without waiting like pinned memory, and the
+// driver stages the transfers.
+void registerHostMemory(void *ptr, const size_t bytes) {
+    common::addRegisteredHostMemory(ptr, bytes);
+}
+
+void unregisterHostMemory(void *ptr) {
+    if (!common::removeRegisteredHostMemory(ptr)) {
+        AF_ERROR("The host memory is not registered", AF_ERR_ARG);
+    }
+}
+
 #define INSTANTIATE(T)                                                         \
     template unique_ptr<cl::Buffer, function<void(cl::Buffer *)>> memAlloc<T>( \
         const size_t &elements);                                               \
@@ -165,6 +238,7 @@ INSTANTIATE(uintl)
 INSTANTIATE(short)
 INSTANTIATE(ushort)
 INSTANTIATE(common::half)
+INSTANTIATE(common::bfloat16)
 
 Allocator::Allocator() { logger = common::loggerFactory("mem"); }
 
@@ -185,11 +259,44 @@ size_t Allocator::getMaxMemorySize(int id) {
     return opencl::getDeviceMemorySize(id);
 }
 
+size_t Allocator::getFreeMemorySize(int id) {
+    return opencl::getDeviceFreeMemorySize(id);
+}
+
+void *Allocator::nativeSubAlloc(void *ptr, size_t offset, size_t bytes) {
+    cl_buffer_region region = {offset, bytes};
+    cl_int err              = CL_SUCCESS;
+    cl_mem buffer           = clCreateSubBuffer(
+        static_cast<cl_mem>(ptr), CL_MEM_READ_WRITE,
+        CL_BUFFER_CREATE_TYPE_REGION, &region, &err);
+    if (err != CL_SUCCESS) {
+        AF_ERROR("Failed to create a sub-buffer of a memory scope",
+                 AF_ERR_NO_MEM);
+    }
+    return static_cast<void *>(buffer);
+}
+
+void Allocator::nativeSubFree(void *ptr) {
+    cl_int err = clReleaseMemObject(static_cast<cl_mem>(ptr));
+    if (err != CL_SUCCESS) {
+        AF_ERROR("Failed to release device memory.", AF_ERR_RUNTIME);
+    }
+}
+
+size_t Allocator::getSubAllocAlignment() {
+    // The alignment of the sub-buffers is given in bits
+    return getDevice().getInfo<CL_DEVICE_MEM_BASE_ADDR_ALIGN>() / 8;
+}
+
 void *Allocator::nativeAlloc(const size_t bytes) {
+    // Buffers in host memory can be mapped without a copy on devices which
+    // share their memory with the host
+    cl_mem_flags flags = CL_MEM_READ_WRITE;
+    if (isUnifiedMemoryEnabled()) { flags |= CL_MEM_ALLOC_HOST_PTR; }
+
     cl_int err = CL_SUCCESS;
-    auto ptr   = static_cast<void *>(clCreateBuffer(
-        getContext()(), CL_MEM_READ_WRITE,  // NOLINT(hicpp-signed-bitwise)
-        bytes, nullptr, &err));
+    auto ptr   = static_cast<void *>(
+        clCreateBuffer(getContext()(), flags, bytes, nullptr, &err));
 
     if (err != CL_SUCCESS) {
         auto str = fmt::format("Failed to allocate device memory of size {}",
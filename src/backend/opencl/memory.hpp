@@ -36,6 +36,22 @@ template<typename T>
 void memFree(T *ptr);
 void memFreeUser(void *ptr);
 
+/// Returns true if the buffers of the active device are allocated in host
+/// memory and mapped instead of copied by readBuffer and writeBuffer. This
+/// is enabled with AF_OPENCL_UNIFIED_MEMORY on devices which share their
+/// memory with the host.
+bool isUnifiedMemoryEnabled();
+
+/// Writes \p bytes of \p data to \p buf at \p offset. Returns after
+/// \p data can be reused.
+void writeBuffer(const cl::Buffer &buf, size_t offset, size_t bytes,
+                 const void *data);
+
+/// Reads \p bytes from \p buf at \p offset into \p data. Returns after the
+/// data was read.
+void readBuffer(const cl::Buffer &buf, size_t offset, size_t bytes,
+                void *data);
+
 void memLock(const cl::Buffer *ptr);
 void memUnlock(const cl::Buffer *ptr);
 bool isLocked(const void *ptr);
@@ -45,6 +61,18 @@ T *pinnedAlloc(const size_t &elements);
 template<typename T>
 void pinnedFree(T *ptr);
 
+/// Returns the size of the pinned allocation which starts at \p ptr, or
+/// the number of bytes from \p ptr to the end of the host memory registered
+/// by registerHostMemory which holds it. Returns zero for other memory.
+size_t pinnedAllocated(const void *ptr);
+
+/// Registers \p bytes of host memory at \p ptr, so transfers from and to
+/// the memory are asynchronous like those of pinned memory
+void registerHostMemory(void *ptr, const size_t bytes);
+
+/// Unregisters the host memory registered at \p ptr
+void unregisterHostMemory(void *ptr);
+
 void deviceMemoryInfo(size_t *alloc_bytes, size_t *alloc_buffers,
                       size_t *lock_bytes, size_t *lock_buffers);
 void signalMemoryCleanup();
@@ -68,6 +96,10 @@ class Allocator final : public common::memory::AllocatorInterface {
     size_t getMaxMemorySize(int id) override;
     void *nativeAlloc(const size_t bytes) override;
     void nativeFree(void *ptr) override;
+    size_t getFreeMemorySize(int id) override;
+    void *nativeSubAlloc(void *ptr, size_t offset, size_t bytes) override;
+    void nativeSubFree(void *ptr) override;
+    size_t getSubAllocAlignment() override;
 };
 
 class AllocatorPinned final : public common::memory::AllocatorInterface {
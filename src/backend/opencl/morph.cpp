@@ -8,19 +8,51 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <copy.hpp>
 #include <err_opencl.hpp>
 #include <kernel/morph.hpp>
 #include <math.hpp>
 #include <morph.hpp>
 #include <af/dim4.hpp>
 
+#include <algorithm>
+#include <vector>
+
 using af::dim4;
 
 namespace opencl {
 
+/// Returns true if every element of the mask is set
+template<typename T>
+bool isFlatMask(const Array<T> &mask) {
+    std::vector<T> values(mask.elements());
+    copyData(values.data(), mask);
+    return std::all_of(values.begin(), values.end(),
+                       [](T value) { return value > T(0); });
+}
+
+/// Dilation or erosion with a flat mask as one pass along each dimension of
+/// the mask. Each pass costs the same for any length of the mask.
+template<typename T>
+Array<T> morphFlat(const Array<T> &in, const dim4 &mdims, int ndims,
+                   bool isDilation) {
+    Array<T> out = in;
+    for (int axis = 0; axis < ndims; ++axis) {
+        if (mdims[axis] == 1) { continue; }
+        Array<T> pass = createEmptyArray<T>(in.dims());
+        kernel::morphLine<T>(pass, out, axis, mdims[axis], isDilation);
+        out = pass;
+    }
+    return out;
+}
+
 template<typename T>
 Array<T> morph(const Array<T> &in, const Array<T> &mask, bool isDilation) {
     const dim4 mdims = mask.dims();
+    if (mdims[0] != mdims[1] || mdims[0] > 19) {
+        // Larger masks do not fit the local memory of the kernel
+        if (isFlatMask(mask)) { return morphFlat(in, mdims, 2, isDilation); }
+    }
     if (mdims[0] != mdims[1]) {
         OPENCL_NOT_SUPPORTED("Rectangular masks are not suported");
     }
@@ -36,6 +68,9 @@ Array<T> morph(const Array<T> &in, const Array<T> &mask, bool isDilation) {
 template<typename T>
 Array<T> morph3d(const Array<T> &in, const Array<T> &mask, bool isDilation) {
     const dim4 mdims = mask.dims();
+    if (mdims[0] != mdims[1] || mdims[0] != mdims[2] || mdims[0] > 7) {
+        if (isFlatMask(mask)) { return morphFlat(in, mdims, 3, isDilation); }
+    }
     if (mdims[0] != mdims[1] || mdims[0] != mdims[2]) {
         OPENCL_NOT_SUPPORTED("Only cubic masks are supported");
     }
@@ -0,0 +1,201 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <offload.hpp>
+
+#include <common/Logger.hpp>
+#include <common/util.hpp>
+#include <device_manager.hpp>
+#include <kernel/lapack_batched.hpp>
+#include <platform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using common::loggerFactory;
+using std::call_once;
+using std::max;
+using std::min;
+using std::once_flag;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::high_resolution_clock;
+
+namespace opencl {
+
+namespace {
+
+/// The block size of the panels of the MAGMA factorizations, which is
+/// between 64 and 320 depending on the type and the size
+constexpr double PANEL_SIZE = 128;
+
+/// The rates and the copies of a device, which estimate the time of the
+/// functions on the host and on the device
+struct OffloadModel {
+    double hostRate;    ///< Floating point operations per second of the host
+    double deviceRate;  ///< Floating point operations per second of the device
+    double latency;     ///< Seconds taken by a copy of a few bytes
+    double bandwidth;   ///< Bytes per second of the large copies
+    bool unified;       ///< Whether the device shares the memory of the host
+    bool gpu;           ///< Whether the device is a GPU
+};
+
+spdlog::logger *getLogger() {
+    static shared_ptr<spdlog::logger> logger(loggerFactory("platform"));
+    return logger.get();
+}
+
+/// Returns the seconds taken by a blocking write of \p bytes to \p buffer
+double timeWrite(const cl::Buffer &buffer, const vector<char> &host,
+                 const size_t bytes) {
+    auto start = high_resolution_clock::now();
+    getQueue().enqueueWriteBuffer(buffer, CL_TRUE, 0, bytes, host.data());
+    return duration<double>(high_resolution_clock::now() - start).count();
+}
+
+/// Estimates the rates of the host and of the active device from their
+/// cores and their clocks, and measures the latency and the bandwidth of the
+/// copies to the device
+OffloadModel calibrate() {
+    const cl::Device &device = getDevice();
+    OffloadModel model;
+    model.unified = isHostUnifiedMemory(device);
+    model.gpu = (device.getInfo<CL_DEVICE_TYPE>() & CL_DEVICE_TYPE_GPU) != 0;
+
+    // A GPU compute unit retires a fused multiply-add on 64 lanes per cycle
+    // and a CPU core one on 8 lanes. A host core is assumed to run two of
+    // them at 2.5 GHz. The blocked updates reach about half of the peak.
+    const double clock = device.getInfo<CL_DEVICE_MAX_CLOCK_FREQUENCY>() * 1e6;
+    const double units = device.getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();
+    const double cores = max(std::thread::hardware_concurrency(), 1u);
+    model.deviceRate   = 0.5 * units * clock * (model.gpu ? 128 : 16);
+    model.hostRate     = 0.5 * cores * 2.5e9 * 32;
+
+    // The latency is the fastest of a few small writes, and the bandwidth is
+    // measured with a write of 8 MB
+    constexpr size_t bytes = 8 << 20;
+    vector<char> host(bytes);
+    cl::Buffer buffer(getContext(), CL_MEM_READ_WRITE, bytes);
+    timeWrite(buffer, host, bytes);
+
+    model.latency = timeWrite(buffer, host, 4);
+    for (int i = 0; i < 4; ++i) {
+        model.latency = min(model.latency, timeWrite(buffer, host, 4));
+    }
+    const double copy = timeWrite(buffer, host, bytes) - model.latency;
+    model.bandwidth   = bytes / max(copy, 1e-6);
+
+    AF_TRACE(
+        "CPU offload model: {{ host: {:.0f} GFLOPS, device: {:.0f} GFLOPS, "
+        "latency: {:.1f} us, bandwidth: {:.1f} GB/s, unified: {} }}",
+        model.hostRate * 1e-9, model.deviceRate * 1e-9, model.latency * 1e6,
+        model.bandwidth * 1e-9, model.unified);
+    return model;
+}
+
+/// Returns the model of the active device, which is calibrated on its first
+/// use
+const OffloadModel &getOffloadModel() {
+    static once_flag flags[DeviceManager::MAX_DEVICES];
+    static OffloadModel models[DeviceManager::MAX_DEVICES];
+
+    const unsigned id = getActiveDeviceId();
+    call_once(flags[id], [id] { models[id] = calibrate(); });
+    return models[id];
+}
+
+/// Returns the floating point operations of \p op, counting a complex one
+/// as one operation
+double flops(const OffloadOp op, const double m, const double n,
+             const double k) {
+    const double lo = min(m, n);
+    const double hi = max(m, n);
+    switch (op) {
+        case OffloadOp::Cholesky: return n * n * n / 3;
+        case OffloadOp::LU: return hi * lo * lo - lo * lo * lo / 3;
+        case OffloadOp::QR: return 2 * hi * lo * lo - 2 * lo * lo * lo / 3;
+        case OffloadOp::SVD: return 4 * hi * lo * lo + 8 * lo * lo * lo;
+        case OffloadOp::Solve:
+            return hi * lo * lo - lo * lo * lo / 3 + 2 * m * n * k;
+        case OffloadOp::Inverse: return 2 * n * n * n;
+        case OffloadOp::Gemm: return 2 * m * n * k;
+    }
+    return 0;
+}
+
+double typeSize(const af_dtype type) {
+    switch (type) {
+        case f64:
+        case c32: return 8;
+        case c64: return 16;
+        default: return 4;
+    }
+}
+
+}  // namespace
+
+bool OpenCLCPUOffload(OffloadOp op, af_dtype type, dim_t m, dim_t n, dim_t k,
+                      dim_t batch) {
+    static const string mode = getEnvVar("AF_OPENCL_CPU_OFFLOAD");
+    const bool lapack        = op != OffloadOp::Gemm;
+    if (mode == "0" || mode == "1") { return OpenCLCPUOffload(lapack); }
+#if OS_MAC
+    // The LAPACK functions are always offloaded on OSX unified memory
+    // devices, see OpenCLCPUOffload
+    if (lapack && isHostUnifiedMemory(getDevice())) { return true; }
+#endif
+    if (m * n * batch == 0) { return false; }
+
+    const OffloadModel &model = getOffloadModel();
+    const bool isDouble       = type == f64 || type == c64;
+    const bool isComplex      = type == c32 || type == c64;
+
+    // A complex operation takes four real ones. The double precision rate of
+    // the GPUs is assumed to be a quarter of the single precision one.
+    const double ops        = batch * flops(op, m, n, k) * (isComplex ? 4 : 1);
+    const double hostRate   = model.hostRate / (isDouble ? 2 : 1);
+    const double deviceRate =
+        model.deviceRate / (isDouble ? (model.gpu ? 4 : 2) : 1);
+
+    // The offloaded functions map the matrices to the host and back, which
+    // copies them unless the memory is unified
+    const double size  = typeSize(type);
+    const double bytes = batch * size * (m * n + (lapack ? m : m + n) * k);
+    const double hostTime =
+        ops / hostRate +
+        (model.unified ? 0 : 2 * (model.latency + bytes / model.bandwidth));
+
+    // The MAGMA functions copy each panel of a matrix to the host and back,
+    // and launch a few kernels for the update of the rest of the matrix. The
+    // batched kernels factorize the small matrices of a batch at once.
+    double deviceTime = ops / deviceRate + model.latency;
+    const bool batched =
+        batch > 1 && max(m, n) <= kernel::LAPACK_BATCHED_MAX_SIZE &&
+        (op == OffloadOp::Cholesky || op == OffloadOp::LU ||
+         op == OffloadOp::Solve);
+    if (lapack && !batched) {
+        const double panels = std::ceil(min(m, n) / PANEL_SIZE);
+        const double panel  = 2 * m * min<double>(n, PANEL_SIZE) * size;
+        deviceTime += batch * panels *
+                      (4 * model.latency +
+                       (model.unified ? 0 : panel / model.bandwidth));
+    }
+
+    return hostTime < deviceTime;
+}
+
+}  // namespace opencl
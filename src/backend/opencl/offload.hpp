@@ -0,0 +1,49 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Array.hpp>
+#include <traits.hpp>
+#include <af/defines.h>
+
+namespace opencl {
+
+/// The functions which can be offloaded to the CPU backend
+enum class OffloadOp { Cholesky, LU, QR, SVD, Solve, Inverse, Gemm };
+
+/// Returns true when \p op on a batch of \p batch \p m x \p n matrices of
+/// \p type is expected to be faster with the CPU backend, on buffers mapped
+/// to the host, than on the device. \p k is the number of columns of the
+/// right hand side of \ref OffloadOp::Solve and the inner dimension of
+/// \ref OffloadOp::Gemm, and is ignored by the other functions.
+///
+/// The device runs the MAGMA functions, which factorize the panels of the
+/// matrices on the host and update the rest of the matrices on the device,
+/// or the batched kernels for batches of small matrices. The times are
+/// estimated from the floating point operations of \p op, the rates of the
+/// host and of the device, and the latency and the bandwidth of the copies
+/// between them, which are measured on the first call for each device.
+///
+/// AF_OPENCL_CPU_OFFLOAD=0 disables the offload and AF_OPENCL_CPU_OFFLOAD=1
+/// offloads every call on the devices with unified memory, as
+/// OpenCLCPUOffload does.
+bool OpenCLCPUOffload(OffloadOp op, af_dtype type, dim_t m, dim_t n,
+                      dim_t k = 0, dim_t batch = 1);
+
+/// Returns OpenCLCPUOffload for \p op on the matrices of \p in, which are
+/// batched along its third and fourth dimensions
+template<typename T>
+bool OpenCLCPUOffload(OffloadOp op, const Array<T> &in, const dim_t k = 0) {
+    const af::dim4 &dims = in.dims();
+    return OpenCLCPUOffload(op, static_cast<af_dtype>(dtype_traits<T>::af_type),
+                            dims[0], dims[1], k, dims[2] * dims[3]);
+}
+
+}  // namespace opencl
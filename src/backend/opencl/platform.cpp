@@ -13,6 +13,7 @@
 
 #include <GraphicsResourceManager.hpp>
 #include <blas.hpp>
+#include <clblast_tuning.hpp>
 #include <clfft.hpp>
 #include <common/DefaultMemoryManager.hpp>
 #include <common/Logger.hpp>
@@ -21,6 +22,7 @@
 #include <device_manager.hpp>
 #include <err_opencl.hpp>
 #include <errorcodes.hpp>
+#include <profiled_launch.hpp>
 #include <version.hpp>
 #include <af/version.h>
 #include <memory>
@@ -33,6 +35,7 @@
 #include <boost/compute/utility/program_cache.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cstring>
 #include <functional>
@@ -67,6 +70,11 @@ using std::vector;
 
 using common::memory::MemoryManagerBase;
 
+// From cl_ext.h of the AMD platforms
+#ifndef CL_DEVICE_GLOBAL_FREE_MEMORY_AMD
+#define CL_DEVICE_GLOBAL_FREE_MEMORY_AMD 0x4039
+#endif
+
 namespace opencl {
 
 static string get_system() {
@@ -271,9 +279,45 @@ const Context& getContext() {
     return *(devMngr.mContexts[get<0>(devId)]);
 }
 
+namespace {
+/// The number of queues bound to threads in the process
+std::atomic<int> boundQueueCount{0};
+
+/// The queues bound to the calling thread. A null queue means the thread uses
+/// the queue of the device shared by all the threads.
+struct ThreadQueues {
+    CommandQueue queues[DeviceManager::MAX_DEVICES];
+
+    void bind(int device, CommandQueue queue) {
+        // The buffers used by the work on the previous queue may be freed
+        // later without waiting for it
+        if (queues[device]()) {
+            queues[device].finish();
+            boundQueueCount--;
+        }
+        queues[device] = std::move(queue);
+        if (queues[device]()) { boundQueueCount++; }
+    }
+
+    ~ThreadQueues() {
+        for (auto& queue : queues) {
+            if (queue()) { boundQueueCount--; }
+        }
+    }
+};
+
+ThreadQueues& threadQueues() {
+    thread_local ThreadQueues tqueues;
+    return tqueues;
+}
+}  // namespace
+
 CommandQueue& getQueue() {
     device_id_t& devId = tlocalActiveDeviceId();
 
+    CommandQueue& tqueue = threadQueues().queues[get<1>(devId)];
+    if (tqueue()) { return tqueue; }
+
     DeviceManager& devMngr = DeviceManager::getInstance();
 
     common::lock_guard_t lock(devMngr.deviceMutex);
@@ -305,6 +349,28 @@ size_t getDeviceMemorySize(int device) {
     return msize;
 }
 
+size_t getDeviceFreeMemorySize(int device) {
+    DeviceManager& devMngr = DeviceManager::getInstance();
+
+    cl::Device dev;
+    {
+        common::lock_guard_t lock(devMngr.deviceMutex);
+        dev = *devMngr.mDevices[device];
+    }
+    const string extensions = dev.getInfo<CL_DEVICE_EXTENSIONS>();
+    if (extensions.find("cl_amd_device_attribute_query") == string::npos) {
+        return 0;
+    }
+
+    // The total and the largest free block in KB
+    size_t freeKB[2] = {0, 0};
+    if (clGetDeviceInfo(dev(), CL_DEVICE_GLOBAL_FREE_MEMORY_AMD,
+                        sizeof(freeKB), freeKB, nullptr) != CL_SUCCESS) {
+        return 0;
+    }
+    return freeKB[0] * 1024;
+}
+
 size_t getHostMemorySize() { return common::getHostMemorySize(); }
 
 cl_device_type getDeviceType() {
@@ -388,6 +454,20 @@ bool isHalfSupported(unsigned device) {
     }
 }
 
+bool isSubgroupShuffleSupported(unsigned device) {
+    DeviceManager& devMngr = DeviceManager::getInstance();
+
+    cl::Device dev;
+    {
+        common::lock_guard_t lock(devMngr.deviceMutex);
+        dev = *devMngr.mDevices[device];
+    }
+
+    const string extensions = dev.getInfo<CL_DEVICE_EXTENSIONS>();
+    return extensions.find("cl_khr_subgroups") != string::npos &&
+           extensions.find("cl_khr_subgroup_shuffle") != string::npos;
+}
+
 void devprop(char* d_name, char* d_platform, char* d_toolkit, char* d_compute) {
     unsigned nDevices    = 0;
     auto currActiveDevId = static_cast<unsigned>(getActiveDeviceId());
@@ -459,6 +539,38 @@ int setDevice(int device) {
     }
 }
 
+void setThreadQueue(cl_command_queue queue) {
+    ThreadQueues& tqueues = threadQueues();
+    const int device      = getActiveDeviceId();
+    if (queue == NULL) {
+        tqueues.bind(device, CommandQueue());
+        return;
+    }
+
+    CommandQueue newQueue(queue, true);
+    if (newQueue.getInfo<CL_QUEUE_CONTEXT>()() != getContext()() ||
+        newQueue.getInfo<CL_QUEUE_DEVICE>()() != getDevice()()) {
+        AF_ERROR("The queue does not belong to the active device and context",
+                 AF_ERR_ARG);
+    }
+    // The kernels and copies of ArrayFire rely on the order of the queue
+    if (newQueue.getInfo<CL_QUEUE_PROPERTIES>() &
+        CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE) {
+        AF_ERROR("Out of order queues cannot be used by ArrayFire",
+                 AF_ERR_NOT_SUPPORTED);
+    }
+    tqueues.bind(device, std::move(newQueue));
+}
+
+bool hasThreadQueues() { return boundQueueCount > 0; }
+
+cl_command_queue createQueue() {
+    CommandQueue queue(getContext(), getDevice(), getQueueProperties());
+    // Ownership of the queue is passed to the caller
+    clRetainCommandQueue(queue());
+    return queue();
+}
+
 void sync(int device) {
     int currDevice = getActiveDeviceId();
     setDevice(device);
@@ -476,12 +588,14 @@ void addDeviceContext(cl_device_id dev, cl_context ctx, cl_command_queue que) {
         auto tDevice  = make_unique<cl::Device>(dev, true);
         auto tContext = make_unique<cl::Context>(ctx, true);
         auto tQueue =
-            (que == NULL ? make_unique<cl::CommandQueue>(*tContext, *tDevice)
+            (que == NULL ? make_unique<cl::CommandQueue>(
+                               *tContext, *tDevice, getQueueProperties())
                          : make_unique<cl::CommandQueue>(que, true));
         devMngr.mPlatforms.push_back(getPlatformEnum(*tDevice));
         // FIXME: add OpenGL Interop for user provided contexts later
         devMngr.mIsGLSharingOn.push_back(false);
         devMngr.mDeviceTypes.push_back(tDevice->getInfo<CL_DEVICE_TYPE>());
+        applyBlasTuning(*tDevice);
 
         devMngr.mDevices.push_back(move(tDevice));
         devMngr.mContexts.push_back(move(tContext));
@@ -680,6 +794,8 @@ GraphicsResourceManager& interopManager() {
 PlanCache& fftManager() {
     thread_local PlanCache clfftManagers[DeviceManager::MAX_DEVICES];
 
+    DeviceManager::getInstance().setupFFT();
+
     return clfftManagers[getActiveDeviceId()];
 }
 
@@ -721,6 +837,22 @@ af_err afcl_get_queue(cl_command_queue* queue, const bool retain) {
     return AF_SUCCESS;
 }
 
+af_err afcl_set_queue(cl_command_queue queue) {
+    try {
+        setThreadQueue(queue);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err afcl_create_queue(cl_command_queue* queue) {
+    try {
+        *queue = createQueue();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
 af_err afcl_get_device_id(cl_device_id* id) {
     try {
         *id = getDevice()();
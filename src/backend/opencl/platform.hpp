@@ -63,10 +63,27 @@ const cl::Context& getContext();
 
 cl::CommandQueue& getQueue();
 
+/// Binds \p queue to the calling thread for the active device. The kernels
+/// and copies issued by the thread on the device are enqueued on \p queue.
+/// A null queue restores the queue shared by all threads.
+void setThreadQueue(cl_command_queue queue);
+
+/// Returns true if any thread has a queue bound using setThreadQueue
+bool hasThreadQueues();
+
+/// Creates a new in-order queue on the active device and context. The caller
+/// owns the returned queue.
+cl_command_queue createQueue();
+
 const cl::Device& getDevice(int id = -1);
 
 size_t getDeviceMemorySize(int device);
 
+/// Returns the free memory of \p device, which counts the memory used by
+/// other processes, or 0 when the platform does not report it. Only the AMD
+/// platforms report it.
+size_t getDeviceFreeMemorySize(int device);
+
 size_t getHostMemorySize();
 
 cl_device_type getDeviceType();
@@ -82,6 +99,9 @@ bool isDoubleSupported(unsigned device);
 // Returns true if 16-bit precision floats are supported by the device
 bool isHalfSupported(unsigned device);
 
+// Returns true if the device supports the cl_khr_subgroup_shuffle functions
+bool isSubgroupShuffleSupported(unsigned device);
+
 void devprop(char* d_name, char* d_platform, char* d_toolkit, char* d_compute);
 
 std::string getPlatformName(const cl::Device& device);
@@ -11,21 +11,23 @@
 #include <GraphicsResourceManager.hpp>
 #include <debug_opencl.hpp>
 #include <err_opencl.hpp>
+#include <kernel/interleave.hpp>
 #include <plot.hpp>
 
+#include <vector>
+
 using af::dim4;
+using std::vector;
 
 namespace opencl {
 
 template<typename T>
-void copy_plot(const Array<T> &P, fg_plot plot) {
+void copy_plot(const vector<Array<T>> &components, fg_plot plot) {
     ForgeModule &_ = graphics::forgePlugin();
+    vector<Param> params(components.begin(), components.end());
+    cl::CommandQueue &queue = interopManager().beginCopy();
     if (isGLSharingSupported()) {
         CheckGL("Begin OpenCL resource copy");
-        const cl::Buffer *d_P = P.get();
-        unsigned bytes        = 0;
-        FG_CHECK(_.fg_get_plot_vertex_buffer_size(&bytes, plot));
-
         auto res = interopManager().getPlotResources(plot);
 
         std::vector<cl::Memory> shared_objects;
@@ -37,16 +39,19 @@ void copy_plot(const Array<T> &P, fg_plot plot) {
         // https://www.khronos.org/registry/cl/sdk/1.1/docs/man/xhtml/clEnqueueReleaseGLObjects.html
         cl::Event event;
 
-        getQueue().enqueueAcquireGLObjects(&shared_objects, NULL, &event);
+        queue.enqueueAcquireGLObjects(&shared_objects, NULL, &event);
         event.wait();
-        getQueue().enqueueCopyBuffer(*d_P, *(res[0].get()), 0, 0, bytes, NULL,
-                                     &event);
-        getQueue().enqueueReleaseGLObjects(&shared_objects, NULL, &event);
+        kernel::interleave<T>(*(res[0].get()), params, queue);
+        queue.enqueueReleaseGLObjects(&shared_objects, NULL, &event);
         event.wait();
 
-        CL_DEBUG_FINISH(getQueue());
+        CL_DEBUG_FINISH(queue);
         CheckGL("End OpenCL resource copy");
     } else {
+        Array<T> P = createEmptyArray<T>(
+            dim4(params.size() * components[0].elements()));
+        kernel::interleave<T>(*P.get(), params, queue);
+
         unsigned bytes = 0, buffer = 0;
         FG_CHECK(_.fg_get_plot_vertex_buffer(&buffer, plot));
         FG_CHECK(_.fg_get_plot_vertex_buffer_size(&bytes, plot));
@@ -56,7 +61,7 @@ void copy_plot(const Array<T> &P, fg_plot plot) {
         auto *ptr =
             static_cast<GLubyte *>(glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY));
         if (ptr) {
-            getQueue().enqueueReadBuffer(*P.get(), CL_TRUE, 0, bytes, ptr);
+            queue.enqueueReadBuffer(*P.get(), CL_TRUE, 0, bytes, ptr);
             glUnmapBuffer(GL_ARRAY_BUFFER);
         }
         glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -64,7 +69,8 @@ void copy_plot(const Array<T> &P, fg_plot plot) {
     }
 }
 
-#define INSTANTIATE(T) template void copy_plot<T>(const Array<T> &, fg_plot);
+#define INSTANTIATE(T)                                             \
+    template void copy_plot<T>(const vector<Array<T>> &, fg_plot);
 
 INSTANTIATE(float)
 INSTANTIATE(double)
@@ -7,9 +7,11 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <common/bfloat16.hpp>
 #include <common/half.hpp>
 #include "reduce_impl.hpp"
 
+using common::bfloat16;
 using common::half;
 
 namespace opencl {
@@ -27,4 +29,5 @@ INSTANTIATE(af_mul_t, uchar, uint)
 INSTANTIATE(af_mul_t, short, int)
 INSTANTIATE(af_mul_t, ushort, uint)
 INSTANTIATE(af_mul_t, half, float)
+INSTANTIATE(af_mul_t, bfloat16, float)
 }  // namespace opencl
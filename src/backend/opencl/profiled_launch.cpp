@@ -0,0 +1,127 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <profiled_launch.hpp>
+
+#include <common/Profiler.hpp>
+#include <platform.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+using common::addProfileEvent;
+using common::getProfiledFunction;
+using common::getProfiledName;
+using common::isProfiling;
+using common::ProfileEvent;
+using common::profileClock;
+using std::lock_guard;
+using std::mutex;
+using std::vector;
+
+namespace opencl {
+
+namespace {
+
+/// A launch which was not completed yet
+struct PendingLaunch {
+    cl::Event event;
+    /// The host time at which the launch was enqueued
+    double enqueued;
+    ProfileEvent profile;
+};
+
+struct ProfiledLaunches {
+    mutex launchesMutex;
+    vector<PendingLaunch> pending;
+};
+
+ProfiledLaunches& getProfiledLaunches() {
+    // Never released, so the pending launches can be flushed when the
+    // profiler writes its timeline at exit
+    static auto* launches = new ProfiledLaunches();
+    return *launches;
+}
+
+/// Adds the completed launches to the timeline of the profiler. If \p wait
+/// is true, the launches which are still running are waited for.
+void resolveLaunches(ProfiledLaunches& launches, bool wait) {
+    auto resolved = [wait](PendingLaunch& launch) {
+        try {
+            if (wait) {
+                launch.event.wait();
+            } else if (launch.event
+                           .getInfo<CL_EVENT_COMMAND_EXECUTION_STATUS>() !=
+                       CL_COMPLETE) {
+                return false;
+            }
+            // The device timestamps are in nanoseconds. The start of the
+            // launch is placed on the host timeline by its queued time.
+            cl_ulong queued =
+                launch.event.getProfilingInfo<CL_PROFILING_COMMAND_QUEUED>();
+            cl_ulong start =
+                launch.event.getProfilingInfo<CL_PROFILING_COMMAND_START>();
+            cl_ulong end =
+                launch.event.getProfilingInfo<CL_PROFILING_COMMAND_END>();
+            launch.profile.start =
+                launch.enqueued + static_cast<double>(start - queued) * 1e-3;
+            launch.profile.duration = static_cast<double>(end - start) * 1e-3;
+            addProfileEvent(std::move(launch.profile));
+        } catch (const cl::Error&) {
+            // The launch failed and is dropped from the timeline
+        }
+        return true;
+    };
+    auto& pending = launches.pending;
+    pending.erase(std::remove_if(pending.begin(), pending.end(), resolved),
+                  pending.end());
+}
+
+}  // namespace
+
+cl_command_queue_properties getQueueProperties() {
+    return isProfiling() ? CL_QUEUE_PROFILING_ENABLE : 0;
+}
+
+void addProfiledLaunch(const cl::Event& event, const cl::Kernel& kernel) {
+    if (!isProfiling()) { return; }
+
+    const double enqueued = profileClock();
+    ProfileEvent profile{kernel.getInfo<CL_KERNEL_FUNCTION_NAME>(),
+                         getProfiledFunction(),
+                         getProfiledName(kernel.getInfo<CL_KERNEL_PROGRAM>()()),
+                         getActiveDeviceId(), enqueued, 0.0};
+
+    // The queues passed by the user may not record timestamps
+    cl::CommandQueue queue = event.getInfo<CL_EVENT_COMMAND_QUEUE>();
+    if (!(queue.getInfo<CL_QUEUE_PROPERTIES>() & CL_QUEUE_PROFILING_ENABLE)) {
+        event.wait();
+        profile.duration = profileClock() - enqueued;
+        addProfileEvent(std::move(profile));
+        return;
+    }
+
+    ProfiledLaunches& launches = getProfiledLaunches();
+    static std::once_flag flushFlag;
+    std::call_once(flushFlag, [&launches]() {
+        common::setProfileFlush([&launches]() {
+            lock_guard<mutex> lock(launches.launchesMutex);
+            resolveLaunches(launches, true);
+        });
+    });
+
+    lock_guard<mutex> lock(launches.launchesMutex);
+    launches.pending.push_back({event, enqueued, std::move(profile)});
+    resolveLaunches(launches, false);
+}
+
+}  // namespace opencl
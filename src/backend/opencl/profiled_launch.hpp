@@ -0,0 +1,32 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <cl2hpp.hpp>
+
+namespace opencl {
+
+/// Returns the properties of the queues created by ArrayFire. The queues
+/// record the timestamps of their commands if the launches are profiled
+/// (see AF_PROFILE).
+cl_command_queue_properties getQueueProperties();
+
+/// Records a kernel launch if the launches are profiled
+///
+/// The launch is added to the timeline of the profiler once it completes,
+/// with the time measured by the profiling info of \p event. If the queue
+/// was created without CL_QUEUE_PROFILING_ENABLE, the launch is waited for
+/// and measured on the host instead.
+///
+/// \param[in] event the event of the launch
+/// \param[in] kernel the kernel which was launched
+void addProfiledLaunch(const cl::Event& event, const cl::Kernel& kernel);
+
+}  // namespace opencl
@@ -21,13 +21,16 @@
 #include <magma/magma.h>
 #include <magma/magma_data.h>
 #include <magma/magma_helper.h>
+#include <offload.hpp>
 #include <platform.hpp>
 
 namespace opencl {
 
 template<typename T>
 void qr(Array<T> &q, Array<T> &r, Array<T> &t, const Array<T> &orig) {
-    if (OpenCLCPUOffload()) { return cpu::qr(q, r, t, orig); }
+    if (OpenCLCPUOffload(OffloadOp::QR, orig)) {
+        return cpu::qr(q, r, t, orig);
+    }
 
     const dim4 NullShape(0, 0, 0, 0);
 
@@ -79,7 +82,7 @@ void qr(Array<T> &q, Array<T> &r, Array<T> &t, const Array<T> &orig) {
 
 template<typename T>
 Array<T> qr_inplace(Array<T> &in) {
-    if (OpenCLCPUOffload()) { return cpu::qr_inplace(in); }
+    if (OpenCLCPUOffload(OffloadOp::QR, in)) { return cpu::qr_inplace(in); }
 
     dim4 iDims = in.dims();
     int M      = iDims[0];
@@ -9,9 +9,15 @@
 
 #include <Array.hpp>
 #include <common/half.hpp>
+#include <common/jit/RandomNode.hpp>
+#include <kernel/random_distributions.hpp>
 #include <kernel/random_engine.hpp>
 #include <af/dim4.hpp>
 
+#include <memory>
+#include <type_traits>
+#include <vector>
+
 using common::half;
 
 namespace opencl {
@@ -20,16 +26,56 @@ void initMersenneState(Array<uint> &state, const uintl seed,
     kernel::initMersenneState(*state.get(), *tbl.get(), seed);
 }
 
+void initMersenneStates(std::vector<Array<uint>> &states,
+                        const std::vector<uintl> &seeds,
+                        const Array<uint> &tbl) {
+    // The kernels of OpenCL 1.2 cannot take an array of buffers, so each
+    // state is initialized by its own launch of the cached kernel
+    for (size_t i = 0; i < states.size(); ++i) {
+        kernel::initMersenneState(*states[i].get(), *tbl.get(), seeds[i]);
+    }
+}
+
+/// Generates a uniform array of a counter based engine with its kernel
 template<typename T>
-Array<T> uniformDistribution(const af::dim4 &dims,
-                             const af_random_engine_type type,
-                             const uintl &seed, uintl &counter) {
+Array<T> uniformKernelArray(const af::dim4 &dims,
+                            const af_random_engine_type type,
+                            const uintl &seed, uintl &counter) {
     Array<T> out = createEmptyArray<T>(dims);
     kernel::uniformDistributionCBRNG<T>(*out.get(), out.elements(), type, seed,
                                         counter);
     return out;
 }
 
+/// Floating point arrays of the Philox engine are generated by the JIT
+/// kernels which use them. Their values are the ones written by the kernel.
+template<typename T>
+typename std::enable_if<std::is_floating_point<T>::value, Array<T>>::type
+uniformCBRNG(const af::dim4 &dims, const af_random_engine_type type,
+             const uintl &seed, uintl &counter) {
+    if (type != AF_RANDOM_ENGINE_PHILOX_4X32_10) {
+        return uniformKernelArray<T>(dims, type, seed, counter);
+    }
+    Array<T> out = createNodeArray<T>(
+        dims, std::make_shared<common::RandomNode<T>>(seed, counter));
+    counter += dims.elements();
+    return out;
+}
+
+template<typename T>
+typename std::enable_if<!std::is_floating_point<T>::value, Array<T>>::type
+uniformCBRNG(const af::dim4 &dims, const af_random_engine_type type,
+             const uintl &seed, uintl &counter) {
+    return uniformKernelArray<T>(dims, type, seed, counter);
+}
+
+template<typename T>
+Array<T> uniformDistribution(const af::dim4 &dims,
+                             const af_random_engine_type type,
+                             const uintl &seed, uintl &counter) {
+    return uniformCBRNG<T>(dims, type, seed, counter);
+}
+
 template<typename T>
 Array<T> normalDistribution(const af::dim4 &dims,
                             const af_random_engine_type type, const uintl &seed,
@@ -64,6 +110,16 @@ Array<T> normalDistribution(const af::dim4 &dims, Array<uint> pos,
     return out;
 }
 
+template<typename T>
+Array<T> randomDistribution(const AF_RANDOM_DIST dist, const Array<T> &param0,
+                            const Array<T> &param1, const uintl seed,
+                            uintl &counter) {
+    Array<T> out = createEmptyArray<T>(param0.dims());
+    kernel::randomDistribution<T>(*out.get(), *param0.get(), *param1.get(),
+                                  out.elements(), dist, seed, counter);
+    return out;
+}
+
 #define INSTANTIATE_UNIFORM(T)                                   \
     template Array<T> uniformDistribution<T>(                    \
         const af::dim4 &dims, const af_random_engine_type type,  \
@@ -152,4 +208,12 @@ COMPLEX_UNIFORM_DISTRIBUTION(cfloat, float)
 COMPLEX_NORMAL_DISTRIBUTION(cdouble, double)
 COMPLEX_NORMAL_DISTRIBUTION(cfloat, float)
 
+#define INSTANTIATE_DISTRIBUTION(T)                                            \
+    template Array<T> randomDistribution<T>(                                   \
+        const AF_RANDOM_DIST dist, const Array<T> &param0,                     \
+        const Array<T> &param1, const uintl seed, uintl &counter);
+
+INSTANTIATE_DISTRIBUTION(float)
+INSTANTIATE_DISTRIBUTION(double)
+
 }  // namespace opencl
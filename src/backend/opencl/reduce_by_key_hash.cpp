@@ -0,0 +1,69 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <common/Binary.hpp>
+#include <common/hash_reduce.hpp>
+#include <copy.hpp>
+#include <err_opencl.hpp>
+#include <kernel/reduce_by_key_hash.hpp>
+#include <reduce.hpp>
+#include <af/dim4.hpp>
+
+using af::dim4;
+using common::Binary;
+
+namespace opencl {
+
+template<af_op_t op, typename Ti, typename Tk, typename To>
+bool reduce_by_key_hash(Array<Tk> &keys_out, Array<To> &vals_out,
+                        const Array<Tk> &keys, const Array<Ti> &vals) {
+    const dim_t n     = keys.elements();
+    const dim_t slots = common::hashReduceSlots(n);
+
+    // The kernel reads the buffers from their first element
+    const Array<Tk> ikeys = keys.isLinear() && keys.getOffset() == 0
+                                ? keys
+                                : copyArray<Tk>(keys);
+    const Array<Ti> ivals = vals.isLinear() && vals.getOffset() == 0
+                                ? vals
+                                : copyArray<Ti>(vals);
+
+    Array<Tk> tableKeys =
+        createValueArray<Tk>(dim4(slots + 1), common::hashReduceEmptyKey<Tk>());
+    Array<To> tableVals =
+        createValueArray<To>(dim4(slots + 1), Binary<To, op>::init());
+    Array<uint> flags = createValueArray<uint>(dim4(2), 0);
+
+    const common::HashReduceTable<Tk, To> table =
+        kernel::reduceByKeyHash<op, Ti, Tk, To>(
+            *tableKeys.get(), *tableVals.get(), *flags.get(), *ikeys.get(),
+            *ivals.get(), n, slots);
+    return common::hashReduceOutputs(keys_out, vals_out, table);
+}
+
+#define INSTANTIATE(op, Tk, T)                                          \
+    template bool reduce_by_key_hash<op, T, Tk, T>(                     \
+        Array<Tk> &keys_out, Array<T> &vals_out, const Array<Tk> &keys, \
+        const Array<T> &vals);
+
+#define INSTANTIATE_KEYS(op, T) \
+    INSTANTIATE(op, int, T)     \
+    INSTANTIATE(op, uint, T)
+
+#define INSTANTIATE_OP(op)      \
+    INSTANTIATE_KEYS(op, float) \
+    INSTANTIATE_KEYS(op, int)   \
+    INSTANTIATE_KEYS(op, uint)
+
+INSTANTIATE_OP(af_add_t)
+INSTANTIATE_OP(af_min_t)
+INSTANTIATE_OP(af_max_t)
+
+}  // namespace opencl
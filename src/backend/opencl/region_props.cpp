@@ -0,0 +1,46 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <common/region_stats.hpp>
+#include <err_opencl.hpp>
+#include <kernel/region_props.hpp>
+#include <region_props.hpp>
+#include <af/dim4.hpp>
+
+using af::dim4;
+
+namespace opencl {
+
+template<typename T>
+Array<float> regionProps(const Array<T> &labels, const unsigned nlabels) {
+    Array<float> out =
+        createEmptyArray<float>(dim4(common::REGION_PROP_COUNT, nlabels));
+    if (nlabels == 0) { return out; }
+
+    Array<uint> acc = createValueArray<uint>(
+        dim4(kernel::REGION_ACC_WORDS, nlabels), uint(0));
+
+    kernel::regionSums<T>(acc, labels, static_cast<int>(nlabels));
+    kernel::regionProps(out, acc);
+    return out;
+}
+
+#define INSTANTIATE(T)                                            \
+    template Array<float> regionProps<T>(const Array<T> &labels, \
+                                         const unsigned nlabels);
+
+INSTANTIATE(float)
+INSTANTIATE(double)
+INSTANTIATE(int)
+INSTANTIATE(uint)
+INSTANTIATE(short)
+INSTANTIATE(ushort)
+
+}  // namespace opencl
@@ -14,4 +14,11 @@ namespace opencl {
 template<typename T>
 Array<T> regions(const Array<char> &in, af_connectivity connectivity);
 
+/// Labels the regions and computes five statistics of each one: the area,
+/// the first row and column and the last row and column of its bounding
+/// box. Region i is described by column i - 1 of \p stats.
+template<typename T>
+Array<T> regions(const Array<char> &in, af_connectivity connectivity,
+                 Array<uint> &stats);
+
 }
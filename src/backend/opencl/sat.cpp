@@ -0,0 +1,38 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <sat.hpp>
+
+#include <Array.hpp>
+#include <err_opencl.hpp>
+#include <kernel/sat.hpp>
+#include <types.hpp>
+
+namespace opencl {
+template<typename Ti, typename To>
+Array<To> sat(const Array<Ti> &in) {
+    Array<To> out = createEmptyArray<To>(in.dims());
+    if (in.elements() != 0) { kernel::sat<Ti, To>(out, in); }
+    return out;
+}
+
+#define INSTANTIATE(Ti, To) \
+    template Array<To> sat<Ti, To>(const Array<Ti> &in);
+
+INSTANTIATE(double, double)
+INSTANTIATE(float, float)
+INSTANTIATE(int, int)
+INSTANTIATE(uint, uint)
+INSTANTIATE(char, int)
+INSTANTIATE(uchar, uint)
+INSTANTIATE(intl, intl)
+INSTANTIATE(uintl, uintl)
+INSTANTIATE(short, int)
+INSTANTIATE(ushort, uint)
+}  // namespace opencl
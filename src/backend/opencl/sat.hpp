@@ -0,0 +1,19 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Array.hpp>
+
+namespace opencl {
+/// Computes the summed-area table of each 2D slice of \p in, the sums of the
+/// values above and to the left of each value, including the value
+template<typename Ti, typename To>
+Array<To> sat(const Array<Ti> &in);
+}  // namespace opencl
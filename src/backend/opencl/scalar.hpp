@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#pragma once
 #include <Array.hpp>
 #include <common/jit/ScalarNode.hpp>
 #include <math.hpp>
@@ -17,7 +18,7 @@ namespace opencl {
 template<typename T>
 Array<T> createScalarNode(const dim4 &size, const T val) {
     return createNodeArray<T>(size,
-                              std::make_shared<common::ScalarNode<T>>(val));
+                              common::makePooled<common::ScalarNode<T>>(val));
 }
 
 }  // namespace opencl
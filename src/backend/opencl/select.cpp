@@ -11,6 +11,7 @@
 
 #include <Array.hpp>
 #include <common/half.hpp>
+#include <common/jit/JitStats.hpp>
 #include <common/jit/NaryNode.hpp>
 #include <err_opencl.hpp>
 #include <scalar.hpp>
@@ -20,6 +21,7 @@
 using af::dim4;
 
 using common::half;
+using common::JitEvalScope;
 using common::NaryNode;
 
 using std::make_shared;
@@ -38,9 +40,11 @@ Array<T> createSelectNode(const Array<char> &cond, const Array<T> &a,
         static_cast<af::dtype>(dtype_traits<T>::af_type), "__select", 3,
         {{cond_node, a_node, b_node}}, static_cast<int>(af_select_t), height));
 
-    if (detail::passesJitHeuristics<T>(node.get()) == kJITHeuristics::Pass) {
+    const kJITHeuristics reason = detail::passesJitHeuristics<T>(node.get());
+    if (reason == kJITHeuristics::Pass) {
         return createNodeArray<T>(odims, node);
     } else {
+        JitEvalScope scope(reason);
         if (a_node->getHeight() >
             max(b_node->getHeight(), cond_node->getHeight())) {
             a.eval();
@@ -68,9 +72,11 @@ Array<T> createSelectNode(const Array<char> &cond, const Array<T> &a,
         (flip ? "__not_select" : "__select"), 3, {{cond_node, a_node, b_node}},
         static_cast<int>(flip ? af_not_select_t : af_select_t), height));
 
-    if (detail::passesJitHeuristics<T>(node.get()) == kJITHeuristics::Pass) {
+    const kJITHeuristics reason = detail::passesJitHeuristics<T>(node.get());
+    if (reason == kJITHeuristics::Pass) {
         return createNodeArray<T>(odims, node);
     } else {
+        JitEvalScope scope(reason);
         if (a_node->getHeight() >
             max(b_node->getHeight(), cond_node->getHeight())) {
             a.eval();
@@ -10,128 +10,114 @@
 #include <Array.hpp>
 #include <copy.hpp>
 #include <err_opencl.hpp>
+#include <join.hpp>
+#include <kernel/set.hpp>
+#include <scan.hpp>
 #include <set.hpp>
 #include <sort.hpp>
 #include <af/dim4.hpp>
 
-AF_DEPRECATED_WARNINGS_OFF
-#include <boost/compute/algorithm/set_intersection.hpp>
-#include <boost/compute/algorithm/set_union.hpp>
-#include <boost/compute/algorithm/sort.hpp>
-#include <boost/compute/algorithm/unique.hpp>
-#include <boost/compute/iterator/buffer_iterator.hpp>
-AF_DEPRECATED_WARNINGS_ON
-
-namespace compute = boost::compute;
-
 namespace opencl {
 using af::dim4;
 
-using std::conditional;
-using std::is_same;
-template<typename T>
-using ltype_t = typename conditional<is_same<T, intl>::value, cl_long, T>::type;
+namespace {
 
+/// The values of a set and their number, which stays on the device until the
+/// result is returned. Only the first length[0] values are valid.
 template<typename T>
-using type_t =
-    typename conditional<is_same<T, uintl>::value, cl_ulong, ltype_t<T>>::type;
+struct DeviceSet {
+    Array<T> values;
+    Array<uint> length;
+};
 
+/// The kernels take the buffers without their offset
 template<typename T>
-Array<T> setUnique(const Array<T> &in, const bool is_sorted) {
-    try {
-        Array<T> out = copyArray<T>(in);
-
-        compute::command_queue queue(getQueue()());
+Array<T> flat(const Array<T> &in) {
+    Array<T> out =
+        in.isLinear() && in.getOffset() == 0 ? in : copyArray<T>(in);
+    out.eval();
+    out.modDims(dim4(in.elements()));
+    return out;
+}
 
-        compute::buffer out_data((*out.get())());
+template<typename T>
+DeviceSet<T> sortedSet(const Array<T> &in, const bool is_sorted) {
+    Array<T> values = is_sorted ? flat(in) : sort<T>(flat(in), 0, true);
+    Array<uint> length =
+        createValueArray<uint>(dim4(1), static_cast<uint>(in.elements()));
+    length.eval();
+    return {values, length};
+}
 
-        compute::buffer_iterator<type_t<T>> begin(out_data, 0);
-        compute::buffer_iterator<type_t<T>> end(out_data, out.elements());
+/// Keeps the first value of each run of equal values of the sorted set, or one
+/// value of each run of at least two values when \p duplicates is true
+template<typename T>
+DeviceSet<T> compact(const DeviceSet<T> &set, const bool duplicates) {
+    const dim_t capacity = set.values.elements();
+
+    Array<uint> flags = createEmptyArray<uint>(dim4(capacity));
+    kernel::setFlags<T>(*flags.get(), *set.values.get(), *set.length.get(),
+                        capacity, duplicates);
+    const Array<uint> positions = scan<af_add_t, uint, uint>(flags, 0, true);
+
+    DeviceSet<T> out{createEmptyArray<T>(dim4(capacity)),
+                     createEmptyArray<uint>(dim4(1))};
+    kernel::setScatter<T>(*out.values.get(), *out.length.get(),
+                          *set.values.get(), *flags.get(), *positions.get(),
+                          capacity);
+    return out;
+}
 
-        if (!is_sorted) { compute::sort(begin, end, queue); }
+template<typename T>
+DeviceSet<T> merge(const DeviceSet<T> &first, const DeviceSet<T> &second) {
+    const dim_t capacity = first.values.elements() + second.values.elements();
+
+    DeviceSet<T> out{createEmptyArray<T>(dim4(capacity)),
+                     createEmptyArray<uint>(dim4(1))};
+    kernel::setMerge<T>(*out.values.get(), *out.length.get(),
+                        *first.values.get(), *first.length.get(),
+                        *second.values.get(), *second.length.get(), capacity);
+    return out;
+}
 
-        end = compute::unique(begin, end, queue);
+/// Reads the length of the set, which is the only synchronization of the set
+/// operations, and returns its values
+template<typename T>
+Array<T> toArray(DeviceSet<T> set) {
+    set.values.resetDims(dim4(getScalar<uint>(set.length)));
+    return set.values;
+}
 
-        out.resetDims(dim4(std::distance(begin, end), 1, 1, 1));
+}  // namespace
 
-        return out;
-    } catch (const std::exception &ex) { AF_ERROR(ex.what(), AF_ERR_INTERNAL); }
+template<typename T>
+Array<T> setUnique(const Array<T> &in, const bool is_sorted) {
+    return toArray(compact(sortedSet(in, is_sorted), false));
 }
 
 template<typename T>
 Array<T> setUnion(const Array<T> &first, const Array<T> &second,
                   const bool is_unique) {
-    try {
-        Array<T> unique_first  = first;
-        Array<T> unique_second = second;
-
-        if (!is_unique) {
-            unique_first  = setUnique(first, false);
-            unique_second = setUnique(second, false);
-        }
-
-        size_t out_size = unique_first.elements() + unique_second.elements();
-        Array<T> out    = createEmptyArray<T>(dim4(out_size, 1, 1, 1));
-
-        compute::command_queue queue(getQueue()());
-
-        compute::buffer first_data((*unique_first.get())());
-        compute::buffer second_data((*unique_second.get())());
-        compute::buffer out_data((*out.get())());
-
-        compute::buffer_iterator<type_t<T>> first_begin(first_data, 0);
-        compute::buffer_iterator<type_t<T>> first_end(first_data,
-                                                      unique_first.elements());
-        compute::buffer_iterator<type_t<T>> second_begin(second_data, 0);
-        compute::buffer_iterator<type_t<T>> second_end(
-            second_data, unique_second.elements());
-        compute::buffer_iterator<type_t<T>> out_begin(out_data, 0);
-
-        compute::buffer_iterator<type_t<T>> out_end = compute::set_union(
-            first_begin, first_end, second_begin, second_end, out_begin, queue);
-
-        out.resetDims(dim4(std::distance(out_begin, out_end), 1, 1, 1));
-        return out;
-
-    } catch (const std::exception &ex) { AF_ERROR(ex.what(), AF_ERR_INTERNAL); }
+    if (!is_unique) {
+        return setUnique(join<T>(0, flat(first), flat(second)), false);
+    }
+    return toArray(compact(
+        merge(sortedSet(first, true), sortedSet(second, true)), false));
 }
 
 template<typename T>
 Array<T> setIntersect(const Array<T> &first, const Array<T> &second,
                       const bool is_unique) {
-    try {
-        Array<T> unique_first  = first;
-        Array<T> unique_second = second;
-
-        if (!is_unique) {
-            unique_first  = setUnique(first, false);
-            unique_second = setUnique(second, false);
-        }
-
-        size_t out_size =
-            std::max(unique_first.elements(), unique_second.elements());
-        Array<T> out = createEmptyArray<T>(dim4(out_size, 1, 1, 1));
-
-        compute::command_queue queue(getQueue()());
-
-        compute::buffer first_data((*unique_first.get())());
-        compute::buffer second_data((*unique_second.get())());
-        compute::buffer out_data((*out.get())());
-
-        compute::buffer_iterator<type_t<T>> first_begin(first_data, 0);
-        compute::buffer_iterator<type_t<T>> first_end(first_data,
-                                                      unique_first.elements());
-        compute::buffer_iterator<type_t<T>> second_begin(second_data, 0);
-        compute::buffer_iterator<type_t<T>> second_end(
-            second_data, unique_second.elements());
-        compute::buffer_iterator<type_t<T>> out_begin(out_data, 0);
-
-        compute::buffer_iterator<type_t<T>> out_end = compute::set_intersection(
-            first_begin, first_end, second_begin, second_end, out_begin, queue);
-
-        out.resetDims(dim4(std::distance(out_begin, out_end), 1, 1, 1));
-        return out;
-    } catch (const std::exception &ex) { AF_ERROR(ex.what(), AF_ERR_INTERNAL); }
+    DeviceSet<T> uFirst  = sortedSet(first, is_unique);
+    DeviceSet<T> uSecond = sortedSet(second, is_unique);
+
+    if (!is_unique) {
+        uFirst  = compact(uFirst, false);
+        uSecond = compact(uSecond, false);
+    }
+
+    // The values of both sets appear twice in their merge
+    return toArray(compact(merge(uFirst, uSecond), true));
 }
 
 #define INSTANTIATE(T)                                                        \
@@ -15,22 +15,65 @@
 #include <blas.hpp>
 #include <copy.hpp>
 #include <cpu/cpu_solve.hpp>
+#include <kernel/lapack_batched.hpp>
 #include <lu.hpp>
 #include <magma/magma.h>
 #include <magma/magma_blas.h>
 #include <magma/magma_data.h>
 #include <magma/magma_helper.h>
 #include <math.hpp>
+#include <offload.hpp>
 #include <platform.hpp>
 #include <transpose.hpp>
 #include <af/opencl.h>
 
 namespace opencl {
 
+/// Solves the systems of a batch of LU factorized matrices in place of \p B
+template<typename T>
+void solveBatched(const Array<T> &A, const Array<int> &pivot, Array<T> &B) {
+    dim4 aDims = A.dims();
+    int N      = aDims[0];
+
+    if (N <= kernel::LAPACK_BATCHED_MAX_SIZE) {
+        kernel::getrsBatched<T>(A, pivot, B);
+        return;
+    }
+
+    // MAGMA reads the pivots from the host
+    std::vector<int> ipiv(pivot.elements());
+    copyData(&ipiv[0], pivot);
+
+    const cl::Buffer *A_buf = A.get();
+    cl::Buffer *B_buf       = B.get();
+
+    int info = 0;
+    for (dim_t w = 0; w < aDims[3]; w++) {
+        for (dim_t z = 0; z < aDims[2]; z++) {
+            dim_t aOffset =
+                A.getOffset() + z * A.strides()[2] + w * A.strides()[3];
+            dim_t bOffset =
+                B.getOffset() + z * B.strides()[2] + w * B.strides()[3];
+            magma_getrs_gpu<T>(MagmaNoTrans, N, B.dims()[1], (*A_buf)(),
+                               aOffset, A.strides()[1],
+                               &ipiv[(w * aDims[2] + z) * N], (*B_buf)(),
+                               bOffset, B.strides()[1], getQueue()(), &info);
+        }
+    }
+}
+
 template<typename T>
 Array<T> solveLU(const Array<T> &A, const Array<int> &pivot, const Array<T> &b,
                  const af_mat_prop options) {
-    if (OpenCLCPUOffload()) { return cpu::solveLU(A, pivot, b, options); }
+    if (OpenCLCPUOffload(OffloadOp::Solve, A, b.dims()[1])) {
+        return cpu::solveLU(A, pivot, b, options);
+    }
+
+    if (A.dims()[2] * A.dims()[3] > 1) {
+        Array<T> B = copyArray<T>(b);
+        solveBatched<T>(A, pivot, B);
+        return B;
+    }
 
     int N    = A.dims()[0];
     int NRHS = b.dims()[1];
@@ -61,6 +104,12 @@ Array<T> generalSolve(const Array<T> &a, const Array<T> &b) {
     Array<T> A = copyArray<T>(a);
     Array<T> B = copyArray<T>(b);
 
+    if (iDims[2] * iDims[3] > 1) {
+        Array<int> pivot = lu_inplace(A, false);
+        solveBatched<T>(A, pivot, B);
+        return B;
+    }
+
     cl::Buffer *A_buf  = A.get();
     int info           = 0;
     cl_command_queue q = getQueue()();
@@ -243,36 +292,47 @@ Array<T> triangleSolve(const Array<T> &A, const Array<T> &b,
     int N    = B.dims()[0];
     int NRHS = B.dims()[1];
 
-    const cl::Buffer *A_buf = A.get();
-    cl::Buffer *B_buf       = B.get();
+    cl::Buffer *B_buf = B.get();
 
     cl_event event         = 0;
     cl_command_queue queue = getQueue()();
 
-    if (getActivePlatform() == AFCL_PLATFORM_NVIDIA &&
-        (options & AF_MAT_UPPER)) {
-        Array<T> AT = transpose<T>(A, true);
-
-        cl::Buffer *AT_buf = AT.get();
-        OPENCL_BLAS_CHECK(gpu_blas_trsm(
-            OPENCL_BLAS_SIDE_LEFT, OPENCL_BLAS_TRIANGLE_LOWER,
-            OPENCL_BLAS_CONJ_TRANS,
-            options & AF_MAT_DIAG_UNIT ? OPENCL_BLAS_UNIT_DIAGONAL
-                                       : OPENCL_BLAS_NON_UNIT_DIAGONAL,
-            N, NRHS, scalar<T>(1), (*AT_buf)(), AT.getOffset(), AT.strides()[1],
-            (*B_buf)(), B.getOffset(), B.strides()[1], 1, &queue, 0, nullptr,
-            &event));
-    } else {
-        OPENCL_BLAS_CHECK(gpu_blas_trsm(
-            OPENCL_BLAS_SIDE_LEFT,
-            options & AF_MAT_LOWER ? OPENCL_BLAS_TRIANGLE_LOWER
-                                   : OPENCL_BLAS_TRIANGLE_UPPER,
-            OPENCL_BLAS_NO_TRANS,
-            options & AF_MAT_DIAG_UNIT ? OPENCL_BLAS_UNIT_DIAGONAL
-                                       : OPENCL_BLAS_NON_UNIT_DIAGONAL,
-            N, NRHS, scalar<T>(1), (*A_buf)(), A.getOffset(), A.strides()[1],
-            (*B_buf)(), B.getOffset(), B.strides()[1], 1, &queue, 0, nullptr,
-            &event));
+    bool transposed = getActivePlatform() == AFCL_PLATFORM_NVIDIA &&
+                      (options & AF_MAT_UPPER);
+    Array<T> AT     = transposed ? transpose<T>(A, true) : A;
+
+    const cl::Buffer *AT_buf = AT.get();
+
+    // The systems of a batch are solved one at a time
+    for (dim_t w = 0; w < B.dims()[3]; w++) {
+        for (dim_t z = 0; z < B.dims()[2]; z++) {
+            dim_t aOffset =
+                AT.getOffset() + z * AT.strides()[2] + w * AT.strides()[3];
+            dim_t bOffset =
+                B.getOffset() + z * B.strides()[2] + w * B.strides()[3];
+
+            if (transposed) {
+                OPENCL_BLAS_CHECK(gpu_blas_trsm(
+                    OPENCL_BLAS_SIDE_LEFT, OPENCL_BLAS_TRIANGLE_LOWER,
+                    OPENCL_BLAS_CONJ_TRANS,
+                    options & AF_MAT_DIAG_UNIT ? OPENCL_BLAS_UNIT_DIAGONAL
+                                               : OPENCL_BLAS_NON_UNIT_DIAGONAL,
+                    N, NRHS, scalar<T>(1), (*AT_buf)(), aOffset,
+                    AT.strides()[1], (*B_buf)(), bOffset, B.strides()[1], 1,
+                    &queue, 0, nullptr, &event));
+            } else {
+                OPENCL_BLAS_CHECK(gpu_blas_trsm(
+                    OPENCL_BLAS_SIDE_LEFT,
+                    options & AF_MAT_LOWER ? OPENCL_BLAS_TRIANGLE_LOWER
+                                           : OPENCL_BLAS_TRIANGLE_UPPER,
+                    OPENCL_BLAS_NO_TRANS,
+                    options & AF_MAT_DIAG_UNIT ? OPENCL_BLAS_UNIT_DIAGONAL
+                                               : OPENCL_BLAS_NON_UNIT_DIAGONAL,
+                    N, NRHS, scalar<T>(1), (*AT_buf)(), aOffset,
+                    AT.strides()[1], (*B_buf)(), bOffset, B.strides()[1], 1,
+                    &queue, 0, nullptr, &event));
+            }
+        }
     }
 
     return B;
@@ -281,7 +341,9 @@ Array<T> triangleSolve(const Array<T> &A, const Array<T> &b,
 template<typename T>
 Array<T> solve(const Array<T> &a, const Array<T> &b,
                const af_mat_prop options) {
-    if (OpenCLCPUOffload()) { return cpu::solve(a, b, options); }
+    if (OpenCLCPUOffload(OffloadOp::Solve, a, b.dims()[1])) {
+        return cpu::solve(a, b, options);
+    }
 
     if (options & AF_MAT_UPPER || options & AF_MAT_LOWER) {
         return triangleSolve<T>(a, b, options);
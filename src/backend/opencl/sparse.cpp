@@ -13,65 +13,73 @@
 #include <stdexcept>
 #include <string>
 
-#include <arith.hpp>
-#include <cast.hpp>
 #include <complex.hpp>
 #include <copy.hpp>
 #include <err_opencl.hpp>
-#include <lookup.hpp>
 #include <math.hpp>
 #include <platform.hpp>
 #include <range.hpp>
-#include <reduce.hpp>
-#include <where.hpp>
+#include <scan.hpp>
 
 namespace opencl {
 
 using namespace common;
 
-// Partial template specialization of sparseConvertDenseToStorage for COO
-// However, template specialization is not allowed
+/// Returns the exclusive scan of the number of nonzeros of the rows or of
+/// the columns of \p in. The last of the offsets is the number of nonzeros.
 template<typename T>
-SparseArray<T> sparseConvertDenseToCOO(const Array<T> &in) {
-    in.eval();
-
-    Array<uint> nonZeroIdx_ = where<T>(in);
-    Array<int> nonZeroIdx   = cast<int, uint>(nonZeroIdx_);
-
-    dim_t nNZ = nonZeroIdx.elements();
-
-    Array<int> constDim = createValueArray<int>(dim4(nNZ), in.dims()[0]);
-    constDim.eval();
-
-    Array<int> rowIdx =
-        arithOp<int, af_mod_t>(nonZeroIdx, constDim, nonZeroIdx.dims());
-    Array<int> colIdx =
-        arithOp<int, af_div_t>(nonZeroIdx, constDim, nonZeroIdx.dims());
-
-    Array<T> values = copyArray<T>(in);
-    values.modDims(dim4(values.elements()));
-    values = lookup<T, int>(values, nonZeroIdx, 0);
+Array<int> nnzOffsets(const Array<T> &in, const bool byRow) {
+    const dim_t lines = byRow ? in.dims()[0] : in.dims()[1];
+    Array<int> counts = createEmptyArray<int>(dim4(lines + 1));
+    if (byRow) {
+        kernel::nnzPerRow<T>(counts, in);
+    } else {
+        kernel::nnzPerCol<T>(counts, in);
+    }
+    return scan<af_add_t, int, int>(counts, 0, false);
+}
 
-    return createArrayDataSparseArray<T>(in.dims(), values, rowIdx, colIdx,
-                                         AF_STORAGE_COO);
+/// Reads the last offset of \p offsets. This is the only synchronization of
+/// the conversions of dense arrays.
+static int readNNZ(const Array<int> &offsets) {
+    int nNZ = 0;
+    getQueue().enqueueReadBuffer(
+        *offsets.get(), CL_TRUE,
+        sizeof(int) * (offsets.getOffset() + offsets.elements() - 1),
+        sizeof(int), &nNZ);
+    return nNZ;
 }
 
 template<typename T, af_storage stype>
-SparseArray<T> sparseConvertDenseToStorage(const Array<T> &in_) {
-    in_.eval();
-
-    uint nNZ = reduce_all<af_notzero_t, T, uint>(in_);
+SparseArray<T> sparseConvertDenseToStorage(const Array<T> &in) {
+    in.eval();
 
-    SparseArray<T> sparse_ = createEmptySparseArray<T>(in_.dims(), nNZ, stype);
-    sparse_.eval();
+    // CSR is written by row. CSC and COO, which is column major, are written
+    // by column.
+    const bool byRow   = stype == AF_STORAGE_CSR;
+    Array<int> offsets = nnzOffsets(in, byRow);
+    const int nNZ      = readNNZ(offsets);
 
-    Array<T> &values   = sparse_.getValues();
-    Array<int> &rowIdx = sparse_.getRowIdx();
-    Array<int> &colIdx = sparse_.getColIdx();
+    Array<T> values = createEmptyArray<T>(dim4(nNZ));
+    if (stype == AF_STORAGE_CSR) {
+        Array<int> colIdx = createEmptyArray<int>(dim4(nNZ));
+        kernel::dense2csrRows<T>(values, colIdx, in, offsets);
+        return createArrayDataSparseArray<T>(in.dims(), values, offsets,
+                                             colIdx, stype);
+    }
 
-    kernel::dense2csr<T>(values, rowIdx, colIdx, in_);
+    Array<int> rowIdx = createEmptyArray<int>(dim4(nNZ));
+    if (stype == AF_STORAGE_CSC) {
+        kernel::dense2sparseCols<T>(values, rowIdx, rowIdx, in, offsets,
+                                    false);
+        return createArrayDataSparseArray<T>(in.dims(), values, rowIdx,
+                                             offsets, stype);
+    }
 
-    return sparse_;
+    Array<int> colIdx = createEmptyArray<int>(dim4(nNZ));
+    kernel::dense2sparseCols<T>(values, rowIdx, colIdx, in, offsets, true);
+    return createArrayDataSparseArray<T>(in.dims(), values, rowIdx, colIdx,
+                                         stype);
 }
 
 // Partial template specialization of sparseConvertStorageToDense for COO
@@ -177,22 +185,19 @@ SparseArray<T> sparseConvertStorageToStorage(const SparseArray<T> &in) {
     sparseConvertStorageToStorage<T, S, AF_STORAGE_COO>( \
         const SparseArray<T> &in);
 
-#define INSTANTIATE_COO_SPECIAL(T)                                 \
-    template<>                                                     \
-    SparseArray<T> sparseConvertDenseToStorage<T, AF_STORAGE_COO>( \
-        const Array<T> &in) {                                      \
-        return sparseConvertDenseToCOO<T>(in);                     \
-    }                                                              \
-    template<>                                                     \
-    Array<T> sparseConvertStorageToDense<T, AF_STORAGE_COO>(       \
-        const SparseArray<T> &in) {                                \
-        return sparseConvertCOOToDense<T>(in);                     \
+#define INSTANTIATE_COO_SPECIAL(T)                           \
+    template<>                                               \
+    Array<T> sparseConvertStorageToDense<T, AF_STORAGE_COO>( \
+        const SparseArray<T> &in) {                          \
+        return sparseConvertCOOToDense<T>(in);               \
     }
 
 #define INSTANTIATE_SPARSE(T)                                               \
     template SparseArray<T> sparseConvertDenseToStorage<T, AF_STORAGE_CSR>( \
         const Array<T> &in);                                                \
     template SparseArray<T> sparseConvertDenseToStorage<T, AF_STORAGE_CSC>( \
+        const Array<T> &in);                                                \
+    template SparseArray<T> sparseConvertDenseToStorage<T, AF_STORAGE_COO>( \
         const Array<T> &in);                                                \
                                                                             \
     template Array<T> sparseConvertStorageToDense<T, AF_STORAGE_CSR>(       \
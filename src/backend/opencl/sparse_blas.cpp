@@ -9,20 +9,30 @@
 
 #include <sparse_blas.hpp>
 
+#include <kernel/coomm.hpp>
 #include <kernel/cscmm.hpp>
 #include <kernel/cscmv.hpp>
 #include <kernel/csrmm.hpp>
 #include <kernel/csrmv.hpp>
+#include <kernel/csrsv.hpp>
+#include <kernel/sparse_blocked.hpp>
+#include <kernel/spgemm.hpp>
 
 #include <cassert>
+#include <memory>
 #include <stdexcept>
 #include <string>
 
+#include <common/SpgemmPattern.hpp>
 #include <common/err_common.hpp>
+#include <common/sparse_triangular.hpp>
 #include <complex.hpp>
+#include <copy.hpp>
 #include <err_opencl.hpp>
 #include <math.hpp>
 #include <platform.hpp>
+#include <scan.hpp>
+#include <traits.hpp>
 #include <transpose.hpp>
 #include <af/dim4.hpp>
 
@@ -34,11 +44,49 @@ namespace opencl {
 
 using namespace common;
 
+/// Multiplies the BSR or SELL array \p lhs with the dense array \p rhs
+template<typename T>
+Array<T> blockedMatmul(const common::SparseArray<T>& lhs,
+                       const Array<T>& rhs) {
+    Array<T> out =
+        createEmptyArray<T>(af::dim4(lhs.dims()[0], rhs.dims()[1]));
+    if (lhs.getStorage() == AF_STORAGE_BSR) {
+        kernel::bsrmm<T>(out, lhs.getValues(), lhs.getRowIdx(),
+                         lhs.getColIdx(), rhs, lhs.getBlockSize());
+    } else {
+        kernel::sellmm<T>(out, lhs.getValues(), lhs.getRowIdx(),
+                          lhs.getColIdx(), rhs, lhs.getBlockSize());
+    }
+    return out;
+}
+
+/// Multiplies the COO array \p lhs with the dense array \p rhs
+template<typename T>
+Array<T> cooMatmul(const common::SparseArray<T>& lhs, const Array<T>& rhs,
+                   af_mat_prop optLhs) {
+    const int M = lhs.dims()[optLhs == AF_MAT_NONE ? 0 : 1];
+    Array<T> out =
+        createValueArray<T>(af::dim4(M, rhs.dims()[1]), scalar<T>(0));
+    out.eval();
+    kernel::coomm<T>(out, lhs.getValues(), lhs.getRowIdx(), lhs.getColIdx(),
+                     rhs, optLhs != AF_MAT_NONE, optLhs == AF_MAT_CTRANS);
+    return out;
+}
+
 template<typename T>
 Array<T> matmul(const common::SparseArray<T>& lhs, const Array<T>& rhsIn,
                 af_mat_prop optLhs, af_mat_prop optRhs) {
+    // The blocked formats only support AF_MAT_NONE. The CPU offload only
+    // handles CSR arrays.
+    const af_storage storage = lhs.getStorage();
+    if (storage == AF_STORAGE_BSR || storage == AF_STORAGE_SELL) {
+        return blockedMatmul(lhs, rhsIn);
+    }
+    if (storage == AF_STORAGE_COO) { return cooMatmul(lhs, rhsIn, optLhs); }
+
 #if defined(WITH_LINEAR_ALGEBRA)
-    if (OpenCLCPUOffload(
+    if (storage == AF_STORAGE_CSR &&
+        OpenCLCPUOffload(
             false)) {  // Do not force offload gemm on OSX Intel devices
         return cpu::matmul(lhs, rhsIn, optLhs, optRhs);
     }
@@ -55,40 +103,145 @@ Array<T> matmul(const common::SparseArray<T>& lhs, const Array<T>& rhsIn,
     int N      = rDims[rColDim];
     // int K = lDims[lColDim];
 
-    const Array<T> rhs =
-        (N != 1 && optLhs == AF_MAT_NONE) ? transpose(rhsIn, false) : rhsIn;
+    // The column offsets and the row indices of a CSC matrix are the CSR
+    // arrays of its transpose, so its products use the CSR kernels of the
+    // transposed operation
+    const bool csc            = storage == AF_STORAGE_CSC;
+    const bool transposed     = (optLhs != AF_MAT_NONE) != csc;
+    const Array<int>& offsets = csc ? lhs.getColIdx() : lhs.getRowIdx();
+    const Array<int>& indices = csc ? lhs.getRowIdx() : lhs.getColIdx();
+
+    // The CSR kernels do not conjugate the values, so the conjugate
+    // transpose of a complex CSC matrix is computed as conj(A^T conj(rhs))
+    const bool conjugated =
+        csc && optLhs == AF_MAT_CTRANS && af::iscplx<T>();
+    Array<T> rhsOp = conjugated ? conj(rhsIn) : rhsIn;
+
+    Array<T> rhs = (N != 1 && !transposed) ? transpose(rhsOp, false) : rhsOp;
+    rhs.eval();
     Array<T> out = createEmptyArray<T>(af::dim4(M, N, 1, 1));
 
     static const T alpha = scalar<T>(1.0);
     static const T beta  = scalar<T>(0.0);
 
-    const Array<T>& values   = lhs.getValues();
-    const Array<int>& rowIdx = lhs.getRowIdx();
-    const Array<int>& colIdx = lhs.getColIdx();
+    const Array<T>& values = lhs.getValues();
 
-    if (optLhs == AF_MAT_NONE) {
+    if (!transposed) {
         if (N == 1) {
-            kernel::csrmv(out, values, rowIdx, colIdx, rhs, alpha, beta);
+            kernel::csrmv(out, values, offsets, indices, rhs, alpha, beta);
         } else {
-            kernel::csrmm_nt(out, values, rowIdx, colIdx, rhs, alpha, beta);
+            kernel::csrmm_nt(out, values, offsets, indices, rhs, alpha, beta);
         }
     } else {
         // CSR transpose is a CSC matrix
         if (N == 1) {
-            kernel::cscmv(out, values, rowIdx, colIdx, rhs, alpha, beta,
+            kernel::cscmv(out, values, offsets, indices, rhs, alpha, beta,
                           optLhs == AF_MAT_CTRANS);
         } else {
-            kernel::cscmm_nn(out, values, rowIdx, colIdx, rhs, alpha, beta,
+            kernel::cscmm_nn(out, values, offsets, indices, rhs, alpha, beta,
                              optLhs == AF_MAT_CTRANS);
         }
     }
+    return conjugated ? conj(out) : out;
+}
+
+/// The pattern of the last sparse-sparse product of a sparse array and the
+/// levels of its triangles, which are kept with the array
+class SparseCache : public common::SparseArrayCache {
+   public:
+    std::shared_ptr<common::SpgemmPattern> spgemm;
+    std::shared_ptr<common::TriangularLevels> levels[2];
+};
+
+/// Returns the cache of \p in, which is created on the first product of the
+/// matrix
+template<typename T>
+std::shared_ptr<SparseCache> sparseCache(const common::SparseArray<T>& in) {
+    auto cache = std::dynamic_pointer_cast<SparseCache>(in.getCache());
+    if (!cache) {
+        cache = std::make_shared<SparseCache>();
+        in.setCache(cache);
+    }
+    return cache;
+}
+
+/// Reads the last row offset of \p rowIdx, which is the number of nonzeros
+static int readNNZ(const Array<int>& rowIdx) {
+    int nnz = 0;
+    getQueue().enqueueReadBuffer(
+        *rowIdx.get(), CL_TRUE,
+        sizeof(int) * (rowIdx.getOffset() + rowIdx.elements() - 1),
+        sizeof(int), &nnz);
+    return nnz;
+}
+
+template<typename T>
+SparseArray<T> matmul(const common::SparseArray<T>& lhs,
+                      const common::SparseArray<T>& rhs) {
+    const int M = lhs.dims()[0];
+    const int N = rhs.dims()[1];
+
+    const Array<int>& lRowIdx = lhs.getRowIdx();
+    const Array<int>& lColIdx = lhs.getColIdx();
+    const Array<int>& rRowIdx = rhs.getRowIdx();
+    const Array<int>& rColIdx = rhs.getColIdx();
+
+    std::shared_ptr<SparseCache> cache             = sparseCache(lhs);
+    std::shared_ptr<common::SpgemmPattern> pattern = cache->spgemm;
+    if (!pattern || !pattern->matches(rhs)) {
+        // Each row gets a hash table with a slot for each of its products
+        auto flops = createValueArray<int>(dim4(M + 1), scalar<int>(0));
+        flops.eval();
+        kernel::spgemmRowFlops<T>(flops, M, lRowIdx, lColIdx, rRowIdx);
+        auto offsets = scan<af_add_t, int, int>(flops, 0);
+
+        auto table  = createEmptyArray<int>(dim4(readNNZ(offsets)));
+        auto counts = createValueArray<int>(dim4(M + 1), scalar<int>(0));
+        counts.eval();
+        kernel::spgemmSymbolic<T>(counts, table, offsets, M, lRowIdx, lColIdx,
+                                  rRowIdx, rColIdx);
+        auto rowIdx = scan<af_add_t, int, int>(counts, 0);
+
+        auto colIdx = createEmptyArray<int>(dim4(readNNZ(rowIdx)));
+        kernel::spgemmColumns<T>(colIdx, rowIdx, table, offsets, M);
+
+        pattern = std::make_shared<common::SpgemmPattern>(rhs, rowIdx, colIdx);
+        cache->spgemm = pattern;
+    }
+
+    auto values = createEmptyArray<T>(dim4(pattern->getNNZ()));
+    kernel::spgemmValues<T>(values, pattern->rowIdx, pattern->colIdx, M,
+                            lhs.getValues(), lRowIdx, lColIdx, rhs.getValues(),
+                            rRowIdx, rColIdx);
+
+    return createArrayDataSparseArray<T>(dim4(M, N), values, pattern->rowIdx,
+                                         pattern->colIdx, AF_STORAGE_CSR);
+}
+
+template<typename T>
+Array<T> solve(const common::SparseArray<T>& lhs, const Array<T>& rhs,
+               const af_mat_prop options) {
+    const bool upper = options & AF_MAT_UPPER;
+    const bool unit  = options & AF_MAT_DIAG_UNIT;
+
+    std::shared_ptr<SparseCache> cache = sparseCache(lhs);
+    auto& levels                       = cache->levels[upper];
+    if (!levels) { levels = common::triangularLevels(lhs, upper); }
+
+    Array<T> out = copyArray<T>(rhs);
+    kernel::csrsv<T>(out, lhs.getValues(), lhs.getRowIdx(), lhs.getColIdx(),
+                     *levels, upper, unit);
     return out;
 }
 
-#define INSTANTIATE_SPARSE(T)                                            \
-    template Array<T> matmul<T>(const common::SparseArray<T>& lhs,       \
-                                const Array<T>& rhs, af_mat_prop optLhs, \
-                                af_mat_prop optRhs);
+#define INSTANTIATE_SPARSE(T)                                               \
+    template Array<T> matmul<T>(const common::SparseArray<T>& lhs,          \
+                                const Array<T>& rhs, af_mat_prop optLhs,    \
+                                af_mat_prop optRhs);                        \
+    template SparseArray<T> matmul<T>(const common::SparseArray<T>& lhs,    \
+                                      const common::SparseArray<T>& rhs);   \
+    template Array<T> solve<T>(const common::SparseArray<T>& lhs,           \
+                               const Array<T>& rhs, const af_mat_prop options);
 
 INSTANTIATE_SPARSE(float)
 INSTANTIATE_SPARSE(double)
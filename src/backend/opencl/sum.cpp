@@ -7,9 +7,11 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <common/bfloat16.hpp>
 #include <common/half.hpp>
 #include "reduce_impl.hpp"
 
+using common::bfloat16;
 using common::half;
 
 namespace opencl {
@@ -36,4 +38,5 @@ INSTANTIATE(af_add_t, ushort, uint)
 INSTANTIATE(af_add_t, ushort, float)
 INSTANTIATE(af_add_t, half, half)
 INSTANTIATE(af_add_t, half, float)
+INSTANTIATE(af_add_t, bfloat16, float)
 }  // namespace opencl
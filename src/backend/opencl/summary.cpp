@@ -0,0 +1,36 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <summary.hpp>
+
+#include <Array.hpp>
+#include <err_opencl.hpp>
+#include <kernel/summary.hpp>
+#include <types.hpp>
+
+namespace opencl {
+template<typename T>
+common::Summary summary_all(const Array<T> &in) {
+    return kernel::summary_all<T>(in);
+}
+
+#define INSTANTIATE(T) \
+    template common::Summary summary_all<T>(const Array<T> &in);
+
+INSTANTIATE(float)
+INSTANTIATE(double)
+INSTANTIATE(int)
+INSTANTIATE(uint)
+INSTANTIATE(intl)
+INSTANTIATE(uintl)
+INSTANTIATE(short)
+INSTANTIATE(ushort)
+INSTANTIATE(char)
+INSTANTIATE(uchar)
+}  // namespace opencl
@@ -9,25 +9,45 @@
 
 #include <Array.hpp>
 #include <GraphicsResourceManager.hpp>
+#include <common/graphics_vertices.hpp>
 #include <debug_opencl.hpp>
 #include <err_opencl.hpp>
+#include <kernel/interleave.hpp>
 #include <surface.hpp>
 
+#include <vector>
+
 using af::dim4;
 using cl::Memory;
+using common::surfaceComponent;
+using common::VertexComponent;
 using std::vector;
 
 namespace opencl {
 
+/// Returns the param of \p in read as \p component
+template<typename T>
+Param componentParam(const Array<T> &in, const VertexComponent &component) {
+    Param out = in;
+    for (int i = 0; i < 4; ++i) {
+        out.info.dims[i]    = component.dims[i];
+        out.info.strides[i] = component.strides[i];
+    }
+    return out;
+}
+
 template<typename T>
-void copy_surface(const Array<T> &P, fg_surface surface) {
-    ForgeModule &_ = graphics::forgePlugin();
+void copy_surface(const Array<T> &x, const Array<T> &y, const Array<T> &z,
+                  fg_surface surface) {
+    ForgeModule &_       = graphics::forgePlugin();
+    const dim_t vertices = z.elements();
+    vector<Param> params = {
+        componentParam(x, surfaceComponent(vertices, x.dims(), x.strides(), 0)),
+        componentParam(y, surfaceComponent(vertices, y.dims(), y.strides(), 1)),
+        z};
+    cl::CommandQueue &queue = interopManager().beginCopy();
     if (isGLSharingSupported()) {
         CheckGL("Begin OpenCL resource copy");
-        const cl::Buffer *d_P = P.get();
-        unsigned bytes        = 0;
-        FG_CHECK(_.fg_get_surface_vertex_buffer_size(&bytes, surface));
-
         auto res = interopManager().getSurfaceResources(surface);
 
         vector<Memory> shared_objects;
@@ -39,16 +59,18 @@ void copy_surface(const Array<T> &P, fg_surface surface) {
         // https://www.khronos.org/registry/cl/sdk/1.1/docs/man/xhtml/clEnqueueReleaseGLObjects.html
         cl::Event event;
 
-        getQueue().enqueueAcquireGLObjects(&shared_objects, NULL, &event);
+        queue.enqueueAcquireGLObjects(&shared_objects, NULL, &event);
         event.wait();
-        getQueue().enqueueCopyBuffer(*d_P, *(res[0].get()), 0, 0, bytes, NULL,
-                                     &event);
-        getQueue().enqueueReleaseGLObjects(&shared_objects, NULL, &event);
+        kernel::interleave<T>(*(res[0].get()), params, queue);
+        queue.enqueueReleaseGLObjects(&shared_objects, NULL, &event);
         event.wait();
 
-        CL_DEBUG_FINISH(getQueue());
+        CL_DEBUG_FINISH(queue);
         CheckGL("End OpenCL resource copy");
     } else {
+        Array<T> P = createEmptyArray<T>(dim4(3 * vertices));
+        kernel::interleave<T>(*P.get(), params, queue);
+
         unsigned bytes = 0, buffer = 0;
         FG_CHECK(_.fg_get_surface_vertex_buffer(&buffer, surface));
         FG_CHECK(_.fg_get_surface_vertex_buffer_size(&bytes, surface));
@@ -58,7 +80,7 @@ void copy_surface(const Array<T> &P, fg_surface surface) {
         auto *ptr =
             static_cast<GLubyte *>(glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY));
         if (ptr) {
-            getQueue().enqueueReadBuffer(*P.get(), CL_TRUE, 0, bytes, ptr);
+            queue.enqueueReadBuffer(*P.get(), CL_TRUE, 0, bytes, ptr);
             glUnmapBuffer(GL_ARRAY_BUFFER);
         }
         glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -66,8 +88,9 @@ void copy_surface(const Array<T> &P, fg_surface surface) {
     }
 }
 
-#define INSTANTIATE(T) \
-    template void copy_surface<T>(const Array<T> &, fg_surface);
+#define INSTANTIATE(T)                                                \
+    template void copy_surface<T>(const Array<T> &, const Array<T> &, \
+                                  const Array<T> &, fg_surface);
 
 INSTANTIATE(float)
 INSTANTIATE(double)
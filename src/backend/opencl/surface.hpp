@@ -12,7 +12,12 @@
 
 namespace opencl {
 
+/// Writes the vertices of \p surface from the coordinates \p x, \p y and
+/// \p z. The x and y coordinates are arrays with a value per vertex, or
+/// vectors of the coordinates of the first and of the second dimension of
+/// the grid.
 template<typename T>
-void copy_surface(const Array<T> &P, fg_surface surface);
+void copy_surface(const Array<T> &x, const Array<T> &y, const Array<T> &z,
+                  fg_surface surface);
 
 }
@@ -15,6 +15,11 @@
 #include <reduce.hpp>
 #include <svd.hpp>  // opencl backend function header
 #include <transpose.hpp>
+#include <af/seq.h>
+
+#include <vector>
+
+using std::vector;
 
 #if defined(WITH_LINEAR_ALGEBRA)
 
@@ -22,6 +27,7 @@
 #include <magma/magma.h>
 #include <magma/magma_cpu_lapack.h>
 #include <magma/magma_helper.h>
+#include <offload.hpp>
 #include <platform.hpp>
 
 namespace opencl {
@@ -195,14 +201,16 @@ void svd(Array<T> &arrU, Array<Tr> &arrS, Array<T> &arrVT, Array<T> &arrA,
 
 template<typename T, typename Tr>
 void svdInPlace(Array<Tr> &s, Array<T> &u, Array<T> &vt, Array<T> &in) {
-    if (OpenCLCPUOffload()) { return cpu::svdInPlace(s, u, vt, in); }
+    if (OpenCLCPUOffload(OffloadOp::SVD, in)) {
+        return cpu::svdInPlace(s, u, vt, in);
+    }
 
     svd<T, Tr>(u, s, vt, in, true);
 }
 
 template<typename T, typename Tr>
 void svd(Array<Tr> &s, Array<T> &u, Array<T> &vt, const Array<T> &in) {
-    if (OpenCLCPUOffload()) { return cpu::svd(s, u, vt, in); }
+    if (OpenCLCPUOffload(OffloadOp::SVD, in)) { return cpu::svd(s, u, vt, in); }
 
     dim4 iDims = in.dims();
     int M      = iDims[0];
@@ -219,11 +227,31 @@ void svd(Array<Tr> &s, Array<T> &u, Array<T> &vt, const Array<T> &in) {
     }
 }
 
+template<typename T, typename Tr>
+void svdBatched(Array<Tr> &s, Array<T> &u, Array<T> &vt, const Array<T> &in) {
+    dim4 iDims = in.dims();
+    for (dim_t j = 0; j < iDims[3]; ++j) {
+        for (dim_t i = 0; i < iDims[2]; ++i) {
+            const vector<af_seq> slice = {
+                af_span, af_span,
+                {static_cast<double>(i), static_cast<double>(i), 1.},
+                {static_cast<double>(j), static_cast<double>(j), 1.}};
+            Array<Tr> sSlice = createSubArray(s, slice, false);
+            Array<T> uSlice  = createSubArray(u, slice, false);
+            Array<T> vtSlice = createSubArray(vt, slice, false);
+            svd<T, Tr>(sSlice, uSlice, vtSlice,
+                       createSubArray(in, slice, false));
+        }
+    }
+}
+
 #define INSTANTIATE(T, Tr)                                               \
     template void svd<T, Tr>(Array<Tr> & s, Array<T> & u, Array<T> & vt, \
                              const Array<T> &in);                        \
     template void svdInPlace<T, Tr>(Array<Tr> & s, Array<T> & u,         \
-                                    Array<T> & vt, Array<T> & in);
+                                    Array<T> & vt, Array<T> & in);       \
+    template void svdBatched<T, Tr>(Array<Tr> & s, Array<T> & u,         \
+                                    Array<T> & vt, const Array<T> &in);
 
 INSTANTIATE(float, float)
 INSTANTIATE(double, double)
@@ -246,11 +274,18 @@ void svdInPlace(Array<Tr> &s, Array<T> &u, Array<T> &vt, Array<T> &in) {
     AF_ERROR("Linear Algebra is disabled on OpenCL", AF_ERR_NOT_CONFIGURED);
 }
 
+template<typename T, typename Tr>
+void svdBatched(Array<Tr> &s, Array<T> &u, Array<T> &vt, const Array<T> &in) {
+    AF_ERROR("Linear Algebra is disabled on OpenCL", AF_ERR_NOT_CONFIGURED);
+}
+
 #define INSTANTIATE(T, Tr)                                               \
     template void svd<T, Tr>(Array<Tr> & s, Array<T> & u, Array<T> & vt, \
                              const Array<T> &in);                        \
     template void svdInPlace<T, Tr>(Array<Tr> & s, Array<T> & u,         \
-                                    Array<T> & vt, Array<T> & in);
+                                    Array<T> & vt, Array<T> & in);       \
+    template void svdBatched<T, Tr>(Array<Tr> & s, Array<T> & u,         \
+                                    Array<T> & vt, const Array<T> &in);
 
 INSTANTIATE(float, float)
 INSTANTIATE(double, double)
@@ -15,4 +15,11 @@ void svd(Array<Tr> &s, Array<T> &u, Array<T> &vt, const Array<T> &in);
 
 template<typename T, typename Tr>
 void svdInPlace(Array<Tr> &s, Array<T> &u, Array<T> &vt, Array<T> &in);
+
+/// Computes the SVD of each matrix of the batch \p in, along its third and
+/// fourth dimensions, into the same matrices of \p s, \p u and \p vt. The
+/// outputs are allocated by the caller, with min(M, N) x 1, M x M and N x N
+/// matrices.
+template<typename T, typename Tr>
+void svdBatched(Array<Tr> &s, Array<T> &u, Array<T> &vt, const Array<T> &in);
 }  // namespace opencl
@@ -6,27 +6,47 @@
  * The complete license agreement can be obtained at:
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
-#include <kernel/tile.hpp>
 #include <tile.hpp>
 
 #include <Array.hpp>
 #include <common/half.hpp>
-#include <stdexcept>
+#include <common/jit/TileNodeBase.hpp>
+#include <traits.hpp>
+
+#include <memory>
 
 using common::half;
+using common::Node_ptr;
+using common::TileNodeBase;
+using opencl::jit::BufferNode;
+using std::make_shared;
+using std::static_pointer_cast;
 
 namespace opencl {
+using TileNode = TileNodeBase<BufferNode>;
+
 template<typename T>
 Array<T> tile(const Array<T> &in, const af::dim4 &tileDims) {
     const af::dim4 &iDims = in.dims();
     af::dim4 oDims        = iDims;
     oDims *= tileDims;
 
-    Array<T> out = createEmptyArray<T>(oDims);
+    // The tiled array is read through a node of the JIT tree, so it is
+    // fused into the expression which uses it instead of being copied.
+    // Force input to be evaluated so that in is always a buffer.
+    in.eval();
 
-    kernel::tile<T>(out, in);
+    // The buffer is broadcast if it is only repeated along the dimensions
+    // of size one
+    bool broadcast = true;
+    for (int i = 0; i < AF_MAX_DIMS; i++) {
+        broadcast &= tileDims[i] == 1 || iDims[i] == 1;
+    }
 
-    return out;
+    auto node = make_shared<TileNode>(
+        static_cast<af::dtype>(dtype_traits<T>::af_type),
+        static_pointer_cast<BufferNode>(in.getNode()), broadcast);
+    return createNodeArray<T>(oDims, Node_ptr(node));
 }
 
 #define INSTANTIATE(T) \
@@ -11,6 +11,7 @@
 #include <common/half.hpp>
 #include <err_opencl.hpp>
 #include <index.hpp>
+#include <kernel/topk.hpp>
 #include <sort.hpp>
 #include <sort_index.hpp>
 #include <types.hpp>
@@ -31,6 +32,10 @@ using std::transform;
 using std::vector;
 
 namespace opencl {
+/// The largest k selected by sorting the whole input. Larger k select the
+/// values first and only sort the selected ones.
+constexpr int TOPK_MAX_SORTED_K = 256;
+
 vector<af_index_t> indexForTopK(const int k) {
     af_index_t idx;
     idx.idx.seq = af_seq{0.0, static_cast<double>(k) - 1.0, 1.0};
@@ -125,6 +130,13 @@ void topk(Array<T>& vals, Array<unsigned>& idxs, const Array<T>& in,
 
         vals = values;
         idxs = indices;
+    } else if (k > TOPK_MAX_SORTED_K) {
+        dim4 outDims = in.dims();
+        outDims[dim] = k;
+
+        vals = createEmptyArray<T>(outDims);
+        idxs = createEmptyArray<unsigned>(outDims);
+        kernel::topkSelect<T>(vals, idxs, in, k, order);
     } else {
         auto values  = createEmptyArray<T>(in.dims());
         auto indices = createEmptyArray<unsigned>(in.dims());
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2020, ArrayFire
+# All rights reserved.
+#
+# This file is distributed under 3-clause BSD license.
+# The complete license agreement can be obtained at:
+# http://arrayfire.com/licenses/BSD-3-Clause
+
+"""Tunes the kernels of CLBlast and adds the results to a tuning database.
+
+Each tuner of CLBlast is run for each precision on a device and writes the
+best parameters it found to a JSON file. The parameters of each kernel are
+written to the database as a line with the name of the device, the name of
+the kernel, the precision and the parameters separated by tabs, which is
+the format read by the OpenCL backend (see clblast_tuning.hpp). The lines
+of the database for the same device, kernel and precision are replaced.
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+
+def kernel_name(family):
+    """Returns the name of the kernel of a tuner family, which is the name
+    used by CLBlast to override its parameters, e.g. Xgemm for xgemm_2"""
+    family = re.sub(r"_\d+$", "", family)
+    return "".join(part.capitalize() for part in family.split("_"))
+
+
+def run_tuners(tuners, platform, device, precisions):
+    """Runs the tuners and returns the best result of each kernel as a
+    dictionary from (device, kernel, precision) to (time, parameters)"""
+    results = {}
+    with tempfile.TemporaryDirectory() as directory:
+        for tuner in tuners:
+            for precision in precisions:
+                command = [tuner, "-platform", str(platform), "-device",
+                           str(device), "-precision", precision]
+                print(" ".join(command), file=sys.stderr)
+                # The tuners fail on the precisions which the device does
+                # not support, which are skipped
+                subprocess.run(command, cwd=directory, stdout=sys.stderr)
+
+        for path in glob.glob(os.path.join(directory, "*.json")):
+            with open(path) as result:
+                tuned = json.load(result)
+            name = tuned.get("device") or tuned.get("clblast_device_name")
+            params = [p for p in tuned["best_parameters"].split()
+                      if not p.startswith("PRECISION=")]
+            key = (name.strip(), kernel_name(tuned["kernel_family"]),
+                   tuned["precision"])
+            time = float(tuned["best_time"])
+            # Several tuners of a family tune the same kernel
+            if key not in results or time < results[key][0]:
+                results[key] = (time, " ".join(params))
+    return results
+
+
+def update_database(path, results):
+    """Replaces the entries of the database with the results"""
+    lines = []
+    if os.path.exists(path):
+        with open(path) as database:
+            for line in database.read().splitlines():
+                fields = line.split("\t")
+                if (not line.startswith("#") and len(fields) == 4 and
+                        tuple(fields[:3]) in results):
+                    continue
+                lines.append(line)
+    for (device, kernel, precision), (_, params) in sorted(results.items()):
+        lines.append("\t".join([device, kernel, precision, params]))
+    with open(path, "w") as database:
+        database.write("\n".join(lines) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--tuners", required=True,
+                        help="The directory of the CLBlast tuners")
+    parser.add_argument("--database", required=True,
+                        help="The tuning database which is updated")
+    parser.add_argument("--platform", type=int, default=0,
+                        help="The index of the OpenCL platform")
+    parser.add_argument("--device", type=int, default=0,
+                        help="The index of the device on the platform")
+    parser.add_argument("--precisions", default="32,64,3232,6464",
+                        help="The precisions which are tuned")
+    args = parser.parse_args()
+
+    # The routine tuners choose between kernels rather than their
+    # parameters, which the database does not hold
+    tuners = sorted(
+        path for path in glob.glob(os.path.join(args.tuners,
+                                                "clblast_tuner_*"))
+        if "routine" not in os.path.basename(path) and
+        os.access(path, os.X_OK))
+    if not tuners:
+        sys.exit("No CLBlast tuners found in %s" % args.tuners)
+
+    results = run_tuners(tuners, args.platform, args.device,
+                         args.precisions.split(","))
+    update_database(args.database, results)
+    print("Wrote %d tuned kernels to %s" % (len(results), args.database))
+
+
+if __name__ == "__main__":
+    main()
@@ -30,6 +30,15 @@ struct kernel_type<common::half> {
 
     using compute = float;
 };
+
+/// The bfloat16 values are read as ushort and converted to float by the
+/// kernels
+template<>
+struct kernel_type<common::bfloat16> {
+    using data    = common::bfloat16;
+    using native  = float;
+    using compute = float;
+};
 }  // namespace common
 
 namespace opencl {
@@ -108,6 +117,10 @@ template<>
 inline const char *shortname<ushort>(bool caps) {
     return caps ? "Q" : "q";
 }
+template<>
+inline const char *shortname<common::bfloat16>(bool caps) {
+    return caps ? "B" : "b";
+}
 
 template<typename T>
 inline const char *getFullName() {
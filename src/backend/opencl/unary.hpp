@@ -81,9 +81,9 @@ Array<T> unaryOp(const Array<T> &in, dim4 outDim = dim4(-1, -1, -1, -1)) {
     using std::array;
 
     auto createUnary = [](array<Node_ptr, 1> &operands) {
-        return common::Node_ptr(new common::UnaryNode(
+        return common::makePooled<common::UnaryNode>(
             static_cast<af::dtype>(dtype_traits<T>::af_type), unaryName<op>(),
-            operands[0], op));
+            operands[0], op);
     };
 
     if (outDim == dim4(-1, -1, -1, -1)) { outDim = in.dims(); }
@@ -96,9 +96,9 @@ Array<char> checkOp(const Array<T> &in, dim4 outDim = dim4(-1, -1, -1, -1)) {
     using common::Node_ptr;
 
     auto createUnary = [](std::array<Node_ptr, 1> &operands) {
-        return Node_ptr(new common::UnaryNode(
+        return common::makePooled<common::UnaryNode>(
             static_cast<af::dtype>(dtype_traits<char>::af_type),
-            unaryName<op>(), operands[0], op));
+            unaryName<op>(), operands[0], op);
     };
 
     if (outDim == dim4(-1, -1, -1, -1)) { outDim = in.dims(); }
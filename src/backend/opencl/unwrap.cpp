@@ -59,4 +59,36 @@ INSTANTIATE(ushort)
 INSTANTIATE(half)
 #undef INSTANTIATE
 
+template<af_op_t op, typename T>
+Array<T> unwrapReduce(const Array<T> &in, const dim_t wx, const dim_t wy,
+                      const dim_t sx, const dim_t sy, const dim_t px,
+                      const dim_t py) {
+    af::dim4 idims = in.dims();
+
+    dim_t nx = 1 + (idims[0] + 2 * px - wx) / sx;
+    dim_t ny = 1 + (idims[1] + 2 * py - wy) / sy;
+
+    Array<T> outArray =
+        createEmptyArray<T>(af::dim4(nx, ny, idims[2], idims[3]));
+    kernel::unwrapReduce<op, T>(outArray, in, wx, wy, sx, sy, px, py);
+
+    return outArray;
+}
+
+#define INSTANTIATE_REDUCE(op, T)                                           \
+    template Array<T> unwrapReduce<op, T>(                                  \
+        const Array<T> &in, const dim_t wx, const dim_t wy, const dim_t sx, \
+        const dim_t sy, const dim_t px, const dim_t py);
+
+#define INSTANTIATE_REDUCE_OPS(T)   \
+    INSTANTIATE_REDUCE(af_add_t, T) \
+    INSTANTIATE_REDUCE(af_mul_t, T) \
+    INSTANTIATE_REDUCE(af_min_t, T) \
+    INSTANTIATE_REDUCE(af_max_t, T)
+
+INSTANTIATE_REDUCE_OPS(float)
+INSTANTIATE_REDUCE_OPS(double)
+#undef INSTANTIATE_REDUCE_OPS
+#undef INSTANTIATE_REDUCE
+
 }  // namespace opencl
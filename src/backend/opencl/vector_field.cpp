@@ -11,25 +11,26 @@
 #include <GraphicsResourceManager.hpp>
 #include <debug_opencl.hpp>
 #include <err_opencl.hpp>
+#include <kernel/interleave.hpp>
 #include <vector_field.hpp>
 
+#include <vector>
+
 using af::dim4;
+using std::vector;
 
 namespace opencl {
 
 template<typename T>
-void copy_vector_field(const Array<T> &points, const Array<T> &directions,
+void copy_vector_field(const vector<Array<T>> &points,
+                       const vector<Array<T>> &directions,
                        fg_vector_field vfield) {
     ForgeModule &_ = graphics::forgePlugin();
+    vector<Param> pParams(points.begin(), points.end());
+    vector<Param> dParams(directions.begin(), directions.end());
+    cl::CommandQueue &queue = interopManager().beginCopy();
     if (isGLSharingSupported()) {
         CheckGL("Begin OpenCL resource copy");
-        const cl::Buffer *d_points     = points.get();
-        const cl::Buffer *d_directions = directions.get();
-        unsigned pBytes                = 0;
-        unsigned dBytes                = 0;
-        FG_CHECK(_.fg_get_vector_field_vertex_buffer_size(&pBytes, vfield));
-        FG_CHECK(_.fg_get_vector_field_direction_buffer_size(&dBytes, vfield));
-
         auto res = interopManager().getVectorFieldResources(vfield);
 
         std::vector<cl::Memory> shared_objects;
@@ -42,18 +43,22 @@ void copy_vector_field(const Array<T> &points, const Array<T> &directions,
         // https://www.khronos.org/registry/cl/sdk/1.1/docs/man/xhtml/clEnqueueReleaseGLObjects.html
         cl::Event event;
 
-        getQueue().enqueueAcquireGLObjects(&shared_objects, NULL, &event);
+        queue.enqueueAcquireGLObjects(&shared_objects, NULL, &event);
         event.wait();
-        getQueue().enqueueCopyBuffer(*d_points, *(res[0].get()), 0, 0, pBytes,
-                                     NULL, &event);
-        getQueue().enqueueCopyBuffer(*d_directions, *(res[1].get()), 0, 0,
-                                     dBytes, NULL, &event);
-        getQueue().enqueueReleaseGLObjects(&shared_objects, NULL, &event);
+        kernel::interleave<T>(*(res[0].get()), pParams, queue);
+        kernel::interleave<T>(*(res[1].get()), dParams, queue);
+        queue.enqueueReleaseGLObjects(&shared_objects, NULL, &event);
         event.wait();
 
-        CL_DEBUG_FINISH(getQueue());
+        CL_DEBUG_FINISH(queue);
         CheckGL("End OpenCL resource copy");
     } else {
+        const dim4 vdims(pParams.size() * points[0].elements());
+        Array<T> pVertices = createEmptyArray<T>(vdims);
+        Array<T> dVertices = createEmptyArray<T>(vdims);
+        kernel::interleave<T>(*pVertices.get(), pParams, queue);
+        kernel::interleave<T>(*dVertices.get(), dParams, queue);
+
         unsigned size1 = 0, size2 = 0;
         unsigned buff1 = 0, buff2 = 0;
         FG_CHECK(_.fg_get_vector_field_vertex_buffer_size(&size1, vfield));
@@ -68,8 +73,7 @@ void copy_vector_field(const Array<T> &points, const Array<T> &directions,
         auto *pPtr =
             static_cast<GLubyte *>(glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY));
         if (pPtr) {
-            getQueue().enqueueReadBuffer(*points.get(), CL_TRUE, 0, size1,
-                                         pPtr);
+            queue.enqueueReadBuffer(*pVertices.get(), CL_TRUE, 0, size1, pPtr);
             glUnmapBuffer(GL_ARRAY_BUFFER);
         }
         glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -79,8 +83,7 @@ void copy_vector_field(const Array<T> &points, const Array<T> &directions,
         auto *dPtr =
             static_cast<GLubyte *>(glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY));
         if (dPtr) {
-            getQueue().enqueueReadBuffer(*directions.get(), CL_TRUE, 0, size2,
-                                         dPtr);
+            queue.enqueueReadBuffer(*dVertices.get(), CL_TRUE, 0, size2, dPtr);
             glUnmapBuffer(GL_ARRAY_BUFFER);
         }
         glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -88,8 +91,9 @@ void copy_vector_field(const Array<T> &points, const Array<T> &directions,
     }
 }
 
-#define INSTANTIATE(T)                                                     \
-    template void copy_vector_field<T>(const Array<T> &, const Array<T> &, \
+#define INSTANTIATE(T)                                           \
+    template void copy_vector_field<T>(const vector<Array<T>> &, \
+                                       const vector<Array<T>> &, \
                                        fg_vector_field);
 
 INSTANTIATE(float)
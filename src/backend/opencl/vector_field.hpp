@@ -10,9 +10,14 @@
 #include <Array.hpp>
 #include <common/graphics_common.hpp>
 
+#include <vector>
+
 namespace opencl {
 
+/// Writes the points and the directions of \p vfield from their x, y and z
+/// components, which are vectors or views of the columns of arrays
 template<typename T>
-void copy_vector_field(const Array<T> &points, const Array<T> &directions,
+void copy_vector_field(const std::vector<Array<T>> &points,
+                       const std::vector<Array<T>> &directions,
                        fg_vector_field vfield);
 }
@@ -23,7 +23,19 @@ Array<uint> where(const Array<T> &in) {
     return createParamArray<uint>(Out, true);
 }
 
-#define INSTANTIATE(T) template Array<uint> where<T>(const Array<T> &in);
+template<typename T>
+Array<T> compact(const Array<T> &in, const Array<char> &mask) {
+    Param Out;
+    Param In   = in;
+    Param Mask = mask;
+    kernel::compact<T>(Out, In, Mask);
+    return createParamArray<T>(Out, true);
+}
+
+#define INSTANTIATE(T)                                 \
+    template Array<uint> where<T>(const Array<T> &in); \
+    template Array<T> compact<T>(const Array<T> &in,   \
+                                 const Array<char> &mask);
 
 INSTANTIATE(float)
 INSTANTIATE(cfloat)
@@ -1093,3 +1093,27 @@ TEST_F(Approx1NullArgs, V2UniformNullPosArray) {
     ASSERT_EQ(AF_ERR_ARG, af_approx1_uniform_v2(&this->out, this->in, 0, 0, 0.0,
                                                 1.0, AF_INTERP_LINEAR, 0.f));
 }
+
+TEST(Approx1Plan, MatchesApprox1) {
+    const af_interp_type methods[] = {
+        AF_INTERP_NEAREST, AF_INTERP_LOWER, AF_INTERP_LINEAR,
+        AF_INTERP_LINEAR_COSINE, AF_INTERP_CUBIC, AF_INTERP_CUBIC_SPLINE};
+
+    array in       = randu(100, 3);
+    array unsorted = randu(500) * 104 - 2;
+    array sorted   = af::range(dim4(420)) * 0.25f - 1;
+    for (af_interp_type method : methods) {
+        af::interpPlan plan(unsorted, 100, method, -1.f);
+        ASSERT_ARRAYS_NEAR(approx1(in, unsorted, method, -1.f),
+                           plan.apply(in), 1e-4);
+
+        af::interpPlan sortedPlan(sorted, 100, method, -1.f);
+        ASSERT_ARRAYS_NEAR(approx1(in, sorted, method, -1.f),
+                           sortedPlan.apply(in), 1e-4);
+    }
+}
+
+TEST(Approx1Plan, InputLength) {
+    af::interpPlan plan(randu(10) * 10, 10);
+    EXPECT_THROW(plan.apply(randu(20)), af::exception);
+}
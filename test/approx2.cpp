@@ -1065,3 +1065,18 @@ TEST_F(Approx2NullArgs, V2UniformNullPos2Array) {
               af_approx2_uniform_v2(&this->out, this->in, this->pos1, 0, 0.0,
                                     1.0, 0, 1, 0.0, 1.0, AF_INTERP_LINEAR, 0));
 }
+
+TEST(Approx2Plan, MatchesApprox2) {
+    const af_interp_type methods[] = {AF_INTERP_NEAREST, AF_INTERP_LOWER,
+                                      AF_INTERP_BILINEAR, AF_INTERP_CUBIC,
+                                      AF_INTERP_BICUBIC_SPLINE};
+
+    array in   = randu(40, 30, 2);
+    array pos0 = randu(20, 10) * 42 - 1;
+    array pos1 = randu(20, 10) * 32 - 1;
+    for (af_interp_type method : methods) {
+        af::interpPlan plan(pos0, pos1, 40, 30, method, -1.f);
+        ASSERT_ARRAYS_NEAR(approx2(in, pos0, pos1, method, -1.f),
+                           plan.apply(in), 1e-4);
+    }
+}
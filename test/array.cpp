@@ -502,6 +502,121 @@ TEST(DeviceId, Different) {
     deviceGC();
 }
 
+TEST(CopyToDevice, SameDevice) {
+    array a = randu(5, 5);
+    array b;
+    af::event e = a.copyToDevice(b, getDevice());
+    e.block();
+
+    ASSERT_EQ(getDevice(), getDeviceId(b));
+    ASSERT_ARRAYS_EQ(a, b);
+}
+
+TEST(CopyToDevice, Different) {
+    int ndevices = getDeviceCount();
+    if (ndevices < 2) return;
+    int id0 = getDevice();
+    int id1 = (id0 + 1) % ndevices;
+
+    {
+        array a = randu(100, 100);
+        array sub = a(seq(10, 50), seq(20, 60));
+        array b;
+        af::event e = sub.copyToDevice(b, id1);
+        ASSERT_EQ(getDevice(), id0);
+        ASSERT_EQ(getDeviceId(b), id1);
+
+        vector<float> gold(sub.elements());
+        sub.host(&gold.front());
+
+        setDevice(id1);
+        e.enqueue();
+        vector<float> out(b.elements());
+        b.host(&out.front());
+        setDevice(id0);
+        ASSERT_EQ(gold, out);
+    }
+
+    setDevice(id1);
+    deviceGC();
+    setDevice(id0);
+    deviceGC();
+}
+
+TEST(Collective, ScatterGather) {
+    array a        = randu(10, 7);
+    int device     = getDevice();
+    int devices[3] = {device, device, device};
+    array parts[3];
+    af::event events[3];
+    scatter(parts, a, 1, 3, devices, events);
+    for (int i = 0; i < 3; ++i) { events[i].block(); }
+
+    ASSERT_EQ(dim4(10, 3), parts[0].dims());
+    ASSERT_EQ(dim4(10, 2), parts[1].dims());
+    ASSERT_EQ(dim4(10, 2), parts[2].dims());
+    ASSERT_ARRAYS_EQ(a(span, seq(3, 4)), parts[1]);
+
+    array b = gather(3, parts, 1, device);
+    ASSERT_ARRAYS_EQ(a, b);
+}
+
+TEST(Collective, AllReduceSum) {
+    array ins[3] = {randu(50, 4), randu(50, 4), randu(50, 4)};
+    array outs[3];
+    allReduce(outs, 3, ins);
+
+    array gold = ins[0] + ins[1] + ins[2];
+    for (int i = 0; i < 3; ++i) { ASSERT_ARRAYS_NEAR(gold, outs[i], 1e-6); }
+}
+
+TEST(Collective, AllReduceMaxFewElements) {
+    // Fewer elements than arrays, so some of the chunks are empty
+    array ins[3] = {randu(2, s32), randu(2, s32), randu(2, s32)};
+    array outs[3];
+    allReduce(outs, 3, ins, AF_BINARY_MAX);
+
+    array gold = max(max(ins[0], ins[1]), ins[2]);
+    for (int i = 0; i < 3; ++i) { ASSERT_ARRAYS_EQ(gold, outs[i]); }
+}
+
+TEST(Collective, AllReduceDevices) {
+    int ndevices = getDeviceCount();
+    if (ndevices < 2) return;
+    int id0 = getDevice();
+
+    {
+        vector<array> ins(ndevices);
+        array gold = constant(0, 1000);
+        for (int i = 0; i < ndevices; ++i) {
+            setDevice(i);
+            ins[i] = range(dim4(1000)) * (i + 1);
+            setDevice(id0);
+            gold += range(dim4(1000)) * (i + 1);
+        }
+
+        vector<array> outs(ndevices);
+        vector<af::event> events(ndevices);
+        allReduce(outs.data(), ndevices, ins.data(), AF_BINARY_ADD,
+                  events.data());
+        for (int i = 0; i < ndevices; ++i) {
+            ASSERT_EQ(i, getDeviceId(outs[i]));
+            vector<float> out(1000);
+            setDevice(i);
+            events[i].enqueue();
+            outs[i].host(out.data());
+            setDevice(id0);
+            ASSERT_VEC_ARRAY_EQ(out, dim4(1000), gold);
+        }
+    }
+
+    for (int i = 0; i < ndevices; ++i) {
+        setDevice(i);
+        deviceGC();
+    }
+    setDevice(id0);
+}
+
 TEST(Device, empty) {
     array a = array();
     ASSERT_EQ(a.device<float>() == NULL, 1);
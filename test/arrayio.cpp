@@ -12,7 +12,9 @@
 
 #include <testHelpers.hpp>
 
+#include <cmath>
 #include <complex>
+#include <fstream>
 #include <string>
 #include <vector>
 
@@ -125,3 +127,201 @@ TEST(ArrayIO, Save) {
     ASSERT_ARRAYS_EQ(a, aread);
     ASSERT_ARRAYS_EQ(b, bread);
 }
+
+TEST(ArrayIO, SaveOverwritesReadArrays) {
+    array a = af::randu(100, 10);
+    array b = af::randu(10, 3, f64);
+
+    saveArray("a", a, "overwrite.af");
+    saveArray("b", b, "overwrite.af", true);
+    array aread = readArray("overwrite.af", "a");
+    array bread = readArray("overwrite.af", 1);
+
+    // Arrays read from the file keep their values when the file is replaced
+    array c = constant(3, 5, 5, s32);
+    saveArray("c", c, "overwrite.af");
+    ASSERT_ARRAYS_EQ(a, aread);
+    ASSERT_ARRAYS_EQ(b, bread);
+
+    ASSERT_EQ(-1, af::readArrayCheck("overwrite.af", "a"));
+    ASSERT_ARRAYS_EQ(c, readArray("overwrite.af", "c"));
+}
+
+TEST(ArrayIO, ModifyReadArray) {
+    array a = constant(1, 10, 10);
+    saveArray("a", a, "modify.af");
+
+    array aread = readArray("modify.af", "a");
+    aread(0, 0) = 5;
+    aread += 1;
+
+    // Modifying an array does not change the file or other reads of it
+    ASSERT_ARRAYS_EQ(a, readArray("modify.af", "a"));
+    ASSERT_ARRAYS_EQ(constant(2, 9, 10), aread(af::seq(1, 9), af::span));
+}
+
+TEST(ArrayIO, ReadManyKeys) {
+    const int n = 200;
+    for (int i = 0; i < n; i++) {
+        saveArray(std::to_string(i).c_str(), constant(i, 3, 2), "keys.af",
+                  i > 0);
+    }
+    for (int i = n - 1; i >= 0; i -= 7) {
+        ASSERT_EQ(i, af::readArrayCheck("keys.af", std::to_string(i).c_str()));
+        ASSERT_ARRAYS_EQ(constant(i, 3, 2),
+                         readArray("keys.af", std::to_string(i).c_str()));
+    }
+}
+
+TEST(ArrayIO, SaveChunked) {
+    array a = af::randu(10, 100);
+    array b = af::randu(7, 3, 5, f64);
+    array c = af::range(dim4(1000), 0, s32);
+
+    // The chunks hold 4 columns of a
+    ASSERT_EQ(0, af::saveArrayChunked("a", a, "chunked.af", false,
+                                      AF_COMPRESSION_NONE, 160));
+    ASSERT_EQ(1, af::saveArrayChunked("b", b, "chunked.af", true,
+                                      AF_COMPRESSION_NONE, 100));
+    ASSERT_EQ(2, af::saveArrayChunked("c", c, "chunked.af", true));
+
+    ASSERT_ARRAYS_EQ(a, readArray("chunked.af", "a"));
+    ASSERT_ARRAYS_EQ(b, readArray("chunked.af", 1));
+    ASSERT_ARRAYS_EQ(c, readArray("chunked.af", "c"));
+    ASSERT_EQ(2, af::readArrayCheck("chunked.af", "c"));
+}
+
+TEST(ArrayIO, SaveChunkedAppendToArrayFile) {
+    saveArray("a", constant(1, 10, 10), "unchunked.af");
+    ASSERT_THROW(af::saveArrayChunked("b", constant(2, 10, 10),
+                                      "unchunked.af", true),
+                 af::exception);
+}
+
+TEST(ArrayIO, SaveAsync) {
+    array a = af::randu(10, 100);
+    array b = af::range(dim4(1000), 0, s32);
+    array c = a(af::seq(2, 7), af::span);
+
+    af_save_handle ha = af::saveArrayAsync("a", a, "async.af");
+    af_save_handle hb = af::saveArrayAsync("b", b, "async.af", true);
+    af_save_handle hc = af::saveArrayAsync("c", c, "async.af", true);
+
+    // The saves write the arrays as they were when they were started
+    array saved = a.copy();
+    a(0, 0)     = 5;
+
+    ASSERT_EQ(0, af::waitSave(ha));
+    ASSERT_EQ(1, af::waitSave(hb));
+    ASSERT_EQ(2, af::waitSave(hc));
+
+    ASSERT_ARRAYS_EQ(saved, readArray("async.af", "a"));
+    ASSERT_ARRAYS_EQ(b, readArray("async.af", 1));
+    ASSERT_ARRAYS_EQ(c, readArray("async.af", "c"));
+}
+
+TEST(ArrayIO, ReadRange) {
+    array a = af::randu(10, 100);
+    af::saveArrayChunked("a", a, "range.af", false, AF_COMPRESSION_NONE, 160);
+    saveArray("a", a, "range_unchunked.af");
+
+    for (const char *file : {"range.af", "range_unchunked.af"}) {
+        ASSERT_ARRAYS_EQ(a(af::span, af::seq(13, 58)),
+                         af::readArrayRange(file, 0, af::span,
+                                            af::seq(13, 58)));
+        ASSERT_ARRAYS_EQ(a(af::seq(2, 5), af::seq(90, af::end)),
+                         af::readArrayRange(file, 0, af::seq(2, 5),
+                                            af::seq(90, af::end)));
+        ASSERT_ARRAYS_EQ(a(af::seq(3, 17), af::seq(70, 20, -5)),
+                         af::readArrayRange(file, 0, af::seq(3, 17),
+                                            af::seq(70, 20, -5)));
+        ASSERT_ARRAYS_EQ(a(af::seq(35, 171)),
+                         af::readArrayRange(file, 0, af::seq(35, 171)));
+        ASSERT_THROW(af::readArrayRange(file, 0, af::span, af::seq(90, 100)),
+                     af::exception);
+    }
+}
+
+TEST(ArrayIO, SaveChunkedCompressed) {
+    array a = af::range(dim4(100, 300), 1, u16);
+    for (af::compressionType compression :
+         {AF_COMPRESSION_LZ4, AF_COMPRESSION_ZSTD}) {
+        try {
+            af::saveArrayChunked("a", a, "compressed.af", false, compression,
+                                 2000);
+        } catch (af::exception &ex) {
+            // The compression libraries are optional
+            if (ex.err() == AF_ERR_NOT_CONFIGURED ||
+                ex.err() == AF_ERR_LOAD_LIB) {
+                continue;
+            }
+            throw;
+        }
+        ASSERT_ARRAYS_EQ(a, readArray("compressed.af", "a"));
+        ASSERT_ARRAYS_EQ(a(af::span, af::seq(25, 107)),
+                         af::readArrayRange("compressed.af", 0, af::span,
+                                            af::seq(25, 107)));
+    }
+}
+
+TEST(ArrayIO, ReadMtx) {
+    {
+        std::ofstream file("read.mtx");
+        file << "%%MatrixMarket matrix coordinate real symmetric\n"
+             << "% A comment\n"
+             << "3 3 4\n"
+             << "1 1 1.5\n"
+             << "3 1 2\n"
+             << "2 2 -3\n"
+             << "3 2 4e1\n";
+    }
+    array a = af::readMtx("read.mtx", f64);
+    ASSERT_TRUE(a.issparse());
+    ASSERT_EQ(AF_STORAGE_CSR, af::sparseGetStorage(a));
+    ASSERT_EQ(6, af::sparseGetNNZ(a));
+
+    const double gold[] = {1.5, 0, 2, 0, -3, 40, 2, 40, 0};
+    ASSERT_VEC_ARRAY_EQ(vector<double>(gold, gold + 9), dim4(3, 3),
+                        af::dense(a));
+    ASSERT_THROW(af::readMtx("read.mtx", s32), af::exception);
+}
+
+TEST(ArrayIO, ReadMtxArray) {
+    {
+        std::ofstream file("read_array.mtx");
+        file << "%%MatrixMarket matrix array real general\n"
+             << "2 3\n"
+             << "1\n2\n3\n4\n5\n6\n";
+    }
+    array a = af::readMtx("read_array.mtx");
+    ASSERT_FALSE(a.issparse());
+    ASSERT_ARRAYS_EQ(af::moddims(af::range(dim4(6), 0, f32) + 1, 2, 3), a);
+}
+
+TEST(ArrayIO, ReadCsv) {
+    {
+        std::ofstream file("read.csv");
+        file << "x,y,z\n"
+             << "1, 2.5 ,3\r\n"
+             << "4,,6\n"
+             << "\n"
+             << "7,8,9\n";
+    }
+    array a = af::readCsv("read.csv", f32, ',', 1);
+    ASSERT_EQ(dim4(3, 3), a.dims());
+
+    vector<float> ha(a.elements());
+    a.host(ha.data());
+    EXPECT_EQ(2.5f, ha[3]);
+    EXPECT_TRUE(std::isnan(ha[4]));
+    EXPECT_EQ(9.f, ha[8]);
+
+    // The header is not a number
+    ASSERT_THROW(af::readCsv("read.csv", f32), af::exception);
+
+    {
+        std::ofstream file("read_ragged.csv");
+        file << "1,2\n3\n";
+    }
+    ASSERT_THROW(af::readCsv("read_ragged.csv", s32), af::exception);
+}
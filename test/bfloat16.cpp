@@ -0,0 +1,197 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <gtest/gtest.h>
+#include <testHelpers.hpp>
+
+#include <limits>
+#include <vector>
+
+using af::array;
+using af::bfloat16;
+using af::constant;
+using af::dim4;
+using af::matmul;
+using af::randu;
+using af::range;
+using std::vector;
+
+namespace {
+/// Returns the bfloat16 value whose bits are \p bits
+bfloat16 fromBits(unsigned short bits) {
+    bfloat16 out;
+    out.data_ = bits;
+    return out;
+}
+}  // namespace
+
+struct bf16_convert_params {
+    af_dtype from, to;
+    double value;
+    bf16_convert_params(af_dtype f, af_dtype t, double v)
+        : from(f), to(t), value(v) {}
+};
+
+class BFloat16Convert : public ::testing::TestWithParam<bf16_convert_params> {
+};
+
+INSTANTIATE_TEST_CASE_P(
+    ToBF16, BFloat16Convert,
+    ::testing::Values(bf16_convert_params(f32, bf16, 10),
+                      bf16_convert_params(f64, bf16, 10),
+                      bf16_convert_params(f16, bf16, 10),
+                      bf16_convert_params(s32, bf16, 10),
+                      bf16_convert_params(u32, bf16, 10),
+                      bf16_convert_params(u8, bf16, 10),
+                      bf16_convert_params(b8, bf16, 1),
+                      bf16_convert_params(s64, bf16, 10),
+                      bf16_convert_params(u64, bf16, 10),
+                      bf16_convert_params(s16, bf16, 10),
+                      bf16_convert_params(u16, bf16, 10),
+                      bf16_convert_params(bf16, bf16, 10)));
+
+INSTANTIATE_TEST_CASE_P(
+    FromBF16, BFloat16Convert,
+    ::testing::Values(bf16_convert_params(bf16, f32, 10),
+                      bf16_convert_params(bf16, f64, 10),
+                      bf16_convert_params(bf16, f16, 10),
+                      bf16_convert_params(bf16, s32, 10),
+                      bf16_convert_params(bf16, u32, 10),
+                      bf16_convert_params(bf16, u8, 10),
+                      bf16_convert_params(bf16, b8, 1),
+                      bf16_convert_params(bf16, s64, 10),
+                      bf16_convert_params(bf16, u64, 10),
+                      bf16_convert_params(bf16, s16, 10),
+                      bf16_convert_params(bf16, u16, 10)));
+
+TEST_P(BFloat16Convert, convert) {
+    bf16_convert_params params = GetParam();
+    if (params.from == f16 || params.to == f16) {
+        SUPPORTED_TYPE_CHECK(af_half);
+    }
+    if (params.from == f64 || params.to == f64) {
+        SUPPORTED_TYPE_CHECK(double);
+    }
+
+    array from = constant(params.value, 3, 3, params.from);
+    array to   = from.as(params.to);
+
+    ASSERT_EQ(from.type(), params.from);
+    ASSERT_EQ(to.type(), params.to);
+
+    array gold = constant(params.value, 3, 3, params.to);
+    ASSERT_ARRAYS_EQ(gold.as(f32), to.as(f32));
+}
+
+TEST(BFloat16, RoundsToNearestEven) {
+    // 1 + 2^-8 is halfway between 1 and the next bfloat16 value, and rounds
+    // to 1. 1 + 3 * 2^-8 rounds up to the even 1 + 2^-6.
+    vector<float> in = {1.f, 1.00390625f, 1.01171875f, -2.f, 65536.f};
+    vector<unsigned short> gold = {0x3F80, 0x3F80, 0x3F82, 0xC000, 0x4780};
+
+    array b = array(dim4(in.size()), in.data()).as(bf16);
+    vector<bfloat16> out(in.size());
+    b.host(out.data());
+
+    for (size_t i = 0; i < in.size(); ++i) {
+        EXPECT_EQ(gold[i], out[i].data_) << "at index " << i;
+    }
+}
+
+TEST(BFloat16, HostRoundTrip) {
+    vector<bfloat16> in = {fromBits(0x3F80), fromBits(0x4000),
+                           fromBits(0xBF00), fromBits(0x7F80)};
+    array b(dim4(in.size()), in.data());
+    ASSERT_EQ(bf16, b.type());
+
+    const float inf    = std::numeric_limits<float>::infinity();
+    vector<float> gold = {1.f, 2.f, -0.5f, inf};
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(in.size()), b.as(f32));
+}
+
+TEST(BFloat16, NotFromComplex) {
+    array c = randu(3, c32);
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_TYPE, af_cast(&out, c.get(), bf16));
+}
+
+TEST(BFloat16, Arith) {
+    array a = constant(1.5, 3, 3, bf16);
+    array b = constant(2.25, 3, 3, bf16);
+
+    array sum  = a + b;
+    array prod = a * b;
+    ASSERT_EQ(bf16, sum.type());
+    ASSERT_EQ(bf16, prod.type());
+    ASSERT_EQ(bf16, (a * 2.0).type());
+
+    ASSERT_ARRAYS_EQ(constant(3.75, 3, 3), sum.as(f32));
+    ASSERT_ARRAYS_EQ(constant(3.375, 3, 3), prod.as(f32));
+    ASSERT_ARRAYS_EQ(constant(true, 3, 3, b8), a < b);
+}
+
+TEST(BFloat16, ArithRoundsOnce) {
+    // The float sum of the three values is 1 + 2^-7, which is exact. Rounding
+    // each partial sum to bfloat16 would return 1.
+    array a = constant(1, 10, bf16);
+    array b = constant(1.f / 256, 10, bf16);
+
+    array res = a + b + b;
+    ASSERT_ARRAYS_EQ(constant(1.f + 1.f / 128, 10), res.as(f32));
+}
+
+TEST(BFloat16, SumAccumulatesInFloat) {
+    // A bfloat16 accumulator stops increasing at 256
+    array b = constant(1, 1000, bf16);
+
+    array res = af::sum(b);
+    ASSERT_EQ(f32, res.type());
+    ASSERT_EQ(1000.f, res.scalar<float>());
+    ASSERT_EQ(1000.f, af::sum<float>(b));
+}
+
+TEST(BFloat16, SumDims) {
+    array a = range(dim4(16, 8), 1) - 4;
+    array b = a.as(bf16);
+
+    ASSERT_ARRAYS_EQ(af::sum(a, 1), af::sum(b, 1));
+    ASSERT_ARRAYS_EQ(af::sum(a, 0), af::sum(b, 0));
+}
+
+TEST(BFloat16, Product) {
+    array b = constant(2, 20, bf16);
+
+    ASSERT_EQ(1048576.f, af::product<float>(b));
+}
+
+TEST(BFloat16, Matmul) {
+    // The small integers and their products are exact in bfloat16
+    array a = af::floor(randu(32, 16) * 8);
+    array b = af::floor(randu(16, 24) * 8);
+
+    array res = matmul(a.as(bf16), b.as(bf16));
+    ASSERT_EQ(bf16, res.type());
+    ASSERT_ARRAYS_EQ(matmul(a, b), res.as(f32));
+}
+
+TEST(BFloat16, GemmF32Output) {
+    array a = af::floor(randu(32, 16) * 8);
+    array b = af::floor(randu(16, 24) * 8);
+
+    const float alpha = 1.f;
+    const float beta  = 0.f;
+    af_array out      = 0;
+    ASSERT_SUCCESS(af_gemm_v2(&out, AF_MAT_NONE, AF_MAT_NONE, &alpha,
+                              a.as(bf16).get(), b.as(bf16).get(), &beta,
+                              AF_GEMM_COMPUTE_F32));
+    array res(out);
+    ASSERT_EQ(f32, res.type());
+    ASSERT_ARRAYS_EQ(matmul(a, b), res);
+}
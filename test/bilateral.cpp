@@ -200,3 +200,25 @@ TEST(bilateral, GFOR) {
         ASSERT_EQ(max<double>(abs(c_ii - b_ii)) < 1E-5, true);
     }
 }
+
+using af::bilateralGrid;
+using af::randu;
+
+TEST(BilateralGrid, PreservesEdges) {
+    // A step of 100 across the columns with noise of +-1
+    const dim4 dims(64, 64, 2);
+    array step  = (iota(dim4(1, 64), dim4(64, 1, 2)) >= 32).as(f32) * 100;
+    array noisy = step + randu(dims) * 2 - 1;
+
+    array out = bilateralGrid(noisy, 4.f, 10.f);
+    ASSERT_EQ(out.dims(), dims);
+    ASSERT_LT(max<float>(abs(out - step)), 1.f);
+}
+
+TEST(BilateralGrid, InvalidArgs) {
+    array in     = randu(16, 16);
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_ARG, af_bilateral_grid(&out, in.get(), 0.f, 1.f, 1.f));
+    ASSERT_EQ(AF_ERR_ARG, af_bilateral_grid(&out, in.get(), 1.f, 1.f, 0.f));
+    ASSERT_EQ(AF_ERR_ARG, af_bilateral_grid(&out, in.get(), 1.f, 1.f, 2.f));
+}
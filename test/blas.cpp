@@ -32,6 +32,7 @@ using af::max;
 using af::randu;
 using af::setDevice;
 using af::span;
+using af::tile;
 using af::transpose;
 using std::copy;
 using std::cout;
@@ -799,3 +800,227 @@ TEST(MatrixMultiply, SameInput) {
     array out = matmul(a, a);
     ASSERT_VEC_ARRAY_NEAR(hgold, dim4(dim, dim), out, 1e-4);
 }
+
+TEST(MatrixMultiply, BatchedBroadcast) {
+    // Covers the evenly spaced batches of the strided batched GEMM and the
+    // broadcasts which are not evenly spaced
+    array a  = randu(16, 8);
+    array a3 = randu(16, 8, 2);
+    array b  = randu(8, 4, 2, 3);
+
+    array c  = matmul(a, b);
+    array c3 = matmul(a3, b);
+    for (int j = 0; j < 3; j++) {
+        for (int i = 0; i < 2; i++) {
+            array b_ij = b(span, span, i, j);
+            ASSERT_ARRAYS_NEAR(matmul(a, b_ij), c(span, span, i, j),
+                               batch_tol);
+            ASSERT_ARRAYS_NEAR(matmul(a3(span, span, i), b_ij),
+                               c3(span, span, i, j), batch_tol);
+        }
+    }
+}
+
+TEST(MatrixMultiply, SmallBatchedTransposed) {
+    // Covers the small batched products of the CPU backend, for a size with
+    // a fixed microkernel and one without, with broadcasts and conjugates
+    for (int m : {8, 5}) {
+        array a = randu(7, m, 6, c32);
+        array b = randu(3, 7, c32);
+        array c = matmul(a, b, AF_MAT_CTRANS, AF_MAT_TRANS);
+        ASSERT_EQ(dim4(m, 3, 6), c.dims());
+        for (int i = 0; i < 6; i++) {
+            ASSERT_ARRAYS_NEAR(
+                matmul(a(span, span, i), b, AF_MAT_CTRANS, AF_MAT_TRANS),
+                c(span, span, i), batch_tol);
+        }
+    }
+}
+
+TEST(Gemm, FusedBiasRelu) {
+    array a    = randu(20, 10) - 0.5;
+    array b    = randu(10, 15) - 0.5;
+    array bias = randu(20) - 0.5;
+
+    array out  = matmul(a, b, bias, AF_GEMM_EPILOGUE_RELU);
+    array gold = max(matmul(a, b) + tile(bias, 1, 15), 0.0);
+    ASSERT_ARRAYS_NEAR(gold, out, 1e-5);
+}
+
+TEST(Gemm, FusedGeluBatched) {
+    array a = randu(20, 10, 3) - 0.5;
+    array b = randu(10, 15, 3) - 0.5;
+
+    array out  = matmul(a, b, array(), AF_GEMM_EPILOGUE_GELU);
+    array x    = matmul(a, b);
+    array gold = 0.5 * x * (1 + tanh(0.7978845608028654 *
+                                     (x + 0.044715 * x * x * x)));
+    ASSERT_ARRAYS_NEAR(gold, out, 1e-5);
+}
+
+TEST(Gemm, FusedAlphaBeta) {
+    array a    = randu(20, 10);
+    array b    = randu(10, 15);
+    array bias = randu(20);
+    array c    = constant(1, 20, 15);
+
+    af_array out = 0;
+    ASSERT_SUCCESS(af_retain_array(&out, c.get()));
+    float alpha = 2.f;
+    float beta  = 1.f;
+    ASSERT_SUCCESS(af_gemm_fused(&out, AF_MAT_NONE, AF_MAT_NONE, &alpha,
+                                 a.get(), b.get(), &beta, bias.get(),
+                                 AF_GEMM_EPILOGUE_NONE));
+
+    array gold = 2 * matmul(a, b) + 1 + tile(bias, 1, 15);
+    ASSERT_ARRAYS_NEAR(gold, array(out), 1e-5);
+}
+
+TEST(Gemm, FusedComplexActivation) {
+    array a = randu(4, 4, c32);
+    array b = randu(4, 4, c32);
+
+    af_array out = 0;
+    cfloat alpha(1.f);
+    cfloat beta(0.f);
+    ASSERT_EQ(AF_ERR_NOT_SUPPORTED,
+              af_gemm_fused(&out, AF_MAT_NONE, AF_MAT_NONE, &alpha, a.get(),
+                            b.get(), &beta, 0, AF_GEMM_EPILOGUE_RELU));
+}
+
+TEST(Gemm, FusedBiasSize) {
+    array a    = randu(4, 3);
+    array b    = randu(3, 5);
+    array bias = randu(5);
+
+    af_array out = 0;
+    float alpha  = 1.f;
+    float beta   = 0.f;
+    ASSERT_EQ(AF_ERR_SIZE,
+              af_gemm_fused(&out, AF_MAT_NONE, AF_MAT_NONE, &alpha, a.get(),
+                            b.get(), &beta, bias.get(),
+                            AF_GEMM_EPILOGUE_NONE));
+}
+
+TEST(Gemm, MixedF16AccumulateF32) {
+    SUPPORTED_TYPE_CHECK(half_float::half);
+    array a = (randu(64, 256) - 0.5).as(f16);
+    array b = (randu(256, 32) - 0.5).as(f16);
+
+    array out = matmul(a, b, AF_GEMM_COMPUTE_F32);
+    ASSERT_EQ(f32, out.type());
+
+    array gold = matmul(a.as(f32), b.as(f32));
+    ASSERT_ARRAYS_NEAR(gold, out, 1e-3);
+}
+
+TEST(Gemm, MixedF16OutputF16) {
+    SUPPORTED_TYPE_CHECK(half_float::half);
+    array a = (randu(16, 32, 2) - 0.5).as(f16);
+    array b = (randu(32, 8, 2) - 0.5).as(f16);
+    array c = constant(1, 16, 8, 2, f16);
+
+    af_array out = 0;
+    ASSERT_SUCCESS(af_retain_array(&out, c.get()));
+    const half_float::half alpha(1.0f);
+    const half_float::half beta(1.0f);
+    ASSERT_SUCCESS(af_gemm_v2(&out, AF_MAT_NONE, AF_MAT_NONE, &alpha, a.get(),
+                              b.get(), &beta, AF_GEMM_COMPUTE_F32));
+    ASSERT_EQ(f16, array(out).type());
+
+    array gold = matmul(a.as(f32), b.as(f32)) + 1;
+    ASSERT_ARRAYS_NEAR(gold, array(out).as(f32), 1e-2);
+}
+
+TEST(Gemm, MixedTF32) {
+    array a = randu(64, 128);
+    array b = randu(128, 32);
+
+    // TF32 keeps 10 bits of the mantissa of the inputs
+    array out  = matmul(a, b, AF_GEMM_COMPUTE_TF32);
+    array gold = matmul(a, b);
+    ASSERT_EQ(f32, out.type());
+    ASSERT_ARRAYS_NEAR(gold, out, 0.1);
+}
+
+TEST(Gemm, MixedOutputType) {
+    SUPPORTED_TYPE_CHECK(half_float::half);
+    array a = randu(4, 4, f16);
+    array b = randu(4, 4, f16);
+    array c = constant(0, 4, 4, f64);
+
+    af_array out = 0;
+    ASSERT_SUCCESS(af_retain_array(&out, c.get()));
+    double alpha = 1.0;
+    double beta  = 0.0;
+    ASSERT_EQ(AF_ERR_DIFF_TYPE,
+              af_gemm_v2(&out, AF_MAT_NONE, AF_MAT_NONE, &alpha, a.get(),
+                         b.get(), &beta, AF_GEMM_COMPUTE_F32));
+    ASSERT_SUCCESS(af_release_array(out));
+}
+
+TEST(Gemm, Quantized) {
+    array a = af::floor(randu(40, 64) * 256).as(u8);
+    array b = af::floor(randu(64, 24) * 256).as(u8);
+
+    // The float products are exact below 2^24
+    array out = af::matmulQuantized(a, b, 120, 3);
+    ASSERT_EQ(s32, out.type());
+
+    array gold = matmul(a.as(f32) - 120, b.as(f32) - 3);
+    ASSERT_ARRAYS_EQ(gold.as(s32), out);
+}
+
+TEST(Gemm, QuantizedTransposedBatched) {
+    array a = af::floor(randu(33, 17, 3) * 256).as(u8);
+    array b = af::floor(randu(19, 33) * 256).as(u8);
+
+    array out = af::matmulQuantized(a, b, 128, 255, AF_MAT_TRANS, AF_MAT_TRANS);
+    ASSERT_EQ(dim4(17, 19, 3), out.dims());
+
+    array gold = matmul(a.as(f32) - 128, tile(b.as(f32) - 255, 1, 1, 3),
+                        AF_MAT_TRANS, AF_MAT_TRANS);
+    ASSERT_ARRAYS_EQ(gold.as(s32), out);
+}
+
+TEST(Gemm, QuantizedInvalid) {
+    array a = randu(4, 4);
+    array b = af::floor(randu(4, 4) * 256).as(u8);
+
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_TYPE, af_matmul_quantized(&out, a.get(), a.get(), 0, 0,
+                                               AF_MAT_NONE, AF_MAT_NONE));
+    ASSERT_EQ(AF_ERR_ARG, af_matmul_quantized(&out, b.get(), b.get(), 256, 0,
+                                              AF_MAT_NONE, AF_MAT_NONE));
+}
+
+TEST(Gemm, QuantizeDequantizePerChannel) {
+    array x = randu(16, 8) * 4 - 2;
+
+    // One scale and zero point per row. The error is at most one scale.
+    array lo    = af::min(x, 1);
+    array hi    = af::max(x, 1);
+    array scale = (hi - lo) / 255;
+    array zero  = af::round(-lo / scale);
+
+    array q = af::quantize(x, scale, zero, 0);
+    ASSERT_EQ(u8, q.type());
+
+    array y = af::dequantize(q, scale, zero, 0);
+    ASSERT_EQ(f32, y.type());
+    ASSERT_ARRAYS_NEAR(x, y, 4.f / 255 + 1e-5);
+}
+
+TEST(Gemm, QuantizedDequantizedProduct) {
+    array a = randu(32, 48);
+    array b = randu(48, 16);
+
+    const float sa = 1.f / 255;
+    const float sb = 1.f / 255;
+    array qa       = af::quantize(a, constant(sa, 1), array());
+    array qb       = af::quantize(b, constant(sb, 1), array());
+
+    array out = af::dequantize(af::matmulQuantized(qa, qb, 0, 0),
+                               constant(sa * sb, 1), array());
+    ASSERT_ARRAYS_NEAR(matmul(a, b), out, 0.1);
+}
@@ -171,6 +171,49 @@ TEST(CannyEdgeDetector, OtsuThreshold) {
                               false);
 }
 
+TEST(CannyEdgeDetector, WeakEdgeAcrossImage) {
+    // A step along the rows which is strong in the first columns only. The
+    // weak part of the step is kept because it is connected to the strong
+    // one through all the columns.
+    const int rows  = 64;
+    const int cols  = 1024;
+    af::array step  = (af::range(dim4(rows, cols)) >= rows / 2).as(f32);
+    af::array level = af::constant(60.f, rows, cols);
+    level(af::span, af::seq(16)) = 255.f;
+
+    af::array out =
+        af::canny(step * level, AF_CANNY_THRESHOLD_MANUAL, 0.1f, 0.5f);
+
+    af::array edgeColumns = af::anyTrue(out, 0);
+    af::array inner       = edgeColumns(af::seq(4, cols - 5));
+    ASSERT_TRUE(af::allTrue<bool>(inner));
+}
+
+TEST(CannyEdgeDetector, Batched) {
+    // The slices are different noise images which contain the same strong
+    // block. The largest gradient is on the corners of the block, so the
+    // thresholds of every slice are the same as when it is alone.
+    const int rows = 48;
+    const int cols = 40;
+    af::array in   = af::randu(rows, cols, 2, 3) * 100.f;
+    in(af::seq(5, 25), af::seq(5, 25), af::span, af::span)   = 0.f;
+    in(af::seq(10, 20), af::seq(10, 20), af::span, af::span) = 1000.f;
+
+    af::array out =
+        af::canny(in, AF_CANNY_THRESHOLD_MANUAL, 0.05f, 0.2f, 3, false);
+    ASSERT_EQ(dim4(rows, cols, 2, 3), out.dims());
+
+    for (int w = 0; w < 3; ++w) {
+        for (int z = 0; z < 2; ++z) {
+            af::array gold = af::canny(in(af::span, af::span, z, w),
+                                       AF_CANNY_THRESHOLD_MANUAL, 0.05f, 0.2f,
+                                       3, false);
+            af::array slice = out(af::span, af::span, z, w);
+            ASSERT_ARRAYS_EQ(gold, slice);
+        }
+    }
+}
+
 TEST(CannyEdgeDetector, InvalidSizeArray) {
     af_array inArray  = 0;
     af_array outArray = 0;
@@ -32,7 +32,8 @@ using std::string;
 using std::vector;
 
 template<typename T>
-void choleskyTester(const int n, double eps, bool is_upper) {
+void choleskyTester(const int n, double eps, bool is_upper,
+                    const int batch = 1) {
     SUPPORTED_TYPE_CHECK(T);
     if (noLAPACKTests()) return;
 
@@ -40,11 +41,11 @@ void choleskyTester(const int n, double eps, bool is_upper) {
 
     // Prepare positive definite matrix
 #if 1
-    array a = cpu_randu<T>(dim4(n, n));
+    array a = cpu_randu<T>(dim4(n, n, batch));
 #else
     array a = randu(n, n, ty);
 #endif
-    array b  = 10 * n * identity(n, n, ty);
+    array b  = 10 * n * identity(dim4(n, n, batch), ty);
     array in = matmul(a.H(), a) + b;
 
     //! [ex_chol_reg]
@@ -134,3 +135,30 @@ TYPED_TEST(Cholesky, LowerMultipleOfTwo) {
 TYPED_TEST(Cholesky, LowerMultipleOfTwoLarge) {
     choleskyTester<TypeParam>(1024, eps<TypeParam>(), false);
 }
+
+TYPED_TEST(Cholesky, UpperBatched) {
+    choleskyTester<TypeParam>(8, eps<TypeParam>(), true, 64);
+}
+
+TYPED_TEST(Cholesky, LowerBatched) {
+    choleskyTester<TypeParam>(8, eps<TypeParam>(), false, 64);
+}
+
+TYPED_TEST(Cholesky, UpperBatchedLarge) {
+    choleskyTester<TypeParam>(40, eps<TypeParam>(), true, 6);
+}
+
+TYPED_TEST(Cholesky, LowerBatchedLarge) {
+    choleskyTester<TypeParam>(40, eps<TypeParam>(), false, 6);
+}
+
+TEST(Cholesky, BatchedInfo) {
+    if (noLAPACKTests()) return;
+
+    // The second matrix is not positive definite from its third row
+    array in    = identity(dim4(4, 4, 3), f32);
+    in(2, 2, 1) = -1;
+
+    array out;
+    ASSERT_EQ(3, cholesky(out, in, true));
+}
@@ -198,3 +198,30 @@ INSTANTIATE_TEST_CASE_P(
            << info.param.iterations << "_replace_" << info.param.replace;
         return ss.str();
     });
+
+TEST(ConfidenceConnected, Serpentine) {
+    // A corridor which winds through the columns of the image, joined at
+    // alternating ends, and a separate column that must not be segmented
+    const int rows = 64;
+    const int cols = 33;
+    vector<unsigned char> img(rows * cols, 0);
+    for (int y = 0; y < cols - 3; ++y) {
+        if (y % 2 == 0) {
+            for (int x = 0; x < rows; ++x) { img[x + y * rows] = 200; }
+        } else {
+            img[(y % 4 == 1 ? 0 : rows - 1) + y * rows] = 200;
+        }
+    }
+    for (int x = 0; x < rows; ++x) { img[x + (cols - 1) * rows] = 200; }
+
+    vector<unsigned char> gold(img);
+    for (int x = 0; x < rows; ++x) { gold[x + (cols - 1) * rows] = 0; }
+    for (auto &val : gold) { val = (val ? 255 : 0); }
+
+    af::array in(rows, cols, img.data());
+    af::array seedx = af::constant(0, 1, u32);
+    af::array seedy = af::constant(0, 1, u32);
+    af::array out   = af::confidenceCC(in, seedx, seedy, 0, 1, 2, 255.0);
+
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(rows, cols), out);
+}
@@ -177,3 +177,12 @@ TYPED_TEST(Constant, IdentityCPP) { IdentityCPPCheck<TypeParam>(); }
 TYPED_TEST(Constant, IdentityLargeDim) { IdentityLargeDimCheck<TypeParam>(); }
 
 TYPED_TEST(Constant, IdentityCPPError) { IdentityCPPError<TypeParam>(); }
+
+TEST(Constant, IdentityFused) {
+    const int num = 7;
+    array out     = identity(num, num) * 3 + 1;
+
+    vector<float> gold(num * num, 1.f);
+    for (int i = 0; i < num; i++) { gold[i * num + i] = 4.f; }
+    ASSERT_VEC_ARRAY_EQ(gold, af::dim4(num, num), out);
+}
@@ -1177,3 +1177,89 @@ TEST(ConvolveNN, ZeroPadding_Issue2817) {
     ASSERT_EQ(sum<float>(abs(signal(seq(1, 3), seq(1, 3)) - convolved)) < 1E-5,
               true);
 }
+
+TEST(Convolve, NNMatchesSpatial) {
+    // The GEMM method of AF_CONV_AUTO pads the signal symmetrically
+    array signal = randu(20, 15);
+    array filter = randu(5, 3);
+
+    array same =
+        convolve2NN(signal, filter, dim4(1, 1), dim4(2, 1), dim4(1, 1));
+    ASSERT_ARRAYS_NEAR(convolve2(signal, filter, AF_CONV_DEFAULT,
+                                 AF_CONV_SPATIAL),
+                       same, 1E-5);
+
+    array expanded =
+        convolve2NN(signal, filter, dim4(1, 1), dim4(4, 2), dim4(1, 1));
+    ASSERT_ARRAYS_NEAR(convolve2(signal, filter, AF_CONV_EXPAND,
+                                 AF_CONV_SPATIAL),
+                       expanded, 1E-5);
+}
+
+TEST(Convolve, TuningExportImport) {
+    array signal = randu(30, 30);
+    array filter = randu(3, 3);
+    array gold   = convolve2(signal, filter, AF_CONV_DEFAULT, AF_CONV_SPATIAL);
+
+    ASSERT_ARRAYS_NEAR(gold, convolve2(signal, filter), 1E-5);
+    af::exportConvolveTuning("convolve_tuning.txt");
+    af::importConvolveTuning("convolve_tuning.txt");
+    ASSERT_ARRAYS_NEAR(gold, convolve2(signal, filter), 1E-5);
+
+    ASSERT_THROW(af::importConvolveTuning("missing_convolve_tuning.txt"),
+                 af::exception);
+}
+
+TEST(Convolve, SeparableFilterDetected) {
+    array signal = randu(50, 40, 2);
+    array filter = af::gaussianKernel(9, 7);
+
+    ASSERT_ARRAYS_NEAR(
+        convolve2(signal, filter, AF_CONV_DEFAULT, AF_CONV_FREQ),
+        convolve2(signal, filter, AF_CONV_DEFAULT, AF_CONV_SPATIAL), 1E-5);
+    ASSERT_ARRAYS_NEAR(
+        convolve2(signal, filter, AF_CONV_EXPAND, AF_CONV_FREQ),
+        convolve2(signal, filter, AF_CONV_EXPAND, AF_CONV_SPATIAL), 1E-5);
+
+    // A filter of rank two is convolved densely
+    array dense = filter + af::transpose(af::gaussianKernel(7, 9, 1, 3));
+    ASSERT_ARRAYS_NEAR(
+        convolve2(signal, dense, AF_CONV_DEFAULT, AF_CONV_FREQ),
+        convolve2(signal, dense, AF_CONV_DEFAULT, AF_CONV_SPATIAL), 1E-5);
+}
+
+TEST(Convolve, SeparableFilterEmptySignal) {
+    array signal;
+    array filter = af::gaussianKernel(9, 7);
+
+    for (af_conv_domain domain : {AF_CONV_AUTO, AF_CONV_SPATIAL}) {
+        array out = convolve2(signal, filter, AF_CONV_DEFAULT, domain);
+        ASSERT_TRUE(out.isempty());
+    }
+}
+
+TEST(Convolve, BoxFilter) {
+    array signal = randu(40, 30, 3);
+    array filter = constant(1.0 / 20, 5, 4);
+
+    ASSERT_ARRAYS_NEAR(
+        convolve2(signal, filter, AF_CONV_DEFAULT, AF_CONV_FREQ),
+        af::boxFilter(signal, 5, 4), 1E-5);
+}
+
+TEST(Convolve, FilterBankMatchesSingleFilters) {
+    array signal = randu(60, 50);
+    array bank   = randu(5, 5, 8, 8);
+
+    for (af_conv_mode mode : {AF_CONV_DEFAULT, AF_CONV_EXPAND}) {
+        array out = convolve2(signal, bank, mode, AF_CONV_SPATIAL);
+        for (int b3 = 0; b3 < bank.dims(3); ++b3) {
+            for (int b2 = 0; b2 < bank.dims(2); ++b2) {
+                array filter = bank(span, span, b2, b3);
+                ASSERT_ARRAYS_NEAR(
+                    convolve2(signal, filter, mode, AF_CONV_SPATIAL),
+                    out(span, span, b2, b3), 1E-5);
+            }
+        }
+    }
+}
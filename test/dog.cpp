@@ -79,3 +79,13 @@ TYPED_TEST(DOG, InvalidArray) {
     array in = randu(512);
     EXPECT_THROW(dog(in, 3, 2), exception);
 }
+
+TEST(DOG, RandomMatchesSmoothedDifference) {
+    array in = randu(64, 48, 2);
+
+    array smth1 = convolve2(in, gaussianKernel(5, 5));
+    array smth2 = convolve2(in, gaussianKernel(9, 9));
+
+    ASSERT_ARRAYS_NEAR(smth1 - smth2, dog(in, 2, 4), 1e-5);
+    ASSERT_ARRAYS_NEAR(smth2 - smth1, dog(in, 4, 2), 1e-5);
+}
@@ -51,3 +51,42 @@ TEST(EventTests, EventCreateAndMove) {
     ASSERT_EQ(fE, anotherEvent.get());
     af::sync();
 }
+
+TEST(EventTests, ElapsedTime) {
+    event start, end;
+    start.mark();
+    af::array a = af::randu(1024, 1024);
+    af::array b = af::matmul(a, a);
+    b.eval();
+    end.mark();
+
+    float ms   = 0.f;
+    af_err err = af_event_elapsed_time(&ms, start.get(), end.get());
+    // OpenCL queues only record timestamps when profiling
+    if (err == AF_ERR_NOT_SUPPORTED) { return; }
+    ASSERT_SUCCESS(err);
+    EXPECT_GE(ms, 0.f);
+}
+
+namespace {
+void addArrays() {
+    af::array a = af::constant(1, 1 << 16);
+    af::array b = a + a;
+    b.eval();
+}
+}  // namespace
+
+TEST(EventTests, TimeitStats) {
+    af::timeit_options options;
+    options.samples = 10;
+    af::timeit_stats stats = af::timeitStats(addArrays, options);
+
+    EXPECT_EQ(10, stats.samples);
+    EXPECT_LE(0, stats.min);
+    EXPECT_LE(stats.min, stats.median);
+    EXPECT_LE(stats.median, stats.p90);
+    EXPECT_LE(stats.p90, stats.p99);
+    EXPECT_LE(stats.p99, stats.max);
+    EXPECT_LE(stats.min, stats.mean);
+    EXPECT_LE(stats.mean, stats.max);
+}
@@ -29,7 +29,9 @@ using af::fft2;
 using af::fft2InPlace;
 using af::fft3;
 using af::fft3InPlace;
+using af::fftC2R;
 using af::fftInPlace;
+using af::fftR2C;
 using af::ifft;
 using af::ifft2;
 using af::ifft2InPlace;
@@ -37,8 +39,10 @@ using af::ifft3;
 using af::ifft3InPlace;
 using af::ifftInPlace;
 using af::moddims;
+using af::prepareFFTPlan;
 using af::randu;
 using af::seq;
+using af::setFFTPlanCacheBytes;
 using af::span;
 using std::abs;
 using std::endl;
@@ -913,3 +917,105 @@ TEST_P(FFTC2R3D, InPlaceIFFT3MatchesOutOfPlace) {
 
     ASSERT_ARRAYS_EQ(a, b);
 }
+
+TEST(FFT, PrepareFFTPlan) {
+    const dim4 dims(64, 32);
+    prepareFFTPlan(dims, 2, c32);
+    prepareFFTPlan(dims, 2, f32);
+
+    array a     = randu(dims, c32);
+    array b     = randu(dims, f32);
+    array gold  = ifft2(fft2(a));
+    array rgold = fftC2R<2>(fftR2C<2>(b), false);
+    ASSERT_ARRAYS_NEAR(a, gold, 1e-4);
+    ASSERT_ARRAYS_NEAR(b, rgold, 1e-4);
+}
+
+TEST(FFT, PlanCacheBytesLimit) {
+    setFFTPlanCacheBytes(1);
+    array a = randu(128, 128, c32);
+    array b = ifft2(fft2(a));
+    ASSERT_ARRAYS_NEAR(a, b, 1e-4);
+    setFFTPlanCacheBytes(0);
+}
+
+TEST(FFT, PrepareFFTPlanInvalidRank) {
+    dim_t dims[] = {16, 16};
+    ASSERT_EQ(AF_ERR_ARG, af_prepare_fft_plan(2, dims, 4, c32));
+}
+
+namespace {
+/// Returns the DFT of the columns of \p in computed with a DFT matrix
+array dftGold(const array &in, bool inverse) {
+    const dim_t n = in.dims(0);
+    array kn = (af::range(dim4(n, n), 0, s64) * af::range(dim4(n, n), 1, s64)) %
+               n;
+    // kn is reduced modulo n so the angles stay accurate in single precision
+    array angle = (inverse ? 2.0 : -2.0) * af::Pi * kn.as(f32) / n;
+    array w     = af::complex(af::cos(angle), af::sin(angle));
+    return af::matmul(w, in);
+}
+}  // namespace
+
+TEST(FFT, PrimeLength) {
+    array a = randu(1009, 3, c32);
+    ASSERT_ARRAYS_NEAR(dftGold(a, false), fft(a), 1e-2);
+    ASSERT_ARRAYS_NEAR(a, ifft(fft(a)), 1e-4);
+}
+
+TEST(FFT, PrimeLengthInverse) {
+    array a = randu(1013, c32);
+    ASSERT_ARRAYS_NEAR(dftGold(a, true) / 1013, ifft(a), 1e-4);
+}
+
+TEST(FFT, PrimeLengthInPlace) {
+    array a    = randu(997, 2, c32);
+    array gold = fft(a);
+    fftInPlace(a);
+    ASSERT_ARRAYS_NEAR(gold, a, 1e-3);
+}
+
+TEST(FFT, PrimeLength2D) {
+    array a = randu(4093, 6, c32);
+    ASSERT_ARRAYS_NEAR(a, ifft2(fft2(a)), 1e-4);
+    ASSERT_ARRAYS_NEAR(fft(fft(a).T()).T(), fft2(a), 1e-2);
+}
+
+TEST(FFT, PrimeLengthR2C) {
+    array a   = randu(1009, 4);
+    array out = fftR2C<1>(a);
+    ASSERT_EQ(dim4(505, 4), out.dims());
+    ASSERT_ARRAYS_NEAR(fft(a.as(c32))(seq(505), span), out, 1e-3);
+    ASSERT_ARRAYS_NEAR(a, fftC2R<1>(out, true), 1e-4);
+}
+
+TEST(FFT, PrimeLengthR2C2D) {
+    array a = randu(17, 1009);
+    ASSERT_ARRAYS_NEAR(a, fftC2R<2>(fftR2C<2>(a), true), 1e-4);
+}
+
+TEST(FFT, R2CStridedBatch) {
+    // The columns of the slice are not packed across dimension 2
+    array a = randu(64, 8, 6);
+    array s = a(span, seq(2, 5), span);
+    ASSERT_ARRAYS_NEAR(fftR2C<1>(s.copy()), fftR2C<1>(s), 1e-4);
+    ASSERT_ARRAYS_NEAR(fftR2C<2>(s.copy()), fftR2C<2>(s), 1e-3);
+}
+
+TEST(FFT, R2CSteppedRows) {
+    array a = randu(96, 16, 3);
+    array s = a(seq(0, 94, 2), span, span);
+    ASSERT_ARRAYS_NEAR(fftR2C<1>(s.copy()), fftR2C<1>(s), 1e-4);
+    ASSERT_ARRAYS_NEAR(fftR2C<2>(s.copy()), fftR2C<2>(s), 1e-3);
+
+    // The column stride of 96 is not a multiple of 5
+    array t = a(seq(0, 94, 5), span, span);
+    ASSERT_ARRAYS_NEAR(fftR2C<2>(t.copy()), fftR2C<2>(t), 1e-3);
+}
+
+TEST(FFT, C2RStridedBatch) {
+    array a = randu(33, 8, 6, c32);
+    array s = a(span, seq(1, 6), span);
+    ASSERT_ARRAYS_NEAR(fftC2R<1>(s.copy()), fftC2R<1>(s), 1e-4);
+    ASSERT_ARRAYS_NEAR(fftC2R<2>(s.copy()), fftC2R<2>(s), 1e-4);
+}
@@ -638,3 +638,62 @@ TEST(FFTConvolve2, Interleaved2) {
         ASSERT_EQ(max<double>(abs(c_ii - d)) < 1E-5, true);
     }
 }
+
+TEST(FFTConvolve1Block, MatchesFFTConvolve1) {
+    array a = randu(1000, 3);
+    for (int n = 16; n <= 17; n++) {
+        array b = randu(n);
+        for (int blockSize = 32; blockSize <= 64; blockSize += 32) {
+            array c = fftConvolve1Block(a, b, blockSize);
+            array d = fftConvolve1(a, b);
+            ASSERT_EQ(c.dims(), d.dims());
+            ASSERT_EQ(max<double>(abs(c - d)) < 1E-4, true);
+
+            c = fftConvolve1Block(a, b, blockSize, AF_CONV_EXPAND);
+            d = fftConvolve1(a, b, AF_CONV_EXPAND);
+            ASSERT_EQ(c.dims(), d.dims());
+            ASSERT_EQ(max<double>(abs(c - d)) < 1E-4, true);
+        }
+    }
+}
+
+TEST(FFTConvolve1Block, Complex) {
+    array a = randu(500, c32);
+    array b = randu(9, c32);
+    array c = fftConvolve1Block(a, b, 16, AF_CONV_EXPAND);
+    array d = fftConvolve1(a, b, AF_CONV_EXPAND);
+    ASSERT_EQ(max<double>(abs(c - d)) < 1E-4, true);
+}
+
+TEST(FFTConvolve1Block, FilterLongerThanBlock) {
+    array a = randu(100);
+    array b = randu(20);
+    EXPECT_THROW(fftConvolve1Block(a, b, 16), af::exception);
+}
+
+TEST(ConvolveStream, MatchesFir) {
+    array x = randu(1000, 2);
+    array b = randu(33);
+    af::convolveStream stream(b, 64);
+
+    array y = stream.push(x(af::seq(0, 99), span));
+    y       = join(0, y, stream.push(x(af::seq(100, 109), span)));
+    y       = join(0, y, stream.push(x(af::seq(110, 999), span)));
+
+    array d = join(1, fir(b, x.col(0)), fir(b, x.col(1)));
+    ASSERT_EQ(y.dims(), x.dims());
+    ASSERT_EQ(max<double>(abs(y - d)) < 1E-4, true);
+}
+
+TEST(ConvolveStream, Reset) {
+    array x = randu(200);
+    array b = randu(7);
+    af::convolveStream stream(b);
+
+    stream.push(randu(50));
+    stream.reset();
+    array y = stream.push(x);
+    ASSERT_EQ(max<double>(abs(y - fir(b, x))) < 1E-4, true);
+
+    EXPECT_THROW(stream.push(randu(50, 2)), af::exception);
+}
@@ -157,3 +157,13 @@ TEST(GaussianKernel, SmallSmall2DWithSigma_CPP) {
     gaussianKernelTestCPP(string(TEST_DIR "/gaussian/gauss2_7x7_sigma1.test"),
                           1.0);
 }
+
+TEST(GaussianFilter, MatchesGaussianKernel) {
+    array impulse = af::constant(0, 101, 81);
+    impulse(50, 40) = 1;
+
+    array filtered = af::gaussianFilter(impulse, 4, 3);
+
+    ASSERT_ARRAYS_NEAR(gaussianKernel(101, 81, 4, 3), filtered, 1E-3);
+    ASSERT_NEAR(1.0, af::sum<double>(filtered), 1E-3);
+}
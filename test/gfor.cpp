@@ -25,6 +25,7 @@ using af::gforSet;
 using af::randu;
 using af::seq;
 using af::span;
+using af::vmap;
 using std::endl;
 using std::string;
 using std::vector;
@@ -543,3 +544,38 @@ TEST(GFOR, MatmulLoopWithNonUnitIncrSeq) {
     }
     ASSERT_ARRAYS_NEAR(C, G, 1E-03);
 }
+
+static array sliceGram(const array &in) { return sum(matmul(in, in), 0); }
+
+TEST(VMAP, Matmul) {
+    const int n     = 8;
+    const int batch = 5;
+
+    array A = randu(n, n, batch);
+    array G = constant(0, 1, n, batch);
+    for (int i = 0; i < batch; ++i) {
+        G(span, span, i) = sum(matmul(A(span, span, i), A(span, span, i)), 0);
+    }
+    ASSERT_ARRAYS_NEAR(G, vmap(sliceGram, A, 2), 1E-03);
+}
+
+static array sortedFlat(const array &in) { return sort(flat(in)); }
+
+TEST(VMAP, SortFlatAlongMiddleDimension) {
+    array A = randu(4, 6, 5);
+    array G = constant(0, 20, 6);
+    for (int i = 0; i < 6; ++i) {
+        G(span, i) = sort(flat(A(span, i, span)));
+    }
+    array out = vmap(sortedFlat, A, 1);
+    ASSERT_EQ(af::dim4(20, 6), out.dims());
+    ASSERT_ARRAYS_EQ(G, out);
+}
+
+static array sliceSum(const array &in) { return in * af::sum<float>(in); }
+
+TEST(VMAP, ReductionOfAllElementsIsNotSupported) {
+    array A = randu(4, 4, 3);
+    ASSERT_THROW(vmap(sliceSum, A), af::exception);
+    ASSERT_FALSE(af::vmapGet());
+}
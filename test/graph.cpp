@@ -0,0 +1,88 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <gtest/gtest.h>
+#include <testHelpers.hpp>
+#include <af/graph.h>
+
+#include <vector>
+
+using af::array;
+using af::beginCapture;
+using af::endCapture;
+using af::getActiveBackend;
+using af::graph;
+using af::randu;
+using std::vector;
+
+TEST(Graph, Replay) {
+    if (getActiveBackend() == AF_BACKEND_OPENCL) return;
+    array x = randu(100, 10);
+    array w = randu(100, 10);
+    x.eval();
+    w.eval();
+
+    beginCapture();
+    array y = 2 * x + w;
+    array z = af::sum(y, 0);
+    af::eval(y, z);
+    graph g = endCapture();
+
+    g.replay();
+    ASSERT_ARRAYS_NEAR(2 * x + w, y, 1e-6);
+    ASSERT_ARRAYS_NEAR(af::sum(2 * x + w, 0), z, 1e-4);
+}
+
+TEST(Graph, ReboundInput) {
+    if (getActiveBackend() == AF_BACKEND_OPENCL) return;
+    array x = randu(64);
+    x.eval();
+
+    beginCapture();
+    array y = x * x;
+    y.eval();
+    graph g = endCapture();
+
+    for (int i = 0; i < 3; ++i) {
+        vector<float> in(64, static_cast<float>(i));
+        x.write(in.data(), in.size() * sizeof(float));
+        g.replay();
+        ASSERT_ARRAYS_EQ(af::constant(i * i, 64), y);
+    }
+}
+
+TEST(Graph, IsCapturing) {
+    if (getActiveBackend() == AF_BACKEND_OPENCL) return;
+    bool capturing = true;
+    ASSERT_SUCCESS(af_is_capturing(&capturing));
+    ASSERT_FALSE(capturing);
+
+    ASSERT_SUCCESS(af_begin_capture());
+    ASSERT_SUCCESS(af_is_capturing(&capturing));
+    ASSERT_TRUE(capturing);
+    ASSERT_EQ(AF_ERR_RUNTIME, af_begin_capture());
+
+    af_graph g = 0;
+    ASSERT_SUCCESS(af_end_capture(&g));
+    ASSERT_SUCCESS(af_is_capturing(&capturing));
+    ASSERT_FALSE(capturing);
+    ASSERT_SUCCESS(af_release_graph(g));
+}
+
+TEST(Graph, EndWithoutBegin) {
+    if (getActiveBackend() == AF_BACKEND_OPENCL) return;
+    af_graph g = 0;
+    ASSERT_EQ(AF_ERR_RUNTIME, af_end_capture(&g));
+}
+
+TEST(Graph, OpenCLNotSupported) {
+    if (getActiveBackend() != AF_BACKEND_OPENCL) return;
+    ASSERT_EQ(AF_ERR_NOT_SUPPORTED, af_begin_capture());
+}
@@ -15,7 +15,9 @@
 #include <vector>
 
 using af::array;
+using af::dim4;
 using af::randu;
+using af::span;
 using std::vector;
 
 TEST(rgb_gray, 32bit) {
@@ -83,6 +85,9 @@ TEST(gray_rgb, 32bit) {
     vector<float> h_rgb(rgb.elements());
     vector<float> h_gray(gray.elements());
 
+    rgb.host(&h_rgb[0]);
+    gray.host(&h_gray[0]);
+
     int num  = gray.elements();
     int roff = 0;
     int goff = num;
@@ -128,3 +133,14 @@ TEST(rgb_gray, MaxDim) {
         ASSERT_FLOAT_EQ(res, h_gray[i]);
     }
 }
+
+TEST(gray_rgb, 8bitBatch) {
+    array gray = randu(10, 8, 1, 2, u8);
+    array rgb  = gray2rgb(gray, 0.25f, 0.5f, 1.0f);
+    ASSERT_EQ(dim4(10, 8, 3, 2), rgb.dims());
+
+    array fgray = gray.as(f32);
+    ASSERT_ARRAYS_EQ(fgray * 0.25f, rgb(span, span, 0, span));
+    ASSERT_ARRAYS_EQ(fgray * 0.5f, rgb(span, span, 1, span));
+    ASSERT_ARRAYS_EQ(fgray, rgb(span, span, 2, span));
+}
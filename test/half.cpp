@@ -138,3 +138,22 @@ TEST(Half, isZero) {
 
     ASSERT_ARRAYS_EQ(gold, res);
 }
+
+TEST(Half, ConvertLarge) {
+    SUPPORTED_TYPE_CHECK(af_half);
+    // The values are exact in half precision
+    array a = af::range(af::dim4(1001), 0, f32) * 0.25 - 100;
+    array h = a.as(f16);
+
+    ASSERT_ARRAYS_EQ(a, h.as(f32));
+    ASSERT_ARRAYS_EQ(a * 2, (h * 2).as(f32));
+}
+
+TEST(Half, SumAccumulatesInFloat) {
+    SUPPORTED_TYPE_CHECK(af_half);
+    // A half accumulator stops increasing at 2048
+    array h = constant(1, 4099, f16);
+
+    ASSERT_EQ(4099.f, af::sum<float>(h));
+    ASSERT_EQ(4096.f, af::sum(h(af::seq(4096))).as(f32).scalar<float>());
+}
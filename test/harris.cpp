@@ -218,3 +218,24 @@ TEST(FloatHarris, CPP) {
             << "at: " << elIter << endl;
     }
 }
+
+TEST(FloatHarris, WideImageCorners) {
+    // The corners are in columns past the number of rows of the image
+    array in = af::constant(0.f, 48, 160);
+    in(af::seq(12, 35), af::seq(100, 139)) = 255.f;
+
+    features out = harris(in, 4, 1e5f, 0.0f, 3, 0.04f);
+    ASSERT_EQ(4u, out.getNumFeatures());
+
+    vector<float> outX(4);
+    vector<float> outY(4);
+    out.getX().host(&outX.front());
+    out.getY().host(&outY.front());
+
+    for (int i = 0; i < 4; i++) {
+        float dx = std::min(fabs(outX[i] - 100.f), fabs(outX[i] - 139.f));
+        float dy = std::min(fabs(outY[i] - 12.f), fabs(outY[i] - 35.f));
+        EXPECT_LE(dx, 2.f) << "at: " << i << endl;
+        EXPECT_LE(dy, 2.f) << "at: " << i << endl;
+    }
+}
@@ -12,6 +12,8 @@
 #include <testHelpers.hpp>
 #include <af/dim4.hpp>
 #include <af/traits.hpp>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -106,6 +108,7 @@ TYPED_TEST(Histogram, 256Bins0min255max_zeros) {
 using af::array;
 using af::constant;
 using af::histogram;
+using af::histogram2;
 using af::max;
 using af::randu;
 using af::range;
@@ -282,3 +285,238 @@ TEST(histogram, LargeBins) {
 
     for (int i = 0; i < nbins; i++) { ASSERT_EQ(hH[i], 0u); }
 }
+
+namespace {
+/// Joint histogram of every d0 x d1 slice of \p x and \p y, which sums the
+/// weights \p w of the pairs, or counts them when \p w is empty
+vector<float> histogram2Gold(const vector<float> &x, const vector<float> &y,
+                             const vector<float> &w, dim4 dims, int xbins,
+                             int ybins, float xmin, float xmax, float ymin,
+                             float ymax) {
+    const int len     = dims[0] * dims[1];
+    const int slices  = dims[2] * dims[3];
+    const float xstep = (xmax - xmin) / xbins;
+    const float ystep = (ymax - ymin) / ybins;
+
+    vector<float> out(xbins * ybins * slices, 0.f);
+    for (int s = 0; s < slices; ++s) {
+        for (int i = s * len; i < (s + 1) * len; ++i) {
+            int xb = static_cast<int>((x[i] - xmin) / xstep);
+            int yb = static_cast<int>((y[i] - ymin) / ystep);
+            xb     = std::min(std::max(xb, 0), xbins - 1);
+            yb     = std::min(std::max(yb, 0), ybins - 1);
+            out[s * xbins * ybins + yb * xbins + xb] += w.empty() ? 1.f : w[i];
+        }
+    }
+    return out;
+}
+
+void histogram2Test(dim4 dims, int xbins, int ybins, float xmax, float ymax,
+                    bool weighted) {
+    array x = round(xmax * randu(dims));
+    array y = round(ymax * randu(dims));
+    array w = weighted ? randu(dims) : array();
+    array H = histogram2(x, y, xbins, ybins, 0, xmax, 0, ymax, w);
+
+    ASSERT_EQ(dim4(xbins, ybins, dims[2], dims[3]), H.dims());
+    ASSERT_EQ(weighted ? f32 : u32, H.type());
+
+    vector<float> hx(x.elements()), hy(y.elements()), hw;
+    x.host(hx.data());
+    y.host(hy.data());
+    if (weighted) {
+        hw.resize(w.elements());
+        w.host(hw.data());
+    }
+    vector<float> gold =
+        histogram2Gold(hx, hy, hw, dims, xbins, ybins, 0, xmax, 0, ymax);
+
+    vector<float> hH(H.elements());
+    H.as(f32).host(hH.data());
+    for (size_t i = 0; i < gold.size(); ++i) {
+        ASSERT_NEAR(gold[i], hH[i], 1e-3 * (1 + gold[i])) << "at bin " << i;
+    }
+}
+}  // namespace
+
+TEST(histogram2, WarpPrivateBins) {
+    histogram2Test(dim4(1000, 300), 8, 4, 64, 32, false);
+}
+
+TEST(histogram2, BlockPrivateBins) {
+    histogram2Test(dim4(1000, 300), 64, 16, 256, 64, false);
+}
+
+TEST(histogram2, GlobalBins) {
+    histogram2Test(dim4(1 << 18), 256, 128, 512, 256, false);
+}
+
+TEST(histogram2, Weighted) {
+    histogram2Test(dim4(500, 400), 16, 16, 64, 64, true);
+}
+
+TEST(histogram2, Batch) {
+    histogram2Test(dim4(100, 50, 3, 2), 16, 8, 64, 32, true);
+}
+
+TEST(histogram2, IndexedArray) {
+    array x = round(64 * randu(200, 100));
+    array y = round(32 * randu(200, 100));
+    seq rows(10, 149), cols(20, 79);
+
+    array H = histogram2(x(rows, cols), y(rows, cols), 8, 4, 0, 64, 0, 32);
+    array G = histogram2(x(rows, cols).copy(), y(rows, cols).copy(), 8, 4, 0,
+                         64, 0, 32);
+    ASSERT_ARRAYS_EQ(G, H);
+}
+
+TEST(histogram, Weighted) {
+    const int nbins = 32;
+    array in        = round(64 * randu(1 << 16));
+    array w         = randu(1 << 16);
+    array H         = histogram(in, w, nbins, 0, 64);
+
+    vector<float> hin(in.elements()), hw(w.elements());
+    in.host(hin.data());
+    w.host(hw.data());
+    vector<float> gold = histogram2Gold(hin, hin, hw, in.dims(), nbins, 1, 0,
+                                        64, 0, 64);
+
+    ASSERT_EQ(f32, H.type());
+    vector<float> hH(nbins);
+    H.host(hH.data());
+    for (int i = 0; i < nbins; ++i) {
+        ASSERT_NEAR(gold[i], hH[i], 1e-3 * (1 + gold[i])) << "at bin " << i;
+    }
+}
+
+TEST(histogram2, InvalidArgs) {
+    array x      = randu(100);
+    af_array out = 0;
+    EXPECT_EQ(AF_ERR_DIFF_TYPE,
+              af_histogram2(&out, x.get(), x.as(f64).get(), 0, 8, 8, 0, 1, 0,
+                            1));
+    EXPECT_EQ(AF_ERR_SIZE, af_histogram2(&out, x.get(), randu(50).get(), 0, 8,
+                                         8, 0, 1, 0, 1));
+    EXPECT_EQ(AF_ERR_ARG,
+              af_histogram2(&out, x.get(), x.get(), 0, 0, 8, 0, 1, 0, 1));
+    EXPECT_EQ(AF_ERR_DIFF_TYPE,
+              af_histogram2(&out, x.get(), x.get(), x.as(f64).get(), 8, 8, 0,
+                            1, 0, 1));
+    EXPECT_EQ(AF_ERR_ARG, af_histogram_weighted(&out, x.get(), 0, 8, 0, 1));
+}
+
+namespace {
+/// Contrast limited adaptive histogram equalization of every d0 x d1 slice
+/// of \p in
+vector<float> claheGold(const vector<float> &in, dim4 dims, int gridRows,
+                        int gridCols, float clipLimit, int nbins,
+                        float minval, float maxval) {
+    const int d0     = dims[0];
+    const int d1     = dims[1];
+    const int slices = dims[2] * dims[3];
+    const float step = (maxval - minval) / nbins;
+
+    vector<float> out(in.size());
+    vector<float> lut(nbins * gridRows * gridCols);
+    for (int s = 0; s < slices; ++s) {
+        const float *img = &in[s * d0 * d1];
+        auto bin         = [&](float v) {
+            int b = static_cast<int>((v - minval) / step);
+            return std::min(std::max(b, 0), nbins - 1);
+        };
+
+        for (int tx = 0; tx < gridCols; ++tx) {
+            for (int ty = 0; ty < gridRows; ++ty) {
+                vector<unsigned> hist(nbins, 0);
+                int count = 0;
+                for (int j = 0; j < d1; ++j) {
+                    for (int i = 0; i < d0; ++i) {
+                        if (i * gridRows / d0 != ty) { continue; }
+                        if (j * gridCols / d1 != tx) { continue; }
+                        hist[bin(img[j * d0 + i])]++;
+                        count++;
+                    }
+                }
+                unsigned excess = 0;
+                if (clipLimit > 0) {
+                    unsigned limit = std::max(
+                        1u, static_cast<unsigned>(clipLimit * count / nbins));
+                    for (auto &h : hist) {
+                        if (h > limit) {
+                            excess += h - limit;
+                            h = limit;
+                        }
+                    }
+                }
+                float cdf  = 0.f;
+                float *tlt = &lut[(tx * gridRows + ty) * nbins];
+                for (int b = 0; b < nbins; ++b) {
+                    cdf += hist[b] + static_cast<float>(excess) / nbins;
+                    tlt[b] = cdf / count;
+                }
+            }
+        }
+
+        for (int j = 0; j < d1; ++j) {
+            for (int i = 0; i < d0; ++i) {
+                const float fy = (i + 0.5f) * gridRows / d0 - 0.5f;
+                const float fx = (j + 0.5f) * gridCols / d1 - 0.5f;
+                const int y0   = static_cast<int>(std::floor(fy));
+                const int x0   = static_cast<int>(std::floor(fx));
+                const float wy = fy - y0;
+                const float wx = fx - x0;
+                const int ty0  = std::max(y0, 0);
+                const int ty1  = std::min(y0 + 1, gridRows - 1);
+                const int tx0  = std::max(x0, 0);
+                const int tx1  = std::min(x0 + 1, gridCols - 1);
+                const int b    = bin(img[j * d0 + i]);
+                auto at        = [&](int ty, int tx) {
+                    return lut[(tx * gridRows + ty) * nbins + b];
+                };
+                const float top = (1 - wx) * at(ty0, tx0) + wx * at(ty0, tx1);
+                const float bot = (1 - wx) * at(ty1, tx0) + wx * at(ty1, tx1);
+                out[s * d0 * d1 + j * d0 + i] =
+                    minval + (maxval - minval) * ((1 - wy) * top + wy * bot);
+            }
+        }
+    }
+    return out;
+}
+}  // namespace
+
+TEST(CLAHE, MatchesGold) {
+    const dim4 dims(67, 45, 2);
+    array in = round(randu(dims) * 255.f);
+    vector<float> hIn(dims.elements());
+    in.host(hIn.data());
+
+    // The bins are 4 wide, so the values are binned exactly
+    array out = af::clahe(in, 4, 3, 2.0f, 64, 0.0, 256.0);
+    vector<float> gold = claheGold(hIn, dims, 4, 3, 2.0f, 64, 0.f, 256.f);
+    ASSERT_VEC_ARRAY_NEAR(gold, dims, out, 1e-2);
+}
+
+TEST(CLAHE, NoClipU8) {
+    const dim4 dims(64, 48);
+    array in = round(randu(dims) * 100.f + 50.f);
+    vector<float> hIn(dims.elements());
+    in.host(hIn.data());
+
+    array out = af::clahe(in.as(u8), 8, 8, 0.f);
+    ASSERT_EQ(u8, out.type());
+    vector<float> gold = claheGold(hIn, dims, 8, 8, 0.f, 256, 0.f, 255.f);
+    for (auto &g : gold) { g = std::floor(g + 0.5f); }
+    ASSERT_VEC_ARRAY_NEAR(gold, dims, out.as(f32), 1.0);
+}
+
+TEST(CLAHE, InvalidArgs) {
+    array in     = randu(16, 16);
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_ARG, af_clahe(&out, in.get(), 0, 4, 2.f, 256, 0, 255));
+    ASSERT_EQ(AF_ERR_ARG, af_clahe(&out, in.get(), 4, 17, 2.f, 256, 0, 255));
+    ASSERT_EQ(AF_ERR_ARG, af_clahe(&out, in.get(), 4, 4, 2.f, 0, 0, 255));
+    ASSERT_EQ(AF_ERR_ARG, af_clahe(&out, in.get(), 4, 4, 2.f, 256, 1, 1));
+    ASSERT_EQ(AF_ERR_TYPE,
+              af_clahe(&out, randu(16, 16, c32).get(), 4, 4, 2.f, 256, 0, 255));
+}
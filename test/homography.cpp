@@ -285,3 +285,33 @@ TEST(Homography, CPP) {
     delete[] gold_t;
     delete[] out_t;
 }
+
+TEST(Homography, Batch) {
+    const int npts = 64;
+    array x_src    = af::randu(npts, 2) * 100.f;
+    array y_src    = af::randu(npts, 2) * 100.f;
+
+    // The first set is scaled by two, the second one is translated
+    array x_dst = af::join(1, x_src.col(0) * 2.f, x_src.col(1) + 10.f);
+    array y_dst = af::join(1, y_src.col(0) * 2.f, y_src.col(1) - 5.f);
+
+    array H, inliers;
+    homographyBatch(H, inliers, x_src, y_src, x_dst, y_dst,
+                    AF_HOMOGRAPHY_RANSAC, 1.0f, 200, f32);
+
+    ASSERT_EQ(dim4(3, 3, 2), H.dims());
+    ASSERT_EQ(dim4(2), inliers.dims());
+    ASSERT_EQ(s32, inliers.type());
+
+    vector<int> h_inliers(2);
+    inliers.host(h_inliers.data());
+    EXPECT_EQ(npts, h_inliers[0]);
+    EXPECT_EQ(npts, h_inliers[1]);
+
+    // The homographies are stored in row major order
+    float gold[] = {2.f, 0.f, 0.f, 0.f, 2.f, 0.f, 0.f, 0.f, 1.f,
+                    1.f, 0.f, 10.f, 0.f, 1.f, -5.f, 0.f, 0.f, 1.f};
+    array normH = H / af::tile(H(2, 2, af::span), 3, 3);
+    ASSERT_VEC_ARRAY_NEAR(vector<float>(gold, gold + 18), dim4(3, 3, 2),
+                          normH, 1e-2);
+}
@@ -158,3 +158,17 @@ TYPED_TEST(filter, iirVecMat) {
 TYPED_TEST(filter, iirMatMat) {
     iirTest<TypeParam>(TEST_DIR "/iir/iir_mm.test");
 }
+
+TYPED_TEST(filter, iirLongSignal) {
+    SUPPORTED_TYPE_CHECK(TypeParam);
+    dtype ty = (dtype)dtype_traits<TypeParam>::af_type;
+    array x  = randu(32768, ty);
+    array b  = randu(5, ty);
+    array a  = join(0, af::constant(1, 1, ty), 0.2 * randu(3, ty));
+
+    // A single signal is split into blocks which are filtered in parallel,
+    // while more signals than blocks are filtered from start to end
+    array y    = iir(b, a, x);
+    array gold = iir(b, a, af::tile(x, 1, 256));
+    ASSERT_ARRAYS_NEAR(gold.col(0), y, 1e-3);
+}
@@ -118,6 +118,7 @@ using af::anyTrue;
 using af::deleteImageMem;
 using af::loadImage;
 using af::loadImageMem;
+using af::loadImages;
 using af::saveImageMem;
 using af::span;
 
@@ -183,6 +184,31 @@ TEST(ImageIO, SaveBMPCPP) {
     ASSERT_FALSE(anyTrue<bool>(out - input));
 }
 
+TEST(ImageIO, LoadImagesCPP) {
+    if (noImageIOTests()) return;
+
+    const char* files[] = {"LoadImages0.png", "LoadImages1.png",
+                           "LoadImages2.png"};
+    for (int i = 0; i < 3; i++) {
+        saveImage(files[i], af::floor(af::randu(12, 10, 3) * 255.f));
+    }
+
+    array gold = af::join(3, loadImage(files[0], true),
+                          loadImage(files[1], true), loadImage(files[2], true));
+
+    array out = loadImages(files, 3, true, f32);
+    ASSERT_ARRAYS_EQ(gold, out);
+
+    array out8 = loadImages(files, 3, true, u8);
+    ASSERT_EQ(u8, out8.type());
+    ASSERT_ARRAYS_EQ(gold.as(u8), out8);
+
+    saveImage("LoadImagesSmall.png", af::constant(0.f, 6, 10, 3));
+    const char* mixed[] = {files[0], "LoadImagesSmall.png"};
+    af_array handle     = 0;
+    ASSERT_EQ(AF_ERR_SIZE, af_load_images(&handle, mixed, 2, true, f32));
+}
+
 TEST(ImageMem, SaveMemPNG) {
     if (noImageIOTests()) return;
 
@@ -805,6 +805,24 @@ TEST(lookup, Issue2009) {
     ASSERT_ARRAYS_EQ(a, b);
 }
 
+TEST(lookup, InExpression) {
+    array a   = range(dim4(6, 5), 1, s32);
+    array idx = constant(0, 3, s32);
+    idx(1)    = 4;
+    idx(2)    = 2;
+
+    // The lookup of a sub array is fused with the arithmetic
+    array b   = a(seq(1, 4), span);
+    array out = af::lookup(b, idx, 1) * 2 + 1;
+
+    vector<int> gold(4 * 3);
+    int cols[3] = {0, 4, 2};
+    for (int j = 0; j < 3; j++) {
+        for (int i = 0; i < 4; i++) { gold[j * 4 + i] = cols[j] * 2 + 1; }
+    }
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(4, 3), out);
+}
+
 TEST(lookup, SNIPPET_lookup1d) {
     //! [ex_index_lookup1d]
 
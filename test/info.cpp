@@ -57,3 +57,13 @@ void infoTest() {
 }
 
 TEST(Info, All) { infoTest(); }
+
+TEST(Info, InitAsync) {
+    ASSERT_SUCCESS(af_init_async());
+
+    af_array outArray = 0;
+    dim4 dims(32, 32, 1, 1);
+    ASSERT_SUCCESS(af_randu(&outArray, dims.ndims(), dims.get(), f32));
+    ASSERT_SUCCESS(af_sync(-1));
+    ASSERT_SUCCESS(af_release_array(outArray));
+}
@@ -144,3 +144,48 @@ TEST(Internal, Allocated) {
 
     ASSERT_EQ(d.allocated(), a_allocated);
 }
+
+TEST(Internal, ViewOfView) {
+    array a = randu(10, 10);
+    array b = a(seq(2, 7), span);
+    array c = b(span, seq(1, 4));
+
+    // c indexes the buffer of a instead of a copy of b
+    ASSERT_EQ(getRawPtr(a), getRawPtr(c));
+    ASSERT_EQ(getOffset(c), 2 + 1 * 10);
+    ASSERT_EQ(getStrides(c), dim4(1, 10, 100, 100));
+    ASSERT_ARRAYS_EQ(a(seq(2, 7), seq(1, 4)), c);
+}
+
+TEST(Internal, DLPackRoundTrip) {
+    array a = randu(3, 4, 2);
+    array b = af::fromDLPack(af::toDLPack(a));
+
+    ASSERT_ARRAYS_EQ(a, b);
+    EXPECT_EQ(af::getRawPtr(a), af::getRawPtr(b));
+    EXPECT_TRUE(a.isLocked());
+
+    // The deleter of the tensor unlocks the buffer of a
+    b = array();
+    EXPECT_FALSE(a.isLocked());
+}
+
+TEST(Internal, DLPackView) {
+    array a = randu(5, 4, 3);
+    array v = a(seq(1, 3), seq(1, 2), span);
+    array b = af::fromDLPack(af::toDLPack(v));
+
+    ASSERT_ARRAYS_EQ(v, b);
+    EXPECT_EQ(af::getOffset(v), af::getOffset(b));
+    EXPECT_EQ(af::getStrides(v), af::getStrides(b));
+}
+
+TEST(Internal, DLPackOutlivesArray) {
+    array a      = randu(10, 10);
+    array gold   = a.copy();
+    void *tensor = af::toDLPack(a);
+    a            = array();
+
+    array b = af::fromDLPack(tensor);
+    ASSERT_ARRAYS_EQ(gold, b);
+}
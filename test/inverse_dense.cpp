@@ -32,11 +32,11 @@ using af::max;
 using std::abs;
 
 template<typename T>
-void inverseTester(const int m, const int n, double eps) {
+void inverseTester(const int m, const int n, double eps, const int batch = 1) {
     SUPPORTED_TYPE_CHECK(T);
     if (noLAPACKTests()) return;
 #if 1
-    array A = cpu_randu<T>(dim4(m, n));
+    array A = cpu_randu<T>(dim4(m, n, batch));
 #else
     array A = randu(m, n, (dtype)dtype_traits<T>::af_type);
 #endif
@@ -46,7 +46,7 @@ void inverseTester(const int m, const int n, double eps) {
     array I  = matmul(A, IA);
     //! [ex_inverse]
 
-    array I2 = identity(m, n, (dtype)dtype_traits<T>::af_type);
+    array I2 = identity(dim4(m, n, batch), (dtype)dtype_traits<T>::af_type);
 
     ASSERT_NEAR(0, max<typename dtype_traits<T>::base_type>(abs(real(I - I2))),
                 eps);
@@ -90,3 +90,11 @@ TYPED_TEST(Inverse, Square) {
 TYPED_TEST(Inverse, SquareMultiplePowerOfTwo) {
     inverseTester<TypeParam>(2048, 2048, eps<TypeParam>());
 }
+
+TYPED_TEST(Inverse, SquareBatched) {
+    inverseTester<TypeParam>(8, 8, eps<TypeParam>(), 64);
+}
+
+TYPED_TEST(Inverse, SquareBatchedLarge) {
+    inverseTester<TypeParam>(40, 40, eps<TypeParam>(), 6);
+}
@@ -113,3 +113,14 @@ TEST(Iota, CPP) {
 
     ASSERT_ARRAYS_EQ(tileArray, output);
 }
+
+TEST(Iota, FusedExpression) {
+    dim4 idims(3, 4, 1, 1);
+    dim4 tdims(2, 1, 2, 1);
+
+    array output = iota(idims, tdims) * 2 + 1;
+    array gold =
+        tile(moddims(range(dim4(idims.elements()), 0), idims), tdims) * 2 + 1;
+
+    ASSERT_ARRAYS_EQ(gold, output);
+}
@@ -0,0 +1,162 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <gtest/gtest.h>
+#include <testHelpers.hpp>
+#include <af/arith.h>
+#include <af/blas.h>
+#include <af/data.h>
+#include <af/lapack.h>
+#include <af/random.h>
+#include <af/sparse.h>
+
+using af::array;
+using af::bicgstab;
+using af::cdouble;
+using af::cfloat;
+using af::cg;
+using af::dtype_traits;
+using af::gmres;
+using af::identity;
+using af::matmul;
+using af::randu;
+using af::sparse;
+
+template<typename T>
+class Iterative : public ::testing::Test {};
+
+typedef ::testing::Types<float, cfloat, double, cdouble> TestTypes;
+TYPED_TEST_CASE(Iterative, TestTypes);
+
+/// Returns a Hermitian positive definite matrix of size \p n
+template<typename T>
+array hermitianMatrix(const int n) {
+    af::dtype type = (af::dtype)dtype_traits<T>::af_type;
+    array R        = randu(n, n, type);
+    return matmul(R, R, AF_MAT_NONE, AF_MAT_CTRANS) + n * identity(n, n, type);
+}
+
+/// Returns a diagonally dominant nonsymmetric matrix of size \p n
+template<typename T>
+array dominantMatrix(const int n) {
+    af::dtype type = (af::dtype)dtype_traits<T>::af_type;
+    return randu(n, n, type) + n * identity(n, n, type);
+}
+
+/// Returns the norm of the residual of \p x relative to the norm of \p b
+double residual(const array &A, const array &x, const array &b) {
+    return af::norm(b - matmul(A, x)) / af::norm(b);
+}
+
+TYPED_TEST(Iterative, CG) {
+    SUPPORTED_TYPE_CHECK(TypeParam);
+    const int n = 100;
+    array A     = hermitianMatrix<TypeParam>(n);
+    array b     = randu(n, (af::dtype)dtype_traits<TypeParam>::af_type);
+
+    unsigned iterations = 0;
+    array x = cg(A, b, 1e-5, 1000, AF_PRECOND_NONE, array(), array(), 10,
+                 &iterations);
+    EXPECT_GT(iterations, 0u);
+    EXPECT_LT(residual(A, x, b), 1e-4);
+}
+
+TYPED_TEST(Iterative, CGJacobi) {
+    SUPPORTED_TYPE_CHECK(TypeParam);
+    const int n = 100;
+    array A     = hermitianMatrix<TypeParam>(n);
+    array b     = randu(n, (af::dtype)dtype_traits<TypeParam>::af_type);
+
+    array x = cg(A, b, 1e-5, 1000, AF_PRECOND_JACOBI, 1 / af::diag(A));
+    EXPECT_LT(residual(A, x, b), 1e-4);
+}
+
+TYPED_TEST(Iterative, CGSparseIC0) {
+    SUPPORTED_TYPE_CHECK(TypeParam);
+    const int n = 100;
+    array A     = hermitianMatrix<TypeParam>(n);
+    array S     = sparse(A);
+    array b     = randu(n, (af::dtype)dtype_traits<TypeParam>::af_type);
+
+    array x = cg(S, b, 1e-5, 1000, AF_PRECOND_IC0, af::sparseIC0(S));
+    EXPECT_LT(residual(A, x, b), 1e-4);
+}
+
+TYPED_TEST(Iterative, BiCGStab) {
+    SUPPORTED_TYPE_CHECK(TypeParam);
+    const int n = 100;
+    array A     = dominantMatrix<TypeParam>(n);
+    array b     = randu(n, (af::dtype)dtype_traits<TypeParam>::af_type);
+
+    array x = bicgstab(A, b, 1e-5);
+    EXPECT_LT(residual(A, x, b), 1e-4);
+}
+
+TYPED_TEST(Iterative, BiCGStabSparseILU0) {
+    SUPPORTED_TYPE_CHECK(TypeParam);
+    const int n = 100;
+    array A     = dominantMatrix<TypeParam>(n);
+    array S     = sparse(A);
+    array b     = randu(n, (af::dtype)dtype_traits<TypeParam>::af_type);
+
+    array x = bicgstab(S, b, 1e-5, 1000, AF_PRECOND_ILU0, af::sparseILU0(S));
+    EXPECT_LT(residual(A, x, b), 1e-4);
+}
+
+TYPED_TEST(Iterative, GMRES) {
+    SUPPORTED_TYPE_CHECK(TypeParam);
+    if (noLAPACKTests()) return;
+    const int n = 100;
+    array A     = dominantMatrix<TypeParam>(n);
+    array b     = randu(n, (af::dtype)dtype_traits<TypeParam>::af_type);
+
+    array x = gmres(A, b, 1e-5, 1000, 20);
+    EXPECT_LT(residual(A, x, b), 1e-4);
+}
+
+TYPED_TEST(Iterative, GMRESInitialGuess) {
+    SUPPORTED_TYPE_CHECK(TypeParam);
+    if (noLAPACKTests()) return;
+    const int n = 100;
+    array A     = dominantMatrix<TypeParam>(n);
+    array b     = randu(n, (af::dtype)dtype_traits<TypeParam>::af_type);
+    array x0    = af::solve(A, b);
+
+    unsigned iterations = 1;
+    array x = gmres(A, b, 1e-3, 1000, 20, AF_PRECOND_NONE, array(), x0, 1,
+                    &iterations);
+    EXPECT_EQ(0u, iterations);
+    EXPECT_LT(residual(A, x, b), 1e-3);
+}
+
+TEST(Iterative, InvalidPreconditioner) {
+    array A = hermitianMatrix<float>(10);
+    array b = randu(10);
+    af_array x = 0;
+    EXPECT_EQ(AF_ERR_ARG, af_cg(&x, NULL, A.get(), b.get(), 1e-5, 100,
+                                AF_PRECOND_JACOBI, 0, 0, 10));
+    EXPECT_EQ(AF_ERR_SIZE, af_gmres(&x, NULL, A.get(), randu(5).get(), 1e-5,
+                                    100, 30, AF_PRECOND_NONE, 0, 0, 10));
+}
+
+TEST(Iterative, Example) {
+    const int n = 100;
+    array R     = randu(n, n);
+    // ![ex_iterative_cg]
+    // A Hermitian positive definite matrix
+    array A = matmul(R, R.T()) + n * identity(n, n);
+    array b = randu(n);
+
+    // Solve A x = b, preconditioned by the inverse of the diagonal of A
+    unsigned iterations = 0;
+    array x = cg(A, b, 1e-5, 1000, AF_PRECOND_JACOBI, 1 / af::diag(A),
+                 array(), 10, &iterations);
+    // ![ex_iterative_cg]
+    EXPECT_LT(residual(A, x, b), 1e-4);
+}
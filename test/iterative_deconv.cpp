@@ -142,3 +142,49 @@ TYPED_TEST(IterativeDeconvolution, RichardsonLucyOnGrayscale) {
         string(TEST_DIR "/iterative_deconv/gray_100_50_lucy.test"), 100, 0.05,
         AF_ITERATIVE_DECONV_RICHARDSONLUCY);
 }
+
+TEST(IterativeDeconvolution, RichardsonLucyStopsAtTolerance) {
+    array ker     = gaussianKernel(5, 5);
+    array image   = randu(64, 48) + 0.5;
+    array blurred = convolve2(image, ker);
+
+    unsigned iterations = 0;
+    array res = iterativeDeconv(blurred, ker, 500, 0.05f,
+                                AF_ITERATIVE_DECONV_RICHARDSONLUCY, 1e-2, 5,
+                                &iterations);
+    ASSERT_LT(iterations, 500u);
+    ASSERT_EQ(0u, iterations % 5);
+
+    array gold = iterativeDeconv(blurred, ker, iterations, 0.05f,
+                                 AF_ITERATIVE_DECONV_RICHARDSONLUCY);
+    ASSERT_ARRAYS_NEAR(gold, res, 1e-5);
+}
+
+TEST(IterativeDeconvolution, LandweberRunsAllIterations) {
+    array ker     = gaussianKernel(5, 5);
+    array blurred = convolve2(randu(64, 48), ker);
+
+    unsigned iterations = 0;
+    array res = iterativeDeconv(blurred, ker, 37, 0.5f,
+                                AF_ITERATIVE_DECONV_LANDWEBER, 1e-3, 5,
+                                &iterations);
+    ASSERT_EQ(37u, iterations);
+
+    array gold =
+        iterativeDeconv(blurred, ker, 37, 0.5f, AF_ITERATIVE_DECONV_LANDWEBER);
+    ASSERT_ARRAYS_NEAR(gold, res, 1e-5);
+}
+
+TEST(IterativeDeconvolution, InvalidTolerance) {
+    array ker     = gaussianKernel(5, 5);
+    array blurred = randu(32, 32);
+    af_array out  = 0;
+    ASSERT_EQ(AF_ERR_ARG,
+              af_iterative_deconv_v2(&out, NULL, blurred.get(), ker.get(), 10,
+                                     0.05f, AF_ITERATIVE_DECONV_LANDWEBER,
+                                     -1.0, 5));
+    ASSERT_EQ(AF_ERR_ARG,
+              af_iterative_deconv_v2(&out, NULL, blurred.get(), ker.get(), 10,
+                                     0.05f, AF_ITERATIVE_DECONV_LANDWEBER,
+                                     1e-3, 0));
+}
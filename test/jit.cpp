@@ -12,11 +12,13 @@
 #include <af/algorithm.h>
 #include <af/arith.h>
 #include <af/array.h>
+#include <af/backend.h>
 #include <af/data.h>
 #include <af/device.h>
 #include <af/gfor.h>
 #include <af/random.h>
 
+#include <algorithm>
 #include <numeric>
 #include <tuple>
 
@@ -76,6 +78,75 @@ TEST(JIT, CPP_JIT_HASH) {
     }
 }
 
+TEST(JIT, CommonSubexpressions) {
+    const int nx = 1000;
+    const int ny = 100;
+    array x      = randu(nx, ny);
+    array y      = randu(nx, ny);
+
+    // The two subtrees are structurally equal but do not share nodes
+    array r1  = sqrt(x * x + y * y);
+    array r2  = sqrt(x * x + y * y);
+    array out = r1 * 3.0f - r2;
+
+    vector<float> hx(nx * ny), hy(nx * ny);
+    x.host(hx.data());
+    y.host(hy.data());
+
+    vector<float> gold(nx * ny);
+    for (int i = 0; i < nx * ny; i++) {
+        float r = std::sqrt(hx[i] * hx[i] + hy[i] * hy[i]);
+        gold[i] = r * 3.0f - r;
+    }
+    ASSERT_VEC_ARRAY_NEAR(gold, dim4(nx, ny), out, 1e-5);
+}
+
+TEST(JIT, EqualOutputs) {
+    // The equal outputs are merged into one node of the kernel, which still
+    // writes both of them
+    const int n = 1000;
+    array x     = randu(n);
+    array y     = randu(n, 3);
+    eval(x, y);
+
+    array a = x + 1;
+    array b = x + 1;
+    eval(a, b);
+
+    array s = y(af::span, 1) * 2 - 1;
+    array t = y(af::span, 1) * 2 - 1;
+    array u = y(af::span, 1) * 2;
+    af_array outs[] = {s.get(), t.get(), u.get()};
+    ASSERT_SUCCESS(af_eval_multiple(3, outs));
+
+    vector<float> hx(n), hy(y.elements());
+    x.host(hx.data());
+    y.host(hy.data());
+
+    vector<float> gold(n), golds(n), goldu(n);
+    for (int i = 0; i < n; i++) {
+        gold[i]  = hx[i] + 1;
+        goldu[i] = hy[n + i] * 2;
+        golds[i] = goldu[i] - 1;
+    }
+    ASSERT_VEC_ARRAY_NEAR(gold, dim4(n), a, 1e-6);
+    ASSERT_VEC_ARRAY_NEAR(gold, dim4(n), b, 1e-6);
+    ASSERT_VEC_ARRAY_NEAR(golds, dim4(n), s, 1e-6);
+    ASSERT_VEC_ARRAY_NEAR(golds, dim4(n), t, 1e-6);
+    ASSERT_VEC_ARRAY_NEAR(goldu, dim4(n), u, 1e-6);
+}
+
+TEST(JIT, ScalarFolding) {
+    array a = constant(2.0f, 10, 10);
+    array b = constant(3.0f, 10, 10);
+    array c = (a * b + a) - b;
+    ASSERT_ARRAYS_EQ(constant(5.0f, 10, 10), c);
+
+    array x   = randu(10, 10);
+    array out = x + a * b;
+    ASSERT_ARRAYS_NEAR(x + 6.0f, out, 1e-6);
+}
+
 TEST(JIT, CPP_JIT_Reset_Binary) {
     array a = constant(2, 5, 5);
     array b = constant(1, 5, 5);
@@ -141,6 +212,115 @@ TEST(JIT, CPP_Multi_linear) {
     ASSERT_VEC_ARRAY_EQ(goldy, dim4(num), y);
 }
 
+TEST(JIT, CPP_Multi_linear_SharedNodeUnevenSize) {
+    // Large enough to be split into multiple tasks on the CPU backend with a
+    // size that is not a multiple of the task size
+    const int num = (1 << 20) + 17;
+    array a       = randu(num, s32);
+    array b       = randu(num, s32);
+    array c       = randu(num, s32);
+    array common  = a * b;
+    array x       = common + c;
+    array y       = common - c;
+    eval(x, y);
+
+    vector<int> ha(num);
+    vector<int> hb(num);
+    vector<int> hc(num);
+
+    a.host(&ha[0]);
+    b.host(&hb[0]);
+    c.host(&hc[0]);
+
+    vector<int> goldx(num);
+    vector<int> goldy(num);
+    for (int i = 0; i < num; i++) {
+        goldx[i] = ha[i] * hb[i] + hc[i];
+        goldy[i] = ha[i] * hb[i] - hc[i];
+    }
+
+    ASSERT_VEC_ARRAY_EQ(goldx, dim4(num), x);
+    ASSERT_VEC_ARRAY_EQ(goldy, dim4(num), y);
+}
+
+TEST(JIT, CPP_Multi_linear_DifferentSizes) {
+    // The small arrays are evaluated together by a batched kernel and the
+    // large one by its own kernel
+    const int small = 100;
+    const int large = 1 << 16;
+    array a         = randu(small, s32);
+    array b         = randu(10, 5, s32);
+    array c         = randu(large, s32);
+    array x         = a + 1;
+    array y         = b * 2;
+    array z         = a * 3;
+    array w         = c - 4;
+    eval(x, y, w, z);
+
+    vector<int> ha(small);
+    vector<int> hb(b.elements());
+    vector<int> hc(large);
+
+    a.host(&ha[0]);
+    b.host(&hb[0]);
+    c.host(&hc[0]);
+
+    vector<int> goldx(small), goldz(small);
+    for (int i = 0; i < small; i++) {
+        goldx[i] = ha[i] + 1;
+        goldz[i] = ha[i] * 3;
+    }
+    vector<int> goldy(hb.size());
+    for (size_t i = 0; i < hb.size(); i++) { goldy[i] = hb[i] * 2; }
+    vector<int> goldw(large);
+    for (int i = 0; i < large; i++) { goldw[i] = hc[i] - 4; }
+
+    ASSERT_VEC_ARRAY_EQ(goldx, dim4(small), x);
+    ASSERT_VEC_ARRAY_EQ(goldy, dim4(10, 5), y);
+    ASSERT_VEC_ARRAY_EQ(goldz, dim4(small), z);
+    ASSERT_VEC_ARRAY_EQ(goldw, dim4(large), w);
+}
+
+TEST(JIT, C_Multi_DifferentSizesAndTypes) {
+    // af_eval_multiple takes arrays of different sizes, with the same type
+    // or with different types
+    array a = randu(100);
+    array b = randu(10, 5);
+    eval(a, b);
+
+    array x = a + 1;
+    array y = b * 2;
+    array k = (b * 100).as(s32);
+
+    af_array same[] = {x.get(), y.get()};
+    ASSERT_SUCCESS(af_eval_multiple(2, same));
+
+    array u          = a - 1;
+    af_array mixed[] = {u.get(), k.get()};
+    ASSERT_SUCCESS(af_eval_multiple(2, mixed));
+
+    vector<float> ha(a.elements()), hb(b.elements());
+    a.host(ha.data());
+    b.host(hb.data());
+
+    vector<float> goldx(ha.size()), goldu(ha.size());
+    for (size_t i = 0; i < ha.size(); i++) {
+        goldx[i] = ha[i] + 1;
+        goldu[i] = ha[i] - 1;
+    }
+    vector<float> goldy(hb.size());
+    vector<int> goldk(hb.size());
+    for (size_t i = 0; i < hb.size(); i++) {
+        goldy[i] = hb[i] * 2;
+        goldk[i] = static_cast<int>(hb[i] * 100);
+    }
+
+    ASSERT_VEC_ARRAY_NEAR(goldx, dim4(100), x, 1e-6);
+    ASSERT_VEC_ARRAY_NEAR(goldy, dim4(10, 5), y, 1e-6);
+    ASSERT_VEC_ARRAY_NEAR(goldu, dim4(100), u, 1e-6);
+    ASSERT_VEC_ARRAY_EQ(goldk, dim4(10, 5), k);
+}
+
 TEST(JIT, CPP_strided) {
     const int num = 1024;
     gforSet(true);
@@ -803,6 +983,35 @@ TEST(JIT, getKernelCacheDirectory) {
   ASSERT_SUCCESS(af_get_kernel_cache_directory(&length, &path.at(0)));
 }
 
+TEST(JIT, prewarmKernels) {
+  unsigned num_modules = 0;
+  ASSERT_SUCCESS(af_prewarm_kernels(&num_modules));
+  ASSERT_SUCCESS(af_prewarm_kernels(NULL));
+
+  // The modules loaded by the first call are not loaded again
+  unsigned second = 0;
+  ASSERT_SUCCESS(af_prewarm_kernels(&second));
+  ASSERT_EQ(0u, second);
+}
+
+TEST(JIT, prewarmKernelsAsync) {
+  af_kernel_batch batch = NULL;
+  ASSERT_SUCCESS(af_prewarm_kernels_async(&batch, NULL, 0, -1));
+  unsigned num_modules = 0;
+  ASSERT_SUCCESS(af_wait_kernel_batch(&num_modules, batch));
+  ASSERT_SUCCESS(af_release_kernel_batch(batch));
+
+  // Keys which are not in the kernel cache index are skipped
+  const char *keys[] = {"not a module key"};
+  ASSERT_SUCCESS(af_prewarm_kernels_async(&batch, keys, 1, -1));
+  ASSERT_SUCCESS(af_wait_kernel_batch(&num_modules, batch));
+  ASSERT_EQ(0u, num_modules);
+  ASSERT_SUCCESS(af_release_kernel_batch(batch));
+
+  // The modules loaded by the first batch are not loaded again
+  ASSERT_EQ(0u, af::waitKernels(af::prewarmKernelsAsync()));
+}
+
 TEST(JIT, setKernelCacheDirectory) {
   std::string path = ".";
 
@@ -828,3 +1037,274 @@ TEST(JIT, setKernelCacheDirectory) {
   // Reset to the old path
   ASSERT_SUCCESS(af_set_kernel_cache_directory(old_path.c_str(), false));
 }
+
+namespace {
+int jit_heuristic_calls = 0;
+
+af_err evalTallTrees(af_jit_decision *decision, const af_jit_tree_info *info,
+                     void *user_data) {
+  jit_heuristic_calls++;
+  *static_cast<int *>(user_data) =
+      std::max(*static_cast<int *>(user_data), info->height);
+  *decision = info->height >= 2 ? AF_JIT_EVAL_TALLEST : AF_JIT_PASS;
+  return AF_SUCCESS;
+}
+}  // namespace
+
+TEST(JIT, setJitHeuristic) {
+  int max_height = 0;
+  jit_heuristic_calls = 0;
+  ASSERT_SUCCESS(af_set_jit_heuristic(evalTallTrees, &max_height));
+
+  array a = constant(1.0f, 10, 10);
+  array b = constant(2.0f, 10, 10);
+  array c = a + b;
+  array d = c * b;
+  array e = d - a;
+  af::eval(e);
+
+  // Reset to the default heuristics
+  ASSERT_SUCCESS(af_set_jit_heuristic(NULL, NULL));
+
+  EXPECT_GT(jit_heuristic_calls, 0);
+  EXPECT_GE(max_height, 1);
+  ASSERT_ARRAYS_EQ(constant(5.0f, 10, 10), e);
+}
+
+TEST(JIT, getJitStats) {
+  int max_height = 0;
+  af::sync();
+  af::resetJitStats();
+  ASSERT_SUCCESS(af_set_jit_heuristic(evalTallTrees, &max_height));
+
+  array a = constant(1.0f, 10, 10);
+  array b = constant(2.0f, 10, 10);
+  array c = a + b;
+  array d = c * b;
+  array e = d - a;
+  af::eval(e);
+  af::sync();
+
+  // Reset to the default heuristics
+  ASSERT_SUCCESS(af_set_jit_heuristic(NULL, NULL));
+
+  af_jit_stats stats = af::getJitStats();
+  EXPECT_GT(stats.evals_tree_height, 0u);
+  EXPECT_GT(stats.evals_explicit, 0u);
+  EXPECT_EQ(stats.num_evals,
+            stats.evals_explicit + stats.evals_tree_height +
+                stats.evals_param_size + stats.evals_memory_pressure);
+
+  size_t kernels = 0;
+  for (size_t count : stats.node_histogram) { kernels += count; }
+  EXPECT_EQ(stats.num_evals, kernels);
+
+  // The modules of the evaluated kernels stay loaded
+  if (af::getActiveBackend() != AF_BACKEND_CPU) {
+    EXPECT_GT(stats.num_modules, 0u);
+  }
+
+  size_t modules = stats.num_modules;
+  af::resetJitStats();
+  stats = af::getJitStats();
+  EXPECT_EQ(0u, stats.num_evals);
+  EXPECT_EQ(0u, stats.cache_hits + stats.cache_misses);
+  EXPECT_EQ(0u, stats.num_evictions);
+  EXPECT_EQ(modules, stats.num_modules);
+}
+
+TEST(JIT, CanonicalKernels) {
+  array a = randu(10, 1);
+  array b = randu(10, 4);
+  array c = randu(10, 4);
+  array x = randu(1, 6);
+  array y = randu(12, 6);
+  array z = randu(12, 6);
+  eval(a, b, c);
+  eval(x, y, z);
+
+  array d = tile(a, 1, 4) + b * c;
+  d.eval();
+  af::sync();
+  af::resetJitStats();
+
+  // The operands of the addition are swapped and the broadcast dimension
+  // and the shapes differ, but both expressions share a kernel
+  array w = y * z + tile(x, 12, 1);
+  w.eval();
+  af::sync();
+
+  if (af::getActiveBackend() != AF_BACKEND_CPU) {
+    af_jit_stats stats = af::getJitStats();
+    EXPECT_EQ(0u, stats.cache_misses);
+  }
+
+  vector<float> hx(x.elements()), hy(y.elements()), hz(z.elements());
+  x.host(hx.data());
+  y.host(hy.data());
+  z.host(hz.data());
+  vector<float> gold(w.elements());
+  for (int j = 0; j < 6; j++) {
+    for (int i = 0; i < 12; i++) {
+      gold[i + 12 * j] = hy[i + 12 * j] * hz[i + 12 * j] + hx[j];
+    }
+  }
+  ASSERT_VEC_ARRAY_NEAR(gold, dim4(12, 6), w, 1e-6);
+}
+
+TEST(JIT, PrecisionScope) {
+  af::precisionMode global = af::getPrecisionMode();
+  array x = randu(1000);
+  array y;
+  {
+    af::precisionScope scope(AF_PRECISION_FAST);
+    EXPECT_EQ(AF_PRECISION_FAST, af::getPrecisionMode());
+    {
+      af::precisionScope inner(AF_PRECISION_STRICT);
+      EXPECT_EQ(AF_PRECISION_STRICT, af::getPrecisionMode());
+    }
+    EXPECT_EQ(AF_PRECISION_FAST, af::getPrecisionMode());
+    y = af::exp(af::sin(x)) * 2;
+    y.eval();
+  }
+  EXPECT_EQ(global, af::getPrecisionMode());
+
+  // The fast math approximations stay close to the default functions
+  array gold = af::exp(af::sin(x)) * 2;
+  ASSERT_ARRAYS_NEAR(gold, y, 1e-4);
+
+  EXPECT_EQ(AF_ERR_ARG, af_end_precision_scope());
+  EXPECT_EQ(AF_ERR_ARG,
+            af_set_precision_mode(static_cast<af_precision_mode>(42)));
+}
+
+TEST(JIT, LinearVectorTail) {
+  // The sizes end with partial vectors, and the sub-array starts at an
+  // offset which is not aligned to the vector loads
+  const int sizes[] = {1, 3, 4, 7, 1029};
+  for (int n : sizes) {
+    array a = randu(n + 1);
+    array b = randu(n + 1);
+    eval(a, b);
+
+    array c = a * 2 + b;
+    array d = a(af::seq(1, n)) - b(af::seq(1, n));
+    eval(c, d);
+
+    vector<float> ha(n + 1), hb(n + 1);
+    a.host(ha.data());
+    b.host(hb.data());
+    vector<float> goldc(n + 1), goldd(n);
+    for (int i = 0; i <= n; i++) { goldc[i] = ha[i] * 2 + hb[i]; }
+    for (int i = 0; i < n; i++) { goldd[i] = ha[i + 1] - hb[i + 1]; }
+    ASSERT_VEC_ARRAY_NEAR(goldc, dim4(n + 1), c, 1e-6);
+    ASSERT_VEC_ARRAY_NEAR(goldd, dim4(n), d, 1e-6);
+  }
+}
+
+TEST(JIT, LinearVectorTypes) {
+  // The complex values are read as vectors of real values, and the half
+  // values are converted to and from float vectors
+  const int sizes[] = {3, 1029};
+  for (int n : sizes) {
+    array a = randu(n);
+    array b = randu(n);
+    array z = af::complex(a, b);
+    eval(a, b, z);
+
+    array w = z * z + z;
+    w.eval();
+
+    vector<float> ha(n), hb(n);
+    a.host(ha.data());
+    b.host(hb.data());
+    vector<af::cfloat> goldw(n);
+    for (int i = 0; i < n; i++) {
+      const float re = ha[i] * ha[i] - hb[i] * hb[i] + ha[i];
+      const float im = 2 * ha[i] * hb[i] + hb[i];
+      goldw[i]       = af::cfloat(re, im);
+    }
+    ASSERT_VEC_ARRAY_NEAR(goldw, dim4(n), w, 1e-5);
+
+    if (noHalfTests(f16)) { continue; }
+    array h = a.as(f16);
+    h.eval();
+    array sum = (h + h).as(f32);
+    array dbl = h * 2;
+    eval(sum, dbl);
+
+    vector<float> goldh(n);
+    for (int i = 0; i < n; i++) { goldh[i] = 2 * ha[i]; }
+    ASSERT_VEC_ARRAY_NEAR(goldh, dim4(n), sum, 1e-2);
+    ASSERT_VEC_ARRAY_NEAR(goldh, dim4(n), dbl.as(f32), 1e-2);
+  }
+}
+
+TEST(JIT, EvalMultipleTypes) {
+  array a = randu(100, 10);
+  array b = randu(100, 10);
+  eval(a, b);
+  af::sync();
+  af::resetJitStats();
+
+  array sum  = a + b;
+  array mask = a > b;
+  array idx  = (a * 100).as(s32);
+  eval(sum, mask, idx);
+  af::sync();
+
+  EXPECT_EQ(f32, sum.type());
+  EXPECT_EQ(b8, mask.type());
+  EXPECT_EQ(s32, idx.type());
+  EXPECT_EQ(1u, af::getJitStats().num_evals);
+
+  vector<float> ha(a.elements()), hb(b.elements());
+  a.host(ha.data());
+  b.host(hb.data());
+  vector<float> gsum(ha.size());
+  vector<char> gmask(ha.size());
+  vector<int> gidx(ha.size());
+  for (size_t i = 0; i < ha.size(); i++) {
+    gsum[i]  = ha[i] + hb[i];
+    gmask[i] = ha[i] > hb[i];
+    gidx[i]  = static_cast<int>(ha[i] * 100);
+  }
+  ASSERT_VEC_ARRAY_NEAR(gsum, dim4(100, 10), sum, 1e-6);
+  ASSERT_VEC_ARRAY_EQ(gmask, dim4(100, 10), mask);
+  ASSERT_VEC_ARRAY_EQ(gidx, dim4(100, 10), idx);
+}
+
+TEST(JIT, ReplaceFused) {
+  array a = randu(100, 10);
+  array b = randu(100, 10);
+  eval(a, b);
+  af::sync();
+
+  array x    = a * 2;
+  array keep = x;
+  af::resetJitStats();
+
+  // The replacements and the clamp are nodes of the JIT tree of x, so they
+  // are evaluated in one kernel
+  af::replace(x, x < 1, b);
+  af::replace(x, x > 0.5, 0.25);
+  x = clamp(x, 0.3, 1.5);
+  x.eval();
+  af::sync();
+  EXPECT_EQ(1u, af::getJitStats().num_evals);
+
+  vector<float> ha(a.elements()), hb(b.elements());
+  a.host(ha.data());
+  b.host(hb.data());
+  vector<float> gold(ha.size()), gkeep(ha.size());
+  for (size_t i = 0; i < ha.size(); i++) {
+    float v  = ha[i] * 2;
+    gkeep[i] = v;
+    v        = v < 1 ? v : hb[i];
+    v        = v > 0.5 ? v : 0.25f;
+    gold[i]  = std::min(std::max(v, 0.3f), 1.5f);
+  }
+  ASSERT_VEC_ARRAY_NEAR(gold, dim4(100, 10), x, 1e-6);
+  // The arrays which shared the values of x are not modified
+  ASSERT_VEC_ARRAY_NEAR(gkeep, dim4(100, 10), keep, 1e-6);
+}
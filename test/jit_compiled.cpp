@@ -0,0 +1,132 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// These tests are run with AF_CPU_JIT_COMPILE=1 (see CMakeLists.txt), so the
+// trees are evaluated by the compiled kernels of the CPU backend. The
+// expected values follow the semantics of the interpreted JIT.
+
+#include <gtest/gtest.h>
+#include <testHelpers.hpp>
+#include <af/arith.h>
+#include <af/array.h>
+#include <af/data.h>
+#include <af/device.h>
+#include <af/random.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using af::array;
+using af::dim4;
+using af::eval;
+using af::randu;
+using af::seq;
+using af::span;
+using std::string;
+using std::vector;
+
+TEST(CompiledJIT, Enabled) {
+    const char* env = std::getenv("AF_CPU_JIT_COMPILE");
+    ASSERT_TRUE(env != nullptr);
+    EXPECT_EQ(string("1"), string(env));
+}
+
+TEST(CompiledJIT, Linear) {
+    const int sizes[] = {1, 7, 1024, 100003};
+    for (int n : sizes) {
+        array a = randu(n);
+        array b = randu(n);
+        array k = (randu(n) * 100).as(s32);
+        eval(a, b, k);
+
+        array c = sin(a) * 2 + b / (a + 1);
+        array d = (k % 7) * 3 - (k >> 1);
+
+        vector<float> ha(n), hb(n);
+        vector<int> hk(n);
+        a.host(ha.data());
+        b.host(hb.data());
+        k.host(hk.data());
+
+        vector<float> goldc(n);
+        vector<int> goldd(n);
+        for (int i = 0; i < n; i++) {
+            goldc[i] = std::sin(ha[i]) * 2 + hb[i] / (ha[i] + 1);
+            goldd[i] = (hk[i] % 7) * 3 - (hk[i] >> 1);
+        }
+        ASSERT_VEC_ARRAY_NEAR(goldc, dim4(n), c, 1e-5);
+        ASSERT_VEC_ARRAY_EQ(goldd, dim4(n), d);
+    }
+}
+
+TEST(CompiledJIT, Strided) {
+    const dim_t d0 = 37, d1 = 23, d2 = 5;
+    array a        = randu(d0, d1, d2);
+    array b        = randu(d0, d1, d2);
+    eval(a, b);
+
+    // Every dimension of the sub-arrays has an offset and a stride, so the
+    // tree is evaluated by the non-linear kernel
+    array sa = a(seq(1, d0 - 1, 2), seq(2, d1 - 1, 3), seq(1, d2 - 1));
+    array sb = b(seq(0, d0 - 2, 2), seq(1, d1 - 2, 3), seq(0, d2 - 2));
+    array c  = exp(sa) - sb * sa;
+    c.eval();
+
+    vector<float> ha(a.elements()), hb(b.elements());
+    a.host(ha.data());
+    b.host(hb.data());
+
+    const dim4 odims = sa.dims();
+    vector<float> gold(odims.elements());
+    for (dim_t k = 0; k < odims[2]; k++) {
+        for (dim_t j = 0; j < odims[1]; j++) {
+            for (dim_t i = 0; i < odims[0]; i++) {
+                const dim_t ia = (1 + 2 * i) + (2 + 3 * j) * d0 +
+                                 (1 + k) * d0 * d1;
+                const dim_t ib = (2 * i) + (1 + 3 * j) * d0 + k * d0 * d1;
+                gold[i + odims[0] * (j + odims[1] * k)] =
+                    std::exp(ha[ia]) - hb[ib] * ha[ia];
+            }
+        }
+    }
+    ASSERT_VEC_ARRAY_NEAR(gold, odims, c, 1e-5);
+}
+
+TEST(CompiledJIT, MultipleOutputs) {
+    const dim_t d0 = 100, d1 = 10;
+    array a        = randu(d0, d1);
+    array b        = randu(d0, d1, f64);
+    eval(a, b);
+
+    array x   = a * 2;
+    array sum = x + b;
+    array gt  = x > b;
+    array idx = (x * 100).as(s32);
+    eval(sum, gt, idx);
+
+    vector<float> ha(a.elements());
+    vector<double> hb(b.elements());
+    a.host(ha.data());
+    b.host(hb.data());
+
+    vector<double> gsum(ha.size());
+    vector<char> ggt(ha.size());
+    vector<int> gidx(ha.size());
+    for (size_t i = 0; i < ha.size(); i++) {
+        const float v = ha[i] * 2;
+        gsum[i]       = v + hb[i];
+        ggt[i]        = v > hb[i];
+        gidx[i]       = static_cast<int>(v * 100);
+    }
+    ASSERT_VEC_ARRAY_NEAR(gsum, dim4(d0, d1), sum, 1e-6);
+    ASSERT_VEC_ARRAY_EQ(ggt, dim4(d0, d1), gt);
+    ASSERT_VEC_ARRAY_EQ(gidx, dim4(d0, d1), idx);
+}
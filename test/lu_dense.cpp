@@ -185,6 +185,38 @@ void luTester(const int m, const int n, double eps) {
         eps);
 }
 
+template<typename T>
+void luBatchedTester(const int n, const int batch, double eps) {
+    SUPPORTED_TYPE_CHECK(T);
+    if (noLAPACKTests()) return;
+
+    array a_orig = cpu_randu<T>(dim4(n, n, batch));
+
+    array l, u, pivot;
+    lu(l, u, pivot, a_orig);
+    ASSERT_EQ(dim4(n, 1, batch), pivot.dims());
+
+    array out = a_orig.copy();
+    array pivot2;
+    luInPlace(pivot2, out, false);
+    ASSERT_EQ(count<uint>(pivot == pivot2), pivot.elements());
+
+    for (int b = 0; b < batch; b++) {
+        array l1, u1, pivot1;
+        lu(l1, u1, pivot1, a_orig(span, span, b));
+
+        ASSERT_EQ(count<uint>(pivot(span, span, b) == pivot1), n);
+        ASSERT_NEAR(0,
+                    max<typename dtype_traits<T>::base_type>(
+                        abs(l(span, span, b) - l1)),
+                    eps);
+        ASSERT_NEAR(0,
+                    max<typename dtype_traits<T>::base_type>(
+                        abs(u(span, span, b) - u1)),
+                    eps);
+    }
+}
+
 template<typename T>
 double eps();
 
@@ -216,6 +248,14 @@ TYPED_TEST_CASE(LU, TestTypes);
 
 TYPED_TEST(LU, SquareLarge) { luTester<TypeParam>(500, 500, eps<TypeParam>()); }
 
+TYPED_TEST(LU, SquareBatched) {
+    luBatchedTester<TypeParam>(8, 64, eps<TypeParam>());
+}
+
+TYPED_TEST(LU, SquareBatchedLarge) {
+    luBatchedTester<TypeParam>(40, 6, eps<TypeParam>());
+}
+
 TYPED_TEST(LU, SquareMultipleOfTwoLarge) {
     luTester<TypeParam>(512, 512, eps<TypeParam>());
 }
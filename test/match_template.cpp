@@ -123,6 +123,68 @@ TEST(MatchTemplate, InvalidMatchType) {
     ASSERT_SUCCESS(af_release_array(tArray));
 }
 
+// The SSD measures of the templates past the size threshold are computed
+// with the FFT
+TEST(MatchTemplate, LargeTemplateSSD) {
+    SUPPORTED_TYPE_CHECK(double);
+
+    const dim4 sDims(48, 40);
+    const dim4 tDims(20, 18);
+    array search = af::randu(sDims, f64);
+    array tmplt  = af::randu(tDims, f64);
+
+    vector<double> s(sDims.elements());
+    vector<double> t(tDims.elements());
+    search.host(s.data());
+    tmplt.host(t.data());
+
+    double tMean = 0;
+    for (double val : t) { tMean += val; }
+    tMean /= t.size();
+
+    const af_match_type types[] = {AF_SSD, AF_ZSSD, AF_LSSD};
+    for (af_match_type type : types) {
+        vector<double> gold(sDims.elements());
+        for (dim_t sj = 0; sj < sDims[1]; ++sj) {
+            for (dim_t si = 0; si < sDims[0]; ++si) {
+                // The windows are padded with zeros past the image
+                double wMean = 0;
+                for (dim_t tj = 0; tj < tDims[1]; ++tj) {
+                    for (dim_t ti = 0; ti < tDims[0]; ++ti) {
+                        const dim_t i = si + ti, j = sj + tj;
+                        if (i < sDims[0] && j < sDims[1]) {
+                            wMean += s[j * sDims[0] + i];
+                        }
+                    }
+                }
+                wMean /= t.size();
+
+                double sum = 0;
+                for (dim_t tj = 0; tj < tDims[1]; ++tj) {
+                    for (dim_t ti = 0; ti < tDims[0]; ++ti) {
+                        const dim_t i = si + ti, j = sj + tj;
+                        const double sVal = (i < sDims[0] && j < sDims[1])
+                                                ? s[j * sDims[0] + i]
+                                                : 0.0;
+                        const double tVal = t[tj * tDims[0] + ti];
+                        double diff       = sVal - tVal;
+                        if (type == AF_ZSSD) {
+                            diff = sVal - wMean - tVal + tMean;
+                        } else if (type == AF_LSSD) {
+                            diff = sVal - (wMean / tMean) * tVal;
+                        }
+                        sum += diff * diff;
+                    }
+                }
+                gold[sj * sDims[0] + si] = sum;
+            }
+        }
+
+        array out = matchTemplate(search, tmplt, type);
+        ASSERT_VEC_ARRAY_NEAR(gold, sDims, out, 1e-8);
+    }
+}
+
 ///////////////////////////////// CPP TESTS /////////////////////////////
 //
 TEST(MatchTemplate, CPP) {
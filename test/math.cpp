@@ -15,6 +15,7 @@
 #include <af/random.h>
 
 #include <complex>
+#include <limits>
 
 // This makes the macros cleaner
 using af::array;
@@ -135,6 +136,35 @@ MATH_TESTS_REAL(erf)
 MATH_TESTS_REAL(erfc)
 #endif
 
+TEST(MathTests, SpecialValuesFloat) {
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    vector<float> in = {0.f,    -0.f,   1e-40f, 0.5f,   -3.f,   50.f,
+                        -90.f,  88.5f,  -105.f, 200.f,  1e5f,   -7e4f,
+                        inf,    -inf,   nan,    1.5707964f};
+    array a(in.size(), in.data());
+
+    auto check = [&](const array &out, float (*ref)(float)) {
+        vector<float> h(in.size());
+        out.host(h.data());
+        for (size_t i = 0; i < in.size(); i++) {
+            const float r = ref(in[i]);
+            if (std::isnan(r)) {
+                EXPECT_TRUE(std::isnan(h[i])) << "at " << in[i];
+            } else if (std::isinf(r) || r == 0.f) {
+                EXPECT_EQ(r, h[i]) << "at " << in[i];
+            } else {
+                EXPECT_NEAR(r, h[i], 1e-6f * std::abs(r) + 1e-44f)
+                    << "at " << in[i];
+            }
+        }
+    };
+    check(af::exp(a), [](float x) { return std::exp(x); });
+    check(af::log(a), [](float x) { return std::log(x); });
+    check(af::sin(a), [](float x) { return std::sin(x); });
+    check(af::cos(a), [](float x) { return std::cos(x); });
+}
+
 TEST(MathTests, Not) {
     array a  = randu(5, 5, b8);
     array b  = !a;
@@ -12,6 +12,7 @@
 #include <testHelpers.hpp>
 #include <af/dim4.hpp>
 #include <af/traits.hpp>
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -464,3 +465,50 @@ TEST(MedianFilter1d, GFOR) {
         ASSERT_EQ(max<double>(abs(c_ii - b_ii)) < 1E-5, true);
     }
 }
+
+template<typename T>
+void medfiltLargeWindowTest(af_border_type pad) {
+    SUPPORTED_TYPE_CHECK(T);
+
+    const int d0 = 53, d1 = 31, w = 7;
+    array input = af::randu(d0, d1, (af_dtype)dtype_traits<T>::af_type);
+    vector<T> in(d0 * d1);
+    input.host(&in.front());
+
+    // Reflects or zero pads position i of a dimension of length len
+    auto pad_index = [pad](int i, int len) {
+        if (pad == AF_PAD_ZERO) { return (i < 0 || i >= len) ? -1 : i; }
+        if (i < 0) { i = -i; }
+        if (i >= len) { i = 2 * (len - 1) - i; }
+        return i;
+    };
+
+    vector<T> gold(d0 * d1);
+    vector<T> window;
+    for (int col = 0; col < d1; col++) {
+        for (int row = 0; row < d0; row++) {
+            window.clear();
+            for (int j = 0; j < w; j++) {
+                for (int i = 0; i < w; i++) {
+                    int r = pad_index(row + i - w / 2, d0);
+                    int c = pad_index(col + j - w / 2, d1);
+                    window.push_back((r < 0 || c < 0) ? T(0) : in[c * d0 + r]);
+                }
+            }
+            std::nth_element(window.begin(), window.begin() + window.size() / 2,
+                             window.end());
+            gold[col * d0 + row] = window[window.size() / 2];
+        }
+    }
+
+    array output = medfilt(input, w, w, pad);
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(d0, d1), output);
+}
+
+TYPED_TEST(MedianFilter, LargeWindowZeroPad) {
+    medfiltLargeWindowTest<TypeParam>(AF_PAD_ZERO);
+}
+
+TYPED_TEST(MedianFilter, LargeWindowSymmetricPad) {
+    medfiltLargeWindowTest<TypeParam>(AF_PAD_SYM);
+}
@@ -17,10 +17,15 @@
 #include <af/random.h>
 #include <af/statistics.h>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 using af::array;
 using af::dtype;
 using af::dtype_traits;
 using af::median;
+using af::quantile;
 using af::randu;
 using af::seq;
 using af::span;
@@ -169,3 +174,83 @@ TEST(Median, TwoElements) {
     af::array gold = mean(in);
     ASSERT_ARRAYS_EQ(gold, out);
 }
+
+// The quantile q of the values along the first dimension, interpolated
+// linearly between the closest ranks
+template<typename T>
+vector<double> quantileGold(const array &in, const double q) {
+    const dim_t n     = in.dims(0);
+    const dim_t lines = in.elements() / n;
+
+    vector<T> values(in.elements());
+    in.host(values.data());
+
+    vector<double> gold(lines);
+    for (dim_t line = 0; line < lines; ++line) {
+        auto first = values.begin() + line * n;
+        std::sort(first, first + n);
+
+        const double h     = (n - 1) * q;
+        const dim_t rank   = static_cast<dim_t>(std::floor(h));
+        const double lower = first[rank];
+        const double upper = first[std::min(rank + 1, n - 1)];
+        gold[line]         = lower + (h - rank) * (upper - lower);
+    }
+    return gold;
+}
+
+template<typename T>
+void quantileTest(const dim_t n, const dim_t lines, const double q) {
+    SUPPORTED_TYPE_CHECK(T);
+    array in = generateArray<T>(n, lines, 1, 1);
+
+    const vector<double> gold = quantileGold<T>(in, q);
+
+    array out = quantile(in, q, 0);
+    ASSERT_EQ(1, out.dims(0));
+    ASSERT_EQ(lines, out.dims(1));
+
+    vector<double> values(lines);
+    out.as(f64).host(values.data());
+    for (dim_t line = 0; line < lines; ++line) {
+        ASSERT_NEAR(gold[line], values[line], 1e-3 * (1 + fabs(gold[line])))
+            << "at line " << line;
+    }
+
+    if (lines == 1) {
+        ASSERT_NEAR(gold[0], quantile<double>(in, q),
+                    1e-6 * (1 + fabs(gold[0])));
+    }
+}
+
+#define QUANTILE_TEST(T)                                                       \
+    TEST(Quantile, T##_Short) { quantileTest<T>(100, 7, 0.3); }                \
+    TEST(Quantile, T##_Long) { quantileTest<T>(10000, 3, 0.3); }               \
+    TEST(Quantile, T##_LongSingle) { quantileTest<T>(100000, 1, 0.99); }       \
+    TEST(Quantile, T##_Min) { quantileTest<T>(5000, 2, 0.0); }                 \
+    TEST(Quantile, T##_Max) { quantileTest<T>(5000, 2, 1.0); }
+
+QUANTILE_TEST(float)
+QUANTILE_TEST(double)
+QUANTILE_TEST(int)
+QUANTILE_TEST(uint)
+QUANTILE_TEST(short)
+QUANTILE_TEST(uchar)
+
+TEST(Quantile, Dim1) {
+    array in  = randu(300, 500);
+    array out = quantile(in, 0.75, 1);
+    array ref = quantile(in.T(), 0.75, 0).T();
+    ASSERT_ARRAYS_EQ(ref, out);
+}
+
+TEST(Quantile, Median) {
+    array in = randu(3001, 4);
+    ASSERT_ARRAYS_EQ(median(in), quantile(in, 0.5));
+}
+
+TEST(Quantile, InvalidQuantile) {
+    array in = randu(10);
+    EXPECT_THROW(quantile(in, 1.5), af::exception);
+    EXPECT_THROW(quantile(in, -0.1), af::exception);
+}
@@ -16,6 +16,7 @@
 #include <af/traits.hpp>
 
 #include <memory>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -272,6 +273,156 @@ TEST(Memory, LargeLoop) {
     ASSERT_EQ(lock_bytes, 1 * step_bytes);
 }
 
+TEST(Memory, ReuseLargerBuffer) {
+    size_t alloc_bytes, alloc_buffers;
+    size_t lock_bytes, lock_buffers;
+
+    cleanSlate();  // Clean up everything done so far
+
+    const int num = 64 * step_bytes / sizeof(float);
+
+    { array a = randu(num); }
+
+    // The free buffer is within the default slack of the request
+    {
+        array b = randu(num - step_bytes / sizeof(float));
+
+        deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+
+        ASSERT_EQ(alloc_buffers, 1u);
+        ASSERT_EQ(lock_buffers, 1u);
+        ASSERT_EQ(alloc_bytes, 64 * step_bytes);
+        ASSERT_EQ(lock_bytes, 64 * step_bytes);
+    }
+
+    // The free buffer is too large for the request
+    {
+        array c = randu(num / 2);
+
+        deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+
+        ASSERT_EQ(alloc_buffers, 2u);
+        ASSERT_EQ(lock_buffers, 1u);
+        ASSERT_EQ(alloc_bytes, 96 * step_bytes);
+        ASSERT_EQ(lock_bytes, 32 * step_bytes);
+    }
+}
+
+TEST(Memory, Stats) {
+    cleanSlate();  // Clean up everything done so far
+
+    const int num = 64 * step_bytes / sizeof(float);
+
+    af::setMemStatsEnabled(true);
+    ASSERT_SUCCESS(af_reset_mem_stats(-1));
+    ASSERT_SUCCESS(af_set_mem_stats_site("stage"));
+    { array a = randu(num); }
+    { array b = randu(num); }
+    ASSERT_SUCCESS(af_set_mem_stats_site(NULL));
+    af::setMemStatsEnabled(false);
+
+    af_mem_stats stats = af::getMemStats();
+    ASSERT_EQ(stats.num_allocs, 2u);
+    ASSERT_EQ(stats.cache_misses, 1u);
+    ASSERT_EQ(stats.cache_hits, 1u);
+    ASSERT_EQ(stats.peak_bytes, 64 * step_bytes);
+    ASSERT_EQ(stats.peak_buffers, 1u);
+    ASSERT_EQ(stats.size_histogram[16], 2u);
+
+    size_t length = 0;
+    ASSERT_SUCCESS(af_get_mem_stats_json(&length, NULL, -1));
+    vector<char> json(length);
+    ASSERT_SUCCESS(af_get_mem_stats_json(&length, json.data(), -1));
+    const std::string str(json.data());
+    EXPECT_NE(str.find("\"stage\":{\"num_allocs\":2"), std::string::npos)
+        << str;
+
+    size_t small = length - 1;
+    ASSERT_EQ(AF_ERR_SIZE, af_get_mem_stats_json(&small, json.data(), -1));
+    ASSERT_SUCCESS(af_reset_mem_stats(-1));
+}
+
+TEST(Memory, ArenaScope) {
+    size_t alloc_bytes, alloc_buffers;
+    size_t lock_bytes, lock_buffers;
+
+    cleanSlate();  // Clean up everything done so far
+
+    const int num = step_bytes / sizeof(float);
+
+    array escaped;
+    {
+        af::memoryScope scope(4 * step_bytes);
+        array a = randu(num);
+        array b = randu(num);
+        escaped = a + b;
+        escaped.eval();
+
+        // The arrays are allocated from the slab
+        deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes,
+                      &lock_buffers);
+        ASSERT_EQ(alloc_buffers, 1u);
+        ASSERT_EQ(lock_buffers, 1u);
+    }
+
+    // The slab is locked by the array which escaped the scope
+    vector<float> h_escaped(num);
+    escaped.host(h_escaped.data());
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(alloc_buffers, 1u);
+    ASSERT_EQ(lock_buffers, 1u);
+
+    escaped = array();
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(alloc_buffers, 1u);
+    ASSERT_EQ(lock_buffers, 0u);
+
+    ASSERT_EQ(AF_ERR_ARG, af_end_memory_scope());
+}
+
+TEST(Memory, ThreadCache) {
+    size_t alloc_bytes, alloc_buffers;
+    size_t lock_bytes, lock_buffers;
+
+    cleanSlate();  // Clean up everything done so far
+
+    const int num      = step_bytes / sizeof(float);
+    const int nthreads = 4;
+
+    // Each thread reuses the buffers it releases, and hands one array to
+    // the main thread which releases it
+    vector<array> handed(nthreads);
+    vector<std::thread> threads;
+    for (int t = 0; t < nthreads; ++t) {
+        threads.emplace_back([&handed, t, num] {
+            for (int i = 0; i < 100; ++i) {
+                array a = randu(num);
+                array b = randu(2 * num);
+                a.eval();
+                b.eval();
+            }
+            handed[t] = randu(num);
+            handed[t].eval();
+        });
+    }
+    for (auto &thread : threads) { thread.join(); }
+
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(lock_buffers, static_cast<size_t>(nthreads));
+    ASSERT_EQ(lock_bytes, nthreads * step_bytes);
+
+    handed.clear();
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(lock_buffers, 0u);
+    ASSERT_EQ(lock_bytes, 0u);
+
+    // The buffers cached by the threads are released too
+    deviceGC();
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(alloc_buffers, 0u);
+    ASSERT_EQ(alloc_bytes, 0u);
+}
+
 TEST(Memory, IndexingOffset) {
     size_t alloc_bytes, alloc_buffers;
     size_t lock_bytes, lock_buffers;
@@ -557,6 +708,50 @@ TEST(Memory, Assign2D) {
     ASSERT_EQ(alloc_bytes, alloc_bytes_after);
 }
 
+TEST(Memory, InPlaceUpdate) {
+    size_t alloc_bytes, alloc_buffers;
+    size_t lock_bytes, lock_buffers;
+
+    cleanSlate();  // Clean up everything done so far
+    {
+        array a = randu(5, 5);
+        array b = randu(5, 5);
+
+        vector<float> ha(a.elements()), hb(b.elements());
+        a.host(ha.data());
+        b.host(hb.data());
+
+        for (int i = 0; i < 10; i++) {
+            // The buffer of a is only read by the expression, so the result
+            // is written into it instead of a new buffer
+            a += b * 2;
+            a.eval();
+
+            deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes,
+                          &lock_buffers);
+            ASSERT_EQ(alloc_buffers, 2u);
+            ASSERT_EQ(lock_buffers, 2u);
+        }
+
+        for (size_t i = 0; i < ha.size(); i++) { ha[i] += 20 * hb[i]; }
+        ASSERT_VEC_ARRAY_NEAR(ha, a.dims(), a, 1e-5);
+    }
+}
+
+TEST(Memory, InPlaceUpdateShared) {
+    array a = randu(5, 5);
+    array b = randu(5, 5);
+    array c = a;
+
+    vector<float> ha(a.elements());
+    a.host(ha.data());
+
+    // c still reads the buffer, so a is written into a new buffer
+    a += b;
+    a.eval();
+    ASSERT_VEC_ARRAY_EQ(ha, c.dims(), c);
+}
+
 TEST(Memory, unlock) {
     size_t alloc_bytes, alloc_buffers;
     size_t lock_bytes, lock_buffers;
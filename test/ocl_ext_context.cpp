@@ -13,6 +13,7 @@
 #if defined(AF_OPENCL)
 #include <af/opencl.h>
 #include <iostream>
+#include <thread>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-function"
@@ -136,6 +137,42 @@ TEST(OCLCheck, DevicePlatform) {
     afcl::platform platform = afcl::getPlatform();
     ASSERT_NE(platform, AFCL_PLATFORM_UNKNOWN);
 }
+
+TEST(OCLThreadQueue, FreeAndReuse) {
+    // Two threads with their own queues free and allocate arrays of the
+    // same size, so the buffers freed by one thread are reused by the other
+    const int nelems = 1 << 20;
+    const int iters  = 50;
+    const int steps  = 8;
+
+    auto work = [&](int id, vector<float> *sums) {
+        setDevice(0);
+        cl_command_queue queue = afcl::createQueue();
+        afcl::setQueue(queue);
+        for (int i = 0; i < iters; ++i) {
+            array x = constant(id, nelems);
+            for (int s = 0; s < steps; ++s) {
+                x = x + 1;
+                x.eval();
+            }
+            (*sums)[i] = af::sum<float>(x);
+        }
+        afcl::setQueue(NULL);
+        clReleaseCommandQueue(queue);
+    };
+
+    vector<float> sums0(iters), sums1(iters);
+    std::thread t0(work, 0, &sums0);
+    std::thread t1(work, 1, &sums1);
+    t0.join();
+    t1.join();
+
+    for (int i = 0; i < iters; ++i) {
+        ASSERT_EQ(float(nelems) * steps, sums0[i]) << "at iteration " << i;
+        ASSERT_EQ(float(nelems) * (1 + steps), sums1[i])
+            << "at iteration " << i;
+    }
+}
 #else
 TEST(OCLExtContext, NoopCPU) {}
 #endif
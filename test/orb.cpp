@@ -322,3 +322,43 @@ TEST(ORB, CPP) {
     delete[] outSize;
     delete[] outDesc;
 }
+
+TEST(ORB, Batch) {
+    if (noImageIOTests()) return;
+
+    vector<dim4> inDims;
+    vector<string> inFiles;
+    vector<vector<float> > goldFeat;
+    vector<vector<unsigned> > goldDesc;
+
+    readImageFeaturesDescriptors<unsigned>(string(TEST_DIR "/orb/square.test"),
+                                           inDims, inFiles, goldFeat, goldDesc);
+    inFiles[0].insert(0, string(TEST_DIR "/orb/"));
+
+    array in    = loadImage(inFiles[0].c_str(), false);
+    array stack = af::join(2, in, in);
+
+    features feat;
+    array desc;
+    orb(feat, desc, in, 20.0f, 400, 1.2f, 8, true);
+    const unsigned num = feat.getNumFeatures();
+
+    features batchFeat;
+    array batchDesc, counts;
+    af::orbBatch(batchFeat, batchDesc, counts, stack, 20.0f, 400, 1.2f, 8,
+                 true);
+
+    ASSERT_EQ(batchFeat.getNumFeatures(), 800u);
+    ASSERT_EQ(batchDesc.dims(), dim4(8, 400, 2));
+    vector<unsigned> h_counts(2);
+    counts.host(h_counts.data());
+    ASSERT_EQ(h_counts[0], num);
+    ASSERT_EQ(h_counts[1], num);
+
+    for (int i = 0; i < 2; ++i) {
+        const af::seq feats(0, num - 1);
+        ASSERT_ARRAYS_EQ(feat.getX(), batchFeat.getX()(feats, i));
+        ASSERT_ARRAYS_EQ(feat.getScore(), batchFeat.getScore()(feats, i));
+        ASSERT_ARRAYS_EQ(desc, batchDesc(af::span, feats, i));
+    }
+}
@@ -14,6 +14,7 @@
 #include <af/dim4.hpp>
 #include <af/traits.hpp>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -192,6 +193,10 @@ using af::getSeed;
 using af::mean;
 using af::randomEngine;
 using af::randomEngineType;
+using af::randomExponential;
+using af::randomGamma;
+using af::randomPoisson;
+using af::randomTruncatedNormal;
 using af::randu;
 using af::setDefaultRandomEngineType;
 using af::setSeed;
@@ -412,3 +417,233 @@ TYPED_TEST(RandomEngineSeed, threefrySeedUniform) {
 TYPED_TEST(RandomEngineSeed, mersenneSeedUniform) {
     testRandomEngineSeed<TypeParam>(AF_RANDOM_ENGINE_MERSENNE_GP11213);
 }
+
+void testRandomEngineSubstream(randomEngineType type) {
+    const int elem = 4 * 1024;
+    randomEngine e(type, 1234);
+    randomEngine e1      = e.substream(1, 4);
+    randomEngine e2      = e.substream(2, 4);
+    randomEngine e1Again = e.substream(1, 4);
+
+    vector<float> h1(elem);
+    vector<float> h2(elem);
+    vector<float> h1Again(elem);
+    randu(elem, f32, e1).host(h1.data());
+    randu(elem, f32, e2).host(h2.data());
+    randu(elem, f32, e1Again).host(h1Again.data());
+
+    int equal = 0;
+    for (int i = 0; i < elem; i++) {
+        ASSERT_EQ(h1[i], h1Again[i]) << "at : " << i;
+        equal += h1[i] == h2[i];
+    }
+    ASSERT_LT(equal, elem / 100);
+}
+
+TEST(RandomEngine, philoxSubstream) {
+    testRandomEngineSubstream(AF_RANDOM_ENGINE_PHILOX_4X32_10);
+}
+
+TEST(RandomEngine, threefrySubstream) {
+    testRandomEngineSubstream(AF_RANDOM_ENGINE_THREEFRY_2X32_16);
+}
+
+TEST(RandomEngine, mersenneSubstream) {
+    testRandomEngineSubstream(AF_RANDOM_ENGINE_MERSENNE_GP11213);
+}
+
+void testRandomEngineSubstreams(randomEngineType type) {
+    const int elem  = 1024;
+    const int count = 5;
+    randomEngine e(type, 1234);
+    vector<randomEngine> subs(count);
+    e.substreams(subs.data(), count);
+
+    for (int i = 0; i < count; i++) {
+        randomEngine sub = e.substream(i, count);
+        vector<float> h(elem);
+        vector<float> hSub(elem);
+        randu(elem, f32, subs[i]).host(h.data());
+        randu(elem, f32, sub).host(hSub.data());
+        ASSERT_EQ(h, hSub) << "substream : " << i;
+    }
+}
+
+TEST(RandomEngine, philoxSubstreams) {
+    testRandomEngineSubstreams(AF_RANDOM_ENGINE_PHILOX_4X32_10);
+}
+
+TEST(RandomEngine, mersenneSubstreams) {
+    testRandomEngineSubstreams(AF_RANDOM_ENGINE_MERSENNE_GP11213);
+}
+
+void testRandomEngineSkip(randomEngineType type) {
+    const int elem = 4 * 1024;
+    const int skip = 3 * 1024;
+    randomEngine e(type, 1234);
+    randomEngine skipped(type, 1234);
+
+    vector<float> h(elem);
+    vector<float> hSkipped(elem);
+    randu(skip, f32, e);
+    randu(elem, f32, e).host(h.data());
+    skipped.skip(skip);
+    randu(elem, f32, skipped).host(hSkipped.data());
+    ASSERT_EQ(h, hSkipped);
+
+    // The last substream starts where the others end
+    randomEngine last = e.substream(3, 4);
+    randomEngine base(type, 1234);
+    base.skip(skip + elem);
+    base.skip(3 * (std::numeric_limits<unsigned long long>::max() / 4));
+    vector<float> hLast(elem);
+    vector<float> hBase(elem);
+    randu(elem, f32, last).host(hLast.data());
+    randu(elem, f32, base).host(hBase.data());
+    ASSERT_EQ(hLast, hBase);
+}
+
+TEST(RandomEngine, philoxSkip) {
+    testRandomEngineSkip(AF_RANDOM_ENGINE_PHILOX_4X32_10);
+}
+
+TEST(RandomEngine, threefrySkip) {
+    testRandomEngineSkip(AF_RANDOM_ENGINE_THREEFRY_2X32_16);
+}
+
+TEST(RandomEngine, mersenneSkipNotSupported) {
+    af_random_engine e = 0;
+    ASSERT_SUCCESS(
+        af_create_random_engine(&e, AF_RANDOM_ENGINE_MERSENNE_GP11213, 1));
+    ASSERT_EQ(AF_ERR_NOT_SUPPORTED, af_random_engine_skip(&e, 16));
+    ASSERT_SUCCESS(af_release_random_engine(e));
+}
+
+template<typename T>
+void testRandomEngineFused(randomEngineType type) {
+    SUPPORTED_TYPE_CHECK(T);
+    dtype ty = (dtype)dtype_traits<T>::af_type;
+
+    // The fused values match the values of the evaluated array, in the linear
+    // kernels and in the kernels indexed by the dimensions (for the tile)
+    const dim4 dims(1000, 37, 3);
+    randomEngine r1(type, 42);
+    randomEngine r2(type, 42);
+    array offset = af::range(dim4(1, 37), 1, ty);
+
+    array evaluated = randu(dims, ty, r1);
+    evaluated.eval();
+    array linear  = randu(dims, ty, r2) * 2 + 1;
+    array general = randu(dims, ty, r2) + af::tile(offset, 1000, 1, 3);
+
+    array evaluated2 = randu(dims, ty, r1);
+    evaluated2.eval();
+    ASSERT_ARRAYS_EQ(evaluated * 2 + 1, linear);
+    ASSERT_ARRAYS_EQ(evaluated2 + af::tile(offset, 1000, 1, 3), general);
+}
+
+TYPED_TEST(RandomEngine, philoxFused) {
+    testRandomEngineFused<TypeParam>(AF_RANDOM_ENGINE_PHILOX_4X32_10);
+}
+
+TYPED_TEST(RandomEngine, threefryFused) {
+    testRandomEngineFused<TypeParam>(AF_RANDOM_ENGINE_THREEFRY_2X32_16);
+}
+
+template<typename T>
+void testRandomDistributions() {
+    SUPPORTED_TYPE_CHECK(T);
+    dtype ty       = (dtype)dtype_traits<T>::af_type;
+    const int elem = 1 << 18;
+    randomEngine r(AF_RANDOM_ENGINE_PHILOX_4X32_10, 42);
+
+    // The parameters of the first half of the elements differ from the
+    // parameters of the second half
+    const af::seq lo(0, elem / 2 - 1);
+    const af::seq hi(elem / 2, elem - 1);
+    array halves = af::join(0, constant(0, elem / 2, ty),
+                            constant(1, elem / 2, ty));
+
+    array e = randomExponential(halves * 2 + 2, r);
+    ASSERT_EQ(ty, e.type());
+    ASSERT_TRUE(allTrue<bool>(e >= 0));
+    ASSERT_NEAR(0.5, mean<double>(e(lo)), 0.01);
+    ASSERT_NEAR(0.25, mean<double>(e(hi)), 0.005);
+    ASSERT_NEAR(0.25, stdev<double>(e(hi), AF_VARIANCE_POPULATION), 0.005);
+
+    array g = randomGamma(halves * 3.5 + 0.5, constant(2, elem, ty), r);
+    ASSERT_NEAR(1, mean<double>(g(lo)), 0.02);
+    ASSERT_NEAR(8, mean<double>(g(hi)), 0.05);
+    ASSERT_NEAR(16, af::var<double>(g(hi), AF_VARIANCE_POPULATION), 0.5);
+
+    array p = randomPoisson(halves * 97 + 3, r);
+    ASSERT_TRUE(allTrue<bool>(p == af::floor(p)));
+    ASSERT_NEAR(3, mean<double>(p(lo)), 0.02);
+    ASSERT_NEAR(100, mean<double>(p(hi)), 0.15);
+    ASSERT_NEAR(100, af::var<double>(p(hi), AF_VARIANCE_POPULATION), 2);
+
+    // [-1, 2] and the tail [3, inf)
+    array lower = halves * 4 - 1;
+    array upper = af::select(halves > 0, af::Inf, constant(2, elem, ty));
+    array n     = randomTruncatedNormal(lower, upper, r);
+    ASSERT_TRUE(allTrue<bool>(n >= lower && n <= upper));
+    ASSERT_NEAR(0.2296, mean<double>(n(lo)), 0.01);
+    ASSERT_NEAR(3.2831, mean<double>(n(hi)), 0.01);
+}
+
+TYPED_TEST(RandomEngine, distributions) {
+    testRandomDistributions<TypeParam>();
+}
+
+TEST(RandomEngine, distributionsInvalidParameters) {
+    randomEngine r(AF_RANDOM_ENGINE_PHILOX_4X32_10, 42);
+    array zero = constant(0, 10);
+    array one  = constant(1, 10);
+
+    ASSERT_TRUE(allTrue<bool>(af::isNaN(randomExponential(zero, r))));
+    ASSERT_TRUE(allTrue<bool>(af::isNaN(randomGamma(zero, one, r))));
+    ASSERT_TRUE(allTrue<bool>(af::isNaN(randomGamma(one, -one, r))));
+    ASSERT_TRUE(allTrue<bool>(af::isNaN(randomPoisson(-one, r))));
+    ASSERT_TRUE(allTrue<bool>(randomPoisson(zero, r) == 0));
+    ASSERT_TRUE(allTrue<bool>(af::isNaN(randomTruncatedNormal(one, one, r))));
+}
+
+TEST(RandomEngine, distributionsInvalidArguments) {
+    randomEngine r(AF_RANDOM_ENGINE_PHILOX_4X32_10, 42);
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_TYPE,
+              af_random_exponential(&out, constant(1, 10, s32).get(), r.get()));
+    ASSERT_EQ(AF_ERR_TYPE,
+              af_random_gamma(&out, constant(1, 10).get(),
+                              constant(1, 10, f64).get(), r.get()));
+    ASSERT_EQ(AF_ERR_SIZE,
+              af_random_truncated_normal(&out, constant(0, 10).get(),
+                                         constant(1, 11).get(), r.get()));
+}
+
+void testRandomDistributionsSeed(randomEngineType type) {
+    array lambda = af::range(dim4(1000)) / 10;
+
+    // The values only depend on the seed and the counter of the engine
+    randomEngine r1(type, 1234);
+    randomEngine r2(type, 1234);
+    array p1 = randomPoisson(lambda, r1);
+    array p2 = randomPoisson(lambda, r2);
+    ASSERT_ARRAYS_EQ(p1, p2);
+    ASSERT_FALSE(allTrue<bool>(randomPoisson(lambda, r1) == p1));
+
+    r1.setSeed(1234);
+    ASSERT_ARRAYS_EQ(p1, randomPoisson(lambda, r1));
+}
+
+TEST(RandomEngine, philoxDistributionsSeed) {
+    testRandomDistributionsSeed(AF_RANDOM_ENGINE_PHILOX_4X32_10);
+}
+
+TEST(RandomEngine, threefryDistributionsSeed) {
+    testRandomDistributionsSeed(AF_RANDOM_ENGINE_THREEFRY_2X32_16);
+}
+
+TEST(RandomEngine, mersenneDistributionsSeed) {
+    testRandomDistributionsSeed(AF_RANDOM_ENGINE_MERSENNE_GP11213);
+}
@@ -171,3 +171,28 @@ TEST(Range, CPP) {
     // Delete
     delete[] outData;
 }
+
+TEST(Range, FusedExpression) {
+    // The sub-array is not linear, so the range is generated at the
+    // coordinates of the elements instead of their linear index
+    array a = af::constant(1, 10, 8, 2);
+    array b = a(af::seq(1, 6), af::span, af::span);
+    dim4 dims(6, 8, 2);
+
+    array linear  = range(dims, 1) * 2 + 1;
+    array general = range(dims, 2) + b;
+
+    vector<float> hLinear(dims.elements());
+    vector<float> hGeneral(dims.elements());
+    for (int z = 0; z < 2; z++) {
+        for (int y = 0; y < 8; y++) {
+            for (int x = 0; x < 6; x++) {
+                int idx       = x + 6 * (y + 8 * z);
+                hLinear[idx]  = y * 2 + 1;
+                hGeneral[idx] = z + 1;
+            }
+        }
+    }
+    ASSERT_VEC_ARRAY_EQ(hLinear, dims, linear);
+    ASSERT_VEC_ARRAY_EQ(hGeneral, dims, general);
+}
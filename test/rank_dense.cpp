@@ -113,6 +113,95 @@ void detTest() {
 
 TYPED_TEST(Det, Small) { detTest<TypeParam>(); }
 
+TEST(Det, Swapped) {
+    if (noLAPACKTests()) return;
+
+    // The rows of the identity swapped twice and once
+    float ha[] = {0, 1, 0, 0, 0, 1, 1, 0, 0};
+    float hb[] = {0, 1, 0, 1, 0, 0, 0, 0, 2};
+
+    ASSERT_NEAR(1.0f, det<float>(array(3, 3, ha)), 1e-6);
+    ASSERT_NEAR(-2.0f, det<float>(array(3, 3, hb)), 1e-6);
+}
+
+template<typename T>
+void detBatchedTest() {
+    SUPPORTED_TYPE_CHECK(T);
+    if (noLAPACKTests()) return;
+
+    dtype dt = (dtype)dtype_traits<T>::af_type;
+    array in = randu(8, 8, 3, 2, dt);
+
+    array dets = af::detBatched(in);
+    array logAbs, sign;
+    af::logDet(logAbs, sign, in);
+    ASSERT_EQ(dim4(1, 1, 3, 2), dets.dims());
+    ASSERT_EQ(dim4(1, 1, 3, 2), logAbs.dims());
+    ASSERT_EQ(dim4(1, 1, 3, 2), sign.dims());
+
+    vector<T> hDets(dets.elements());
+    vector<T> hSign(sign.elements());
+    vector<typename dtype_traits<T>::base_type> hLogAbs(logAbs.elements());
+    dets.host(hDets.data());
+    sign.host(hSign.data());
+    logAbs.host(hLogAbs.data());
+
+    for (int w = 0; w < 2; w++) {
+        for (int z = 0; z < 3; z++) {
+            const int i     = z + 3 * w;
+            const T gold    = det<T>(in(af::span, af::span, z, w));
+            const T fromLog = hSign[i] * (T)std::exp(hLogAbs[i]);
+            ASSERT_NEAR(0, abs(gold - hDets[i]), 1e-4 * abs(gold));
+            ASSERT_NEAR(0, abs(gold - fromLog), 1e-4 * abs(gold));
+        }
+    }
+}
+
+TYPED_TEST(Det, Batched) { detBatchedTest<TypeParam>(); }
+
+TEST(Det, LogSingular) {
+    if (noLAPACKTests()) return;
+
+    float ha[] = {1, 2, 2, 4};
+    array logAbs, sign;
+    af::logDet(logAbs, sign, array(2, 2, ha));
+
+    ASSERT_EQ(0.0f, sign.scalar<float>());
+    ASSERT_TRUE(std::isinf(logAbs.scalar<float>()));
+}
+
+template<typename T>
+class NormBatched : public ::testing::Test {};
+
+TYPED_TEST_CASE(NormBatched, TestTypes);
+
+TYPED_TEST(NormBatched, MatchesNorm) {
+    SUPPORTED_TYPE_CHECK(TypeParam);
+
+    dtype dt = (dtype)dtype_traits<TypeParam>::af_type;
+    array in = randu(13, 7, 2, 3, dt) - 0.5;
+
+    const af::normType types[] = {
+        AF_NORM_EUCLID,     AF_NORM_VECTOR_1,  AF_NORM_VECTOR_INF,
+        AF_NORM_VECTOR_P,   AF_NORM_MATRIX_1,  AF_NORM_MATRIX_INF,
+        AF_NORM_MATRIX_L_PQ};
+    for (af::normType type : types) {
+        array norms = af::normBatched(in, type, 3, 2);
+        ASSERT_EQ(dim4(1, 1, 2, 3), norms.dims());
+
+        vector<double> hNorms(norms.elements());
+        norms.as(f64).host(hNorms.data());
+        for (int w = 0; w < 3; w++) {
+            for (int z = 0; z < 2; z++) {
+                const double gold =
+                    af::norm(in(af::span, af::span, z, w), type, 3, 2);
+                ASSERT_NEAR(gold, hNorms[z + 2 * w], 1e-4 * gold)
+                    << "for type " << type;
+            }
+        }
+    }
+}
+
 TEST(Rank, NullOutput) {
     if (noLAPACKTests()) return;
     dim4 dims(3, 3);
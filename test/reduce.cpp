@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -2065,3 +2066,285 @@ TEST(ReduceByKey, ISSUE_2955_dim) {
     ASSERT_EQ(ok.dims(0), 128);
     ASSERT_EQ(ov.dims(1), 128);
 }
+
+TEST(Reduce, SumOfJitExpression) {
+    const int nx = 1000;
+    const int ny = 37;
+    array a      = randu(nx, ny);
+    array b      = randu(nx, ny);
+    array c      = randu(nx, ny);
+
+    array expr = a * b + c;
+    array gold = a * b + c;
+    gold.eval();
+
+    ASSERT_ARRAYS_EQ(sum(gold, 0), sum(expr, 0));
+    ASSERT_ARRAYS_EQ(max(gold, 0), max(expr, 0));
+    ASSERT_ARRAYS_EQ(sum(gold, 1), sum(expr, 1));
+    ASSERT_EQ(sum<float>(gold), sum<float>(expr));
+    ASSERT_EQ(min<float>(gold), min<float>(expr));
+}
+
+TEST(Reduce, MinMaxIndexOfLongLineWithNaN) {
+    // The line spans several blocks of the CPU backend, and some of the blocks
+    // start with a NaN
+    const int n = 100000;
+    vector<float> h_in(n);
+    for (int i = 0; i < n; ++i) {
+        h_in[i] = (i % 16384 == 0 || i % 7 == 3) ? NAN : float((i * 37) % 1001);
+    }
+    h_in[50000] = -5.0f;
+    h_in[70000] = 2000.0f;
+    array in(n, h_in.data());
+
+    float val;
+    unsigned idx;
+    min(&val, &idx, in);
+    ASSERT_EQ(-5.0f, val);
+    ASSERT_EQ(50000u, idx);
+    max(&val, &idx, in);
+    ASSERT_EQ(2000.0f, val);
+    ASSERT_EQ(70000u, idx);
+
+    array vals, idxs;
+    min(vals, idxs, in, 0);
+    ASSERT_EQ(-5.0f, vals.scalar<float>());
+    ASSERT_EQ(50000u, idxs.scalar<unsigned>());
+    max(vals, idxs, in, 0);
+    ASSERT_EQ(2000.0f, vals.scalar<float>());
+    ASSERT_EQ(70000u, idxs.scalar<unsigned>());
+}
+
+TEST(Reduce, AllOfLongLineMatchesHost) {
+    // The line spans more blocks than the single launch reduction has, so the
+    // blocks reduce several tiles before the last one combines them
+    const int n = 1 << 22;
+    vector<int> h_in(n);
+    for (int i = 0; i < n; ++i) { h_in[i] = (i * 7919) % 1013 - 500; }
+    h_in[123457]  = 100000;
+    h_in[3000001] = -100000;
+    array in(n, h_in.data());
+
+    double gold = 0.0;
+    int nonzero = 0;
+    for (int i = 0; i < n; ++i) {
+        gold += h_in[i];
+        nonzero += h_in[i] != 0;
+    }
+
+    ASSERT_EQ(gold, sum<double>(in));
+    ASSERT_EQ(100000, max<int>(in));
+    ASSERT_EQ(-100000, min<int>(in));
+    ASSERT_EQ(nonzero, count<int>(in));
+    ASSERT_EQ(gold, sum(in).scalar<int>());
+    ASSERT_EQ(gold, sum(in(seq(1, n - 1))).scalar<int>() + h_in[0]);
+}
+
+TEST(Summary, MatchesReductions) {
+    const int nx = 1000;
+    const int ny = 37;
+    array a      = randu(nx, ny) - 0.5f;
+    a(5, 3)      = 0.0f;
+
+    double mn, mx, s, ss, cnt;
+    summary(&mn, &mx, &s, &ss, &cnt, a);
+    ASSERT_EQ(min<float>(a), mn);
+    ASSERT_EQ(max<float>(a), mx);
+    ASSERT_NEAR(sum<float>(a), s, 1e-2);
+    ASSERT_NEAR(sum<float>(a * a), ss, 1e-4 * ss);
+    ASSERT_EQ(count<unsigned>(a), cnt);
+
+    // A non-linear array, and statistics which are not needed
+    array sub = a(af::seq(10, 500), af::seq(2, 30));
+    summary(&mn, NULL, &s, NULL, NULL, sub);
+    ASSERT_EQ(min<float>(sub), mn);
+    ASSERT_NEAR(sum<float>(sub), s, 1e-2);
+}
+
+TEST(Summary, Integers) {
+    vector<int> h_in(100000);
+    for (size_t i = 0; i < h_in.size(); ++i) { h_in[i] = int(i % 201) - 100; }
+    array in(dim4(h_in.size()), h_in.data());
+
+    double mn, mx, s, ss, cnt;
+    summary(&mn, &mx, &s, &ss, &cnt, in);
+    ASSERT_EQ(-100.0, mn);
+    ASSERT_EQ(100.0, mx);
+    ASSERT_EQ(double(sum<int>(in)), s);
+    ASSERT_EQ(count<unsigned>(in), cnt);
+}
+
+TEST(Summary, NaN) {
+    vector<float> h_in(100000);
+    for (size_t i = 0; i < h_in.size(); ++i) {
+        h_in[i] = i % 7 == 2 ? NAN : float((i * 37) % 1001);
+    }
+    h_in[50000] = -5.0f;
+    array in(dim4(h_in.size()), h_in.data());
+
+    double mn, mx, s, cnt;
+    summary(&mn, &mx, &s, NULL, &cnt, in);
+    ASSERT_EQ(-5.0, mn);
+    ASSERT_EQ(1000.0, mx);
+    ASSERT_TRUE(std::isnan(s));
+    ASSERT_EQ(count<unsigned>(in), cnt);
+}
+
+TEST(Summary, Complex) {
+    double s;
+    ASSERT_EQ(AF_ERR_TYPE,
+              af_summary_all(NULL, NULL, &s, NULL, NULL,
+                             randu(10, c32).get()));
+}
+
+TEST(Segmented, Reductions) {
+    // Two columns of three segments, the second of which is empty
+    const float h_in[]    = {3, 1, 2, 5, 4, 9, 7, 8, 6, 0};
+    const int h_offsets[] = {0, 3, 3, 5};
+    array in(dim4(5, 2), h_in);
+    array offsets(4, h_offsets);
+
+    const float inf = std::numeric_limits<float>::infinity();
+    const dim4 odims(3, 2);
+    ASSERT_VEC_ARRAY_EQ(vector<float>({6, 0, 9, 24, 0, 6}), odims,
+                        sumSegmented(in, offsets));
+    ASSERT_VEC_ARRAY_EQ(vector<float>({1, inf, 4, 7, inf, 0}), odims,
+                        minSegmented(in, offsets));
+    ASSERT_VEC_ARRAY_EQ(vector<float>({3, -inf, 5, 9, -inf, 6}), odims,
+                        maxSegmented(in, offsets));
+}
+
+TEST(Segmented, ReductionsMatchByKey) {
+    const int nsegs = 1000;
+    vector<unsigned> h_offsets(nsegs + 1, 0);
+    vector<unsigned> h_keys;
+    for (int i = 0; i < nsegs; ++i) {
+        const unsigned len = (i * 37) % 11 + 1;
+        h_offsets[i + 1]   = h_offsets[i] + len;
+        h_keys.insert(h_keys.end(), len, i);
+    }
+    const dim_t n = h_offsets.back();
+    array keys(n, h_keys.data());
+    array offsets(nsegs + 1, h_offsets.data());
+    array in = randu(n, s32);
+
+    array okeys, gold;
+    sumByKey(okeys, gold, keys, in);
+    ASSERT_ARRAYS_EQ(gold, sumSegmented(in, offsets));
+    minByKey(okeys, gold, keys, in);
+    ASSERT_ARRAYS_EQ(gold, minSegmented(in, offsets));
+}
+
+TEST(ReduceByKeyUnsorted, Small) {
+    const int h_keys[]   = {4, 1, 4, 7, 1, 4, -2};
+    const float h_vals[] = {1, 2, 3, 4, 5, 6, 7};
+    array keys(7, h_keys);
+    array vals(7, h_vals);
+
+    array okeys, ovals;
+    reduceByKeyUnsorted(okeys, ovals, keys, vals);
+    ASSERT_VEC_ARRAY_EQ(vector<int>({-2, 1, 4, 7}), dim4(4), okeys);
+    ASSERT_VEC_ARRAY_EQ(vector<float>({7, 7, 10, 4}), dim4(4), ovals);
+
+    reduceByKeyUnsorted(okeys, ovals, keys, vals, AF_BINARY_MIN);
+    ASSERT_VEC_ARRAY_EQ(vector<float>({7, 2, 1, 4}), dim4(4), ovals);
+
+    reduceByKeyUnsorted(okeys, ovals, keys, vals, AF_BINARY_MAX);
+    ASSERT_VEC_ARRAY_EQ(vector<float>({7, 5, 6, 4}), dim4(4), ovals);
+}
+
+// Few distinct keys are reduced with a hash table, and many are sorted
+TEST(ReduceByKeyUnsorted, MatchesSortedByKey) {
+    const dim_t n = 100000;
+    for (const unsigned distinct : {50u, 50000u}) {
+        array keys = (randu(n, u32) % distinct).as(u32);
+        array vals = (randu(n, u32) % 1000).as(s32);
+
+        array skeys, svals;
+        sort(skeys, svals, keys, vals);
+
+        array okeys, ovals, gkeys, gvals;
+        reduceByKeyUnsorted(okeys, ovals, keys, vals);
+        sumByKey(gkeys, gvals, skeys, svals);
+        ASSERT_ARRAYS_EQ(gkeys, okeys);
+        ASSERT_ARRAYS_EQ(gvals, ovals);
+
+        reduceByKeyUnsorted(okeys, ovals, keys, vals, AF_BINARY_MAX);
+        maxByKey(gkeys, gvals, skeys, svals);
+        ASSERT_ARRAYS_EQ(gkeys, okeys);
+        ASSERT_ARRAYS_EQ(gvals, ovals);
+    }
+}
+
+TEST(ReduceAllArray, MatchesHostReductions) {
+    array in = randu(1000, 37);
+
+    af_array out = 0;
+    ASSERT_SUCCESS(af_sum_all_array(&out, in.get()));
+    array res(out);
+    ASSERT_EQ(dim4(1), res.dims());
+    ASSERT_NEAR(sum<float>(in), res.scalar<float>(), 1e-2);
+
+    ASSERT_SUCCESS(af_max_all_array(&out, in.get()));
+    res = array(out);
+    ASSERT_EQ(max<float>(in), res.scalar<float>());
+
+    // The result is used on the device without a copy to the host
+    array scaled = in / res;
+    ASSERT_EQ(1.0f, max<float>(scaled));
+
+    af_array val = 0, idx = 0;
+    ASSERT_SUCCESS(af_imin_all_array(&val, &idx, in.get()));
+    array vals(val), idxs(idx);
+    float hval;
+    unsigned hidx;
+    min(&hval, &hidx, in);
+    ASSERT_EQ(hval, vals.scalar<float>());
+    ASSERT_EQ(hidx, idxs.scalar<unsigned>());
+
+    ASSERT_SUCCESS(af_count_all_array(&out, (in > 0.5f).get()));
+    res = array(out);
+    ASSERT_EQ(count<unsigned>(in > 0.5f), res.scalar<unsigned>());
+}
+
+TEST(ReduceAllArray, AsyncReadback) {
+    array in = randu(100000);
+
+    af_array out = 0;
+    ASSERT_SUCCESS(af_sum_all_array(&out, in.get()));
+    array res(out);
+
+    float hsum    = 0.0f;
+    af_event evnt = 0;
+    ASSERT_SUCCESS(af_get_data_ptr_async(&evnt, &hsum, res.get()));
+    ASSERT_SUCCESS(af_block_event(evnt));
+    ASSERT_SUCCESS(af_delete_event(evnt));
+    ASSERT_NEAR(sum<float>(in), hsum, 1e-1);
+}
+
+TEST(ReduceDims, MatchesChainedReductions) {
+    array in = randu(33, 17, 3, 4);
+
+    const int spatial[] = {1, 0};
+    ASSERT_ARRAYS_NEAR(sum(sum(in, 0), 1), sumDims(in, 2, spatial), 1e-4);
+    ASSERT_ARRAYS_EQ(max(max(in, 0), 1), maxDims(in, 2, spatial));
+    ASSERT_ARRAYS_EQ(sum(count(in > 0.5f, 0), 1),
+                     countDims(in > 0.5f, 2, spatial));
+
+    // The runs {0, 1} and {3} are reduced separately
+    const int channels[] = {0, 1, 3};
+    array gold           = sum(sum(sum(in, 0), 1), 3);
+    ASSERT_EQ(dim4(1, 1, 3, 1), sumDims(in, 3, channels).dims());
+    ASSERT_ARRAYS_NEAR(gold, sumDims(in, 3, channels), 1e-3);
+    ASSERT_ARRAYS_EQ(min(min(min(in, 0), 1), 3), minDims(in, 3, channels));
+
+    // A view is not linear, so merging its dimensions copies it
+    array view         = in(seq(1, 30), span, seq(0, 1));
+    const int middle[] = {1, 2};
+    ASSERT_ARRAYS_NEAR(sum(sum(view, 1), 2), sumDims(view, 2, middle), 1e-4);
+
+    const int repeated[] = {0, 0};
+    ASSERT_THROW(sumDims(in, 2, repeated), af::exception);
+    const int invalid[] = {4};
+    ASSERT_THROW(sumDims(in, 1, invalid), af::exception);
+}
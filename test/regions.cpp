@@ -14,6 +14,8 @@
 #include <af/dim4.hpp>
 #include <af/image.h>
 #include <af/traits.hpp>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -266,3 +268,196 @@ TEST(Regions, NoComponentImage) {
     for (int i = 0; i < sz; ++i)
         ASSERT_FLOAT_EQ(gold[i], output[i]) << " mismatch at i=" << i << endl;
 }
+
+// Labels the components in the order of their first pixel in memory and
+// computes the area and bounding box of each one
+static void regionsReference(vector<float>& labels, vector<unsigned>& stats,
+                             const vector<char>& in, int rows, int cols,
+                             bool diag) {
+    labels.assign(in.size(), 0.0f);
+    stats.clear();
+    vector<int> stack;
+    for (int p = 0; p < rows * cols; ++p) {
+        if (!in[p] || labels[p] != 0.0f) continue;
+        const float label = static_cast<float>(stats.size() / 5 + 1);
+        unsigned s[5]     = {0, unsigned(rows), unsigned(cols), 0, 0};
+        labels[p]         = label;
+        stack.push_back(p);
+        while (!stack.empty()) {
+            const int q = stack.back();
+            stack.pop_back();
+            const int i = q % rows, j = q / rows;
+            s[0]++;
+            s[1] = std::min(s[1], unsigned(i));
+            s[2] = std::min(s[2], unsigned(j));
+            s[3] = std::max(s[3], unsigned(i));
+            s[4] = std::max(s[4], unsigned(j));
+            for (int dj = -1; dj <= 1; ++dj) {
+                for (int di = -1; di <= 1; ++di) {
+                    if ((di == 0 && dj == 0) || (!diag && di != 0 && dj != 0))
+                        continue;
+                    const int ni = i + di, nj = j + dj;
+                    if (ni < 0 || nj < 0 || ni >= rows || nj >= cols) continue;
+                    const int n = nj * rows + ni;
+                    if (in[n] && labels[n] == 0.0f) {
+                        labels[n] = label;
+                        stack.push_back(n);
+                    }
+                }
+            }
+        }
+        stats.insert(stats.end(), s, s + 5);
+    }
+}
+
+static void regionsStatsTest(af_connectivity connectivity) {
+    const int rows = 600, cols = 500;
+    array in       = (af::randu(rows, cols) < 0.45).as(b8);
+
+    array stats;
+    array out = regions(stats, in, connectivity);
+
+    vector<char> input(rows * cols);
+    in.host(input.data());
+    vector<float> gold;
+    vector<unsigned> goldStats;
+    regionsReference(gold, goldStats, input, rows, cols,
+                     connectivity == AF_CONNECTIVITY_8);
+
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(rows, cols), out);
+    ASSERT_EQ(u32, stats.type());
+    ASSERT_VEC_ARRAY_EQ(goldStats, dim4(5, goldStats.size() / 5), stats);
+}
+
+TEST(Regions, Stats4) { regionsStatsTest(AF_CONNECTIVITY_4); }
+
+TEST(Regions, Stats8) { regionsStatsTest(AF_CONNECTIVITY_8); }
+
+TEST(Regions, StatsNoComponent) {
+    array in = af::constant(0, 64, 64, b8);
+    array stats;
+    array out = regions(stats, in);
+
+    ASSERT_EQ(0, stats.elements());
+    ASSERT_EQ(0.0f, af::max<float>(out));
+}
+
+namespace {
+/// The properties of the labels 1 to nlabels of a label image
+vector<double> regionPropsReference(const vector<float> &labels, int rows,
+                                    int cols, int nlabels) {
+    vector<double> props(13 * nlabels, 0.0);
+    vector<double> sums(6 * nlabels, 0.0);
+    for (int j = 0; j < cols; ++j) {
+        for (int i = 0; i < rows; ++i) {
+            const int label = static_cast<int>(labels[j * rows + i]);
+            if (label < 1 || label > nlabels) { continue; }
+            double *p = &props[13 * (label - 1)];
+            double *s = &sums[6 * (label - 1)];
+            if (p[0] == 0) {
+                p[3] = p[5] = i;
+                p[4] = p[6] = j;
+            }
+            p[0] += 1;
+            p[3] = std::min<double>(p[3], i);
+            p[4] = std::min<double>(p[4], j);
+            p[5] = std::max<double>(p[5], i);
+            p[6] = std::max<double>(p[6], j);
+            s[0] += i;
+            s[1] += j;
+            s[2] += double(i) * i;
+            s[3] += double(j) * j;
+            s[4] += double(i) * j;
+        }
+    }
+    for (int l = 0; l < nlabels; ++l) {
+        double *p       = &props[13 * l];
+        const double *s = &sums[6 * l];
+        if (p[0] == 0) { continue; }
+        const double mr = s[0] / p[0];
+        const double mc = s[1] / p[0];
+        p[1]            = mr;
+        p[2]            = mc;
+        p[7]            = s[0];
+        p[8]            = s[1];
+        p[9]            = s[4];
+        p[10]           = s[2] - s[0] * mr;
+        p[11]           = s[3] - s[1] * mc;
+        p[12]           = s[4] - s[0] * mc;
+    }
+    return props;
+}
+
+void expectRegionProps(const vector<double> &gold, const array &props) {
+    ASSERT_EQ(f32, props.type());
+    ASSERT_EQ(gold.size(), props.elements());
+    vector<float> out(gold.size());
+    props.host(out.data());
+    for (size_t k = 0; k < gold.size(); ++k) {
+        // |mu11| is bounded by the larger of mu20 and mu02, so its error is
+        // relative to them
+        const size_t prop = k % 13;
+        const double scale =
+            prop == 12 ? gold[k - 2] + gold[k - 1] : std::abs(gold[k]);
+        EXPECT_NEAR(gold[k], out[k], 1e-4 * std::max(1.0, scale))
+            << "property " << prop << " of label " << k / 13 + 1;
+    }
+}
+}  // namespace
+
+TEST(RegionProps, MatchesRegions) {
+    const int rows = 300, cols = 200;
+    array in       = (af::randu(rows, cols) < 0.45).as(b8);
+
+    array stats;
+    array labels = regions(stats, in, AF_CONNECTIVITY_8);
+    array props  = af::regionProps(labels);
+
+    vector<float> hLabels(rows * cols);
+    labels.host(hLabels.data());
+    const int nlabels = static_cast<int>(stats.dims(1));
+    ASSERT_EQ(nlabels, props.dims(1));
+    expectRegionProps(regionPropsReference(hLabels, rows, cols, nlabels),
+                      props);
+
+    // The areas and the bounding boxes are the statistics of regions
+    array fstats = stats.as(f32);
+    ASSERT_ARRAYS_EQ(fstats.row(0), props.row(0));
+    ASSERT_ARRAYS_EQ(fstats.rows(1, 4), props.rows(3, 6));
+}
+
+TEST(RegionProps, LabelCount) {
+    // Labels larger than the count are ignored and missing labels are empty
+    const int rows = 64, cols = 48;
+    array labels   = af::floor(af::randu(rows, cols) * 6).as(s32);
+    vector<float> hLabels(rows * cols);
+    labels.as(f32).host(hLabels.data());
+
+    array props = af::regionProps(labels, 8);
+    ASSERT_EQ(8, props.dims(1));
+    expectRegionProps(regionPropsReference(hLabels, rows, cols, 8), props);
+
+    props = af::regionProps(labels, 3);
+    expectRegionProps(regionPropsReference(hLabels, rows, cols, 3), props);
+}
+
+TEST(RegionProps, FarFromOrigin) {
+    // A small square far from the origin has exact central moments
+    array labels = af::constant(0, 2000, 1500, u16);
+    labels(af::seq(1990, 1993), af::seq(1400, 1402)) = 1;
+
+    array props = af::regionProps(labels);
+    vector<float> out(13);
+    props.host(out.data());
+    EXPECT_EQ(12.f, out[0]);
+    EXPECT_FLOAT_EQ(1991.5f, out[1]);
+    EXPECT_FLOAT_EQ(1401.f, out[2]);
+    EXPECT_FLOAT_EQ(15.f, out[10]);
+    EXPECT_FLOAT_EQ(8.f, out[11]);
+    EXPECT_NEAR(0.f, out[12], 1e-4);
+}
+
+TEST(RegionProps, NoLabels) {
+    array props = af::regionProps(af::constant(0, 32, 32));
+    ASSERT_EQ(0, props.elements());
+}
@@ -13,6 +13,7 @@
 #include <af/defines.h>
 #include <af/dim4.hpp>
 #include <af/traits.hpp>
+#include <algorithm>
 #include <complex>
 #include <iostream>
 #include <string>
@@ -198,3 +199,42 @@ TEST(Reorder, InputArrayUnchanged) {
     array input_gold(2, 3, 2, h_input);
     ASSERT_ARRAYS_EQ(input_gold, input);
 }
+
+TEST(Reorder, AllPermutationsLarge) {
+    // The sizes are not multiples of the blocks of the CPU transpose
+    const dim4 idims(37, 41, 6, 5);
+    vector<float> h_input(idims.elements());
+    for (size_t i = 0; i < h_input.size(); i++) { h_input[i] = (float)(i); }
+    array input(idims, &h_input.front());
+
+    unsigned rdims[4] = {0, 1, 2, 3};
+    do {
+        array output = reorder(input, rdims[0], rdims[1], rdims[2], rdims[3]);
+
+        const dim4 odims(idims[rdims[0]], idims[rdims[1]], idims[rdims[2]],
+                         idims[rdims[3]]);
+        const dim4 istrides(1, idims[0], idims[0] * idims[1],
+                            idims[0] * idims[1] * idims[2]);
+        const dim4 ostrides(1, odims[0], odims[0] * odims[1],
+                            odims[0] * odims[1] * odims[2]);
+        vector<float> gold(idims.elements());
+        dim_t ids[4];
+        for (ids[3] = 0; ids[3] < idims[3]; ids[3]++) {
+            for (ids[2] = 0; ids[2] < idims[2]; ids[2]++) {
+                for (ids[1] = 0; ids[1] < idims[1]; ids[1]++) {
+                    for (ids[0] = 0; ids[0] < idims[0]; ids[0]++) {
+                        dim_t iIdx = 0, oIdx = 0;
+                        for (int d = 0; d < 4; d++) {
+                            iIdx += ids[d] * istrides[d];
+                            oIdx += ids[rdims[d]] * ostrides[d];
+                        }
+                        gold[oIdx] = h_input[iIdx];
+                    }
+                }
+            }
+        }
+        ASSERT_VEC_ARRAY_EQ(gold, odims, output)
+            << "for the permutation " << rdims[0] << rdims[1] << rdims[2]
+            << rdims[3];
+    } while (std::next_permutation(rdims, rdims + 4));
+}
@@ -419,3 +419,27 @@ TEST(Resize, ExtractGFOR) {
         ASSERT_EQ(max<double>(abs(c_ii - b_ii)) < 1E-5, true);
     }
 }
+
+TEST(Pyramid, MatchesResize) {
+    array in = af::randu(101, 64);
+    array levels[4];
+    pyramid(levels, in, 4, 2.f);
+
+    ASSERT_ARRAYS_EQ(in, levels[0]);
+    array prev = in;
+    for (int i = 1; i < 4; i++) {
+        const float scl = float(1 << i);
+        array gold      = resize(prev, dim_t(round(101 / scl)),
+                                 dim_t(round(64 / scl)), AF_INTERP_BILINEAR);
+        ASSERT_ARRAYS_NEAR(gold, levels[i], 1e-6);
+        prev = levels[i];
+    }
+}
+
+TEST(Pyramid, InvalidArgs) {
+    array in = af::randu(16, 16);
+    af_array levels[8];
+    ASSERT_EQ(AF_ERR_ARG, af_pyramid(levels, in.get(), 0, 2.f, 0.f));
+    ASSERT_EQ(AF_ERR_ARG, af_pyramid(levels, in.get(), 2, 1.f, 0.f));
+    ASSERT_EQ(AF_ERR_ARG, af_pyramid(levels, in.get(), 8, 2.f, 0.f));
+}
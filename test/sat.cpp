@@ -49,3 +49,21 @@ TYPED_TEST(SAT, IntegralImage) {
 
     EXPECT_EQ(true, allTrue<float>(c == s));
 }
+
+TEST(SAT, BatchedNonMultipleOfTile) {
+    array a = randu(67, 45, 3, 2, s32) % 100;
+    array c = accum(accum(a, 0), 1);
+
+    array s = sat(a);
+
+    ASSERT_EQ(c.dims(), s.dims());
+    EXPECT_EQ(true, allTrue<bool>(c == s));
+}
+
+TEST(SAT, SubArray) {
+    array a = randu(100, 80, f32);
+    array b = a(af::seq(3, 70), af::seq(5, 77));
+    array c = accum(accum(b, 0), 1);
+
+    ASSERT_ARRAYS_NEAR(c, sat(b), 1e-2);
+}
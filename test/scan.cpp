@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
@@ -345,3 +346,33 @@ TEST(Scan, ExclusiveSum2D_Dim3) {
 
     ASSERT_ARRAYS_EQ(gold, out);
 }
+
+// Lines which span many blocks, with a partial last block, are scanned with
+// the results of the previous blocks of the same line only
+TEST(Scan, LongLinesMinMax) {
+    const int nx = 100003;
+    const int ny = 3;
+    vector<int> h_in(nx * ny);
+    for (size_t i = 0; i < h_in.size(); ++i) {
+        h_in[i] = static_cast<int>((i * 7919) % 100003) - 50000;
+    }
+    array in(nx, ny, &h_in.front());
+
+    vector<int> h_max(nx * ny), h_min(nx * ny);
+    for (int y = 0; y < ny; ++y) {
+        int runMax = std::numeric_limits<int>::lowest();
+        int runMin = std::numeric_limits<int>::max();
+        for (int x = 0; x < nx; ++x) {
+            const int i = y * nx + x;
+            h_min[i]    = runMin;
+            runMax      = std::max(runMax, h_in[i]);
+            runMin      = std::min(runMin, h_in[i]);
+            h_max[i]    = runMax;
+        }
+    }
+
+    ASSERT_VEC_ARRAY_EQ(h_max, dim4(nx, ny),
+                        scan(in, 0, AF_BINARY_MAX, true));
+    ASSERT_VEC_ARRAY_EQ(h_min, dim4(nx, ny),
+                        scan(in, 0, AF_BINARY_MIN, false));
+}
@@ -236,3 +236,15 @@ TEST(ScanByKey, FixOverflowWrite) {
 
     ASSERT_EQ(prior, valsAF(0).scalar<float>());
 }
+
+TEST(ScanSegmented, Add) {
+    const int h_in[]      = {1, 2, 3, 4, 5, 6, 7};
+    const int h_offsets[] = {0, 2, 2, 7};
+    array in(7, h_in);
+    array offsets(4, h_offsets);
+
+    ASSERT_VEC_ARRAY_EQ(vector<int>({1, 3, 3, 7, 12, 18, 25}), dim4(7),
+                        af::scanSegmented(in, offsets));
+    ASSERT_VEC_ARRAY_EQ(vector<int>({0, 1, 0, 3, 7, 12, 18}), dim4(7),
+                        af::scanSegmented(in, offsets, AF_BINARY_ADD, false));
+}
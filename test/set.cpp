@@ -13,7 +13,9 @@
 #include <af/algorithm.h>
 #include <af/dim4.hpp>
 #include <af/traits.hpp>
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <vector>
 
@@ -299,3 +301,38 @@ TEST(Set, SNIPPET_setIntersectSimple) {
     dim4 gold_dim(1, 1, 1, 1);
     ASSERT_VEC_ARRAY_EQ(intersect_gold, gold_dim, setA_B);
 }
+
+TEST(Set, LargeWithDuplicates) {
+    const int n = 1 << 16;
+    vector<int> h_a(n), h_b(n);
+    for (int i = 0; i < n; ++i) {
+        h_a[i] = (i * 7919) % 5003;
+        h_b[i] = 2500 + (i * 104729) % 7001;
+    }
+    af::array a(n, h_a.data());
+    af::array b(n, h_b.data());
+
+    vector<int> sa = h_a, sb = h_b;
+    std::sort(sa.begin(), sa.end());
+    std::sort(sb.begin(), sb.end());
+    sa.erase(std::unique(sa.begin(), sa.end()), sa.end());
+    sb.erase(std::unique(sb.begin(), sb.end()), sb.end());
+
+    vector<int> union_gold, intersect_gold;
+    std::set_union(sa.begin(), sa.end(), sb.begin(), sb.end(),
+                   std::back_inserter(union_gold));
+    std::set_intersection(sa.begin(), sa.end(), sb.begin(), sb.end(),
+                          std::back_inserter(intersect_gold));
+
+    ASSERT_VEC_ARRAY_EQ(sa, dim4(sa.size()), setUnique(a));
+    ASSERT_VEC_ARRAY_EQ(union_gold, dim4(union_gold.size()), setUnion(a, b));
+    ASSERT_VEC_ARRAY_EQ(intersect_gold, dim4(intersect_gold.size()),
+                        setIntersect(a, b));
+
+    af::array ua = af::array(sa.size(), sa.data());
+    af::array ub = af::array(sb.size(), sb.data());
+    ASSERT_VEC_ARRAY_EQ(union_gold, dim4(union_gold.size()),
+                        setUnion(ua, ub, true));
+    ASSERT_VEC_ARRAY_EQ(intersect_gold, dim4(intersect_gold.size()),
+                        setIntersect(ua, ub, true));
+}
@@ -0,0 +1,116 @@
+/*******************************************************
+ * Copyright (c) 2020, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <gtest/gtest.h>
+#include <testHelpers.hpp>
+#include <af/sharded.h>
+
+#include <vector>
+
+using af::array;
+using af::deviceGC;
+using af::dim4;
+using af::getDevice;
+using af::getDeviceCount;
+using af::getDeviceId;
+using af::randu;
+using af::setDevice;
+using af::shardedArray;
+using std::vector;
+
+namespace {
+array scale(const array &x) { return 2 * x + 1; }
+
+array multiply(const array &lhs, const array &rhs) { return lhs * rhs; }
+}  // namespace
+
+TEST(Sharded, LastDimension) {
+    array a        = randu(10, 7);
+    int device     = getDevice();
+    int devices[3] = {device, device, device};
+    shardedArray s(a, 3, devices);
+
+    ASSERT_EQ(3u, s.numShards());
+    ASSERT_EQ(1, s.shardDim());
+    ASSERT_EQ(a.dims(), s.dims());
+    ASSERT_EQ(dim4(10, 3), s.shard(0).dims());
+    ASSERT_ARRAYS_EQ(a, s.gather());
+}
+
+TEST(Sharded, Vector) {
+    array a        = randu(100);
+    int device     = getDevice();
+    int devices[2] = {device, device};
+    shardedArray s(a, 2, devices);
+
+    ASSERT_EQ(0, s.shardDim());
+    ASSERT_EQ(dim4(50), s.shard(1).dims());
+}
+
+TEST(Sharded, Map) {
+    array a        = randu(20, 9);
+    array b        = randu(20, 9);
+    int device     = getDevice();
+    int devices[3] = {device, device, device};
+    shardedArray sa(a, 3, devices);
+    shardedArray sb(b, 3, devices);
+
+    shardedArray sc = shardedArray::map(sa.map(scale), sb, multiply);
+    ASSERT_ARRAYS_NEAR((2 * a + 1) * b, sc.gather(), 1e-6);
+}
+
+TEST(Sharded, Reduce) {
+    array a        = af::range(dim4(10, 10), 1, s32);
+    int device     = getDevice();
+    int devices[4] = {device, device, device, device};
+    shardedArray s(a, 4, devices);
+
+    ASSERT_EQ(af::sum<int>(a), s.reduce().scalar<int>());
+    ASSERT_EQ(af::max<int>(a), s.reduce(AF_BINARY_MAX).scalar<int>());
+    ASSERT_EQ(af::min<int>(a), s.reduce(AF_BINARY_MIN).scalar<int>());
+}
+
+TEST(Sharded, MismatchedShards) {
+    int device     = getDevice();
+    int devices[2] = {device, device};
+    shardedArray sa(randu(10, 4), 2, devices);
+    shardedArray sb(randu(10, 6), 2, devices);
+
+    ASSERT_THROW(shardedArray::map(sa, sb, multiply), af::exception);
+}
+
+TEST(Sharded, Devices) {
+    int ndevices = getDeviceCount();
+    if (ndevices < 2) return;
+    int id0 = getDevice();
+
+    {
+        vector<int> devices(ndevices);
+        for (int i = 0; i < ndevices; ++i) { devices[i] = i; }
+
+        array a = randu(100, 10 * ndevices);
+        shardedArray s(a, ndevices, devices.data());
+        for (int i = 0; i < ndevices; ++i) {
+            ASSERT_EQ(i, getDeviceId(s.shard(i)));
+        }
+
+        shardedArray t = s.map(scale);
+        ASSERT_EQ(id0, getDevice());
+        ASSERT_ARRAYS_NEAR(2 * a + 1, t.gather(), 1e-6);
+        ASSERT_NEAR(af::sum<float>(2 * a + 1), t.reduce().scalar<float>(),
+                    1e-2);
+    }
+
+    for (int i = 0; i < ndevices; ++i) {
+        setDevice(i);
+        deviceGC();
+    }
+    setDevice(id0);
+}
@@ -30,7 +30,7 @@ using std::vector;
 
 template<typename T>
 void solveTester(const int m, const int n, const int k, double eps,
-                 int targetDevice = -1) {
+                 int targetDevice = -1, const int batch = 1) {
     if (targetDevice >= 0) af::setDevice(targetDevice);
 
     af::deviceGC();
@@ -39,8 +39,8 @@ void solveTester(const int m, const int n, const int k, double eps,
     if (noLAPACKTests()) return;
 
 #if 1
-    af::array A  = cpu_randu<T>(af::dim4(m, n));
-    af::array X0 = cpu_randu<T>(af::dim4(n, k));
+    af::array A  = cpu_randu<T>(af::dim4(m, n, batch));
+    af::array X0 = cpu_randu<T>(af::dim4(n, k, batch));
 #else
     af::array A  = af::randu(m, n, (af::dtype)af::dtype_traits<T>::af_type);
     af::array X0 = af::randu(n, k, (af::dtype)af::dtype_traits<T>::af_type);
@@ -58,18 +58,18 @@ void solveTester(const int m, const int n, const int k, double eps,
     ASSERT_NEAR(0,
                 af::sum<typename af::dtype_traits<T>::base_type>(
                     af::abs(real(B0 - B1))) /
-                    (m * k),
+                    (m * k * batch),
                 eps);
     ASSERT_NEAR(0,
                 af::sum<typename af::dtype_traits<T>::base_type>(
                     af::abs(imag(B0 - B1))) /
-                    (m * k),
+                    (m * k * batch),
                 eps);
 }
 
 template<typename T>
 void solveLUTester(const int n, const int k, double eps,
-                   int targetDevice = -1) {
+                   int targetDevice = -1, const int batch = 1) {
     if (targetDevice >= 0) af::setDevice(targetDevice);
 
     af::deviceGC();
@@ -78,8 +78,8 @@ void solveLUTester(const int n, const int k, double eps,
     if (noLAPACKTests()) return;
 
 #if 1
-    af::array A  = cpu_randu<T>(af::dim4(n, n));
-    af::array X0 = cpu_randu<T>(af::dim4(n, k));
+    af::array A  = cpu_randu<T>(af::dim4(n, n, batch));
+    af::array X0 = cpu_randu<T>(af::dim4(n, k, batch));
 #else
     af::array A  = af::randu(n, n, (af::dtype)af::dtype_traits<T>::af_type);
     af::array X0 = af::randu(n, k, (af::dtype)af::dtype_traits<T>::af_type);
@@ -97,18 +97,18 @@ void solveLUTester(const int n, const int k, double eps,
     ASSERT_NEAR(0,
                 af::sum<typename af::dtype_traits<T>::base_type>(
                     af::abs(real(B0 - B1))) /
-                    (n * k),
+                    (n * k * batch),
                 eps);
     ASSERT_NEAR(0,
                 af::sum<typename af::dtype_traits<T>::base_type>(
                     af::abs(imag(B0 - B1))) /
-                    (n * k),
+                    (n * k * batch),
                 eps);
 }
 
 template<typename T>
 void solveTriangleTester(const int n, const int k, bool is_upper, double eps,
-                         int targetDevice = -1) {
+                         int targetDevice = -1, const int batch = 1) {
     if (targetDevice >= 0) af::setDevice(targetDevice);
 
     af::deviceGC();
@@ -117,8 +117,8 @@ void solveTriangleTester(const int n, const int k, bool is_upper, double eps,
     if (noLAPACKTests()) return;
 
 #if 1
-    af::array A  = cpu_randu<T>(af::dim4(n, n));
-    af::array X0 = cpu_randu<T>(af::dim4(n, k));
+    af::array A  = cpu_randu<T>(af::dim4(n, n, batch));
+    af::array X0 = cpu_randu<T>(af::dim4(n, k, batch));
 #else
     af::array A  = af::randu(n, n, (af::dtype)af::dtype_traits<T>::af_type);
     af::array X0 = af::randu(n, k, (af::dtype)af::dtype_traits<T>::af_type);
@@ -150,11 +150,11 @@ void solveTriangleTester(const int n, const int k, bool is_upper, double eps,
     ASSERT_NEAR(0,
                 af::sum<typename af::dtype_traits<T>::base_type>(
                     af::abs(real(B0 - B1))) /
-                    (n * k),
+                    (n * k * batch),
                 eps);
     ASSERT_NEAR(0,
                 af::sum<typename af::dtype_traits<T>::base_type>(
                     af::abs(imag(B0 - B1))) /
-                    (n * k),
+                    (n * k * batch),
                 eps);
 }
@@ -139,6 +139,42 @@ TYPED_TEST(Solve, TriangleLowerMultipleOfTwoLarge) {
     solveTriangleTester<TypeParam>(2048, 512, false, eps<TypeParam>());
 }
 
+TYPED_TEST(Solve, SquareBatched) {
+    solveTester<TypeParam>(8, 8, 4, eps<TypeParam>(), -1, 64);
+}
+
+TYPED_TEST(Solve, SquareBatchedLarge) {
+    solveTester<TypeParam>(40, 40, 4, eps<TypeParam>(), -1, 6);
+}
+
+TYPED_TEST(Solve, LUBatched) {
+    solveLUTester<TypeParam>(8, 4, eps<TypeParam>(), -1, 64);
+}
+
+TYPED_TEST(Solve, LUBatchedLarge) {
+    solveLUTester<TypeParam>(40, 4, eps<TypeParam>(), -1, 6);
+}
+
+TYPED_TEST(Solve, TriangleUpperBatched) {
+    solveTriangleTester<TypeParam>(8, 4, true, eps<TypeParam>(), -1, 64);
+}
+
+TYPED_TEST(Solve, TriangleLowerBatched) {
+    solveTriangleTester<TypeParam>(8, 4, false, eps<TypeParam>(), -1, 64);
+}
+
+TEST(Solve, BatchedLeastSquares) {
+    if (noLAPACKTests()) return;
+    af_array a = 0, b = 0, out = 0;
+    dim_t adims[] = {6, 4, 2};
+    dim_t bdims[] = {6, 3, 2};
+    ASSERT_SUCCESS(af_randu(&a, 3, adims, f32));
+    ASSERT_SUCCESS(af_randu(&b, 3, bdims, f32));
+    ASSERT_EQ(AF_ERR_BATCH, af_solve(&out, a, b, AF_MAT_NONE));
+    ASSERT_SUCCESS(af_release_array(a));
+    ASSERT_SUCCESS(af_release_array(b));
+}
+
 #if !defined(AF_OPENCL)
 int nextTargetDeviceId() {
     static int nextId = 0;
@@ -13,7 +13,9 @@
 #include <af/defines.h>
 #include <af/dim4.hpp>
 #include <af/traits.hpp>
+#include <algorithm>
 #include <complex>
+#include <functional>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -226,3 +228,35 @@ TEST(Sort, CPPDim2) {
     // Delete
     delete[] sxData;
 }
+
+namespace {
+void checkColumnSort(const dim4 &dims, const bool isAscending) {
+    array in  = af::randu(dims, s32);
+    array out = sort(in, 0, isAscending);
+
+    vector<int> gold(in.elements());
+    in.host(&gold.front());
+    const size_t n = dims[0];
+    for (size_t col = 0; col < gold.size() / n; ++col) {
+        auto begin = gold.begin() + col * n;
+        if (isAscending) {
+            std::sort(begin, begin + n);
+        } else {
+            std::sort(begin, begin + n, std::greater<int>());
+        }
+    }
+    ASSERT_VEC_ARRAY_EQ(gold, dims, out);
+}
+}  // namespace
+
+TEST(Sort, BatchedShortColumns) {
+    checkColumnSort(dim4(100, 37, 3), true);
+    checkColumnSort(dim4(100, 37, 3), false);
+    checkColumnSort(dim4(1, 1000), true);
+    checkColumnSort(dim4(4096, 20), false);
+}
+
+TEST(Sort, BatchedMediumColumns) {
+    checkColumnSort(dim4(5000, 12), true);
+    checkColumnSort(dim4(5000, 12), false);
+}
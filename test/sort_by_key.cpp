@@ -196,3 +196,32 @@ TEST(SortByKey, CPPDim2) {
     ASSERT_VEC_ARRAY_EQ(tests[resultIdx0], idims, out_keys);
     ASSERT_VEC_ARRAY_EQ(tests[resultIdx1], idims, out_vals);
 }
+
+TEST(SortSegmented, Values) {
+    const float h_in[]    = {3, 1, 2, 5, 4, 9, 7, 8, 6, 0};
+    const int h_offsets[] = {0, 3, 3, 5};
+    array in(dim4(5, 2), h_in);
+    array offsets(4, h_offsets);
+
+    ASSERT_VEC_ARRAY_EQ(vector<float>({1, 2, 3, 4, 5, 7, 8, 9, 0, 6}),
+                        dim4(5, 2), sortSegmented(in, offsets));
+    ASSERT_VEC_ARRAY_EQ(vector<float>({3, 2, 1, 5, 4, 9, 8, 7, 6, 0}),
+                        dim4(5, 2), sortSegmented(in, offsets, false));
+}
+
+TEST(SortSegmented, ByKey) {
+    const float h_keys[]  = {3, 1, 2, 0, 5, 4, 6};
+    const int h_vals[]    = {0, 1, 2, 3, 4, 5, 6};
+    const int h_offsets[] = {0, 4, 7};
+    array keys(7, h_keys);
+    array vals(7, h_vals);
+    array offsets(3, h_offsets);
+
+    array out_keys, out_vals;
+    sortByKeySegmented(out_keys, out_vals, keys, vals, offsets);
+
+    ASSERT_VEC_ARRAY_EQ(vector<float>({0, 1, 2, 3, 4, 5, 6}), dim4(7),
+                        out_keys);
+    ASSERT_VEC_ARRAY_EQ(vector<int>({3, 1, 2, 0, 5, 4, 6}), dim4(7),
+                        out_vals);
+}
@@ -13,10 +13,13 @@
 
 using af::allTrue;
 using af::array;
+using af::constant;
 using af::deviceMemInfo;
+using af::diag;
 using af::dim4;
 using af::dtype_traits;
 using af::identity;
+using af::matProp;
 using af::randu;
 using af::span;
 
@@ -416,3 +419,245 @@ TEST(Sparse, CPPDenseToSparseToDenseUsage) {
     ASSERT_ARRAYS_EQ(in, gold);
     ASSERT_ARRAYS_EQ(dense, gold);
 }
+
+TEST(Sparse, DenseConversions) {
+    // More rows than the threads of a column and empty rows and columns
+    const int M              = 600;
+    const int N              = 300;
+    array A                  = makeSparse<float>(randu(M, N), 7);
+    A(af::seq(10, 20), span) = 0;
+    A(span, af::seq(30, 40)) = 0;
+
+    array csr = sparse(A, AF_STORAGE_CSR);
+    ASSERT_EQ(af::count<int>(A), sparseGetNNZ(csr));
+    ASSERT_ARRAYS_EQ(A, dense(csr));
+
+    // COO arrays are sorted by column
+    array coo = sparse(A, AF_STORAGE_COO);
+    array idx = where(A).as(s32);
+    ASSERT_ARRAYS_EQ(idx % M, sparseGetRowIdx(coo));
+    ASSERT_ARRAYS_EQ(idx / M, sparseGetColIdx(coo));
+    ASSERT_ARRAYS_EQ(A(idx), sparseGetValues(coo));
+
+    array zeros = sparse(af::constant(0, M, N), AF_STORAGE_CSR);
+    ASSERT_EQ(0, sparseGetNNZ(zeros));
+    ASSERT_ARRAYS_EQ(af::constant(0, M, N), dense(zeros));
+}
+
+TEST(Sparse, RepeatedMatmul) {
+    // The products of the same sparse array reuse its cached descriptors and
+    // workspace, whichever operation and shape comes first
+    array A  = makeSparse<float>(randu(200, 150), 5);
+    array sA = sparse(A);
+
+    for (int i = 0; i < 3; i++) {
+        array x = randu(150);
+        array y = randu(200);
+        array X = randu(150, 4);
+        ASSERT_ARRAYS_NEAR(matmul(A, x), matmul(sA, x), 1e-3);
+        ASSERT_ARRAYS_NEAR(matmul(A, y, AF_MAT_TRANS),
+                           matmul(sA, y, AF_MAT_TRANS), 1e-3);
+        ASSERT_ARRAYS_NEAR(matmul(A, X), matmul(sA, X), 1e-3);
+    }
+
+    // A sparse array with new values does not use the cache of sA
+    array sB = sparse(2 * A);
+    array x  = randu(150);
+    ASSERT_ARRAYS_NEAR(matmul(2 * A, x), matmul(sB, x), 1e-3);
+    ASSERT_ARRAYS_NEAR(matmul(A, x), matmul(sA, x), 1e-3);
+}
+
+TEST(Sparse, LargeMatmul) {
+    // Large enough to be split across threads. The dense rows are shared by
+    // several threads.
+    array A                    = makeSparse<cfloat>(randu(1500, 1200, c32), 5);
+    A(7, span)                 = randu(1, 1200, c32);
+    A(af::seq(900, 903), span) = randu(4, 1200, c32);
+    array sA                   = sparse(A);
+
+    array x = randu(1200, c32);
+    array X = randu(1200, 3, c32);
+    array y = randu(1500, c32);
+    array Y = randu(1500, 3, c32);
+    ASSERT_ARRAYS_NEAR(matmul(A, x), matmul(sA, x), 1e-2);
+    ASSERT_ARRAYS_NEAR(matmul(A, X), matmul(sA, X), 1e-2);
+    ASSERT_ARRAYS_NEAR(matmul(A, y, AF_MAT_TRANS),
+                       matmul(sA, y, AF_MAT_TRANS), 1e-2);
+    ASSERT_ARRAYS_NEAR(matmul(A, Y, AF_MAT_CTRANS),
+                       matmul(sA, Y, AF_MAT_CTRANS), 1e-2);
+}
+
+TEST(Sparse, SparseSparseMatmul) {
+    array A  = makeSparse<float>(randu(120, 90), 5);
+    array B  = makeSparse<float>(randu(90, 70), 5);
+    array sA = sparse(A);
+    array sB = sparse(B);
+
+    array sC = matmul(sA, sB);
+    ASSERT_TRUE(sC.issparse());
+    ASSERT_EQ(AF_STORAGE_CSR, sparseGetStorage(sC));
+    ASSERT_ARRAYS_NEAR(matmul(A, B), dense(sC), 1e-3);
+
+    // The second product only computes the values of the cached pattern
+    ASSERT_ARRAYS_NEAR(matmul(A, B), dense(matmul(sA, sB)), 1e-3);
+
+    // New values in the indices of sB
+    array values = randu(sparseGetNNZ(sB));
+    array sB2    = sparse(90, 70, values, sparseGetRowIdx(sB),
+                          sparseGetColIdx(sB));
+    ASSERT_ARRAYS_NEAR(matmul(A, dense(sB2)), dense(matmul(sA, sB2)), 1e-3);
+
+    // A new pattern
+    array C  = makeSparse<float>(randu(90, 40), 3);
+    array sD = matmul(sA, sparse(C));
+    ASSERT_ARRAYS_NEAR(matmul(A, C), dense(sD), 1e-3);
+}
+
+TEST(Sparse, BlockedMatmul) {
+    // The dimensions are not multiples of the block or slice sizes
+    array A  = makeSparse<float>(randu(101, 67), 5);
+    array x  = randu(67);
+    array B  = randu(67, 9);
+    array sA = sparse(A);
+
+    array bsr = sparseConvertTo(sA, AF_STORAGE_BSR, 3);
+    ASSERT_EQ(AF_STORAGE_BSR, sparseGetStorage(bsr));
+    ASSERT_ARRAYS_EQ(A, dense(bsr));
+    ASSERT_ARRAYS_NEAR(matmul(A, x), matmul(bsr, x), 1e-3);
+    ASSERT_ARRAYS_NEAR(matmul(A, B), matmul(bsr, B), 1e-3);
+
+    array sell = sparseConvertTo(sA, AF_STORAGE_SELL, 4, 8);
+    ASSERT_EQ(AF_STORAGE_SELL, sparseGetStorage(sell));
+    ASSERT_EQ(sparseGetNNZ(sA), sparseGetNNZ(sell) -
+                                    af::sum<int>(sparseGetColIdx(sell) < 0));
+    ASSERT_ARRAYS_EQ(A, dense(sell));
+    ASSERT_ARRAYS_NEAR(matmul(A, x), matmul(sell, x), 1e-3);
+    ASSERT_ARRAYS_NEAR(matmul(A, B), matmul(sell, B), 1e-3);
+
+    array csr = sparseConvertTo(sell, AF_STORAGE_CSR);
+    ASSERT_EQ(sparseGetNNZ(sA), sparseGetNNZ(csr));
+    ASSERT_ARRAYS_EQ(A, dense(csr));
+
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_NOT_SUPPORTED,
+              af_matmul(&out, bsr.get(), B.get(), AF_MAT_TRANS, AF_MAT_NONE));
+}
+
+TEST(Sparse, CooCscMatmul) {
+    // The COO and CSC arrays are multiplied in their own format. The nonzeros
+    // of the COO array are reversed, so they are not sorted by row.
+    const int M = 130;
+    const int K = 90;
+    array A     = makeSparse<cfloat>(randu(M, K, c32), 5);
+
+    array coo     = sparse(A, AF_STORAGE_COO);
+    const int nnz = sparseGetNNZ(coo);
+    af::seq reversed(nnz - 1, 0, -1);
+    array sCoo = sparse(M, K, sparseGetValues(coo)(reversed),
+                        sparseGetRowIdx(coo)(reversed),
+                        sparseGetColIdx(coo)(reversed), AF_STORAGE_COO);
+
+    // The CSR arrays of the transpose are the CSC arrays of A
+    array csrT = sparse(transpose(A));
+    array sCsc = sparse(M, K, sparseGetValues(csrT), sparseGetColIdx(csrT),
+                        sparseGetRowIdx(csrT), AF_STORAGE_CSC);
+
+    array x = randu(K, c32);
+    array X = randu(K, 4, c32);
+    array y = randu(M, c32);
+    array Y = randu(M, 3, c32);
+    for (const array &sA : {sCoo, sCsc}) {
+        ASSERT_ARRAYS_NEAR(matmul(A, x), matmul(sA, x), 1e-2);
+        ASSERT_ARRAYS_NEAR(matmul(A, X), matmul(sA, X), 1e-2);
+        ASSERT_ARRAYS_NEAR(matmul(A, y, AF_MAT_TRANS),
+                           matmul(sA, y, AF_MAT_TRANS), 1e-2);
+        ASSERT_ARRAYS_NEAR(matmul(A, y, AF_MAT_CTRANS),
+                           matmul(sA, y, AF_MAT_CTRANS), 1e-2);
+        ASSERT_ARRAYS_NEAR(matmul(A, Y, AF_MAT_CTRANS),
+                           matmul(sA, Y, AF_MAT_CTRANS), 1e-2);
+    }
+}
+
+TEST(Sparse, UpdateValuesAndEntries) {
+    array A        = makeSparse<float>(randu(80, 60), 5);
+    A(40, span)    = 0;
+    array sA       = sparse(A);
+    array x        = randu(60);
+    const dim_t nz = sparseGetNNZ(sA);
+    ASSERT_ARRAYS_NEAR(matmul(A, x), matmul(sA, x), 1e-3);
+
+    // New values in the pattern of sA after a product
+    array values = randu(nz);
+    sparseSetValues(sA, values);
+    ASSERT_ARRAYS_EQ(values, sparseGetValues(sA));
+    ASSERT_ARRAYS_NEAR(matmul(dense(sA), x), matmul(sA, x), 1e-3);
+
+    // The values of another handle of the array do not change
+    array other = sA;
+    sparseSetValues(sA, 2 * values);
+    ASSERT_ARRAYS_EQ(values, sparseGetValues(other));
+    ASSERT_ARRAYS_NEAR(matmul(dense(sA), x), matmul(sA, x), 1e-3);
+
+    // Entries in and out of the pattern, and a repeated entry
+    array D      = dense(sA);
+    int rows[]   = {0, 5, 5, 79, 0};
+    int cols[]   = {0, 7, 7, 59, 0};
+    float vals[] = {1, 2, 3, 4, 5};
+    sparseInsert(sA, array(5, vals), array(5, rows), array(5, cols));
+    D(0, 0)   = 5;
+    D(5, 7)   = 3;
+    D(79, 59) = 4;
+    ASSERT_ARRAYS_EQ(D, dense(sA));
+    ASSERT_ARRAYS_NEAR(matmul(D, x), matmul(sA, x), 1e-3);
+    ASSERT_EQ(af::count<int>(D), sparseGetNNZ(sA));
+
+    // The entry of the empty row is not in the array
+    int removeRows[] = {5, 79, 40};
+    int removeCols[] = {7, 59, 3};
+    sparseRemove(sA, array(3, removeRows), array(3, removeCols));
+    D(5, 7)   = 0;
+    D(79, 59) = 0;
+    ASSERT_ARRAYS_EQ(D, dense(sA));
+    ASSERT_ARRAYS_NEAR(matmul(D, x), matmul(sA, x), 1e-3);
+    ASSERT_EQ(af::count<int>(D), sparseGetNNZ(sA));
+
+    af_array arr = sA.get();
+    ASSERT_EQ(AF_ERR_SIZE, af_sparse_set_values(arr, values.get()));
+}
+
+TEST(Sparse, TriangularSolveAndILU) {
+    const int n = 60;
+    array A     = makeSparse<float>(randu(n, n), 5) + n * identity(n, n);
+    array sA    = sparse(A);
+    array b     = randu(n, 3);
+
+    const matProp lowerUnit = matProp(AF_MAT_LOWER | AF_MAT_DIAG_UNIT);
+    ASSERT_ARRAYS_NEAR(solve(lower(A), b, AF_MAT_LOWER),
+                       solve(sA, b, AF_MAT_LOWER), 1e-3);
+    ASSERT_ARRAYS_NEAR(solve(upper(A), b, AF_MAT_UPPER),
+                       solve(sA, b, AF_MAT_UPPER), 1e-3);
+    ASSERT_ARRAYS_NEAR(solve(lower(A, true), b, AF_MAT_LOWER),
+                       solve(sA, b, lowerUnit), 1e-3);
+
+    // The analysis is kept with the array across new values
+    sparseSetValues(sA, 2 * sparseGetValues(sA));
+    ASSERT_ARRAYS_NEAR(solve(lower(2 * A), b, AF_MAT_LOWER),
+                       solve(sA, b, AF_MAT_LOWER), 1e-3);
+
+    // The incomplete factorizations of a tridiagonal matrix are exact
+    array T  = diag(constant(4, n), 0, false) +
+              diag(constant(-1, n - 1), 1, false) +
+              diag(constant(-1, n - 1), -1, false);
+    array sT = sparse(T);
+    array x  = solve(T, b);
+
+    array lu = sparseILU0(sT);
+    ASSERT_ARRAYS_NEAR(
+        x, solve(lu, solve(lu, b, lowerUnit), AF_MAT_UPPER), 1e-3);
+
+    array ic = sparseIC0(sT);
+    ASSERT_ARRAYS_NEAR(
+        x, solve(ic, solve(ic, b, AF_MAT_LOWER), AF_MAT_UPPER), 1e-3);
+
+    ASSERT_THROW(solve(sA, b), af::exception);
+}
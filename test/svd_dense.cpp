@@ -166,3 +166,70 @@ TEST(svd, InPlaceRect0_Exception) {
     array u, s, v;
     EXPECT_THROW(svdInPlace(u, s, v, in), af::exception);
 }
+
+template<typename T>
+void svdBatchedTest(const int M, const int N, const int P) {
+    SUPPORTED_TYPE_CHECK(T);
+    if (noLAPACKTests()) return;
+
+    dtype ty = (dtype)dtype_traits<T>::af_type;
+
+    array A = randu(M, N, P, ty);
+
+    array U, S, Vt;
+    af::svd(U, S, Vt, A);
+
+    ASSERT_EQ(dim4(std::min(M, N), 1, P), S.dims());
+    ASSERT_EQ(dim4(M, M, P), U.dims());
+    ASSERT_EQ(dim4(N, N, P), Vt.dims());
+
+    const int MN = std::min(M, N);
+    for (int i = 0; i < P; ++i) {
+        array UU = U(span, seq(MN), i);
+        array SS = diag(S(span, 0, i), 0, false).as(ty);
+        array VV = Vt(seq(MN), span, i);
+
+        ASSERT_ARRAYS_NEAR(A(span, span, i), matmul(UU, SS, VV), 1E-3);
+    }
+}
+
+TYPED_TEST(svd, BatchedSmall) { svdBatchedTest<TypeParam>(8, 6, 5); }
+
+TYPED_TEST(svd, BatchedSmallWide) { svdBatchedTest<TypeParam>(6, 8, 5); }
+
+TYPED_TEST(svd, BatchedLarge) { svdBatchedTest<TypeParam>(40, 36, 3); }
+
+template<typename T>
+void svdRandomizedTest(const int M, const int N, const int rank) {
+    SUPPORTED_TYPE_CHECK(T);
+    if (noLAPACKTests()) return;
+
+    dtype ty = (dtype)dtype_traits<T>::af_type;
+
+    // A matrix of the given rank is recovered up to the rounding errors
+    array A = matmul(randu(M, rank, ty), randu(rank, N, ty));
+
+    array U, S, Vt;
+    af::svdRandomized(U, S, Vt, A, rank);
+
+    ASSERT_EQ(dim4(rank), S.dims());
+    ASSERT_EQ(dim4(M, rank), U.dims());
+    ASSERT_EQ(dim4(rank, N), Vt.dims());
+
+    array u, s, vt;
+    af::svd(u, s, vt, A);
+    ASSERT_ARRAYS_NEAR(s(seq(rank)), S, 1E-2);
+
+    array AA = matmul(U, diag(S, 0, false).as(ty), Vt);
+    ASSERT_ARRAYS_NEAR(A, AA, 1E-2);
+}
+
+TYPED_TEST(svd, RandomizedTall) { svdRandomizedTest<TypeParam>(500, 200, 10); }
+
+TYPED_TEST(svd, RandomizedWide) { svdRandomizedTest<TypeParam>(200, 500, 10); }
+
+TEST(svd, RandomizedZeroRank) {
+    array in = randu(10, 10);
+    array u, s, v;
+    EXPECT_THROW(af::svdRandomized(u, s, v, in, 0), af::exception);
+}
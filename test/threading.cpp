@@ -12,6 +12,9 @@
 #include <sparse_common.hpp>
 #include <testHelpers.hpp>
 #include <af/traits.hpp>
+#if defined(AF_CPU)
+#include <af/cpu.h>
+#endif
 #include <chrono>
 #include <complex>
 #include <condition_variable>
@@ -713,6 +716,54 @@ TEST(Threading, Sparse) {
         if (tests[testId].joinable()) tests[testId].join();
 }
 
+#if defined(AF_CPU)
+TEST(Threading, CPUQueueSmallTasks) {
+    // The small tasks of all the threads are merged into the batches of the
+    // queue of the device
+    vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; ++t) {
+        threads.emplace_back([t] {
+            setDevice(0);
+            array x = constant(t, 64);
+            for (int i = 0; i < 200; ++i) {
+                x = x + 1;
+                x.eval();
+            }
+            vector<float> out(x.elements());
+            x.host(out.data());
+            for (float v : out) { ASSERT_EQ(t + 200, v); }
+        });
+    }
+    for (auto& t : threads) { t.join(); }
+}
+
+TEST(Threading, CPUQueueFlushLimits) {
+    unsigned long long defBytes = 0, defElements = 0;
+    ASSERT_SUCCESS(afcpu_get_queue_flush_limits(&defBytes, &defElements));
+
+    // Small limits flush the queue after every few tasks
+    ASSERT_SUCCESS(afcpu_set_queue_flush_limits(1 << 16, 1 << 14));
+    unsigned long long bytes = 0, elements = 0;
+    ASSERT_SUCCESS(afcpu_get_queue_flush_limits(&bytes, &elements));
+    EXPECT_EQ(1ULL << 16, bytes);
+    EXPECT_EQ(1ULL << 14, elements);
+
+    array x = constant(0, 1 << 12);
+    for (int i = 0; i < 100; ++i) {
+        x = x + 1;
+        x.eval();
+    }
+    vector<float> out(x.elements());
+    x.host(out.data());
+    for (float v : out) { ASSERT_EQ(100, v); }
+
+    ASSERT_SUCCESS(afcpu_set_queue_flush_limits(defBytes, defElements));
+    ASSERT_SUCCESS(afcpu_get_queue_flush_limits(&bytes, &elements));
+    EXPECT_EQ(defBytes, bytes);
+    EXPECT_EQ(defElements, elements);
+}
+#endif
+
 TEST(Threading, DISABLED_MemoryManagerStressTest) {
     vector<std::thread> threads;
     for (int i = 0; i < THREAD_COUNT; i++) {
@@ -239,3 +239,34 @@ TEST(Tile, LargeRepeatDim) {
 
     ASSERT_VEC_ARRAY_EQ(empty, dim4(dim0, 1, largeDim), temp);
 }
+
+TEST(Tile, InExpression) {
+    array v = af::range(dim4(3), 0, s32);
+    array m = af::range(dim4(3, 4), 1, s32);
+
+    array out = tile(v, 1, 4) + m;
+
+    vector<int> gold(12);
+    for (int j = 0; j < 4; j++) {
+        for (int i = 0; i < 3; i++) { gold[j * 3 + i] = i + j; }
+    }
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(3, 4), out);
+}
+
+TEST(Tile, SubArray) {
+    array a = af::range(dim4(4, 4), 0, s32);
+    array b = a(seq(1, 2), seq(1, 2));
+
+    vector<int> hb(4);
+    b.host(hb.data());
+
+    array out = 2 * tile(b, 2, 3);
+
+    vector<int> gold(4 * 6);
+    for (int j = 0; j < 6; j++) {
+        for (int i = 0; i < 4; i++) {
+            gold[j * 4 + i] = 2 * hb[(j % 2) * 2 + (i % 2)];
+        }
+    }
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(4, 6), out);
+}
@@ -270,7 +270,13 @@ INSTANTIATE_TEST_CASE_P(
                       topk_params{10, 100, 5, 0, AF_TOPK_MAX},
                       topk_params{10, 1000, 5, 0, AF_TOPK_MAX},
                       topk_params{10, 10000, 5, 0, AF_TOPK_MAX},
-                      topk_params{1000, 10, 256, 0, AF_TOPK_MAX}),
+                      topk_params{1000, 10, 256, 0, AF_TOPK_MAX},
+                      topk_params{1000000, 1, 100, 0, AF_TOPK_MAX},
+                      topk_params{500000, 2, 100, 0, AF_TOPK_MIN},
+                      topk_params{1000, 10, 257, 0, AF_TOPK_MIN},
+                      topk_params{5000, 20, 4096, 0, AF_TOPK_MAX},
+                      topk_params{100000, 4, 1000, 0, AF_TOPK_MAX},
+                      topk_params{1000000, 1, 10000, 0, AF_TOPK_MIN}),
     [](const ::testing::TestParamInfo<TopKParams::ParamType> info) {
         stringstream ss;
         ss << "d0_" << info.param.d0 << "_d1_" << info.param.d1 << "_k_"
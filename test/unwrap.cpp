@@ -236,3 +236,56 @@ TEST(Unwrap, DocSnippet) {
     array gold_A_padded(dim4(4, 4), gold_hA_padded);
     ASSERT_ARRAYS_EQ(gold_A_padded, A_padded);
 }
+
+TEST(UnwrapReduce, MatchesUnwrap) {
+    // 5 x 4 windows with a stride of 3 x 2 and padding over 3 images
+    array in = af::randu(dim4(23, 17, 3)) - 0.5f;
+
+    const dim_t nx = 1 + (23 + 2 * 2 - 5) / 3;
+    const dim_t ny = 1 + (17 + 2 * 1 - 4) / 2;
+    array cols     = unwrap(in, 5, 4, 3, 2, 2, 1);
+
+    ASSERT_ARRAYS_NEAR(af::moddims(af::sum(cols, 0), nx, ny, 3),
+                       af::unwrapReduce(in, 5, 4, 3, 2, 2, 1), 1e-5);
+    ASSERT_ARRAYS_EQ(af::moddims(af::min(cols, 0), nx, ny, 3),
+                     af::unwrapReduce(in, 5, 4, 3, 2, 2, 1, AF_BINARY_MIN));
+    ASSERT_ARRAYS_EQ(af::moddims(af::max(cols, 0), nx, ny, 3),
+                     af::unwrapReduce(in, 5, 4, 3, 2, 2, 1, AF_BINARY_MAX));
+}
+
+TEST(UnwrapReduce, DocSnippet) {
+    float hA[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    array A(dim4(3, 3), hA);
+
+    // The sums of the columns of the padded unwrap of DocSnippet
+    float gold_hA[] = {1, 5, 11, 28};
+    ASSERT_ARRAYS_EQ(array(dim4(2, 2), gold_hA),
+                     af::unwrapReduce(A, 2, 2, 2, 2, 1, 1));
+
+    // The padding of the first three windows is reduced as a zero
+    float gold_hP[] = {0, 0, 0, 2160};
+    ASSERT_ARRAYS_EQ(array(dim4(2, 2), gold_hP),
+                     af::unwrapReduce(A, 2, 2, 2, 2, 1, 1, AF_BINARY_MUL));
+}
+
+TEST(UnwrapReduce, IntegerInput) {
+    array in = af::round(af::randu(dim4(16, 16)) * 255).as(u8);
+
+    array res = af::unwrapReduce(in, 3, 3, 1, 1);
+    ASSERT_EQ(f32, res.type());
+    ASSERT_ARRAYS_EQ(
+        af::moddims(af::sum(unwrap(in.as(f32), 3, 3, 1, 1), 0), 14, 14),
+        res);
+}
+
+TEST(UnwrapReduce, InvalidArgs) {
+    array in     = af::randu(dim4(8, 8));
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_ARG, af_unwrap_reduce(&out, in.get(), 0, 2, 1, 1, 0, 0,
+                                           AF_BINARY_ADD));
+    ASSERT_EQ(AF_ERR_ARG, af_unwrap_reduce(&out, in.get(), 2, 2, 1, 1, 0, 0,
+                                           static_cast<af_binary_op>(7)));
+    ASSERT_EQ(AF_ERR_TYPE,
+              af_unwrap_reduce(&out, af::randu(8, 8, c32).get(), 2, 2, 1, 1,
+                               0, 0, AF_BINARY_ADD));
+}
@@ -188,3 +188,23 @@ TEST(Var, ISSUE2117) {
 #pragma GCC diagnostic pop
     ASSERT_NEAR(0.0f, sum<float>(myArray), 0.000001);
 }
+
+TEST(Var, LargeOffset) {
+    using af::range;
+    using af::var;
+
+    // The variance of values far from 0 loses no precision in one pass
+    const int n = 1 << 16;
+    array a     = 1000.0f + (range(dim4(n, 4)) % 2).as(f32);
+    array v     = var(a, AF_VARIANCE_POPULATION, 0);
+    vector<float> h(4);
+    v.host(h.data());
+    for (float val : h) { ASSERT_NEAR(0.25f, val, 1e-3); }
+
+    array b  = 1000.0f + (range(dim4(4, n), 1) % 2).as(f32);
+    array vb = var(b, AF_VARIANCE_SAMPLE, 1);
+    vb.host(h.data());
+    for (float val : h) { ASSERT_NEAR(0.25 * n / (n - 1), val, 1e-3); }
+
+    ASSERT_NEAR(0.25, var<float>(a, AF_VARIANCE_POPULATION), 1e-3);
+}
@@ -136,3 +136,23 @@ TEST(Where, ISSUE_1259) {
     array indices = where(a > 2);
     ASSERT_EQ(indices.elements(), 0);
 }
+
+TEST(Compact, MatchesWhere) {
+    array in   = randu(dim4(300, 40, 3));
+    array mask = in > 0.5;
+    array out  = compact(in, mask);
+    array idx  = where(mask);
+    ASSERT_ARRAYS_EQ(in(idx), out);
+}
+
+TEST(Compact, Indexed) {
+    array base = range(dim4(20, 10), 0, s32);
+    array in   = base(af::seq(0, 18, 2), af::span);
+    array mask = in % 4 == 0;
+    ASSERT_ARRAYS_EQ(in(where(mask)), compact(in, mask));
+}
+
+TEST(Compact, NoneSelected) {
+    array in = randu(100, 100);
+    ASSERT_EQ(compact(in, in > 2).elements(), 0);
+}
@@ -84,3 +84,129 @@ TEST(Write, VoidPointer) {
 
     ASSERT_VEC_ARRAY_EQ(gold, dim4(100), a);
 }
+
+TEST(Write, AsyncPageable) {
+    // Larger than a staging buffer so the transfer is split
+    const size_t elements = 5 << 20;
+    vector<float> gold(elements);
+    for (size_t i = 0; i < elements; i++) { gold[i] = i % 1000; }
+
+    array a(elements);
+    af::event e = a.writeAsync(&gold.front(), elements * sizeof(float));
+    e.block();
+
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(elements), a);
+}
+
+TEST(Write, AsyncPinned) {
+    const size_t elements = 1000;
+    float *pinned = static_cast<float *>(af::pinned(elements, f32));
+    for (size_t i = 0; i < elements; i++) { pinned[i] = i; }
+
+    array a(elements);
+    af::event e = a.writeAsync(pinned, elements * sizeof(float));
+    e.block();
+
+    vector<float> gold(pinned, pinned + elements);
+    af::freePinned(pinned);
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(elements), a);
+}
+
+TEST(Write, AsyncDevice) {
+    array a = af::randu(100);
+    array b(100);
+    af::event e = b.writeAsync(a.device<float>(), 100 * sizeof(float),
+                               afDevice);
+    a.unlock();
+    e.block();
+
+    ASSERT_ARRAYS_EQ(a, b);
+}
+
+TEST(Write, HostAsyncPageable) {
+    const size_t elements = 5 << 20;
+    array a = af::range(dim4(elements), 0, s32);
+
+    vector<int> out(elements);
+    af::event e = a.hostAsync(&out.front());
+    e.block();
+
+    for (size_t i = 0; i < elements; i++) {
+        ASSERT_EQ(static_cast<int>(i), out[i]) << "at index " << i;
+    }
+}
+
+TEST(Write, HostAsyncPinned) {
+    array a = af::range(dim4(1000), 0, s32);
+
+    int *pinned = static_cast<int *>(af::pinned(1000, s32));
+    af::event e = a.hostAsync(pinned);
+    e.block();
+
+    vector<int> out(pinned, pinned + 1000);
+    af::freePinned(pinned);
+    for (int i = 0; i < 1000; i++) { ASSERT_EQ(i, out[i]); }
+}
+
+TEST(Write, HostAsyncSubArray) {
+    array a   = af::randu(10, 10);
+    array sub = a(af::seq(2, 5), af::seq(1, 3));
+
+    vector<float> gold(sub.elements());
+    sub.host(&gold.front());
+
+    vector<float> out(sub.elements());
+    af::event e = sub.hostAsync(&out.front());
+    e.block();
+
+    for (size_t i = 0; i < gold.size(); i++) { ASSERT_EQ(gold[i], out[i]); }
+}
+
+namespace {
+void countRelease(void *data, void *user_data) {
+    delete[] static_cast<float *>(data);
+    ++*static_cast<int *>(user_data);
+}
+}  // namespace
+
+TEST(Write, AdoptHostArray) {
+    const dim_t elements = 1000;
+    float *data          = new float[elements];
+    for (dim_t i = 0; i < elements; i++) { data[i] = i; }
+    vector<float> gold(data, data + elements);
+
+    int released = 0;
+    af_array handle = 0;
+    ASSERT_SUCCESS(af_adopt_host_array(&handle, data, 1, &elements, f32,
+                                       countRelease, &released));
+    {
+        array a(handle);
+        array b = a;
+        ASSERT_VEC_ARRAY_EQ(gold, dim4(elements), b);
+    }
+    af::sync();
+    ASSERT_EQ(1, released);
+}
+
+TEST(Write, CreateArrayAsyncRegistered) {
+    const dim_t elements = 1 << 20;
+    vector<int> data(elements);
+    for (dim_t i = 0; i < elements; i++) { data[i] = i; }
+
+    af::registerHostMemory(&data.front(), elements * sizeof(int));
+    af_event written = 0;
+    af_array handle  = 0;
+    ASSERT_SUCCESS(af_create_array_async(&written, &handle, &data.front(), 1,
+                                         &elements, s32));
+    af::event e(written);
+    e.block();
+    af::unregisterHostMemory(&data.front());
+
+    array a(handle);
+    ASSERT_VEC_ARRAY_EQ(data, dim4(elements), a);
+}
+
+TEST(Write, UnregisterUnknownHostMemory) {
+    int value = 0;
+    ASSERT_EQ(AF_ERR_ARG, af_unregister_host_memory(&value));
+}
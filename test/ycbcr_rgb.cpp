@@ -155,3 +155,12 @@ TEST(rgb2ycbcr, MaxDim) {
 
     delete[] outData;
 }
+
+TEST(ycbcr_rgb, RoundTripBatch) {
+    array rgb = af::randu(16, 12, 3, 4);
+    for (af_ycc_std standard : {AF_YCC_601, AF_YCC_709, AF_YCC_2020}) {
+        array ycc = af::rgb2ycbcr(rgb, standard);
+        ASSERT_EQ(rgb.dims(), ycc.dims());
+        ASSERT_ARRAYS_NEAR(rgb, af::ycbcr2rgb(ycc, standard), 1e-4);
+    }
+}